@@ -7,6 +7,7 @@
 
 #include "mercury_test.h"
 
+#include "mercury_time.h"
 #include "mercury_util.h"
 #include "na_test_getopt.h"
 #ifdef HG_TEST_HAS_CRAY_DRC
@@ -19,6 +20,8 @@
 #    include <unistd.h>
 #endif
 
+#include <string.h>
+
 /****************/
 /* Local Macros */
 /****************/
@@ -69,6 +72,20 @@ hg_test_usage(const char *execname)
     printf("    -m, --memory        Use shared-memory with local targets\n");
     printf("    -t, --threads       Number of server threads\n");
     printf("    -B, --bidirectional Bidirectional communication\n");
+    printf("    -r, --rate          Open-loop start rate (RPC/s), swept until "
+           "saturation\n");
+    printf("    -E, --poisson       Poisson instead of constant arrivals\n");
+    printf("    -T, --progress-threads Number of progress threads per "
+           "context\n");
+    printf("    -O, --offload       Offload RPC handlers to server threads\n");
+    printf("    -g, --segments      Max bulk segments per transfer\n");
+    printf("    -D, --seg-random    Random instead of uniform segment sizes\n");
+    printf("    -A, --seg-mismatch  Shift remote segments against local\n");
+    printf("    -I, --priority      High priority for rate RPCs\n");
+    printf("    -j, --capture       RPC capture file (written by server, "
+           "read by replay)\n");
+    printf("    -u, --bulk-ratio    Percentage of RPCs that transfer bulk "
+           "data\n");
 }
 
 /*---------------------------------------------------------------------------*/
@@ -111,6 +128,39 @@ hg_test_parse_options(int argc, char *argv[], struct hg_test_info *hg_test_info)
             case 'B': /* bidirectional */
                 hg_test_info->bidirectional = HG_TRUE;
                 break;
+            case 'r': /* open-loop rate */
+                hg_test_info->rate = atof(na_test_opt_arg_g);
+                break;
+            case 'E': /* poisson arrivals */
+                hg_test_info->poisson = HG_TRUE;
+                break;
+            case 'T': /* number of progress threads */
+                hg_test_info->progress_thread_count =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'O': /* offload handlers */
+                hg_test_info->offload = HG_TRUE;
+                break;
+            case 'g': /* number of bulk segments */
+                hg_test_info->segment_count =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
+            case 'D': /* random segment sizes */
+                hg_test_info->segment_random = HG_TRUE;
+                break;
+            case 'A': /* mismatched segment layouts */
+                hg_test_info->segment_mismatch = HG_TRUE;
+                break;
+            case 'I': /* high priority rate RPCs */
+                hg_test_info->priority = HG_TRUE;
+                break;
+            case 'j': /* RPC capture file */
+                hg_test_info->capture = strdup(na_test_opt_arg_g);
+                break;
+            case 'u': /* percentage of bulk RPCs */
+                hg_test_info->bulk_ratio =
+                    (unsigned int) atoi(na_test_opt_arg_g);
+                break;
             default:
                 break;
         }
@@ -175,6 +225,7 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
     hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
     const char *log_subsys = getenv("HG_LOG_SUBSYS");
+    hg_time_t t1, t2;
     size_t i;
 
     if (!log_subsys) {
@@ -217,6 +268,7 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
     HG_TEST_CHECK_ERROR(hg_test_info->hg_classes == NULL, error, ret, HG_NOMEM,
         "Could not allocate array of HG classes");
 
+    hg_test_info->init_time = 0;
     for (i = 0; i < hg_test_info->na_test_info.max_classes; i++) {
         struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
 
@@ -239,9 +291,12 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
         hg_init_info.no_multi_recv = hg_test_info->na_test_info.no_multi_recv;
 
         /* Init HG with init options */
+        hg_time_get_current(&t1);
         hg_test_info->hg_classes[i] =
             HG_Init_opt2(NULL, hg_test_info->na_test_info.listen,
                 HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), &hg_init_info);
+        hg_time_get_current(&t2);
+        hg_test_info->init_time += hg_time_to_double(hg_time_subtract(t2, t1));
         HG_TEST_CHECK_ERROR(hg_test_info->hg_classes[i] == NULL, error, ret,
             HG_FAULT, "HG_Init_opt2() failed");
     }
@@ -303,6 +358,11 @@ HG_Test_finalize(struct hg_test_info *hg_test_info)
     HG_TEST_CHECK_ERROR(na_ret != NA_SUCCESS, done, ret, (hg_return_t) na_ret,
         "NA_Test_finalize() failed (%s)", NA_Error_to_string(na_ret));
 
+    if (hg_test_info->capture != NULL) {
+        free(hg_test_info->capture);
+        hg_test_info->capture = NULL;
+    }
+
     if (hg_test_info->auth) {
 #ifdef HG_TEST_HAS_CRAY_DRC
         ret = hg_test_drc_release(hg_test_info);
@@ -33,8 +33,19 @@ struct hg_test_info {
     unsigned int handle_max;   /* Max number of handles in-flight */
     unsigned int thread_count; /* Max number of threads */
     hg_bool_t auth;
-    hg_bool_t auto_sm;       /* Use shared-memory */
-    hg_bool_t bidirectional; /* Bidirectional tests */
+    hg_bool_t auto_sm;                  /* Use shared-memory */
+    hg_bool_t bidirectional;            /* Bidirectional tests */
+    hg_bool_t poisson;                  /* Poisson open-loop arrivals */
+    double rate;                        /* Open-loop start rate (RPC/s) */
+    unsigned int progress_thread_count; /* Progress threads per context */
+    hg_bool_t offload;                  /* Offload RPC handlers to threads */
+    unsigned int segment_count;         /* Max bulk segments per transfer */
+    hg_bool_t segment_random;           /* Random segment sizes */
+    hg_bool_t segment_mismatch;         /* Shifted remote segments */
+    hg_bool_t priority;                 /* High priority rate RPCs */
+    char *capture;                      /* RPC capture file */
+    unsigned int bulk_ratio;            /* Percentage of bulk RPCs */
+    double init_time;                   /* Time spent in HG_Init() (s) */
 };
 
 /*****************/
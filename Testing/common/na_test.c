@@ -7,11 +7,13 @@
 
 #include "na_test.h"
 #include "na_test_getopt.h"
+#include "na_test_report.h"
 
 #ifdef NA_HAS_MPI
 #    include "na_mpi.h"
 #endif
 
+#include "mercury_time.h"
 #include "mercury_util.h"
 
 #include <stdio.h>
@@ -115,7 +117,16 @@ na_test_usage(const char *execname)
     printf("    -R, --force-register Force registration of buffers\n");
     printf("    -M, --mbps           Output in MB/s instead of MiB/s\n");
     printf("    -U, --no-multi-recv  Disable multi-recv\n");
+    printf("    -G, --device         Use device (CUDA) memory for buffers\n");
+    printf("    -e, --expected       Use expected msgs\n");
     printf("    -V, --verbose        Print verbose output\n");
+    printf("    -F, --format         Output format of results\n"
+           "                         Formats: text (default), json, csv\n");
+    printf("    -K, --baseline       Compare results against JSON/CSV output "
+           "of a previous run\n");
+    printf("    -Q, --threshold      Regression threshold in %% "
+           "(default: %.0f)\n",
+        NA_TEST_REPORT_THRESHOLD);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -212,6 +223,30 @@ na_test_parse_options(int argc, char *argv[], struct na_test_info *na_test_info)
             case 'U': /* no-multi-recv */
                 na_test_info->no_multi_recv = true;
                 break;
+            case 'G': /* device */
+                na_test_info->device = true;
+                break;
+            case 'e': /* expected */
+                na_test_info->expected = true;
+                break;
+            case 'F': /* output format */
+                if (strcmp(na_test_opt_arg_g, "json") == 0)
+                    na_test_info->report_format = NA_TEST_REPORT_JSON;
+                else if (strcmp(na_test_opt_arg_g, "csv") == 0)
+                    na_test_info->report_format = NA_TEST_REPORT_CSV;
+                else if (strcmp(na_test_opt_arg_g, "text") == 0)
+                    na_test_info->report_format = NA_TEST_REPORT_TEXT;
+                else {
+                    na_test_usage(argv[0]);
+                    exit(1);
+                }
+                break;
+            case 'K': /* baseline */
+                na_test_info->baseline = strdup(na_test_opt_arg_g);
+                break;
+            case 'Q': /* regression threshold */
+                na_test_info->threshold = atof(na_test_opt_arg_g);
+                break;
             default:
                 break;
         }
@@ -536,6 +571,7 @@ NA_Test_init(int argc, char *argv[], struct na_test_info *na_test_info)
 {
     char *info_string = NULL;
     struct na_init_info na_init_info = NA_INIT_INFO_INITIALIZER;
+    hg_time_t t1, t2;
     na_return_t ret = NA_SUCCESS;
     const char *log_subsys = getenv("HG_LOG_SUBSYS");
     size_t i;
@@ -565,6 +601,11 @@ NA_Test_init(int argc, char *argv[], struct na_test_info *na_test_info)
     na_test_info->mpi_comm_size = 1;
     na_test_info->max_number_of_peers = 1;
 #endif
+
+    ret = na_test_report_init(na_test_info);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "na_test_report_init() failed (%s)",
+        NA_Error_to_string(ret));
+
     if (na_test_info->max_classes == 0)
         na_test_info->max_classes = 1;
 
@@ -574,7 +615,8 @@ NA_Test_init(int argc, char *argv[], struct na_test_info *na_test_info)
 
     if (na_test_info->busy_wait) {
         na_init_info.progress_mode = NA_NO_BLOCK;
-        if (na_test_info->mpi_comm_rank == 0)
+        if (na_test_info->mpi_comm_rank == 0 &&
+            na_test_info->report_format == NA_TEST_REPORT_TEXT)
             printf("# Initializing NA in busy wait mode\n");
     }
     na_init_info.auth_key = na_test_info->key;
@@ -583,13 +625,16 @@ NA_Test_init(int argc, char *argv[], struct na_test_info *na_test_info)
     na_init_info.max_unexpected_size = (size_t) na_test_info->max_msg_size;
     na_init_info.max_expected_size = (size_t) na_test_info->max_msg_size;
     na_init_info.thread_mode =
-        na_test_info->use_threads ? 0 : NA_THREAD_MODE_SINGLE;
+        (na_test_info->use_threads || na_test_info->max_contexts > 1)
+            ? 0
+            : NA_THREAD_MODE_SINGLE;
 
     na_test_info->na_classes = (na_class_t **) malloc(
         sizeof(na_class_t *) * na_test_info->max_classes);
     NA_TEST_CHECK_ERROR(na_test_info->na_classes == NULL, error, ret, NA_NOMEM,
         "Could not allocate NA classes");
 
+    na_test_info->init_time = 0;
     for (i = 0; i < na_test_info->max_classes; i++) {
         /* Generate NA init string and get config options */
         info_string = na_test_gen_config(na_test_info,
@@ -598,12 +643,16 @@ NA_Test_init(int argc, char *argv[], struct na_test_info *na_test_info)
         NA_TEST_CHECK_ERROR(info_string == NULL, error, ret, NA_PROTOCOL_ERROR,
             "Could not generate config string");
 
-        if (na_test_info->mpi_comm_rank == 0)
+        if (na_test_info->mpi_comm_rank == 0 &&
+            na_test_info->report_format == NA_TEST_REPORT_TEXT)
             printf("# Class %zu using info string: %s\n", i + 1, info_string);
 
+        hg_time_get_current(&t1);
         na_test_info->na_classes[i] =
             NA_Initialize_opt2(info_string, na_test_info->listen,
                 NA_VERSION(NA_VERSION_MAJOR, NA_VERSION_MINOR), &na_init_info);
+        hg_time_get_current(&t2);
+        na_test_info->init_time += hg_time_to_double(hg_time_subtract(t2, t1));
         NA_TEST_CHECK_ERROR(na_test_info->na_classes[i] == NULL, error, ret,
             NA_PROTOCOL_ERROR, "NA_Initialize_opt2(%s) failed", info_string);
 
@@ -684,7 +733,8 @@ NA_Test_init(int argc, char *argv[], struct na_test_info *na_test_info)
         }
 #endif
         na_test_info->target_name = na_test_info->target_names[0];
-        if (na_test_info->mpi_comm_rank == 0) {
+        if (na_test_info->mpi_comm_rank == 0 &&
+            na_test_info->report_format == NA_TEST_REPORT_TEXT) {
             uint32_t j;
 
             printf("# %" PRIu32 " target name(s) read:\n",
@@ -753,6 +803,11 @@ NA_Test_finalize(struct na_test_info *na_test_info)
         free(na_test_info->key);
         na_test_info->key = NULL;
     }
+    if (na_test_info->baseline != NULL) {
+        free(na_test_info->baseline);
+        na_test_info->baseline = NULL;
+    }
+    na_test_report_free(na_test_info);
 
 #ifdef HG_TEST_HAS_PARALLEL
     na_test_mpi_finalize(na_test_info);
@@ -789,3 +844,21 @@ NA_Test_bcast(
     (void) buf;
 #endif
 }
+
+/*---------------------------------------------------------------------------*/
+void
+NA_Test_gather(const char *send_buf, char *recv_buf, int count, int root,
+    const struct na_test_info *na_test_info)
+{
+#ifdef HG_TEST_HAS_PARALLEL
+    if (na_test_info->mpi_comm_size > 1) {
+        MPI_Gather(send_buf, count, MPI_BYTE, recv_buf, count, MPI_BYTE, root,
+            na_test_info->mpi_comm);
+        return;
+    }
+#else
+    (void) na_test_info;
+    (void) root;
+#endif
+    memcpy(recv_buf, send_buf, (size_t) count);
+}
@@ -19,6 +19,15 @@
 /* Public Type and Struct Definition */
 /*************************************/
 
+/* Output format of benchmark results */
+enum na_test_report_format {
+    NA_TEST_REPORT_TEXT, /* Human-formatted tables (default) */
+    NA_TEST_REPORT_JSON, /* JSON document */
+    NA_TEST_REPORT_CSV   /* CSV with commented metadata */
+};
+
+struct na_test_report;
+
 struct na_test_info {
     na_class_t *na_class;    /* Default NA class */
     na_class_t **na_classes; /* Array of NA classes */
@@ -56,6 +65,15 @@ struct na_test_info {
     bool verify;         /* Verify data */
     bool mbps;           /* OSU-style of output in MB/s */
     bool no_multi_recv;  /* Disable multi-recv */
+    bool device;         /* Use device memory */
+    bool expected;       /* Send expected msgs */
+    double init_time;    /* Time spent in NA_Initialize() (s) */
+
+    /* Results report */
+    enum na_test_report_format report_format; /* Output format */
+    char *baseline;                           /* Baseline to compare against */
+    double threshold;                         /* Regression threshold (%) */
+    struct na_test_report *report;            /* Report (NULL if text only) */
 };
 
 /*****************/
@@ -218,6 +236,14 @@ void
 NA_Test_bcast(
     char *buf, int count, int root, const struct na_test_info *na_test_info);
 
+/**
+ * Call MPI_Gather if available, count is the number of bytes sent by each
+ * rank
+ */
+void
+NA_Test_gather(const char *send_buf, char *recv_buf, int count, int root,
+    const struct na_test_info *na_test_info);
+
 #ifdef __cplusplus
 }
 #endif
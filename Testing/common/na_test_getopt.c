@@ -14,7 +14,7 @@
 
 int na_test_opt_ind_g = 1;            /* token pointer */
 const char *na_test_opt_arg_g = NULL; /* flag argument (or value) */
-const char *na_test_short_opt_g = "hc:d:p:H:P:LsSk:l:bC:X:VaZ:y:z:w:x:mt:BRvMU";
+const char *na_test_short_opt_g = "hc:d:p:H:P:LsSk:l:bC:X:VaZ:y:z:w:x:mt:BRvMUGr:ET:Og:DAF:K:Q:eIj:u:";
 /* clang-format off */
 const struct na_test_opt na_test_opt_g[] = {
     {"help", no_arg, 'h'},
@@ -45,6 +45,21 @@ const struct na_test_opt na_test_opt_g[] = {
     {"verify", no_arg, 'v'},
     {"millionbps", no_arg, 'M'},
     {"no-multi-recv", no_arg, 'U'},
+    {"device", no_arg, 'G'},
+    {"rate", require_arg, 'r'},
+    {"poisson", no_arg, 'E'},
+    {"progress-threads", require_arg, 'T'},
+    {"offload", no_arg, 'O'},
+    {"segments", require_arg, 'g'},
+    {"seg-random", no_arg, 'D'},
+    {"seg-mismatch", no_arg, 'A'},
+    {"format", require_arg, 'F'},
+    {"baseline", require_arg, 'K'},
+    {"threshold", require_arg, 'Q'},
+    {"expected", no_arg, 'e'},
+    {"priority", no_arg, 'I'},
+    {"capture", require_arg, 'j'},
+    {"bulk-ratio", require_arg, 'u'},
     {NULL, 0, '\0'} /* Must add this at the end */
 };
 /* clang-format on */
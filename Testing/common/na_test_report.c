@@ -0,0 +1,565 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "na_test_report.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+#define NA_TEST_REPORT_META_MAX   48
+#define NA_TEST_REPORT_COLUMN_MAX 8
+#define NA_TEST_REPORT_NAME_MAX   32
+#define NA_TEST_REPORT_VALUE_MAX  256
+#define NA_TEST_REPORT_LINE_MAX   4096
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+struct na_test_report_meta {
+    char key[NA_TEST_REPORT_NAME_MAX];
+    char value[NA_TEST_REPORT_VALUE_MAX];
+};
+
+/* Row of baseline results */
+struct na_test_report_row {
+    char names[NA_TEST_REPORT_COLUMN_MAX][NA_TEST_REPORT_NAME_MAX];
+    double values[NA_TEST_REPORT_COLUMN_MAX];
+    size_t count;
+};
+
+struct na_test_report {
+    struct na_test_report_meta meta[NA_TEST_REPORT_META_MAX]; /* Metadata */
+    struct na_test_report_metric metrics[NA_TEST_REPORT_COLUMN_MAX];
+    struct na_test_report_row *baseline; /* Baseline rows */
+    const char *benchmark;               /* Benchmark name */
+    size_t meta_count;                   /* Number of metadata entries */
+    size_t metric_count;                 /* Number of metrics */
+    size_t baseline_count;               /* Number of baseline rows */
+    size_t row_count;                    /* Number of rows reported */
+    unsigned int regressions;            /* Number of regressed values */
+    bool segments;                       /* Segment count column */
+    bool begun;                          /* Report started */
+    bool printed;                        /* Prolog printed */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Load baseline rows from a JSON or CSV report.
+ */
+static na_return_t
+na_test_report_load(struct na_test_report *report, const char *path);
+
+/**
+ * Parse one result object of a JSON report.
+ */
+static void
+na_test_report_parse_json(const char *line, struct na_test_report_row *row);
+
+/**
+ * Parse one line of a CSV report.
+ */
+static void
+na_test_report_parse_csv(char *line, const struct na_test_report_row *header,
+    struct na_test_report_row *row);
+
+/**
+ * Get value of column (returns false if the column does not exist).
+ */
+static bool
+na_test_report_get(
+    const struct na_test_report_row *row, const char *name, double *value_p);
+
+/**
+ * Print metadata and column names.
+ */
+static void
+na_test_report_prolog(const struct na_test_info *na_test_info);
+
+/**
+ * Print string as a JSON value (numbers and booleans are left unquoted).
+ */
+static void
+na_test_report_print_json(const char *value);
+
+/**
+ * Compare row against the matching baseline row.
+ */
+static void
+na_test_report_compare(const struct na_test_info *na_test_info, size_t size,
+    size_t segment_count, const double *values);
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+na_test_report_init(struct na_test_info *na_test_info)
+{
+    struct na_test_report *report = NULL;
+    na_return_t ret;
+
+    if (na_test_info->threshold <= 0.0)
+        na_test_info->threshold = NA_TEST_REPORT_THRESHOLD;
+    if (na_test_info->report_format == NA_TEST_REPORT_TEXT &&
+        na_test_info->baseline == NULL)
+        return NA_SUCCESS;
+
+    report = (struct na_test_report *) calloc(1, sizeof(*report));
+    NA_TEST_CHECK_ERROR(
+        report == NULL, error, ret, NA_NOMEM, "Could not allocate report");
+
+    if (na_test_info->baseline != NULL) {
+        ret = na_test_report_load(report, na_test_info->baseline);
+        NA_TEST_CHECK_NA_ERROR(error, ret,
+            "Could not load baseline from %s (%s)", na_test_info->baseline,
+            NA_Error_to_string(ret));
+    }
+
+    na_test_info->report = report;
+
+    return NA_SUCCESS;
+
+error:
+    if (report != NULL) {
+        free(report->baseline);
+        free(report);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_test_report_free(struct na_test_info *na_test_info)
+{
+    if (na_test_info->report != NULL) {
+        free(na_test_info->report->baseline);
+        free(na_test_info->report);
+        na_test_info->report = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_test_report_load(struct na_test_report *report, const char *path)
+{
+    char line[NA_TEST_REPORT_LINE_MAX];
+    struct na_test_report_row header = {.count = 0};
+    size_t row_max = 0;
+    bool json = false, first = true;
+    FILE *file;
+    na_return_t ret;
+
+    file = fopen(path, "r");
+    NA_TEST_CHECK_ERROR(
+        file == NULL, error, ret, NA_NOENTRY, "Could not open %s", path);
+
+    while (fgets(line, (int) sizeof(line), file) != NULL) {
+        struct na_test_report_row row = {.count = 0};
+        char *ptr = line;
+
+        while (isspace((unsigned char) *ptr))
+            ptr++;
+        if (*ptr == '\0')
+            continue;
+
+        /* Format is given by the first character of the file */
+        if (first) {
+            json = (*ptr == '{');
+            first = false;
+        }
+
+        if (json) {
+            /* Result objects are printed one per line */
+            if (strncmp(ptr, "{\"size\":", strlen("{\"size\":")) != 0)
+                continue;
+            na_test_report_parse_json(ptr, &row);
+        } else {
+            if (*ptr == '#')
+                continue;
+            if (header.count == 0) {
+                na_test_report_parse_csv(ptr, NULL, &header);
+                continue;
+            }
+            na_test_report_parse_csv(ptr, &header, &row);
+        }
+        if (row.count == 0)
+            continue;
+
+        if (report->baseline_count == row_max) {
+            struct na_test_report_row *baseline;
+
+            row_max = (row_max == 0) ? 16 : row_max * 2;
+            baseline = (struct na_test_report_row *) realloc(
+                report->baseline, row_max * sizeof(*baseline));
+            NA_TEST_CHECK_ERROR(baseline == NULL, error, ret, NA_NOMEM,
+                "Could not allocate baseline rows");
+            report->baseline = baseline;
+        }
+        report->baseline[report->baseline_count++] = row;
+    }
+
+    NA_TEST_CHECK_ERROR(report->baseline_count == 0, error, ret, NA_INVALID_ARG,
+        "No results found in %s", path);
+
+    fclose(file);
+
+    return NA_SUCCESS;
+
+error:
+    if (file != NULL)
+        fclose(file);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_test_report_parse_json(const char *line, struct na_test_report_row *row)
+{
+    const char *ptr = line;
+
+    while (row->count < NA_TEST_REPORT_COLUMN_MAX &&
+           (ptr = strchr(ptr, '"')) != NULL) {
+        const char *end = strchr(++ptr, '"');
+        size_t len;
+        char *value_end;
+
+        if (end == NULL)
+            break;
+        len = (size_t) (end - ptr);
+        if (len >= NA_TEST_REPORT_NAME_MAX || end[1] != ':')
+            break;
+        memcpy(row->names[row->count], ptr, len);
+        row->names[row->count][len] = '\0';
+
+        row->values[row->count] = strtod(end + 2, &value_end);
+        if (value_end == end + 2)
+            break;
+        row->count++;
+        ptr = value_end;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_test_report_parse_csv(char *line, const struct na_test_report_row *header,
+    struct na_test_report_row *row)
+{
+    char *field = line;
+
+    line[strcspn(line, "\r\n")] = '\0';
+    while (field != NULL && row->count < NA_TEST_REPORT_COLUMN_MAX) {
+        char *next = strchr(field, ',');
+
+        if (next != NULL)
+            *next++ = '\0';
+        if (header == NULL) {
+            /* Column names */
+            snprintf(row->names[row->count], NA_TEST_REPORT_NAME_MAX, "%s",
+                field);
+        } else {
+            if (row->count >= header->count)
+                break;
+            strcpy(row->names[row->count], header->names[row->count]);
+            row->values[row->count] = strtod(field, NULL);
+        }
+        row->count++;
+        field = next;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+na_test_report_get(
+    const struct na_test_report_row *row, const char *name, double *value_p)
+{
+    size_t i;
+
+    for (i = 0; i < row->count; i++) {
+        if (strcmp(row->names[i], name) == 0) {
+            *value_p = row->values[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*---------------------------------------------------------------------------*/
+bool
+na_test_report_begin(const struct na_test_info *na_test_info,
+    const char *benchmark, const char *version,
+    const struct na_test_report_metric *metrics, size_t metric_count,
+    bool segments)
+{
+    struct na_test_report *report = na_test_info->report;
+    size_t i;
+
+    if (report == NULL)
+        return true;
+
+    report->benchmark = benchmark;
+    report->segments = segments;
+    report->metric_count = (metric_count < NA_TEST_REPORT_COLUMN_MAX - 2)
+                               ? metric_count
+                               : NA_TEST_REPORT_COLUMN_MAX - 2;
+    for (i = 0; i < report->metric_count; i++)
+        report->metrics[i] = metrics[i];
+    report->meta_count = 0;
+    report->row_count = 0;
+    report->regressions = 0;
+    report->printed = false;
+    report->begun = true;
+
+    /* Run metadata */
+    na_test_report_meta(na_test_info, "benchmark", "%s", benchmark);
+    na_test_report_meta(na_test_info, "version", "%s", version);
+    na_test_report_meta(na_test_info, "plugin", "%s",
+        na_test_info->comm ? na_test_info->comm : "");
+    na_test_report_meta(na_test_info, "protocol", "%s",
+        na_test_info->protocol ? na_test_info->protocol : "");
+    na_test_report_meta(na_test_info, "domain", "%s",
+        na_test_info->domain ? na_test_info->domain : "");
+    na_test_report_meta(na_test_info, "loop", "%d", na_test_info->loop);
+    na_test_report_meta(
+        na_test_info, "buf_size_min", "%zu", na_test_info->buf_size_min);
+    na_test_report_meta(
+        na_test_info, "buf_size_max", "%zu", na_test_info->buf_size_max);
+    na_test_report_meta(
+        na_test_info, "buf_count", "%zu", na_test_info->buf_count);
+    na_test_report_meta(
+        na_test_info, "msg_size", "%zu", na_test_info->max_msg_size);
+    na_test_report_meta(
+        na_test_info, "classes", "%zu", na_test_info->max_classes);
+    na_test_report_meta(
+        na_test_info, "contexts", "%u", (unsigned) na_test_info->max_contexts);
+    na_test_report_meta(
+        na_test_info, "targets", "%" PRIu32, na_test_info->max_targets);
+    na_test_report_meta(
+        na_test_info, "processes", "%d", na_test_info->mpi_comm_size);
+    na_test_report_meta(na_test_info, "busy_wait", "%s",
+        na_test_info->busy_wait ? "true" : "false");
+    na_test_report_meta(na_test_info, "force_register", "%s",
+        na_test_info->force_register ? "true" : "false");
+    na_test_report_meta(na_test_info, "verify", "%s",
+        na_test_info->verify ? "true" : "false");
+    na_test_report_meta(na_test_info, "no_multi_recv", "%s",
+        na_test_info->no_multi_recv ? "true" : "false");
+    na_test_report_meta(na_test_info, "device", "%s",
+        na_test_info->device ? "true" : "false");
+
+    return na_test_info->report_format == NA_TEST_REPORT_TEXT;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_test_report_meta(const struct na_test_info *na_test_info, const char *key,
+    const char *format, ...)
+{
+    struct na_test_report *report = na_test_info->report;
+    struct na_test_report_meta *meta;
+    va_list ap;
+
+    if (report == NULL || !report->begun || report->printed ||
+        report->meta_count == NA_TEST_REPORT_META_MAX)
+        return;
+
+    meta = &report->meta[report->meta_count++];
+    snprintf(meta->key, sizeof(meta->key), "%s", key);
+    va_start(ap, format);
+    vsnprintf(meta->value, sizeof(meta->value), format, ap);
+    va_end(ap);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_test_report_prolog(const struct na_test_info *na_test_info)
+{
+    struct na_test_report *report = na_test_info->report;
+    size_t i;
+
+    report->printed = true;
+
+    switch (na_test_info->report_format) {
+        case NA_TEST_REPORT_JSON:
+            printf("{\n  \"metadata\": {");
+            for (i = 0; i < report->meta_count; i++) {
+                printf("%s\n    \"%s\": ", (i > 0) ? "," : "",
+                    report->meta[i].key);
+                na_test_report_print_json(report->meta[i].value);
+            }
+            printf("\n  },\n  \"results\": [");
+            break;
+        case NA_TEST_REPORT_CSV:
+            for (i = 0; i < report->meta_count; i++)
+                printf(
+                    "# %s=%s\n", report->meta[i].key, report->meta[i].value);
+            printf("size");
+            if (report->segments)
+                printf(",segments");
+            for (i = 0; i < report->metric_count; i++)
+                printf(",%s", report->metrics[i].name);
+            printf("\n");
+            break;
+        case NA_TEST_REPORT_TEXT:
+        default:
+            break;
+    }
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_test_report_print_json(const char *value)
+{
+    const char *ptr;
+    char *end = NULL;
+
+    if (*value != '\0')
+        (void) strtod(value, &end);
+    if ((end != NULL && *end == '\0') || strcmp(value, "true") == 0 ||
+        strcmp(value, "false") == 0) {
+        printf("%s", value);
+        return;
+    }
+
+    putchar('"');
+    for (ptr = value; *ptr != '\0'; ptr++) {
+        if (*ptr == '"' || *ptr == '\\')
+            printf("\\%c", *ptr);
+        else if ((unsigned char) *ptr < 0x20)
+            printf("\\u%04x", (unsigned int) *ptr);
+        else
+            putchar(*ptr);
+    }
+    putchar('"');
+}
+
+/*---------------------------------------------------------------------------*/
+bool
+na_test_report_row(const struct na_test_info *na_test_info, size_t size,
+    size_t segment_count, const double *values)
+{
+    struct na_test_report *report = na_test_info->report;
+    size_t i;
+
+    if (report == NULL || !report->begun)
+        return true;
+
+    if (!report->printed)
+        na_test_report_prolog(na_test_info);
+
+    switch (na_test_info->report_format) {
+        case NA_TEST_REPORT_JSON:
+            printf("%s\n    {\"size\": %zu", (report->row_count > 0) ? "," : "",
+                size);
+            if (report->segments)
+                printf(", \"segments\": %zu", segment_count);
+            for (i = 0; i < report->metric_count; i++)
+                printf(", \"%s\": %.3f", report->metrics[i].name, values[i]);
+            printf("}");
+            break;
+        case NA_TEST_REPORT_CSV:
+            printf("%zu", size);
+            if (report->segments)
+                printf(",%zu", segment_count);
+            for (i = 0; i < report->metric_count; i++)
+                printf(",%.3f", values[i]);
+            printf("\n");
+            break;
+        case NA_TEST_REPORT_TEXT:
+        default:
+            break;
+    }
+    fflush(stdout);
+    report->row_count++;
+
+    if (report->baseline != NULL)
+        na_test_report_compare(na_test_info, size, segment_count, values);
+
+    return na_test_info->report_format == NA_TEST_REPORT_TEXT;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_test_report_compare(const struct na_test_info *na_test_info, size_t size,
+    size_t segment_count, const double *values)
+{
+    struct na_test_report *report = na_test_info->report;
+    const struct na_test_report_row *row = NULL;
+    size_t i;
+
+    for (i = 0; i < report->baseline_count; i++) {
+        double row_size, row_segments = 0;
+
+        if (!na_test_report_get(&report->baseline[i], "size", &row_size) ||
+            (size_t) row_size != size)
+            continue;
+        (void) na_test_report_get(
+            &report->baseline[i], "segments", &row_segments);
+        if (report->segments && (size_t) row_segments != segment_count)
+            continue;
+        row = &report->baseline[i];
+        break;
+    }
+    if (row == NULL)
+        return;
+
+    for (i = 0; i < report->metric_count; i++) {
+        const struct na_test_report_metric *metric = &report->metrics[i];
+        double base, delta;
+
+        if (!na_test_report_get(row, metric->name, &base) || base <= 0.0)
+            continue;
+
+        /* Relative change in %, positive when the value got worse */
+        delta = (values[i] - base) / base * 100.0;
+        if (metric->higher_is_better)
+            delta = -delta;
+        if (delta <= na_test_info->threshold)
+            continue;
+
+        report->regressions++;
+        fprintf(stderr,
+            "# REGRESSION %s size %zu: %s %.3f vs %.3f in baseline "
+            "(%.1f%% worse)\n",
+            report->benchmark, size, metric->name, values[i], base, delta);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+bool
+na_test_report_end(const struct na_test_info *na_test_info)
+{
+    struct na_test_report *report = na_test_info->report;
+
+    if (report == NULL || !report->begun)
+        return false;
+
+    if (!report->printed)
+        na_test_report_prolog(na_test_info);
+
+    if (na_test_info->report_format == NA_TEST_REPORT_JSON)
+        printf("\n  ],\n  \"regressions\": %u\n}\n", report->regressions);
+    fflush(stdout);
+
+    if (report->baseline != NULL)
+        fprintf(stderr,
+            "# %u value(s) of %s regressed by more than %.1f%% against %s\n",
+            report->regressions, report->benchmark, na_test_info->threshold,
+            na_test_info->baseline);
+    report->begun = false;
+
+    return report->regressions > 0;
+}
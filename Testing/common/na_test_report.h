@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef NA_TEST_REPORT_H
+#define NA_TEST_REPORT_H
+
+#include "na_test.h"
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/* Measured value reported for each size */
+struct na_test_report_metric {
+    const char *name;      /* Column name (e.g., "lat_us") */
+    bool higher_is_better; /* Direction of regressions */
+};
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/* Default regression threshold (%) */
+#define NA_TEST_REPORT_THRESHOLD (5.0)
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create report if results are output in JSON/CSV or compared against a
+ * baseline, load baseline results.
+ */
+na_return_t
+na_test_report_init(struct na_test_info *na_test_info);
+
+/**
+ * Free report.
+ */
+void
+na_test_report_free(struct na_test_info *na_test_info);
+
+/**
+ * Start reporting results of benchmark, run metadata is recorded from the
+ * test options. Columns are the size, the number of segments if segments is
+ * true, and one column per metric.
+ *
+ * \return true if human-formatted output must be printed by the caller
+ */
+bool
+na_test_report_begin(const struct na_test_info *na_test_info,
+    const char *benchmark, const char *version,
+    const struct na_test_report_metric *metrics, size_t metric_count,
+    bool segments);
+
+/**
+ * Add metadata entry, must be called before the first row is reported.
+ */
+void
+na_test_report_meta(const struct na_test_info *na_test_info, const char *key,
+    const char *format, ...) HG_ATTR_PRINTF(3, 4);
+
+/**
+ * Report one row of values (one per metric) and compare it against the
+ * matching baseline row.
+ *
+ * \return true if human-formatted output must be printed by the caller
+ */
+bool
+na_test_report_row(const struct na_test_info *na_test_info, size_t size,
+    size_t segment_count, const double *values);
+
+/**
+ * Finish report.
+ *
+ * \return true if values regressed beyond threshold against the baseline
+ */
+bool
+na_test_report_end(const struct na_test_info *na_test_info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NA_TEST_REPORT_H */
@@ -0,0 +1,334 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_perf.h"
+
+#include "mercury_mem.h"
+
+#ifdef HG_TEST_HAS_CUDA
+#    include <cuda_runtime.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "HG_Bulk_create() cost"
+
+/* Default buffer size max if not specified */
+#define HG_BULK_CREATE_SIZE_MAX (1 << 24)
+
+/* Gap left after each segment so that segments are not coalesced */
+#define HG_BULK_CREATE_SEG_GAP (64)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Kinds of memory that get registered */
+enum hg_bulk_create_mem_kind {
+    HG_BULK_CREATE_MEM_HOST,  /* Host memory, default pages */
+    HG_BULK_CREATE_MEM_HUGE,  /* Host memory, huge pages */
+    HG_BULK_CREATE_MEM_DEVICE /* Device memory */
+};
+
+struct hg_bulk_create_info {
+    hg_class_t *hg_class;                /* HG class */
+    enum hg_bulk_create_mem_kind kind;   /* Memory kind */
+    void **bufs;                         /* Segment buffers */
+    hg_size_t *lens;                     /* Segment sizes */
+    void *serialize_buf;                 /* Serialization buffer */
+    size_t serialize_buf_size;           /* Serialization buffer size */
+    size_t segment_count;                /* Segments per handle */
+    int loop;                            /* Loop count */
+    int rank;                            /* MPI rank */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static void *
+hg_bulk_create_buf_alloc(enum hg_bulk_create_mem_kind kind, size_t alloc_size);
+
+static void
+hg_bulk_create_buf_free(
+    enum hg_bulk_create_mem_kind kind, void *buf, size_t alloc_size);
+
+static hg_return_t
+hg_bulk_create_run(struct hg_bulk_create_info *info, void *buf,
+    size_t buf_size, size_t skip);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static const char *const hg_bulk_create_mem_name_g[] = {
+    [HG_BULK_CREATE_MEM_HOST] = "host",
+    [HG_BULK_CREATE_MEM_HUGE] = "host hugepage",
+    [HG_BULK_CREATE_MEM_DEVICE] = "device"};
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_bulk_create_buf_alloc(enum hg_bulk_create_mem_kind kind, size_t alloc_size)
+{
+    void *buf = NULL;
+
+    switch (kind) {
+        case HG_BULK_CREATE_MEM_HOST:
+            buf = hg_mem_aligned_alloc(
+                (size_t) hg_mem_get_page_size(), alloc_size);
+            break;
+        case HG_BULK_CREATE_MEM_HUGE:
+            buf = hg_mem_huge_alloc(alloc_size);
+            break;
+        case HG_BULK_CREATE_MEM_DEVICE:
+#ifdef HG_TEST_HAS_CUDA
+            if (cudaMalloc(&buf, alloc_size) != cudaSuccess)
+                buf = NULL;
+#endif
+            return buf;
+        default:
+            return NULL;
+    }
+
+    /* Fault pages in, first touch is not part of the registration cost */
+    if (buf != NULL)
+        memset(buf, 0, alloc_size);
+
+    return buf;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_create_buf_free(
+    enum hg_bulk_create_mem_kind kind, void *buf, size_t alloc_size)
+{
+    switch (kind) {
+        case HG_BULK_CREATE_MEM_HOST:
+            hg_mem_aligned_free(buf);
+            break;
+        case HG_BULK_CREATE_MEM_HUGE:
+            (void) hg_mem_huge_free(buf, alloc_size);
+            break;
+        case HG_BULK_CREATE_MEM_DEVICE:
+#ifdef HG_TEST_HAS_CUDA
+            (void) cudaFree(buf);
+#endif
+            break;
+        default:
+            break;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_create_run(struct hg_bulk_create_info *info, void *buf,
+    size_t buf_size, size_t skip)
+{
+    struct hg_perf_reg_times times = {.first = 0};
+    struct hg_bulk_attr attrs = {
+        .mem_type = (info->kind == HG_BULK_CREATE_MEM_DEVICE)
+                        ? HG_MEM_TYPE_CUDA
+                        : HG_MEM_TYPE_HOST,
+        .device = 0};
+    size_t loop = (size_t) info->loop, i;
+    hg_bulk_t bulk = HG_BULK_NULL;
+    hg_return_t ret;
+
+    /* Same layout for every iteration, segments are split by a gap */
+    for (i = 0; i < info->segment_count; i++) {
+        info->bufs[i] = (char *) buf + i * (buf_size / info->segment_count +
+                                               HG_BULK_CREATE_SEG_GAP);
+        info->lens[i] = (hg_size_t) (buf_size / info->segment_count);
+    }
+    info->lens[info->segment_count - 1] +=
+        (hg_size_t) (buf_size % info->segment_count);
+
+    for (i = 0; i < skip + loop; i++) {
+        hg_time_t t0, t1, t2, t3, t4, t5;
+        hg_size_t serialize_size;
+        double create, serialize, free_time;
+
+        hg_time_get_current(&t0);
+
+        ret = HG_Bulk_create_attr(info->hg_class,
+            (hg_uint32_t) info->segment_count, info->bufs, info->lens,
+            HG_BULK_READWRITE, &attrs, &bulk);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_create_attr() failed (%s)",
+            HG_Error_to_string(ret));
+        hg_time_get_current(&t1);
+
+        /* Lazily registered handles get registered there */
+        serialize_size = HG_Bulk_get_serialize_size(bulk, 0);
+        hg_time_get_current(&t2);
+
+        /* Growing the serialization buffer is not accounted for */
+        if (serialize_size > info->serialize_buf_size) {
+            void *serialize_buf =
+                realloc(info->serialize_buf, (size_t) serialize_size);
+            HG_TEST_CHECK_ERROR(serialize_buf == NULL, error, ret, HG_NOMEM,
+                "realloc(%zu) failed", (size_t) serialize_size);
+            info->serialize_buf = serialize_buf;
+            info->serialize_buf_size = (size_t) serialize_size;
+        }
+        hg_time_get_current(&t3);
+
+        ret = HG_Bulk_serialize(info->serialize_buf, serialize_size, 0, bulk);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_serialize() failed (%s)",
+            HG_Error_to_string(ret));
+        hg_time_get_current(&t4);
+
+        ret = HG_Bulk_free(bulk);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_free() failed (%s)",
+            HG_Error_to_string(ret));
+        bulk = HG_BULK_NULL;
+        hg_time_get_current(&t5);
+
+        create = hg_time_to_double(hg_time_subtract(t1, t0));
+        serialize = hg_time_to_double(hg_time_subtract(t2, t1)) +
+                    hg_time_to_double(hg_time_subtract(t4, t3));
+        free_time = hg_time_to_double(hg_time_subtract(t5, t4));
+
+        /* First registration of a buffer misses any registration cache */
+        if (i == 0)
+            times.first = (create + serialize + free_time) * 1e6;
+        if (i < skip)
+            continue;
+
+        times.create += create;
+        times.serialize += serialize;
+        times.free += free_time;
+    }
+
+    times.create *= 1e6 / (double) loop;
+    times.serialize *= 1e6 / (double) loop;
+    times.free *= 1e6 / (double) loop;
+
+    if (info->rank == 0)
+        hg_perf_print_reg(buf_size, &times);
+
+    return HG_SUCCESS;
+
+error:
+    (void) HG_Bulk_free(bulk);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info;
+    struct hg_bulk_create_info info;
+    size_t page_size = (size_t) hg_mem_get_page_size(),
+           hugepage_size = (size_t) hg_mem_get_hugepage_size(), size_min,
+           size_max, size;
+    enum hg_bulk_create_mem_kind kind;
+    hg_return_t hg_ret;
+
+    /* Registration is local, no target is needed */
+    memset(&hg_test_info, 0, sizeof(hg_test_info));
+    memset(&info, 0, sizeof(info));
+    hg_test_info.na_test_info.self_send = true;
+
+    /* Initialize the interface */
+    hg_ret = HG_Test_init(argc, argv, &hg_test_info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Test_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    info.hg_class = hg_test_info.hg_class;
+    info.loop = hg_test_info.na_test_info.loop;
+    info.rank = hg_test_info.na_test_info.mpi_comm_rank;
+
+#ifndef HG_TEST_HAS_CUDA
+    HG_TEST_CHECK_ERROR(hg_test_info.na_test_info.device, error, hg_ret,
+        HG_OPNOTSUPPORTED,
+        "Device memory requested but CUDA support was not enabled");
+#endif
+
+    info.segment_count =
+        (hg_test_info.segment_count > 1) ? hg_test_info.segment_count : 1;
+    info.bufs = (void **) malloc(info.segment_count * sizeof(*info.bufs));
+    HG_TEST_CHECK_ERROR(info.bufs == NULL, error, hg_ret, HG_NOMEM,
+        "Could not allocate array of %zu segments", info.segment_count);
+    info.lens = (hg_size_t *) malloc(info.segment_count * sizeof(*info.lens));
+    HG_TEST_CHECK_ERROR(info.lens == NULL, error, hg_ret, HG_NOMEM,
+        "Could not allocate array of %zu segment sizes", info.segment_count);
+
+    /* Every segment holds at least one byte */
+    size_min = MAX(hg_test_info.na_test_info.buf_size_min, info.segment_count);
+    size_max = (hg_test_info.na_test_info.buf_size_max > 0)
+                   ? hg_test_info.na_test_info.buf_size_max
+                   : HG_BULK_CREATE_SIZE_MAX;
+
+    for (kind = HG_BULK_CREATE_MEM_HOST; kind <= HG_BULK_CREATE_MEM_DEVICE;
+         kind++) {
+        size_t kind_page_size =
+            (kind == HG_BULK_CREATE_MEM_HUGE)   ? hugepage_size
+            : (kind == HG_BULK_CREATE_MEM_HOST) ? page_size
+                                                : 0;
+
+        /* Device memory is only registered on request */
+        if (kind == HG_BULK_CREATE_MEM_DEVICE &&
+            !hg_test_info.na_test_info.device)
+            break;
+        if (kind == HG_BULK_CREATE_MEM_HUGE && hugepage_size == 0) {
+            if (info.rank == 0)
+                printf("# Skipping %s memory, no hugepage size\n",
+                    hg_bulk_create_mem_name_g[kind]);
+            continue;
+        }
+        info.kind = kind;
+
+        if (info.rank == 0)
+            hg_perf_print_header_reg(&hg_test_info, BENCHMARK_NAME, size_min,
+                size_max, hg_bulk_create_mem_name_g[kind], kind_page_size,
+                info.segment_count);
+
+        for (size = size_min; size <= size_max; size *= 2) {
+            size_t alloc_size = size + info.segment_count *
+                                           HG_BULK_CREATE_SEG_GAP;
+            void *buf;
+
+            /* Hugepage mappings are whole pages */
+            if (kind == HG_BULK_CREATE_MEM_HUGE)
+                alloc_size = (alloc_size + hugepage_size - 1) / hugepage_size *
+                             hugepage_size;
+
+            buf = hg_bulk_create_buf_alloc(kind, alloc_size);
+            if (buf == NULL) {
+                if (info.rank == 0)
+                    printf("# Could not allocate %zu byte(s) of %s memory\n",
+                        alloc_size, hg_bulk_create_mem_name_g[kind]);
+                break;
+            }
+
+            hg_ret = hg_bulk_create_run(&info, buf, size,
+                (size > HG_PERF_LARGE_SIZE) ? HG_PERF_LAT_SKIP_LARGE
+                                            : HG_PERF_LAT_SKIP_SMALL);
+            hg_bulk_create_buf_free(kind, buf, alloc_size);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                "hg_bulk_create_run(%zu) failed (%s)", size,
+                HG_Error_to_string(hg_ret));
+        }
+    }
+
+    free(info.bufs);
+    free(info.lens);
+    free(info.serialize_buf);
+    (void) HG_Test_finalize(&hg_test_info);
+
+    return EXIT_SUCCESS;
+
+error:
+    free(info.bufs);
+    free(info.lens);
+    free(info.serialize_buf);
+    (void) HG_Test_finalize(&hg_test_info);
+
+    return EXIT_FAILURE;
+}
@@ -91,8 +91,9 @@ main(int argc, char *argv[])
     struct hg_perf_info perf_info;
     struct hg_test_info *hg_test_info;
     struct hg_perf_class_info *info;
-    size_t size;
+    size_t size, segment_count;
     hg_return_t hg_ret;
+    bool regressed;
 
     /* Initialize the interface */
     hg_ret = hg_perf_init(argc, argv, false, &perf_info);
@@ -115,23 +116,56 @@ main(int argc, char *argv[])
     if (hg_test_info->na_test_info.mpi_comm_rank == 0)
         hg_perf_print_header_bw(hg_test_info, info, BENCHMARK_NAME);
 
-    /* Bulk RPC with different sizes */
-    for (size = MAX(1, info->buf_size_min); size <= info->buf_size_max;
-         size *= 2) {
-        hg_ret = hg_perf_run(hg_test_info, info, size,
-            (size > HG_PERF_LARGE_SIZE) ? HG_PERF_LAT_SKIP_LARGE
-                                        : HG_PERF_LAT_SKIP_SMALL);
-        HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_run() failed (%s)",
-            HG_Error_to_string(hg_ret));
+    if (info->segment_max > 1) {
+        /* Bulk RPC at max size with more and more segments */
+        for (segment_count = 1;;
+             segment_count = MIN(segment_count * 2, info->segment_max)) {
+            if (segment_count > 1) {
+                hg_ret = hg_perf_bulk_segments_set(
+                    hg_test_info, info, HG_BULK_PULL, segment_count);
+                HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                    "hg_perf_bulk_segments_set() failed (%s)",
+                    HG_Error_to_string(hg_ret));
+
+                hg_ret = hg_perf_set_handles(info, HG_PERF_BW_WRITE);
+                HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                    "hg_perf_set_handles() failed (%s)",
+                    HG_Error_to_string(hg_ret));
+            }
+
+            hg_ret = hg_perf_run(hg_test_info, info, info->buf_size_max,
+                HG_PERF_LAT_SKIP_LARGE);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_run() failed (%s)",
+                HG_Error_to_string(hg_ret));
+
+            if (segment_count == info->segment_max)
+                break;
+        }
+    } else {
+        /* Bulk RPC with different sizes */
+        for (size = MAX(1, info->buf_size_min); size <= info->buf_size_max;
+             size *= 2) {
+            hg_ret = hg_perf_run(hg_test_info, info, size,
+                (size > HG_PERF_LARGE_SIZE) ? HG_PERF_LAT_SKIP_LARGE
+                                            : HG_PERF_LAT_SKIP_SMALL);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_run() failed (%s)",
+                HG_Error_to_string(hg_ret));
+        }
     }
 
     /* Finalize interface */
-    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0) {
+        if (hg_test_info->na_test_info.report_format == NA_TEST_REPORT_TEXT)
+            hg_perf_print_progress(info);
         hg_perf_send_done(info);
+    }
+
+    /* Regressions against a baseline fail the run */
+    regressed = na_test_report_end(&hg_test_info->na_test_info);
 
     hg_perf_cleanup(&perf_info);
 
-    return EXIT_SUCCESS;
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
 
 error:
     hg_perf_cleanup(&perf_info);
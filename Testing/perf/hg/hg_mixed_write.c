@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_perf.h"
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "RPC latency under write BW load"
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_perf_info perf_info;
+    struct hg_test_info *hg_test_info;
+    struct hg_perf_class_info *info, *load_info;
+    size_t size;
+    hg_return_t hg_ret;
+    bool regressed;
+
+    /* Initialize the interface */
+    hg_ret = hg_perf_init(argc, argv, false, &perf_info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    hg_test_info = &perf_info.hg_test_info;
+
+    /* Probes and background load are sent from separate classes */
+    HG_TEST_CHECK_ERROR(perf_info.class_max < 2, error, hg_ret,
+        HG_INVALID_ARG, "Background load requires a second class (-C 2)");
+    info = &perf_info.class_info[0];
+    load_info = &perf_info.class_info[1];
+
+    /* Allocate RPC buffers */
+    hg_ret = hg_perf_rpc_buf_init(info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_rpc_buf_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* Allocate bulk buffers */
+    hg_ret = hg_perf_bulk_buf_init(hg_test_info, load_info, HG_BULK_PULL);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_bulk_buf_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* Set HG handles */
+    hg_ret = hg_perf_set_handles(info, HG_PERF_RATE);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_set_handles() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    hg_ret = hg_perf_set_handles(load_info, HG_PERF_BW_WRITE);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_set_handles() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* Header info */
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        hg_perf_print_header_mixed(
+            hg_test_info, info, load_info, BENCHMARK_NAME);
+
+    /* Small RPCs of different sizes */
+    for (size = info->buf_size_min;
+         size <= MIN(info->buf_size_max, HG_PERF_LARGE_SIZE);
+         size = MAX(1, size * 2)) {
+        hg_ret = hg_perf_run_mixed(
+            hg_test_info, info, load_info, HG_PERF_BW_WRITE, size);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_perf_run_mixed() failed (%s)", HG_Error_to_string(hg_ret));
+    }
+
+    /* Finalize interface */
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0) {
+        if (hg_test_info->na_test_info.report_format == NA_TEST_REPORT_TEXT)
+            hg_perf_print_progress(info);
+        hg_perf_send_done(info);
+    }
+
+    /* Regressions against a baseline fail the run */
+    regressed = na_test_report_end(&hg_test_info->na_test_info);
+
+    hg_perf_cleanup(&perf_info);
+
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+
+error:
+    hg_perf_cleanup(&perf_info);
+
+    return EXIT_FAILURE;
+}
@@ -18,6 +18,13 @@
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Progress loop on one context */
+struct hg_perf_loop_info {
+    struct hg_perf_class_info *info; /* Class info */
+    hg_context_t *context;           /* Context progressed */
+    size_t cpu_id;                   /* CPU index used for affinity */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -27,11 +34,11 @@ hg_perf_loop_thread(void *arg);
 
 #if !defined(_WIN32) && !defined(__APPLE__)
 static hg_return_t
-hg_perf_loop_thread_set_affinity(struct hg_perf_class_info *info);
+hg_perf_loop_thread_set_affinity(size_t cpu_id);
 #endif
 
 static hg_return_t
-hg_perf_loop(struct hg_perf_class_info *info);
+hg_perf_loop(struct hg_perf_class_info *info, hg_context_t *context);
 
 /*******************/
 /* Local Variables */
@@ -41,14 +48,15 @@ hg_perf_loop(struct hg_perf_class_info *info);
 static HG_THREAD_RETURN_TYPE
 hg_perf_loop_thread(void *arg)
 {
+    struct hg_perf_loop_info *loop_info = (struct hg_perf_loop_info *) arg;
     hg_thread_ret_t tret = (hg_thread_ret_t) 0;
     hg_return_t hg_ret;
 
 #if !defined(_WIN32) && !defined(__APPLE__)
-    (void) hg_perf_loop_thread_set_affinity((struct hg_perf_class_info *) arg);
+    (void) hg_perf_loop_thread_set_affinity(loop_info->cpu_id);
 #endif
 
-    hg_ret = hg_perf_loop((struct hg_perf_class_info *) arg);
+    hg_ret = hg_perf_loop(loop_info->info, loop_info->context);
     HG_TEST_CHECK_HG_ERROR(
         done, hg_ret, "hg_perf_loop() failed (%s)", HG_Error_to_string(hg_ret));
 
@@ -60,7 +68,7 @@ done:
 /*---------------------------------------------------------------------------*/
 #if !defined(_WIN32) && !defined(__APPLE__)
 static hg_return_t
-hg_perf_loop_thread_set_affinity(struct hg_perf_class_info *info)
+hg_perf_loop_thread_set_affinity(size_t cpu_id)
 {
     hg_cpu_set_t orig_cpu_set, new_cpu_set;
     size_t cpu, i = 0;
@@ -72,15 +80,16 @@ hg_perf_loop_thread_set_affinity(struct hg_perf_class_info *info)
     rc = hg_thread_getaffinity(hg_thread_self(), &orig_cpu_set);
     HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_PROTOCOL_ERROR,
         "Could not retrieve CPU affinity");
-    HG_TEST_CHECK_ERROR(info->class_id > CPU_COUNT(&orig_cpu_set), error, ret,
-        HG_PROTOCOL_ERROR,
-        "Could not set affinity, class ID (%d) > CPU count (%d)",
-        info->class_id, CPU_COUNT(&orig_cpu_set));
+    HG_TEST_CHECK_ERROR(CPU_COUNT(&orig_cpu_set) == 0, error, ret,
+        HG_PROTOCOL_ERROR, "Could not set affinity, empty CPU set");
+
+    /* Loops share CPUs once there are more loops than CPUs */
+    cpu_id %= (size_t) CPU_COUNT(&orig_cpu_set);
 
     CPU_ZERO(&new_cpu_set);
     for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
         if (CPU_ISSET(cpu, &orig_cpu_set)) {
-            if (i == (size_t) info->class_id) {
+            if (i == cpu_id) {
                 CPU_SET(cpu, &new_cpu_set);
                 break;
             }
@@ -99,7 +108,7 @@ hg_perf_loop_thread_set_affinity(struct hg_perf_class_info *info)
     for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
         if (CPU_ISSET(cpu, &orig_cpu_set))
             HG_TEST_LOG_DEBUG(
-                "Class ID %d bound to CPU %zu\n", info->class_id, cpu);
+                "Loop ID %zu bound to CPU %zu\n", cpu_id, cpu);
 
     return HG_SUCCESS;
 
@@ -110,7 +119,7 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_perf_loop(struct hg_perf_class_info *info)
+hg_perf_loop(struct hg_perf_class_info *info, hg_context_t *context)
 {
     hg_return_t ret;
 
@@ -118,7 +127,7 @@ hg_perf_loop(struct hg_perf_class_info *info)
         unsigned int actual_count = 0;
 
         do {
-            ret = HG_Trigger(info->context, 0, 1, &actual_count);
+            ret = HG_Trigger(context, 0, 1, &actual_count);
         } while ((ret == HG_SUCCESS) && actual_count);
         HG_TEST_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
             "HG_Trigger() failed (%s)", HG_Error_to_string(ret));
@@ -126,7 +135,7 @@ hg_perf_loop(struct hg_perf_class_info *info)
         if (info->done)
             break;
 
-        ret = HG_Progress(info->context, 1000);
+        ret = HG_Progress(context, 1000);
     } while (ret == HG_SUCCESS || ret == HG_TIMEOUT);
     HG_TEST_CHECK_ERROR_NORET(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
         "HG_Progress() failed (%s)", HG_Error_to_string(ret));
@@ -143,8 +152,10 @@ main(int argc, char *argv[])
 {
     struct hg_perf_info info;
     struct hg_test_info *hg_test_info;
-    hg_return_t hg_ret;
+    struct hg_perf_loop_info *loop_infos = NULL;
     hg_thread_t *progress_threads = NULL;
+    size_t loop_max = 0, thread_count, i, j, k;
+    hg_return_t hg_ret;
 
     /* Initialize the interface */
     hg_ret = hg_perf_init(argc, argv, true, &info);
@@ -152,43 +163,80 @@ main(int argc, char *argv[])
         HG_Error_to_string(hg_ret));
     hg_test_info = &info.hg_test_info;
 
-    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
-        HG_TEST_READY_MSG();
+    /* Each context of each class is progressed by one or more threads */
+    thread_count = (hg_test_info->progress_thread_count > 1)
+                       ? hg_test_info->progress_thread_count
+                       : 1;
+#ifndef HG_HAS_MULTI_PROGRESS
+    HG_TEST_CHECK_ERROR_NORET(thread_count > 1, error,
+        "Multiple progress threads per context require multi-progress "
+        "support (HG_ALLOW_MULTI_PROGRESS)");
+#endif
+    for (i = 0; i < info.class_max; i++)
+        loop_max += info.class_info[i].context_max * thread_count;
+
+    loop_infos =
+        (struct hg_perf_loop_info *) malloc(sizeof(*loop_infos) * loop_max);
+    HG_TEST_CHECK_ERROR_NORET(
+        loop_infos == NULL, error, "Could not allocate loop infos");
+
+    for (i = 0, k = 0; i < info.class_max; i++) {
+        struct hg_perf_class_info *class_info = &info.class_info[i];
+
+        for (j = 0; j < class_info->context_max * thread_count; j++, k++)
+            loop_infos[k] = (struct hg_perf_loop_info){.info = class_info,
+                .context = (j / thread_count == 0)
+                               ? class_info->context
+                               : class_info->contexts[j / thread_count - 1],
+                .cpu_id = k};
+    }
 
-    if (info.class_max > 1) {
-        size_t i;
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0) {
+        if (loop_max > 1)
+            printf("# Progressing %zu context(s) per class with %zu "
+                   "thread(s) each%s\n",
+                info.class_info[0].context_max, thread_count,
+                hg_test_info->offload ? ", handlers offloaded" : "");
+        HG_TEST_READY_MSG();
+    }
 
+    if (loop_max > 1) {
         progress_threads =
-            (hg_thread_t *) malloc(sizeof(*progress_threads) * info.class_max);
+            (hg_thread_t *) malloc(sizeof(*progress_threads) * loop_max);
         HG_TEST_CHECK_ERROR_NORET(progress_threads == NULL, error,
             "Could not allocate progress threads");
 
-        for (i = 0; i < info.class_max; i++) {
+        for (i = 0; i < loop_max; i++) {
             int rc = hg_thread_create(
-                &progress_threads[i], hg_perf_loop_thread, &info.class_info[i]);
+                &progress_threads[i], hg_perf_loop_thread, &loop_infos[i]);
             HG_TEST_CHECK_ERROR_NORET(
                 rc != 0, error, "hg_thread_create() failed");
         }
 
-        for (i = 0; i < info.class_max; i++)
+        for (i = 0; i < loop_max; i++)
             hg_thread_join(progress_threads[i]);
     } else {
-        hg_ret = hg_perf_loop(&info.class_info[0]);
+        hg_ret = hg_perf_loop(loop_infos[0].info, loop_infos[0].context);
         HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_loop() failed (%s)",
             HG_Error_to_string(hg_ret));
     }
 
     /* Finalize interface */
-    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0) {
+        for (i = 0; i < info.class_max; i++)
+            hg_perf_print_progress(&info.class_info[i]);
         printf("Finalizing...\n");
+    }
     hg_perf_cleanup(&info);
     free(progress_threads);
+    free(loop_infos);
 
     return EXIT_SUCCESS;
 
 error:
     hg_perf_cleanup(&info);
     free(progress_threads);
+    free(loop_infos);
 
     return EXIT_FAILURE;
 }
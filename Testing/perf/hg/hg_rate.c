@@ -35,6 +35,10 @@ static hg_return_t
 hg_perf_run(const struct hg_test_info *hg_test_info,
     struct hg_perf_class_info *info, size_t buf_size, size_t skip);
 
+static hg_return_t
+hg_perf_run_sweep(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, size_t buf_size);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -108,6 +112,36 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_run_sweep(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, size_t buf_size)
+{
+    double rate = hg_test_info->rate;
+    int step;
+
+    /* Double offered rate until the server can no longer keep up */
+    for (step = 0; step < HG_PERF_OPEN_STEP_MAX; step++, rate *= 2) {
+        struct hg_perf_open_result result;
+        hg_return_t ret;
+
+        ret = hg_perf_run_open(hg_test_info, info, buf_size, rate, &result);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_run_open() failed (%s)",
+            HG_Error_to_string(ret));
+
+        if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+            hg_perf_print_open(buf_size, &result);
+
+        if (result.achieved < HG_PERF_OPEN_SATURATION * result.offered)
+            break;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return HG_OTHER_ERROR;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 main(int argc, char *argv[])
@@ -117,6 +151,7 @@ main(int argc, char *argv[])
     struct hg_perf_class_info *info;
     size_t size;
     hg_return_t hg_ret;
+    bool regressed;
 
     /* Initialize the interface */
     hg_ret = hg_perf_init(argc, argv, false, &perf_info);
@@ -136,8 +171,23 @@ main(int argc, char *argv[])
         HG_Error_to_string(hg_ret));
 
     /* Header info */
-    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
-        hg_perf_print_header_lat(hg_test_info, info, BENCHMARK_NAME);
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0) {
+        if (hg_test_info->rate > 0)
+            hg_perf_print_header_open(hg_test_info, info, BENCHMARK_NAME);
+        else
+            hg_perf_print_header_lat(hg_test_info, info, BENCHMARK_NAME);
+    }
+
+    /* Open-loop rate sweep */
+    if (hg_test_info->rate > 0) {
+        for (size = info->buf_size_min; size <= info->buf_size_max;
+             size = MAX(1, size * 2)) {
+            hg_ret = hg_perf_run_sweep(hg_test_info, info, size);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                "hg_perf_run_sweep() failed (%s)", HG_Error_to_string(hg_ret));
+        }
+        goto done;
+    }
 
     /* NULL RPC */
     if (info->buf_size_min == 0) {
@@ -156,13 +206,20 @@ main(int argc, char *argv[])
             HG_Error_to_string(hg_ret));
     }
 
+done:
     /* Finalize interface */
-    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0) {
+        if (hg_test_info->na_test_info.report_format == NA_TEST_REPORT_TEXT)
+            hg_perf_print_progress(info);
         hg_perf_send_done(info);
+    }
+
+    /* Regressions against a baseline fail the run */
+    regressed = na_test_report_end(&hg_test_info->na_test_info);
 
     hg_perf_cleanup(&perf_info);
 
-    return EXIT_SUCCESS;
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
 
 error:
     hg_perf_cleanup(&perf_info);
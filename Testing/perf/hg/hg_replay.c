@@ -0,0 +1,556 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_perf.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#    include <sys/uio.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "Replay of captured RPCs"
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+#ifdef _WIN32
+struct iovec {
+    void *iov_base; /* Pointer to data.  */
+    size_t iov_len; /* Length of data.  */
+};
+#endif
+
+/* Captured RPCs are replayed either as rate RPCs or as bulk RPCs */
+enum hg_replay_kind { HG_REPLAY_RPC, HG_REPLAY_BULK, HG_REPLAY_KIND_MAX };
+
+/* Replay state */
+struct hg_replay_state {
+    struct hg_replay_slot *slots;          /* One slot per handle */
+    size_t *free_ids;                      /* Stack of free handle IDs */
+    double *latencies[HG_REPLAY_KIND_MAX]; /* Replayed latencies (us) */
+    size_t counts[HG_REPLAY_KIND_MAX];     /* Number of replayed RPCs */
+    size_t free_count;                     /* Number of free handles */
+    size_t complete_count;                 /* Number of completed RPCs */
+    hg_return_t ret;                       /* First error */
+};
+
+/* Replayed RPC in flight */
+struct hg_replay_slot {
+    struct hg_replay_state *state; /* Replay state */
+    hg_time_t start;               /* Scheduled arrival time */
+    size_t handle_id;              /* Handle used */
+    enum hg_perf_rpc_id rpc_id;    /* RPC ID handle is set to */
+    enum hg_replay_kind kind;      /* Kind of RPC in flight */
+};
+
+/* Captured values of each kind of RPC */
+struct hg_replay_capture {
+    double *handler_times[HG_REPLAY_KIND_MAX]; /* Callback times (us) */
+    size_t counts[HG_REPLAY_KIND_MAX];         /* Number of RPCs */
+    size_t clamp_count;                        /* Sizes above buf size max */
+    double duration;                           /* Capture duration (s) */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static hg_return_t
+hg_replay_load(
+    const char *path, struct hg_capture_record **records_p, size_t *count_p);
+
+static int
+hg_replay_record_cmp(const void *a, const void *b);
+
+static int
+hg_replay_double_cmp(const void *a, const void *b);
+
+static double
+hg_replay_percentile(const double *values, size_t count, double percentile);
+
+static enum hg_replay_kind
+hg_replay_get_kind(const struct hg_capture_record *record);
+
+static hg_return_t
+hg_replay_capture_init(const struct hg_perf_class_info *info,
+    const struct hg_capture_record *records, size_t count,
+    struct hg_replay_capture *capture);
+
+static void
+hg_replay_capture_free(struct hg_replay_capture *capture);
+
+static hg_return_t
+hg_replay_set_handle(const struct hg_perf_class_info *info,
+    struct hg_replay_slot *slot, enum hg_perf_rpc_id rpc_id);
+
+static hg_return_t
+hg_replay_cb(const struct hg_cb_info *hg_cb_info);
+
+static hg_return_t
+hg_replay_run(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, const struct hg_capture_record *records,
+    size_t count, struct hg_replay_state *state, double *duration);
+
+static void
+hg_replay_print(enum hg_replay_kind kind,
+    const struct hg_replay_capture *capture,
+    const struct hg_replay_state *state, double duration);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static const char *const hg_replay_kind_name_g[] = {
+    [HG_REPLAY_RPC] = "rpc", [HG_REPLAY_BULK] = "bulk"};
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_load(
+    const char *path, struct hg_capture_record **records_p, size_t *count_p)
+{
+    struct hg_capture_header header;
+    struct hg_capture_record *records = NULL;
+    FILE *file;
+    long file_size;
+    size_t count;
+    hg_return_t ret;
+
+    file = fopen(path, "rb");
+    HG_TEST_CHECK_ERROR(file == NULL, error, ret, HG_NOENTRY,
+        "Could not open capture file %s", path);
+
+    HG_TEST_CHECK_ERROR(fread(&header, sizeof(header), 1, file) != 1,
+        error_close, ret, HG_PROTOCOL_ERROR, "Could not read capture header");
+    HG_TEST_CHECK_ERROR(header.magic != HG_CAPTURE_MAGIC ||
+                            header.version != HG_CAPTURE_VERSION ||
+                            header.record_size != sizeof(*records),
+        error_close, ret, HG_PROTOCOL_ERROR,
+        "Unsupported capture file (magic=%#x, version=%u, record_size=%u)",
+        header.magic, header.version, header.record_size);
+
+    /* Records of an interrupted capture may be truncated */
+    HG_TEST_CHECK_ERROR(fseek(file, 0, SEEK_END) != 0 ||
+                            (file_size = ftell(file)) < 0 ||
+                            fseek(file, (long) sizeof(header), SEEK_SET) != 0,
+        error_close, ret, HG_PROTOCOL_ERROR, "Could not get capture size");
+    count = ((size_t) file_size - sizeof(header)) / sizeof(*records);
+    HG_TEST_CHECK_ERROR(count == 0, error_close, ret, HG_INVALID_ARG,
+        "No RPC in capture file %s", path);
+
+    records = (struct hg_capture_record *) malloc(count * sizeof(*records));
+    HG_TEST_CHECK_ERROR(records == NULL, error_close, ret, HG_NOMEM,
+        "Could not allocate %zu capture records", count);
+    HG_TEST_CHECK_ERROR(fread(records, sizeof(*records), count, file) != count,
+        error_free, ret, HG_PROTOCOL_ERROR, "Could not read capture records");
+    fclose(file);
+
+    /* Records are appended on completion, not on arrival */
+    qsort(records, count, sizeof(*records), hg_replay_record_cmp);
+
+    *records_p = records;
+    *count_p = count;
+
+    return HG_SUCCESS;
+
+error_free:
+    free(records);
+error_close:
+    fclose(file);
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_replay_record_cmp(const void *a, const void *b)
+{
+    hg_uint64_t x = ((const struct hg_capture_record *) a)->arrival,
+                y = ((const struct hg_capture_record *) b)->arrival;
+
+    return (x > y) - (x < y);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_replay_double_cmp(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+/*---------------------------------------------------------------------------*/
+static double
+hg_replay_percentile(const double *values, size_t count, double percentile)
+{
+    size_t rank = (size_t) ceil(percentile / 100.0 * (double) count);
+
+    if (count == 0)
+        return 0;
+
+    return values[(rank > 0) ? MIN(rank, count) - 1 : 0];
+}
+
+/*---------------------------------------------------------------------------*/
+static enum hg_replay_kind
+hg_replay_get_kind(const struct hg_capture_record *record)
+{
+    return (record->bulk_size > 0) ? HG_REPLAY_BULK : HG_REPLAY_RPC;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_capture_init(const struct hg_perf_class_info *info,
+    const struct hg_capture_record *records, size_t count,
+    struct hg_replay_capture *capture)
+{
+    hg_return_t ret;
+    size_t i;
+
+    memset(capture, 0, sizeof(*capture));
+    for (i = 0; i < HG_REPLAY_KIND_MAX; i++) {
+        capture->handler_times[i] = (double *) malloc(count * sizeof(double));
+        HG_TEST_CHECK_ERROR(capture->handler_times[i] == NULL, error, ret,
+            HG_NOMEM, "Could not allocate handler times");
+    }
+
+    for (i = 0; i < count; i++) {
+        enum hg_replay_kind kind = hg_replay_get_kind(&records[i]);
+        size_t size = (kind == HG_REPLAY_BULK) ? records[i].bulk_size
+                                                : records[i].in_size;
+
+        capture->handler_times[kind][capture->counts[kind]++] =
+            (double) records[i].handler_time / 1e3;
+        if (size > info->buf_size_max)
+            capture->clamp_count++;
+    }
+    for (i = 0; i < HG_REPLAY_KIND_MAX; i++)
+        qsort(capture->handler_times[i], capture->counts[i], sizeof(double),
+            hg_replay_double_cmp);
+    capture->duration =
+        (double) (records[count - 1].arrival - records[0].arrival) / 1e9;
+
+    return HG_SUCCESS;
+
+error:
+    hg_replay_capture_free(capture);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_replay_capture_free(struct hg_replay_capture *capture)
+{
+    size_t i;
+
+    for (i = 0; i < HG_REPLAY_KIND_MAX; i++) {
+        free(capture->handler_times[i]);
+        capture->handler_times[i] = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_set_handle(const struct hg_perf_class_info *info,
+    struct hg_replay_slot *slot, enum hg_perf_rpc_id rpc_id)
+{
+    hg_return_t ret;
+
+    if (slot->rpc_id == rpc_id)
+        return HG_SUCCESS;
+
+    ret = HG_Reset(info->handles[slot->handle_id],
+        info->target_addrs[slot->handle_id % info->target_addr_max],
+        (hg_id_t) rpc_id);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Reset() failed (%s)", HG_Error_to_string(ret));
+
+    if (info->context_max > 1) {
+        ret = HG_Set_target_id(info->handles[slot->handle_id],
+            (hg_uint8_t) (slot->handle_id % info->context_max));
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Set_target_id() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+    slot->rpc_id = rpc_id;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_replay_slot *slot = (struct hg_replay_slot *) hg_cb_info->arg;
+    struct hg_replay_state *state = slot->state;
+    hg_time_t now;
+
+    hg_time_get_current(&now);
+    if (hg_cb_info->ret != HG_SUCCESS && state->ret == HG_SUCCESS)
+        state->ret = hg_cb_info->ret;
+    state->latencies[slot->kind][state->counts[slot->kind]++] =
+        hg_time_to_double(hg_time_subtract(now, slot->start)) * 1e6;
+    state->free_ids[state->free_count++] = slot->handle_id;
+    state->complete_count++;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_replay_run(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, const struct hg_capture_record *records,
+    size_t count, struct hg_replay_state *state, double *duration)
+{
+    size_t sent = 0, i;
+    hg_time_t t0, t_end, next;
+    hg_return_t ret;
+
+    for (i = 0; i < info->handle_max; i++) {
+        state->slots[i].state = state;
+        state->slots[i].handle_id = i;
+        state->slots[i].rpc_id = HG_PERF_RATE;
+        state->free_ids[state->free_count++] = info->handle_max - 1 - i;
+    }
+
+    if (hg_test_info->na_test_info.mpi_comm_size > 1)
+        NA_Test_barrier(&hg_test_info->na_test_info);
+
+    /* RPCs are sent at their captured arrival times regardless of
+     * completions, latencies are measured from these arrival times so that
+     * RPCs delayed by a lack of free handles are not hidden */
+    hg_time_get_current(&t0);
+    next = t0;
+    while (state->complete_count < count) {
+        unsigned int actual_count = 0;
+        hg_time_t now;
+
+        hg_time_get_current(&now);
+        while (sent < count && state->free_count > 0 &&
+               !hg_time_less(now, next)) {
+            const struct hg_capture_record *record = &records[sent];
+            struct hg_replay_slot *slot =
+                &state->slots[state->free_ids[--state->free_count]];
+
+            slot->start = next;
+            slot->kind = hg_replay_get_kind(record);
+            if (slot->kind == HG_REPLAY_BULK) {
+                struct hg_perf_bulk_info in_struct = {
+                    .comm_rank =
+                        (uint32_t) hg_test_info->na_test_info.mpi_comm_rank,
+                    .handle_id =
+                        (uint32_t) (slot->handle_id / info->target_addr_max),
+                    .size = (uint32_t) MIN(
+                        record->bulk_size, info->buf_size_max)};
+
+                ret = hg_replay_set_handle(info, slot, HG_PERF_BW_WRITE);
+                HG_TEST_CHECK_HG_ERROR(error, ret,
+                    "hg_replay_set_handle() failed (%s)",
+                    HG_Error_to_string(ret));
+                ret = HG_Forward(info->handles[slot->handle_id], hg_replay_cb,
+                    slot, &in_struct);
+            } else {
+                struct iovec in_struct = {.iov_base = info->rpc_buf,
+                    .iov_len = MIN(record->in_size, info->buf_size_max)};
+
+                ret = hg_replay_set_handle(info, slot, HG_PERF_RATE);
+                HG_TEST_CHECK_HG_ERROR(error, ret,
+                    "hg_replay_set_handle() failed (%s)",
+                    HG_Error_to_string(ret));
+                ret = HG_Forward(info->handles[slot->handle_id], hg_replay_cb,
+                    slot, &in_struct);
+            }
+            HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Forward() failed (%s)",
+                HG_Error_to_string(ret));
+            sent++;
+
+            if (sent < count)
+                next = hg_time_add(t0,
+                    hg_time_from_double(
+                        (double) (records[sent].arrival - records[0].arrival) /
+                        1e9));
+        }
+
+        ret = HG_Progress(info->context, 0);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+        do {
+            ret = HG_Trigger(info->context, 0, 64, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count > 0);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Trigger() failed (%s)", HG_Error_to_string(ret));
+        ret = state->ret;
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+    }
+    hg_time_get_current(&t_end);
+
+    if (hg_test_info->na_test_info.mpi_comm_size > 1)
+        NA_Test_barrier(&hg_test_info->na_test_info);
+
+    for (i = 0; i < HG_REPLAY_KIND_MAX; i++)
+        qsort(state->latencies[i], state->counts[i], sizeof(double),
+            hg_replay_double_cmp);
+    *duration = hg_time_to_double(hg_time_subtract(t_end, t0));
+
+    return HG_SUCCESS;
+
+error:
+    /* Let RPCs in flight complete before releasing slots */
+    while (state->complete_count < sent) {
+        unsigned int actual_count = 0;
+
+        if (HG_Progress(info->context, 100) != HG_SUCCESS ||
+            HG_Trigger(info->context, 0, 64, &actual_count) != HG_SUCCESS)
+            break;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_replay_print(enum hg_replay_kind kind,
+    const struct hg_replay_capture *capture,
+    const struct hg_replay_state *state, double duration)
+{
+    const double *latencies = state->latencies[kind];
+    size_t count = state->counts[kind];
+    struct hg_perf_replay_result result;
+
+    if (count == 0)
+        return;
+
+    result.count = count;
+    result.captured =
+        (capture->duration > 0) ? (double) count / capture->duration : 0;
+    result.achieved = (double) count / duration;
+    result.handler_p50 = hg_replay_percentile(
+        capture->handler_times[kind], capture->counts[kind], 50.0);
+    result.p50 = hg_replay_percentile(latencies, count, 50.0);
+    result.p99 = hg_replay_percentile(latencies, count, 99.0);
+    result.p999 = hg_replay_percentile(latencies, count, 99.9);
+    result.max = latencies[count - 1];
+
+    hg_perf_print_replay(hg_replay_kind_name_g[kind], &result);
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_perf_info perf_info;
+    struct hg_test_info *hg_test_info;
+    struct hg_perf_class_info *info;
+    struct hg_capture_record *records = NULL;
+    struct hg_replay_capture capture;
+    struct hg_replay_state state;
+    size_t count = 0, i;
+    double duration = 0;
+    hg_return_t hg_ret;
+
+    memset(&capture, 0, sizeof(capture));
+    memset(&state, 0, sizeof(state));
+
+    /* Initialize the interface */
+    hg_ret = hg_perf_init(argc, argv, false, &perf_info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    hg_test_info = &perf_info.hg_test_info;
+    info = &perf_info.class_info[0];
+
+    /* Load captured RPCs */
+    HG_TEST_CHECK_ERROR(hg_test_info->capture == NULL, error, hg_ret,
+        HG_INVALID_ARG, "Replay requires a capture file (-j)");
+    hg_ret = hg_replay_load(hg_test_info->capture, &records, &count);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_replay_load() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    hg_ret = hg_replay_capture_init(info, records, count, &capture);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+        "hg_replay_capture_init() failed (%s)", HG_Error_to_string(hg_ret));
+
+    /* Allocate RPC buffers */
+    hg_ret = hg_perf_rpc_buf_init(info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_rpc_buf_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* Allocate bulk buffers, only if needed */
+    if (capture.counts[HG_REPLAY_BULK] > 0) {
+        hg_ret = hg_perf_bulk_buf_init(hg_test_info, info, HG_BULK_PULL);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_perf_bulk_buf_init() failed (%s)", HG_Error_to_string(hg_ret));
+    }
+
+    /* Set HG handles */
+    hg_ret = hg_perf_set_handles(info, HG_PERF_RATE);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_set_handles() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* Allocate replay state */
+    state.slots = (struct hg_replay_slot *) malloc(
+        info->handle_max * sizeof(*state.slots));
+    state.free_ids = (size_t *) malloc(info->handle_max * sizeof(size_t));
+    HG_TEST_CHECK_ERROR(state.slots == NULL || state.free_ids == NULL, error,
+        hg_ret, HG_NOMEM, "Could not allocate replay state");
+    for (i = 0; i < HG_REPLAY_KIND_MAX; i++) {
+        state.latencies[i] =
+            (double *) malloc(MAX(capture.counts[i], 1) * sizeof(double));
+        HG_TEST_CHECK_ERROR(state.latencies[i] == NULL, error, hg_ret,
+            HG_NOMEM, "Could not allocate latencies");
+    }
+
+    /* Header info */
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        hg_perf_print_header_replay(hg_test_info, info, BENCHMARK_NAME,
+            count, capture.duration, capture.clamp_count);
+
+    hg_ret =
+        hg_replay_run(hg_test_info, info, records, count, &state, &duration);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_replay_run() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0) {
+        for (i = 0; i < HG_REPLAY_KIND_MAX; i++)
+            hg_replay_print(
+                (enum hg_replay_kind) i, &capture, &state, duration);
+    }
+
+    /* Finalize interface */
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        hg_perf_send_done(info);
+
+    for (i = 0; i < HG_REPLAY_KIND_MAX; i++)
+        free(state.latencies[i]);
+    free(state.slots);
+    free(state.free_ids);
+    hg_replay_capture_free(&capture);
+    free(records);
+    hg_perf_cleanup(&perf_info);
+
+    return EXIT_SUCCESS;
+
+error:
+    for (i = 0; i < HG_REPLAY_KIND_MAX; i++)
+        free(state.latencies[i]);
+    free(state.slots);
+    free(state.free_ids);
+    hg_replay_capture_free(&capture);
+    free(records);
+    hg_perf_cleanup(&perf_info);
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,288 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_perf.h"
+
+#ifndef _WIN32
+#    include <sys/uio.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "RPC scaling"
+
+/* Column width of scaling results, matches header */
+#define NWIDTH_SCALE 14
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+#ifdef _WIN32
+struct iovec {
+    void *iov_base; /* Pointer to data.  */
+    size_t iov_len; /* Length of data.  */
+};
+#endif
+
+/* Traffic patterns */
+enum hg_perf_scale_mode {
+    HG_PERF_MANY_TO_ONE, /* All clients target the first server */
+    HG_PERF_ALL_TO_ALL   /* Each client spreads RPCs over all servers */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static hg_return_t
+hg_perf_scale_set_targets(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, enum hg_perf_scale_mode mode);
+
+static hg_return_t
+hg_perf_scale_run(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, enum hg_perf_scale_mode mode,
+    size_t buf_size, size_t skip);
+
+static void
+hg_perf_scale_print(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info, enum hg_perf_scale_mode mode,
+    size_t buf_size, hg_time_t t, const double *client_rates,
+    const struct hg_perf_server_stats *stats_diff);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static const char *const hg_perf_scale_mode_name_g[] = {
+    [HG_PERF_MANY_TO_ONE] = "many-to-one", [HG_PERF_ALL_TO_ALL] = "all-to-all"};
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_scale_set_targets(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, enum hg_perf_scale_mode mode)
+{
+    size_t rank = (size_t) hg_test_info->na_test_info.mpi_comm_rank, i;
+    hg_return_t ret;
+
+    for (i = 0; i < info->handle_max; i++) {
+        /* Offset by rank so that clients do not all start on the same server */
+        size_t target = (mode == HG_PERF_ALL_TO_ALL)
+                            ? (rank + i) % info->target_addr_max
+                            : 0;
+
+        ret = HG_Reset(info->handles[i], info->target_addrs[target],
+            (hg_id_t) HG_PERF_RATE);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Reset() failed (%s)", HG_Error_to_string(ret));
+
+        if (info->context_max > 1) {
+            ret = HG_Set_target_id(
+                info->handles[i], (hg_uint8_t) (i % info->context_max));
+            HG_TEST_CHECK_HG_ERROR(error, ret,
+                "HG_Set_target_id() failed (%s)", HG_Error_to_string(ret));
+        }
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_scale_run(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, enum hg_perf_scale_mode mode,
+    size_t buf_size, size_t skip)
+{
+    struct iovec in_struct = {.iov_base = info->rpc_buf, .iov_len = buf_size};
+    struct hg_perf_server_stats stats_start, stats_end, stats_diff;
+    size_t comm_size = (size_t) hg_test_info->na_test_info.mpi_comm_size;
+    bool root = (hg_test_info->na_test_info.mpi_comm_rank == 0);
+    double *client_rates = NULL, client_rate;
+    hg_time_t t1, t2, t_client;
+    hg_return_t ret;
+    size_t i;
+
+    if (root) {
+        client_rates = (double *) malloc(comm_size * sizeof(double));
+        HG_TEST_CHECK_ERROR(client_rates == NULL, error, ret, HG_NOMEM,
+            "Could not allocate array of client rates");
+    }
+
+    ret = hg_perf_scale_set_targets(hg_test_info, info, mode);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_perf_scale_set_targets() failed (%s)", HG_Error_to_string(ret));
+
+    /* Warm up so that server handle pools are extended before stats */
+    for (i = 0; i < skip + (size_t) hg_test_info->na_test_info.loop; i++) {
+        struct hg_perf_request args = {
+            .expected_count = (int32_t) info->handle_max,
+            .complete_count = 0,
+            .request = info->request};
+        unsigned int j;
+
+        if (i == skip) {
+            if (comm_size > 1)
+                NA_Test_barrier(&hg_test_info->na_test_info);
+
+            /* Handle 0 is temporarily used for the stats RPC */
+            if (root) {
+                ret = hg_perf_get_server_stats(info, &stats_start);
+                HG_TEST_CHECK_HG_ERROR(error, ret,
+                    "hg_perf_get_server_stats() failed (%s)",
+                    HG_Error_to_string(ret));
+                ret = hg_perf_scale_set_targets(hg_test_info, info, mode);
+                HG_TEST_CHECK_HG_ERROR(error, ret,
+                    "hg_perf_scale_set_targets() failed (%s)",
+                    HG_Error_to_string(ret));
+            }
+
+            if (comm_size > 1)
+                NA_Test_barrier(&hg_test_info->na_test_info);
+            hg_time_get_current(&t1);
+        }
+
+        hg_request_reset(info->request);
+
+        for (j = 0; j < info->handle_max; j++) {
+            ret = HG_Forward(
+                info->handles[j], hg_perf_request_complete, &args, &in_struct);
+            HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Forward() failed (%s)",
+                HG_Error_to_string(ret));
+        }
+
+        hg_request_wait(info->request, HG_MAX_IDLE_TIME, NULL);
+    }
+
+    /* Per-client rate is measured before waiting for other clients */
+    hg_time_get_current(&t_client);
+    client_rate =
+        (double) ((size_t) hg_test_info->na_test_info.loop * info->handle_max) /
+        hg_time_to_double(hg_time_subtract(t_client, t1));
+
+    if (comm_size > 1)
+        NA_Test_barrier(&hg_test_info->na_test_info);
+
+    hg_time_get_current(&t2);
+
+    NA_Test_gather((const char *) &client_rate, (char *) client_rates,
+        (int) sizeof(client_rate), 0, &hg_test_info->na_test_info);
+
+    if (root) {
+        ret = hg_perf_get_server_stats(info, &stats_end);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "hg_perf_get_server_stats() failed (%s)", HG_Error_to_string(ret));
+
+        stats_diff = (struct hg_perf_server_stats){
+            .cpu_time = stats_end.cpu_time - stats_start.cpu_time,
+            .rpc_count = stats_end.rpc_count - stats_start.rpc_count};
+
+        hg_perf_scale_print(hg_test_info, info, mode, buf_size,
+            hg_time_subtract(t2, t1), client_rates, &stats_diff);
+    }
+
+    free(client_rates);
+
+    return HG_SUCCESS;
+
+error:
+    free(client_rates);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_perf_scale_print(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info, enum hg_perf_scale_mode mode,
+    size_t buf_size, hg_time_t t, const double *client_rates,
+    const struct hg_perf_server_stats *stats_diff)
+{
+    size_t comm_size = (size_t) hg_test_info->na_test_info.mpi_comm_size,
+           rpc_count = (size_t) hg_test_info->na_test_info.loop *
+                       info->handle_max * comm_size,
+           i;
+    double sum = 0, sum_sq = 0, min = client_rates[0], max = client_rates[0],
+           cpu_per_rpc = 0;
+
+    for (i = 0; i < comm_size; i++) {
+        sum += client_rates[i];
+        sum_sq += client_rates[i] * client_rates[i];
+        min = MIN(min, client_rates[i]);
+        max = MAX(max, client_rates[i]);
+    }
+    if (stats_diff->rpc_count > 0)
+        cpu_per_rpc = (double) stats_diff->cpu_time / 1e3 /
+                      (double) stats_diff->rpc_count;
+
+    printf("%-*s%-*zu%*.0f%*.0f%*.0f%*.*f%*.*f\n", 13,
+        hg_perf_scale_mode_name_g[mode], 10, buf_size, NWIDTH_SCALE,
+        (double) rpc_count / hg_time_to_double(t), NWIDTH_SCALE, min,
+        NWIDTH_SCALE, max, NWIDTH_SCALE, 3,
+        (sum * sum) / ((double) comm_size * sum_sq), NWIDTH_SCALE, 2,
+        cpu_per_rpc);
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_perf_info perf_info;
+    struct hg_test_info *hg_test_info;
+    struct hg_perf_class_info *info;
+    enum hg_perf_scale_mode mode;
+    size_t size;
+    hg_return_t hg_ret;
+
+    /* Initialize the interface */
+    hg_ret = hg_perf_init(argc, argv, false, &perf_info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    hg_test_info = &perf_info.hg_test_info;
+    info = &perf_info.class_info[0];
+
+    /* Allocate RPC buffers */
+    hg_ret = hg_perf_rpc_buf_init(info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_perf_init_rpc_buf() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* Header info */
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        hg_perf_print_header_scale(hg_test_info, info, BENCHMARK_NAME);
+
+    /* All-to-all is only different from many-to-one with several servers */
+    for (mode = HG_PERF_MANY_TO_ONE; mode <= HG_PERF_ALL_TO_ALL; mode++) {
+        if (mode == HG_PERF_ALL_TO_ALL && info->target_addr_max == 1)
+            break;
+
+        for (size = info->buf_size_min; size <= info->buf_size_max;
+             size = MAX(1, size * 2)) {
+            hg_ret = hg_perf_scale_run(hg_test_info, info, mode, size,
+                (size > HG_PERF_LARGE_SIZE) ? HG_PERF_LAT_SKIP_LARGE
+                                            : HG_PERF_LAT_SKIP_SMALL);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                "hg_perf_scale_run() failed (%s)", HG_Error_to_string(hg_ret));
+        }
+    }
+
+    /* Finalize interface */
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        hg_perf_send_done(info);
+
+    hg_perf_cleanup(&perf_info);
+
+    return EXIT_SUCCESS;
+
+error:
+    hg_perf_cleanup(&perf_info);
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,338 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_perf.h"
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "Startup and wire-up time"
+
+/* Progress timeout while waiting for an operation (ms) */
+#define HG_STARTUP_PROGRESS_TIMEOUT (100)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Timed startup phases */
+enum hg_startup_phase {
+    HG_STARTUP_NA_INIT,   /* NA plugin init and provider discovery */
+    HG_STARTUP_HG_INIT,   /* HG class init */
+    HG_STARTUP_CONTEXT,   /* Context creation and posting of recvs */
+    HG_STARTUP_LOOKUP,    /* Batched lookup of all targets */
+    HG_STARTUP_FIRST_RPC, /* First RPC to each target */
+    HG_STARTUP_WARM_RPC,  /* Second RPC to each target */
+    HG_STARTUP_PHASE_MAX
+};
+
+/* Completion of an operation */
+struct hg_startup_op {
+    hg_return_t ret; /* Return value */
+    bool done;       /* Completed */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static hg_return_t
+hg_startup_cb(const struct hg_cb_info *hg_cb_info);
+
+static hg_return_t
+hg_startup_wait(hg_context_t *context, struct hg_startup_op *op);
+
+static hg_return_t
+hg_startup_forward(hg_handle_t handle, hg_context_t *context);
+
+static hg_return_t
+hg_startup_rpc(hg_context_t *context, const hg_addr_t *addrs,
+    size_t addr_count, double *first_time, double *warm_time);
+
+static hg_return_t
+hg_startup_send_done(
+    hg_context_t *context, const hg_addr_t *addrs, size_t addr_count);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static const char *const hg_startup_phase_name_g[] = {
+    [HG_STARTUP_NA_INIT] = "na_init",
+    [HG_STARTUP_HG_INIT] = "hg_init",
+    [HG_STARTUP_CONTEXT] = "context",
+    [HG_STARTUP_LOOKUP] = "lookup",
+    [HG_STARTUP_FIRST_RPC] = "first_rpc",
+    [HG_STARTUP_WARM_RPC] = "warm_rpc"};
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_startup_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_startup_op *op = (struct hg_startup_op *) hg_cb_info->arg;
+
+    op->ret = hg_cb_info->ret;
+    op->done = true;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_startup_wait(hg_context_t *context, struct hg_startup_op *op)
+{
+    hg_return_t ret;
+
+    while (!op->done) {
+        unsigned int actual_count = 0;
+
+        do {
+            ret = HG_Trigger(context, 0, 1, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count > 0 && !op->done);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Trigger() failed (%s)", HG_Error_to_string(ret));
+        if (op->done)
+            break;
+
+        ret = HG_Progress(context, HG_STARTUP_PROGRESS_TIMEOUT);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    return op->ret;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_startup_forward(hg_handle_t handle, hg_context_t *context)
+{
+    struct hg_startup_op op = {.ret = HG_SUCCESS, .done = false};
+    hg_return_t ret;
+
+    ret = HG_Forward(handle, hg_startup_cb, &op, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_startup_wait(context, &op);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "RPC failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_startup_rpc(hg_context_t *context, const hg_addr_t *addrs,
+    size_t addr_count, double *first_time, double *warm_time)
+{
+    hg_return_t ret;
+    size_t i;
+
+    *first_time = 0;
+    *warm_time = 0;
+
+    /* First RPC pays for connection setup, second one shows steady state */
+    for (i = 0; i < addr_count; i++) {
+        hg_handle_t handle = HG_HANDLE_NULL;
+        hg_time_t t1, t2, t3;
+
+        hg_time_get_current(&t1);
+        ret = HG_Create(
+            context, addrs[i], (hg_id_t) HG_PERF_RATE_INIT, &handle);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+        ret = hg_startup_forward(handle, context);
+        HG_TEST_CHECK_HG_ERROR(error_destroy, ret,
+            "hg_startup_forward() failed (%s)", HG_Error_to_string(ret));
+        hg_time_get_current(&t2);
+
+        ret = hg_startup_forward(handle, context);
+        HG_TEST_CHECK_HG_ERROR(error_destroy, ret,
+            "hg_startup_forward() failed (%s)", HG_Error_to_string(ret));
+        hg_time_get_current(&t3);
+
+        (void) HG_Destroy(handle);
+
+        *first_time += hg_time_to_double(hg_time_subtract(t2, t1));
+        *warm_time += hg_time_to_double(hg_time_subtract(t3, t2));
+        continue;
+
+error_destroy:
+        (void) HG_Destroy(handle);
+        goto error;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_startup_send_done(
+    hg_context_t *context, const hg_addr_t *addrs, size_t addr_count)
+{
+    hg_return_t ret;
+    size_t i;
+
+    for (i = 0; i < addr_count; i++) {
+        hg_handle_t handle = HG_HANDLE_NULL;
+
+        ret = HG_Create(context, addrs[i], (hg_id_t) HG_PERF_DONE, &handle);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+        ret = hg_startup_forward(handle, context);
+        (void) HG_Destroy(handle);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "hg_startup_forward() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info;
+    struct hg_startup_op op = {.ret = HG_SUCCESS, .done = false};
+    double times[HG_STARTUP_PHASE_MAX], *all_times = NULL, *phase_times = NULL;
+    hg_context_t *context = NULL;
+    hg_addr_t *addrs = NULL;
+    size_t addr_count = 0, comm_size, i;
+    hg_time_t t1, t2;
+    hg_return_t hg_ret;
+    int j;
+
+    memset(&hg_test_info, 0, sizeof(hg_test_info));
+
+    /* NA and HG init are timed by the test layer */
+    hg_ret = HG_Test_init(argc, argv, &hg_test_info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Test_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    times[HG_STARTUP_NA_INIT] = hg_test_info.na_test_info.init_time;
+    times[HG_STARTUP_HG_INIT] = hg_test_info.init_time;
+    comm_size = (size_t) hg_test_info.na_test_info.mpi_comm_size;
+
+    addr_count = hg_test_info.na_test_info.max_targets;
+    HG_TEST_CHECK_ERROR(addr_count == 0, error, hg_ret, HG_INVALID_ARG,
+        "No target to look up");
+    addrs = (hg_addr_t *) calloc(addr_count, sizeof(*addrs));
+    HG_TEST_CHECK_ERROR(addrs == NULL, error, hg_ret, HG_NOMEM,
+        "Could not allocate array of %zu addrs", addr_count);
+
+    hg_ret = HG_Register(
+        hg_test_info.hg_class, HG_PERF_RATE_INIT, NULL, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Register() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    hg_ret = HG_Register(hg_test_info.hg_class, HG_PERF_DONE, NULL, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Register() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* All processes go through each phase at the same time */
+    if (comm_size > 1)
+        NA_Test_barrier(&hg_test_info.na_test_info);
+    hg_time_get_current(&t1);
+    context = HG_Context_create(hg_test_info.hg_class);
+    hg_time_get_current(&t2);
+    HG_TEST_CHECK_ERROR(context == NULL, error, hg_ret, HG_NOMEM,
+        "HG_Context_create() failed");
+    times[HG_STARTUP_CONTEXT] = hg_time_to_double(hg_time_subtract(t2, t1));
+
+    if (comm_size > 1)
+        NA_Test_barrier(&hg_test_info.na_test_info);
+    hg_time_get_current(&t1);
+    hg_ret = HG_Addr_lookup_multi(context, hg_startup_cb, &op,
+        (const char *const *) hg_test_info.na_test_info.target_names,
+        (unsigned int) addr_count, addrs, HG_OP_ID_IGNORE);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Addr_lookup_multi() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    hg_ret = hg_startup_wait(context, &op);
+    HG_TEST_CHECK_HG_ERROR(
+        error, hg_ret, "Lookup failed (%s)", HG_Error_to_string(hg_ret));
+    hg_time_get_current(&t2);
+    times[HG_STARTUP_LOOKUP] = hg_time_to_double(hg_time_subtract(t2, t1));
+
+    if (comm_size > 1)
+        NA_Test_barrier(&hg_test_info.na_test_info);
+    hg_ret = hg_startup_rpc(context, addrs, addr_count,
+        &times[HG_STARTUP_FIRST_RPC], &times[HG_STARTUP_WARM_RPC]);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_startup_rpc() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* Collect times of all processes */
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        all_times = (double *) malloc(comm_size * sizeof(times));
+        phase_times = (double *) malloc(comm_size * sizeof(double));
+        HG_TEST_CHECK_ERROR(all_times == NULL || phase_times == NULL, error,
+            hg_ret, HG_NOMEM, "Could not allocate array of times");
+    }
+    NA_Test_gather((const char *) times, (char *) all_times,
+        (int) sizeof(times), 0, &hg_test_info.na_test_info);
+
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        hg_perf_print_header_startup(&hg_test_info, BENCHMARK_NAME);
+        for (j = 0; j < HG_STARTUP_PHASE_MAX; j++) {
+            size_t op_count =
+                (j == HG_STARTUP_NA_INIT || j == HG_STARTUP_HG_INIT)
+                    ? hg_test_info.na_test_info.max_classes
+                : (j == HG_STARTUP_CONTEXT) ? 1
+                                            : addr_count;
+
+            for (i = 0; i < comm_size; i++)
+                phase_times[i] =
+                    all_times[i * HG_STARTUP_PHASE_MAX + (size_t) j];
+            hg_perf_print_startup(
+                hg_startup_phase_name_g[j], op_count, phase_times, comm_size);
+        }
+    }
+
+    if (comm_size > 1)
+        NA_Test_barrier(&hg_test_info.na_test_info);
+    if (hg_test_info.na_test_info.mpi_comm_rank == 0) {
+        hg_ret = hg_startup_send_done(context, addrs, addr_count);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_startup_send_done() failed (%s)", HG_Error_to_string(hg_ret));
+    }
+
+    for (i = 0; i < addr_count; i++)
+        (void) HG_Addr_free(hg_test_info.hg_class, addrs[i]);
+    free(addrs);
+    free(all_times);
+    free(phase_times);
+    (void) HG_Context_destroy(context);
+    (void) HG_Test_finalize(&hg_test_info);
+
+    return EXIT_SUCCESS;
+
+error:
+    if (addrs != NULL) {
+        for (i = 0; i < addr_count; i++)
+            if (addrs[i] != HG_ADDR_NULL)
+                (void) HG_Addr_free(hg_test_info.hg_class, addrs[i]);
+        free(addrs);
+    }
+    free(all_times);
+    free(phase_times);
+    if (context != NULL)
+        (void) HG_Context_destroy(context);
+    (void) HG_Test_finalize(&hg_test_info);
+
+    return EXIT_FAILURE;
+}
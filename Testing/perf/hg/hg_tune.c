@@ -0,0 +1,1048 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_perf.h"
+#include "mercury_proc.h"
+#include "mercury_proc_bulk.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#    include <sys/uio.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "HG init parameter tuning"
+
+/* RPCs measured per loop and trial */
+#define HG_TUNE_RPC_COUNT (1000)
+
+/* RPCs sent before measuring each trial */
+#define HG_TUNE_WARMUP_COUNT (200)
+
+/* Minimum rate improvement for a value to be kept (%) */
+#define HG_TUNE_GAIN_MIN (3.0)
+
+/* Default RPC size when no buffer size is given */
+#define HG_TUNE_SIZE_DEFAULT (64)
+
+/* Max number of RPC sizes in the workload */
+#define HG_TUNE_SIZE_MAX (64)
+
+/* Max number of candidate values per parameter */
+#define HG_TUNE_VALUE_MAX (4)
+
+/* Progress timeout (ms) */
+#define HG_TUNE_PROGRESS_TIMEOUT (10)
+
+/* RPC IDs of the tuning workload */
+#define HG_TUNE_RPC  (1)
+#define HG_TUNE_BULK (2)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+#ifdef _WIN32
+struct iovec {
+    void *iov_base; /* Pointer to data.  */
+    size_t iov_len; /* Length of data.  */
+};
+#endif
+
+/* Tuned parameters */
+enum hg_tune_param {
+    HG_TUNE_REQUEST_POST_INIT,
+    HG_TUNE_REQUEST_POST_INCR,
+    HG_TUNE_NO_MULTI_RECV,
+    HG_TUNE_RELEASE_INPUT_EARLY,
+    HG_TUNE_MSG_SIZE,
+    HG_TUNE_PROGRESS_MODE,
+    HG_TUNE_PROGRESS_SPIN_MAX,
+    HG_TUNE_REQUEST_COALESCE_MAX,
+    HG_TUNE_PARAM_MAX
+};
+
+/* How parameter values are printed */
+enum hg_tune_kind { HG_TUNE_UINT, HG_TUNE_BOOL, HG_TUNE_MODE };
+
+/* Parameter description */
+struct hg_tune_param_info {
+    const char *name;                       /* Printed name */
+    const char *fields[2];                  /* hg_init_info fields set */
+    enum hg_tune_kind kind;                 /* Kind of value */
+    unsigned int values[HG_TUNE_VALUE_MAX]; /* Candidates, default first */
+    size_t value_count;                     /* Number of candidates */
+};
+
+/* Described workload */
+struct hg_tune_workload {
+    size_t sizes[HG_TUNE_SIZE_MAX]; /* RPC sizes, cycled through */
+    size_t size_count;              /* Number of RPC sizes */
+    size_t size_max;                /* Largest RPC size */
+    size_t handle_count;            /* RPCs in flight */
+    unsigned int bulk_ratio;        /* Percentage of bulk RPCs */
+    size_t rpc_count;               /* RPCs measured per trial */
+};
+
+/* Bulk RPC input */
+struct hg_tune_bulk_in {
+    hg_bulk_t bulk;   /* Origin bulk handle */
+    hg_uint32_t size; /* Size to pull */
+};
+
+/* Server side of a trial */
+struct hg_tune_server {
+    hg_class_t *hg_class;   /* HG class */
+    hg_context_t *context;  /* HG context */
+    void *buf;              /* RPC and bulk buffer */
+    hg_bulk_t bulk;         /* Bulk handle of buffer */
+    hg_thread_t thread;     /* Progress thread */
+    hg_atomic_int32_t stop; /* Stop progress thread */
+    hg_return_t ret;        /* Progress thread error */
+    bool started;           /* Progress thread started */
+};
+
+/* Client side of a trial */
+struct hg_tune_client {
+    hg_class_t *hg_class;       /* HG class */
+    hg_context_t *context;      /* HG context */
+    hg_addr_t addr;             /* Server address */
+    void *buf;                  /* RPC and bulk buffer */
+    hg_bulk_t bulk;             /* Bulk handle of buffer */
+    struct hg_tune_slot *slots; /* One slot per handle */
+    size_t slot_count;          /* Number of slots */
+};
+
+/* Closed-loop run */
+struct hg_tune_run {
+    struct hg_tune_client *client;           /* Client */
+    const struct hg_tune_workload *workload; /* Workload */
+    double *latencies;                       /* Latencies (us), or NULL */
+    size_t count;                            /* RPCs to complete */
+    size_t sent_count;                       /* RPCs sent */
+    size_t complete_count;                   /* RPCs completed */
+    size_t kind_counts[2];                   /* RPCs sent of each kind */
+    hg_return_t ret;                         /* First error */
+};
+
+/* Handle in flight */
+struct hg_tune_slot {
+    struct hg_tune_run *run; /* Current run */
+    hg_handle_t handle;      /* Handle */
+    hg_id_t id;              /* RPC ID handle is set to */
+    hg_time_t start;         /* Time RPC was sent */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static char *
+hg_tune_info_string(const struct na_test_info *na_test_info);
+
+static void
+hg_tune_workload_init(const struct hg_test_info *hg_test_info,
+    struct hg_tune_workload *workload);
+
+static void
+hg_tune_init_info_set(
+    const size_t *indices, struct hg_init_info *hg_init_info);
+
+static void
+hg_tune_value_string(enum hg_tune_param param, size_t index, char *buf,
+    size_t buf_size);
+
+static hg_return_t
+hg_tune_proc_iovec(hg_proc_t proc, void *arg);
+
+static hg_return_t
+hg_tune_proc_bulk_in(hg_proc_t proc, void *arg);
+
+static hg_return_t
+hg_tune_rpc_cb(hg_handle_t handle);
+
+static hg_return_t
+hg_tune_bulk_cb(hg_handle_t handle);
+
+static hg_return_t
+hg_tune_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info);
+
+static HG_THREAD_RETURN_TYPE
+hg_tune_server_thread(void *arg);
+
+static hg_return_t
+hg_tune_server_start(const char *info_string,
+    const struct hg_init_info *hg_init_info, size_t buf_size,
+    struct hg_tune_server *server);
+
+static void
+hg_tune_server_stop(struct hg_tune_server *server);
+
+static hg_return_t
+hg_tune_client_start(const char *info_string,
+    const struct hg_init_info *hg_init_info,
+    const struct hg_tune_server *server,
+    const struct hg_tune_workload *workload, struct hg_tune_client *client);
+
+static void
+hg_tune_client_stop(struct hg_tune_client *client);
+
+static hg_return_t
+hg_tune_forward(struct hg_tune_slot *slot);
+
+static hg_return_t
+hg_tune_forward_cb(const struct hg_cb_info *hg_cb_info);
+
+static hg_return_t
+hg_tune_client_run(struct hg_tune_client *client,
+    const struct hg_tune_workload *workload, size_t count, double *latencies,
+    double *elapsed);
+
+static int
+hg_tune_double_cmp(const void *a, const void *b);
+
+static double
+hg_tune_percentile(const double *values, size_t count, double percentile);
+
+static hg_return_t
+hg_tune_trial(const char *info_string, const struct hg_tune_workload *workload,
+    const size_t *indices, double *latencies,
+    struct hg_perf_probe_result *result);
+
+static void
+hg_tune_print_config(const size_t *indices, double gain);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static const struct hg_tune_param_info hg_tune_params_g[] = {
+    [HG_TUNE_REQUEST_POST_INIT] = {"request_post_init",
+        {"request_post_init", NULL}, HG_TUNE_UINT, {0, 32, 128, 1024}, 4},
+    [HG_TUNE_REQUEST_POST_INCR] = {"request_post_incr",
+        {"request_post_incr", NULL}, HG_TUNE_UINT, {0, 32, 1024}, 3},
+    [HG_TUNE_NO_MULTI_RECV] = {"no_multi_recv", {"no_multi_recv", NULL},
+        HG_TUNE_BOOL, {0, 1}, 2},
+    [HG_TUNE_RELEASE_INPUT_EARLY] = {"release_input_early",
+        {"release_input_early", NULL}, HG_TUNE_BOOL, {0, 1}, 2},
+    [HG_TUNE_MSG_SIZE] = {"msg_size",
+        {"na_init_info.max_unexpected_size",
+            "na_init_info.max_expected_size"},
+        HG_TUNE_UINT, {0, 4096, 16384, 65536}, 4},
+    [HG_TUNE_PROGRESS_MODE] = {"progress_mode",
+        {"na_init_info.progress_mode", NULL}, HG_TUNE_MODE, {0, NA_NO_BLOCK},
+        2},
+    [HG_TUNE_PROGRESS_SPIN_MAX] = {"progress_spin_max",
+        {"progress_spin_max", NULL}, HG_TUNE_UINT, {0, 20, 100}, 3},
+    [HG_TUNE_REQUEST_COALESCE_MAX] = {"request_coalesce_max",
+        {"request_coalesce_max", NULL}, HG_TUNE_UINT, {0, 4, 16}, 3}};
+
+/*---------------------------------------------------------------------------*/
+static char *
+hg_tune_info_string(const struct na_test_info *na_test_info)
+{
+    char *info_string = (char *) malloc(NA_TEST_MAX_ADDR_NAME);
+    int rc;
+
+    HG_TEST_CHECK_ERROR_NORET(
+        info_string == NULL, error, "Could not allocate info string");
+
+    /* Server and client both pick any port */
+    rc = snprintf(info_string, NA_TEST_MAX_ADDR_NAME, "%s%s%s://%s%s%s",
+        na_test_info->comm ? na_test_info->comm : "",
+        na_test_info->comm ? "+" : "", na_test_info->protocol,
+        na_test_info->domain ? na_test_info->domain : "",
+        na_test_info->domain ? "/" : "",
+        na_test_info->hostname ? na_test_info->hostname : "");
+    HG_TEST_CHECK_ERROR_NORET(rc < 0 || rc >= NA_TEST_MAX_ADDR_NAME,
+        error_free, "Info string exceeds %d bytes", NA_TEST_MAX_ADDR_NAME);
+
+    return info_string;
+
+error_free:
+    free(info_string);
+error:
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_tune_workload_init(
+    const struct hg_test_info *hg_test_info, struct hg_tune_workload *workload)
+{
+    size_t size_min = hg_test_info->na_test_info.buf_size_min,
+           size_max = hg_test_info->na_test_info.buf_size_max, size;
+
+    if (size_min == 0)
+        size_min = (size_max > 0) ? MIN(size_max, HG_TUNE_SIZE_DEFAULT)
+                                  : HG_TUNE_SIZE_DEFAULT;
+    if (size_max < size_min)
+        size_max = size_min;
+
+    /* Sizes double from min to max */
+    workload->size_count = 0;
+    for (size = size_min;
+         size <= size_max && workload->size_count < HG_TUNE_SIZE_MAX;
+         size *= 2)
+        workload->sizes[workload->size_count++] = size;
+    workload->size_max = workload->sizes[workload->size_count - 1];
+
+    workload->handle_count = MAX(hg_test_info->handle_max, 1);
+    workload->bulk_ratio = MIN(hg_test_info->bulk_ratio, 100);
+    workload->rpc_count =
+        (size_t) hg_test_info->na_test_info.loop * HG_TUNE_RPC_COUNT;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_tune_init_info_set(const size_t *indices, struct hg_init_info *hg_init_info)
+{
+    int i;
+
+    for (i = 0; i < HG_TUNE_PARAM_MAX; i++) {
+        unsigned int value = hg_tune_params_g[i].values[indices[i]];
+
+        switch (i) {
+            case HG_TUNE_REQUEST_POST_INIT:
+                hg_init_info->request_post_init = value;
+                break;
+            case HG_TUNE_REQUEST_POST_INCR:
+                hg_init_info->request_post_incr = value;
+                break;
+            case HG_TUNE_NO_MULTI_RECV:
+                hg_init_info->no_multi_recv = (hg_bool_t) value;
+                break;
+            case HG_TUNE_RELEASE_INPUT_EARLY:
+                hg_init_info->release_input_early = (hg_bool_t) value;
+                break;
+            case HG_TUNE_MSG_SIZE:
+                hg_init_info->na_init_info.max_unexpected_size = value;
+                hg_init_info->na_init_info.max_expected_size = value;
+                break;
+            case HG_TUNE_PROGRESS_MODE:
+                hg_init_info->na_init_info.progress_mode = (uint8_t) value;
+                break;
+            case HG_TUNE_PROGRESS_SPIN_MAX:
+                hg_init_info->progress_spin_max = value;
+                break;
+            case HG_TUNE_REQUEST_COALESCE_MAX:
+                hg_init_info->request_coalesce_max = value;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_tune_value_string(
+    enum hg_tune_param param, size_t index, char *buf, size_t buf_size)
+{
+    unsigned int value = hg_tune_params_g[param].values[index];
+
+    switch (hg_tune_params_g[param].kind) {
+        case HG_TUNE_BOOL:
+            snprintf(buf, buf_size, "%s", value ? "HG_TRUE" : "HG_FALSE");
+            break;
+        case HG_TUNE_MODE:
+            snprintf(buf, buf_size, "%s", value ? "NA_NO_BLOCK" : "0");
+            break;
+        case HG_TUNE_UINT:
+        default:
+            snprintf(buf, buf_size, "%u", value);
+            break;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_proc_iovec(hg_proc_t proc, void *arg)
+{
+    struct iovec *iov = (struct iovec *) arg;
+    uint32_t len = (uint32_t) iov->iov_len;
+    hg_return_t ret;
+
+    if (hg_proc_get_op(proc) == HG_FREE)
+        return HG_SUCCESS;
+
+    ret = hg_proc_uint32_t(proc, &len);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_uint32_t() failed (%s)", HG_Error_to_string(ret));
+    iov->iov_len = (size_t) len;
+
+    if (len == 0)
+        return HG_SUCCESS;
+
+    ret = hg_proc_raw(proc, iov->iov_base, iov->iov_len);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_raw() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_proc_bulk_in(hg_proc_t proc, void *arg)
+{
+    struct hg_tune_bulk_in *in = (struct hg_tune_bulk_in *) arg;
+    hg_return_t ret;
+
+    ret = hg_proc_hg_bulk_t(proc, &in->bulk);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_hg_bulk_t() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_proc_uint32_t(proc, &in->size);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_uint32_t() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_rpc_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    struct hg_tune_server *server = HG_Context_get_data(hg_info->context);
+    struct iovec iov = {.iov_base = server->buf, .iov_len = 0};
+    hg_return_t ret;
+
+    /* Payload is decoded into the server buffer */
+    ret = HG_Get_input(handle, &iov);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    (void) HG_Free_input(handle, &iov);
+
+    ret = HG_Respond(handle, NULL, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    (void) HG_Destroy(handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_bulk_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    struct hg_tune_server *server = HG_Context_get_data(hg_info->context);
+    struct hg_tune_bulk_in in;
+    hg_return_t ret;
+
+    ret = HG_Get_input(handle, &in);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
+
+    /* Respond once data is pulled into the server buffer */
+    ret = HG_Bulk_transfer(hg_info->context, hg_tune_bulk_transfer_cb, handle,
+        HG_BULK_PULL, hg_info->addr, in.bulk, 0, server->bulk, 0, in.size,
+        HG_OP_ID_IGNORE);
+    (void) HG_Free_input(handle, &in);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_transfer() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    (void) HG_Destroy(handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info)
+{
+    hg_handle_t handle = (hg_handle_t) hg_cb_info->arg;
+
+    HG_TEST_CHECK_ERROR_NORET(hg_cb_info->ret != HG_SUCCESS, done,
+        "Bulk transfer failed (%s)", HG_Error_to_string(hg_cb_info->ret));
+
+done:
+    (void) HG_Respond(handle, NULL, NULL, NULL);
+    (void) HG_Destroy(handle);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_tune_server_thread(void *arg)
+{
+    struct hg_tune_server *server = (struct hg_tune_server *) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+    hg_return_t ret;
+
+    while (hg_atomic_get32(&server->stop) == 0) {
+        unsigned int actual_count = 0;
+
+        do {
+            ret = HG_Trigger(server->context, 0, 1, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count > 0);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Trigger() failed (%s)", HG_Error_to_string(ret));
+
+        ret = HG_Progress(server->context, HG_TUNE_PROGRESS_TIMEOUT);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    return tret;
+
+error:
+    server->ret = ret;
+
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_server_start(const char *info_string,
+    const struct hg_init_info *hg_init_info, size_t buf_size,
+    struct hg_tune_server *server)
+{
+    hg_size_t bulk_size = (hg_size_t) buf_size;
+    hg_return_t ret;
+    int rc;
+
+    server->hg_class = HG_Init_opt2(info_string, HG_TRUE,
+        HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), hg_init_info);
+    HG_TEST_CHECK_ERROR(server->hg_class == NULL, error, ret, HG_FAULT,
+        "HG_Init_opt2(%s) failed", info_string);
+
+    ret = HG_Register(server->hg_class, HG_TUNE_RPC, hg_tune_proc_iovec, NULL,
+        hg_tune_rpc_cb);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Register() failed (%s)", HG_Error_to_string(ret));
+    ret = HG_Register(server->hg_class, HG_TUNE_BULK, hg_tune_proc_bulk_in,
+        NULL, hg_tune_bulk_cb);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Register() failed (%s)", HG_Error_to_string(ret));
+
+    server->context = HG_Context_create(server->hg_class);
+    HG_TEST_CHECK_ERROR(server->context == NULL, error, ret, HG_FAULT,
+        "HG_Context_create() failed");
+
+    ret = HG_Context_set_data(server->context, server, NULL);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Context_set_data() failed (%s)",
+        HG_Error_to_string(ret));
+
+    server->buf = calloc(1, buf_size);
+    HG_TEST_CHECK_ERROR(server->buf == NULL, error, ret, HG_NOMEM,
+        "Could not allocate buffer of %zu bytes", buf_size);
+
+    ret = HG_Bulk_create(server->hg_class, 1, &server->buf,
+        &bulk_size, HG_BULK_READWRITE, &server->bulk);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    server->ret = HG_SUCCESS;
+    hg_atomic_init32(&server->stop, 0);
+    rc = hg_thread_create(&server->thread, hg_tune_server_thread, server);
+    HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_create() failed");
+    server->started = true;
+
+    return HG_SUCCESS;
+
+error:
+    hg_tune_server_stop(server);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_tune_server_stop(struct hg_tune_server *server)
+{
+    if (server->started) {
+        hg_atomic_set32(&server->stop, 1);
+        hg_thread_join(server->thread);
+        server->started = false;
+    }
+    if (server->bulk != HG_BULK_NULL) {
+        (void) HG_Bulk_free(server->bulk);
+        server->bulk = HG_BULK_NULL;
+    }
+    free(server->buf);
+    server->buf = NULL;
+    if (server->context != NULL) {
+        (void) HG_Context_destroy(server->context);
+        server->context = NULL;
+    }
+    if (server->hg_class != NULL) {
+        (void) HG_Finalize(server->hg_class);
+        server->hg_class = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_client_start(const char *info_string,
+    const struct hg_init_info *hg_init_info,
+    const struct hg_tune_server *server,
+    const struct hg_tune_workload *workload, struct hg_tune_client *client)
+{
+    char addr_string[NA_TEST_MAX_ADDR_NAME];
+    hg_size_t addr_string_len = sizeof(addr_string);
+    hg_size_t bulk_size = (hg_size_t) workload->size_max;
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_return_t ret;
+    size_t i;
+
+    /* Server address is looked up from its string like a remote one */
+    ret = HG_Addr_self(server->hg_class, &self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+    ret = HG_Addr_to_string(
+        server->hg_class, addr_string, &addr_string_len, self_addr);
+    (void) HG_Addr_free(server->hg_class, self_addr);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Addr_to_string() failed (%s)",
+        HG_Error_to_string(ret));
+
+    client->hg_class = HG_Init_opt2(info_string, HG_FALSE,
+        HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), hg_init_info);
+    HG_TEST_CHECK_ERROR(client->hg_class == NULL, error, ret, HG_FAULT,
+        "HG_Init_opt2(%s) failed", info_string);
+
+    ret = HG_Register(
+        client->hg_class, HG_TUNE_RPC, hg_tune_proc_iovec, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Register() failed (%s)", HG_Error_to_string(ret));
+    ret = HG_Register(
+        client->hg_class, HG_TUNE_BULK, hg_tune_proc_bulk_in, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Register() failed (%s)", HG_Error_to_string(ret));
+
+    client->context = HG_Context_create(client->hg_class);
+    HG_TEST_CHECK_ERROR(client->context == NULL, error, ret, HG_FAULT,
+        "HG_Context_create() failed");
+
+    ret = HG_Addr_lookup2(client->hg_class, addr_string, &client->addr);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Addr_lookup2(%s) failed (%s)",
+        addr_string, HG_Error_to_string(ret));
+
+    client->buf = malloc(workload->size_max);
+    HG_TEST_CHECK_ERROR(client->buf == NULL, error, ret, HG_NOMEM,
+        "Could not allocate buffer of %zu bytes", workload->size_max);
+    memset(client->buf, 'x', workload->size_max);
+
+    ret = HG_Bulk_create(client->hg_class, 1, &client->buf, &bulk_size,
+        HG_BULK_READ_ONLY, &client->bulk);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    client->slots = (struct hg_tune_slot *) calloc(
+        workload->handle_count, sizeof(*client->slots));
+    HG_TEST_CHECK_ERROR(client->slots == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %zu slots", workload->handle_count);
+    client->slot_count = workload->handle_count;
+
+    for (i = 0; i < client->slot_count; i++) {
+        client->slots[i].id = HG_TUNE_RPC;
+        ret = HG_Create(client->context, client->addr, HG_TUNE_RPC,
+            &client->slots[i].handle);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    return HG_SUCCESS;
+
+error:
+    hg_tune_client_stop(client);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_tune_client_stop(struct hg_tune_client *client)
+{
+    size_t i;
+
+    if (client->slots != NULL) {
+        for (i = 0; i < client->slot_count; i++)
+            if (client->slots[i].handle != HG_HANDLE_NULL)
+                (void) HG_Destroy(client->slots[i].handle);
+        free(client->slots);
+        client->slots = NULL;
+    }
+    if (client->bulk != HG_BULK_NULL) {
+        (void) HG_Bulk_free(client->bulk);
+        client->bulk = HG_BULK_NULL;
+    }
+    free(client->buf);
+    client->buf = NULL;
+    if (client->addr != HG_ADDR_NULL) {
+        (void) HG_Addr_free(client->hg_class, client->addr);
+        client->addr = HG_ADDR_NULL;
+    }
+    if (client->context != NULL) {
+        (void) HG_Context_destroy(client->context);
+        client->context = NULL;
+    }
+    if (client->hg_class != NULL) {
+        (void) HG_Finalize(client->hg_class);
+        client->hg_class = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_forward(struct hg_tune_slot *slot)
+{
+    struct hg_tune_run *run = slot->run;
+    const struct hg_tune_workload *workload = run->workload;
+    size_t index = run->sent_count++, kind, size;
+    hg_id_t id;
+    hg_return_t ret;
+
+    /* Bulk RPCs are spread evenly among RPCs */
+    kind = ((index + 1) * workload->bulk_ratio / 100 !=
+               index * workload->bulk_ratio / 100)
+               ? 1
+               : 0;
+    id = kind ? HG_TUNE_BULK : HG_TUNE_RPC;
+    size = workload->sizes[run->kind_counts[kind]++ % workload->size_count];
+
+    if (slot->id != id) {
+        ret = HG_Reset(slot->handle, run->client->addr, id);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Reset() failed (%s)", HG_Error_to_string(ret));
+        slot->id = id;
+    }
+
+    hg_time_get_current(&slot->start);
+    if (kind) {
+        struct hg_tune_bulk_in in = {
+            .bulk = run->client->bulk, .size = (hg_uint32_t) size};
+
+        ret = HG_Forward(slot->handle, hg_tune_forward_cb, slot, &in);
+    } else {
+        struct iovec iov = {.iov_base = run->client->buf, .iov_len = size};
+
+        ret = HG_Forward(slot->handle, hg_tune_forward_cb, slot, &iov);
+    }
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    run->sent_count--;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_forward_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_tune_slot *slot = (struct hg_tune_slot *) hg_cb_info->arg;
+    struct hg_tune_run *run = slot->run;
+    hg_time_t now;
+
+    hg_time_get_current(&now);
+    if (hg_cb_info->ret != HG_SUCCESS && run->ret == HG_SUCCESS)
+        run->ret = hg_cb_info->ret;
+    if (run->latencies != NULL)
+        run->latencies[run->complete_count] =
+            hg_time_to_double(hg_time_subtract(now, slot->start)) * 1e6;
+    run->complete_count++;
+
+    /* Keep the handle busy until all RPCs are sent */
+    if (run->ret == HG_SUCCESS && run->sent_count < run->count) {
+        hg_return_t ret = hg_tune_forward(slot);
+        if (ret != HG_SUCCESS)
+            run->ret = ret;
+    }
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_client_run(struct hg_tune_client *client,
+    const struct hg_tune_workload *workload, size_t count, double *latencies,
+    double *elapsed)
+{
+    struct hg_tune_run run = {.client = client,
+        .workload = workload,
+        .latencies = latencies,
+        .count = count,
+        .sent_count = 0,
+        .complete_count = 0,
+        .kind_counts = {0, 0},
+        .ret = HG_SUCCESS};
+    hg_time_t t1, t2;
+    hg_return_t ret;
+    size_t i;
+
+    hg_time_get_current(&t1);
+    for (i = 0; i < MIN(client->slot_count, count); i++) {
+        client->slots[i].run = &run;
+        ret = hg_tune_forward(&client->slots[i]);
+        if (ret != HG_SUCCESS) {
+            run.ret = ret;
+            break;
+        }
+    }
+
+    /* Wait for RPCs in flight to complete on error */
+    while (run.complete_count <
+           ((run.ret == HG_SUCCESS) ? run.count : run.sent_count)) {
+        unsigned int actual_count = 0;
+
+        do {
+            ret = HG_Trigger(client->context, 0, 1, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count > 0);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Trigger() failed (%s)", HG_Error_to_string(ret));
+
+        if (run.complete_count ==
+            ((run.ret == HG_SUCCESS) ? run.count : run.sent_count))
+            break;
+
+        ret = HG_Progress(client->context, HG_TUNE_PROGRESS_TIMEOUT);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+    }
+    hg_time_get_current(&t2);
+    *elapsed = hg_time_to_double(hg_time_subtract(t2, t1));
+
+    return run.ret;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_tune_double_cmp(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+/*---------------------------------------------------------------------------*/
+static double
+hg_tune_percentile(const double *values, size_t count, double percentile)
+{
+    size_t rank = (size_t) ceil(percentile / 100.0 * (double) count);
+
+    if (count == 0)
+        return 0;
+
+    return values[(rank > 0) ? MIN(rank, count) - 1 : 0];
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_tune_trial(const char *info_string, const struct hg_tune_workload *workload,
+    const size_t *indices, double *latencies,
+    struct hg_perf_probe_result *result)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_tune_server server;
+    struct hg_tune_client client;
+    double elapsed;
+    hg_return_t ret;
+
+    memset(&server, 0, sizeof(server));
+    memset(&client, 0, sizeof(client));
+    hg_tune_init_info_set(indices, &hg_init_info);
+
+    /* Each trial initializes both sides with the same parameters */
+    ret = hg_tune_server_start(
+        info_string, &hg_init_info, workload->size_max, &server);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_tune_server_start() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_tune_client_start(
+        info_string, &hg_init_info, &server, workload, &client);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_tune_client_start() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_tune_client_run(
+        &client, workload, HG_TUNE_WARMUP_COUNT, NULL, &elapsed);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_tune_client_run() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_tune_client_run(
+        &client, workload, workload->rpc_count, latencies, &elapsed);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_tune_client_run() failed (%s)",
+        HG_Error_to_string(ret));
+
+    hg_tune_client_stop(&client);
+    hg_tune_server_stop(&server);
+    HG_TEST_CHECK_ERROR(server.ret != HG_SUCCESS, error, ret, server.ret,
+        "Server progress failed (%s)", HG_Error_to_string(server.ret));
+
+    qsort(latencies, workload->rpc_count, sizeof(double), hg_tune_double_cmp);
+    result->rate = (elapsed > 0) ? (double) workload->rpc_count / elapsed : 0;
+    result->p50 = hg_tune_percentile(latencies, workload->rpc_count, 50.0);
+    result->p99 = hg_tune_percentile(latencies, workload->rpc_count, 99.0);
+    result->p999 = hg_tune_percentile(latencies, workload->rpc_count, 99.9);
+    result->max = latencies[workload->rpc_count - 1];
+
+    return HG_SUCCESS;
+
+error:
+    hg_tune_client_stop(&client);
+    hg_tune_server_stop(&server);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_tune_print_config(const size_t *indices, double gain)
+{
+    bool tuned = false;
+    int i;
+    size_t j;
+
+    for (i = 0; i < HG_TUNE_PARAM_MAX; i++)
+        if (indices[i] != 0)
+            tuned = true;
+
+    if (!tuned) {
+        printf("# Recommended configuration: defaults\n");
+        fflush(stdout);
+        return;
+    }
+
+    printf("# Recommended configuration (%+.*f%% rate over defaults):\n", 1,
+        gain);
+    printf("struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;\n");
+    for (i = 0; i < HG_TUNE_PARAM_MAX; i++) {
+        char value[32];
+
+        if (indices[i] == 0)
+            continue;
+
+        hg_tune_value_string(
+            (enum hg_tune_param) i, indices[i], value, sizeof(value));
+        for (j = 0; j < 2 && hg_tune_params_g[i].fields[j] != NULL; j++)
+            printf("hg_init_info.%s = %s;\n", hg_tune_params_g[i].fields[j],
+                value);
+    }
+    fflush(stdout);
+}
+
+/*****************************************************************************/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info;
+    struct hg_tune_workload workload;
+    struct hg_perf_probe_result baseline, best, result;
+    size_t indices[HG_TUNE_PARAM_MAX];
+    double *latencies = NULL;
+    char *info_string = NULL;
+    char value[32];
+    double gain;
+    hg_return_t hg_ret;
+    int i;
+    size_t j;
+
+    memset(&hg_test_info, 0, sizeof(hg_test_info));
+    memset(indices, 0, sizeof(indices));
+
+    /* Classes of each trial are created locally, no target to look up */
+    hg_test_info.na_test_info.self_send = true;
+    hg_ret = HG_Test_init(argc, argv, &hg_test_info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Test_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    hg_tune_workload_init(&hg_test_info, &workload);
+
+    info_string = hg_tune_info_string(&hg_test_info.na_test_info);
+    HG_TEST_CHECK_ERROR(info_string == NULL, error, hg_ret, HG_NOMEM,
+        "Could not generate info string");
+
+    latencies = (double *) malloc(workload.rpc_count * sizeof(*latencies));
+    HG_TEST_CHECK_ERROR(latencies == NULL, error, hg_ret, HG_NOMEM,
+        "Could not allocate array of %zu latencies", workload.rpc_count);
+
+    hg_perf_print_header_tune(&hg_test_info, BENCHMARK_NAME, workload.sizes[0],
+        workload.size_max, workload.rpc_count, HG_TUNE_GAIN_MIN);
+
+    hg_ret =
+        hg_tune_trial(info_string, &workload, indices, latencies, &baseline);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_tune_trial() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    hg_perf_print_tune("defaults", "-", &baseline, 0);
+    best = baseline;
+
+    /* Coordinate descent, starting from defaults */
+    for (i = 0; i < HG_TUNE_PARAM_MAX; i++) {
+        size_t best_index = 0;
+
+        /* Increment is only used with a non-default number of requests */
+        if (i == HG_TUNE_REQUEST_POST_INCR &&
+            indices[HG_TUNE_REQUEST_POST_INIT] == 0)
+            continue;
+
+        for (j = 1; j < hg_tune_params_g[i].value_count; j++) {
+            indices[i] = j;
+            hg_ret = hg_tune_trial(
+                info_string, &workload, indices, latencies, &result);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                "hg_tune_trial() failed (%s)", HG_Error_to_string(hg_ret));
+
+            gain =
+                (best.rate > 0) ? (result.rate / best.rate - 1.0) * 100.0 : 0;
+            hg_tune_value_string(
+                (enum hg_tune_param) i, j, value, sizeof(value));
+            hg_perf_print_tune(hg_tune_params_g[i].name, value, &result, gain);
+            if (gain >= HG_TUNE_GAIN_MIN) {
+                best = result;
+                best_index = j;
+            }
+        }
+        indices[i] = best_index;
+    }
+
+    /* Measure the recommended configuration again */
+    hg_ret = hg_tune_trial(info_string, &workload, indices, latencies, &result);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_tune_trial() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    gain = (baseline.rate > 0) ? (result.rate / baseline.rate - 1.0) * 100.0
+                               : 0;
+    hg_perf_print_tune("tuned", "-", &result, gain);
+    hg_tune_print_config(indices, gain);
+
+    free(latencies);
+    free(info_string);
+    (void) HG_Test_finalize(&hg_test_info);
+
+    return EXIT_SUCCESS;
+
+error:
+    free(latencies);
+    free(info_string);
+    (void) HG_Test_finalize(&hg_test_info);
+
+    return EXIT_FAILURE;
+}
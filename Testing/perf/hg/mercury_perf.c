@@ -11,10 +11,17 @@
 #include "mercury_proc.h"
 #include "mercury_proc_bulk.h"
 
+#include <math.h>
+
 #ifndef _WIN32
+#    include <sys/resource.h>
 #    include <sys/uio.h>
 #endif
 
+#ifdef HG_TEST_HAS_CUDA
+#    include <cuda_runtime.h>
+#endif
+
 /****************/
 /* Local Macros */
 /****************/
@@ -25,6 +32,16 @@
 /* Default RMA count if not specified */
 #define HG_PERF_BULK_COUNT (64)
 
+/* Gap left after each segment so that segments are not coalesced */
+#define HG_PERF_SEG_GAP (64)
+
+/* Max length of RPC capture file names */
+#define HG_PERF_CAPTURE_PATH_MAX (1024)
+
+/* Random segment sizes are drawn from a fixed seed per transfer region, so
+ * that clients and servers derive the same layout */
+#define HG_PERF_SEG_SEED UINT64_C(0x9E3779B97F4A7C15)
+
 /* Wait max 5s */
 #define HG_PERF_TIMEOUT_MAX (5000)
 
@@ -37,6 +54,24 @@
 #define NDIGITS 2
 #define NWIDTH  27
 
+/* Column width of open-loop, scaling and mixed-workload results */
+#define NWIDTH_OPEN  14
+#define NWIDTH_SCALE 14
+#define NWIDTH_MIXED 12
+
+/* Column width of replay results */
+#define NWIDTH_REPLAY 14
+
+/* Column widths of tuning results */
+#define NWIDTH_TUNE       14
+#define NWIDTH_TUNE_PARAM 24
+
+/* Column width of segment counts */
+#define NWIDTH_SEG 12
+
+/* Column width of registration results */
+#define NWIDTH_REG 16
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -48,6 +83,23 @@ struct iovec {
 };
 #endif
 
+/* Open-loop run state */
+struct hg_perf_open_state {
+    struct hg_perf_open_slot *slots; /* One slot per handle */
+    size_t *free_ids;                /* Stack of free handle IDs */
+    double *latencies;               /* Latencies of completed RPCs (us) */
+    size_t free_count;               /* Number of free handles */
+    size_t complete_count;           /* Number of completed RPCs */
+    hg_return_t ret;                 /* First error */
+};
+
+/* Open-loop RPC in flight */
+struct hg_perf_open_slot {
+    struct hg_perf_open_state *state; /* Run state */
+    hg_time_t start;                  /* Scheduled arrival time */
+    size_t handle_id;                 /* Handle used */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -65,6 +117,10 @@ hg_perf_class_init(const struct hg_test_info *hg_test_info, int class_id,
 static void
 hg_perf_class_cleanup(struct hg_perf_class_info *info);
 
+static void
+hg_perf_report_meta(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info);
+
 static hg_return_t
 hg_perf_bulk_buf_alloc(
     struct hg_perf_class_info *info, uint8_t bulk_flags, bool init_data);
@@ -72,11 +128,34 @@ hg_perf_bulk_buf_alloc(
 static void
 hg_perf_bulk_buf_free(struct hg_perf_class_info *info);
 
-static void
-hg_perf_init_data(void *buf, size_t buf_size);
+static hg_return_t
+hg_perf_bulk_buf_post(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, hg_bulk_op_t bulk_op);
+
+static size_t
+hg_perf_bulk_region_stride(const struct hg_perf_class_info *info);
+
+static size_t
+hg_perf_bulk_segment_lens(const struct hg_perf_class_info *info,
+    size_t region, bool shift, hg_size_t *lens);
+
+static hg_return_t
+hg_perf_bulk_create(struct hg_perf_class_info *info, size_t index,
+    uint8_t bulk_flags, bool shift, bool init_data);
 
 static hg_return_t
-hg_perf_handle_create_cb(hg_handle_t handle, void *arg);
+hg_perf_bulk_data(const struct hg_perf_class_info *info, hg_bulk_t bulk,
+    size_t size, bool verify);
+
+static void *
+hg_perf_buf_alloc(
+    const struct hg_perf_class_info *info, size_t buf_size, bool init_data);
+
+static void
+hg_perf_buf_free(const struct hg_perf_class_info *info, void *buf);
+
+static void
+hg_perf_init_data(void *buf, size_t buf_size);
 
 static hg_return_t
 hg_perf_proc_iovec(hg_proc_t proc, void *arg);
@@ -111,10 +190,52 @@ hg_perf_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info);
 static hg_return_t
 hg_perf_done_cb(hg_handle_t handle);
 
+static hg_return_t
+hg_perf_proc_server_stats(hg_proc_t proc, void *arg);
+
+static hg_return_t
+hg_perf_stats_cb(hg_handle_t handle);
+
+static HG_THREAD_RETURN_TYPE
+hg_perf_offload_thread(void *arg);
+
+static hg_return_t
+hg_perf_offload_cb(hg_handle_t handle);
+
+static hg_return_t
+hg_perf_open_cb(const struct hg_cb_info *hg_cb_info);
+
+static uint64_t
+hg_perf_rand(uint64_t *seed_p);
+
+static double
+hg_perf_open_interval(double rate, bool poisson, uint64_t *seed_p);
+
+static int
+hg_perf_open_cmp(const void *a, const void *b);
+
+static double
+hg_perf_open_percentile(
+    const double *latencies, size_t count, double percentile);
+
+static HG_THREAD_RETURN_TYPE
+hg_perf_load_thread(void *arg);
+
+static void
+hg_perf_print_mixed(const struct hg_test_info *hg_test_info, size_t buf_size,
+    const struct hg_perf_probe_result *idle,
+    const struct hg_perf_probe_result *loaded, double bw);
+
 /*******************/
 /* Local Variables */
 /*******************/
 
+/* RPC handlers that can be offloaded to the thread pool */
+static const hg_rpc_cb_t hg_perf_offload_cbs_g[] = {
+    [HG_PERF_RATE] = hg_perf_rpc_rate_cb,
+    [HG_PERF_BW_READ] = hg_perf_bulk_push_cb,
+    [HG_PERF_BW_WRITE] = hg_perf_bulk_pull_cb};
+
 /*---------------------------------------------------------------------------*/
 static int
 hg_perf_request_progress(unsigned int timeout, void *arg)
@@ -201,14 +322,22 @@ hg_perf_class_init(const struct hg_test_info *hg_test_info, int class_id,
 
     info->class_id = class_id;
     info->hg_class = hg_class;
+    hg_atomic_init64(&info->rpc_count, 0);
     info->verify = hg_test_info->na_test_info.verify;
     info->bidir = hg_test_info->bidirectional;
+    info->device = hg_test_info->na_test_info.device;
+#ifndef HG_TEST_HAS_CUDA
+    HG_TEST_CHECK_ERROR(info->device, error, ret, HG_OPNOTSUPPORTED,
+        "Device memory requested but CUDA support was not enabled");
+#endif
+    HG_TEST_CHECK_ERROR(info->device && info->verify, error, ret,
+        HG_OPNOTSUPPORTED, "Cannot verify data in device memory");
 
-    /* Add extra info to handles created */
-    ret = HG_Class_set_handle_create_callback(
-        info->hg_class, hg_perf_handle_create_cb, NULL);
+    /* Keep request info inline with handles created */
+    ret = HG_Class_set_private_area_size(
+        info->hg_class, sizeof(struct hg_perf_request));
     HG_TEST_CHECK_HG_ERROR(error, ret,
-        "HG_Class_set_handle_create_callback() failed (%s)",
+        "HG_Class_set_private_area_size() failed (%s)",
         HG_Error_to_string(ret));
 
     info->context = HG_Context_create(info->hg_class);
@@ -216,6 +345,39 @@ hg_perf_class_init(const struct hg_test_info *hg_test_info, int class_id,
         "HG_Context_create() failed");
     (void) HG_Context_set_data(info->context, info, NULL);
 
+    /* Clients target contexts round-robin, servers progress all of them */
+    info->context_max = (hg_test_info->na_test_info.max_contexts > 1)
+                            ? hg_test_info->na_test_info.max_contexts
+                            : 1;
+    if (listen && info->context_max > 1) {
+        /* SM contexts share one endpoint, a context may then complete
+         * operations of another context without waking it up */
+        if (!hg_test_info->na_test_info.busy_wait &&
+            strcmp(HG_Class_get_protocol(info->hg_class), "sm") == 0)
+            HG_TEST_LOG_WARNING("SM contexts share one endpoint, use busy "
+                                "wait (-b) to avoid delayed completions");
+
+        info->contexts = (hg_context_t **) calloc(
+            info->context_max - 1, sizeof(*info->contexts));
+        HG_TEST_CHECK_ERROR(info->contexts == NULL, error, ret, HG_NOMEM,
+            "Could not allocate array of contexts");
+
+        for (i = 0; i < info->context_max - 1; i++) {
+            info->contexts[i] =
+                HG_Context_create_id(info->hg_class, (hg_uint8_t) (i + 1));
+            HG_TEST_CHECK_ERROR(info->contexts[i] == NULL, error, ret,
+                HG_NOMEM, "HG_Context_create_id() failed");
+            (void) HG_Context_set_data(info->contexts[i], info, NULL);
+        }
+    }
+
+    if (listen && hg_test_info->offload) {
+        int rc = hg_thread_pool_init(
+            hg_test_info->thread_count, &info->thread_pool);
+        HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+            "hg_thread_pool_init() failed");
+    }
+
     info->request_class = hg_request_init(
         hg_perf_request_progress, hg_perf_request_trigger, info);
 
@@ -232,25 +394,65 @@ hg_perf_class_init(const struct hg_test_info *hg_test_info, int class_id,
         HG_INVALID_ARG, "Max buffer size must be a power of 2 (%zu)",
         info->buf_size_max);
 
+    /* Clients sweep segment counts up to that max, servers get the layout
+     * from the bulk init RPC */
+    info->segment_max =
+        (hg_test_info->segment_count > 1) ? hg_test_info->segment_count : 1;
+    info->segment_count = 1;
+    info->segment_random = hg_test_info->segment_random;
+    info->segment_mismatch = hg_test_info->segment_mismatch;
+    HG_TEST_CHECK_ERROR(info->segment_max > info->buf_size_max, error, ret,
+        HG_INVALID_ARG, "Cannot split %zu byte(s) into %zu segments",
+        info->buf_size_max, info->segment_max);
+    HG_TEST_CHECK_ERROR(info->device && info->segment_max > 1, error, ret,
+        HG_OPNOTSUPPORTED, "Cannot segment device memory");
+
+    /* Servers may capture the RPCs they process so that they can be replayed,
+     * one file per class */
+    if (listen && hg_test_info->capture != NULL) {
+        char path[HG_PERF_CAPTURE_PATH_MAX];
+
+        if (hg_test_info->na_test_info.max_classes > 1)
+            snprintf(
+                path, sizeof(path), "%s.%d", hg_test_info->capture, class_id);
+        else
+            snprintf(path, sizeof(path), "%s", hg_test_info->capture);
+        ret = HG_Class_set_capture(info->hg_class, path);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Class_set_capture() failed (%s)", HG_Error_to_string(ret));
+    }
+
     /* Register RPCs */
     ret = HG_Register(info->hg_class, HG_PERF_RATE_INIT, NULL, NULL,
         hg_perf_rpc_rate_init_cb);
 
     ret = HG_Register(info->hg_class, HG_PERF_RATE, hg_perf_proc_iovec,
         (hg_test_info->bidirectional) ? hg_perf_proc_iovec : NULL,
-        hg_perf_rpc_rate_cb);
+        (info->thread_pool) ? hg_perf_offload_cb : hg_perf_rpc_rate_cb);
+
+    /* Latency probes may be prioritized over bulk traffic */
+    if (hg_test_info->priority) {
+        ret = HG_Registered_set_priority(
+            info->hg_class, HG_PERF_RATE, HG_PRIO_HIGH);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Registered_set_priority() failed (%s)",
+            HG_Error_to_string(ret));
+    }
 
     ret = HG_Register(info->hg_class, HG_PERF_BW_INIT,
         hg_perf_proc_bulk_init_info, NULL, hg_perf_bulk_init_cb);
 
     ret = HG_Register(info->hg_class, HG_PERF_BW_READ, hg_perf_proc_bulk_info,
-        NULL, hg_perf_bulk_push_cb);
+        NULL, (info->thread_pool) ? hg_perf_offload_cb : hg_perf_bulk_push_cb);
 
     ret = HG_Register(info->hg_class, HG_PERF_BW_WRITE, hg_perf_proc_bulk_info,
-        NULL, hg_perf_bulk_pull_cb);
+        NULL, (info->thread_pool) ? hg_perf_offload_cb : hg_perf_bulk_pull_cb);
 
     ret =
         HG_Register(info->hg_class, HG_PERF_DONE, NULL, NULL, hg_perf_done_cb);
+
+    ret = HG_Register(info->hg_class, HG_PERF_STATS, NULL,
+        hg_perf_proc_server_stats, hg_perf_stats_cb);
     HG_TEST_CHECK_HG_ERROR(
         error, ret, "HG_Register() failed (%s)", HG_Error_to_string(ret));
 
@@ -325,6 +527,12 @@ hg_perf_class_cleanup(struct hg_perf_class_info *info)
 {
     size_t i;
 
+    /* Wait for offloaded handlers */
+    if (info->thread_pool != NULL) {
+        hg_thread_pool_destroy(info->thread_pool);
+        info->thread_pool = NULL;
+    }
+
     if (info->handles != NULL) {
         for (i = 0; i < info->handle_max; i++)
             HG_Destroy(info->handles[i]);
@@ -361,6 +569,14 @@ hg_perf_class_cleanup(struct hg_perf_class_info *info)
     if (info->request_class)
         hg_request_finalize(info->request_class, NULL);
 
+    if (info->contexts != NULL) {
+        for (i = 0; i < info->context_max - 1; i++)
+            if (info->contexts[i])
+                HG_Context_destroy(info->contexts[i]);
+        free(info->contexts);
+        info->contexts = NULL;
+    }
+
     if (info->context)
         HG_Context_destroy(info->context);
 }
@@ -370,7 +586,6 @@ static hg_return_t
 hg_perf_bulk_buf_alloc(
     struct hg_perf_class_info *info, uint8_t bulk_flags, bool init_data)
 {
-    size_t page_size = (size_t) hg_mem_get_page_size();
     hg_return_t ret;
     size_t i;
 
@@ -384,21 +599,17 @@ hg_perf_bulk_buf_alloc(
         "malloc(%zu) failed", info->handle_max * sizeof(hg_bulk_t));
 
     for (i = 0; i < info->handle_max; i++) {
-        hg_size_t alloc_size = info->buf_size_max * info->bulk_count;
+        size_t alloc_size =
+            hg_perf_bulk_region_stride(info) * info->bulk_count;
 
-        /* Prepare buf */
-        info->bulk_bufs[i] = hg_mem_aligned_alloc(page_size, alloc_size);
+        /* Prepare buf, segmented data is laid out through the handle */
+        info->bulk_bufs[i] = hg_perf_buf_alloc(
+            info, alloc_size, init_data && info->segment_max == 1);
         HG_TEST_CHECK_ERROR(info->bulk_bufs[i] == NULL, error, ret, HG_NOMEM,
-            "hg_mem_aligned_alloc(%zu, %zu) failed", page_size,
-            info->buf_size_max);
+            "hg_perf_buf_alloc(%zu) failed", alloc_size);
 
-        /* Initialize data */
-        if (init_data)
-            hg_perf_init_data(info->bulk_bufs[i], alloc_size);
-
-        ret = HG_Bulk_create(info->hg_class, 1, &info->bulk_bufs[i],
-            &alloc_size, bulk_flags, &info->local_bulk_handles[i]);
-        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_create() failed (%s)",
+        ret = hg_perf_bulk_create(info, i, bulk_flags, false, init_data);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_bulk_create() failed (%s)",
             HG_Error_to_string(ret));
     }
 
@@ -414,7 +625,7 @@ error:
 
     if (info->bulk_bufs != NULL) {
         for (i = 0; i < info->handle_max; i++)
-            hg_mem_aligned_free(info->bulk_bufs[i]);
+            hg_perf_buf_free(info, info->bulk_bufs[i]);
         free(info->bulk_bufs);
         info->bulk_bufs = NULL;
     }
@@ -437,28 +648,193 @@ hg_perf_bulk_buf_free(struct hg_perf_class_info *info)
 
     if (info->bulk_bufs != NULL) {
         for (i = 0; i < info->handle_max; i++)
-            hg_mem_aligned_free(info->bulk_bufs[i]);
+            hg_perf_buf_free(info, info->bulk_bufs[i]);
         free(info->bulk_bufs);
         info->bulk_bufs = NULL;
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static size_t
+hg_perf_bulk_region_stride(const struct hg_perf_class_info *info)
+{
+    /* Shifted layouts have one more segment than the segment count */
+    return (info->segment_max > 1)
+               ? info->buf_size_max + (info->segment_max + 1) * HG_PERF_SEG_GAP
+               : info->buf_size_max;
+}
+
+/*---------------------------------------------------------------------------*/
+static size_t
+hg_perf_bulk_segment_lens(const struct hg_perf_class_info *info,
+    size_t region, bool shift, hg_size_t *lens)
+{
+    size_t count = info->segment_count, size = info->buf_size_max, i, n;
+    hg_size_t carry = 0;
+
+    if (info->segment_random) {
+        uint64_t seed = HG_PERF_SEG_SEED * (uint64_t) (region + 1), sum = 0;
+        size_t used = 0;
+
+        /* Every segment gets at least one byte */
+        for (i = 0; i < count; i++) {
+            lens[i] = (hg_size_t) (hg_perf_rand(&seed) >> 48) + 1;
+            sum += lens[i];
+        }
+        for (i = 0; i < count; i++) {
+            lens[i] = 1 + (hg_size_t) ((size - count) * lens[i] / sum);
+            used += (size_t) lens[i];
+        }
+        lens[count - 1] += (hg_size_t) (size - used);
+    } else {
+        for (i = 0; i < count; i++)
+            lens[i] = (hg_size_t) (size / count);
+        lens[count - 1] += (hg_size_t) (size % count);
+    }
+
+    if (!shift)
+        return count;
+
+    /* Move every boundary to the middle of a segment so that no boundary
+     * matches the other side */
+    for (i = 0; i < count; i++) {
+        hg_size_t len = lens[i];
+
+        lens[i] = carry + len / 2;
+        carry = len - len / 2;
+    }
+    lens[count] = carry;
+
+    /* Drop empty segments */
+    for (i = 0, n = 0; i <= count; i++)
+        if (lens[i] > 0)
+            lens[n++] = lens[i];
+
+    return n;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_bulk_create(struct hg_perf_class_info *info, size_t index,
+    uint8_t bulk_flags, bool shift, bool init_data)
+{
+    struct hg_bulk_attr attrs = {
+        .mem_type = info->device ? HG_MEM_TYPE_CUDA : HG_MEM_TYPE_HOST,
+        .device = 0};
+    size_t stride = hg_perf_bulk_region_stride(info),
+           gap = (info->segment_max > 1) ? HG_PERF_SEG_GAP : 0,
+           seg_max = info->bulk_count * (info->segment_count + 1), count = 0,
+           i;
+    hg_bulk_t bulk = HG_BULK_NULL;
+    hg_size_t *lens = NULL;
+    void **bufs = NULL;
+    hg_return_t ret;
+
+    bufs = (void **) malloc(seg_max * sizeof(*bufs));
+    HG_TEST_CHECK_ERROR(bufs == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %zu segments", seg_max);
+    lens = (hg_size_t *) malloc(seg_max * sizeof(*lens));
+    HG_TEST_CHECK_ERROR(lens == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %zu segment sizes", seg_max);
+
+    /* Contiguous regions are coalesced back into a single segment */
+    for (i = 0; i < info->bulk_count; i++) {
+        char *base = (char *) info->bulk_bufs[index] + i * stride;
+        size_t n = hg_perf_bulk_segment_lens(info, i, shift, &lens[count]), j;
+
+        for (j = 0; j < n; j++) {
+            bufs[count + j] = base;
+            base += lens[count + j] + gap;
+        }
+        count += n;
+    }
+
+    ret = HG_Bulk_create_attr(info->hg_class, (hg_uint32_t) count, bufs, lens,
+        bulk_flags, &attrs, &bulk);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_create_attr() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Data follows the logical layout once segments are spread out */
+    if (init_data && info->segment_max > 1) {
+        ret = hg_perf_bulk_data(info, bulk, info->buf_size_max, false);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_bulk_data() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    /* Replace previous layout */
+    (void) HG_Bulk_free(info->local_bulk_handles[index]);
+    info->local_bulk_handles[index] = bulk;
+
+    free(bufs);
+    free(lens);
+
+    return HG_SUCCESS;
+
+error:
+    (void) HG_Bulk_free(bulk);
+    free(bufs);
+    free(lens);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_perf_handle_create_cb(hg_handle_t handle, void HG_ATTR_UNUSED *arg)
+hg_perf_bulk_data(const struct hg_perf_class_info *info, hg_bulk_t bulk,
+    size_t size, bool verify)
 {
-    struct hg_perf_request *request;
+    hg_uint32_t max_count = (hg_uint32_t) info->segment_max + 1;
+    hg_size_t *lens = NULL;
+    void **bufs = NULL;
     hg_return_t ret;
+    size_t i;
+
+    bufs = (void **) malloc(max_count * sizeof(*bufs));
+    HG_TEST_CHECK_ERROR(bufs == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %u segments", max_count);
+    lens = (hg_size_t *) malloc(max_count * sizeof(*lens));
+    HG_TEST_CHECK_ERROR(lens == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %u segment sizes", max_count);
+
+    /* Each transfer region holds the same pattern as a contiguous buffer */
+    for (i = 0; i < info->bulk_count; i++) {
+        hg_uint32_t actual_count = 0, j;
+        size_t offset = 0;
 
-    request = (struct hg_perf_request *) calloc(1, sizeof(*request));
-    HG_TEST_CHECK_ERROR(request == NULL, error, ret, HG_NOMEM,
-        "Could not allocate hg_test_handle_info");
+        ret = HG_Bulk_access(bulk, i * info->buf_size_max, size,
+            HG_BULK_READWRITE, max_count, bufs, lens, &actual_count);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_access() failed (%s)",
+            HG_Error_to_string(ret));
+
+        for (j = 0; j < actual_count; j++) {
+            char *buf_ptr = (char *) bufs[j];
+            hg_size_t k;
+
+            for (k = 0; k < lens[j]; k++, offset++) {
+                if (!verify) {
+                    buf_ptr[k] = (char) offset;
+                    continue;
+                }
+                HG_TEST_CHECK_ERROR(buf_ptr[k] != (char) offset, error, ret,
+                    HG_FAULT,
+                    "Error detected in bulk transfer, buf[%zu] = %d, "
+                    "was expecting %d!",
+                    offset, buf_ptr[k], (char) offset);
+            }
+        }
+        HG_TEST_CHECK_ERROR(offset != size, error, ret, HG_FAULT,
+            "Accessed %zu byte(s) out of %zu", offset, size);
+    }
 
-    HG_Set_data(handle, request, free);
+    free(bufs);
+    free(lens);
 
     return HG_SUCCESS;
 
 error:
+    free(bufs);
+    free(lens);
+
     return ret;
 }
 
@@ -474,6 +850,13 @@ hg_perf_set_handles(struct hg_perf_class_info *info, enum hg_perf_rpc_id rpc_id)
             info->target_addrs[i % info->target_addr_max], (hg_id_t) rpc_id);
         HG_TEST_CHECK_HG_ERROR(
             error, ret, "HG_Reset() failed (%s)", HG_Error_to_string(ret));
+
+        if (info->context_max > 1) {
+            ret = HG_Set_target_id(
+                info->handles[i], (hg_uint8_t) (i % info->context_max));
+            HG_TEST_CHECK_HG_ERROR(error, ret,
+                "HG_Set_target_id() failed (%s)", HG_Error_to_string(ret));
+        }
     }
 
     return HG_SUCCESS;
@@ -559,12 +942,68 @@ hg_perf_bulk_buf_init(const struct hg_test_info *hg_test_info,
     hg_uint8_t bulk_flags =
         (bulk_op == HG_BULK_PULL) ? HG_BULK_READ_ONLY : HG_BULK_WRITE_ONLY;
     hg_return_t ret;
-    size_t i;
 
     ret = hg_perf_bulk_buf_alloc(info, bulk_flags, bulk_op == HG_BULK_PULL);
     HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_bulk_buf_alloc() failed (%s)",
         HG_Error_to_string(ret));
 
+    ret = hg_perf_bulk_buf_post(hg_test_info, info, bulk_op);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_bulk_buf_post() failed (%s)",
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    hg_perf_bulk_buf_free(info);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_bulk_segments_set(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, hg_bulk_op_t bulk_op,
+    size_t segment_count)
+{
+    hg_uint8_t bulk_flags =
+        (bulk_op == HG_BULK_PULL) ? HG_BULK_READ_ONLY : HG_BULK_WRITE_ONLY;
+    hg_return_t ret;
+    size_t i;
+
+    HG_TEST_CHECK_ERROR(segment_count == 0 || segment_count > info->segment_max,
+        error, ret, HG_INVALID_ARG, "Invalid segment count (%zu)",
+        segment_count);
+    info->segment_count = segment_count;
+
+    for (i = 0; i < info->handle_max; i++) {
+        ret = hg_perf_bulk_create(
+            info, i, bulk_flags, false, bulk_op == HG_BULK_PULL);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "hg_perf_bulk_create() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    /* Servers re-create their handles with the new layout */
+    ret = hg_perf_bulk_buf_post(hg_test_info, info, bulk_op);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_bulk_buf_post() failed (%s)",
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_bulk_buf_post(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, hg_bulk_op_t bulk_op)
+{
+    uint32_t segment_flags =
+        (uint32_t) ((info->segment_random ? HG_PERF_SEG_RANDOM : 0) |
+                    (info->segment_mismatch ? HG_PERF_SEG_MISMATCH : 0));
+    hg_return_t ret;
+    size_t i;
+
     for (i = 0; i < info->handle_max; i++) {
         struct hg_perf_request args = {
             .expected_count = 1, .complete_count = 0, .request = info->request};
@@ -578,7 +1017,10 @@ hg_perf_bulk_buf_init(const struct hg_test_info *hg_test_info,
             .handle_max = (uint32_t) info->handle_max,
             .comm_rank = (uint32_t) hg_test_info->na_test_info.mpi_comm_rank,
             .comm_size = (uint32_t) hg_test_info->na_test_info.mpi_comm_size,
-            .target_addr_max = (uint32_t) info->target_addr_max};
+            .target_addr_max = (uint32_t) info->target_addr_max,
+            .segment_max = (uint32_t) info->segment_max,
+            .segment_count = (uint32_t) info->segment_count,
+            .segment_flags = segment_flags};
 
         ret = HG_Reset(info->handles[0],
             info->target_addrs[i % info->target_addr_max],
@@ -609,11 +1051,75 @@ hg_perf_bulk_buf_init(const struct hg_test_info *hg_test_info,
     return HG_SUCCESS;
 
 error:
-    hg_perf_bulk_buf_free(info);
-
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void *
+hg_perf_buf_alloc(
+    const struct hg_perf_class_info *info, size_t buf_size, bool init_data)
+{
+    size_t page_size = (size_t) hg_mem_get_page_size();
+    void *buf;
+
+#ifdef HG_TEST_HAS_CUDA
+    if (info->device) {
+        void *host_buf = NULL;
+        cudaError_t cuda_rc;
+
+        cuda_rc = cudaMalloc(&buf, buf_size);
+        HG_TEST_CHECK_ERROR_NORET(cuda_rc != cudaSuccess, error,
+            "cudaMalloc(%zu) failed (%s)", buf_size,
+            cudaGetErrorString(cuda_rc));
+        if (!init_data)
+            return buf;
+
+        /* Initialize data on host and copy to device */
+        host_buf = hg_mem_aligned_alloc(page_size, buf_size);
+        HG_TEST_CHECK_ERROR_NORET(host_buf == NULL, error_free,
+            "hg_mem_aligned_alloc(%zu, %zu) failed", page_size, buf_size);
+        hg_perf_init_data(host_buf, buf_size);
+        cuda_rc = cudaMemcpy(buf, host_buf, buf_size, cudaMemcpyHostToDevice);
+        hg_mem_aligned_free(host_buf);
+        HG_TEST_CHECK_ERROR_NORET(cuda_rc != cudaSuccess, error_free,
+            "cudaMemcpy(%zu) failed (%s)", buf_size,
+            cudaGetErrorString(cuda_rc));
+
+        return buf;
+
+error_free:
+        (void) cudaFree(buf);
+error:
+        return NULL;
+    }
+#else
+    (void) info;
+#endif
+
+    buf = hg_mem_aligned_alloc(page_size, buf_size);
+    if (buf != NULL && init_data)
+        hg_perf_init_data(buf, buf_size);
+
+    return buf;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_perf_buf_free(const struct hg_perf_class_info *info, void *buf)
+{
+    if (buf == NULL)
+        return;
+#ifdef HG_TEST_HAS_CUDA
+    if (info->device) {
+        (void) cudaFree(buf);
+        return;
+    }
+#else
+    (void) info;
+#endif
+    hg_mem_aligned_free(buf);
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_perf_init_data(void *buf, size_t buf_size)
@@ -646,11 +1152,60 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_verify_bulk(
+    const struct hg_perf_class_info *info, hg_bulk_t bulk, size_t size)
+{
+    return hg_perf_bulk_data(info, bulk, size, true);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_perf_report_meta(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info)
+{
+    const struct na_test_info *na_test_info = &hg_test_info->na_test_info;
+
+    na_test_report_meta(na_test_info, "size_min", "%zu", info->buf_size_min);
+    na_test_report_meta(na_test_info, "size_max", "%zu", info->buf_size_max);
+    na_test_report_meta(na_test_info, "handles", "%zu", info->handle_max);
+    na_test_report_meta(
+        na_test_info, "target_addrs", "%zu", info->target_addr_max);
+    na_test_report_meta(
+        na_test_info, "threads", "%u", hg_test_info->thread_count);
+    na_test_report_meta(na_test_info, "progress_threads", "%u",
+        hg_test_info->progress_thread_count);
+    na_test_report_meta(na_test_info, "offload", "%s",
+        hg_test_info->offload ? "true" : "false");
+    na_test_report_meta(na_test_info, "bidirectional", "%s",
+        hg_test_info->bidirectional ? "true" : "false");
+
+    /* Settings passed to HG_Init_opt2() by HG_Test_init() */
+    na_test_report_meta(na_test_info, "hg_init_info.auto_sm", "%s",
+        hg_test_info->auto_sm ? "true" : "false");
+    na_test_report_meta(na_test_info, "hg_init_info.no_multi_recv", "%s",
+        na_test_info->no_multi_recv ? "true" : "false");
+    na_test_report_meta(na_test_info, "hg_init_info.progress_mode", "%s",
+        na_test_info->busy_wait ? "NA_NO_BLOCK" : "default");
+    na_test_report_meta(na_test_info, "hg_init_info.max_contexts", "%u",
+        (unsigned) na_test_info->max_contexts);
+}
+
 /*---------------------------------------------------------------------------*/
 void
 hg_perf_print_header_lat(const struct hg_test_info *hg_test_info,
     const struct hg_perf_class_info *info, const char *benchmark)
 {
+    static const struct na_test_report_metric metrics[] = {
+        {"time_us", false}, {"rate_rpc_s", true}};
+
+    if (!na_test_report_begin(&hg_test_info->na_test_info, benchmark,
+            VERSION_NAME, metrics, 2, false)) {
+        hg_perf_report_meta(hg_test_info, info);
+        return;
+    }
+
     printf("# %s v%s\n", benchmark, VERSION_NAME);
     printf("# Loop %d times from size %zu to %zu byte(s) with %zu handle(s) "
            "in-flight\n",
@@ -671,7 +1226,7 @@ void
 hg_perf_print_lat(const struct hg_test_info *hg_test_info,
     const struct hg_perf_class_info *info, size_t buf_size, hg_time_t t)
 {
-    double rpc_time;
+    double values[2], rpc_time;
     size_t loop = (size_t) hg_test_info->na_test_info.loop,
            handle_max = (size_t) info->handle_max,
            dir = (size_t) (hg_test_info->bidirectional ? 2 : 1),
@@ -680,8 +1235,11 @@ hg_perf_print_lat(const struct hg_test_info *hg_test_info,
     rpc_time = hg_time_to_double(t) * 1e6 /
                (double) (loop * handle_max * dir * mpi_comm_size);
 
-    printf("%-*zu%*.*f%*lu\n", 10, buf_size, NWIDTH, NDIGITS, rpc_time, NWIDTH,
-        (long unsigned int) (1e6 / rpc_time));
+    values[0] = rpc_time;
+    values[1] = 1e6 / rpc_time;
+    if (na_test_report_row(&hg_test_info->na_test_info, buf_size, 0, values))
+        printf("%-*zu%*.*f%*lu\n", 10, buf_size, NWIDTH, NDIGITS, rpc_time,
+            NWIDTH, (long unsigned int) values[1]);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -689,18 +1247,56 @@ void
 hg_perf_print_header_bw(const struct hg_test_info *hg_test_info,
     const struct hg_perf_class_info *info, const char *benchmark)
 {
+    const struct na_test_report_metric metrics[] = {
+        {hg_test_info->na_test_info.mbps ? "bw_mb_s" : "bw_mib_s", true},
+        {"time_us", false}};
+    const char *size_label = "# Size";
+    size_t vec_threshold, nt_threshold;
+
+    hg_mem_copy_get_thresholds(&vec_threshold, &nt_threshold);
+    if (!na_test_report_begin(&hg_test_info->na_test_info, benchmark,
+            VERSION_NAME, metrics, 2, info->segment_max > 1)) {
+        hg_perf_report_meta(hg_test_info, info);
+        na_test_report_meta(&hg_test_info->na_test_info, "bulk_count", "%zu",
+            info->bulk_count);
+        na_test_report_meta(&hg_test_info->na_test_info, "segments", "%zu",
+            info->segment_max);
+        na_test_report_meta(&hg_test_info->na_test_info, "segment_sizes", "%s",
+            info->segment_random ? "random" : "uniform");
+        na_test_report_meta(&hg_test_info->na_test_info, "remote_layout",
+            "%s", info->segment_mismatch ? "shifted" : "matching");
+        na_test_report_meta(&hg_test_info->na_test_info, "copy_kernel", "%s",
+            hg_mem_copy_get_kernel());
+        return;
+    }
+
     printf("# %s v%s\n", benchmark, VERSION_NAME);
-    printf("# Loop %d times from size %zu to %zu byte(s) with %zu handle(s) "
-           "in-flight\n# - %zu bulk transfer(s) per handle\n",
-        hg_test_info->na_test_info.loop, info->buf_size_min, info->buf_size_max,
-        info->handle_max, (size_t) info->bulk_count);
+    if (info->segment_max > 1)
+        printf("# Loop %d times at size %zu byte(s) from 1 to %zu segment(s) "
+               "with %zu handle(s) in-flight\n# - %zu bulk transfer(s) per "
+               "handle, %s segment sizes, %s remote layout\n",
+            hg_test_info->na_test_info.loop, info->buf_size_max,
+            info->segment_max, info->handle_max, (size_t) info->bulk_count,
+            info->segment_random ? "random" : "uniform",
+            info->segment_mismatch ? "shifted" : "matching");
+    else
+        printf("# Loop %d times from size %zu to %zu byte(s) with %zu "
+               "handle(s) in-flight\n# - %zu bulk transfer(s) per handle\n",
+            hg_test_info->na_test_info.loop, info->buf_size_min,
+            info->buf_size_max, info->handle_max, (size_t) info->bulk_count);
+    printf("# Copy kernel: %s (SIMD >= %zu, non-temporal >= %zu byte(s))\n",
+        hg_mem_copy_get_kernel(), vec_threshold, nt_threshold);
     if (info->verify)
         printf("# WARNING verifying data, output will be slower\n");
+    if (info->segment_max > 1) {
+        printf("%-*s", NWIDTH_SEG, "# Segments");
+        size_label = "Size";
+    }
     if (hg_test_info->na_test_info.mbps)
-        printf("%-*s%*s%*s\n", 10, "# Size", NWIDTH, "Bandwidth (MB/s)", NWIDTH,
-            "Time (us)");
+        printf("%-*s%*s%*s\n", 10, size_label, NWIDTH, "Bandwidth (MB/s)",
+            NWIDTH, "Time (us)");
     else
-        printf("%-*s%*s%*s\n", 10, "# Size", NWIDTH, "Bandwidth (MiB/s)",
+        printf("%-*s%*s%*s\n", 10, size_label, NWIDTH, "Bandwidth (MiB/s)",
             NWIDTH, "Time (us)");
     fflush(stdout);
 }
@@ -714,7 +1310,7 @@ hg_perf_print_bw(const struct hg_test_info *hg_test_info,
            mpi_comm_size = (size_t) hg_test_info->na_test_info.mpi_comm_size,
            handle_max = (size_t) info->handle_max,
            buf_count = (size_t) info->bulk_count;
-    double avg_time, avg_bw;
+    double values[2], avg_time, avg_bw;
 
     avg_time = hg_time_to_double(t) * 1e6 /
                (double) (loop * handle_max * mpi_comm_size * buf_count);
@@ -727,57 +1323,736 @@ hg_perf_print_bw(const struct hg_test_info *hg_test_info,
     else
         avg_bw /= (1024 * 1024); /* MiB/s */
 
+    values[0] = avg_bw;
+    values[1] = avg_time;
+    if (!na_test_report_row(&hg_test_info->na_test_info, buf_size,
+            info->segment_count, values))
+        return;
+
+    if (info->segment_max > 1)
+        printf("%-*zu", NWIDTH_SEG, info->segment_count);
     printf("%-*zu%*.*f%*.*f\n", 10, buf_size, NWIDTH, NDIGITS, avg_bw, NWIDTH,
         NDIGITS, avg_time);
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-hg_perf_request_complete(const struct hg_cb_info *hg_cb_info)
+void
+hg_perf_print_header_reg(const struct hg_test_info *hg_test_info,
+    const char *benchmark, size_t size_min, size_t size_max,
+    const char *mem_name, size_t page_size, size_t segment_count)
 {
-    struct hg_perf_request *info = (struct hg_perf_request *) hg_cb_info->arg;
-
-    if ((++info->complete_count) == info->expected_count)
-        hg_request_complete(info->request);
-
-    return HG_SUCCESS;
+    printf("# %s v%s\n", benchmark, VERSION_NAME);
+    printf("# Loop %d times from size %zu to %zu byte(s), %s memory",
+        hg_test_info->na_test_info.loop, size_min, size_max, mem_name);
+    if (page_size > 0)
+        printf(" (%zu byte pages)", page_size);
+    printf("\n# - %zu segment(s) per handle\n", segment_count);
+    printf("%-*s%*s%*s%*s%*s%*s\n", 10, "# Size", NWIDTH_REG, "First (us)",
+        NWIDTH_REG, "Create (us)", NWIDTH_REG, "Serialize (us)", NWIDTH_REG,
+        "Free (us)", NWIDTH_REG, "Total (us)");
+    fflush(stdout);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_perf_proc_iovec(hg_proc_t proc, void *arg)
+void
+hg_perf_print_reg(size_t buf_size, const struct hg_perf_reg_times *times)
 {
-    struct iovec *iov = (struct iovec *) arg;
-    uint32_t len = (uint32_t) iov->iov_len;
-    hg_return_t ret;
-
-    if (hg_proc_get_op(proc) == HG_FREE)
-        return HG_SUCCESS;
-
-    ret = hg_proc_uint32_t(proc, &len);
-    HG_TEST_CHECK_HG_ERROR(
-        error, ret, "hg_proc_uint32_t() failed (%s)", HG_Error_to_string(ret));
-    iov->iov_len = (size_t) len;
+    printf("%-*zu%*.*f%*.*f%*.*f%*.*f%*.*f\n", 10, buf_size, NWIDTH_REG,
+        NDIGITS, times->first, NWIDTH_REG, NDIGITS, times->create, NWIDTH_REG,
+        NDIGITS, times->serialize, NWIDTH_REG, NDIGITS, times->free,
+        NWIDTH_REG, NDIGITS, times->create + times->serialize + times->free);
+    fflush(stdout);
+}
 
-    if (len == 0)
-        return HG_SUCCESS;
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_header_startup(
+    const struct hg_test_info *hg_test_info, const char *benchmark)
+{
+    printf("# %s v%s\n", benchmark, VERSION_NAME);
+    printf("# %d process(es) against %" PRIu32 " target(s), times are per "
+           "process\n",
+        hg_test_info->na_test_info.mpi_comm_size,
+        hg_test_info->na_test_info.max_targets);
+    printf("%-*s%*s%*s%*s%*s\n", 16, "# Phase", NWIDTH_REG, "Count",
+        NWIDTH_REG, "Avg (ms)", NWIDTH_REG, "Max (ms)", NWIDTH_REG,
+        "Avg/op (us)");
+    fflush(stdout);
+}
 
-    ret = hg_proc_raw(proc, iov->iov_base, iov->iov_len);
-    HG_TEST_CHECK_HG_ERROR(
-        error, ret, "hg_proc_raw() failed (%s)", HG_Error_to_string(ret));
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_startup(
+    const char *phase, size_t op_count, const double *times, size_t count)
+{
+    double sum = 0, max = 0;
+    size_t i;
 
-    return HG_SUCCESS;
+    for (i = 0; i < count; i++) {
+        sum += times[i];
+        max = MAX(max, times[i]);
+    }
 
-error:
-    return ret;
+    printf("%-*s%*zu%*.*f%*.*f%*.*f\n", 16, phase, NWIDTH_REG, op_count,
+        NWIDTH_REG, NDIGITS, sum * 1e3 / (double) count, NWIDTH_REG, NDIGITS,
+        max * 1e3, NWIDTH_REG, NDIGITS,
+        sum * 1e6 / (double) (count * MAX(op_count, 1)));
+    fflush(stdout);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_perf_proc_bulk_init_info(hg_proc_t proc, void *arg)
+void
+hg_perf_print_header_replay(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info, const char *benchmark, size_t count,
+    double duration, size_t clamp_count)
 {
-    struct hg_perf_bulk_init_info *info = (struct hg_perf_bulk_init_info *) arg;
-    hg_return_t ret;
+    printf("# %s v%s\n", benchmark, VERSION_NAME);
+    printf("# %zu RPC(s) captured over %.3f s in %s, replayed with up to %zu "
+           "handle(s) in-flight\n",
+        count, duration, hg_test_info->capture, info->handle_max);
+    printf("# RPCs with bulk data are replayed as bulk pulls of that size, "
+           "others as RPCs of the same request size\n");
+    if (clamp_count > 0)
+        printf("# %zu RPC(s) above %zu byte(s) were clamped to that size\n",
+            clamp_count, info->buf_size_max);
+    printf("# Latencies are measured from captured arrival times\n");
+    printf("%-*s%*s%*s%*s%*s%*s%*s%*s%*s\n", 10, "# Type", NWIDTH_REPLAY,
+        "Count", NWIDTH_REPLAY, "Capt (RPC/s)", NWIDTH_REPLAY, "Rate (RPC/s)",
+        NWIDTH_REPLAY, "Capt hdl (us)", NWIDTH_REPLAY, "p50 (us)",
+        NWIDTH_REPLAY, "p99 (us)", NWIDTH_REPLAY, "p99.9 (us)", NWIDTH_REPLAY,
+        "Max (us)");
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_replay(
+    const char *type, const struct hg_perf_replay_result *result)
+{
+    printf("%-*s%*zu%*.0f%*.0f%*.*f%*.*f%*.*f%*.*f%*.*f\n", 10, type,
+        NWIDTH_REPLAY, result->count, NWIDTH_REPLAY, result->captured,
+        NWIDTH_REPLAY, result->achieved, NWIDTH_REPLAY, NDIGITS,
+        result->handler_p50, NWIDTH_REPLAY, NDIGITS, result->p50,
+        NWIDTH_REPLAY, NDIGITS, result->p99, NWIDTH_REPLAY, NDIGITS,
+        result->p999, NWIDTH_REPLAY, NDIGITS, result->max);
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_header_tune(const struct hg_test_info *hg_test_info,
+    const char *benchmark, size_t size_min, size_t size_max, size_t rpc_count,
+    double gain_min)
+{
+    printf("# %s v%s\n", benchmark, VERSION_NAME);
+    printf("# Workload: %zu to %zu byte(s), %u handle(s) in-flight, %u%% bulk "
+           "RPCs, %zu RPC(s) per trial\n",
+        size_min, size_max, hg_test_info->handle_max, hg_test_info->bulk_ratio,
+        rpc_count);
+    printf("# Parameters are tuned one at a time, a value is kept if it "
+           "improves the rate by at least %.0f%%\n",
+        gain_min);
+    printf("%-*s%*s%*s%*s%*s%*s\n", NWIDTH_TUNE_PARAM, "# Parameter",
+        NWIDTH_TUNE, "Value", NWIDTH_TUNE, "Rate (RPC/s)", NWIDTH_TUNE,
+        "p50 (us)", NWIDTH_TUNE, "p99 (us)", NWIDTH_TUNE, "Gain (%)");
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_tune(const char *param, const char *value,
+    const struct hg_perf_probe_result *result, double gain)
+{
+    printf("%-*s%*s%*.0f%*.*f%*.*f%*.*f\n", NWIDTH_TUNE_PARAM, param,
+        NWIDTH_TUNE, value, NWIDTH_TUNE, result->rate, NWIDTH_TUNE, NDIGITS,
+        result->p50, NWIDTH_TUNE, NDIGITS, result->p99, NWIDTH_TUNE, NDIGITS,
+        gain);
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_progress(const struct hg_perf_class_info *info)
+{
+    struct hg_progress_stats stats;
+    double total;
+
+    if (HG_Context_get_progress_stats(info->context, &stats) != HG_SUCCESS)
+        return;
+
+    total = (double) (stats.progress_time + stats.trigger_time +
+                      stats.trigger_wait_time);
+    if (total <= 0.0)
+        return;
+
+    printf("# Progress (class %d): %" PRIu64 " progress and %" PRIu64
+           " trigger call(s), idle %.1f%%, busy %.1f%%\n",
+        info->class_id, stats.progress_count, stats.trigger_count,
+        stats.idle_ratio * 100.0, stats.busy_ratio * 100.0);
+    printf("# - poll wait %.1f%%, NA %.1f%%, NA SM %.1f%%, trigger %.1f%% "
+           "(callbacks %.1f%%), trigger wait %.1f%%\n",
+        (double) stats.poll_wait_time * 100.0 / total,
+        (double) stats.na_time * 100.0 / total,
+        (double) stats.na_sm_time * 100.0 / total,
+        (double) stats.trigger_time * 100.0 / total,
+        (double) stats.callback_time * 100.0 / total,
+        (double) stats.trigger_wait_time * 100.0 / total);
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_run_open(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, size_t buf_size, double rate,
+    struct hg_perf_open_result *result)
+{
+    struct iovec in_struct = {.iov_base = info->rpc_buf, .iov_len = buf_size};
+    struct hg_perf_open_state state = {.slots = NULL,
+        .free_ids = NULL,
+        .latencies = NULL,
+        .free_count = 0,
+        .complete_count = 0,
+        .ret = HG_SUCCESS};
+    size_t count = (size_t) hg_test_info->na_test_info.loop * info->handle_max,
+           sent = 0, i;
+    uint64_t seed = UINT64_C(0x9E3779B97F4A7C15) ^
+                    (uint64_t) (hg_test_info->na_test_info.mpi_comm_rank + 1);
+    hg_time_t t0, t_end, next;
+    double offset = 0;
+    hg_return_t ret;
+
+    state.slots = (struct hg_perf_open_slot *) malloc(
+        info->handle_max * sizeof(*state.slots));
+    state.free_ids = (size_t *) malloc(info->handle_max * sizeof(size_t));
+    state.latencies = (double *) malloc(count * sizeof(double));
+    HG_TEST_CHECK_ERROR(state.slots == NULL || state.free_ids == NULL ||
+                            state.latencies == NULL,
+        error, ret, HG_NOMEM, "Could not allocate open-loop state");
+    for (i = 0; i < info->handle_max; i++) {
+        state.slots[i].state = &state;
+        state.slots[i].handle_id = i;
+        state.free_ids[state.free_count++] = info->handle_max - 1 - i;
+    }
+
+    if (hg_test_info->na_test_info.mpi_comm_size > 1)
+        NA_Test_barrier(&hg_test_info->na_test_info);
+
+    /* Arrivals are scheduled independently of completions, latencies are
+     * measured from the scheduled arrival so that requests delayed by a lack
+     * of free handles are not hidden (coordinated omission) */
+    hg_time_get_current(&t0);
+    next = t0;
+    while (state.complete_count < count) {
+        unsigned int actual_count = 0;
+        hg_time_t now;
+
+        hg_time_get_current(&now);
+        while (sent < count && state.free_count > 0 &&
+               !hg_time_less(now, next)) {
+            struct hg_perf_open_slot *slot =
+                &state.slots[state.free_ids[--state.free_count]];
+
+            slot->start = next;
+            ret = HG_Forward(info->handles[slot->handle_id], hg_perf_open_cb,
+                slot, &in_struct);
+            HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Forward() failed (%s)",
+                HG_Error_to_string(ret));
+            sent++;
+
+            offset += hg_perf_open_interval(
+                rate, hg_test_info->poisson, &seed);
+            next = hg_time_add(t0, hg_time_from_double(offset));
+        }
+
+        ret = HG_Progress(info->context, 0);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+        do {
+            ret = HG_Trigger(info->context, 0, 64, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count > 0);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+            ret, ret, "HG_Trigger() failed (%s)", HG_Error_to_string(ret));
+        ret = state.ret;
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+    }
+    hg_time_get_current(&t_end);
+
+    if (hg_test_info->na_test_info.mpi_comm_size > 1)
+        NA_Test_barrier(&hg_test_info->na_test_info);
+
+    qsort(state.latencies, count, sizeof(double), hg_perf_open_cmp);
+    result->offered = rate;
+    result->achieved =
+        (double) count / hg_time_to_double(hg_time_subtract(t_end, t0));
+    result->p50 = hg_perf_open_percentile(state.latencies, count, 50.0);
+    result->p99 = hg_perf_open_percentile(state.latencies, count, 99.0);
+    result->p999 = hg_perf_open_percentile(state.latencies, count, 99.9);
+    result->max = state.latencies[count - 1];
+
+    free(state.slots);
+    free(state.free_ids);
+    free(state.latencies);
+
+    return HG_SUCCESS;
+
+error:
+    /* Let RPCs in flight complete before releasing slots */
+    while (state.latencies != NULL && state.complete_count < sent) {
+        unsigned int actual_count = 0;
+
+        if (HG_Progress(info->context, 100) != HG_SUCCESS ||
+            HG_Trigger(info->context, 0, 64, &actual_count) != HG_SUCCESS)
+            break;
+    }
+    free(state.slots);
+    free(state.free_ids);
+    free(state.latencies);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_open_cb(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_perf_open_slot *slot =
+        (struct hg_perf_open_slot *) hg_cb_info->arg;
+    struct hg_perf_open_state *state = slot->state;
+    hg_time_t now;
+
+    hg_time_get_current(&now);
+    if (hg_cb_info->ret != HG_SUCCESS && state->ret == HG_SUCCESS)
+        state->ret = hg_cb_info->ret;
+    state->latencies[state->complete_count++] =
+        hg_time_to_double(hg_time_subtract(now, slot->start)) * 1e6;
+    state->free_ids[state->free_count++] = slot->handle_id;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static uint64_t
+hg_perf_rand(uint64_t *seed_p)
+{
+    /* xorshift64* */
+    *seed_p ^= *seed_p >> 12;
+    *seed_p ^= *seed_p << 25;
+    *seed_p ^= *seed_p >> 27;
+
+    return *seed_p * UINT64_C(0x2545F4914F6CDD1D);
+}
+
+/*---------------------------------------------------------------------------*/
+static double
+hg_perf_open_interval(double rate, bool poisson, uint64_t *seed_p)
+{
+    double u;
+
+    if (!poisson)
+        return 1.0 / rate;
+
+    /* Exponentially distributed inter-arrival times */
+    u = (double) (hg_perf_rand(seed_p) >> 11) / (double) (UINT64_C(1) << 53);
+
+    return -log(1.0 - u) / rate;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_perf_open_cmp(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+/*---------------------------------------------------------------------------*/
+static double
+hg_perf_open_percentile(
+    const double *latencies, size_t count, double percentile)
+{
+    size_t rank = (size_t) ceil(percentile / 100.0 * (double) count);
+
+    return latencies[(rank > 0) ? MIN(rank, count) - 1 : 0];
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_header_open(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info, const char *benchmark)
+{
+    printf("# %s v%s (open-loop)\n", benchmark, VERSION_NAME);
+    printf("# %d RPC(s) per step from size %zu to %zu byte(s) with up to %zu "
+           "handle(s) in-flight\n",
+        hg_test_info->na_test_info.loop * (int) info->handle_max,
+        info->buf_size_min, info->buf_size_max, info->handle_max);
+    printf("# %s arrivals from %.0f RPC/s, doubled until achieved rate is "
+           "below %.0f%% of offered rate\n",
+        hg_test_info->poisson ? "Poisson" : "Constant", hg_test_info->rate,
+        HG_PERF_OPEN_SATURATION * 100.0);
+    printf("# Latencies are measured from scheduled arrival times\n");
+    printf("%-*s%*s%*s%*s%*s%*s%*s\n", 10, "# Size", NWIDTH_OPEN,
+        "Offered (RPC/s)", NWIDTH_OPEN, "Rate (RPC/s)", NWIDTH_OPEN,
+        "p50 (us)", NWIDTH_OPEN, "p99 (us)", NWIDTH_OPEN, "p99.9 (us)",
+        NWIDTH_OPEN, "Max (us)");
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_open(size_t buf_size, const struct hg_perf_open_result *result)
+{
+    printf("%-*zu%*.0f%*.0f%*.*f%*.*f%*.*f%*.*f\n", 10, buf_size, NWIDTH_OPEN,
+        result->offered, NWIDTH_OPEN, result->achieved, NWIDTH_OPEN, NDIGITS,
+        result->p50, NWIDTH_OPEN, NDIGITS, result->p99, NWIDTH_OPEN, NDIGITS,
+        result->p999, NWIDTH_OPEN, NDIGITS, result->max);
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_run_probe(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, size_t buf_size,
+    struct hg_perf_probe_result *result)
+{
+    struct iovec in_struct = {.iov_base = info->rpc_buf, .iov_len = buf_size};
+    size_t count = (size_t) hg_test_info->na_test_info.loop,
+           skip = HG_PERF_LAT_SKIP_SMALL, i;
+    double *latencies, total = 0;
+    hg_return_t ret;
+
+    latencies = (double *) malloc(count * sizeof(double));
+    HG_TEST_CHECK_ERROR(latencies == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of latencies");
+
+    /* One RPC in flight at a time so that each RPC is timed individually */
+    for (i = 0; i < skip + count; i++) {
+        struct hg_perf_request args = {
+            .expected_count = 1, .complete_count = 0, .request = info->request};
+        hg_time_t t1, t2;
+
+        hg_request_reset(info->request);
+
+        hg_time_get_current(&t1);
+        ret = HG_Forward(info->handles[i % info->handle_max],
+            hg_perf_request_complete, &args, &in_struct);
+        HG_TEST_CHECK_HG_ERROR(error_free, ret, "HG_Forward() failed (%s)",
+            HG_Error_to_string(ret));
+
+        hg_request_wait(info->request, HG_MAX_IDLE_TIME, NULL);
+        hg_time_get_current(&t2);
+
+        if (i >= skip) {
+            latencies[i - skip] =
+                hg_time_to_double(hg_time_subtract(t2, t1)) * 1e6;
+            total += latencies[i - skip];
+        }
+    }
+
+    qsort(latencies, count, sizeof(double), hg_perf_open_cmp);
+    result->rate = (double) count * 1e6 / total;
+    result->p50 = hg_perf_open_percentile(latencies, count, 50.0);
+    result->p99 = hg_perf_open_percentile(latencies, count, 99.0);
+    result->p999 = hg_perf_open_percentile(latencies, count, 99.9);
+    result->max = latencies[count - 1];
+
+    free(latencies);
+
+    return HG_SUCCESS;
+
+error_free:
+    free(latencies);
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_load_start(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, enum hg_perf_rpc_id rpc_id,
+    size_t buf_size, struct hg_perf_load *load)
+{
+    hg_return_t ret;
+    int rc;
+
+    load->hg_test_info = hg_test_info;
+    load->info = info;
+    load->rpc_id = rpc_id;
+    load->buf_size = buf_size;
+    load->round_count = 0;
+    load->ret = HG_SUCCESS;
+    hg_atomic_init32(&load->started, 0);
+    hg_atomic_init32(&load->stop, 0);
+
+    rc = hg_thread_create(&load->thread, hg_perf_load_thread, load);
+    HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_create() failed");
+
+    /* Measurements only start once transfers are in flight */
+    while (hg_atomic_get32(&load->started) == 0)
+        hg_thread_yield();
+
+    /* Load thread exits on error */
+    if (load->ret != HG_SUCCESS) {
+        hg_thread_join(load->thread);
+        return load->ret;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_load_stop(struct hg_perf_load *load, double *bw)
+{
+    size_t transfer_count =
+        load->round_count * load->info->handle_max * load->info->bulk_count;
+    double t;
+
+    hg_atomic_set32(&load->stop, 1);
+    hg_thread_join(load->thread);
+
+    t = hg_time_to_double(load->t);
+    *bw = (t > 0) ? (double) (load->buf_size * transfer_count) / t : 0;
+    if (load->hg_test_info->na_test_info.mbps)
+        *bw /= 1e6; /* MB/s, matches OSU benchmarks */
+    else
+        *bw /= (1024 * 1024); /* MiB/s */
+
+    return load->ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_perf_load_thread(void *arg)
+{
+    struct hg_perf_load *load = (struct hg_perf_load *) arg;
+    struct hg_perf_class_info *info = load->info;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+    hg_time_t t1, t2;
+    hg_return_t ret;
+
+    /* Keep all handles busy until stopped */
+    hg_time_get_current(&t1);
+    do {
+        struct hg_perf_request args = {
+            .expected_count = (int32_t) info->handle_max,
+            .complete_count = 0,
+            .request = info->request};
+        size_t j;
+
+        hg_request_reset(info->request);
+
+        for (j = 0; j < info->handle_max; j++) {
+            struct hg_perf_bulk_info in_struct = {
+                .comm_rank = (uint32_t) load->hg_test_info->na_test_info
+                                 .mpi_comm_rank,
+                .handle_id = (uint32_t) (j / info->target_addr_max),
+                .size = (uint32_t) load->buf_size};
+
+            ret = HG_Forward(
+                info->handles[j], hg_perf_request_complete, &args, &in_struct);
+            HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Forward() failed (%s)",
+                HG_Error_to_string(ret));
+        }
+
+        hg_request_wait(info->request, HG_MAX_IDLE_TIME, NULL);
+        load->round_count++;
+        hg_atomic_set32(&load->started, 1);
+    } while (hg_atomic_get32(&load->stop) == 0);
+    hg_time_get_current(&t2);
+
+    load->t = hg_time_subtract(t2, t1);
+
+    return tret;
+
+error:
+    load->ret = ret;
+    load->t = hg_time_from_double(0);
+    hg_atomic_set32(&load->started, 1);
+
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_run_mixed(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, struct hg_perf_class_info *load_info,
+    enum hg_perf_rpc_id rpc_id, size_t buf_size)
+{
+    struct hg_perf_probe_result idle, loaded;
+    struct hg_perf_load load;
+    double bw;
+    hg_return_t ret;
+
+    /* Same probes without then with background transfers of max size */
+    ret = hg_perf_run_probe(hg_test_info, info, buf_size, &idle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_run_probe() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_perf_load_start(
+        hg_test_info, load_info, rpc_id, load_info->buf_size_max, &load);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_load_start() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_perf_run_probe(hg_test_info, info, buf_size, &loaded);
+    HG_TEST_CHECK_HG_ERROR(error_stop, ret, "hg_perf_run_probe() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_perf_load_stop(&load, &bw);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_perf_load_stop() failed (%s)",
+        HG_Error_to_string(ret));
+
+    if (hg_test_info->na_test_info.mpi_comm_rank == 0)
+        hg_perf_print_mixed(hg_test_info, buf_size, &idle, &loaded, bw);
+
+    return HG_SUCCESS;
+
+error_stop:
+    (void) hg_perf_load_stop(&load, &bw);
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_header_mixed(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info,
+    const struct hg_perf_class_info *load_info, const char *benchmark)
+{
+    const struct na_test_report_metric metrics[] = {{"idle_p50_us", false},
+        {"idle_p99_us", false}, {"idle_p999_us", false},
+        {"load_p50_us", false}, {"load_p99_us", false},
+        {"load_p999_us", false},
+        {hg_test_info->na_test_info.mbps ? "load_bw_mb_s" : "load_bw_mib_s",
+            true}};
+
+    if (!na_test_report_begin(&hg_test_info->na_test_info, benchmark,
+            VERSION_NAME, metrics, sizeof(metrics) / sizeof(metrics[0]),
+            false)) {
+        hg_perf_report_meta(hg_test_info, info);
+        na_test_report_meta(&hg_test_info->na_test_info, "load_size", "%zu",
+            load_info->buf_size_max);
+        na_test_report_meta(&hg_test_info->na_test_info, "load_handles",
+            "%zu", load_info->handle_max);
+        na_test_report_meta(&hg_test_info->na_test_info, "bulk_count", "%zu",
+            load_info->bulk_count);
+        na_test_report_meta(&hg_test_info->na_test_info, "priority", "%s",
+            hg_test_info->priority ? "high" : "normal");
+        return;
+    }
+
+    printf("# %s v%s\n", benchmark, VERSION_NAME);
+    printf("# %d RPC probe(s) one at a time from size %zu to %zu byte(s), "
+           "%s priority\n",
+        hg_test_info->na_test_info.loop, info->buf_size_min,
+        MIN(info->buf_size_max, HG_PERF_LARGE_SIZE),
+        hg_test_info->priority ? "high" : "normal");
+    printf("# Background load: %zu handle(s) in-flight from a separate class, "
+           "%zu bulk transfer(s) of %zu byte(s) per handle\n",
+        load_info->handle_max, load_info->bulk_count, load_info->buf_size_max);
+    printf("# Latencies (us) are measured per RPC without then with "
+           "background load\n");
+    if (info->verify)
+        printf("# WARNING verifying data, output will be slower\n");
+    printf("%-*s%*s%*s%*s%*s%*s%*s%*s\n", 10, "# Size", NWIDTH_MIXED,
+        "Idle p50", NWIDTH_MIXED, "Idle p99", NWIDTH_MIXED, "Idle p99.9",
+        NWIDTH_MIXED, "Load p50", NWIDTH_MIXED, "Load p99", NWIDTH_MIXED,
+        "Load p99.9", NWIDTH_MIXED,
+        hg_test_info->na_test_info.mbps ? "Load MB/s" : "Load MiB/s");
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_perf_print_mixed(const struct hg_test_info *hg_test_info, size_t buf_size,
+    const struct hg_perf_probe_result *idle,
+    const struct hg_perf_probe_result *loaded, double bw)
+{
+    double values[7] = {idle->p50, idle->p99, idle->p999, loaded->p50,
+        loaded->p99, loaded->p999, bw};
+
+    if (!na_test_report_row(&hg_test_info->na_test_info, buf_size, 0, values))
+        return;
+
+    printf("%-*zu%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f\n", 10, buf_size,
+        NWIDTH_MIXED, NDIGITS, values[0], NWIDTH_MIXED, NDIGITS, values[1],
+        NWIDTH_MIXED, NDIGITS, values[2], NWIDTH_MIXED, NDIGITS, values[3],
+        NWIDTH_MIXED, NDIGITS, values[4], NWIDTH_MIXED, NDIGITS, values[5],
+        NWIDTH_MIXED, NDIGITS, values[6]);
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_perf_print_header_scale(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info, const char *benchmark)
+{
+    printf("# %s v%s\n", benchmark, VERSION_NAME);
+    printf("# %d client(s) against %zu server(s), loop %d time(s) with %zu "
+           "handle(s) in-flight per client\n",
+        hg_test_info->na_test_info.mpi_comm_size, info->target_addr_max,
+        hg_test_info->na_test_info.loop, info->handle_max);
+    printf("# Fairness is Jain's index of per-client rates (1 is fair), "
+           "server CPU is process time per RPC\n");
+    printf("%-*s%-*s%*s%*s%*s%*s%*s\n", 13, "# Mode", 10, "Size",
+        NWIDTH_SCALE, "Rate (RPC/s)", NWIDTH_SCALE, "Min (RPC/s)",
+        NWIDTH_SCALE, "Max (RPC/s)", NWIDTH_SCALE, "Fairness", NWIDTH_SCALE,
+        "CPU/RPC (us)");
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_request_complete(const struct hg_cb_info *hg_cb_info)
+{
+    struct hg_perf_request *info = (struct hg_perf_request *) hg_cb_info->arg;
+
+    if ((++info->complete_count) == info->expected_count)
+        hg_request_complete(info->request);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_proc_iovec(hg_proc_t proc, void *arg)
+{
+    struct iovec *iov = (struct iovec *) arg;
+    uint32_t len = (uint32_t) iov->iov_len;
+    hg_return_t ret;
+
+    if (hg_proc_get_op(proc) == HG_FREE)
+        return HG_SUCCESS;
+
+    ret = hg_proc_uint32_t(proc, &len);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_uint32_t() failed (%s)", HG_Error_to_string(ret));
+    iov->iov_len = (size_t) len;
+
+    if (len == 0)
+        return HG_SUCCESS;
+
+    ret = hg_proc_raw(proc, iov->iov_base, iov->iov_len);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_raw() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_proc_bulk_init_info(hg_proc_t proc, void *arg)
+{
+    struct hg_perf_bulk_init_info *info = (struct hg_perf_bulk_init_info *) arg;
+    hg_return_t ret;
 
     ret = hg_proc_hg_bulk_t(proc, &info->bulk);
     HG_TEST_CHECK_HG_ERROR(
@@ -815,6 +2090,18 @@ hg_perf_proc_bulk_init_info(hg_proc_t proc, void *arg)
     HG_TEST_CHECK_HG_ERROR(
         error, ret, "hg_proc_uint32_t() failed (%s)", HG_Error_to_string(ret));
 
+    ret = hg_proc_uint32_t(proc, &info->segment_max);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_uint32_t() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_proc_uint32_t(proc, &info->segment_count);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_uint32_t() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_proc_uint32_t(proc, &info->segment_flags);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_uint32_t() failed (%s)", HG_Error_to_string(ret));
+
     return HG_SUCCESS;
 
 error:
@@ -855,6 +2142,10 @@ hg_perf_rpc_rate_init_cb(hg_handle_t handle)
     struct hg_perf_class_info *info = HG_Context_get_data(hg_info->context);
     hg_return_t ret;
 
+    /* Buffers are shared by all clients */
+    if (info->rpc_buf != NULL)
+        goto respond;
+
     /* Prepare buf */
     info->rpc_buf = hg_mem_aligned_alloc(page_size, info->buf_size_max);
     HG_TEST_CHECK_ERROR(info->rpc_buf == NULL, error, ret, HG_NOMEM,
@@ -868,6 +2159,7 @@ hg_perf_rpc_rate_init_cb(hg_handle_t handle)
             info->buf_size_max);
     }
 
+respond:
     /* Send response back */
     ret = HG_Respond(handle, NULL, NULL, NULL);
     HG_TEST_CHECK_HG_ERROR(
@@ -917,6 +2209,8 @@ hg_perf_rpc_rate_cb(hg_handle_t handle)
             "hg_perf_verify_data() failed (%s)", HG_Error_to_string(ret));
     }
 
+    hg_atomic_incr64(&info->rpc_count);
+
     /* Send response back */
     if (info->bidir) {
         ret = HG_Respond(handle, NULL, NULL, &iov);
@@ -946,6 +2240,7 @@ hg_perf_bulk_init_cb(hg_handle_t handle)
     const struct hg_info *hg_info = HG_Get_info(handle);
     struct hg_perf_class_info *info = HG_Context_get_data(hg_info->context);
     struct hg_perf_bulk_init_info bulk_info;
+    hg_uint8_t bulk_flags;
     size_t bulk_index;
     hg_return_t ret;
 
@@ -953,10 +2248,16 @@ hg_perf_bulk_init_cb(hg_handle_t handle)
     HG_TEST_CHECK_HG_ERROR(
         error, ret, "HG_Get_input() failed (%s)", HG_Error_to_string(ret));
 
+    bulk_flags = (bulk_info.bulk_op == HG_BULK_PULL) ? HG_BULK_WRITE_ONLY
+                                                      : HG_BULK_READ_ONLY;
+    info->segment_count = bulk_info.segment_count;
+
     if (info->bulk_bufs == NULL) {
-        hg_uint8_t bulk_flags = (bulk_info.bulk_op == HG_BULK_PULL)
-                                    ? HG_BULK_WRITE_ONLY
-                                    : HG_BULK_READ_ONLY;
+        info->segment_max = bulk_info.segment_max;
+        info->segment_random =
+            (bulk_info.segment_flags & HG_PERF_SEG_RANDOM) != 0;
+        info->segment_mismatch =
+            (bulk_info.segment_flags & HG_PERF_SEG_MISMATCH) != 0;
         info->handle_per_rank =
             (bulk_info.handle_max / bulk_info.target_addr_max);
 
@@ -979,6 +2280,15 @@ hg_perf_bulk_init_cb(hg_handle_t handle)
     bulk_index = bulk_info.handle_id % info->handle_per_rank +
                  info->handle_per_rank * bulk_info.comm_rank;
 
+    /* Segment count changes between runs of a segment sweep */
+    if (info->segment_max > 1) {
+        ret = hg_perf_bulk_create(info, bulk_index, bulk_flags,
+            info->segment_mismatch, bulk_info.bulk_op == HG_BULK_PUSH);
+        HG_TEST_CHECK_HG_ERROR(error_free, ret,
+            "hg_perf_bulk_create() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    (void) HG_Bulk_free(info->remote_bulk_handles[bulk_index]);
     info->remote_bulk_handles[bulk_index] = bulk_info.bulk;
     HG_Bulk_ref_incr(bulk_info.bulk);
 
@@ -1021,7 +2331,7 @@ hg_perf_bulk_common(hg_handle_t handle, hg_bulk_op_t op)
     const struct hg_info *hg_info = HG_Get_info(handle);
     struct hg_perf_class_info *info = HG_Context_get_data(hg_info->context);
     struct hg_perf_request *request =
-        (struct hg_perf_request *) HG_Get_data(handle);
+        (struct hg_perf_request *) HG_Get_private_area(handle);
     struct hg_perf_bulk_info bulk_info;
     hg_return_t ret;
     size_t i, bulk_index;
@@ -1034,15 +2344,15 @@ hg_perf_bulk_common(hg_handle_t handle, hg_bulk_op_t op)
     bulk_index = bulk_info.handle_id % info->handle_per_rank +
                  info->handle_per_rank * bulk_info.comm_rank;
 
-    /* Initialize request */
-    *request = (struct hg_perf_request){.complete_count = 0,
-        .expected_count = (int32_t) info->bulk_count,
-        .request = NULL};
+    /* Initialize request, work entry may still be in use if offloaded */
+    request->complete_count = 0;
+    request->expected_count = (int32_t) info->bulk_count;
+    request->request = NULL;
 
-    /* Post bulk push */
+    /* Post bulk push, completes on the context that received the RPC */
     for (i = 0; i < info->bulk_count; i++) {
-        ret = HG_Bulk_transfer(info->context, hg_perf_bulk_transfer_cb, handle,
-            op, hg_info->addr, info->remote_bulk_handles[bulk_index],
+        ret = HG_Bulk_transfer(hg_info->context, hg_perf_bulk_transfer_cb,
+            handle, op, hg_info->addr, info->remote_bulk_handles[bulk_index],
             i * info->buf_size_max, info->local_bulk_handles[bulk_index],
             i * info->buf_size_max, bulk_info.size, HG_OP_ID_IGNORE);
         HG_TEST_CHECK_HG_ERROR(error_free, ret,
@@ -1069,7 +2379,7 @@ hg_perf_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info)
     const struct hg_info *hg_info = HG_Get_info(handle);
     struct hg_perf_class_info *info = HG_Context_get_data(hg_info->context);
     struct hg_perf_request *request =
-        (struct hg_perf_request *) HG_Get_data(handle);
+        (struct hg_perf_request *) HG_Get_private_area(handle);
 
     HG_TEST_CHECK_HG_ERROR(done, hg_cb_info->ret, "Bulk transfer failed (%s)",
         HG_Error_to_string(hg_cb_info->ret));
@@ -1077,30 +2387,10 @@ hg_perf_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info)
 done:
     if ((++request->complete_count) == request->expected_count) {
         if (hg_cb_info->info.bulk.op == HG_BULK_PULL && info->verify) {
-            void *buf;
-            hg_size_t buf_size;
-            hg_uint32_t actual_count;
-            hg_return_t ret;
-            size_t i;
-
-            ret = HG_Bulk_access(hg_cb_info->info.bulk.local_handle, 0,
-                info->buf_size_max * info->bulk_count, HG_BULK_READWRITE, 1,
-                &buf, &buf_size, &actual_count);
-            HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_access() failed (%s)",
-                HG_Error_to_string(ret));
-            HG_TEST_CHECK_ERROR(actual_count != 1, error, ret, HG_FAULT,
-                "actual_count=%d", (int) actual_count);
-            HG_TEST_CHECK_ERROR(
-                buf_size != info->buf_size_max * info->bulk_count, error, ret,
-                HG_FAULT, "buf_size=%zu", (size_t) buf_size);
-
-            for (i = 0; i < info->bulk_count; i++) {
-                char *buf_p = (char *) buf + info->buf_size_max * i;
-                ret = hg_perf_verify_data(buf_p, hg_cb_info->info.bulk.size);
-                HG_TEST_CHECK_HG_ERROR(error, ret,
-                    "hg_perf_verify_data() failed (%s, %p)",
-                    HG_Error_to_string(ret), buf);
-            }
+            hg_return_t ret = hg_perf_verify_bulk(info,
+                hg_cb_info->info.bulk.local_handle, hg_cb_info->info.bulk.size);
+            HG_TEST_CHECK_HG_ERROR(error, ret,
+                "hg_perf_verify_bulk() failed (%s)", HG_Error_to_string(ret));
         }
 
         HG_Respond(handle, NULL, NULL, NULL);
@@ -1142,6 +2432,142 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_proc_server_stats(hg_proc_t proc, void *arg)
+{
+    struct hg_perf_server_stats *stats = (struct hg_perf_server_stats *) arg;
+    hg_return_t ret;
+
+    ret = hg_proc_uint64_t(proc, &stats->cpu_time);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_uint64_t() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_proc_uint64_t(proc, &stats->rpc_count);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "hg_proc_uint64_t() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_stats_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    struct hg_perf_class_info *info = HG_Context_get_data(hg_info->context);
+    struct hg_perf_server_stats stats = {
+        .cpu_time = 0,
+        .rpc_count = (uint64_t) hg_atomic_get64(&info->rpc_count)};
+    hg_return_t ret;
+#ifndef _WIN32
+    struct rusage usage;
+
+    /* CPU time is process-wide, user and system time are both accounted */
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        stats.cpu_time = (uint64_t) (usage.ru_utime.tv_sec +
+                                     usage.ru_stime.tv_sec) *
+                             UINT64_C(1000000000) +
+                         (uint64_t) (usage.ru_utime.tv_usec +
+                                     usage.ru_stime.tv_usec) *
+                             UINT64_C(1000);
+#endif
+
+    /* Send response back */
+    ret = HG_Respond(handle, NULL, NULL, &stats);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+    (void) HG_Destroy(handle);
+
+    return HG_SUCCESS;
+
+error:
+    (void) HG_Destroy(handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_perf_offload_thread(void *arg)
+{
+    hg_handle_t handle = (hg_handle_t) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+
+    (void) hg_perf_offload_cbs_g[HG_Get_info(handle)->id](handle);
+
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_perf_offload_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    struct hg_perf_class_info *info = HG_Context_get_data(hg_info->context);
+    struct hg_perf_request *request =
+        (struct hg_perf_request *) HG_Get_private_area(handle);
+
+    request->work.func = hg_perf_offload_thread;
+    request->work.args = handle;
+    hg_thread_pool_post(info->thread_pool, &request->work);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_perf_get_server_stats(
+    struct hg_perf_class_info *info, struct hg_perf_server_stats *stats)
+{
+    hg_return_t ret;
+    size_t i;
+
+    *stats = (struct hg_perf_server_stats){.cpu_time = 0, .rpc_count = 0};
+
+    for (i = 0; i < info->target_addr_max; i++) {
+        struct hg_perf_request args = {
+            .expected_count = 1, .complete_count = 0, .request = info->request};
+        struct hg_perf_server_stats target_stats;
+        unsigned int completed = 0;
+
+        ret = HG_Reset(
+            info->handles[0], info->target_addrs[i], (hg_id_t) HG_PERF_STATS);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Reset() failed (%s)", HG_Error_to_string(ret));
+
+        hg_request_reset(info->request);
+
+        /* Forward call to target addr */
+        ret =
+            HG_Forward(info->handles[0], hg_perf_request_complete, &args, NULL);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+        hg_request_wait(info->request, HG_PERF_TIMEOUT_MAX, &completed);
+        HG_TEST_CHECK_ERROR(!completed, error, ret, HG_TIMEOUT,
+            "No stats response from server");
+
+        ret = HG_Get_output(info->handles[0], &target_stats);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+
+        stats->cpu_time += target_stats.cpu_time;
+        stats->rpc_count += target_stats.rpc_count;
+
+        (void) HG_Free_output(info->handles[0], &target_stats);
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_perf_send_done(struct hg_perf_class_info *info)
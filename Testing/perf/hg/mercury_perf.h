@@ -9,10 +9,12 @@
 #define MERCURY_PERF_H
 
 #include "mercury_test.h"
+#include "na_test_report.h"
 
 #include "mercury_bulk.h"
 #include "mercury_param.h"
 #include "mercury_request.h" /* For convenience */
+#include "mercury_thread_pool.h"
 #include "mercury_time.h"
 
 #include <stdlib.h>
@@ -28,7 +30,8 @@ enum hg_perf_rpc_id {
     HG_PERF_BW_INIT,
     HG_PERF_BW_READ,
     HG_PERF_BW_WRITE,
-    HG_PERF_DONE
+    HG_PERF_DONE,
+    HG_PERF_STATS
 };
 
 struct hg_perf_info {
@@ -40,6 +43,8 @@ struct hg_perf_info {
 struct hg_perf_class_info {
     hg_class_t *hg_class;              /* HG class */
     hg_context_t *context;             /* HG context */
+    hg_context_t **contexts;           /* Additional contexts (server) */
+    hg_thread_pool_t *thread_pool;     /* Handler offload pool (server) */
     hg_request_class_t *request_class; /* Request class */
     hg_addr_t *target_addrs;           /* Target addresses */
     hg_handle_t *handles;              /* Handles */
@@ -52,19 +57,27 @@ struct hg_perf_class_info {
     size_t handle_per_rank;
     size_t buf_size_min;
     size_t buf_size_max;
+    size_t context_max;   /* Number of contexts */
+    size_t segment_max;   /* Max bulk segments per transfer */
+    size_t segment_count; /* Current bulk segments per transfer */
     hg_bulk_t *local_bulk_handles;
     hg_bulk_t *remote_bulk_handles;
     hg_request_t *request; /* Request */
+    hg_atomic_int64_t rpc_count; /* Number of rate RPCs processed */
     int class_id;
     bool done;
     bool verify;
     bool bidir;
+    bool device;           /* Use device memory for bulk buffers */
+    bool segment_random;   /* Random segment sizes */
+    bool segment_mismatch; /* Shift server segments against client ones */
 };
 
 struct hg_perf_request {
-    int32_t expected_count; /* Expected count */
-    int32_t complete_count; /* Completed count */
-    hg_request_t *request;  /* Request */
+    struct hg_thread_work work; /* Handler offload */
+    int32_t expected_count;     /* Expected count */
+    int32_t complete_count;     /* Completed count */
+    hg_request_t *request;      /* Request */
 };
 
 struct hg_perf_bulk_init_info {
@@ -77,6 +90,65 @@ struct hg_perf_bulk_init_info {
     uint32_t comm_rank;
     uint32_t comm_size;
     uint32_t target_addr_max;
+    uint32_t segment_max;
+    uint32_t segment_count;
+    uint32_t segment_flags;
+};
+
+struct hg_perf_open_result {
+    double offered;  /* Offered rate (RPC/s) */
+    double achieved; /* Achieved rate (RPC/s) */
+    double p50;      /* Latency percentiles (us) */
+    double p99;
+    double p999;
+    double max;
+};
+
+/* Closed-loop latency probe results */
+struct hg_perf_probe_result {
+    double rate; /* Achieved rate (RPC/s) */
+    double p50;  /* Latency percentiles (us) */
+    double p99;
+    double p999;
+    double max;
+};
+
+/* Results of replayed RPCs of one type */
+struct hg_perf_replay_result {
+    size_t count;       /* Number of RPCs */
+    double captured;    /* Captured rate (RPC/s) */
+    double achieved;    /* Replayed rate (RPC/s) */
+    double handler_p50; /* Captured RPC callback time p50 (us) */
+    double p50;         /* Latency percentiles (us) */
+    double p99;
+    double p999;
+    double max;
+};
+
+/* Background bulk load generated by a separate class */
+struct hg_perf_load {
+    const struct hg_test_info *hg_test_info; /* Test info */
+    struct hg_perf_class_info *info;         /* Class generating load */
+    hg_thread_t thread;                      /* Load thread */
+    hg_atomic_int32_t started;               /* First round completed */
+    hg_atomic_int32_t stop;                  /* Stop requested */
+    enum hg_perf_rpc_id rpc_id;              /* Bulk RPC ID */
+    size_t buf_size;                         /* Transfer size */
+    size_t round_count;                      /* Completed rounds */
+    hg_time_t t;                             /* Load duration */
+    hg_return_t ret;                         /* First error */
+};
+
+struct hg_perf_server_stats {
+    uint64_t cpu_time;  /* Server process CPU time (ns) */
+    uint64_t rpc_count; /* Number of rate RPCs processed */
+};
+
+struct hg_perf_reg_times {
+    double first;     /* Cold create to free time (us) */
+    double create;    /* Average times (us) */
+    double serialize;
+    double free;
 };
 
 struct hg_perf_bulk_info {
@@ -93,6 +165,15 @@ struct hg_perf_bulk_info {
 #define HG_PERF_LAT_SKIP_LARGE 10
 #define HG_PERF_LARGE_SIZE     8192
 
+/* Segment layout flags sent with bulk init info */
+#define HG_PERF_SEG_RANDOM   (1 << 0)
+#define HG_PERF_SEG_MISMATCH (1 << 1)
+
+/* Open-loop rate sweep stops once the achieved rate falls below that ratio
+ * of the offered rate, or after a max number of steps */
+#define HG_PERF_OPEN_SATURATION 0.9
+#define HG_PERF_OPEN_STEP_MAX   20
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -118,9 +199,18 @@ hg_return_t
 hg_perf_bulk_buf_init(const struct hg_test_info *hg_test_info,
     struct hg_perf_class_info *info, hg_bulk_op_t bulk_op);
 
+hg_return_t
+hg_perf_bulk_segments_set(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, hg_bulk_op_t bulk_op,
+    size_t segment_count);
+
 hg_return_t
 hg_perf_verify_data(const void *buf, size_t buf_size);
 
+hg_return_t
+hg_perf_verify_bulk(
+    const struct hg_perf_class_info *info, hg_bulk_t bulk, size_t size);
+
 void
 hg_perf_print_header_lat(const struct hg_test_info *hg_test_info,
     const struct hg_perf_class_info *info, const char *benchmark);
@@ -137,12 +227,92 @@ void
 hg_perf_print_bw(const struct hg_test_info *hg_test_info,
     const struct hg_perf_class_info *info, size_t buf_size, hg_time_t t);
 
+void
+hg_perf_print_header_reg(const struct hg_test_info *hg_test_info,
+    const char *benchmark, size_t size_min, size_t size_max,
+    const char *mem_name, size_t page_size, size_t segment_count);
+
+void
+hg_perf_print_reg(size_t buf_size, const struct hg_perf_reg_times *times);
+
+void
+hg_perf_print_header_startup(
+    const struct hg_test_info *hg_test_info, const char *benchmark);
+
+void
+hg_perf_print_startup(
+    const char *phase, size_t op_count, const double *times, size_t count);
+
+void
+hg_perf_print_header_replay(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info, const char *benchmark, size_t count,
+    double duration, size_t clamp_count);
+
+void
+hg_perf_print_replay(
+    const char *type, const struct hg_perf_replay_result *result);
+
+void
+hg_perf_print_header_tune(const struct hg_test_info *hg_test_info,
+    const char *benchmark, size_t size_min, size_t size_max, size_t rpc_count,
+    double gain_min);
+
+void
+hg_perf_print_tune(const char *param, const char *value,
+    const struct hg_perf_probe_result *result, double gain);
+
+void
+hg_perf_print_progress(const struct hg_perf_class_info *info);
+
+hg_return_t
+hg_perf_run_open(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, size_t buf_size, double rate,
+    struct hg_perf_open_result *result);
+
+void
+hg_perf_print_header_open(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info, const char *benchmark);
+
+void
+hg_perf_print_open(size_t buf_size, const struct hg_perf_open_result *result);
+
+hg_return_t
+hg_perf_run_probe(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, size_t buf_size,
+    struct hg_perf_probe_result *result);
+
+hg_return_t
+hg_perf_load_start(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, enum hg_perf_rpc_id rpc_id,
+    size_t buf_size, struct hg_perf_load *load);
+
+hg_return_t
+hg_perf_load_stop(struct hg_perf_load *load, double *bw);
+
+hg_return_t
+hg_perf_run_mixed(const struct hg_test_info *hg_test_info,
+    struct hg_perf_class_info *info, struct hg_perf_class_info *load_info,
+    enum hg_perf_rpc_id rpc_id, size_t buf_size);
+
+void
+hg_perf_print_header_mixed(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info,
+    const struct hg_perf_class_info *load_info, const char *benchmark);
+
+void
+hg_perf_print_header_scale(const struct hg_test_info *hg_test_info,
+    const struct hg_perf_class_info *info, const char *benchmark);
+
 hg_return_t
 hg_perf_request_complete(const struct hg_cb_info *hg_cb_info);
 
 hg_return_t
 hg_perf_send_done(struct hg_perf_class_info *info);
 
+hg_return_t
+hg_perf_get_server_stats(
+    struct hg_perf_class_info *info, struct hg_perf_server_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
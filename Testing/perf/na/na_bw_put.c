@@ -133,6 +133,7 @@ main(int argc, char *argv[])
     struct na_perf_info info;
     size_t size, i;
     na_return_t na_ret;
+    bool regressed;
 
     /* Initialize the interface */
     na_ret = na_perf_init(argc, argv, false, &info);
@@ -166,9 +167,12 @@ main(int argc, char *argv[])
     if (info.na_test_info.mpi_comm_rank == 0)
         na_perf_send_finalize(&info);
 
+    /* Regressions against a baseline fail the run */
+    regressed = na_test_report_end(&info.na_test_info);
+
     na_perf_cleanup(&info);
 
-    return EXIT_SUCCESS;
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
 
 error:
     na_perf_cleanup(&info);
@@ -28,6 +28,9 @@
 #define NDIGITS 2
 #define NWIDTH  27
 
+/* Column width of registration results */
+#define NWIDTH_REG 16
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -384,6 +387,16 @@ void
 na_perf_print_header_lat(
     const struct na_perf_info *info, const char *benchmark, size_t min_size)
 {
+    static const struct na_test_report_metric metrics[] = {{"lat_us", false}};
+
+    if (!na_test_report_begin(&info->na_test_info, benchmark, VERSION_NAME,
+            metrics, 1, false)) {
+        na_test_report_meta(&info->na_test_info, "size_min", "%zu", min_size);
+        na_test_report_meta(&info->na_test_info, "size_max", "%zu",
+            info->msg_unexp_size_max);
+        return;
+    }
+
     fprintf(stdout, "# %s v%s\n", benchmark, VERSION_NAME);
     fprintf(stdout, "# Loop %d times from size %zu to %zu byte(s)\n",
         info->na_test_info.loop, min_size, info->msg_unexp_size_max);
@@ -403,17 +416,39 @@ na_perf_print_lat(const struct na_perf_info *info, size_t buf_size, hg_time_t t)
 
     msg_lat = hg_time_to_double(t) * 1e6 / (double) (loop * 2 * mpi_comm_size);
 
-    printf("%-*zu%*.*f\n", 10, buf_size, NWIDTH, NDIGITS, msg_lat);
+    if (na_test_report_row(&info->na_test_info, buf_size, 0, &msg_lat))
+        printf("%-*zu%*.*f\n", 10, buf_size, NWIDTH, NDIGITS, msg_lat);
 }
 
 /*---------------------------------------------------------------------------*/
 void
 na_perf_print_header_bw(const struct na_perf_info *info, const char *benchmark)
 {
+    const struct na_test_report_metric metrics[] = {
+        {info->na_test_info.mbps ? "bw_mb_s" : "bw_mib_s", true},
+        {"time_us", false}};
+    size_t vec_threshold, nt_threshold;
+
+    hg_mem_copy_get_thresholds(&vec_threshold, &nt_threshold);
+    if (!na_test_report_begin(&info->na_test_info, benchmark, VERSION_NAME,
+            metrics, 2, false)) {
+        na_test_report_meta(
+            &info->na_test_info, "size_min", "%zu", info->rma_size_min);
+        na_test_report_meta(
+            &info->na_test_info, "size_max", "%zu", info->rma_size_max);
+        na_test_report_meta(
+            &info->na_test_info, "rma_count", "%zu", info->rma_count);
+        na_test_report_meta(&info->na_test_info, "copy_kernel", "%s",
+            hg_mem_copy_get_kernel());
+        return;
+    }
+
     printf("# %s v%s\n", benchmark, VERSION_NAME);
     printf("# Loop %d times from size %zu to %zu byte(s), RMA count (%zu)\n",
         info->na_test_info.loop, info->rma_size_min, info->rma_size_max,
         info->rma_count);
+    printf("# Copy kernel: %s (SIMD >= %zu, non-temporal >= %zu byte(s))\n",
+        hg_mem_copy_get_kernel(), vec_threshold, nt_threshold);
     if (info->na_test_info.verify)
         printf("# WARNING verifying data, output will be slower\n");
     if (info->na_test_info.force_register)
@@ -434,7 +469,7 @@ na_perf_print_bw(const struct na_perf_info *info, size_t buf_size, hg_time_t t)
     size_t loop = (size_t) info->na_test_info.loop,
            mpi_comm_size = (size_t) info->na_test_info.mpi_comm_size,
            buf_count = (size_t) info->rma_count;
-    double avg_time, avg_bw;
+    double values[2], avg_time, avg_bw;
 
     avg_time = hg_time_to_double(t) * 1e6 /
                (double) (loop * mpi_comm_size * buf_count);
@@ -446,8 +481,95 @@ na_perf_print_bw(const struct na_perf_info *info, size_t buf_size, hg_time_t t)
     else
         avg_bw /= (1024 * 1024); /* MiB/s */
 
-    printf("%-*zu%*.*f%*.*f\n", 10, buf_size, NWIDTH, NDIGITS, avg_bw, NWIDTH,
-        NDIGITS, avg_time);
+    values[0] = avg_bw;
+    values[1] = avg_time;
+    if (na_test_report_row(&info->na_test_info, buf_size, 0, values))
+        printf("%-*zu%*.*f%*.*f\n", 10, buf_size, NWIDTH, NDIGITS, avg_bw,
+            NWIDTH, NDIGITS, avg_time);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_perf_print_header_rate(const struct na_perf_info *info,
+    const char *benchmark, size_t min_size, size_t max_size, size_t window,
+    unsigned int thread_count)
+{
+    static const struct na_test_report_metric metrics[] = {
+        {"rate_msg_s", true}, {"rate_msg_s_core", true}};
+    bool expected = info->na_test_info.expected;
+
+    if (!na_test_report_begin(&info->na_test_info, benchmark, VERSION_NAME,
+            metrics, 2, false)) {
+        na_test_report_meta(&info->na_test_info, "size_min", "%zu", min_size);
+        na_test_report_meta(&info->na_test_info, "size_max", "%zu", max_size);
+        na_test_report_meta(&info->na_test_info, "window", "%zu", window);
+        na_test_report_meta(
+            &info->na_test_info, "threads", "%u", thread_count);
+        na_test_report_meta(&info->na_test_info, "expected", "%s",
+            expected ? "true" : "false");
+        return;
+    }
+
+    printf("# %s v%s\n", benchmark, VERSION_NAME);
+    printf("# Loop %d times from size %zu to %zu byte(s), %zu %s msg(s) in "
+           "flight per thread, %u thread(s)\n",
+        info->na_test_info.loop, min_size, max_size, window,
+        expected ? "expected" : "unexpected", thread_count);
+    if (info->na_test_info.verify)
+        printf("# WARNING verifying data, output will be slower\n");
+    printf("%-*s%*s%*s\n", 10, "# Size", NWIDTH, "Rate (msg/s)", NWIDTH,
+        "Rate per core (msg/s)");
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_perf_print_rate(const struct na_perf_info *info, size_t buf_size,
+    size_t msg_count, unsigned int thread_count, hg_time_t t)
+{
+    size_t mpi_comm_size = (size_t) info->na_test_info.mpi_comm_size;
+    double values[2];
+
+    /* Each thread of each process drives its own core */
+    values[0] = (double) (msg_count * mpi_comm_size) / hg_time_to_double(t);
+    values[1] = values[0] / (double) (thread_count * mpi_comm_size);
+
+    if (na_test_report_row(&info->na_test_info, buf_size, 0, values))
+        printf("%-*zu%*.*f%*.*f\n", 10, buf_size, NWIDTH, NDIGITS, values[0],
+            NWIDTH, NDIGITS, values[1]);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_perf_print_header_reg(const struct na_test_info *na_test_info,
+    const char *benchmark, size_t size_min, size_t size_max,
+    const char *mem_name, size_t page_size)
+{
+    printf("# %s v%s\n", benchmark, VERSION_NAME);
+    if (page_size > 0)
+        printf("# Loop %d times from size %zu to %zu byte(s), %s memory "
+               "(%zu byte pages)\n",
+            na_test_info->loop, size_min, size_max, mem_name, page_size);
+    else
+        printf("# Loop %d times from size %zu to %zu byte(s), %s memory\n",
+            na_test_info->loop, size_min, size_max, mem_name);
+    printf("%-*s%*s%*s%*s%*s%*s%*s\n", 10, "# Size", NWIDTH_REG,
+        "First (us)", NWIDTH_REG, "Create (us)", NWIDTH_REG, "Register (us)",
+        NWIDTH_REG, "Serialize (us)", NWIDTH_REG, "Deregister (us)",
+        NWIDTH_REG, "Total (us)");
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+na_perf_print_reg(size_t buf_size, const struct na_perf_reg_times *times)
+{
+    printf("%-*zu%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f\n", 10, buf_size, NWIDTH_REG,
+        NDIGITS, times->first, NWIDTH_REG, NDIGITS, times->create, NWIDTH_REG,
+        NDIGITS, times->reg, NWIDTH_REG, NDIGITS, times->serialize,
+        NWIDTH_REG, NDIGITS, times->dereg, NWIDTH_REG, NDIGITS,
+        times->create + times->reg + times->serialize + times->dereg);
+    fflush(stdout);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -9,6 +9,7 @@
 #define NA_PERF_H
 
 #include "na_test.h"
+#include "na_test_report.h"
 
 #include "mercury_param.h"
 #include "mercury_poll.h"
@@ -52,6 +53,14 @@ struct na_perf_info {
     int poll_fd;                       /* Poll fd */
 };
 
+struct na_perf_reg_times {
+    double first;     /* Cold create to free time (us) */
+    double create;    /* Average times (us) */
+    double reg;
+    double serialize;
+    double dereg;
+};
+
 struct na_perf_rma_info {
     int32_t expected_count; /* Expected count */
     int32_t complete_count; /* Completed count */
@@ -62,11 +71,13 @@ struct na_perf_rma_info {
 /* Public Macros */
 /*****************/
 
-#define NA_PERF_TAG_LAT_INIT 0
-#define NA_PERF_TAG_LAT      1
-#define NA_PERF_TAG_PUT      10
-#define NA_PERF_TAG_GET      20
-#define NA_PERF_TAG_DONE     111
+#define NA_PERF_TAG_LAT_INIT  0
+#define NA_PERF_TAG_LAT       1
+#define NA_PERF_TAG_PUT       10
+#define NA_PERF_TAG_GET       20
+#define NA_PERF_TAG_RATE_INIT 30
+#define NA_PERF_TAG_DONE      111
+#define NA_PERF_TAG_RATE      1000 /* Offset by sender ID */
 
 #define NA_PERF_LAT_SKIP_SMALL 100
 #define NA_PERF_LAT_SKIP_LARGE 10
@@ -74,6 +85,9 @@ struct na_perf_rma_info {
 #define NA_PERF_BW_SKIP_LARGE  2
 #define NA_PERF_LARGE_SIZE     8192
 
+#define NA_PERF_RATE_WINDOW     64  /* Default msgs in flight per sender */
+#define NA_PERF_RATE_SENDER_MAX 256 /* Max number of concurrent senders */
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -108,6 +122,23 @@ na_perf_print_header_bw(const struct na_perf_info *info, const char *benchmark);
 void
 na_perf_print_bw(const struct na_perf_info *info, size_t buf_size, hg_time_t t);
 
+void
+na_perf_print_header_rate(const struct na_perf_info *info,
+    const char *benchmark, size_t min_size, size_t max_size, size_t window,
+    unsigned int thread_count);
+
+void
+na_perf_print_rate(const struct na_perf_info *info, size_t buf_size,
+    size_t msg_count, unsigned int thread_count, hg_time_t t);
+
+void
+na_perf_print_header_reg(const struct na_test_info *na_test_info,
+    const char *benchmark, size_t size_min, size_t size_max,
+    const char *mem_name, size_t page_size);
+
+void
+na_perf_print_reg(size_t buf_size, const struct na_perf_reg_times *times);
+
 void
 na_perf_init_data(void *buf, size_t buf_size, size_t header_size);
 
@@ -21,14 +21,37 @@ typedef na_return_t (*na_perf_recv_op_t)(na_class_t *na_class,
 
 struct na_perf_recv_info {
     struct na_perf_info *info;
+    struct na_perf_rate_sender *rate_senders[NA_PERF_RATE_SENDER_MAX];
     na_perf_recv_op_t recv_op;
     na_cb_t recv_op_cb;
     na_return_t ret;
     const char *recv_op_name;
+    size_t rate_posted; /* Expected recvs posted for rate senders */
     bool post_new_recv;
     bool done;
 };
 
+/* Expected recv of rate sender */
+struct na_perf_rate_recv {
+    struct na_perf_rate_sender *sender; /* Sender */
+    void *buf;                          /* Msg buffer */
+    void *data;                         /* Plugin data */
+    na_op_id_t *op_id;                  /* Op ID */
+    bool posted;                        /* Currently posted */
+};
+
+/* Sender of na_rate, one per client thread */
+struct na_perf_rate_sender {
+    struct na_perf_recv_info *recv_info; /* Recv info */
+    na_addr_t *addr;                     /* Sender addr */
+    na_op_id_t *ack_op_id;               /* Window ack op ID */
+    struct na_perf_rate_recv *recvs;     /* Expected recvs (window) */
+    size_t window;                       /* Msgs per window */
+    size_t count;                        /* Msgs received in window */
+    na_tag_t tag;                        /* Tag of msgs and acks */
+    bool expected;                       /* Sender uses expected msgs */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -47,6 +70,23 @@ static void
 na_perf_process_recv(struct na_perf_recv_info *recv_info, void *actual_buf,
     size_t actual_buf_size, na_addr_t *source, na_tag_t tag);
 
+static na_return_t
+na_perf_rate_init(struct na_perf_recv_info *recv_info, na_addr_t *source,
+    const uint32_t *params);
+
+static na_return_t
+na_perf_rate_recv_post(struct na_perf_rate_recv *recv);
+
+static void
+na_perf_rate_recv_cb(const struct na_cb_info *na_cb_info);
+
+static na_return_t
+na_perf_rate_process(struct na_perf_rate_sender *sender, const void *buf,
+    size_t buf_size, size_t header_size);
+
+static na_return_t
+na_perf_rate_cleanup(struct na_perf_recv_info *recv_info);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -93,9 +133,11 @@ na_perf_loop(struct na_perf_info *info, na_perf_recv_op_t recv_op,
     NA_TEST_CHECK_ERROR_NORET(ret != NA_SUCCESS && ret != NA_TIMEOUT, error,
         "NA_Progress() failed (%s)", NA_Error_to_string(ret));
 
-    return NA_SUCCESS;
+    return na_perf_rate_cleanup(&recv_info);
 
 error:
+    na_perf_rate_cleanup(&recv_info);
+
     return ret;
 }
 
@@ -130,13 +172,36 @@ na_perf_multi_recv_cb(const struct na_cb_info *na_cb_info)
 /*---------------------------------------------------------------------------*/
 static void
 na_perf_process_recv(struct na_perf_recv_info *recv_info,
-    void NA_UNUSED *actual_buf, size_t actual_buf_size, na_addr_t *source,
+    void *actual_buf, size_t actual_buf_size, na_addr_t *source,
     na_tag_t tag)
 {
     struct na_perf_info *info = recv_info->info;
+    uint32_t rate_params[3] = {0, 0, 0};
     na_return_t ret = NA_SUCCESS;
     size_t i;
 
+    if (actual_buf == NULL)
+        actual_buf = info->msg_unexp_buf;
+
+    /* Rate messages are tagged with their sender ID */
+    if (tag >= NA_PERF_TAG_RATE &&
+        tag < NA_PERF_TAG_RATE + NA_PERF_RATE_SENDER_MAX) {
+        struct na_perf_rate_sender *sender =
+            recv_info->rate_senders[tag - NA_PERF_TAG_RATE];
+
+        NA_TEST_CHECK_ERROR(sender == NULL || sender->expected, release, ret,
+            NA_PROTOCOL_ERROR, "Unexpected rate msg from unknown sender");
+
+        /* Process msg before buffer can be reused */
+        ret = na_perf_rate_process(
+            sender, actual_buf, actual_buf_size, info->msg_unexp_header_size);
+        NA_TEST_CHECK_NA_ERROR(release, ret,
+            "na_perf_rate_process() failed (%s)", NA_Error_to_string(ret));
+    } else if (tag == NA_PERF_TAG_RATE_INIT)
+        memcpy(rate_params,
+            (const char *) actual_buf + info->msg_unexp_header_size,
+            sizeof(rate_params));
+
     /* Repost recv in advance to prevent buffering of unexpected msg */
     if (recv_info->post_new_recv && tag != NA_PERF_TAG_DONE) {
         recv_info->post_new_recv = false;
@@ -182,20 +247,252 @@ na_perf_process_recv(struct na_perf_recv_info *recv_info,
                 "na_perf_mem_handle_send() failed (%s)",
                 NA_Error_to_string(ret));
             break;
+        case NA_PERF_TAG_RATE_INIT:
+            ret = na_perf_rate_init(recv_info, source, rate_params);
+            NA_TEST_CHECK_NA_ERROR(done, ret,
+                "na_perf_rate_init() failed (%s)", NA_Error_to_string(ret));
+            break;
         case NA_PERF_TAG_DONE:
             recv_info->done = true;
             break;
         default:
-            ret = NA_PROTOCOL_ERROR;
+            if (tag < NA_PERF_TAG_RATE ||
+                tag >= NA_PERF_TAG_RATE + NA_PERF_RATE_SENDER_MAX)
+                ret = NA_PROTOCOL_ERROR;
             break;
     }
 
+release:
     NA_Addr_free(info->na_class, source);
 
 done:
     recv_info->ret = ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_rate_init(struct na_perf_recv_info *recv_info, na_addr_t *source,
+    const uint32_t *params)
+{
+    struct na_perf_info *info = recv_info->info;
+    struct na_perf_rate_sender *sender = NULL;
+    uint32_t id = params[0];
+    na_return_t ret;
+    size_t i;
+
+    NA_TEST_CHECK_ERROR(id >= NA_PERF_RATE_SENDER_MAX ||
+                            recv_info->rate_senders[id] != NULL,
+        error, ret, NA_PROTOCOL_ERROR, "Invalid rate sender ID (%" PRIu32 ")",
+        id);
+    NA_TEST_CHECK_ERROR(params[1] == 0, error, ret, NA_PROTOCOL_ERROR,
+        "Rate window cannot be zero");
+
+    sender = (struct na_perf_rate_sender *) calloc(1, sizeof(*sender));
+    NA_TEST_CHECK_ERROR(sender == NULL, error, ret, NA_NOMEM,
+        "Could not allocate rate sender");
+    recv_info->rate_senders[id] = sender;
+    sender->recv_info = recv_info;
+    sender->window = (size_t) params[1];
+    sender->tag = (na_tag_t) (NA_PERF_TAG_RATE + id);
+    sender->expected = (params[2] != 0);
+
+    ret = NA_Addr_dup(info->na_class, source, &sender->addr);
+    NA_TEST_CHECK_NA_ERROR(
+        error, ret, "NA_Addr_dup() failed (%s)", NA_Error_to_string(ret));
+
+    sender->ack_op_id = NA_Op_create(info->na_class, NA_OP_SINGLE);
+    NA_TEST_CHECK_ERROR(sender->ack_op_id == NULL, error, ret, NA_NOMEM,
+        "NA_Op_create() failed");
+
+    /* Pre-post one expected recv per msg in flight */
+    if (sender->expected) {
+        sender->recvs = (struct na_perf_rate_recv *) calloc(
+            sender->window, sizeof(*sender->recvs));
+        NA_TEST_CHECK_ERROR(sender->recvs == NULL, error, ret, NA_NOMEM,
+            "Could not allocate rate recvs");
+
+        for (i = 0; i < sender->window; i++) {
+            struct na_perf_rate_recv *recv = &sender->recvs[i];
+
+            recv->sender = sender;
+            recv->buf = NA_Msg_buf_alloc(info->na_class,
+                info->msg_exp_size_max, NA_RECV, &recv->data);
+            NA_TEST_CHECK_ERROR(recv->buf == NULL, error, ret, NA_NOMEM,
+                "NA_Msg_buf_alloc() failed");
+
+            recv->op_id = NA_Op_create(info->na_class, NA_OP_SINGLE);
+            NA_TEST_CHECK_ERROR(recv->op_id == NULL, error, ret, NA_NOMEM,
+                "NA_Op_create() failed");
+
+            ret = na_perf_rate_recv_post(recv);
+            NA_TEST_CHECK_NA_ERROR(error, ret,
+                "na_perf_rate_recv_post() failed (%s)",
+                NA_Error_to_string(ret));
+        }
+    }
+
+    /* Sender can start once recvs are posted */
+    ret = NA_Msg_send_expected(info->na_class, info->context, NULL, NULL,
+        info->msg_exp_buf, info->msg_exp_header_size, info->msg_exp_data,
+        sender->addr, 0, sender->tag, sender->ack_op_id);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Msg_send_expected() failed (%s)",
+        NA_Error_to_string(ret));
+
+    return NA_SUCCESS;
+
+error:
+    /* Sender is released by na_perf_rate_cleanup() */
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_rate_recv_post(struct na_perf_rate_recv *recv)
+{
+    struct na_perf_rate_sender *sender = recv->sender;
+    struct na_perf_info *info = sender->recv_info->info;
+    na_return_t ret;
+
+    ret = NA_Msg_recv_expected(info->na_class, info->context,
+        na_perf_rate_recv_cb, recv, recv->buf, info->msg_exp_size_max,
+        recv->data, sender->addr, 0, sender->tag, recv->op_id);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Msg_recv_expected() failed (%s)",
+        NA_Error_to_string(ret));
+
+    recv->posted = true;
+    sender->recv_info->rate_posted++;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_perf_rate_recv_cb(const struct na_cb_info *na_cb_info)
+{
+    struct na_perf_rate_recv *recv =
+        (struct na_perf_rate_recv *) na_cb_info->arg;
+    struct na_perf_rate_sender *sender = recv->sender;
+    struct na_perf_recv_info *recv_info = sender->recv_info;
+    na_return_t ret = na_cb_info->ret;
+
+    recv->posted = false;
+    recv_info->rate_posted--;
+
+    if (ret == NA_CANCELED)
+        return;
+    NA_TEST_CHECK_NA_ERROR(done, ret, "NA_Msg_recv_expected() failed (%s)",
+        NA_Error_to_string(ret));
+
+    /* Repost before the window can be acknowledged */
+    ret = na_perf_rate_recv_post(recv);
+    NA_TEST_CHECK_NA_ERROR(done, ret, "na_perf_rate_recv_post() failed (%s)",
+        NA_Error_to_string(ret));
+
+    ret = na_perf_rate_process(sender, recv->buf,
+        na_cb_info->info.recv_expected.actual_buf_size,
+        recv_info->info->msg_exp_header_size);
+    NA_TEST_CHECK_NA_ERROR(done, ret, "na_perf_rate_process() failed (%s)",
+        NA_Error_to_string(ret));
+
+done:
+    if (ret != NA_SUCCESS)
+        recv_info->ret = ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_rate_process(struct na_perf_rate_sender *sender, const void *buf,
+    size_t buf_size, size_t header_size)
+{
+    struct na_perf_info *info = sender->recv_info->info;
+    na_return_t ret;
+
+    if (info->na_test_info.verify) {
+        ret = na_perf_verify_data(buf, buf_size, header_size);
+        NA_TEST_CHECK_NA_ERROR(error, ret, "na_perf_verify_data() failed (%s)",
+            NA_Error_to_string(ret));
+    }
+
+    if (++sender->count < sender->window)
+        return NA_SUCCESS;
+
+    /* Acknowledge window */
+    sender->count = 0;
+    ret = NA_Msg_send_expected(info->na_class, info->context, NULL, NULL,
+        info->msg_exp_buf, info->msg_exp_header_size, info->msg_exp_data,
+        sender->addr, 0, sender->tag, sender->ack_op_id);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Msg_send_expected() failed (%s)",
+        NA_Error_to_string(ret));
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_rate_cleanup(struct na_perf_recv_info *recv_info)
+{
+    struct na_perf_info *info = recv_info->info;
+    na_return_t ret = NA_SUCCESS;
+    size_t i, j;
+
+    /* Cancel expected recvs that are still posted */
+    for (i = 0; i < NA_PERF_RATE_SENDER_MAX; i++) {
+        struct na_perf_rate_sender *sender = recv_info->rate_senders[i];
+
+        if (sender == NULL || sender->recvs == NULL)
+            continue;
+        for (j = 0; j < sender->window; j++)
+            if (sender->recvs[j].posted)
+                NA_Cancel(info->na_class, info->context,
+                    sender->recvs[j].op_id);
+    }
+
+    while (recv_info->rate_posted > 0) {
+        unsigned int actual_count = 0;
+
+        ret = NA_Progress(info->na_class, info->context, 1000);
+        if (ret != NA_SUCCESS && ret != NA_TIMEOUT)
+            break;
+        ret = NA_Trigger(info->context, 1, &actual_count);
+        if (ret != NA_SUCCESS)
+            break;
+    }
+    NA_TEST_CHECK_WARNING(ret != NA_SUCCESS && ret != NA_TIMEOUT,
+        "Could not complete canceled recvs (%s)", NA_Error_to_string(ret));
+
+    for (i = 0; i < NA_PERF_RATE_SENDER_MAX; i++) {
+        struct na_perf_rate_sender *sender = recv_info->rate_senders[i];
+
+        if (sender == NULL)
+            continue;
+        if (sender->recvs != NULL) {
+            for (j = 0; j < sender->window; j++) {
+                struct na_perf_rate_recv *recv = &sender->recvs[j];
+
+                if (recv->op_id != NULL)
+                    NA_Op_destroy(info->na_class, recv->op_id);
+                if (recv->buf != NULL)
+                    NA_Msg_buf_free(info->na_class, recv->buf, recv->data);
+            }
+            free(sender->recvs);
+        }
+        if (sender->ack_op_id != NULL)
+            NA_Op_destroy(info->na_class, sender->ack_op_id);
+        if (sender->addr != NULL)
+            NA_Addr_free(info->na_class, sender->addr);
+        free(sender);
+        recv_info->rate_senders[i] = NULL;
+    }
+
+    return (ret == NA_TIMEOUT) ? NA_SUCCESS : ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 main(int argc, char *argv[])
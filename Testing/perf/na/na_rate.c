@@ -0,0 +1,522 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "na_perf.h"
+
+#include "mercury_thread.h"
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "Message rate"
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Msg buffer used for sends */
+struct na_perf_rate_buf {
+    void *buf;          /* Msg buffer */
+    void *data;         /* Plugin data */
+    size_t size_max;    /* Max msg size */
+    size_t header_size; /* Header size */
+};
+
+/* Sending thread, each thread uses its own context */
+struct na_perf_rate_thread {
+    struct na_perf_info *info;           /* Perf info */
+    const struct na_perf_rate_buf *send; /* Send buffer */
+    na_context_t *context;               /* Context */
+    na_op_id_t **op_ids;                 /* Send op IDs (window) */
+    na_op_id_t *ack_op_id;               /* Ack recv op ID */
+    void *ack_buf;                       /* Ack buffer */
+    void *ack_data;                      /* Plugin data */
+    hg_thread_t thread;                  /* Thread */
+    hg_time_t time;                      /* Time of measured loops */
+    size_t window;                       /* Msgs in flight */
+    size_t buf_size;                     /* Current msg size */
+    size_t skip;                         /* Warm-up loops */
+    size_t completed;                    /* Completed sends in window */
+    na_return_t ret;                     /* Return code */
+    na_tag_t tag;                        /* Tag of msgs and acks */
+    uint32_t id;                         /* Sender ID */
+    bool acked;                          /* Window acknowledged */
+    bool initialized;                    /* Sender known to target */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static void
+na_perf_rate_send_cb(const struct na_cb_info *na_cb_info);
+
+static void
+na_perf_rate_ack_cb(const struct na_cb_info *na_cb_info);
+
+static na_return_t
+na_perf_rate_wait(struct na_perf_rate_thread *thread);
+
+static na_return_t
+na_perf_rate_sender_init(struct na_perf_rate_thread *thread);
+
+static na_return_t
+na_perf_rate_window(struct na_perf_rate_thread *thread);
+
+static HG_THREAD_RETURN_TYPE
+na_perf_rate_thread_run(void *arg);
+
+static na_return_t
+na_perf_rate_thread_init(struct na_perf_info *info,
+    const struct na_perf_rate_buf *send, uint32_t id, uint8_t context_id,
+    struct na_perf_rate_thread *thread);
+
+static void
+na_perf_rate_thread_cleanup(struct na_perf_rate_thread *thread);
+
+static na_return_t
+na_perf_run(struct na_perf_info *info, struct na_perf_rate_thread *threads,
+    unsigned int thread_count, size_t buf_size, size_t skip);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/*---------------------------------------------------------------------------*/
+static void
+na_perf_rate_send_cb(const struct na_cb_info *na_cb_info)
+{
+    struct na_perf_rate_thread *thread =
+        (struct na_perf_rate_thread *) na_cb_info->arg;
+
+    if (na_cb_info->ret != NA_SUCCESS)
+        thread->ret = na_cb_info->ret;
+    thread->completed++;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_perf_rate_ack_cb(const struct na_cb_info *na_cb_info)
+{
+    struct na_perf_rate_thread *thread =
+        (struct na_perf_rate_thread *) na_cb_info->arg;
+
+    if (na_cb_info->ret != NA_SUCCESS)
+        thread->ret = na_cb_info->ret;
+    thread->acked = true;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_rate_wait(struct na_perf_rate_thread *thread)
+{
+    struct na_perf_info *info = thread->info;
+    na_return_t ret;
+
+    /* Wait for all sends of the window and for the target's ack */
+    for (;;) {
+        unsigned int actual_count = 0, timeout = 0;
+
+        do {
+            ret = NA_Trigger(thread->context, 1, &actual_count);
+            NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Trigger() failed (%s)",
+                NA_Error_to_string(ret));
+        } while (actual_count > 0);
+
+        if (thread->acked && thread->completed == thread->window)
+            break;
+
+        /* Only block if no send is waiting to be retried, completions of ops
+         * progressed by other contexts would not wake up this context */
+        if (info->na_test_info.max_contexts == 1 &&
+            NA_Poll_try_wait(info->na_class, thread->context))
+            timeout = NA_MAX_IDLE_TIME;
+
+        ret = NA_Progress(info->na_class, thread->context, timeout);
+        NA_TEST_CHECK_ERROR_NORET(ret != NA_SUCCESS && ret != NA_TIMEOUT,
+            error, "NA_Progress() failed (%s)", NA_Error_to_string(ret));
+    }
+    ret = thread->ret;
+    NA_TEST_CHECK_NA_ERROR(
+        error, ret, "Msg operation failed (%s)", NA_Error_to_string(ret));
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_rate_sender_init(struct na_perf_rate_thread *thread)
+{
+    struct na_perf_info *info = thread->info;
+    uint32_t params[3] = {thread->id, (uint32_t) thread->window,
+        (uint32_t) info->na_test_info.expected};
+    void *init_buf, *init_data = NULL;
+    na_return_t ret;
+
+    /* Each thread passes its own ID and parameters */
+    init_buf = NA_Msg_buf_alloc(info->na_class, info->msg_unexp_size_max,
+        NA_SEND, &init_data);
+    NA_TEST_CHECK_ERROR(init_buf == NULL, error, ret, NA_NOMEM,
+        "NA_Msg_buf_alloc() failed");
+
+    ret = NA_Msg_init_unexpected(
+        info->na_class, init_buf, info->msg_unexp_size_max);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Msg_init_unexpected() failed (%s)",
+        NA_Error_to_string(ret));
+    memcpy((char *) init_buf + info->msg_unexp_header_size, params,
+        sizeof(params));
+
+    /* Target acks once its recvs are posted */
+    thread->acked = false;
+    thread->completed = thread->window - 1;
+
+    ret = NA_Msg_recv_expected(info->na_class, thread->context,
+        na_perf_rate_ack_cb, thread, thread->ack_buf, info->msg_exp_size_max,
+        thread->ack_data, info->target_addr, 0, thread->tag,
+        thread->ack_op_id);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Msg_recv_expected() failed (%s)",
+        NA_Error_to_string(ret));
+
+    ret = NA_Msg_send_unexpected(info->na_class, thread->context,
+        na_perf_rate_send_cb, thread, init_buf,
+        info->msg_unexp_header_size + sizeof(params), init_data,
+        info->target_addr, 0, NA_PERF_TAG_RATE_INIT, thread->op_ids[0]);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Msg_send_unexpected() failed (%s)",
+        NA_Error_to_string(ret));
+
+    ret = na_perf_rate_wait(thread);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "na_perf_rate_wait() failed (%s)",
+        NA_Error_to_string(ret));
+
+    NA_Msg_buf_free(info->na_class, init_buf, init_data);
+    thread->initialized = true;
+
+    return NA_SUCCESS;
+
+error:
+    if (init_buf != NULL)
+        NA_Msg_buf_free(info->na_class, init_buf, init_data);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_rate_window(struct na_perf_rate_thread *thread)
+{
+    struct na_perf_info *info = thread->info;
+    const struct na_perf_rate_buf *send = thread->send;
+    na_return_t ret;
+    size_t i;
+
+    thread->acked = false;
+    thread->completed = 0;
+
+    /* Post ack recv first so that the ack is never unexpected */
+    ret = NA_Msg_recv_expected(info->na_class, thread->context,
+        na_perf_rate_ack_cb, thread, thread->ack_buf, info->msg_exp_size_max,
+        thread->ack_data, info->target_addr, 0, thread->tag,
+        thread->ack_op_id);
+    NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Msg_recv_expected() failed (%s)",
+        NA_Error_to_string(ret));
+
+    /* Post window of sends */
+    for (i = 0; i < thread->window; i++) {
+        if (info->na_test_info.expected)
+            ret = NA_Msg_send_expected(info->na_class, thread->context,
+                na_perf_rate_send_cb, thread, send->buf, thread->buf_size,
+                send->data, info->target_addr, 0, thread->tag,
+                thread->op_ids[i]);
+        else
+            ret = NA_Msg_send_unexpected(info->na_class, thread->context,
+                na_perf_rate_send_cb, thread, send->buf, thread->buf_size,
+                send->data, info->target_addr, 0, thread->tag,
+                thread->op_ids[i]);
+        NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Msg_send_%s() failed (%s)",
+            info->na_test_info.expected ? "expected" : "unexpected",
+            NA_Error_to_string(ret));
+    }
+
+    return na_perf_rate_wait(thread);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+na_perf_rate_thread_run(void *arg)
+{
+    struct na_perf_rate_thread *thread = (struct na_perf_rate_thread *) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+    hg_time_t t1, t2;
+    na_return_t ret;
+    size_t i;
+
+    if (!thread->initialized) {
+        ret = na_perf_rate_sender_init(thread);
+        NA_TEST_CHECK_NA_ERROR(done, ret,
+            "na_perf_rate_sender_init() failed (%s)", NA_Error_to_string(ret));
+    }
+
+    for (i = 0; i < thread->skip + (size_t) thread->info->na_test_info.loop;
+         i++) {
+        if (i == thread->skip)
+            hg_time_get_current(&t1);
+
+        ret = na_perf_rate_window(thread);
+        NA_TEST_CHECK_NA_ERROR(done, ret, "na_perf_rate_window() failed (%s)",
+            NA_Error_to_string(ret));
+    }
+
+    hg_time_get_current(&t2);
+    thread->time = hg_time_subtract(t2, t1);
+
+done:
+    thread->ret = ret;
+
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_rate_thread_init(struct na_perf_info *info,
+    const struct na_perf_rate_buf *send, uint32_t id, uint8_t context_id,
+    struct na_perf_rate_thread *thread)
+{
+    na_return_t ret;
+    size_t i;
+
+    memset(thread, 0, sizeof(*thread));
+    thread->info = info;
+    thread->send = send;
+    thread->id = id;
+    thread->tag = (na_tag_t) (NA_PERF_TAG_RATE + id);
+    thread->window = info->na_test_info.buf_count;
+    if (thread->window == 0)
+        thread->window = NA_PERF_RATE_WINDOW;
+
+    /* First thread uses the default context */
+    if (context_id == 0)
+        thread->context = info->context;
+    else {
+        thread->context = NA_Context_create_id(info->na_class, context_id);
+        NA_TEST_CHECK_ERROR(thread->context == NULL, error, ret, NA_NOMEM,
+            "NA_Context_create_id() failed");
+    }
+
+    thread->ack_buf = NA_Msg_buf_alloc(info->na_class, info->msg_exp_size_max,
+        NA_RECV, &thread->ack_data);
+    NA_TEST_CHECK_ERROR(thread->ack_buf == NULL, error, ret, NA_NOMEM,
+        "NA_Msg_buf_alloc() failed");
+
+    thread->ack_op_id = NA_Op_create(info->na_class, NA_OP_SINGLE);
+    NA_TEST_CHECK_ERROR(thread->ack_op_id == NULL, error, ret, NA_NOMEM,
+        "NA_Op_create() failed");
+
+    thread->op_ids =
+        (na_op_id_t **) calloc(thread->window, sizeof(na_op_id_t *));
+    NA_TEST_CHECK_ERROR(thread->op_ids == NULL, error, ret, NA_NOMEM,
+        "Could not allocate op IDs");
+
+    for (i = 0; i < thread->window; i++) {
+        thread->op_ids[i] = NA_Op_create(info->na_class, NA_OP_SINGLE);
+        NA_TEST_CHECK_ERROR(thread->op_ids[i] == NULL, error, ret, NA_NOMEM,
+            "NA_Op_create() failed");
+    }
+
+    return NA_SUCCESS;
+
+error:
+    na_perf_rate_thread_cleanup(thread);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_perf_rate_thread_cleanup(struct na_perf_rate_thread *thread)
+{
+    struct na_perf_info *info = thread->info;
+
+    if (info == NULL)
+        return;
+
+    if (thread->op_ids != NULL) {
+        size_t i;
+
+        for (i = 0; i < thread->window; i++)
+            if (thread->op_ids[i] != NULL)
+                NA_Op_destroy(info->na_class, thread->op_ids[i]);
+        free(thread->op_ids);
+    }
+
+    if (thread->ack_op_id != NULL)
+        NA_Op_destroy(info->na_class, thread->ack_op_id);
+
+    if (thread->ack_buf != NULL)
+        NA_Msg_buf_free(info->na_class, thread->ack_buf, thread->ack_data);
+
+    if (thread->context != NULL && thread->context != info->context)
+        NA_Context_destroy(info->na_class, thread->context);
+
+    thread->info = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_perf_run(struct na_perf_info *info, struct na_perf_rate_thread *threads,
+    unsigned int thread_count, size_t buf_size, size_t skip)
+{
+    hg_time_t t = hg_time_from_ms(0);
+    na_return_t ret = NA_SUCCESS;
+    unsigned int i;
+
+    if (info->na_test_info.mpi_comm_size > 1)
+        NA_Test_barrier(&info->na_test_info);
+
+    for (i = 0; i < thread_count; i++) {
+        threads[i].buf_size = buf_size;
+        threads[i].skip = skip;
+        hg_thread_create(
+            &threads[i].thread, na_perf_rate_thread_run, &threads[i]);
+    }
+
+    /* Rate is bounded by the slowest thread */
+    for (i = 0; i < thread_count; i++) {
+        hg_thread_join(threads[i].thread);
+        if (threads[i].ret != NA_SUCCESS)
+            ret = threads[i].ret;
+        else if (hg_time_less(t, threads[i].time))
+            t = threads[i].time;
+    }
+    NA_TEST_CHECK_NA_ERROR(
+        error, ret, "Rate thread failed (%s)", NA_Error_to_string(ret));
+
+    if (info->na_test_info.mpi_comm_size > 1)
+        NA_Test_barrier(&info->na_test_info);
+
+    if (info->na_test_info.mpi_comm_rank == 0)
+        na_perf_print_rate(info, buf_size,
+            (size_t) info->na_test_info.loop * threads[0].window *
+                thread_count,
+            thread_count, t);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct na_perf_info info;
+    struct na_perf_rate_thread *threads = NULL;
+    struct na_perf_rate_buf send = {.buf = NULL, .data = NULL};
+    unsigned int thread_count = 0, i;
+    size_t size, min_size;
+    na_return_t na_ret;
+    bool regressed;
+
+    /* Initialize the interface */
+    na_ret = na_perf_init(argc, argv, false, &info);
+    NA_TEST_CHECK_NA_ERROR(error, na_ret, "na_perf_init() failed (%s)",
+        NA_Error_to_string(na_ret));
+
+    /* Send buffer */
+    if (info.na_test_info.expected) {
+        send.size_max = info.msg_exp_size_max;
+        send.header_size = NA_Msg_get_expected_header_size(info.na_class);
+        send.buf =
+            NA_Msg_buf_alloc(info.na_class, send.size_max, NA_SEND, &send.data);
+        NA_TEST_CHECK_ERROR(send.buf == NULL, error, na_ret, NA_NOMEM,
+            "NA_Msg_buf_alloc() failed");
+
+        na_ret = NA_Msg_init_expected(info.na_class, send.buf, send.size_max);
+        NA_TEST_CHECK_NA_ERROR(error, na_ret,
+            "NA_Msg_init_expected() failed (%s)", NA_Error_to_string(na_ret));
+    } else {
+        send.buf = info.msg_unexp_buf;
+        send.data = info.msg_unexp_data;
+        send.size_max = info.msg_unexp_size_max;
+        send.header_size = info.msg_unexp_header_size;
+    }
+    na_perf_init_data(send.buf, send.size_max, send.header_size);
+
+    /* One sending thread per context */
+    if (info.na_test_info.max_contexts == 0)
+        info.na_test_info.max_contexts = 1;
+    thread_count = info.na_test_info.max_contexts;
+    NA_TEST_CHECK_ERROR(thread_count * (unsigned int) info.na_test_info
+                                               .mpi_comm_size >
+                            NA_PERF_RATE_SENDER_MAX,
+        error, na_ret, NA_INVALID_ARG, "Too many senders (max %d)",
+        NA_PERF_RATE_SENDER_MAX);
+
+    threads = (struct na_perf_rate_thread *) calloc(
+        thread_count, sizeof(*threads));
+    NA_TEST_CHECK_ERROR(threads == NULL, error, na_ret, NA_NOMEM,
+        "Could not allocate threads");
+
+    for (i = 0; i < thread_count; i++) {
+        na_ret = na_perf_rate_thread_init(&info, &send,
+            (uint32_t) info.na_test_info.mpi_comm_rank * thread_count + i,
+            (uint8_t) i, &threads[i]);
+        NA_TEST_CHECK_NA_ERROR(error, na_ret,
+            "na_perf_rate_thread_init() failed (%s)",
+            NA_Error_to_string(na_ret));
+    }
+
+    min_size = (send.header_size > 0) ? send.header_size : 1;
+
+    /* Header info */
+    if (info.na_test_info.mpi_comm_rank == 0)
+        na_perf_print_header_rate(&info, BENCHMARK_NAME, min_size,
+            send.size_max, threads[0].window, thread_count);
+
+    /* Msg with different sizes */
+    for (size = min_size; size <= send.size_max; size *= 2) {
+        na_ret = na_perf_run(&info, threads, thread_count, size,
+            (size > NA_PERF_LARGE_SIZE) ? NA_PERF_BW_SKIP_LARGE
+                                        : NA_PERF_BW_SKIP_SMALL);
+        NA_TEST_CHECK_NA_ERROR(error, na_ret, "na_perf_run(%zu) failed (%s)",
+            size, NA_Error_to_string(na_ret));
+    }
+
+    /* Finalize interface */
+    if (info.na_test_info.mpi_comm_rank == 0)
+        na_perf_send_finalize(&info);
+
+    /* Regressions against a baseline fail the run */
+    regressed = na_test_report_end(&info.na_test_info);
+
+    for (i = 0; i < thread_count; i++)
+        na_perf_rate_thread_cleanup(&threads[i]);
+    free(threads);
+    if (info.na_test_info.expected)
+        NA_Msg_buf_free(info.na_class, send.buf, send.data);
+    na_perf_cleanup(&info);
+
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+
+error:
+    if (threads != NULL) {
+        for (i = 0; i < thread_count; i++)
+            na_perf_rate_thread_cleanup(&threads[i]);
+        free(threads);
+    }
+    if (info.na_test_info.expected && send.buf != NULL)
+        NA_Msg_buf_free(info.na_class, send.buf, send.data);
+    na_perf_cleanup(&info);
+
+    return EXIT_FAILURE;
+}
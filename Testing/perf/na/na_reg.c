@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "na_perf.h"
+
+#include "mercury_mem.h"
+
+#ifdef HG_TEST_HAS_CUDA
+#    include <cuda_runtime.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+#define BENCHMARK_NAME "NA memory registration"
+
+/* Default buffer size max if not specified */
+#define NA_REG_SIZE_MAX (1 << 24)
+
+/* Serialized handles are small, only a few segments are described */
+#define NA_REG_SERIALIZE_MAX (4096)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Kinds of memory that get registered */
+enum na_reg_mem_kind {
+    NA_REG_MEM_HOST,  /* Host memory, default pages */
+    NA_REG_MEM_HUGE,  /* Host memory, huge pages */
+    NA_REG_MEM_DEVICE /* Device memory */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static void *
+na_reg_buf_alloc(enum na_reg_mem_kind kind, size_t alloc_size);
+
+static void
+na_reg_buf_free(enum na_reg_mem_kind kind, void *buf, size_t alloc_size);
+
+static na_return_t
+na_reg_run(const struct na_test_info *na_test_info, enum na_reg_mem_kind kind,
+    void *buf, size_t buf_size, size_t skip);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+static const char *const na_reg_mem_name_g[] = {[NA_REG_MEM_HOST] = "host",
+    [NA_REG_MEM_HUGE] = "host hugepage", [NA_REG_MEM_DEVICE] = "device"};
+
+/*---------------------------------------------------------------------------*/
+static void *
+na_reg_buf_alloc(enum na_reg_mem_kind kind, size_t alloc_size)
+{
+    void *buf = NULL;
+
+    switch (kind) {
+        case NA_REG_MEM_HOST:
+            buf = hg_mem_aligned_alloc(
+                (size_t) hg_mem_get_page_size(), alloc_size);
+            break;
+        case NA_REG_MEM_HUGE:
+            buf = hg_mem_huge_alloc(alloc_size);
+            break;
+        case NA_REG_MEM_DEVICE:
+#ifdef HG_TEST_HAS_CUDA
+            if (cudaMalloc(&buf, alloc_size) != cudaSuccess)
+                buf = NULL;
+#endif
+            return buf;
+        default:
+            return NULL;
+    }
+
+    /* Fault pages in, first touch is not part of the registration cost */
+    if (buf != NULL)
+        memset(buf, 0, alloc_size);
+
+    return buf;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_reg_buf_free(enum na_reg_mem_kind kind, void *buf, size_t alloc_size)
+{
+    switch (kind) {
+        case NA_REG_MEM_HOST:
+            hg_mem_aligned_free(buf);
+            break;
+        case NA_REG_MEM_HUGE:
+            (void) hg_mem_huge_free(buf, alloc_size);
+            break;
+        case NA_REG_MEM_DEVICE:
+#ifdef HG_TEST_HAS_CUDA
+            (void) cudaFree(buf);
+#endif
+            break;
+        default:
+            break;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_reg_run(const struct na_test_info *na_test_info, enum na_reg_mem_kind kind,
+    void *buf, size_t buf_size, size_t skip)
+{
+    char serialize_buf[NA_REG_SERIALIZE_MAX];
+    struct na_perf_reg_times times = {.first = 0};
+    enum na_mem_type mem_type =
+        (kind == NA_REG_MEM_DEVICE) ? NA_MEM_TYPE_CUDA : NA_MEM_TYPE_HOST;
+    na_class_t *na_class = na_test_info->na_class;
+    na_mem_handle_t *mem_handle = NULL;
+    size_t loop = (size_t) na_test_info->loop, i;
+    na_return_t ret;
+
+    for (i = 0; i < skip + loop; i++) {
+        hg_time_t t0, t1, t2, t3, t4;
+        size_t serialize_size;
+
+        hg_time_get_current(&t0);
+
+        ret = NA_Mem_handle_create(
+            na_class, buf, buf_size, NA_MEM_READWRITE, &mem_handle);
+        NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Mem_handle_create() failed (%s)",
+            NA_Error_to_string(ret));
+        hg_time_get_current(&t1);
+
+        ret = NA_Mem_register(na_class, mem_handle, mem_type, 0);
+        NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Mem_register() failed (%s)",
+            NA_Error_to_string(ret));
+        hg_time_get_current(&t2);
+
+        serialize_size = NA_Mem_handle_get_serialize_size(na_class, mem_handle);
+        NA_TEST_CHECK_ERROR(serialize_size > sizeof(serialize_buf), error, ret,
+            NA_OVERFLOW, "Serialize size %zu exceeds %zu", serialize_size,
+            sizeof(serialize_buf));
+        ret = NA_Mem_handle_serialize(
+            na_class, serialize_buf, serialize_size, mem_handle);
+        NA_TEST_CHECK_NA_ERROR(error, ret,
+            "NA_Mem_handle_serialize() failed (%s)", NA_Error_to_string(ret));
+        hg_time_get_current(&t3);
+
+        ret = NA_Mem_deregister(na_class, mem_handle);
+        NA_TEST_CHECK_NA_ERROR(error, ret, "NA_Mem_deregister() failed (%s)",
+            NA_Error_to_string(ret));
+        NA_Mem_handle_free(na_class, mem_handle);
+        mem_handle = NULL;
+        hg_time_get_current(&t4);
+
+        /* First registration of a buffer misses any registration cache */
+        if (i == 0)
+            times.first = hg_time_to_double(hg_time_subtract(t4, t0)) * 1e6;
+        if (i < skip)
+            continue;
+
+        times.create += hg_time_to_double(hg_time_subtract(t1, t0));
+        times.reg += hg_time_to_double(hg_time_subtract(t2, t1));
+        times.serialize += hg_time_to_double(hg_time_subtract(t3, t2));
+        times.dereg += hg_time_to_double(hg_time_subtract(t4, t3));
+    }
+
+    times.create *= 1e6 / (double) loop;
+    times.reg *= 1e6 / (double) loop;
+    times.serialize *= 1e6 / (double) loop;
+    times.dereg *= 1e6 / (double) loop;
+
+    if (na_test_info->mpi_comm_rank == 0)
+        na_perf_print_reg(buf_size, &times);
+
+    return NA_SUCCESS;
+
+error:
+    if (mem_handle != NULL)
+        NA_Mem_handle_free(na_class, mem_handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct na_test_info na_test_info;
+    size_t page_size = (size_t) hg_mem_get_page_size(),
+           hugepage_size = (size_t) hg_mem_get_hugepage_size(), size_min,
+           size_max, size;
+    enum na_reg_mem_kind kind;
+    na_return_t na_ret;
+
+    /* Registration is local, no target is needed */
+    memset(&na_test_info, 0, sizeof(na_test_info));
+    na_test_info.self_send = true;
+
+    /* Initialize the interface */
+    na_ret = NA_Test_init(argc, argv, &na_test_info);
+    NA_TEST_CHECK_NA_ERROR(error, na_ret, "NA_Test_init() failed (%s)",
+        NA_Error_to_string(na_ret));
+
+#ifndef HG_TEST_HAS_CUDA
+    NA_TEST_CHECK_ERROR(na_test_info.device, error, na_ret, NA_OPNOTSUPPORTED,
+        "Device memory requested but CUDA support was not enabled");
+#endif
+
+    size_min = (na_test_info.buf_size_min > 0) ? na_test_info.buf_size_min : 1;
+    size_max = (na_test_info.buf_size_max > 0) ? na_test_info.buf_size_max
+                                               : NA_REG_SIZE_MAX;
+    NA_TEST_CHECK_ERROR(!powerof2(size_min) || !powerof2(size_max), error,
+        na_ret, NA_INVALID_ARG, "Sizes must be a power of 2 (%zu, %zu)",
+        size_min, size_max);
+
+    for (kind = NA_REG_MEM_HOST; kind <= NA_REG_MEM_DEVICE; kind++) {
+        size_t kind_page_size = (kind == NA_REG_MEM_HUGE)   ? hugepage_size
+                                : (kind == NA_REG_MEM_HOST) ? page_size
+                                                            : 0;
+
+        /* Device memory is only registered on request */
+        if (kind == NA_REG_MEM_DEVICE && !na_test_info.device)
+            break;
+        if (kind == NA_REG_MEM_HUGE && hugepage_size == 0) {
+            if (na_test_info.mpi_comm_rank == 0)
+                printf("# Skipping %s memory, no hugepage size\n",
+                    na_reg_mem_name_g[kind]);
+            continue;
+        }
+
+        if (na_test_info.mpi_comm_rank == 0)
+            na_perf_print_header_reg(&na_test_info, BENCHMARK_NAME, size_min,
+                size_max, na_reg_mem_name_g[kind], kind_page_size);
+
+        for (size = size_min; size <= size_max; size *= 2) {
+            /* Hugepage mappings are whole pages */
+            size_t alloc_size =
+                (kind == NA_REG_MEM_HUGE)
+                    ? (size + hugepage_size - 1) / hugepage_size * hugepage_size
+                    : size;
+            void *buf = na_reg_buf_alloc(kind, alloc_size);
+
+            if (buf == NULL) {
+                if (na_test_info.mpi_comm_rank == 0)
+                    printf("# Could not allocate %zu byte(s) of %s memory\n",
+                        alloc_size, na_reg_mem_name_g[kind]);
+                break;
+            }
+
+            na_ret = na_reg_run(&na_test_info, kind, buf, size,
+                (size > NA_PERF_LARGE_SIZE) ? NA_PERF_LAT_SKIP_LARGE
+                                            : NA_PERF_LAT_SKIP_SMALL);
+            na_reg_buf_free(kind, buf, alloc_size);
+            NA_TEST_CHECK_NA_ERROR(error, na_ret, "na_reg_run(%zu) failed (%s)",
+                size, NA_Error_to_string(na_ret));
+        }
+    }
+
+    (void) NA_Test_finalize(&na_test_info);
+
+    return EXIT_SUCCESS;
+
+error:
+    (void) NA_Test_finalize(&na_test_info);
+
+    return EXIT_FAILURE;
+}
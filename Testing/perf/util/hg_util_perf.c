@@ -0,0 +1,995 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_atomic.h"
+#include "mercury_atomic_queue.h"
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_event.h"
+#include "mercury_hash_table.h"
+#include "mercury_mem_pool.h"
+#include "mercury_oa_hash_table.h"
+#include "mercury_poll.h"
+#include "mercury_thread.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_thread_pool.h"
+#include "mercury_thread_rwlock.h"
+#include "mercury_thread_spin.h"
+#include "mercury_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+#define STRING(s)  #s
+#define XSTRING(s) STRING(s)
+#define VERSION_NAME                                                           \
+    XSTRING(HG_UTIL_VERSION_MAJOR)                                             \
+    "." XSTRING(HG_UTIL_VERSION_MINOR) "." XSTRING(HG_UTIL_VERSION_PATCH)
+
+/* Default number of ops per thread */
+#define HG_UTIL_PERF_LOOP (1 << 20)
+
+/* Default max number of threads */
+#define HG_UTIL_PERF_THREAD_MAX (8)
+
+/* Ops of slow benchmarks are scaled down from the loop count */
+#define HG_UTIL_PERF_POOL_SHIFT    (4)
+#define HG_UTIL_PERF_HANDOFF_SHIFT (8)
+
+/* Sizes of benchmarked objects */
+#define HG_UTIL_PERF_QUEUE_SIZE  (1024)
+#define HG_UTIL_PERF_CHUNK_SIZE  (64)
+#define HG_UTIL_PERF_CHUNK_COUNT (1024)
+#define HG_UTIL_PERF_CACHE_COUNT (64)
+
+#define NDIGITS 2
+#define NWIDTH  24
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Benchmark run by 1 to N threads on a shared state */
+struct hg_util_perf_bench {
+    const char *name;                     /* Benchmark name */
+    const char *desc;                     /* Op description */
+    void *(*setup)(unsigned int threads); /* Create shared state */
+    void (*run)(void *state, unsigned int index, unsigned int loop);
+    void (*teardown)(void *state); /* Destroy shared state */
+};
+
+/* Threads of a benchmark run */
+struct hg_util_perf_run {
+    const struct hg_util_perf_bench *bench; /* Benchmark */
+    void *state;                            /* Shared state */
+    hg_atomic_int32_t ready;                /* Threads ready to start */
+    hg_atomic_int32_t go;                   /* Start flag */
+    unsigned int loop;                      /* Ops per thread */
+};
+
+struct hg_util_perf_thread {
+    struct hg_util_perf_run *run; /* Run */
+    hg_thread_t thread;           /* Thread */
+    unsigned int index;           /* Thread index */
+};
+
+/* Shared state of lock benchmarks */
+struct hg_util_perf_lock {
+    hg_thread_mutex_t mutex;
+    hg_thread_spin_t spin;
+    hg_thread_ticket_t ticket;
+    hg_thread_rwlock_t rwlock;
+    hg_thread_brlock_t brlock;
+    volatile unsigned int turn; /* Owner of next handoff */
+    volatile int64_t value;
+};
+
+/* Shared state of thread pool benchmark */
+struct hg_util_perf_pool {
+    hg_thread_pool_t *pool;
+    struct hg_thread_work *works;
+    hg_atomic_int32_t completed;
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+static HG_THREAD_RETURN_TYPE
+hg_util_perf_thread_cb(void *arg);
+
+static int
+hg_util_perf_threads(const struct hg_util_perf_bench *bench,
+    unsigned int thread_count, unsigned int loop, double *rate);
+
+static void
+hg_util_perf_print_threads(const struct hg_util_perf_bench *bench,
+    unsigned int thread_max, unsigned int loop);
+
+static void *
+hg_util_perf_queue_setup(unsigned int threads);
+
+static void
+hg_util_perf_queue_run(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_queue_teardown(void *state);
+
+static void *
+hg_util_perf_seg_queue_setup(unsigned int threads);
+
+static void
+hg_util_perf_seg_queue_run(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_seg_queue_teardown(void *state);
+
+static void *
+hg_util_perf_mem_pool_setup(unsigned int threads);
+
+static void *
+hg_util_perf_mem_pool_cache_setup(unsigned int threads);
+
+static void
+hg_util_perf_mem_pool_run(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_mem_pool_teardown(void *state);
+
+static void *
+hg_util_perf_lock_setup(unsigned int threads);
+
+static void
+hg_util_perf_mutex_run(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_spin_run(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_ticket_run(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_rwlock_run(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_brlock_run(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_lock_teardown(void *state);
+
+static void
+hg_util_perf_mutex_handoff(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_spin_handoff(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_ticket_handoff(void *state, unsigned int index, unsigned int loop);
+
+static void
+hg_util_perf_print_handoff(unsigned int loop);
+
+static unsigned int
+hg_util_perf_key_hash(hg_hash_table_key_t key);
+
+static int
+hg_util_perf_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+static int
+hg_util_perf_hash(unsigned int entries, unsigned int loop, bool oa,
+    double *lookup_time);
+
+static void
+hg_util_perf_print_hash(unsigned int loop);
+
+static HG_THREAD_RETURN_TYPE
+hg_util_perf_pool_work(void *arg);
+
+static int
+hg_util_perf_pool(unsigned int thread_count, unsigned int loop, double *rate);
+
+static void
+hg_util_perf_print_pool(unsigned int thread_max, unsigned int loop);
+
+static int
+hg_util_perf_poll(unsigned int loop, double *rate);
+
+static void
+hg_util_perf_print_poll(unsigned int loop);
+
+static bool
+hg_util_perf_selected(int argc, char *argv[], int first, const char *name);
+
+static void
+hg_util_perf_usage(const char *execname);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Benchmarks run under 1 to N threads */
+static const struct hg_util_perf_bench hg_util_perf_benches_g[] = {
+    {"queue", "hg_atomic_queue push/pop pairs", hg_util_perf_queue_setup,
+        hg_util_perf_queue_run, hg_util_perf_queue_teardown},
+    {"seg_queue", "hg_atomic_seg_queue push/pop pairs",
+        hg_util_perf_seg_queue_setup, hg_util_perf_seg_queue_run,
+        hg_util_perf_seg_queue_teardown},
+    {"mem_pool", "hg_mem_pool alloc/free pairs", hg_util_perf_mem_pool_setup,
+        hg_util_perf_mem_pool_run, hg_util_perf_mem_pool_teardown},
+    {"mem_pool_cache", "hg_mem_pool alloc/free pairs (thread cache)",
+        hg_util_perf_mem_pool_cache_setup, hg_util_perf_mem_pool_run,
+        hg_util_perf_mem_pool_teardown},
+    {"mutex", "hg_thread_mutex lock/unlock pairs", hg_util_perf_lock_setup,
+        hg_util_perf_mutex_run, hg_util_perf_lock_teardown},
+    {"spin", "hg_thread_spin lock/unlock pairs", hg_util_perf_lock_setup,
+        hg_util_perf_spin_run, hg_util_perf_lock_teardown},
+    {"ticket", "hg_thread_ticket lock/unlock pairs", hg_util_perf_lock_setup,
+        hg_util_perf_ticket_run, hg_util_perf_lock_teardown},
+    {"rwlock", "hg_thread_rwlock read lock/unlock pairs",
+        hg_util_perf_lock_setup, hg_util_perf_rwlock_run,
+        hg_util_perf_lock_teardown},
+    {"brlock", "hg_thread_brlock read lock/unlock pairs",
+        hg_util_perf_lock_setup, hg_util_perf_brlock_run,
+        hg_util_perf_lock_teardown}};
+
+/* Lock handoffs between two threads */
+static const struct hg_util_perf_bench hg_util_perf_handoffs_g[] = {
+    {"mutex", "hg_thread_mutex", hg_util_perf_lock_setup,
+        hg_util_perf_mutex_handoff, hg_util_perf_lock_teardown},
+    {"spin", "hg_thread_spin", hg_util_perf_lock_setup,
+        hg_util_perf_spin_handoff, hg_util_perf_lock_teardown},
+    {"ticket", "hg_thread_ticket", hg_util_perf_lock_setup,
+        hg_util_perf_ticket_handoff, hg_util_perf_lock_teardown}};
+
+/* Hash table loads (number of entries) */
+static const unsigned int hg_util_perf_hash_loads_g[] = {
+    16, 1024, 65536, 1048576};
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_util_perf_thread_cb(void *arg)
+{
+    struct hg_util_perf_thread *thread = (struct hg_util_perf_thread *) arg;
+    struct hg_util_perf_run *run = thread->run;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+
+    /* Wait for all threads to be created */
+    hg_atomic_incr32(&run->ready);
+    while (hg_atomic_get32(&run->go) == 0)
+        hg_thread_yield();
+
+    run->bench->run(run->state, thread->index, run->loop);
+
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_util_perf_threads(const struct hg_util_perf_bench *bench,
+    unsigned int thread_count, unsigned int loop, double *rate)
+{
+    struct hg_util_perf_thread *threads;
+    struct hg_util_perf_run run;
+    hg_time_t t1, t2;
+    unsigned int i;
+
+    run.bench = bench;
+    run.loop = loop;
+    hg_atomic_init32(&run.ready, 0);
+    hg_atomic_init32(&run.go, 0);
+    run.state = bench->setup(thread_count);
+    if (run.state == NULL)
+        return HG_UTIL_FAIL;
+
+    threads = (struct hg_util_perf_thread *) calloc(
+        thread_count, sizeof(*threads));
+    if (threads == NULL) {
+        bench->teardown(run.state);
+        return HG_UTIL_FAIL;
+    }
+
+    for (i = 0; i < thread_count; i++) {
+        threads[i].run = &run;
+        threads[i].index = i;
+        hg_thread_create(
+            &threads[i].thread, hg_util_perf_thread_cb, &threads[i]);
+    }
+    while (hg_atomic_get32(&run.ready) < (int32_t) thread_count)
+        hg_thread_yield();
+
+    hg_time_get_current(&t1);
+    hg_atomic_set32(&run.go, 1);
+    for (i = 0; i < thread_count; i++)
+        hg_thread_join(threads[i].thread);
+    hg_time_get_current(&t2);
+
+    *rate = (double) thread_count * (double) loop /
+            hg_time_to_double(hg_time_subtract(t2, t1));
+
+    free(threads);
+    bench->teardown(run.state);
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_print_threads(const struct hg_util_perf_bench *bench,
+    unsigned int thread_max, unsigned int loop)
+{
+    unsigned int thread_count;
+
+    printf("# %s: %s, %u per thread\n", bench->name, bench->desc, loop);
+    printf("%-*s%*s%*s\n", 10, "# Threads", NWIDTH, "Rate (Mops/s)", NWIDTH,
+        "Per thread (Mops/s)");
+    for (thread_count = 1; thread_count <= thread_max; thread_count *= 2) {
+        double rate;
+
+        if (hg_util_perf_threads(bench, thread_count, loop, &rate) !=
+            HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not run %s with %u thread(s)\n",
+                bench->name, thread_count);
+            return;
+        }
+        printf("%-*u%*.*f%*.*f\n", 10, thread_count, NWIDTH, NDIGITS,
+            rate / 1e6, NWIDTH, NDIGITS, rate / 1e6 / (double) thread_count);
+        fflush(stdout);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_util_perf_queue_setup(unsigned int threads)
+{
+    (void) threads;
+
+    return hg_atomic_queue_alloc(HG_UTIL_PERF_QUEUE_SIZE);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_queue_run(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_atomic_queue *queue = (struct hg_atomic_queue *) state;
+    void *entry = (void *) ((uintptr_t) index + 1);
+    unsigned int i;
+
+    /* At most one entry per thread is queued, pop cannot fail for long */
+    for (i = 0; i < loop; i++) {
+        while (hg_atomic_queue_push(queue, entry) != HG_UTIL_SUCCESS)
+            continue;
+        while (hg_atomic_queue_pop_mc(queue) == NULL)
+            continue;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_queue_teardown(void *state)
+{
+    hg_atomic_queue_free((struct hg_atomic_queue *) state);
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_util_perf_seg_queue_setup(unsigned int threads)
+{
+    (void) threads;
+
+    return hg_atomic_seg_queue_alloc(HG_UTIL_PERF_QUEUE_SIZE);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_seg_queue_run(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_atomic_seg_queue *queue = (struct hg_atomic_seg_queue *) state;
+    void *entry = (void *) ((uintptr_t) index + 1);
+    unsigned int i;
+
+    for (i = 0; i < loop; i++) {
+        while (hg_atomic_seg_queue_push(queue, entry) != HG_UTIL_SUCCESS)
+            continue;
+        while (hg_atomic_seg_queue_pop(queue) == NULL)
+            continue;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_seg_queue_teardown(void *state)
+{
+    hg_atomic_seg_queue_free((struct hg_atomic_seg_queue *) state);
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_util_perf_mem_pool_setup(unsigned int threads)
+{
+    return hg_mem_pool_create(HG_UTIL_PERF_CHUNK_SIZE,
+        HG_UTIL_PERF_CHUNK_COUNT + threads * HG_UTIL_PERF_CACHE_COUNT, 1, NULL,
+        0, NULL, NULL);
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_util_perf_mem_pool_cache_setup(unsigned int threads)
+{
+    struct hg_mem_pool *pool = hg_util_perf_mem_pool_setup(threads);
+
+    if (pool == NULL)
+        return NULL;
+
+    if (hg_mem_pool_set_thread_cache(pool, HG_UTIL_PERF_CACHE_COUNT) !=
+        HG_UTIL_SUCCESS) {
+        hg_mem_pool_destroy(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_mem_pool_run(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_mem_pool *pool = (struct hg_mem_pool *) state;
+    unsigned int i;
+
+    (void) index;
+
+    for (i = 0; i < loop; i++) {
+        void *chunk = hg_mem_pool_alloc(pool, HG_UTIL_PERF_CHUNK_SIZE, NULL);
+
+        if (chunk != NULL)
+            hg_mem_pool_free(pool, chunk, NULL);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_mem_pool_teardown(void *state)
+{
+    hg_mem_pool_destroy((struct hg_mem_pool *) state);
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_util_perf_lock_setup(unsigned int threads)
+{
+    struct hg_util_perf_lock *lock;
+
+    (void) threads;
+
+    lock = (struct hg_util_perf_lock *) calloc(1, sizeof(*lock));
+    if (lock == NULL)
+        return NULL;
+
+    hg_thread_mutex_init(&lock->mutex);
+    hg_thread_spin_init(&lock->spin);
+    hg_thread_ticket_init(&lock->ticket);
+    hg_thread_rwlock_init(&lock->rwlock);
+    hg_thread_brlock_init(&lock->brlock);
+
+    return lock;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_mutex_run(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+    unsigned int i;
+
+    (void) index;
+
+    for (i = 0; i < loop; i++) {
+        hg_thread_mutex_lock(&lock->mutex);
+        lock->value++;
+        hg_thread_mutex_unlock(&lock->mutex);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_spin_run(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+    unsigned int i;
+
+    (void) index;
+
+    for (i = 0; i < loop; i++) {
+        hg_thread_spin_lock(&lock->spin);
+        lock->value++;
+        hg_thread_spin_unlock(&lock->spin);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_ticket_run(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+    unsigned int i;
+
+    (void) index;
+
+    for (i = 0; i < loop; i++) {
+        hg_thread_ticket_lock(&lock->ticket);
+        lock->value++;
+        hg_thread_ticket_unlock(&lock->ticket);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_rwlock_run(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+    int64_t value = 0;
+    unsigned int i;
+
+    (void) index;
+
+    for (i = 0; i < loop; i++) {
+        hg_thread_rwlock_rdlock(&lock->rwlock);
+        value += lock->value;
+        hg_thread_rwlock_release_rdlock(&lock->rwlock);
+    }
+    (void) value;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_brlock_run(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+    int64_t value = 0;
+    unsigned int i;
+
+    (void) index;
+
+    for (i = 0; i < loop; i++) {
+        hg_thread_brlock_rdlock(&lock->brlock);
+        value += lock->value;
+        hg_thread_brlock_release_rdlock(&lock->brlock);
+    }
+    (void) value;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_lock_teardown(void *state)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+
+    hg_thread_brlock_destroy(&lock->brlock);
+    hg_thread_rwlock_destroy(&lock->rwlock);
+    hg_thread_ticket_destroy(&lock->ticket);
+    hg_thread_spin_destroy(&lock->spin);
+    hg_thread_mutex_destroy(&lock->mutex);
+    free(lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_mutex_handoff(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+    unsigned int i = 0;
+
+    /* Each turn is handed off to the other thread through the lock */
+    while (i < loop) {
+        hg_thread_mutex_lock(&lock->mutex);
+        if (lock->turn == index) {
+            lock->turn = !index;
+            i++;
+        }
+        hg_thread_mutex_unlock(&lock->mutex);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_spin_handoff(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+    unsigned int i = 0;
+
+    while (i < loop) {
+        hg_thread_spin_lock(&lock->spin);
+        if (lock->turn == index) {
+            lock->turn = !index;
+            i++;
+        }
+        hg_thread_spin_unlock(&lock->spin);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_ticket_handoff(void *state, unsigned int index, unsigned int loop)
+{
+    struct hg_util_perf_lock *lock = (struct hg_util_perf_lock *) state;
+    unsigned int i = 0;
+
+    while (i < loop) {
+        hg_thread_ticket_lock(&lock->ticket);
+        if (lock->turn == index) {
+            lock->turn = !index;
+            i++;
+        }
+        hg_thread_ticket_unlock(&lock->ticket);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_print_handoff(unsigned int loop)
+{
+    size_t i;
+
+    printf("# handoff: lock handed off between 2 threads, %u per thread\n",
+        loop);
+    printf("%-*s%*s\n", 10, "# Lock", NWIDTH, "Latency (ns)");
+    for (i = 0; i < sizeof(hg_util_perf_handoffs_g) /
+                        sizeof(hg_util_perf_handoffs_g[0]);
+         i++) {
+        const struct hg_util_perf_bench *bench = &hg_util_perf_handoffs_g[i];
+        double rate;
+
+        if (hg_util_perf_threads(bench, 2, loop, &rate) != HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not run %s handoff\n", bench->name);
+            return;
+        }
+        printf("%-*s%*.*f\n", 10, bench->name, NWIDTH, NDIGITS, 1e9 / rate);
+        fflush(stdout);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_util_perf_key_hash(hg_hash_table_key_t key)
+{
+    uint64_t k = *(const uint64_t *) key;
+
+    /* Mix bits so that consecutive keys do not map to consecutive slots */
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+
+    return (unsigned int) k;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_util_perf_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return *(const uint64_t *) key1 == *(const uint64_t *) key2;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_util_perf_hash(
+    unsigned int entries, unsigned int loop, bool oa, double *lookup_time)
+{
+    hg_hash_table_t *hash_table = NULL;
+    hg_oa_hash_table_t *oa_hash_table = NULL;
+    uint64_t *keys;
+    uintptr_t found = 0;
+    hg_time_t t1, t2;
+    unsigned int i;
+    int ret = HG_UTIL_SUCCESS;
+
+    keys = (uint64_t *) malloc(entries * sizeof(*keys));
+    if (keys == NULL)
+        return HG_UTIL_FAIL;
+    for (i = 0; i < entries; i++)
+        keys[i] = i;
+
+    if (oa)
+        oa_hash_table =
+            hg_oa_hash_table_new(hg_util_perf_key_hash, hg_util_perf_key_equal);
+    else
+        hash_table =
+            hg_hash_table_new(hg_util_perf_key_hash, hg_util_perf_key_equal);
+    if (hash_table == NULL && oa_hash_table == NULL) {
+        free(keys);
+        return HG_UTIL_FAIL;
+    }
+
+    for (i = 0; i < entries; i++) {
+        int rc = oa ? hg_oa_hash_table_insert(oa_hash_table, &keys[i], &keys[i])
+                    : hg_hash_table_insert(hash_table, &keys[i], &keys[i]);
+        if (rc == 0) {
+            ret = HG_UTIL_FAIL;
+            goto done;
+        }
+    }
+
+    /* Look up keys in a strided order that defeats the prefetcher */
+    hg_time_get_current(&t1);
+    for (i = 0; i < loop; i++) {
+        uint64_t key = (uint64_t) ((i * 2654435761U) % entries);
+
+        found += (uintptr_t) (oa ? hg_oa_hash_table_lookup(oa_hash_table, &key)
+                                 : hg_hash_table_lookup(hash_table, &key));
+    }
+    hg_time_get_current(&t2);
+
+    *lookup_time = hg_time_to_double(hg_time_subtract(t2, t1)) * 1e9 / loop;
+    if (found == 0)
+        ret = HG_UTIL_FAIL;
+
+done:
+    if (oa)
+        hg_oa_hash_table_free(oa_hash_table);
+    else
+        hg_hash_table_free(hash_table);
+    free(keys);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_print_hash(unsigned int loop)
+{
+    size_t i;
+
+    printf("# hash: lookups at various loads, %u lookups\n", loop);
+    printf("%-*s%*s%*s\n", 10, "# Entries", NWIDTH, "hash_table (ns)",
+        NWIDTH, "oa_hash_table (ns)");
+    for (i = 0; i < sizeof(hg_util_perf_hash_loads_g) /
+                        sizeof(hg_util_perf_hash_loads_g[0]);
+         i++) {
+        unsigned int entries = hg_util_perf_hash_loads_g[i];
+        double chained, oa;
+
+        if (hg_util_perf_hash(entries, loop, false, &chained) !=
+                HG_UTIL_SUCCESS ||
+            hg_util_perf_hash(entries, loop, true, &oa) != HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not run hash with %u entries\n",
+                entries);
+            return;
+        }
+        printf("%-*u%*.*f%*.*f\n", 10, entries, NWIDTH, NDIGITS, chained,
+            NWIDTH, NDIGITS, oa);
+        fflush(stdout);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_util_perf_pool_work(void *arg)
+{
+    struct hg_util_perf_pool *pool = (struct hg_util_perf_pool *) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+
+    hg_atomic_incr32(&pool->completed);
+
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_util_perf_pool(unsigned int thread_count, unsigned int loop, double *rate)
+{
+    struct hg_util_perf_pool pool;
+    hg_time_t t1, t2;
+    unsigned int i;
+
+    hg_atomic_init32(&pool.completed, 0);
+    pool.works =
+        (struct hg_thread_work *) calloc(loop, sizeof(struct hg_thread_work));
+    if (pool.works == NULL)
+        return HG_UTIL_FAIL;
+    if (hg_thread_pool_init(thread_count, &pool.pool) != HG_UTIL_SUCCESS) {
+        free(pool.works);
+        return HG_UTIL_FAIL;
+    }
+
+    /* Time from first post to last completion */
+    hg_time_get_current(&t1);
+    for (i = 0; i < loop; i++) {
+        pool.works[i].func = hg_util_perf_pool_work;
+        pool.works[i].args = &pool;
+        hg_thread_pool_post(pool.pool, &pool.works[i]);
+    }
+    while (hg_atomic_get32(&pool.completed) < (int32_t) loop)
+        hg_thread_yield();
+    hg_time_get_current(&t2);
+
+    *rate = (double) loop / hg_time_to_double(hg_time_subtract(t2, t1));
+
+    hg_thread_pool_destroy(pool.pool);
+    free(pool.works);
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_print_pool(unsigned int thread_max, unsigned int loop)
+{
+    unsigned int thread_count;
+
+    printf("# thread_pool: hg_thread_pool posts of empty work, %u posts\n",
+        loop);
+    printf("%-*s%*s\n", 10, "# Threads", NWIDTH, "Rate (Mops/s)");
+    for (thread_count = 1; thread_count <= thread_max; thread_count *= 2) {
+        double rate;
+
+        if (hg_util_perf_pool(thread_count, loop, &rate) != HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not run thread_pool with %u "
+                            "thread(s)\n",
+                thread_count);
+            return;
+        }
+        printf("%-*u%*.*f\n", 10, thread_count, NWIDTH, NDIGITS, rate / 1e6);
+        fflush(stdout);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_util_perf_poll(unsigned int loop, double *rate)
+{
+    struct hg_poll_event event = {.events = HG_POLLIN, .data.ptr = NULL};
+    hg_poll_set_t *poll_set;
+    hg_time_t t1, t2;
+    unsigned int i;
+    int fd, ret = HG_UTIL_SUCCESS;
+
+    poll_set = hg_poll_create();
+    if (poll_set == NULL)
+        return HG_UTIL_FAIL;
+    fd = hg_event_create();
+    if (fd < 0 || hg_poll_add(poll_set, fd, &event) != HG_UTIL_SUCCESS) {
+        ret = HG_UTIL_FAIL;
+        goto done;
+    }
+
+    /* Signal, wait and consume event */
+    hg_time_get_current(&t1);
+    for (i = 0; i < loop; i++) {
+        unsigned int nevents = 0;
+        bool signaled = false;
+
+        hg_event_set(fd);
+        hg_poll_wait(poll_set, 0, 1, &event, &nevents);
+        hg_event_get(fd, &signaled);
+        if (nevents != 1 || !signaled) {
+            ret = HG_UTIL_FAIL;
+            break;
+        }
+    }
+    hg_time_get_current(&t2);
+
+    *rate = (double) loop / hg_time_to_double(hg_time_subtract(t2, t1));
+
+    hg_poll_remove(poll_set, fd);
+
+done:
+    if (fd >= 0)
+        hg_event_destroy(fd);
+    hg_poll_destroy(poll_set);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_print_poll(unsigned int loop)
+{
+    double rate;
+
+    printf("# poll: hg_event set/hg_poll_wait/hg_event get cycles, %u "
+           "cycles\n",
+        loop);
+    if (hg_util_perf_poll(loop, &rate) != HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: could not run poll\n");
+        return;
+    }
+    printf("%-*s%*s\n", 10, "#", NWIDTH, "Rate (Mops/s)");
+    printf("%-*s%*.*f\n", 10, "", NWIDTH, NDIGITS, rate / 1e6);
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+hg_util_perf_selected(int argc, char *argv[], int first, const char *name)
+{
+    int i;
+
+    /* All benchmarks are run if none is named */
+    if (first >= argc)
+        return true;
+
+    for (i = first; i < argc; i++)
+        if (strcmp(argv[i], name) == 0)
+            return true;
+
+    return false;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_util_perf_usage(const char *execname)
+{
+    size_t i;
+
+    printf("usage: %s [OPTIONS] [BENCHMARK...]\n", execname);
+    printf("    -h            Print a usage message and exit\n");
+    printf("    -l LOOP       Number of ops per thread (default: %d)\n",
+        HG_UTIL_PERF_LOOP);
+    printf("    -t THREADS    Max number of threads (default: %d)\n",
+        HG_UTIL_PERF_THREAD_MAX);
+    printf("    BENCHMARKS:");
+    for (i = 0; i < sizeof(hg_util_perf_benches_g) /
+                        sizeof(hg_util_perf_benches_g[0]);
+         i++)
+        printf(" %s", hg_util_perf_benches_g[i].name);
+    printf(" handoff hash thread_pool poll\n");
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    unsigned int thread_max = HG_UTIL_PERF_THREAD_MAX,
+                 loop = HG_UTIL_PERF_LOOP;
+    size_t i;
+    int first;
+
+    for (first = 1; first < argc && argv[first][0] == '-'; first++) {
+        if (strcmp(argv[first], "-t") == 0 && first + 1 < argc)
+            thread_max = (unsigned int) atoi(argv[++first]);
+        else if (strcmp(argv[first], "-l") == 0 && first + 1 < argc)
+            loop = (unsigned int) atoi(argv[++first]);
+        else {
+            hg_util_perf_usage(argv[0]);
+            return strcmp(argv[first], "-h") == 0 ? EXIT_SUCCESS
+                                                  : EXIT_FAILURE;
+        }
+    }
+    if (thread_max == 0 || loop == 0) {
+        hg_util_perf_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("# Mercury util micro-benchmarks v%s\n", VERSION_NAME);
+
+    for (i = 0; i < sizeof(hg_util_perf_benches_g) /
+                        sizeof(hg_util_perf_benches_g[0]);
+         i++)
+        if (hg_util_perf_selected(
+                argc, argv, first, hg_util_perf_benches_g[i].name))
+            hg_util_perf_print_threads(
+                &hg_util_perf_benches_g[i], thread_max, loop);
+
+    if (hg_util_perf_selected(argc, argv, first, "handoff"))
+        hg_util_perf_print_handoff(
+            (loop >> HG_UTIL_PERF_HANDOFF_SHIFT) + 1);
+
+    if (hg_util_perf_selected(argc, argv, first, "hash"))
+        hg_util_perf_print_hash(loop);
+
+    if (hg_util_perf_selected(argc, argv, first, "thread_pool"))
+        hg_util_perf_print_pool(
+            thread_max, (loop >> HG_UTIL_PERF_POOL_SHIFT) + 1);
+
+    if (hg_util_perf_selected(argc, argv, first, "poll"))
+        hg_util_perf_print_poll(loop);
+
+    return EXIT_SUCCESS;
+}
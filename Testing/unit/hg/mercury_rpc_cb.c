@@ -218,6 +218,21 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_test_rpc_open_reduce(void *acc_struct, void *out_struct)
+{
+    rpc_open_out_t *acc = (rpc_open_out_t *) acc_struct;
+    const rpc_open_out_t *out = (const rpc_open_out_t *) out_struct;
+
+    /* Keep first error and sum event IDs */
+    if (acc->ret == 0)
+        acc->ret = out->ret;
+    acc->event_id += out->event_id;
+
+    return HG_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 HG_TEST_RPC_CB(hg_test_rpc_open_no_resp, handle)
 {
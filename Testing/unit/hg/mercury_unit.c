@@ -61,6 +61,7 @@ hg_test_register(hg_class_t *hg_class);
 hg_id_t hg_test_rpc_null_id_g = 0;
 hg_id_t hg_test_rpc_open_id_g = 0;
 hg_id_t hg_test_rpc_open_id_no_resp_g = 0;
+hg_id_t hg_test_rpc_open_reduce_id_g = 0;
 hg_id_t hg_test_overflow_id_g = 0;
 hg_id_t hg_test_cancel_rpc_id_g = 0;
 
@@ -223,6 +224,15 @@ hg_test_register(hg_class_t *hg_class)
     HG_Registered_disable_response(
         hg_class, hg_test_rpc_open_id_no_resp_g, HG_TRUE);
 
+    hg_test_rpc_open_reduce_id_g = MERCURY_REGISTER(hg_class,
+        "hg_test_rpc_open_reduce", rpc_open_in_t, rpc_open_out_t,
+        hg_test_rpc_open_cb);
+#ifndef HG_HAS_XDR
+    /* Reduce fan-out outputs */
+    HG_Registered_reduce(hg_class, hg_test_rpc_open_reduce_id_g,
+        hg_test_rpc_open_reduce, sizeof(rpc_open_out_t));
+#endif
+
     hg_test_overflow_id_g = MERCURY_REGISTER(hg_class, "hg_test_overflow", void,
         overflow_out_t, hg_test_overflow_cb);
     hg_test_cancel_rpc_id_g = MERCURY_REGISTER(
@@ -7,7 +7,11 @@
 
 #include "mercury_unit.h"
 
+#include "mercury_bulk_proc.h"
+#include "mercury_crc32c.h"
+#include "mercury_mem.h"
 #include "mercury_param.h"
+#include "mercury_time.h"
 
 /****************/
 /* Local Macros */
@@ -16,6 +20,16 @@
 /* Wait timeout in ms */
 #define HG_TEST_WAIT_TIMEOUT (HG_TEST_TIMEOUT * 1000)
 
+/* Segments and size of segments of handles used by feature tests */
+#define HG_TEST_BULK_SEGMENT_COUNT (4)
+#define HG_TEST_BULK_SEGMENT_SIZE  (1024)
+#define HG_TEST_BULK_SIZE                                                      \
+    (HG_TEST_BULK_SEGMENT_COUNT * HG_TEST_BULK_SEGMENT_SIZE)
+
+/* Chunks of pipelined transfers */
+#define HG_TEST_BULK_CHUNK_SIZE  (512)
+#define HG_TEST_BULK_CHUNK_COUNT (HG_TEST_BULK_SIZE / HG_TEST_BULK_CHUNK_SIZE)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -33,6 +47,28 @@ struct forward_cb_args {
     hg_return_t ret;
 };
 
+/* Two listening classes so that transfers between them go through NA */
+struct hg_test_bulk_pair {
+    hg_class_t *local_class;      /* Class that issues transfers */
+    hg_context_t *local_context;  /* Context of local class */
+    hg_class_t *origin_class;     /* Class that exposes origin handles */
+    hg_context_t *origin_context; /* Context of origin class */
+    hg_addr_t origin_addr;        /* Origin addr looked up by local class */
+};
+
+struct transfer_cb_args {
+    struct hg_cb_info_bulk info; /* Bulk info of completed transfer */
+    hg_return_t ret;             /* Returned status */
+    int32_t rank;                /* Order of completion */
+    int32_t *complete_count;     /* Number of completed transfers */
+};
+
+struct chunk_cb_args {
+    hg_size_t offsets[HG_TEST_BULK_CHUNK_COUNT]; /* Offsets of chunks */
+    hg_size_t sizes[HG_TEST_BULK_CHUNK_COUNT];   /* Sizes of chunks */
+    unsigned int count;                          /* Number of chunks */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -52,6 +88,58 @@ hg_test_bulk_forward(hg_handle_t handle, hg_addr_t addr, hg_id_t rpc_id,
 static hg_return_t
 hg_test_bulk_forward_cb(const struct hg_cb_info *callback_info);
 
+static hg_return_t
+hg_test_bulk_pair_init(const hg_class_t *parent_class,
+    const struct hg_init_info *hg_init_info, struct hg_test_bulk_pair *pair);
+
+static hg_return_t
+hg_test_bulk_pair_cleanup(struct hg_test_bulk_pair *pair);
+
+static hg_return_t
+hg_test_bulk_pair_expose(const struct hg_test_bulk_pair *pair,
+    hg_bulk_t origin_handle, hg_bulk_t *handle_p);
+
+static hg_return_t
+hg_test_bulk_pair_progress(const struct hg_test_bulk_pair *pair);
+
+static hg_return_t
+hg_test_bulk_pair_wait(const struct hg_test_bulk_pair *pair,
+    const int32_t *complete_count, int32_t expected_count);
+
+static hg_return_t
+hg_test_bulk_transfer_cb(const struct hg_cb_info *callback_info);
+
+static void
+hg_test_bulk_chunk_cb(void *arg, hg_size_t offset, hg_size_t size);
+
+static hg_return_t
+hg_test_bulk_desc_check(const struct hg_test_bulk_pair *pair,
+    hg_bulk_t origin_handle, unsigned long flags);
+
+static hg_return_t
+hg_test_bulk_desc(const hg_class_t *parent_class);
+
+static hg_return_t
+hg_test_bulk_pipelined(const hg_class_t *parent_class);
+
+static hg_return_t
+hg_test_bulk_coalesce(const hg_class_t *parent_class);
+
+static hg_return_t
+hg_test_bulk_file_backed(const hg_class_t *parent_class);
+
+static hg_return_t
+hg_test_bulk_stream(const hg_class_t *parent_class);
+
+static hg_return_t
+hg_test_bulk_flow_control(const hg_class_t *parent_class);
+
+static hg_return_t
+hg_test_bulk_atomic(const hg_class_t *parent_class);
+
+static hg_return_t
+hg_test_bulk_checksum(const hg_class_t *parent_class);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -240,6 +328,1318 @@ done:
     return HG_SUCCESS;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_pair_init(const hg_class_t *parent_class,
+    const struct hg_init_info *hg_init_info, struct hg_test_bulk_pair *pair)
+{
+    char info_string[64], addr_string[256];
+    hg_size_t addr_string_size = sizeof(addr_string);
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_return_t ret;
+
+    *pair = (struct hg_test_bulk_pair){.local_class = NULL,
+        .local_context = NULL,
+        .origin_class = NULL,
+        .origin_context = NULL,
+        .origin_addr = HG_ADDR_NULL};
+
+    snprintf(info_string, sizeof(info_string), "%s+%s",
+        HG_Class_get_name(parent_class), HG_Class_get_protocol(parent_class));
+
+    pair->local_class = HG_Init_opt2(info_string, HG_TRUE,
+        HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), hg_init_info);
+    HG_TEST_CHECK_ERROR(pair->local_class == NULL, error, ret, HG_FAULT,
+        "HG_Init_opt2() failed");
+
+    pair->local_context = HG_Context_create(pair->local_class);
+    HG_TEST_CHECK_ERROR(pair->local_context == NULL, error, ret, HG_FAULT,
+        "HG_Context_create() failed");
+
+    pair->origin_class = HG_Init_opt2(info_string, HG_TRUE,
+        HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), hg_init_info);
+    HG_TEST_CHECK_ERROR(pair->origin_class == NULL, error, ret, HG_FAULT,
+        "HG_Init_opt2() failed");
+
+    pair->origin_context = HG_Context_create(pair->origin_class);
+    HG_TEST_CHECK_ERROR(pair->origin_context == NULL, error, ret, HG_FAULT,
+        "HG_Context_create() failed");
+
+    /* Origin is not self for the local class */
+    ret = HG_Addr_self(pair->origin_class, &self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Addr_to_string(
+        pair->origin_class, addr_string, &addr_string_size, self_addr);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Addr_to_string() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Addr_free(pair->origin_class, self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_free() failed (%s)", HG_Error_to_string(ret));
+    self_addr = HG_ADDR_NULL;
+
+    ret = HG_Addr_lookup2(pair->local_class, addr_string, &pair->origin_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_lookup2() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    if (self_addr != HG_ADDR_NULL)
+        (void) HG_Addr_free(pair->origin_class, self_addr);
+    (void) hg_test_bulk_pair_cleanup(pair);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_pair_cleanup(struct hg_test_bulk_pair *pair)
+{
+    hg_return_t ret = HG_SUCCESS, cleanup_ret;
+
+    /* Release everything and report the first error */
+    if (pair->origin_addr != HG_ADDR_NULL) {
+        cleanup_ret = HG_Addr_free(pair->local_class, pair->origin_addr);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Addr_free() failed (%s)", HG_Error_to_string(cleanup_ret));
+        ret = (ret == HG_SUCCESS) ? cleanup_ret : ret;
+        pair->origin_addr = HG_ADDR_NULL;
+    }
+    if (pair->origin_context != NULL) {
+        cleanup_ret = HG_Context_destroy(pair->origin_context);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Context_destroy() failed (%s)",
+            HG_Error_to_string(cleanup_ret));
+        ret = (ret == HG_SUCCESS) ? cleanup_ret : ret;
+        pair->origin_context = NULL;
+    }
+    if (pair->origin_class != NULL) {
+        cleanup_ret = HG_Finalize(pair->origin_class);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Finalize() failed (%s)", HG_Error_to_string(cleanup_ret));
+        ret = (ret == HG_SUCCESS) ? cleanup_ret : ret;
+        pair->origin_class = NULL;
+    }
+    if (pair->local_context != NULL) {
+        cleanup_ret = HG_Context_destroy(pair->local_context);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Context_destroy() failed (%s)",
+            HG_Error_to_string(cleanup_ret));
+        ret = (ret == HG_SUCCESS) ? cleanup_ret : ret;
+        pair->local_context = NULL;
+    }
+    if (pair->local_class != NULL) {
+        cleanup_ret = HG_Finalize(pair->local_class);
+        HG_TEST_CHECK_ERROR_DONE(cleanup_ret != HG_SUCCESS,
+            "HG_Finalize() failed (%s)", HG_Error_to_string(cleanup_ret));
+        ret = (ret == HG_SUCCESS) ? cleanup_ret : ret;
+        pair->local_class = NULL;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_pair_expose(const struct hg_test_bulk_pair *pair,
+    hg_bulk_t origin_handle, hg_bulk_t *handle_p)
+{
+    hg_size_t buf_size;
+    void *buf = NULL;
+    hg_return_t ret;
+
+    /* Origin handle as received by local class */
+    buf_size = HG_Bulk_get_serialize_size(origin_handle, 0);
+    HG_TEST_CHECK_ERROR(buf_size == 0, error, ret, HG_FAULT,
+        "HG_Bulk_get_serialize_size() failed");
+
+    buf = malloc((size_t) buf_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+
+    ret = HG_Bulk_serialize(buf, buf_size, 0, origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_serialize() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Bulk_deserialize(pair->local_class, handle_p, buf, buf_size);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_deserialize() failed (%s)",
+        HG_Error_to_string(ret));
+
+    free(buf);
+
+    return HG_SUCCESS;
+
+error:
+    free(buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_pair_progress(const struct hg_test_bulk_pair *pair)
+{
+    unsigned int actual_count = 0;
+    hg_return_t ret;
+
+    /* Origin only needs to make progress on its side of transfers */
+    ret = HG_Progress(pair->origin_context, 0);
+    HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error, ret,
+        ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Progress(pair->local_context, 10);
+    HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error, ret,
+        ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+
+    do {
+        ret = HG_Trigger(pair->local_context, 0, 1, &actual_count);
+    } while (ret == HG_SUCCESS && actual_count);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_pair_wait(const struct hg_test_bulk_pair *pair,
+    const int32_t *complete_count, int32_t expected_count)
+{
+    hg_time_t deadline, now;
+    hg_return_t ret;
+
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(HG_TEST_WAIT_TIMEOUT));
+    while (*complete_count < expected_count && hg_time_less(now, deadline)) {
+        ret = hg_test_bulk_pair_progress(pair);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "hg_test_bulk_pair_progress() failed (%s)",
+            HG_Error_to_string(ret));
+
+        hg_time_get_current_ms(&now);
+    }
+    HG_TEST_CHECK_ERROR(*complete_count < expected_count, error, ret,
+        HG_TIMEOUT, "Timed out waiting for transfers");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_transfer_cb(const struct hg_cb_info *callback_info)
+{
+    struct transfer_cb_args *args =
+        (struct transfer_cb_args *) callback_info->arg;
+
+    args->info = callback_info->info.bulk;
+    args->ret = callback_info->ret;
+    args->rank = (*args->complete_count)++;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_test_bulk_chunk_cb(void *arg, hg_size_t offset, hg_size_t size)
+{
+    struct chunk_cb_args *args = (struct chunk_cb_args *) arg;
+
+    if (args->count < HG_TEST_BULK_CHUNK_COUNT) {
+        args->offsets[args->count] = offset;
+        args->sizes[args->count] = size;
+    }
+    args->count++;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_desc_check(const struct hg_test_bulk_pair *pair,
+    hg_bulk_t origin_handle, unsigned long flags)
+{
+    void *origin_ptrs[HG_TEST_BULK_SEGMENT_COUNT],
+        *ptrs[HG_TEST_BULK_SEGMENT_COUNT];
+    hg_size_t origin_sizes[HG_TEST_BULK_SEGMENT_COUNT],
+        sizes[HG_TEST_BULK_SEGMENT_COUNT];
+    hg_uint32_t origin_count = 0, count = 0, i;
+    hg_bulk_t handles[2] = {HG_BULK_NULL, HG_BULK_NULL};
+    hg_bulk_t corrupt_handle = HG_BULK_NULL;
+    hg_size_t size = HG_Bulk_get_size(origin_handle), buf_size,
+              truncated_sizes[3];
+    char *buf = NULL, *corrupt_buf = NULL;
+    hg_return_t ret;
+
+    buf_size = HG_Bulk_get_serialize_size(origin_handle, flags);
+    HG_TEST_CHECK_ERROR(buf_size < 12, error, ret, HG_FAULT,
+        "HG_Bulk_get_serialize_size() returned %" PRIu64 " bytes", buf_size);
+
+    buf = (char *) malloc((size_t) buf_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    corrupt_buf = (char *) malloc((size_t) buf_size);
+    HG_TEST_CHECK_ERROR(
+        corrupt_buf == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+
+    ret = HG_Bulk_serialize(buf, buf_size, flags, origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_serialize() failed (%s)", HG_Error_to_string(ret));
+
+    /* Truncated descriptors must be rejected */
+    truncated_sizes[0] = 1;
+    truncated_sizes[1] = buf_size / 2;
+    truncated_sizes[2] = buf_size - 1;
+    for (i = 0; i < 3; i++) {
+        ret = HG_Bulk_deserialize(
+            pair->local_class, &corrupt_handle, buf, truncated_sizes[i]);
+        HG_TEST_CHECK_ERROR(ret == HG_SUCCESS, error, ret, HG_FAULT,
+            "Descriptor truncated to %" PRIu64 " of %" PRIu64
+            " bytes was accepted",
+            truncated_sizes[i], buf_size);
+    }
+
+    /* Segment count that never ends (more than 10 bytes of varint) */
+    memcpy(corrupt_buf, buf, (size_t) buf_size);
+    memset(corrupt_buf + 1, 0xff, 11);
+    ret = HG_Bulk_deserialize(
+        pair->local_class, &corrupt_handle, corrupt_buf, buf_size);
+    HG_TEST_CHECK_ERROR(ret == HG_SUCCESS, error, ret, HG_FAULT,
+        "Descriptor with corrupt segment count was accepted");
+
+    /* Deserialize twice, second time is served from descriptor cache */
+    for (i = 0; i < 2; i++) {
+        ret =
+            HG_Bulk_deserialize(pair->local_class, &handles[i], buf, buf_size);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_deserialize() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+    HG_TEST_CHECK_ERROR((handles[0] == handles[1]) == !!(flags & HG_BULK_EAGER),
+        error, ret, HG_FAULT, "Unexpected descriptor cache %s",
+        (handles[0] == handles[1]) ? "hit" : "miss");
+
+    HG_TEST_CHECK_ERROR(HG_Bulk_get_size(handles[0]) != size, error, ret,
+        HG_FAULT, "Deserialized size is %" PRIu64 ", expected %" PRIu64,
+        HG_Bulk_get_size(handles[0]), size);
+
+    ret = HG_Bulk_access(origin_handle, 0, size, HG_BULK_READ_ONLY,
+        HG_TEST_BULK_SEGMENT_COUNT, origin_ptrs, origin_sizes, &origin_count);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_access() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Bulk_access(handles[0], 0, size, HG_BULK_READ_ONLY,
+        HG_TEST_BULK_SEGMENT_COUNT, ptrs, sizes, &count);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_access() failed (%s)", HG_Error_to_string(ret));
+
+    HG_TEST_CHECK_ERROR(count != origin_count, error, ret, HG_FAULT,
+        "Deserialized %" PRIu32 " segments, expected %" PRIu32, count,
+        origin_count);
+
+    /* Eager descriptors carry a copy of the data */
+    for (i = 0; i < count; i++) {
+        HG_TEST_CHECK_ERROR(sizes[i] != origin_sizes[i], error, ret, HG_FAULT,
+            "Segment %" PRIu32 " size is %" PRIu64 ", expected %" PRIu64, i,
+            sizes[i], origin_sizes[i]);
+        HG_TEST_CHECK_ERROR((ptrs[i] == origin_ptrs[i]) ==
+                                !!(flags & HG_BULK_EAGER),
+            error, ret, HG_FAULT, "Unexpected address of segment %" PRIu32, i);
+        HG_TEST_CHECK_ERROR(
+            memcmp(ptrs[i], origin_ptrs[i], (size_t) sizes[i]) != 0, error,
+            ret, HG_FAULT, "Data of segment %" PRIu32 " differs", i);
+    }
+
+    for (i = 0; i < 2; i++) {
+        ret = HG_Bulk_free(handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+        handles[i] = HG_BULK_NULL;
+    }
+
+    free(corrupt_buf);
+    free(buf);
+
+    return HG_SUCCESS;
+
+error:
+    for (i = 0; i < 2; i++)
+        if (handles[i] != HG_BULK_NULL)
+            (void) HG_Bulk_free(handles[i]);
+    if (corrupt_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(corrupt_handle);
+    free(corrupt_buf);
+    free(buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_desc(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_test_bulk_pair pair;
+    void *buf_ptrs[HG_TEST_BULK_SEGMENT_COUNT];
+    hg_size_t buf_sizes[HG_TEST_BULK_SEGMENT_COUNT];
+    hg_bulk_t handle = HG_BULK_NULL;
+    char *buf = NULL, *file_buf = NULL;
+    size_t i;
+    hg_return_t ret;
+
+    /* File-backed handles are cut into contiguous segments */
+    hg_init_info.bulk_chunk_size = HG_TEST_BULK_SEGMENT_SIZE;
+    hg_init_info.bulk_desc_cache_max = 4;
+    ret = hg_test_bulk_pair_init(parent_class, &hg_init_info, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Segments with gaps between them are not coalesced */
+    buf = (char *) malloc(2 * HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    for (i = 0; i < 2 * HG_TEST_BULK_SIZE; i++)
+        buf[i] = (char) i;
+    for (i = 0; i < HG_TEST_BULK_SEGMENT_COUNT; i++) {
+        buf_ptrs[i] = buf + 2 * i * HG_TEST_BULK_SEGMENT_SIZE;
+        buf_sizes[i] = HG_TEST_BULK_SEGMENT_SIZE;
+    }
+
+    ret = HG_Bulk_create(pair.origin_class, HG_TEST_BULK_SEGMENT_COUNT,
+        buf_ptrs, buf_sizes, HG_BULK_READ_ONLY, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_desc_check(&pair, handle, 0);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_desc_check() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_desc_check(&pair, handle, HG_BULK_EAGER);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_desc_check() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Bulk_free(handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    handle = HG_BULK_NULL;
+
+    /* Contiguous segments only share a base address in the descriptor */
+    file_buf = (char *) hg_mem_aligned_alloc(
+        (size_t) hg_mem_get_page_size(), HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        file_buf == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    memcpy(file_buf, buf, HG_TEST_BULK_SIZE);
+    buf_ptrs[0] = file_buf;
+    buf_sizes[0] = HG_TEST_BULK_SIZE;
+
+    ret = HG_Bulk_create_attr(pair.origin_class, 1, buf_ptrs, buf_sizes,
+        HG_BULK_READWRITE,
+        &(struct hg_bulk_attr){.mem_type = HG_MEM_TYPE_HOST,
+            .device = 0,
+            .file_backed = HG_TRUE},
+        &handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_create_attr() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(
+        HG_Bulk_get_segment_count(handle) != HG_TEST_BULK_SEGMENT_COUNT, error,
+        ret, HG_FAULT, "File-backed handle has %" PRIu32 " segments",
+        HG_Bulk_get_segment_count(handle));
+
+    ret = hg_test_bulk_desc_check(&pair, handle, 0);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_desc_check() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Bulk_free(handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    handle = HG_BULK_NULL;
+
+    hg_mem_aligned_free(file_buf);
+    file_buf = NULL;
+    free(buf);
+    buf = NULL;
+
+    ret = hg_test_bulk_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_test_bulk_pair_cleanup() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    if (handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(handle);
+    if (file_buf != NULL)
+        hg_mem_aligned_free(file_buf);
+    free(buf);
+    (void) hg_test_bulk_pair_cleanup(&pair);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_pipelined(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_test_bulk_pair pair;
+    struct chunk_cb_args chunk_args = {.count = 0};
+    int32_t complete_count = 0;
+    struct transfer_cb_args cb_args = {
+        .ret = HG_OTHER_ERROR, .rank = -1, .complete_count = &complete_count};
+    hg_bulk_t origin_handle = HG_BULK_NULL, remote_handle = HG_BULK_NULL,
+              local_handle = HG_BULK_NULL;
+    hg_size_t size = HG_TEST_BULK_SIZE;
+    char *src = NULL, *dst = NULL;
+    size_t i;
+    hg_return_t ret;
+
+    /* A single chunk in flight at a time, chunks then complete in order */
+    hg_init_info.bulk_chunk_size = HG_TEST_BULK_CHUNK_SIZE;
+    hg_init_info.bulk_max_inflight = 1;
+    ret = hg_test_bulk_pair_init(parent_class, &hg_init_info, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    src = (char *) malloc(HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        src == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    for (i = 0; i < HG_TEST_BULK_SIZE; i++)
+        src[i] = (char) i;
+    dst = (char *) calloc(1, HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        dst == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+
+    ret = HG_Bulk_create(pair.origin_class, 1, (void **) &src, &size,
+        HG_BULK_READ_ONLY, &origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_expose(&pair, origin_handle, &remote_handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_expose() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Bulk_create(pair.local_class, 1, (void **) &dst, &size,
+        HG_BULK_WRITE_ONLY, &local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Bulk_transfer_pipelined(pair.local_context,
+        hg_test_bulk_transfer_cb, &cb_args, hg_test_bulk_chunk_cb, &chunk_args,
+        HG_BULK_PULL, pair.origin_addr, 0, remote_handle, 0, local_handle, 0,
+        size, HG_OP_ID_IGNORE);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "HG_Bulk_transfer_pipelined() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_wait(&pair, &complete_count, 1);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = cb_args.ret;
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(cb_args.info.size != size, error, ret, HG_FAULT,
+        "Transferred %" PRIu64 " bytes, expected %" PRIu64, cb_args.info.size,
+        size);
+
+    HG_TEST_CHECK_ERROR(chunk_args.count != HG_TEST_BULK_CHUNK_COUNT, error,
+        ret, HG_FAULT, "Received %u chunk callbacks, expected %d",
+        chunk_args.count, HG_TEST_BULK_CHUNK_COUNT);
+    for (i = 0; i < HG_TEST_BULK_CHUNK_COUNT; i++)
+        HG_TEST_CHECK_ERROR(
+            chunk_args.offsets[i] != i * HG_TEST_BULK_CHUNK_SIZE ||
+                chunk_args.sizes[i] != HG_TEST_BULK_CHUNK_SIZE,
+            error, ret, HG_FAULT,
+            "Chunk %zu has offset %" PRIu64 " and size %" PRIu64, i,
+            chunk_args.offsets[i], chunk_args.sizes[i]);
+
+    HG_TEST_CHECK_ERROR(memcmp(src, dst, HG_TEST_BULK_SIZE) != 0, error, ret,
+        HG_FAULT, "Transferred data differs");
+
+    ret = HG_Bulk_free(local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    local_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(remote_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    remote_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    origin_handle = HG_BULK_NULL;
+
+    ret = hg_test_bulk_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_test_bulk_pair_cleanup() failed (%s)", HG_Error_to_string(ret));
+
+    free(dst);
+    free(src);
+
+    return HG_SUCCESS;
+
+error:
+    if (local_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(local_handle);
+    if (remote_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(remote_handle);
+    if (origin_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(origin_handle);
+    (void) hg_test_bulk_pair_cleanup(&pair);
+    free(dst);
+    free(src);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_coalesce(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_test_bulk_pair pair;
+    int32_t complete_count = 0;
+    struct transfer_cb_args cb_args = {
+        .ret = HG_OTHER_ERROR, .rank = -1, .complete_count = &complete_count};
+    /* First two local segments are adjacent, others are not */
+    const size_t dst_offsets[HG_TEST_BULK_SEGMENT_COUNT] = {0, 1, 3, 5};
+    void *buf_ptrs[HG_TEST_BULK_SEGMENT_COUNT];
+    hg_size_t buf_sizes[HG_TEST_BULK_SEGMENT_COUNT];
+    hg_bulk_t origin_handle = HG_BULK_NULL, remote_handle = HG_BULK_NULL,
+              local_handle = HG_BULK_NULL;
+    char *src = NULL, *dst = NULL;
+    size_t i;
+    hg_return_t ret;
+
+    ret = hg_test_bulk_pair_init(parent_class, &hg_init_info, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    src = (char *) malloc(HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        src == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    for (i = 0; i < HG_TEST_BULK_SIZE; i++)
+        src[i] = (char) i;
+    dst = (char *) calloc(2, HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        dst == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+
+    /* Adjacent slices of one buffer are exposed as a single segment */
+    for (i = 0; i < HG_TEST_BULK_SEGMENT_COUNT; i++) {
+        buf_ptrs[i] = src + i * HG_TEST_BULK_SEGMENT_SIZE;
+        buf_sizes[i] = HG_TEST_BULK_SEGMENT_SIZE;
+    }
+    ret = HG_Bulk_create(pair.origin_class, HG_TEST_BULK_SEGMENT_COUNT,
+        buf_ptrs, buf_sizes, HG_BULK_READ_ONLY, &origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(HG_Bulk_get_segment_count(origin_handle) != 1, error,
+        ret, HG_FAULT, "Adjacent slices were exposed as %" PRIu32 " segments",
+        HG_Bulk_get_segment_count(origin_handle));
+
+    ret = hg_test_bulk_pair_expose(&pair, origin_handle, &remote_handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_expose() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(HG_Bulk_get_segment_count(remote_handle) != 1, error,
+        ret, HG_FAULT, "Descriptor has %" PRIu32 " segments",
+        HG_Bulk_get_segment_count(remote_handle));
+
+    for (i = 0; i < HG_TEST_BULK_SEGMENT_COUNT; i++)
+        buf_ptrs[i] = dst + dst_offsets[i] * HG_TEST_BULK_SEGMENT_SIZE;
+    ret = HG_Bulk_create(pair.local_class, HG_TEST_BULK_SEGMENT_COUNT,
+        buf_ptrs, buf_sizes, HG_BULK_WRITE_ONLY, &local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(HG_Bulk_get_segment_count(local_handle) !=
+                            HG_TEST_BULK_SEGMENT_COUNT - 1,
+        error, ret, HG_FAULT, "Local handle has %" PRIu32 " segments",
+        HG_Bulk_get_segment_count(local_handle));
+
+    ret = HG_Bulk_transfer(pair.local_context, hg_test_bulk_transfer_cb,
+        &cb_args, HG_BULK_PULL, pair.origin_addr, remote_handle, 0,
+        local_handle, 0, HG_TEST_BULK_SIZE, HG_OP_ID_IGNORE);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_transfer() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_wait(&pair, &complete_count, 1);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = cb_args.ret;
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < HG_TEST_BULK_SEGMENT_COUNT; i++)
+        HG_TEST_CHECK_ERROR(memcmp(buf_ptrs[i],
+                                src + i * HG_TEST_BULK_SEGMENT_SIZE,
+                                HG_TEST_BULK_SEGMENT_SIZE) != 0,
+            error, ret, HG_FAULT, "Data of segment %zu differs", i);
+
+    ret = HG_Bulk_free(local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    local_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(remote_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    remote_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    origin_handle = HG_BULK_NULL;
+
+    ret = hg_test_bulk_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_test_bulk_pair_cleanup() failed (%s)", HG_Error_to_string(ret));
+
+    free(dst);
+    free(src);
+
+    return HG_SUCCESS;
+
+error:
+    if (local_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(local_handle);
+    if (remote_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(remote_handle);
+    if (origin_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(origin_handle);
+    (void) hg_test_bulk_pair_cleanup(&pair);
+    free(dst);
+    free(src);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_file_backed(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_test_bulk_pair pair;
+    int32_t complete_count = 0;
+    struct transfer_cb_args cb_args[2] = {
+        {.ret = HG_OTHER_ERROR, .rank = -1, .complete_count = &complete_count},
+        {.ret = HG_OTHER_ERROR, .rank = -1, .complete_count = &complete_count}};
+    hg_bulk_t origin_handles[2] = {HG_BULK_NULL, HG_BULK_NULL},
+              remote_handles[2] = {HG_BULK_NULL, HG_BULK_NULL},
+              local_handle = HG_BULK_NULL;
+    hg_size_t size = HG_TEST_BULK_SIZE;
+    char *src = NULL, *dst = NULL, *file_buf = NULL;
+    size_t i;
+    hg_return_t ret;
+
+    /* File-backed handles are registered chunk by chunk */
+    hg_init_info.bulk_chunk_size = HG_TEST_BULK_CHUNK_SIZE;
+    hg_init_info.bulk_max_inflight = 2;
+    ret = hg_test_bulk_pair_init(parent_class, &hg_init_info, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    src = (char *) malloc(HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        src == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    for (i = 0; i < HG_TEST_BULK_SIZE; i++)
+        src[i] = (char) i;
+    dst = (char *) calloc(1, HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        dst == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+
+    /* Any page-aligned host memory can stand in for a file mapping */
+    file_buf = (char *) hg_mem_aligned_alloc(
+        (size_t) hg_mem_get_page_size(), HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        file_buf == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    memset(file_buf, 0, HG_TEST_BULK_SIZE);
+
+    ret = HG_Bulk_create(pair.origin_class, 1, (void **) &src, &size,
+        HG_BULK_READ_ONLY, &origin_handles[0]);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+    ret = HG_Bulk_create(pair.origin_class, 1, (void **) &dst, &size,
+        HG_BULK_WRITE_ONLY, &origin_handles[1]);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < 2; i++) {
+        ret = hg_test_bulk_pair_expose(
+            &pair, origin_handles[i], &remote_handles[i]);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "hg_test_bulk_pair_expose() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    ret = HG_Bulk_create_attr(pair.local_class, 1, (void **) &file_buf, &size,
+        HG_BULK_READWRITE,
+        &(struct hg_bulk_attr){.mem_type = HG_MEM_TYPE_HOST,
+            .device = 0,
+            .file_backed = HG_TRUE},
+        &local_handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_create_attr() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(
+        HG_Bulk_get_segment_count(local_handle) != HG_TEST_BULK_CHUNK_COUNT,
+        error, ret, HG_FAULT, "File-backed handle has %" PRIu32 " segments",
+        HG_Bulk_get_segment_count(local_handle));
+
+    /* Read into the file mapping, then write it back out */
+    ret = HG_Bulk_transfer(pair.local_context, hg_test_bulk_transfer_cb,
+        &cb_args[0], HG_BULK_PULL, pair.origin_addr, remote_handles[0], 0,
+        local_handle, 0, size, HG_OP_ID_IGNORE);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_transfer() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_wait(&pair, &complete_count, 1);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = cb_args[0].ret;
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(memcmp(src, file_buf, HG_TEST_BULK_SIZE) != 0, error,
+        ret, HG_FAULT, "Data read into file-backed handle differs");
+
+    ret = HG_Bulk_transfer(pair.local_context, hg_test_bulk_transfer_cb,
+        &cb_args[1], HG_BULK_PUSH, pair.origin_addr, remote_handles[1], 0,
+        local_handle, 0, size, HG_OP_ID_IGNORE);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_transfer() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_wait(&pair, &complete_count, 2);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = cb_args[1].ret;
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(memcmp(src, dst, HG_TEST_BULK_SIZE) != 0, error, ret,
+        HG_FAULT, "Data written from file-backed handle differs");
+
+    ret = HG_Bulk_free(local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    local_handle = HG_BULK_NULL;
+
+    for (i = 0; i < 2; i++) {
+        ret = HG_Bulk_free(remote_handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+        remote_handles[i] = HG_BULK_NULL;
+
+        ret = HG_Bulk_free(origin_handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+        origin_handles[i] = HG_BULK_NULL;
+    }
+
+    ret = hg_test_bulk_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_test_bulk_pair_cleanup() failed (%s)", HG_Error_to_string(ret));
+
+    hg_mem_aligned_free(file_buf);
+    free(dst);
+    free(src);
+
+    return HG_SUCCESS;
+
+error:
+    if (local_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(local_handle);
+    for (i = 0; i < 2; i++) {
+        if (remote_handles[i] != HG_BULK_NULL)
+            (void) HG_Bulk_free(remote_handles[i]);
+        if (origin_handles[i] != HG_BULK_NULL)
+            (void) HG_Bulk_free(origin_handles[i]);
+    }
+    (void) hg_test_bulk_pair_cleanup(&pair);
+    if (file_buf != NULL)
+        hg_mem_aligned_free(file_buf);
+    free(dst);
+    free(src);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_stream(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_test_bulk_pair pair;
+    hg_bulk_t origin_handle = HG_BULK_NULL, remote_handle = HG_BULK_NULL;
+    hg_bulk_stream_t stream = NULL;
+    /* Stream does not start at the beginning nor end on a chunk boundary */
+    hg_size_t size = HG_TEST_BULK_SIZE, offset = 100,
+              stream_size = HG_TEST_BULK_SIZE - 300, received = 0;
+    unsigned int chunk_count = 0;
+    hg_time_t deadline, now;
+    char *src = NULL;
+    size_t i;
+    hg_return_t ret;
+
+    ret = hg_test_bulk_pair_init(parent_class, &hg_init_info, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    src = (char *) malloc(HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        src == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    for (i = 0; i < HG_TEST_BULK_SIZE; i++)
+        src[i] = (char) i;
+
+    ret = HG_Bulk_create(pair.origin_class, 1, (void **) &src, &size,
+        HG_BULK_READ_ONLY, &origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_expose(&pair, origin_handle, &remote_handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_expose() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Bulk_stream_create(pair.local_context, pair.origin_addr, 0,
+        remote_handle, offset, stream_size, HG_TEST_BULK_CHUNK_SIZE, 2,
+        &stream);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_stream_create() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Chunks are returned in order until the end of the stream */
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(HG_TEST_WAIT_TIMEOUT));
+    for (;;) {
+        hg_size_t chunk_size = 0;
+        void *chunk = NULL;
+
+        ret = HG_Bulk_stream_next_chunk(stream, &chunk, &chunk_size);
+        if (ret == HG_AGAIN) {
+            HG_TEST_CHECK_ERROR(hg_time_less(deadline, now), error, ret,
+                HG_TIMEOUT, "Timed out waiting for chunk %u", chunk_count);
+
+            ret = hg_test_bulk_pair_progress(&pair);
+            HG_TEST_CHECK_HG_ERROR(error, ret,
+                "hg_test_bulk_pair_progress() failed (%s)",
+                HG_Error_to_string(ret));
+
+            hg_time_get_current_ms(&now);
+            continue;
+        }
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Bulk_stream_next_chunk() failed (%s)", HG_Error_to_string(ret));
+        if (chunk == NULL)
+            break;
+
+        HG_TEST_CHECK_ERROR(chunk_size != HG_TEST_BULK_CHUNK_SIZE &&
+                                chunk_size != stream_size - received,
+            error, ret, HG_FAULT, "Chunk %u has size %" PRIu64, chunk_count,
+            chunk_size);
+        HG_TEST_CHECK_ERROR(
+            memcmp(chunk, src + offset + received, (size_t) chunk_size) != 0,
+            error, ret, HG_FAULT, "Data of chunk %u differs", chunk_count);
+        received += chunk_size;
+        chunk_count++;
+    }
+    HG_TEST_CHECK_ERROR(received != stream_size, error, ret, HG_FAULT,
+        "Stream ended after %" PRIu64 " bytes, expected %" PRIu64, received,
+        stream_size);
+    HG_TEST_CHECK_ERROR(
+        chunk_count != (stream_size - 1) / HG_TEST_BULK_CHUNK_SIZE + 1, error,
+        ret, HG_FAULT, "Stream returned %u chunks", chunk_count);
+
+    ret = HG_Bulk_stream_destroy(stream);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_stream_destroy() failed (%s)",
+        HG_Error_to_string(ret));
+    stream = NULL;
+
+    ret = HG_Bulk_free(remote_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    remote_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    origin_handle = HG_BULK_NULL;
+
+    ret = hg_test_bulk_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_test_bulk_pair_cleanup() failed (%s)", HG_Error_to_string(ret));
+
+    free(src);
+
+    return HG_SUCCESS;
+
+error:
+    if (stream != NULL)
+        (void) HG_Bulk_stream_destroy(stream);
+    if (remote_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(remote_handle);
+    if (origin_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(origin_handle);
+    (void) hg_test_bulk_pair_cleanup(&pair);
+    free(src);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_flow_control(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_test_bulk_pair pair;
+    int32_t complete_count = 0, last_rank = -1;
+    struct transfer_cb_args cb_args[HG_TEST_BULK_SEGMENT_COUNT];
+    hg_op_id_t op_ids[HG_TEST_BULK_SEGMENT_COUNT];
+    hg_bulk_t origin_handle = HG_BULK_NULL, remote_handle = HG_BULK_NULL,
+              local_handle = HG_BULK_NULL;
+    hg_size_t size = HG_TEST_BULK_SIZE;
+    char *src = NULL, *dst = NULL;
+    size_t i;
+    hg_return_t ret;
+
+    /* Room for a single segment transfer at a time */
+    hg_init_info.bulk_max_inflight_size = HG_TEST_BULK_SEGMENT_SIZE;
+    ret = hg_test_bulk_pair_init(parent_class, &hg_init_info, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    src = (char *) malloc(HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        src == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    for (i = 0; i < HG_TEST_BULK_SIZE; i++)
+        src[i] = (char) i;
+    dst = (char *) calloc(1, HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        dst == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+
+    ret = HG_Bulk_create(pair.origin_class, 1, (void **) &src, &size,
+        HG_BULK_READ_ONLY, &origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_expose(&pair, origin_handle, &remote_handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_expose() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Bulk_create(pair.local_class, 1, (void **) &dst, &size,
+        HG_BULK_WRITE_ONLY, &local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Transfers past the first one are queued */
+    for (i = 0; i < HG_TEST_BULK_SEGMENT_COUNT; i++) {
+        cb_args[i] = (struct transfer_cb_args){.ret = HG_OTHER_ERROR,
+            .rank = -1,
+            .complete_count = &complete_count};
+
+        ret = HG_Bulk_transfer(pair.local_context, hg_test_bulk_transfer_cb,
+            &cb_args[i], HG_BULK_PULL, pair.origin_addr, remote_handle,
+            i * HG_TEST_BULK_SEGMENT_SIZE, local_handle,
+            i * HG_TEST_BULK_SEGMENT_SIZE, HG_TEST_BULK_SEGMENT_SIZE,
+            &op_ids[i]);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_transfer() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+    /* Canceling a queued transfer removes it from the queue */
+    ret = HG_Bulk_cancel(op_ids[2]);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_cancel() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_wait(
+        &pair, &complete_count, HG_TEST_BULK_SEGMENT_COUNT);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Remaining transfers of a single origin are started in order */
+    for (i = 0; i < HG_TEST_BULK_SEGMENT_COUNT; i++) {
+        const char *seg_dst = dst + i * HG_TEST_BULK_SEGMENT_SIZE;
+        size_t j;
+
+        if (i == 2) {
+            HG_TEST_CHECK_ERROR(cb_args[i].ret != HG_CANCELED, error, ret,
+                HG_FAULT, "Queued transfer was not canceled (%s)",
+                HG_Error_to_string(cb_args[i].ret));
+            for (j = 0; j < HG_TEST_BULK_SEGMENT_SIZE; j++)
+                HG_TEST_CHECK_ERROR(seg_dst[j] != 0, error, ret, HG_FAULT,
+                    "Canceled transfer wrote data");
+            continue;
+        }
+
+        ret = cb_args[i].ret;
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+        HG_TEST_CHECK_ERROR(cb_args[i].rank <= last_rank, error, ret,
+            HG_FAULT, "Transfer %zu completed out of order", i);
+        last_rank = cb_args[i].rank;
+        HG_TEST_CHECK_ERROR(memcmp(seg_dst, src + i * HG_TEST_BULK_SEGMENT_SIZE,
+                                HG_TEST_BULK_SEGMENT_SIZE) != 0,
+            error, ret, HG_FAULT, "Data of transfer %zu differs", i);
+    }
+
+    ret = HG_Bulk_free(local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    local_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(remote_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    remote_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    origin_handle = HG_BULK_NULL;
+
+    ret = hg_test_bulk_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_test_bulk_pair_cleanup() failed (%s)", HG_Error_to_string(ret));
+
+    free(dst);
+    free(src);
+
+    return HG_SUCCESS;
+
+error:
+    if (local_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(local_handle);
+    if (remote_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(remote_handle);
+    if (origin_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(origin_handle);
+    (void) hg_test_bulk_pair_cleanup(&pair);
+    free(dst);
+    free(src);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_atomic(const hg_class_t *parent_class)
+{
+    /* Operations are applied in sequence, failed CAS leaves value as is */
+    const struct {
+        hg_bulk_atomic_op_t op;
+        hg_size_t offset;
+        hg_uint64_t operand;
+        hg_uint64_t compare;
+        hg_uint64_t result;
+    } ops[] = {{HG_BULK_ATOMIC_FETCH_ADD, 0, 3, 0, 5},
+        {HG_BULK_ATOMIC_CAS, 0, 42, 8, 8}, {HG_BULK_ATOMIC_CAS, 0, 1, 8, 42},
+        {HG_BULK_ATOMIC_FETCH_ADD, sizeof(hg_uint64_t), 7, 0, 0}};
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_test_bulk_pair pair;
+    hg_uint64_t values[2] = {5, 0};
+    void *buf_ptr = values;
+    hg_size_t size = sizeof(values);
+    int32_t complete_count = 0;
+    hg_bulk_t origin_handle = HG_BULK_NULL, remote_handle = HG_BULK_NULL;
+    size_t i;
+    hg_return_t ret;
+
+    ret = hg_test_bulk_pair_init(parent_class, &hg_init_info, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Bulk_create(pair.origin_class, 1, &buf_ptr, &size,
+        HG_BULK_READWRITE, &origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_expose(&pair, origin_handle, &remote_handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_expose() failed (%s)",
+        HG_Error_to_string(ret));
+
+    for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+        struct transfer_cb_args cb_args = {.ret = HG_OTHER_ERROR,
+            .rank = -1,
+            .complete_count = &complete_count};
+
+        ret = HG_Bulk_atomic(pair.local_context, hg_test_bulk_transfer_cb,
+            &cb_args, ops[i].op, pair.origin_addr, remote_handle,
+            ops[i].offset, ops[i].operand, ops[i].compare, HG_OP_ID_IGNORE);
+        HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Bulk_atomic() failed (%s)",
+            HG_Error_to_string(ret));
+
+        ret = hg_test_bulk_pair_wait(&pair, &complete_count, (int32_t) i + 1);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "hg_test_bulk_pair_wait() failed (%s)", HG_Error_to_string(ret));
+
+        ret = cb_args.ret;
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+        HG_TEST_CHECK_ERROR(cb_args.info.result != ops[i].result, error, ret,
+            HG_FAULT, "Operation %zu returned %" PRIu64 ", expected %" PRIu64,
+            i, cb_args.info.result, ops[i].result);
+    }
+    HG_TEST_CHECK_ERROR(values[0] != 42 || values[1] != 7, error, ret, HG_FAULT,
+        "Values are %" PRIu64 " and %" PRIu64 ", expected 42 and 7",
+        values[0], values[1]);
+
+    ret = HG_Bulk_free(remote_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    remote_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    origin_handle = HG_BULK_NULL;
+
+    ret = hg_test_bulk_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_test_bulk_pair_cleanup() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    if (remote_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(remote_handle);
+    if (origin_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(origin_handle);
+    (void) hg_test_bulk_pair_cleanup(&pair);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_checksum(const hg_class_t *parent_class)
+{
+    /* Second transfer starts and ends in the middle of chunks */
+    const hg_size_t offsets[2] = {0, HG_TEST_BULK_CHUNK_SIZE / 2},
+                    sizes[2] = {HG_TEST_BULK_SIZE,
+                        HG_TEST_BULK_SIZE - HG_TEST_BULK_CHUNK_SIZE};
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_test_bulk_pair pair;
+    struct hg_bulk_transfer_stats stats;
+    struct hg_bulk_transfer_opt opt = {.chunk_callback = NULL,
+        .chunk_arg = NULL,
+        .stats = &stats,
+        .timeout_ms = 0,
+        .checksum = HG_TRUE};
+    int32_t complete_count = 0;
+    hg_bulk_t origin_handle = HG_BULK_NULL, remote_handle = HG_BULK_NULL,
+              local_handle = HG_BULK_NULL;
+    hg_size_t size = HG_TEST_BULK_SIZE;
+    char *src = NULL, *dst = NULL;
+    size_t i;
+    hg_return_t ret;
+
+    /* Checksums of chunks are combined */
+    hg_init_info.bulk_chunk_size = HG_TEST_BULK_CHUNK_SIZE;
+    hg_init_info.bulk_max_inflight = 2;
+    ret = hg_test_bulk_pair_init(parent_class, &hg_init_info, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    src = (char *) malloc(HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        src == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+    for (i = 0; i < HG_TEST_BULK_SIZE; i++)
+        src[i] = (char) i;
+    dst = (char *) calloc(1, HG_TEST_BULK_SIZE);
+    HG_TEST_CHECK_ERROR(
+        dst == NULL, error, ret, HG_NOMEM, "Could not allocate buffer");
+
+    ret = HG_Bulk_create(pair.origin_class, 1, (void **) &src, &size,
+        HG_BULK_READ_ONLY, &origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_bulk_pair_expose(&pair, origin_handle, &remote_handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_bulk_pair_expose() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Bulk_create(pair.local_class, 1, (void **) &dst, &size,
+        HG_BULK_WRITE_ONLY, &local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_create() failed (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < 2; i++) {
+        struct transfer_cb_args cb_args = {.ret = HG_OTHER_ERROR,
+            .rank = -1,
+            .complete_count = &complete_count};
+        /* Checksum that origin computed before sending its data */
+        hg_uint32_t expected_crc =
+            hg_crc32c(0, src + offsets[i], (size_t) sizes[i]);
+
+        /* Corrupt second transfer after origin computed its checksum */
+        if (i == 1)
+            src[HG_TEST_BULK_SIZE / 2]++;
+
+        ret = HG_Bulk_transfer_opt(pair.local_context,
+            hg_test_bulk_transfer_cb, &cb_args, HG_BULK_PULL, pair.origin_addr,
+            0, remote_handle, offsets[i], local_handle, offsets[i], sizes[i],
+            &opt, HG_OP_ID_IGNORE);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Bulk_transfer_opt() failed (%s)", HG_Error_to_string(ret));
+
+        ret = hg_test_bulk_pair_wait(&pair, &complete_count, (int32_t) i + 1);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "hg_test_bulk_pair_wait() failed (%s)", HG_Error_to_string(ret));
+
+        ret = cb_args.ret;
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+        HG_TEST_CHECK_ERROR(stats.transferred != sizes[i], error, ret,
+            HG_FAULT, "Transferred %" PRIu64 " bytes, expected %" PRIu64,
+            stats.transferred, sizes[i]);
+
+        /* Checksum is that of the data received */
+        HG_TEST_CHECK_ERROR(
+            cb_args.info.checksum !=
+                hg_crc32c(0, dst + offsets[i], (size_t) sizes[i]),
+            error, ret, HG_FAULT, "Checksum does not match received data");
+        HG_TEST_CHECK_ERROR((cb_args.info.checksum == expected_crc) != (i == 0),
+            error, ret, HG_FAULT, "Checksum mismatch %sdetected",
+            (i == 0) ? "wrongly " : "not ");
+    }
+
+    ret = HG_Bulk_free(local_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    local_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(remote_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    remote_handle = HG_BULK_NULL;
+
+    ret = HG_Bulk_free(origin_handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Bulk_free() failed (%s)", HG_Error_to_string(ret));
+    origin_handle = HG_BULK_NULL;
+
+    ret = hg_test_bulk_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "hg_test_bulk_pair_cleanup() failed (%s)", HG_Error_to_string(ret));
+
+    free(dst);
+    free(src);
+
+    return HG_SUCCESS;
+
+error:
+    if (local_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(local_handle);
+    if (remote_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(remote_handle);
+    if (origin_handle != HG_BULK_NULL)
+        (void) HG_Bulk_free(origin_handle);
+    (void) hg_test_bulk_pair_cleanup(&pair);
+    free(dst);
+    free(src);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 main(int argc, char *argv[])
@@ -500,6 +1900,67 @@ main(int argc, char *argv[])
     HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_bulk_destroy() failed (%s)",
         HG_Error_to_string(hg_ret));
 
+    /**************************************************************************
+     * Bulk feature tests between two classes of this process.
+     *************************************************************************/
+
+    if (info.hg_test_info.na_test_info.self_send) {
+        HG_TEST("bulk descriptors");
+        hg_ret = hg_test_bulk_desc(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_bulk_desc() failed (%s)",
+            HG_Error_to_string(hg_ret));
+        HG_PASSED();
+
+        HG_TEST("pipelined bulk transfer");
+        hg_ret = hg_test_bulk_pipelined(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_bulk_pipelined() failed (%s)", HG_Error_to_string(hg_ret));
+        HG_PASSED();
+
+        HG_TEST("coalesced bulk segments");
+        hg_ret = hg_test_bulk_coalesce(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_bulk_coalesce() failed (%s)", HG_Error_to_string(hg_ret));
+        HG_PASSED();
+
+        HG_TEST("file-backed bulk transfer");
+        hg_ret = hg_test_bulk_file_backed(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_bulk_file_backed() failed (%s)",
+            HG_Error_to_string(hg_ret));
+        HG_PASSED();
+
+        HG_TEST("bulk stream");
+        hg_ret = hg_test_bulk_stream(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_bulk_stream() failed (%s)", HG_Error_to_string(hg_ret));
+        HG_PASSED();
+
+        HG_TEST("bulk flow control");
+        hg_ret = hg_test_bulk_flow_control(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_bulk_flow_control() failed (%s)",
+            HG_Error_to_string(hg_ret));
+        HG_PASSED();
+
+        /* Not all plugins support remote atomics */
+        if (NA_Has_opt_feature(
+                info.hg_test_info.na_test_info.na_class, NA_OPT_ATOMIC)) {
+            HG_TEST("bulk remote atomics");
+            hg_ret = hg_test_bulk_atomic(info.hg_class);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                "hg_test_bulk_atomic() failed (%s)",
+                HG_Error_to_string(hg_ret));
+            HG_PASSED();
+        }
+
+        HG_TEST("bulk transfer checksum");
+        hg_ret = hg_test_bulk_checksum(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_bulk_checksum() failed (%s)", HG_Error_to_string(hg_ret));
+        HG_PASSED();
+    }
+
     hg_unit_cleanup(&info);
 
     return EXIT_SUCCESS;
@@ -11,6 +11,10 @@
 /* Local Macros */
 /****************/
 
+#define HG_TEST_WAIT_TIMEOUT (HG_TEST_TIMEOUT * 1000)
+
+#define HG_TEST_LOOKUP_MULTI_COUNT (16)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -29,6 +33,21 @@ struct hg_test_thread_args {
 static hg_return_t
 hg_test_rpc_lookup(hg_class_t *hg_class, const char *target_name);
 
+static hg_return_t
+hg_test_rpc_lookup_multi_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_test_rpc_lookup_multi(struct hg_unit_info *info);
+
+static hg_return_t
+hg_test_addr_book(struct hg_unit_info *info);
+
+static hg_return_t
+hg_test_addr_warm_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_test_addr_warm(struct hg_unit_info *info);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -97,6 +116,194 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_lookup_multi_cb(const struct hg_cb_info *callback_info)
+{
+    hg_request_complete((hg_request_t *) callback_info->arg);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_lookup_multi(struct hg_unit_info *info)
+{
+    const char *names[HG_TEST_LOOKUP_MULTI_COUNT];
+    hg_addr_t addrs[HG_TEST_LOOKUP_MULTI_COUNT];
+    hg_request_t *request = NULL;
+    hg_return_t ret;
+    unsigned int flag, i;
+    int rc;
+
+    /* Same target repeated, must resolve to a single addr */
+    for (i = 0; i < HG_TEST_LOOKUP_MULTI_COUNT; i++) {
+        names[i] = info->hg_test_info.na_test_info.target_name;
+        addrs[i] = HG_ADDR_NULL;
+    }
+
+    request = hg_request_create(info->request_class);
+    HG_TEST_CHECK_ERROR(request == NULL, error, ret, HG_NOMEM,
+        "hg_request_create() failed");
+
+    ret = HG_Addr_lookup_multi(info->context, hg_test_rpc_lookup_multi_cb,
+        request, names, HG_TEST_LOOKUP_MULTI_COUNT, addrs, HG_OP_ID_IGNORE);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Addr_lookup_multi() failed (%s)",
+        HG_Error_to_string(ret));
+
+    rc = hg_request_wait(request, HG_TEST_WAIT_TIMEOUT, &flag);
+    HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_PROTOCOL_ERROR,
+        "hg_request_wait() failed");
+    HG_TEST_CHECK_ERROR(
+        !flag, error, ret, HG_TIMEOUT, "hg_request_wait() timed out");
+
+    for (i = 1; i < HG_TEST_LOOKUP_MULTI_COUNT; i++)
+        HG_TEST_CHECK_ERROR(!HG_Addr_cmp(info->hg_class, addrs[0], addrs[i]),
+            error, ret, HG_FAULT, "Addr %u differs from addr 0", i);
+
+    for (i = 0; i < HG_TEST_LOOKUP_MULTI_COUNT; i++) {
+        ret = HG_Addr_free(info->hg_class, addrs[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Addr_free() failed (%s)", HG_Error_to_string(ret));
+        addrs[i] = HG_ADDR_NULL;
+    }
+
+    hg_request_destroy(request);
+
+    return HG_SUCCESS;
+
+error:
+    for (i = 0; i < HG_TEST_LOOKUP_MULTI_COUNT; i++)
+        HG_Addr_free(info->hg_class, addrs[i]);
+    if (request != NULL)
+        hg_request_destroy(request);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_addr_book(struct hg_unit_info *info)
+{
+    hg_addr_t addrs[2] = {info->target_addr, HG_ADDR_NULL};
+    hg_addr_t book_addrs[4] = {HG_ADDR_NULL};
+    unsigned int count = 0, i;
+    hg_size_t book_size;
+    char *buf = NULL;
+    hg_return_t ret;
+
+    ret = HG_Addr_self(info->hg_class, &addrs[1]);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+
+    /* Two concatenated books, as would be produced by an allgather */
+    book_size = HG_Addr_get_book_size(info->hg_class, addrs, 2);
+    HG_TEST_CHECK_ERROR(book_size == 0, error, ret, HG_FAULT,
+        "HG_Addr_get_book_size() failed");
+    buf = malloc(2 * book_size);
+    HG_TEST_CHECK_ERROR(
+        buf == NULL, error, ret, HG_NOMEM, "Could not allocate book");
+
+    for (i = 0; i < 2; i++) {
+        ret = HG_Addr_serialize_book(
+            info->hg_class, buf + i * book_size, book_size, addrs, 2);
+        HG_TEST_CHECK_HG_ERROR(error, ret,
+            "HG_Addr_serialize_book() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    /* Query number of entries first */
+    ret = HG_Addr_deserialize_book(
+        info->hg_class, buf, 2 * book_size, NULL, &count);
+    HG_TEST_CHECK_ERROR(ret != HG_OVERFLOW || count != 4, error, ret, HG_FAULT,
+        "HG_Addr_deserialize_book() returned %u entries (%s)", count,
+        HG_Error_to_string(ret));
+
+    ret = HG_Addr_deserialize_book(
+        info->hg_class, buf, 2 * book_size, book_addrs, &count);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "HG_Addr_deserialize_book() failed (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < 4; i++)
+        HG_TEST_CHECK_ERROR(
+            !HG_Addr_cmp(info->hg_class, book_addrs[i], addrs[i % 2]), error,
+            ret, HG_FAULT, "Addr %u differs from serialized addr", i);
+
+    for (i = 0; i < 4; i++)
+        HG_Addr_free(info->hg_class, book_addrs[i]);
+    HG_Addr_free(info->hg_class, addrs[1]);
+    free(buf);
+
+    return HG_SUCCESS;
+
+error:
+    for (i = 0; i < 4; i++)
+        HG_Addr_free(info->hg_class, book_addrs[i]);
+    HG_Addr_free(info->hg_class, addrs[1]);
+    free(buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_addr_warm_cb(const struct hg_cb_info *callback_info)
+{
+    hg_return_t *ret_p = (hg_return_t *) hg_request_get_data(
+        (hg_request_t *) callback_info->arg);
+
+    *ret_p = (callback_info->type == HG_CB_WARM) ? callback_info->ret
+                                                  : HG_PROTOCOL_ERROR;
+    hg_request_complete((hg_request_t *) callback_info->arg);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_addr_warm(struct hg_unit_info *info)
+{
+    hg_addr_t addrs[2] = {info->target_addr, HG_ADDR_NULL};
+    hg_request_t *request = NULL;
+    hg_return_t ret, cb_ret = HG_SUCCESS;
+    unsigned int flag;
+    int rc;
+
+    /* Self addrs must be skipped */
+    ret = HG_Addr_self(info->hg_class, &addrs[1]);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+
+    request = hg_request_create(info->request_class);
+    HG_TEST_CHECK_ERROR(request == NULL, error, ret, HG_NOMEM,
+        "hg_request_create() failed");
+    hg_request_set_data(request, &cb_ret);
+
+    ret = HG_Addr_warm(info->context, hg_test_addr_warm_cb, request, addrs, 2,
+        HG_OP_ID_IGNORE);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_warm() failed (%s)", HG_Error_to_string(ret));
+
+    rc = hg_request_wait(request, HG_TEST_WAIT_TIMEOUT, &flag);
+    HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_PROTOCOL_ERROR,
+        "hg_request_wait() failed");
+    HG_TEST_CHECK_ERROR(
+        !flag, error, ret, HG_TIMEOUT, "hg_request_wait() timed out");
+    HG_TEST_CHECK_HG_ERROR(error, cb_ret, "Warm-up callback failed (%s)",
+        HG_Error_to_string(cb_ret));
+
+    hg_request_destroy(request);
+    HG_Addr_free(info->hg_class, addrs[1]);
+
+    return HG_SUCCESS;
+
+error:
+    if (request != NULL)
+        hg_request_destroy(request);
+    HG_Addr_free(info->hg_class, addrs[1]);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 main(int argc, char *argv[])
@@ -133,11 +340,29 @@ main(int argc, char *argv[])
 
     HG_PASSED();
 
+    HG_TEST("multi lookup RPC");
+    hg_ret = hg_test_rpc_lookup_multi(&info);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "multi lookup test failed");
+    HG_PASSED();
+
     hg_ret = HG_Addr_lookup2(info.hg_class,
         info.hg_test_info.na_test_info.target_name, &info.target_addr);
     HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
         "HG_Addr_lookup() failed (%s)", HG_Error_to_string(hg_ret));
 
+    HG_TEST("addr book");
+    hg_ret = hg_test_addr_book(&info);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "addr book test failed");
+    HG_PASSED();
+
+    HG_TEST("addr warm-up");
+    hg_ret = hg_test_addr_warm(&info);
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "addr warm-up test failed");
+    HG_PASSED();
+
 done:
     if (ret != EXIT_SUCCESS)
         HG_FAILED();
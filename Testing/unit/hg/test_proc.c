@@ -10,11 +10,20 @@
 #include "mercury_proc.h"
 
 #include "mercury_mem.h"
+#ifdef HG_HAS_CHECKSUMS
+#    include "mercury_crc32c.h"
+#endif
 
 /****************/
 /* Local Macros */
 /****************/
 
+/* Number of values in arrays */
+#define HG_TEST_PROC_ARRAY_COUNT (257)
+
+/* Number of strings in string arrays */
+#define HG_TEST_PROC_STRING_COUNT (6)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -30,6 +39,19 @@ typedef struct {
     hg_const_string_t string;
 } hg_test_proc_string_t;
 
+typedef struct {
+    hg_const_string_t strings[HG_TEST_PROC_STRING_COUNT];
+} hg_test_proc_strings_t;
+
+typedef struct {
+    hg_uint32_t val32[HG_TEST_PROC_ARRAY_COUNT];
+    double val64[HG_TEST_PROC_ARRAY_COUNT];
+} hg_test_proc_array_t;
+
+#ifdef HG_HAS_BOOST
+typedef hg_test_proc_uint_t hg_test_proc_pod_t;
+#endif
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -59,6 +81,48 @@ hg_proc_hg_test_proc_uint_t(hg_proc_t proc, void *data)
     return ret;
 }
 
+static hg_return_t
+hg_proc_hg_test_proc_array_t(hg_proc_t proc, void *data)
+{
+    hg_test_proc_array_t *struct_data = (hg_test_proc_array_t *) data;
+    hg_return_t ret = HG_SUCCESS;
+
+    ret = hg_proc_uint32_array(
+        proc, struct_data->val32, HG_TEST_PROC_ARRAY_COUNT);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    ret = hg_proc_double_array(
+        proc, struct_data->val64, HG_TEST_PROC_ARRAY_COUNT);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    return ret;
+}
+
+/* Must be encoded the same way as hg_proc_hg_test_proc_array_t() */
+static hg_return_t
+hg_proc_hg_test_proc_array_values_t(hg_proc_t proc, void *data)
+{
+    hg_test_proc_array_t *struct_data = (hg_test_proc_array_t *) data;
+    hg_return_t ret = HG_SUCCESS;
+    int i;
+
+    for (i = 0; i < HG_TEST_PROC_ARRAY_COUNT; i++) {
+        ret = hg_proc_hg_uint32_t(proc, &struct_data->val32[i]);
+        if (ret != HG_SUCCESS)
+            return ret;
+    }
+
+    for (i = 0; i < HG_TEST_PROC_ARRAY_COUNT; i++) {
+        ret = hg_proc_hg_uint64_t(proc, &struct_data->val64[i]);
+        if (ret != HG_SUCCESS)
+            return ret;
+    }
+
+    return ret;
+}
+
 static hg_return_t
 hg_proc_hg_test_proc_string_t(hg_proc_t proc, void *data)
 {
@@ -72,13 +136,36 @@ hg_proc_hg_test_proc_string_t(hg_proc_t proc, void *data)
     return ret;
 }
 
+static hg_return_t
+hg_test_proc_strings(hg_proc_t proc, hg_test_proc_strings_t *data,
+    hg_return_t (*string_cb)(hg_proc_t proc, void *data))
+{
+    hg_return_t ret = HG_SUCCESS;
+    int i;
+
+    for (i = 0; i < HG_TEST_PROC_STRING_COUNT; i++) {
+        ret = string_cb(proc, &data->strings[i]);
+        if (ret != HG_SUCCESS)
+            return ret;
+    }
+
+    return ret;
+}
+
+#ifdef HG_HAS_BOOST
+/* Must be encoded the same way as hg_proc_hg_test_proc_uint_t() */
+MERCURY_GEN_POD_STRUCT_PROC(hg_test_proc_pod_t,
+    ((hg_uint8_t) (val8))((hg_uint16_t) (val16))((hg_uint32_t) (val32))(
+        (hg_uint64_t) (val64)))
+#endif
+
 /*******************/
 /* Local Variables */
 /*******************/
 
 static hg_return_t
-hg_test_proc_generic(
-    hg_return_t (*proc_cb)(hg_proc_t proc, void *data), void *in, void *out)
+hg_test_proc_generic(hg_return_t (*encode_cb)(hg_proc_t proc, void *data),
+    hg_return_t (*decode_cb)(hg_proc_t proc, void *data), void *in, void *out)
 {
     hg_proc_t proc = HG_PROC_NULL;
     void *in_buf = NULL, *out_buf = NULL;
@@ -87,6 +174,9 @@ hg_test_proc_generic(
 #ifdef HG_HAS_CHECKSUMS
     hg_uint32_t checksum = 0;
 #endif
+#ifndef HG_HAS_XDR
+    hg_size_t encoded_size;
+#endif
 
     /* CRC32 is enough for small size buffers */
     ret = hg_proc_create((hg_class_t *) 1, HG_CRC32, &proc);
@@ -100,13 +190,32 @@ hg_test_proc_generic(
     HG_TEST_CHECK_ERROR(
         out_buf == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate buf");
 
+#ifndef HG_HAS_XDR
+    /* Compute encoded size */
+    ret = hg_proc_reset(proc, NULL, 0, HG_SIZE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = encode_cb(proc, in);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+
+    encoded_size = hg_proc_get_size_used(proc);
+#endif
+
     /* Reset proc */
     ret = hg_proc_reset(proc, in_buf, buf_size, HG_ENCODE);
     HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
 
-    ret = proc_cb(proc, in);
+    ret = encode_cb(proc, in);
     HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
 
+#ifndef HG_HAS_XDR
+    HG_TEST_CHECK_ERROR(encoded_size != hg_proc_get_size_used(proc), done, ret,
+        HG_PROTOCOL_ERROR,
+        "Computed size does not match encoded size (%" PRIu64 " != %" PRIu64
+        ")",
+        encoded_size, hg_proc_get_size_used(proc));
+#endif
+
     /* Flush proc */
     ret = hg_proc_flush(proc);
     HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
@@ -124,7 +233,7 @@ hg_test_proc_generic(
     ret = hg_proc_reset(proc, out_buf, buf_size, HG_DECODE);
     HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
 
-    ret = proc_cb(proc, out);
+    ret = decode_cb(proc, out);
     HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
 
     /* Flush proc */
@@ -189,7 +298,8 @@ hg_test_proc_uint(void)
     hg_return_t ret;
     hg_test_proc_uint_t in = {1, 2, 3, 4}, out = {0, 0, 0, 0};
 
-    ret = hg_test_proc_generic(hg_proc_hg_test_proc_uint_t, &in, &out);
+    ret = hg_test_proc_generic(
+        hg_proc_hg_test_proc_uint_t, hg_proc_hg_test_proc_uint_t, &in, &out);
     HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
 
     HG_TEST_CHECK_ERROR(in.val8 != out.val8 && in.val16 != out.val16 &&
@@ -204,6 +314,244 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_BOOST
+static hg_return_t
+hg_test_proc_pod(void)
+{
+    hg_return_t ret;
+    hg_test_proc_pod_t in = {1, 2, 3, 4}, out = {0, 0, 0, 0};
+
+    /* Encode with fixed-layout proc and decode with per-field proc */
+    ret = hg_test_proc_generic(
+        hg_proc_hg_test_proc_pod_t, hg_proc_hg_test_proc_uint_t, &in, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
+
+    HG_TEST_CHECK_ERROR(in.val8 != out.val8 || in.val16 != out.val16 ||
+                            in.val32 != out.val32 || in.val64 != out.val64,
+        done, ret, HG_PROTOCOL_ERROR,
+        "Encoded and decoded values do not match");
+
+    /* And the other way around */
+    memset(&out, 0, sizeof(out));
+    ret = hg_test_proc_generic(
+        hg_proc_hg_test_proc_uint_t, hg_proc_hg_test_proc_pod_t, &in, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
+
+    HG_TEST_CHECK_ERROR(in.val8 != out.val8 || in.val16 != out.val16 ||
+                            in.val32 != out.val32 || in.val64 != out.val64,
+        done, ret, HG_PROTOCOL_ERROR,
+        "Encoded and decoded values do not match");
+
+    ret = hg_test_proc_free(hg_proc_hg_test_proc_pod_t, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_free() failed");
+
+done:
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_proc_array(void)
+{
+    hg_return_t ret;
+    hg_test_proc_array_t *in, *out = NULL;
+    int i;
+
+    /* Zero padding as well since structs are compared */
+    in = (hg_test_proc_array_t *) calloc(1, sizeof(*in));
+    HG_TEST_CHECK_ERROR(
+        in == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate array");
+    out = (hg_test_proc_array_t *) calloc(1, sizeof(*out));
+    HG_TEST_CHECK_ERROR(
+        out == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate array");
+
+    for (i = 0; i < HG_TEST_PROC_ARRAY_COUNT; i++) {
+        in->val32[i] = 0x01020304U * (hg_uint32_t) (i + 1);
+        in->val64[i] = 1.5 * i;
+    }
+
+    /* Encode arrays at once and decode values one by one */
+    ret = hg_test_proc_generic(hg_proc_hg_test_proc_array_t,
+        hg_proc_hg_test_proc_array_values_t, in, out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
+
+    HG_TEST_CHECK_ERROR(memcmp(in, out, sizeof(*in)) != 0, done, ret,
+        HG_PROTOCOL_ERROR, "Encoded and decoded arrays do not match");
+
+    /* And the other way around */
+    memset(out, 0, sizeof(*out));
+    ret = hg_test_proc_generic(hg_proc_hg_test_proc_array_values_t,
+        hg_proc_hg_test_proc_array_t, in, out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
+
+    HG_TEST_CHECK_ERROR(memcmp(in, out, sizeof(*in)) != 0, done, ret,
+        HG_PROTOCOL_ERROR, "Encoded and decoded arrays do not match");
+
+    ret = hg_test_proc_free(hg_proc_hg_test_proc_array_t, out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_free() failed");
+
+done:
+    free(in);
+    free(out);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_test_proc_varint(void)
+{
+    hg_test_proc_uint_t in[] = {{1, 2, 0, 127}, {1, 2, 128, 300},
+                         {1, 2, UINT32_MAX, UINT64_MAX}},
+                        out;
+    /* Encoded sizes of above values */
+    const hg_size_t sizes[] = {5, 7, 18};
+    hg_proc_t proc = HG_PROC_NULL;
+    char buf[64];
+    hg_size_t encoded_size;
+    hg_return_t ret;
+    size_t i;
+
+    ret = hg_proc_create((hg_class_t *) 1, HG_CRC32, &proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Cannot create HG proc");
+
+    for (i = 0; i < sizeof(in) / sizeof(in[0]); i++) {
+        ret = hg_proc_reset(proc, NULL, 0, HG_SIZE);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+        hg_proc_set_flags(proc, HG_PROC_VARINT);
+
+        ret = hg_proc_hg_test_proc_uint_t(proc, &in[i]);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+        encoded_size = hg_proc_get_size_used(proc);
+
+        ret = hg_proc_reset(proc, buf, sizeof(buf), HG_ENCODE);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+        hg_proc_set_flags(proc, HG_PROC_VARINT);
+
+        ret = hg_proc_hg_test_proc_uint_t(proc, &in[i]);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+
+        HG_TEST_CHECK_ERROR(hg_proc_get_size_used(proc) != sizes[i] ||
+                                encoded_size != sizes[i],
+            done, ret, HG_PROTOCOL_ERROR,
+            "Unexpected encoded size (%" PRIu64 ", %" PRIu64 " != %" PRIu64
+            ")",
+            hg_proc_get_size_used(proc), encoded_size, sizes[i]);
+
+        ret = hg_proc_reset(proc, buf, sizes[i], HG_DECODE);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+        hg_proc_set_flags(proc, HG_PROC_VARINT);
+
+        memset(&out, 0, sizeof(out));
+        ret = hg_proc_hg_test_proc_uint_t(proc, &out);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+
+        HG_TEST_CHECK_ERROR(in[i].val8 != out.val8 ||
+                                in[i].val16 != out.val16 ||
+                                in[i].val32 != out.val32 ||
+                                in[i].val64 != out.val64,
+            done, ret, HG_PROTOCOL_ERROR,
+            "Encoded and decoded values do not match");
+
+        /* Truncated stream must be rejected */
+        ret = hg_proc_reset(proc, buf, sizes[i] - 1, HG_DECODE);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+        hg_proc_set_flags(proc, HG_PROC_VARINT);
+
+        ret = hg_proc_hg_test_proc_uint_t(proc, &out);
+        HG_TEST_CHECK_ERROR(ret == HG_SUCCESS, done, ret, HG_PROTOCOL_ERROR,
+            "Truncated varint was decoded");
+        ret = HG_SUCCESS;
+    }
+
+    /* 32-bit value overflow must be rejected */
+    memset(buf, 0xff, 4);
+    buf[4] = 0x1f;
+    ret = hg_proc_reset(proc, buf, 5, HG_DECODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_uint32_varint(proc, &out.val32);
+    HG_TEST_CHECK_ERROR(ret != HG_PROTOCOL_ERROR, done, ret, HG_PROTOCOL_ERROR,
+        "Varint overflow was not detected");
+    ret = HG_SUCCESS;
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_CHECKSUMS
+static hg_return_t
+hg_test_proc_checksum_buf(void)
+{
+    hg_test_proc_uint_t in = {1, 2, 3, 4}, out = {0, 0, 0, 0};
+    hg_proc_t proc = HG_PROC_NULL;
+    char buf[64];
+    hg_uint32_t checksum = 0, expected;
+    hg_return_t ret;
+
+    ret = hg_proc_create((hg_class_t *) 1, HG_CRC32C_BUF, &proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Cannot create HG proc");
+
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_ENCODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_test_proc_uint_t(proc, &in);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    ret = hg_proc_checksum_get(proc, &checksum, sizeof(checksum));
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in getting proc checksum");
+
+    /* Checksum is computed over the encoded buffer */
+    expected = hg_crc32c(0, buf, (size_t) hg_proc_get_size_used(proc));
+    HG_TEST_CHECK_ERROR(checksum != expected, done, ret, HG_CHECKSUM_ERROR,
+        "Unexpected checksum (0x%08X != 0x%08X)", checksum, expected);
+
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_DECODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_test_proc_uint_t(proc, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    ret = hg_proc_checksum_verify(proc, &checksum, sizeof(checksum));
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc checksum verify");
+
+    /* Corrupted stream must be detected */
+    buf[1] ^= 1;
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_DECODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_test_proc_uint_t(proc, &out);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc uint_t struct");
+
+    ret = hg_proc_flush(proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in proc flush");
+
+    ret = hg_proc_checksum_verify(proc, &checksum, sizeof(checksum));
+    HG_TEST_CHECK_ERROR(ret != HG_CHECKSUM_ERROR, done, ret, HG_PROTOCOL_ERROR,
+        "Corrupted stream was not detected");
+    ret = HG_SUCCESS;
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_proc_string(void)
@@ -211,7 +559,8 @@ hg_test_proc_string(void)
     hg_return_t ret;
     hg_test_proc_string_t in = {"Hello"}, out = {"NULL"};
 
-    ret = hg_test_proc_generic(hg_proc_hg_test_proc_string_t, &in, &out);
+    ret = hg_test_proc_generic(hg_proc_hg_test_proc_string_t,
+        hg_proc_hg_test_proc_string_t, &in, &out);
     HG_TEST_CHECK_HG_ERROR(done, ret, "hg_test_proc_generic() failed");
 
     HG_TEST_CHECK_ERROR(strcmp(in.string, out.string) != 0, done, ret,
@@ -226,6 +575,105 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_proc_strings_cmp(
+    const hg_test_proc_strings_t *in, const hg_test_proc_strings_t *out)
+{
+    int i;
+
+    for (i = 0; i < HG_TEST_PROC_STRING_COUNT; i++) {
+        if (in->strings[i] == NULL || out->strings[i] == NULL) {
+            if (in->strings[i] != out->strings[i])
+                return HG_PROTOCOL_ERROR;
+        } else if (strcmp(in->strings[i], out->strings[i]) != 0)
+            return HG_PROTOCOL_ERROR;
+    }
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_proc_string_modes(void)
+{
+    hg_test_proc_strings_t in = {{"/a/b/c", "key", "/a/b/c", NULL, "",
+                                    "/a/b/c"}},
+                           out;
+    hg_proc_t proc = HG_PROC_NULL;
+    char buf[256];
+    hg_size_t const_size;
+    hg_return_t ret;
+
+    ret = hg_proc_create((hg_class_t *) 1, HG_CRC32, &proc);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Cannot create HG proc");
+
+    /* Encode const strings and decode borrowed strings */
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_ENCODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_test_proc_strings(proc, &in, hg_proc_hg_const_string_t);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc strings");
+    const_size = hg_proc_get_size_used(proc);
+
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_DECODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_test_proc_strings(proc, &out, hg_proc_hg_borrowed_string_t);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc strings");
+
+    HG_TEST_CHECK_ERROR(hg_test_proc_strings_cmp(&in, &out) != HG_SUCCESS,
+        done, ret, HG_PROTOCOL_ERROR,
+        "Encoded and decoded strings do not match");
+#ifndef HG_HAS_XDR
+    HG_TEST_CHECK_ERROR(
+        out.strings[0] < buf || out.strings[0] >= buf + sizeof(buf), done, ret,
+        HG_PROTOCOL_ERROR, "Borrowed string does not point to buffer");
+#endif
+
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_FREE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+    ret = hg_test_proc_strings(proc, &out, hg_proc_hg_borrowed_string_t);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not free strings");
+
+    /* Interned strings */
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_ENCODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_test_proc_strings(proc, &in, hg_proc_hg_interned_string_t);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc strings");
+
+    HG_TEST_CHECK_ERROR(hg_proc_get_size_used(proc) >= const_size, done, ret,
+        HG_PROTOCOL_ERROR,
+        "Interned strings are not smaller (%" PRIu64 " >= %" PRIu64 ")",
+        hg_proc_get_size_used(proc), const_size);
+
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_DECODE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+
+    ret = hg_test_proc_strings(proc, &out, hg_proc_hg_interned_string_t);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not proc strings");
+
+    HG_TEST_CHECK_ERROR(hg_test_proc_strings_cmp(&in, &out) != HG_SUCCESS,
+        done, ret, HG_PROTOCOL_ERROR,
+        "Encoded and decoded strings do not match");
+#ifndef HG_HAS_XDR
+    HG_TEST_CHECK_ERROR(out.strings[2] != out.strings[0], done, ret,
+        HG_PROTOCOL_ERROR, "Interned string was not shared");
+#endif
+
+    ret = hg_proc_reset(proc, buf, sizeof(buf), HG_FREE);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not reset proc");
+    ret = hg_test_proc_strings(proc, &out, hg_proc_hg_interned_string_t);
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Could not free strings");
+
+done:
+    if (proc != HG_PROC_NULL)
+        hg_proc_free(proc);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 main(void)
@@ -240,6 +688,40 @@ main(void)
         hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "uint proc test failed");
     HG_PASSED();
 
+#ifdef HG_HAS_BOOST
+    /* fixed-layout proc test */
+    HG_TEST("pod proc");
+    hg_ret = hg_test_proc_pod();
+    HG_TEST_CHECK_ERROR(
+        hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE, "pod proc test failed");
+    HG_PASSED();
+#endif
+
+    /* array proc test */
+    HG_TEST("array proc");
+    hg_ret = hg_test_proc_array();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "array proc test failed");
+    HG_PASSED();
+
+#ifndef HG_HAS_XDR
+    /* varint proc test */
+    HG_TEST("varint proc");
+    hg_ret = hg_test_proc_varint();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "varint proc test failed");
+    HG_PASSED();
+#endif
+
+#ifdef HG_HAS_CHECKSUMS
+    /* buffer checksum test */
+    HG_TEST("checksum buf proc");
+    hg_ret = hg_test_proc_checksum_buf();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "checksum buf proc test failed");
+    HG_PASSED();
+#endif
+
     /* string proc test */
     HG_TEST("string proc");
     hg_ret = hg_test_proc_string();
@@ -247,6 +729,13 @@ main(void)
         "string proc test failed");
     HG_PASSED();
 
+    /* borrowed and interned string proc test */
+    HG_TEST("string modes proc");
+    hg_ret = hg_test_proc_string_modes();
+    HG_TEST_CHECK_ERROR(hg_ret != HG_SUCCESS, done, ret, EXIT_FAILURE,
+        "string modes proc test failed");
+    HG_PASSED();
+
 done:
     if (ret != EXIT_SUCCESS)
         HG_FAILED();
@@ -7,6 +7,8 @@
 
 #include "mercury_unit.h"
 
+#include "mercury_time.h"
+
 /****************/
 /* Local Macros */
 /****************/
@@ -17,6 +19,9 @@
 /* Wait timeout in ms */
 #define HG_TEST_WAIT_TIMEOUT (HG_TEST_TIMEOUT * 1000)
 
+/* Number of requests forwarded to a coalescing target */
+#define HG_TEST_COALESCE_COUNT 4
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -28,6 +33,32 @@ struct forward_cb_args {
     bool no_entry;
 };
 
+struct coalesce_cb_args {
+    hg_return_t ret;         /* Return code of forward */
+    int32_t *complete_count; /* Shared completed count */
+};
+
+struct rpc_pair {
+    hg_class_t *target_class;     /* Class handling requests */
+    hg_context_t *target_context; /* Context of target class */
+    hg_class_t *origin_class;     /* Class forwarding requests */
+    hg_context_t *origin_context; /* Context of origin class */
+    hg_addr_t target_addr;        /* Target address looked up by origin */
+    hg_id_t rpc_id;               /* RPC registered on both classes */
+};
+
+struct overflow_rpc_args {
+    size_t string_len;       /* Length of output string */
+    int32_t respond_count;   /* Completed responses */
+    hg_return_t respond_ret; /* Return code of last response */
+};
+
+struct overflow_cb_args {
+    size_t string_len;       /* Expected length of output string */
+    hg_return_t ret;         /* Return code of forward */
+    int32_t *complete_count; /* Shared completed count */
+};
+
 struct forward_multi_cb_args {
     rpc_handle_t *rpc_handle;
     hg_return_t *rets;
@@ -67,6 +98,10 @@ static hg_return_t
 hg_test_rpc_cancel(hg_handle_t handle, hg_addr_t addr, hg_id_t rpc_id,
     hg_cb_t callback, hg_request_t *request);
 
+static hg_return_t
+hg_test_rpc_timeout(hg_handle_t handle, hg_addr_t addr, hg_id_t rpc_id,
+    hg_cb_t callback, hg_request_t *request);
+
 static hg_return_t
 hg_test_rpc_multi(hg_handle_t *handles, size_t handle_max, hg_addr_t addr,
     hg_uint8_t target_id, hg_id_t rpc_id, hg_cb_t callback,
@@ -75,6 +110,70 @@ hg_test_rpc_multi(hg_handle_t *handles, size_t handle_max, hg_addr_t addr,
 static hg_return_t
 hg_test_rpc_multi_cb(const struct hg_cb_info *callback_info);
 
+static hg_return_t
+hg_test_rpc_persistent(hg_context_t *context, hg_addr_t addr, hg_id_t rpc_id,
+    unsigned int count, hg_cb_t callback, hg_request_t *request);
+
+static hg_return_t
+hg_test_rpc_forward_multi(hg_context_t *context, hg_addr_t addr,
+    hg_id_t rpc_id, unsigned int count, unsigned int tree_arity,
+    hg_cb_t callback, hg_request_t *request);
+
+static hg_return_t
+hg_test_rpc_forward_multi_cb(const struct hg_cb_info *callback_info);
+
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_test_rpc_forward_multi_reduce_cb(const struct hg_cb_info *callback_info);
+#endif
+
+static hg_return_t
+hg_test_rpc_stats(hg_class_t *hg_class, hg_id_t rpc_id);
+
+static hg_return_t
+hg_test_progress_stats(hg_context_t *context);
+
+static hg_return_t
+hg_test_exec_single_thread(na_class_t *na_class);
+
+static hg_return_t
+hg_test_coalesce_rpc_cb(hg_handle_t handle);
+
+static hg_return_t
+hg_test_coalesce_forward_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_test_rpc_coalesce_cancel(const hg_class_t *parent_class);
+
+#ifndef HG_HAS_XDR
+static hg_return_t
+hg_test_rpc_pair_init(const hg_class_t *parent_class,
+    struct hg_init_info *hg_init_info, struct overflow_rpc_args *rpc_args,
+    struct rpc_pair *pair);
+
+static hg_return_t
+hg_test_rpc_pair_cleanup(struct rpc_pair *pair);
+
+static hg_return_t
+hg_test_rpc_pair_wait(struct rpc_pair *pair, bool origin,
+    const int32_t *count, int32_t expected);
+
+static hg_return_t
+hg_test_overflow_rpc_cb(hg_handle_t handle);
+
+static hg_return_t
+hg_test_overflow_respond_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_test_overflow_forward_cb(const struct hg_cb_info *callback_info);
+
+static hg_return_t
+hg_test_rpc_lease(const hg_class_t *parent_class);
+
+static hg_return_t
+hg_test_rpc_out_region(const hg_class_t *parent_class);
+#endif
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -82,6 +181,7 @@ hg_test_rpc_multi_cb(const struct hg_cb_info *callback_info);
 extern hg_id_t hg_test_rpc_null_id_g;
 extern hg_id_t hg_test_rpc_open_id_g;
 extern hg_id_t hg_test_rpc_open_id_no_resp_g;
+extern hg_id_t hg_test_rpc_open_reduce_id_g;
 extern hg_id_t hg_test_overflow_id_g;
 extern hg_id_t hg_test_cancel_rpc_id_g;
 
@@ -365,6 +465,50 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_timeout(hg_handle_t handle, hg_addr_t addr, hg_id_t rpc_id,
+    hg_cb_t callback, hg_request_t *request)
+{
+    hg_return_t ret;
+    struct forward_cb_args forward_cb_args = {
+        .request = request, .ret = HG_SUCCESS};
+    unsigned int flag;
+    int rc;
+
+    hg_request_reset(request);
+
+    ret = HG_Reset(handle, addr, rpc_id);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Reset() failed (%s)", HG_Error_to_string(ret));
+
+    /* Target never responds, forward must be canceled from progress */
+    ret = HG_Set_timeout(handle, 100);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Set_timeout() failed (%s)", HG_Error_to_string(ret));
+
+    HG_TEST_LOG_DEBUG("Forwarding RPC, op id: %" PRIu64 "...", rpc_id);
+
+    ret = HG_Forward(handle, callback, &forward_cb_args, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    rc = hg_request_wait(request, HG_TEST_WAIT_TIMEOUT, &flag);
+    HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_PROTOCOL_ERROR,
+        "hg_request_wait() failed");
+
+    HG_TEST_CHECK_ERROR(
+        !flag, error, ret, HG_TIMEOUT, "hg_request_wait() timed out");
+    ret = forward_cb_args.ret;
+    HG_TEST_CHECK_ERROR_NORET(ret != HG_TIMEOUT, error,
+        "Error in HG callback (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_rpc_multi(hg_handle_t *handles, size_t handle_max, hg_addr_t addr,
@@ -487,143 +631,1211 @@ done:
 }
 
 /*---------------------------------------------------------------------------*/
-int
-main(int argc, char *argv[])
+static hg_return_t
+hg_test_rpc_persistent(hg_context_t *context, hg_addr_t addr, hg_id_t rpc_id,
+    unsigned int count, hg_cb_t callback, hg_request_t *request)
 {
-    struct hg_unit_info info;
-    hg_return_t hg_ret;
-    hg_id_t inv_id;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_return_t ret;
+    unsigned int i;
+
+    ret = HG_Create_persistent(context, addr, rpc_id, &handle);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Create_persistent() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Second half of the calls re-uses the same encoded input */
+    for (i = 0; i < 2 * count; i++) {
+        rpc_handle_t rpc_open_handle = {.cookie = 100};
+        struct forward_cb_args forward_cb_args = {.request = request,
+            .rpc_handle = &rpc_open_handle,
+            .ret = HG_SUCCESS,
+            .no_entry = false};
+        rpc_open_in_t in_struct = {
+            .handle = rpc_open_handle, .path = HG_TEST_RPC_PATH};
+        unsigned int flag;
+        int rc;
+
+        hg_request_reset(request);
+
+        if (i < count) {
+            ret = HG_Forward_persistent(
+                handle, callback, &forward_cb_args, &in_struct);
+            HG_TEST_CHECK_HG_ERROR(error, ret,
+                "HG_Forward_persistent() failed (%s)", HG_Error_to_string(ret));
+        } else {
+            if (i == count) {
+                ret = HG_Retain_input(handle, &in_struct);
+                HG_TEST_CHECK_HG_ERROR(error, ret,
+                    "HG_Retain_input() failed (%s)", HG_Error_to_string(ret));
+            }
+            ret = HG_Forward_retained(handle, callback, &forward_cb_args);
+            HG_TEST_CHECK_HG_ERROR(error, ret,
+                "HG_Forward_retained() failed (%s)", HG_Error_to_string(ret));
+        }
 
-    /* Initialize the interface */
-    hg_ret = hg_unit_init(argc, argv, false, &info);
-    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_unit_init() failed (%s)",
-        HG_Error_to_string(hg_ret));
+        rc = hg_request_wait(request, HG_TEST_WAIT_TIMEOUT, &flag);
+        HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret,
+            HG_PROTOCOL_ERROR, "hg_request_wait() failed");
 
-    /* NULL RPC test */
-    HG_TEST("NULL RPC");
-    hg_ret = hg_test_rpc_no_input(info.handles[0], info.target_addr,
-        hg_test_rpc_null_id_g, hg_test_rpc_no_output_cb, info.request);
-    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_no_input() failed (%s)",
-        HG_Error_to_string(hg_ret));
-    HG_PASSED();
+        HG_TEST_CHECK_ERROR(
+            !flag, error, ret, HG_TIMEOUT, "hg_request_wait() timed out");
+        ret = forward_cb_args.ret;
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
+    }
 
-    /* Simple RPC test */
-    HG_TEST("RPC with response");
-    hg_ret = hg_test_rpc_input(info.handles[0], info.target_addr,
-        hg_test_rpc_open_id_g, hg_test_rpc_output_cb, info.request);
-    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_input() failed (%s)",
-        HG_Error_to_string(hg_ret));
-    HG_PASSED();
+    /* Binding is removed by reset */
+    ret = HG_Reset(handle, addr, rpc_id);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Reset() failed (%s)", HG_Error_to_string(ret));
+    ret = HG_Forward_persistent(handle, callback, NULL, NULL);
+    HG_TEST_CHECK_ERROR(ret != HG_INVALID_ARG, error, ret, HG_PROTOCOL_ERROR,
+        "HG_Forward_persistent() succeeded after reset");
 
-    /* RPC test with lookup/free */
-    if (!info.hg_test_info.na_test_info.self_send &&
-        strcmp(HG_Class_get_name(info.hg_class), "mpi")) {
-        int i;
+    ret = HG_Destroy(handle);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
 
-        hg_ret = HG_Addr_set_remove(info.hg_class, info.target_addr);
-        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
-            "HG_Addr_set_remove() failed (%s)", HG_Error_to_string(hg_ret));
+    return HG_SUCCESS;
 
-        hg_ret = HG_Addr_free(info.hg_class, info.target_addr);
-        HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Addr_free() failed (%s)",
-            HG_Error_to_string(hg_ret));
-        info.target_addr = HG_ADDR_NULL;
+error:
+    (void) HG_Destroy(handle);
+done:
+    return ret;
+}
 
-        HG_TEST("RPC with multiple lookup/free");
-        for (i = 0; i < 32; i++) {
-            hg_ret = HG_Addr_lookup2(info.hg_class,
-                info.hg_test_info.na_test_info.target_name, &info.target_addr);
-            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
-                "HG_Addr_lookup2() failed (%s)", HG_Error_to_string(hg_ret));
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_forward_multi(hg_context_t *context, hg_addr_t addr,
+    hg_id_t rpc_id, unsigned int count, unsigned int tree_arity,
+    hg_cb_t callback, hg_request_t *request)
+{
+    rpc_handle_t rpc_open_handle = {.cookie = 100};
+    struct forward_cb_args forward_cb_args = {.request = request,
+        .rpc_handle = &rpc_open_handle,
+        .ret = HG_SUCCESS,
+        .no_entry = false};
+    rpc_open_in_t in_struct = {
+        .handle = rpc_open_handle, .path = HG_TEST_RPC_PATH};
+    hg_addr_t *addrs = NULL;
+    hg_multi_t multi = NULL;
+    unsigned int i, flag;
+    hg_return_t ret;
+    int rc;
 
-            hg_ret = hg_test_rpc_input(info.handles[0], info.target_addr,
-                hg_test_rpc_open_id_g, hg_test_rpc_output_cb, info.request);
-            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
-                "hg_test_rpc_input() failed (%s)", HG_Error_to_string(hg_ret));
+    hg_request_reset(request);
 
-            hg_ret = HG_Addr_set_remove(info.hg_class, info.target_addr);
-            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
-                "HG_Addr_set_remove() failed (%s)", HG_Error_to_string(hg_ret));
+    /* Same target is used multiple times */
+    addrs = (hg_addr_t *) malloc(count * sizeof(hg_addr_t));
+    HG_TEST_CHECK_ERROR(addrs == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of addresses");
+    for (i = 0; i < count; i++)
+        addrs[i] = addr;
 
-            hg_ret = HG_Addr_free(info.hg_class, info.target_addr);
-            HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Addr_free() failed (%s)",
-                HG_Error_to_string(hg_ret));
-            info.target_addr = HG_ADDR_NULL;
-        }
-        HG_PASSED();
+    HG_TEST_LOG_DEBUG("Forwarding RPC to %u targets (arity %u), op id: %" PRIu64
+                      "...",
+        count, tree_arity, rpc_id);
 
-        hg_ret = HG_Addr_lookup2(info.hg_class,
-            info.hg_test_info.na_test_info.target_name, &info.target_addr);
-        HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Addr_lookup2() failed (%s)",
-            HG_Error_to_string(hg_ret));
-    }
+    ret = HG_Forward_multi(context, rpc_id, addrs, count, tree_arity, callback,
+        &forward_cb_args, &in_struct, &multi);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward_multi() failed (%s)", HG_Error_to_string(ret));
 
-    /* RPC test with no response */
-    HG_TEST("RPC without response");
-    hg_ret = hg_test_rpc_input(info.handles[0], info.target_addr,
-        hg_test_rpc_open_id_no_resp_g, hg_test_rpc_no_output_cb, info.request);
-    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_input() failed (%s)",
-        HG_Error_to_string(hg_ret));
-    HG_PASSED();
+    rc = hg_request_wait(request, HG_TEST_WAIT_TIMEOUT, &flag);
+    HG_TEST_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_PROTOCOL_ERROR,
+        "hg_request_wait() failed");
 
-    /* RPC test with unregistered ID */
-    inv_id = MERCURY_REGISTER(info.hg_class, "unreg_id", void, void, NULL);
-    HG_TEST_CHECK_ERROR_NORET(inv_id == 0, error, "HG_Register() failed");
-    hg_ret = HG_Deregister(info.hg_class, inv_id);
-    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Deregister() failed (%s)",
-        HG_Error_to_string(hg_ret));
+    HG_TEST_CHECK_ERROR(
+        !flag, error, ret, HG_TIMEOUT, "hg_request_wait() timed out");
+    ret = forward_cb_args.ret;
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "Error in HG callback (%s)", HG_Error_to_string(ret));
 
-    HG_TEST("RPC with unregistered ID");
-    HG_Test_log_disable(); // Expected to produce errors
-    hg_ret = hg_test_rpc_input(info.handles[0], info.target_addr, inv_id,
-        hg_test_rpc_output_cb, info.request);
-    HG_Test_log_enable();
-    HG_TEST_CHECK_ERROR_NORET(hg_ret != HG_NOENTRY, error,
-        "hg_test_rpc_input() failed (%s, expected %s)",
-        HG_Error_to_string(hg_ret), HG_Error_to_string(HG_NOENTRY));
-    HG_PASSED();
+    ret = HG_Multi_destroy(multi);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Multi_destroy() failed (%s)", HG_Error_to_string(ret));
+    free(addrs);
 
-    if (!info.hg_test_info.na_test_info.self_send) {
-        /* RPC test with invalid ID (not registered on server) */
-        inv_id = MERCURY_REGISTER(info.hg_class, "inv_id", void, void, NULL);
-        HG_TEST_CHECK_ERROR_NORET(inv_id == 0, error, "HG_Register() failed");
+    return HG_SUCCESS;
 
-        HG_TEST("RPC not registered on server");
-        hg_ret = hg_test_rpc_inv(
-            info.handles[0], info.target_addr, inv_id, info.request);
-        HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_inv() failed (%s)",
-            HG_Error_to_string(hg_ret));
-        HG_PASSED();
-    }
+error:
+    (void) HG_Multi_destroy(multi);
+    free(addrs);
 
-#ifndef HG_HAS_XDR
-    /* Overflow RPC test */
-    HG_TEST("RPC with output overflow");
-    hg_ret = hg_test_rpc_no_input(info.handles[0], info.target_addr,
-        hg_test_overflow_id_g, hg_test_rpc_output_overflow_cb, info.request);
-    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_no_input() failed (%s)",
-        HG_Error_to_string(hg_ret));
-    HG_PASSED();
-#endif
+    return ret;
+}
 
-    /* Cancel RPC test (self cancelation is not supported) */
-    if (!info.hg_test_info.na_test_info.self_send) {
-        HG_TEST("RPC cancelation");
-        hg_ret = hg_test_rpc_cancel(info.handles[0], info.target_addr,
-            hg_test_cancel_rpc_id_g, hg_test_rpc_no_output_cb, info.request);
-        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
-            "hg_test_rpc_cancel() failed (%s)", HG_Error_to_string(hg_ret));
-        HG_PASSED();
-    }
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_forward_multi_cb(const struct hg_cb_info *callback_info)
+{
+    hg_multi_t multi = callback_info->info.forward_multi.multi;
+    struct forward_cb_args *args =
+        (struct forward_cb_args *) callback_info->arg;
+    unsigned int i, count = HG_Multi_get_count(multi);
+    hg_return_t ret = callback_info->ret;
 
-    /* RPC test with multiple handle in flight */
-    HG_TEST("concurrent RPCs");
-    hg_ret = hg_test_rpc_multi(info.handles, info.handle_max, info.target_addr,
-        0, hg_test_rpc_open_id_g, hg_test_rpc_multi_cb, info.request);
-    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_multiple() failed (%s)",
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in HG callback (%s)",
+        HG_Error_to_string(callback_info->ret));
+
+    for (i = 0; i < count; i++) {
+        rpc_open_out_t rpc_open_out_struct;
+
+        ret = HG_Multi_get_ret(multi, i);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "Target %u failed (%s)", i,
+            HG_Error_to_string(ret));
+
+        /* Get output */
+        ret = HG_Multi_get_output(multi, i, &rpc_open_out_struct);
+        HG_TEST_CHECK_HG_ERROR(done, ret, "HG_Multi_get_output() failed (%s)",
+            HG_Error_to_string(ret));
+
+        HG_TEST_LOG_DEBUG("rpc_open %u returned: %d with event_id: %d", i,
+            rpc_open_out_struct.ret, rpc_open_out_struct.event_id);
+        if (rpc_open_out_struct.event_id != (int) args->rpc_handle->cookie)
+            ret = HG_FAULT;
+
+        /* Free output */
+        if (ret != HG_SUCCESS)
+            (void) HG_Multi_free_output(multi, i, &rpc_open_out_struct);
+        else {
+            ret = HG_Multi_free_output(multi, i, &rpc_open_out_struct);
+            HG_TEST_CHECK_HG_ERROR(done, ret,
+                "HG_Multi_free_output() failed (%s)", HG_Error_to_string(ret));
+        }
+        HG_TEST_CHECK_ERROR_NORET(ret != HG_SUCCESS, done,
+            "Cookie did not match RPC response of target %u", i);
+    }
+
+done:
+    args->ret = ret;
+
+    hg_request_complete(args->request);
+
+    return HG_SUCCESS;
+}
+
+#ifndef HG_HAS_XDR
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_forward_multi_reduce_cb(const struct hg_cb_info *callback_info)
+{
+    hg_multi_t multi = callback_info->info.forward_multi.multi;
+    struct forward_cb_args *args =
+        (struct forward_cb_args *) callback_info->arg;
+    unsigned int count = HG_Multi_get_count(multi);
+    rpc_open_out_t rpc_open_out_struct;
+    hg_return_t ret = callback_info->ret;
+
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in HG callback (%s)",
+        HG_Error_to_string(callback_info->ret));
+
+    /* Get reduced output */
+    ret = HG_Multi_get_reduced_output(multi, &rpc_open_out_struct);
+    HG_TEST_CHECK_HG_ERROR(done, ret,
+        "HG_Multi_get_reduced_output() failed (%s)", HG_Error_to_string(ret));
+
+    /* Event IDs of all targets are summed */
+    HG_TEST_LOG_DEBUG("rpc_open reduced event_id: %d",
+        rpc_open_out_struct.event_id);
+    HG_TEST_CHECK_ERROR(rpc_open_out_struct.event_id !=
+                            (int) (args->rpc_handle->cookie * count),
+        free, ret, HG_FAULT, "Reduced output did not match RPC responses");
+
+free:
+    if (ret != HG_SUCCESS)
+        (void) HG_Multi_free_reduced_output(multi, &rpc_open_out_struct);
+    else {
+        /* Free output */
+        ret = HG_Multi_free_reduced_output(multi, &rpc_open_out_struct);
+        HG_TEST_CHECK_HG_ERROR(done, ret,
+            "HG_Multi_free_reduced_output() failed (%s)",
+            HG_Error_to_string(ret));
+    }
+
+done:
+    args->ret = ret;
+
+    hg_request_complete(args->request);
+
+    return HG_SUCCESS;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_stats(hg_class_t *hg_class, hg_id_t rpc_id)
+{
+    struct hg_rpc_stats stats;
+    hg_return_t ret;
+
+    ret = HG_Class_get_stats(hg_class, rpc_id, &stats);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Class_get_stats() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* At least one RPC with response was forwarded */
+    HG_TEST_CHECK_ERROR(stats.latency.count == 0 || stats.payload.count == 0,
+        error, ret, HG_FAULT, "No RPC stats were recorded");
+    HG_TEST_CHECK_ERROR(
+        HG_Stats_percentile(&stats.latency, 100.0) != stats.latency.max ||
+            HG_Stats_percentile(&stats.latency, 50.0) > stats.latency.max,
+        error, ret, HG_FAULT, "Invalid latency percentiles");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_progress_stats(hg_context_t *context)
+{
+    struct hg_progress_stats stats;
+    hg_return_t ret;
+
+    /* Requests may have completed through trigger alone (e.g., self-send),
+     * make sure that the context was progressed at least once */
+    ret = HG_Progress(context, 0);
+    HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error, ret,
+        ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Context_get_progress_stats(context, &stats);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "HG_Context_get_progress_stats() failed (%s)", HG_Error_to_string(ret));
+
+    /* Samples are a subset of calls */
+    HG_TEST_CHECK_ERROR(stats.progress_count == 0 ||
+                            stats.progress_samples > stats.progress_count ||
+                            stats.trigger_samples > stats.trigger_count,
+        error, ret, HG_FAULT, "Invalid progress counts");
+    HG_TEST_CHECK_ERROR(stats.idle_ratio < 0.0 || stats.idle_ratio > 1.0 ||
+                            stats.busy_ratio < 0.0 || stats.busy_ratio > 1.0,
+        error, ret, HG_FAULT, "Invalid progress ratios");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_exec_single_thread(na_class_t *na_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    hg_class_t *hg_class = NULL;
+    hg_context_t *context = NULL;
+    hg_return_t ret;
+
+    /* Share NA class, class is not listening */
+    hg_init_info.na_class = na_class;
+    hg_init_info.single_thread = HG_TRUE;
+    hg_class = HG_Init_opt2(NULL, HG_FALSE,
+        HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), &hg_init_info);
+    HG_TEST_CHECK_ERROR(
+        hg_class == NULL, error, ret, HG_FAULT, "HG_Init_opt2() failed");
+
+    context = HG_Context_create(hg_class);
+    HG_TEST_CHECK_ERROR(
+        context == NULL, error, ret, HG_FAULT, "HG_Context_create() failed");
+
+    /* Execution model spawns threads and must be refused */
+    ret = HG_Context_exec_start(context, NULL);
+    HG_TEST_CHECK_ERROR(ret != HG_INVALID_ARG, error, ret, HG_FAULT,
+        "HG_Context_exec_start() should have failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Context_destroy(context);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Context_destroy() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Finalize(hg_class);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Finalize() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    if (context != NULL)
+        (void) HG_Context_destroy(context);
+    if (hg_class != NULL)
+        (void) HG_Finalize(hg_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_coalesce_rpc_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    int32_t *handled_count =
+        (int32_t *) HG_Registered_data(hg_info->hg_class, hg_info->id);
+    hg_return_t ret;
+
+    (*handled_count)++;
+
+    ret = HG_Respond(handle, NULL, NULL, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    (void) HG_Destroy(handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_coalesce_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct coalesce_cb_args *args =
+        (struct coalesce_cb_args *) callback_info->arg;
+
+    args->ret = callback_info->ret;
+    (*args->complete_count)++;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_coalesce_cancel(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct coalesce_cb_args cb_args[HG_TEST_COALESCE_COUNT];
+    hg_handle_t handles[HG_TEST_COALESCE_COUNT] = {NULL};
+    int32_t complete_count = 0, handled_count = 0;
+    char info_string[64];
+    hg_class_t *hg_class = NULL;
+    hg_context_t *context = NULL;
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_time_t deadline, now;
+    hg_id_t rpc_id;
+    hg_return_t ret;
+    int i;
+
+    /* Separate listening class that sends to itself through NA, with
+     * requests held back until a full batch is formed */
+    snprintf(info_string, sizeof(info_string), "%s+%s",
+        HG_Class_get_name(parent_class), HG_Class_get_protocol(parent_class));
+    hg_init_info.no_loopback = HG_TRUE;
+    hg_init_info.request_coalesce_max = HG_TEST_COALESCE_COUNT - 1;
+    hg_init_info.request_coalesce_delay = HG_TEST_WAIT_TIMEOUT * 1000;
+    hg_class = HG_Init_opt2(info_string, HG_TRUE,
+        HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), &hg_init_info);
+    HG_TEST_CHECK_ERROR(
+        hg_class == NULL, error, ret, HG_FAULT, "HG_Init_opt2() failed");
+
+    context = HG_Context_create(hg_class);
+    HG_TEST_CHECK_ERROR(
+        context == NULL, error, ret, HG_FAULT, "HG_Context_create() failed");
+
+    rpc_id = HG_Register_name(
+        hg_class, "hg_test_coalesce", NULL, NULL, hg_test_coalesce_rpc_cb);
+    HG_TEST_CHECK_ERROR(
+        rpc_id == 0, error, ret, HG_FAULT, "HG_Register_name() failed");
+
+    ret = HG_Register_data(hg_class, rpc_id, &handled_count, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Register_data() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Addr_self(hg_class, &self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < HG_TEST_COALESCE_COUNT; i++) {
+        cb_args[i].ret = HG_OTHER_ERROR;
+        cb_args[i].complete_count = &complete_count;
+
+        ret = HG_Create(context, self_addr, rpc_id, &handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    /* Queue two requests and cancel the second one while it is still
+     * pending in the batch */
+    for (i = 0; i < 2; i++) {
+        ret = HG_Forward(
+            handles[i], hg_test_coalesce_forward_cb, &cb_args[i], NULL);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    ret = HG_Cancel(handles[1]);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Cancel() failed (%s)", HG_Error_to_string(ret));
+
+    /* Remaining requests complete the batch, which is then sent */
+    for (i = 2; i < HG_TEST_COALESCE_COUNT; i++) {
+        ret = HG_Forward(
+            handles[i], hg_test_coalesce_forward_cb, &cb_args[i], NULL);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(HG_TEST_WAIT_TIMEOUT));
+    while (complete_count < HG_TEST_COALESCE_COUNT &&
+           hg_time_less(now, deadline)) {
+        unsigned int actual_count = 0;
+
+        ret = HG_Progress(context, 100);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error, ret,
+            ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+
+        do {
+            ret = HG_Trigger(context, 0, 1, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count);
+
+        hg_time_get_current_ms(&now);
+    }
+    HG_TEST_CHECK_ERROR(complete_count < HG_TEST_COALESCE_COUNT, error, ret,
+        HG_TIMEOUT, "Timed out waiting for coalesced requests");
+
+    /* Canceled request must not have been sent */
+    for (i = 0; i < HG_TEST_COALESCE_COUNT; i++)
+        HG_TEST_CHECK_ERROR(
+            cb_args[i].ret != ((i == 1) ? HG_CANCELED : HG_SUCCESS), error,
+            ret, HG_FAULT, "Unexpected return code for request %d (%s)", i,
+            HG_Error_to_string(cb_args[i].ret));
+    HG_TEST_CHECK_ERROR(handled_count != HG_TEST_COALESCE_COUNT - 1, error, ret,
+        HG_FAULT, "Target handled %" PRId32 " requests, expected %d",
+        handled_count, HG_TEST_COALESCE_COUNT - 1);
+
+    for (i = 0; i < HG_TEST_COALESCE_COUNT; i++) {
+        ret = HG_Destroy(handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+        handles[i] = NULL;
+    }
+
+    ret = HG_Addr_free(hg_class, self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_free() failed (%s)", HG_Error_to_string(ret));
+    self_addr = HG_ADDR_NULL;
+
+    ret = HG_Context_destroy(context);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Context_destroy() failed (%s)",
+        HG_Error_to_string(ret));
+    context = NULL;
+
+    ret = HG_Finalize(hg_class);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Finalize() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    for (i = 0; i < HG_TEST_COALESCE_COUNT; i++)
+        if (handles[i] != NULL)
+            (void) HG_Destroy(handles[i]);
+    if (self_addr != HG_ADDR_NULL)
+        (void) HG_Addr_free(hg_class, self_addr);
+    if (context != NULL)
+        (void) HG_Context_destroy(context);
+    if (hg_class != NULL)
+        (void) HG_Finalize(hg_class);
+
+    return ret;
+}
+
+#ifndef HG_HAS_XDR
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_pair_init(const hg_class_t *parent_class,
+    struct hg_init_info *hg_init_info, struct overflow_rpc_args *rpc_args,
+    struct rpc_pair *pair)
+{
+    char info_string[64], addr_string[256];
+    hg_size_t addr_string_size = sizeof(addr_string);
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_return_t ret;
+
+    memset(pair, 0, sizeof(*pair));
+
+    /* Origin and target are separate listening classes so that requests and
+     * responses always go through NA and can be progressed separately */
+    snprintf(info_string, sizeof(info_string), "%s+%s",
+        HG_Class_get_name(parent_class), HG_Class_get_protocol(parent_class));
+    pair->target_class = HG_Init_opt2(info_string, HG_TRUE,
+        HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), hg_init_info);
+    HG_TEST_CHECK_ERROR(pair->target_class == NULL, error, ret, HG_FAULT,
+        "HG_Init_opt2() failed");
+
+    pair->target_context = HG_Context_create(pair->target_class);
+    HG_TEST_CHECK_ERROR(pair->target_context == NULL, error, ret, HG_FAULT,
+        "HG_Context_create() failed");
+
+    pair->origin_class = HG_Init_opt2(info_string, HG_TRUE,
+        HG_VERSION(HG_VERSION_MAJOR, HG_VERSION_MINOR), hg_init_info);
+    HG_TEST_CHECK_ERROR(pair->origin_class == NULL, error, ret, HG_FAULT,
+        "HG_Init_opt2() failed");
+
+    pair->origin_context = HG_Context_create(pair->origin_class);
+    HG_TEST_CHECK_ERROR(pair->origin_context == NULL, error, ret, HG_FAULT,
+        "HG_Context_create() failed");
+
+    /* Responses are larger than what fits into a response message */
+    rpc_args->string_len =
+        HG_Class_get_output_eager_size(pair->target_class) * 2;
+    rpc_args->respond_count = 0;
+    rpc_args->respond_ret = HG_OTHER_ERROR;
+
+    pair->rpc_id = HG_Register_name(pair->target_class, "hg_test_overflow",
+        hg_proc_hg_uint32_t, hg_proc_overflow_out_t, hg_test_overflow_rpc_cb);
+    HG_TEST_CHECK_ERROR(pair->rpc_id == 0, error, ret, HG_FAULT,
+        "HG_Register_name() failed");
+
+    ret = HG_Register_data(pair->target_class, pair->rpc_id, rpc_args, NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Register_data() failed (%s)", HG_Error_to_string(ret));
+
+    HG_TEST_CHECK_ERROR(HG_Register_name(pair->origin_class,
+                            "hg_test_overflow", hg_proc_hg_uint32_t,
+                            hg_proc_overflow_out_t, NULL) != pair->rpc_id,
+        error, ret, HG_FAULT, "HG_Register_name() failed");
+
+    ret = HG_Addr_self(pair->target_class, &self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_self() failed (%s)", HG_Error_to_string(ret));
+
+    ret = HG_Addr_to_string(
+        pair->target_class, addr_string, &addr_string_size, self_addr);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Addr_to_string() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Addr_free(pair->target_class, self_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_free() failed (%s)", HG_Error_to_string(ret));
+    self_addr = HG_ADDR_NULL;
+
+    ret = HG_Addr_lookup2(pair->origin_class, addr_string, &pair->target_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_lookup2() failed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    if (self_addr != HG_ADDR_NULL)
+        (void) HG_Addr_free(pair->target_class, self_addr);
+    (void) hg_test_rpc_pair_cleanup(pair);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_pair_cleanup(struct rpc_pair *pair)
+{
+    hg_return_t ret, cleanup_ret = HG_SUCCESS;
+
+    if (pair->target_addr != HG_ADDR_NULL) {
+        ret = HG_Addr_free(pair->origin_class, pair->target_addr);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Addr_free() failed (%s)", HG_Error_to_string(ret));
+        if (cleanup_ret == HG_SUCCESS)
+            cleanup_ret = ret;
+        pair->target_addr = HG_ADDR_NULL;
+    }
+    if (pair->origin_context != NULL) {
+        ret = HG_Context_destroy(pair->origin_context);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Context_destroy() failed (%s)", HG_Error_to_string(ret));
+        if (cleanup_ret == HG_SUCCESS)
+            cleanup_ret = ret;
+        pair->origin_context = NULL;
+    }
+    if (pair->origin_class != NULL) {
+        ret = HG_Finalize(pair->origin_class);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Finalize() failed (%s)", HG_Error_to_string(ret));
+        if (cleanup_ret == HG_SUCCESS)
+            cleanup_ret = ret;
+        pair->origin_class = NULL;
+    }
+    if (pair->target_context != NULL) {
+        ret = HG_Context_destroy(pair->target_context);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Context_destroy() failed (%s)", HG_Error_to_string(ret));
+        if (cleanup_ret == HG_SUCCESS)
+            cleanup_ret = ret;
+        pair->target_context = NULL;
+    }
+    if (pair->target_class != NULL) {
+        ret = HG_Finalize(pair->target_class);
+        HG_TEST_CHECK_ERROR_DONE(ret != HG_SUCCESS,
+            "HG_Finalize() failed (%s)", HG_Error_to_string(ret));
+        if (cleanup_ret == HG_SUCCESS)
+            cleanup_ret = ret;
+        pair->target_class = NULL;
+    }
+
+    return cleanup_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_pair_wait(struct rpc_pair *pair, bool origin,
+    const int32_t *count, int32_t expected)
+{
+    hg_time_t deadline, now;
+    hg_return_t ret;
+
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(HG_TEST_WAIT_TIMEOUT));
+    while (*count < expected && hg_time_less(now, deadline)) {
+        unsigned int actual_count = 0;
+
+        /* Origin is left alone when only the target must make progress */
+        if (origin) {
+            ret = HG_Progress(pair->origin_context, 0);
+            HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+                ret, ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+
+            do {
+                ret = HG_Trigger(pair->origin_context, 0, 1, &actual_count);
+            } while (ret == HG_SUCCESS && actual_count);
+        }
+
+        ret = HG_Progress(pair->target_context, 10);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error, ret,
+            ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+
+        do {
+            ret = HG_Trigger(pair->target_context, 0, 1, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count);
+
+        hg_time_get_current_ms(&now);
+    }
+
+    return (*count < expected) ? HG_TIMEOUT : HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_overflow_rpc_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    struct overflow_rpc_args *args = (struct overflow_rpc_args *)
+        HG_Registered_data(hg_info->hg_class, hg_info->id);
+    overflow_out_t out_struct;
+    hg_string_t string;
+    hg_return_t ret;
+
+    string = (hg_string_t) malloc(args->string_len + 1);
+    HG_TEST_CHECK_ERROR(
+        string == NULL, done, ret, HG_NOMEM_ERROR, "Could not allocate string");
+
+    memset(string, 'h', args->string_len);
+    string[args->string_len] = '\0';
+
+    out_struct.string = string;
+    out_struct.string_len = args->string_len;
+
+    ret = HG_Respond(handle, hg_test_overflow_respond_cb, args, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Respond() failed (%s)", HG_Error_to_string(ret));
+
+done:
+    (void) HG_Destroy(handle);
+    free(string);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_overflow_respond_cb(const struct hg_cb_info *callback_info)
+{
+    struct overflow_rpc_args *args =
+        (struct overflow_rpc_args *) callback_info->arg;
+
+    args->respond_ret = callback_info->ret;
+    args->respond_count++;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_overflow_forward_cb(const struct hg_cb_info *callback_info)
+{
+    hg_handle_t handle = callback_info->info.forward.handle;
+    struct overflow_cb_args *args =
+        (struct overflow_cb_args *) callback_info->arg;
+    overflow_out_t out_struct;
+    hg_return_t ret = callback_info->ret;
+
+    HG_TEST_CHECK_HG_ERROR(done, ret, "Error in HG callback (%s)",
+        HG_Error_to_string(callback_info->ret));
+
+    ret = HG_Get_output(handle, &out_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        done, ret, "HG_Get_output() failed (%s)", HG_Error_to_string(ret));
+
+    if (out_struct.string_len != args->string_len ||
+        out_struct.string == NULL ||
+        strspn(out_struct.string, "h") != args->string_len) {
+        HG_TEST_LOG_ERROR("Output string does not match (length %" PRIu64
+                          ", expected %zu)",
+            out_struct.string_len, args->string_len);
+        ret = HG_FAULT;
+    }
+
+    (void) HG_Free_output(handle, &out_struct);
+
+done:
+    args->ret = ret;
+    (*args->complete_count)++;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_lease(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct overflow_rpc_args rpc_args;
+    struct overflow_cb_args cb_args[2];
+    hg_handle_t handles[2] = {NULL};
+    struct rpc_pair pair;
+    int32_t complete_count = 0;
+    hg_return_t ret;
+    int i, j;
+
+    ret = hg_test_rpc_pair_init(parent_class, &hg_init_info, &rpc_args, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_rpc_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    for (i = 0; i < 2; i++) {
+        cb_args[i].string_len = rpc_args.string_len;
+        cb_args[i].ret = HG_OTHER_ERROR;
+        cb_args[i].complete_count = &complete_count;
+
+        ret = HG_Create(
+            pair.origin_context, pair.target_addr, pair.rpc_id, &handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+    }
+
+    /* Origin pulls the output of the first request and defers its ack */
+    ret = HG_Forward(
+        handles[0], hg_test_overflow_forward_cb, &cb_args[0], NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_rpc_pair_wait(&pair, true, &complete_count, 1);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_rpc_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(rpc_args.respond_count != 0, error, ret, HG_FAULT,
+        "Response completed before its output was released");
+
+    /* Deferred acks are only sent explicitly when the origin makes progress,
+     * the next request must release the output of the first one */
+    ret = HG_Forward(
+        handles[1], hg_test_overflow_forward_cb, &cb_args[1], NULL);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_rpc_pair_wait(&pair, false, &rpc_args.respond_count, 1);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "Output of first request was not released (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_test_rpc_pair_wait(&pair, true, &complete_count, 2);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_rpc_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* No request follows the second one, its ack is held back by the origin
+     * and only sent once its delay expires */
+    for (j = 0; j < 4; j++) {
+        ret = HG_Progress(pair.target_context, 10);
+        HG_TEST_CHECK_ERROR(ret != HG_SUCCESS && ret != HG_TIMEOUT, error, ret,
+            ret, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+        (void) HG_Trigger(pair.target_context, 0, 1, NULL);
+    }
+    HG_TEST_CHECK_ERROR(rpc_args.respond_count != 1, error, ret, HG_FAULT,
+        "Response completed before its ack was sent");
+
+    ret = hg_test_rpc_pair_wait(&pair, true, &rpc_args.respond_count, 2);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "Ack of second request was not sent (%s)", HG_Error_to_string(ret));
+
+    for (i = 0; i < 2; i++)
+        HG_TEST_CHECK_ERROR(cb_args[i].ret != HG_SUCCESS, error, ret, HG_FAULT,
+            "Request %d failed (%s)", i, HG_Error_to_string(cb_args[i].ret));
+    HG_TEST_CHECK_ERROR(rpc_args.respond_ret != HG_SUCCESS, error, ret,
+        HG_FAULT, "Response failed (%s)",
+        HG_Error_to_string(rpc_args.respond_ret));
+
+    for (i = 0; i < 2; i++) {
+        ret = HG_Destroy(handles[i]);
+        HG_TEST_CHECK_HG_ERROR(
+            error, ret, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+        handles[i] = NULL;
+    }
+
+    ret = hg_test_rpc_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_rpc_pair_cleanup() failed (%s)",
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    for (i = 0; i < 2; i++)
+        if (handles[i] != NULL)
+            (void) HG_Destroy(handles[i]);
+    (void) hg_test_rpc_pair_cleanup(&pair);
+
+    return ret;
+}
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_out_region(const hg_class_t *parent_class)
+{
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct overflow_rpc_args rpc_args;
+    struct overflow_cb_args cb_args;
+    struct hg_peer_stats origin_stats, target_stats;
+    hg_handle_t handle = NULL;
+    hg_addr_t origin_addr = HG_ADDR_NULL;
+    unsigned int peer_count = 1;
+    struct rpc_pair pair;
+    hg_uint32_t in_struct = 0;
+    int32_t complete_count = 0;
+    hg_return_t ret;
+
+    /* Bulk traffic tells whether the output was pushed or pulled */
+    hg_init_info.peer_stats_max = 1;
+    ret = hg_test_rpc_pair_init(parent_class, &hg_init_info, &rpc_args, &pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_rpc_pair_init() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = HG_Registered_out_region(
+        pair.origin_class, pair.rpc_id, rpc_args.string_len * 2);
+    HG_TEST_CHECK_HG_ERROR(error, ret,
+        "HG_Registered_out_region() failed (%s)", HG_Error_to_string(ret));
+
+    cb_args.string_len = rpc_args.string_len;
+    cb_args.ret = HG_OTHER_ERROR;
+    cb_args.complete_count = &complete_count;
+
+    ret = HG_Create(
+        pair.origin_context, pair.target_addr, pair.rpc_id, &handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Create() failed (%s)", HG_Error_to_string(ret));
+
+    /* Region is advertised along with the input */
+    ret = HG_Forward(handle, hg_test_overflow_forward_cb, &cb_args, &in_struct);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Forward() failed (%s)", HG_Error_to_string(ret));
+
+    ret = hg_test_rpc_pair_wait(&pair, true, &complete_count, 1);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_rpc_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+
+    ret = hg_test_rpc_pair_wait(&pair, true, &rpc_args.respond_count, 1);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_rpc_pair_wait() failed (%s)",
+        HG_Error_to_string(ret));
+
+    HG_TEST_CHECK_ERROR(cb_args.ret != HG_SUCCESS, error, ret, HG_FAULT,
+        "Request failed (%s)", HG_Error_to_string(cb_args.ret));
+    HG_TEST_CHECK_ERROR(rpc_args.respond_ret != HG_SUCCESS, error, ret,
+        HG_FAULT, "Response failed (%s)",
+        HG_Error_to_string(rpc_args.respond_ret));
+
+    /* Output must have been written by the target into the region, not
+     * pulled by the origin */
+    ret = HG_Class_get_peer_stats(
+        pair.origin_class, pair.target_addr, &origin_stats);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Class_get_peer_stats() failed (%s)",
+        HG_Error_to_string(ret));
+
+    /* Origin is the only peer of the target */
+    ret = HG_Class_get_hot_peers(
+        pair.target_class, &origin_addr, &target_stats, &peer_count);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "HG_Class_get_hot_peers() failed (%s)",
+        HG_Error_to_string(ret));
+    HG_TEST_CHECK_ERROR(peer_count != 1, error, ret, HG_FAULT,
+        "Target has %u peers, expected 1", peer_count);
+
+    HG_TEST_CHECK_ERROR(origin_stats.bulk_bytes != 0, error, ret, HG_FAULT,
+        "Origin transferred %" PRIu64 " bytes, expected none",
+        origin_stats.bulk_bytes);
+    HG_TEST_CHECK_ERROR(target_stats.bulk_bytes < rpc_args.string_len, error,
+        ret, HG_FAULT,
+        "Target transferred %" PRIu64 " bytes, expected at least %zu",
+        target_stats.bulk_bytes, rpc_args.string_len);
+
+    ret = HG_Destroy(handle);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Destroy() failed (%s)", HG_Error_to_string(ret));
+    handle = NULL;
+
+    ret = HG_Addr_free(pair.target_class, origin_addr);
+    HG_TEST_CHECK_HG_ERROR(
+        error, ret, "HG_Addr_free() failed (%s)", HG_Error_to_string(ret));
+    origin_addr = HG_ADDR_NULL;
+
+    ret = hg_test_rpc_pair_cleanup(&pair);
+    HG_TEST_CHECK_HG_ERROR(error, ret, "hg_test_rpc_pair_cleanup() failed (%s)",
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    if (handle != NULL)
+        (void) HG_Destroy(handle);
+    if (origin_addr != HG_ADDR_NULL)
+        (void) HG_Addr_free(pair.target_class, origin_addr);
+    (void) hg_test_rpc_pair_cleanup(&pair);
+
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_unit_info info;
+    hg_return_t hg_ret;
+    hg_id_t inv_id;
+
+    /* Initialize the interface */
+    hg_ret = hg_unit_init(argc, argv, false, &info);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_unit_init() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    /* NULL RPC test */
+    HG_TEST("NULL RPC");
+    hg_ret = hg_test_rpc_no_input(info.handles[0], info.target_addr,
+        hg_test_rpc_null_id_g, hg_test_rpc_no_output_cb, info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_no_input() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+    /* Simple RPC test */
+    HG_TEST("RPC with response");
+    hg_ret = hg_test_rpc_input(info.handles[0], info.target_addr,
+        hg_test_rpc_open_id_g, hg_test_rpc_output_cb, info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_input() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+    /* RPC stats test */
+    HG_TEST("RPC stats");
+    hg_ret = hg_test_rpc_stats(info.hg_class, hg_test_rpc_open_id_g);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_stats() failed (%s)",
         HG_Error_to_string(hg_ret));
     HG_PASSED();
 
+    /* Progress stats test */
+    HG_TEST("progress stats");
+    hg_ret = hg_test_progress_stats(info.context);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+        "hg_test_progress_stats() failed (%s)", HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+    /* Execution model test on single-threaded class */
+    HG_TEST("exec on single_thread class");
+    hg_ret =
+        hg_test_exec_single_thread(info.hg_test_info.na_test_info.na_class);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+        "hg_test_exec_single_thread() failed (%s)", HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+    /* Cancelation of coalesced request, target is the class itself */
+    if (info.hg_test_info.na_test_info.self_send) {
+        HG_TEST("coalesced RPC cancelation");
+        hg_ret = hg_test_rpc_coalesce_cancel(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_rpc_coalesce_cancel() failed (%s)",
+            HG_Error_to_string(hg_ret));
+        HG_PASSED();
+    }
+
+#ifndef HG_HAS_XDR
+    /* Extra response data, target is a separate class */
+    if (info.hg_test_info.na_test_info.self_send) {
+        HG_TEST("RPC output release");
+        hg_ret = hg_test_rpc_lease(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_rpc_lease() failed (%s)", HG_Error_to_string(hg_ret));
+        HG_PASSED();
+
+        HG_TEST("RPC output region");
+        hg_ret = hg_test_rpc_out_region(info.hg_class);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_rpc_out_region() failed (%s)", HG_Error_to_string(hg_ret));
+        HG_PASSED();
+    }
+#endif
+
+    /* RPC test with lookup/free */
+    if (!info.hg_test_info.na_test_info.self_send &&
+        strcmp(HG_Class_get_name(info.hg_class), "mpi")) {
+        int i;
+
+        hg_ret = HG_Addr_set_remove(info.hg_class, info.target_addr);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "HG_Addr_set_remove() failed (%s)", HG_Error_to_string(hg_ret));
+
+        hg_ret = HG_Addr_free(info.hg_class, info.target_addr);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Addr_free() failed (%s)",
+            HG_Error_to_string(hg_ret));
+        info.target_addr = HG_ADDR_NULL;
+
+        HG_TEST("RPC with multiple lookup/free");
+        for (i = 0; i < 32; i++) {
+            hg_ret = HG_Addr_lookup2(info.hg_class,
+                info.hg_test_info.na_test_info.target_name, &info.target_addr);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                "HG_Addr_lookup2() failed (%s)", HG_Error_to_string(hg_ret));
+
+            hg_ret = hg_test_rpc_input(info.handles[0], info.target_addr,
+                hg_test_rpc_open_id_g, hg_test_rpc_output_cb, info.request);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                "hg_test_rpc_input() failed (%s)", HG_Error_to_string(hg_ret));
+
+            hg_ret = HG_Addr_set_remove(info.hg_class, info.target_addr);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+                "HG_Addr_set_remove() failed (%s)", HG_Error_to_string(hg_ret));
+
+            hg_ret = HG_Addr_free(info.hg_class, info.target_addr);
+            HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Addr_free() failed (%s)",
+                HG_Error_to_string(hg_ret));
+            info.target_addr = HG_ADDR_NULL;
+        }
+        HG_PASSED();
+
+        hg_ret = HG_Addr_lookup2(info.hg_class,
+            info.hg_test_info.na_test_info.target_name, &info.target_addr);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Addr_lookup2() failed (%s)",
+            HG_Error_to_string(hg_ret));
+    }
+
+    /* RPC test with no response */
+    HG_TEST("RPC without response");
+    hg_ret = hg_test_rpc_input(info.handles[0], info.target_addr,
+        hg_test_rpc_open_id_no_resp_g, hg_test_rpc_no_output_cb, info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_input() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+    /* RPC test with unregistered ID */
+    inv_id = MERCURY_REGISTER(info.hg_class, "unreg_id", void, void, NULL);
+    HG_TEST_CHECK_ERROR_NORET(inv_id == 0, error, "HG_Register() failed");
+    hg_ret = HG_Deregister(info.hg_class, inv_id);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "HG_Deregister() failed (%s)",
+        HG_Error_to_string(hg_ret));
+
+    HG_TEST("RPC with unregistered ID");
+    HG_Test_log_disable(); // Expected to produce errors
+    hg_ret = hg_test_rpc_input(info.handles[0], info.target_addr, inv_id,
+        hg_test_rpc_output_cb, info.request);
+    HG_Test_log_enable();
+    HG_TEST_CHECK_ERROR_NORET(hg_ret != HG_NOENTRY, error,
+        "hg_test_rpc_input() failed (%s, expected %s)",
+        HG_Error_to_string(hg_ret), HG_Error_to_string(HG_NOENTRY));
+    HG_PASSED();
+
+    if (!info.hg_test_info.na_test_info.self_send) {
+        /* RPC test with invalid ID (not registered on server) */
+        inv_id = MERCURY_REGISTER(info.hg_class, "inv_id", void, void, NULL);
+        HG_TEST_CHECK_ERROR_NORET(inv_id == 0, error, "HG_Register() failed");
+
+        HG_TEST("RPC not registered on server");
+        hg_ret = hg_test_rpc_inv(
+            info.handles[0], info.target_addr, inv_id, info.request);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_inv() failed (%s)",
+            HG_Error_to_string(hg_ret));
+        HG_PASSED();
+    }
+
+#ifndef HG_HAS_XDR
+    /* Overflow RPC test */
+    HG_TEST("RPC with output overflow");
+    hg_ret = hg_test_rpc_no_input(info.handles[0], info.target_addr,
+        hg_test_overflow_id_g, hg_test_rpc_output_overflow_cb, info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_no_input() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    HG_PASSED();
+#endif
+
+    /* Cancel RPC test (self cancelation is not supported) */
+    if (!info.hg_test_info.na_test_info.self_send) {
+        HG_TEST("RPC cancelation");
+        hg_ret = hg_test_rpc_cancel(info.handles[0], info.target_addr,
+            hg_test_cancel_rpc_id_g, hg_test_rpc_no_output_cb, info.request);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_rpc_cancel() failed (%s)", HG_Error_to_string(hg_ret));
+        HG_PASSED();
+
+        HG_TEST("RPC timeout");
+        hg_ret = hg_test_rpc_timeout(info.handles[0], info.target_addr,
+            hg_test_cancel_rpc_id_g, hg_test_rpc_no_output_cb, info.request);
+        HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+            "hg_test_rpc_timeout() failed (%s)", HG_Error_to_string(hg_ret));
+        HG_PASSED();
+    }
+
+    /* RPC test with multiple handle in flight */
+    HG_TEST("concurrent RPCs");
+    hg_ret = hg_test_rpc_multi(info.handles, info.handle_max, info.target_addr,
+        0, hg_test_rpc_open_id_g, hg_test_rpc_multi_cb, info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret, "hg_test_rpc_multiple() failed (%s)",
+        HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+    /* Persistent handle test */
+    HG_TEST("persistent RPC handle");
+    hg_ret = hg_test_rpc_persistent(info.context, info.target_addr,
+        hg_test_rpc_open_id_g, 16, hg_test_rpc_output_cb, info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+        "hg_test_rpc_persistent() failed (%s)", HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+    /* Fan-out RPC test */
+    HG_TEST("fan-out RPC");
+    hg_ret = hg_test_rpc_forward_multi(info.context, info.target_addr,
+        hg_test_rpc_open_id_g, 8, 0, hg_test_rpc_forward_multi_cb,
+        info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+        "hg_test_rpc_forward_multi() failed (%s)", HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+#ifndef HG_HAS_XDR
+    /* Fan-out RPC test through a tree */
+    HG_TEST("tree fan-out RPC");
+    hg_ret = hg_test_rpc_forward_multi(info.context, info.target_addr,
+        hg_test_rpc_open_id_g, 8, 2, hg_test_rpc_forward_multi_cb,
+        info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+        "hg_test_rpc_forward_multi() failed (%s)", HG_Error_to_string(hg_ret));
+    HG_PASSED();
+
+    /* Fan-out RPC test with reduced outputs */
+    HG_TEST("reduced fan-out RPC");
+    hg_ret = hg_test_rpc_forward_multi(info.context, info.target_addr,
+        hg_test_rpc_open_reduce_id_g, 8, 0,
+        hg_test_rpc_forward_multi_reduce_cb, info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+        "hg_test_rpc_forward_multi() failed (%s)", HG_Error_to_string(hg_ret));
+    hg_ret = hg_test_rpc_forward_multi(info.context, info.target_addr,
+        hg_test_rpc_open_reduce_id_g, 8, 2,
+        hg_test_rpc_forward_multi_reduce_cb, info.request);
+    HG_TEST_CHECK_HG_ERROR(error, hg_ret,
+        "hg_test_rpc_forward_multi() failed (%s)", HG_Error_to_string(hg_ret));
+    HG_PASSED();
+#endif
+
     /* RPC test with multiple handle to multiple target contexts */
     if (info.hg_test_info.na_test_info.max_contexts) {
         hg_uint8_t i,
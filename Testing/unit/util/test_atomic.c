@@ -199,6 +199,22 @@ main(void)
         goto done;
     }
 
+    /* Add64 test */
+    val64 = hg_atomic_add64(&atomic_int64, 5);
+    if (val64 != 7) {
+        fprintf(stderr,
+            "Error in hg_atomic_add64: atomic value is %" PRId64 "\n", val64);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    val64 = hg_atomic_add64(&atomic_int64, -5);
+    if (val64 != 2) {
+        fprintf(stderr,
+            "Error in hg_atomic_add64: atomic value is %" PRId64 "\n", val64);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
     /* Or64 test */
     init_val64 = hg_atomic_get64(&atomic_int64);
     val64 = hg_atomic_or64(&atomic_int64, 8);
@@ -6,7 +6,10 @@
  */
 
 #include "mercury_atomic_queue.h"
+#include "mercury_thread.h"
+#include "mercury_time.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -16,6 +19,141 @@ struct my_entry {
 
 #define HG_TEST_QUEUE_SIZE 16
 
+/* Benchmark parameters */
+#define HG_TEST_BENCH_QUEUE_SIZE 1024
+#define HG_TEST_BENCH_ITEMS      (1 << 14) /* Per producer */
+#define HG_TEST_BENCH_BATCH      16
+#define HG_TEST_BENCH_THREAD_MAX 4
+
+struct hg_test_bench {
+    struct hg_atomic_queue *queue;
+    hg_atomic_int64_t popped;
+    int64_t total;
+    bool batch;
+    bool single; /* Single producer / single consumer variants */
+};
+
+static HG_THREAD_RETURN_TYPE
+hg_test_bench_produce(void *arg)
+{
+    struct hg_test_bench *bench = (struct hg_test_bench *) arg;
+    void *entries[HG_TEST_BENCH_BATCH];
+    unsigned int n = 0, i;
+
+    while (n < HG_TEST_BENCH_ITEMS) {
+        if (bench->batch) {
+            unsigned int count = HG_TEST_BENCH_ITEMS - n, pushed;
+
+            if (count > HG_TEST_BENCH_BATCH)
+                count = HG_TEST_BENCH_BATCH;
+            for (i = 0; i < count; i++)
+                entries[i] = (void *) (uintptr_t) (n + i + 1);
+            pushed = (bench->single)
+                         ? hg_atomic_queue_push_sp_batch(
+                               bench->queue, entries, count)
+                         : hg_atomic_queue_push_batch(
+                               bench->queue, entries, count);
+            if (pushed == 0)
+                hg_thread_yield();
+            n += pushed;
+        } else if (hg_atomic_queue_push(bench->queue,
+                       (void *) (uintptr_t) (n + 1)) == HG_UTIL_SUCCESS)
+            n++;
+        else
+            hg_thread_yield();
+    }
+
+    return (HG_THREAD_RETURN_TYPE) 0;
+}
+
+static HG_THREAD_RETURN_TYPE
+hg_test_bench_consume(void *arg)
+{
+    struct hg_test_bench *bench = (struct hg_test_bench *) arg;
+    void *entries[HG_TEST_BENCH_BATCH];
+
+    while (hg_atomic_get64(&bench->popped) < bench->total) {
+        unsigned int count;
+
+        if (bench->batch)
+            count = (bench->single)
+                        ? hg_atomic_queue_pop_sc_batch(
+                              bench->queue, entries, HG_TEST_BENCH_BATCH)
+                        : hg_atomic_queue_pop_mc_batch(
+                              bench->queue, entries, HG_TEST_BENCH_BATCH);
+        else
+            count = (hg_atomic_queue_pop_mc(bench->queue) != NULL) ? 1 : 0;
+
+        if (count == 0) {
+            hg_thread_yield();
+            continue;
+        }
+        hg_atomic_add64(&bench->popped, (int64_t) count);
+    }
+
+    return (HG_THREAD_RETURN_TYPE) 0;
+}
+
+static int
+hg_test_bench_run(unsigned int nprod, unsigned int ncons, bool batch,
+    bool single, double *rate)
+{
+    hg_thread_t threads[2 * HG_TEST_BENCH_THREAD_MAX];
+    struct hg_test_bench bench;
+    hg_time_t t1, t2;
+    unsigned int i;
+
+    bench.queue = hg_atomic_queue_alloc(HG_TEST_BENCH_QUEUE_SIZE);
+    if (bench.queue == NULL)
+        return HG_UTIL_FAIL;
+    hg_atomic_init64(&bench.popped, 0);
+    bench.total = (int64_t) (nprod * HG_TEST_BENCH_ITEMS);
+    bench.batch = batch;
+    bench.single = single;
+
+    hg_time_get_current(&t1);
+    for (i = 0; i < ncons; i++)
+        hg_thread_create(&threads[i], hg_test_bench_consume, &bench);
+    for (i = 0; i < nprod; i++)
+        hg_thread_create(&threads[ncons + i], hg_test_bench_produce, &bench);
+    for (i = 0; i < nprod + ncons; i++)
+        hg_thread_join(threads[i]);
+    hg_time_get_current(&t2);
+
+    *rate = (double) bench.total / hg_time_to_double(hg_time_subtract(t2, t1));
+
+    hg_atomic_queue_free(bench.queue);
+
+    return (hg_atomic_get64(&bench.popped) == bench.total) ? HG_UTIL_SUCCESS
+                                                           : HG_UTIL_FAIL;
+}
+
+static int
+hg_test_bench(void)
+{
+    unsigned int threads[] = {1, 2, HG_TEST_BENCH_THREAD_MAX};
+    double single_rate, batch_rate, spsc_rate;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        if (hg_test_bench_run(threads[i], threads[i], false, false,
+                &single_rate) != HG_UTIL_SUCCESS ||
+            hg_test_bench_run(threads[i], threads[i], true, false,
+                &batch_rate) != HG_UTIL_SUCCESS)
+            return HG_UTIL_FAIL;
+        printf("%u producer(s) / %u consumer(s): single %.2f Mops/s, batch "
+               "%.2f Mops/s\n",
+            threads[i], threads[i], single_rate / 1e6, batch_rate / 1e6);
+    }
+
+    if (hg_test_bench_run(1, 1, true, true, &spsc_rate) != HG_UTIL_SUCCESS)
+        return HG_UTIL_FAIL;
+    printf("1 producer / 1 consumer: spsc batch %.2f Mops/s\n",
+        spsc_rate / 1e6);
+
+    return HG_UTIL_SUCCESS;
+}
+
 int
 main(void)
 {
@@ -25,6 +163,9 @@ main(void)
     struct my_entry my_entry1 = {.value = value1};
     struct my_entry my_entry2 = {.value = value2};
     struct my_entry *my_entry_ptr;
+    struct my_entry my_entries[HG_TEST_QUEUE_SIZE];
+    void *entries[HG_TEST_QUEUE_SIZE];
+    unsigned int count, i;
 
     hg_atomic_queue = hg_atomic_queue_alloc(HG_TEST_QUEUE_SIZE);
     if (!hg_atomic_queue) {
@@ -62,6 +203,98 @@ main(void)
         goto done;
     }
 
+    /* Batch pop, wrap around the end of the ring */
+    for (i = 0; i < HG_TEST_QUEUE_SIZE - 1; i++) {
+        my_entries[i].value = (int) i;
+        if (hg_atomic_queue_push(hg_atomic_queue, &my_entries[i]) !=
+            HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not push entry %u\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    count = hg_atomic_queue_pop_mc_batch(hg_atomic_queue, entries, 4);
+    if (count != 4) {
+        fprintf(stderr, "Error: expected 4 entries, got %u\n", count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    count += hg_atomic_queue_pop_mc_batch(
+        hg_atomic_queue, entries + count, HG_TEST_QUEUE_SIZE);
+    if (count != HG_TEST_QUEUE_SIZE - 1) {
+        fprintf(stderr, "Error: expected %d entries, got %u\n",
+            HG_TEST_QUEUE_SIZE - 1, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < count; i++) {
+        my_entry_ptr = (struct my_entry *) entries[i];
+        if (my_entry_ptr->value != (int) i) {
+            fprintf(stderr, "Error: values do not match, expected %u, got %d\n",
+                i, my_entry_ptr->value);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+    if (!hg_atomic_queue_is_empty(hg_atomic_queue) ||
+        hg_atomic_queue_pop_mc_batch(hg_atomic_queue, entries, 1) != 0) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Batch push, only HG_TEST_QUEUE_SIZE - 1 entries fit */
+    for (i = 0; i < HG_TEST_QUEUE_SIZE; i++) {
+        my_entries[i].value = (int) i;
+        entries[i] = &my_entries[i];
+    }
+    count = hg_atomic_queue_push_batch(hg_atomic_queue, entries, 8);
+    count += hg_atomic_queue_push_sp_batch(
+        hg_atomic_queue, entries + count, HG_TEST_QUEUE_SIZE - count);
+    if (count != HG_TEST_QUEUE_SIZE - 1 ||
+        hg_atomic_queue_count(hg_atomic_queue) != HG_TEST_QUEUE_SIZE - 1) {
+        fprintf(stderr, "Error: expected %d entries pushed, got %u\n",
+            HG_TEST_QUEUE_SIZE - 1, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_atomic_queue_push_batch(hg_atomic_queue, entries, 1) != 0) {
+        fprintf(stderr, "Error: queue should be full\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    count = hg_atomic_queue_pop_sc_batch(
+        hg_atomic_queue, entries, HG_TEST_QUEUE_SIZE);
+    if (count != HG_TEST_QUEUE_SIZE - 1) {
+        fprintf(stderr, "Error: expected %d entries, got %u\n",
+            HG_TEST_QUEUE_SIZE - 1, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < count; i++) {
+        my_entry_ptr = (struct my_entry *) entries[i];
+        if (my_entry_ptr->value != (int) i) {
+            fprintf(stderr, "Error: values do not match, expected %u, got %d\n",
+                i, my_entry_ptr->value);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+    if (hg_atomic_queue_pop_sc_batch(hg_atomic_queue, entries, 1) != 0) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Throughput of single and batch paths */
+    if (hg_test_bench() != HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: benchmark failed\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
 done:
     hg_atomic_queue_free(hg_atomic_queue);
     return ret;
@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_atomic.h"
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_thread.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HG_TEST_SEG_COUNT 4
+#define HG_TEST_ENTRIES   (4 * HG_TEST_SEG_COUNT + 1)
+
+/* Stress parameters */
+#define HG_TEST_STRESS_ITEMS   (1 << 14) /* Per producer */
+#define HG_TEST_STRESS_BATCH   8
+#define HG_TEST_STRESS_THREADS 4
+
+struct hg_test_stress {
+    struct hg_atomic_seg_queue *queue;
+    hg_atomic_int64_t popped;
+    hg_atomic_int64_t sum;
+    int64_t total;
+};
+
+static HG_THREAD_RETURN_TYPE
+hg_test_stress_produce(void *arg)
+{
+    struct hg_test_stress *stress = (struct hg_test_stress *) arg;
+    unsigned int i;
+
+    for (i = 1; i <= HG_TEST_STRESS_ITEMS; i++)
+        if (hg_atomic_seg_queue_push(stress->queue, (void *) (uintptr_t) i) !=
+            HG_UTIL_SUCCESS)
+            break;
+
+    return (HG_THREAD_RETURN_TYPE) 0;
+}
+
+static HG_THREAD_RETURN_TYPE
+hg_test_stress_consume(void *arg)
+{
+    struct hg_test_stress *stress = (struct hg_test_stress *) arg;
+    void *entries[HG_TEST_STRESS_BATCH];
+
+    while (hg_atomic_get64(&stress->popped) < stress->total) {
+        unsigned int count, i;
+
+        count = hg_atomic_seg_queue_pop_batch(
+            stress->queue, entries, HG_TEST_STRESS_BATCH);
+        if (count == 0) {
+            hg_thread_yield();
+            continue;
+        }
+        for (i = 0; i < count; i++)
+            hg_atomic_add64(&stress->sum, (int64_t) (uintptr_t) entries[i]);
+        hg_atomic_add64(&stress->popped, (int64_t) count);
+    }
+
+    return (HG_THREAD_RETURN_TYPE) 0;
+}
+
+static int
+hg_test_stress(void)
+{
+    hg_thread_t threads[2 * HG_TEST_STRESS_THREADS];
+    struct hg_test_stress stress;
+    int64_t expected_sum;
+    unsigned int i;
+    int ret = HG_UTIL_SUCCESS;
+
+    /* Small segments so that segments are constantly appended and retired */
+    stress.queue = hg_atomic_seg_queue_alloc(64);
+    if (stress.queue == NULL)
+        return HG_UTIL_FAIL;
+    hg_atomic_init64(&stress.popped, 0);
+    hg_atomic_init64(&stress.sum, 0);
+    stress.total = (int64_t) HG_TEST_STRESS_THREADS * HG_TEST_STRESS_ITEMS;
+
+    for (i = 0; i < HG_TEST_STRESS_THREADS; i++)
+        hg_thread_create(&threads[i], hg_test_stress_consume, &stress);
+    for (i = 0; i < HG_TEST_STRESS_THREADS; i++)
+        hg_thread_create(&threads[HG_TEST_STRESS_THREADS + i],
+            hg_test_stress_produce, &stress);
+    for (i = 0; i < 2 * HG_TEST_STRESS_THREADS; i++)
+        hg_thread_join(threads[i]);
+
+    /* Every entry must have been popped exactly once */
+    expected_sum = (int64_t) HG_TEST_STRESS_THREADS * HG_TEST_STRESS_ITEMS *
+                   (HG_TEST_STRESS_ITEMS + 1) / 2;
+    if (hg_atomic_get64(&stress.popped) != stress.total ||
+        hg_atomic_get64(&stress.sum) != expected_sum ||
+        !hg_atomic_seg_queue_is_empty(stress.queue)) {
+        fprintf(stderr, "Error: popped %" PRId64 " entries (sum %" PRId64
+                        "), expected %" PRId64 " (sum %" PRId64 ")\n",
+            hg_atomic_get64(&stress.popped), hg_atomic_get64(&stress.sum),
+            stress.total, expected_sum);
+        ret = HG_UTIL_FAIL;
+    }
+
+    hg_atomic_seg_queue_free(stress.queue);
+
+    return ret;
+}
+
+int
+main(void)
+{
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue;
+    int my_entries[HG_TEST_ENTRIES];
+    void *entries[HG_TEST_ENTRIES];
+    int ret = EXIT_SUCCESS;
+    unsigned int count, i;
+    int *my_entry_ptr;
+
+    hg_atomic_seg_queue = hg_atomic_seg_queue_alloc(HG_TEST_SEG_COUNT);
+    if (!hg_atomic_seg_queue) {
+        fprintf(stderr, "Error: could not allocate queue\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    if (!hg_atomic_seg_queue_is_empty(hg_atomic_seg_queue) ||
+        hg_atomic_seg_queue_pop(hg_atomic_seg_queue) != NULL) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Push across several segments */
+    for (i = 0; i < HG_TEST_ENTRIES; i++) {
+        my_entries[i] = (int) i;
+        if (hg_atomic_seg_queue_push(hg_atomic_seg_queue, &my_entries[i]) !=
+            HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: could not push entry %u\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+    count = hg_atomic_seg_queue_count(hg_atomic_seg_queue);
+    if (count != HG_TEST_ENTRIES) {
+        fprintf(stderr, "Error: expected %d entries queued, got %u\n",
+            HG_TEST_ENTRIES, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    my_entry_ptr = hg_atomic_seg_queue_pop(hg_atomic_seg_queue);
+    if (my_entry_ptr == NULL || *my_entry_ptr != 0) {
+        fprintf(stderr, "Error: expected first entry\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    count = hg_atomic_seg_queue_pop_batch(
+        hg_atomic_seg_queue, entries, HG_TEST_ENTRIES);
+    if (count != HG_TEST_ENTRIES - 1) {
+        fprintf(stderr, "Error: expected %d entries, got %u\n",
+            HG_TEST_ENTRIES - 1, count);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < count; i++) {
+        my_entry_ptr = (int *) entries[i];
+        if (*my_entry_ptr != (int) i + 1) {
+            fprintf(stderr, "Error: values do not match, expected %u, got %d\n",
+                i + 1, *my_entry_ptr);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+    if (!hg_atomic_seg_queue_is_empty(hg_atomic_seg_queue) ||
+        hg_atomic_seg_queue_count(hg_atomic_seg_queue) != 0 ||
+        hg_atomic_seg_queue_pop_batch(hg_atomic_seg_queue, entries, 1) != 0) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Concurrent producers and consumers */
+    if (hg_test_stress() != HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: stress test failed\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    hg_atomic_seg_queue_free(hg_atomic_seg_queue);
+    return ret;
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_byteswap.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Not a multiple of any vector width so that tails are also processed */
+#define HG_TEST_COUNT (1024 + 7)
+
+static uint32_t src32[HG_TEST_COUNT], dest32[HG_TEST_COUNT];
+static uint64_t src64[HG_TEST_COUNT], dest64[HG_TEST_COUNT];
+static char buf[8 * HG_TEST_COUNT + 8], unaligned[8 * HG_TEST_COUNT + 8];
+
+int
+main(void)
+{
+    size_t i;
+
+    for (i = 0; i < HG_TEST_COUNT; i++) {
+        src32[i] = (uint32_t) (0x01020304 * (i + 1));
+        src64[i] = (uint64_t) 0x0102030405060708 * (i + 1);
+    }
+
+    hg_bswap_32_array(dest32, src32, HG_TEST_COUNT);
+    hg_bswap_64_array(dest64, src64, HG_TEST_COUNT);
+    for (i = 0; i < HG_TEST_COUNT; i++) {
+        if (dest32[i] != bswap_32(src32[i]) ||
+            dest64[i] != bswap_64(src64[i])) {
+            fprintf(stderr, "Error: values do not match at index %zu\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* In place */
+    hg_bswap_32_array(dest32, dest32, HG_TEST_COUNT);
+    hg_bswap_64_array(dest64, dest64, HG_TEST_COUNT);
+    if (memcmp(dest32, src32, sizeof(src32)) != 0 ||
+        memcmp(dest64, src64, sizeof(src64)) != 0) {
+        fprintf(stderr, "Error: in place values do not match\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Unaligned */
+    memcpy(unaligned + 1, src32, sizeof(src32));
+    hg_bswap_32_array(buf + 3, unaligned + 1, HG_TEST_COUNT);
+    hg_bswap_32_array(dest32, buf + 3, HG_TEST_COUNT);
+    memcpy(unaligned + 1, src64, sizeof(src64));
+    hg_bswap_64_array(buf + 3, unaligned + 1, HG_TEST_COUNT);
+    hg_bswap_64_array(dest64, buf + 3, HG_TEST_COUNT);
+    if (memcmp(dest32, src32, sizeof(src32)) != 0 ||
+        memcmp(dest64, src64, sizeof(src64)) != 0) {
+        fprintf(stderr, "Error: unaligned values do not match\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
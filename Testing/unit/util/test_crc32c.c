@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_crc32c.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Not a multiple of any word size so that tails are also processed */
+#define HG_TEST_SIZE (4096 + 13)
+
+static unsigned char buf[HG_TEST_SIZE + 1];
+
+static uint32_t
+crc32c_ref(const unsigned char *p, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    size_t i;
+    int j;
+
+    for (i = 0; i < size; i++) {
+        crc ^= p[i];
+        for (j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78 : 0);
+    }
+
+    return ~crc;
+}
+
+int
+main(void)
+{
+    const char *check = "123456789";
+    uint32_t crc, ref;
+    size_t i;
+
+    /* Standard check value */
+    crc = hg_crc32c(0, check, strlen(check));
+    if (crc != 0xE3069283) {
+        fprintf(stderr, "Error: check value is 0x%08X\n", (unsigned) crc);
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < sizeof(buf); i++)
+        buf[i] = (unsigned char) (i * 7 + 3);
+    ref = crc32c_ref(buf + 1, HG_TEST_SIZE);
+
+    /* Unaligned */
+    crc = hg_crc32c(0, buf + 1, HG_TEST_SIZE);
+    if (crc != ref) {
+        fprintf(stderr, "Error: checksums do not match (0x%08X != 0x%08X)\n",
+            (unsigned) crc, (unsigned) ref);
+        return EXIT_FAILURE;
+    }
+
+    /* In several parts */
+    crc = hg_crc32c(0, buf + 1, 5);
+    crc = hg_crc32c(crc, buf + 6, 1000);
+    crc = hg_crc32c(crc, buf + 1006, HG_TEST_SIZE - 1005);
+    if (crc != ref) {
+        fprintf(stderr, "Error: checksums do not match (0x%08X != 0x%08X)\n",
+            (unsigned) crc, (unsigned) ref);
+        return EXIT_FAILURE;
+    }
+
+    /* Parts checksummed independently */
+    crc = hg_crc32c_combine(hg_crc32c(0, buf + 1, 1005),
+        hg_crc32c(0, buf + 1006, HG_TEST_SIZE - 1005), HG_TEST_SIZE - 1005);
+    crc = hg_crc32c_combine(hg_crc32c(0, NULL, 0), crc, HG_TEST_SIZE);
+    if (crc != ref) {
+        fprintf(stderr, "Error: checksums do not match (0x%08X != 0x%08X)\n",
+            (unsigned) crc, (unsigned) ref);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
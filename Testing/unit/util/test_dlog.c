@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_dlog.h"
+#include "mercury_thread.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HG_TEST_LESIZE  64
+#define HG_TEST_THREADS 4
+#define HG_TEST_ADDS    (2 * HG_TEST_LESIZE)
+
+static struct hg_dlog_entry test_le[HG_TEST_LESIZE];
+static struct hg_dlog test_dlog =
+    HG_DLOG_INITIALIZER("test", test_le, HG_TEST_LESIZE, 0);
+
+/* Entries seen by dump_func */
+static unsigned int n_dumped = 0;
+static unsigned int last_line = 0;
+static double last_time = 0.;
+static int out_of_order = 0;
+
+static int
+dump_func(FILE *stream, const char *format, ...)
+{
+    va_list ap;
+
+    (void) stream;
+
+    /* Only look at log entries, i.e. "# [%lf] %s:%d..." */
+    if (strncmp(format, "# [", 3) != 0)
+        return 0;
+
+    va_start(ap, format);
+    {
+        double time = va_arg(ap, double);
+        (void) va_arg(ap, const char *);
+        last_line = (unsigned int) va_arg(ap, int);
+        if (n_dumped > 0 && time < last_time)
+            out_of_order = 1;
+        last_time = time;
+    }
+    va_end(ap);
+    n_dumped++;
+
+    return 0;
+}
+
+static void
+dump_reset(void)
+{
+    n_dumped = 0;
+    last_time = 0.;
+    out_of_order = 0;
+}
+
+static int
+counter_func(const char *name, const char *descr, int64_t value, void *arg)
+{
+    int64_t *sum = (int64_t *) arg;
+
+    (void) name;
+    (void) descr;
+    *sum += value;
+
+    return 0;
+}
+
+static HG_THREAD_RETURN_TYPE
+thread_cb_addlog(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    unsigned int *added = (unsigned int *) arg;
+    unsigned int i;
+
+    for (i = 0; i < HG_TEST_ADDS; i++)
+        *added += hg_dlog_addlog(
+            &test_dlog, __FILE__, __LINE__, __func__, NULL, NULL);
+
+    hg_thread_exit(thread_ret);
+    return thread_ret;
+}
+
+int
+main(int argc, char *argv[])
+{
+    hg_thread_t threads[HG_TEST_THREADS];
+    unsigned int added[HG_TEST_THREADS];
+    struct hg_dlog *dlog = NULL;
+    hg_atomic_int32_t *count32 = NULL;
+    hg_atomic_int64_t *count64 = NULL;
+    int64_t sum = 0;
+    int ret = EXIT_SUCCESS;
+    unsigned int i;
+
+    (void) argc;
+    (void) argv;
+
+    /* Each thread fills its own ring then stops (log is not circular) */
+    for (i = 0; i < HG_TEST_THREADS; i++) {
+        added[i] = 0;
+        hg_thread_create(&threads[i], thread_cb_addlog, &added[i]);
+    }
+    for (i = 0; i < HG_TEST_THREADS; i++) {
+        hg_thread_join(threads[i]);
+        if (added[i] != HG_TEST_LESIZE) {
+            fprintf(stderr, "Error: thread %u added %u entries, expected %d\n",
+                i, added[i], HG_TEST_LESIZE);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+
+    hg_dlog_dump(&test_dlog, dump_func, stdout, 0);
+    if (n_dumped != HG_TEST_THREADS * HG_TEST_LESIZE || out_of_order) {
+        fprintf(stderr, "Error: dumped %u entries (out of order: %d)\n",
+            n_dumped, out_of_order);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Reset drops previous entries and lets threads log again */
+    hg_dlog_resetlog(&test_dlog);
+    if (hg_dlog_addlog(&test_dlog, __FILE__, __LINE__, __func__, NULL, NULL) !=
+        1) {
+        fprintf(stderr, "Error: could not add entry after reset\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    dump_reset();
+    hg_dlog_dump(&test_dlog, dump_func, stdout, 0);
+    if (n_dumped != 1) {
+        fprintf(stderr, "Error: dumped %u entries after reset\n", n_dumped);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Circular log only keeps the most recent entries */
+    dlog = hg_dlog_alloc("loop", HG_TEST_LESIZE, 1);
+    if (dlog == NULL) {
+        fprintf(stderr, "Error: could not allocate dlog\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < HG_TEST_ADDS; i++)
+        hg_dlog_addlog(dlog, __FILE__, i, __func__, NULL, NULL);
+    dump_reset();
+    hg_dlog_dump(dlog, dump_func, stdout, 0);
+    if (n_dumped != HG_TEST_LESIZE || last_line != HG_TEST_ADDS - 1) {
+        fprintf(stderr, "Error: dumped %u entries, last one is %u\n", n_dumped,
+            last_line);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Counters are walked with their current value */
+    hg_dlog_mkcount32(&test_dlog, &count32, "count32", "32-bit counter");
+    hg_dlog_mkcount64(&test_dlog, &count64, "count64", "64-bit counter");
+    hg_atomic_set32(count32, 3);
+    hg_atomic_set64(count64, (int64_t) 1 << 40);
+    if (hg_dlog_foreach_counter(&test_dlog, counter_func, &sum) != 0 ||
+        sum != ((int64_t) 1 << 40) + 3) {
+        fprintf(stderr, "Error: counters sum to %" PRId64 "\n", sum);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    if (dlog != NULL)
+        hg_dlog_free(dlog);
+    hg_dlog_free(&test_dlog);
+    return ret;
+}
@@ -9,11 +9,46 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define COPY_BUF_SIZE (3 * 4096 + 100)
+
+static int
+test_mem_copy(const char *kernel, size_t vec_threshold, size_t nt_threshold)
+{
+    static char src[COPY_BUF_SIZE], dest[COPY_BUF_SIZE];
+    size_t sizes[] = {0, 1, 63, 4096, 4096 + 33, 2 * 4096 + 1};
+    size_t i, j;
+
+    if (hg_mem_copy_set_kernel(kernel) != HG_UTIL_SUCCESS)
+        return EXIT_SUCCESS; /* Not supported by CPU */
+    hg_mem_copy_set_thresholds(vec_threshold, nt_threshold);
+
+    for (i = 0; i < COPY_BUF_SIZE; i++)
+        src[i] = (char) i;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (j = 0; j < 64; j += 7) {
+            memset(dest, 0, COPY_BUF_SIZE);
+            hg_mem_copy(dest + j, src + 3, sizes[i]);
+            if (memcmp(dest + j, src + 3, sizes[i]) != 0 ||
+                (j > 0 && dest[j - 1] != 0) || dest[j + sizes[i]] != 0) {
+                fprintf(stderr,
+                    "Error: %s copy of %zu bytes at offset %zu failed\n",
+                    kernel, sizes[i], j);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
 
 int
 main(void)
 {
-    size_t page_size;
+    const char *kernels[] = {"memcpy", "sse2", "avx2", "avx512"};
+    size_t page_size, i;
     void *ptr;
 
     page_size = (size_t) hg_mem_get_page_size();
@@ -38,6 +73,12 @@ main(void)
             (void) hg_mem_huge_free(ptr, page_size * 4);
     }
 
+    for (i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+        if (test_mem_copy(kernels[i], 4096, 2 * 4096) != EXIT_SUCCESS ||
+            test_mem_copy(kernels[i], 0, 0) != EXIT_SUCCESS)
+            goto error;
+    }
+
     return EXIT_SUCCESS;
 
 error:
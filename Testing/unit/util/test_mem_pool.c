@@ -9,6 +9,7 @@
 #include "mercury_mem_pool.h"
 #include "mercury_thread.h"
 #include "mercury_thread_condition.h"
+#include "mercury_time.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,6 +27,18 @@
 #    define HG_TEST_NUM_THREADS_DEFAULT (8)
 #endif
 
+/* Benchmark parameters */
+#define BENCH_CHUNK_SIZE  (64)
+#define BENCH_CHUNK_COUNT (256)
+#define BENCH_CACHE_COUNT (32)
+#define BENCH_BATCH       (8)        /* Chunks held at once per thread */
+#define BENCH_ITERS       (1 << 15) /* Per thread */
+
+/* Background growth parameters */
+#define GROW_CHUNK_COUNT (4)
+#define GROW_WATERMARK   (2)
+#define GROW_TIMEOUT_MS  (5000)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -39,6 +52,11 @@ struct thread_args {
     int mr;
 };
 
+struct bench_args {
+    struct hg_mem_pool *mem_pool;
+    hg_atomic_int32_t failed;
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -53,6 +71,13 @@ hg_test_mem_pool_deregister(void *handle, void *arg);
 static void
 hg_test_mem_pool_alloc(struct hg_mem_pool *hg_mem_pool, int mr);
 
+static int
+hg_test_mem_pool_bench(unsigned int n_threads, unsigned int cache_count,
+    hg_atomic_int32_t *n_mr, double *rate);
+
+static int
+hg_test_mem_pool_grow(hg_atomic_int32_t *n_mr);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -137,12 +162,132 @@ hg_test_mem_pool_alloc(struct hg_mem_pool *hg_mem_pool, int mr)
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_test_bench_thread(void *arg)
+{
+    struct bench_args *bench_args = (struct bench_args *) arg;
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    void *mem_ptrs[BENCH_BATCH], *mr_handles[BENCH_BATCH];
+    int i, j;
+
+    for (i = 0; i < BENCH_ITERS / BENCH_BATCH; i++) {
+        for (j = 0; j < BENCH_BATCH; j++) {
+            mem_ptrs[j] = hg_mem_pool_alloc(
+                bench_args->mem_pool, BENCH_CHUNK_SIZE, &mr_handles[j]);
+            if (mem_ptrs[j] == NULL) {
+                hg_atomic_incr32(&bench_args->failed);
+                goto done;
+            }
+            *(int *) mem_ptrs[j] = j;
+        }
+        for (j = 0; j < BENCH_BATCH; j++)
+            hg_mem_pool_free(bench_args->mem_pool, mem_ptrs[j], mr_handles[j]);
+    }
+
+done:
+    hg_thread_exit(thread_ret);
+    return thread_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_test_mem_pool_bench(unsigned int n_threads, unsigned int cache_count,
+    hg_atomic_int32_t *n_mr, double *rate)
+{
+    hg_thread_t threads[HG_TEST_NUM_THREADS_DEFAULT];
+    struct bench_args bench_args;
+    hg_time_t t1, t2;
+    unsigned int i;
+
+    bench_args.mem_pool = hg_mem_pool_create(BENCH_CHUNK_SIZE,
+        BENCH_CHUNK_COUNT, 1, hg_test_mem_pool_register, 0,
+        hg_test_mem_pool_deregister, n_mr);
+    if (bench_args.mem_pool == NULL)
+        return HG_UTIL_FAIL;
+    if (hg_mem_pool_set_thread_cache(bench_args.mem_pool, cache_count) !=
+        HG_UTIL_SUCCESS) {
+        hg_mem_pool_destroy(bench_args.mem_pool);
+        return HG_UTIL_FAIL;
+    }
+    hg_atomic_init32(&bench_args.failed, 0);
+
+    hg_time_get_current(&t1);
+    for (i = 0; i < n_threads; i++)
+        hg_thread_create(&threads[i], hg_test_bench_thread, &bench_args);
+    for (i = 0; i < n_threads; i++)
+        hg_thread_join(threads[i]);
+    hg_time_get_current(&t2);
+
+    *rate = (double) (n_threads * BENCH_ITERS) /
+            hg_time_to_double(hg_time_subtract(t2, t1));
+
+    hg_mem_pool_destroy(bench_args.mem_pool);
+
+    return (hg_atomic_get32(&bench_args.failed) == 0) ? HG_UTIL_SUCCESS
+                                                      : HG_UTIL_FAIL;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_test_mem_pool_grow(hg_atomic_int32_t *n_mr)
+{
+    struct hg_mem_pool_attr attr = HG_MEM_POOL_ATTR_INITIALIZER;
+    struct hg_mem_pool_stats stats;
+    struct hg_mem_pool *mem_pool;
+    void *chunks[GROW_CHUNK_COUNT], *mr_handles[GROW_CHUNK_COUNT];
+    unsigned int i;
+    int ret = HG_UTIL_SUCCESS;
+
+    attr.numa_node = 0;
+    attr.grow_watermark = GROW_WATERMARK;
+    mem_pool = hg_mem_pool_create_attr(CHUNK_SIZE1, GROW_CHUNK_COUNT, 1,
+        &attr, hg_test_mem_pool_register, 0, hg_test_mem_pool_deregister,
+        n_mr);
+    if (mem_pool == NULL)
+        return HG_UTIL_FAIL;
+
+    /* Dropping below the watermark must trigger a background grow */
+    for (i = 0; i < GROW_CHUNK_COUNT; i++) {
+        chunks[i] = hg_mem_pool_alloc(mem_pool, CHUNK_SIZE1, &mr_handles[i]);
+        if (chunks[i] == NULL) {
+            fprintf(stderr, "Error: could not allocate chunk %u\n", i);
+            ret = HG_UTIL_FAIL;
+            goto done;
+        }
+    }
+    for (i = 0; i < GROW_TIMEOUT_MS; i++) {
+        hg_mem_pool_get_stats(mem_pool, &stats);
+        if (stats.async_grow_count > 0)
+            break;
+        hg_time_sleep(hg_time_from_ms(1));
+    }
+    if (stats.async_grow_count == 0 ||
+        stats.block_count != stats.async_grow_count + 1) {
+        fprintf(stderr, "Error: pool was not grown in background (%zu/%zu)\n",
+            stats.async_grow_count, stats.block_count);
+        ret = HG_UTIL_FAIL;
+    }
+    printf("%zu block(s), registration time %.2f us (max %.2f us)\n",
+        stats.block_count, stats.register_time * 1e6,
+        stats.register_time_max * 1e6);
+
+    for (i = 0; i < GROW_CHUNK_COUNT; i++)
+        hg_mem_pool_free(mem_pool, chunks[i], mr_handles[i]);
+
+done:
+    hg_mem_pool_destroy(mem_pool);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 main(void)
 {
     struct thread_args thread_args;
     hg_thread_t threads[HG_TEST_NUM_THREADS_DEFAULT];
+    unsigned int n;
     int i;
     int ret = EXIT_SUCCESS;
 
@@ -187,6 +332,55 @@ main(void)
             (int) hg_atomic_get32(&thread_args.n_mr));
     }
 
+    /* Create memory pool with registration and thread caches */
+    thread_args.n_threads = 0;
+    thread_args.mem_pool = hg_mem_pool_create(CHUNK_SIZE1, CHUNK_COUNT1,
+        BLOCK_COUNT1, hg_test_mem_pool_register, 0, hg_test_mem_pool_deregister,
+        &thread_args.n_mr);
+    if (thread_args.mem_pool == NULL ||
+        hg_mem_pool_set_thread_cache(thread_args.mem_pool, CHUNK_COUNT1) !=
+            HG_UTIL_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    for (i = 0; i < HG_TEST_NUM_THREADS_DEFAULT; i++)
+        hg_thread_create(&threads[i], hg_test_alloc_thread, &thread_args);
+
+    for (i = 0; i < HG_TEST_NUM_THREADS_DEFAULT; i++)
+        hg_thread_join(threads[i]);
+
+    hg_mem_pool_destroy(thread_args.mem_pool);
+    if (hg_atomic_get32(&thread_args.n_mr) != 0) {
+        fprintf(stderr, "Error: memory still registered (%d)\n",
+            (int) hg_atomic_get32(&thread_args.n_mr));
+    }
+
+    /* Create memory pool with background growth */
+    if (hg_test_mem_pool_grow(&thread_args.n_mr) != HG_UTIL_SUCCESS ||
+        hg_atomic_get32(&thread_args.n_mr) != 0) {
+        fprintf(stderr, "Error: background growth test failed\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Throughput with and without thread caches */
+    for (n = 1; n <= HG_TEST_NUM_THREADS_DEFAULT; n *= 2) {
+        double shared_rate, cache_rate;
+
+        if (hg_test_mem_pool_bench(n, 0, &thread_args.n_mr, &shared_rate) !=
+                HG_UTIL_SUCCESS ||
+            hg_test_mem_pool_bench(
+                n, BENCH_CACHE_COUNT, &thread_args.n_mr, &cache_rate) !=
+                HG_UTIL_SUCCESS) {
+            fprintf(stderr, "Error: benchmark failed\n");
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        printf("%u thread(s): shared %.2f Mops/s, thread cache %.2f Mops/s\n",
+            n, shared_rate / 1e6, cache_rate / 1e6);
+    }
+
 done:
     hg_thread_mutex_destroy(&thread_args.mutex);
     hg_thread_cond_destroy(&thread_args.cond);
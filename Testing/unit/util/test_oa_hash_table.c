@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_oa_hash_table.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Enough entries to go through several enlargements */
+#define HG_TEST_ENTRIES (10000)
+
+static unsigned int n_freed = 0;
+
+static int
+int_equal(hg_hash_table_key_t vlocation1, hg_hash_table_key_t vlocation2)
+{
+    return *((int *) vlocation1) == *((int *) vlocation2);
+}
+
+static unsigned int
+int_hash(hg_hash_table_key_t vlocation)
+{
+    return *((unsigned int *) vlocation);
+}
+
+static void
+int_hash_value_free(hg_hash_table_value_t value)
+{
+    (void) value;
+    n_freed++;
+}
+
+/*---------------------------------------------------------------------------*/
+
+int
+main(int argc, char *argv[])
+{
+    hg_oa_hash_table_t *hash_table = NULL;
+    hg_oa_hash_table_iter_t hash_table_iter;
+    static int keys[HG_TEST_ENTRIES], values[HG_TEST_ENTRIES];
+    int overwrite_value = -1;
+    int64_t sum = 0, expected_sum = 0;
+    int ret = EXIT_SUCCESS;
+    int i, j;
+
+    (void) argc;
+    (void) argv;
+
+    hash_table = hg_oa_hash_table_new(int_hash, int_equal);
+    if (hash_table == NULL) {
+        fprintf(stderr, "Error: could not create hash table\n");
+        return EXIT_FAILURE;
+    }
+    hg_oa_hash_table_register_free_functions(
+        hash_table, NULL, int_hash_value_free);
+
+    /* Lookups must keep working while entries are being moved */
+    for (i = 0; i < HG_TEST_ENTRIES; i++) {
+        keys[i] = i;
+        values[i] = 10 * i;
+        if (!hg_oa_hash_table_insert(hash_table, &keys[i], &values[i])) {
+            fprintf(stderr, "Error: could not insert entry %d\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        for (j = 0; j <= i; j += 1 + i / 64) {
+            int *value = (int *) hg_oa_hash_table_lookup(hash_table, &keys[j]);
+
+            if (value != &values[j]) {
+                fprintf(stderr, "Error: entry %d not found after %d\n", j, i);
+                ret = EXIT_FAILURE;
+                goto done;
+            }
+        }
+    }
+    if (hg_oa_hash_table_num_entries(hash_table) != HG_TEST_ENTRIES) {
+        fprintf(stderr, "Error: was expecting %d entries, got %u\n",
+            HG_TEST_ENTRIES, hg_oa_hash_table_num_entries(hash_table));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Overwrite must free the previous value */
+    if (!hg_oa_hash_table_insert(hash_table, &keys[0], &overwrite_value) ||
+        n_freed != 1 ||
+        hg_oa_hash_table_lookup(hash_table, &keys[0]) != &overwrite_value) {
+        fprintf(stderr, "Error: could not overwrite entry\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    /* Remove odd keys */
+    for (i = 1; i < HG_TEST_ENTRIES; i += 2) {
+        if (!hg_oa_hash_table_remove(hash_table, &keys[i])) {
+            fprintf(stderr, "Error: could not remove entry %d\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+    if (hg_oa_hash_table_remove(hash_table, &keys[1])) {
+        fprintf(stderr, "Error: entry 1 was removed twice\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < HG_TEST_ENTRIES; i++) {
+        int *value = (int *) hg_oa_hash_table_lookup(hash_table, &keys[i]);
+
+        if ((i % 2 == 1 && value != NULL) ||
+            (i % 2 == 0 && i > 0 && value != &values[i])) {
+            fprintf(stderr, "Error: unexpected value for entry %d\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        if (i % 2 == 0)
+            expected_sum += (i > 0) ? values[i] : overwrite_value;
+    }
+
+    hg_oa_hash_table_iterate(hash_table, &hash_table_iter);
+    for (i = 0; hg_oa_hash_table_iter_has_more(&hash_table_iter); i++)
+        sum += *((int *) hg_oa_hash_table_iter_next(&hash_table_iter));
+    if (i != HG_TEST_ENTRIES / 2 || sum != expected_sum) {
+        fprintf(stderr, "Error: iterated over %d entries, expected %d\n", i,
+            HG_TEST_ENTRIES / 2);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
+    hg_oa_hash_table_free(hash_table);
+    if (ret == EXIT_SUCCESS && n_freed != HG_TEST_ENTRIES + 1) {
+        fprintf(stderr, "Error: freed %u values, expected %d\n", n_freed,
+            HG_TEST_ENTRIES + 1);
+        ret = EXIT_FAILURE;
+    }
+    return ret;
+}
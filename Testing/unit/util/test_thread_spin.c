@@ -7,11 +7,25 @@
 
 #include "mercury_thread.h"
 #include "mercury_thread_spin.h"
+#include "mercury_time.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 
+/* Benchmark parameters */
+#define HG_TEST_BENCH_ITERS      (1 << 12) /* Per thread */
+#define HG_TEST_BENCH_THREAD_MAX 32
+
+struct hg_test_bench {
+    hg_thread_spin_t spin;
+    hg_thread_ticket_t ticket;
+    int64_t value;
+    double max_wait; /* Longest time a thread waited for the lock */
+    bool use_ticket;
+};
+
 static hg_thread_spin_t thread_spin;
+static hg_thread_ticket_t thread_ticket;
 static int thread_value = 0;
 
 static HG_THREAD_RETURN_TYPE
@@ -32,6 +46,111 @@ thread_cb_mutex(void *arg)
     return thread_ret;
 }
 
+static HG_THREAD_RETURN_TYPE
+thread_cb_ticket(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+
+    (void) arg;
+
+    if (hg_thread_ticket_try_lock(&thread_ticket) != HG_UTIL_SUCCESS)
+        hg_thread_ticket_lock(&thread_ticket);
+
+    thread_value++;
+
+    hg_thread_ticket_unlock(&thread_ticket);
+
+    hg_thread_exit(thread_ret);
+    return thread_ret;
+}
+
+static HG_THREAD_RETURN_TYPE
+hg_test_bench_lock(void *arg)
+{
+    struct hg_test_bench *bench = (struct hg_test_bench *) arg;
+    unsigned int i;
+
+    for (i = 0; i < HG_TEST_BENCH_ITERS; i++) {
+        hg_time_t t1, t2;
+        double wait;
+
+        hg_time_get_current(&t1);
+        if (bench->use_ticket)
+            hg_thread_ticket_lock(&bench->ticket);
+        else
+            hg_thread_spin_lock(&bench->spin);
+        hg_time_get_current(&t2);
+
+        bench->value++;
+        wait = hg_time_to_double(hg_time_subtract(t2, t1));
+        if (wait > bench->max_wait)
+            bench->max_wait = wait;
+
+        if (bench->use_ticket)
+            hg_thread_ticket_unlock(&bench->ticket);
+        else
+            hg_thread_spin_unlock(&bench->spin);
+    }
+
+    return (HG_THREAD_RETURN_TYPE) 0;
+}
+
+static int
+hg_test_bench_run(
+    unsigned int nthreads, bool use_ticket, double *rate, double *max_wait)
+{
+    hg_thread_t threads[HG_TEST_BENCH_THREAD_MAX];
+    struct hg_test_bench bench;
+    hg_time_t t1, t2;
+    unsigned int i;
+
+    hg_thread_spin_init(&bench.spin);
+    hg_thread_ticket_init(&bench.ticket);
+    bench.value = 0;
+    bench.max_wait = 0.0;
+    bench.use_ticket = use_ticket;
+
+    hg_time_get_current(&t1);
+    for (i = 0; i < nthreads; i++)
+        hg_thread_create(&threads[i], hg_test_bench_lock, &bench);
+    for (i = 0; i < nthreads; i++)
+        hg_thread_join(threads[i]);
+    hg_time_get_current(&t2);
+
+    *rate = (double) (nthreads * HG_TEST_BENCH_ITERS) /
+            hg_time_to_double(hg_time_subtract(t2, t1));
+    *max_wait = bench.max_wait;
+
+    hg_thread_ticket_destroy(&bench.ticket);
+    hg_thread_spin_destroy(&bench.spin);
+
+    return (bench.value == (int64_t) nthreads * HG_TEST_BENCH_ITERS)
+               ? HG_UTIL_SUCCESS
+               : HG_UTIL_FAIL;
+}
+
+static int
+hg_test_bench(void)
+{
+    unsigned int threads[] = {1, 4, 8, HG_TEST_BENCH_THREAD_MAX};
+    double spin_rate, spin_wait, ticket_rate, ticket_wait;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        if (hg_test_bench_run(threads[i], false, &spin_rate, &spin_wait) !=
+                HG_UTIL_SUCCESS ||
+            hg_test_bench_run(threads[i], true, &ticket_rate, &ticket_wait) !=
+                HG_UTIL_SUCCESS)
+            return HG_UTIL_FAIL;
+        printf("%u thread(s): spin %.2f Mops/s (max wait %.2f ms), ticket "
+               "%.2f Mops/s (max wait %.2f ms)\n",
+            threads[i], spin_rate / 1e6, spin_wait * 1e3, ticket_rate / 1e6,
+            ticket_wait * 1e3);
+    }
+
+    return HG_UTIL_SUCCESS;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -56,5 +175,26 @@ main(int argc, char *argv[])
     }
 
     hg_thread_spin_destroy(&thread_spin);
+
+    hg_thread_ticket_init(&thread_ticket);
+
+    hg_thread_create(&thread1, thread_cb_ticket, NULL);
+    hg_thread_create(&thread2, thread_cb_ticket, NULL);
+    hg_thread_join(thread1);
+    hg_thread_join(thread2);
+
+    if (thread_value != 4) {
+        fprintf(stderr, "Error: value is %d\n", thread_value);
+        ret = EXIT_FAILURE;
+    }
+
+    if (hg_thread_ticket_destroy(&thread_ticket) != HG_UTIL_SUCCESS)
+        ret = EXIT_FAILURE;
+
+    if (hg_test_bench() != HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: lock benchmark failed\n");
+        ret = EXIT_FAILURE;
+    }
+
     return ret;
 }
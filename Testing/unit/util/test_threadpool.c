@@ -58,6 +58,9 @@ main(int argc, char *argv[])
     int i;
     hg_thread_pool_t *thread_pool;
     struct hg_thread_work work[POOL_NUM_POSTS];
+    struct hg_thread_work *batch[POOL_NUM_POSTS];
+    struct hg_thread_pool_opt opt = {.cpu_set = NULL, .work_stealing = true};
+    hg_cpu_set_t cpu_set;
     int ret = EXIT_SUCCESS;
 
     (void) argc;
@@ -79,6 +82,47 @@ main(int argc, char *argv[])
         fprintf(stderr, "Did not execute all the operations posted (%u/%d)\n",
             ncalls, POOL_NUM_POSTS);
         ret = EXIT_FAILURE;
+        goto done;
     }
+
+    /* Work stealing, pinned to the CPUs we can run on if supported */
+    if (hg_thread_getaffinity(hg_thread_self(), &cpu_set) == HG_UTIL_SUCCESS)
+        opt.cpu_set = &cpu_set;
+    ncalls = 0;
+    hg_thread_mutex_init(&mymutex);
+    if (hg_thread_pool_init_opt(HG_TEST_NUM_THREADS_DEFAULT, &opt,
+            &thread_pool) != HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Could not create work-stealing pool\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+    for (i = 0; i < POOL_NUM_POSTS / 2; i++) {
+        work[i].func = myfunc;
+        work[i].args = NULL;
+        hg_thread_pool_post_prio(thread_pool, &work[i],
+            (i % 2) ? HG_THREAD_POOL_PRIO_HIGH : HG_THREAD_POOL_PRIO_NORMAL);
+    }
+    for (i = POOL_NUM_POSTS / 2; i < POOL_NUM_POSTS; i++) {
+        work[i].func = myfunc;
+        work[i].args = NULL;
+        batch[i - POOL_NUM_POSTS / 2] = &work[i];
+    }
+    hg_thread_pool_post_batch(thread_pool, batch, POOL_NUM_POSTS / 2,
+        HG_THREAD_POOL_PRIO_NORMAL);
+
+    hg_thread_pool_destroy(thread_pool);
+    hg_thread_mutex_destroy(&mymutex);
+
+    if (ncalls != POOL_NUM_POSTS) {
+        fprintf(stderr,
+            "Did not execute all the operations posted with work stealing "
+            "(%u/%d)\n",
+            ncalls, POOL_NUM_POSTS);
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
+done:
     return ret;
 }
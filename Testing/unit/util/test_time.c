@@ -7,6 +7,7 @@
 
 #include "mercury_time.h"
 
+#include <inttypes.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,6 +20,8 @@ main(int argc, char *argv[])
     double epsilon = 1e-9;
     double t1_double, t2_double;
     unsigned int t1_ms = 12345, t2_ms;
+    uint64_t c1, c2;
+    double cycles_double;
     int ret = EXIT_SUCCESS;
 
     (void) argc;
@@ -27,9 +30,11 @@ main(int argc, char *argv[])
     printf("Current time: %s\n", hg_time_stamp());
 
     hg_time_get_current(&t1);
+    c1 = hg_time_get_cycles();
 
     hg_time_sleep(sleep_time);
 
+    c2 = hg_time_get_cycles();
     hg_time_get_current(&t2);
 
     /* Should have slept at least sleep_time */
@@ -77,6 +82,28 @@ main(int argc, char *argv[])
         goto done;
     }
 
+    /* Cycle counter must agree with the clock (allow for VM jitter) */
+    printf("Cycle counter: %" PRIu64 " Hz (invariant: %d)\n",
+        hg_time_cycles_freq(), hg_time_cycles_invariant());
+    if (c2 <= c1) {
+        fprintf(stderr, "Error: c1 >= c2\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    cycles_double = hg_time_cycles_to_double(c2 - c1);
+    if (fabs(cycles_double - hg_time_diff(t2, t1)) > 0.1 * cycles_double) {
+        fprintf(stderr, "Error: cycles elapsed %f s, clock elapsed %f s\n",
+            cycles_double, hg_time_diff(t2, t1));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (fabs((double) hg_time_cycles_to_ns(c2 - c1) - cycles_double * 1e9) >
+        1e3) {
+        fprintf(stderr, "Error: ns conversion does not match\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
 done:
     return ret;
 }
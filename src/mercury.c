@@ -13,8 +13,13 @@
 
 #include "mercury_private.h"
 
+#include "mercury_atomic.h"
 #include "mercury_hash_string.h"
 #include "mercury_mem.h"
+#include "mercury_mem_pool.h"
+#include "mercury_param.h"
+#include "mercury_thread.h"
+#include "mercury_thread_pool.h"
 #include "mercury_thread_spin.h"
 
 #include <assert.h>
@@ -31,6 +36,33 @@
 #define HG_HANDLE_CLASS(handle)                                                \
     ((struct hg_private_class *) ((handle)->info.hg_class))
 
+#define HG_CONTEXT_EXEC(context)                                               \
+    (&((struct hg_private_context *) (context))->exec)
+
+/* Max number of callbacks triggered at once by the progress thread */
+#define HG_EXEC_TRIGGER_MAX (64)
+
+/* Default progress timeout of the progress thread (ms) */
+#define HG_EXEC_PROGRESS_TIMEOUT (100)
+
+/* Max number of callbacks triggered at once by a blocked caller */
+#define HG_WAIT_TRIGGER_MAX (16)
+
+/* Number of extra buffer pool size classes (page size << class) */
+#define HG_EXTRA_BUF_POOL_CLASSES (16)
+
+/* Max number of responses passed at once to HG_Core_respond_batch() */
+#define HG_RESPOND_BATCH_MAX (64)
+
+/* Max size of self address string compared against tree targets */
+#define HG_MULTI_ADDR_NAME_MAX (256)
+
+/* Offset of private area that follows handles (aligned for any type) */
+#define HG_PRIVATE_AREA_ALIGN (16)
+#define HG_PRIVATE_AREA_OFFSET                                                 \
+    ((sizeof(struct hg_private_handle) + HG_PRIVATE_AREA_ALIGN - 1) &          \
+        ~((size_t) HG_PRIVATE_AREA_ALIGN - 1))
+
 /* Name of this subsystem */
 #define HG_SUBSYS_NAME        hg
 #define HG_STRINGIFY(x)       HG_UTIL_STRINGIFY(x)
@@ -40,14 +72,62 @@
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Pooled extra buffer */
+struct hg_extra_buf {
+    struct hg_extra_buf *next; /* Next free buffer */
+    void *buf;                 /* Buffer */
+    hg_size_t size;            /* Buffer size */
+    hg_bulk_t bulk;            /* Bulk handle registered for buffer */
+    unsigned int size_class;   /* Size class index */
+};
+
+/* Pool of extra buffers */
+struct hg_extra_buf_pool {
+    struct hg_extra_buf *free_lists[HG_EXTRA_BUF_POOL_CLASSES]; /* Free */
+    hg_thread_spin_t lock;                                       /* Lock */
+    hg_size_t size;     /* Size of free buffers */
+    hg_size_t max_size; /* Max size of free buffers */
+};
+
 /* HG class */
 struct hg_private_class {
     struct hg_class hg_class; /* Must remain as first field */
     hg_return_t (*handle_create)(hg_handle_t, void *); /* handle_create */
     void *handle_create_arg;                           /* handle_create arg */
+    hg_trace_cb_t trace;                               /* Trace callback */
+    void *trace_arg;                                   /* Trace callback arg */
+    hg_peer_error_cb_t peer_error;                     /* Peer error callback */
+    void *peer_error_arg;                              /* Peer error arg */
     hg_checksum_level_t checksum_level;                /* Checksum level */
+    hg_bool_t checksum_payload_buf; /* Checksum encoded payload at once */
     hg_bool_t bulk_eager;                              /* Eager bulk proc */
     hg_bool_t release_input_early;                     /* Release input early */
+    hg_bool_t release_input_on_free; /* Release input on HG_Free_input() */
+    hg_bool_t bulk_eager_ref;        /* Reference eager data from input */
+    hg_size_t input_ref_threshold;   /* Min size of input refs */
+    hg_bool_t single_thread;         /* Class used by a single thread */
+    hg_size_t private_area_size;     /* Size of private area of handles */
+    hg_atomic_int32_t handle_count;  /* Handles created (area is fixed) */
+    struct hg_extra_buf_pool extra_buf_pool; /* Extra buffer pool */
+};
+
+/* Execution model of a context (see HG_Context_exec_start()) */
+struct hg_exec {
+    hg_thread_t progress_thread;  /* Progress thread */
+    hg_thread_pool_t *pool;       /* Handler pool (NULL if inline only) */
+    hg_atomic_int32_t posting;    /* Handlers being posted to pool */
+    hg_atomic_int32_t offloading; /* Handlers may be posted to pool */
+    hg_atomic_int32_t stopping;   /* Progress thread must exit */
+    unsigned int progress_timeout; /* Progress timeout (ms) */
+    hg_cpu_set_t cpu_mask;         /* CPUs the context is placed on */
+    hg_bool_t bound;               /* Context placed on cpu_mask */
+    hg_bool_t started;             /* Progress thread is running */
+};
+
+/* HG context */
+struct hg_private_context {
+    struct hg_context context; /* Must remain as first field */
+    struct hg_exec exec;       /* Execution model */
 };
 
 /* Info for function map */
@@ -58,6 +138,19 @@ struct hg_proc_info {
     void *data;                    /* User data */
     void (*free_callback)(void *); /* User data free callback */
     hg_bool_t no_response;         /* RPC response not expected */
+    hg_bool_t precompute_size;     /* Size payload before encoding */
+    hg_bool_t varint;              /* Encode unsigned integers as varints */
+    const struct hg_compressor *compressor; /* Payload compressor */
+    hg_size_t compress_threshold;           /* Min size to compress */
+    hg_size_t bulk_eager_max;  /* Max bulk data embedded along payload */
+    hg_bool_t bulk_eager_set;  /* Eager bulk policy set for that RPC */
+    hg_bool_t tree;            /* Payload is relayed through a tree */
+    hg_bool_t offload;         /* Run RPC callback in handler pool */
+    hg_reduce_cb_t reduce_cb;  /* Reduce callback of fan-out outputs */
+    hg_size_t out_struct_size; /* Size of output struct (reduce) */
+    hg_size_t out_region_size; /* Size of advertised output region */
+    hg_size_t shared_in_size;  /* Size of input struct shared with self */
+    hg_size_t shared_out_size; /* Size of output struct shared with self */
 };
 
 /* HG handle */
@@ -66,12 +159,18 @@ struct hg_private_handle {
     struct hg_header hg_header; /* Header for input/output */
     hg_cb_t forward_cb;         /* Forward callback */
     hg_cb_t respond_cb;         /* Respond callback */
+    hg_cb_t stream_cb;          /* Partial response callback (origin) */
+    hg_cb_t partial_cb;         /* Partial respond callback (target) */
     void (*extra_bulk_transfer_cb)(
         hg_core_handle_t, hg_return_t); /* Bulk transfer callback */
     void *forward_arg;                  /* Forward callback args */
     void *respond_arg;                  /* Respond callback args */
+    void *stream_arg;                   /* Partial response callback args */
+    void *partial_arg;                  /* Partial respond callback args */
     void *in_extra_buf;                 /* Extra input buffer */
     void *out_extra_buf;                /* Extra output buffer */
+    struct hg_extra_buf *in_extra_pooled;  /* Pooled extra input buffer */
+    struct hg_extra_buf *out_extra_pooled; /* Pooled extra output buffer */
     hg_proc_t in_proc;                  /* Proc for input */
     hg_proc_t out_proc;                 /* Proc for output */
     hg_bulk_t in_extra_bulk;            /* Extra input bulk handle */
@@ -79,6 +178,31 @@ struct hg_private_handle {
     hg_size_t in_extra_buf_size;        /* Extra input buffer size */
     hg_size_t out_extra_buf_size;       /* Extra output buffer size */
     hg_bool_t use_checksums;            /* Handle uses checksums */
+    hg_bool_t in_decompressed;  /* Extra input buffer is decompressed */
+    hg_bool_t out_decompressed; /* Extra output buffer is decompressed */
+    hg_bool_t in_extra_charged;  /* Extra input buffer is charged */
+    hg_bool_t out_extra_charged; /* Extra output buffer is charged */
+    struct hg_multi *multi_node; /* Relay state if received through tree */
+    void *tree_in_buf;           /* Input relayed through tree */
+    hg_size_t tree_in_buf_size;  /* Size of input relayed through tree */
+    struct hg_thread_work offload_work; /* Offloaded RPC callback */
+    const struct hg_proc_info *persistent_proc_info; /* Bound proc info */
+    hg_size_t retained_in_size; /* Size of retained encoded input */
+    hg_bool_t in_retained;      /* Encoded input is retained in buffer */
+    void *out_region_buf;       /* Output region advertised (origin) */
+    hg_size_t out_region_size;  /* Size of output region (origin) */
+    hg_bulk_t out_region;       /* Output region bulk handle (origin) */
+    hg_bulk_t out_region_remote; /* Advertised output region (target) */
+    hg_size_t respond_size;      /* Payload size of deferred response */
+    hg_bool_t out_region_advertised; /* Origin advertised a region */
+    hg_bool_t out_region_push;       /* Output is pushed to region */
+    void *shared_in;                 /* Input struct shared with self */
+    void *shared_out;                /* Output struct shared with self */
+    hg_size_t shared_in_alloc;       /* Allocated size of shared_in */
+    hg_size_t shared_out_alloc;      /* Allocated size of shared_out */
+    hg_bool_t in_shared;             /* Input is shared, not encoded */
+    hg_bool_t out_shared;            /* Output is shared, not encoded */
+    hg_size_t private_area_size;     /* Size of inline private area */
 };
 
 /* HG op id */
@@ -96,6 +220,58 @@ struct hg_op_id {
     hg_cb_type_t type;          /* Callback type */
 };
 
+/* Target of a fan-out operation */
+struct hg_multi_target {
+    struct hg_multi *multi;     /* Fan-out operation */
+    hg_handle_t handle;         /* Handle forwarded to target */
+    void *out_buf;              /* Encoded output relayed through tree */
+    hg_size_t out_buf_size;     /* Size of encoded output */
+    unsigned int subtree_count; /* Number of targets reached by handle */
+    hg_return_t ret;            /* Result of target */
+};
+
+/* Fan-out operation, tree nodes also use it to relay calls to their subtree
+ * (first target is then the node itself) */
+struct hg_multi {
+    struct hg_proc_info tree_proc_info; /* Proc info of relayed payloads */
+    const struct hg_proc_info *hg_proc_info; /* Proc info of RPC */
+    struct hg_context *context;              /* Context */
+    struct hg_private_handle *node_handle;   /* Handle of tree node */
+    struct hg_multi_target *targets;         /* Targets */
+    char *addrs;              /* Address strings of targets (tree) */
+    hg_size_t *addr_offsets;  /* Offsets of address strings (tree) */
+    void *in_buf;             /* Encoded input (tree) */
+    hg_size_t in_buf_size;    /* Size of encoded input (tree) */
+    void *reduced_buf;        /* Encoded reduced output */
+    hg_size_t reduced_buf_size; /* Size of encoded reduced output */
+    hg_proc_t proc;           /* Proc for relayed/reduced payloads */
+    hg_cb_t callback;         /* Callback */
+    void *arg;                /* Callback arguments */
+    hg_id_t id;               /* RPC ID */
+    hg_atomic_int32_t pending; /* Number of pending completions */
+    unsigned int count;        /* Number of targets */
+    unsigned int arity;        /* Tree arity (0 if direct) */
+};
+
+/* Input relayed through a tree */
+struct hg_multi_tree_in {
+    void *addrs;              /* Address strings of subtree */
+    void *in_buf;             /* Encoded input */
+    hg_uint64_t addrs_size;   /* Size of address strings */
+    hg_uint64_t in_buf_size;  /* Size of encoded input */
+    hg_uint32_t addr_count;   /* Number of addresses in subtree */
+    hg_uint32_t arity;        /* Tree arity */
+};
+
+/* Outputs relayed through a tree */
+struct hg_multi_tree_out {
+    struct hg_multi_target *targets; /* Targets of subtree */
+    void *reduced_buf;               /* Reduced output of subtree */
+    hg_uint64_t reduced_buf_size;    /* Size of reduced output */
+    hg_uint32_t count;               /* Number of targets */
+    hg_bool_t reduced;               /* Outputs were reduced */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -137,18 +313,70 @@ hg_more_data_cb(hg_core_handle_t core_handle, hg_op_t op,
 static void
 hg_more_data_free_cb(hg_core_handle_t core_handle);
 
+/**
+ * Trace callback.
+ */
+static void
+hg_trace_cb(hg_core_handle_t core_handle,
+    const struct hg_trace_info *trace_info, void *arg);
+
+/**
+ * Peer error callback.
+ */
+static void
+hg_peer_error_cb(hg_core_addr_t core_addr, hg_return_t ret, void *arg);
+
 /**
  * Core RPC callback.
  */
 static hg_return_t
 hg_core_rpc_cb(hg_core_handle_t core_handle);
 
+/**
+ * Post RPC callback to handler pool of context, returns false if the
+ * callback must be run inline.
+ */
+static hg_bool_t
+hg_exec_offload(struct hg_private_handle *hg_handle);
+
+/**
+ * Run offloaded RPC callback.
+ */
+static HG_THREAD_RETURN_TYPE
+hg_exec_handler(void *arg);
+
+/**
+ * Progress thread of context.
+ */
+static HG_THREAD_RETURN_TYPE
+hg_exec_progress_thread(void *arg);
+
+/**
+ * Forward callback of HG_Forward_wait().
+ */
+static hg_return_t
+hg_forward_wait_cb(const struct hg_cb_info *callback_info);
+
 /**
  * Core lookup callback.
  */
 static HG_INLINE hg_return_t
 hg_core_addr_lookup_cb(const struct hg_core_cb_info *callback_info);
 
+/**
+ * Decode header and get proc positioned at the start of the payload.
+ */
+static hg_return_t
+hg_get_struct_proc(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_op_t op, hg_proc_t *proc_p);
+
+/**
+ * Copy input/output structure that is shared with ourself.
+ */
+static hg_return_t
+hg_shared_copy(void **buf_p, hg_size_t *alloc_size_p, const void *struct_ptr,
+    hg_size_t size);
+
 /**
  * Decode and get input/output structure.
  */
@@ -164,6 +392,79 @@ hg_set_struct(struct hg_private_handle *hg_handle,
     const struct hg_proc_info *hg_proc_info, hg_op_t op, void *struct_ptr,
     hg_size_t *payload_size, hg_bool_t *more_data);
 
+#ifndef HG_HAS_XDR
+/**
+ * Replace encoded payload with compressed payload if it is worth it.
+ */
+static hg_return_t
+hg_compress_payload(struct hg_private_handle *hg_handle,
+    const struct hg_compressor *compressor, hg_proc_t proc, void *buf,
+    hg_size_t buf_size, hg_uint8_t *compress_id);
+
+/**
+ * Decompress payload into extra buffer.
+ */
+static hg_return_t
+hg_decompress_payload(struct hg_private_handle *hg_handle,
+    const struct hg_compressor *compressor, hg_op_t op, hg_uint8_t compress_id,
+    hg_proc_t proc, void **buf_p, hg_size_t *buf_size_p);
+#endif
+
+/**
+ * Create bulk handle for extra payload.
+ */
+static hg_return_t
+hg_create_extra_bulk(struct hg_private_handle *hg_handle, hg_proc_t proc,
+    void **extra_buf, hg_size_t *extra_buf_size, hg_bulk_t *extra_bulk);
+
+/**
+ * Encode descriptor of extra bulk handle in place of the payload.
+ */
+static hg_return_t
+hg_encode_extra_bulk(struct hg_private_handle *hg_handle, hg_proc_t proc,
+    void *buf, hg_size_t buf_size, hg_bulk_t extra_bulk);
+
+/**
+ * Allocate output region of at least size bytes advertised to targets.
+ */
+static hg_return_t
+hg_out_region_alloc(struct hg_private_handle *hg_handle, hg_size_t size);
+
+/**
+ * Free output region.
+ */
+static void
+hg_out_region_free(struct hg_private_handle *hg_handle);
+
+/**
+ * Push extra output payload to the output region of the origin.
+ */
+static hg_return_t
+hg_out_region_push(struct hg_private_handle *hg_handle);
+
+/**
+ * Output region push callback, sends the deferred response.
+ */
+static hg_return_t
+hg_out_region_push_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Encode output and return flags and payload size of the response, sent_p
+ * is set if the response has already been sent (or deferred).
+ */
+static hg_return_t
+hg_respond_prepare(struct hg_private_handle *hg_handle, hg_cb_t callback,
+    void *arg, void *out_struct, hg_uint8_t *flags_p, hg_size_t *payload_size_p,
+    hg_bool_t *sent_p);
+
+/**
+ * Post responses of core handles together and report their return codes.
+ */
+static hg_return_t
+hg_respond_batch_post(hg_core_handle_t core_handles[], void *args[],
+    const hg_uint8_t flags[], const hg_size_t payload_sizes[],
+    const unsigned int indices[], unsigned int count, hg_return_t rets[]);
+
 /**
  * Free allocated members from input/output structure.
  */
@@ -190,6 +491,39 @@ hg_get_extra_payload_cb(const struct hg_cb_info *callback_info);
 static void
 hg_free_extra_payload(struct hg_private_handle *hg_handle);
 
+/**
+ * Free allocated extra output payload.
+ */
+static void
+hg_free_extra_output(struct hg_private_handle *hg_handle);
+
+/**
+ * Get a registered buffer of at least size bytes from the extra buffer pool.
+ */
+static hg_return_t
+hg_extra_buf_pool_get(struct hg_private_class *hg_class, hg_size_t size,
+    struct hg_extra_buf **extra_buf_p);
+
+/**
+ * Release buffer to the extra buffer pool.
+ */
+static void
+hg_extra_buf_pool_release(
+    struct hg_private_class *hg_class, struct hg_extra_buf *extra_buf);
+
+/**
+ * Free pooled extra buffer.
+ */
+static void
+hg_extra_buf_free(
+    struct hg_private_class *hg_class, struct hg_extra_buf *extra_buf);
+
+/**
+ * Free all buffers of the extra buffer pool.
+ */
+static void
+hg_extra_buf_pool_drain(struct hg_private_class *hg_class);
+
 /**
  * Forward callback.
  */
@@ -202,6 +536,158 @@ hg_core_forward_cb(const struct hg_core_cb_info *callback_info);
 static HG_INLINE hg_return_t
 hg_core_respond_cb(const struct hg_core_cb_info *callback_info);
 
+/**
+ * Partial response callback.
+ */
+static hg_return_t
+hg_core_stream_cb(const struct hg_core_cb_info *callback_info);
+
+/**
+ * Partial respond callback.
+ */
+static hg_return_t
+hg_core_partial_cb(const struct hg_core_cb_info *callback_info);
+
+/**
+ * Create fan-out operation.
+ */
+static hg_return_t
+hg_multi_create(struct hg_context *context,
+    const struct hg_proc_info *hg_proc_info, hg_id_t id, unsigned int count,
+    unsigned int arity, struct hg_multi **multi_p);
+
+/**
+ * Free fan-out operation.
+ */
+static void
+hg_multi_free(struct hg_multi *multi);
+
+/**
+ * Complete one of the pending operations of fan-out and execute callback (or
+ * respond to parent node) once they have all completed.
+ */
+static hg_return_t
+hg_multi_complete(struct hg_multi *multi);
+
+/**
+ * Forward to each target directly, the input is only encoded once for all
+ * targets that share the same encoding.
+ */
+static void
+hg_multi_forward_direct(struct hg_multi *multi, const hg_addr_t *addrs,
+    void *in_struct, unsigned int *posted_p);
+
+/**
+ * Forward by copying the encoded input of another handle.
+ */
+static hg_return_t
+hg_multi_forward_copy(struct hg_private_handle *hg_handle,
+    struct hg_private_handle *src_handle, hg_size_t payload_size,
+    hg_uint8_t flags);
+
+/**
+ * Direct forward callback.
+ */
+static hg_return_t
+hg_multi_forward_cb(const struct hg_cb_info *callback_info);
+
+#ifndef HG_HAS_XDR
+/**
+ * Proc relayed input.
+ */
+static hg_return_t
+hg_multi_tree_in_proc(hg_proc_t proc, void *data);
+
+/**
+ * Proc relayed outputs.
+ */
+static hg_return_t
+hg_multi_tree_out_proc(hg_proc_t proc, void *data);
+
+/**
+ * Encode structure into a separate buffer (if buf is NULL, size is first
+ * computed and encoding is done in place).
+ */
+static hg_return_t
+hg_multi_encode(hg_proc_t proc, void *buf, hg_size_t buf_size,
+    hg_proc_cb_t proc_cb, hg_bool_t varint, void *struct_ptr,
+    void **encoded_buf_p, hg_size_t *encoded_buf_size_p);
+
+/**
+ * Decode output of a fan-out operation from an encoded buffer.
+ */
+static hg_return_t
+hg_multi_decode_output(
+    struct hg_multi *multi, void *buf, hg_size_t buf_size, void *out_struct);
+
+/**
+ * Free output decoded with hg_multi_decode_output().
+ */
+static hg_return_t
+hg_multi_free_output(struct hg_multi *multi, void *out_struct);
+
+/**
+ * Reduce outputs of targets that completed into a single encoded output.
+ */
+static hg_return_t
+hg_multi_reduce(struct hg_multi *multi);
+
+/**
+ * Set address strings of targets.
+ */
+static hg_return_t
+hg_multi_set_addrs(struct hg_multi *multi, const hg_addr_t *addrs);
+
+/**
+ * Split targets starting at first into subtrees and forward to the root of
+ * each subtree (address strings are looked up if addrs is NULL).
+ */
+static void
+hg_multi_tree_forward(struct hg_multi *multi, unsigned int first,
+    const hg_addr_t *addrs, unsigned int *posted_p);
+
+/**
+ * Look up address string of a subtree root. Own address is returned as self
+ * address, as it may not be resolvable when the class is not listening.
+ */
+static hg_return_t
+hg_multi_tree_addr_lookup(
+    struct hg_multi *multi, const char *name, hg_addr_t *addr_p);
+
+/**
+ * Forward to the root of a subtree.
+ */
+static hg_return_t
+hg_multi_tree_forward_one(
+    struct hg_multi *multi, unsigned int start, hg_addr_t addr);
+
+/**
+ * Tree forward callback.
+ */
+static hg_return_t
+hg_multi_tree_forward_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Relay call to subtree of node if it was received through a tree.
+ */
+static hg_return_t
+hg_multi_node_init(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info);
+
+/**
+ * Keep output of node until its subtree has responded.
+ */
+static hg_return_t
+hg_multi_node_respond(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, void *out_struct);
+
+/**
+ * Respond to parent with the outputs of subtree.
+ */
+static hg_return_t
+hg_multi_node_complete(struct hg_multi *multi);
+#endif
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -248,16 +734,25 @@ hg_handle_create(struct hg_private_class *hg_class)
     hg_proc_hash_t hash;
     hg_return_t ret;
 
-    /* Create private data to wrap callbacks etc */
-    hg_handle = (struct hg_private_handle *) calloc(1, sizeof(*hg_handle));
+    /* Create private data to wrap callbacks etc, user private area is
+     * allocated inline and recycled along with the handle */
+    hg_handle = (struct hg_private_handle *) calloc(
+        1, HG_PRIVATE_AREA_OFFSET + hg_class->private_area_size);
     HG_CHECK_SUBSYS_ERROR_NORET(rpc, hg_handle == NULL, error,
         "Could not allocate handle private data");
+    hg_atomic_incr32(&hg_class->handle_count);
+
+    if (hg_class->private_area_size > 0) {
+        hg_handle->handle.private_area =
+            (char *) hg_handle + HG_PRIVATE_AREA_OFFSET;
+        hg_handle->private_area_size = hg_class->private_area_size;
+    }
 
     hg_handle->handle.info.hg_class = (hg_class_t *) hg_class;
     hg_header_init(&hg_handle->hg_header, HG_UNDEF);
     if (hg_class->checksum_level > HG_CHECKSUM_RPC_HEADERS) {
         hg_handle->use_checksums = HG_TRUE;
-        hash = HG_CRC32;
+        hash = hg_class->checksum_payload_buf ? HG_CRC32C_BUF : HG_CRC32;
     } else
         hash = HG_NOHASH;
 
@@ -290,7 +785,10 @@ hg_handle_free(void *arg)
         hg_proc_free(hg_handle->in_proc);
     if (hg_handle->out_proc != HG_PROC_NULL)
         hg_proc_free(hg_handle->out_proc);
+    hg_out_region_free(hg_handle);
     hg_header_finalize(&hg_handle->hg_header);
+    free(hg_handle->shared_in);
+    free(hg_handle->shared_out);
     free(hg_handle);
 }
 
@@ -382,6 +880,51 @@ hg_more_data_free_cb(hg_core_handle_t core_handle)
         return;
 
     hg_free_extra_payload(hg_handle);
+
+    /* Private area is reset rather than freed */
+    if (hg_handle->private_area_size > 0)
+        memset(hg_handle->handle.private_area, 0,
+            (size_t) hg_handle->private_area_size);
+
+    /* Output region advertised along with the input */
+    if (hg_handle->out_region_remote != HG_BULK_NULL) {
+        HG_Bulk_free(hg_handle->out_region_remote);
+        hg_handle->out_region_remote = HG_BULK_NULL;
+    }
+    hg_handle->out_region_advertised = HG_FALSE;
+    hg_handle->out_region_push = HG_FALSE;
+
+    /* Relayed input may be referenced until handle is released */
+    free(hg_handle->tree_in_buf);
+    hg_handle->tree_in_buf = NULL;
+    hg_handle->tree_in_buf_size = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_trace_cb(hg_core_handle_t core_handle,
+    const struct hg_trace_info *trace_info, void *arg)
+{
+    struct hg_private_class *private_class = (struct hg_private_class *) arg;
+    struct hg_private_handle *hg_handle;
+
+    /* Retrieve private data */
+    hg_handle = (struct hg_private_handle *) HG_Core_get_data(core_handle);
+    if (!hg_handle)
+        return;
+
+    private_class->trace(
+        (hg_handle_t) hg_handle, trace_info, private_class->trace_arg);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_peer_error_cb(hg_core_addr_t core_addr, hg_return_t ret, void *arg)
+{
+    struct hg_private_class *private_class = (struct hg_private_class *) arg;
+
+    private_class->peer_error(
+        (hg_addr_t) core_addr, ret, private_class->peer_error_arg);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -412,6 +955,18 @@ hg_core_rpc_cb(hg_core_handle_t core_handle)
     HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info->rpc_cb == NULL, error, ret,
         HG_INVALID_ARG, "No RPC callback registered");
 
+#ifndef HG_HAS_XDR
+    /* Calls received through a tree are relayed before being executed */
+    ret = hg_multi_node_init(hg_handle, hg_proc_info);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not relay call (%s)",
+        HG_Error_to_string(ret));
+#endif
+
+    /* Long handlers are run by the handler pool so that they do not delay
+     * other completions */
+    if (hg_proc_info->offload && hg_exec_offload(hg_handle))
+        return HG_SUCCESS;
+
     ret = hg_proc_info->rpc_cb((hg_handle_t) hg_handle);
 
     return HG_SUCCESS;
@@ -424,50 +979,214 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_addr_lookup_cb(const struct hg_core_cb_info *callback_info)
+static hg_bool_t
+hg_exec_offload(struct hg_private_handle *hg_handle)
 {
-    struct hg_op_id *hg_op_id = (struct hg_op_id *) callback_info->arg;
-    struct hg_cb_info hg_cb_info = {.arg = hg_op_id->arg,
-        .ret = callback_info->ret,
-        .type = hg_op_id->type,
-        .info.lookup.addr = (hg_addr_t) callback_info->info.lookup.addr};
+    struct hg_exec *hg_exec = HG_CONTEXT_EXEC(hg_handle->handle.info.context);
+    hg_bool_t offloaded = HG_FALSE;
+
+    if (!hg_atomic_get32(&hg_exec->offloading))
+        return HG_FALSE;
+
+    /* Pool cannot be destroyed while handlers are being posted */
+    hg_atomic_incr32(&hg_exec->posting);
+    if (hg_atomic_get32(&hg_exec->offloading)) {
+        hg_handle->offload_work.func = hg_exec_handler;
+        hg_handle->offload_work.args = hg_handle;
+        offloaded = (hg_thread_pool_post(hg_exec->pool,
+                         &hg_handle->offload_work) == HG_UTIL_SUCCESS);
+    }
+    hg_atomic_decr32(&hg_exec->posting);
 
-    if (hg_op_id->callback)
-        hg_op_id->callback(&hg_cb_info);
+    return offloaded;
+}
 
-    /* NB. OK to free after callback execution, op ID is not re-used */
-    free(hg_op_id);
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_exec_handler(void *arg)
+{
+    struct hg_private_handle *hg_handle = (struct hg_private_handle *) arg;
+    const struct hg_proc_info *hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(
+            hg_handle->handle.core_handle);
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
 
-    return HG_SUCCESS;
+    (void) hg_proc_info->rpc_cb((hg_handle_t) hg_handle);
+
+    return tret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_get_struct(struct hg_private_handle *hg_handle,
-    const struct hg_proc_info *hg_proc_info, hg_op_t op, void *struct_ptr)
+static HG_THREAD_RETURN_TYPE
+hg_exec_progress_thread(void *arg)
+{
+    struct hg_context *hg_context = (struct hg_context *) arg;
+    struct hg_exec *hg_exec = HG_CONTEXT_EXEC(hg_context);
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+    hg_return_t ret;
+
+    do {
+        unsigned int actual_count = 0;
+
+        /* Completion callbacks and inline handlers run on this thread */
+        do {
+            ret = HG_Trigger(
+                hg_context, 0, HG_EXEC_TRIGGER_MAX, &actual_count);
+        } while (ret == HG_SUCCESS && actual_count == HG_EXEC_TRIGGER_MAX);
+        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+            done, "HG_Trigger() failed (%s)", HG_Error_to_string(ret));
+
+        if (hg_atomic_get32(&hg_exec->stopping))
+            break;
+
+        ret = HG_Progress(hg_context, hg_exec->progress_timeout);
+        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+            done, "HG_Progress() failed (%s)", HG_Error_to_string(ret));
+    } while (1);
+
+done:
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_wait_progress(
+    hg_context_t *context, struct hg_wait *hg_wait, unsigned int timeout_ms)
+{
+    hg_core_context_t *core_context = context->core_context;
+    hg_time_t deadline, now = hg_time_from_ms(0);
+    hg_return_t ret;
+
+    if (hg_atomic_get32(&hg_wait->done))
+        return HG_SUCCESS;
+
+    if (timeout_ms != 0)
+        hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
+
+    for (;;) {
+        unsigned int remaining =
+            hg_time_less(now, deadline)
+                ? hg_time_to_ms(hg_time_subtract(deadline, now))
+                : 0;
+
+        if (HG_CONTEXT_EXEC(context)->started) {
+            /* Progress thread triggers the callback and wakes us up */
+            hg_core_completion_wait(
+                core_context, &hg_wait->done, HG_FALSE, remaining);
+        } else {
+            unsigned int count = 0;
+
+            /* Sleep until something completes rather than competing with
+             * the thread that is already making progress */
+            if (hg_core_context_progressing(core_context))
+                hg_core_completion_wait(
+                    core_context, &hg_wait->done, HG_TRUE, remaining);
+            else {
+                ret = HG_Core_progress(core_context, remaining);
+                HG_CHECK_SUBSYS_ERROR_NORET(poll,
+                    ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+                    "Could not make progress on context (%s)",
+                    HG_Error_to_string(ret));
+            }
+
+            if (!hg_atomic_get32(&hg_wait->done)) {
+                ret = HG_Core_trigger(
+                    core_context, 0, HG_WAIT_TRIGGER_MAX, &count);
+                HG_CHECK_SUBSYS_ERROR_NORET(poll,
+                    ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+                    "Could not trigger operations from context (%s)",
+                    HG_Error_to_string(ret));
+            }
+        }
+
+        if (hg_atomic_get32(&hg_wait->done))
+            return HG_SUCCESS;
+        if (remaining == 0)
+            return HG_TIMEOUT;
+
+        hg_time_get_current_ms(&now);
+    }
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_wait_signal(struct hg_wait *hg_wait, hg_return_t ret)
+{
+    hg_core_context_t *core_context = hg_wait->core_context;
+
+    /* Waiter may return and release hg_wait as soon as done is set */
+    hg_wait->ret = ret;
+    hg_atomic_incr32(&hg_wait->done);
+    hg_core_completion_wake(core_context);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_forward_wait_cb(const struct hg_cb_info *callback_info)
+{
+    hg_wait_signal((struct hg_wait *) callback_info->arg, callback_info->ret);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_addr_lookup_cb(const struct hg_core_cb_info *callback_info)
+{
+    struct hg_op_id *hg_op_id = (struct hg_op_id *) callback_info->arg;
+    struct hg_cb_info hg_cb_info = {.arg = hg_op_id->arg,
+        .ret = callback_info->ret,
+        .type = hg_op_id->type,
+        .info.lookup.addr = (hg_addr_t) callback_info->info.lookup.addr};
+
+    if (hg_op_id->callback)
+        hg_op_id->callback(&hg_cb_info);
+
+    /* NB. OK to free after callback execution, op ID is not re-used */
+    free(hg_op_id);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_get_struct_proc(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_op_t op, hg_proc_t *proc_p)
 {
     hg_proc_t proc = HG_PROC_NULL;
-    hg_proc_cb_t proc_cb = NULL;
     void *buf, *extra_buf;
     hg_size_t buf_size, extra_buf_size;
     struct hg_header *hg_header = &hg_handle->hg_header;
-#ifdef HG_HAS_CHECKSUMS
-    struct hg_header_hash *hg_header_hash = NULL;
-#endif
+    hg_uint8_t *compress_id = NULL;
+    hg_bool_t decompressed = HG_FALSE;
     hg_size_t header_offset = hg_header_get_size(op);
     hg_return_t ret;
 
+    /* Input relayed through a tree was extracted from the payload and
+     * verified when the call was received */
+    if (op == HG_INPUT && hg_handle->tree_in_buf != NULL) {
+        ret = hg_proc_reset(hg_handle->in_proc, hg_handle->tree_in_buf,
+            hg_handle->tree_in_buf_size, HG_DECODE);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+#ifndef HG_HAS_XDR
+        if (hg_proc_info->varint)
+            hg_proc_set_flags(hg_handle->in_proc, HG_PROC_VARINT);
+#endif
+        *proc_p = hg_handle->in_proc;
+
+        return HG_SUCCESS;
+    }
+
     switch (op) {
         case HG_INPUT:
             /* Use custom header offset */
             header_offset += hg_handle->handle.info.hg_class->in_offset;
             /* Set input proc */
             proc = hg_handle->in_proc;
-            proc_cb = hg_proc_info->in_proc_cb;
-#ifdef HG_HAS_CHECKSUMS
-            hg_header_hash = &hg_header->msg.input.hash;
-#endif
 
             /* Get core input buffer */
             ret = HG_Core_get_input(
@@ -478,21 +1197,14 @@ hg_get_struct(struct hg_private_handle *hg_handle,
 
             extra_buf = hg_handle->in_extra_buf;
             extra_buf_size = hg_handle->in_extra_buf_size;
+            compress_id = &hg_header->msg.input.compress;
+            decompressed = hg_handle->in_decompressed;
             break;
         case HG_OUTPUT:
-            /* Cannot respond if no_response flag set */
-            HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info->no_response, error, ret,
-                HG_OPNOTSUPPORTED,
-                "No output was produced on that RPC (no response)");
-
             /* Use custom header offset */
             header_offset += hg_handle->handle.info.hg_class->out_offset;
             /* Set output proc */
             proc = hg_handle->out_proc;
-            proc_cb = hg_proc_info->out_proc_cb;
-#ifdef HG_HAS_CHECKSUMS
-            hg_header_hash = &hg_header->msg.output.hash;
-#endif
 
             /* Get core output buffer */
             ret = HG_Core_get_output(
@@ -502,13 +1214,13 @@ hg_get_struct(struct hg_private_handle *hg_handle,
 
             extra_buf = hg_handle->out_extra_buf;
             extra_buf_size = hg_handle->out_extra_buf_size;
+            compress_id = &hg_header->msg.output.compress;
+            decompressed = hg_handle->out_decompressed;
             break;
         default:
             HG_GOTO_SUBSYS_ERROR(
                 rpc, error, ret, HG_INVALID_ARG, "Invalid HG op");
     }
-    HG_CHECK_SUBSYS_ERROR(rpc, proc_cb == NULL, error, ret, HG_FAULT,
-        "No proc set, proc must be set in HG_Register()");
 
     /* Reset header */
     hg_header_reset(hg_header, op);
@@ -522,16 +1234,161 @@ hg_get_struct(struct hg_private_handle *hg_handle,
     if (extra_buf) {
         buf = extra_buf;
         buf_size = extra_buf_size;
+    } else if (op == HG_OUTPUT &&
+               (hg_header->msg.output.flags & HG_HEADER_REGION)) {
+        hg_uint64_t region_size;
+
+        /* Payload was pushed to the output region, only its size was sent */
+        ret = hg_proc_reset(proc, (char *) buf + header_offset,
+            buf_size - header_offset, HG_DECODE);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+
+        ret = hg_proc_hg_uint64_t(proc, &region_size);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not decode output region payload size");
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            hg_handle->out_region_buf == NULL ||
+                region_size > hg_handle->out_region_size,
+            error, ret, HG_PROTOCOL_ERROR,
+            "Invalid output region payload size (%" PRIu64 " bytes)",
+            region_size);
+
+        buf = hg_handle->out_region_buf;
+        buf_size = (hg_size_t) region_size;
     } else {
         /* Include our own header offset */
         buf = (char *) buf + header_offset;
         buf_size -= header_offset;
     }
 
+    /* Decompress payload unless it was already decompressed by a previous
+     * call */
+    if (*compress_id != 0 && !decompressed) {
+#ifdef HG_HAS_XDR
+        HG_GOTO_SUBSYS_ERROR(rpc, error, ret, HG_PROTOCOL_ERROR,
+            "Compressed payloads are not supported with XDR");
+#else
+        ret = hg_decompress_payload(hg_handle, hg_proc_info->compressor, op,
+            *compress_id, proc, &buf, &buf_size);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not decompress payload");
+#endif
+    }
+
     /* Reset proc */
     ret = hg_proc_reset(proc, buf, buf_size, HG_DECODE);
     HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
 
+#ifndef HG_HAS_XDR
+    if (hg_proc_info->varint)
+        hg_proc_set_flags(proc, HG_PROC_VARINT);
+#else
+    (void) hg_proc_info;
+#endif
+
+    /* Output region advertised by the origin precedes the payload, keep the
+     * first one decoded */
+    if (op == HG_INPUT && (hg_header->msg.input.flags & HG_HEADER_OUT_REGION)) {
+        hg_bulk_t out_region = HG_BULK_NULL;
+
+        ret = hg_proc_hg_bulk_t(proc, &out_region);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not decode output region");
+        if (hg_handle->out_region_remote == HG_BULK_NULL)
+            hg_handle->out_region_remote = out_region;
+        else
+            HG_Bulk_free(out_region);
+    }
+
+    /* Eager bulk data may point into the input, which is then kept */
+    if (op == HG_INPUT && HG_HANDLE_CLASS(&hg_handle->handle)->bulk_eager_ref)
+        hg_proc_set_handle(proc, &hg_handle->handle);
+
+    *proc_p = proc;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_shared_copy(void **buf_p, hg_size_t *alloc_size_p, const void *struct_ptr,
+    hg_size_t size)
+{
+    hg_return_t ret;
+
+    if (*alloc_size_p < size) {
+        void *buf = realloc(*buf_p, size);
+        HG_CHECK_SUBSYS_ERROR(rpc, buf == NULL, error, ret, HG_NOMEM,
+            "Could not allocate shared struct (%" PRIu64 " bytes)", size);
+        *buf_p = buf;
+        *alloc_size_p = size;
+    }
+    memcpy(*buf_p, struct_ptr, size);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_get_struct(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_op_t op, void *struct_ptr)
+{
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_proc_cb_t proc_cb = NULL;
+#ifdef HG_HAS_CHECKSUMS
+    struct hg_header *hg_header = &hg_handle->hg_header;
+    struct hg_header_hash *hg_header_hash = NULL;
+#endif
+    hg_return_t ret;
+
+    switch (op) {
+        case HG_INPUT:
+            proc_cb = hg_proc_info->in_proc_cb;
+#ifdef HG_HAS_CHECKSUMS
+            hg_header_hash = &hg_header->msg.input.hash;
+#endif
+            break;
+        case HG_OUTPUT:
+            /* Cannot respond if no_response flag set */
+            HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info->no_response, error, ret,
+                HG_OPNOTSUPPORTED,
+                "No output was produced on that RPC (no response)");
+
+            proc_cb = hg_proc_info->out_proc_cb;
+#ifdef HG_HAS_CHECKSUMS
+            hg_header_hash = &hg_header->msg.output.hash;
+#endif
+            break;
+        default:
+            HG_GOTO_SUBSYS_ERROR(
+                rpc, error, ret, HG_INVALID_ARG, "Invalid HG op");
+    }
+
+    /* Struct was passed by value when forwarding to ourself */
+    if (op == HG_INPUT && hg_handle->in_shared) {
+        memcpy(struct_ptr, hg_handle->shared_in, hg_proc_info->shared_in_size);
+        HG_Core_ref_incr(hg_handle->handle.core_handle);
+        return HG_SUCCESS;
+    } else if (op == HG_OUTPUT && hg_handle->out_shared) {
+        memcpy(
+            struct_ptr, hg_handle->shared_out, hg_proc_info->shared_out_size);
+        HG_Core_ref_incr(hg_handle->handle.core_handle);
+        return HG_SUCCESS;
+    }
+
+    HG_CHECK_SUBSYS_ERROR(rpc, proc_cb == NULL, error, ret, HG_FAULT,
+        "No proc set, proc must be set in HG_Register()");
+
+    /* Get proc over the encoded payload */
+    ret = hg_get_struct_proc(hg_handle, hg_proc_info, op, &proc);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get payload proc");
+
     /* Decode parameters */
     ret = proc_cb(proc, struct_ptr);
     HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not decode parameters");
@@ -542,7 +1399,8 @@ hg_get_struct(struct hg_private_handle *hg_handle,
 
 #ifdef HG_HAS_CHECKSUMS
     /* Compare checksum with header hash */
-    if (hg_handle->use_checksums) {
+    if (hg_handle->use_checksums &&
+        !(op == HG_INPUT && hg_handle->tree_in_buf != NULL)) {
         ret = hg_proc_checksum_verify(
             proc, &hg_header_hash->payload, sizeof(hg_header_hash->payload));
         HG_CHECK_SUBSYS_HG_ERROR(
@@ -588,6 +1446,12 @@ hg_set_struct(struct hg_private_handle *hg_handle,
     struct hg_header_hash *hg_header_hash = NULL;
 #endif
     hg_size_t header_offset = hg_header_get_size(op);
+#ifndef HG_HAS_XDR
+    hg_size_t ref_threshold = 0, encoded_size = 0;
+    hg_uint8_t *compress_id = NULL;
+#endif
+    hg_size_t bulk_eager_budget = HG_SIZE_MAX;
+    hg_bool_t bulk_eager;
     hg_return_t ret;
 
     switch (op) {
@@ -610,6 +1474,12 @@ hg_set_struct(struct hg_private_handle *hg_handle,
             extra_buf = &hg_handle->in_extra_buf;
             extra_buf_size = &hg_handle->in_extra_buf_size;
             extra_bulk = &hg_handle->in_extra_bulk;
+#ifndef HG_HAS_XDR
+            compress_id = &hg_header->msg.input.compress;
+#endif
+            /* Output of a previous forward is no longer referenced and
+             * must not be mistaken for the next one */
+            hg_free_extra_output(hg_handle);
             break;
         case HG_OUTPUT:
             /* Cannot respond if no_response flag set */
@@ -635,6 +1505,10 @@ hg_set_struct(struct hg_private_handle *hg_handle,
             extra_buf = &hg_handle->out_extra_buf;
             extra_buf_size = &hg_handle->out_extra_buf_size;
             extra_bulk = &hg_handle->out_extra_bulk;
+#ifndef HG_HAS_XDR
+            compress_id = &hg_header->msg.output.compress;
+#endif
+            hg_handle->out_region_push = HG_FALSE;
             break;
         default:
             HG_GOTO_SUBSYS_ERROR(
@@ -646,17 +1520,41 @@ hg_set_struct(struct hg_private_handle *hg_handle,
         return HG_SUCCESS;
     }
 
+    /* Output region descriptor is decoded along with the input, decode it
+     * now if the input was not (header is shared with the input) */
+    if (op == HG_OUTPUT && hg_handle->out_region_advertised &&
+        hg_handle->out_region_remote == HG_BULK_NULL) {
+        hg_proc_t in_proc = HG_PROC_NULL;
+
+        ret = hg_get_struct_proc(hg_handle, hg_proc_info, HG_INPUT, &in_proc);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not decode output region");
+    }
+
     /* Reset header */
     hg_header_reset(hg_header, op);
 
+    /* Let target know that it must relay the payload */
+    if (op == HG_INPUT && hg_proc_info->tree)
+        hg_header->msg.input.flags |= HG_HEADER_TREE;
+
+#ifndef HG_HAS_XDR
+    /* Advertise a region that the target can push a large output to, there
+     * is no point in doing so when forwarding to ourself */
+    if (op == HG_INPUT && hg_proc_info->out_region_size > 0 &&
+        !hg_proc_info->tree && !hg_proc_info->no_response &&
+        !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr)) {
+        ret = hg_out_region_alloc(hg_handle, hg_proc_info->out_region_size);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate output region");
+        hg_header->msg.input.flags |= HG_HEADER_OUT_REGION;
+    }
+#endif
+
     /* Include our own header offset */
     buf = (char *) buf + header_offset;
     buf_size -= header_offset;
 
-    /* Reset proc */
-    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
-
 #ifdef NA_HAS_SM
     /* Determine if we need special handling for SM */
     if (HG_Core_addr_get_na_sm(hg_handle->handle.core_handle->info.addr) !=
@@ -664,12 +1562,111 @@ hg_set_struct(struct hg_private_handle *hg_handle,
         proc_flags |= HG_PROC_SM;
 #endif
 
-    /* Attempt to use eager bulk transfers when appropriate */
-    if (HG_HANDLE_CLASS(&hg_handle->handle)->bulk_eager &&
+    /* Attempt to use eager bulk transfers when appropriate, RPCs that have
+     * their own policy override the class default */
+    if (hg_proc_info->bulk_eager_set) {
+        bulk_eager = hg_proc_info->bulk_eager_max > 0;
+        bulk_eager_budget = hg_proc_info->bulk_eager_max;
+    } else
+        bulk_eager = HG_HANDLE_CLASS(&hg_handle->handle)->bulk_eager;
+    if (bulk_eager &&
         !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
         proc_flags |= HG_PROC_BULK_EAGER;
 
+    /* Bulk handles sent to ourself are only transferred through loopback */
+    if (HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
+        proc_flags |= HG_PROC_SELF;
+
+#ifndef HG_HAS_XDR
+    /* Keep large input fields as references to user memory, there is no
+     * point in doing so for fields that would fit into the buffer. When
+     * forwarding to ourself, the extra buffer is decoded directly and must
+     * therefore contain the entire payload */
+    if (op == HG_INPUT &&
+        HG_HANDLE_CLASS(&hg_handle->handle)->input_ref_threshold > 0 &&
+        !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr)) {
+        ref_threshold =
+            HG_HANDLE_CLASS(&hg_handle->handle)->input_ref_threshold;
+        if (ref_threshold < buf_size)
+            ref_threshold = buf_size;
+    }
+
+    if (hg_proc_info->varint)
+        proc_flags |= HG_PROC_VARINT;
+
+    /* Size the other fields first so that embedded bulk data only takes
+     * the space that they leave in the buffer and never pushes them into an
+     * extra buffer */
+    if ((proc_flags & HG_PROC_BULK_EAGER) && hg_proc_info->bulk_eager_set) {
+        hg_size_t other_size;
+
+        ret = hg_proc_reset(proc, NULL, 0, HG_SIZE);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+
+        hg_proc_set_flags(
+            proc, (hg_uint8_t) (proc_flags & ~HG_PROC_BULK_EAGER));
+        hg_proc_set_ref_threshold(proc, ref_threshold);
+
+        ret = proc_cb(proc, struct_ptr);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not compute size of parameters");
+
+        other_size = hg_proc_get_size_used(proc);
+        if (other_size < buf_size) {
+            if (bulk_eager_budget > buf_size - other_size)
+                bulk_eager_budget = buf_size - other_size;
+        } else
+            proc_flags &= (hg_uint8_t) ~HG_PROC_BULK_EAGER;
+
+        HG_LOG_SUBSYS_DEBUG(rpc,
+            "Eager bulk budget is %" PRIu64 " bytes (other fields take %" PRIu64
+            " bytes)",
+            (proc_flags & HG_PROC_BULK_EAGER) ? bulk_eager_budget : 0,
+            other_size);
+
+        /* Nothing is embedded if the other fields do not fit */
+        if (hg_proc_info->precompute_size)
+            encoded_size = other_size;
+    } else if (hg_proc_info->precompute_size) {
+        /* Compute encoded size first so that the extra buffer, if needed, is
+         * allocated once instead of being grown while encoding */
+        ret = hg_proc_reset(proc, NULL, 0, HG_SIZE);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+
+        hg_proc_set_flags(proc, proc_flags);
+        hg_proc_set_ref_threshold(proc, ref_threshold);
+
+        ret = proc_cb(proc, struct_ptr);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not compute size of parameters");
+
+        encoded_size = hg_proc_get_size_used(proc);
+    }
+#endif
+
+    /* Reset proc */
+    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+
     hg_proc_set_flags(proc, proc_flags);
+    hg_proc_set_bulk_eager_budget(proc, bulk_eager_budget);
+
+#ifndef HG_HAS_XDR
+    hg_proc_set_ref_threshold(proc, ref_threshold);
+
+    if (encoded_size > buf_size) {
+        ret = hg_proc_set_size(proc, encoded_size);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate extra buffer");
+    }
+
+    /* Output region descriptor precedes the payload */
+    if (op == HG_INPUT && (hg_header->msg.input.flags & HG_HEADER_OUT_REGION)) {
+        ret = hg_proc_hg_bulk_t(proc, &hg_handle->out_region);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not encode output region");
+    }
+#endif
 
     /* Encode parameters */
     ret = proc_cb(proc, struct_ptr);
@@ -689,6 +1686,20 @@ hg_set_struct(struct hg_private_handle *hg_handle,
     }
 #endif
 
+#ifndef HG_HAS_XDR
+    /* Compress payload once it has been fully encoded (and checksummed),
+     * references to user memory are not compressed and compressing a
+     * payload that is not sent over the network would only add overhead */
+    if (hg_proc_info->compressor != NULL &&
+        hg_proc_get_size_used(proc) >= hg_proc_info->compress_threshold &&
+        hg_proc_get_ref_count(proc) == 0 &&
+        !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr)) {
+        ret = hg_compress_payload(hg_handle, hg_proc_info->compressor, proc,
+            buf, buf_size, compress_id);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not compress payload");
+    }
+#endif
+
     /* The proc object may have allocated an extra buffer at this point.
      * If the payload did not fit into the original buffer, we need to send a
      * message with "more data" flag set along with the bulk data descriptor
@@ -702,54 +1713,42 @@ hg_set_struct(struct hg_private_handle *hg_handle,
         HG_GOTO_SUBSYS_ERROR(rpc, error, ret, HG_OVERFLOW,
             "Arguments overflow is not supported with XDR");
 #endif
-        /* Create a bulk descriptor only of the size that is used */
-        *extra_buf = hg_proc_get_extra_buf(proc);
-        *extra_buf_size = hg_proc_get_size_used(proc);
-
-        /* Prevent buffer from being freed when proc_reset is called */
-        hg_proc_set_extra_buf_is_mine(proc, HG_TRUE);
-
         /* Create bulk descriptor */
-        ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1, extra_buf,
-            extra_buf_size, HG_BULK_READ_ONLY, extra_bulk);
+        ret = hg_create_extra_bulk(
+            hg_handle, proc, extra_buf, extra_buf_size, extra_bulk);
         HG_CHECK_SUBSYS_HG_ERROR(
-            rpc, error, ret, "Could not create bulk data handle");
-
-        /* Reset proc */
-        ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
-
-        /* Reset proc flags */
-        proc_flags = 0;
+            rpc, error, ret, "Could not create extra bulk handle");
 
-#ifdef NA_HAS_SM
-        /* Determine if we need special handling for SM */
-        if (HG_Core_addr_get_na_sm(hg_handle->handle.core_handle->info.addr) !=
-            NULL)
-            proc_flags |= HG_PROC_SM;
-#endif
-
-        /* Attempt to use eager bulk transfers when appropriate */
-        if (HG_HANDLE_CLASS(&hg_handle->handle)->bulk_eager &&
-            !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
-            proc_flags |= HG_PROC_BULK_EAGER;
+#ifndef HG_HAS_XDR
+        /* Push output to the region advertised by the origin before
+         * responding, the response then only carries the payload size */
+        if (op == HG_OUTPUT && hg_handle->out_region_remote != HG_BULK_NULL &&
+            *compress_id == 0 &&
+            *extra_buf_size <= HG_Bulk_get_size(hg_handle->out_region_remote)) {
+            hg_uint64_t region_size = (hg_uint64_t) *extra_buf_size;
 
-        hg_proc_set_flags(proc, proc_flags);
+            ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+            HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
 
-        /* Encode extra_bulk_handle, we can do that safely here because
-         * the user payload has been copied so we don't have to worry
-         * about overwriting the user's data */
-        ret = hg_proc_hg_bulk_t(proc, extra_bulk);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            rpc, error, ret, "Could not process extra bulk handle");
+            ret = hg_proc_hg_uint64_t(proc, &region_size);
+            HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+                "Could not encode output region payload size");
 
-        ret = hg_proc_flush(proc);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Error in proc flush");
+            ret = hg_proc_flush(proc);
+            HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Error in proc flush");
 
-        HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_get_extra_buf(proc), error, ret,
-            HG_OVERFLOW, "Extra bulk handle could not fit into buffer");
+            hg_header->msg.output.flags |= HG_HEADER_REGION;
+            hg_handle->out_region_push = HG_TRUE;
+        } else
+#endif
+        {
+            ret = hg_encode_extra_bulk(
+                hg_handle, proc, buf, buf_size, *extra_bulk);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                rpc, error, ret, "Could not encode extra bulk handle");
 
-        *more_data = HG_TRUE;
+            *more_data = HG_TRUE;
+        }
     }
 
     /* Encode header */
@@ -772,21 +1771,469 @@ error:
     return ret;
 }
 
+#ifndef HG_HAS_XDR
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_free_struct(struct hg_private_handle *hg_handle,
-    const struct hg_proc_info *hg_proc_info, hg_op_t op, void *struct_ptr)
+hg_compress_payload(struct hg_private_handle *hg_handle,
+    const struct hg_compressor *compressor, hg_proc_t proc, void *buf,
+    hg_size_t buf_size, hg_uint8_t *compress_id)
 {
-    void *buf = NULL;
-    hg_size_t buf_size = 0;
-#ifdef HG_HAS_XDR
-    hg_size_t header_offset = hg_header_get_size(op);
-#endif
-    hg_proc_t proc = HG_PROC_NULL;
-    hg_proc_cb_t proc_cb = NULL;
+    struct hg_private_class *hg_class = HG_HANDLE_CLASS(&hg_handle->handle);
+    void *src = hg_proc_get_extra_buf(proc) ? hg_proc_get_extra_buf(proc) : buf;
+    hg_uint64_t src_size = hg_proc_get_size_used(proc), dest_size;
+    hg_size_t dest_max_size = compressor->bound(compressor->arg, src_size);
+    struct hg_extra_buf *pooled = NULL;
+    void *dest = NULL;
     hg_return_t ret;
 
-    switch (op) {
+    /* Compressor cannot process that payload */
+    if (dest_max_size == 0)
+        return HG_SUCCESS;
+
+    /* Use a pooled scratch buffer if possible */
+    ret = hg_extra_buf_pool_get(hg_class, dest_max_size, &pooled);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not get pooled buffer");
+    if (pooled != NULL)
+        dest = pooled->buf;
+    else {
+        dest = hg_mem_aligned_alloc(
+            (size_t) hg_mem_get_page_size(), (size_t) dest_max_size);
+        HG_CHECK_SUBSYS_ERROR(rpc, dest == NULL, done, ret, HG_NOMEM,
+            "Could not allocate compression buffer");
+    }
+
+    dest_size = dest_max_size;
+    ret = compressor->compress(
+        compressor->arg, src, src_size, dest, &dest_size);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, done, ret, "Could not compress payload (%s)", compressor->name);
+
+    /* Send payload as is if it does not shrink */
+    if (dest_size + 2 * sizeof(hg_uint64_t) >= src_size)
+        goto done;
+
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Compressed payload from %" PRIu64 " to %" PRIu64 " bytes (%s)",
+        src_size, dest_size, compressor->name);
+
+    /* Replace payload with original size, compressed size and compressed
+     * data, an extra buffer is allocated if that still does not fit */
+    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_uint64_t(proc, &src_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not encode payload size");
+
+    ret = hg_proc_hg_uint64_t(proc, &dest_size);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, done, ret, "Could not encode compressed payload size");
+
+    ret = hg_proc_bytes(proc, dest, dest_size);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, done, ret, "Could not encode compressed payload");
+
+    ret = hg_proc_flush(proc);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Error in proc flush");
+
+    *compress_id = compressor->id;
+
+done:
+    if (pooled != NULL)
+        hg_extra_buf_pool_release(hg_class, pooled);
+    else
+        hg_mem_aligned_free(dest);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_decompress_payload(struct hg_private_handle *hg_handle,
+    const struct hg_compressor *compressor, hg_op_t op, hg_uint8_t compress_id,
+    hg_proc_t proc, void **buf_p, hg_size_t *buf_size_p)
+{
+    struct hg_private_class *hg_class = HG_HANDLE_CLASS(&hg_handle->handle);
+    void **extra_buf;
+    hg_size_t *extra_buf_size;
+    hg_bulk_t *extra_bulk;
+    struct hg_extra_buf **extra_pooled;
+    hg_bool_t *decompressed, *extra_charged;
+    hg_uint64_t size, src_size;
+    struct hg_extra_buf *pooled = NULL;
+    struct hg_mem_budget *mem_budget =
+        hg_core_class_get_mem_budget(hg_class->hg_class.core_class);
+    void *src, *dest = NULL;
+    hg_bool_t charged = HG_FALSE;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        compressor == NULL || compressor->id != compress_id, error, ret,
+        HG_PROTOCOL_ERROR,
+        "Payload was compressed with unknown compressor (ID %" PRIu8 ")",
+        compress_id);
+
+    switch (op) {
+        case HG_INPUT:
+            extra_buf = &hg_handle->in_extra_buf;
+            extra_buf_size = &hg_handle->in_extra_buf_size;
+            extra_bulk = &hg_handle->in_extra_bulk;
+            extra_pooled = &hg_handle->in_extra_pooled;
+            decompressed = &hg_handle->in_decompressed;
+            extra_charged = &hg_handle->in_extra_charged;
+            break;
+        case HG_OUTPUT:
+            extra_buf = &hg_handle->out_extra_buf;
+            extra_buf_size = &hg_handle->out_extra_buf_size;
+            extra_bulk = &hg_handle->out_extra_bulk;
+            extra_pooled = &hg_handle->out_extra_pooled;
+            decompressed = &hg_handle->out_decompressed;
+            extra_charged = &hg_handle->out_extra_charged;
+            break;
+        default:
+            HG_GOTO_SUBSYS_ERROR(
+                rpc, error, ret, HG_INVALID_ARG, "Invalid HG op");
+    }
+
+    ret = hg_proc_reset(proc, *buf_p, *buf_size_p, HG_DECODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+
+    ret = hg_proc_hg_uint64_t(proc, &size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not decode payload size");
+
+    ret = hg_proc_hg_uint64_t(proc, &src_size);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not decode compressed payload size");
+
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        size == 0 || src_size > hg_proc_get_size_left(proc), error, ret,
+        HG_PROTOCOL_ERROR,
+        "Invalid compressed payload (%" PRIu64 " bytes from %" PRIu64 ")",
+        size, src_size);
+    src = hg_proc_save_ptr(proc, src_size);
+
+    /* Decompress into a pooled buffer if possible */
+    ret = hg_extra_buf_pool_get(hg_class, size, &pooled);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get pooled buffer");
+    if (pooled != NULL)
+        dest = pooled->buf;
+    else {
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            !hg_mem_budget_acquire(mem_budget, (size_t) size), error, ret,
+            HG_NOMEM,
+            "Memory budget exhausted, could not allocate decompression buffer");
+        charged = HG_TRUE;
+        dest = hg_mem_aligned_alloc(
+            (size_t) hg_mem_get_page_size(), (size_t) size);
+        HG_CHECK_SUBSYS_ERROR(rpc, dest == NULL, error, ret, HG_NOMEM,
+            "Could not allocate decompression buffer");
+    }
+
+    ret = compressor->decompress(compressor->arg, src, src_size, dest, size);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not decompress payload (%s)", compressor->name);
+
+    /* The compressed payload is no longer needed, decompressed payload
+     * remains valid until the extra payload is freed like any other extra
+     * buffer */
+    HG_Bulk_free(*extra_bulk);
+    *extra_bulk = HG_BULK_NULL;
+    if (*extra_pooled != NULL)
+        hg_extra_buf_pool_release(hg_class, *extra_pooled);
+    else if (*extra_buf != NULL)
+        hg_mem_aligned_free(*extra_buf);
+    if (*extra_charged)
+        hg_mem_budget_release(mem_budget, (size_t) *extra_buf_size);
+    *extra_buf = dest;
+    *extra_buf_size = size;
+    *extra_pooled = pooled;
+    *extra_charged = charged;
+    *decompressed = HG_TRUE;
+
+    *buf_p = dest;
+    *buf_size_p = size;
+
+    return HG_SUCCESS;
+
+error:
+    if (pooled != NULL)
+        hg_extra_buf_pool_release(hg_class, pooled);
+    else if (dest != NULL)
+        hg_mem_aligned_free(dest);
+    if (charged)
+        hg_mem_budget_release(mem_budget, (size_t) size);
+
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_create_extra_bulk(struct hg_private_handle *hg_handle, hg_proc_t proc,
+    void **extra_buf, hg_size_t *extra_buf_size, hg_bulk_t *extra_bulk)
+{
+    hg_uint32_t ref_count = hg_proc_get_ref_count(proc);
+    void **buf_ptrs = NULL;
+    hg_size_t *buf_sizes = NULL;
+    hg_uint32_t count;
+    hg_return_t ret;
+
+    /* Create a bulk descriptor only of the size that is used */
+    *extra_buf = hg_proc_get_extra_buf(proc);
+    *extra_buf_size = hg_proc_get_size_used(proc);
+
+    /* Prevent buffer from being freed when proc_reset is called */
+    hg_proc_set_extra_buf_is_mine(proc, HG_TRUE);
+
+    if (ref_count == 0)
+        return HG_Bulk_create(hg_handle->handle.info.hg_class, 1, extra_buf,
+            extra_buf_size, HG_BULK_READ_ONLY, extra_bulk);
+
+    /* Referenced data is exposed directly from user memory, segments
+     * interleave the extra buffer with references so that the target
+     * retrieves the same stream that it would have if data was copied */
+    buf_ptrs = (void **) malloc((2 * ref_count + 1) * sizeof(*buf_ptrs));
+    HG_CHECK_SUBSYS_ERROR(rpc, buf_ptrs == NULL, done, ret, HG_NOMEM,
+        "Could not allocate array of segment pointers");
+    buf_sizes =
+        (hg_size_t *) malloc((2 * ref_count + 1) * sizeof(*buf_sizes));
+    HG_CHECK_SUBSYS_ERROR(rpc, buf_sizes == NULL, done, ret, HG_NOMEM,
+        "Could not allocate array of segment sizes");
+
+    ret = hg_proc_get_ref_segments(proc, buf_ptrs, buf_sizes, &count);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not get proc segments");
+
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Creating extra bulk handle of %" PRIu32 " segments (%" PRIu64
+        " bytes referenced)",
+        count, hg_proc_get_ref_size(proc));
+
+    ret = HG_Bulk_create(hg_handle->handle.info.hg_class, count, buf_ptrs,
+        buf_sizes, HG_BULK_READ_ONLY, extra_bulk);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not create bulk handle");
+
+    /* Stream size includes referenced data */
+    *extra_buf_size += hg_proc_get_ref_size(proc);
+
+done:
+    free(buf_ptrs);
+    free(buf_sizes);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_encode_extra_bulk(struct hg_private_handle *hg_handle, hg_proc_t proc,
+    void *buf, hg_size_t buf_size, hg_bulk_t extra_bulk)
+{
+    hg_uint8_t proc_flags = 0;
+    hg_return_t ret;
+
+    /* Reset proc */
+    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+
+#ifdef NA_HAS_SM
+    /* Determine if we need special handling for SM */
+    if (HG_Core_addr_get_na_sm(hg_handle->handle.core_handle->info.addr) !=
+        NULL)
+        proc_flags |= HG_PROC_SM;
+#endif
+
+    /* Attempt to use eager bulk transfers when appropriate */
+    if (HG_HANDLE_CLASS(&hg_handle->handle)->bulk_eager &&
+        !HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
+        proc_flags |= HG_PROC_BULK_EAGER;
+    if (HG_Core_addr_is_self(hg_handle->handle.core_handle->info.addr))
+        proc_flags |= HG_PROC_SELF;
+
+    hg_proc_set_flags(proc, proc_flags);
+
+    /* Encode extra_bulk_handle, we can do that safely here because
+     * the user payload has been copied so we don't have to worry
+     * about overwriting the user's data */
+    ret = hg_proc_hg_bulk_t(proc, &extra_bulk);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not process extra bulk handle");
+
+    ret = hg_proc_flush(proc);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Error in proc flush");
+
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_get_extra_buf(proc), error, ret,
+        HG_OVERFLOW, "Extra bulk handle could not fit into buffer");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_out_region_alloc(struct hg_private_handle *hg_handle, hg_size_t size)
+{
+    struct hg_mem_budget *mem_budget = hg_core_class_get_mem_budget(
+        hg_handle->handle.info.hg_class->core_class);
+    hg_return_t ret;
+
+    /* Region is kept across forwards */
+    if (hg_handle->out_region != HG_BULK_NULL &&
+        hg_handle->out_region_size >= size)
+        return HG_SUCCESS;
+    hg_out_region_free(hg_handle);
+
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        !hg_mem_budget_acquire(mem_budget, (size_t) size), error, ret,
+        HG_NOMEM,
+        "Memory budget exhausted, could not allocate output region of "
+        "size %" PRIu64,
+        size);
+    hg_handle->out_region_size = size;
+
+    hg_handle->out_region_buf =
+        hg_mem_aligned_alloc((size_t) hg_mem_get_page_size(), (size_t) size);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_handle->out_region_buf == NULL, error, ret,
+        HG_NOMEM, "Could not allocate output region");
+
+    ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1,
+        &hg_handle->out_region_buf, &hg_handle->out_region_size,
+        HG_BULK_WRITE_ONLY, &hg_handle->out_region);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not create bulk handle");
+
+    return HG_SUCCESS;
+
+error:
+    hg_out_region_free(hg_handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_out_region_free(struct hg_private_handle *hg_handle)
+{
+    if (hg_handle->out_region_size == 0)
+        return;
+
+    if (hg_handle->out_region != HG_BULK_NULL) {
+        HG_Bulk_free(hg_handle->out_region);
+        hg_handle->out_region = HG_BULK_NULL;
+    }
+    hg_mem_aligned_free(hg_handle->out_region_buf);
+    hg_handle->out_region_buf = NULL;
+    hg_mem_budget_release(hg_core_class_get_mem_budget(
+                              hg_handle->handle.info.hg_class->core_class),
+        (size_t) hg_handle->out_region_size);
+    hg_handle->out_region_size = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_out_region_push(struct hg_private_handle *hg_handle)
+{
+    const struct hg_core_info *hg_core_info =
+        HG_Core_get_info(hg_handle->handle.core_handle);
+    hg_return_t ret;
+
+    /* Handle must remain valid until the response is sent */
+    HG_Core_ref_incr(hg_handle->handle.core_handle);
+
+    ret = HG_Bulk_transfer_id(hg_handle->handle.info.context,
+        hg_out_region_push_cb, hg_handle, HG_BULK_PUSH,
+        (hg_addr_t) hg_core_info->addr, hg_core_info->context_id,
+        hg_handle->out_region_remote, 0, hg_handle->out_extra_bulk, 0,
+        hg_handle->out_extra_buf_size, HG_OP_ID_IGNORE);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not push output to output region");
+
+    return HG_SUCCESS;
+
+error:
+    HG_Core_destroy(hg_handle->handle.core_handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_out_region_push_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+    hg_core_handle_t core_handle = hg_handle->handle.core_handle;
+    hg_size_t payload_size = hg_handle->respond_size;
+    hg_uint8_t flags = 0;
+    hg_return_t ret = callback_info->ret;
+
+    /* Let the origin pull the output if it could not be pushed */
+    if (ret != HG_SUCCESS) {
+        struct hg_header *hg_header = &hg_handle->hg_header;
+        hg_size_t header_offset = hg_header_get_size(HG_OUTPUT) +
+                                  hg_handle->handle.info.hg_class->out_offset;
+        void *buf;
+        hg_size_t buf_size;
+
+        HG_LOG_SUBSYS_WARNING(rpc,
+            "Could not push output to output region (%s), falling back to "
+            "extra bulk handle",
+            HG_Error_to_string(ret));
+
+        ret = HG_Core_get_output(core_handle, &buf, &buf_size);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not get output buffer");
+
+        ret = hg_encode_extra_bulk(hg_handle, hg_handle->out_proc,
+            (char *) buf + header_offset, buf_size - header_offset,
+            hg_handle->out_extra_bulk);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not encode extra bulk handle");
+
+        hg_header->msg.output.flags &= (hg_uint8_t) ~HG_HEADER_REGION;
+        ret = hg_header_proc(HG_ENCODE, buf, buf_size, hg_header);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process header");
+
+        payload_size = hg_proc_get_size_used(hg_handle->out_proc) +
+                       header_offset;
+        flags |= HG_CORE_MORE_DATA;
+    }
+
+    ret = HG_Core_respond(
+        core_handle, hg_core_respond_cb, hg_handle, flags, payload_size);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not respond (%s)", HG_Error_to_string(ret));
+
+    HG_Core_destroy(core_handle);
+
+    return HG_SUCCESS;
+
+error:
+    /* Response could not be sent, report it to the user */
+    {
+        struct hg_core_cb_info hg_core_cb_info = {
+            .arg = hg_handle, .ret = ret, .type = HG_CB_RESPOND};
+
+        hg_core_respond_cb(&hg_core_cb_info);
+    }
+    HG_Core_destroy(core_handle);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_free_struct(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, hg_op_t op, void *struct_ptr)
+{
+    void *buf = NULL;
+    hg_size_t buf_size = 0;
+#ifdef HG_HAS_XDR
+    hg_size_t header_offset = hg_header_get_size(op);
+#endif
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_proc_cb_t proc_cb = NULL;
+    hg_return_t ret;
+
+    switch (op) {
         case HG_INPUT:
             /* Set input proc */
             proc = hg_handle->in_proc;
@@ -815,6 +2262,11 @@ hg_free_struct(struct hg_private_handle *hg_handle,
             HG_GOTO_SUBSYS_ERROR(
                 rpc, error, ret, HG_INVALID_ARG, "Invalid HG op");
     }
+
+    /* Structs passed by value do not own any memory */
+    if ((op == HG_INPUT) ? hg_handle->in_shared : hg_handle->out_shared)
+        goto done;
+
     HG_CHECK_SUBSYS_ERROR(rpc, proc_cb == NULL, error, ret, HG_FAULT,
         "No proc set, proc must be set in HG_Register()");
 
@@ -833,6 +2285,17 @@ hg_free_struct(struct hg_private_handle *hg_handle,
     HG_CHECK_SUBSYS_HG_ERROR(
         rpc, error, ret, "Could not free allocated parameters");
 
+    if (HG_HANDLE_CLASS(&hg_handle->handle)->release_input_on_free &&
+        !HG_HANDLE_CLASS(&hg_handle->handle)->release_input_early &&
+        op == HG_INPUT) {
+        /* Parameters were decoded in place and are no longer referenced,
+         * release the buffer so that it can be re-used */
+        ret = HG_Core_release_input(hg_handle->handle.core_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not release input buffer");
+    }
+
+done:
     /* Decrement ref count or free */
     ret = HG_Core_destroy(hg_handle->handle.core_handle);
     HG_CHECK_SUBSYS_HG_ERROR(
@@ -855,8 +2318,12 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
     void *buf, **extra_buf;
     hg_size_t buf_size, *extra_buf_size;
     hg_bulk_t *extra_bulk = NULL;
+    struct hg_extra_buf **extra_pooled;
+    hg_bool_t *extra_charged;
     hg_size_t header_offset = hg_header_get_size(op);
     hg_size_t page_size = (hg_size_t) hg_mem_get_page_size();
+    struct hg_mem_budget *mem_budget = hg_core_class_get_mem_budget(
+        hg_handle->handle.info.hg_class->core_class);
     hg_bulk_t local_handle = HG_BULK_NULL;
     hg_return_t ret = HG_SUCCESS;
 
@@ -875,6 +2342,8 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
             extra_buf = &hg_handle->in_extra_buf;
             extra_buf_size = &hg_handle->in_extra_buf_size;
             extra_bulk = &hg_handle->in_extra_bulk;
+            extra_pooled = &hg_handle->in_extra_pooled;
+            extra_charged = &hg_handle->in_extra_charged;
             break;
         case HG_OUTPUT:
             /* Use custom header offset */
@@ -890,6 +2359,8 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
             extra_buf = &hg_handle->out_extra_buf;
             extra_buf_size = &hg_handle->out_extra_buf_size;
             extra_bulk = &hg_handle->out_extra_bulk;
+            extra_pooled = &hg_handle->out_extra_pooled;
+            extra_charged = &hg_handle->out_extra_charged;
             break;
         default:
             HG_GOTO_SUBSYS_ERROR(
@@ -911,15 +2382,41 @@ hg_get_extra_payload(struct hg_private_handle *hg_handle, hg_op_t op,
     ret = hg_proc_flush(proc);
     HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Error in proc flush");
 
-    /* Create a new local handle to read the data */
+    /* Use a pooled buffer that is already registered if possible */
     *extra_buf_size = HG_Bulk_get_size(*extra_bulk);
-    *extra_buf = hg_mem_aligned_alloc(page_size, *extra_buf_size);
-    HG_CHECK_SUBSYS_ERROR(rpc, *extra_buf == NULL, done, ret, HG_NOMEM,
-        "Could not allocate extra payload buffer");
+    if (op == HG_INPUT)
+        hg_core_capture_extra(hg_handle->handle.core_handle, *extra_buf_size);
+    ret = hg_extra_buf_pool_get(
+        HG_HANDLE_CLASS(&hg_handle->handle), *extra_buf_size, extra_pooled);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not get pooled buffer");
+
+    if (*extra_pooled != NULL) {
+        *extra_buf = (*extra_pooled)->buf;
+        local_handle = (*extra_pooled)->bulk;
+        HG_Bulk_ref_incr(local_handle);
+    } else {
+        /* Fail fast once the memory budget is exhausted */
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            !hg_mem_budget_acquire(mem_budget, (size_t) *extra_buf_size), done,
+            ret, HG_NOMEM,
+            "Memory budget exhausted, could not allocate extra payload "
+            "buffer of size %" PRIu64,
+            *extra_buf_size);
+
+        /* Create a new local handle to read the data */
+        *extra_buf = hg_mem_aligned_alloc(page_size, *extra_buf_size);
+        if (*extra_buf == NULL) {
+            hg_mem_budget_release(mem_budget, (size_t) *extra_buf_size);
+            HG_GOTO_SUBSYS_ERROR(rpc, done, ret, HG_NOMEM,
+                "Could not allocate extra payload buffer");
+        }
+        *extra_charged = HG_TRUE;
 
-    ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1, extra_buf,
-        extra_buf_size, HG_BULK_READWRITE, &local_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not create HG bulk handle");
+        ret = HG_Bulk_create(hg_handle->handle.info.hg_class, 1, extra_buf,
+            extra_buf_size, HG_BULK_READWRITE, &local_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, done, ret, "Could not create HG bulk handle");
+    }
 
     /* Read bulk data here and wait for the data to be here  */
     hg_handle->extra_bulk_transfer_cb = done_cb;
@@ -960,47 +2457,208 @@ hg_free_extra_payload(struct hg_private_handle *hg_handle)
     if (hg_handle->in_extra_buf) {
         HG_Bulk_free(hg_handle->in_extra_bulk);
         hg_handle->in_extra_bulk = HG_BULK_NULL;
-        hg_mem_aligned_free(hg_handle->in_extra_buf);
+        if (hg_handle->in_extra_pooled) {
+            hg_extra_buf_pool_release(HG_HANDLE_CLASS(&hg_handle->handle),
+                hg_handle->in_extra_pooled);
+            hg_handle->in_extra_pooled = NULL;
+        } else
+            hg_mem_aligned_free(hg_handle->in_extra_buf);
+        if (hg_handle->in_extra_charged)
+            hg_mem_budget_release(
+                hg_core_class_get_mem_budget(
+                    hg_handle->handle.info.hg_class->core_class),
+                (size_t) hg_handle->in_extra_buf_size);
+        hg_handle->in_extra_charged = HG_FALSE;
         hg_handle->in_extra_buf = NULL;
         hg_handle->in_extra_buf_size = 0;
+        hg_handle->in_decompressed = HG_FALSE;
     }
 
+    hg_free_extra_output(hg_handle);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_free_extra_output(struct hg_private_handle *hg_handle)
+{
     if (hg_handle->out_extra_buf) {
         HG_Bulk_free(hg_handle->out_extra_bulk);
         hg_handle->out_extra_bulk = HG_BULK_NULL;
-        hg_mem_aligned_free(hg_handle->out_extra_buf);
+        if (hg_handle->out_extra_pooled) {
+            hg_extra_buf_pool_release(HG_HANDLE_CLASS(&hg_handle->handle),
+                hg_handle->out_extra_pooled);
+            hg_handle->out_extra_pooled = NULL;
+        } else
+            hg_mem_aligned_free(hg_handle->out_extra_buf);
+        if (hg_handle->out_extra_charged)
+            hg_mem_budget_release(
+                hg_core_class_get_mem_budget(
+                    hg_handle->handle.info.hg_class->core_class),
+                (size_t) hg_handle->out_extra_buf_size);
+        hg_handle->out_extra_charged = HG_FALSE;
         hg_handle->out_extra_buf = NULL;
         hg_handle->out_extra_buf_size = 0;
+        hg_handle->out_decompressed = HG_FALSE;
     }
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_forward_cb(const struct hg_core_cb_info *callback_info)
+static hg_return_t
+hg_extra_buf_pool_get(struct hg_private_class *hg_class, hg_size_t size,
+    struct hg_extra_buf **extra_buf_p)
 {
-    struct hg_private_handle *hg_handle =
-        (struct hg_private_handle *) callback_info->arg;
+    struct hg_extra_buf_pool *pool = &hg_class->extra_buf_pool;
+    hg_size_t page_size = (hg_size_t) hg_mem_get_page_size();
+    struct hg_extra_buf *extra_buf = NULL;
+    struct hg_mem_budget *mem_budget =
+        hg_core_class_get_mem_budget(hg_class->hg_class.core_class);
+    unsigned int size_class = 0;
+    hg_bool_t charged = HG_FALSE;
+    hg_return_t ret;
 
-    /* Execute callback */
-    if (hg_handle->forward_cb) {
-        struct hg_cb_info hg_cb_info = {.arg = hg_handle->forward_arg,
-            .ret = callback_info->ret,
-            .type = callback_info->type,
-            .info.forward.handle = (hg_handle_t) hg_handle};
-        hg_handle->forward_cb(&hg_cb_info);
+    *extra_buf_p = NULL;
+    if (pool->max_size == 0)
+        return HG_SUCCESS;
+
+    /* Payloads that are larger than the largest size class are not pooled */
+    while ((page_size << size_class) < size)
+        if (++size_class == HG_EXTRA_BUF_POOL_CLASSES)
+            return HG_SUCCESS;
+
+    hg_thread_spin_lock(&pool->lock);
+    extra_buf = pool->free_lists[size_class];
+    if (extra_buf != NULL) {
+        pool->free_lists[size_class] = extra_buf->next;
+        pool->size -= extra_buf->size;
+    }
+    hg_thread_spin_unlock(&pool->lock);
+
+    if (extra_buf == NULL) {
+        /* Fail fast once the memory budget is exhausted */
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            !hg_mem_budget_acquire(
+                mem_budget, (size_t) (page_size << size_class)),
+            error, ret, HG_NOMEM,
+            "Memory budget exhausted, could not allocate extra buffer of size "
+            "%" PRIu64,
+            page_size << size_class);
+        charged = HG_TRUE;
+
+        extra_buf = (struct hg_extra_buf *) calloc(1, sizeof(*extra_buf));
+        HG_CHECK_SUBSYS_ERROR(rpc, extra_buf == NULL, error, ret, HG_NOMEM,
+            "Could not allocate pooled extra buffer");
+        extra_buf->size = page_size << size_class;
+        extra_buf->size_class = size_class;
+
+        extra_buf->buf = hg_mem_aligned_alloc(page_size, extra_buf->size);
+        HG_CHECK_SUBSYS_ERROR(rpc, extra_buf->buf == NULL, error, ret,
+            HG_NOMEM, "Could not allocate extra buffer of size %" PRIu64,
+            extra_buf->size);
+
+        ret = HG_Bulk_create((hg_class_t *) hg_class, 1, &extra_buf->buf,
+            &extra_buf->size, HG_BULK_READWRITE, &extra_buf->bulk);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not create HG bulk handle");
     }
 
+    *extra_buf_p = extra_buf;
+
     return HG_SUCCESS;
+
+error:
+    if (extra_buf != NULL) {
+        hg_mem_aligned_free(extra_buf->buf);
+        free(extra_buf);
+    }
+    if (charged)
+        hg_mem_budget_release(mem_budget, (size_t) (page_size << size_class));
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_respond_cb(const struct hg_core_cb_info *callback_info)
+static void
+hg_extra_buf_pool_release(
+    struct hg_private_class *hg_class, struct hg_extra_buf *extra_buf)
 {
-    struct hg_private_handle *hg_handle =
-        (struct hg_private_handle *) callback_info->arg;
+    struct hg_extra_buf_pool *pool = &hg_class->extra_buf_pool;
+    hg_bool_t pooled = HG_FALSE;
+
+    hg_thread_spin_lock(&pool->lock);
+    if (pool->size + extra_buf->size <= pool->max_size) {
+        extra_buf->next = pool->free_lists[extra_buf->size_class];
+        pool->free_lists[extra_buf->size_class] = extra_buf;
+        pool->size += extra_buf->size;
+        pooled = HG_TRUE;
+    }
+    hg_thread_spin_unlock(&pool->lock);
 
-    /* Execute callback */
+    if (!pooled)
+        hg_extra_buf_free(hg_class, extra_buf);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_extra_buf_free(
+    struct hg_private_class *hg_class, struct hg_extra_buf *extra_buf)
+{
+    HG_Bulk_free(extra_buf->bulk);
+    hg_mem_aligned_free(extra_buf->buf);
+    hg_mem_budget_release(
+        hg_core_class_get_mem_budget(hg_class->hg_class.core_class),
+        (size_t) extra_buf->size);
+    free(extra_buf);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_extra_buf_pool_drain(struct hg_private_class *hg_class)
+{
+    struct hg_extra_buf_pool *pool = &hg_class->extra_buf_pool;
+    unsigned int i;
+
+    hg_thread_spin_lock(&pool->lock);
+    for (i = 0; i < HG_EXTRA_BUF_POOL_CLASSES; i++) {
+        struct hg_extra_buf *extra_buf = pool->free_lists[i];
+
+        while (extra_buf != NULL) {
+            struct hg_extra_buf *next = extra_buf->next;
+
+            hg_extra_buf_free(hg_class, extra_buf);
+            extra_buf = next;
+        }
+        pool->free_lists[i] = NULL;
+    }
+    pool->size = 0;
+    hg_thread_spin_unlock(&pool->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_forward_cb(const struct hg_core_cb_info *callback_info)
+{
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+
+    /* Execute callback */
+    if (hg_handle->forward_cb) {
+        struct hg_cb_info hg_cb_info = {.arg = hg_handle->forward_arg,
+            .ret = callback_info->ret,
+            .type = callback_info->type,
+            .info.forward.handle = (hg_handle_t) hg_handle};
+        hg_handle->forward_cb(&hg_cb_info);
+    }
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_respond_cb(const struct hg_core_cb_info *callback_info)
+{
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+
+    /* Execute callback */
     if (hg_handle->respond_cb) {
         struct hg_cb_info hg_cb_info = {.arg = hg_handle->respond_arg,
             .ret = callback_info->ret,
@@ -1013,119 +2671,281 @@ hg_core_respond_cb(const struct hg_core_cb_info *callback_info)
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Version_get(
-    unsigned int *major_p, unsigned int *minor_p, unsigned int *patch_p)
+static hg_return_t
+hg_core_stream_cb(const struct hg_core_cb_info *callback_info)
 {
-    if (major_p)
-        *major_p = HG_VERSION_MAJOR;
-    if (minor_p)
-        *minor_p = HG_VERSION_MINOR;
-    if (patch_p)
-        *patch_p = HG_VERSION_PATCH;
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+
+    /* Output of partial response can only be decoded from the callback */
+    if (hg_handle->stream_cb) {
+        struct hg_cb_info hg_cb_info = {.arg = hg_handle->stream_arg,
+            .ret = callback_info->ret,
+            .type = callback_info->type,
+            .info.forward.handle = (hg_handle_t) hg_handle};
+        hg_handle->stream_cb(&hg_cb_info);
+    }
 
     return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
-const char *
-HG_Error_to_string(hg_return_t errnum)
+static hg_return_t
+hg_core_partial_cb(const struct hg_core_cb_info *callback_info)
 {
-    return hg_return_name[errnum];
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) callback_info->arg;
+
+    if (hg_handle->partial_cb) {
+        struct hg_cb_info hg_cb_info = {.arg = hg_handle->partial_arg,
+            .ret = callback_info->ret,
+            .type = callback_info->type,
+            .info.respond.handle = (hg_handle_t) hg_handle};
+        hg_handle->partial_cb(&hg_cb_info);
+    }
+
+    return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_class_t *
-HG_Init(const char *na_info_string, hg_bool_t na_listen)
+static hg_return_t
+hg_multi_create(struct hg_context *context,
+    const struct hg_proc_info *hg_proc_info, hg_id_t id, unsigned int count,
+    unsigned int arity, struct hg_multi **multi_p)
 {
-    return HG_Init_opt2(na_info_string, na_listen, 0, NULL);
+    struct hg_multi *multi = NULL;
+    unsigned int i;
+    hg_return_t ret;
+
+    multi = (struct hg_multi *) calloc(1, sizeof(*multi));
+    HG_CHECK_SUBSYS_ERROR(rpc, multi == NULL, error, ret, HG_NOMEM,
+        "Could not allocate fan-out operation");
+
+    multi->targets =
+        (struct hg_multi_target *) calloc(count, sizeof(*multi->targets));
+    HG_CHECK_SUBSYS_ERROR(rpc, multi->targets == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %u targets", count);
+    for (i = 0; i < count; i++) {
+        multi->targets[i].multi = multi;
+        multi->targets[i].subtree_count = 1;
+    }
+
+    /* Relayed payloads are encoded with the same options as the RPC */
+    multi->tree_proc_info = *hg_proc_info;
+#ifndef HG_HAS_XDR
+    multi->tree_proc_info.in_proc_cb = hg_multi_tree_in_proc;
+    multi->tree_proc_info.out_proc_cb = hg_multi_tree_out_proc;
+#endif
+    multi->tree_proc_info.data = NULL;
+    multi->tree_proc_info.free_callback = NULL;
+    multi->tree_proc_info.tree = HG_TRUE;
+
+    multi->hg_proc_info = hg_proc_info;
+    multi->context = context;
+    multi->id = id;
+    multi->count = count;
+    multi->arity = arity;
+    hg_atomic_init32(&multi->pending, 0);
+
+#ifndef HG_HAS_XDR
+    /* Outputs are decoded and re-encoded when reduced, or kept encoded when
+     * relayed through a tree */
+    if (arity > 0 ||
+        (hg_proc_info->reduce_cb != NULL && !hg_proc_info->no_response)) {
+        ret = hg_proc_create(context->hg_class, HG_NOHASH, &multi->proc);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not create proc (%s)",
+            HG_Error_to_string(ret));
+    }
+#endif
+
+    *multi_p = multi;
+
+    return HG_SUCCESS;
+
+error:
+    hg_multi_free(multi);
+
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_class_t *
-HG_Init_opt(const char *na_info_string, hg_bool_t na_listen,
-    const struct hg_init_info *hg_init_info)
+static void
+hg_multi_free(struct hg_multi *multi)
 {
-    /* v2.2 is latest version for which init struct was not versioned */
-    return HG_Init_opt2(
-        na_info_string, na_listen, HG_VERSION(2, 2), hg_init_info);
+    unsigned int i;
+
+    if (multi == NULL)
+        return;
+
+    if (multi->targets != NULL) {
+        for (i = 0; i < multi->count; i++) {
+            (void) HG_Destroy(multi->targets[i].handle);
+            free(multi->targets[i].out_buf);
+        }
+        free(multi->targets);
+    }
+    free(multi->addrs);
+    free(multi->addr_offsets);
+    /* Input of tree nodes is owned by their handle */
+    if (multi->node_handle == NULL)
+        free(multi->in_buf);
+    free(multi->reduced_buf);
+    if (multi->proc != HG_PROC_NULL)
+        hg_proc_free(multi->proc);
+    free(multi);
 }
 
 /*---------------------------------------------------------------------------*/
-hg_class_t *
-HG_Init_opt2(const char *na_info_string, hg_bool_t na_listen,
-    unsigned int version, const struct hg_init_info *hg_init_info_p)
+static hg_return_t
+hg_multi_complete(struct hg_multi *multi)
 {
-    struct hg_private_class *hg_class = NULL;
-    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
-
-    /* Make sure error return codes match */
-    assert(HG_CANCELED == (hg_return_t) NA_CANCELED);
+    struct hg_cb_info hg_cb_info = {.arg = multi->arg,
+        .ret = HG_SUCCESS,
+        .type = HG_CB_FORWARD_MULTI,
+        .info.forward_multi.multi = (hg_multi_t) multi};
+    unsigned int i;
 
-    hg_class = calloc(1, sizeof(*hg_class));
-    HG_CHECK_SUBSYS_ERROR_NORET(
-        cls, hg_class == NULL, error, "Could not allocate HG class");
+    if (hg_atomic_decr32(&multi->pending) > 0)
+        return HG_SUCCESS;
 
-    if (hg_init_info_p != NULL) {
-        HG_CHECK_SUBSYS_ERROR_NORET(
-            cls, version == 0, error, "API version cannot be 0");
-        HG_LOG_SUBSYS_DEBUG(cls, "Init info version used: v%d.%d",
-            HG_MAJOR(version), HG_MINOR(version));
+#ifndef HG_HAS_XDR
+    if (multi->node_handle != NULL)
+        return hg_multi_node_complete(multi);
+#endif
 
-        /* Get init info and overwrite defaults */
-        if (HG_VERSION_GE(version, HG_VERSION(2, 3)))
-            hg_init_info = *hg_init_info_p;
-        else
-            hg_init_info_dup_2_2(&hg_init_info,
-                (const struct hg_init_info_2_2 *) hg_init_info_p);
+    /* Report first error */
+    for (i = 0; i < multi->count; i++) {
+        if (multi->targets[i].ret != HG_SUCCESS) {
+            hg_cb_info.ret = multi->targets[i].ret;
+            break;
+        }
     }
 
-    /* Save bulk eager information */
-    hg_class->bulk_eager = !hg_init_info.no_bulk_eager;
+#ifndef HG_HAS_XDR
+    if (multi->hg_proc_info->reduce_cb != NULL &&
+        !multi->hg_proc_info->no_response) {
+        hg_return_t ret = hg_multi_reduce(multi);
 
-    /* Save checksum level information */
-#ifdef HG_HAS_CHECKSUMS
-    hg_class->checksum_level = hg_init_info.checksum_level;
-#else
-    HG_CHECK_SUBSYS_WARNING(cls,
-        hg_init_info.checksum_level != HG_CHECKSUM_NONE,
-        "Option checksum_level requires CMake option MERCURY_USE_CHECKSUMS "
-        "to be turned ON.");
+        if (ret != HG_SUCCESS && hg_cb_info.ret == HG_SUCCESS)
+            hg_cb_info.ret = ret;
+    }
 #endif
 
-    /* Release input early */
-    hg_class->release_input_early = hg_init_info.release_input_early;
+    if (multi->callback)
+        multi->callback(&hg_cb_info);
 
-    hg_class->hg_class.core_class =
-        HG_Core_init_opt2(na_info_string, na_listen, version, hg_init_info_p);
-    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_class->hg_class.core_class == NULL,
-        error, "Could not create HG core class");
+    return HG_SUCCESS;
+}
 
-    /* Set more data callback */
-    HG_Core_set_more_data_callback(
-        hg_class->hg_class.core_class, hg_more_data_cb, hg_more_data_free_cb);
+/*---------------------------------------------------------------------------*/
+static void
+hg_multi_forward_direct(struct hg_multi *multi, const hg_addr_t *addrs,
+    void *in_struct, unsigned int *posted_p)
+{
+    /* First handle of each encoding, indexed by SM / self address */
+    struct {
+        struct hg_private_handle *handle; /* Handle of encoded input */
+        hg_size_t payload_size;           /* Size of encoded input */
+        hg_uint8_t flags;                 /* Core forward flags */
+    } refs[4] = {{NULL, 0, 0}};
+    unsigned int i;
+
+    /* Held until all targets have been forwarded to */
+    hg_atomic_init32(&multi->pending, (int32_t) multi->count + 1);
+
+    for (i = 0; i < multi->count; i++) {
+        struct hg_multi_target *target = &multi->targets[i];
+        struct hg_private_handle *hg_handle;
+        hg_core_addr_t core_addr = (hg_core_addr_t) addrs[i];
+        unsigned int key = HG_Core_addr_is_self(core_addr) ? 1 : 0;
+        hg_return_t ret;
 
-    return (hg_class_t *) hg_class;
+#ifdef NA_HAS_SM
+        if (HG_Core_addr_get_na_sm(core_addr) != NULL)
+            key |= 2;
+#endif
 
-error:
-    free(hg_class);
+        ret = HG_Create(multi->context, addrs[i], multi->id, &target->handle);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+            "Could not create handle for target %u (%s)", i,
+            HG_Error_to_string(ret));
+        hg_handle = (struct hg_private_handle *) target->handle;
+        hg_handle->forward_cb = hg_multi_forward_cb;
+        hg_handle->forward_arg = target;
 
-    return NULL;
+        if (refs[key].handle != NULL) {
+            ret = hg_multi_forward_copy(hg_handle, refs[key].handle,
+                refs[key].payload_size, refs[key].flags);
+            HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+                "Could not forward copy of input to target %u (%s)", i,
+                HG_Error_to_string(ret));
+        } else {
+            hg_size_t payload_size = 0;
+            hg_bool_t more_data = HG_FALSE;
+            hg_uint8_t flags = 0;
+
+            ret = hg_set_struct(hg_handle, multi->hg_proc_info, HG_INPUT,
+                in_struct, &payload_size, &more_data);
+            HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+                "Could not set input (%s)", HG_Error_to_string(ret));
+
+            if (more_data)
+                flags |= HG_CORE_MORE_DATA;
+            if (multi->hg_proc_info->no_response)
+                flags |= HG_CORE_NO_RESPONSE;
+
+            /* Other targets pull the extra payload from that handle, which
+             * is only known to be done once they have responded */
+            if (!(more_data && multi->hg_proc_info->no_response)) {
+                refs[key].handle = hg_handle;
+                refs[key].payload_size = payload_size;
+                refs[key].flags = flags;
+            }
+
+            ret = HG_Core_forward(hg_handle->handle.core_handle,
+                hg_core_forward_cb, hg_handle, flags, payload_size);
+            HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+                "Could not forward call to target %u (%s)", i,
+                HG_Error_to_string(ret));
+        }
+
+        (*posted_p)++;
+        continue;
+
+error:
+        /* Pending count cannot drop to zero before it is released */
+        target->ret = ret;
+        (void) hg_atomic_decr32(&multi->pending);
+    }
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Finalize(hg_class_t *hg_class)
+static hg_return_t
+hg_multi_forward_copy(struct hg_private_handle *hg_handle,
+    struct hg_private_handle *src_handle, hg_size_t payload_size,
+    hg_uint8_t flags)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
+    void *buf, *src_buf;
+    hg_size_t buf_size, src_buf_size;
     hg_return_t ret;
 
-    ret = HG_Core_finalize(private_class->hg_class.core_class);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        cls, error, ret, "Could not finalize HG core class");
+    ret = HG_Core_get_input(src_handle->handle.core_handle, &src_buf,
+        &src_buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get input buffer");
 
-    free(private_class);
+    ret = HG_Core_get_input(hg_handle->handle.core_handle, &buf, &buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get input buffer");
+    HG_CHECK_SUBSYS_ERROR(rpc, payload_size > buf_size, error, ret,
+        HG_OVERFLOW, "Encoded input (%" PRIu64 ") exceeds buffer (%" PRIu64 ")",
+        payload_size, buf_size);
+
+    /* Header and payload are copied as is */
+    memcpy(buf, src_buf, (size_t) payload_size);
+
+    ret = HG_Core_forward(hg_handle->handle.core_handle, hg_core_forward_cb,
+        hg_handle, flags, payload_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward call (%s)",
+        HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1134,67 +2954,2223 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Cleanup(void)
+static hg_return_t
+hg_multi_forward_cb(const struct hg_cb_info *callback_info)
 {
-    HG_Core_cleanup();
+    struct hg_multi_target *target =
+        (struct hg_multi_target *) callback_info->arg;
+
+    target->ret = callback_info->ret;
+
+    return hg_multi_complete(target->multi);
 }
 
+#ifndef HG_HAS_XDR
 /*---------------------------------------------------------------------------*/
-void
-HG_Set_log_level(const char *level)
+static hg_return_t
+hg_multi_tree_in_proc(hg_proc_t proc, void *data)
 {
-    hg_log_set_subsys_level(HG_SUBSYS_NAME_STRING, hg_log_name_to_level(level));
+    struct hg_multi_tree_in *tree_in = (struct hg_multi_tree_in *) data;
+    hg_return_t ret;
+
+    ret = hg_proc_hg_uint32_t(proc, &tree_in->arity);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc tree arity");
+
+    ret = hg_proc_hg_uint32_t(proc, &tree_in->addr_count);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc address count");
+
+    ret = hg_proc_hg_uint64_t(proc, &tree_in->addrs_size);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not proc size of addresses");
+
+    ret = hg_proc_hg_uint64_t(proc, &tree_in->in_buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc input size");
+
+    /* Decoded buffers are owned by the tree node */
+    if (hg_proc_get_op(proc) == HG_FREE)
+        return HG_SUCCESS;
+    if (hg_proc_get_op(proc) == HG_DECODE) {
+        tree_in->addrs = malloc((size_t) MAX(tree_in->addrs_size, 1));
+        HG_CHECK_SUBSYS_ERROR(rpc, tree_in->addrs == NULL, error, ret,
+            HG_NOMEM, "Could not allocate addresses");
+        tree_in->in_buf = malloc((size_t) MAX(tree_in->in_buf_size, 1));
+        HG_CHECK_SUBSYS_ERROR(rpc, tree_in->in_buf == NULL, error, ret,
+            HG_NOMEM, "Could not allocate input buffer");
+    }
+
+    ret = hg_proc_bytes(proc, tree_in->addrs, tree_in->addrs_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc addresses");
+
+    ret = hg_proc_bytes(proc, tree_in->in_buf, tree_in->in_buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc input");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Set_log_subsys(const char *subsys)
+static hg_return_t
+hg_multi_tree_out_proc(hg_proc_t proc, void *data)
 {
-    hg_log_set_subsys(subsys);
+    struct hg_multi_tree_out *tree_out = (struct hg_multi_tree_out *) data;
+    hg_uint32_t count = tree_out->count, i;
+    hg_uint8_t reduced = (hg_uint8_t) tree_out->reduced;
+    hg_return_t ret;
+
+    if (hg_proc_get_op(proc) == HG_FREE)
+        return HG_SUCCESS;
+
+    ret = hg_proc_hg_uint32_t(proc, &count);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc target count");
+    HG_CHECK_SUBSYS_ERROR(rpc, count != tree_out->count, error, ret,
+        HG_PROTOCOL_ERROR,
+        "Number of relayed outputs (%" PRIu32
+        ") does not match subtree (%" PRIu32 ")",
+        count, tree_out->count);
+
+    /* Subtree may have reduced its outputs into a single one */
+    ret = hg_proc_hg_uint8_t(proc, &reduced);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc reduced flag");
+    tree_out->reduced = (hg_bool_t) reduced;
+
+    for (i = 0; i < count; i++) {
+        struct hg_multi_target *target = &tree_out->targets[i];
+        hg_int32_t target_ret = (hg_int32_t) target->ret;
+        hg_uint64_t out_buf_size = target->out_buf_size;
+
+        ret = hg_proc_int32_t(proc, &target_ret);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc result");
+
+        if (hg_proc_get_op(proc) == HG_DECODE) {
+            HG_CHECK_SUBSYS_ERROR(rpc,
+                target_ret < 0 || target_ret >= (hg_int32_t) HG_RETURN_MAX,
+                error, ret, HG_PROTOCOL_ERROR, "Invalid result (%" PRId32 ")",
+                target_ret);
+            target->ret = (hg_return_t) target_ret;
+        }
+        if (reduced)
+            continue;
+
+        ret = hg_proc_hg_uint64_t(proc, &out_buf_size);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc output size");
+
+        if (hg_proc_get_op(proc) == HG_DECODE) {
+            if (target->ret != HG_SUCCESS)
+                continue;
+
+            target->out_buf = malloc((size_t) MAX(out_buf_size, 1));
+            HG_CHECK_SUBSYS_ERROR(rpc, target->out_buf == NULL, error, ret,
+                HG_NOMEM, "Could not allocate output buffer");
+            target->out_buf_size = out_buf_size;
+        } else if (target->ret != HG_SUCCESS)
+            continue;
+
+        ret = hg_proc_bytes(proc, target->out_buf, out_buf_size);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not proc output");
+    }
+
+    if (reduced) {
+        hg_uint64_t reduced_buf_size = tree_out->reduced_buf_size;
+
+        ret = hg_proc_hg_uint64_t(proc, &reduced_buf_size);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not proc reduced output size");
+        if (reduced_buf_size == 0)
+            return HG_SUCCESS;
+
+        /* Reduced output of subtree is kept by its root */
+        if (hg_proc_get_op(proc) == HG_DECODE) {
+            tree_out->targets[0].out_buf = malloc((size_t) reduced_buf_size);
+            HG_CHECK_SUBSYS_ERROR(rpc, tree_out->targets[0].out_buf == NULL,
+                error, ret, HG_NOMEM, "Could not allocate output buffer");
+            tree_out->targets[0].out_buf_size = reduced_buf_size;
+            tree_out->reduced_buf = tree_out->targets[0].out_buf;
+        }
+
+        ret = hg_proc_bytes(proc, tree_out->reduced_buf, reduced_buf_size);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not proc reduced output");
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Set_log_func(int (*log_func)(FILE *stream, const char *format, ...))
+static hg_return_t
+hg_multi_encode(hg_proc_t proc, void *buf, hg_size_t buf_size,
+    hg_proc_cb_t proc_cb, hg_bool_t varint, void *struct_ptr,
+    void **encoded_buf_p, hg_size_t *encoded_buf_size_p)
 {
-    hg_log_set_func(log_func);
+    void *encoded_buf = NULL;
+    hg_size_t encoded_buf_size = 0;
+    hg_return_t ret;
+
+    if (proc_cb == NULL || struct_ptr == NULL)
+        goto done;
+
+    /* Encode directly into an exactly sized buffer */
+    if (buf == NULL) {
+        ret = hg_proc_reset(proc, NULL, 0, HG_SIZE);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+        if (varint)
+            hg_proc_set_flags(proc, HG_PROC_VARINT);
+
+        ret = proc_cb(proc, struct_ptr);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not compute size of parameters");
+
+        buf_size = MAX(hg_proc_get_size_used(proc), 1);
+        encoded_buf = malloc((size_t) buf_size);
+        HG_CHECK_SUBSYS_ERROR(rpc, encoded_buf == NULL, error, ret, HG_NOMEM,
+            "Could not allocate encoding buffer");
+        buf = encoded_buf;
+    }
+
+    ret = hg_proc_reset(proc, buf, buf_size, HG_ENCODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+    if (varint)
+        hg_proc_set_flags(proc, HG_PROC_VARINT);
+
+    ret = proc_cb(proc, struct_ptr);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode parameters");
+
+    ret = hg_proc_flush(proc);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Error in proc flush");
+
+    encoded_buf_size = hg_proc_get_size_used(proc);
+
+    /* Copy out of scratch buffer (or extra buffer if it overflowed) */
+    if (encoded_buf == NULL) {
+        const void *src = hg_proc_get_extra_buf(proc)
+                              ? hg_proc_get_extra_buf(proc)
+                              : buf;
+
+        encoded_buf = malloc((size_t) MAX(encoded_buf_size, 1));
+        HG_CHECK_SUBSYS_ERROR(rpc, encoded_buf == NULL, error, ret, HG_NOMEM,
+            "Could not allocate encoded buffer");
+        memcpy(encoded_buf, src, (size_t) encoded_buf_size);
+    }
+
+done:
+    *encoded_buf_p = encoded_buf;
+    *encoded_buf_size_p = encoded_buf_size;
+
+    return HG_SUCCESS;
+
+error:
+    if (encoded_buf != buf)
+        free(encoded_buf);
+    else
+        free(buf);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_decode_output(
+    struct hg_multi *multi, void *buf, hg_size_t buf_size, void *out_struct)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_reset(multi->proc, buf, buf_size, HG_DECODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+    if (multi->hg_proc_info->varint)
+        hg_proc_set_flags(multi->proc, HG_PROC_VARINT);
+
+    ret = multi->hg_proc_info->out_proc_cb(multi->proc, out_struct);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not decode output");
+
+    ret = hg_proc_flush(multi->proc);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Error in proc flush");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_free_output(struct hg_multi *multi, void *out_struct)
+{
+    hg_return_t ret;
+
+    ret = hg_proc_reset(multi->proc, NULL, 0, HG_FREE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not reset proc");
+
+    ret = multi->hg_proc_info->out_proc_cb(multi->proc, out_struct);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not free output");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_reduce(struct hg_multi *multi)
+{
+    const struct hg_proc_info *hg_proc_info = multi->hg_proc_info;
+    size_t out_struct_size = (size_t) hg_proc_info->out_struct_size;
+    char *acc_struct = NULL, *out_struct;
+    hg_handle_t acc_handle = HG_HANDLE_NULL;
+    hg_bool_t acc_set = HG_FALSE;
+    unsigned int i;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Accumulator and scratch output are allocated together */
+    acc_struct = (char *) calloc(2, MAX(out_struct_size, 1));
+    HG_CHECK_SUBSYS_ERROR(rpc, acc_struct == NULL, done, ret, HG_NOMEM,
+        "Could not allocate output structures");
+    out_struct = acc_struct + MAX(out_struct_size, 1);
+
+    /* Outputs of subtrees were already reduced by their root */
+    for (i = 0; i < multi->count; i++) {
+        struct hg_multi_target *target = &multi->targets[i];
+        void *struct_ptr = acc_set ? out_struct : acc_struct;
+
+        if (target->ret != HG_SUCCESS)
+            continue;
+        if (multi->arity == 0)
+            ret = HG_Get_output(target->handle, struct_ptr);
+        else if (target->out_buf != NULL)
+            ret = hg_multi_decode_output(
+                multi, target->out_buf, target->out_buf_size, struct_ptr);
+        else
+            continue;
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, free, ret,
+            "Could not get output of target %u (%s)", i,
+            HG_Error_to_string(ret));
+
+        if (!acc_set) {
+            acc_handle = target->handle;
+            acc_set = HG_TRUE;
+            continue;
+        }
+
+        ret = hg_proc_info->reduce_cb(acc_struct, out_struct);
+        /* Outputs of direct targets hold a reference to their handle */
+        if (multi->arity == 0)
+            (void) HG_Free_output(target->handle, out_struct);
+        else
+            (void) hg_multi_free_output(multi, out_struct);
+        memset(out_struct, 0, out_struct_size);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, free, ret,
+            "Could not reduce output of target %u (%s)", i,
+            HG_Error_to_string(ret));
+    }
+
+    /* Nothing to reduce if no target completed */
+    if (acc_set)
+        ret = hg_multi_encode(multi->proc, NULL, 0, hg_proc_info->out_proc_cb,
+            hg_proc_info->varint, acc_struct, &multi->reduced_buf,
+            &multi->reduced_buf_size);
+    HG_CHECK_SUBSYS_ERROR_NORET(rpc, ret != HG_SUCCESS, free,
+        "Could not encode reduced output (%s)", HG_Error_to_string(ret));
+
+free:
+    if (acc_set && multi->arity == 0)
+        (void) HG_Free_output(acc_handle, acc_struct);
+    else if (acc_set)
+        (void) hg_multi_free_output(multi, acc_struct);
+    free(acc_struct);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_set_addrs(struct hg_multi *multi, const hg_addr_t *addrs)
+{
+    hg_size_t addrs_size = 0, addrs_max = 0;
+    unsigned int i;
+    hg_return_t ret;
+
+    multi->addr_offsets =
+        (hg_size_t *) malloc((multi->count + 1) * sizeof(hg_size_t));
+    HG_CHECK_SUBSYS_ERROR(rpc, multi->addr_offsets == NULL, error, ret,
+        HG_NOMEM, "Could not allocate address offsets");
+
+    for (i = 0; i < multi->count; i++) {
+        hg_size_t addr_size = 0;
+
+        ret = HG_Core_addr_to_string(
+            NULL, &addr_size, (hg_core_addr_t) addrs[i]);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+            "Could not get size of address string %u (%s)", i,
+            HG_Error_to_string(ret));
+
+        if (addrs_size + addr_size > addrs_max) {
+            hg_size_t new_max = MAX(addrs_max * 2, addrs_size + addr_size);
+            char *new_addrs = (char *) realloc(multi->addrs, new_max);
+
+            HG_CHECK_SUBSYS_ERROR(rpc, new_addrs == NULL, error, ret, HG_NOMEM,
+                "Could not grow address strings to %" PRIu64 " bytes",
+                new_max);
+            multi->addrs = new_addrs;
+            addrs_max = new_max;
+        }
+
+        ret = HG_Core_addr_to_string(multi->addrs + addrs_size, &addr_size,
+            (hg_core_addr_t) addrs[i]);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+            "Could not convert address %u to string (%s)", i,
+            HG_Error_to_string(ret));
+
+        multi->addr_offsets[i] = addrs_size;
+        addrs_size += addr_size;
+    }
+    multi->addr_offsets[multi->count] = addrs_size;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_multi_tree_forward(struct hg_multi *multi, unsigned int first,
+    const hg_addr_t *addrs, unsigned int *posted_p)
+{
+    unsigned int n = multi->count - first;
+    unsigned int chunks = MIN(multi->arity, n), i, start = first;
+
+    /* Held until all subtrees have been forwarded to (or until the node has
+     * responded itself) */
+    hg_atomic_init32(&multi->pending, (int32_t) chunks + 1);
+
+    for (i = 0; i < chunks; i++) {
+        unsigned int len = n / chunks + ((i < n % chunks) ? 1 : 0), j;
+        hg_addr_t addr = HG_ADDR_NULL;
+        hg_return_t ret;
+
+        if (addrs != NULL)
+            addr = addrs[start];
+        else {
+            ret = hg_multi_tree_addr_lookup(
+                multi, multi->addrs + multi->addr_offsets[start], &addr);
+            HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+                "Could not look up address of subtree %u (%s)", i,
+                HG_Error_to_string(ret));
+        }
+
+        multi->targets[start].subtree_count = len;
+        ret = hg_multi_tree_forward_one(multi, start, addr);
+        if (addrs == NULL)
+            (void) HG_Addr_free(multi->context->hg_class, addr);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+            "Could not forward to subtree %u (%s)", i,
+            HG_Error_to_string(ret));
+
+        if (posted_p != NULL)
+            (*posted_p)++;
+        start += len;
+        continue;
+
+error:
+        /* Entire subtree is unreachable */
+        for (j = start; j < start + len; j++)
+            multi->targets[j].ret = ret;
+        (void) hg_atomic_decr32(&multi->pending);
+        start += len;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_tree_addr_lookup(
+    struct hg_multi *multi, const char *name, hg_addr_t *addr_p)
+{
+    hg_class_t *hg_class = multi->context->hg_class;
+    char self_name[HG_MULTI_ADDR_NAME_MAX];
+    hg_size_t self_name_size = sizeof(self_name);
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_return_t ret;
+
+    ret = HG_Addr_self(hg_class, &self_addr);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not get self address (%s)", HG_Error_to_string(ret));
+
+    if (HG_Core_addr_to_string(self_name, &self_name_size,
+            (hg_core_addr_t) self_addr) == HG_SUCCESS &&
+        strcmp(self_name, name) == 0) {
+        *addr_p = self_addr;
+        return HG_SUCCESS;
+    }
+    (void) HG_Addr_free(hg_class, self_addr);
+
+    return HG_Addr_lookup2(hg_class, name, addr_p);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_tree_forward_one(
+    struct hg_multi *multi, unsigned int start, hg_addr_t addr)
+{
+    struct hg_multi_target *target = &multi->targets[start];
+    unsigned int len = target->subtree_count;
+    struct hg_multi_tree_in tree_in = {.addrs =
+                                           multi->addrs +
+                                           multi->addr_offsets[start + 1],
+        .in_buf = multi->in_buf,
+        .addrs_size = multi->addr_offsets[start + len] -
+                      multi->addr_offsets[start + 1],
+        .in_buf_size = multi->in_buf_size,
+        .addr_count = len - 1,
+        .arity = multi->arity};
+    struct hg_private_handle *hg_handle;
+    hg_size_t payload_size = 0;
+    hg_bool_t more_data = HG_FALSE;
+    hg_uint8_t flags = 0;
+    hg_return_t ret;
+
+    ret = HG_Create(multi->context, addr, multi->id, &target->handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not create handle (%s)",
+        HG_Error_to_string(ret));
+    hg_handle = (struct hg_private_handle *) target->handle;
+    hg_handle->forward_cb = hg_multi_tree_forward_cb;
+    hg_handle->forward_arg = target;
+
+    ret = hg_set_struct(hg_handle, &multi->tree_proc_info, HG_INPUT, &tree_in,
+        &payload_size, &more_data);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not set input (%s)", HG_Error_to_string(ret));
+
+    if (more_data)
+        flags |= HG_CORE_MORE_DATA;
+    if (multi->tree_proc_info.no_response)
+        flags |= HG_CORE_NO_RESPONSE;
+
+    ret = HG_Core_forward(hg_handle->handle.core_handle, hg_core_forward_cb,
+        hg_handle, flags, payload_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward call (%s)",
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_tree_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_multi_target *target =
+        (struct hg_multi_target *) callback_info->arg;
+    struct hg_multi *multi = target->multi;
+    struct hg_private_handle *hg_handle =
+        (struct hg_private_handle *) target->handle;
+    hg_return_t ret = callback_info->ret;
+    unsigned int i;
+
+    if (ret == HG_SUCCESS && !multi->tree_proc_info.no_response) {
+        struct hg_multi_tree_out tree_out = {.targets = target,
+            .reduced_buf = NULL,
+            .reduced_buf_size = 0,
+            .count = target->subtree_count,
+            .reduced = HG_FALSE};
+
+        ret = hg_get_struct(
+            hg_handle, &multi->tree_proc_info, HG_OUTPUT, &tree_out);
+        HG_CHECK_SUBSYS_ERROR_NORET(rpc, ret != HG_SUCCESS, done,
+            "Could not get relayed outputs (%s)", HG_Error_to_string(ret));
+
+        (void) hg_free_struct(
+            hg_handle, &multi->tree_proc_info, HG_OUTPUT, &tree_out);
+    }
+
+done:
+    if (ret != HG_SUCCESS)
+        for (i = 0; i < target->subtree_count; i++)
+            target[i].ret = ret;
+
+    (void) HG_Destroy(target->handle);
+    target->handle = HG_HANDLE_NULL;
+
+    return hg_multi_complete(multi);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_node_init(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info)
+{
+    struct hg_multi_tree_in tree_in = {.addrs = NULL, .in_buf = NULL};
+    struct hg_header *hg_header = &hg_handle->hg_header;
+    struct hg_multi *multi = NULL;
+    hg_proc_t proc = HG_PROC_NULL;
+    hg_size_t buf_size, offset = 0;
+    void *buf;
+    unsigned int i;
+    hg_return_t ret;
+
+    /* Only peek at header flags, payload is decoded when needed */
+    ret = HG_Core_get_input(hg_handle->handle.core_handle, &buf, &buf_size);
+    if (ret != HG_SUCCESS)
+        return HG_SUCCESS;
+    hg_header_reset(hg_header, HG_INPUT);
+    ret = hg_header_proc(HG_DECODE, buf, buf_size, hg_header);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process header");
+    hg_handle->out_region_advertised =
+        (hg_header->msg.input.flags & HG_HEADER_OUT_REGION) != 0;
+    if (!(hg_header->msg.input.flags & HG_HEADER_TREE))
+        return HG_SUCCESS;
+
+    ret = hg_get_struct_proc(hg_handle, hg_proc_info, HG_INPUT, &proc);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get payload proc");
+
+    ret = hg_multi_tree_in_proc(proc, &tree_in);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not decode relayed input");
+
+    ret = hg_proc_flush(proc);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Error in proc flush");
+
+#ifdef HG_HAS_CHECKSUMS
+    if (hg_handle->use_checksums) {
+        ret = hg_proc_checksum_verify(proc, &hg_header->msg.input.hash.payload,
+            sizeof(hg_header->msg.input.hash.payload));
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Error in proc checksum verify");
+    }
+#endif
+
+    HG_CHECK_SUBSYS_ERROR(rpc, tree_in.arity == 0, error, ret,
+        HG_PROTOCOL_ERROR, "Invalid tree arity");
+
+    /* Node itself is the first target */
+    ret = hg_multi_create(hg_handle->handle.info.context, hg_proc_info,
+        hg_handle->handle.info.id, tree_in.addr_count + 1, tree_in.arity,
+        &multi);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not create relay operation (%s)", HG_Error_to_string(ret));
+
+    multi->addrs = (char *) tree_in.addrs;
+    tree_in.addrs = NULL;
+    multi->addr_offsets =
+        (hg_size_t *) malloc((multi->count + 1) * sizeof(hg_size_t));
+    HG_CHECK_SUBSYS_ERROR(rpc, multi->addr_offsets == NULL, error, ret,
+        HG_NOMEM, "Could not allocate address offsets");
+
+    /* Address strings are NUL-terminated and packed back to back */
+    multi->addr_offsets[0] = 0;
+    for (i = 1; i < multi->count; i++) {
+        const char *end;
+
+        HG_CHECK_SUBSYS_ERROR(rpc, offset >= tree_in.addrs_size, error, ret,
+            HG_PROTOCOL_ERROR, "Truncated address strings");
+        end = memchr(multi->addrs + offset, '\0',
+            (size_t) (tree_in.addrs_size - offset));
+        HG_CHECK_SUBSYS_ERROR(rpc, end == NULL, error, ret, HG_PROTOCOL_ERROR,
+            "Address string is not terminated");
+
+        multi->addr_offsets[i] = offset;
+        offset = (hg_size_t) (end - multi->addrs) + 1;
+    }
+    multi->addr_offsets[multi->count] = offset;
+
+    /* Input is decoded from relayed buffer from now on */
+    hg_handle->tree_in_buf = tree_in.in_buf;
+    hg_handle->tree_in_buf_size = tree_in.in_buf_size;
+    tree_in.in_buf = NULL;
+    multi->in_buf = hg_handle->tree_in_buf;
+    multi->in_buf_size = hg_handle->tree_in_buf_size;
+    multi->node_handle = hg_handle;
+    hg_handle->multi_node = multi;
+
+    /* Handle must remain valid until subtree has responded */
+    HG_Core_ref_incr(hg_handle->handle.core_handle);
+
+    hg_multi_tree_forward(multi, 1, NULL, NULL);
+
+    /* No response is returned by the node itself */
+    if (hg_proc_info->no_response)
+        return hg_multi_complete(multi);
+
+    return HG_SUCCESS;
+
+error:
+    free(tree_in.addrs);
+    free(tree_in.in_buf);
+    hg_multi_free(multi);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_node_respond(struct hg_private_handle *hg_handle,
+    const struct hg_proc_info *hg_proc_info, void *out_struct)
+{
+    struct hg_multi *multi = hg_handle->multi_node;
+    struct hg_multi_target *target = &multi->targets[0];
+    hg_size_t header_offset = hg_header_get_size(HG_OUTPUT) +
+                              hg_handle->handle.info.hg_class->out_offset;
+    hg_size_t buf_size;
+    void *buf;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info->no_response, error, ret,
+        HG_OPNOTSUPPORTED, "No output was produced on that RPC (no response)");
+
+    /* Output buffer is only used as scratch space, outputs of subtree are
+     * sent together once they have all responded */
+    ret = HG_Core_get_output(hg_handle->handle.core_handle, &buf, &buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get output buffer");
+
+    ret = hg_multi_encode(hg_handle->out_proc,
+        (buf_size > header_offset) ? (char *) buf + header_offset : NULL,
+        (buf_size > header_offset) ? buf_size - header_offset : 0,
+        hg_proc_info->out_proc_cb, hg_proc_info->varint, out_struct,
+        &target->out_buf, &target->out_buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode output (%s)",
+        HG_Error_to_string(ret));
+    target->ret = HG_SUCCESS;
+
+    return hg_multi_complete(multi);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_multi_node_complete(struct hg_multi *multi)
+{
+    struct hg_private_handle *hg_handle = multi->node_handle;
+    hg_core_handle_t core_handle = hg_handle->handle.core_handle;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!multi->tree_proc_info.no_response) {
+        struct hg_multi_tree_out tree_out = {.targets = multi->targets,
+            .reduced_buf = NULL,
+            .reduced_buf_size = 0,
+            .count = multi->count,
+            .reduced = (multi->hg_proc_info->reduce_cb != NULL)};
+        hg_size_t payload_size = 0;
+        hg_bool_t more_data = HG_FALSE;
+        hg_uint8_t flags = 0;
+
+        /* Only the reduced output of the subtree is sent upward */
+        if (tree_out.reduced) {
+            unsigned int i;
+
+            ret = hg_multi_reduce(multi);
+            if (ret != HG_SUCCESS) {
+                HG_LOG_SUBSYS_ERROR(rpc, "Could not reduce outputs (%s)",
+                    HG_Error_to_string(ret));
+                for (i = 0; i < multi->count; i++)
+                    multi->targets[i].ret = ret;
+            }
+            tree_out.reduced_buf = multi->reduced_buf;
+            tree_out.reduced_buf_size = multi->reduced_buf_size;
+        }
+
+        ret = hg_set_struct(hg_handle, &multi->tree_proc_info, HG_OUTPUT,
+            &tree_out, &payload_size, &more_data);
+        HG_CHECK_SUBSYS_ERROR_NORET(rpc, ret != HG_SUCCESS, done,
+            "Could not set relayed outputs (%s)", HG_Error_to_string(ret));
+
+        if (more_data)
+            flags |= HG_CORE_MORE_DATA;
+
+        ret = HG_Core_respond(
+            core_handle, hg_core_respond_cb, hg_handle, flags, payload_size);
+        HG_CHECK_SUBSYS_ERROR_NORET(rpc, ret != HG_SUCCESS, done,
+            "Could not respond (%s)", HG_Error_to_string(ret));
+    }
+
+done:
+    hg_handle->multi_node = NULL;
+    hg_multi_free(multi);
+    (void) HG_Core_destroy(core_handle);
+
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Version_get(
+    unsigned int *major_p, unsigned int *minor_p, unsigned int *patch_p)
+{
+    if (major_p)
+        *major_p = HG_VERSION_MAJOR;
+    if (minor_p)
+        *minor_p = HG_VERSION_MINOR;
+    if (patch_p)
+        *patch_p = HG_VERSION_PATCH;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+const char *
+HG_Error_to_string(hg_return_t errnum)
+{
+    return hg_return_name[errnum];
+}
+
+/*---------------------------------------------------------------------------*/
+hg_class_t *
+HG_Init(const char *na_info_string, hg_bool_t na_listen)
+{
+    return HG_Init_opt2(na_info_string, na_listen, 0, NULL);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_class_t *
+HG_Init_opt(const char *na_info_string, hg_bool_t na_listen,
+    const struct hg_init_info *hg_init_info)
+{
+    /* v2.2 is latest version for which init struct was not versioned */
+    return HG_Init_opt2(
+        na_info_string, na_listen, HG_VERSION(2, 2), hg_init_info);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_class_t *
+HG_Init_opt2(const char *na_info_string, hg_bool_t na_listen,
+    unsigned int version, const struct hg_init_info *hg_init_info_p)
+{
+    struct hg_private_class *hg_class = NULL;
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+
+    /* Make sure error return codes match */
+    assert(HG_CANCELED == (hg_return_t) NA_CANCELED);
+
+    hg_class = calloc(1, sizeof(*hg_class));
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        cls, hg_class == NULL, error, "Could not allocate HG class");
+
+    if (hg_init_info_p != NULL) {
+        HG_CHECK_SUBSYS_ERROR_NORET(
+            cls, version == 0, error, "API version cannot be 0");
+        HG_LOG_SUBSYS_DEBUG(cls, "Init info version used: v%d.%d",
+            HG_MAJOR(version), HG_MINOR(version));
+
+        /* Get init info and overwrite defaults */
+        if (HG_VERSION_GE(version, HG_VERSION(2, 4)))
+            hg_init_info = *hg_init_info_p;
+        else if (HG_VERSION_GE(version, HG_VERSION(2, 3)))
+            hg_init_info_dup_2_3(&hg_init_info,
+                (const struct hg_init_info_2_3 *) hg_init_info_p);
+        else
+            hg_init_info_dup_2_2(&hg_init_info,
+                (const struct hg_init_info_2_2 *) hg_init_info_p);
+    }
+
+    /* Save bulk eager information */
+    hg_class->bulk_eager = !hg_init_info.no_bulk_eager;
+
+    /* Save checksum level information */
+#ifdef HG_HAS_CHECKSUMS
+    hg_class->checksum_level = hg_init_info.checksum_level;
+    hg_class->checksum_payload_buf = hg_init_info.checksum_payload_buf;
+#else
+    HG_CHECK_SUBSYS_WARNING(cls,
+        hg_init_info.checksum_level != HG_CHECKSUM_NONE,
+        "Option checksum_level requires CMake option MERCURY_USE_CHECKSUMS "
+        "to be turned ON.");
+#endif
+
+    /* Threads cannot be spawned on classes used by a single thread */
+    hg_class->single_thread = hg_init_info.single_thread;
+
+    /* Release input early */
+    hg_class->release_input_early = hg_init_info.release_input_early;
+    hg_class->release_input_on_free = hg_init_info.release_input_on_free;
+
+    /* Eager bulk data can only be referenced while input is kept */
+    HG_CHECK_SUBSYS_WARNING(cls,
+        hg_init_info.bulk_eager_ref && (hg_init_info.release_input_early ||
+                                           hg_init_info.release_input_on_free),
+        "Option bulk_eager_ref is ignored when input is released early");
+    hg_class->bulk_eager_ref = hg_init_info.bulk_eager_ref &&
+                               !hg_init_info.release_input_early &&
+                               !hg_init_info.release_input_on_free;
+
+    /* Input references */
+#ifdef HG_HAS_XDR
+    HG_CHECK_SUBSYS_WARNING(cls, hg_init_info.input_ref_threshold > 0,
+        "Option input_ref_threshold is not supported with XDR");
+#else
+    hg_class->input_ref_threshold = hg_init_info.input_ref_threshold;
+#endif
+
+    hg_atomic_init32(&hg_class->handle_count, 0);
+
+    /* Extra buffer pool */
+    hg_thread_spin_init(&hg_class->extra_buf_pool.lock);
+    hg_class->extra_buf_pool.max_size = hg_init_info.extra_buf_pool_max;
+
+    hg_class->hg_class.core_class =
+        HG_Core_init_opt2(na_info_string, na_listen, version, hg_init_info_p);
+    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_class->hg_class.core_class == NULL,
+        error, "Could not create HG core class");
+
+    /* Set more data callback */
+    HG_Core_set_more_data_callback(
+        hg_class->hg_class.core_class, hg_more_data_cb, hg_more_data_free_cb);
+
+    return (hg_class_t *) hg_class;
+
+error:
+    free(hg_class);
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Finalize(hg_class_t *hg_class)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret;
+
+    /* Pooled buffers must be deregistered first */
+    hg_extra_buf_pool_drain(private_class);
+
+    ret = HG_Core_finalize(private_class->hg_class.core_class);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        cls, error, ret, "Could not finalize HG core class");
+
+    hg_thread_spin_destroy(&private_class->extra_buf_pool.lock);
+    free(private_class);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+HG_Cleanup(void)
+{
+    HG_Core_cleanup();
+}
+
+/*---------------------------------------------------------------------------*/
+void
+HG_Set_log_level(const char *level)
+{
+    hg_log_set_subsys_level(HG_SUBSYS_NAME_STRING, hg_log_name_to_level(level));
+}
+
+/*---------------------------------------------------------------------------*/
+void
+HG_Set_log_subsys(const char *subsys)
+{
+    hg_log_set_subsys(subsys);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+HG_Set_log_func(int (*log_func)(FILE *stream, const char *format, ...))
+{
+    hg_log_set_func(log_func);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+HG_Set_log_stream(const char *level, FILE *stream)
+{
+    switch (hg_log_name_to_level(level)) {
+        case HG_LOG_LEVEL_ERROR:
+            hg_log_set_stream_error(stream);
+            break;
+        case HG_LOG_LEVEL_WARNING:
+            hg_log_set_stream_warning(stream);
+            break;
+        case HG_LOG_LEVEL_MIN_DEBUG:
+        case HG_LOG_LEVEL_DEBUG:
+            hg_log_set_stream_debug(stream);
+            break;
+        default:
+            break;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Class_set_handle_create_callback(hg_class_t *hg_class,
+    hg_return_t (*callback)(hg_handle_t, void *), void *arg)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    private_class->handle_create = callback;
+    private_class->handle_create_arg = arg;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Class_set_private_area_size(hg_class_t *hg_class, hg_size_t size)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(cls,
+        hg_atomic_get32(&private_class->handle_count) > 0, error, ret, HG_BUSY,
+        "Private area size cannot change once handles have been created");
+
+    private_class->private_area_size = size;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Class_set_trace_callback(
+    hg_class_t *hg_class, hg_trace_cb_t callback, void *arg)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    private_class->trace = callback;
+    private_class->trace_arg = arg;
+
+    ret = HG_Core_class_set_trace_callback(hg_class->core_class,
+        (callback != NULL) ? hg_trace_cb : NULL, private_class);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not set trace callback (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Class_set_peer_error_callback(
+    hg_class_t *hg_class, hg_peer_error_cb_t callback, void *arg)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    private_class->peer_error = callback;
+    private_class->peer_error_arg = arg;
+
+    ret = HG_Core_class_set_peer_error_callback(hg_class->core_class,
+        (callback != NULL) ? hg_peer_error_cb : NULL, private_class);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not set peer error callback (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_context_t *
+HG_Context_create(hg_class_t *hg_class)
+{
+    return HG_Context_create_id(hg_class, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_context_t *
+HG_Context_create_id(hg_class_t *hg_class, hg_uint8_t id)
+{
+    return HG_Context_create_opt(hg_class, id, NULL);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_context_t *
+HG_Context_create_opt(
+    hg_class_t *hg_class, hg_uint8_t id, const struct hg_context_info *info)
+{
+    const struct na_context_info *na_context_info =
+        (info != NULL) ? &info->na_context_info : NULL;
+    struct hg_context *hg_context = NULL;
+    hg_cpu_set_t cpu_mask, prev_mask;
+    hg_bool_t bound = HG_FALSE;
+    hg_return_t ret;
+    int rc;
+
+    HG_CHECK_SUBSYS_ERROR_NORET(ctx, hg_class == NULL, error, "NULL HG class");
+
+    /* Bind calling thread so that context memory (including pre-posted
+     * buffers) gets allocated locally on first touch */
+    if (na_context_info != NULL &&
+        (na_context_info->cpus != NULL || na_context_info->numa_node >= 0) &&
+        hg_thread_cpu_mask_init(na_context_info->cpus,
+            na_context_info->cpu_count, na_context_info->numa_node,
+            &cpu_mask) == HG_UTIL_SUCCESS &&
+        hg_thread_getaffinity(hg_thread_self(), &prev_mask) ==
+            HG_UTIL_SUCCESS &&
+        hg_thread_setaffinity(hg_thread_self(), &cpu_mask) == HG_UTIL_SUCCESS)
+        bound = HG_TRUE;
+
+    hg_context = calloc(1, sizeof(struct hg_private_context));
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        ctx, hg_context == NULL, error, "Could not allocate HG context");
+    hg_atomic_init32(&HG_CONTEXT_EXEC(hg_context)->posting, 0);
+    hg_atomic_init32(&HG_CONTEXT_EXEC(hg_context)->offloading, 0);
+    hg_atomic_init32(&HG_CONTEXT_EXEC(hg_context)->stopping, 0);
+
+    hg_context->hg_class = hg_class;
+    hg_context->core_context =
+        HG_Core_context_create_opt(hg_class->core_class, id, info);
+    HG_CHECK_SUBSYS_ERROR_NORET(ctx, hg_context->core_context == NULL, error,
+        "Could not create context for ID %u", id);
+
+    /* Set handle create callback */
+    HG_Core_context_set_handle_create_callback(
+        hg_context->core_context, hg_handle_create_cb, hg_context);
+
+    /* If we are listening, start posting requests */
+    if (HG_Core_class_is_listening(hg_class->core_class)) {
+        ret = HG_Core_context_post(hg_context->core_context);
+        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+            "Could not post context requests (%s)", HG_Error_to_string(ret));
+    }
+
+    if (bound) {
+        HG_CONTEXT_EXEC(hg_context)->cpu_mask = cpu_mask;
+        HG_CONTEXT_EXEC(hg_context)->bound = HG_TRUE;
+        rc = hg_thread_setaffinity(hg_thread_self(), &prev_mask);
+        HG_CHECK_SUBSYS_WARNING(ctx, rc != HG_UTIL_SUCCESS,
+            "Could not restore calling thread affinity");
+    }
+
+    return hg_context;
+
+error:
+    if (hg_context) {
+        if (hg_context->core_context)
+            (void) HG_Core_context_destroy(hg_context->core_context);
+        free(hg_context);
+    }
+    if (bound)
+        (void) hg_thread_setaffinity(hg_thread_self(), &prev_mask);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_destroy(hg_context_t *context)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+
+    /* Stop execution model if it was not stopped */
+    if (HG_CONTEXT_EXEC(context)->started) {
+        ret = HG_Context_exec_stop(context);
+        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+            "Could not stop execution model (%s)", HG_Error_to_string(ret));
+    }
+
+    ret = HG_Core_context_destroy(context->core_context);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+        "Could not destroy HG core context (%s)", HG_Error_to_string(ret));
+
+    free(context);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_destroy_multi(
+    hg_context_t *contexts[], unsigned int count, hg_bool_t quiescent)
+{
+    hg_core_context_t **core_contexts = NULL;
+    hg_return_t ret;
+    unsigned int i;
+
+    HG_CHECK_SUBSYS_ERROR(ctx, contexts == NULL && count > 0, error, ret,
+        HG_INVALID_ARG, "NULL context array");
+    if (count == 0)
+        return HG_SUCCESS;
+
+    core_contexts =
+        (hg_core_context_t **) malloc(count * sizeof(*core_contexts));
+    HG_CHECK_SUBSYS_ERROR(ctx, core_contexts == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %u core contexts", count);
+
+    for (i = 0; i < count; i++) {
+        HG_CHECK_SUBSYS_ERROR(ctx, contexts[i] == NULL, error, ret,
+            HG_INVALID_ARG, "NULL HG context (index %u)", i);
+
+        /* Stop execution model if it was not stopped */
+        if (HG_CONTEXT_EXEC(contexts[i])->started) {
+            ret = HG_Context_exec_stop(contexts[i]);
+            HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+                "Could not stop execution model (%s)",
+                HG_Error_to_string(ret));
+        }
+        core_contexts[i] = contexts[i]->core_context;
+    }
+
+    ret = HG_Core_context_destroy_multi(core_contexts, count, quiescent);
+
+    /* Release contexts whose core context was destroyed */
+    for (i = 0; i < count; i++) {
+        if (core_contexts[i] != NULL)
+            continue;
+        free(contexts[i]);
+        contexts[i] = NULL;
+    }
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+        "Could not destroy HG core contexts (%s)", HG_Error_to_string(ret));
+
+    free(core_contexts);
+
+    return HG_SUCCESS;
+
+error:
+    free(core_contexts);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_exec_start(hg_context_t *context, const struct hg_exec_info *info)
+{
+    struct hg_exec *hg_exec;
+    hg_return_t ret;
+    int rc;
+
+    HG_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    hg_exec = HG_CONTEXT_EXEC(context);
+    HG_CHECK_SUBSYS_ERROR(ctx, hg_exec->started, error, ret, HG_BUSY,
+        "Execution model already started");
+    HG_CHECK_SUBSYS_ERROR(ctx, HG_CONTEXT_CLASS(context)->single_thread, error,
+        ret, HG_INVALID_ARG,
+        "Execution model cannot be started on single-threaded class");
+
+    hg_exec->progress_timeout = (info != NULL && info->progress_timeout > 0)
+                                    ? info->progress_timeout
+                                    : HG_EXEC_PROGRESS_TIMEOUT;
+
+    /* Workers get their own queue so that a post only wakes up one worker */
+    if (info != NULL && info->handler_thread_count > 0) {
+        struct hg_thread_pool_opt opt = {
+            .cpu_set = hg_exec->bound ? &hg_exec->cpu_mask : NULL,
+            .work_stealing = true};
+
+        rc = hg_thread_pool_init_opt(
+            info->handler_thread_count, &opt, &hg_exec->pool);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+            "Could not create handler pool of %u thread(s)",
+            info->handler_thread_count);
+    }
+
+    hg_atomic_set32(&hg_exec->stopping, 0);
+    rc = hg_thread_create(
+        &hg_exec->progress_thread, hg_exec_progress_thread, context);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error_pool, ret,
+        HG_NOMEM, "Could not create progress thread");
+    hg_exec->started = HG_TRUE;
+
+    if (hg_exec->bound) {
+        rc = hg_thread_setaffinity(
+            hg_exec->progress_thread, &hg_exec->cpu_mask);
+        HG_CHECK_SUBSYS_WARNING(ctx, rc != HG_UTIL_SUCCESS,
+            "Could not bind progress thread to context CPUs");
+    }
+
+    if (hg_exec->pool != NULL)
+        hg_atomic_set32(&hg_exec->offloading, 1);
+
+    return HG_SUCCESS;
+
+error_pool:
+    if (hg_exec->pool != NULL) {
+        (void) hg_thread_pool_destroy(hg_exec->pool);
+        hg_exec->pool = NULL;
+    }
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_exec_stop(hg_context_t *context)
+{
+    struct hg_exec *hg_exec;
+    hg_return_t ret;
+    int rc;
+
+    HG_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    hg_exec = HG_CONTEXT_EXEC(context);
+    HG_CHECK_SUBSYS_ERROR(ctx, !hg_exec->started, error, ret, HG_PROTOCOL_ERROR,
+        "Execution model was not started");
+
+    /* Stop offloading and wait for handlers being posted, RPC callbacks are
+     * then run inline by the progress thread */
+    hg_atomic_set32(&hg_exec->offloading, 0);
+    while (hg_atomic_get32(&hg_exec->posting) > 0)
+        hg_thread_yield();
+
+    /* Keep making progress while queued handlers complete */
+    if (hg_exec->pool != NULL) {
+        rc = hg_thread_pool_destroy(hg_exec->pool);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+            HG_PROTOCOL_ERROR, "Could not destroy handler pool");
+        hg_exec->pool = NULL;
+    }
+
+    hg_atomic_set32(&hg_exec->stopping, 1);
+    rc = hg_thread_join(hg_exec->progress_thread);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+        HG_PROTOCOL_ERROR, "Could not join progress thread");
+    hg_exec->started = HG_FALSE;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_unpost(hg_context_t *context)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+
+    ret = HG_Core_context_unpost(context->core_context);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+        "Could not unpost HG core context (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_id_t
+HG_Register_name(hg_class_t *hg_class, const char *func_name,
+    hg_proc_cb_t in_proc_cb, hg_proc_cb_t out_proc_cb, hg_rpc_cb_t rpc_cb)
+{
+    hg_id_t id;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_class == NULL, error, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR_NORET(cls, func_name == NULL, error, "NULL string");
+
+    /* Generate an ID from the function name */
+    id = hg_hash_string(func_name);
+
+    /* Register RPC */
+    ret = HG_Register(hg_class, id, in_proc_cb, out_proc_cb, rpc_cb);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not register RPC ID %" PRIu64 " for %s (%s)", id, func_name,
+        HG_Error_to_string(ret));
+
+    return id;
+
+error:
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_name(hg_class_t *hg_class, const char *func_name, hg_id_t *id_p,
+    hg_bool_t *flag_p)
+{
+    struct hg_private_class *private_class =
+        (struct hg_private_class *) hg_class;
+    hg_id_t id = 0;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(
+        cls, func_name == NULL, error, ret, HG_INVALID_ARG, "NULL string");
+
+    /* Generate an ID from the function name */
+    id = hg_hash_string(func_name);
+
+    ret = HG_Core_registered(private_class->hg_class.core_class, id, flag_p);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not check for registered RPC ID %" PRIu64 " for %s (%s)", id,
+        func_name, HG_Error_to_string(ret));
+
+    if (id_p)
+        *id_p = id;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Register(hg_class_t *hg_class, hg_id_t id, hg_proc_cb_t in_proc_cb,
+    hg_proc_cb_t out_proc_cb, hg_rpc_cb_t rpc_cb)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(cls, hg_class == NULL, error_done, ret,
+        HG_INVALID_ARG, "NULL HG class");
+
+    /* Register RPC (update RPC callback if already registered) */
+    ret = HG_Core_register(hg_class->core_class, id, hg_core_rpc_cb);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error_done, ret,
+        "Could not register RPC ID %" PRIu64 " (%s)", id,
+        HG_Error_to_string(ret));
+
+    /* Check for registered data attached to that RPC */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    if (hg_proc_info == NULL) {
+        hg_proc_info = (struct hg_proc_info *) calloc(1, sizeof(*hg_proc_info));
+        HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOMEM,
+            "Could not allocate proc info");
+
+        /* Attach proc info to RPC ID */
+        ret = HG_Core_register_data(
+            hg_class->core_class, id, hg_proc_info, hg_proc_info_free);
+        HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+            "Could not set proc info for RPC ID %" PRIu64 " (%s)", id,
+            HG_Error_to_string(ret));
+    }
+    hg_proc_info->rpc_cb = rpc_cb;
+    hg_proc_info->in_proc_cb = in_proc_cb;
+    hg_proc_info->out_proc_cb = out_proc_cb;
+
+    return HG_SUCCESS;
+
+error:
+    (void) HG_Core_deregister(hg_class->core_class, id);
+    free(hg_proc_info); /* assumes info was not attached */
+
+error_done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Deregister(hg_class_t *hg_class, hg_id_t id)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_deregister(hg_class->core_class, id);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not deregister RPC ID %" PRIu64 " (%s)", id,
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag_p)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_registered(hg_class->core_class, id, flag_p);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not check for registered RPC ID %" PRIu64 " (%s)", id,
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_proc_cb(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag_p,
+    hg_proc_cb_t *in_proc_cb_p, hg_proc_cb_t *out_proc_cb_p)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_registered(hg_class->core_class, id, flag_p);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not check for registered RPC ID %" PRIu64 " (%s)", id,
+        HG_Error_to_string(ret));
+
+    if (*flag_p) {
+        /* if RPC is registered, retrieve pointers */
+        hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+            hg_class->core_class, id);
+        HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_FAULT,
+            "Could not get registered data for RPC ID %" PRIu64, id);
+
+        if (in_proc_cb_p)
+            *in_proc_cb_p = hg_proc_info->in_proc_cb;
+        if (out_proc_cb_p)
+            *out_proc_cb_p = hg_proc_info->out_proc_cb;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Register_data(
+    hg_class_t *hg_class, hg_id_t id, void *data, void (*free_callback)(void *))
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    hg_proc_info->data = data;
+    hg_proc_info->free_callback = free_callback;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+HG_Registered_data(hg_class_t *hg_class, hg_id_t id)
+{
+    struct hg_proc_info *hg_proc_info;
+
+    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_class == NULL, error, "NULL HG class");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_proc_info == NULL, error,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    return hg_proc_info->data;
+
+error:
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_disable_response(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t disable)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    hg_proc_info->no_response = disable;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_disabled_response(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t *disabled_p)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(cls, disabled_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to disabled flag");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    *disabled_p = hg_proc_info->no_response;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_timeout(
+    hg_class_t *hg_class, hg_id_t id, unsigned int timeout_ms)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_registered_set_timeout(hg_class->core_class, id, timeout_ms);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not set timeout of RPC ID %" PRIu64, id);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_bypass_admission(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t bypass)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_registered_bypass_admission(hg_class->core_class, id, bypass);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not set admission bypass of RPC ID %" PRIu64, id);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_disable_coalescing(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t disable)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_registered_disable_coalescing(
+        hg_class->core_class, id, disable);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not disable coalescing of RPC ID %" PRIu64, id);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_share_self(hg_class_t *hg_class, hg_id_t id,
+    hg_size_t in_struct_size, hg_size_t out_struct_size)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    hg_proc_info->shared_in_size = in_struct_size;
+    hg_proc_info->shared_out_size = out_struct_size;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_offload(hg_class_t *hg_class, hg_id_t id, hg_bool_t offload)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    hg_proc_info->offload = offload;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_set_priority(hg_class_t *hg_class, hg_id_t id, hg_prio_t prio)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_registered_set_priority(hg_class->core_class, id, prio);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Could not set priority of RPC ID %" PRIu64, id);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_precompute_size(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t enable)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+#ifdef HG_HAS_XDR
+    HG_CHECK_SUBSYS_WARNING(
+        cls, enable, "Size precomputation is not supported with XDR");
+#endif
+    hg_proc_info->precompute_size = enable;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_encode_varint(hg_class_t *hg_class, hg_id_t id, hg_bool_t enable)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+#ifdef HG_HAS_XDR
+    HG_CHECK_SUBSYS_WARNING(
+        cls, enable, "Varint encoding is not supported with XDR");
+#endif
+    hg_proc_info->varint = enable;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_bulk_eager(hg_class_t *hg_class, hg_id_t id, hg_size_t max_size)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    hg_proc_info->bulk_eager_max = max_size;
+    hg_proc_info->bulk_eager_set = HG_TRUE;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_out_region(hg_class_t *hg_class, hg_id_t id, hg_size_t size)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+#ifdef HG_HAS_XDR
+    HG_CHECK_SUBSYS_ERROR(cls, size > 0, error, ret, HG_OPNOTSUPPORTED,
+        "Output regions are not supported with XDR");
+#endif
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    /* Region descriptor is encoded before the input */
+    HG_CHECK_SUBSYS_ERROR(cls, size > 0 && hg_proc_info->in_proc_cb == NULL,
+        error, ret, HG_OPNOTSUPPORTED,
+        "Output region requires an input proc (RPC ID %" PRIu64 ")", id);
+
+    hg_proc_info->out_region_size = size;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_compress(hg_class_t *hg_class, hg_id_t id,
+    const struct hg_compressor *compressor, hg_size_t threshold)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+#ifdef HG_HAS_XDR
+    HG_CHECK_SUBSYS_ERROR(cls, compressor != NULL, error, ret,
+        HG_OPNOTSUPPORTED, "Payload compression is not supported with XDR");
+#endif
+    HG_CHECK_SUBSYS_ERROR(cls,
+        compressor != NULL &&
+            (compressor->id == 0 || compressor->bound == NULL ||
+                compressor->compress == NULL || compressor->decompress == NULL),
+        error, ret, HG_INVALID_ARG, "Invalid compressor");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+
+    hg_proc_info->compressor = compressor;
+    hg_proc_info->compress_threshold = threshold;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_reduce(hg_class_t *hg_class, hg_id_t id,
+    hg_reduce_cb_t reduce_cb, hg_size_t out_struct_size)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+#ifdef HG_HAS_XDR
+    HG_CHECK_SUBSYS_ERROR(cls, reduce_cb != NULL, error, ret,
+        HG_OPNOTSUPPORTED, "Output reduction is not supported with XDR");
+#endif
+    HG_CHECK_SUBSYS_ERROR(cls, reduce_cb != NULL && out_struct_size == 0,
+        error, ret, HG_INVALID_ARG, "Invalid output struct size");
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
+    HG_CHECK_SUBSYS_ERROR(cls,
+        reduce_cb != NULL && hg_proc_info->out_proc_cb == NULL, error, ret,
+        HG_INVALID_ARG, "No output proc registered for RPC ID %" PRIu64, id);
+
+    hg_proc_info->reduce_cb = reduce_cb;
+    hg_proc_info->out_struct_size = out_struct_size;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_lookup1(hg_context_t *context, hg_cb_t callback, void *arg,
+    const char *name, hg_op_id_t *op_id_p)
+{
+    struct hg_op_id *hg_op_id = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    (void) op_id_p;
+
+    /* Allocate op_id */
+    hg_op_id = (struct hg_op_id *) malloc(sizeof(struct hg_op_id));
+    HG_CHECK_SUBSYS_ERROR(addr, hg_op_id == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG operation ID");
+
+    hg_op_id->context = context;
+    hg_op_id->type = HG_CB_LOOKUP;
+    hg_op_id->callback = callback;
+    hg_op_id->arg = arg;
+    hg_op_id->info.lookup.hg_addr = HG_ADDR_NULL;
+
+    ret = HG_Core_addr_lookup1(context->core_context, hg_core_addr_lookup_cb,
+        hg_op_id, name, HG_CORE_OP_ID_IGNORE);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not lookup %s (%s)", name,
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    free(hg_op_id);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_lookup2(hg_class_t *hg_class, const char *name, hg_addr_t *addr_p)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_lookup2(
+        hg_class->core_class, name, (hg_core_addr_t *) addr_p);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not lookup %s (%s)", name,
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_lookup_multi(hg_context_t *context, hg_cb_t callback, void *arg,
+    const char *const *names, unsigned int count, hg_addr_t *addrs,
+    hg_op_id_t *op_id_p)
+{
+    struct hg_op_id *hg_op_id = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    (void) op_id_p;
+
+    /* Allocate op_id */
+    hg_op_id = (struct hg_op_id *) malloc(sizeof(struct hg_op_id));
+    HG_CHECK_SUBSYS_ERROR(addr, hg_op_id == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG operation ID");
+
+    hg_op_id->context = context;
+    hg_op_id->type = HG_CB_LOOKUP;
+    hg_op_id->callback = callback;
+    hg_op_id->arg = arg;
+    hg_op_id->info.lookup.hg_addr = HG_ADDR_NULL;
+
+    ret = HG_Core_addr_lookup_multi(context->core_context,
+        hg_core_addr_lookup_cb, hg_op_id, names, count,
+        (hg_core_addr_t *) addrs, HG_CORE_OP_ID_IGNORE);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not lookup %u names (%s)",
+        count, HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    free(hg_op_id);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_warm(hg_context_t *context, hg_cb_t callback, void *arg,
+    const hg_addr_t *addrs, unsigned int count, hg_op_id_t *op_id_p)
+{
+    struct hg_op_id *hg_op_id = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    (void) op_id_p;
+
+    /* Allocate op_id */
+    hg_op_id = (struct hg_op_id *) malloc(sizeof(struct hg_op_id));
+    HG_CHECK_SUBSYS_ERROR(addr, hg_op_id == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG operation ID");
+
+    hg_op_id->context = context;
+    hg_op_id->type = HG_CB_WARM;
+    hg_op_id->callback = callback;
+    hg_op_id->arg = arg;
+    hg_op_id->info.lookup.hg_addr = HG_ADDR_NULL;
+
+    ret = HG_Core_addr_warm(context->core_context, hg_core_addr_lookup_cb,
+        hg_op_id, (const hg_core_addr_t *) addrs, count, HG_CORE_OP_ID_IGNORE);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+        "Could not warm up %u addrs (%s)", count, HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    free(hg_op_id);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_free(hg_class_t *hg_class, hg_addr_t addr)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_free((hg_core_addr_t) addr);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        addr, error, ret, "Could not free addr (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_set_remove(hg_class_t *hg_class, hg_addr_t addr)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_set_remove((hg_core_addr_t) addr);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+        "Could not set addr to be removed (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_purge(hg_class_t *hg_class, const hg_addr_t *addrs, unsigned int count)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_purge(
+        hg_class->core_class, (const hg_core_addr_t *) addrs, count);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not purge %u addrs (%s)",
+        count, HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_self(hg_class_t *hg_class, hg_addr_t *addr_p)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_self(hg_class->core_class, (hg_core_addr_t *) addr_p);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+        "Could not retrieve self addr (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_dup(hg_class_t *hg_class, hg_addr_t addr, hg_addr_t *new_addr_p)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret =
+        HG_Core_addr_dup((hg_core_addr_t) addr, (hg_core_addr_t *) new_addr_p);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        addr, error, ret, "Could not dup addr (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+HG_Addr_cmp(hg_class_t *hg_class, hg_addr_t addr1, hg_addr_t addr2)
+{
+    HG_CHECK_SUBSYS_ERROR_NORET(addr, hg_class == NULL, error, "NULL HG class");
+
+    return HG_Core_addr_cmp((hg_core_addr_t) addr1, (hg_core_addr_t) addr2);
+
+error:
+    return HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_to_string(
+    hg_class_t *hg_class, char *buf, hg_size_t *buf_size_p, hg_addr_t addr)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    ret = HG_Core_addr_to_string(buf, buf_size_p, (hg_core_addr_t) addr);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+        "Could not convert addr to string (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Set_log_stream(const char *level, FILE *stream)
+hg_size_t
+HG_Addr_get_book_size(
+    hg_class_t *hg_class, const hg_addr_t *addrs, unsigned int count)
 {
-    switch (hg_log_name_to_level(level)) {
-        case HG_LOG_LEVEL_ERROR:
-            hg_log_set_stream_error(stream);
-            break;
-        case HG_LOG_LEVEL_WARNING:
-            hg_log_set_stream_warning(stream);
-            break;
-        case HG_LOG_LEVEL_MIN_DEBUG:
-        case HG_LOG_LEVEL_DEBUG:
-            hg_log_set_stream_debug(stream);
-            break;
-        default:
-            break;
-    }
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        addr, hg_class == NULL, error, "NULL HG class");
+
+    return HG_Core_addr_get_book_size(hg_class->core_class,
+        (const hg_core_addr_t *) addrs, count, HG_CORE_SM);
+
+error:
+    return 0;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Class_set_handle_create_callback(hg_class_t *hg_class,
-    hg_return_t (*callback)(hg_handle_t, void *), void *arg)
+HG_Addr_serialize_book(hg_class_t *hg_class, void *buf, hg_size_t buf_size,
+    const hg_addr_t *addrs, unsigned int count)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(
-        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
 
-    private_class->handle_create = callback;
-    private_class->handle_create_arg = arg;
+    ret = HG_Core_addr_serialize_book(buf, buf_size, HG_CORE_SM,
+        hg_class->core_class, (const hg_core_addr_t *) addrs, count);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+        "Could not serialize addr book (%s)", HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1203,86 +5179,114 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-hg_context_t *
-HG_Context_create(hg_class_t *hg_class)
+hg_return_t
+HG_Addr_deserialize_book(hg_class_t *hg_class, const void *buf,
+    hg_size_t buf_size, hg_addr_t *addrs, unsigned int *count_p)
 {
-    return HG_Context_create_id(hg_class, 0);
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+
+    /* HG_OVERFLOW only reports the number of entries */
+    ret = HG_Core_addr_deserialize_book(hg_class->core_class, buf, buf_size,
+        (hg_core_addr_t *) addrs, count_p);
+    if (ret == HG_OVERFLOW)
+        return ret;
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+        "Could not deserialize addr book (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_context_t *
-HG_Context_create_id(hg_class_t *hg_class, hg_uint8_t id)
+hg_return_t
+HG_Create(
+    hg_context_t *context, hg_addr_t addr, hg_id_t id, hg_handle_t *handle_p)
 {
-    struct hg_context *hg_context = NULL;
+    struct hg_private_handle *hg_handle = NULL;
+    hg_core_handle_t core_handle = HG_CORE_HANDLE_NULL;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR_NORET(ctx, hg_class == NULL, error, "NULL HG class");
-
-    hg_context = calloc(1, sizeof(*hg_context));
-    HG_CHECK_SUBSYS_ERROR_NORET(
-        ctx, hg_context == NULL, error, "Could not allocate HG context");
+    HG_CHECK_SUBSYS_ERROR(
+        rpc, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
 
-    hg_context->hg_class = hg_class;
-    hg_context->core_context =
-        HG_Core_context_create_id(hg_class->core_class, id);
-    HG_CHECK_SUBSYS_ERROR_NORET(ctx, hg_context->core_context == NULL, error,
-        "Could not create context for ID %u", id);
+    /* Create HG core handle (calls handle_create_cb) */
+    ret = HG_Core_create(
+        context->core_context, (hg_core_addr_t) addr, id, &core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Cannot create HG handle with ID %" PRIu64 " (%s)", id,
+        HG_Error_to_string(ret));
 
-    /* Set handle create callback */
-    HG_Core_context_set_handle_create_callback(
-        hg_context->core_context, hg_handle_create_cb, hg_context);
+    /* Get data and HG info */
+    hg_handle = (struct hg_private_handle *) HG_Core_get_data(core_handle);
+    HG_CHECK_SUBSYS_ERROR(
+        rpc, hg_handle == NULL, error, ret, HG_INVALID_ARG, "NULL handle");
+    hg_handle->handle.info.addr = addr;
+    hg_handle->handle.info.id = id;
 
-    /* If we are listening, start posting requests */
-    if (HG_Core_class_is_listening(hg_class->core_class)) {
-        ret = HG_Core_context_post(hg_context->core_context);
-        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
-            "Could not post context requests (%s)", HG_Error_to_string(ret));
-    }
+    *handle_p = (hg_handle_t) hg_handle;
 
-    return hg_context;
+    return HG_SUCCESS;
 
 error:
-    if (hg_context) {
-        if (hg_context->core_context)
-            (void) HG_Core_context_destroy(hg_context->core_context);
-        free(hg_context);
-    }
-    return NULL;
+    (void) HG_Core_destroy(core_handle);
+
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Context_destroy(hg_context_t *context)
+HG_Create_persistent(
+    hg_context_t *context, hg_addr_t addr, hg_id_t id, hg_handle_t *handle_p)
 {
+    struct hg_private_handle *hg_handle;
+    hg_handle_t handle = HG_HANDLE_NULL;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        ctx, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    HG_CHECK_SUBSYS_ERROR(rpc, addr == HG_ADDR_NULL, error, ret,
+        HG_INVALID_ARG, "NULL target addr");
 
-    ret = HG_Core_context_destroy(context->core_context);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
-        "Could not destroy HG core context (%s)", HG_Error_to_string(ret));
+    ret = HG_Create(context, addr, id, &handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not create handle (%s)", HG_Error_to_string(ret));
+    hg_handle = (struct hg_private_handle *) handle;
 
-    free(context);
+    /* Bind proc info once */
+    hg_handle->persistent_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_handle->persistent_proc_info == NULL, error,
+        ret, HG_FAULT, "Could not get proc info");
+
+    ret = HG_Core_set_persistent(handle->core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not set handle persistent (%s)", HG_Error_to_string(ret));
+
+    *handle_p = handle;
 
     return HG_SUCCESS;
 
 error:
+    (void) HG_Destroy(handle);
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Context_unpost(hg_context_t *context)
+HG_Destroy(hg_handle_t handle)
 {
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        ctx, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    if (handle == HG_HANDLE_NULL)
+        return HG_SUCCESS;
 
-    ret = HG_Core_context_unpost(context->core_context);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
-        "Could not unpost HG core context (%s)", HG_Error_to_string(ret));
+    ret = HG_Core_destroy(handle->core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not set handle to be destroyed (%s)", HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1291,56 +5295,57 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-hg_id_t
-HG_Register_name(hg_class_t *hg_class, const char *func_name,
-    hg_proc_cb_t in_proc_cb, hg_proc_cb_t out_proc_cb, hg_rpc_cb_t rpc_cb)
+hg_return_t
+HG_Reset(hg_handle_t handle, hg_addr_t addr, hg_id_t id)
 {
-    hg_id_t id;
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_class == NULL, error, "NULL HG class");
-    HG_CHECK_SUBSYS_ERROR_NORET(cls, func_name == NULL, error, "NULL string");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
 
-    /* Generate an ID from the function name */
-    id = hg_hash_string(func_name);
+    /* Call core reset */
+    ret = HG_Core_reset(handle->core_handle, (hg_core_addr_t) addr, id);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not reset core HG handle (%s)", HG_Error_to_string(ret));
 
-    /* Register RPC */
-    ret = HG_Register(hg_class, id, in_proc_cb, out_proc_cb, rpc_cb);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
-        "Could not register RPC ID %" PRIu64 " for %s (%s)", id, func_name,
-        HG_Error_to_string(ret));
+    /* Set info */
+    private_handle->handle.info.addr = addr;
+    private_handle->handle.info.id = id;
+    private_handle->handle.info.context_id = 0;
+    private_handle->persistent_proc_info = NULL;
+    private_handle->in_retained = HG_FALSE;
 
-    return id;
+    return HG_SUCCESS;
 
 error:
-    return 0;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered_name(hg_class_t *hg_class, const char *func_name, hg_id_t *id_p,
-    hg_bool_t *flag_p)
+HG_Get_input(hg_handle_t handle, void *in_struct)
 {
-    struct hg_private_class *private_class =
-        (struct hg_private_class *) hg_class;
-    hg_id_t id = 0;
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
-    HG_CHECK_SUBSYS_ERROR(
-        cls, func_name == NULL, error, ret, HG_INVALID_ARG, "NULL string");
-
-    /* Generate an ID from the function name */
-    id = hg_hash_string(func_name);
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, in_struct == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to input struct");
 
-    ret = HG_Core_registered(private_class->hg_class.core_class, id, flag_p);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
-        "Could not check for registered RPC ID %" PRIu64 " for %s (%s)", id,
-        func_name, HG_Error_to_string(ret));
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
+        "Could not get proc info");
 
-    if (id_p)
-        *id_p = id;
+    /* Get input struct */
+    ret = hg_get_struct(
+        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_struct);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not get input (%s)", HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1350,63 +5355,87 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Register(hg_class_t *hg_class, hg_id_t id, hg_proc_cb_t in_proc_cb,
-    hg_proc_cb_t out_proc_cb, hg_rpc_cb_t rpc_cb)
+HG_Get_input_proc(hg_handle_t handle, hg_proc_t *in_proc_p)
 {
-    struct hg_proc_info *hg_proc_info = NULL;
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(cls, hg_class == NULL, error_done, ret,
-        HG_INVALID_ARG, "NULL HG class");
-
-    /* Register RPC (update RPC callback if already registered) */
-    ret = HG_Core_register(hg_class->core_class, id, hg_core_rpc_cb);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error_done, ret,
-        "Could not register RPC ID %" PRIu64 " (%s)", id,
-        HG_Error_to_string(ret));
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, in_proc_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to input proc");
 
-    /* Check for registered data attached to that RPC */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    if (hg_proc_info == NULL) {
-        hg_proc_info = (struct hg_proc_info *) calloc(1, sizeof(*hg_proc_info));
-        HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOMEM,
-            "Could not allocate proc info");
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
+        "Could not get proc info");
 
-        /* Attach proc info to RPC ID */
-        ret = HG_Core_register_data(
-            hg_class->core_class, id, hg_proc_info, hg_proc_info_free);
-        HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
-            "Could not set proc info for RPC ID %" PRIu64 " (%s)", id,
-            HG_Error_to_string(ret));
-    }
-    hg_proc_info->rpc_cb = rpc_cb;
-    hg_proc_info->in_proc_cb = in_proc_cb;
-    hg_proc_info->out_proc_cb = out_proc_cb;
+    /* Get input proc, nothing is decoded until fields are processed */
+    ret = hg_get_struct_proc(
+        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_proc_p);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get input proc (%s)",
+        HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
 error:
-    (void) HG_Core_deregister(hg_class->core_class, id);
-    free(hg_proc_info); /* assumes info was not attached */
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Free_input(hg_handle_t handle, void *in_struct)
+{
+    const struct hg_proc_info *hg_proc_info;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, in_struct == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to input struct");
+
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
+        "Could not get proc info");
+
+    /* Free input struct */
+    ret = hg_free_struct(
+        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_struct);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not free input (%s)", HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
 
-error_done:
+error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Deregister(hg_class_t *hg_class, hg_id_t id)
+HG_Get_output(hg_handle_t handle, void *out_struct)
 {
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, out_struct == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to output struct");
 
-    ret = HG_Core_deregister(hg_class->core_class, id);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
-        "Could not deregister RPC ID %" PRIu64 " (%s)", id,
-        HG_Error_to_string(ret));
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
+        "Could not get proc info");
+
+    /* Get output struct */
+    ret = hg_get_struct((struct hg_private_handle *) handle, hg_proc_info,
+        HG_OUTPUT, out_struct);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not get output (%s)", HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1416,17 +5445,27 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag_p)
+HG_Free_output(hg_handle_t handle, void *out_struct)
 {
+    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, out_struct == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to output struct");
 
-    ret = HG_Core_registered(hg_class->core_class, id, flag_p);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
-        "Could not check for registered RPC ID %" PRIu64 " (%s)", id,
-        HG_Error_to_string(ret));
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
+        "Could not get proc info");
+
+    /* Free output struct */
+    ret = hg_free_struct((struct hg_private_handle *) handle, hg_proc_info,
+        HG_OUTPUT, out_struct);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not free output (%s)", HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1436,32 +5475,28 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered_proc_cb(hg_class_t *hg_class, hg_id_t id, hg_bool_t *flag_p,
-    hg_proc_cb_t *in_proc_cb_p, hg_proc_cb_t *out_proc_cb_p)
+HG_Get_input_buf(hg_handle_t handle, void **in_buf_p, hg_size_t *in_buf_size_p)
 {
-    struct hg_proc_info *hg_proc_info = NULL;
+    hg_size_t buf_size, header_offset = hg_header_get_size(HG_INPUT);
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, in_buf_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL input buffer pointer");
 
-    ret = HG_Core_registered(hg_class->core_class, id, flag_p);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
-        "Could not check for registered RPC ID %" PRIu64 " (%s)", id,
+    /* Get core input buffer */
+    /* Note: any extra header information will be transmitted with the
+     * control message, not the extra_buf, if the RPC exceeds the eager size
+     * limit.
+     */
+    ret = HG_Core_get_input(handle->core_handle, in_buf_p, &buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get input buffer (%s)",
         HG_Error_to_string(ret));
 
-    if (*flag_p) {
-        /* if RPC is registered, retrieve pointers */
-        hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-            hg_class->core_class, id);
-        HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_FAULT,
-            "Could not get registered data for RPC ID %" PRIu64, id);
-
-        if (in_proc_cb_p)
-            *in_proc_cb_p = hg_proc_info->in_proc_cb;
-        if (out_proc_cb_p)
-            *out_proc_cb_p = hg_proc_info->out_proc_cb;
-    }
+    *in_buf_p = (char *) *in_buf_p + header_offset;
+    if (in_buf_size_p)
+        *in_buf_size_p = buf_size - header_offset;
 
     return HG_SUCCESS;
 
@@ -1471,23 +5506,16 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Register_data(
-    hg_class_t *hg_class, hg_id_t id, void *data, void (*free_callback)(void *))
+HG_Release_input_buf(hg_handle_t handle)
 {
-    struct hg_proc_info *hg_proc_info = NULL;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
-
-    /* Retrieve proc function from function map */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
-        "Could not get registered data for RPC ID %" PRIu64, id);
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
 
-    hg_proc_info->data = data;
-    hg_proc_info->free_callback = free_callback;
+    ret = HG_Core_release_input(handle->core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not release input buffer (%s)", HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1496,43 +5524,55 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-void *
-HG_Registered_data(hg_class_t *hg_class, hg_id_t id)
+hg_return_t
+HG_Get_output_buf(
+    hg_handle_t handle, void **out_buf_p, hg_size_t *out_buf_size_p)
 {
-    struct hg_proc_info *hg_proc_info;
+    hg_size_t buf_size, header_offset = hg_header_get_size(HG_OUTPUT);
+    hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_class == NULL, error, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, out_buf_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL output buffer pointer");
 
-    /* Retrieve proc function from function map */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_proc_info == NULL, error,
-        "Could not get registered data for RPC ID %" PRIu64, id);
+    /* Get core output buffer */
+    /* Note: any extra header information will be transmitted with the
+     * control message, not the extra_buf, if the response exceeds the eager
+     * size limit.
+     */
+    ret = HG_Core_get_output(handle->core_handle, out_buf_p, &buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not get output buffer (%s)", HG_Error_to_string(ret));
 
-    return hg_proc_info->data;
+    *out_buf_p = (char *) *out_buf_p + header_offset;
+    if (out_buf_size_p)
+        *out_buf_size_p = buf_size - header_offset;
+
+    return HG_SUCCESS;
 
 error:
-    return NULL;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered_disable_response(
-    hg_class_t *hg_class, hg_id_t id, hg_bool_t disable)
+HG_Get_input_extra_buf(
+    hg_handle_t handle, void **in_buf_p, hg_size_t *in_buf_size_p)
 {
-    struct hg_proc_info *hg_proc_info = NULL;
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
-
-    /* Retrieve proc function from function map */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
-        "Could not get registered data for RPC ID %" PRIu64, id);
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, in_buf_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL input buffer pointer");
 
-    hg_proc_info->no_response = disable;
+    /* No offset if extra buffer since only the user payload is copied */
+    *in_buf_p = private_handle->in_extra_buf;
+    if (in_buf_size_p)
+        *in_buf_size_p = private_handle->in_extra_buf_size;
 
     return HG_SUCCESS;
 
@@ -1542,24 +5582,22 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Registered_disabled_response(
-    hg_class_t *hg_class, hg_id_t id, hg_bool_t *disabled_p)
+HG_Get_output_extra_buf(
+    hg_handle_t handle, void **out_buf_p, hg_size_t *out_buf_size_p)
 {
-    struct hg_proc_info *hg_proc_info = NULL;
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        cls, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
-    HG_CHECK_SUBSYS_ERROR(cls, disabled_p == NULL, error, ret, HG_INVALID_ARG,
-        "NULL pointer to disabled flag");
-
-    /* Retrieve proc function from function map */
-    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
-        hg_class->core_class, id);
-    HG_CHECK_SUBSYS_ERROR(cls, hg_proc_info == NULL, error, ret, HG_NOENTRY,
-        "Could not get registered data for RPC ID %" PRIu64, id);
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, out_buf_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL output buffer pointer");
 
-    *disabled_p = hg_proc_info->no_response;
+    /* No offset if extra buffer since only the user payload is copied */
+    *out_buf_p = private_handle->out_extra_buf;
+    if (out_buf_size_p)
+        *out_buf_size_p = private_handle->out_extra_buf_size;
 
     return HG_SUCCESS;
 
@@ -1569,52 +5607,66 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_lookup1(hg_context_t *context, hg_cb_t callback, void *arg,
-    const char *name, hg_op_id_t *op_id_p)
+HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
 {
-    struct hg_op_id *hg_op_id = NULL;
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
+    const struct hg_proc_info *hg_proc_info = NULL;
+    hg_size_t payload_size = 0;
+    hg_bool_t more_data = HG_FALSE;
+    hg_uint8_t flags = 0;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        addr, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
-    (void) op_id_p;
-
-    /* Allocate op_id */
-    hg_op_id = (struct hg_op_id *) malloc(sizeof(struct hg_op_id));
-    HG_CHECK_SUBSYS_ERROR(addr, hg_op_id == NULL, error, ret, HG_NOMEM,
-        "Could not allocate HG operation ID");
-
-    hg_op_id->context = context;
-    hg_op_id->type = HG_CB_LOOKUP;
-    hg_op_id->callback = callback;
-    hg_op_id->arg = arg;
-    hg_op_id->info.lookup.hg_addr = HG_ADDR_NULL;
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle->info.addr == HG_ADDR_NULL, error, ret,
+        HG_INVALID_ARG, "NULL target addr");
 
-    ret = HG_Core_addr_lookup1(context->core_context, hg_core_addr_lookup_cb,
-        hg_op_id, name, HG_CORE_OP_ID_IGNORE);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not lookup %s (%s)", name,
-        HG_Error_to_string(ret));
+    /* Set callback data */
+    private_handle->forward_cb = callback;
+    private_handle->forward_arg = arg;
 
-    return HG_SUCCESS;
+    /* Retrieve RPC data */
+    hg_proc_info =
+        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
+        "Could not get proc info");
 
-error:
-    free(hg_op_id);
+    /* Input buffer is overwritten */
+    private_handle->in_retained = HG_FALSE;
+
+    /* Pass input by value when forwarding to ourself if allowed */
+    private_handle->in_shared = in_struct != NULL &&
+                                hg_proc_info->shared_in_size > 0 &&
+                                !hg_proc_info->tree &&
+                                HG_Core_is_self(handle->core_handle);
+    private_handle->out_shared = HG_FALSE;
+    if (private_handle->in_shared) {
+        ret = hg_shared_copy(&private_handle->shared_in,
+            &private_handle->shared_in_alloc, in_struct,
+            hg_proc_info->shared_in_size);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not share input");
+    }
 
-    return ret;
-}
+    /* Set input struct */
+    ret = hg_set_struct(private_handle, hg_proc_info, HG_INPUT,
+        private_handle->in_shared ? NULL : in_struct, &payload_size,
+        &more_data);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not set input (%s)", HG_Error_to_string(ret));
 
-/*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Addr_lookup2(hg_class_t *hg_class, const char *name, hg_addr_t *addr_p)
-{
-    hg_return_t ret;
+    /* Set more data flag on handle so that handle_more_callback is triggered */
+    if (more_data)
+        flags |= HG_CORE_MORE_DATA;
 
-    HG_CHECK_SUBSYS_ERROR(
-        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    /* Set no response flag if no response required */
+    if (hg_proc_info->no_response)
+        flags |= HG_CORE_NO_RESPONSE;
 
-    ret = HG_Core_addr_lookup2(
-        hg_class->core_class, name, (hg_core_addr_t *) addr_p);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not lookup %s (%s)", name,
+    /* Send request */
+    ret = HG_Core_forward(
+        handle->core_handle, hg_core_forward_cb, handle, flags, payload_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward call (%s)",
         HG_Error_to_string(ret));
 
     return HG_SUCCESS;
@@ -1625,16 +5677,49 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_free(hg_class_t *hg_class, hg_addr_t addr)
+HG_Forward_persistent(
+    hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
 {
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
+    const struct hg_proc_info *hg_proc_info;
+    hg_size_t payload_size = 0;
+    hg_bool_t more_data = HG_FALSE;
+    hg_uint8_t flags = 0;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    hg_proc_info = private_handle->persistent_proc_info;
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret,
+        HG_INVALID_ARG, "Handle is not persistent");
 
-    ret = HG_Core_addr_free((hg_core_addr_t) addr);
+    /* Set callback data */
+    private_handle->forward_cb = callback;
+    private_handle->forward_arg = arg;
+
+    /* Input buffer is overwritten, it is always encoded so that it can be
+     * retained */
+    private_handle->in_retained = HG_FALSE;
+    private_handle->in_shared = HG_FALSE;
+    private_handle->out_shared = HG_FALSE;
+
+    /* Set input struct */
+    ret = hg_set_struct(private_handle, hg_proc_info, HG_INPUT, in_struct,
+        &payload_size, &more_data);
     HG_CHECK_SUBSYS_HG_ERROR(
-        addr, error, ret, "Could not free addr (%s)", HG_Error_to_string(ret));
+        rpc, error, ret, "Could not set input (%s)", HG_Error_to_string(ret));
+
+    if (more_data)
+        flags |= HG_CORE_MORE_DATA;
+    if (hg_proc_info->no_response)
+        flags |= HG_CORE_NO_RESPONSE;
+
+    /* Send request, header is re-used if flags did not change */
+    ret = HG_Core_forward(
+        handle->core_handle, hg_core_forward_cb, handle, flags, payload_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward call (%s)",
+        HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1644,16 +5729,33 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_set_remove(hg_class_t *hg_class, hg_addr_t addr)
+HG_Retain_input(hg_handle_t handle, void *in_struct)
 {
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
+    hg_size_t payload_size = 0;
+    hg_bool_t more_data = HG_FALSE;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, private_handle->persistent_proc_info == NULL,
+        error, ret, HG_INVALID_ARG, "Handle is not persistent");
 
-    ret = HG_Core_addr_set_remove((hg_core_addr_t) addr);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
-        "Could not set addr to be removed (%s)", HG_Error_to_string(ret));
+    private_handle->in_retained = HG_FALSE;
+
+    /* Encode input once into the input buffer of the handle */
+    ret = hg_set_struct(private_handle, private_handle->persistent_proc_info,
+        HG_INPUT, in_struct, &payload_size, &more_data);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not set input (%s)", HG_Error_to_string(ret));
+
+    /* Extra buffers may be released or re-used once the call completes */
+    HG_CHECK_SUBSYS_ERROR(rpc, more_data, error, ret, HG_MSGSIZE,
+        "Encoded input does not fit in input buffer and cannot be retained");
+
+    private_handle->retained_in_size = payload_size;
+    private_handle->in_retained = HG_TRUE;
 
     return HG_SUCCESS;
 
@@ -1663,16 +5765,32 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_self(hg_class_t *hg_class, hg_addr_t *addr_p)
+HG_Forward_retained(hg_handle_t handle, hg_cb_t callback, void *arg)
 {
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, !private_handle->in_retained, error, ret,
+        HG_INVALID_ARG, "No input retained on handle");
 
-    ret = HG_Core_addr_self(hg_class->core_class, (hg_core_addr_t *) addr_p);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
-        "Could not retrieve self addr (%s)", HG_Error_to_string(ret));
+    /* Set callback data */
+    private_handle->forward_cb = callback;
+    private_handle->forward_arg = arg;
+
+    /* Output of a previous forward is no longer referenced */
+    hg_free_extra_output(private_handle);
+    private_handle->out_shared = HG_FALSE;
+
+    /* Proc callbacks are skipped, the buffer is sent as is */
+    ret = HG_Core_forward(handle->core_handle, hg_core_forward_cb, handle,
+        private_handle->persistent_proc_info->no_response ? HG_CORE_NO_RESPONSE
+                                                          : 0,
+        private_handle->retained_in_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward call (%s)",
+        HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1682,49 +5800,61 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_dup(hg_class_t *hg_class, hg_addr_t addr, hg_addr_t *new_addr_p)
+HG_Forward_wait(hg_handle_t handle, void *in_struct, unsigned int timeout_ms)
 {
+    struct hg_wait hg_wait;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
-
-    ret =
-        HG_Core_addr_dup((hg_core_addr_t) addr, (hg_core_addr_t *) new_addr_p);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        addr, error, ret, "Could not dup addr (%s)", HG_Error_to_string(ret));
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
 
-    return HG_SUCCESS;
+    hg_wait.core_context = handle->info.context->core_context;
+    hg_atomic_init32(&hg_wait.done, 0);
+    hg_wait.ret = HG_SUCCESS;
 
-error:
-    return ret;
-}
+    ret = HG_Forward(handle, hg_forward_wait_cb, &hg_wait, in_struct);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward call (%s)",
+        HG_Error_to_string(ret));
 
-/*---------------------------------------------------------------------------*/
-hg_bool_t
-HG_Addr_cmp(hg_class_t *hg_class, hg_addr_t addr1, hg_addr_t addr2)
-{
-    HG_CHECK_SUBSYS_ERROR_NORET(addr, hg_class == NULL, error, "NULL HG class");
+    ret = hg_wait_progress(handle->info.context, &hg_wait, timeout_ms);
+    if (ret != HG_SUCCESS) {
+        /* Callback references hg_wait, wait for the canceled call to
+         * complete before leaving */
+        (void) HG_Cancel(handle);
+        while (hg_wait_progress(handle->info.context, &hg_wait,
+                   HG_MAX_IDLE_TIME) != HG_SUCCESS)
+            continue;
+        return ret;
+    }
 
-    return HG_Core_addr_cmp((hg_core_addr_t) addr1, (hg_core_addr_t) addr2);
+    return hg_wait.ret;
 
 error:
-    return HG_FALSE;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Addr_to_string(
-    hg_class_t *hg_class, char *buf, hg_size_t *buf_size_p, hg_addr_t addr)
+HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct)
 {
+    hg_size_t payload_size;
+    hg_uint8_t flags;
+    hg_bool_t sent;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        addr, hg_class == NULL, error, ret, HG_INVALID_ARG, "NULL HG class");
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
 
-    ret = HG_Core_addr_to_string(buf, buf_size_p, (hg_core_addr_t) addr);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
-        "Could not convert addr to string (%s)", HG_Error_to_string(ret));
+    ret = hg_respond_prepare((struct hg_private_handle *) handle, callback,
+        arg, out_struct, &flags, &payload_size, &sent);
+    if (ret != HG_SUCCESS || sent)
+        return ret;
+
+    /* Send response back */
+    ret = HG_Core_respond(
+        handle->core_handle, hg_core_respond_cb, handle, flags, payload_size);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not respond (%s)", HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1733,53 +5863,67 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Create(
-    hg_context_t *context, hg_addr_t addr, hg_id_t id, hg_handle_t *handle_p)
+static hg_return_t
+hg_respond_prepare(struct hg_private_handle *hg_handle, hg_cb_t callback,
+    void *arg, void *out_struct, hg_uint8_t *flags_p, hg_size_t *payload_size_p,
+    hg_bool_t *sent_p)
 {
-    struct hg_private_handle *hg_handle = NULL;
-    hg_core_handle_t core_handle = HG_CORE_HANDLE_NULL;
+    const struct hg_proc_info *hg_proc_info;
+    hg_size_t payload_size;
+    hg_bool_t more_data = HG_FALSE;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(
-        rpc, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
-
-    /* Create HG core handle (calls handle_create_cb) */
-    ret = HG_Core_create(
-        context->core_context, (hg_core_addr_t) addr, id, &core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
-        "Cannot create HG handle with ID %" PRIu64 " (%s)", id,
-        HG_Error_to_string(ret));
+    *sent_p = HG_FALSE;
 
-    /* Get data and HG info */
-    hg_handle = (struct hg_private_handle *) HG_Core_get_data(core_handle);
-    HG_CHECK_SUBSYS_ERROR(
-        rpc, hg_handle == NULL, error, ret, HG_INVALID_ARG, "NULL handle");
-    hg_handle->handle.info.addr = addr;
-    hg_handle->handle.info.id = id;
+    /* Set callback data */
+    hg_handle->respond_cb = callback;
+    hg_handle->respond_arg = arg;
 
-    *handle_p = (hg_handle_t) hg_handle;
+    /* Retrieve RPC data */
+    hg_proc_info = (const struct hg_proc_info *) HG_Core_get_rpc_data(
+        hg_handle->handle.core_handle);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
+        "Could not get proc info");
 
-    return HG_SUCCESS;
+#ifndef HG_HAS_XDR
+    /* Tree nodes respond once their subtree has responded */
+    if (hg_handle->multi_node != NULL) {
+        *sent_p = HG_TRUE;
+        return hg_multi_node_respond(hg_handle, hg_proc_info, out_struct);
+    }
+#endif
 
-error:
-    (void) HG_Core_destroy(core_handle);
+    /* Pass output by value when responding to ourself if allowed */
+    hg_handle->out_shared = out_struct != NULL &&
+                            hg_proc_info->shared_out_size > 0 &&
+                            HG_Core_is_self(hg_handle->handle.core_handle);
+    if (hg_handle->out_shared) {
+        ret = hg_shared_copy(&hg_handle->shared_out,
+            &hg_handle->shared_out_alloc, out_struct,
+            hg_proc_info->shared_out_size);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not share output");
+    }
 
-    return ret;
-}
+    /* Set output struct */
+    ret = hg_set_struct(hg_handle, hg_proc_info, HG_OUTPUT,
+        hg_handle->out_shared ? NULL : out_struct, &payload_size, &more_data);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not set output (%s)", HG_Error_to_string(ret));
 
-/*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Destroy(hg_handle_t handle)
-{
-    hg_return_t ret;
+    /* Response is sent once the output has been pushed to the origin */
+    if (hg_handle->out_region_push) {
+        hg_handle->respond_size = payload_size;
+        ret = hg_out_region_push(hg_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+            "Could not push output (%s)", HG_Error_to_string(ret));
 
-    if (handle == HG_HANDLE_NULL)
+        *sent_p = HG_TRUE;
         return HG_SUCCESS;
+    }
 
-    ret = HG_Core_destroy(handle->core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
-        "Could not set handle to be destroyed (%s)", HG_Error_to_string(ret));
+    /* Set more data flag on handle so that handle_more_callback is triggered */
+    *flags_p = more_data ? HG_CORE_MORE_DATA : 0;
+    *payload_size_p = payload_size;
 
     return HG_SUCCESS;
 
@@ -1789,72 +5933,103 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Reset(hg_handle_t handle, hg_addr_t addr, hg_id_t id)
+HG_Respond_batch(hg_handle_t handles[], unsigned int count, hg_cb_t callback,
+    void *arg, void *out_structs[], hg_return_t rets[])
 {
-    struct hg_private_handle *private_handle =
-        (struct hg_private_handle *) handle;
-    hg_return_t ret;
-
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-
-    /* Call core reset */
-    ret = HG_Core_reset(handle->core_handle, (hg_core_addr_t) addr, id);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
-        "Could not reset core HG handle (%s)", HG_Error_to_string(ret));
-
-    /* Set info */
-    private_handle->handle.info.addr = addr;
-    private_handle->handle.info.id = id;
-    private_handle->handle.info.context_id = 0;
+    hg_core_handle_t core_handles[HG_RESPOND_BATCH_MAX];
+    void *args[HG_RESPOND_BATCH_MAX];
+    hg_uint8_t flags[HG_RESPOND_BATCH_MAX];
+    hg_size_t payload_sizes[HG_RESPOND_BATCH_MAX];
+    unsigned int indices[HG_RESPOND_BATCH_MAX];
+    unsigned int i, batch_count = 0;
+    hg_return_t ret = HG_SUCCESS, ret_batch;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, count > 0 && handles == NULL, done, ret,
+        HG_INVALID_ARG, "NULL array of handles");
+
+    for (i = 0; i < count; i++) {
+        hg_return_t ret_handle;
+        hg_bool_t sent = HG_FALSE;
+
+        if (handles[i] == HG_HANDLE_NULL)
+            ret_handle = HG_INVALID_ARG;
+        else
+            ret_handle = hg_respond_prepare(
+                (struct hg_private_handle *) handles[i], callback, arg,
+                (out_structs != NULL) ? out_structs[i] : NULL,
+                &flags[batch_count], &payload_sizes[batch_count], &sent);
+        if (ret_handle != HG_SUCCESS || sent) {
+            HG_CHECK_SUBSYS_WARNING(rpc, ret_handle != HG_SUCCESS,
+                "Could not respond on handle (%p) (%s)", (void *) handles[i],
+                HG_Error_to_string(ret_handle));
+            if (rets != NULL)
+                rets[i] = ret_handle;
+            if (ret == HG_SUCCESS)
+                ret = ret_handle;
+            continue;
+        }
+
+        core_handles[batch_count] = handles[i]->core_handle;
+        args[batch_count] = handles[i];
+        indices[batch_count] = i;
+        if (++batch_count == HG_RESPOND_BATCH_MAX) {
+            ret_batch = hg_respond_batch_post(core_handles, args, flags,
+                payload_sizes, indices, batch_count, rets);
+            if (ret == HG_SUCCESS)
+                ret = ret_batch;
+            batch_count = 0;
+        }
+    }
 
-    return HG_SUCCESS;
+    if (batch_count > 0) {
+        ret_batch = hg_respond_batch_post(core_handles, args, flags,
+            payload_sizes, indices, batch_count, rets);
+        if (ret == HG_SUCCESS)
+            ret = ret_batch;
+    }
 
-error:
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_return_t
-HG_Get_input(hg_handle_t handle, void *in_struct)
+static hg_return_t
+hg_respond_batch_post(hg_core_handle_t core_handles[], void *args[],
+    const hg_uint8_t flags[], const hg_size_t payload_sizes[],
+    const unsigned int indices[], unsigned int count, hg_return_t rets[])
 {
-    const struct hg_proc_info *hg_proc_info;
+    hg_return_t core_rets[HG_RESPOND_BATCH_MAX];
     hg_return_t ret;
+    unsigned int i;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, in_struct == NULL, error, ret, HG_INVALID_ARG,
-        "NULL pointer to input struct");
-
-    /* Retrieve RPC data */
-    hg_proc_info =
-        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
-        "Could not get proc info");
-
-    /* Get input struct */
-    ret = hg_get_struct(
-        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_struct);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not get input (%s)", HG_Error_to_string(ret));
+    ret = HG_Core_respond_batch(core_handles, count, hg_core_respond_cb, args,
+        flags, payload_sizes, core_rets);
+    HG_CHECK_SUBSYS_WARNING(rpc, ret != HG_SUCCESS,
+        "Could not respond on all handles (%s)", HG_Error_to_string(ret));
 
-    return HG_SUCCESS;
+    if (rets != NULL)
+        for (i = 0; i < count; i++)
+            rets[indices[i]] = core_rets[i];
 
-error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Free_input(hg_handle_t handle, void *in_struct)
+HG_Respond_partial(
+    hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct)
 {
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
     const struct hg_proc_info *hg_proc_info;
+    hg_size_t payload_size;
+    hg_bool_t more_data = HG_FALSE;
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
         HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, in_struct == NULL, error, ret, HG_INVALID_ARG,
-        "NULL pointer to input struct");
+    HG_CHECK_SUBSYS_ERROR(rpc, private_handle->multi_node != NULL, error, ret,
+        HG_OPNOTSUPPORTED, "Cannot stream responses through a tree");
 
     /* Retrieve RPC data */
     hg_proc_info =
@@ -1862,11 +6037,28 @@ HG_Free_input(hg_handle_t handle, void *in_struct)
     HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
         "Could not get proc info");
 
-    /* Free input struct */
-    ret = hg_free_struct(
-        (struct hg_private_handle *) handle, hg_proc_info, HG_INPUT, in_struct);
+    /* Set output struct */
+    private_handle->out_shared = HG_FALSE;
+    ret = hg_set_struct(private_handle, hg_proc_info, HG_OUTPUT, out_struct,
+        &payload_size, &more_data);
     HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not free input (%s)", HG_Error_to_string(ret));
+        rpc, error, ret, "Could not set output (%s)", HG_Error_to_string(ret));
+
+    /* Partial responses are only sent through the output buffer */
+    if (more_data || private_handle->out_region_push) {
+        hg_free_extra_output(private_handle);
+        HG_GOTO_SUBSYS_ERROR(rpc, error, ret, HG_MSGSIZE,
+            "Partial response exceeds output buffer");
+    }
+
+    /* Set callback data */
+    private_handle->partial_cb = callback;
+    private_handle->partial_arg = arg;
+
+    ret = HG_Core_respond_partial(
+        handle->core_handle, hg_core_partial_cb, handle, payload_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not respond partially (%s)", HG_Error_to_string(ret));
 
     return HG_SUCCESS;
 
@@ -1876,59 +6068,96 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_output(hg_handle_t handle, void *out_struct)
+HG_Forward_multi(hg_context_t *context, hg_id_t id, const hg_addr_t *addrs,
+    unsigned int count, unsigned int tree_arity, hg_cb_t callback, void *arg,
+    void *in_struct, hg_multi_t *multi_p)
 {
-    const struct hg_proc_info *hg_proc_info;
+    const struct hg_proc_info *hg_proc_info = NULL;
+    struct hg_multi *multi = NULL;
+    unsigned int posted = 0;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, out_struct == NULL, error, ret, HG_INVALID_ARG,
-        "NULL pointer to output struct");
+    HG_CHECK_SUBSYS_ERROR(rpc, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG context");
+    HG_CHECK_SUBSYS_ERROR(rpc, addrs == NULL || count == 0, error, ret,
+        HG_INVALID_ARG, "No target addresses");
+    HG_CHECK_SUBSYS_ERROR(rpc, multi_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to fan-out operation");
 
     /* Retrieve RPC data */
-    hg_proc_info =
-        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
-        "Could not get proc info");
+    hg_proc_info = (const struct hg_proc_info *) HG_Core_registered_data(
+        context->hg_class->core_class, id);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not get registered data for RPC ID %" PRIu64, id);
 
-    /* Get output struct */
-    ret = hg_get_struct((struct hg_private_handle *) handle, hg_proc_info,
-        HG_OUTPUT, out_struct);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not get output (%s)", HG_Error_to_string(ret));
+#ifdef HG_HAS_XDR
+    HG_CHECK_SUBSYS_ERROR(rpc, tree_arity > 0, error, ret, HG_OPNOTSUPPORTED,
+        "Tree forwarding is not supported with XDR");
+#endif
+
+    ret = hg_multi_create(context, hg_proc_info, id, count, tree_arity, &multi);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not create fan-out operation (%s)", HG_Error_to_string(ret));
+    multi->callback = callback;
+    multi->arg = arg;
+
+    if (tree_arity == 0)
+        hg_multi_forward_direct(multi, addrs, in_struct, &posted);
+#ifndef HG_HAS_XDR
+    else {
+        ret = hg_multi_set_addrs(multi, addrs);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+            "Could not set target addresses (%s)", HG_Error_to_string(ret));
+
+        /* Input is encoded once and relayed as is */
+        ret = hg_multi_encode(multi->proc, NULL, 0, hg_proc_info->in_proc_cb,
+            hg_proc_info->varint, in_struct, &multi->in_buf,
+            &multi->in_buf_size);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode input (%s)",
+            HG_Error_to_string(ret));
+
+        hg_multi_tree_forward(multi, 0, addrs, &posted);
+    }
+#endif
+
+    /* Nothing is pending if no target could be reached */
+    if (posted == 0) {
+        ret = multi->targets[0].ret;
+        goto error;
+    }
+
+    *multi_p = (hg_multi_t) multi;
+
+    /* Release reference held while forwarding */
+    (void) hg_multi_complete(multi);
 
     return HG_SUCCESS;
 
 error:
+    hg_multi_free(multi);
+
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+unsigned int
+HG_Multi_get_count(hg_multi_t multi)
+{
+    return (multi != NULL) ? multi->count : 0;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Free_output(hg_handle_t handle, void *out_struct)
+HG_Multi_get_ret(hg_multi_t multi, unsigned int index)
 {
-    const struct hg_proc_info *hg_proc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, out_struct == NULL, error, ret, HG_INVALID_ARG,
-        "NULL pointer to output struct");
-
-    /* Retrieve RPC data */
-    hg_proc_info =
-        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
-        "Could not get proc info");
-
-    /* Free output struct */
-    ret = hg_free_struct((struct hg_private_handle *) handle, hg_proc_info,
-        HG_OUTPUT, out_struct);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not free output (%s)", HG_Error_to_string(ret));
+    HG_CHECK_SUBSYS_ERROR(rpc, multi == NULL, error, ret, HG_INVALID_ARG,
+        "NULL fan-out operation");
+    HG_CHECK_SUBSYS_ERROR(rpc, index >= multi->count, error, ret,
+        HG_INVALID_ARG, "Invalid target index (%u)", index);
 
-    return HG_SUCCESS;
+    return multi->targets[index].ret;
 
 error:
     return ret;
@@ -1936,28 +6165,40 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_input_buf(hg_handle_t handle, void **in_buf_p, hg_size_t *in_buf_size_p)
+HG_Multi_get_output(hg_multi_t multi, unsigned int index, void *out_struct)
 {
-    hg_size_t buf_size, header_offset = hg_header_get_size(HG_INPUT);
+    struct hg_multi_target *target;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, in_buf_p == NULL, error, ret, HG_INVALID_ARG,
-        "NULL input buffer pointer");
-
-    /* Get core input buffer */
-    /* Note: any extra header information will be transmitted with the
-     * control message, not the extra_buf, if the RPC exceeds the eager size
-     * limit.
-     */
-    ret = HG_Core_get_input(handle->core_handle, in_buf_p, &buf_size);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get input buffer (%s)",
-        HG_Error_to_string(ret));
-
-    *in_buf_p = (char *) *in_buf_p + header_offset;
-    if (in_buf_size_p)
-        *in_buf_size_p = buf_size - header_offset;
+    HG_CHECK_SUBSYS_ERROR(rpc, multi == NULL, error, ret, HG_INVALID_ARG,
+        "NULL fan-out operation");
+    HG_CHECK_SUBSYS_ERROR(rpc, index >= multi->count, error, ret,
+        HG_INVALID_ARG, "Invalid target index (%u)", index);
+    HG_CHECK_SUBSYS_ERROR(rpc, out_struct == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to output struct");
+    target = &multi->targets[index];
+    HG_CHECK_SUBSYS_ERROR(rpc, target->ret != HG_SUCCESS, error, ret,
+        target->ret, "Target %u did not complete (%s)", index,
+        HG_Error_to_string(target->ret));
+
+    if (multi->arity == 0) {
+        ret = HG_Get_output(target->handle, out_struct);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get output (%s)",
+            HG_Error_to_string(ret));
+    }
+#ifndef HG_HAS_XDR
+    else {
+        HG_CHECK_SUBSYS_ERROR(rpc, multi->hg_proc_info->reduce_cb != NULL,
+            error, ret, HG_OPNOTSUPPORTED,
+            "Outputs relayed through a tree were reduced");
+
+        /* Relayed outputs were kept encoded */
+        ret = hg_multi_decode_output(
+            multi, target->out_buf, target->out_buf_size, out_struct);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not get output (%s)",
+            HG_Error_to_string(ret));
+    }
+#endif
 
     return HG_SUCCESS;
 
@@ -1967,16 +6208,27 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Release_input_buf(hg_handle_t handle)
+HG_Multi_free_output(hg_multi_t multi, unsigned int index, void *out_struct)
 {
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, multi == NULL, error, ret, HG_INVALID_ARG,
+        "NULL fan-out operation");
+    HG_CHECK_SUBSYS_ERROR(rpc, index >= multi->count, error, ret,
+        HG_INVALID_ARG, "Invalid target index (%u)", index);
 
-    ret = HG_Core_release_input(handle->core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
-        "Could not release input buffer (%s)", HG_Error_to_string(ret));
+    if (multi->arity == 0) {
+        ret = HG_Free_output(multi->targets[index].handle, out_struct);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not free output (%s)",
+            HG_Error_to_string(ret));
+    }
+#ifndef HG_HAS_XDR
+    else {
+        ret = hg_multi_free_output(multi, out_struct);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not free output (%s)",
+            HG_Error_to_string(ret));
+    }
+#endif
 
     return HG_SUCCESS;
 
@@ -1986,29 +6238,25 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_output_buf(
-    hg_handle_t handle, void **out_buf_p, hg_size_t *out_buf_size_p)
+HG_Multi_get_reduced_output(hg_multi_t multi, void *out_struct)
 {
-    hg_size_t buf_size, header_offset = hg_header_get_size(HG_OUTPUT);
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, out_buf_p == NULL, error, ret, HG_INVALID_ARG,
-        "NULL output buffer pointer");
+    HG_CHECK_SUBSYS_ERROR(rpc, multi == NULL, error, ret, HG_INVALID_ARG,
+        "NULL fan-out operation");
+    HG_CHECK_SUBSYS_ERROR(rpc, out_struct == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to output struct");
+    HG_CHECK_SUBSYS_ERROR(rpc, multi->hg_proc_info->reduce_cb == NULL, error,
+        ret, HG_OPNOTSUPPORTED, "No reduce callback registered for RPC");
+    HG_CHECK_SUBSYS_ERROR(rpc, multi->reduced_buf == NULL, error, ret,
+        HG_NOENTRY, "No target output was reduced");
 
-    /* Get core output buffer */
-    /* Note: any extra header information will be transmitted with the
-     * control message, not the extra_buf, if the response exceeds the eager
-     * size limit.
-     */
-    ret = HG_Core_get_output(handle->core_handle, out_buf_p, &buf_size);
+#ifndef HG_HAS_XDR
+    ret = hg_multi_decode_output(
+        multi, multi->reduced_buf, multi->reduced_buf_size, out_struct);
     HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
-        "Could not get output buffer (%s)", HG_Error_to_string(ret));
-
-    *out_buf_p = (char *) *out_buf_p + header_offset;
-    if (out_buf_size_p)
-        *out_buf_size_p = buf_size - header_offset;
+        "Could not get reduced output (%s)", HG_Error_to_string(ret));
+#endif
 
     return HG_SUCCESS;
 
@@ -2018,22 +6266,20 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_input_extra_buf(
-    hg_handle_t handle, void **in_buf_p, hg_size_t *in_buf_size_p)
+HG_Multi_free_reduced_output(hg_multi_t multi, void *out_struct)
 {
-    struct hg_private_handle *private_handle =
-        (struct hg_private_handle *) handle;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, in_buf_p == NULL, error, ret, HG_INVALID_ARG,
-        "NULL input buffer pointer");
+    HG_CHECK_SUBSYS_ERROR(rpc, multi == NULL, error, ret, HG_INVALID_ARG,
+        "NULL fan-out operation");
+    HG_CHECK_SUBSYS_ERROR(rpc, multi->hg_proc_info->reduce_cb == NULL, error,
+        ret, HG_OPNOTSUPPORTED, "No reduce callback registered for RPC");
 
-    /* No offset if extra buffer since only the user payload is copied */
-    *in_buf_p = private_handle->in_extra_buf;
-    if (in_buf_size_p)
-        *in_buf_size_p = private_handle->in_extra_buf_size;
+#ifndef HG_HAS_XDR
+    ret = hg_multi_free_output(multi, out_struct);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not free reduced output (%s)", HG_Error_to_string(ret));
+#endif
 
     return HG_SUCCESS;
 
@@ -2043,141 +6289,74 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Get_output_extra_buf(
-    hg_handle_t handle, void **out_buf_p, hg_size_t *out_buf_size_p)
+HG_Multi_destroy(hg_multi_t multi)
 {
-    struct hg_private_handle *private_handle =
-        (struct hg_private_handle *) handle;
-    hg_return_t ret;
-
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, out_buf_p == NULL, error, ret, HG_INVALID_ARG,
-        "NULL output buffer pointer");
-
-    /* No offset if extra buffer since only the user payload is copied */
-    *out_buf_p = private_handle->out_extra_buf;
-    if (out_buf_size_p)
-        *out_buf_size_p = private_handle->out_extra_buf_size;
+    hg_multi_free(multi);
 
     return HG_SUCCESS;
-
-error:
-    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
+HG_Progress(hg_context_t *context, unsigned int timeout)
 {
-    struct hg_private_handle *private_handle =
-        (struct hg_private_handle *) handle;
-    const struct hg_proc_info *hg_proc_info = NULL;
-    hg_size_t payload_size = 0;
-    hg_bool_t more_data = HG_FALSE;
-    hg_uint8_t flags = 0;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-    HG_CHECK_SUBSYS_ERROR(rpc, handle->info.addr == HG_ADDR_NULL, error, ret,
-        HG_INVALID_ARG, "NULL target addr");
-
-    /* Set callback data */
-    private_handle->forward_cb = callback;
-    private_handle->forward_arg = arg;
-
-    /* Retrieve RPC data */
-    hg_proc_info =
-        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
-        "Could not get proc info");
-
-    /* Set input struct */
-    ret = hg_set_struct(private_handle, hg_proc_info, HG_INPUT, in_struct,
-        &payload_size, &more_data);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not set input (%s)", HG_Error_to_string(ret));
-
-    /* Set more data flag on handle so that handle_more_callback is triggered */
-    if (more_data)
-        flags |= HG_CORE_MORE_DATA;
-
-    /* Set no response flag if no response required */
-    if (hg_proc_info->no_response)
-        flags |= HG_CORE_NO_RESPONSE;
+    HG_CHECK_SUBSYS_ERROR(
+        poll, context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
 
-    /* Send request */
-    ret = HG_Core_forward(
-        handle->core_handle, hg_core_forward_cb, handle, flags, payload_size);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward call (%s)",
+    ret = HG_Core_progress(context->core_context, timeout);
+    HG_CHECK_SUBSYS_ERROR_NORET(poll, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+        done, "Could not make progress on context (%s)",
         HG_Error_to_string(ret));
 
-    return HG_SUCCESS;
-
-error:
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct)
+HG_Progress_multi(hg_context_t *contexts[], unsigned int count,
+    unsigned int timeout, hg_uint64_t *ready_p)
 {
-    struct hg_private_handle *private_handle =
-        (struct hg_private_handle *) handle;
-    const struct hg_proc_info *hg_proc_info;
-    hg_size_t payload_size;
-    hg_bool_t more_data = HG_FALSE;
-    hg_uint8_t flags = 0;
+    hg_core_context_t *core_contexts[64];
+    unsigned int i;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
-        HG_INVALID_ARG, "NULL HG handle");
-
-    /* Set callback data */
-    private_handle->respond_cb = callback;
-    private_handle->respond_arg = arg;
-
-    /* Retrieve RPC data */
-    hg_proc_info =
-        (const struct hg_proc_info *) HG_Core_get_rpc_data(handle->core_handle);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_proc_info == NULL, error, ret, HG_FAULT,
-        "Could not get proc info");
-
-    /* Set output struct */
-    ret = hg_set_struct(private_handle, hg_proc_info, HG_OUTPUT, out_struct,
-        &payload_size, &more_data);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not set output (%s)", HG_Error_to_string(ret));
-
-    /* Set more data flag on handle so that handle_more_callback is triggered */
-    if (more_data)
-        flags |= HG_CORE_MORE_DATA;
-
-    /* Send response back */
-    ret = HG_Core_respond(
-        handle->core_handle, hg_core_respond_cb, handle, flags, payload_size);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not respond (%s)", HG_Error_to_string(ret));
+    HG_CHECK_SUBSYS_ERROR(poll, contexts == NULL || count == 0, done, ret,
+        HG_INVALID_ARG, "NULL HG contexts");
+    HG_CHECK_SUBSYS_ERROR(poll,
+        count > sizeof(core_contexts) / sizeof(core_contexts[0]), done, ret,
+        HG_INVALID_ARG, "Number of contexts (%u) exceeds max", count);
+    for (i = 0; i < count; i++) {
+        HG_CHECK_SUBSYS_ERROR(poll, contexts[i] == NULL, done, ret,
+            HG_INVALID_ARG, "NULL HG context");
+        core_contexts[i] = contexts[i]->core_context;
+    }
 
-    return HG_SUCCESS;
+    ret = HG_Core_progress_multi(core_contexts, count, timeout, ready_p);
+    HG_CHECK_SUBSYS_ERROR_NORET(poll, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+        done, "Could not make progress on contexts (%s)",
+        HG_Error_to_string(ret));
 
-error:
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Progress(hg_context_t *context, unsigned int timeout)
+HG_Trigger(hg_context_t *context, unsigned int timeout, unsigned int max_count,
+    unsigned int *actual_count_p)
 {
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(
         poll, context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
 
-    ret = HG_Core_progress(context->core_context, timeout);
+    ret = HG_Core_trigger(
+        context->core_context, timeout, max_count, actual_count_p);
     HG_CHECK_SUBSYS_ERROR_NORET(poll, ret != HG_SUCCESS && ret != HG_TIMEOUT,
-        done, "Could not make progress on context (%s)",
+        done, "Could not trigger operations from context (%s)",
         HG_Error_to_string(ret));
 
 done:
@@ -2186,16 +6365,17 @@ done:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Trigger(hg_context_t *context, unsigned int timeout, unsigned int max_count,
-    unsigned int *actual_count_p)
+HG_Trigger_batch(hg_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count_p,
+    unsigned int *remaining_count_p)
 {
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(
         poll, context == NULL, done, ret, HG_INVALID_ARG, "NULL HG context");
 
-    ret = HG_Core_trigger(
-        context->core_context, timeout, max_count, actual_count_p);
+    ret = HG_Core_trigger_batch(context->core_context, timeout, max_count,
+        actual_count_p, remaining_count_p);
     HG_CHECK_SUBSYS_ERROR_NORET(poll, ret != HG_SUCCESS && ret != HG_TIMEOUT,
         done, "Could not trigger operations from context (%s)",
         HG_Error_to_string(ret));
@@ -2222,3 +6402,48 @@ HG_Cancel(hg_handle_t handle)
 error:
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Set_timeout(hg_handle_t handle, unsigned int timeout_ms)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+
+    ret = HG_Core_set_timeout(handle->core_handle, timeout_ms);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not set timeout (%s)",
+        HG_Error_to_string(ret));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Set_stream(
+    hg_handle_t handle, hg_cb_t callback, void *arg, unsigned int credits)
+{
+    struct hg_private_handle *private_handle =
+        (struct hg_private_handle *) handle;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG handle");
+
+    ret = HG_Core_set_stream(handle->core_handle,
+        (credits > 0) ? hg_core_stream_cb : NULL, private_handle, credits);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not set stream (%s)",
+        HG_Error_to_string(ret));
+
+    private_handle->stream_cb = callback;
+    private_handle->stream_arg = arg;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
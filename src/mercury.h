@@ -296,6 +296,67 @@ HG_Class_set_data(
 static HG_INLINE void *
 HG_Class_get_data(const hg_class_t *hg_class);
 
+/**
+ * Retrieve stats of a registered RPC ID, see HG_Core_class_get_stats(). Stats
+ * are always collected and can be retrieved at any time, e.g., to tell whether
+ * tail latency comes from the network, from the progress loop or from the RPC
+ * callback.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param stats [OUT]           pointer to returned stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Class_get_stats(
+    hg_class_t *hg_class, hg_id_t id, struct hg_rpc_stats *stats);
+
+/**
+ * Retrieve traffic exchanged with a peer, see HG_Core_class_get_peer_stats().
+ * Per-peer counters must be enabled through the peer_stats_max init info
+ * field.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addr [IN]             abstract address of peer
+ * \param stats [OUT]           pointer to returned stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Class_get_peer_stats(
+    hg_class_t *hg_class, hg_addr_t addr, struct hg_peer_stats *stats);
+
+/**
+ * Retrieve the peers that exchanged the most RPCs with that class, see
+ * HG_Core_class_get_hot_peers(). Returned addresses must be freed with
+ * HG_Addr_free().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addrs [OUT]           array of returned addresses
+ * \param stats [OUT]           array of returned stats of each address
+ * \param count_p [IN/OUT]      pointer to number of entries in arrays, set
+ *                              to the number of peers returned
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Class_get_hot_peers(hg_class_t *hg_class, hg_addr_t *addrs,
+    struct hg_peer_stats *stats, unsigned int *count_p);
+
+/**
+ * Estimate a percentile of a histogram returned in RPC stats, see
+ * HG_Core_stats_percentile().
+ *
+ * \param histogram [IN]        pointer to histogram
+ * \param percentile [IN]       percentile between 0 and 100 (e.g., 99.9)
+ *
+ * \return Value or 0 if histogram is empty
+ */
+static HG_INLINE hg_uint64_t
+HG_Stats_percentile(
+    const struct hg_stats_histogram *histogram, double percentile);
+
 /**
  * Set callback to be called on HG handle creation. Handles are created
  * both on HG_Create() and HG_Context_create() calls. This allows upper layers
@@ -312,6 +373,74 @@ HG_PUBLIC hg_return_t
 HG_Class_set_handle_create_callback(hg_class_t *hg_class,
     hg_return_t (*callback)(hg_handle_t, void *), void *arg);
 
+/**
+ * Reserve a private area of size bytes in each HG handle, see
+ * HG_Get_private_area(). The area is allocated along with the handle and
+ * suitably aligned for any type. It is zeroed when the handle is created and
+ * each time it is reset (i.e., when it is re-posted to the pool of handles
+ * or on HG_Reset()), so that per-RPC state does not need to be allocated.
+ *
+ * 
+emark Must be called before any context is created.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param size [IN]             size of private area (0 to disable)
+ *
+ * 
+eturn HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Class_set_private_area_size(hg_class_t *hg_class, hg_size_t size);
+
+/**
+ * Set callback to be called on each trace event of an RPC, see
+ * HG_Core_class_set_trace_callback(). The trace context passed on
+ * HG_TRACE_FORWARD can be filled by the callback (e.g., with a trace and a
+ * span ID) and is received by the target on HG_TRACE_RECV and subsequent
+ * events. Passing a NULL callback disables tracing, without any cost on the
+ * RPC path.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Class_set_trace_callback(
+    hg_class_t *hg_class, hg_trace_cb_t callback, void *arg);
+
+/**
+ * Capture RPCs processed by the class to a binary file (RPC ID, payload and
+ * bulk sizes, arrival and callback times), see HG_Core_class_set_capture().
+ * Passing a NULL path stops the capture.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param path [IN]             path of capture file
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Class_set_capture(hg_class_t *hg_class, const char *path);
+
+/**
+ * Set callback to be called when the transport reports a peer as no longer
+ * reachable, see HG_Core_class_set_peer_error_callback(). Forwards still
+ * pending to that peer are completed with HG_HOSTUNREACH before the callback
+ * is made, a typical callback then calls HG_Addr_purge() on the addresses
+ * that match (HG_Addr_cmp()) so that further RPCs reconnect or fail early.
+ * The address passed is only valid for the duration of the callback.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Class_set_peer_error_callback(
+    hg_class_t *hg_class, hg_peer_error_cb_t callback, void *arg);
+
 /**
  * Create a new context. Must be destroyed by calling HG_Context_destroy().
  *
@@ -346,6 +475,24 @@ HG_Context_create(hg_class_t *hg_class);
 HG_PUBLIC hg_context_t *
 HG_Context_create_id(hg_class_t *hg_class, hg_uint8_t id);
 
+/**
+ * Same as HG_Context_create_id() but place the context on the CPUs or NUMA
+ * node given by \info. Context memory (handles, pre-posted buffers, NA
+ * resources) is allocated locally and the execution model started with
+ * HG_Context_exec_start() runs on these CPUs. A warning is emitted if the
+ * network device is on a different NUMA node.
+ * Context must be destroyed by calling HG_Context_destroy().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               user-defined context ID
+ * \param info [IN]             optional context info (NULL for none)
+ *
+ * \return Pointer to HG context or NULL in case of failure
+ */
+HG_PUBLIC hg_context_t *
+HG_Context_create_opt(
+    hg_class_t *hg_class, hg_uint8_t id, const struct hg_context_info *info);
+
 /**
  * Destroy a context created by HG_Context_create(). If listening and
  * HG_Context_unpost() has not already been called, also cancels previously
@@ -358,6 +505,24 @@ HG_Context_create_id(hg_class_t *hg_class, hg_uint8_t id);
 HG_PUBLIC hg_return_t
 HG_Context_destroy(hg_context_t *context);
 
+/**
+ * Destroy several contexts at once (see HG_Context_destroy()). Posted
+ * requests of all contexts are canceled first and their completion is waited
+ * on together, so that teardown of many contexts is not serialized. If
+ * \quiescent is set, the caller guarantees that no user handle is still in
+ * use and the corresponding waits are skipped.
+ * On failure, entries of contexts that were destroyed are set to NULL.
+ *
+ * \param contexts [IN/OUT]     array of HG contexts
+ * \param count [IN]            number of contexts
+ * \param quiescent [IN]        skip waits on user handles
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Context_destroy_multi(
+    hg_context_t *contexts[], unsigned int count, hg_bool_t quiescent);
+
 /**
  * Unpost pre-posted requests if listening. This prevents any further RPCs
  * from being received by that context.
@@ -369,6 +534,35 @@ HG_Context_destroy(hg_context_t *context);
 HG_PUBLIC hg_return_t
 HG_Context_unpost(hg_context_t *context);
 
+/**
+ * Start a built-in execution model on the given context: a dedicated thread
+ * makes progress and triggers callbacks, RPC callbacks of RPCs set with
+ * HG_Registered_offload() are run by a pool of handler threads so that long
+ * handlers do not delay other completions. Other RPC callbacks are run
+ * inline by the progress thread. HG_Progress() and HG_Trigger() must not be
+ * called on that context until HG_Context_exec_stop() returns. The execution
+ * model cannot be started on classes initialized with single_thread.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param info [IN]             pointer to execution info (NULL for defaults)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Context_exec_start(hg_context_t *context, const struct hg_exec_info *info);
+
+/**
+ * Stop the execution model started by HG_Context_exec_start(). Offloaded RPC
+ * callbacks that are queued are run before the handler pool exits. Called by
+ * HG_Context_destroy() if needed.
+ *
+ * \param context [IN]          pointer to HG context
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Context_exec_stop(hg_context_t *context);
+
 /**
  * Retrieve the class used to create the given context.
  *
@@ -389,6 +583,58 @@ HG_Context_get_class(const hg_context_t *context);
 static HG_INLINE hg_uint8_t
 HG_Context_get_id(const hg_context_t *context);
 
+/**
+ * Retrieve the current amount of time that progress may busy-spin on that
+ * context before blocking (see progress_spin_max init info).
+ *
+ * \param context [IN]          pointer to HG context
+ *
+ * \return Spin budget in microseconds or 0 if progress does not spin
+ */
+static HG_INLINE unsigned int
+HG_Context_get_spin_budget(const hg_context_t *context);
+
+/**
+ * Retrieve progress loop stats of a context, see
+ * HG_Core_context_get_progress_stats().
+ *
+ * \param context [IN]          pointer to HG context
+ * \param stats [OUT]           pointer to returned stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Context_get_progress_stats(
+    const hg_context_t *context, struct hg_progress_stats *stats);
+
+/**
+ * Retrieve stats of the pools of handles of a context, see
+ * HG_Core_context_get_handle_stats().
+ *
+ * \param context [IN]          pointer to HG context
+ * \param stats [OUT]           pointer to returned stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Context_get_handle_stats(
+    const hg_context_t *context, struct hg_handle_stats *stats);
+
+/**
+ * Retrieve the number of outstanding handles of a context for a given RPC ID
+ * and the age of the oldest one, see HG_Core_context_get_handle_age().
+ *
+ * \param context [IN]          pointer to HG context
+ * \param id [IN]               registered function ID (0 for any ID)
+ * \param count_p [OUT]         pointer to number of outstanding handles
+ * \param age_p [OUT]           pointer to age of the oldest handle (ns)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+static HG_INLINE hg_return_t
+HG_Context_get_handle_age(const hg_context_t *context, hg_id_t id,
+    hg_uint32_t *count_p, hg_uint64_t *age_p);
+
 /**
  * Associate user data to context. When HG_Context_destroy() is called,
  * free_callback (if defined) is called to free the associated data.
@@ -565,6 +811,237 @@ HG_PUBLIC hg_return_t
 HG_Registered_disabled_response(
     hg_class_t *hg_class, hg_id_t id, hg_bool_t *disabled_p);
 
+/**
+ * Set default timeout of forwards of RPC ID, see HG_Set_timeout().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param timeout_ms [IN]       timeout in ms (0 for no timeout)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_set_timeout(
+    hg_class_t *hg_class, hg_id_t id, unsigned int timeout_ms);
+
+/**
+ * Exempt requests of RPC ID from admission control, these requests are then
+ * never rejected with HG_BUSY when the context is overloaded (e.g., health
+ * checks or control RPCs). See hg_init_info::admission_queue_max.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param bypass [IN]           boolean (HG_TRUE to always admit requests)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_bypass_admission(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t bypass);
+
+/**
+ * Never coalesce requests of RPC ID with other requests, see
+ * HG_Core_registered_disable_coalescing().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param disable [IN]          boolean (HG_TRUE to disable coalescing)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_disable_coalescing(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t disable);
+
+/**
+ * Run the RPC callback of RPC ID in the handler pool of contexts that use
+ * the built-in execution model (see HG_Context_exec_start()). This should
+ * be set on RPCs whose callback blocks or runs for long. The RPC callback is
+ * run inline on contexts that do not have a handler pool.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param offload [IN]          boolean (HG_TRUE to offload RPC callback)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_offload(hg_class_t *hg_class, hg_id_t id, hg_bool_t offload);
+
+/**
+ * Pass input and output structures of RPC ID by value when forwarding to
+ * ourself through the loopback interface instead of encoding and decoding
+ * them. HG_Forward() and HG_Respond() then copy the struct as is and
+ * HG_Get_input() / HG_Get_output() return that copy, so that pointers that
+ * it contains reference the memory of the caller (HG_Free_input() and
+ * HG_Free_output() do not free anything). This must only be set on types
+ * whose referenced memory remains valid until the RPC callback has executed
+ * (input) and until the forward callback has executed (output). Structures
+ * of RPCs that are not forwarded to ourself are encoded as usual.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param in_struct_size [IN]   size of input struct (0 to encode input)
+ * \param out_struct_size [IN]  size of output struct (0 to encode output)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_share_self(hg_class_t *hg_class, hg_id_t id,
+    hg_size_t in_struct_size, hg_size_t out_struct_size);
+
+/**
+ * Set priority class of RPC ID, see HG_Core_registered_set_priority(). This
+ * should be used for failure-detector heartbeats and other RPCs that must
+ * keep flowing under load. The priority must be set on both origin and
+ * target.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param prio [IN]             priority class
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_set_priority(hg_class_t *hg_class, hg_id_t id, hg_prio_t prio);
+
+/**
+ * Compute the encoded size of the input and output structures of a given RPC
+ * ID before encoding them. Proc callbacks are first called with HG_SIZE so
+ * that, when the payload does not fit into the RPC buffer, the extra buffer
+ * is allocated once at its final size rather than grown while encoding. This
+ * is beneficial for RPCs with large variable-size payloads but requires all
+ * proc callbacks of that RPC to support HG_SIZE (mercury's own procs do).
+ * This option has no effect with XDR.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param enable [IN]           boolean (HG_TRUE to enable
+ *                                       HG_FALSE to disable)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_precompute_size(
+    hg_class_t *hg_class, hg_id_t id, hg_bool_t enable);
+
+/**
+ * Encode unsigned 32-bit and 64-bit integers (including hg_size_t and
+ * hg_id_t fields) of the input and output structures of a given RPC ID as
+ * LEB128 varints (see hg_proc_uint32_varint()) instead of fixed-size values,
+ * so that small values only take one or two bytes. Origin and target must
+ * both enable that option for the RPC. This option has no effect with XDR.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param enable [IN]           boolean (HG_TRUE to enable
+ *                                       HG_FALSE to disable)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_encode_varint(hg_class_t *hg_class, hg_id_t id, hg_bool_t enable);
+
+/**
+ * Set the amount of read-only bulk data that may be embedded along with the
+ * bulk descriptors of the input and output structures of a given RPC ID
+ * (eager bulk), overriding hg_init_info::no_bulk_eager for that RPC. The
+ * other fields are sized first and data is only embedded within the space
+ * that they leave in the eager buffer, up to max_size bytes in total for
+ * all the bulk handles of the payload, so that small transfers complete
+ * along with the RPC instead of requiring an additional RMA operation.
+ * Bulk handles whose data does not fit are sent as descriptors only. A
+ * max_size of 0 disables eager bulk for the RPC, HG_SIZE_MAX only limits
+ * embedded data to the space left. Enabling this option adds a sizing pass
+ * to the encoding of each payload, with XDR only max_size is enforced.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param max_size [IN]         max size of embedded bulk data
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_bulk_eager(hg_class_t *hg_class, hg_id_t id, hg_size_t max_size);
+
+/**
+ * Let the origin advertise a registered output region of size bytes in the
+ * requests of a given RPC ID. Outputs that do not fit into the response
+ * message but fit into the region are RMA-written to it by the target, the
+ * response message that follows only completes the RPC and the origin
+ * decodes the output from the region instead of pulling it with an extra
+ * RMA operation. The region is allocated on first forward and kept by the
+ * handle, it is charged to the memory budget of the class. Compressed
+ * outputs, RPCs relayed through a tree and calls to self do not use it. As
+ * the region is advertised along with the input, the RPC must have an input
+ * proc and be forwarded with an input struct. A size of 0 disables the
+ * option, which is not supported with XDR.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param size [IN]             size of output region
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_out_region(hg_class_t *hg_class, hg_id_t id, hg_size_t size);
+
+/**
+ * Compress the encoded input and output payloads of a given RPC ID that are
+ * at least threshold bytes (after being flushed and before being sent), the
+ * compressor ID is passed in the RPC header so that the target knows whether
+ * the payload must be decompressed. Origin and target must both register the
+ * same compressor for the RPC, the compressor must remain valid until the RPC
+ * is deregistered. Payloads that do not compress, payloads that keep
+ * references to user memory and RPCs forwarded to self are sent as is.
+ * Scratch buffers are taken from the extra buffer pool when it is enabled
+ * (see hg_init_info::extra_buf_pool_max). This option is not supported with
+ * XDR.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param compressor [IN]       pointer to compressor (NULL to disable)
+ * \param threshold [IN]        min payload size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_compress(hg_class_t *hg_class, hg_id_t id,
+    const struct hg_compressor *compressor, hg_size_t threshold);
+
+/**
+ * Reduce the outputs of a given RPC ID when it is forwarded with
+ * HG_Forward_multi(). Outputs are decoded into structures of out_struct_size
+ * bytes and combined two at a time by calling reduce_cb, which must fold
+ * out_struct into acc_struct without keeping references to memory owned by
+ * out_struct (it is freed right after). When forwarding through a tree,
+ * each node reduces the outputs of its subtree before responding so that a
+ * single output is sent upward, origin and targets must then all register
+ * the same reduce callback for the RPC. The reduced output can be retrieved
+ * with HG_Multi_get_reduced_output(), per-target outputs are only kept when
+ * forwarding directly. This option is not supported with XDR.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param reduce_cb [IN]        pointer to reduce callback (NULL to disable)
+ * \param out_struct_size [IN]  size of output structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Registered_reduce(hg_class_t *hg_class, hg_id_t id,
+    hg_reduce_cb_t reduce_cb, hg_size_t out_struct_size);
+
+/**
+ * Get a built-in compressor by name ("lz4", "zstd" or "snappy").
+ *
+ * \param name [IN]             compressor name
+ *
+ * \return Pointer to compressor or NULL if that compressor was not built
+ */
+HG_PUBLIC const struct hg_compressor *
+HG_Compressor_get(const char *name);
+
 /**
  * Lookup an addr from a peer address/name. Addresses need to be
  * freed by calling HG_Addr_free(). After completion, user callback is
@@ -600,7 +1077,52 @@ HG_Addr_lookup1(hg_context_t *context, hg_cb_t callback, void *arg,
  * \return HG_SUCCESS or corresponding HG error code
  */
 HG_PUBLIC hg_return_t
-HG_Addr_lookup2(hg_class_t *hg_class, const char *name, hg_addr_t *addr_p);
+HG_Addr_lookup2(hg_class_t *hg_class, const char *name, hg_addr_t *addr_p);
+
+/**
+ * Lookup a list of addrs from peer addresses/names, typically at startup when
+ * connecting to a large number of servers. Names that were already resolved
+ * are re-used, duplicate names are only resolved once and the remaining
+ * lookups are batched by the underlying NA plugin when supported. Addresses
+ * need to be freed by calling HG_Addr_free() on each entry of \addrs. A
+ * single user callback is placed into the completion queue once the entire
+ * list is resolved, the callback's lookup info does not carry an address.
+ *
+ * \param context [IN]          pointer to context of execution
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param names [IN]            array of lookup names
+ * \param count [IN]            number of names
+ * \param addrs [OUT]           array of count abstract addresses
+ * \param op_id_p [OUT]         pointer to returned operation ID (unused)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_lookup_multi(hg_context_t *context, hg_cb_t callback, void *arg,
+    const char *const *names, unsigned int count, hg_addr_t *addrs,
+    hg_op_id_t *op_id_p);
+
+/**
+ * Pre-warm a list of addrs so that connections, endpoints and other transport
+ * state get established ahead of the first RPC instead of on its critical
+ * path. This is a hint: the underlying NA plugin may have nothing to set up.
+ * A single user callback of type HG_CB_WARM is placed into the completion
+ * queue once the warm-up has been initiated for the entire list, the
+ * callback's lookup info does not carry an address.
+ *
+ * \param context [IN]          pointer to context of execution
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ * \param op_id_p [OUT]         pointer to returned operation ID (unused)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_warm(hg_context_t *context, hg_cb_t callback, void *arg,
+    const hg_addr_t *addrs, unsigned int count, hg_op_id_t *op_id_p);
 
 /**
  * Free the addr.
@@ -627,6 +1149,22 @@ HG_Addr_free(hg_class_t *hg_class, hg_addr_t addr);
 HG_PUBLIC hg_return_t
 HG_Addr_set_remove(hg_class_t *hg_class, hg_addr_t addr);
 
+/**
+ * Purge a list of dead peers at once, e.g., after a failure detector or a
+ * timed out heartbeat declared them dead. Forwards still pending to any of
+ * them, on any context, complete immediately with HG_HOSTUNREACH instead of
+ * waiting for a timeout, and each address is set to be removed (see
+ * HG_Addr_set_remove()). Addresses must still be freed with HG_Addr_free().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_purge(hg_class_t *hg_class, const hg_addr_t *addrs, unsigned int count);
+
 /**
  * Access self address. Address must be freed with HG_Addr_free().
  *
@@ -682,6 +1220,55 @@ HG_PUBLIC hg_return_t
 HG_Addr_to_string(
     hg_class_t *hg_class, char *buf, hg_size_t *buf_size_p, hg_addr_t addr);
 
+/**
+ * Get size required to serialize a list of addresses into an address book.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return Non-negative value
+ */
+HG_PUBLIC hg_size_t
+HG_Addr_get_book_size(
+    hg_class_t *hg_class, const hg_addr_t *addrs, unsigned int count);
+
+/**
+ * Serialize a list of addresses into a compact binary address book that can
+ * be exchanged in place of address strings during wire-up. Books produced by
+ * each peer can be concatenated (e.g., through a PMI or MPI allgather) and
+ * passed as a whole to HG_Addr_deserialize_book().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param buf [IN/OUT]          pointer to destination buffer
+ * \param buf_size [IN]         buffer size
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_serialize_book(hg_class_t *hg_class, void *buf, hg_size_t buf_size,
+    const hg_addr_t *addrs, unsigned int count);
+
+/**
+ * Deserialize one or more concatenated address books in one call. If addrs is
+ * NULL or the input value passed through count_p is smaller than the number
+ * of entries, HG_OVERFLOW is returned and the count_p output is set to the
+ * number of entries. Addresses need to be freed by calling HG_Addr_free().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param buf [IN]              pointer to buffer used for deserialization
+ * \param buf_size [IN]         buffer size
+ * \param addrs [OUT]           array of abstract addresses
+ * \param count_p [IN/OUT]      pointer to number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Addr_deserialize_book(hg_class_t *hg_class, const void *buf,
+    hg_size_t buf_size, hg_addr_t *addrs, unsigned int *count_p);
+
 /**
  * Initiate a new HG RPC using the specified function ID and the local/remote
  * target defined by addr. The HG handle created can be used to query input
@@ -710,6 +1297,24 @@ HG_Create(
 HG_PUBLIC hg_return_t
 HG_Destroy(hg_handle_t handle);
 
+/**
+ * Create a persistent handle for repeated calls of RPC ID to the same target.
+ * Target address, RPC ID and registered procs are bound once so that
+ * HG_Forward_persistent() only needs to encode the input payload, the request
+ * header is encoded once and re-used. Calling HG_Reset() on that handle
+ * removes the binding. Handle must be released with HG_Destroy().
+ *
+ * \param context [IN]          pointer to HG context
+ * \param addr [IN]             target address
+ * \param id [IN]               registered function ID
+ * \param handle_p [OUT]        pointer to HG handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Create_persistent(
+    hg_context_t *context, hg_addr_t addr, hg_id_t id, hg_handle_t *handle_p);
+
 /**
  * Reset an existing HG handle to make it reusable for RPC forwarding.
  * Both target address and RPC ID can be modified at this time.
@@ -780,6 +1385,17 @@ HG_Set_data(hg_handle_t handle, void *data, void (*free_callback)(void *));
 static HG_INLINE void *
 HG_Get_data(hg_handle_t handle);
 
+/**
+ * Retrieve private area of handle, see HG_Class_set_private_area_size().
+ *
+ * \param handle [IN]           HG handle
+ *
+ * 
+eturn Pointer to private area or NULL if no area was reserved
+ */
+static HG_INLINE void *
+HG_Get_private_area(hg_handle_t handle);
+
 /**
  * Get input from handle (requires registration of input proc to deserialize
  * parameters). Input must be freed using HG_Free_input().
@@ -805,6 +1421,10 @@ HG_Get_input(hg_handle_t handle, void *in_struct);
  * User may copy parameters contained in the input structure before calling
  * HG_Free_input().
  *
+ * \remark The input buffer is also released after that call if the
+ * release_input_on_free init info parameter has been set when initializing the
+ * HG class.
+ *
  * \param handle [IN]           HG handle
  * \param in_struct [IN/OUT]    pointer to input structure
  *
@@ -813,6 +1433,27 @@ HG_Get_input(hg_handle_t handle, void *in_struct);
 HG_PUBLIC hg_return_t
 HG_Free_input(hg_handle_t handle, void *in_struct);
 
+/**
+ * Get a proc positioned at the start of the encoded input of a handle so that
+ * input fields can be decoded on demand, in the order in which they were
+ * encoded, by calling the corresponding hg_proc routines on that proc (e.g.,
+ * to reject a request after looking at its first fields without having to
+ * decode the rest of the input). Decoding may stop at any point, the complete
+ * input can still be decoded afterwards with HG_Get_input().
+ *
+ * \remark The proc remains valid until the next call to HG_Get_input(), it
+ * must not be freed. Checksums are only verified by HG_Get_input(). Decoded
+ * fields that allocate memory must be freed by the caller, fields that do not
+ * (fixed-size fields, hg_borrowed_string_t, etc) are preferred.
+ *
+ * \param handle [IN]           HG handle
+ * \param in_proc_p [OUT]       pointer to input proc
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Get_input_proc(hg_handle_t handle, hg_proc_t *in_proc_p);
+
 /**
  * Get output from handle (requires registration of output proc to deserialize
  * parameters). Output must be freed using HG_Free_output().
@@ -966,6 +1607,10 @@ HG_Set_target_id(hg_handle_t handle, hg_uint8_t id);
  *   - Call hg_proc to serialize parameters
  *   - HG_Core_forward()
  *
+ * \remark When input_ref_threshold is set in the init info, memory that is
+ * referenced by large input fields is not copied and must remain valid until
+ * the user callback is triggered.
+ *
  * \param handle [IN]           HG handle
  * \param callback [IN]         pointer to function callback
  * \param arg [IN]              pointer to data passed to callback
@@ -976,6 +1621,72 @@ HG_Set_target_id(hg_handle_t handle, hg_uint8_t id);
 HG_PUBLIC hg_return_t
 HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct);
 
+/**
+ * Forward a call using a handle created with HG_Create_persistent(). This is
+ * equivalent to HG_Forward() but skips per-call lookups, only the input
+ * structure is serialized. As with HG_Forward(), the previous forward must
+ * have completed before the handle can be forwarded again.
+ *
+ * \param handle [IN]           persistent HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param in_struct [IN]        pointer to input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_persistent(
+    hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct);
+
+/**
+ * Encode input structure once into the input buffer of a handle created with
+ * HG_Create_persistent() and retain it, so that it can be sent many times
+ * with HG_Forward_retained() without running proc callbacks again (e.g.,
+ * polling or heartbeat RPCs). The encoded input is a snapshot: later changes
+ * to the input structure, including data of bulk handles embedded eagerly,
+ * are not seen. Inputs that do not fit in the input buffer cannot be
+ * retained. The retained input is dropped by HG_Forward(),
+ * HG_Forward_persistent() and HG_Reset().
+ *
+ * \param handle [IN]           persistent HG handle (not in use)
+ * \param in_struct [IN]        pointer to input structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Retain_input(hg_handle_t handle, void *in_struct);
+
+/**
+ * Forward the input retained by HG_Retain_input(). Only the request tag is
+ * generated again, proc callbacks are not run.
+ *
+ * \param handle [IN]           persistent HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_retained(hg_handle_t handle, hg_cb_t callback, void *arg);
+
+/**
+ * Forward a call like HG_Forward() and block until it completes, the calling
+ * thread makes progress and triggers callbacks of the handle's context as
+ * needed. If another thread is making progress on the context, or if the
+ * context uses the built-in execution model (see HG_Context_exec_start()),
+ * the calling thread sleeps until the call completes instead. The call is
+ * canceled if it has not completed after timeout_ms, in which case HG_TIMEOUT
+ * is returned once it is released.
+ *
+ * \param handle [IN]           HG handle
+ * \param in_struct [IN]        pointer to input structure
+ * \param timeout_ms [IN]       timeout in ms
+ *
+ * \return HG_SUCCESS, return code of the call or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_wait(hg_handle_t handle, void *in_struct, unsigned int timeout_ms);
+
 /**
  * Respond back to origin using an existing HG handle.
  * Output structure can be passed and parameters serialized using a previously
@@ -997,6 +1708,174 @@ HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct);
 HG_PUBLIC hg_return_t
 HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct);
 
+/**
+ * Respond back to the origins of several handles at once (e.g., when a
+ * single I/O completion finishes many requests), as if HG_Respond() was
+ * called on each of them. Outputs are serialized first and their sends are
+ * then posted together, grouped by destination, so that NA plugins can
+ * amortize the cost of posting them. Responses that could not be sent
+ * after being serialized are still completed through the callback with an
+ * error.
+ *
+ * \param handles [IN]          array of HG handles
+ * \param count [IN]            number of handles
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param out_structs [IN]      array of pointers to output structures
+ *                              (may be NULL if RPCs have no output)
+ * \param rets [OUT]            array of return codes of each response
+ *                              (may be NULL)
+ *
+ * \return HG_SUCCESS if all responses were posted or first error code
+ */
+HG_PUBLIC hg_return_t
+HG_Respond_batch(hg_handle_t handles[], unsigned int count, hg_cb_t callback,
+    void *arg, void *out_structs[], hg_return_t rets[]);
+
+/**
+ * Send a partial response to an origin that enabled streaming with
+ * HG_Set_stream(), HG_Respond() must then be called to send the final
+ * response. Output structure is serialized as with HG_Respond() but must fit
+ * in the eager output buffer (HG_MSGSIZE is returned otherwise). Only one
+ * partial response can be in flight at a time, user callback is placed into
+ * a completion queue once it has been sent and the next partial (or final)
+ * response can then be posted. Partial responses are held back while the
+ * origin has not consumed enough of the previous ones.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param out_struct [IN]       pointer to output structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Respond_partial(
+    hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct);
+
+/**
+ * Forward the same call to a list of local/remote targets. The input structure
+ * is serialized once using the input proc registered for id and the encoded
+ * payload is copied to each target, only targets that require a different
+ * encoding (shared-memory or self addresses) get their own. Once all targets
+ * have completed, user callback is placed into a completion queue with a
+ * callback type of HG_CB_FORWARD_MULTI and can be triggered using
+ * HG_Trigger(), its return value is the first error returned by a target.
+ * Per-target results can be queried using HG_Multi_get_ret() and
+ * HG_Multi_get_output(), the operation must then be released using
+ * HG_Multi_destroy().
+ *
+ * When tree_arity is non-zero, the origin only forwards to tree_arity targets
+ * that re-forward the call to their own subtree before executing it, so that
+ * the cost on the origin is O(log N) instead of O(N). Each target responds
+ * once its subtree has responded and outputs are relayed in their encoded
+ * form. Addresses are passed to targets as strings and must be reachable
+ * from every target, bulk handles that are part of input and output
+ * structures must be bound (see HG_Bulk_bind()) since they are relayed. Tree
+ * mode is not supported with XDR.
+ *
+ * \remark Memory referenced by the input structure must remain valid until
+ * the user callback is triggered.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param id [IN]               registered function ID
+ * \param addrs [IN]            array of target addresses
+ * \param count [IN]            number of target addresses
+ * \param tree_arity [IN]       arity of forwarding tree (0 for direct)
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param in_struct [IN]        pointer to input structure
+ * \param multi_p [OUT]         pointer to fan-out operation
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Forward_multi(hg_context_t *context, hg_id_t id, const hg_addr_t *addrs,
+    unsigned int count, unsigned int tree_arity, hg_cb_t callback, void *arg,
+    void *in_struct, hg_multi_t *multi_p);
+
+/**
+ * Get number of targets of a fan-out operation.
+ *
+ * \param multi [IN]            fan-out operation
+ *
+ * \return Non-negative value
+ */
+HG_PUBLIC unsigned int
+HG_Multi_get_count(hg_multi_t multi);
+
+/**
+ * Get result of the call forwarded to target index (in the order of the
+ * addresses passed to HG_Forward_multi()).
+ *
+ * \param multi [IN]            fan-out operation
+ * \param index [IN]            target index
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Multi_get_ret(hg_multi_t multi, unsigned int index);
+
+/**
+ * Get output of target index from a completed fan-out operation. Output must
+ * be freed using HG_Multi_free_output(). Outputs relayed through a tree are
+ * not available if they were reduced (see HG_Registered_reduce()).
+ *
+ * \param multi [IN]            fan-out operation
+ * \param index [IN]            target index
+ * \param out_struct [IN/OUT]   pointer to output structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Multi_get_output(hg_multi_t multi, unsigned int index, void *out_struct);
+
+/**
+ * Get reduced output of a completed fan-out operation (see
+ * HG_Registered_reduce()), outputs of targets that did not complete are not
+ * part of it. Output must be freed using HG_Multi_free_reduced_output().
+ *
+ * \param multi [IN]            fan-out operation
+ * \param out_struct [IN/OUT]   pointer to output structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Multi_get_reduced_output(hg_multi_t multi, void *out_struct);
+
+/**
+ * Free output previously obtained with HG_Multi_get_reduced_output().
+ *
+ * \param multi [IN]            fan-out operation
+ * \param out_struct [IN/OUT]   pointer to output structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Multi_free_reduced_output(hg_multi_t multi, void *out_struct);
+
+/**
+ * Free output of target index previously obtained with HG_Multi_get_output().
+ *
+ * \param multi [IN]            fan-out operation
+ * \param index [IN]            target index
+ * \param out_struct [IN/OUT]   pointer to output structure
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Multi_free_output(hg_multi_t multi, unsigned int index, void *out_struct);
+
+/**
+ * Release a fan-out operation once its callback has been triggered.
+ *
+ * \param multi [IN]            fan-out operation
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Multi_destroy(hg_multi_t multi);
+
 /**
  * Try to progress RPC execution for at most timeout until timeout is reached or
  * any completion has occurred.
@@ -1012,6 +1891,29 @@ HG_Respond(hg_handle_t handle, hg_cb_t callback, void *arg, void *out_struct);
 HG_PUBLIC hg_return_t
 HG_Progress(hg_context_t *context, unsigned int timeout);
 
+/**
+ * Progress several contexts from a single call, which saves threads that own
+ * several contexts (one per NIC, SM and NA, etc) from round-robin calls to
+ * progress with small timeouts. Contexts are first polled without blocking,
+ * if none of them has work, the calling thread blocks on the wait fds of all
+ * contexts at once until one of them has work or timeout is reached. If one
+ * of the contexts does not expose a wait fd, contexts are polled without
+ * blocking until timeout is reached. Bit i of ready_p is set if contexts[i]
+ * progressed or has completions to trigger, so that only these contexts
+ * need to be triggered. Contexts must not be progressed concurrently by
+ * other threads.
+ *
+ * \param contexts [IN]         array of HG contexts
+ * \param count [IN]            number of contexts (at most 64)
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param ready_p [OUT]         pointer to mask of ready contexts
+ *
+ * \return HG_SUCCESS if any context is ready / HG error code otherwise
+ */
+HG_PUBLIC hg_return_t
+HG_Progress_multi(hg_context_t *contexts[], unsigned int count,
+    unsigned int timeout, hg_uint64_t *ready_p);
+
 /**
  * Execute at most max_count callbacks. If timeout is non-zero, wait up to
  * timeout before returning. Function can return when at least one or more
@@ -1028,6 +1930,25 @@ HG_PUBLIC hg_return_t
 HG_Trigger(hg_context_t *context, unsigned int timeout, unsigned int max_count,
     unsigned int *actual_count_p);
 
+/**
+ * Execute at most max_count callbacks, draining completion entries in batches
+ * rather than one at a time. Same semantics as HG_Trigger(), except that
+ * the number of completion entries still queued on return is also reported,
+ * so that callers can decide whether to trigger again or make progress.
+ *
+ * \param context [IN]              pointer to HG context
+ * \param timeout [IN]              timeout (in milliseconds)
+ * \param max_count [IN]            maximum number of callbacks triggered
+ * \param actual_count_p [OUT]      actual number of callbacks triggered
+ * \param remaining_count_p [OUT]   number of completions left in queue
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Trigger_batch(hg_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count_p,
+    unsigned int *remaining_count_p);
+
 /**
  * Cancel an ongoing operation.
  *
@@ -1038,6 +1959,46 @@ HG_Trigger(hg_context_t *context, unsigned int timeout, unsigned int max_count,
 HG_PUBLIC hg_return_t
 HG_Cancel(hg_handle_t handle);
 
+/**
+ * Set timeout of next forwards of handle, which overrides the default
+ * timeout of its RPC ID (see HG_Registered_set_timeout()). Forwards that have
+ * not completed once the timeout is reached are canceled from progress, no
+ * extra thread is involved, and their callback returns HG_TIMEOUT. Forwards
+ * to self cannot be canceled and do not expire. The timeout is cleared when
+ * the handle is reset.
+ *
+ * \param handle [IN]           HG handle
+ * \param timeout_ms [IN]       timeout in ms (0 for default)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Set_timeout(hg_handle_t handle, unsigned int timeout_ms);
+
+/**
+ * Let the target of the next forwards of handle stream partial responses
+ * (see HG_Respond_partial()) before its final response. Each partial
+ * response is passed in order to callback, with a callback type of
+ * HG_CB_FORWARD, from HG_Trigger(); its output must be retrieved with
+ * HG_Get_output() and released with HG_Free_output() from that callback.
+ * The forward callback is triggered once the final response is received.
+ * At most credits partial responses are in flight: credits are returned to
+ * the target as partial responses are triggered, which prevents the target
+ * from overrunning a slow origin. Streaming is not supported for forwards to
+ * self, is cleared when the handle is reset and is disabled by passing 0
+ * credits.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to partial response callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param credits [IN]          max partial responses in flight (at most 255)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Set_stream(
+    hg_handle_t handle, hg_cb_t callback, void *arg, unsigned int credits);
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -1061,6 +2022,7 @@ struct hg_handle {
     hg_core_handle_t core_handle;       /* Core handle */
     void *data;                         /* User data */
     void (*data_free_callback)(void *); /* User data free callback */
+    void *private_area;                 /* Inline private area (if any) */
 };
 
 /*---------------------------------------------------------------------------*/
@@ -1160,6 +2122,47 @@ HG_Class_get_data(const hg_class_t *hg_class)
     return HG_Core_class_get_data(hg_class->core_class);
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Class_get_stats(
+    hg_class_t *hg_class, hg_id_t id, struct hg_rpc_stats *stats)
+{
+    return HG_Core_class_get_stats(hg_class->core_class, id, stats);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Class_get_peer_stats(
+    hg_class_t *hg_class, hg_addr_t addr, struct hg_peer_stats *stats)
+{
+    return HG_Core_class_get_peer_stats(
+        hg_class->core_class, (hg_core_addr_t) addr, stats);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Class_get_hot_peers(hg_class_t *hg_class, hg_addr_t *addrs,
+    struct hg_peer_stats *stats, unsigned int *count_p)
+{
+    return HG_Core_class_get_hot_peers(
+        hg_class->core_class, (hg_core_addr_t *) addrs, stats, count_p);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Class_set_capture(hg_class_t *hg_class, const char *path)
+{
+    return HG_Core_class_set_capture(hg_class->core_class, path);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_uint64_t
+HG_Stats_percentile(
+    const struct hg_stats_histogram *histogram, double percentile)
+{
+    return HG_Core_stats_percentile(histogram, percentile);
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_class_t *
 HG_Context_get_class(const hg_context_t *context)
@@ -1174,6 +2177,38 @@ HG_Context_get_id(const hg_context_t *context)
     return HG_Core_context_get_id(context->core_context);
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+HG_Context_get_spin_budget(const hg_context_t *context)
+{
+    return HG_Core_context_get_spin_budget(context->core_context);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Context_get_progress_stats(
+    const hg_context_t *context, struct hg_progress_stats *stats)
+{
+    return HG_Core_context_get_progress_stats(context->core_context, stats);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Context_get_handle_stats(
+    const hg_context_t *context, struct hg_handle_stats *stats)
+{
+    return HG_Core_context_get_handle_stats(context->core_context, stats);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+HG_Context_get_handle_age(const hg_context_t *context, hg_id_t id,
+    hg_uint32_t *count_p, hg_uint64_t *age_p)
+{
+    return HG_Core_context_get_handle_age(
+        context->core_context, id, count_p, age_p);
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
 HG_Context_set_data(
@@ -1227,6 +2262,13 @@ HG_Get_data(hg_handle_t handle)
     return handle->data;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void *
+HG_Get_private_area(hg_handle_t handle)
+{
+    return handle->private_area;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
 HG_Set_target_id(hg_handle_t handle, hg_uint8_t id)
@@ -12,13 +12,24 @@
 #include "mercury_private.h"
 
 #include "mercury_atomic.h"
+#include "mercury_atomic_queue.h"
+#include "mercury_crc32c.h"
+#include "mercury_hash_table.h"
 #include "mercury_list.h"
+#include "mercury_mem.h"
+#include "mercury_mem_pool.h"
 #include "mercury_thread_condition.h"
+#include "mercury_thread_mutex.h"
 #include "mercury_thread_spin.h"
+#include "mercury_time.h"
 
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef HG_HAS_CUDA
+#    include <cuda_runtime.h>
+#endif
+
 /****************/
 /* Local Macros */
 /****************/
@@ -26,16 +37,42 @@
 /* Limit for number of segments statically allocated */
 #define HG_BULK_STATIC_MAX (8)
 
+/* Dynamic arrays of NA op IDs that are larger are not kept for re-use */
+#define HG_BULK_NA_OP_IDS_KEEP_MAX (1024)
+
+/* Min size of lock-free queue of free op IDs */
+#define HG_BULK_OP_POOL_QUEUE_MIN (1024)
+
+/* Size of chunks of file-backed handles registered at once (if no chunk size
+ * is set for pipelined transfers) */
+#define HG_BULK_FILE_CHUNK_SIZE (1 << 22)
+
 /* Additional internal bulk flags (can hold up to 8 bits) */
 #define HG_BULK_ALLOC (1 << 4) /* memory is allocated */
 #define HG_BULK_BIND  (1 << 5) /* address is bound to segment */
 #define HG_BULK_REGV  (1 << 6) /* single registration for multiple segments */
 #define HG_BULK_VIRT  (1 << 7) /* addresses are virtual */
 
+/* Serialized flags only, re-use the bits of HG_BULK_ALLOC / HG_BULK_VIRT
+ * which are local */
+#define HG_BULK_CONTIG (1 << 4) /* segments are contiguous */
+#define HG_BULK_RAILS  (1 << 7) /* handles of additional rails follow */
+
+/* Stripes of transfers split across rails are aligned on that size */
+#define HG_BULK_RAIL_ALIGN (4096)
+
+/* Rails are given at least that fraction of the fastest rail's share so that
+ * their bandwidth keeps being measured */
+#define HG_BULK_RAIL_MIN_SHARE (16)
+
+/* Max length of a LEB128 encoded 64-bit value */
+#define HG_BULK_VARINT_MAX ((sizeof(hg_uint64_t) * 8 + 6) / 7)
+
 /* Op ID status bits */
 #define HG_BULK_OP_COMPLETED (1 << 0)
 #define HG_BULK_OP_CANCELED  (1 << 1)
 #define HG_BULK_OP_ERRORED   (1 << 2)
+#define HG_BULK_OP_EXPIRED   (1 << 3)
 
 /* Encode type */
 #define HG_BULK_TYPE_ENCODE(label, ret, buf_ptr, buf_size_left, data, size)    \
@@ -75,6 +112,28 @@
     HG_BULK_TYPE_DECODE(                                                       \
         label, ret, buf_ptr, buf_size_left, data, sizeof(type) * count)
 
+/* Encode / decode LEB128 varint */
+#define HG_BULK_VARINT_ENCODE(label, ret, buf_ptr, buf_size_left, value)       \
+    do {                                                                       \
+        size_t _len = hg_bulk_varint_size(value);                              \
+        HG_CHECK_SUBSYS_ERROR(bulk, buf_size_left < _len, label, ret,          \
+            HG_OVERFLOW, "Buffer size too small (%" PRIu64 ")",                \
+            buf_size_left);                                                    \
+        hg_bulk_varint_encode(buf_ptr, value);                                 \
+        buf_ptr += _len;                                                       \
+        buf_size_left -= _len;                                                 \
+    } while (0)
+
+#define HG_BULK_VARINT_DECODE(label, ret, buf_ptr, buf_size_left, value_p)     \
+    do {                                                                       \
+        size_t _len = hg_bulk_varint_decode(buf_ptr, buf_size_left, value_p);  \
+        HG_CHECK_SUBSYS_ERROR(bulk, _len == 0, label, ret, HG_OVERFLOW,        \
+            "Could not decode varint (%" PRIu64 " bytes left)",                \
+            buf_size_left);                                                    \
+        buf_ptr += _len;                                                       \
+        buf_size_left -= _len;                                                 \
+    } while (0)
+
 /* Min/max macros */
 #define HG_BULK_MIN(a, b) (a < b) ? a : b
 
@@ -88,11 +147,12 @@
                                                             : (x)->handles.s
 
 #define HG_BULK_NA_OP_IDS(x)                                                   \
-    ((x)->op_count > HG_BULK_STATIC_MAX) ? (x)->na_op_ids.d : (x)->na_op_ids.s
+    ((x)->na_op_id_count > HG_BULK_STATIC_MAX) ? (x)->na_op_ids.d              \
+                                               : (x)->na_op_ids.s
 
 #define HG_BULK_NA_SM_OP_IDS(x)                                                \
-    ((x)->op_count > HG_BULK_STATIC_MAX) ? (x)->na_sm_op_ids.d                 \
-                                         : (x)->na_sm_op_ids.s
+    ((x)->na_op_id_count > HG_BULK_STATIC_MAX) ? (x)->na_sm_op_ids.d           \
+                                               : (x)->na_sm_op_ids.s
 
 /* Check permission flags */
 #define HG_BULK_CHECK_FLAGS(op, origin_flags, local_flags, label, ret)         \
@@ -162,6 +222,85 @@ struct hg_bulk_na_mem_desc {
     } handles;                                  /* NA mem handles */
 };
 
+/* Registration cache key */
+struct hg_bulk_reg_key {
+    hg_ptr_t base;       /* Address of the segment */
+    hg_size_t len;       /* Size of the segment in bytes */
+    hg_uint64_t device;  /* Device ID */
+    hg_uint8_t flags;    /* Permission flags */
+    hg_uint8_t mem_type; /* Memory type */
+};
+
+/* Registration cache entry */
+struct hg_bulk_reg_entry {
+    struct hg_bulk_reg_key key;             /* Key (must remain first) */
+    HG_LIST_ENTRY(hg_bulk_reg_entry) entry; /* Entry in cache list */
+    na_class_t *na_class;                   /* NA class */
+    na_mem_handle_t *na_mem_handle;         /* NA mem handle */
+    size_t na_serialize_size;               /* NA mem handle serialize size */
+#ifdef NA_HAS_SM
+    na_class_t *na_sm_class;           /* NA SM class */
+    na_mem_handle_t *na_sm_mem_handle; /* NA SM mem handle */
+    size_t na_sm_serialize_size;       /* NA SM mem handle serialize size */
+#endif
+    hg_uint64_t last_used; /* Last use (for LRU eviction) */
+    hg_uint32_t ref_count; /* Number of bulk handles using entry */
+    hg_bool_t invalid;     /* Entry was invalidated and removed from cache */
+};
+
+/* Registration cache */
+struct hg_bulk_reg_cache {
+    hg_thread_mutex_t mutex;              /* Cache lock */
+    hg_hash_table_t *table;               /* Lookup table of entries */
+    HG_LIST_HEAD(hg_bulk_reg_entry) list; /* List of entries */
+    hg_size_t size;                       /* Total size registered */
+    hg_size_t max_size;                   /* Max size registered */
+    hg_uint64_t use_count;                /* Current use count */
+    struct hg_bulk_dereg_queue *dereg_queue; /* Deferred deregistrations */
+};
+
+/* Descriptor cache key */
+struct hg_bulk_desc_key {
+    const void *buf; /* Serialized descriptor */
+    hg_size_t size;  /* Size of serialized descriptor */
+};
+
+/* Descriptor cache entry */
+struct hg_bulk_desc_entry {
+    struct hg_bulk_desc_key key;             /* Key (must remain first) */
+    HG_LIST_ENTRY(hg_bulk_desc_entry) entry; /* Entry in cache list */
+    struct hg_bulk *hg_bulk;                 /* Deserialized handle */
+    hg_uint64_t last_used;                   /* Last use (for LRU eviction) */
+};
+
+/* Descriptor cache */
+struct hg_bulk_desc_cache {
+    hg_thread_mutex_t mutex;               /* Cache lock */
+    hg_hash_table_t *table;                /* Lookup table of entries */
+    HG_LIST_HEAD(hg_bulk_desc_entry) list; /* List of entries */
+    hg_uint32_t count;                     /* Number of entries */
+    hg_uint32_t max_count;                 /* Max number of entries */
+    hg_uint64_t use_count;                 /* Current use count */
+};
+
+/* Deferred deregistration queue */
+struct hg_bulk_dereg_queue {
+    HG_QUEUE_HEAD(hg_bulk) bulks;            /* Handles left to release */
+    HG_LIST_HEAD(hg_bulk_reg_entry) entries; /* Evicted registrations */
+    hg_thread_spin_t lock;                   /* Queue lock */
+    hg_atomic_int32_t count;                 /* Number of queued items */
+    hg_uint32_t batch;                       /* Max items released at once */
+};
+
+/* NA memory handles on additional rails (index 0 is the default NA class) */
+struct hg_bulk_rails {
+    na_mem_handle_t *handles[HG_CORE_RAIL_MAX]; /* Memory handles */
+    size_t serialize_sizes[HG_CORE_RAIL_MAX];   /* Serialize sizes */
+    na_addr_t *addrs[HG_CORE_RAIL_MAX]; /* Rail addresses (remote only) */
+    size_t addr_sizes[HG_CORE_RAIL_MAX]; /* Address serialize sizes */
+    hg_uint8_t count;                    /* Number of rails */
+};
+
 /* HG bulk handle */
 struct hg_bulk {
     struct hg_bulk_desc desc;                /* Bulk descriptor   */
@@ -174,33 +313,124 @@ struct hg_bulk {
 #ifdef NA_HAS_SM
     na_class_t *na_sm_class; /* NA SM class */
 #endif
-    struct hg_bulk_attr attrs;   /* Memory attributes */
-    hg_core_addr_t addr;         /* Addr (valid if bound to handle) */
-    void *serialize_ptr;         /* Cached serialization buffer */
-    hg_size_t serialize_size;    /* Cached serialization size */
-    hg_atomic_int32_t ref_count; /* Reference count */
-    hg_uint8_t context_id;       /* Context ID (valid if bound to handle) */
-    hg_bool_t registered;        /* Handle was registered */
+    struct hg_bulk_attr attrs;           /* Memory attributes */
+    hg_core_addr_t addr;                 /* Addr (valid if bound to handle) */
+    struct hg_bulk_reg_entry *reg_entry; /* Cached registration */
+    void *serialize_ptr;                 /* Cached serialization buffer */
+    hg_size_t serialize_size;            /* Cached serialization size */
+    void *desc_buf;                /* Descriptor copy (if in desc cache) */
+    struct hg_bulk_rails *rails;   /* Handles on additional rails (if any) */
+    hg_core_handle_t pin_handle;   /* Handle owning eager data (if any) */
+    HG_QUEUE_ENTRY(hg_bulk) dereg_entry; /* Entry in deregistration queue */
+    hg_size_t desc_serialize_size[2]; /* Descriptor sizes (w/o, w/ SM) */
+    hg_thread_mutex_t reg_mutex;      /* Deferred registration lock */
+    hg_atomic_int32_t ref_count;      /* Reference count */
+    hg_uint8_t context_id; /* Context ID (valid if bound to handle) */
+    hg_bool_t registered;  /* Handle was registered */
+    hg_bool_t lazy;        /* Registration deferred until first remote use */
+    hg_bool_t deferred[2]; /* Segments left to register (w/o, w/ SM) */
 };
 
 /* HG bulk NA op IDs (not a union as we re-use op IDs) */
 typedef struct {
     na_op_id_t *s[HG_BULK_STATIC_MAX]; /* Static array */
     na_op_id_t **d;                    /* Dynamic array */
+    hg_uint32_t d_count;               /* Number of op IDs in dynamic array */
 } hg_bulk_na_op_id_t;
 
+/* Wrapper on top of NA layer */
+typedef na_return_t (*na_bulk_op_t)(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, na_mem_handle_t *local_mem_handle,
+    na_offset_t local_offset, na_mem_handle_t *remote_mem_handle,
+    na_offset_t remote_offset, size_t data_size, na_addr_t *remote_addr,
+    uint8_t remote_id, na_op_id_t *op_id);
+
+/* Pipeline slot (one NA operation in flight) */
+struct hg_bulk_pipeline_slot {
+    struct hg_bulk_pipeline *pipeline; /* Pipeline that slot belongs to */
+    na_op_id_t *na_op_id;              /* NA operation ID */
+    hg_size_t offset;                  /* Offset of chunk within transfer */
+    hg_size_t size;                    /* Size of chunk */
+    hg_uint32_t index;                 /* Index of chunk within transfer */
+};
+
+/* Checksum of a pipelined chunk */
+struct hg_bulk_chunk_crc {
+    hg_size_t size;  /* Size of chunk */
+    hg_uint32_t crc; /* CRC32C of chunk */
+};
+
+/* Pipelined transfer state */
+struct hg_bulk_pipeline {
+    struct hg_bulk_segment origin_segment; /* Origin segment (if single) */
+    struct hg_bulk_segment local_segment;  /* Local segment (if single) */
+    const struct hg_bulk_segment *origin_segments; /* Origin segments */
+    const struct hg_bulk_segment *local_segments;  /* Local segments */
+    na_mem_handle_t **origin_mem_handles;          /* Origin mem handles */
+    na_mem_handle_t **local_mem_handles;           /* Local mem handles */
+    struct hg_bulk_op_id *hg_bulk_op_id;           /* Bulk op ID */
+    na_bulk_op_t na_bulk_op;                       /* NA operation */
+    na_addr_t *na_origin_addr;                     /* Origin NA addr */
+    struct hg_bulk_chunk_crc *crcs;                /* Chunk checksums */
+    hg_thread_spin_t lock;                         /* Iterator lock */
+    hg_size_t chunk_size;                          /* Max size of NA ops */
+    hg_size_t origin_segment_index;  /* Current origin segment index */
+    hg_size_t origin_segment_offset; /* Offset within origin segment */
+    hg_size_t local_segment_index;   /* Current local segment index */
+    hg_size_t local_segment_offset;  /* Offset within local segment */
+    hg_size_t transfer_offset;       /* Transfer offset of next chunk */
+    hg_size_t remaining_size;        /* Size that remains to be issued */
+    hg_size_t transferred;           /* Size of chunks completed (if stats) */
+    hg_size_t failed_offset; /* Lowest offset of chunks failed (if stats) */
+    hg_ptr_t prefetch_end;   /* End of range prefetched (if file-backed) */
+    hg_size_t local_offset;          /* Local offset of transfer */
+    hg_uint32_t origin_count;        /* Number of origin segments */
+    hg_uint32_t local_count;         /* Number of local segments */
+    hg_uint32_t slot_count;          /* Number of slots */
+    hg_uint32_t active_count;        /* Number of slots still in use */
+    hg_uint32_t issued_count;        /* Number of chunks issued */
+    hg_uint8_t origin_id;            /* Origin context ID */
+    struct hg_bulk_pipeline_slot slots[]; /* NA operations in flight */
+};
+
+/* Stripe of a transfer issued on one rail */
+struct hg_bulk_rail_op {
+    struct hg_bulk_op_id *hg_bulk_op_id; /* Bulk op ID */
+    na_op_id_t *na_op_id;                /* NA operation ID */
+    hg_time_t start;                     /* Time stripe was issued */
+    hg_time_t end;                       /* Time stripe completed */
+    hg_size_t size;                      /* Size of stripe (0 if none) */
+    hg_bool_t transferred;               /* Stripe completed successfully */
+};
+
 /* HG Bulk op ID */
 struct hg_bulk_op_id {
     struct hg_completion_entry
         hg_completion_entry;              /* Entry in completion queue */
     struct hg_cb_info callback_info;      /* Callback info struct */
     HG_LIST_ENTRY(hg_bulk_op_id) pending; /* Pending list entry */
+    HG_LIST_ENTRY(hg_bulk_op_id) expiry;  /* Expiry list entry */
+    HG_QUEUE_ENTRY(hg_bulk_op_id) sched;  /* Entry in queue of origin */
+    struct hg_core_addr *origin_addr;     /* Origin addr (while queued) */
+    hg_size_t origin_offset;              /* Origin offset (while queued) */
+    hg_size_t local_offset;               /* Local offset (while queued) */
+    hg_size_t sched_size;                 /* Bytes accounted in flight */
+    struct hg_bulk_sched_peer *sched_peer; /* Origin op ID is queued on */
     struct hg_bulk_op_pool *op_pool;      /* Pool that op ID belongs to */
     hg_cb_t callback;                     /* Pointer to function */
+    hg_bulk_chunk_cb_t chunk_callback;    /* Chunk completion callback */
+    void *chunk_arg;                      /* Chunk callback argument */
+    struct hg_bulk_pipeline *pipeline;    /* Pipelined transfer state */
+    struct hg_bulk_op_id *parent;         /* List that transfer belongs to */
+    struct hg_bulk_op_id **children;      /* Transfers of list */
+    struct hg_bulk_transfer_stats *stats; /* Stats returned (if any) */
+    hg_time_t start;                      /* Start time (if stats/deadline) */
+    hg_time_t deadline;                   /* Deadline (if timeout) */
     hg_bulk_na_op_id_t na_op_ids;         /* NA operations IDs */
 #ifdef NA_HAS_SM
     hg_bulk_na_op_id_t na_sm_op_ids; /* NA SM operations IDs */
 #endif
+    struct hg_bulk_rail_op rail_ops[HG_CORE_RAIL_MAX]; /* Rail stripes */
     hg_core_context_t *core_context;      /* Context */
     na_class_t *na_class;                 /* NA class */
     na_context_t *na_context;             /* NA context */
@@ -209,7 +439,25 @@ struct hg_bulk_op_id {
     hg_atomic_int32_t op_completed_count; /* Number of operations completed */
     hg_atomic_int32_t ref_count;          /* Refcount */
     hg_uint32_t op_count;                 /* Number of ongoing operations */
+    hg_uint32_t na_op_id_count;           /* Number of NA op IDs used */
+    hg_uint32_t child_count;              /* Number of transfers of list */
+    hg_uint8_t rail_op_count;             /* Number of rails used (if split) */
+    hg_bool_t timeout;                    /* Transfer has a deadline */
+    hg_bool_t checksum;                   /* Checksum data transferred */
+    hg_bool_t expiring;                   /* Op ID is in expiry list */
     hg_bool_t reuse;                      /* Re-use op ID once ref_count is 0 */
+    hg_uint8_t origin_id;                 /* Origin context ID (while queued) */
+#ifdef HG_HAS_CUDA
+    HG_LIST_ENTRY(hg_bulk_op_id) device; /* Device copy list entry */
+    cudaEvent_t cuda_event;              /* Recorded after device copies */
+#endif
+};
+
+/* Origin with queued transfers */
+struct hg_bulk_sched_peer {
+    HG_QUEUE_HEAD(hg_bulk_op_id) queue;       /* Queued transfers */
+    HG_QUEUE_ENTRY(hg_bulk_sched_peer) entry; /* Entry in round-robin queue */
+    void *key;                                /* Key of origin */
 };
 
 /* Pool of op IDs */
@@ -217,24 +465,63 @@ struct hg_bulk_op_pool {
     hg_thread_mutex_t extend_mutex;           /* To extend pool */
     hg_thread_cond_t extend_cond;             /* To extend pool */
     hg_core_context_t *core_context;          /* Context */
-    HG_LIST_HEAD(hg_bulk_op_id) pending_list; /* Pending op IDs */
+    struct hg_atomic_queue *free_queue;       /* Free op IDs */
+    HG_LIST_HEAD(hg_bulk_op_id) pending_list; /* Free op IDs (queue full) */
     hg_thread_spin_t pending_list_lock;       /* Pending list lock */
+    HG_LIST_HEAD(hg_bulk_op_id) expiry_list;  /* Op IDs with a deadline */
+    hg_thread_spin_t expiry_list_lock;        /* Expiry list lock */
+    hg_atomic_int32_t expiry_count;           /* Number of op IDs in list */
+#ifdef HG_HAS_CUDA
+    HG_LIST_HEAD(hg_bulk_op_id) device_list;  /* Op IDs copying on device */
+    hg_thread_spin_t device_list_lock;        /* Device list lock */
+    hg_atomic_int32_t device_count;           /* Number of op IDs in list */
+#endif
+    HG_QUEUE_HEAD(hg_bulk_sched_peer) sched_queue; /* Queued origins */
+    hg_hash_table_t *sched_peers;             /* Origins by key */
+    hg_thread_spin_t sched_lock;              /* Scheduler lock */
+    hg_size_t sched_inflight;                 /* Bytes in flight */
+    hg_size_t sched_max_inflight;             /* Max bytes in flight */
     unsigned long count;                      /* Number of op IDs */
     hg_bool_t extending;                      /* When extending the pool */
 };
 
+/* Chunk of stream */
+struct hg_bulk_stream_slot {
+    struct hg_bulk_stream *stream; /* Stream */
+    hg_op_id_t op_id;              /* Transfer of chunk */
+    hg_size_t size;                /* Size of chunk */
+    hg_atomic_int32_t status;      /* Pending or return code of transfer */
+};
+
+/* Streaming pull */
+struct hg_bulk_stream {
+    hg_context_t *context;             /* Context */
+    hg_core_addr_t origin_addr;        /* Origin addr */
+    hg_bulk_t origin_handle;           /* Origin handle */
+    hg_bulk_t local_handle;            /* Handle of local buffers */
+    char *buf;                         /* Local buffers */
+    struct hg_bulk_stream_slot *slots; /* Ring of chunks */
+    hg_size_t origin_offset;           /* Offset of stream in origin handle */
+    hg_size_t size;                    /* Size of stream */
+    hg_size_t chunk_size;              /* Size of chunks */
+    hg_size_t issued;                  /* Size of data requested */
+    hg_size_t consumed;                /* Size of data returned */
+    hg_atomic_int32_t ref_count;       /* Refcount (stream and transfers) */
+    hg_uint32_t depth;                 /* Number of chunks */
+    hg_uint32_t issue_slot;            /* Slot of next chunk requested */
+    hg_uint32_t next_slot;             /* Slot of next chunk returned */
+    hg_uint8_t origin_id;              /* Origin context ID */
+    hg_bool_t held;                    /* Previous chunk not released */
+};
+
+/* Status of pending chunks (completed chunks hold the return code) */
+#define HG_BULK_STREAM_PENDING (-1)
+
 /* Wrapper on top of memcpy */
 typedef void (*hg_bulk_copy_op_t)(hg_ptr_t local_address,
     hg_size_t local_offset, hg_ptr_t remote_address, hg_size_t remote_offset,
     hg_size_t data_size);
 
-/* Wrapper on top of NA layer */
-typedef na_return_t (*na_bulk_op_t)(na_class_t *na_class, na_context_t *context,
-    na_cb_t callback, void *arg, na_mem_handle_t *local_mem_handle,
-    na_offset_t local_offset, na_mem_handle_t *remote_mem_handle,
-    na_offset_t remote_offset, size_t data_size, na_addr_t *remote_addr,
-    uint8_t remote_id, na_op_id_t *op_id);
-
 /********************/
 /* Local Prototypes */
 /********************/
@@ -247,6 +534,28 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
     const hg_size_t *lens, hg_uint8_t flags, const struct hg_bulk_attr *attrs,
     struct hg_bulk **hg_bulk_p);
 
+/**
+ * Get number of segments once adjacent segments that are contiguous in memory
+ * are merged.
+ */
+static hg_uint32_t
+hg_bulk_coalesce_count(
+    void *const *bufs, const hg_size_t *lens, hg_uint32_t count);
+
+/**
+ * Register memory of handle with NA classes.
+ */
+static hg_return_t
+hg_bulk_mem_register(struct hg_bulk *hg_bulk);
+
+/**
+ * Get segments of file-backed handle, contiguous buffers are merged and cut
+ * in chunks that are registered separately. Only count if segments is NULL.
+ */
+static hg_uint32_t
+hg_bulk_file_segments(void *const *bufs, const hg_size_t *lens,
+    hg_uint32_t count, hg_size_t chunk_size, struct hg_bulk_segment *segments);
+
 /**
  * Free handle.
  */
@@ -254,12 +563,19 @@ static hg_return_t
 hg_bulk_free(struct hg_bulk *hg_bulk);
 
 /**
- * Create NA memory descriptors.
+ * Deregister and release handle that is no longer referenced.
+ */
+static hg_return_t
+hg_bulk_release(struct hg_bulk *hg_bulk);
+
+/**
+ * Create NA memory descriptors (segments are not registered if deferred).
  */
 static hg_return_t
 hg_bulk_create_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
     na_class_t *na_class, struct hg_bulk_segment *segments, hg_uint32_t count,
-    hg_uint8_t flags, enum na_mem_type mem_type, uint64_t device);
+    hg_uint8_t flags, enum na_mem_type mem_type, uint64_t device,
+    hg_bool_t deferred);
 
 /**
  * Free NA memory descriptors.
@@ -292,12 +608,165 @@ static hg_return_t
 hg_bulk_deregister(
     na_class_t *na_class, na_mem_handle_t *mem_handle, bool registered);
 
+/**
+ * Register segment of file-backed handle if not registered yet.
+ */
+static hg_return_t
+hg_bulk_register_deferred(struct hg_bulk *hg_bulk, na_class_t *na_class,
+    hg_uint32_t index, na_mem_handle_t **mem_handle_p);
+
+/**
+ * Register all remaining segments of lazily registered handle before it is
+ * serialized for or used with a remote peer.
+ */
+static hg_return_t
+hg_bulk_register_deferred_all(struct hg_bulk *hg_bulk, hg_uint8_t flags);
+
+/**
+ * Register segment with NA class (deferred registration lock must be held).
+ */
+static hg_return_t
+hg_bulk_register_deferred_locked(
+    struct hg_bulk *hg_bulk, na_class_t *na_class, hg_uint32_t index);
+
+/**
+ * Register memory of handle with additional rails.
+ */
+static hg_return_t
+hg_bulk_rails_register(struct hg_bulk *hg_bulk,
+    const struct hg_core_rails *rails, struct hg_bulk_segment *segments,
+    hg_uint32_t count, hg_uint8_t flags, const struct hg_bulk_attr *attrs);
+
+/**
+ * Release memory handles and addresses of additional rails.
+ */
+static hg_return_t
+hg_bulk_rails_free(struct hg_bulk *hg_bulk);
+
+/**
+ * Hash registration key.
+ */
+static HG_INLINE unsigned int
+hg_bulk_reg_key_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare registration keys.
+ */
+static HG_INLINE int
+hg_bulk_reg_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Get registration from cache or register segment and add it to cache.
+ */
+static hg_return_t
+hg_bulk_reg_cache_get(struct hg_bulk_reg_cache *hg_bulk_reg_cache,
+    struct hg_bulk *hg_bulk, const struct hg_bulk_segment *segment,
+    hg_uint8_t flags, struct hg_bulk_reg_entry **entry_p);
+
+/**
+ * Release registration previously retrieved from cache.
+ */
+static hg_return_t
+hg_bulk_reg_cache_put(struct hg_bulk_reg_cache *hg_bulk_reg_cache,
+    struct hg_bulk_reg_entry *entry);
+
+/**
+ * Remove entry from cache (lock must be held).
+ */
+static void
+hg_bulk_reg_cache_remove(struct hg_bulk_reg_cache *hg_bulk_reg_cache,
+    struct hg_bulk_reg_entry *entry);
+
+/**
+ * Evict least recently used entries until cache fits (lock must be held).
+ */
+static hg_return_t
+hg_bulk_reg_cache_evict(struct hg_bulk_reg_cache *hg_bulk_reg_cache);
+
+/**
+ * Pop one item from deferred deregistration queue and release it. Returns
+ * HG_FALSE if queue was empty.
+ */
+static hg_bool_t
+hg_bulk_dereg_queue_pop(struct hg_bulk_dereg_queue *hg_bulk_dereg_queue);
+
+/**
+ * Deregister and free cache entry.
+ */
+static hg_return_t
+hg_bulk_reg_entry_free(struct hg_bulk_reg_entry *entry);
+
+/**
+ * Hash descriptor cache key.
+ */
+static HG_INLINE unsigned int
+hg_bulk_desc_key_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare descriptor cache keys.
+ */
+static HG_INLINE int
+hg_bulk_desc_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Get handle from descriptor cache or deserialize it and add it to cache.
+ */
+static hg_return_t
+hg_bulk_desc_cache_get(struct hg_bulk_desc_cache *hg_bulk_desc_cache,
+    hg_core_class_t *core_class, struct hg_bulk **hg_bulk_p, const void *buf,
+    hg_size_t buf_size, hg_core_handle_t pin_handle);
+
+/**
+ * Evict least recently used entry (lock must be held).
+ */
+static hg_return_t
+hg_bulk_desc_cache_evict(struct hg_bulk_desc_cache *hg_bulk_desc_cache);
+
+/**
+ * Free descriptor cache entry and release its handle.
+ */
+static hg_return_t
+hg_bulk_desc_entry_free(struct hg_bulk_desc_entry *entry);
+
+/**
+ * Length of LEB128 encoded value.
+ */
+static HG_INLINE size_t
+hg_bulk_varint_size(hg_uint64_t value);
+
+/**
+ * Encode LEB128 value (buffer must be large enough).
+ */
+static HG_INLINE void
+hg_bulk_varint_encode(char *buf, hg_uint64_t value);
+
+/**
+ * Decode LEB128 value, returns number of bytes read or 0 on error.
+ */
+static HG_INLINE size_t
+hg_bulk_varint_decode(
+    const char *buf, hg_size_t buf_size, hg_uint64_t *value_p);
+
+/**
+ * Check whether segments are adjacent in memory.
+ */
+static HG_INLINE hg_bool_t
+hg_bulk_segments_contig(
+    const struct hg_bulk_segment *segments, hg_uint32_t count);
+
 /**
  * Get serialize size.
  */
 static hg_size_t
 hg_bulk_get_serialize_size(struct hg_bulk *hg_bulk, hg_uint8_t flags);
 
+/**
+ * Get serialize size of descriptor (segments and NA memory handles). Result
+ * does not depend on bind or eager state and is cached on the handle.
+ */
+static hg_size_t
+hg_bulk_get_serialize_size_desc(struct hg_bulk *hg_bulk, hg_uint8_t flags);
+
 /**
  * Get serialize size of NA memory descriptors.
  */
@@ -320,12 +789,25 @@ hg_bulk_serialize_mem_descs(na_class_t *na_class, char **buf_p,
     hg_size_t *buf_size_left_p, struct hg_bulk_na_mem_desc *na_mem_descs,
     const struct hg_bulk_segment *segments, hg_uint32_t count);
 
+/**
+ * Get serialize size of addresses and memory handles of additional rails.
+ */
+static hg_size_t
+hg_bulk_get_serialize_size_rails(struct hg_bulk *hg_bulk);
+
+/**
+ * Serialize addresses and memory handles of additional rails.
+ */
+static hg_return_t
+hg_bulk_serialize_rails(
+    char **buf_p, hg_size_t *buf_size_left_p, struct hg_bulk *hg_bulk);
+
 /**
  * Deserialize bulk handle.
  */
 static hg_return_t
 hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_p,
-    const void *buf, hg_size_t buf_size);
+    const void *buf, hg_size_t buf_size, hg_core_handle_t pin_handle);
 
 /**
  * Deserialize NA memory descriptors.
@@ -335,6 +817,13 @@ hg_bulk_deserialize_mem_descs(na_class_t *na_class, const char **buf_p,
     hg_size_t *buf_size_left_p, struct hg_bulk_na_mem_desc *na_mem_descs,
     const struct hg_bulk_segment *segments, hg_uint32_t count);
 
+/**
+ * Deserialize addresses and memory handles of additional rails.
+ */
+static hg_return_t
+hg_bulk_deserialize_rails(
+    const char **buf_p, hg_size_t *buf_size_left_p, struct hg_bulk *hg_bulk);
+
 /**
  * Access bulk handle and get segment addresses/sizes.
  */
@@ -371,25 +860,147 @@ static hg_return_t
 hg_bulk_op_pool_get(struct hg_bulk_op_pool *hg_bulk_op_pool,
     struct hg_bulk_op_id **hg_bulk_op_id_p);
 
+/**
+ * Return op ID to pool.
+ */
+static HG_INLINE void
+hg_bulk_op_pool_put(struct hg_bulk_op_pool *hg_bulk_op_pool,
+    struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Get array of at least count NA op IDs. Dynamic arrays remain attached to
+ * the op ID so that they can be re-used by subsequent transfers.
+ */
+static hg_return_t
+hg_bulk_na_op_ids_get(hg_bulk_na_op_id_t *hg_bulk_na_op_ids,
+    na_class_t *na_class, hg_uint32_t count, na_op_id_t ***na_op_ids_p);
+
+/**
+ * Free dynamic array of NA op IDs.
+ */
+static void
+hg_bulk_na_op_ids_free(
+    hg_bulk_na_op_id_t *hg_bulk_na_op_ids, na_class_t *na_class);
+
+/**
+ * Get op ID from context pool or create a new one.
+ */
+static hg_return_t
+hg_bulk_op_get(
+    hg_core_context_t *core_context, struct hg_bulk_op_id **hg_bulk_op_id_p);
+
+/**
+ * Hash key of origin.
+ */
+static HG_INLINE unsigned int
+hg_bulk_sched_key_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare keys of origins.
+ */
+static HG_INLINE int
+hg_bulk_sched_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Account bytes of NA transfer in flight, or queue transfer on its origin if
+ * the limit of the pool is reached. Returns HG_TRUE if the transfer can be
+ * started.
+ */
+static hg_bool_t
+hg_bulk_sched_admit(struct hg_bulk_op_pool *hg_bulk_op_pool,
+    struct hg_bulk_op_id *hg_bulk_op_id, struct hg_core_addr *origin_addr,
+    hg_uint8_t origin_id, hg_size_t origin_offset, hg_size_t local_offset);
+
+/**
+ * Release bytes of completed transfer and start queued transfers that fit.
+ */
+static void
+hg_bulk_sched_release(
+    struct hg_bulk_op_id *hg_bulk_op_id, hg_bool_t self_notify);
+
+/**
+ * Remove transfer from queue of its origin. Returns HG_TRUE if it was queued.
+ */
+static hg_bool_t
+hg_bulk_sched_remove(struct hg_bulk_op_id *hg_bulk_op_id);
+
 /**
  * Bulk transfer.
  */
 static hg_return_t
 hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
-    hg_bulk_op_t op, struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
+    const struct hg_bulk_transfer_opt *opt, hg_bulk_op_t op,
+    struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
     struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
     struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
+    struct hg_bulk_op_id *hg_bulk_parent_op_id, hg_op_id_t *op_id);
+
+/**
+ * Start NA transfer of op ID.
+ */
+static hg_return_t
+hg_bulk_transfer_start_na(struct hg_bulk_op_id *hg_bulk_op_id,
+    struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
+    hg_size_t origin_offset, hg_size_t local_offset);
+
+/**
+ * Bulk transfer of a list of origin regions.
+ */
+static hg_return_t
+hg_bulk_transfer_list(hg_core_context_t *core_context, hg_cb_t callback,
+    void *arg, hg_bulk_op_t op, struct hg_bulk *hg_bulk_local,
+    const struct hg_bulk_transfer_entry *entries, hg_uint32_t count,
+    hg_op_id_t *op_id);
+
+/**
+ * Atomic operation on origin region.
+ */
+static hg_return_t
+hg_bulk_atomic(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
+    hg_bulk_atomic_op_t op, struct hg_core_addr *origin_addr,
+    hg_uint8_t origin_id, struct hg_bulk *hg_bulk_origin,
+    hg_size_t origin_offset, hg_uint64_t operand, hg_uint64_t compare,
     hg_op_id_t *op_id);
 
 /**
- * Bulk transfer to self.
+ * Determine whether a transfer to self can be done with host memcpy.
+ */
+static hg_bool_t
+hg_bulk_self_is_host(
+    const struct hg_bulk *hg_bulk_origin, const struct hg_bulk *hg_bulk_local);
+
+/**
+ * Bulk transfer to self. When device is set, copies are issued
+ * asynchronously on the device and the transfer completes from progress.
  */
 static hg_return_t
 hg_bulk_transfer_self(hg_bulk_op_t op,
     const struct hg_bulk_segment *origin_segments, hg_uint32_t origin_count,
     hg_size_t origin_offset, const struct hg_bulk_segment *local_segments,
     hg_uint32_t local_count, hg_size_t local_offset, hg_size_t size,
-    struct hg_bulk_op_id *hg_bulk_op_id);
+    hg_bool_t device, struct hg_bulk_op_id *hg_bulk_op_id);
+
+#ifdef HG_HAS_CUDA
+/**
+ * Queue device copies of transfer to self for completion from progress.
+ */
+static hg_return_t
+hg_bulk_transfer_self_cuda(struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Complete transfer to self once its device copies are done.
+ */
+static void
+hg_bulk_transfer_self_cuda_complete(
+    struct hg_bulk_op_id *hg_bulk_op_id, hg_return_t ret);
+#endif
+
+/**
+ * Compute CRC32C of a range of segments.
+ */
+static hg_uint32_t
+hg_bulk_checksum(const struct hg_bulk_segment *segments, hg_uint32_t count,
+    hg_size_t offset, hg_size_t size);
 
 /**
  * Transfer segments to self (local copy).
@@ -403,41 +1014,93 @@ hg_bulk_transfer_segments_self(hg_bulk_copy_op_t copy_op,
     hg_size_t size);
 
 /**
- * Memcpy.
+ * Memcpy (through selected copy kernel).
  */
 static HG_INLINE void
 hg_bulk_memcpy_put(hg_ptr_t local_address, hg_size_t local_offset,
     hg_ptr_t remote_address, hg_size_t remote_offset, hg_size_t data_size)
 {
-    memcpy((void *) (remote_address + remote_offset),
-        (const void *) (local_address + local_offset), data_size);
+    hg_mem_copy((void *) (remote_address + remote_offset),
+        (const void *) (local_address + local_offset), (size_t) data_size);
 }
 
 /**
- * Memcpy.
+ * Memcpy (through selected copy kernel).
  */
 static HG_INLINE void
 hg_bulk_memcpy_get(hg_ptr_t local_address, hg_size_t local_offset,
     hg_ptr_t remote_address, hg_size_t remote_offset, hg_size_t data_size)
 {
-    memcpy((void *) (local_address + local_offset),
-        (const void *) (remote_address + remote_offset), data_size);
+    hg_mem_copy((void *) (local_address + local_offset),
+        (const void *) (remote_address + remote_offset), (size_t) data_size);
 }
 
+#ifdef HG_HAS_CUDA
 /**
- * Bulk transfer over NA.
+ * Device memcpy (stream ordered, any combination of host and device).
  */
-static hg_return_t
-hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t *na_origin_addr,
-    hg_uint8_t origin_id, const struct hg_bulk_segment *origin_segments,
-    hg_uint32_t origin_count, na_mem_handle_t **origin_mem_handles,
-    hg_uint8_t origin_flags, hg_size_t origin_offset,
-    const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
-    na_mem_handle_t **local_mem_handles, hg_uint8_t local_flags,
-    hg_size_t local_offset, hg_size_t size,
-    struct hg_bulk_op_id *hg_bulk_op_id);
-
-/**
+static HG_INLINE void
+hg_bulk_cuda_memcpy_put(hg_ptr_t local_address, hg_size_t local_offset,
+    hg_ptr_t remote_address, hg_size_t remote_offset, hg_size_t data_size)
+{
+    (void) cudaMemcpyAsync((void *) (remote_address + remote_offset),
+        (const void *) (local_address + local_offset), (size_t) data_size,
+        cudaMemcpyDefault, cudaStreamPerThread);
+}
+
+/**
+ * Device memcpy (stream ordered, any combination of host and device).
+ */
+static HG_INLINE void
+hg_bulk_cuda_memcpy_get(hg_ptr_t local_address, hg_size_t local_offset,
+    hg_ptr_t remote_address, hg_size_t remote_offset, hg_size_t data_size)
+{
+    (void) cudaMemcpyAsync((void *) (local_address + local_offset),
+        (const void *) (remote_address + remote_offset), (size_t) data_size,
+        cudaMemcpyDefault, cudaStreamPerThread);
+}
+#endif
+
+/**
+ * Bulk transfer over NA.
+ */
+static hg_return_t
+hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t *na_origin_addr,
+    hg_uint8_t origin_id, const struct hg_bulk_segment *origin_segments,
+    hg_uint32_t origin_count, na_mem_handle_t **origin_mem_handles,
+    hg_uint8_t origin_flags, hg_size_t origin_offset,
+    const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
+    na_mem_handle_t **local_mem_handles, hg_uint8_t local_flags,
+    hg_size_t local_offset, hg_size_t size,
+    struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Get mask of rails that transfer may be split across (bit 0 is the default
+ * NA class, only bit 0 is set if transfer cannot be split).
+ */
+static hg_uint8_t
+hg_bulk_transfer_rail_mask(const struct hg_bulk *hg_bulk_origin,
+    const struct hg_bulk *hg_bulk_local, hg_size_t size,
+    const struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Split transfer across rails in proportion to their measured bandwidth.
+ */
+static void
+hg_bulk_transfer_rail_split(struct hg_core_rails *rails,
+    hg_uint8_t rail_mask, hg_size_t size, hg_size_t *sizes);
+
+/**
+ * Bulk transfer over NA split across rails.
+ */
+static hg_return_t
+hg_bulk_transfer_rails(hg_bulk_op_t op, na_addr_t *na_origin_addr,
+    hg_uint8_t origin_id, struct hg_bulk *hg_bulk_origin,
+    hg_size_t origin_offset, struct hg_bulk *hg_bulk_local,
+    hg_size_t local_offset, hg_size_t size, hg_uint8_t rail_mask,
+    struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
  * Get number of required operations to transfer data.
  */
 static hg_uint32_t
@@ -446,7 +1109,7 @@ hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
     hg_size_t origin_segment_start_offset,
     const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
     hg_size_t local_segment_start_index, hg_size_t local_segment_start_offset,
-    hg_size_t size);
+    hg_size_t size, hg_size_t chunk_size);
 
 /**
  * Transfer segments.
@@ -463,6 +1126,55 @@ hg_bulk_transfer_segments_na(na_class_t *na_class, na_context_t *na_context,
     hg_size_t local_segment_start_offset, hg_size_t size,
     na_op_id_t *na_op_ids[], hg_uint32_t na_op_count);
 
+/**
+ * Transfer segments as a single batched NA operation.
+ */
+static hg_return_t
+hg_bulk_transfer_batch_na(na_class_t *na_class, na_context_t *na_context,
+    na_cb_type_t na_cb_type, na_cb_t callback, void *arg,
+    na_addr_t *origin_addr, uint8_t origin_id,
+    const struct hg_bulk_segment *origin_segments, hg_uint32_t origin_count,
+    na_mem_handle_t **origin_mem_handles, hg_size_t origin_segment_start_index,
+    hg_size_t origin_segment_start_offset,
+    const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
+    na_mem_handle_t **local_mem_handles, hg_size_t local_segment_start_index,
+    hg_size_t local_segment_start_offset, hg_size_t size,
+    hg_uint32_t segment_count, na_op_id_t *na_op_id);
+
+/**
+ * Pipelined bulk transfer over NA.
+ */
+static hg_return_t
+hg_bulk_transfer_pipeline_na(na_bulk_op_t na_bulk_op, na_addr_t *na_origin_addr,
+    hg_uint8_t origin_id, const struct hg_bulk_segment *origin_segments,
+    hg_uint32_t origin_count, na_mem_handle_t **origin_mem_handles,
+    hg_uint8_t origin_flags, hg_size_t origin_offset,
+    const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
+    na_mem_handle_t **local_mem_handles, hg_uint8_t local_flags,
+    hg_size_t local_offset, hg_size_t size, hg_size_t chunk_size,
+    hg_uint32_t max_inflight, hg_bulk_na_op_id_t *hg_bulk_na_op_ids,
+    struct hg_bulk_op_id *hg_bulk_op_id);
+
+/**
+ * Issue next chunk of a pipelined transfer on slot. Returns HG_FALSE if no
+ * chunk was issued.
+ */
+static hg_bool_t
+hg_bulk_pipeline_next(struct hg_bulk_pipeline_slot *slot);
+
+/**
+ * Release slot and complete transfer once no slot remains in use.
+ */
+static void
+hg_bulk_pipeline_retire(
+    struct hg_bulk_pipeline *pipeline, hg_bool_t self_notify);
+
+/**
+ * Free pipeline.
+ */
+static void
+hg_bulk_pipeline_free(struct hg_bulk_pipeline *pipeline);
+
 /**
  * NA_Put wrapper
  */
@@ -499,6 +1211,24 @@ hg_bulk_na_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
 static void
 hg_bulk_transfer_cb(const struct na_cb_info *callback_info);
 
+/**
+ * Rail stripe transfer callback.
+ */
+static void
+hg_bulk_transfer_rail_cb(const struct na_cb_info *callback_info);
+
+/**
+ * Atomic operation callback.
+ */
+static void
+hg_bulk_atomic_cb(const struct na_cb_info *callback_info);
+
+/**
+ * Pipelined transfer callback.
+ */
+static void
+hg_bulk_transfer_pipeline_cb(const struct na_cb_info *callback_info);
+
 /**
  * Complete operation ID.
  */
@@ -506,12 +1236,57 @@ static void
 hg_bulk_complete(struct hg_bulk_op_id *hg_bulk_op_id, hg_return_t ret,
     hg_bool_t self_notify);
 
+/**
+ * Complete one transfer of a list, completing the list once all transfers
+ * have completed.
+ */
+static void
+hg_bulk_list_complete_one(struct hg_bulk_op_id *hg_bulk_op_id,
+    hg_return_t ret, hg_bool_t self_notify);
+
+/**
+ * Fill stats of completed operation ID.
+ */
+static void
+hg_bulk_stats_fill(struct hg_bulk_op_id *hg_bulk_op_id, hg_return_t ret);
+
+/**
+ * Remove operation ID from expiry list of its pool.
+ */
+static void
+hg_bulk_expiry_remove(struct hg_bulk_op_id *hg_bulk_op_id);
+
 /**
  * Cancel operation ID.
  */
 static hg_return_t
 hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id);
 
+/**
+ * Request next chunk of stream into its slot. Errors are returned in order by
+ * HG_Bulk_stream_next_chunk().
+ */
+static void
+hg_bulk_stream_issue(struct hg_bulk_stream *hg_bulk_stream);
+
+/**
+ * Stream transfer callback.
+ */
+static hg_return_t
+hg_bulk_stream_cb(const struct hg_cb_info *callback_info);
+
+/**
+ * Free stream once all references are released.
+ */
+static void
+hg_bulk_stream_free(struct hg_bulk_stream *hg_bulk_stream);
+
+/**
+ * Transfer callback of HG_Bulk_transfer_wait().
+ */
+static hg_return_t
+hg_bulk_transfer_wait_cb(const struct hg_cb_info *callback_info);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -519,6 +1294,12 @@ hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id);
 /* Specific log outlets */
 static HG_LOG_SUBSYS_DECL_REGISTER(bulk, hg);
 
+#ifdef HG_HAS_CUDA
+/* Number of device handles created (origin of transfers to self may be a
+ * deserialized handle that does not carry its memory type) */
+static hg_atomic_int32_t hg_bulk_device_count_g = HG_ATOMIC_VAR_INIT(0);
+#endif
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
@@ -531,13 +1312,34 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
 #ifdef NA_HAS_SM
     na_class_t *na_sm_class = HG_Core_class_get_na_sm(core_class);
 #endif
+    hg_uint32_t buf_count = count;
+    hg_size_t file_chunk_size = 0;
     hg_return_t ret;
 
     hg_bulk = (struct hg_bulk *) calloc(1, sizeof(*hg_bulk));
     HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk == NULL, error, ret, HG_NOMEM,
         "Could not allocate handle");
 
+    if (attrs->file_backed) {
+        hg_uint32_t max_inflight;
+
+        /* Registering a whole file mapping would fault in every page, chunks
+         * are registered as transfers reach them */
+        hg_core_class_get_bulk_pipeline_info(
+            core_class, &file_chunk_size, &max_inflight);
+        if (file_chunk_size == 0)
+            file_chunk_size = HG_BULK_FILE_CHUNK_SIZE;
+        count = hg_bulk_file_segments(
+            bufs, lens, buf_count, file_chunk_size, NULL);
+    } else if (bufs && count > 1) {
+        /* Segments that are contiguous in memory are registered and
+         * transferred as one */
+        count = hg_bulk_coalesce_count(bufs, lens, buf_count);
+    }
+
+    /* Counted from here on as releasing the handle uncounts it */
     hg_bulk->core_class = core_class;
+    hg_core_bulk_incr(core_class);
     hg_bulk->na_class = na_class;
 #ifdef NA_HAS_SM
     hg_bulk->na_sm_class = na_sm_class;
@@ -545,6 +1347,15 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
     hg_bulk->desc.info.segment_count = count;
     hg_bulk->desc.info.flags = flags;
     hg_bulk->attrs = *attrs;
+#ifdef HG_HAS_CUDA
+    if (attrs->mem_type != HG_MEM_TYPE_HOST)
+        hg_atomic_incr32(&hg_bulk_device_count_g);
+#endif
+    hg_bulk->lazy = attrs->file_backed ||
+                    (attrs->mem_type == HG_MEM_TYPE_HOST &&
+                        hg_core_class_get_bulk_lazy_register(core_class));
+    if (hg_bulk->lazy)
+        hg_thread_mutex_init(&hg_bulk->reg_mutex);
     hg_atomic_init32(&hg_bulk->ref_count, 1);
 
     if (count > HG_BULK_STATIC_MAX) {
@@ -575,12 +1386,25 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
             segments[i].len = lens[i];
             hg_bulk->desc.info.len += lens[i];
         }
-    } else {
+    } else if (attrs->file_backed) {
         hg_uint32_t i;
 
-        for (i = 0; i < count; i++) {
-            segments[i].base = (hg_ptr_t) bufs[i];
-            segments[i].len = lens[i];
+        (void) hg_bulk_file_segments(
+            bufs, lens, buf_count, file_chunk_size, segments);
+        for (i = 0; i < buf_count; i++)
+            hg_bulk->desc.info.len += lens[i];
+    } else {
+        hg_uint32_t i, j = 0;
+
+        for (i = 0; i < buf_count; i++) {
+            if (j > 0 && segments[j - 1].base + segments[j - 1].len ==
+                             (hg_ptr_t) bufs[i])
+                segments[j - 1].len += lens[i];
+            else {
+                segments[j].base = (hg_ptr_t) bufs[i];
+                segments[j].len = lens[i];
+                j++;
+            }
             hg_bulk->desc.info.len += lens[i];
         }
     }
@@ -589,8 +1413,49 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
         "Creating bulk handle with %u segment(s), len is %" PRIu64 " bytes",
         hg_bulk->desc.info.segment_count, hg_bulk->desc.info.len);
 
+    if (hg_bulk->lazy && !attrs->file_backed) {
+        /* Only registered once handle is used with a remote peer */
+        hg_bulk->deferred[0] = HG_TRUE;
+#ifdef NA_HAS_SM
+        hg_bulk->deferred[1] = (na_sm_class != NULL);
+#endif
+    } else {
+        ret = hg_bulk_mem_register(hg_bulk);
+        HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not register memory");
+    }
+    hg_bulk->registered = HG_TRUE;
+
+    *hg_bulk_p = hg_bulk;
+
+    return HG_SUCCESS;
+
+error:
+    hg_bulk_free(hg_bulk);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_mem_register(struct hg_bulk *hg_bulk)
+{
+    struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
+    struct hg_bulk_reg_cache *hg_bulk_reg_cache =
+        hg_core_class_get_bulk_reg_cache(hg_bulk->core_class);
+    const struct hg_core_rails *rails =
+        hg_core_class_get_rails(hg_bulk->core_class);
+    const struct hg_bulk_attr *attrs = &hg_bulk->attrs;
+    na_class_t *na_class = hg_bulk->na_class;
+#ifdef NA_HAS_SM
+    na_class_t *na_sm_class = hg_bulk->na_sm_class;
+#endif
+    hg_uint32_t count = hg_bulk->desc.info.segment_count;
+    hg_uint8_t flags = hg_bulk->desc.info.flags & HG_BULK_READWRITE;
+    hg_return_t ret;
+
     /* Query max segment limit that NA plugin can handle */
-    if ((count > 1) && na_class->ops->mem_handle_create_segments) {
+    if ((count > 1) && !attrs->file_backed &&
+        na_class->ops->mem_handle_create_segments) {
         size_t max_segments =
             na_class->ops->mem_handle_get_max_segments(na_class);
 
@@ -637,45 +1502,121 @@ hg_bulk_create(hg_core_class_t *core_class, hg_uint32_t count, void **bufs,
             HG_CHECK_SUBSYS_HG_ERROR(
                 bulk, error, ret, "Could not register segments with SM");
         }
+#endif
+    } else if (hg_bulk_reg_cache != NULL && count == 1 &&
+               !(hg_bulk->desc.info.flags & HG_BULK_ALLOC) &&
+               segments[0].base != (hg_ptr_t) NULL && !attrs->file_backed) {
+        /* Re-use cached registration of single segment if any */
+        ret = hg_bulk_reg_cache_get(hg_bulk_reg_cache, hg_bulk, &segments[0],
+            flags, &hg_bulk->reg_entry);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not get cached registration");
+
+        hg_bulk->na_mem_descs.handles.s[0] = hg_bulk->reg_entry->na_mem_handle;
+        hg_bulk->na_mem_descs.serialize_sizes.s[0] =
+            hg_bulk->reg_entry->na_serialize_size;
+#ifdef NA_HAS_SM
+        hg_bulk->na_sm_mem_descs.handles.s[0] =
+            hg_bulk->reg_entry->na_sm_mem_handle;
+        hg_bulk->na_sm_mem_descs.serialize_sizes.s[0] =
+            hg_bulk->reg_entry->na_sm_serialize_size;
 #endif
     } else {
         /* Register segments individually */
         ret = hg_bulk_create_na_mem_descs(&hg_bulk->na_mem_descs, na_class,
             segments, count, flags, (enum na_mem_type) attrs->mem_type,
-            attrs->device);
+            attrs->device, attrs->file_backed);
         HG_CHECK_SUBSYS_HG_ERROR(
             bulk, error, ret, "Could not create NA mem descriptors");
+        hg_bulk->deferred[0] = attrs->file_backed;
 
 #ifdef NA_HAS_SM
         if (na_sm_class) {
             ret = hg_bulk_create_na_mem_descs(&hg_bulk->na_sm_mem_descs,
                 na_sm_class, segments, count, flags,
-                (enum na_mem_type) attrs->mem_type, attrs->device);
+                (enum na_mem_type) attrs->mem_type, attrs->device,
+                attrs->file_backed);
             HG_CHECK_SUBSYS_HG_ERROR(
                 bulk, error, ret, "Could not create NA SM mem descriptors");
+            hg_bulk->deferred[1] = attrs->file_backed;
         }
 #endif
     }
-    hg_bulk->registered = HG_TRUE;
-    hg_core_bulk_incr(core_class);
 
-    *hg_bulk_p = hg_bulk;
+    /* Register with additional rails if handle may be used for striping */
+    if (rails->count > 1 && hg_bulk->desc.info.len >= rails->min_size &&
+        !attrs->file_backed &&
+        ((hg_bulk->desc.info.flags & HG_BULK_REGV) ||
+            (count == 1 && segments[0].base != (hg_ptr_t) NULL))) {
+        ret = hg_bulk_rails_register(
+            hg_bulk, rails, segments, count, flags, attrs);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not register with bulk rails");
+    }
 
     return HG_SUCCESS;
 
 error:
-    hg_bulk_free(hg_bulk);
-
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_uint32_t
+hg_bulk_coalesce_count(
+    void *const *bufs, const hg_size_t *lens, hg_uint32_t count)
+{
+    hg_uint32_t i, coalesced_count = 1;
+
+    for (i = 1; i < count; i++)
+        if ((hg_ptr_t) bufs[i - 1] + lens[i - 1] != (hg_ptr_t) bufs[i])
+            coalesced_count++;
+
+    return coalesced_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_uint32_t
+hg_bulk_file_segments(void *const *bufs, const hg_size_t *lens,
+    hg_uint32_t count, hg_size_t chunk_size, struct hg_bulk_segment *segments)
+{
+    hg_ptr_t base = 0;
+    hg_size_t len = 0;
+    hg_uint32_t i, segment_count = 0;
+
+    for (i = 0; i <= count; i++) {
+        if (i > 0 && i < count && base + len == (hg_ptr_t) bufs[i]) {
+            len += lens[i];
+            continue;
+        }
+
+        /* Cut previous run of contiguous buffers */
+        if (i > 0) {
+            do {
+                hg_size_t chunk_len = HG_BULK_MIN(len, chunk_size);
+
+                if (segments) {
+                    segments[segment_count].base = base;
+                    segments[segment_count].len = chunk_len;
+                }
+                segment_count++;
+                base += chunk_len;
+                len -= chunk_len;
+            } while (len > 0);
+        }
+
+        if (i < count) {
+            base = (hg_ptr_t) bufs[i];
+            len = lens[i];
+        }
+    }
+
+    return segment_count;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_free(struct hg_bulk *hg_bulk)
 {
-    struct hg_bulk_segment *segments;
-    hg_return_t ret;
-
     if (hg_bulk == NULL)
         return HG_SUCCESS;
 
@@ -683,8 +1624,42 @@ hg_bulk_free(struct hg_bulk *hg_bulk)
     if (hg_atomic_decr32(&hg_bulk->ref_count))
         return HG_SUCCESS;
 
+    /* Defer deregistration of memory that we registered, cached
+     * registrations are only released to the cache */
+    if (hg_bulk->registered && hg_bulk->reg_entry == NULL) {
+        struct hg_bulk_dereg_queue *hg_bulk_dereg_queue =
+            hg_core_class_get_bulk_dereg_queue(hg_bulk->core_class);
+
+        if (hg_bulk_dereg_queue != NULL) {
+            hg_thread_spin_lock(&hg_bulk_dereg_queue->lock);
+            HG_QUEUE_PUSH_TAIL(
+                &hg_bulk_dereg_queue->bulks, hg_bulk, dereg_entry);
+            hg_thread_spin_unlock(&hg_bulk_dereg_queue->lock);
+            hg_atomic_incr32(&hg_bulk_dereg_queue->count);
+
+            return HG_SUCCESS;
+        }
+    }
+
+    return hg_bulk_release(hg_bulk);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_release(struct hg_bulk *hg_bulk)
+{
+    struct hg_bulk_segment *segments;
+    hg_return_t ret;
+
     /* Deregister segments */
-    if (hg_bulk->desc.info.flags & HG_BULK_REGV ||
+    if (hg_bulk->reg_entry != NULL) {
+        /* Registration is owned by the cache */
+        ret = hg_bulk_reg_cache_put(
+            hg_core_class_get_bulk_reg_cache(hg_bulk->core_class),
+            hg_bulk->reg_entry);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not release cached registration");
+    } else if (hg_bulk->desc.info.flags & HG_BULK_REGV ||
         (hg_bulk->desc.info.segment_count == 1)) {
         if (hg_bulk->na_mem_descs.handles.s[0] != NULL) {
             ret = hg_bulk_deregister(hg_bulk->na_class,
@@ -720,6 +1695,13 @@ hg_bulk_free(struct hg_bulk *hg_bulk)
 #endif
     }
 
+    /* Release handles of additional rails */
+    if (hg_bulk->rails != NULL) {
+        ret = hg_bulk_rails_free(hg_bulk);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not release bulk rail handles");
+    }
+
     /* Free addr if any was attached to handle */
     if (hg_bulk->desc.info.flags & HG_BULK_BIND) {
         ret = HG_Core_addr_free(hg_bulk->addr);
@@ -741,6 +1723,16 @@ hg_bulk_free(struct hg_bulk *hg_bulk)
     if (hg_bulk->desc.info.segment_count > HG_BULK_STATIC_MAX)
         free(segments);
 
+    /* Release handle that eager data pointed into */
+    if (hg_bulk->pin_handle != NULL) {
+        ret = HG_Core_destroy(hg_bulk->pin_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not release pin handle");
+    }
+
+    free(hg_bulk->desc_buf);
+    if (hg_bulk->lazy)
+        hg_thread_mutex_destroy(&hg_bulk->reg_mutex);
     hg_core_bulk_decr(hg_bulk->core_class);
     free(hg_bulk);
 
@@ -754,7 +1746,8 @@ error:
 static hg_return_t
 hg_bulk_create_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
     na_class_t *na_class, struct hg_bulk_segment *segments, hg_uint32_t count,
-    hg_uint8_t flags, enum na_mem_type mem_type, uint64_t device)
+    hg_uint8_t flags, enum na_mem_type mem_type, uint64_t device,
+    hg_bool_t deferred)
 {
     na_mem_handle_t **na_mem_handles;
     size_t *na_mem_serialize_sizes;
@@ -781,6 +1774,10 @@ hg_bulk_create_na_mem_descs(struct hg_bulk_na_mem_desc *na_mem_descs,
         na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
     }
 
+    /* Segments are registered on first use */
+    if (deferred)
+        return HG_SUCCESS;
+
     for (i = 0; i < count; i++) {
         /* Skip null segments */
         if (segments[i].base == (hg_ptr_t) NULL)
@@ -979,957 +1976,2972 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_size_t
-hg_bulk_get_serialize_size(struct hg_bulk *hg_bulk, hg_uint8_t flags)
+static hg_return_t
+hg_bulk_register_deferred(struct hg_bulk *hg_bulk, na_class_t *na_class,
+    hg_uint32_t index, na_mem_handle_t **mem_handle_p)
 {
-    struct hg_bulk_desc_info *desc_info = &hg_bulk->desc.info;
-    hg_size_t ret = 0;
-
-    /* Descriptor info + segments */
-    ret = sizeof(*desc_info) +
-          desc_info->segment_count * sizeof(struct hg_bulk_segment);
-
-    /* Memory handles */
-    if ((desc_info->flags & HG_BULK_REGV) || (desc_info->segment_count == 1)) {
-        /* Only one single memory handle in that case */
-        if (hg_bulk->na_mem_descs.handles.s[0] != NULL)
-            ret += hg_bulk->na_mem_descs.serialize_sizes.s[0] + sizeof(size_t);
-
-#ifdef NA_HAS_SM
-        /* Only add SM serialized handles if we're sending over SM, otherwise
-         * skip it. */
-        if ((flags & HG_BULK_SM) &&
-            (hg_bulk->na_sm_mem_descs.handles.s[0] != NULL))
-            ret +=
-                hg_bulk->na_sm_mem_descs.serialize_sizes.s[0] + sizeof(size_t);
-#endif
-    } else {
-        ret += hg_bulk_get_serialize_size_mem_descs(
-            &hg_bulk->na_mem_descs, desc_info->segment_count);
-
-#ifdef NA_HAS_SM
-        /* Only add SM serialized handles if we're sending over SM, otherwise
-         * skip it. */
-        if ((flags & HG_BULK_SM) && hg_bulk->na_sm_class)
-            ret += hg_bulk_get_serialize_size_mem_descs(
-                &hg_bulk->na_sm_mem_descs, desc_info->segment_count);
-#endif
-    }
-
-    /* Address information (context ID + serialize size + address) */
-    if (desc_info->flags & HG_BULK_BIND) {
-        unsigned long addr_flags = 0;
+    struct hg_bulk_na_mem_desc *na_mem_descs = &hg_bulk->na_mem_descs;
+    hg_uint32_t count = hg_bulk->desc.info.segment_count;
+    hg_return_t ret;
 
 #ifdef NA_HAS_SM
-        if (flags & HG_BULK_SM)
-            addr_flags |= HG_CORE_SM;
+    if (na_class == hg_bulk->na_sm_class)
+        na_mem_descs = &hg_bulk->na_sm_mem_descs;
 #endif
-        ret += sizeof(hg_uint8_t) + sizeof(hg_size_t) +
-               HG_Core_addr_get_serialize_size(hg_bulk->addr, addr_flags);
-    }
 
-    /* Eager mode (in eager mode, the actual data will be copied) */
-    if ((flags & HG_BULK_EAGER) && (desc_info->flags & HG_BULK_READ_ONLY) &&
-        !(desc_info->flags & HG_BULK_VIRT) &&
-        (hg_bulk->attrs.mem_type == HG_MEM_TYPE_HOST))
-        ret += desc_info->len;
+    hg_thread_mutex_lock(&hg_bulk->reg_mutex);
+    ret = hg_bulk_register_deferred_locked(hg_bulk, na_class, index);
+    *mem_handle_p = (HG_BULK_MEM_HANDLES(
+        na_mem_descs, count, hg_bulk->desc.info.flags))[index];
+    hg_thread_mutex_unlock(&hg_bulk->reg_mutex);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_size_t
-hg_bulk_get_serialize_size_mem_descs(
-    struct hg_bulk_na_mem_desc *na_mem_descs, hg_uint32_t count)
+static hg_return_t
+hg_bulk_register_deferred_all(struct hg_bulk *hg_bulk, hg_uint8_t flags)
 {
-    na_mem_handle_t **na_mem_handles;
-    size_t *na_mem_serialize_sizes;
     hg_uint32_t i;
-    hg_size_t ret = 0;
+    hg_return_t ret = HG_SUCCESS;
 
-    if (count > HG_BULK_STATIC_MAX) {
-        na_mem_handles = na_mem_descs->handles.d;
-        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.d;
-    } else {
-        na_mem_handles = na_mem_descs->handles.s;
-        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
+    hg_thread_mutex_lock(&hg_bulk->reg_mutex);
+
+    /* Serialized sizes change once handles are registered */
+    if (hg_bulk->deferred[0] || ((flags & HG_BULK_SM) && hg_bulk->deferred[1]))
+        memset(hg_bulk->desc_serialize_size, 0,
+            sizeof(hg_bulk->desc_serialize_size));
+
+    /* Handles that are not file-backed are registered as a whole */
+    if (!hg_bulk->attrs.file_backed) {
+        if (hg_bulk->deferred[0]) {
+            HG_LOG_SUBSYS_DEBUG(bulk,
+                "Registering lazily registered handle (%p)", (void *) hg_bulk);
+            ret = hg_bulk_mem_register(hg_bulk);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                bulk, unlock, ret, "Could not register memory");
+        }
+        hg_bulk->deferred[0] = hg_bulk->deferred[1] = HG_FALSE;
+        goto unlock;
     }
 
-    /* Serialize sizes */
-    ret += count * sizeof(size_t);
+    /* Default NA handles are always serialized */
+    for (i = 0; hg_bulk->deferred[0] && i < hg_bulk->desc.info.segment_count;
+         i++) {
+        ret = hg_bulk_register_deferred_locked(hg_bulk, hg_bulk->na_class, i);
+        HG_CHECK_SUBSYS_HG_ERROR(bulk, unlock, ret,
+            "Could not register segment %" PRIu32, i);
+    }
+    hg_bulk->deferred[0] = HG_FALSE;
 
-    for (i = 0; i < count; i++)
-        if (na_mem_handles[i] != NULL)
-            ret += na_mem_serialize_sizes[i];
+#ifdef NA_HAS_SM
+    for (i = 0; (flags & HG_BULK_SM) && hg_bulk->deferred[1] &&
+                i < hg_bulk->desc.info.segment_count;
+         i++) {
+        ret =
+            hg_bulk_register_deferred_locked(hg_bulk, hg_bulk->na_sm_class, i);
+        HG_CHECK_SUBSYS_HG_ERROR(bulk, unlock, ret,
+            "Could not register segment %" PRIu32 " with SM", i);
+    }
+    if (flags & HG_BULK_SM)
+        hg_bulk->deferred[1] = HG_FALSE;
+#else
+    (void) flags;
+#endif
+
+unlock:
+    hg_thread_mutex_unlock(&hg_bulk->reg_mutex);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_serialize(
-    void *buf, hg_size_t buf_size, hg_uint8_t flags, struct hg_bulk *hg_bulk)
+hg_bulk_register_deferred_locked(
+    struct hg_bulk *hg_bulk, na_class_t *na_class, hg_uint32_t index)
 {
-    struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
-    char *buf_ptr = (char *) buf;
-    hg_size_t buf_size_left = buf_size;
-    struct hg_bulk_desc_info desc_info = hg_bulk->desc.info; /* Copy info */
-    hg_return_t ret;
-
-    /* Always reset bulk alloc flag (only local) */
-    desc_info.flags &= (~HG_BULK_ALLOC & 0xff);
-
-    /* Add eager flag to descriptor if requested and bulk handle is read-only,
-     * is not virtual (i.e., points to local data), and memory is not on device.
-     */
-    if ((flags & HG_BULK_EAGER) && (desc_info.flags & HG_BULK_READ_ONLY) &&
-        !(desc_info.flags & HG_BULK_VIRT) &&
-        (hg_bulk->attrs.mem_type == HG_MEM_TYPE_HOST)) {
-        HG_LOG_SUBSYS_DEBUG(bulk, "HG_BULK_EAGER flag set");
-        desc_info.flags |= HG_BULK_EAGER;
-    } else
-        desc_info.flags &= (~HG_BULK_EAGER & 0xff);
+    const struct hg_bulk_segment *segment = &(HG_BULK_SEGMENTS(hg_bulk))[index];
+    struct hg_bulk_na_mem_desc *na_mem_descs = &hg_bulk->na_mem_descs;
+    hg_uint32_t count = hg_bulk->desc.info.segment_count;
+    na_mem_handle_t **na_mem_handles;
+    size_t *na_mem_serialize_sizes;
 
 #ifdef NA_HAS_SM
-    /* Add SM flag */
-    if (flags & HG_BULK_SM) {
-        HG_LOG_SUBSYS_DEBUG(bulk, "HG_BULK_SM flag set");
-        desc_info.flags |= HG_BULK_SM;
-    } else
-        desc_info.flags &= (~HG_BULK_SM & 0xff);
+    if (na_class == hg_bulk->na_sm_class)
+        na_mem_descs = &hg_bulk->na_sm_mem_descs;
 #endif
+    if (count > HG_BULK_STATIC_MAX) {
+        na_mem_handles = na_mem_descs->handles.d;
+        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.d;
+    } else {
+        na_mem_handles = na_mem_descs->handles.s;
+        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
+    }
 
-    HG_LOG_SUBSYS_DEBUG(bulk,
-        "Serializing bulk handle with %u segment(s), len is %" PRIu64 " bytes",
-        desc_info.segment_count, desc_info.len);
+    /* Already registered or null segment */
+    if (na_mem_handles[index] != NULL || segment->base == (hg_ptr_t) NULL)
+        return HG_SUCCESS;
 
-    /* Descriptor info */
-    HG_BULK_ENCODE(error, ret, buf_ptr, buf_size_left, &desc_info,
-        struct hg_bulk_desc_info);
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Registering segment %" PRIu32 " (%" PRIu64 " bytes) of file-backed "
+        "handle (%p)",
+        index, segment->len, (void *) hg_bulk);
 
-    /* Segments */
-    HG_BULK_ENCODE_ARRAY(error, ret, buf_ptr, buf_size_left, segments,
-        struct hg_bulk_segment, desc_info.segment_count);
+    return hg_bulk_register(na_class, (void *) segment->base, segment->len,
+        hg_bulk->desc.info.flags & HG_BULK_READWRITE, NA_MEM_TYPE_HOST, 0,
+        &na_mem_handles[index], &na_mem_serialize_sizes[index]);
+}
 
-    /* TODO if eager or self flag, skip mem handles ? */
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_rails_register(struct hg_bulk *hg_bulk,
+    const struct hg_core_rails *rails, struct hg_bulk_segment *segments,
+    hg_uint32_t count, hg_uint8_t flags, const struct hg_bulk_attr *attrs)
+{
+    struct hg_bulk_rails *hg_bulk_rails;
+    hg_uint8_t i;
+    hg_return_t ret;
 
-    /* Add the NA memory handles */
-    if ((desc_info.flags & HG_BULK_REGV) || (desc_info.segment_count == 1)) {
-        /* N.B. skip serialize size if no handle */
-        if (hg_bulk->na_mem_descs.handles.s[0] != NULL) {
-            na_return_t na_ret;
+    hg_bulk_rails = (struct hg_bulk_rails *) calloc(1, sizeof(*hg_bulk_rails));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_rails == NULL, error, ret, HG_NOMEM,
+        "Could not allocate rail handles");
+    hg_bulk_rails->count = rails->count;
+    hg_bulk->rails = hg_bulk_rails;
 
-            HG_LOG_SUBSYS_DEBUG(bulk, "Serializing single NA memory handle");
+    for (i = 1; i < rails->count; i++) {
+        na_class_t *na_class = rails->rail[i].na_class;
 
-            HG_BULK_ENCODE(error, ret, buf_ptr, buf_size_left,
-                &hg_bulk->na_mem_descs.serialize_sizes.s[0], size_t);
+        /* Handle is reached through the self address of that rail */
+        hg_bulk_rails->addr_sizes[i] = rails->rail[i].self_addr_size;
 
-            na_ret = NA_Mem_handle_serialize(hg_bulk->na_class, buf_ptr,
-                buf_size_left, hg_bulk->na_mem_descs.handles.s[0]);
-            HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
-                (hg_return_t) na_ret, "Could not serialize memory handle (%s)",
-                NA_Error_to_string(na_ret));
-            buf_ptr += hg_bulk->na_mem_descs.serialize_sizes.s[0];
-            buf_size_left -= hg_bulk->na_mem_descs.serialize_sizes.s[0];
-        }
+        if (hg_bulk->desc.info.flags & HG_BULK_REGV) {
+            /* Rail is not used for that handle if it cannot register
+             * segments */
+            if (!na_class->ops->mem_handle_create_segments ||
+                na_class->ops->mem_handle_get_max_segments(na_class) < count)
+                continue;
 
-#ifdef NA_HAS_SM
-        /* Only add SM serialized handles if we're sending over SM, otherwise
-         * skip then. */
-        if ((desc_info.flags & HG_BULK_SM) &&
-            (hg_bulk->na_sm_mem_descs.handles.s[0] != NULL)) {
-            na_return_t na_ret;
+            ret = hg_bulk_register_segments(na_class,
+                (struct na_segment *) segments, count, flags,
+                (enum na_mem_type) attrs->mem_type, attrs->device,
+                &hg_bulk_rails->handles[i], &hg_bulk_rails->serialize_sizes[i]);
+        } else
+            ret = hg_bulk_register(na_class, (void *) segments[0].base,
+                segments[0].len, flags, (enum na_mem_type) attrs->mem_type,
+                attrs->device, &hg_bulk_rails->handles[i],
+                &hg_bulk_rails->serialize_sizes[i]);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not register segments with rail %u", i);
+    }
 
-            HG_BULK_ENCODE(error, ret, buf_ptr, buf_size_left,
-                &hg_bulk->na_sm_mem_descs.serialize_sizes.s[0], size_t);
+    return HG_SUCCESS;
 
-            na_ret = NA_Mem_handle_serialize(hg_bulk->na_sm_class, buf_ptr,
-                buf_size_left, hg_bulk->na_sm_mem_descs.handles.s[0]);
-            HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
-                (hg_return_t) na_ret,
-                "Could not serialize SM memory handle (%s)",
-                NA_Error_to_string(na_ret));
-            buf_ptr += hg_bulk->na_sm_mem_descs.serialize_sizes.s[0];
-            buf_size_left -= hg_bulk->na_sm_mem_descs.serialize_sizes.s[0];
-        }
-#endif
-    } else {
-        HG_LOG_SUBSYS_DEBUG(bulk, "Serializing %u NA memory handle(s)",
-            desc_info.segment_count);
+error:
+    return ret;
+}
 
-        ret = hg_bulk_serialize_mem_descs(hg_bulk->na_class, &buf_ptr,
-            &buf_size_left, &hg_bulk->na_mem_descs, segments,
-            desc_info.segment_count);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            bulk, error, ret, "Could not serialize NA mem descriptors");
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_rails_free(struct hg_bulk *hg_bulk)
+{
+    const struct hg_core_rails *rails =
+        hg_core_class_get_rails(hg_bulk->core_class);
+    struct hg_bulk_rails *hg_bulk_rails = hg_bulk->rails;
+    hg_uint8_t i;
+    hg_return_t ret;
 
-#ifdef NA_HAS_SM
-        /* Only add SM serialized handles if we're sending over SM, otherwise
-         * skip it. */
-        if ((desc_info.flags & HG_BULK_SM) && hg_bulk->na_sm_class) {
-            ret = hg_bulk_serialize_mem_descs(hg_bulk->na_sm_class, &buf_ptr,
-                &buf_size_left, &hg_bulk->na_sm_mem_descs, segments,
-                desc_info.segment_count);
-            HG_CHECK_SUBSYS_HG_ERROR(
-                bulk, error, ret, "Could not serialize NA SM mem descriptors");
+    for (i = 1; i < hg_bulk_rails->count; i++) {
+        if (hg_bulk_rails->handles[i] != NULL) {
+            ret = hg_bulk_deregister(rails->rail[i].na_class,
+                hg_bulk_rails->handles[i], hg_bulk->registered);
+            HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret,
+                "Could not deregister segment with rail %u", i);
+            hg_bulk_rails->handles[i] = NULL;
+        }
+        if (hg_bulk_rails->addrs[i] != NULL) {
+            NA_Addr_free(rails->rail[i].na_class, hg_bulk_rails->addrs[i]);
+            hg_bulk_rails->addrs[i] = NULL;
         }
-#endif
     }
 
-    /* Address information */
-    if (desc_info.flags & HG_BULK_BIND) {
-        hg_size_t serialize_size;
-        unsigned long addr_flags = 0;
+    free(hg_bulk_rails);
+    hg_bulk->rails = NULL;
 
-        HG_LOG_SUBSYS_DEBUG(
-            bulk, "HG_BULK_BIND flag set, serializing address information");
+    return HG_SUCCESS;
 
-#ifdef NA_HAS_SM
-        if (flags & HG_BULK_SM)
-            addr_flags |= HG_CORE_SM;
-#endif
+error:
+    return ret;
+}
 
-        serialize_size =
-            HG_Core_addr_get_serialize_size(hg_bulk->addr, addr_flags);
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_bulk_reg_key_hash(hg_hash_table_key_t key)
+{
+    const struct hg_bulk_reg_key *reg_key =
+        (const struct hg_bulk_reg_key *) key;
 
-        HG_BULK_ENCODE(
-            error, ret, buf_ptr, buf_size_left, &serialize_size, hg_size_t);
+    /* Low bits of the address are usually aligned */
+    return (unsigned int) ((reg_key->base >> 6) ^ (reg_key->base >> 32) ^
+                           reg_key->len);
+}
 
-        ret = HG_Core_addr_serialize(
-            buf_ptr, buf_size_left, addr_flags, hg_bulk->addr);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            bulk, error, ret, "Could not serialize address");
-        buf_ptr += serialize_size;
-        buf_size_left -= serialize_size;
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int
+hg_bulk_reg_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    const struct hg_bulk_reg_key *reg_key1 =
+        (const struct hg_bulk_reg_key *) key1;
+    const struct hg_bulk_reg_key *reg_key2 =
+        (const struct hg_bulk_reg_key *) key2;
+
+    return reg_key1->base == reg_key2->base && reg_key1->len == reg_key2->len &&
+           reg_key1->device == reg_key2->device &&
+           reg_key1->flags == reg_key2->flags &&
+           reg_key1->mem_type == reg_key2->mem_type;
+}
 
-        /* Add context ID */
-        HG_BULK_ENCODE(error, ret, buf_ptr, buf_size_left, &hg_bulk->context_id,
-            hg_uint8_t);
-    }
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_reg_cache_create(hg_size_t max_size,
+    struct hg_bulk_dereg_queue *hg_bulk_dereg_queue,
+    struct hg_bulk_reg_cache **hg_bulk_reg_cache_p)
+{
+    struct hg_bulk_reg_cache *hg_bulk_reg_cache = NULL;
+    hg_return_t ret;
 
-    /* Add the serialized data if eager mode is requested */
-    if (desc_info.flags & HG_BULK_EAGER) {
-        hg_uint32_t i;
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Creating registration cache of %" PRIu64 " bytes", max_size);
 
-        HG_LOG_SUBSYS_DEBUG(bulk, "Serializing eager bulk data, %u segment(s)",
-            desc_info.segment_count);
-        for (i = 0; i < desc_info.segment_count; i++) {
-            if (!segments[i].len)
-                continue;
+    hg_bulk_reg_cache =
+        (struct hg_bulk_reg_cache *) calloc(1, sizeof(*hg_bulk_reg_cache));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_reg_cache == NULL, error, ret,
+        HG_NOMEM, "Could not allocate registration cache");
 
-            HG_BULK_ENCODE_ARRAY(error, ret, buf_ptr, buf_size_left,
-                (const void *) segments[i].base, char, segments[i].len);
-        }
-    }
+    hg_bulk_reg_cache->table =
+        hg_hash_table_new(hg_bulk_reg_key_hash, hg_bulk_reg_key_equal);
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_reg_cache->table == NULL, error, ret,
+        HG_NOMEM, "Could not allocate registration cache table");
+
+    hg_thread_mutex_init(&hg_bulk_reg_cache->mutex);
+    HG_LIST_INIT(&hg_bulk_reg_cache->list);
+    hg_bulk_reg_cache->max_size = max_size;
+    hg_bulk_reg_cache->dereg_queue = hg_bulk_dereg_queue;
+
+    *hg_bulk_reg_cache_p = hg_bulk_reg_cache;
 
     return HG_SUCCESS;
 
 error:
+    free(hg_bulk_reg_cache);
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_bulk_serialize_mem_descs(na_class_t *na_class, char **buf_p,
-    hg_size_t *buf_size_left_p, struct hg_bulk_na_mem_desc *na_mem_descs,
-    const struct hg_bulk_segment *segments, hg_uint32_t count)
+hg_return_t
+hg_bulk_reg_cache_destroy(struct hg_bulk_reg_cache *hg_bulk_reg_cache)
 {
-    na_mem_handle_t **na_mem_handles;
-    size_t *na_mem_serialize_sizes;
+    struct hg_bulk_reg_entry *entry;
     hg_return_t ret;
-    hg_uint32_t i;
-
-    if (count > HG_BULK_STATIC_MAX) {
-        na_mem_handles = na_mem_descs->handles.d;
-        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.d;
-    } else {
-        na_mem_handles = na_mem_descs->handles.s;
-        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
-    }
 
-    /* Encode serialize sizes */
-    HG_BULK_ENCODE_ARRAY(error, ret, *buf_p, *buf_size_left_p,
-        na_mem_serialize_sizes, size_t, count);
+    HG_LOG_SUBSYS_DEBUG(bulk, "Free registration cache (%p)",
+        (void *) hg_bulk_reg_cache);
 
-    for (i = 0; i < count; i++) {
-        na_return_t na_ret;
+    /* Registrations still referenced by bulk handles cannot be released */
+    HG_LIST_FOREACH (entry, &hg_bulk_reg_cache->list, entry)
+        HG_CHECK_SUBSYS_ERROR(bulk, entry->ref_count > 0, error, ret, HG_BUSY,
+            "Cached registration (%p, %" PRIu64 ") still in use (%" PRIu32
+            " references)",
+            (void *) entry->key.base, entry->key.len, entry->ref_count);
 
-        /* Skip null segments */
-        if (segments[i].base == (hg_ptr_t) NULL)
-            continue;
+    entry = HG_LIST_FIRST(&hg_bulk_reg_cache->list);
+    while (entry) {
+        struct hg_bulk_reg_entry *entry_next = HG_LIST_NEXT(entry, entry);
 
-        na_ret = NA_Mem_handle_serialize(
-            na_class, *buf_p, *buf_size_left_p, na_mem_handles[i]);
-        HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not serialize memory handle (%s)",
-            NA_Error_to_string(na_ret));
+        HG_LIST_REMOVE(entry, entry);
+        (void) hg_bulk_reg_entry_free(entry);
 
-        *buf_p += na_mem_serialize_sizes[i];
-        *buf_size_left_p -= na_mem_serialize_sizes[i];
+        entry = entry_next;
     }
 
+    hg_hash_table_free(hg_bulk_reg_cache->table);
+    hg_thread_mutex_destroy(&hg_bulk_reg_cache->mutex);
+    free(hg_bulk_reg_cache);
+
     return HG_SUCCESS;
 
 error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_reg_cache_invalidate(
+    struct hg_bulk_reg_cache *hg_bulk_reg_cache, hg_ptr_t base, hg_size_t len)
+{
+    struct hg_bulk_reg_entry *entry;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_thread_mutex_lock(&hg_bulk_reg_cache->mutex);
+
+    entry = HG_LIST_FIRST(&hg_bulk_reg_cache->list);
+    while (entry) {
+        struct hg_bulk_reg_entry *entry_next = HG_LIST_NEXT(entry, entry);
+
+        /* Remove any entry that overlaps the range */
+        if (entry->key.base < base + len &&
+            base < entry->key.base + entry->key.len) {
+            HG_LOG_SUBSYS_DEBUG(bulk,
+                "Invalidating cached registration (%p, %" PRIu64 ")",
+                (void *) entry->key.base, entry->key.len);
+
+            hg_bulk_reg_cache_remove(hg_bulk_reg_cache, entry);
+
+            /* Entries still in use are freed once released */
+            if (entry->ref_count == 0) {
+                hg_return_t free_ret = hg_bulk_reg_entry_free(entry);
+                if (free_ret != HG_SUCCESS)
+                    ret = free_ret;
+            }
+        }
+
+        entry = entry_next;
+    }
+
+    hg_thread_mutex_unlock(&hg_bulk_reg_cache->mutex);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_p,
-    const void *buf, hg_size_t buf_size)
+hg_bulk_reg_cache_get(struct hg_bulk_reg_cache *hg_bulk_reg_cache,
+    struct hg_bulk *hg_bulk, const struct hg_bulk_segment *segment,
+    hg_uint8_t flags, struct hg_bulk_reg_entry **entry_p)
 {
-    struct hg_bulk *hg_bulk = NULL;
-    struct hg_bulk_segment *segments;
-    const char *buf_ptr = (const char *) buf;
-    hg_size_t buf_size_left = buf_size;
+    struct hg_bulk_reg_key key = {.base = segment->base,
+        .len = segment->len,
+        .device = hg_bulk->attrs.device,
+        .flags = flags,
+        .mem_type = (hg_uint8_t) hg_bulk->attrs.mem_type};
+    struct hg_bulk_reg_entry *entry;
     hg_return_t ret;
 
-    hg_bulk = (struct hg_bulk *) calloc(1, sizeof(*hg_bulk));
-    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk == NULL, error, ret, HG_NOMEM,
-        "Could not allocate handle");
+    hg_thread_mutex_lock(&hg_bulk_reg_cache->mutex);
 
-    hg_bulk->core_class = core_class;
-    hg_bulk->na_class = HG_Core_class_get_na(core_class);
-    hg_bulk->registered = HG_FALSE;
-    hg_atomic_init32(&hg_bulk->ref_count, 1);
+    entry = (struct hg_bulk_reg_entry *) hg_hash_table_lookup(
+        hg_bulk_reg_cache->table, (hg_hash_table_key_t) &key);
+    if (entry != HG_HASH_TABLE_NULL) {
+        HG_LOG_SUBSYS_DEBUG(bulk,
+            "Re-using cached registration (%p, %" PRIu64 ")",
+            (void *) key.base, key.len);
+    } else {
+        int rc;
 
-    /* Descriptor info */
-    HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left, &hg_bulk->desc.info,
-        struct hg_bulk_desc_info);
+        entry = (struct hg_bulk_reg_entry *) calloc(1, sizeof(*entry));
+        HG_CHECK_SUBSYS_ERROR(bulk, entry == NULL, error, ret, HG_NOMEM,
+            "Could not allocate registration cache entry");
+        entry->key = key;
+        entry->na_class = hg_bulk->na_class;
 
-    HG_LOG_SUBSYS_DEBUG(bulk,
-        "Deserializing bulk handle with %u segment(s), len is %" PRIu64
-        " bytes",
-        hg_bulk->desc.info.segment_count, hg_bulk->desc.info.len);
+        ret = hg_bulk_register(hg_bulk->na_class, (void *) key.base,
+            (size_t) key.len, flags, (enum na_mem_type) key.mem_type,
+            key.device, &entry->na_mem_handle, &entry->na_serialize_size);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not register segment");
 
 #ifdef NA_HAS_SM
-    /* Use SM classes if requested */
-    if (hg_bulk->desc.info.flags & HG_BULK_SM) {
-        HG_LOG_SUBSYS_DEBUG(bulk, "HG_BULK_SM flag is set");
-        hg_bulk->na_sm_class = HG_Core_class_get_na_sm(core_class);
-        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk->na_sm_class == NULL, error, ret,
-            HG_PROTOCOL_ERROR, "SM class is not set");
-    }
+        if (hg_bulk->na_sm_class) {
+            entry->na_sm_class = hg_bulk->na_sm_class;
+            ret = hg_bulk_register(hg_bulk->na_sm_class, (void *) key.base,
+                (size_t) key.len, flags, (enum na_mem_type) key.mem_type,
+                key.device, &entry->na_sm_mem_handle,
+                &entry->na_sm_serialize_size);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                bulk, error, ret, "Could not register segment with SM");
+        }
 #endif
 
-    /* Segments */
-    if (hg_bulk->desc.info.segment_count > HG_BULK_STATIC_MAX) {
-        /* Allocate segments */
-        hg_bulk->desc.segments.d = (struct hg_bulk_segment *) calloc(
-            hg_bulk->desc.info.segment_count, sizeof(struct hg_bulk_segment));
-        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk->desc.segments.d == NULL, error,
-            ret, HG_NOMEM, "Could not allocate segment array");
+        rc = hg_hash_table_insert(hg_bulk_reg_cache->table,
+            (hg_hash_table_key_t) &entry->key, (hg_hash_table_value_t) entry);
+        HG_CHECK_SUBSYS_ERROR(bulk, rc == 0, error, ret, HG_NOMEM,
+            "Could not insert registration into cache");
+        HG_LIST_INSERT_HEAD(&hg_bulk_reg_cache->list, entry, entry);
+        hg_bulk_reg_cache->size += key.len;
 
-        segments = hg_bulk->desc.segments.d;
-    } else
-        segments = hg_bulk->desc.segments.s;
-    HG_BULK_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left, segments,
-        struct hg_bulk_segment, hg_bulk->desc.info.segment_count);
+        HG_LOG_SUBSYS_DEBUG(bulk,
+            "Added registration (%p, %" PRIu64
+            ") to cache, cache size is %" PRIu64 " bytes",
+            (void *) key.base, key.len, hg_bulk_reg_cache->size);
+    }
 
-    /* Get the NA memory handles */
-    if (hg_bulk->desc.info.flags & HG_BULK_REGV ||
-        (hg_bulk->desc.info.segment_count == 1)) {
-        /* Always deserialize handle if HG_BULK_REGV is set */
-        if ((segments[0].base != (hg_ptr_t) NULL) ||
-            (hg_bulk->desc.info.flags & HG_BULK_REGV)) {
-            na_return_t na_ret;
+    entry->ref_count++;
+    entry->last_used = hg_bulk_reg_cache->use_count++;
 
-            HG_LOG_SUBSYS_DEBUG(bulk, "Deserializing single NA memory handle");
+    /* Make room if needed, entries that are in use cannot be evicted */
+    if (hg_bulk_reg_cache->size > hg_bulk_reg_cache->max_size) {
+        hg_return_t evict_ret = hg_bulk_reg_cache_evict(hg_bulk_reg_cache);
+        HG_CHECK_SUBSYS_ERROR_DONE(bulk, evict_ret != HG_SUCCESS,
+            "Could not evict cached registrations");
+    }
 
-            HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left,
-                &hg_bulk->na_mem_descs.serialize_sizes.s[0], size_t);
+    hg_thread_mutex_unlock(&hg_bulk_reg_cache->mutex);
 
-            na_ret = NA_Mem_handle_deserialize(hg_bulk->na_class,
-                &hg_bulk->na_mem_descs.handles.s[0], buf_ptr, buf_size_left);
-            HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
-                (hg_return_t) na_ret,
-                "Could not deserialize memory handle (%s)",
-                NA_Error_to_string(na_ret));
-            buf_ptr += hg_bulk->na_mem_descs.serialize_sizes.s[0];
-            buf_size_left -= hg_bulk->na_mem_descs.serialize_sizes.s[0];
+    *entry_p = entry;
 
-#ifdef NA_HAS_SM
-            /* Only deserialize handles if we were sending over SM */
-            if (hg_bulk->desc.info.flags & HG_BULK_SM) {
-                HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left,
-                    &hg_bulk->na_sm_mem_descs.serialize_sizes.s[0], size_t);
+    return HG_SUCCESS;
 
-                na_ret = NA_Mem_handle_deserialize(hg_bulk->na_sm_class,
-                    &hg_bulk->na_sm_mem_descs.handles.s[0], buf_ptr,
-                    buf_size_left);
-                HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
-                    (hg_return_t) na_ret,
-                    "Could not deserialize SM memory handle (%s)",
-                    NA_Error_to_string(na_ret));
-                buf_ptr += hg_bulk->na_sm_mem_descs.serialize_sizes.s[0];
-                buf_size_left -= hg_bulk->na_sm_mem_descs.serialize_sizes.s[0];
-            }
-#endif
-        }
-    } else {
-        HG_LOG_SUBSYS_DEBUG(bulk, "Deserializing %u NA memory handle(s)",
-            hg_bulk->desc.info.segment_count);
+error:
+    hg_thread_mutex_unlock(&hg_bulk_reg_cache->mutex);
+    if (entry != NULL)
+        (void) hg_bulk_reg_entry_free(entry);
 
-        ret = hg_bulk_deserialize_mem_descs(hg_bulk->na_class, &buf_ptr,
-            &buf_size_left, &hg_bulk->na_mem_descs, segments,
-            hg_bulk->desc.info.segment_count);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            bulk, error, ret, "Could not deserialize NA mem descriptors");
+    return ret;
+}
 
-#ifdef NA_HAS_SM
-        /* Only deserialize handles if we were sending over SM */
-        if (hg_bulk->desc.info.flags & HG_BULK_SM) {
-            ret = hg_bulk_deserialize_mem_descs(hg_bulk->na_sm_class, &buf_ptr,
-                &buf_size_left, &hg_bulk->na_sm_mem_descs, segments,
-                hg_bulk->desc.info.segment_count);
-            HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret,
-                "Could not deserialize NA SM mem descriptors");
-        }
-#endif
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_reg_cache_put(struct hg_bulk_reg_cache *hg_bulk_reg_cache,
+    struct hg_bulk_reg_entry *entry)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_thread_mutex_lock(&hg_bulk_reg_cache->mutex);
+    if (--entry->ref_count == 0) {
+        if (entry->invalid)
+            ret = hg_bulk_reg_entry_free(entry);
+        else if (hg_bulk_reg_cache->size > hg_bulk_reg_cache->max_size)
+            ret = hg_bulk_reg_cache_evict(hg_bulk_reg_cache);
     }
+    hg_thread_mutex_unlock(&hg_bulk_reg_cache->mutex);
 
-    /* Address information */
-    if (hg_bulk->desc.info.flags & HG_BULK_BIND) {
-        hg_size_t serialize_size;
-
-        HG_LOG_SUBSYS_DEBUG(
-            bulk, "HG_BULK_BIND flag set, deserializing address information");
+    return ret;
+}
 
-        HG_BULK_DECODE(
-            error, ret, buf_ptr, buf_size_left, &serialize_size, hg_size_t);
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_reg_cache_remove(struct hg_bulk_reg_cache *hg_bulk_reg_cache,
+    struct hg_bulk_reg_entry *entry)
+{
+    (void) hg_hash_table_remove(
+        hg_bulk_reg_cache->table, (hg_hash_table_key_t) &entry->key);
+    HG_LIST_REMOVE(entry, entry);
+    hg_bulk_reg_cache->size -= entry->key.len;
+    entry->invalid = HG_TRUE;
+}
 
-        ret = HG_Core_addr_deserialize(
-            hg_bulk->core_class, &hg_bulk->addr, buf_ptr, buf_size_left);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            bulk, error, ret, "Could not deserialize address");
-        buf_ptr += serialize_size;
-        buf_size_left -= serialize_size;
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_reg_cache_evict(struct hg_bulk_reg_cache *hg_bulk_reg_cache)
+{
+    hg_return_t ret;
 
-        /* Get context ID */
-        HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left, &hg_bulk->context_id,
-            hg_uint8_t);
-    }
+    while (hg_bulk_reg_cache->size > hg_bulk_reg_cache->max_size) {
+        struct hg_bulk_reg_entry *entry, *lru_entry = NULL;
 
-    /* Get the serialized data */
-    if (hg_bulk->desc.info.flags & HG_BULK_EAGER) {
-        hg_uint32_t i;
+        /* Eviction is rare enough compared to lookups that a linear scan is
+         * preferred over maintaining an ordered list on each use */
+        HG_LIST_FOREACH (entry, &hg_bulk_reg_cache->list, entry) {
+            if (entry->ref_count == 0 &&
+                (lru_entry == NULL || entry->last_used < lru_entry->last_used))
+                lru_entry = entry;
+        }
+        if (lru_entry == NULL)
+            break; /* Everything is in use */
 
         HG_LOG_SUBSYS_DEBUG(bulk,
-            "Deserializing eager bulk data, %u segment(s)",
-            hg_bulk->desc.info.segment_count);
-        hg_bulk->desc.info.flags |= HG_BULK_ALLOC;
-        for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
-            if (!segments[i].len)
-                continue;
+            "Evicting cached registration (%p, %" PRIu64 ")",
+            (void *) lru_entry->key.base, lru_entry->key.len);
 
-            /* Override base address to store data */
-            segments[i].base = (hg_ptr_t) calloc(1, segments[i].len);
-            HG_CHECK_SUBSYS_ERROR(bulk, segments[i].base == (hg_ptr_t) NULL,
-                error, ret, HG_NOMEM, "Could not allocate segment");
+        hg_bulk_reg_cache_remove(hg_bulk_reg_cache, lru_entry);
 
-            HG_BULK_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left,
-                (void *) segments[i].base, char, segments[i].len);
-        }
-    } else
-        /* Addresses are virtual and do not point to physical memory */
-        hg_bulk->desc.info.flags |= HG_BULK_VIRT;
+        /* Entry is no longer referenced and its list entry may be re-used */
+        if (hg_bulk_reg_cache->dereg_queue != NULL) {
+            struct hg_bulk_dereg_queue *hg_bulk_dereg_queue =
+                hg_bulk_reg_cache->dereg_queue;
 
-    HG_CHECK_SUBSYS_WARNING(bulk, buf_size_left != 0,
-        "Buffer size left for decoding bulk handle is not zero (%" PRIu64 ")",
-        buf_size_left);
+            hg_thread_spin_lock(&hg_bulk_dereg_queue->lock);
+            HG_LIST_INSERT_HEAD(
+                &hg_bulk_dereg_queue->entries, lru_entry, entry);
+            hg_thread_spin_unlock(&hg_bulk_dereg_queue->lock);
+            hg_atomic_incr32(&hg_bulk_dereg_queue->count);
+            continue;
+        }
 
-    hg_core_bulk_incr(hg_bulk->core_class);
-    *hg_bulk_p = hg_bulk;
+        ret = hg_bulk_reg_entry_free(lru_entry);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not free cached registration");
+    }
 
     return HG_SUCCESS;
 
 error:
-    hg_bulk_free(hg_bulk);
-
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_deserialize_mem_descs(na_class_t *na_class, const char **buf_p,
-    hg_size_t *buf_size_left_p, struct hg_bulk_na_mem_desc *na_mem_descs,
-    const struct hg_bulk_segment *segments, hg_uint32_t count)
+hg_bulk_reg_entry_free(struct hg_bulk_reg_entry *entry)
 {
-    na_mem_handle_t **na_mem_handles;
-    size_t *na_mem_serialize_sizes;
-    hg_return_t ret;
-    hg_uint32_t i;
+    hg_return_t ret = HG_SUCCESS;
 
-    if (count > HG_BULK_STATIC_MAX) {
-        /* Allocate NA memory handles */
-        na_mem_descs->handles.d =
-            (na_mem_handle_t **) calloc(count, sizeof(na_mem_handle_t *));
-        HG_CHECK_SUBSYS_ERROR(bulk, na_mem_descs->handles.d == NULL, error, ret,
-            HG_NOMEM, "Could not allocate mem handle array");
-
-        /* Allocate serialize sizes */
-        na_mem_descs->serialize_sizes.d =
-            (size_t *) calloc(count, sizeof(size_t));
-        HG_CHECK_SUBSYS_ERROR(bulk, na_mem_descs->serialize_sizes.d == NULL,
-            error, ret, HG_NOMEM, "Could not allocate serialize sizes array");
-
-        na_mem_handles = na_mem_descs->handles.d;
-        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.d;
-    } else {
-        na_mem_handles = na_mem_descs->handles.s;
-        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
+    if (entry->na_mem_handle != NULL) {
+        ret = hg_bulk_deregister(entry->na_class, entry->na_mem_handle, true);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, done, ret, "Could not deregister segment");
     }
 
-    /* Decode serialize sizes */
-    HG_BULK_DECODE_ARRAY(error, ret, *buf_p, *buf_size_left_p,
-        na_mem_serialize_sizes, size_t, count);
-
-    for (i = 0; i < count; i++) {
-        na_return_t na_ret;
-
-        /* Skip null segments */
-        if (segments[i].base == (hg_ptr_t) NULL)
-            continue;
-
-        na_ret = NA_Mem_handle_deserialize(
-            na_class, &na_mem_handles[i], *buf_p, *buf_size_left_p);
-        HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not deserialize memory handle (%s)",
-            NA_Error_to_string(na_ret));
-
-        *buf_p += na_mem_serialize_sizes[i];
-        *buf_size_left_p -= na_mem_serialize_sizes[i];
+#ifdef NA_HAS_SM
+    if (entry->na_sm_mem_handle != NULL) {
+        ret = hg_bulk_deregister(
+            entry->na_sm_class, entry->na_sm_mem_handle, true);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, done, ret, "Could not deregister segment with SM");
     }
+#endif
 
-    return HG_SUCCESS;
+done:
+    free(entry);
 
-error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void *
-hg_bulk_get_serialize_cached_ptr(struct hg_bulk *hg_bulk)
+static HG_INLINE unsigned int
+hg_bulk_desc_key_hash(hg_hash_table_key_t key)
 {
-    return hg_bulk->serialize_ptr;
-}
+    const struct hg_bulk_desc_key *desc_key =
+        (const struct hg_bulk_desc_key *) key;
 
-/*---------------------------------------------------------------------------*/
-hg_size_t
-hg_bulk_get_serialize_cached_size(struct hg_bulk *hg_bulk)
-{
-    return hg_bulk->serialize_size;
+    return (unsigned int) hg_crc32c(0, desc_key->buf, (size_t) desc_key->size);
 }
 
 /*---------------------------------------------------------------------------*/
-void
-hg_bulk_set_serialize_cached_ptr(
-    struct hg_bulk *hg_bulk, void *buf, size_t buf_size)
+static HG_INLINE int
+hg_bulk_desc_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
 {
-    hg_bulk->serialize_ptr = buf;
-    hg_bulk->serialize_size = buf_size;
+    const struct hg_bulk_desc_key *desc_key1 =
+        (const struct hg_bulk_desc_key *) key1;
+    const struct hg_bulk_desc_key *desc_key2 =
+        (const struct hg_bulk_desc_key *) key2;
+
+    return desc_key1->size == desc_key2->size &&
+           memcmp(desc_key1->buf, desc_key2->buf, (size_t) desc_key1->size) ==
+               0;
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_bulk_access(struct hg_bulk *hg_bulk, hg_size_t offset, hg_size_t size,
-    hg_uint8_t flags, hg_uint32_t max_count, void **buf_ptrs,
-    hg_size_t *buf_sizes, hg_uint32_t *actual_count)
+hg_return_t
+hg_bulk_desc_cache_create(
+    hg_uint32_t max_count, struct hg_bulk_desc_cache **hg_bulk_desc_cache_p)
 {
-    struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
-    hg_uint32_t segment_index;
-    hg_size_t segment_offset;
-    hg_size_t remaining_size = size;
-    hg_uint32_t count = 0;
-
-    /* TODO use flags */
-    (void) flags;
-
-    hg_bulk_offset_translate(segments, hg_bulk->desc.info.segment_count, offset,
-        &segment_index, &segment_offset);
+    struct hg_bulk_desc_cache *hg_bulk_desc_cache = NULL;
+    hg_return_t ret;
 
-    while ((remaining_size > 0) && (count < max_count)) {
-        hg_ptr_t base;
-        hg_size_t len;
+    HG_LOG_SUBSYS_DEBUG(
+        bulk, "Creating descriptor cache of %" PRIu32 " entries", max_count);
 
-        /* Can only transfer smallest size */
-        len = segments[segment_index].len - segment_offset;
+    hg_bulk_desc_cache =
+        (struct hg_bulk_desc_cache *) calloc(1, sizeof(*hg_bulk_desc_cache));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_desc_cache == NULL, error, ret,
+        HG_NOMEM, "Could not allocate descriptor cache");
 
-        /* Remaining size may be smaller */
-        len = HG_BULK_MIN(remaining_size, len);
-        base = segments[segment_index].base + (hg_ptr_t) segment_offset;
+    hg_bulk_desc_cache->table =
+        hg_hash_table_new(hg_bulk_desc_key_hash, hg_bulk_desc_key_equal);
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_desc_cache->table == NULL, error, ret,
+        HG_NOMEM, "Could not allocate descriptor cache table");
 
-        /* Fill segments */
-        if (buf_ptrs)
-            buf_ptrs[count] = (void *) base;
-        if (buf_sizes)
-            buf_sizes[count] = len;
-        /*
-        printf("Segment %d: address=0x%lX\n", count, segment_address);
-        printf("Segment %d: size=%zu\n", count, segment_size);
-         */
+    hg_thread_mutex_init(&hg_bulk_desc_cache->mutex);
+    HG_LIST_INIT(&hg_bulk_desc_cache->list);
+    hg_bulk_desc_cache->max_count = max_count;
 
-        /* Decrease remaining size from the size of data we transferred */
-        remaining_size -= len;
+    *hg_bulk_desc_cache_p = hg_bulk_desc_cache;
 
-        /* Change segment */
-        segment_index++;
-        segment_offset = 0;
-        count++;
-    }
+    return HG_SUCCESS;
 
-    if (actual_count)
-        *actual_count = count;
+error:
+    free(hg_bulk_desc_cache);
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE void
-hg_bulk_offset_translate(const struct hg_bulk_segment *segments,
-    hg_uint32_t count, hg_size_t offset, hg_uint32_t *segment_start_index,
-    hg_size_t *segment_start_offset)
+void
+hg_bulk_desc_cache_destroy(struct hg_bulk_desc_cache *hg_bulk_desc_cache)
 {
-    hg_uint32_t i, new_segment_start_index = 0;
-    hg_size_t new_segment_offset = offset, next_offset = 0;
+    struct hg_bulk_desc_entry *entry;
 
-    /* Get start index and handle offset */
-    for (i = 0; i < count; i++) {
-        next_offset += segments[i].len;
-        if (offset < next_offset) {
-            new_segment_start_index = i;
-            break;
-        }
-        new_segment_offset -= segments[i].len;
+    HG_LOG_SUBSYS_DEBUG(bulk, "Free descriptor cache (%p)",
+        (void *) hg_bulk_desc_cache);
+
+    /* Handles that are still referenced by the user remain valid */
+    entry = HG_LIST_FIRST(&hg_bulk_desc_cache->list);
+    while (entry) {
+        struct hg_bulk_desc_entry *entry_next = HG_LIST_NEXT(entry, entry);
+
+        HG_LIST_REMOVE(entry, entry);
+        (void) hg_bulk_desc_entry_free(entry);
+
+        entry = entry_next;
     }
 
-    *segment_start_index = new_segment_start_index;
-    *segment_start_offset = new_segment_offset;
+    hg_hash_table_free(hg_bulk_desc_cache->table);
+    hg_thread_mutex_destroy(&hg_bulk_desc_cache->mutex);
+    free(hg_bulk_desc_cache);
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_op_create(
-    hg_core_context_t *core_context, struct hg_bulk_op_id **hg_bulk_op_id_p)
+hg_bulk_desc_cache_get(struct hg_bulk_desc_cache *hg_bulk_desc_cache,
+    hg_core_class_t *core_class, struct hg_bulk **hg_bulk_p, const void *buf,
+    hg_size_t buf_size, hg_core_handle_t pin_handle)
 {
-    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    struct hg_bulk_desc_key key = {.buf = buf, .size = buf_size};
+    struct hg_bulk_desc_entry *entry;
+    struct hg_bulk *hg_bulk = NULL;
+    int rc;
     hg_return_t ret;
-    int i;
 
-    hg_bulk_op_id = (struct hg_bulk_op_id *) calloc(1, sizeof(*hg_bulk_op_id));
-    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_id == NULL, error, ret, HG_NOMEM,
-        "Could not allocate HG Bulk operation ID");
+    hg_thread_mutex_lock(&hg_bulk_desc_cache->mutex);
+    entry = (struct hg_bulk_desc_entry *) hg_hash_table_lookup(
+        hg_bulk_desc_cache->table, (hg_hash_table_key_t) &key);
+    if (entry != HG_HASH_TABLE_NULL) {
+        HG_LOG_SUBSYS_DEBUG(bulk, "Re-using cached bulk handle (%p)",
+            (void *) entry->hg_bulk);
+        hg_atomic_incr32(&entry->hg_bulk->ref_count);
+        entry->last_used = hg_bulk_desc_cache->use_count++;
+        *hg_bulk_p = entry->hg_bulk;
+        hg_thread_mutex_unlock(&hg_bulk_desc_cache->mutex);
 
-    hg_bulk_op_id->core_context = core_context;
-    hg_atomic_init32(&hg_bulk_op_id->ref_count, 1);
+        return HG_SUCCESS;
+    }
+    hg_thread_mutex_unlock(&hg_bulk_desc_cache->mutex);
 
-    /* Completed by default */
-    hg_atomic_init32(&hg_bulk_op_id->status, HG_BULK_OP_COMPLETED);
-    hg_atomic_init32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS);
+    /* Deserialize outside of the lock */
+    ret = hg_bulk_deserialize(core_class, &hg_bulk, buf, buf_size, pin_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not deserialize handle");
 
-    hg_bulk_op_id->callback_info.type = HG_CB_BULK;
-    hg_bulk_op_id->op_count = 1; /* Default */
-    hg_atomic_init32(&hg_bulk_op_id->op_completed_count, 0);
+    /* Eager handles carry their data and are not worth keeping */
+    if (hg_bulk->desc.info.flags & HG_BULK_EAGER) {
+        *hg_bulk_p = hg_bulk;
+        return HG_SUCCESS;
+    }
 
-    /* Preallocate NA OP IDs */
-    for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
-        hg_bulk_op_id->na_op_ids.s[i] =
-            NA_Op_create(core_context->core_class->na_class, 0);
-        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_id->na_op_ids.s[i] == NULL,
-            error, ret, HG_NA_ERROR, "NA_Op_create() failed");
+    entry = (struct hg_bulk_desc_entry *) calloc(1, sizeof(*entry));
+    HG_CHECK_SUBSYS_ERROR(bulk, entry == NULL, error, ret, HG_NOMEM,
+        "Could not allocate descriptor cache entry");
+    hg_bulk->desc_buf = malloc((size_t) buf_size);
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk->desc_buf == NULL, error, ret,
+        HG_NOMEM, "Could not allocate descriptor copy");
+    memcpy(hg_bulk->desc_buf, buf, (size_t) buf_size);
+    entry->key.buf = hg_bulk->desc_buf;
+    entry->key.size = buf_size;
+    entry->hg_bulk = hg_bulk;
+
+    hg_thread_mutex_lock(&hg_bulk_desc_cache->mutex);
+
+    /* Another thread may have added the same descriptor meanwhile, in which
+     * case the new handle is simply not cached */
+    rc = hg_hash_table_insert(hg_bulk_desc_cache->table,
+        (hg_hash_table_key_t) &entry->key, (hg_hash_table_value_t) entry);
+    if (rc == 0) {
+        hg_thread_mutex_unlock(&hg_bulk_desc_cache->mutex);
+        free(hg_bulk->desc_buf);
+        hg_bulk->desc_buf = NULL;
+        free(entry);
+        *hg_bulk_p = hg_bulk;
+
+        return HG_SUCCESS;
     }
-#ifdef NA_HAS_SM
-    if (core_context->core_class->na_sm_class) {
-        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
-            hg_bulk_op_id->na_sm_op_ids.s[i] =
-                NA_Op_create(core_context->core_class->na_sm_class, 0);
-            HG_CHECK_SUBSYS_ERROR(bulk,
-                hg_bulk_op_id->na_sm_op_ids.s[i] == NULL, error, ret,
-                HG_NA_ERROR, "NA_Op_create() failed");
-        }
+    HG_LIST_INSERT_HEAD(&hg_bulk_desc_cache->list, entry, entry);
+    hg_bulk_desc_cache->count++;
+    entry->last_used = hg_bulk_desc_cache->use_count++;
+
+    /* Cache holds one reference and serialization always uses the copy */
+    hg_atomic_incr32(&hg_bulk->ref_count);
+    hg_bulk->serialize_ptr = hg_bulk->desc_buf;
+    hg_bulk->serialize_size = buf_size;
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Added bulk handle (%p) to descriptor cache, %" PRIu32 " entries",
+        (void *) hg_bulk, hg_bulk_desc_cache->count);
+
+    if (hg_bulk_desc_cache->count > hg_bulk_desc_cache->max_count) {
+        hg_return_t evict_ret = hg_bulk_desc_cache_evict(hg_bulk_desc_cache);
+        HG_CHECK_SUBSYS_ERROR_DONE(bulk, evict_ret != HG_SUCCESS,
+            "Could not evict cached bulk handle");
     }
-#endif
 
-    HG_LOG_SUBSYS_DEBUG(
-        bulk, "Created new bulk op ID (%p)", (void *) hg_bulk_op_id);
+    hg_thread_mutex_unlock(&hg_bulk_desc_cache->mutex);
 
-    *hg_bulk_op_id_p = hg_bulk_op_id;
+    *hg_bulk_p = hg_bulk;
 
     return HG_SUCCESS;
 
 error:
-    if (hg_bulk_op_id) {
-        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
-            if (hg_bulk_op_id->na_op_ids.s[i] == NULL)
-                continue;
-
-            NA_Op_destroy(core_context->core_class->na_class,
-                hg_bulk_op_id->na_op_ids.s[i]);
-        }
-#ifdef NA_HAS_SM
-        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
-            if (hg_bulk_op_id->na_sm_op_ids.s[i] == NULL)
-                continue;
-
-            NA_Op_destroy(core_context->core_class->na_sm_class,
-                hg_bulk_op_id->na_sm_op_ids.s[i]);
-        }
-#endif
-        free(hg_bulk_op_id);
+    if (hg_bulk != NULL) {
+        free(hg_bulk->desc_buf);
+        hg_bulk->desc_buf = NULL;
+        (void) hg_bulk_free(hg_bulk);
     }
+    free(entry);
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_bulk_op_destroy(struct hg_bulk_op_id *hg_bulk_op_id)
+static hg_return_t
+hg_bulk_desc_cache_evict(struct hg_bulk_desc_cache *hg_bulk_desc_cache)
 {
-    hg_uint32_t i;
-
-    if (hg_atomic_decr32(&hg_bulk_op_id->ref_count))
-        return; /* Cannot free yet */
-
-    /* We may have used extra op IDs if this NA class was used */
-    if (hg_bulk_op_id->na_class &&
-        hg_bulk_op_id->op_count > HG_BULK_STATIC_MAX) {
-        na_op_id_t **na_op_ids = NULL;
-#ifdef NA_HAS_SM
-        if (hg_bulk_op_id->na_class ==
-            hg_bulk_op_id->core_context->core_class->na_sm_class)
-            na_op_ids = hg_bulk_op_id->na_sm_op_ids.d;
-        else
-#endif
-            na_op_ids = hg_bulk_op_id->na_op_ids.d;
-
-        if (na_op_ids) {
-            for (i = 0; i < hg_bulk_op_id->op_count; i++) {
-                if (na_op_ids[i] == NULL)
-                    continue;
+    struct hg_bulk_desc_entry *entry, *lru_entry = NULL;
 
-                NA_Op_destroy(hg_bulk_op_id->na_class, na_op_ids[i]);
-            }
-            free(na_op_ids);
-            hg_bulk_op_id->na_op_ids.d = NULL;
-#ifdef NA_HAS_SM
-            hg_bulk_op_id->na_sm_op_ids.d = NULL;
-#endif
-        }
+    /* Same linear scan as the registration cache, the cache is expected to
+     * remain small */
+    HG_LIST_FOREACH (entry, &hg_bulk_desc_cache->list, entry) {
+        if (lru_entry == NULL || entry->last_used < lru_entry->last_used)
+            lru_entry = entry;
     }
+    if (lru_entry == NULL)
+        return HG_SUCCESS;
 
-    /* Repost handle if we were listening, otherwise destroy it */
-    if (hg_bulk_op_id->reuse) {
-        HG_LOG_SUBSYS_DEBUG(
-            bulk, "Re-using bulk op ID (%p)", (void *) hg_bulk_op_id);
-
-        /* Reset ref_count */
-        hg_atomic_set32(&hg_bulk_op_id->ref_count, 1);
-
-        /* Reset status */
-        hg_atomic_set32(&hg_bulk_op_id->status, HG_BULK_OP_COMPLETED);
+    HG_LOG_SUBSYS_DEBUG(bulk, "Evicting cached bulk handle (%p)",
+        (void *) lru_entry->hg_bulk);
 
-        hg_thread_spin_lock(&hg_bulk_op_id->op_pool->pending_list_lock);
-        HG_LIST_INSERT_HEAD(
-            &hg_bulk_op_id->op_pool->pending_list, hg_bulk_op_id, pending);
-        hg_thread_spin_unlock(&hg_bulk_op_id->op_pool->pending_list_lock);
-    } else {
-        HG_LOG_SUBSYS_DEBUG(
-            bulk, "Freeing bulk op ID (%p)", (void *) hg_bulk_op_id);
+    (void) hg_hash_table_remove(
+        hg_bulk_desc_cache->table, (hg_hash_table_key_t) &lru_entry->key);
+    HG_LIST_REMOVE(lru_entry, entry);
+    hg_bulk_desc_cache->count--;
 
-        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
-            if (hg_bulk_op_id->na_op_ids.s[i] == NULL)
-                continue;
+    return hg_bulk_desc_entry_free(lru_entry);
+}
 
-            NA_Op_destroy(hg_bulk_op_id->core_context->core_class->na_class,
-                hg_bulk_op_id->na_op_ids.s[i]);
-        }
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_desc_entry_free(struct hg_bulk_desc_entry *entry)
+{
+    hg_return_t ret;
 
-#ifdef NA_HAS_SM
-        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
-            if (hg_bulk_op_id->na_sm_op_ids.s[i] == NULL)
-                continue;
+    /* Descriptor copy is owned by the handle and freed along with it */
+    ret = hg_bulk_free(entry->hg_bulk);
+    HG_CHECK_SUBSYS_HG_ERROR(bulk, done, ret, "Could not free bulk handle");
 
-            NA_Op_destroy(hg_bulk_op_id->core_context->core_class->na_sm_class,
-                hg_bulk_op_id->na_sm_op_ids.s[i]);
-        }
-#endif
+done:
+    free(entry);
 
-        free(hg_bulk_op_id);
-    }
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-hg_bulk_op_pool_create(hg_core_context_t *core_context, unsigned int init_count,
-    struct hg_bulk_op_pool **hg_bulk_op_pool_p)
+hg_bulk_dereg_queue_create(
+    hg_uint32_t batch, struct hg_bulk_dereg_queue **hg_bulk_dereg_queue_p)
 {
-    struct hg_bulk_op_pool *hg_bulk_op_pool = NULL;
+    struct hg_bulk_dereg_queue *hg_bulk_dereg_queue;
     hg_return_t ret;
-    unsigned int i;
-
-    HG_LOG_SUBSYS_DEBUG(bulk, "Creating pool with %u bulk op IDs", init_count);
-
-    hg_bulk_op_pool =
-        (struct hg_bulk_op_pool *) calloc(1, sizeof(*hg_bulk_op_pool));
-    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_pool == NULL, error, ret, HG_NOMEM,
-        "Could not allocate bulk op pool");
-
-    hg_thread_mutex_init(&hg_bulk_op_pool->extend_mutex);
-    hg_thread_cond_init(&hg_bulk_op_pool->extend_cond);
-    hg_bulk_op_pool->core_context = core_context;
-    HG_LIST_INIT(&hg_bulk_op_pool->pending_list);
-    hg_thread_spin_init(&hg_bulk_op_pool->pending_list_lock);
-    hg_bulk_op_pool->count = init_count;
-    hg_bulk_op_pool->extending = HG_FALSE;
-
-    for (i = 0; i < init_count; i++) {
-        struct hg_bulk_op_id *hg_bulk_op_id = NULL;
-
-        ret = hg_bulk_op_create(core_context, &hg_bulk_op_id);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            bulk, error, ret, "Could not create bulk op ID");
 
-        hg_bulk_op_id->reuse = HG_TRUE;
-        hg_bulk_op_id->op_pool = hg_bulk_op_pool;
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Creating deferred deregistration queue (batches of %" PRIu32 ")",
+        batch);
 
-        hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
-        HG_LIST_INSERT_HEAD(
-            &hg_bulk_op_pool->pending_list, hg_bulk_op_id, pending);
-        hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
-    }
+    hg_bulk_dereg_queue =
+        (struct hg_bulk_dereg_queue *) calloc(1, sizeof(*hg_bulk_dereg_queue));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_dereg_queue == NULL, error, ret,
+        HG_NOMEM, "Could not allocate deferred deregistration queue");
 
-    HG_LOG_SUBSYS_DEBUG(
-        bulk, "Created bulk op ID pool (%p)", (void *) hg_bulk_op_pool);
+    HG_QUEUE_INIT(&hg_bulk_dereg_queue->bulks);
+    HG_LIST_INIT(&hg_bulk_dereg_queue->entries);
+    hg_thread_spin_init(&hg_bulk_dereg_queue->lock);
+    hg_atomic_init32(&hg_bulk_dereg_queue->count, 0);
+    hg_bulk_dereg_queue->batch = batch;
 
-    *hg_bulk_op_pool_p = hg_bulk_op_pool;
+    *hg_bulk_dereg_queue_p = hg_bulk_dereg_queue;
 
     return HG_SUCCESS;
 
 error:
-    if (hg_bulk_op_pool)
-        hg_bulk_op_pool_destroy(hg_bulk_op_pool);
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 void
-hg_bulk_op_pool_destroy(struct hg_bulk_op_pool *hg_bulk_op_pool)
+hg_bulk_dereg_queue_destroy(struct hg_bulk_dereg_queue *hg_bulk_dereg_queue)
 {
-    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    HG_LOG_SUBSYS_DEBUG(bulk, "Free deferred deregistration queue (%p)",
+        (void *) hg_bulk_dereg_queue);
 
-    HG_LOG_SUBSYS_DEBUG(
-        bulk, "Free bulk op ID pool (%p)", (void *) hg_bulk_op_pool);
+    hg_bulk_dereg_queue_drain(hg_bulk_dereg_queue, HG_TRUE);
+    hg_thread_spin_destroy(&hg_bulk_dereg_queue->lock);
+    free(hg_bulk_dereg_queue);
+}
 
-    hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
+/*---------------------------------------------------------------------------*/
+void
+hg_bulk_dereg_queue_drain(
+    struct hg_bulk_dereg_queue *hg_bulk_dereg_queue, hg_bool_t all)
+{
+    hg_uint32_t i;
 
-    hg_bulk_op_id = HG_LIST_FIRST(&hg_bulk_op_pool->pending_list);
+    /* Releasing a handle may queue evicted registrations, which are then
+     * released as part of the same batch */
+    for (i = 0; all || i < hg_bulk_dereg_queue->batch; i++) {
+        if (hg_atomic_get32(&hg_bulk_dereg_queue->count) == 0 ||
+            !hg_bulk_dereg_queue_pop(hg_bulk_dereg_queue))
+            break;
+    }
+}
 
-    while (hg_bulk_op_id) {
-        struct hg_bulk_op_id *hg_bulk_op_id_next =
-            HG_LIST_NEXT(hg_bulk_op_id, pending);
-        HG_LIST_REMOVE(hg_bulk_op_id, pending);
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_dereg_queue_pop(struct hg_bulk_dereg_queue *hg_bulk_dereg_queue)
+{
+    struct hg_bulk_reg_entry *entry;
+    struct hg_bulk *hg_bulk;
+    hg_return_t ret;
 
-        /* Prevent re-initialization */
-        hg_bulk_op_id->reuse = HG_FALSE;
+    hg_thread_spin_lock(&hg_bulk_dereg_queue->lock);
+    entry = HG_LIST_FIRST(&hg_bulk_dereg_queue->entries);
+    if (entry != NULL) {
+        HG_LIST_REMOVE(entry, entry);
+        hg_thread_spin_unlock(&hg_bulk_dereg_queue->lock);
+        hg_atomic_decr32(&hg_bulk_dereg_queue->count);
 
-        /* Destroy op IDs */
-        hg_bulk_op_destroy(hg_bulk_op_id);
+        ret = hg_bulk_reg_entry_free(entry);
+        HG_CHECK_SUBSYS_ERROR_DONE(bulk, ret != HG_SUCCESS,
+            "Could not free cached registration");
 
-        hg_bulk_op_id = hg_bulk_op_id_next;
+        return HG_TRUE;
     }
-    hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
+    hg_bulk = HG_QUEUE_FIRST(&hg_bulk_dereg_queue->bulks);
+    if (hg_bulk == NULL) {
+        hg_thread_spin_unlock(&hg_bulk_dereg_queue->lock);
+        return HG_FALSE;
+    }
+    HG_QUEUE_POP_HEAD(&hg_bulk_dereg_queue->bulks, dereg_entry);
+    hg_thread_spin_unlock(&hg_bulk_dereg_queue->lock);
+    hg_atomic_decr32(&hg_bulk_dereg_queue->count);
 
-    hg_thread_mutex_destroy(&hg_bulk_op_pool->extend_mutex);
-    hg_thread_cond_destroy(&hg_bulk_op_pool->extend_cond);
-    hg_thread_spin_destroy(&hg_bulk_op_pool->pending_list_lock);
+    ret = hg_bulk_release(hg_bulk);
+    HG_CHECK_SUBSYS_ERROR_DONE(
+        bulk, ret != HG_SUCCESS, "Could not release bulk handle");
 
-    free(hg_bulk_op_pool);
+    return HG_TRUE;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_bulk_op_pool_get(struct hg_bulk_op_pool *hg_bulk_op_pool,
-    struct hg_bulk_op_id **hg_bulk_op_id_p)
+static HG_INLINE size_t
+hg_bulk_varint_size(hg_uint64_t value)
 {
-    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
-    hg_return_t ret;
+    size_t len = 1;
 
-    do {
-        unsigned int i;
+    while (value >>= 7)
+        len++;
 
-        hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
-        if ((hg_bulk_op_id = HG_LIST_FIRST(&hg_bulk_op_pool->pending_list)))
-            HG_LIST_REMOVE(hg_bulk_op_id, pending);
-        hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
+    return len;
+}
 
-        if (hg_bulk_op_id)
-            break;
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_bulk_varint_encode(char *buf, hg_uint64_t value)
+{
+    hg_uint8_t *ptr = (hg_uint8_t *) buf;
 
-        /* Create another batch of IDs if empty */
-        hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
-        if (hg_bulk_op_pool->extending) {
-            hg_thread_cond_wait(
-                &hg_bulk_op_pool->extend_cond, &hg_bulk_op_pool->extend_mutex);
-            hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
-            continue;
+    while (value >= 0x80) {
+        *ptr++ = (hg_uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    *ptr = (hg_uint8_t) value;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE size_t
+hg_bulk_varint_decode(
+    const char *buf, hg_size_t buf_size, hg_uint64_t *value_p)
+{
+    const hg_uint8_t *ptr = (const hg_uint8_t *) buf;
+    size_t max_len = (buf_size < HG_BULK_VARINT_MAX) ? (size_t) buf_size
+                                                      : HG_BULK_VARINT_MAX;
+    hg_uint64_t value = 0;
+    size_t len;
+
+    for (len = 0; len < max_len; len++) {
+        value |= (hg_uint64_t) (ptr[len] & 0x7f) << (7 * len);
+        if (!(ptr[len] & 0x80)) {
+            /* Last byte may only carry the remaining bit */
+            if (len == HG_BULK_VARINT_MAX - 1 && ptr[len] > 1)
+                return 0;
+            *value_p = value;
+            return len + 1;
         }
-        hg_bulk_op_pool->extending = HG_TRUE;
-        hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+    }
 
-        /* Only a single thread can extend the pool */
-        for (i = 0; i < hg_bulk_op_pool->count; i++) {
-            struct hg_bulk_op_id *new_op_id = NULL;
+    return 0;
+}
 
-            ret = hg_bulk_op_create(hg_bulk_op_pool->core_context, &new_op_id);
-            HG_CHECK_SUBSYS_HG_ERROR(
-                bulk, error, ret, "Could not create bulk op ID");
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_bulk_segments_contig(
+    const struct hg_bulk_segment *segments, hg_uint32_t count)
+{
+    hg_uint32_t i;
 
-            new_op_id->reuse = HG_TRUE;
-            new_op_id->op_pool = hg_bulk_op_pool;
+    for (i = 1; i < count; i++)
+        if (segments[i].base != segments[i - 1].base + segments[i - 1].len)
+            return HG_FALSE;
 
-            hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
-            HG_LIST_INSERT_HEAD(
-                &hg_bulk_op_pool->pending_list, new_op_id, pending);
-            hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
-        }
-        hg_bulk_op_pool->count *= 2;
+    return HG_TRUE;
+}
 
-        hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
-        hg_bulk_op_pool->extending = HG_FALSE;
-        hg_thread_cond_broadcast(&hg_bulk_op_pool->extend_cond);
-        hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
-    } while (!hg_bulk_op_id);
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_bulk_get_serialize_size(struct hg_bulk *hg_bulk, hg_uint8_t flags)
+{
+    struct hg_bulk_desc_info *desc_info = &hg_bulk->desc.info;
+    hg_size_t ret;
+
+    /* Flags + segments + memory handles */
+    ret = hg_bulk_get_serialize_size_desc(hg_bulk, flags);
+
+    /* Address information (serialize size + address + context ID) */
+    if (desc_info->flags & HG_BULK_BIND) {
+        unsigned long addr_flags = 0;
+        hg_size_t addr_size;
+
+#ifdef NA_HAS_SM
+        if (flags & HG_BULK_SM)
+            addr_flags |= HG_CORE_SM;
+#endif
+        addr_size = HG_Core_addr_get_serialize_size(hg_bulk->addr, addr_flags);
+        ret += hg_bulk_varint_size(addr_size) + addr_size + sizeof(hg_uint8_t);
+    }
+
+    /* Eager mode (in eager mode, the actual data will be copied) */
+    if ((flags & HG_BULK_EAGER) && (desc_info->flags & HG_BULK_READ_ONLY) &&
+        !(desc_info->flags & HG_BULK_VIRT) &&
+        (hg_bulk->attrs.mem_type == HG_MEM_TYPE_HOST))
+        ret += desc_info->len;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_bulk_get_serialize_size_desc(struct hg_bulk *hg_bulk, hg_uint8_t flags)
+{
+    struct hg_bulk_desc_info *desc_info = &hg_bulk->desc.info;
+    const struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
+    hg_size_t *size_p;
+    hg_size_t ret;
+    hg_uint32_t i;
+
+#ifdef NA_HAS_SM
+    size_p = &hg_bulk->desc_serialize_size[(flags & HG_BULK_SM) ? 1 : 0];
+#else
+    (void) flags;
+    size_p = &hg_bulk->desc_serialize_size[0];
+#endif
+    /* Segments and handles do not change once the handle is created */
+    if (*size_p != 0)
+        return *size_p;
+
+    /* Flags + segment count */
+    ret = sizeof(hg_uint8_t) + hg_bulk_varint_size(desc_info->segment_count);
+
+    /* Segments, only the first base is needed if they are contiguous */
+    if (desc_info->segment_count > 0 &&
+        hg_bulk_segments_contig(segments, desc_info->segment_count))
+        ret += sizeof(hg_ptr_t);
+    else
+        ret += desc_info->segment_count * sizeof(hg_ptr_t);
+    for (i = 0; i < desc_info->segment_count; i++)
+        ret += hg_bulk_varint_size(segments[i].len);
+
+    /* Memory handles */
+    if ((desc_info->flags & HG_BULK_REGV) || (desc_info->segment_count == 1)) {
+        /* Only one single memory handle in that case, an empty size is
+         * encoded if the handle is not registered yet (lazy registration) */
+        if (hg_bulk->na_mem_descs.handles.s[0] != NULL ||
+            segments[0].base != (hg_ptr_t) NULL)
+            ret += hg_bulk->na_mem_descs.serialize_sizes.s[0] +
+                   hg_bulk_varint_size(
+                       hg_bulk->na_mem_descs.serialize_sizes.s[0]);
+
+#ifdef NA_HAS_SM
+        /* Only add SM serialized handles if we're sending over SM, otherwise
+         * skip it. */
+        if ((flags & HG_BULK_SM) &&
+            (hg_bulk->na_sm_mem_descs.handles.s[0] != NULL ||
+                segments[0].base != (hg_ptr_t) NULL))
+            ret += hg_bulk->na_sm_mem_descs.serialize_sizes.s[0] +
+                   hg_bulk_varint_size(
+                       hg_bulk->na_sm_mem_descs.serialize_sizes.s[0]);
+#endif
+    } else {
+        ret += hg_bulk_get_serialize_size_mem_descs(
+            &hg_bulk->na_mem_descs, desc_info->segment_count);
+
+#ifdef NA_HAS_SM
+        /* Only add SM serialized handles if we're sending over SM, otherwise
+         * skip it. */
+        if ((flags & HG_BULK_SM) && hg_bulk->na_sm_class)
+            ret += hg_bulk_get_serialize_size_mem_descs(
+                &hg_bulk->na_sm_mem_descs, desc_info->segment_count);
+#endif
+    }
+
+    /* Handles of additional rails (not needed when sending over SM) */
+    if (hg_bulk->rails != NULL && !(flags & HG_BULK_SM))
+        ret += hg_bulk_get_serialize_size_rails(hg_bulk);
+
+    *size_p = ret;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_bulk_get_serialize_size_mem_descs(
+    struct hg_bulk_na_mem_desc *na_mem_descs, hg_uint32_t count)
+{
+    na_mem_handle_t **na_mem_handles;
+    size_t *na_mem_serialize_sizes;
+    hg_uint32_t i;
+    hg_size_t ret = 0;
+
+    if (count > HG_BULK_STATIC_MAX) {
+        na_mem_handles = na_mem_descs->handles.d;
+        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.d;
+    } else {
+        na_mem_handles = na_mem_descs->handles.s;
+        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
+    }
+
+    /* Handles not registered yet (lazy registration), encode empty sizes */
+    if (na_mem_handles == NULL)
+        return count * hg_bulk_varint_size(0);
+
+    /* Serialize sizes */
+    for (i = 0; i < count; i++) {
+        ret += hg_bulk_varint_size(na_mem_serialize_sizes[i]);
+        if (na_mem_handles[i] != NULL)
+            ret += na_mem_serialize_sizes[i];
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_serialize(
+    void *buf, hg_size_t buf_size, hg_uint8_t flags, struct hg_bulk *hg_bulk)
+{
+    struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
+    char *buf_ptr = (char *) buf;
+    hg_size_t buf_size_left = buf_size;
+    struct hg_bulk_desc_info desc_info = hg_bulk->desc.info; /* Copy info */
+    hg_uint8_t desc_flags;
+    hg_uint32_t i;
+    hg_return_t ret;
+
+    /* Always reset bulk alloc and virt flags (only local) */
+    desc_info.flags &= (~(HG_BULK_ALLOC | HG_BULK_VIRT) & 0xff);
+
+    /* Add eager flag to descriptor if requested and bulk handle is read-only,
+     * is not virtual (i.e., points to local data), and memory is not on device.
+     */
+    if ((flags & HG_BULK_EAGER) && (desc_info.flags & HG_BULK_READ_ONLY) &&
+        !(hg_bulk->desc.info.flags & HG_BULK_VIRT) &&
+        (hg_bulk->attrs.mem_type == HG_MEM_TYPE_HOST)) {
+        HG_LOG_SUBSYS_DEBUG(bulk, "HG_BULK_EAGER flag set");
+        desc_info.flags |= HG_BULK_EAGER;
+    } else
+        desc_info.flags &= (~HG_BULK_EAGER & 0xff);
+
+#ifdef NA_HAS_SM
+    /* Add SM flag */
+    if (flags & HG_BULK_SM) {
+        HG_LOG_SUBSYS_DEBUG(bulk, "HG_BULK_SM flag set");
+        desc_info.flags |= HG_BULK_SM;
+    } else
+        desc_info.flags &= (~HG_BULK_SM & 0xff);
+#endif
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Serializing bulk handle with %u segment(s), len is %" PRIu64 " bytes",
+        desc_info.segment_count, desc_info.len);
+
+    /* Flags and segment count (total length is recomputed from segments) */
+    desc_flags = desc_info.flags;
+    if (desc_info.segment_count > 0 &&
+        hg_bulk_segments_contig(segments, desc_info.segment_count))
+        desc_flags |= HG_BULK_CONTIG;
+    if (hg_bulk->rails != NULL && !(desc_info.flags & HG_BULK_SM))
+        desc_flags |= HG_BULK_RAILS;
+    HG_BULK_ENCODE(error, ret, buf_ptr, buf_size_left, &desc_flags, hg_uint8_t);
+    HG_BULK_VARINT_ENCODE(
+        error, ret, buf_ptr, buf_size_left, desc_info.segment_count);
+
+    /* Segments */
+    if (desc_flags & HG_BULK_CONTIG) {
+        HG_BULK_ENCODE(
+            error, ret, buf_ptr, buf_size_left, &segments[0].base, hg_ptr_t);
+        for (i = 0; i < desc_info.segment_count; i++)
+            HG_BULK_VARINT_ENCODE(
+                error, ret, buf_ptr, buf_size_left, segments[i].len);
+    } else {
+        for (i = 0; i < desc_info.segment_count; i++) {
+            HG_BULK_ENCODE(error, ret, buf_ptr, buf_size_left,
+                &segments[i].base, hg_ptr_t);
+            HG_BULK_VARINT_ENCODE(
+                error, ret, buf_ptr, buf_size_left, segments[i].len);
+        }
+    }
+
+    /* TODO if eager or self flag, skip mem handles ? */
+
+    /* Add the NA memory handles */
+    if ((desc_info.flags & HG_BULK_REGV) || (desc_info.segment_count == 1)) {
+        /* N.B. skip serialize size if no handle, unless handle is not
+         * registered yet, in which case an empty size is encoded */
+        if (hg_bulk->na_mem_descs.handles.s[0] == NULL &&
+            segments[0].base != (hg_ptr_t) NULL) {
+            HG_LOG_SUBSYS_DEBUG(bulk, "NA memory handle is not registered");
+
+            HG_BULK_VARINT_ENCODE(error, ret, buf_ptr, buf_size_left, 0);
+        } else if (hg_bulk->na_mem_descs.handles.s[0] != NULL) {
+            na_return_t na_ret;
+
+            HG_LOG_SUBSYS_DEBUG(bulk, "Serializing single NA memory handle");
+
+            HG_BULK_VARINT_ENCODE(error, ret, buf_ptr, buf_size_left,
+                hg_bulk->na_mem_descs.serialize_sizes.s[0]);
+
+            na_ret = NA_Mem_handle_serialize(hg_bulk->na_class, buf_ptr,
+                buf_size_left, hg_bulk->na_mem_descs.handles.s[0]);
+            HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+                (hg_return_t) na_ret, "Could not serialize memory handle (%s)",
+                NA_Error_to_string(na_ret));
+            buf_ptr += hg_bulk->na_mem_descs.serialize_sizes.s[0];
+            buf_size_left -= hg_bulk->na_mem_descs.serialize_sizes.s[0];
+        }
+
+#ifdef NA_HAS_SM
+        /* Only add SM serialized handles if we're sending over SM, otherwise
+         * skip then. */
+        if ((desc_info.flags & HG_BULK_SM) &&
+            hg_bulk->na_sm_mem_descs.handles.s[0] == NULL &&
+            segments[0].base != (hg_ptr_t) NULL) {
+            HG_BULK_VARINT_ENCODE(error, ret, buf_ptr, buf_size_left, 0);
+        } else if ((desc_info.flags & HG_BULK_SM) &&
+                   (hg_bulk->na_sm_mem_descs.handles.s[0] != NULL)) {
+            na_return_t na_ret;
+
+            HG_BULK_VARINT_ENCODE(error, ret, buf_ptr, buf_size_left,
+                hg_bulk->na_sm_mem_descs.serialize_sizes.s[0]);
+
+            na_ret = NA_Mem_handle_serialize(hg_bulk->na_sm_class, buf_ptr,
+                buf_size_left, hg_bulk->na_sm_mem_descs.handles.s[0]);
+            HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+                (hg_return_t) na_ret,
+                "Could not serialize SM memory handle (%s)",
+                NA_Error_to_string(na_ret));
+            buf_ptr += hg_bulk->na_sm_mem_descs.serialize_sizes.s[0];
+            buf_size_left -= hg_bulk->na_sm_mem_descs.serialize_sizes.s[0];
+        }
+#endif
+    } else {
+        HG_LOG_SUBSYS_DEBUG(bulk, "Serializing %u NA memory handle(s)",
+            desc_info.segment_count);
+
+        ret = hg_bulk_serialize_mem_descs(hg_bulk->na_class, &buf_ptr,
+            &buf_size_left, &hg_bulk->na_mem_descs, segments,
+            desc_info.segment_count);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not serialize NA mem descriptors");
+
+#ifdef NA_HAS_SM
+        /* Only add SM serialized handles if we're sending over SM, otherwise
+         * skip it. */
+        if ((desc_info.flags & HG_BULK_SM) && hg_bulk->na_sm_class) {
+            ret = hg_bulk_serialize_mem_descs(hg_bulk->na_sm_class, &buf_ptr,
+                &buf_size_left, &hg_bulk->na_sm_mem_descs, segments,
+                desc_info.segment_count);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                bulk, error, ret, "Could not serialize NA SM mem descriptors");
+        }
+#endif
+    }
+
+    /* Handles of additional rails */
+    if (desc_flags & HG_BULK_RAILS) {
+        ret = hg_bulk_serialize_rails(&buf_ptr, &buf_size_left, hg_bulk);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not serialize bulk rail handles");
+    }
+
+    /* Address information */
+    if (desc_info.flags & HG_BULK_BIND) {
+        hg_size_t serialize_size;
+        unsigned long addr_flags = 0;
+
+        HG_LOG_SUBSYS_DEBUG(
+            bulk, "HG_BULK_BIND flag set, serializing address information");
+
+#ifdef NA_HAS_SM
+        if (flags & HG_BULK_SM)
+            addr_flags |= HG_CORE_SM;
+#endif
+
+        serialize_size =
+            HG_Core_addr_get_serialize_size(hg_bulk->addr, addr_flags);
+
+        HG_BULK_VARINT_ENCODE(
+            error, ret, buf_ptr, buf_size_left, serialize_size);
+
+        ret = HG_Core_addr_serialize(
+            buf_ptr, buf_size_left, addr_flags, hg_bulk->addr);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not serialize address");
+        buf_ptr += serialize_size;
+        buf_size_left -= serialize_size;
+
+        /* Add context ID */
+        HG_BULK_ENCODE(error, ret, buf_ptr, buf_size_left, &hg_bulk->context_id,
+            hg_uint8_t);
+    }
+
+    /* Add the serialized data if eager mode is requested */
+    if (desc_info.flags & HG_BULK_EAGER) {
+        HG_LOG_SUBSYS_DEBUG(bulk, "Serializing eager bulk data, %u segment(s)",
+            desc_info.segment_count);
+        for (i = 0; i < desc_info.segment_count; i++) {
+            if (!segments[i].len)
+                continue;
+
+            HG_BULK_ENCODE_ARRAY(error, ret, buf_ptr, buf_size_left,
+                (const void *) segments[i].base, char, segments[i].len);
+        }
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_serialize_mem_descs(na_class_t *na_class, char **buf_p,
+    hg_size_t *buf_size_left_p, struct hg_bulk_na_mem_desc *na_mem_descs,
+    const struct hg_bulk_segment *segments, hg_uint32_t count)
+{
+    na_mem_handle_t **na_mem_handles;
+    size_t *na_mem_serialize_sizes;
+    hg_return_t ret;
+    hg_uint32_t i;
+
+    if (count > HG_BULK_STATIC_MAX) {
+        na_mem_handles = na_mem_descs->handles.d;
+        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.d;
+    } else {
+        na_mem_handles = na_mem_descs->handles.s;
+        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
+    }
+
+    /* Handles not registered yet (lazy registration), encode empty sizes */
+    if (na_mem_handles == NULL) {
+        for (i = 0; i < count; i++)
+            HG_BULK_VARINT_ENCODE(error, ret, *buf_p, *buf_size_left_p, 0);
+        return HG_SUCCESS;
+    }
+
+    /* Encode serialize sizes */
+    for (i = 0; i < count; i++)
+        HG_BULK_VARINT_ENCODE(
+            error, ret, *buf_p, *buf_size_left_p, na_mem_serialize_sizes[i]);
+
+    for (i = 0; i < count; i++) {
+        na_return_t na_ret;
+
+        /* Skip null segments and segments that are not registered */
+        if (segments[i].base == (hg_ptr_t) NULL ||
+            na_mem_handles[i] == NULL)
+            continue;
+
+        na_ret = NA_Mem_handle_serialize(
+            na_class, *buf_p, *buf_size_left_p, na_mem_handles[i]);
+        HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not serialize memory handle (%s)",
+            NA_Error_to_string(na_ret));
+
+        *buf_p += na_mem_serialize_sizes[i];
+        *buf_size_left_p -= na_mem_serialize_sizes[i];
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_bulk_get_serialize_size_rails(struct hg_bulk *hg_bulk)
+{
+    const struct hg_bulk_rails *hg_bulk_rails = hg_bulk->rails;
+    hg_size_t ret = sizeof(hg_uint8_t);
+    hg_uint8_t i;
+
+    /* Rail count + address and memory handle of each rail */
+    for (i = 1; i < hg_bulk_rails->count; i++) {
+        ret += hg_bulk_varint_size(hg_bulk_rails->addr_sizes[i]) +
+               hg_bulk_rails->addr_sizes[i];
+        ret += hg_bulk_varint_size(hg_bulk_rails->serialize_sizes[i]);
+        if (hg_bulk_rails->handles[i] != NULL)
+            ret += hg_bulk_rails->serialize_sizes[i];
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_serialize_rails(
+    char **buf_p, hg_size_t *buf_size_left_p, struct hg_bulk *hg_bulk)
+{
+    const struct hg_core_rails *rails =
+        hg_core_class_get_rails(hg_bulk->core_class);
+    const struct hg_bulk_rails *hg_bulk_rails = hg_bulk->rails;
+    hg_uint8_t i;
+    hg_return_t ret;
+
+    HG_LOG_SUBSYS_DEBUG(bulk, "Serializing NA memory handles of %" PRIu8
+        " rail(s)", hg_bulk_rails->count);
+
+    HG_BULK_ENCODE(error, ret, *buf_p, *buf_size_left_p, &hg_bulk_rails->count,
+        hg_uint8_t);
+
+    for (i = 1; i < hg_bulk_rails->count; i++) {
+        size_t handle_size = (hg_bulk_rails->handles[i] != NULL)
+                                 ? hg_bulk_rails->serialize_sizes[i]
+                                 : 0;
+        na_return_t na_ret;
+
+        /* Address of rail (handles that were deserialized keep pointing to
+         * the rails of their owner) */
+        HG_BULK_VARINT_ENCODE(error, ret, *buf_p, *buf_size_left_p,
+            hg_bulk_rails->addr_sizes[i]);
+        na_ret = NA_Addr_serialize(rails->rail[i].na_class, *buf_p,
+            *buf_size_left_p,
+            (hg_bulk_rails->addrs[i] != NULL) ? hg_bulk_rails->addrs[i]
+                                              : rails->rail[i].self_addr);
+        HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not serialize rail address (%s)",
+            NA_Error_to_string(na_ret));
+        *buf_p += hg_bulk_rails->addr_sizes[i];
+        *buf_size_left_p -= hg_bulk_rails->addr_sizes[i];
+
+        /* Memory handle (none if rail could not register memory) */
+        HG_BULK_VARINT_ENCODE(
+            error, ret, *buf_p, *buf_size_left_p, handle_size);
+        if (handle_size == 0)
+            continue;
+        na_ret = NA_Mem_handle_serialize(rails->rail[i].na_class, *buf_p,
+            *buf_size_left_p, hg_bulk_rails->handles[i]);
+        HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not serialize rail memory handle (%s)",
+            NA_Error_to_string(na_ret));
+        *buf_p += handle_size;
+        *buf_size_left_p -= handle_size;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_deserialize(hg_core_class_t *core_class, struct hg_bulk **hg_bulk_p,
+    const void *buf, hg_size_t buf_size, hg_core_handle_t pin_handle)
+{
+    struct hg_bulk *hg_bulk = NULL;
+    struct hg_bulk_segment *segments;
+    const char *buf_ptr = (const char *) buf;
+    hg_size_t buf_size_left = buf_size;
+    hg_uint64_t value;
+    hg_uint8_t desc_flags;
+    hg_uint32_t i;
+    hg_return_t ret;
+
+    hg_bulk = (struct hg_bulk *) calloc(1, sizeof(*hg_bulk));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk == NULL, error, ret, HG_NOMEM,
+        "Could not allocate handle");
+
+    /* Counted from here on as releasing the handle uncounts it */
+    hg_bulk->core_class = core_class;
+    hg_core_bulk_incr(core_class);
+    hg_bulk->na_class = HG_Core_class_get_na(core_class);
+    hg_bulk->registered = HG_FALSE;
+    hg_atomic_init32(&hg_bulk->ref_count, 1);
+
+    /* Flags and segment count */
+    HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left, &desc_flags, hg_uint8_t);
+    hg_bulk->desc.info.flags =
+        desc_flags & (~(HG_BULK_CONTIG | HG_BULK_RAILS) & 0xff);
+    HG_BULK_VARINT_DECODE(error, ret, buf_ptr, buf_size_left, &value);
+    /* Each segment takes at least one byte, do not trust larger counts */
+    HG_CHECK_SUBSYS_ERROR(bulk, value > buf_size_left || value > UINT32_MAX,
+        error, ret, HG_PROTOCOL_ERROR, "Invalid segment count (%" PRIu64 ")",
+        value);
+    hg_bulk->desc.info.segment_count = (hg_uint32_t) value;
+
+#ifdef NA_HAS_SM
+    /* Use SM classes if requested */
+    if (hg_bulk->desc.info.flags & HG_BULK_SM) {
+        HG_LOG_SUBSYS_DEBUG(bulk, "HG_BULK_SM flag is set");
+        hg_bulk->na_sm_class = HG_Core_class_get_na_sm(core_class);
+        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk->na_sm_class == NULL, error, ret,
+            HG_PROTOCOL_ERROR, "SM class is not set");
+    }
+#endif
+
+    /* Segments */
+    if (hg_bulk->desc.info.segment_count > HG_BULK_STATIC_MAX) {
+        /* Allocate segments */
+        hg_bulk->desc.segments.d = (struct hg_bulk_segment *) calloc(
+            hg_bulk->desc.info.segment_count, sizeof(struct hg_bulk_segment));
+        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk->desc.segments.d == NULL, error,
+            ret, HG_NOMEM, "Could not allocate segment array");
+
+        segments = hg_bulk->desc.segments.d;
+    } else
+        segments = hg_bulk->desc.segments.s;
+    if (desc_flags & HG_BULK_CONTIG) {
+        hg_ptr_t base;
+
+        HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left, &base, hg_ptr_t);
+        for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
+            HG_BULK_VARINT_DECODE(
+                error, ret, buf_ptr, buf_size_left, &segments[i].len);
+            segments[i].base = base;
+            base += segments[i].len;
+            hg_bulk->desc.info.len += segments[i].len;
+        }
+    } else {
+        for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
+            HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left,
+                &segments[i].base, hg_ptr_t);
+            HG_BULK_VARINT_DECODE(
+                error, ret, buf_ptr, buf_size_left, &segments[i].len);
+            hg_bulk->desc.info.len += segments[i].len;
+        }
+    }
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Deserializing bulk handle with %u segment(s), len is %" PRIu64
+        " bytes",
+        hg_bulk->desc.info.segment_count, hg_bulk->desc.info.len);
+
+    /* Get the NA memory handles */
+    if (hg_bulk->desc.info.flags & HG_BULK_REGV ||
+        (hg_bulk->desc.info.segment_count == 1)) {
+        /* Always deserialize handle if HG_BULK_REGV is set */
+        if ((segments[0].base != (hg_ptr_t) NULL) ||
+            (hg_bulk->desc.info.flags & HG_BULK_REGV)) {
+            na_return_t na_ret;
+
+            HG_LOG_SUBSYS_DEBUG(bulk, "Deserializing single NA memory handle");
+
+            HG_BULK_VARINT_DECODE(error, ret, buf_ptr, buf_size_left, &value);
+            HG_CHECK_SUBSYS_ERROR(bulk, value > buf_size_left, error, ret,
+                HG_OVERFLOW, "Invalid memory handle size (%" PRIu64 ")", value);
+            hg_bulk->na_mem_descs.serialize_sizes.s[0] = (size_t) value;
+
+            /* Empty size if handle was not registered (lazy registration) */
+            if (value > 0) {
+                na_ret = NA_Mem_handle_deserialize(hg_bulk->na_class,
+                    &hg_bulk->na_mem_descs.handles.s[0], buf_ptr,
+                    buf_size_left);
+                HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+                    (hg_return_t) na_ret,
+                    "Could not deserialize memory handle (%s)",
+                    NA_Error_to_string(na_ret));
+            }
+            buf_ptr += hg_bulk->na_mem_descs.serialize_sizes.s[0];
+            buf_size_left -= hg_bulk->na_mem_descs.serialize_sizes.s[0];
+
+#ifdef NA_HAS_SM
+            /* Only deserialize handles if we were sending over SM */
+            if (hg_bulk->desc.info.flags & HG_BULK_SM) {
+                HG_BULK_VARINT_DECODE(
+                    error, ret, buf_ptr, buf_size_left, &value);
+                HG_CHECK_SUBSYS_ERROR(bulk, value > buf_size_left, error, ret,
+                    HG_OVERFLOW, "Invalid SM memory handle size (%" PRIu64 ")",
+                    value);
+                hg_bulk->na_sm_mem_descs.serialize_sizes.s[0] = (size_t) value;
+
+                if (value > 0) {
+                    na_ret = NA_Mem_handle_deserialize(hg_bulk->na_sm_class,
+                        &hg_bulk->na_sm_mem_descs.handles.s[0], buf_ptr,
+                        buf_size_left);
+                    HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error,
+                        ret, (hg_return_t) na_ret,
+                        "Could not deserialize SM memory handle (%s)",
+                        NA_Error_to_string(na_ret));
+                }
+                buf_ptr += hg_bulk->na_sm_mem_descs.serialize_sizes.s[0];
+                buf_size_left -= hg_bulk->na_sm_mem_descs.serialize_sizes.s[0];
+            }
+#endif
+        }
+    } else {
+        HG_LOG_SUBSYS_DEBUG(bulk, "Deserializing %u NA memory handle(s)",
+            hg_bulk->desc.info.segment_count);
+
+        ret = hg_bulk_deserialize_mem_descs(hg_bulk->na_class, &buf_ptr,
+            &buf_size_left, &hg_bulk->na_mem_descs, segments,
+            hg_bulk->desc.info.segment_count);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not deserialize NA mem descriptors");
+
+#ifdef NA_HAS_SM
+        /* Only deserialize handles if we were sending over SM */
+        if (hg_bulk->desc.info.flags & HG_BULK_SM) {
+            ret = hg_bulk_deserialize_mem_descs(hg_bulk->na_sm_class, &buf_ptr,
+                &buf_size_left, &hg_bulk->na_sm_mem_descs, segments,
+                hg_bulk->desc.info.segment_count);
+            HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret,
+                "Could not deserialize NA SM mem descriptors");
+        }
+#endif
+    }
+
+    /* Handles of additional rails */
+    if (desc_flags & HG_BULK_RAILS) {
+        ret = hg_bulk_deserialize_rails(&buf_ptr, &buf_size_left, hg_bulk);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not deserialize bulk rail handles");
+    }
+
+    /* Address information */
+    if (hg_bulk->desc.info.flags & HG_BULK_BIND) {
+        HG_LOG_SUBSYS_DEBUG(
+            bulk, "HG_BULK_BIND flag set, deserializing address information");
+
+        HG_BULK_VARINT_DECODE(error, ret, buf_ptr, buf_size_left, &value);
+        HG_CHECK_SUBSYS_ERROR(bulk, value > buf_size_left, error, ret,
+            HG_OVERFLOW, "Invalid address size (%" PRIu64 ")", value);
+
+        ret = HG_Core_addr_deserialize(
+            hg_bulk->core_class, &hg_bulk->addr, buf_ptr, buf_size_left);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not deserialize address");
+        buf_ptr += value;
+        buf_size_left -= value;
+
+        /* Get context ID */
+        HG_BULK_DECODE(error, ret, buf_ptr, buf_size_left, &hg_bulk->context_id,
+            hg_uint8_t);
+    }
+
+    /* Get the serialized data */
+    if (hg_bulk->desc.info.flags & HG_BULK_EAGER) {
+        HG_LOG_SUBSYS_DEBUG(bulk,
+            "Deserializing eager bulk data, %u segment(s)",
+            hg_bulk->desc.info.segment_count);
+        if (pin_handle == NULL) {
+            /* Bases are remote addresses until data is copied, do not free
+             * them if the descriptor turns out to be truncated */
+            for (i = 0; i < hg_bulk->desc.info.segment_count; i++)
+                segments[i].base = (hg_ptr_t) NULL;
+            hg_bulk->desc.info.flags |= HG_BULK_ALLOC;
+        }
+        for (i = 0; i < hg_bulk->desc.info.segment_count; i++) {
+            if (!segments[i].len)
+                continue;
+
+            /* Point to data in place, buffer is kept by pin handle */
+            if (pin_handle != NULL) {
+                HG_CHECK_SUBSYS_ERROR(bulk, buf_size_left < segments[i].len,
+                    error, ret, HG_OVERFLOW,
+                    "Buffer size too small (%" PRIu64 ")", buf_size_left);
+                segments[i].base = (hg_ptr_t) buf_ptr;
+                buf_ptr += segments[i].len;
+                buf_size_left -= segments[i].len;
+                continue;
+            }
+
+            /* Override base address to store data */
+            segments[i].base = (hg_ptr_t) calloc(1, segments[i].len);
+            HG_CHECK_SUBSYS_ERROR(bulk, segments[i].base == (hg_ptr_t) NULL,
+                error, ret, HG_NOMEM, "Could not allocate segment");
+
+            HG_BULK_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left,
+                (void *) segments[i].base, char, segments[i].len);
+        }
+        if (pin_handle != NULL) {
+            ret = HG_Core_ref_incr(pin_handle);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                bulk, error, ret, "Could not take reference on pin handle");
+            hg_bulk->pin_handle = pin_handle;
+        }
+    } else
+        /* Addresses are virtual and do not point to physical memory */
+        hg_bulk->desc.info.flags |= HG_BULK_VIRT;
+
+    HG_CHECK_SUBSYS_WARNING(bulk, buf_size_left != 0,
+        "Buffer size left for decoding bulk handle is not zero (%" PRIu64 ")",
+        buf_size_left);
+
+    *hg_bulk_p = hg_bulk;
+
+    return HG_SUCCESS;
+
+error:
+    hg_bulk_free(hg_bulk);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_deserialize_mem_descs(na_class_t *na_class, const char **buf_p,
+    hg_size_t *buf_size_left_p, struct hg_bulk_na_mem_desc *na_mem_descs,
+    const struct hg_bulk_segment *segments, hg_uint32_t count)
+{
+    na_mem_handle_t **na_mem_handles;
+    size_t *na_mem_serialize_sizes;
+    hg_return_t ret;
+    hg_uint32_t i;
+
+    if (count > HG_BULK_STATIC_MAX) {
+        /* Allocate NA memory handles */
+        na_mem_descs->handles.d =
+            (na_mem_handle_t **) calloc(count, sizeof(na_mem_handle_t *));
+        HG_CHECK_SUBSYS_ERROR(bulk, na_mem_descs->handles.d == NULL, error, ret,
+            HG_NOMEM, "Could not allocate mem handle array");
+
+        /* Allocate serialize sizes */
+        na_mem_descs->serialize_sizes.d =
+            (size_t *) calloc(count, sizeof(size_t));
+        HG_CHECK_SUBSYS_ERROR(bulk, na_mem_descs->serialize_sizes.d == NULL,
+            error, ret, HG_NOMEM, "Could not allocate serialize sizes array");
+
+        na_mem_handles = na_mem_descs->handles.d;
+        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.d;
+    } else {
+        na_mem_handles = na_mem_descs->handles.s;
+        na_mem_serialize_sizes = na_mem_descs->serialize_sizes.s;
+    }
+
+    /* Decode serialize sizes */
+    for (i = 0; i < count; i++) {
+        hg_uint64_t value;
+
+        HG_BULK_VARINT_DECODE(error, ret, *buf_p, *buf_size_left_p, &value);
+        HG_CHECK_SUBSYS_ERROR(bulk,
+            segments[i].base != (hg_ptr_t) NULL && value > *buf_size_left_p,
+            error, ret, HG_OVERFLOW, "Invalid memory handle size (%" PRIu64 ")",
+            value);
+        na_mem_serialize_sizes[i] = (size_t) value;
+    }
+
+    for (i = 0; i < count; i++) {
+        na_return_t na_ret;
+
+        /* Skip null segments and segments that were not registered */
+        if (segments[i].base == (hg_ptr_t) NULL ||
+            na_mem_serialize_sizes[i] == 0)
+            continue;
+
+        na_ret = NA_Mem_handle_deserialize(
+            na_class, &na_mem_handles[i], *buf_p, *buf_size_left_p);
+        HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not deserialize memory handle (%s)",
+            NA_Error_to_string(na_ret));
+
+        *buf_p += na_mem_serialize_sizes[i];
+        *buf_size_left_p -= na_mem_serialize_sizes[i];
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_deserialize_rails(
+    const char **buf_p, hg_size_t *buf_size_left_p, struct hg_bulk *hg_bulk)
+{
+    const struct hg_core_rails *rails =
+        hg_core_class_get_rails(hg_bulk->core_class);
+    struct hg_bulk_rails *hg_bulk_rails = NULL;
+    hg_uint8_t count, i;
+    hg_return_t ret;
+
+    HG_BULK_DECODE(error, ret, *buf_p, *buf_size_left_p, &count, hg_uint8_t);
+    HG_CHECK_SUBSYS_ERROR(bulk, count > HG_CORE_RAIL_MAX, error, ret,
+        HG_PROTOCOL_ERROR, "Invalid rail count (%" PRIu8 ")", count);
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Deserializing NA memory handles of %" PRIu8 " rail(s)", count);
+
+    /* Only rails that are also available locally can be used */
+    if (rails->count > 1 && count > 1) {
+        hg_bulk_rails =
+            (struct hg_bulk_rails *) calloc(1, sizeof(*hg_bulk_rails));
+        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_rails == NULL, error, ret,
+            HG_NOMEM, "Could not allocate rail handles");
+        hg_bulk_rails->count = HG_BULK_MIN(count, rails->count);
+        hg_bulk->rails = hg_bulk_rails;
+    }
+
+    for (i = 1; i < count; i++) {
+        hg_bool_t used = (hg_bulk_rails != NULL && i < hg_bulk_rails->count);
+        hg_uint64_t value;
+        na_return_t na_ret;
+
+        /* Address of rail */
+        HG_BULK_VARINT_DECODE(error, ret, *buf_p, *buf_size_left_p, &value);
+        HG_CHECK_SUBSYS_ERROR(bulk, value > *buf_size_left_p, error, ret,
+            HG_OVERFLOW, "Invalid rail address size (%" PRIu64 ")", value);
+        if (used) {
+            na_ret = NA_Addr_deserialize(rails->rail[i].na_class,
+                &hg_bulk_rails->addrs[i], *buf_p, (size_t) value);
+            HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+                (hg_return_t) na_ret, "Could not deserialize rail address (%s)",
+                NA_Error_to_string(na_ret));
+            hg_bulk_rails->addr_sizes[i] = (size_t) value;
+        }
+        *buf_p += value;
+        *buf_size_left_p -= value;
+
+        /* Memory handle */
+        HG_BULK_VARINT_DECODE(error, ret, *buf_p, *buf_size_left_p, &value);
+        HG_CHECK_SUBSYS_ERROR(bulk, value > *buf_size_left_p, error, ret,
+            HG_OVERFLOW, "Invalid rail memory handle size (%" PRIu64 ")",
+            value);
+        if (used && value > 0) {
+            na_ret = NA_Mem_handle_deserialize(rails->rail[i].na_class,
+                &hg_bulk_rails->handles[i], *buf_p, (size_t) value);
+            HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+                (hg_return_t) na_ret,
+                "Could not deserialize rail memory handle (%s)",
+                NA_Error_to_string(na_ret));
+            hg_bulk_rails->serialize_sizes[i] = (size_t) value;
+        }
+        *buf_p += value;
+        *buf_size_left_p -= value;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+hg_bulk_get_serialize_cached_ptr(struct hg_bulk *hg_bulk)
+{
+    return hg_bulk->serialize_ptr;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_size_t
+hg_bulk_get_serialize_cached_size(struct hg_bulk *hg_bulk)
+{
+    return hg_bulk->serialize_size;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_bulk_set_serialize_cached_ptr(
+    struct hg_bulk *hg_bulk, void *buf, size_t buf_size)
+{
+    /* Handles from the descriptor cache keep pointing to their own copy */
+    if (hg_bulk->desc_buf != NULL)
+        return;
+
+    hg_bulk->serialize_ptr = buf;
+    hg_bulk->serialize_size = buf_size;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_deserialize_pinned(hg_class_t *hg_class, struct hg_bulk **hg_bulk_p,
+    const void *buf, hg_size_t buf_size, hg_core_handle_t pin_handle)
+{
+    struct hg_bulk_desc_cache *hg_bulk_desc_cache =
+        hg_core_class_get_bulk_desc_cache(hg_class->core_class);
+
+    if (hg_bulk_desc_cache != NULL)
+        return hg_bulk_desc_cache_get(hg_bulk_desc_cache, hg_class->core_class,
+            hg_bulk_p, buf, buf_size, pin_handle);
+    else
+        return hg_bulk_deserialize(
+            hg_class->core_class, hg_bulk_p, buf, buf_size, pin_handle);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_access(struct hg_bulk *hg_bulk, hg_size_t offset, hg_size_t size,
+    hg_uint8_t flags, hg_uint32_t max_count, void **buf_ptrs,
+    hg_size_t *buf_sizes, hg_uint32_t *actual_count)
+{
+    struct hg_bulk_segment *segments = HG_BULK_SEGMENTS(hg_bulk);
+    hg_uint32_t segment_index;
+    hg_size_t segment_offset;
+    hg_size_t remaining_size = size;
+    hg_uint32_t count = 0;
+
+    /* TODO use flags */
+    (void) flags;
+
+    hg_bulk_offset_translate(segments, hg_bulk->desc.info.segment_count, offset,
+        &segment_index, &segment_offset);
+
+    while ((remaining_size > 0) && (count < max_count)) {
+        hg_ptr_t base;
+        hg_size_t len;
+
+        /* Can only transfer smallest size */
+        len = segments[segment_index].len - segment_offset;
+
+        /* Remaining size may be smaller */
+        len = HG_BULK_MIN(remaining_size, len);
+        base = segments[segment_index].base + (hg_ptr_t) segment_offset;
+
+        /* Fill segments */
+        if (buf_ptrs)
+            buf_ptrs[count] = (void *) base;
+        if (buf_sizes)
+            buf_sizes[count] = len;
+        /*
+        printf("Segment %d: address=0x%lX\n", count, segment_address);
+        printf("Segment %d: size=%zu\n", count, segment_size);
+         */
+
+        /* Decrease remaining size from the size of data we transferred */
+        remaining_size -= len;
+
+        /* Change segment */
+        segment_index++;
+        segment_offset = 0;
+        count++;
+    }
+
+    if (actual_count)
+        *actual_count = count;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_bulk_offset_translate(const struct hg_bulk_segment *segments,
+    hg_uint32_t count, hg_size_t offset, hg_uint32_t *segment_start_index,
+    hg_size_t *segment_start_offset)
+{
+    hg_uint32_t i, new_segment_start_index = 0;
+    hg_size_t new_segment_offset = offset, next_offset = 0;
+
+    /* Get start index and handle offset */
+    for (i = 0; i < count; i++) {
+        next_offset += segments[i].len;
+        if (offset < next_offset) {
+            new_segment_start_index = i;
+            break;
+        }
+        new_segment_offset -= segments[i].len;
+    }
+
+    *segment_start_index = new_segment_start_index;
+    *segment_start_offset = new_segment_offset;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_op_create(
+    hg_core_context_t *core_context, struct hg_bulk_op_id **hg_bulk_op_id_p)
+{
+    const struct hg_core_rails *rails =
+        hg_core_class_get_rails(core_context->core_class);
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    hg_return_t ret;
+    int i;
+
+    hg_bulk_op_id = (struct hg_bulk_op_id *) calloc(1, sizeof(*hg_bulk_op_id));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_id == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG Bulk operation ID");
+
+    hg_bulk_op_id->core_context = core_context;
+    hg_atomic_init32(&hg_bulk_op_id->ref_count, 1);
+
+    /* Completed by default */
+    hg_atomic_init32(&hg_bulk_op_id->status, HG_BULK_OP_COMPLETED);
+    hg_atomic_init32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS);
+
+    hg_bulk_op_id->callback_info.type = HG_CB_BULK;
+    hg_bulk_op_id->op_count = 1; /* Default */
+    hg_bulk_op_id->na_op_id_count = 1;
+    hg_atomic_init32(&hg_bulk_op_id->op_completed_count, 0);
+
+    /* Preallocate NA OP IDs */
+    for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
+        hg_bulk_op_id->na_op_ids.s[i] =
+            NA_Op_create(core_context->core_class->na_class, 0);
+        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_id->na_op_ids.s[i] == NULL,
+            error, ret, HG_NA_ERROR, "NA_Op_create() failed");
+    }
+#ifdef NA_HAS_SM
+    if (core_context->core_class->na_sm_class) {
+        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
+            hg_bulk_op_id->na_sm_op_ids.s[i] =
+                NA_Op_create(core_context->core_class->na_sm_class, 0);
+            HG_CHECK_SUBSYS_ERROR(bulk,
+                hg_bulk_op_id->na_sm_op_ids.s[i] == NULL, error, ret,
+                HG_NA_ERROR, "NA_Op_create() failed");
+        }
+    }
+#endif
+    for (i = 0; i < HG_CORE_RAIL_MAX; i++)
+        hg_bulk_op_id->rail_ops[i].hg_bulk_op_id = hg_bulk_op_id;
+    for (i = 1; i < rails->count; i++) {
+        hg_bulk_op_id->rail_ops[i].na_op_id =
+            NA_Op_create(rails->rail[i].na_class, 0);
+        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_id->rail_ops[i].na_op_id == NULL,
+            error, ret, HG_NA_ERROR, "NA_Op_create() failed");
+    }
+
+    HG_LOG_SUBSYS_DEBUG(
+        bulk, "Created new bulk op ID (%p)", (void *) hg_bulk_op_id);
+
+    *hg_bulk_op_id_p = hg_bulk_op_id;
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_bulk_op_id) {
+        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
+            if (hg_bulk_op_id->na_op_ids.s[i] == NULL)
+                continue;
+
+            NA_Op_destroy(core_context->core_class->na_class,
+                hg_bulk_op_id->na_op_ids.s[i]);
+        }
+#ifdef NA_HAS_SM
+        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
+            if (hg_bulk_op_id->na_sm_op_ids.s[i] == NULL)
+                continue;
+
+            NA_Op_destroy(core_context->core_class->na_sm_class,
+                hg_bulk_op_id->na_sm_op_ids.s[i]);
+        }
+#endif
+        for (i = 1; i < rails->count; i++) {
+            if (hg_bulk_op_id->rail_ops[i].na_op_id == NULL)
+                continue;
+
+            NA_Op_destroy(
+                rails->rail[i].na_class, hg_bulk_op_id->rail_ops[i].na_op_id);
+        }
+        free(hg_bulk_op_id);
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_op_destroy(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    hg_uint32_t i;
+
+    if (hg_atomic_decr32(&hg_bulk_op_id->ref_count))
+        return; /* Cannot free yet */
+
+    /* Keep extra op IDs for re-use unless there are too many of them */
+    if (!hg_bulk_op_id->reuse ||
+        hg_bulk_op_id->na_op_ids.d_count > HG_BULK_NA_OP_IDS_KEEP_MAX)
+        hg_bulk_na_op_ids_free(&hg_bulk_op_id->na_op_ids,
+            hg_bulk_op_id->core_context->core_class->na_class);
+#ifdef NA_HAS_SM
+    if (!hg_bulk_op_id->reuse ||
+        hg_bulk_op_id->na_sm_op_ids.d_count > HG_BULK_NA_OP_IDS_KEEP_MAX)
+        hg_bulk_na_op_ids_free(&hg_bulk_op_id->na_sm_op_ids,
+            hg_bulk_op_id->core_context->core_class->na_sm_class);
+#endif
+
+    /* Release transfers of list */
+    if (hg_bulk_op_id->children) {
+        for (i = 0; i < hg_bulk_op_id->child_count; i++) {
+            struct hg_bulk_op_id *hg_bulk_child_op_id =
+                hg_bulk_op_id->children[i];
+
+            (void) hg_bulk_free(
+                hg_bulk_child_op_id->callback_info.info.bulk.origin_handle);
+            (void) hg_bulk_free(
+                hg_bulk_child_op_id->callback_info.info.bulk.local_handle);
+            hg_bulk_op_destroy(hg_bulk_child_op_id);
+        }
+        free(hg_bulk_op_id->children);
+        hg_bulk_op_id->children = NULL;
+        hg_bulk_op_id->child_count = 0;
+    }
+
+    /* Release pipelined transfer state */
+    if (hg_bulk_op_id->pipeline) {
+        hg_bulk_pipeline_free(hg_bulk_op_id->pipeline);
+        hg_bulk_op_id->pipeline = NULL;
+    }
+
+    /* Repost handle if we were listening, otherwise destroy it */
+    if (hg_bulk_op_id->reuse) {
+        HG_LOG_SUBSYS_DEBUG(
+            bulk, "Re-using bulk op ID (%p)", (void *) hg_bulk_op_id);
+
+        /* Reset ref_count */
+        hg_atomic_set32(&hg_bulk_op_id->ref_count, 1);
+
+        /* Reset status */
+        hg_atomic_set32(&hg_bulk_op_id->status, HG_BULK_OP_COMPLETED);
+
+        hg_bulk_op_pool_put(hg_bulk_op_id->op_pool, hg_bulk_op_id);
+    } else {
+        const struct hg_core_rails *rails =
+            hg_core_class_get_rails(hg_bulk_op_id->core_context->core_class);
+
+        HG_LOG_SUBSYS_DEBUG(
+            bulk, "Freeing bulk op ID (%p)", (void *) hg_bulk_op_id);
+
+        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
+            if (hg_bulk_op_id->na_op_ids.s[i] == NULL)
+                continue;
+
+            NA_Op_destroy(hg_bulk_op_id->core_context->core_class->na_class,
+                hg_bulk_op_id->na_op_ids.s[i]);
+        }
+
+#ifdef NA_HAS_SM
+        for (i = 0; i < HG_BULK_STATIC_MAX; i++) {
+            if (hg_bulk_op_id->na_sm_op_ids.s[i] == NULL)
+                continue;
+
+            NA_Op_destroy(hg_bulk_op_id->core_context->core_class->na_sm_class,
+                hg_bulk_op_id->na_sm_op_ids.s[i]);
+        }
+#endif
+
+        for (i = 1; i < rails->count; i++) {
+            if (hg_bulk_op_id->rail_ops[i].na_op_id == NULL)
+                continue;
+
+            NA_Op_destroy(
+                rails->rail[i].na_class, hg_bulk_op_id->rail_ops[i].na_op_id);
+        }
+
+#ifdef HG_HAS_CUDA
+        if (hg_bulk_op_id->cuda_event != NULL)
+            (void) cudaEventDestroy(hg_bulk_op_id->cuda_event);
+#endif
+
+        free(hg_bulk_op_id);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_bulk_op_pool_create(hg_core_context_t *core_context, unsigned int init_count,
+    struct hg_bulk_op_pool **hg_bulk_op_pool_p)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool = NULL;
+    unsigned int queue_size, i;
+    hg_return_t ret;
+
+    HG_LOG_SUBSYS_DEBUG(bulk, "Creating pool with %u bulk op IDs", init_count);
+
+    hg_bulk_op_pool =
+        (struct hg_bulk_op_pool *) calloc(1, sizeof(*hg_bulk_op_pool));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_pool == NULL, error, ret, HG_NOMEM,
+        "Could not allocate bulk op pool");
+
+    hg_thread_mutex_init(&hg_bulk_op_pool->extend_mutex);
+    hg_thread_cond_init(&hg_bulk_op_pool->extend_cond);
+    hg_bulk_op_pool->core_context = core_context;
+    HG_LIST_INIT(&hg_bulk_op_pool->pending_list);
+    hg_thread_spin_init(&hg_bulk_op_pool->pending_list_lock);
+    HG_LIST_INIT(&hg_bulk_op_pool->expiry_list);
+    hg_thread_spin_init(&hg_bulk_op_pool->expiry_list_lock);
+    hg_atomic_init32(&hg_bulk_op_pool->expiry_count, 0);
+#ifdef HG_HAS_CUDA
+    HG_LIST_INIT(&hg_bulk_op_pool->device_list);
+    hg_thread_spin_init(&hg_bulk_op_pool->device_list_lock);
+    hg_atomic_init32(&hg_bulk_op_pool->device_count, 0);
+#endif
+    HG_QUEUE_INIT(&hg_bulk_op_pool->sched_queue);
+    hg_thread_spin_init(&hg_bulk_op_pool->sched_lock);
+    hg_bulk_op_pool->extending = HG_FALSE;
+
+    /* Op IDs are retrieved and released from any thread, keep them in a
+     * lock-free queue and only fall back to the pending list once the queue
+     * is full (i.e., after the pool has been extended several times) */
+    queue_size = HG_BULK_OP_POOL_QUEUE_MIN;
+    while (queue_size < 4 * init_count)
+        queue_size <<= 1;
+    hg_bulk_op_pool->free_queue = hg_atomic_queue_alloc(queue_size);
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_pool->free_queue == NULL, error, ret,
+        HG_NOMEM, "Could not allocate queue of free op IDs");
+
+    /* Bound bytes of NA transfers in flight, queued transfers are keyed by
+     * origin */
+    hg_bulk_op_pool->sched_max_inflight =
+        hg_core_class_get_bulk_max_inflight_size(core_context->core_class);
+    if (hg_bulk_op_pool->sched_max_inflight > 0) {
+        hg_bulk_op_pool->sched_peers =
+            hg_hash_table_new(hg_bulk_sched_key_hash, hg_bulk_sched_key_equal);
+        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_pool->sched_peers == NULL,
+            error, ret, HG_NOMEM, "Could not allocate table of origins");
+    }
+
+    /* Op IDs are charged to the memory budget of the class */
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        !hg_mem_budget_acquire(
+            hg_core_class_get_mem_budget(core_context->core_class),
+            init_count * sizeof(struct hg_bulk_op_id)),
+        error, ret, HG_NOMEM,
+        "Memory budget is too small for initial pool of %u op IDs",
+        init_count);
+    hg_bulk_op_pool->count = init_count;
+
+    for (i = 0; i < init_count; i++) {
+        struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+
+        ret = hg_bulk_op_create(core_context, &hg_bulk_op_id);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not create bulk op ID");
+
+        hg_bulk_op_id->reuse = HG_TRUE;
+        hg_bulk_op_id->op_pool = hg_bulk_op_pool;
+
+        hg_bulk_op_pool_put(hg_bulk_op_pool, hg_bulk_op_id);
+    }
+
+    HG_LOG_SUBSYS_DEBUG(
+        bulk, "Created bulk op ID pool (%p)", (void *) hg_bulk_op_pool);
+
+    *hg_bulk_op_pool_p = hg_bulk_op_pool;
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_bulk_op_pool)
+        hg_bulk_op_pool_destroy(hg_bulk_op_pool);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_bulk_op_pool_destroy(struct hg_bulk_op_pool *hg_bulk_op_pool)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+
+    HG_LOG_SUBSYS_DEBUG(
+        bulk, "Free bulk op ID pool (%p)", (void *) hg_bulk_op_pool);
+
+    if (hg_bulk_op_pool->free_queue != NULL) {
+        while ((hg_bulk_op_id = hg_atomic_queue_pop_mc(
+                    hg_bulk_op_pool->free_queue)) != NULL) {
+            /* Prevent re-initialization */
+            hg_bulk_op_id->reuse = HG_FALSE;
+
+            /* Destroy op IDs */
+            hg_bulk_op_destroy(hg_bulk_op_id);
+        }
+        hg_atomic_queue_free(hg_bulk_op_pool->free_queue);
+    }
+
+    hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
+
+    hg_bulk_op_id = HG_LIST_FIRST(&hg_bulk_op_pool->pending_list);
+
+    while (hg_bulk_op_id) {
+        struct hg_bulk_op_id *hg_bulk_op_id_next =
+            HG_LIST_NEXT(hg_bulk_op_id, pending);
+        HG_LIST_REMOVE(hg_bulk_op_id, pending);
+
+        /* Prevent re-initialization */
+        hg_bulk_op_id->reuse = HG_FALSE;
+
+        /* Destroy op IDs */
+        hg_bulk_op_destroy(hg_bulk_op_id);
+
+        hg_bulk_op_id = hg_bulk_op_id_next;
+    }
+    hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
+
+    hg_mem_budget_release(hg_core_class_get_mem_budget(
+                              hg_bulk_op_pool->core_context->core_class),
+        hg_bulk_op_pool->count * sizeof(struct hg_bulk_op_id));
+
+    hg_thread_mutex_destroy(&hg_bulk_op_pool->extend_mutex);
+    hg_thread_cond_destroy(&hg_bulk_op_pool->extend_cond);
+    hg_thread_spin_destroy(&hg_bulk_op_pool->pending_list_lock);
+    hg_thread_spin_destroy(&hg_bulk_op_pool->expiry_list_lock);
+#ifdef HG_HAS_CUDA
+    hg_thread_spin_destroy(&hg_bulk_op_pool->device_list_lock);
+#endif
+    if (hg_bulk_op_pool->sched_peers != NULL)
+        hg_hash_table_free(hg_bulk_op_pool->sched_peers);
+    hg_thread_spin_destroy(&hg_bulk_op_pool->sched_lock);
+
+    free(hg_bulk_op_pool);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_op_pool_get(struct hg_bulk_op_pool *hg_bulk_op_pool,
+    struct hg_bulk_op_id **hg_bulk_op_id_p)
+{
+    struct hg_mem_budget *mem_budget = hg_core_class_get_mem_budget(
+        hg_bulk_op_pool->core_context->core_class);
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    hg_return_t ret;
+
+    do {
+        unsigned int i;
+
+        hg_bulk_op_id = hg_atomic_queue_pop_mc(hg_bulk_op_pool->free_queue);
+        if (hg_bulk_op_id)
+            break;
+
+        hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
+        if ((hg_bulk_op_id = HG_LIST_FIRST(&hg_bulk_op_pool->pending_list)))
+            HG_LIST_REMOVE(hg_bulk_op_id, pending);
+        hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
+
+        if (hg_bulk_op_id)
+            break;
+
+        /* Create another batch of IDs if empty */
+        hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
+        if (hg_bulk_op_pool->extending) {
+            hg_thread_cond_wait(
+                &hg_bulk_op_pool->extend_cond, &hg_bulk_op_pool->extend_mutex);
+            hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+            continue;
+        }
+        hg_bulk_op_pool->extending = HG_TRUE;
+        hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+
+        /* Fail fast once the memory budget is exhausted */
+        if (!hg_mem_budget_acquire(mem_budget,
+                hg_bulk_op_pool->count * sizeof(struct hg_bulk_op_id))) {
+            HG_LOG_SUBSYS_DEBUG(
+                bulk, "Memory budget exhausted, could not extend op ID pool");
+            ret = HG_AGAIN;
+            goto error;
+        }
+
+        /* Only a single thread can extend the pool */
+        for (i = 0; i < hg_bulk_op_pool->count; i++) {
+            struct hg_bulk_op_id *new_op_id = NULL;
+
+            ret = hg_bulk_op_create(hg_bulk_op_pool->core_context, &new_op_id);
+            if (ret != HG_SUCCESS) {
+                hg_mem_budget_release(mem_budget,
+                    (hg_bulk_op_pool->count - i) * sizeof(*new_op_id));
+                hg_bulk_op_pool->count += i;
+                HG_GOTO_SUBSYS_ERROR_NORET(
+                    bulk, error, "Could not create bulk op ID");
+            }
+
+            new_op_id->reuse = HG_TRUE;
+            new_op_id->op_pool = hg_bulk_op_pool;
+
+            hg_bulk_op_pool_put(hg_bulk_op_pool, new_op_id);
+        }
+        hg_bulk_op_pool->count *= 2;
+
+        hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
+        hg_bulk_op_pool->extending = HG_FALSE;
+        hg_thread_cond_broadcast(&hg_bulk_op_pool->extend_cond);
+        hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+    } while (!hg_bulk_op_id);
+
+    *hg_bulk_op_id_p = hg_bulk_op_id;
+
+    return HG_SUCCESS;
+
+error:
+    hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
+    hg_bulk_op_pool->extending = HG_FALSE;
+    hg_thread_cond_broadcast(&hg_bulk_op_pool->extend_cond);
+    hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_bulk_op_pool_put(struct hg_bulk_op_pool *hg_bulk_op_pool,
+    struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    if (hg_atomic_queue_push(hg_bulk_op_pool->free_queue, hg_bulk_op_id) !=
+        HG_UTIL_SUCCESS) {
+        hg_thread_spin_lock(&hg_bulk_op_pool->pending_list_lock);
+        HG_LIST_INSERT_HEAD(
+            &hg_bulk_op_pool->pending_list, hg_bulk_op_id, pending);
+        hg_thread_spin_unlock(&hg_bulk_op_pool->pending_list_lock);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_na_op_ids_get(hg_bulk_na_op_id_t *hg_bulk_na_op_ids,
+    na_class_t *na_class, hg_uint32_t count, na_op_id_t ***na_op_ids_p)
+{
+    hg_return_t ret;
+
+    if (count <= HG_BULK_STATIC_MAX) {
+        *na_op_ids_p = hg_bulk_na_op_ids->s;
+        return HG_SUCCESS;
+    }
+
+    /* Grow dynamic array if op IDs that were kept are not enough */
+    if (count > hg_bulk_na_op_ids->d_count) {
+        na_op_id_t **na_op_ids = (na_op_id_t **) realloc(
+            hg_bulk_na_op_ids->d, count * sizeof(na_op_id_t *));
+        HG_CHECK_SUBSYS_ERROR(bulk, na_op_ids == NULL, error, ret, HG_NOMEM,
+            "Could not allocate memory for op_ids");
+        hg_bulk_na_op_ids->d = na_op_ids;
+
+        while (hg_bulk_na_op_ids->d_count < count) {
+            na_op_ids[hg_bulk_na_op_ids->d_count] = NA_Op_create(na_class, 0);
+            HG_CHECK_SUBSYS_ERROR(bulk,
+                na_op_ids[hg_bulk_na_op_ids->d_count] == NULL, error, ret,
+                HG_NA_ERROR, "Could not create NA op ID");
+            hg_bulk_na_op_ids->d_count++;
+        }
+    }
+
+    *na_op_ids_p = hg_bulk_na_op_ids->d;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_na_op_ids_free(
+    hg_bulk_na_op_id_t *hg_bulk_na_op_ids, na_class_t *na_class)
+{
+    hg_uint32_t i;
+
+    for (i = 0; i < hg_bulk_na_op_ids->d_count; i++)
+        NA_Op_destroy(na_class, hg_bulk_na_op_ids->d[i]);
+    free(hg_bulk_na_op_ids->d);
+    hg_bulk_na_op_ids->d = NULL;
+    hg_bulk_na_op_ids->d_count = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_op_get(
+    hg_core_context_t *core_context, struct hg_bulk_op_id **hg_bulk_op_id_p)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool =
+        hg_core_context_get_bulk_op_pool(core_context);
+    hg_return_t ret;
+
+    if (hg_bulk_op_pool) {
+        ret = hg_bulk_op_pool_get(hg_bulk_op_pool, hg_bulk_op_id_p);
+        HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not get bulk op ID");
+    } else {
+        ret = hg_bulk_op_create(core_context, hg_bulk_op_id_p);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not create bulk op ID");
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_bulk_sched_key_hash(hg_hash_table_key_t key)
+{
+    /* Low bits of the address are usually aligned */
+    return (unsigned int) ((uintptr_t) key >> 4);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int
+hg_bulk_sched_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return key1 == key2;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_sched_admit(struct hg_bulk_op_pool *hg_bulk_op_pool,
+    struct hg_bulk_op_id *hg_bulk_op_id, struct hg_core_addr *origin_addr,
+    hg_uint8_t origin_id, hg_size_t origin_offset, hg_size_t local_offset)
+{
+    hg_size_t size = hg_bulk_op_id->callback_info.info.bulk.size;
+    struct hg_bulk_sched_peer *hg_bulk_sched_peer;
+    void *key;
+    hg_return_t ret;
+
+    if (hg_bulk_op_pool == NULL || hg_bulk_op_pool->sched_max_inflight == 0)
+        return HG_TRUE;
+
+    hg_thread_spin_lock(&hg_bulk_op_pool->sched_lock);
+
+    /* Let at least one transfer through so that large transfers progress,
+     * do not overtake transfers that are already queued */
+    if (HG_QUEUE_IS_EMPTY(&hg_bulk_op_pool->sched_queue) &&
+        (hg_bulk_op_pool->sched_inflight == 0 ||
+            hg_bulk_op_pool->sched_inflight + size <=
+                hg_bulk_op_pool->sched_max_inflight))
+        goto admit;
+
+    /* Queue transfers per origin so that origins are served in turn */
+    key = (void *) HG_Core_addr_get_na(origin_addr);
+    if (key == NULL)
+        key = (void *) origin_addr;
+
+    hg_bulk_sched_peer = (struct hg_bulk_sched_peer *) hg_hash_table_lookup(
+        hg_bulk_op_pool->sched_peers, (hg_hash_table_key_t) key);
+    if (hg_bulk_sched_peer == NULL) {
+        hg_bulk_sched_peer = (struct hg_bulk_sched_peer *) malloc(
+            sizeof(*hg_bulk_sched_peer));
+        if (hg_bulk_sched_peer == NULL)
+            goto admit;
+        HG_QUEUE_INIT(&hg_bulk_sched_peer->queue);
+        hg_bulk_sched_peer->key = key;
+        if (hg_hash_table_insert(hg_bulk_op_pool->sched_peers,
+                (hg_hash_table_key_t) key,
+                (hg_hash_table_value_t) hg_bulk_sched_peer) == 0) {
+            free(hg_bulk_sched_peer);
+            goto admit;
+        }
+        HG_QUEUE_PUSH_TAIL(
+            &hg_bulk_op_pool->sched_queue, hg_bulk_sched_peer, entry);
+    }
+
+    /* Origin addr may be freed by the caller before the transfer starts */
+    ret = HG_Core_addr_dup(origin_addr, &hg_bulk_op_id->origin_addr);
+    if (ret != HG_SUCCESS) {
+        if (HG_QUEUE_IS_EMPTY(&hg_bulk_sched_peer->queue)) {
+            HG_QUEUE_REMOVE(&hg_bulk_op_pool->sched_queue, hg_bulk_sched_peer,
+                hg_bulk_sched_peer, entry);
+            (void) hg_hash_table_remove(
+                hg_bulk_op_pool->sched_peers, (hg_hash_table_key_t) key);
+            free(hg_bulk_sched_peer);
+        }
+        goto admit;
+    }
+    hg_bulk_op_id->origin_id = origin_id;
+    hg_bulk_op_id->origin_offset = origin_offset;
+    hg_bulk_op_id->local_offset = local_offset;
+    hg_bulk_op_id->sched_peer = hg_bulk_sched_peer;
+    HG_QUEUE_PUSH_TAIL(&hg_bulk_sched_peer->queue, hg_bulk_op_id, sched);
+
+    hg_thread_spin_unlock(&hg_bulk_op_pool->sched_lock);
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Queued bulk op ID (%p) of %" PRIu64 " bytes on origin (%p)",
+        (void *) hg_bulk_op_id, size, key);
+
+    return HG_FALSE;
+
+admit:
+    hg_bulk_op_pool->sched_inflight += size;
+    hg_bulk_op_id->sched_size = size;
+    hg_thread_spin_unlock(&hg_bulk_op_pool->sched_lock);
+
+    return HG_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_sched_release(
+    struct hg_bulk_op_id *hg_bulk_op_id, hg_bool_t self_notify)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool =
+        hg_core_context_get_bulk_op_pool(hg_bulk_op_id->core_context);
+    HG_QUEUE_HEAD(hg_bulk_op_id) start_queue;
+    struct hg_bulk_sched_peer *hg_bulk_sched_peer;
+    struct hg_bulk_op_id *next_op_id;
+
+    if (hg_bulk_op_id->sched_size == 0)
+        return;
+
+    HG_QUEUE_INIT(&start_queue);
+
+    hg_thread_spin_lock(&hg_bulk_op_pool->sched_lock);
+    hg_bulk_op_pool->sched_inflight -= hg_bulk_op_id->sched_size;
+    hg_bulk_op_id->sched_size = 0;
+
+    /* Take one transfer from each origin in turn while they fit */
+    while ((hg_bulk_sched_peer = HG_QUEUE_FIRST(
+                &hg_bulk_op_pool->sched_queue)) != NULL) {
+        hg_size_t size;
+
+        next_op_id = HG_QUEUE_FIRST(&hg_bulk_sched_peer->queue);
+        size = next_op_id->callback_info.info.bulk.size;
+        if (hg_bulk_op_pool->sched_inflight > 0 &&
+            hg_bulk_op_pool->sched_inflight + size >
+                hg_bulk_op_pool->sched_max_inflight)
+            break;
+
+        HG_QUEUE_POP_HEAD(&hg_bulk_op_pool->sched_queue, entry);
+        HG_QUEUE_POP_HEAD(&hg_bulk_sched_peer->queue, sched);
+        next_op_id->sched_peer = NULL;
+        next_op_id->sched_size = size;
+        hg_bulk_op_pool->sched_inflight += size;
+        HG_QUEUE_PUSH_TAIL(&start_queue, next_op_id, sched);
+
+        if (HG_QUEUE_IS_EMPTY(&hg_bulk_sched_peer->queue)) {
+            (void) hg_hash_table_remove(hg_bulk_op_pool->sched_peers,
+                (hg_hash_table_key_t) hg_bulk_sched_peer->key);
+            free(hg_bulk_sched_peer);
+        } else
+            HG_QUEUE_PUSH_TAIL(
+                &hg_bulk_op_pool->sched_queue, hg_bulk_sched_peer, entry);
+    }
+    hg_thread_spin_unlock(&hg_bulk_op_pool->sched_lock);
+
+    while ((next_op_id = HG_QUEUE_FIRST(&start_queue)) != NULL) {
+        hg_return_t ret;
+
+        HG_QUEUE_POP_HEAD(&start_queue, sched);
+
+        HG_LOG_SUBSYS_DEBUG(
+            bulk, "Starting queued bulk op ID (%p)", (void *) next_op_id);
+
+        ret = hg_bulk_transfer_start_na(next_op_id, next_op_id->origin_addr,
+            next_op_id->origin_id, next_op_id->origin_offset,
+            next_op_id->local_offset);
+        HG_Core_addr_free(next_op_id->origin_addr);
+        next_op_id->origin_addr = NULL;
+
+        /* Caller is no longer there to get the error, complete instead */
+        if (ret != HG_SUCCESS) {
+            HG_LOG_SUBSYS_ERROR(bulk,
+                "Could not start queued bulk op ID (%p)",
+                (void *) next_op_id);
+            hg_bulk_complete(next_op_id, ret, self_notify);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_sched_remove(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool =
+        hg_core_context_get_bulk_op_pool(hg_bulk_op_id->core_context);
+    struct hg_bulk_sched_peer *hg_bulk_sched_peer;
+
+    if (hg_bulk_op_pool == NULL || hg_bulk_op_pool->sched_max_inflight == 0)
+        return HG_FALSE;
+
+    hg_thread_spin_lock(&hg_bulk_op_pool->sched_lock);
+    hg_bulk_sched_peer = hg_bulk_op_id->sched_peer;
+    if (hg_bulk_sched_peer == NULL) {
+        hg_thread_spin_unlock(&hg_bulk_op_pool->sched_lock);
+        return HG_FALSE;
+    }
+
+    HG_QUEUE_REMOVE(
+        &hg_bulk_sched_peer->queue, hg_bulk_op_id, hg_bulk_op_id, sched);
+    hg_bulk_op_id->sched_peer = NULL;
+    if (HG_QUEUE_IS_EMPTY(&hg_bulk_sched_peer->queue)) {
+        HG_QUEUE_REMOVE(&hg_bulk_op_pool->sched_queue, hg_bulk_sched_peer,
+            hg_bulk_sched_peer, entry);
+        (void) hg_hash_table_remove(hg_bulk_op_pool->sched_peers,
+            (hg_hash_table_key_t) hg_bulk_sched_peer->key);
+        free(hg_bulk_sched_peer);
+    }
+    hg_thread_spin_unlock(&hg_bulk_op_pool->sched_lock);
+
+    HG_Core_addr_free(hg_bulk_op_id->origin_addr);
+    hg_bulk_op_id->origin_addr = NULL;
+
+    return HG_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
+    const struct hg_bulk_transfer_opt *opt, hg_bulk_op_t op,
+    struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
+    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
+    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
+    struct hg_bulk_op_id *hg_bulk_parent_op_id, hg_op_id_t *op_id)
+{
+    const struct hg_bulk_segment *origin_segments =
+        HG_BULK_SEGMENTS(hg_bulk_origin);
+    const struct hg_bulk_segment *local_segments =
+        HG_BULK_SEGMENTS(hg_bulk_local);
+    hg_uint32_t origin_count = hg_bulk_origin->desc.info.segment_count,
+                local_count = hg_bulk_local->desc.info.segment_count;
+    uint8_t origin_flags = hg_bulk_origin->desc.info.flags;
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        origin_addr->core_class != core_context->core_class, error, ret,
+        HG_INVALID_ARG,
+        "Context and address passed belong to different classes");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        hg_bulk_origin->core_class != core_context->core_class, error, ret,
+        HG_INVALID_ARG,
+        "Context and origin handle passed belong to different classes");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        hg_bulk_local->core_class != core_context->core_class, error, ret,
+        HG_INVALID_ARG,
+        "Context and local handle passed belong to different classes");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        opt && opt->checksum &&
+            hg_bulk_local->attrs.mem_type != HG_MEM_TYPE_HOST,
+        error, ret, HG_INVALID_ARG,
+        "Checksums can only be computed on host memory");
+
+    /* Get a new OP ID from context */
+    ret = hg_bulk_op_get(core_context, &hg_bulk_op_id);
+    HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not get bulk op ID");
+
+    hg_bulk_op_id->callback = callback;
+    hg_bulk_op_id->callback_info.arg = arg;
+    hg_bulk_op_id->chunk_callback = opt ? opt->chunk_callback : NULL;
+    hg_bulk_op_id->chunk_arg = opt ? opt->chunk_arg : NULL;
+    hg_bulk_op_id->stats = opt ? opt->stats : NULL;
+    hg_bulk_op_id->timeout = (opt && opt->timeout_ms > 0);
+    hg_bulk_op_id->checksum = (opt && opt->checksum);
+    hg_bulk_op_id->parent = hg_bulk_parent_op_id;
+    hg_bulk_op_id->callback_info.info.bulk.origin_handle = hg_bulk_origin;
+    hg_atomic_incr32(&hg_bulk_origin->ref_count);
+    hg_bulk_op_id->callback_info.info.bulk.local_handle = hg_bulk_local;
+    hg_atomic_incr32(&hg_bulk_local->ref_count);
+    hg_bulk_op_id->callback_info.info.bulk.op = op;
+    hg_bulk_op_id->callback_info.info.bulk.size = size;
+    hg_bulk_op_id->callback_info.info.bulk.checksum = 0;
+
+    /* Reset status */
+    hg_atomic_set32(&hg_bulk_op_id->status, 0);
+    hg_atomic_set32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS);
+
+    /* Expected op count */
+    hg_bulk_op_id->op_count = (size > 0) ? 1 : 0; /* Default */
+    hg_bulk_op_id->na_op_id_count = hg_bulk_op_id->op_count;
+    hg_bulk_op_id->rail_op_count = 0;
+    hg_atomic_set32(&hg_bulk_op_id->op_completed_count, 0);
+    hg_bulk_op_id->sched_size = 0;
+    hg_bulk_op_id->sched_peer = NULL;
+
+    if (hg_bulk_op_id->stats || hg_bulk_op_id->timeout)
+        hg_time_get_current(&hg_bulk_op_id->start);
+
+    /* Operations are canceled from progress once their deadline is reached,
+     * add them before issuing any operation as they may complete right away */
+    if (hg_bulk_op_id->timeout) {
+        struct hg_bulk_op_pool *hg_bulk_op_pool =
+            hg_core_context_get_bulk_op_pool(core_context);
+
+        hg_bulk_op_id->deadline = hg_time_add(
+            hg_bulk_op_id->start, hg_time_from_ms(opt->timeout_ms));
+
+        hg_thread_spin_lock(&hg_bulk_op_pool->expiry_list_lock);
+        HG_LIST_INSERT_HEAD(
+            &hg_bulk_op_pool->expiry_list, hg_bulk_op_id, expiry);
+        hg_bulk_op_id->expiring = HG_TRUE;
+        hg_atomic_incr32(&hg_bulk_op_pool->expiry_count);
+        hg_thread_spin_unlock(&hg_bulk_op_pool->expiry_list_lock);
+    }
+
+    /* Count transfer with peer, eager transfers included */
+    if (size > 0 && !HG_Core_addr_is_self(origin_addr))
+        hg_core_peer_stats_bulk(core_context, origin_addr, size);
+
+    if (size == 0) {
+        /* Complete immediately */
+        hg_bulk_complete(hg_bulk_op_id, HG_SUCCESS, HG_TRUE);
+    } else if ((HG_Core_addr_is_self(origin_addr) &&
+                   hg_bulk_self_is_host(hg_bulk_origin, hg_bulk_local)) ||
+               ((origin_flags & HG_BULK_EAGER) && (op != HG_BULK_PUSH))) {
+        hg_bulk_op_id->na_class = NULL;
+        hg_bulk_op_id->na_context = NULL;
+
+        /* When doing eager transfers, use self code path to copy data locally
+         * (device memory cannot be memcpy'd, see below) */
+        ret = hg_bulk_transfer_self(op, origin_segments, origin_count,
+            origin_offset, local_segments, local_count, local_offset, size,
+            HG_FALSE, hg_bulk_op_id);
+#ifdef HG_HAS_CUDA
+    } else if (HG_Core_addr_is_self(origin_addr)) {
+        /* Device memory is copied on the device instead of looping back
+         * through NA, nothing to cancel on NA */
+        hg_bulk_op_id->na_class = NULL;
+        hg_bulk_op_id->na_context = NULL;
+        hg_bulk_op_id->na_op_id_count = 0;
+
+        ret = hg_bulk_transfer_self(op, origin_segments, origin_count,
+            origin_offset, local_segments, local_count, local_offset, size,
+            HG_TRUE, hg_bulk_op_id);
+#endif
+    } else if (hg_bulk_sched_admit(
+                   hg_core_context_get_bulk_op_pool(core_context),
+                   hg_bulk_op_id, origin_addr, origin_id, origin_offset,
+                   local_offset)) {
+        ret = hg_bulk_transfer_start_na(hg_bulk_op_id, origin_addr, origin_id,
+            origin_offset, local_offset);
+    }
+
+    /* Assign op_id */
+    if (op_id && op_id != HG_OP_ID_IGNORE)
+        *op_id = (hg_op_id_t) hg_bulk_op_id;
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_bulk_op_id) {
+        hg_bulk_expiry_remove(hg_bulk_op_id);
+        hg_bulk_op_destroy(hg_bulk_op_id);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_start_na(struct hg_bulk_op_id *hg_bulk_op_id,
+    struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
+    hg_size_t origin_offset, hg_size_t local_offset)
+{
+    hg_core_context_t *core_context = hg_bulk_op_id->core_context;
+    struct hg_bulk *hg_bulk_origin =
+        (struct hg_bulk *) hg_bulk_op_id->callback_info.info.bulk.origin_handle;
+    struct hg_bulk *hg_bulk_local =
+        (struct hg_bulk *) hg_bulk_op_id->callback_info.info.bulk.local_handle;
+    hg_bulk_op_t op = hg_bulk_op_id->callback_info.info.bulk.op;
+    hg_size_t size = hg_bulk_op_id->callback_info.info.bulk.size;
+    const struct hg_bulk_segment *origin_segments =
+        HG_BULK_SEGMENTS(hg_bulk_origin);
+    const struct hg_bulk_segment *local_segments =
+        HG_BULK_SEGMENTS(hg_bulk_local);
+    hg_uint32_t origin_count = hg_bulk_origin->desc.info.segment_count,
+                local_count = hg_bulk_local->desc.info.segment_count;
+    uint8_t origin_flags = hg_bulk_origin->desc.info.flags;
+    uint8_t local_flags = hg_bulk_local->desc.info.flags;
+    struct hg_bulk_na_mem_desc *origin_mem_descs, *local_mem_descs;
+    na_mem_handle_t **origin_mem_handles, **local_mem_handles;
+    na_addr_t *na_origin_addr = NULL;
+    hg_uint8_t rail_mask;
+    hg_return_t ret;
+
+#ifdef NA_HAS_SM
+    /* Use SM if we can */
+    if (hg_bulk_origin->desc.info.flags & HG_BULK_SM) {
+        HG_LOG_SUBSYS_DEBUG(bulk, "Using NA SM class for this transfer");
+
+        hg_bulk_op_id->na_class = hg_bulk_origin->na_sm_class;
+        hg_bulk_op_id->na_context = HG_Core_context_get_na_sm(core_context);
+        na_origin_addr = HG_Core_addr_get_na_sm(origin_addr);
+        origin_mem_descs = &hg_bulk_origin->na_sm_mem_descs;
+        local_mem_descs = &hg_bulk_local->na_sm_mem_descs;
+    } else {
+#endif
+        HG_LOG_SUBSYS_DEBUG(
+            bulk, "Using default NA class for this transfer");
+
+        hg_bulk_op_id->na_class = hg_bulk_origin->na_class;
+        hg_bulk_op_id->na_context = HG_Core_context_get_na(core_context);
+        na_origin_addr = HG_Core_addr_get_na(origin_addr);
+        origin_mem_descs = &hg_bulk_origin->na_mem_descs;
+        local_mem_descs = &hg_bulk_local->na_mem_descs;
+#ifdef NA_HAS_SM
+    }
+#endif
+
+    /* Register lazily registered handles now that a remote peer is
+     * involved, pipeline registers chunks of file-backed local handles */
+    if (hg_bulk_origin->lazy) {
+        ret = hg_bulk_register_deferred_all(hg_bulk_origin, origin_flags);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not register origin segments");
+        origin_flags = hg_bulk_origin->desc.info.flags;
+    }
+    if (hg_bulk_local->lazy && !hg_bulk_local->attrs.file_backed) {
+        ret = hg_bulk_register_deferred_all(hg_bulk_local, origin_flags);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not register local segments");
+        local_flags = hg_bulk_local->desc.info.flags;
+    }
+
+    origin_mem_handles =
+        HG_BULK_MEM_HANDLES(origin_mem_descs, origin_count, origin_flags);
+    local_mem_handles =
+        HG_BULK_MEM_HANDLES(local_mem_descs, local_count, local_flags);
+
+    /* Split large transfers across additional rails if any */
+    rail_mask = hg_bulk_transfer_rail_mask(
+        hg_bulk_origin, hg_bulk_local, size, hg_bulk_op_id);
+    if (rail_mask != 1)
+        ret = hg_bulk_transfer_rails(op, na_origin_addr, origin_id,
+            hg_bulk_origin, origin_offset, hg_bulk_local, local_offset,
+            size, rail_mask, hg_bulk_op_id);
+    else
+        ret = hg_bulk_transfer_na(op, na_origin_addr, origin_id,
+            origin_segments, origin_count, origin_mem_handles,
+            origin_flags, origin_offset, local_segments, local_count,
+            local_mem_handles, local_flags, local_offset, size,
+            hg_bulk_op_id);
+
+    return ret;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_list(hg_core_context_t *core_context, hg_cb_t callback,
+    void *arg, hg_bulk_op_t op, struct hg_bulk *hg_bulk_local,
+    const struct hg_bulk_transfer_entry *entries, hg_uint32_t count,
+    hg_op_id_t *op_id)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id = NULL;
+    hg_size_t size = 0;
+    hg_uint32_t i;
+    hg_return_t ret;
+
+    ret = hg_bulk_op_get(core_context, &hg_bulk_op_id);
+    HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not get bulk op ID");
+
+    if (count > 0) {
+        hg_bulk_op_id->children = (struct hg_bulk_op_id **) malloc(
+            count * sizeof(*hg_bulk_op_id->children));
+        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_id->children == NULL, error,
+            ret, HG_NOMEM, "Could not allocate array of %" PRIu32 " op IDs",
+            count);
+    }
+    for (i = 0; i < count; i++)
+        size += entries[i].size;
+
+    hg_bulk_op_id->callback = callback;
+    hg_bulk_op_id->callback_info.arg = arg;
+    hg_bulk_op_id->chunk_callback = NULL;
+    hg_bulk_op_id->chunk_arg = NULL;
+    hg_bulk_op_id->stats = NULL;
+    hg_bulk_op_id->timeout = HG_FALSE;
+    hg_bulk_op_id->checksum = HG_FALSE;
+    hg_bulk_op_id->parent = NULL;
+    hg_bulk_op_id->na_class = NULL;
+    hg_bulk_op_id->na_context = NULL;
+    hg_bulk_op_id->callback_info.info.bulk.origin_handle = HG_BULK_NULL;
+    hg_bulk_op_id->callback_info.info.bulk.local_handle = hg_bulk_local;
+    hg_atomic_incr32(&hg_bulk_local->ref_count);
+    hg_bulk_op_id->callback_info.info.bulk.op = op;
+    hg_bulk_op_id->callback_info.info.bulk.size = size;
+
+    /* Reset status */
+    hg_atomic_set32(&hg_bulk_op_id->status, 0);
+    hg_atomic_set32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS);
+
+    /* One operation per transfer of the list, NA operations are tracked by
+     * each transfer */
+    hg_bulk_op_id->op_count = count;
+    hg_bulk_op_id->na_op_id_count = 0;
+    hg_bulk_op_id->rail_op_count = 0;
+    hg_bulk_op_id->child_count = 0;
+    hg_atomic_set32(&hg_bulk_op_id->op_completed_count, 0);
+
+    /* Keep op ID until all transfers are issued since it may complete and be
+     * released as soon as the last one is */
+    hg_atomic_incr32(&hg_bulk_op_id->ref_count);
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Transferring %" PRIu64 " bytes from list of %" PRIu32 " region(s)",
+        size, count);
+
+    if (count == 0)
+        hg_bulk_complete(hg_bulk_op_id, HG_SUCCESS, HG_TRUE);
+
+    for (i = 0; i < count; i++) {
+        struct hg_bulk *hg_bulk_origin =
+            (struct hg_bulk *) entries[i].origin_handle;
+        hg_op_id_t child_op_id = HG_OP_ID_NULL;
+
+        /* Use address embedded into origin handle if any */
+        if (hg_bulk_origin->addr != HG_CORE_ADDR_NULL)
+            ret = hg_bulk_transfer(core_context, NULL, NULL, NULL, op,
+                hg_bulk_origin->addr, hg_bulk_origin->context_id,
+                hg_bulk_origin, entries[i].origin_offset, hg_bulk_local,
+                entries[i].local_offset, entries[i].size, hg_bulk_op_id,
+                &child_op_id);
+        else
+            ret = hg_bulk_transfer(core_context, NULL, NULL, NULL, op,
+                (hg_core_addr_t) entries[i].origin_addr, entries[i].origin_id,
+                hg_bulk_origin, entries[i].origin_offset, hg_bulk_local,
+                entries[i].local_offset, entries[i].size, hg_bulk_op_id,
+                &child_op_id);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_SUBSYS_ERROR(
+                bulk, "Could not start transfer %" PRIu32 " of list", i);
+
+            /* Transfers already issued must still complete, report error
+             * through the list callback */
+            for (; i < count; i++)
+                hg_bulk_list_complete_one(hg_bulk_op_id, ret, HG_TRUE);
+            break;
+        }
+        hg_bulk_op_id->children[hg_bulk_op_id->child_count++] =
+            (struct hg_bulk_op_id *) child_op_id;
+    }
+
+    /* Assign op_id */
+    if (op_id && op_id != HG_OP_ID_IGNORE)
+        *op_id = (hg_op_id_t) hg_bulk_op_id;
 
-    *hg_bulk_op_id_p = hg_bulk_op_id;
+    hg_bulk_op_destroy(hg_bulk_op_id);
 
     return HG_SUCCESS;
 
 error:
-    hg_thread_mutex_lock(&hg_bulk_op_pool->extend_mutex);
-    hg_bulk_op_pool->extending = HG_FALSE;
-    hg_thread_cond_broadcast(&hg_bulk_op_pool->extend_cond);
-    hg_thread_mutex_unlock(&hg_bulk_op_pool->extend_mutex);
+    if (hg_bulk_op_id) {
+        free(hg_bulk_op_id->children);
+        hg_bulk_op_id->children = NULL;
+        hg_bulk_op_destroy(hg_bulk_op_id);
+    }
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
-    hg_bulk_op_t op, struct hg_core_addr *origin_addr, hg_uint8_t origin_id,
-    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
-    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
+hg_bulk_atomic(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
+    hg_bulk_atomic_op_t op, struct hg_core_addr *origin_addr,
+    hg_uint8_t origin_id, struct hg_bulk *hg_bulk_origin,
+    hg_size_t origin_offset, hg_uint64_t operand, hg_uint64_t compare,
     hg_op_id_t *op_id)
 {
     const struct hg_bulk_segment *origin_segments =
         HG_BULK_SEGMENTS(hg_bulk_origin);
-    const struct hg_bulk_segment *local_segments =
-        HG_BULK_SEGMENTS(hg_bulk_local);
-    hg_uint32_t origin_count = hg_bulk_origin->desc.info.segment_count,
-                local_count = hg_bulk_local->desc.info.segment_count;
-    uint8_t origin_flags = hg_bulk_origin->desc.info.flags;
-    uint8_t local_flags = hg_bulk_local->desc.info.flags;
+    hg_uint32_t origin_count = hg_bulk_origin->desc.info.segment_count;
+    struct hg_bulk_na_mem_desc *origin_mem_descs;
+    na_mem_handle_t **origin_mem_handles;
+    hg_bulk_na_op_id_t *hg_bulk_na_op_ids;
     struct hg_bulk_op_id *hg_bulk_op_id = NULL;
-    struct hg_bulk_op_pool *hg_bulk_op_pool =
-        hg_core_context_get_bulk_op_pool(core_context);
+    na_addr_t *na_origin_addr;
+    hg_uint32_t segment_index = 0;
+    hg_size_t segment_offset = origin_offset;
+    hg_uint8_t origin_flags;
+    na_return_t na_ret;
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(bulk,
@@ -1940,90 +4952,88 @@ hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
         hg_bulk_origin->core_class != core_context->core_class, error, ret,
         HG_INVALID_ARG,
         "Context and origin handle passed belong to different classes");
-    HG_CHECK_SUBSYS_ERROR(bulk,
-        hg_bulk_local->core_class != core_context->core_class, error, ret,
-        HG_INVALID_ARG,
-        "Context and local handle passed belong to different classes");
 
-    /* Get a new OP ID from context */
-    if (hg_bulk_op_pool) {
-        ret = hg_bulk_op_pool_get(hg_bulk_op_pool, &hg_bulk_op_id);
-        HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not get bulk op ID");
-    } else {
-        ret = hg_bulk_op_create(core_context, &hg_bulk_op_id);
+    /* Register lazily registered handles now that a remote peer is
+     * involved */
+    if (hg_bulk_origin->lazy) {
+        ret = hg_bulk_register_deferred_all(
+            hg_bulk_origin, hg_bulk_origin->desc.info.flags);
         HG_CHECK_SUBSYS_HG_ERROR(
-            bulk, error, ret, "Could not create bulk op ID");
+            bulk, error, ret, "Could not register origin segments");
     }
+    origin_flags = hg_bulk_origin->desc.info.flags;
+
+    /* Get a new OP ID from context */
+    ret = hg_bulk_op_get(core_context, &hg_bulk_op_id);
+    HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not get bulk op ID");
 
     hg_bulk_op_id->callback = callback;
     hg_bulk_op_id->callback_info.arg = arg;
+    hg_bulk_op_id->chunk_callback = NULL;
+    hg_bulk_op_id->chunk_arg = NULL;
+    hg_bulk_op_id->stats = NULL;
+    hg_bulk_op_id->timeout = HG_FALSE;
+    hg_bulk_op_id->checksum = HG_FALSE;
+    hg_bulk_op_id->parent = NULL;
     hg_bulk_op_id->callback_info.info.bulk.origin_handle = hg_bulk_origin;
     hg_atomic_incr32(&hg_bulk_origin->ref_count);
-    hg_bulk_op_id->callback_info.info.bulk.local_handle = hg_bulk_local;
-    hg_atomic_incr32(&hg_bulk_local->ref_count);
-    hg_bulk_op_id->callback_info.info.bulk.op = op;
-    hg_bulk_op_id->callback_info.info.bulk.size = size;
+    hg_bulk_op_id->callback_info.info.bulk.local_handle = HG_BULK_NULL;
+    hg_bulk_op_id->callback_info.info.bulk.op = HG_BULK_PUSH;
+    hg_bulk_op_id->callback_info.info.bulk.size = sizeof(hg_uint64_t);
+    hg_bulk_op_id->callback_info.info.bulk.result = 0;
 
     /* Reset status */
     hg_atomic_set32(&hg_bulk_op_id->status, 0);
     hg_atomic_set32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS);
 
-    /* Expected op count */
-    hg_bulk_op_id->op_count = (size > 0) ? 1 : 0; /* Default */
+    /* Single NA operation */
+    hg_bulk_op_id->op_count = 1;
+    hg_bulk_op_id->na_op_id_count = 1;
+    hg_bulk_op_id->rail_op_count = 0;
     hg_atomic_set32(&hg_bulk_op_id->op_completed_count, 0);
-
-    if (size == 0) {
-        /* Complete immediately */
-        hg_bulk_complete(hg_bulk_op_id, HG_SUCCESS, HG_TRUE);
-    } else if (HG_Core_addr_is_self(origin_addr) ||
-               ((origin_flags & HG_BULK_EAGER) && (op != HG_BULK_PUSH))) {
-        hg_bulk_op_id->na_class = NULL;
-        hg_bulk_op_id->na_context = NULL;
-
-        /* When doing eager transfers, use self code path to copy data locally
-         */
-        ret = hg_bulk_transfer_self(op, origin_segments, origin_count,
-            origin_offset, local_segments, local_count, local_offset, size,
-            hg_bulk_op_id);
-    } else {
-        struct hg_bulk_na_mem_desc *origin_mem_descs, *local_mem_descs;
-        na_mem_handle_t **origin_mem_handles, **local_mem_handles;
-        na_addr_t *na_origin_addr = NULL;
+    hg_bulk_op_id->sched_size = 0;
+    hg_bulk_op_id->sched_peer = NULL;
 
 #ifdef NA_HAS_SM
-        /* Use SM if we can */
-        if (hg_bulk_origin->desc.info.flags & HG_BULK_SM) {
-            HG_LOG_SUBSYS_DEBUG(bulk, "Using NA SM class for this transfer");
-
-            hg_bulk_op_id->na_class = hg_bulk_origin->na_sm_class;
-            hg_bulk_op_id->na_context = HG_Core_context_get_na_sm(core_context);
-            na_origin_addr = HG_Core_addr_get_na_sm(origin_addr);
-            origin_mem_descs = &hg_bulk_origin->na_sm_mem_descs;
-            local_mem_descs = &hg_bulk_local->na_sm_mem_descs;
-        } else {
+    /* Use SM if we can */
+    if (origin_flags & HG_BULK_SM) {
+        hg_bulk_op_id->na_class = hg_bulk_origin->na_sm_class;
+        hg_bulk_op_id->na_context = HG_Core_context_get_na_sm(core_context);
+        na_origin_addr = HG_Core_addr_get_na_sm(origin_addr);
+        origin_mem_descs = &hg_bulk_origin->na_sm_mem_descs;
+        hg_bulk_na_op_ids = &hg_bulk_op_id->na_sm_op_ids;
+    } else {
 #endif
-            HG_LOG_SUBSYS_DEBUG(
-                bulk, "Using default NA class for this transfer");
-
-            hg_bulk_op_id->na_class = hg_bulk_origin->na_class;
-            hg_bulk_op_id->na_context = HG_Core_context_get_na(core_context);
-            na_origin_addr = HG_Core_addr_get_na(origin_addr);
-            origin_mem_descs = &hg_bulk_origin->na_mem_descs;
-            local_mem_descs = &hg_bulk_local->na_mem_descs;
+        hg_bulk_op_id->na_class = hg_bulk_origin->na_class;
+        hg_bulk_op_id->na_context = HG_Core_context_get_na(core_context);
+        na_origin_addr = HG_Core_addr_get_na(origin_addr);
+        origin_mem_descs = &hg_bulk_origin->na_mem_descs;
+        hg_bulk_na_op_ids = &hg_bulk_op_id->na_op_ids;
 #ifdef NA_HAS_SM
-        }
+    }
 #endif
+    origin_mem_handles =
+        HG_BULK_MEM_HANDLES(origin_mem_descs, origin_count, origin_flags);
 
-        origin_mem_handles =
-            HG_BULK_MEM_HANDLES(origin_mem_descs, origin_count, origin_flags);
-        local_mem_handles =
-            HG_BULK_MEM_HANDLES(local_mem_descs, local_count, local_flags);
+    /* Handles registered per segment are addressed from their segment */
+    if (!(origin_flags & HG_BULK_REGV) && origin_count > 1)
+        hg_bulk_offset_translate(origin_segments, origin_count, origin_offset,
+            &segment_index, &segment_offset);
 
-        ret = hg_bulk_transfer_na(op, na_origin_addr, origin_id,
-            origin_segments, origin_count, origin_mem_handles, origin_flags,
-            origin_offset, local_segments, local_count, local_mem_handles,
-            local_flags, local_offset, size, hg_bulk_op_id);
-    }
+    if (op == HG_BULK_ATOMIC_FETCH_ADD)
+        na_ret = NA_Atomic_fetch_add(hg_bulk_op_id->na_class,
+            hg_bulk_op_id->na_context, hg_bulk_atomic_cb, hg_bulk_op_id,
+            operand, origin_mem_handles[segment_index], segment_offset,
+            na_origin_addr, origin_id, hg_bulk_na_op_ids->s[0]);
+    else
+        na_ret = NA_Atomic_cas(hg_bulk_op_id->na_class,
+            hg_bulk_op_id->na_context, hg_bulk_atomic_cb, hg_bulk_op_id,
+            operand, compare, origin_mem_handles[segment_index],
+            segment_offset, na_origin_addr, origin_id,
+            hg_bulk_na_op_ids->s[0]);
+    HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, release, ret,
+        (hg_return_t) na_ret, "Could not post atomic operation (%s)",
+        NA_Error_to_string(na_ret));
 
     /* Assign op_id */
     if (op_id && op_id != HG_OP_ID_IGNORE)
@@ -2031,20 +5041,51 @@ hg_bulk_transfer(hg_core_context_t *core_context, hg_cb_t callback, void *arg,
 
     return HG_SUCCESS;
 
-error:
-    if (hg_bulk_op_id)
-        hg_bulk_op_destroy(hg_bulk_op_id);
+release:
+    (void) hg_bulk_free(hg_bulk_origin);
+    hg_bulk_op_destroy(hg_bulk_op_id);
 
+error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_self_is_host(
+    const struct hg_bulk *hg_bulk_origin, const struct hg_bulk *hg_bulk_local)
+{
+    if (hg_bulk_local->attrs.mem_type != HG_MEM_TYPE_HOST ||
+        hg_bulk_origin->attrs.mem_type != HG_MEM_TYPE_HOST)
+        return HG_FALSE;
+
+#ifdef HG_HAS_CUDA
+    /* Origin memory belongs to this process, it can only be on device if a
+     * device handle was created */
+    if (hg_atomic_get32(&hg_bulk_device_count_g) > 0 &&
+        hg_bulk_origin->desc.info.segment_count > 0) {
+        const struct hg_bulk_segment *origin_segments =
+            HG_BULK_SEGMENTS(hg_bulk_origin);
+        struct cudaPointerAttributes attributes;
+
+        if (cudaPointerGetAttributes(&attributes,
+                (const void *) origin_segments[0].base) == cudaSuccess)
+            return (attributes.type != cudaMemoryTypeDevice);
+
+        /* Clear error left by non-CUDA pointers */
+        (void) cudaGetLastError();
+    }
+#endif
+
+    return HG_TRUE;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_transfer_self(hg_bulk_op_t op,
     const struct hg_bulk_segment *origin_segments, hg_uint32_t origin_count,
     hg_size_t origin_offset, const struct hg_bulk_segment *local_segments,
     hg_uint32_t local_count, hg_size_t local_offset, hg_size_t size,
-    struct hg_bulk_op_id *hg_bulk_op_id)
+    hg_bool_t device, struct hg_bulk_op_id *hg_bulk_op_id)
 {
     hg_uint32_t origin_segment_start_index = 0, local_segment_start_index = 0;
     hg_size_t origin_segment_start_offset = 0, local_segment_start_offset = 0;
@@ -2054,16 +5095,25 @@ hg_bulk_transfer_self(hg_bulk_op_t op,
     switch (op) {
         case HG_BULK_PUSH:
             copy_op = hg_bulk_memcpy_put;
+#ifdef HG_HAS_CUDA
+            if (device)
+                copy_op = hg_bulk_cuda_memcpy_put;
+#endif
             break;
         case HG_BULK_PULL:
             copy_op = hg_bulk_memcpy_get;
+#ifdef HG_HAS_CUDA
+            if (device)
+                copy_op = hg_bulk_cuda_memcpy_get;
+#endif
             break;
         default:
             HG_GOTO_SUBSYS_ERROR(
                 bulk, error, ret, HG_INVALID_ARG, "Unknown bulk operation");
     }
 
-    HG_LOG_SUBSYS_DEBUG(bulk, "Transferring data through self");
+    HG_LOG_SUBSYS_DEBUG(bulk, "Transferring data through self (device=%d)",
+        (int) device);
 
     /* Translate origin offset */
     if (origin_offset > 0)
@@ -2081,6 +5131,28 @@ hg_bulk_transfer_self(hg_bulk_op_t op,
         local_count, local_segment_start_index, local_segment_start_offset,
         size);
 
+#ifdef HG_HAS_CUDA
+    /* Device copies complete from progress */
+    if (device) {
+        hg_bulk_op_id->local_offset = local_offset;
+        ret = hg_bulk_transfer_self_cuda(hg_bulk_op_id);
+        if (ret != HG_SUCCESS)
+            hg_bulk_transfer_self_cuda_complete(hg_bulk_op_id, ret);
+        return HG_SUCCESS;
+    }
+#else
+    (void) device;
+#endif
+
+    /* Data was just copied, checksum it while it is in cache */
+    if (hg_bulk_op_id->checksum)
+        hg_bulk_op_id->callback_info.info.bulk.checksum = hg_bulk_checksum(
+            local_segments, local_count, local_offset, size);
+
+    /* Entire range is available at once */
+    if (hg_bulk_op_id->chunk_callback)
+        hg_bulk_op_id->chunk_callback(hg_bulk_op_id->chunk_arg, 0, size);
+
     /* Complete immediately */
     hg_bulk_complete(hg_bulk_op_id, HG_SUCCESS, HG_TRUE);
 
@@ -2090,6 +5162,101 @@ error:
     return ret;
 }
 
+#ifdef HG_HAS_CUDA
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_self_cuda(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool =
+        hg_core_context_get_bulk_op_pool(hg_bulk_op_id->core_context);
+    cudaError_t cuda_rc;
+    hg_return_t ret;
+
+    /* Copies were issued asynchronously, launch errors are sticky */
+    cuda_rc = cudaGetLastError();
+    HG_CHECK_SUBSYS_ERROR(bulk, cuda_rc != cudaSuccess, error, ret,
+        HG_PROTOCOL_ERROR, "cudaMemcpyAsync() failed (%s)",
+        cudaGetErrorString(cuda_rc));
+
+    /* Events are kept with op IDs for re-use */
+    if (hg_bulk_op_id->cuda_event == NULL) {
+        cuda_rc = cudaEventCreateWithFlags(
+            &hg_bulk_op_id->cuda_event, cudaEventDisableTiming);
+        HG_CHECK_SUBSYS_ERROR(bulk, cuda_rc != cudaSuccess, error, ret,
+            HG_NOMEM, "cudaEventCreateWithFlags() failed (%s)",
+            cudaGetErrorString(cuda_rc));
+    }
+
+    cuda_rc = cudaEventRecord(hg_bulk_op_id->cuda_event, cudaStreamPerThread);
+    HG_CHECK_SUBSYS_ERROR(bulk, cuda_rc != cudaSuccess, error, ret,
+        HG_PROTOCOL_ERROR, "cudaEventRecord() failed (%s)",
+        cudaGetErrorString(cuda_rc));
+
+    hg_thread_spin_lock(&hg_bulk_op_pool->device_list_lock);
+    HG_LIST_INSERT_HEAD(&hg_bulk_op_pool->device_list, hg_bulk_op_id, device);
+    hg_atomic_incr32(&hg_bulk_op_pool->device_count);
+    hg_thread_spin_unlock(&hg_bulk_op_pool->device_list_lock);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_transfer_self_cuda_complete(
+    struct hg_bulk_op_id *hg_bulk_op_id, hg_return_t ret)
+{
+    /* Copies cannot be interrupted, cancellation only affects the status */
+    if (ret == HG_SUCCESS &&
+        (hg_atomic_get32(&hg_bulk_op_id->status) & HG_BULK_OP_CANCELED))
+        ret = HG_CANCELED;
+
+    if (ret == HG_SUCCESS) {
+        const struct hg_cb_info_bulk *bulk_info =
+            &hg_bulk_op_id->callback_info.info.bulk;
+        struct hg_bulk *hg_bulk_local =
+            (struct hg_bulk *) bulk_info->local_handle;
+        hg_size_t size = bulk_info->size;
+
+        /* Local memory is on host if a checksum was requested */
+        if (hg_bulk_op_id->checksum)
+            hg_bulk_op_id->callback_info.info.bulk.checksum =
+                hg_bulk_checksum(HG_BULK_SEGMENTS(hg_bulk_local),
+                    hg_bulk_local->desc.info.segment_count,
+                    hg_bulk_op_id->local_offset, size);
+
+        if (hg_bulk_op_id->chunk_callback)
+            hg_bulk_op_id->chunk_callback(hg_bulk_op_id->chunk_arg, 0, size);
+    }
+
+    hg_bulk_complete(hg_bulk_op_id, ret, HG_TRUE);
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_uint32_t
+hg_bulk_checksum(const struct hg_bulk_segment *segments, hg_uint32_t count,
+    hg_size_t offset, hg_size_t size)
+{
+    hg_uint32_t crc = 0, i = 0;
+    hg_size_t segment_offset = 0;
+
+    hg_bulk_offset_translate(segments, count, offset, &i, &segment_offset);
+
+    for (; i < count && size > 0; i++) {
+        hg_size_t len = HG_BULK_MIN(segments[i].len - segment_offset, size);
+
+        crc = hg_crc32c(crc, (const void *) (segments[i].base + segment_offset),
+            (size_t) len);
+        size -= len;
+        segment_offset = 0;
+    }
+
+    return crc;
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_bulk_transfer_segments_self(hg_bulk_copy_op_t copy_op,
@@ -2155,6 +5322,9 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t *na_origin_addr,
 {
     hg_bulk_na_op_id_t *hg_bulk_na_op_ids;
     na_bulk_op_t na_bulk_op;
+    hg_size_t chunk_size;
+    hg_uint32_t max_inflight;
+    hg_bool_t pipeline;
     hg_return_t ret;
 
     /* Map op to NA op */
@@ -2178,8 +5348,26 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t *na_origin_addr,
 #endif
         hg_bulk_na_op_ids = &hg_bulk_op_id->na_op_ids;
 
-    if (((origin_flags & HG_BULK_REGV) || origin_count == 1) &&
-        ((local_flags & HG_BULK_REGV) || local_count == 1)) {
+    /* Pipeline transfer if chunks must be reported or operations split (or
+     * if partial completion must be reported or chunks checksummed) */
+    hg_core_class_get_bulk_pipeline_info(
+        hg_bulk_op_id->core_context->core_class, &chunk_size, &max_inflight);
+    pipeline = (hg_bulk_op_id->chunk_callback != NULL) ||
+               (hg_bulk_op_id->stats != NULL) || hg_bulk_op_id->checksum ||
+               (chunk_size > 0 && size > chunk_size) ||
+               hg_bulk_op_id->callback_info.info.bulk.local_handle->attrs
+                   .file_backed;
+
+    if (pipeline) {
+        ret = hg_bulk_transfer_pipeline_na(na_bulk_op, na_origin_addr,
+            origin_id, origin_segments, origin_count, origin_mem_handles,
+            origin_flags, origin_offset, local_segments, local_count,
+            local_mem_handles, local_flags, local_offset, size, chunk_size,
+            max_inflight, hg_bulk_na_op_ids, hg_bulk_op_id);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not start pipelined transfer");
+    } else if (((origin_flags & HG_BULK_REGV) || origin_count == 1) &&
+               ((local_flags & HG_BULK_REGV) || local_count == 1)) {
         na_return_t na_ret;
 
         HG_LOG_SUBSYS_DEBUG(
@@ -2193,12 +5381,27 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t *na_origin_addr,
             (hg_return_t) na_ret, "Could not transfer data (%s)",
             NA_Error_to_string(na_ret));
     } else {
+        struct hg_bulk_segment origin_segment = {0, 0},
+                               local_segment = {0, 0};
         hg_uint32_t origin_segment_start_index = 0,
                     local_segment_start_index = 0;
         hg_size_t origin_segment_start_offset = 0,
                   local_segment_start_offset = 0;
         na_op_id_t **na_op_ids;
 
+        /* Memory registered through a single NA handle is contiguous, only
+         * split operations at boundaries of the other side's segments */
+        if ((origin_flags & HG_BULK_REGV) || origin_count == 1) {
+            origin_segment.len = origin_offset + size;
+            origin_segments = &origin_segment;
+            origin_count = 1;
+        }
+        if ((local_flags & HG_BULK_REGV) || local_count == 1) {
+            local_segment.len = local_offset + size;
+            local_segments = &local_segment;
+            local_count = 1;
+        }
+
         /* Translate bulk_offset */
         if (origin_offset > 0)
             hg_bulk_offset_translate(origin_segments, origin_count,
@@ -2214,35 +5417,64 @@ hg_bulk_transfer_na(hg_bulk_op_t op, na_addr_t *na_origin_addr,
         hg_bulk_op_id->op_count = hg_bulk_transfer_get_op_count(origin_segments,
             origin_count, origin_segment_start_index,
             origin_segment_start_offset, local_segments, local_count,
-            local_segment_start_index, local_segment_start_offset, size);
+            local_segment_start_index, local_segment_start_offset, size, 0);
         HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_op_id->op_count == 0, error, ret,
             HG_INVALID_ARG, "Could not get bulk op_count");
 
+        /* Let the plugin post all segments as one operation if it can, so
+         * that a single completion is generated for the whole transfer */
+        if (hg_bulk_op_id->op_count > 1 &&
+            hg_bulk_op_id->op_count <=
+                NA_Rma_batch_get_max_segments(hg_bulk_op_id->na_class)) {
+            hg_uint32_t segment_count = hg_bulk_op_id->op_count;
+
+            HG_LOG_SUBSYS_DEBUG(bulk,
+                "Transferring data through NA in single batch of %u segments",
+                segment_count);
+
+            hg_bulk_op_id->op_count = 1;
+            hg_bulk_op_id->na_op_id_count = 1;
+            ret = hg_bulk_transfer_batch_na(hg_bulk_op_id->na_class,
+                hg_bulk_op_id->na_context,
+                (op == HG_BULK_PUSH) ? NA_CB_PUT : NA_CB_GET,
+                hg_bulk_transfer_cb, hg_bulk_op_id, na_origin_addr, origin_id,
+                origin_segments, origin_count, origin_mem_handles,
+                origin_segment_start_index, origin_segment_start_offset,
+                local_segments, local_count, local_mem_handles,
+                local_segment_start_index, local_segment_start_offset, size,
+                segment_count, hg_bulk_na_op_ids->s[0]);
+            if (ret == HG_SUCCESS)
+                return HG_SUCCESS;
+
+            /* Segments may span more pieces than the plugin can batch */
+            HG_CHECK_SUBSYS_ERROR(bulk, ret != HG_OVERFLOW, error, ret, ret,
+                "Could not transfer data segments in batch");
+            hg_bulk_op_id->op_count = segment_count;
+        }
+
+        /* Bound number of operations in flight */
+        if (max_inflight > 0 && hg_bulk_op_id->op_count > max_inflight) {
+            ret = hg_bulk_transfer_pipeline_na(na_bulk_op, na_origin_addr,
+                origin_id, origin_segments, origin_count, origin_mem_handles,
+                origin_flags, origin_offset, local_segments, local_count,
+                local_mem_handles, local_flags, local_offset, size, chunk_size,
+                max_inflight, hg_bulk_na_op_ids, hg_bulk_op_id);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                bulk, error, ret, "Could not start pipelined transfer");
+
+            return HG_SUCCESS;
+        }
+        hg_bulk_op_id->na_op_id_count = hg_bulk_op_id->op_count;
+
         HG_LOG_SUBSYS_DEBUG(bulk,
             "Transferring data through NA in %u operation(s)",
             hg_bulk_op_id->op_count);
 
-        /* Create extra operation IDs if the number of operations exceeds
+        /* Use extra operation IDs if the number of operations exceeds
          * the number of pre-allocated op IDs */
-        if (hg_bulk_op_id->op_count > HG_BULK_STATIC_MAX) {
-            unsigned int i;
-
-            /* Allocate memory for NA operation IDs */
-            hg_bulk_na_op_ids->d =
-                malloc(sizeof(na_op_id_t *) * hg_bulk_op_id->op_count);
-            HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_na_op_ids->d == NULL, error,
-                ret, HG_NOMEM, "Could not allocate memory for op_ids");
-
-            for (i = 0; i < hg_bulk_op_id->op_count; i++) {
-                hg_bulk_na_op_ids->d[i] =
-                    NA_Op_create(hg_bulk_op_id->na_class, 0);
-                HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_na_op_ids->d[i] == NULL,
-                    error, ret, HG_NA_ERROR, "Could not create NA op ID");
-            }
-
-            na_op_ids = hg_bulk_na_op_ids->d;
-        } else
-            na_op_ids = hg_bulk_na_op_ids->s;
+        ret = hg_bulk_na_op_ids_get(hg_bulk_na_op_ids, hg_bulk_op_id->na_class,
+            hg_bulk_op_id->op_count, &na_op_ids);
+        HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not get NA op IDs");
 
         /* Do actual transfer */
         ret = hg_bulk_transfer_segments_na(hg_bulk_op_id->na_class,
@@ -2263,6 +5495,188 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_uint8_t
+hg_bulk_transfer_rail_mask(const struct hg_bulk *hg_bulk_origin,
+    const struct hg_bulk *hg_bulk_local, hg_size_t size,
+    const struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    hg_core_context_t *core_context = hg_bulk_op_id->core_context;
+    const struct hg_core_rails *rails =
+        hg_core_class_get_rails(core_context->core_class);
+    const struct hg_bulk_rails *origin_rails = hg_bulk_origin->rails,
+                               *local_rails = hg_bulk_local->rails;
+    hg_size_t chunk_size;
+    hg_uint32_t max_inflight;
+    hg_uint8_t rail_mask = 1, i;
+
+    /* Handles that were not registered with rails, transfers over SM and
+     * transfers that must be pipelined in chunks are not split */
+    if (origin_rails == NULL || local_rails == NULL ||
+        size < rails->min_size ||
+        (hg_bulk_origin->desc.info.flags & HG_BULK_SM) ||
+        hg_bulk_op_id->chunk_callback != NULL || hg_bulk_op_id->checksum)
+        return rail_mask;
+
+    hg_core_class_get_bulk_pipeline_info(
+        core_context->core_class, &chunk_size, &max_inflight);
+    if (chunk_size > 0 && size > chunk_size)
+        return rail_mask;
+
+    for (i = 1; i < origin_rails->count && i < local_rails->count; i++)
+        if (origin_rails->handles[i] != NULL &&
+            origin_rails->addrs[i] != NULL && local_rails->handles[i] != NULL &&
+            hg_core_context_get_na_rail(core_context, i) != NULL)
+            rail_mask |= (hg_uint8_t) (1 << i);
+
+    return rail_mask;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_transfer_rail_split(struct hg_core_rails *rails,
+    hg_uint8_t rail_mask, hg_size_t size, hg_size_t *sizes)
+{
+    int32_t weights[HG_CORE_RAIL_MAX], max_weight = 0;
+    double weight_sum = 0., known_sum = 0.;
+    hg_size_t remaining = size;
+    unsigned int known_count = 0, last = 0, i;
+
+    /* Rails that were not measured yet are assumed to be as fast as the
+     * average of the ones that were */
+    for (i = 0; i < HG_CORE_RAIL_MAX; i++) {
+        weights[i] = 0;
+        if (!(rail_mask & (1 << i)))
+            continue;
+        weights[i] = hg_atomic_get32(&rails->rail[i].bandwidth);
+        if (weights[i] > 0) {
+            known_sum += (double) weights[i];
+            known_count++;
+        }
+        last = i;
+    }
+    for (i = 0; i <= last; i++) {
+        if (!(rail_mask & (1 << i)))
+            continue;
+        if (weights[i] == 0)
+            weights[i] =
+                (known_count > 0) ? (int32_t) (known_sum / known_count) : 1;
+        if (weights[i] > max_weight)
+            max_weight = weights[i];
+    }
+
+    /* Keep sending some data on slow rails so that they are re-measured */
+    for (i = 0; i <= last; i++) {
+        if (!(rail_mask & (1 << i)))
+            continue;
+        if (weights[i] < max_weight / HG_BULK_RAIL_MIN_SHARE)
+            weights[i] = max_weight / HG_BULK_RAIL_MIN_SHARE;
+        weight_sum += (double) weights[i];
+    }
+
+    /* Stripes are aligned, last rail gets what remains */
+    for (i = 0; i <= last; i++) {
+        sizes[i] = 0;
+        if (!(rail_mask & (1 << i)))
+            continue;
+        if (i < last) {
+            sizes[i] = (hg_size_t) ((double) size * weights[i] / weight_sum) &
+                       ~((hg_size_t) HG_BULK_RAIL_ALIGN - 1);
+            sizes[i] = HG_BULK_MIN(sizes[i], remaining);
+        } else
+            sizes[i] = remaining;
+        remaining -= sizes[i];
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_rails(hg_bulk_op_t op, na_addr_t *na_origin_addr,
+    hg_uint8_t origin_id, struct hg_bulk *hg_bulk_origin,
+    hg_size_t origin_offset, struct hg_bulk *hg_bulk_local,
+    hg_size_t local_offset, hg_size_t size, hg_uint8_t rail_mask,
+    struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_core_rails *rails =
+        hg_core_class_get_rails(hg_bulk_op_id->core_context->core_class);
+    hg_size_t sizes[HG_CORE_RAIL_MAX], offset = 0;
+    na_bulk_op_t na_bulk_op;
+    hg_uint8_t rail_op_count = 0, i;
+    hg_uint32_t op_count = 0;
+    hg_return_t ret;
+
+    /* Map op to NA op */
+    switch (op) {
+        case HG_BULK_PUSH:
+            na_bulk_op = hg_bulk_na_put;
+            break;
+        case HG_BULK_PULL:
+            na_bulk_op = hg_bulk_na_get;
+            break;
+        default:
+            HG_GOTO_SUBSYS_ERROR(
+                bulk, error, ret, HG_INVALID_ARG, "Unknown bulk operation");
+    }
+
+    hg_bulk_transfer_rail_split(rails, rail_mask, size, sizes);
+    for (i = 0; i < HG_CORE_RAIL_MAX; i++) {
+        if (!(rail_mask & (1 << i)))
+            continue;
+        hg_bulk_op_id->rail_ops[i].size = sizes[i];
+        rail_op_count = (hg_uint8_t) (i + 1);
+        if (sizes[i] > 0)
+            op_count++;
+    }
+    for (i = 0; i < rail_op_count; i++)
+        if (!(rail_mask & (1 << i)))
+            hg_bulk_op_id->rail_ops[i].size = 0;
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Transferring data through NA in %" PRIu32 " stripe(s) across rails",
+        op_count);
+
+    /* All stripes must be accounted for before any completes */
+    hg_bulk_op_id->op_count = op_count;
+    hg_bulk_op_id->na_op_id_count = 0;
+    hg_bulk_op_id->rail_op_count = rail_op_count;
+    hg_bulk_op_id->rail_ops[0].na_op_id = hg_bulk_op_id->na_op_ids.s[0];
+
+    for (i = 0; i < rail_op_count; i++) {
+        struct hg_bulk_rail_op *rail_op = &hg_bulk_op_id->rail_ops[i];
+        na_return_t na_ret;
+
+        if (rail_op->size == 0)
+            continue;
+
+        hg_time_get_current(&rail_op->start);
+        if (i == 0)
+            na_ret = na_bulk_op(hg_bulk_op_id->na_class,
+                hg_bulk_op_id->na_context, hg_bulk_transfer_rail_cb, rail_op,
+                hg_bulk_local->na_mem_descs.handles.s[0], local_offset + offset,
+                hg_bulk_origin->na_mem_descs.handles.s[0],
+                origin_offset + offset, rail_op->size, na_origin_addr,
+                origin_id, rail_op->na_op_id);
+        else
+            na_ret = na_bulk_op(rails->rail[i].na_class,
+                hg_core_context_get_na_rail(hg_bulk_op_id->core_context, i),
+                hg_bulk_transfer_rail_cb, rail_op,
+                hg_bulk_local->rails->handles[i], local_offset + offset,
+                hg_bulk_origin->rails->handles[i], origin_offset + offset,
+                rail_op->size, hg_bulk_origin->rails->addrs[i], origin_id,
+                rail_op->na_op_id);
+        HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not transfer data on rail %" PRIu8
+            " (%s)", i, NA_Error_to_string(na_ret));
+
+        offset += rail_op->size;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_uint32_t
 hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
@@ -2270,7 +5684,7 @@ hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
     hg_size_t origin_segment_start_offset,
     const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
     hg_size_t local_segment_start_index, hg_size_t local_segment_start_offset,
-    hg_size_t size)
+    hg_size_t size, hg_size_t chunk_size)
 {
     hg_size_t origin_segment_index = origin_segment_start_index;
     hg_size_t local_segment_index = local_segment_start_index;
@@ -2289,6 +5703,10 @@ hg_bulk_transfer_get_op_count(const struct hg_bulk_segment *origin_segments,
         /* Remaining size may be smaller */
         transfer_size = HG_BULK_MIN(remaining_size, transfer_size);
 
+        /* Operations may not exceed chunk size */
+        if (chunk_size > 0)
+            transfer_size = HG_BULK_MIN(chunk_size, transfer_size);
+
         /* Increment op count */
         count++;
 
@@ -2359,8 +5777,85 @@ hg_bulk_transfer_segments_na(na_class_t *na_class, na_context_t *na_context,
 
         count++;
 
-        /* Decrease remaining size from the size of data we transferred
-         * and exit if everything has been transferred */
+        /* Decrease remaining size from the size of data we transferred
+         * and exit if everything has been transferred */
+        remaining_size -= transfer_size;
+        if (remaining_size == 0)
+            break;
+
+        /* Increment offsets from the size of data we transferred */
+        origin_segment_offset += transfer_size;
+        local_segment_offset += transfer_size;
+
+        /* Change segment if new offset exceeds segment size */
+        if (origin_segment_offset >=
+            origin_segments[origin_segment_index].len) {
+            origin_segment_index++;
+            origin_segment_offset = 0;
+        }
+        if (local_segment_offset >= local_segments[local_segment_index].len) {
+            local_segment_index++;
+            local_segment_offset = 0;
+        }
+    }
+
+    HG_CHECK_SUBSYS_ERROR(bulk, count != na_op_count, error, ret,
+        HG_PROTOCOL_ERROR, "Expected %u operations, issued %u", na_op_count,
+        count);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_batch_na(na_class_t *na_class, na_context_t *na_context,
+    na_cb_type_t na_cb_type, na_cb_t callback, void *arg,
+    na_addr_t *origin_addr, uint8_t origin_id,
+    const struct hg_bulk_segment *origin_segments, hg_uint32_t origin_count,
+    na_mem_handle_t **origin_mem_handles, hg_size_t origin_segment_start_index,
+    hg_size_t origin_segment_start_offset,
+    const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
+    na_mem_handle_t **local_mem_handles, hg_size_t local_segment_start_index,
+    hg_size_t local_segment_start_offset, hg_size_t size,
+    hg_uint32_t segment_count, na_op_id_t *na_op_id)
+{
+    hg_size_t origin_segment_index = origin_segment_start_index;
+    hg_size_t local_segment_index = local_segment_start_index;
+    hg_size_t origin_segment_offset = origin_segment_start_offset;
+    hg_size_t local_segment_offset = local_segment_start_offset;
+    hg_size_t remaining_size = size;
+    struct na_rma_segment *segments = NULL;
+    hg_uint32_t count = 0;
+    na_return_t na_ret;
+    hg_return_t ret;
+
+    segments = (struct na_rma_segment *) malloc(
+        segment_count * sizeof(struct na_rma_segment));
+    HG_CHECK_SUBSYS_ERROR(bulk, segments == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %u RMA segments", segment_count);
+
+    while (remaining_size > 0 && count < segment_count &&
+           origin_segment_index < origin_count &&
+           local_segment_index < local_count) {
+        /* Can only transfer smallest size */
+        hg_size_t transfer_size = HG_BULK_MIN(
+            (origin_segments[origin_segment_index].len - origin_segment_offset),
+            (local_segments[local_segment_index].len - local_segment_offset));
+
+        /* Remaining size may be smaller */
+        transfer_size = HG_BULK_MIN(remaining_size, transfer_size);
+
+        segments[count] = (struct na_rma_segment){
+            .local_mem_handle = local_mem_handles[local_segment_index],
+            .local_offset = local_segment_offset,
+            .remote_mem_handle = origin_mem_handles[origin_segment_index],
+            .remote_offset = origin_segment_offset,
+            .length = transfer_size};
+        count++;
+
         remaining_size -= transfer_size;
         if (remaining_size == 0)
             break;
@@ -2380,10 +5875,162 @@ hg_bulk_transfer_segments_na(na_class_t *na_class, na_context_t *na_context,
             local_segment_offset = 0;
         }
     }
+    HG_CHECK_SUBSYS_ERROR(bulk, remaining_size > 0, error, ret,
+        HG_PROTOCOL_ERROR, "Expected %u segments, %" PRIu64 " bytes left",
+        segment_count, remaining_size);
 
-    HG_CHECK_SUBSYS_ERROR(bulk, count != na_op_count, error, ret,
-        HG_PROTOCOL_ERROR, "Expected %u operations, issued %u", na_op_count,
-        count);
+    na_ret = NA_Rma_batch(na_class, na_context, na_cb_type, callback, arg,
+        segments, count, origin_addr, origin_id, na_op_id);
+    HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not transfer data (%s)",
+        NA_Error_to_string(na_ret));
+
+    free(segments);
+
+    return HG_SUCCESS;
+
+error:
+    free(segments);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_pipeline_na(na_bulk_op_t na_bulk_op, na_addr_t *na_origin_addr,
+    hg_uint8_t origin_id, const struct hg_bulk_segment *origin_segments,
+    hg_uint32_t origin_count, na_mem_handle_t **origin_mem_handles,
+    hg_uint8_t origin_flags, hg_size_t origin_offset,
+    const struct hg_bulk_segment *local_segments, hg_uint32_t local_count,
+    na_mem_handle_t **local_mem_handles, hg_uint8_t local_flags,
+    hg_size_t local_offset, hg_size_t size, hg_size_t chunk_size,
+    hg_uint32_t max_inflight, hg_bulk_na_op_id_t *hg_bulk_na_op_ids,
+    struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_bulk_segment origin_segment = {0, 0}, local_segment = {0, 0};
+    struct hg_bulk_pipeline *pipeline = NULL;
+    hg_uint32_t origin_segment_start_index = 0, local_segment_start_index = 0;
+    hg_size_t origin_segment_start_offset = 0, local_segment_start_offset = 0;
+    hg_uint32_t op_count, slot_count, i;
+    na_op_id_t **na_op_ids;
+    na_return_t na_ret;
+    hg_return_t ret;
+
+    /* Memory registered through a single NA handle is contiguous */
+    if ((origin_flags & HG_BULK_REGV) || origin_count == 1) {
+        origin_segment.base = 0;
+        origin_segment.len = origin_offset + size;
+        origin_segments = &origin_segment;
+        origin_count = 1;
+    }
+    if ((local_flags & HG_BULK_REGV) || local_count == 1) {
+        local_segment.base = 0;
+        local_segment.len = local_offset + size;
+        local_segments = &local_segment;
+        local_count = 1;
+    }
+
+    /* Translate origin offset */
+    if (origin_offset > 0)
+        hg_bulk_offset_translate(origin_segments, origin_count, origin_offset,
+            &origin_segment_start_index, &origin_segment_start_offset);
+
+    /* Translate local offset */
+    if (local_offset > 0)
+        hg_bulk_offset_translate(local_segments, local_count, local_offset,
+            &local_segment_start_index, &local_segment_start_offset);
+
+    /* Determine number of NA operations that will be needed */
+    op_count = hg_bulk_transfer_get_op_count(origin_segments, origin_count,
+        origin_segment_start_index, origin_segment_start_offset,
+        local_segments, local_count, local_segment_start_index,
+        local_segment_start_offset, size, chunk_size);
+    HG_CHECK_SUBSYS_ERROR(bulk, op_count == 0, error, ret, HG_INVALID_ARG,
+        "Could not get bulk op_count");
+    slot_count = (max_inflight > 0 && op_count > max_inflight) ? max_inflight
+                                                                : op_count;
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Transferring data through NA in %u operation(s), %u in flight",
+        op_count, slot_count);
+
+    pipeline = (struct hg_bulk_pipeline *) calloc(1,
+        sizeof(*pipeline) + slot_count * sizeof(struct hg_bulk_pipeline_slot));
+    HG_CHECK_SUBSYS_ERROR(bulk, pipeline == NULL, error, ret, HG_NOMEM,
+        "Could not allocate bulk pipeline");
+    hg_thread_spin_init(&pipeline->lock);
+    hg_bulk_op_id->pipeline = pipeline;
+
+    pipeline->origin_segment = origin_segment;
+    pipeline->origin_segments = (origin_segments == &origin_segment)
+                                    ? &pipeline->origin_segment
+                                    : origin_segments;
+    pipeline->local_segment = local_segment;
+    pipeline->local_segments = (local_segments == &local_segment)
+                                   ? &pipeline->local_segment
+                                   : local_segments;
+    pipeline->origin_mem_handles = origin_mem_handles;
+    pipeline->local_mem_handles = local_mem_handles;
+    pipeline->hg_bulk_op_id = hg_bulk_op_id;
+    pipeline->na_bulk_op = na_bulk_op;
+    pipeline->chunk_size = chunk_size;
+    pipeline->origin_segment_index = origin_segment_start_index;
+    pipeline->origin_segment_offset = origin_segment_start_offset;
+    pipeline->local_segment_index = local_segment_start_index;
+    pipeline->local_segment_offset = local_segment_start_offset;
+    pipeline->transfer_offset = 0;
+    pipeline->remaining_size = size;
+    pipeline->transferred = 0;
+    pipeline->failed_offset = size;
+    pipeline->origin_count = origin_count;
+    pipeline->local_count = local_count;
+    pipeline->slot_count = slot_count;
+    pipeline->active_count = slot_count;
+    pipeline->issued_count = 0;
+    pipeline->local_offset = local_offset;
+    pipeline->origin_id = origin_id;
+
+    /* Chunks may complete out of order, keep checksum of each chunk */
+    if (hg_bulk_op_id->checksum) {
+        pipeline->crcs = (struct hg_bulk_chunk_crc *) calloc(
+            op_count, sizeof(*pipeline->crcs));
+        HG_CHECK_SUBSYS_ERROR(bulk, pipeline->crcs == NULL, error, ret,
+            HG_NOMEM, "Could not allocate %" PRIu32 " chunk checksums",
+            op_count);
+    }
+
+    /* Follow-on operations may be issued after the caller's address is freed */
+    na_ret = NA_Addr_dup(
+        hg_bulk_op_id->na_class, na_origin_addr, &pipeline->na_origin_addr);
+    HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not duplicate origin address (%s)",
+        NA_Error_to_string(na_ret));
+
+    /* Use extra operation IDs if the number of slots exceeds the number of
+     * pre-allocated op IDs */
+    hg_bulk_op_id->op_count = op_count;
+    hg_bulk_op_id->na_op_id_count = slot_count;
+    ret = hg_bulk_na_op_ids_get(
+        hg_bulk_na_op_ids, hg_bulk_op_id->na_class, slot_count, &na_op_ids);
+    HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not get NA op IDs");
+
+    for (i = 0; i < slot_count; i++) {
+        pipeline->slots[i].pipeline = pipeline;
+        pipeline->slots[i].na_op_id = na_op_ids[i];
+    }
+
+    /* Fill pipeline, further chunks are issued as operations complete */
+    for (i = 0; i < slot_count; i++) {
+        if (hg_bulk_pipeline_next(&pipeline->slots[i]))
+            continue;
+
+        /* Nothing is in flight yet, fail directly */
+        HG_CHECK_SUBSYS_ERROR(bulk, i == 0, error, ret,
+            (hg_return_t) hg_atomic_get32(&hg_bulk_op_id->ret_status),
+            "Could not transfer data");
+
+        hg_bulk_pipeline_retire(pipeline, HG_TRUE);
+    }
 
     return HG_SUCCESS;
 
@@ -2391,6 +6038,185 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_bulk_pipeline_next(struct hg_bulk_pipeline_slot *slot)
+{
+    struct hg_bulk_pipeline *pipeline = slot->pipeline;
+    struct hg_bulk_op_id *hg_bulk_op_id = pipeline->hg_bulk_op_id;
+    struct hg_bulk *hg_bulk_local =
+        hg_bulk_op_id->callback_info.info.bulk.local_handle;
+    na_mem_handle_t *origin_mem_handle, *local_mem_handle;
+    hg_size_t origin_segment_offset, local_segment_offset, transfer_size;
+    hg_size_t local_segment_index;
+    hg_ptr_t prefetch_start = 0, prefetch_end = 0;
+    na_return_t na_ret;
+
+    /* Chunks may be issued from completion callbacks without returning to
+     * progress, also check the deadline here */
+    if (hg_bulk_op_id->timeout) {
+        hg_time_t now;
+
+        hg_time_get_current(&now);
+        if (!hg_time_less(now, hg_bulk_op_id->deadline))
+            hg_atomic_or32(&hg_bulk_op_id->status,
+                HG_BULK_OP_EXPIRED | HG_BULK_OP_CANCELED);
+    }
+
+    hg_thread_spin_lock(&pipeline->lock);
+
+    if (pipeline->remaining_size == 0) {
+        hg_thread_spin_unlock(&pipeline->lock);
+        return HG_FALSE;
+    }
+
+    /* Stop issuing operations once transfer is canceled or errored */
+    if (hg_atomic_get32(&hg_bulk_op_id->status) &
+        (HG_BULK_OP_CANCELED | HG_BULK_OP_ERRORED)) {
+        hg_thread_spin_unlock(&pipeline->lock);
+        hg_atomic_cas32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) HG_CANCELED);
+        return HG_FALSE;
+    }
+
+    /* Can only transfer smallest size */
+    transfer_size = HG_BULK_MIN(
+        (pipeline->origin_segments[pipeline->origin_segment_index].len -
+            pipeline->origin_segment_offset),
+        (pipeline->local_segments[pipeline->local_segment_index].len -
+            pipeline->local_segment_offset));
+
+    /* Remaining size and chunk size may be smaller */
+    transfer_size = HG_BULK_MIN(pipeline->remaining_size, transfer_size);
+    if (pipeline->chunk_size > 0)
+        transfer_size = HG_BULK_MIN(pipeline->chunk_size, transfer_size);
+
+    origin_mem_handle =
+        pipeline->origin_mem_handles[pipeline->origin_segment_index];
+    origin_segment_offset = pipeline->origin_segment_offset;
+    local_mem_handle =
+        pipeline->local_mem_handles[pipeline->local_segment_index];
+    local_segment_index = pipeline->local_segment_index;
+    local_segment_offset = pipeline->local_segment_offset;
+    slot->offset = pipeline->transfer_offset;
+    slot->size = transfer_size;
+    slot->index = pipeline->issued_count++;
+
+    /* Read ahead pages of file-backed memory up to one chunk past the chunks
+     * in flight, ranges already prefetched are skipped */
+    if (hg_bulk_local->attrs.file_backed) {
+        const struct hg_bulk_segment *segments =
+            HG_BULK_SEGMENTS(hg_bulk_local);
+        hg_size_t i = local_segment_index;
+        hg_ptr_t run_end = segments[i].base + segments[i].len;
+
+        prefetch_start = segments[i].base + local_segment_offset;
+        prefetch_end = prefetch_start +
+                       transfer_size * (hg_size_t) (pipeline->slot_count + 1);
+
+        /* Chunks are cut from contiguous buffers, read ahead across them */
+        while (run_end < prefetch_end &&
+               i + 1 < hg_bulk_local->desc.info.segment_count &&
+               segments[i + 1].base == run_end)
+            run_end += segments[++i].len;
+        if (prefetch_end > run_end)
+            prefetch_end = run_end;
+        if (pipeline->prefetch_end > prefetch_start &&
+            pipeline->prefetch_end <= run_end)
+            prefetch_start = pipeline->prefetch_end;
+        if (prefetch_start < prefetch_end)
+            pipeline->prefetch_end = prefetch_end;
+    }
+
+    /* Advance to next chunk */
+    pipeline->transfer_offset += transfer_size;
+    pipeline->remaining_size -= transfer_size;
+    pipeline->origin_segment_offset += transfer_size;
+    pipeline->local_segment_offset += transfer_size;
+    if (pipeline->origin_segment_offset >=
+        pipeline->origin_segments[pipeline->origin_segment_index].len) {
+        pipeline->origin_segment_index++;
+        pipeline->origin_segment_offset = 0;
+    }
+    if (pipeline->local_segment_offset >=
+        pipeline->local_segments[pipeline->local_segment_index].len) {
+        pipeline->local_segment_index++;
+        pipeline->local_segment_offset = 0;
+    }
+
+    hg_thread_spin_unlock(&pipeline->lock);
+
+    if (hg_bulk_local->attrs.file_backed) {
+        hg_return_t ret;
+
+        if (prefetch_start < prefetch_end)
+            (void) hg_mem_prefetch((void *) prefetch_start,
+                (size_t) (prefetch_end - prefetch_start));
+
+        /* Register chunk once the pipeline reaches it */
+        ret = hg_bulk_register_deferred(hg_bulk_local, hg_bulk_op_id->na_class,
+            (hg_uint32_t) local_segment_index, &local_mem_handle);
+        na_ret = (na_return_t) ret;
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not register file-backed segment");
+    }
+
+    na_ret = pipeline->na_bulk_op(hg_bulk_op_id->na_class,
+        hg_bulk_op_id->na_context, hg_bulk_transfer_pipeline_cb, slot,
+        local_mem_handle, local_segment_offset, origin_mem_handle,
+        origin_segment_offset, transfer_size, pipeline->na_origin_addr,
+        pipeline->origin_id, slot->na_op_id);
+    HG_CHECK_SUBSYS_ERROR_NORET(bulk, na_ret != NA_SUCCESS, error,
+        "Could not transfer data (%s)", NA_Error_to_string(na_ret));
+
+    return HG_TRUE;
+
+error:
+    if (hg_bulk_op_id->stats) {
+        hg_thread_spin_lock(&pipeline->lock);
+        if (slot->offset < pipeline->failed_offset)
+            pipeline->failed_offset = slot->offset;
+        hg_thread_spin_unlock(&pipeline->lock);
+    }
+
+    /* Mark handle as errored and keep first non-success ret status */
+    hg_atomic_or32(&hg_bulk_op_id->status, HG_BULK_OP_ERRORED);
+    hg_atomic_cas32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS,
+        (int32_t) na_ret);
+
+    return HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_pipeline_retire(
+    struct hg_bulk_pipeline *pipeline, hg_bool_t self_notify)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id = pipeline->hg_bulk_op_id;
+    hg_bool_t last;
+
+    hg_thread_spin_lock(&pipeline->lock);
+    last = (--pipeline->active_count == 0);
+    hg_thread_spin_unlock(&pipeline->lock);
+
+    if (last)
+        hg_bulk_complete(hg_bulk_op_id,
+            (hg_return_t) hg_atomic_get32(&hg_bulk_op_id->ret_status),
+            self_notify);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_pipeline_free(struct hg_bulk_pipeline *pipeline)
+{
+    if (pipeline->na_origin_addr)
+        NA_Addr_free(
+            pipeline->hg_bulk_op_id->na_class, pipeline->na_origin_addr);
+    hg_thread_spin_destroy(&pipeline->lock);
+    free(pipeline->crcs);
+    free(pipeline);
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_bulk_transfer_cb(const struct na_cb_info *callback_info)
@@ -2430,6 +6256,124 @@ hg_bulk_transfer_cb(const struct na_cb_info *callback_info)
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_atomic_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id =
+        (struct hg_bulk_op_id *) callback_info->arg;
+
+    if (callback_info->ret == NA_SUCCESS)
+        hg_bulk_op_id->callback_info.info.bulk.result =
+            callback_info->info.atomic.result;
+
+    hg_bulk_transfer_cb(callback_info);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_transfer_rail_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_bulk_rail_op *rail_op =
+        (struct hg_bulk_rail_op *) callback_info->arg;
+    struct hg_bulk_op_id *hg_bulk_op_id = rail_op->hg_bulk_op_id;
+    struct na_cb_info transfer_cb_info = *callback_info;
+
+    hg_time_get_current(&rail_op->end);
+    rail_op->transferred = (callback_info->ret == NA_SUCCESS);
+
+    /* Update bandwidth estimate of rail (moving average) */
+    if (callback_info->ret == NA_SUCCESS) {
+        struct hg_core_rails *rails =
+            hg_core_class_get_rails(hg_bulk_op_id->core_context->core_class);
+        hg_atomic_int32_t *bandwidth_p =
+            &rails->rail[rail_op - hg_bulk_op_id->rail_ops].bandwidth;
+        int32_t bandwidth = hg_atomic_get32(bandwidth_p), sample;
+        double elapsed_us, rate;
+
+        elapsed_us = hg_time_diff(rail_op->end, rail_op->start) * 1000000.0;
+        rate = (double) rail_op->size / ((elapsed_us > 1.0) ? elapsed_us : 1.0);
+        if (rate >= (double) INT32_MAX)
+            sample = INT32_MAX;
+        else
+            sample = (rate > 1.0) ? (int32_t) rate : 1;
+        hg_atomic_set32(bandwidth_p,
+            (bandwidth == 0) ? sample : bandwidth + (sample - bandwidth) / 4);
+    }
+
+    transfer_cb_info.arg = hg_bulk_op_id;
+    hg_bulk_transfer_cb(&transfer_cb_info);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_transfer_pipeline_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_bulk_pipeline_slot *slot =
+        (struct hg_bulk_pipeline_slot *) callback_info->arg;
+    struct hg_bulk_pipeline *pipeline = slot->pipeline;
+    struct hg_bulk_op_id *hg_bulk_op_id = pipeline->hg_bulk_op_id;
+    hg_size_t chunk_offset = slot->offset, chunk_size = slot->size;
+    hg_uint32_t chunk_index = slot->index;
+    hg_bool_t issued = HG_FALSE;
+
+    /* Keep track of chunks completed so that partial transfers can be
+     * resumed */
+    if (hg_bulk_op_id->stats) {
+        hg_thread_spin_lock(&pipeline->lock);
+        if (callback_info->ret == NA_SUCCESS)
+            pipeline->transferred += chunk_size;
+        else if (chunk_offset < pipeline->failed_offset)
+            pipeline->failed_offset = chunk_offset;
+        hg_thread_spin_unlock(&pipeline->lock);
+    }
+
+    if (callback_info->ret == NA_SUCCESS) {
+        /* Keep slot busy while the chunk callback executes */
+        issued = hg_bulk_pipeline_next(slot);
+    } else if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_SUBSYS_WARNING(bulk,
+            hg_atomic_get32(&hg_bulk_op_id->status) & HG_BULK_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_SUBSYS_DEBUG(
+            bulk, "NA_CANCELED event on op ID %p", (void *) hg_bulk_op_id);
+
+        hg_atomic_cas32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) HG_CANCELED);
+    } else { /* All other errors */
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_bulk_op_id->status, HG_BULK_OP_ERRORED);
+
+        /* Keep first non-success ret status */
+        hg_atomic_cas32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) callback_info->ret);
+        HG_LOG_ERROR("NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
+    }
+
+    /* Checksum chunk while it is still in cache, next chunk is already in
+     * flight */
+    if (callback_info->ret == NA_SUCCESS && hg_bulk_op_id->checksum) {
+        struct hg_bulk *hg_bulk_local =
+            hg_bulk_op_id->callback_info.info.bulk.local_handle;
+
+        pipeline->crcs[chunk_index].crc =
+            hg_bulk_checksum(HG_BULK_SEGMENTS(hg_bulk_local),
+                hg_bulk_local->desc.info.segment_count,
+                pipeline->local_offset + chunk_offset, chunk_size);
+        pipeline->crcs[chunk_index].size = chunk_size;
+    }
+
+    /* Notify chunk completion */
+    if (callback_info->ret == NA_SUCCESS && hg_bulk_op_id->chunk_callback)
+        hg_bulk_op_id->chunk_callback(
+            hg_bulk_op_id->chunk_arg, chunk_offset, chunk_size);
+
+    /* Complete bulk operation once all slots are released */
+    if (!issued)
+        hg_bulk_pipeline_retire(pipeline, HG_FALSE);
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_bulk_complete(
@@ -2438,6 +6382,39 @@ hg_bulk_complete(
     /* Mark op id as completed */
     hg_atomic_or32(&hg_bulk_op_id->status, HG_BULK_OP_COMPLETED);
 
+    /* Let queued transfers use the bytes that were in flight */
+    if (hg_bulk_op_id->sched_size > 0)
+        hg_bulk_sched_release(hg_bulk_op_id, self_notify);
+
+    /* Transfers canceled once their deadline was reached time out */
+    if (hg_bulk_op_id->timeout) {
+        hg_bulk_expiry_remove(hg_bulk_op_id);
+        if (ret == HG_CANCELED &&
+            (hg_atomic_get32(&hg_bulk_op_id->status) & HG_BULK_OP_EXPIRED))
+            ret = HG_TIMEOUT;
+    }
+
+    /* Combine checksums of pipelined chunks in transfer order */
+    if (hg_bulk_op_id->checksum && hg_bulk_op_id->pipeline != NULL &&
+        ret == HG_SUCCESS) {
+        const struct hg_bulk_pipeline *pipeline = hg_bulk_op_id->pipeline;
+        hg_uint32_t crc = 0, i;
+
+        for (i = 0; i < pipeline->issued_count; i++)
+            crc = hg_crc32c_combine(
+                crc, pipeline->crcs[i].crc, pipeline->crcs[i].size);
+        hg_bulk_op_id->callback_info.info.bulk.checksum = crc;
+    }
+
+    if (hg_bulk_op_id->stats)
+        hg_bulk_stats_fill(hg_bulk_op_id, ret);
+
+    /* Transfers of a list are not individually notified */
+    if (hg_bulk_op_id->parent != NULL) {
+        hg_bulk_list_complete_one(hg_bulk_op_id->parent, ret, self_notify);
+        return;
+    }
+
     /* Forward status to callback */
     hg_bulk_op_id->callback_info.ret = ret;
 
@@ -2448,10 +6425,216 @@ hg_bulk_complete(
         &hg_bulk_op_id->hg_completion_entry, self_notify);
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_list_complete_one(
+    struct hg_bulk_op_id *hg_bulk_op_id, hg_return_t ret, hg_bool_t self_notify)
+{
+    /* Keep first non-success ret status */
+    if (ret != HG_SUCCESS)
+        hg_atomic_cas32(&hg_bulk_op_id->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) ret);
+
+    if ((hg_uint32_t) hg_atomic_incr32(&hg_bulk_op_id->op_completed_count) ==
+        hg_bulk_op_id->op_count)
+        hg_bulk_complete(hg_bulk_op_id,
+            (hg_return_t) hg_atomic_get32(&hg_bulk_op_id->ret_status),
+            self_notify);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_stats_fill(struct hg_bulk_op_id *hg_bulk_op_id, hg_return_t ret)
+{
+    struct hg_bulk_transfer_stats *stats = hg_bulk_op_id->stats;
+    hg_size_t size = hg_bulk_op_id->callback_info.info.bulk.size;
+    hg_time_t now;
+    unsigned int i;
+
+    hg_time_get_current(&now);
+    memset(stats, 0, sizeof(*stats));
+    stats->elapsed = hg_time_diff(now, hg_bulk_op_id->start);
+
+    if (hg_bulk_op_id->pipeline) {
+        /* All slots were retired, chunks below the lowest offset that failed
+         * or was never issued were transferred */
+        struct hg_bulk_pipeline *pipeline = hg_bulk_op_id->pipeline;
+
+        stats->transferred = pipeline->transferred;
+        stats->resume_offset =
+            HG_BULK_MIN(pipeline->failed_offset, pipeline->transfer_offset);
+        stats->rails[0].transferred = stats->transferred;
+        stats->rails[0].elapsed = stats->elapsed;
+        stats->rail_count = 1;
+    } else if (hg_bulk_op_id->rail_op_count > 0) {
+        /* Stripes are laid out in rail order */
+        hg_bool_t contiguous = HG_TRUE;
+
+        for (i = 0; i < hg_bulk_op_id->rail_op_count &&
+                    i < HG_BULK_STATS_RAIL_MAX;
+             i++) {
+            struct hg_bulk_rail_op *rail_op = &hg_bulk_op_id->rail_ops[i];
+
+            if (rail_op->size == 0)
+                continue;
+            if (rail_op->transferred) {
+                stats->rails[i].transferred = rail_op->size;
+                stats->transferred += rail_op->size;
+                if (contiguous)
+                    stats->resume_offset += rail_op->size;
+            } else
+                contiguous = HG_FALSE;
+            stats->rails[i].elapsed =
+                hg_time_diff(rail_op->end, hg_bulk_op_id->start);
+        }
+        stats->rail_count = (hg_uint8_t) i;
+    } else {
+        /* Local copies and single NA operations complete entirely or not */
+        stats->transferred = (ret == HG_SUCCESS) ? size : 0;
+        stats->resume_offset = stats->transferred;
+        stats->rails[0].transferred = stats->transferred;
+        stats->rails[0].elapsed = stats->elapsed;
+        stats->rail_count = 1;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_expiry_remove(struct hg_bulk_op_id *hg_bulk_op_id)
+{
+    struct hg_bulk_op_pool *hg_bulk_op_pool =
+        hg_core_context_get_bulk_op_pool(hg_bulk_op_id->core_context);
+
+    if (!hg_bulk_op_id->timeout)
+        return;
+
+    hg_thread_spin_lock(&hg_bulk_op_pool->expiry_list_lock);
+    if (hg_bulk_op_id->expiring) {
+        HG_LIST_REMOVE(hg_bulk_op_id, expiry);
+        hg_bulk_op_id->expiring = HG_FALSE;
+        hg_atomic_decr32(&hg_bulk_op_pool->expiry_count);
+    }
+    hg_thread_spin_unlock(&hg_bulk_op_pool->expiry_list_lock);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+hg_bulk_op_pool_expire(
+    struct hg_bulk_op_pool *hg_bulk_op_pool, hg_time_t *deadline_p)
+{
+    HG_LIST_HEAD(hg_bulk_op_id) expired_list;
+    struct hg_bulk_op_id *hg_bulk_op_id;
+    hg_bool_t pending = HG_FALSE;
+    hg_time_t now;
+
+    if (hg_atomic_get32(&hg_bulk_op_pool->expiry_count) == 0)
+        return HG_FALSE;
+
+    HG_LIST_INIT(&expired_list);
+    hg_time_get_current(&now);
+
+    /* Keep a reference to expired op IDs so that they cannot be released
+     * while they are canceled */
+    hg_thread_spin_lock(&hg_bulk_op_pool->expiry_list_lock);
+    hg_bulk_op_id = HG_LIST_FIRST(&hg_bulk_op_pool->expiry_list);
+    while (hg_bulk_op_id != NULL) {
+        struct hg_bulk_op_id *next = HG_LIST_NEXT(hg_bulk_op_id, expiry);
+
+        if (!hg_time_less(now, hg_bulk_op_id->deadline)) {
+            HG_LIST_REMOVE(hg_bulk_op_id, expiry);
+            hg_bulk_op_id->expiring = HG_FALSE;
+            hg_atomic_decr32(&hg_bulk_op_pool->expiry_count);
+            hg_atomic_incr32(&hg_bulk_op_id->ref_count);
+            HG_LIST_INSERT_HEAD(&expired_list, hg_bulk_op_id, expiry);
+        } else {
+            if (deadline_p != NULL &&
+                (!pending ||
+                    hg_time_less(hg_bulk_op_id->deadline, *deadline_p)))
+                *deadline_p = hg_bulk_op_id->deadline;
+            pending = HG_TRUE;
+        }
+        hg_bulk_op_id = next;
+    }
+    hg_thread_spin_unlock(&hg_bulk_op_pool->expiry_list_lock);
+
+    while ((hg_bulk_op_id = HG_LIST_FIRST(&expired_list)) != NULL) {
+        hg_return_t ret;
+
+        HG_LIST_REMOVE(hg_bulk_op_id, expiry);
+
+        HG_LOG_SUBSYS_DEBUG(bulk, "Bulk op ID (%p) reached its deadline",
+            (void *) hg_bulk_op_id);
+
+        hg_atomic_or32(&hg_bulk_op_id->status, HG_BULK_OP_EXPIRED);
+        ret = hg_bulk_cancel(hg_bulk_op_id);
+        if (ret != HG_SUCCESS)
+            HG_LOG_SUBSYS_ERROR(bulk,
+                "Could not cancel expired bulk op ID (%p)",
+                (void *) hg_bulk_op_id);
+
+        hg_bulk_op_destroy(hg_bulk_op_id);
+    }
+
+    return pending;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+hg_bulk_op_pool_device_poll(struct hg_bulk_op_pool *hg_bulk_op_pool)
+{
+#ifdef HG_HAS_CUDA
+    HG_LIST_HEAD(hg_bulk_op_id) done_list;
+    struct hg_bulk_op_id *hg_bulk_op_id;
+    hg_bool_t pending = HG_FALSE;
+
+    if (hg_atomic_get32(&hg_bulk_op_pool->device_count) == 0)
+        return HG_FALSE;
+
+    HG_LIST_INIT(&done_list);
+
+    hg_thread_spin_lock(&hg_bulk_op_pool->device_list_lock);
+    hg_bulk_op_id = HG_LIST_FIRST(&hg_bulk_op_pool->device_list);
+    while (hg_bulk_op_id != NULL) {
+        struct hg_bulk_op_id *next = HG_LIST_NEXT(hg_bulk_op_id, device);
+        cudaError_t cuda_rc = cudaEventQuery(hg_bulk_op_id->cuda_event);
+
+        if (cuda_rc == cudaErrorNotReady)
+            pending = HG_TRUE;
+        else {
+            if (cuda_rc != cudaSuccess) {
+                HG_LOG_SUBSYS_ERROR(bulk, "Device copy failed (%s)",
+                    cudaGetErrorString(cuda_rc));
+                hg_atomic_set32(
+                    &hg_bulk_op_id->ret_status, (int32_t) HG_PROTOCOL_ERROR);
+            }
+            HG_LIST_REMOVE(hg_bulk_op_id, device);
+            hg_atomic_decr32(&hg_bulk_op_pool->device_count);
+            HG_LIST_INSERT_HEAD(&done_list, hg_bulk_op_id, device);
+        }
+        hg_bulk_op_id = next;
+    }
+    hg_thread_spin_unlock(&hg_bulk_op_pool->device_list_lock);
+
+    while ((hg_bulk_op_id = HG_LIST_FIRST(&done_list)) != NULL) {
+        HG_LIST_REMOVE(hg_bulk_op_id, device);
+        hg_bulk_transfer_self_cuda_complete(hg_bulk_op_id,
+            (hg_return_t) hg_atomic_get32(&hg_bulk_op_id->ret_status));
+    }
+
+    return pending;
+#else
+    (void) hg_bulk_op_pool;
+
+    return HG_FALSE;
+#endif
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id)
 {
+    const struct hg_core_rails *rails =
+        hg_core_class_get_rails(hg_bulk_op_id->core_context->core_class);
     na_op_id_t **na_op_ids;
     hg_return_t ret;
     int32_t status;
@@ -2468,6 +6651,12 @@ hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id)
         HG_BULK_OP_CANCELED)
         return HG_SUCCESS;
 
+    /* Transfers that were never started complete right away */
+    if (hg_bulk_sched_remove(hg_bulk_op_id)) {
+        hg_bulk_complete(hg_bulk_op_id, HG_CANCELED, HG_TRUE);
+        return HG_SUCCESS;
+    }
+
 #ifdef NA_HAS_SM
     if (hg_bulk_op_id->na_class ==
         hg_bulk_op_id->core_context->core_class->na_sm_class)
@@ -2476,8 +6665,36 @@ hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id)
 #endif
         na_op_ids = HG_BULK_NA_OP_IDS(hg_bulk_op_id);
 
+    /* Cancel transfers of list */
+    for (i = 0; i < hg_bulk_op_id->child_count; i++) {
+        ret = hg_bulk_cancel(hg_bulk_op_id->children[i]);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not cancel transfer %u of list", i);
+    }
+
+    /* Cancel stripes issued across rails */
+    for (i = 0; i < hg_bulk_op_id->rail_op_count; i++) {
+        struct hg_bulk_rail_op *rail_op = &hg_bulk_op_id->rail_ops[i];
+        na_return_t na_ret;
+
+        if (rail_op->size == 0)
+            continue;
+
+        if (i == 0)
+            na_ret = NA_Cancel(hg_bulk_op_id->na_class,
+                hg_bulk_op_id->na_context, rail_op->na_op_id);
+        else
+            na_ret = NA_Cancel(rails->rail[i].na_class,
+                hg_core_context_get_na_rail(
+                    hg_bulk_op_id->core_context, (hg_uint8_t) i),
+                rail_op->na_op_id);
+        HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not cancel NA op ID on rail %u (%s)",
+            i, NA_Error_to_string(na_ret));
+    }
+
     /* Cancel all NA operations issued */
-    for (i = 0; i < hg_bulk_op_id->op_count; i++) {
+    for (i = 0; i < hg_bulk_op_id->na_op_id_count; i++) {
         na_return_t na_ret = NA_Cancel(
             hg_bulk_op_id->na_class, hg_bulk_op_id->na_context, na_op_ids[i]);
         HG_CHECK_SUBSYS_ERROR(bulk, na_ret != NA_SUCCESS, error, ret,
@@ -2487,8 +6704,70 @@ hg_bulk_cancel(struct hg_bulk_op_id *hg_bulk_op_id)
 
     return HG_SUCCESS;
 
-error:
-    return ret;
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_stream_issue(struct hg_bulk_stream *hg_bulk_stream)
+{
+    struct hg_bulk_stream_slot *slot =
+        &hg_bulk_stream->slots[hg_bulk_stream->issue_slot];
+    hg_size_t size = hg_bulk_stream->size - hg_bulk_stream->issued;
+    hg_return_t ret;
+
+    if (size > hg_bulk_stream->chunk_size)
+        size = hg_bulk_stream->chunk_size;
+    slot->size = size;
+    hg_atomic_set32(&slot->status, HG_BULK_STREAM_PENDING);
+    hg_atomic_incr32(&hg_bulk_stream->ref_count);
+
+    ret = HG_Bulk_transfer_opt(hg_bulk_stream->context, hg_bulk_stream_cb,
+        slot, HG_BULK_PULL, (hg_addr_t) hg_bulk_stream->origin_addr,
+        hg_bulk_stream->origin_id, hg_bulk_stream->origin_handle,
+        hg_bulk_stream->origin_offset + hg_bulk_stream->issued,
+        hg_bulk_stream->local_handle,
+        (hg_size_t) hg_bulk_stream->issue_slot * hg_bulk_stream->chunk_size,
+        size, NULL, &slot->op_id);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_SUBSYS_ERROR(bulk,
+            "Could not request chunk at offset %" PRIu64 " of stream (%p)",
+            hg_bulk_stream->issued, (void *) hg_bulk_stream);
+        hg_atomic_decr32(&hg_bulk_stream->ref_count);
+        hg_atomic_set32(&slot->status, (int32_t) ret);
+    }
+
+    hg_bulk_stream->issued += size;
+    hg_bulk_stream->issue_slot =
+        (hg_bulk_stream->issue_slot + 1) % hg_bulk_stream->depth;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_stream_cb(const struct hg_cb_info *callback_info)
+{
+    struct hg_bulk_stream_slot *slot =
+        (struct hg_bulk_stream_slot *) callback_info->arg;
+    struct hg_bulk_stream *hg_bulk_stream = slot->stream;
+
+    hg_atomic_set32(&slot->status, (int32_t) callback_info->ret);
+    if (hg_atomic_decr32(&hg_bulk_stream->ref_count) == 0)
+        hg_bulk_stream_free(hg_bulk_stream);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_stream_free(struct hg_bulk_stream *hg_bulk_stream)
+{
+    (void) HG_Bulk_free(hg_bulk_stream->local_handle);
+    (void) HG_Bulk_free(hg_bulk_stream->origin_handle);
+    if (hg_bulk_stream->origin_addr != HG_CORE_ADDR_NULL)
+        (void) HG_Core_addr_free(hg_bulk_stream->origin_addr);
+    free(hg_bulk_stream->slots);
+    free(hg_bulk_stream);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -2523,7 +6802,8 @@ hg_return_t
 HG_Bulk_create(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
     const hg_size_t *buf_sizes, hg_uint8_t flags, hg_bulk_t *handle)
 {
-    struct hg_bulk_attr attrs = {.mem_type = HG_MEM_TYPE_HOST, .device = 0};
+    struct hg_bulk_attr attrs = {
+        .mem_type = HG_MEM_TYPE_HOST, .device = 0, .file_backed = HG_FALSE};
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(
@@ -2576,6 +6856,11 @@ HG_Bulk_create_attr(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
     /* We allow for 0-sized segments though. */
     HG_CHECK_SUBSYS_ERROR(
         bulk, attrs == NULL, error, ret, HG_INVALID_ARG, "NULL attrs");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        attrs->file_backed &&
+            (buf_ptrs == NULL || attrs->mem_type != HG_MEM_TYPE_HOST),
+        error, ret, HG_INVALID_ARG,
+        "File-backed handles require host memory buffers");
 
     switch (flags) {
         case HG_BULK_READWRITE:
@@ -2640,6 +6925,30 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_cache_invalidate(hg_class_t *hg_class, void *base, hg_size_t len)
+{
+    struct hg_bulk_reg_cache *hg_bulk_reg_cache;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_class == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG class passed");
+
+    hg_bulk_reg_cache = hg_core_class_get_bulk_reg_cache(hg_class->core_class);
+    if (hg_bulk_reg_cache == NULL)
+        return HG_SUCCESS;
+
+    ret = hg_bulk_reg_cache_invalidate(hg_bulk_reg_cache, (hg_ptr_t) base, len);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        bulk, error, ret, "Could not invalidate cached registrations");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Bulk_bind(hg_bulk_t handle, hg_context_t *context)
@@ -2724,6 +7033,14 @@ HG_Bulk_get_serialize_size(hg_bulk_t handle, unsigned long flags)
     HG_CHECK_ERROR_NORET(
         handle == HG_BULK_NULL, error, "NULL bulk handle passed");
 
+    /* Remote peers need handles of all segments */
+    if (((struct hg_bulk *) handle)->lazy && !(flags & HG_BULK_SELF)) {
+        hg_return_t hg_ret = hg_bulk_register_deferred_all(
+            (struct hg_bulk *) handle, flags & 0xff);
+        HG_CHECK_SUBSYS_ERROR_NORET(bulk, hg_ret != HG_SUCCESS, error,
+            "Could not register segments of file-backed handle");
+    }
+
     ret = hg_bulk_get_serialize_size((struct hg_bulk *) handle, flags & 0xff);
 
     HG_LOG_SUBSYS_DEBUG(bulk,
@@ -2753,6 +7070,13 @@ HG_Bulk_serialize(
         (void *) handle, (flags & HG_BULK_EAGER) ? HG_TRUE : HG_FALSE,
         (flags & HG_BULK_SM) ? HG_TRUE : HG_FALSE);
 
+    if (((struct hg_bulk *) handle)->lazy && !(flags & HG_BULK_SELF)) {
+        ret = hg_bulk_register_deferred_all(
+            (struct hg_bulk *) handle, flags & 0xff);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            bulk, error, ret, "Could not register segments of handle");
+    }
+
     ret = hg_bulk_serialize(
         buf, buf_size, flags & 0xff, (struct hg_bulk *) handle);
     HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not serialize handle");
@@ -2773,8 +7097,8 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
     HG_CHECK_SUBSYS_ERROR(bulk, handle == NULL, error, ret, HG_INVALID_ARG,
         "NULL bulk handle passed");
 
-    ret = hg_bulk_deserialize(
-        hg_class->core_class, (struct hg_bulk **) handle, buf, buf_size);
+    ret = hg_bulk_deserialize_pinned(
+        hg_class, (struct hg_bulk **) handle, buf, buf_size, NULL);
     HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not deserialize handle");
 
     HG_LOG_SUBSYS_DEBUG(
@@ -2837,9 +7161,9 @@ HG_Bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
         (void *) hg_bulk_origin, (void *) hg_bulk_local);
 
     /* Do bulk transfer */
-    ret = hg_bulk_transfer(context->core_context, callback, arg, op,
+    ret = hg_bulk_transfer(context->core_context, callback, arg, NULL, op,
         (hg_core_addr_t) origin_addr, 0, hg_bulk_origin, origin_offset,
-        hg_bulk_local, local_offset, size, op_id);
+        hg_bulk_local, local_offset, size, NULL, op_id);
     HG_CHECK_SUBSYS_HG_ERROR(
         bulk, error, ret, "Could not start transfer of bulk data");
 
@@ -2849,6 +7173,56 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer_wait_cb(const struct hg_cb_info *callback_info)
+{
+    hg_wait_signal((struct hg_wait *) callback_info->arg, callback_info->ret);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_wait(hg_context_t *context, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_bulk_t origin_handle, hg_size_t origin_offset,
+    hg_bulk_t local_handle, hg_size_t local_offset, hg_size_t size,
+    unsigned int timeout_ms)
+{
+    struct hg_wait hg_wait;
+    hg_op_id_t op_id;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        bulk, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+
+    hg_wait.core_context = context->core_context;
+    hg_atomic_init32(&hg_wait.done, 0);
+    hg_wait.ret = HG_SUCCESS;
+
+    ret = HG_Bulk_transfer(context, hg_bulk_transfer_wait_cb, &hg_wait, op,
+        origin_addr, origin_handle, origin_offset, local_handle, local_offset,
+        size, &op_id);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        bulk, error, ret, "Could not start transfer of bulk data");
+
+    ret = hg_wait_progress(context, &hg_wait, timeout_ms);
+    if (ret != HG_SUCCESS) {
+        /* Callback references hg_wait, wait for the canceled transfer to
+         * complete before leaving */
+        (void) HG_Bulk_cancel(op_id);
+        while (hg_wait_progress(context, &hg_wait, HG_MAX_IDLE_TIME) !=
+               HG_SUCCESS)
+            continue;
+        return ret;
+    }
+
+    return hg_wait.ret;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Bulk_bind_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
@@ -2896,9 +7270,9 @@ HG_Bulk_bind_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
         (void *) hg_bulk_origin, (void *) hg_bulk_local);
 
     /* Do bulk transfer */
-    ret = hg_bulk_transfer(context->core_context, callback, arg, op,
+    ret = hg_bulk_transfer(context->core_context, callback, arg, NULL, op,
         hg_bulk_origin->addr, hg_bulk_origin->context_id, hg_bulk_origin,
-        origin_offset, hg_bulk_local, local_offset, size, op_id);
+        origin_offset, hg_bulk_local, local_offset, size, NULL, op_id);
     HG_CHECK_SUBSYS_HG_ERROR(
         bulk, error, ret, "Could not start transfer of bulk data");
 
@@ -2914,9 +7288,26 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
     hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
     hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
     hg_size_t local_offset, hg_size_t size, hg_op_id_t *op_id)
+{
+    return HG_Bulk_transfer_pipelined(context, callback, arg, NULL, NULL, op,
+        origin_addr, origin_id, origin_handle, origin_offset, local_handle,
+        local_offset, size, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_pipelined(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_chunk_cb_t chunk_callback, void *chunk_arg, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_op_id_t *op_id)
 {
     struct hg_bulk *hg_bulk_origin = (struct hg_bulk *) origin_handle;
     struct hg_bulk *hg_bulk_local = (struct hg_bulk *) local_handle;
+    const struct hg_bulk_transfer_opt opt = {.chunk_callback = chunk_callback,
+        .chunk_arg = chunk_arg,
+        .stats = NULL,
+        .timeout_ms = 0};
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(
@@ -2959,9 +7350,75 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
         (void *) hg_bulk_origin, (void *) hg_bulk_local);
 
     /* Do bulk transfer */
-    ret = hg_bulk_transfer(context->core_context, callback, arg, op,
+    ret = hg_bulk_transfer(context->core_context, callback, arg, &opt, op,
+        (hg_core_addr_t) origin_addr, origin_id, hg_bulk_origin, origin_offset,
+        hg_bulk_local, local_offset, size, NULL, op_id);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        bulk, error, ret, "Could not start transfer of bulk data");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_opt(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
+    hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
+    hg_size_t local_offset, hg_size_t size,
+    const struct hg_bulk_transfer_opt *opt, hg_op_id_t *op_id)
+{
+    struct hg_bulk *hg_bulk_origin = (struct hg_bulk *) origin_handle;
+    struct hg_bulk *hg_bulk_local = (struct hg_bulk *) local_handle;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        bulk, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+
+    /* Origin handle sanity checks */
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_origin == NULL, error, ret,
+        HG_INVALID_ARG, "NULL origin handle passed");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        (origin_offset + size) > hg_bulk_origin->desc.info.len, error, ret,
+        HG_INVALID_ARG,
+        "Exceeding size of memory exposed by origin handle (%" PRIu64
+        " + %" PRIu64 " > %" PRIu64 ")",
+        origin_offset, size, hg_bulk_origin->desc.info.len);
+
+    /* Use address embedded into origin handle if any */
+    if (hg_bulk_origin->addr != HG_CORE_ADDR_NULL) {
+        origin_addr = (hg_addr_t) hg_bulk_origin->addr;
+        origin_id = hg_bulk_origin->context_id;
+    }
+
+    /* Origin addr check */
+    HG_CHECK_SUBSYS_ERROR(bulk, origin_addr == HG_ADDR_NULL, error, ret,
+        HG_INVALID_ARG, "NULL origin addr");
+
+    /* Local handle sanity checks */
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_local == NULL, error, ret,
+        HG_INVALID_ARG, "NULL local handle passed");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        (local_offset + size) > hg_bulk_local->desc.info.len, error, ret,
+        HG_INVALID_ARG,
+        "Exceeding size of memory exposed by local handle (%" PRIu64
+        " + %" PRIu64 " > %" PRIu64 ")",
+        local_offset, size, hg_bulk_local->desc.info.len);
+
+    /* Check permission flags */
+    HG_BULK_CHECK_FLAGS(op, hg_bulk_origin->desc.info.flags,
+        hg_bulk_local->desc.info.flags, error, ret);
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Transferring data between bulk handle (%p) and bulk handle (%p)",
+        (void *) hg_bulk_origin, (void *) hg_bulk_local);
+
+    /* Do bulk transfer */
+    ret = hg_bulk_transfer(context->core_context, callback, arg, opt, op,
         (hg_core_addr_t) origin_addr, origin_id, hg_bulk_origin, origin_offset,
-        hg_bulk_local, local_offset, size, op_id);
+        hg_bulk_local, local_offset, size, NULL, op_id);
     HG_CHECK_SUBSYS_HG_ERROR(
         bulk, error, ret, "Could not start transfer of bulk data");
 
@@ -2971,6 +7428,140 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_list(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, hg_bulk_t local_handle,
+    const struct hg_bulk_transfer_entry *entries, hg_uint32_t count,
+    hg_op_id_t *op_id)
+{
+    struct hg_bulk *hg_bulk_local = (struct hg_bulk *) local_handle;
+    hg_return_t ret;
+    hg_uint32_t i;
+
+    HG_CHECK_SUBSYS_ERROR(
+        bulk, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_local == NULL, error, ret,
+        HG_INVALID_ARG, "NULL local handle passed");
+    HG_CHECK_SUBSYS_ERROR(bulk, count > 0 && entries == NULL, error, ret,
+        HG_INVALID_ARG, "NULL list of entries passed");
+
+    /* Check all entries before issuing any transfer */
+    for (i = 0; i < count; i++) {
+        struct hg_bulk *hg_bulk_origin =
+            (struct hg_bulk *) entries[i].origin_handle;
+
+        /* Origin handle sanity checks */
+        HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_origin == NULL, error, ret,
+            HG_INVALID_ARG, "NULL origin handle passed in entry %" PRIu32, i);
+        HG_CHECK_SUBSYS_ERROR(bulk,
+            (entries[i].origin_offset + entries[i].size) >
+                hg_bulk_origin->desc.info.len,
+            error, ret, HG_INVALID_ARG,
+            "Exceeding size of memory exposed by origin handle of entry "
+            "%" PRIu32 " (%" PRIu64 " + %" PRIu64 " > %" PRIu64 ")",
+            i, entries[i].origin_offset, entries[i].size,
+            hg_bulk_origin->desc.info.len);
+
+        /* Origin addr check */
+        HG_CHECK_SUBSYS_ERROR(bulk,
+            hg_bulk_origin->addr == HG_CORE_ADDR_NULL &&
+                entries[i].origin_addr == HG_ADDR_NULL,
+            error, ret, HG_INVALID_ARG, "NULL origin addr in entry %" PRIu32,
+            i);
+
+        /* Local handle sanity checks */
+        HG_CHECK_SUBSYS_ERROR(bulk,
+            (entries[i].local_offset + entries[i].size) >
+                hg_bulk_local->desc.info.len,
+            error, ret, HG_INVALID_ARG,
+            "Exceeding size of memory exposed by local handle in entry "
+            "%" PRIu32 " (%" PRIu64 " + %" PRIu64 " > %" PRIu64 ")",
+            i, entries[i].local_offset, entries[i].size,
+            hg_bulk_local->desc.info.len);
+
+        /* Check permission flags */
+        HG_BULK_CHECK_FLAGS(op, hg_bulk_origin->desc.info.flags,
+            hg_bulk_local->desc.info.flags, error, ret);
+    }
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Transferring data between %" PRIu32
+        " bulk handle(s) and bulk handle (%p)",
+        count, (void *) hg_bulk_local);
+
+    /* Do bulk transfers */
+    ret = hg_bulk_transfer_list(context->core_context, callback, arg, op,
+        hg_bulk_local, entries, count, op_id);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        bulk, error, ret, "Could not start transfer of bulk data list");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_atomic(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_atomic_op_t op, hg_addr_t origin_addr, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_uint64_t operand, hg_uint64_t compare,
+    hg_op_id_t *op_id)
+{
+    struct hg_bulk *hg_bulk_origin = (struct hg_bulk *) origin_handle;
+    struct hg_core_addr *hg_core_addr = (struct hg_core_addr *) origin_addr;
+    hg_uint8_t origin_id = 0;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        bulk, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        op != HG_BULK_ATOMIC_FETCH_ADD && op != HG_BULK_ATOMIC_CAS, error, ret,
+        HG_INVALID_ARG, "Unknown bulk atomic operation");
+
+    /* Origin handle sanity checks */
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_origin == NULL, error, ret,
+        HG_INVALID_ARG, "NULL origin handle passed");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        (origin_offset + sizeof(hg_uint64_t)) > hg_bulk_origin->desc.info.len,
+        error, ret, HG_INVALID_ARG,
+        "Exceeding size of memory exposed by origin handle (%" PRIu64
+        " + 8 > %" PRIu64 ")",
+        origin_offset, hg_bulk_origin->desc.info.len);
+    HG_CHECK_SUBSYS_ERROR(bulk, origin_offset % sizeof(hg_uint64_t) != 0,
+        error, ret, HG_INVALID_ARG,
+        "Origin offset (%" PRIu64 ") is not 8-byte aligned", origin_offset);
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        (hg_bulk_origin->desc.info.flags & HG_BULK_READWRITE) !=
+            HG_BULK_READWRITE,
+        error, ret, HG_PERMISSION,
+        "Invalid permission flags for atomic operation (origin=0x%x)",
+        hg_bulk_origin->desc.info.flags);
+
+    /* Use address information embedded into origin handle if any */
+    if (hg_bulk_origin->addr != HG_CORE_ADDR_NULL) {
+        hg_core_addr = hg_bulk_origin->addr;
+        origin_id = hg_bulk_origin->context_id;
+    }
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_core_addr == HG_CORE_ADDR_NULL, error, ret,
+        HG_INVALID_ARG, "NULL origin addr");
+
+    HG_LOG_SUBSYS_DEBUG(bulk, "Atomic operation on bulk handle (%p)",
+        (void *) hg_bulk_origin);
+
+    ret = hg_bulk_atomic(context->core_context, callback, arg, op,
+        hg_core_addr, origin_id, hg_bulk_origin, origin_offset, operand,
+        compare, op_id);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        bulk, error, ret, "Could not start atomic operation on bulk data");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Bulk_cancel(hg_op_id_t op_id)
@@ -2991,3 +7582,187 @@ HG_Bulk_cancel(hg_op_id_t op_id)
 error:
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_stream_create(hg_context_t *context, hg_addr_t origin_addr,
+    hg_uint8_t origin_id, hg_bulk_t origin_handle, hg_size_t origin_offset,
+    hg_size_t size, hg_size_t chunk_size, hg_uint32_t depth,
+    hg_bulk_stream_t *stream_p)
+{
+    struct hg_bulk *hg_bulk_origin = (struct hg_bulk *) origin_handle;
+    struct hg_bulk_stream *hg_bulk_stream = NULL;
+    struct hg_bulk_attr attrs = {
+        .mem_type = HG_MEM_TYPE_HOST, .device = 0, .file_backed = HG_FALSE};
+    hg_size_t buf_size, buf_access_size = 0;
+    void *buf = NULL;
+    hg_uint32_t buf_count = 0, i;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(
+        bulk, context == NULL, error, ret, HG_INVALID_ARG, "NULL HG context");
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_origin == NULL, error, ret,
+        HG_INVALID_ARG, "NULL origin handle passed");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        (origin_offset + size) > hg_bulk_origin->desc.info.len, error, ret,
+        HG_INVALID_ARG,
+        "Exceeding size of memory exposed by origin handle (%" PRIu64
+        " + %" PRIu64 " > %" PRIu64 ")",
+        origin_offset, size, hg_bulk_origin->desc.info.len);
+    HG_CHECK_SUBSYS_ERROR(bulk, chunk_size == 0 || depth == 0, error, ret,
+        HG_INVALID_ARG, "Invalid chunk size (%" PRIu64 ") or depth (%" PRIu32
+        ")", chunk_size, depth);
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        hg_bulk_origin->addr == HG_CORE_ADDR_NULL &&
+            origin_addr == HG_ADDR_NULL,
+        error, ret, HG_INVALID_ARG, "NULL origin addr");
+    HG_CHECK_SUBSYS_ERROR(bulk,
+        !(hg_bulk_origin->desc.info.flags & HG_BULK_READ_ONLY), error, ret,
+        HG_PERMISSION, "Origin handle is not readable");
+
+    hg_bulk_stream =
+        (struct hg_bulk_stream *) calloc(1, sizeof(*hg_bulk_stream));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_stream == NULL, error, ret, HG_NOMEM,
+        "Could not allocate stream");
+    hg_bulk_stream->context = context;
+    hg_bulk_stream->origin_addr = HG_CORE_ADDR_NULL;
+    hg_bulk_stream->origin_handle = HG_BULK_NULL;
+    hg_bulk_stream->local_handle = HG_BULK_NULL;
+    hg_bulk_stream->origin_offset = origin_offset;
+    hg_bulk_stream->size = size;
+    hg_bulk_stream->chunk_size = chunk_size;
+    hg_bulk_stream->depth = depth;
+    hg_bulk_stream->origin_id = origin_id;
+    hg_atomic_init32(&hg_bulk_stream->ref_count, 1);
+
+    hg_bulk_stream->slots = (struct hg_bulk_stream_slot *) calloc(
+        depth, sizeof(*hg_bulk_stream->slots));
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_stream->slots == NULL, error, ret,
+        HG_NOMEM, "Could not allocate stream slots");
+    for (i = 0; i < depth; i++) {
+        hg_bulk_stream->slots[i].stream = hg_bulk_stream;
+        hg_atomic_init32(&hg_bulk_stream->slots[i].status, HG_SUCCESS);
+    }
+
+    /* Keep references to origin while stream exists */
+    if (origin_addr != HG_ADDR_NULL) {
+        ret = HG_Core_addr_dup(
+            (hg_core_addr_t) origin_addr, &hg_bulk_stream->origin_addr);
+        HG_CHECK_SUBSYS_HG_ERROR(bulk, error, ret, "Could not dup origin addr");
+    }
+    ret = HG_Bulk_ref_incr(origin_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        bulk, error, ret, "Could not take reference to origin handle");
+    hg_bulk_stream->origin_handle = origin_handle;
+
+    /* Ring of local buffers, registered once */
+    buf_size = (hg_size_t) depth * chunk_size;
+    ret = hg_bulk_create(HG_Core_context_get_class(context->core_context), 1,
+        NULL, &buf_size, HG_BULK_WRITE_ONLY, &attrs,
+        (struct hg_bulk **) &hg_bulk_stream->local_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        bulk, error, ret, "Could not create handle of stream buffers");
+    ret = HG_Bulk_access(hg_bulk_stream->local_handle, 0, buf_size,
+        HG_BULK_WRITE_ONLY, 1, &buf, &buf_access_size, &buf_count);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        bulk, error, ret, "Could not access stream buffers");
+    hg_bulk_stream->buf = (char *) buf;
+
+    HG_LOG_SUBSYS_DEBUG(bulk,
+        "Created stream (%p) of %" PRIu64 " bytes from bulk handle (%p), "
+        "%" PRIu32 " chunk(s) of %" PRIu64 " bytes",
+        (void *) hg_bulk_stream, size, (void *) hg_bulk_origin, depth,
+        chunk_size);
+
+    /* Read ahead first chunks */
+    for (i = 0; i < depth && hg_bulk_stream->issued < size; i++)
+        hg_bulk_stream_issue(hg_bulk_stream);
+
+    *stream_p = (hg_bulk_stream_t) hg_bulk_stream;
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_bulk_stream != NULL)
+        hg_bulk_stream_free(hg_bulk_stream);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_stream_next_chunk(
+    hg_bulk_stream_t stream, void **buf_p, hg_size_t *size_p)
+{
+    struct hg_bulk_stream *hg_bulk_stream = (struct hg_bulk_stream *) stream;
+    struct hg_bulk_stream_slot *slot;
+    int32_t status;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(bulk, hg_bulk_stream == NULL, error, ret,
+        HG_INVALID_ARG, "NULL stream passed");
+
+    /* Recycle buffer of previous chunk to read ahead */
+    if (hg_bulk_stream->held) {
+        hg_bulk_stream->held = HG_FALSE;
+        if (hg_bulk_stream->issued < hg_bulk_stream->size)
+            hg_bulk_stream_issue(hg_bulk_stream);
+    }
+
+    if (hg_bulk_stream->consumed == hg_bulk_stream->size) {
+        *buf_p = NULL;
+        *size_p = 0;
+        return HG_SUCCESS;
+    }
+
+    slot = &hg_bulk_stream->slots[hg_bulk_stream->next_slot];
+    status = hg_atomic_get32(&slot->status);
+    if (status == HG_BULK_STREAM_PENDING)
+        return HG_AGAIN;
+    HG_CHECK_SUBSYS_ERROR(bulk, status != HG_SUCCESS, error, ret,
+        (hg_return_t) status,
+        "Could not pull chunk at offset %" PRIu64 " of stream (%p)",
+        hg_bulk_stream->consumed, (void *) hg_bulk_stream);
+
+    *buf_p = hg_bulk_stream->buf +
+             (hg_size_t) hg_bulk_stream->next_slot * hg_bulk_stream->chunk_size;
+    *size_p = slot->size;
+    hg_bulk_stream->consumed += slot->size;
+    hg_bulk_stream->next_slot =
+        (hg_bulk_stream->next_slot + 1) % hg_bulk_stream->depth;
+    hg_bulk_stream->held = HG_TRUE;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_stream_destroy(hg_bulk_stream_t stream)
+{
+    struct hg_bulk_stream *hg_bulk_stream = (struct hg_bulk_stream *) stream;
+    hg_uint32_t i;
+
+    if (hg_bulk_stream == NULL)
+        return HG_SUCCESS;
+
+    HG_LOG_SUBSYS_DEBUG(bulk, "Destroying stream (%p)", (void *) stream);
+
+    /* Callbacks of canceled transfers release remaining references */
+    for (i = 0; i < hg_bulk_stream->depth; i++) {
+        struct hg_bulk_stream_slot *slot = &hg_bulk_stream->slots[i];
+
+        if (hg_atomic_get32(&slot->status) == HG_BULK_STREAM_PENDING) {
+            hg_return_t ret = HG_Bulk_cancel(slot->op_id);
+            HG_CHECK_SUBSYS_WARNING(bulk, ret != HG_SUCCESS,
+                "Could not cancel transfer of stream (%p)", (void *) stream);
+        }
+    }
+
+    if (hg_atomic_decr32(&hg_bulk_stream->ref_count) == 0)
+        hg_bulk_stream_free(hg_bulk_stream);
+
+    return HG_SUCCESS;
+}
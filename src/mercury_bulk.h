@@ -14,6 +14,46 @@
 /* Public Type and Struct Definition */
 /*************************************/
 
+/* Region of an origin handle transferred by HG_Bulk_transfer_list() */
+struct hg_bulk_transfer_entry {
+    hg_addr_t origin_addr;   /* Address of origin (unless origin_handle is
+                                bound, see HG_Bulk_bind()) */
+    hg_bulk_t origin_handle; /* Origin bulk handle */
+    hg_size_t origin_offset; /* Offset within origin handle */
+    hg_size_t local_offset;  /* Offset within local handle */
+    hg_size_t size;          /* Size of data to be transferred */
+    hg_uint8_t origin_id;    /* Context ID of origin (unless bound) */
+};
+
+/* Max number of rails reported by transfer statistics */
+#define HG_BULK_STATS_RAIL_MAX (4)
+
+/* Statistics of a bulk transfer, filled once the transfer completes */
+struct hg_bulk_transfer_stats {
+    hg_size_t transferred;   /* Number of bytes transferred */
+    hg_size_t resume_offset; /* Bytes transferred from the start of the
+                                transfer without gap (i.e., offset to
+                                resume a partial transfer from) */
+    double elapsed;          /* Time from start to completion (s) */
+    struct {
+        hg_size_t transferred; /* Number of bytes transferred on rail */
+        double elapsed;        /* Time from start to completion (s) */
+    } rails[HG_BULK_STATS_RAIL_MAX]; /* Per-rail statistics */
+    hg_uint8_t rail_count;           /* Number of rails used */
+};
+
+/* Options of transfers started with HG_Bulk_transfer_opt() */
+struct hg_bulk_transfer_opt {
+    hg_bulk_chunk_cb_t chunk_callback;    /* Chunk callback (may be NULL) */
+    void *chunk_arg;                      /* Chunk callback argument */
+    struct hg_bulk_transfer_stats *stats; /* Returned stats (may be NULL) */
+    unsigned int timeout_ms;              /* Deadline from start (0 if none) */
+    hg_bool_t checksum;                   /* Return CRC32C of local data */
+};
+
+/* Streaming pull of an origin handle, see HG_Bulk_stream_create() */
+typedef struct hg_bulk_stream *hg_bulk_stream_t;
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -38,6 +78,8 @@ extern "C" {
  * \remark If NULL is passed to buf_ptrs, i.e.,
  * \verbatim HG_Bulk_create(count, NULL, buf_sizes, flags, &handle) \endverbatim
  * memory for the missing buf_ptrs array will be internally allocated.
+ * \remark Segments that are contiguous in memory are merged, the segment
+ * count returned by HG_Bulk_get_segment_count() may therefore be lower.
  *
  * \param hg_class [IN]         pointer to HG class
  * \param count [IN]            number of segments
@@ -61,6 +103,10 @@ HG_Bulk_create(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
  * \remark If NULL is passed to buf_ptrs, i.e.,
  * \verbatim HG_Bulk_create(count, NULL, buf_sizes, flags, &handle) \endverbatim
  * memory for the missing buf_ptrs array will be internally allocated.
+ * \remark When attrs->file_backed is set (e.g., for mmap'd files), memory is
+ * split in chunks of the bulk chunk size that are only registered when a
+ * transfer reaches them or when the handle is serialized, pages are read
+ * ahead of the chunks in flight.
  *
  * \param hg_class [IN]         pointer to HG class
  * \param count [IN]            number of segments
@@ -100,6 +146,23 @@ HG_Bulk_free(hg_bulk_t handle);
 HG_PUBLIC hg_return_t
 HG_Bulk_ref_incr(hg_bulk_t handle);
 
+/**
+ * Invalidate registrations of memory ranges that overlap [base, base + len)
+ * and that were cached when the bulk_reg_cache_max init option is set. This
+ * must be called before memory that was passed to HG_Bulk_create() is
+ * released (e.g., through free() or munmap()) so that a stale registration
+ * is never re-used if the same address range gets re-allocated. Bulk handles
+ * that are still using an invalidated registration remain valid until freed.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param base [IN]             base address of range
+ * \param len [IN]              length of range
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_cache_invalidate(hg_class_t *hg_class, void *base, hg_size_t len);
+
 /**
  * Bind an existing bulk handle to a local HG context and associate its local
  * address. This function can be used to forward and share a bulk handle
@@ -271,6 +334,33 @@ HG_Bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
     hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
     hg_size_t size, hg_op_id_t *op_id);
 
+/**
+ * Transfer data like HG_Bulk_transfer() and block until the transfer
+ * completes, see HG_Forward_wait() for how the calling thread waits. The
+ * transfer is canceled if it has not completed after timeout_ms, in which
+ * case HG_TIMEOUT is returned once it is released.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ * \param size [IN]             size of data to be transferred
+ * \param timeout_ms [IN]       timeout in ms
+ *
+ * \return HG_SUCCESS, return code of the transfer or corresponding HG error
+ * code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_wait(hg_context_t *context, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_bulk_t origin_handle, hg_size_t origin_offset,
+    hg_bulk_t local_handle, hg_size_t local_offset, hg_size_t size,
+    unsigned int timeout_ms);
+
 /**
  * Transfer data to/from origin using abstract bulk handles and implicit origin
  * information (embedded in the origin handle). After completion, user callback
@@ -326,6 +416,214 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
     hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
     hg_size_t local_offset, hg_size_t size, hg_op_id_t *op_id);
 
+/**
+ * Transfer data to/from origin in the same way as HG_Bulk_transfer_id(),
+ * reporting each chunk of data as soon as it has been transferred. Transfers
+ * are split into chunks of at most bulk_chunk_size bytes and no more than
+ * bulk_max_inflight NA operations are kept in flight, the remaining chunks
+ * being issued as previous ones complete (see hg_init_info). The chunk
+ * callback is executed from progress (or directly from this call when the
+ * transfer is local) with the offset of the chunk relative to the start of
+ * the transfer and its size, chunks completing in no particular order. The
+ * user callback is placed into the completion queue once all chunks have
+ * completed.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param chunk_callback [IN]   pointer to chunk callback (may be NULL)
+ * \param chunk_arg [IN]        pointer to data passed to chunk callback
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ * \param size [IN]             size of data to be transferred
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_pipelined(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_chunk_cb_t chunk_callback, void *chunk_arg, hg_bulk_op_t op,
+    hg_addr_t origin_addr, hg_uint8_t origin_id, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_bulk_t local_handle, hg_size_t local_offset,
+    hg_size_t size, hg_op_id_t *op_id);
+
+/**
+ * Transfer data to/from origin in the same way as HG_Bulk_transfer_pipelined()
+ * using the options passed. When a timeout is set, the transfer is canceled
+ * from progress once it is reached and the user callback then returns
+ * HG_TIMEOUT. When a stats struct is passed, it is filled once the transfer
+ * completes, before the user callback is placed into the completion queue;
+ * for transfers that did not complete successfully, resume_offset gives how
+ * much of the transfer can be skipped when issuing it again. Transfers that
+ * report stats are pipelined so that partial completion can be tracked.
+ * When checksum is set, the CRC32C of the local data transferred is returned
+ * in the checksum field of the callback info. Each chunk of the pipeline is
+ * checksummed as soon as it completes, while the next chunks are in flight,
+ * so that no extra pass over the data is needed; the result can be compared
+ * against a digest computed by the sender with hg_crc32c(). Checksums can
+ * only be computed on host memory.
+ *
+ * \remark Origin handles that were bound with HG_Bulk_bind() are transferred
+ * from the address and context ID embedded into them, origin_addr and
+ * origin_id are then ignored.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ * \param size [IN]             size of data to be transferred
+ * \param opt [IN]              pointer to transfer options (may be NULL)
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_opt(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
+    hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
+    hg_size_t local_offset, hg_size_t size,
+    const struct hg_bulk_transfer_opt *opt, hg_op_id_t *op_id);
+
+/**
+ * Transfer data between a list of origin regions, which may each belong to a
+ * different origin, and a single local handle. All transfers share a single
+ * operation ID and the user callback is placed into the completion queue only
+ * once all of them have completed, with the first error returned by any of
+ * them if any. The origin handle passed to the callback is HG_BULK_NULL and
+ * the size is the total size of data transferred. Cancelling the operation
+ * cancels all transfers of the list.
+ *
+ * \remark Origin handles that were bound with HG_Bulk_bind() are transferred
+ * from the address and context ID embedded into them, origin_addr and
+ * origin_id of the entry are then ignored.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param local_handle [IN]     abstract bulk handle
+ * \param entries [IN]          array of regions to transfer
+ * \param count [IN]            number of entries
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_transfer_list(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, hg_bulk_t local_handle,
+    const struct hg_bulk_transfer_entry *entries, hg_uint32_t count,
+    hg_op_id_t *op_id);
+
+/**
+ * Atomically update the 64-bit unsigned integer stored at origin_offset of
+ * the origin handle, without involving the origin in the operation. After
+ * completion, user callback is placed into a completion queue and can be
+ * triggered using HG_Trigger(), the value that was stored before the
+ * operation is returned in the result field of the bulk callback info (the
+ * local handle passed to the callback is HG_BULK_NULL).
+ *
+ * Origin memory must be exposed with HG_BULK_READWRITE and origin_offset must
+ * be 8-byte aligned. Operations are only atomic with respect to other
+ * HG_Bulk_atomic() calls and are not supported by all NA plugins
+ * (HG_NA_ERROR is returned in that case).
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param op [IN]               atomic operation:
+ *                                  - HG_BULK_ATOMIC_FETCH_ADD
+ *                                  - HG_BULK_ATOMIC_CAS
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param operand [IN]          value to add or to swap in
+ * \param compare [IN]          value to compare with (CAS only)
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_atomic(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_atomic_op_t op, hg_addr_t origin_addr, hg_bulk_t origin_handle,
+    hg_size_t origin_offset, hg_uint64_t operand, hg_uint64_t compare,
+    hg_op_id_t *op_id);
+
+/**
+ * Create a stream that pulls size bytes of an origin handle from
+ * origin_offset in chunks of chunk_size. A ring of depth local buffers,
+ * registered once, is allocated and transfers of the first depth chunks are
+ * started right away. Chunks are then returned in order by
+ * HG_Bulk_stream_next_chunk(), which recycles the buffer of the previous
+ * chunk to read ahead the next one, so that up to depth chunks are in flight
+ * or ready while the consumer paces the stream. Transfers complete through
+ * HG_Progress() and HG_Trigger() on context.
+ *
+ * \remark Origin handles that were bound with HG_Bulk_bind() are transferred
+ * from the address and context ID embedded into them, origin_addr and
+ * origin_id are then ignored.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param size [IN]             size of data to be streamed
+ * \param chunk_size [IN]       size of chunks
+ * \param depth [IN]            number of chunks kept in flight
+ * \param stream_p [OUT]        pointer to returned stream
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_stream_create(hg_context_t *context, hg_addr_t origin_addr,
+    hg_uint8_t origin_id, hg_bulk_t origin_handle, hg_size_t origin_offset,
+    hg_size_t size, hg_size_t chunk_size, hg_uint32_t depth,
+    hg_bulk_stream_t *stream_p);
+
+/**
+ * Get the next chunk of a stream. Data of the chunk remains valid until the
+ * next call, which releases its buffer. Once all data was returned, buf_p is
+ * set to NULL and size_p to 0.
+ *
+ * \param stream [IN]           stream
+ * \param buf_p [OUT]           pointer to returned chunk data
+ * \param size_p [OUT]          pointer to returned chunk size
+ *
+ * \return HG_SUCCESS, HG_AGAIN if the chunk has not arrived yet, or the
+ * error code of the transfer of that chunk
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_stream_next_chunk(
+    hg_bulk_stream_t stream, void **buf_p, hg_size_t *size_p);
+
+/**
+ * Destroy a stream. Transfers still in flight are canceled and resources are
+ * released once their callbacks have been triggered.
+ *
+ * \param stream [IN/OUT]       stream
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Bulk_stream_destroy(hg_bulk_stream_t stream);
+
 /**
  * Cancel an ongoing operation.
  *
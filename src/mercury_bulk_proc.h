@@ -9,6 +9,7 @@
 #define MERCURY_BULK_PROC_H
 
 #include "mercury_bulk.h"
+#include "mercury_core.h"
 
 /*************************************/
 /* Public Type and Struct Definition */
@@ -22,6 +23,9 @@
 #define HG_BULK_EAGER (1 << 2) /* embeds data along descriptor */
 #define HG_BULK_SM    (1 << 3) /* bulk transfer through shared-memory */
 
+/* Serialization flags that are not stored in handles */
+#define HG_BULK_SELF (1 << 8) /* serialized for a peer of the same process */
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -48,6 +52,14 @@ hg_bulk_get_serialize_cached_size(hg_bulk_t handle);
 HG_PRIVATE void
 hg_bulk_set_serialize_cached_ptr(hg_bulk_t handle, void *buf, size_t buf_size);
 
+/**
+ * Deserialize handle, eager data points into buf and pin_handle is kept until
+ * the bulk handle is freed (data is copied if pin_handle is NULL).
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_deserialize_pinned(hg_class_t *hg_class, hg_bulk_t *handle,
+    const void *buf, hg_size_t buf_size, hg_core_handle_t pin_handle);
+
 #ifdef __cplusplus
 }
 #endif
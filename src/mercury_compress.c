@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury.h"
+#include "mercury_error.h"
+
+#ifdef HG_HAS_LZ4
+#    include <lz4.h>
+#endif
+#ifdef HG_HAS_ZSTD
+#    include <zstd.h>
+#endif
+#ifdef HG_HAS_SNAPPY
+#    include <snappy-c.h>
+#endif
+
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Favor speed over ratio, payloads are compressed on the RPC path */
+#define HG_COMPRESS_ZSTD_LEVEL (1)
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+#ifdef HG_HAS_LZ4
+static hg_size_t
+hg_compress_lz4_bound(void *arg, hg_size_t size);
+static hg_return_t
+hg_compress_lz4(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t *dest_size);
+static hg_return_t
+hg_decompress_lz4(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t dest_size);
+#endif
+
+#ifdef HG_HAS_ZSTD
+static hg_size_t
+hg_compress_zstd_bound(void *arg, hg_size_t size);
+static hg_return_t
+hg_compress_zstd(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t *dest_size);
+static hg_return_t
+hg_decompress_zstd(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t dest_size);
+#endif
+
+#ifdef HG_HAS_SNAPPY
+static hg_size_t
+hg_compress_snappy_bound(void *arg, hg_size_t size);
+static hg_return_t
+hg_compress_snappy(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t *dest_size);
+static hg_return_t
+hg_decompress_snappy(void *arg, const void *src, hg_size_t src_size,
+    void *dest, hg_size_t dest_size);
+#endif
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Built-in compressors */
+static const struct hg_compressor hg_compressors_g[] = {
+#ifdef HG_HAS_LZ4
+    {.name = "lz4",
+        .id = HG_COMPRESSOR_LZ4,
+        .bound = hg_compress_lz4_bound,
+        .compress = hg_compress_lz4,
+        .decompress = hg_decompress_lz4,
+        .arg = NULL},
+#endif
+#ifdef HG_HAS_ZSTD
+    {.name = "zstd",
+        .id = HG_COMPRESSOR_ZSTD,
+        .bound = hg_compress_zstd_bound,
+        .compress = hg_compress_zstd,
+        .decompress = hg_decompress_zstd,
+        .arg = NULL},
+#endif
+#ifdef HG_HAS_SNAPPY
+    {.name = "snappy",
+        .id = HG_COMPRESSOR_SNAPPY,
+        .bound = hg_compress_snappy_bound,
+        .compress = hg_compress_snappy,
+        .decompress = hg_decompress_snappy,
+        .arg = NULL},
+#endif
+    {.name = NULL}};
+
+#ifdef HG_HAS_LZ4
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_compress_lz4_bound(void *arg, hg_size_t size)
+{
+    (void) arg;
+
+    /* LZ4 only processes int sizes, 0 means payload is not compressed */
+    if (size > LZ4_MAX_INPUT_SIZE)
+        return 0;
+
+    return (hg_size_t) LZ4_compressBound((int) size);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_compress_lz4(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t *dest_size)
+{
+    int rc;
+
+    (void) arg;
+
+    rc = LZ4_compress_default(
+        (const char *) src, (char *) dest, (int) src_size, (int) *dest_size);
+    if (rc <= 0)
+        return HG_OVERFLOW;
+    *dest_size = (hg_size_t) rc;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_decompress_lz4(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t dest_size)
+{
+    int rc;
+
+    (void) arg;
+
+    if (src_size > LZ4_MAX_INPUT_SIZE || dest_size > LZ4_MAX_INPUT_SIZE)
+        return HG_PROTOCOL_ERROR;
+
+    rc = LZ4_decompress_safe(
+        (const char *) src, (char *) dest, (int) src_size, (int) dest_size);
+    if (rc < 0 || (hg_size_t) rc != dest_size)
+        return HG_PROTOCOL_ERROR;
+
+    return HG_SUCCESS;
+}
+#endif
+
+#ifdef HG_HAS_ZSTD
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_compress_zstd_bound(void *arg, hg_size_t size)
+{
+    (void) arg;
+
+    return (hg_size_t) ZSTD_compressBound((size_t) size);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_compress_zstd(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t *dest_size)
+{
+    size_t rc;
+
+    (void) arg;
+
+    rc = ZSTD_compress(dest, (size_t) *dest_size, src, (size_t) src_size,
+        HG_COMPRESS_ZSTD_LEVEL);
+    if (ZSTD_isError(rc))
+        return HG_OVERFLOW;
+    *dest_size = (hg_size_t) rc;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_decompress_zstd(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t dest_size)
+{
+    size_t rc;
+
+    (void) arg;
+
+    rc = ZSTD_decompress(dest, (size_t) dest_size, src, (size_t) src_size);
+    if (ZSTD_isError(rc) || rc != dest_size)
+        return HG_PROTOCOL_ERROR;
+
+    return HG_SUCCESS;
+}
+#endif
+
+#ifdef HG_HAS_SNAPPY
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_compress_snappy_bound(void *arg, hg_size_t size)
+{
+    (void) arg;
+
+    return (hg_size_t) snappy_max_compressed_length((size_t) size);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_compress_snappy(void *arg, const void *src, hg_size_t src_size, void *dest,
+    hg_size_t *dest_size)
+{
+    size_t compressed_length = (size_t) *dest_size;
+
+    (void) arg;
+
+    if (snappy_compress((const char *) src, (size_t) src_size, (char *) dest,
+            &compressed_length) != SNAPPY_OK)
+        return HG_OVERFLOW;
+    *dest_size = (hg_size_t) compressed_length;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_decompress_snappy(void *arg, const void *src, hg_size_t src_size,
+    void *dest, hg_size_t dest_size)
+{
+    size_t uncompressed_length = (size_t) dest_size;
+
+    (void) arg;
+
+    if (snappy_uncompress((const char *) src, (size_t) src_size, (char *) dest,
+            &uncompressed_length) != SNAPPY_OK ||
+        uncompressed_length != dest_size)
+        return HG_PROTOCOL_ERROR;
+
+    return HG_SUCCESS;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+const struct hg_compressor *
+HG_Compressor_get(const char *name)
+{
+    const struct hg_compressor *compressor;
+
+    HG_CHECK_ERROR_NORET(name == NULL, error, "NULL compressor name");
+
+    for (compressor = hg_compressors_g; compressor->name != NULL; compressor++)
+        if (strcmp(compressor->name, name) == 0)
+            return compressor;
+
+    HG_LOG_WARNING("Compressor %s was not built", name);
+
+error:
+    return NULL;
+}
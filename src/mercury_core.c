@@ -9,11 +9,15 @@
 #include "mercury_private.h"
 
 #include "mercury_atomic_queue.h"
+#include "mercury_atomic_seg_queue.h"
 #include "mercury_error.h"
 #include "mercury_event.h"
+#include "mercury_hash_string.h"
 #include "mercury_hash_table.h"
+#include "mercury_inet.h"
 #include "mercury_list.h"
 #include "mercury_mem.h"
+#include "mercury_mem_pool.h"
 #include "mercury_param.h"
 #include "mercury_poll.h"
 #include "mercury_queue.h"
@@ -28,6 +32,7 @@
 #    include <na_sm.h>
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -36,18 +41,44 @@
 /****************/
 
 /* Private flags */
-#define HG_CORE_SELF_FORWARD (1 << 3) /* Forward to self */
+#define HG_CORE_STREAM              (1 << 2) /* Streamed (partial) response */
+#define HG_CORE_SELF_FORWARD        (1 << 3) /* Forward to self */
+#define HG_CORE_COALESCED           (1 << 4) /* Packs several requests */
+#define HG_CORE_UNEXPECTED_RESPONSE (1 << 5) /* Unexpected response */
+#define HG_CORE_TRACE               (1 << 6) /* Trace context after payload */
+#define HG_CORE_RELEASE             (1 << 7) /* Releases an output lease */
+
+/* Call trace callback if tracing is enabled */
+#define HG_CORE_TRACE_EVENT(hg_core_handle, event)                             \
+    do {                                                                       \
+        if (unlikely(                                                          \
+                HG_CORE_HANDLE_CLASS(hg_core_handle)->trace_cb.callback))      \
+            hg_core_trace(hg_core_handle, event);                              \
+    } while (0)
 
-/* Size of comletion queue used for holding completed requests */
+/* Size of completion queue segments used for holding completed requests */
 #define HG_CORE_ATOMIC_QUEUE_SIZE (1024)
 
+/* Segment size of high priority completion queue */
+#define HG_CORE_ATOMIC_QUEUE_HIGH_SIZE (64)
+
 /* Pre-posted requests and op IDs */
 #define HG_CORE_POST_INIT          (512)
 #define HG_CORE_POST_INCR          (512)
 #define HG_CORE_BULK_OP_INIT_COUNT (256)
 
+/* Requests that pools keep posted outside of the shared budget and max number
+ * of requests a pool gives back at once */
+#define HG_CORE_POST_SHARED_MIN     (16)
+#define HG_CORE_POST_RECLAIM_MAX    (64)
+
 /* Number of multi-recv buffer pre-posted */
-#define HG_CORE_MULTI_RECV_OP_MAX (4)
+#define HG_CORE_MULTI_RECV_OP_INIT (4)
+
+/* Max number of multi-recv buffers and buffer growth factor when buffers are
+ * auto-tuned */
+#define HG_CORE_MULTI_RECV_OP_MAX   (16)
+#define HG_CORE_MULTI_RECV_SIZE_MAX (8)
 
 /* Timeout on finalize */
 #define HG_CORE_CLEANUP_TIMEOUT (5000)
@@ -56,9 +87,91 @@
 #define HG_CORE_MAX_EVENTS        (1)
 #define HG_CORE_MAX_TRIGGER_COUNT (1)
 
+/* Max number of NA progress calls made to drain an edge-triggered fd */
+#define HG_CORE_POLL_DRAIN_MAX (64)
+
+/* Max number of contexts progressed at once (size of ready mask) */
+#define HG_CORE_PROGRESS_MULTI_MAX (64)
+
+/* Min number of slots in RPC map snapshot */
+#define HG_CORE_MAP_SNAPSHOT_MIN (64)
+
+/* Default min size of bulk transfers that are striped across rails */
+#define HG_CORE_RAIL_MIN_SIZE_DEFAULT (64 * 1024)
+
+/* Min size of lock-free queue of free handles used with multi-recv */
+#define HG_CORE_HANDLE_POOL_QUEUE_MIN (1024)
+
+/* Max number of completion entries popped at once when triggering */
+#define HG_CORE_TRIGGER_BATCH_SIZE (64)
+
+/* Profile 1 out of N progress and trigger calls */
+#define HG_CORE_PROFILE_SAMPLE_RATE (16)
+
+/* Timer wheel of forward deadlines, slots cover a full revolution of
+ * HG_CORE_TIMER_WHEEL_SIZE * HG_CORE_TIMER_TICK_MS ms */
+#define HG_CORE_TIMER_WHEEL_SIZE (256)
+#define HG_CORE_TIMER_TICK_MS    (8)
+
+/* Weight of new samples in average wait of received requests (1/2^N) */
+#define HG_CORE_ADMISSION_WAIT_SHIFT (3)
+
+/* Time accumulator of a sampled progress call, NULL if not sampled */
+#define HG_CORE_PROFILE(context, sampled, field)                               \
+    ((sampled) ? &(context)->profile.field : NULL)
+
+/* Coalesced requests are stored as size / tag / request records, records are
+ * aligned so that each request can be decoded in place */
+#define HG_CORE_COALESCE_RECORD_HEADER_SIZE (2 * sizeof(hg_uint32_t))
+#define HG_CORE_COALESCE_RECORD_ALIGN       (8)
+#define HG_CORE_COALESCE_BATCH_MAX          (64)
+#define HG_CORE_COALESCE_PEER_MAX           (64) /* Power of 2 */
+#define HG_CORE_COALESCE_ALIGN(x)                                              \
+    (((x) + HG_CORE_COALESCE_RECORD_ALIGN - 1) &                               \
+        ~((size_t) HG_CORE_COALESCE_RECORD_ALIGN - 1))
+
+/* Max number of responses posted together by HG_Core_respond_batch() */
+#define HG_CORE_RESPOND_BATCH_MAX (64)
+
+/* Tag bit of responses sent as unexpected messages, request tags never use
+ * it, and max number of slots of the response table */
+#define HG_CORE_RESPONSE_TAG       ((na_tag_t) 1 << 31)
+#define HG_CORE_RESPONSE_TABLE_MAX (1 << 20)
+
+/* Max number of partial responses in flight, credits are sent after the
+ * request payload as a single byte */
+#define HG_CORE_STREAM_CREDITS_MAX (UINT8_MAX)
+
+/* Max number of credit messages in flight, the origin returns credits in
+ * batches of half the credits */
+#define HG_CORE_STREAM_CREDIT_SLOTS (2)
+
+/* Number of tags tried when the response table slot of a tag is in use */
+#define HG_CORE_RESPONSE_TABLE_PROBES (4)
+
+/* Number of request tags a context reserves at once from the class */
+#define HG_CORE_REQUEST_TAG_BLOCK (256)
+
+/* Number of addrs whose reference is cached per context */
+#define HG_CORE_ADDR_REF_SLOTS (16)
+
+/* Time an origin holds back the ack of extra output data so that the next
+ * request to the same target can carry it instead */
+#define HG_CORE_LEASE_ACK_DELAY_MS (4)
+
 /* 32-bit lock value for serial progress */
 #define HG_CORE_PROGRESS_LOCK (0x80000000)
 
+/* Loopback notify states, progress is blocked / event has been signaled */
+#define HG_CORE_LOOPBACK_WAITING  (1 << 0)
+#define HG_CORE_LOOPBACK_SIGNALED (1 << 1)
+
+/* Addr book format ("HGAB"), a header is followed by the protocol name
+ * shared by all entries and by the entries themselves */
+#define HG_CORE_ADDR_BOOK_MAGIC   (0x48474142)
+#define HG_CORE_ADDR_BOOK_VERSION (1)
+#define HG_CORE_ADDR_BOOK_SM      (1 << 0) /* Entries carry NA SM addrs */
+
 #ifdef NA_HAS_SM
 /* Addr string format */
 #    define HG_CORE_ADDR_MAX_SIZE      (256)
@@ -121,6 +234,16 @@
 #define HG_CORE_HANDLE_CONTEXT(handle)                                         \
     ((struct hg_core_private_context *) (handle->core_handle.info.context))
 
+#define HG_CORE_HANDLE_PRIO_HIGH(handle)                                       \
+    ((handle)->core_handle.rpc_info != NULL &&                                 \
+        ((struct hg_core_private_rpc_info *) (handle)->core_handle.rpc_info)   \
+                ->prio == HG_PRIO_HIGH)
+
+#define HG_CORE_HANDLE_NO_COALESCE(handle)                                     \
+    ((handle)->core_handle.rpc_info != NULL &&                                 \
+        ((struct hg_core_private_rpc_info *) (handle)->core_handle.rpc_info)   \
+            ->no_coalesce)
+
 #define HG_CORE_ADDR_CLASS(addr)                                               \
     ((struct hg_core_private_class *) (addr->core_addr.core_class))
 
@@ -143,12 +266,82 @@ struct hg_core_init_info {
     hg_bool_t na_ext_init;              /* NA externally initialized */
     hg_bool_t multi_recv;               /* Use multi-recv capability */
     hg_bool_t listen;                   /* Listening on incoming RPC requests */
+    hg_uint32_t completion_queue_shards; /* Number of completion queues */
+    hg_uint32_t progress_spin_max;       /* Max progress spin time (us) */
+    hg_uint32_t request_coalesce_max;    /* Max requests per message */
+    hg_uint32_t request_coalesce_delay;  /* Max coalescing delay (us) */
+    hg_bool_t request_coalesce_adaptive; /* Window sized by arrival rate */
+    hg_size_t bulk_chunk_size;           /* Max size of bulk NA ops */
+    hg_uint32_t bulk_max_inflight;       /* Max bulk NA ops in flight */
+    hg_size_t multi_recv_mem_max;        /* Max multi-recv memory */
+    hg_bool_t bulk_lazy_register;        /* Defer bulk NA registration */
+    hg_size_t bulk_max_inflight_size;    /* Max bulk bytes in flight */
+    hg_uint32_t request_post_max;        /* Max posted requests per pool */
+    hg_uint32_t admission_queue_max;     /* Max requests waiting for cb */
+    hg_uint32_t admission_delay_max;     /* Max average wait for cb (us) */
+    hg_uint32_t request_post_seed;       /* Requests posted lazily at first */
+    hg_uint32_t request_post_shared;     /* Requests posted across contexts */
+    hg_size_t mem_max;                   /* Max memory of class */
+    hg_bool_t single_thread;             /* Class used by a single thread */
+    hg_uint32_t peer_stats_max;          /* Max peers counted per context */
+    hg_bool_t poll_edge_triggered;       /* Edge-triggered poll set */
+};
+
+/* Budget of requests posted across contexts */
+struct hg_core_post_shared {
+    hg_atomic_int32_t count;  /* Requests drawn from budget */
+    hg_atomic_int32_t demand; /* Contexts waiting on budget */
+};
+
+/* RPC map snapshot entry */
+struct hg_core_map_slot {
+    hg_id_t id;                        /* RPC ID */
+    struct hg_core_rpc_info *rpc_info; /* RPC info (NULL if empty) */
+};
+
+/* Immutable open-addressed copy of the RPC map used for lookups */
+struct hg_core_map_snapshot {
+    struct hg_core_map_snapshot *next; /* Next retired snapshot */
+    unsigned int mask;                 /* Number of slots - 1 */
+    struct hg_core_map_slot slots[];   /* Slots */
 };
 
 /* RPC map */
 struct hg_core_map {
-    hg_thread_rwlock_t lock; /* Map RW lock */
-    hg_hash_table_t *map;    /* Map */
+    hg_thread_rwlock_t lock;              /* Map RW lock (updates only) */
+    hg_hash_table_t *map;                 /* Map */
+    hg_atomic_int64_t snapshot;           /* Published snapshot */
+    struct hg_core_map_snapshot *retired; /* Snapshots lookups may still use */
+
+    /* Written by each lookup */
+    HG_MEM_FIELD_ALIGNED(hg_atomic_int32_t readers); /* Lookups in progress */
+};
+
+#ifdef NA_HAS_SM
+/* Addr lookup cache (keyed on lookup string) */
+struct hg_core_addr_cache {
+    hg_thread_mutex_t lock; /* Cache lock */
+    hg_hash_table_t *map;   /* Map (NULL if disabled) */
+};
+#endif
+
+/* Addr book header */
+struct hg_core_addr_book_hdr {
+    hg_uint32_t magic;      /* Book magic */
+    hg_uint8_t version;     /* Book version */
+    hg_uint8_t flags;       /* Book flags */
+    hg_uint16_t proto_len;  /* Length of protocol name */
+    hg_uint32_t count;      /* Number of entries */
+    hg_uint32_t na_size;    /* NA addr size (0 if encoded per entry) */
+    hg_uint32_t na_sm_size; /* NA SM addr size (0 if encoded per entry) */
+};
+
+/* NA class / addr resolved by a lookup */
+struct hg_core_addr_lookup_target {
+    na_class_t **na_class_p;           /* NA class used for lookup */
+    na_addr_t **na_addr_p;             /* NA addr to resolve */
+    size_t *na_addr_serialize_size_p; /* Cached serialize size */
+    const char *name_str;              /* NA part of lookup name */
 };
 
 /* More data callbacks */
@@ -158,6 +351,38 @@ struct hg_core_more_data_cb {
     void (*release)(hg_core_handle_t);                         /* release */
 };
 
+/* Trace callback info */
+struct hg_core_trace_cb {
+    hg_core_trace_cb_t callback; /* Callback */
+    void *arg;                   /* Callback args */
+};
+
+/* RPC capture, records are appended to file as requests are completed */
+struct hg_core_capture {
+    FILE *file;              /* Capture file (NULL if disabled) */
+    hg_uint64_t start;       /* Cycles at capture start */
+    hg_thread_mutex_t mutex; /* File lock */
+};
+
+/* Peer reported as unreachable by NA, purged from progress */
+struct hg_core_dead_peer {
+    HG_QUEUE_ENTRY(hg_core_dead_peer) entry; /* Entry in queue */
+    na_class_t *na_class;                    /* NA class of peer */
+    na_addr_t *na_addr;                      /* NA addr of peer */
+    hg_return_t ret;                         /* Error reported by NA */
+};
+
+/* Peer failure handling */
+struct hg_core_peer_errors {
+    HG_QUEUE_HEAD(hg_core_dead_peer) queue;         /* Dead peers to purge */
+    HG_LIST_HEAD(hg_core_private_context) contexts; /* Contexts of class */
+    hg_core_peer_error_cb_t callback;               /* User callback */
+    void *arg;                                      /* User callback args */
+    hg_thread_spin_t lock;                          /* Dead peer queue lock */
+    hg_thread_mutex_t mutex;                        /* Context list lock */
+    hg_atomic_int32_t count;                        /* Dead peers queued */
+};
+
 /* Diag counters */
 struct hg_core_counters {
     hg_atomic_int64_t *rpc_req_sent_count;   /* RPC requests sent */
@@ -169,46 +394,144 @@ struct hg_core_counters {
     hg_atomic_int64_t *bulk_count;           /* Bulk count */
 };
 
+/* Histogram updated concurrently, number of samples is the sum of buckets */
+struct hg_core_histogram {
+    hg_atomic_int64_t sum;                            /* Sum of samples */
+    hg_atomic_int64_t max;                            /* Largest sample */
+    hg_atomic_int64_t buckets[HG_STATS_BUCKET_COUNT]; /* Samples per bucket */
+};
+
+/* RPC info */
+struct hg_core_private_rpc_info {
+    struct hg_core_rpc_info rpc_info;    /* Must remain as first field */
+    struct hg_core_histogram latency;    /* Forward to completion */
+    struct hg_core_histogram handler;    /* RPC callback to respond */
+    struct hg_core_histogram queue_wait; /* Wait in completion queue */
+    struct hg_core_histogram payload;    /* Payload of messages sent */
+    unsigned int timeout_ms;             /* Default forward timeout */
+    hg_bool_t bypass_admission;          /* Never rejected when overloaded */
+    hg_bool_t no_coalesce;               /* Never held back for coalescing */
+    hg_prio_t prio;                      /* Priority class */
+};
+
 /* HG class */
 struct hg_core_private_class {
     struct hg_core_class core_class;    /* Must remain as first field */
     struct hg_core_init_info init_info; /* Saved init info */
 #ifdef NA_HAS_SM
-    na_sm_id_t host_id; /* Host ID for local identification */
+    na_sm_id_t host_id;                   /* Host ID for local identification */
+    struct hg_core_addr_cache addr_cache; /* Addr lookup cache */
 #endif
     struct hg_core_map rpc_map;               /* RPC Map */
     struct hg_core_more_data_cb more_data_cb; /* More data callbacks */
+    struct hg_core_trace_cb trace_cb;         /* Trace callback */
+    struct hg_core_capture capture;           /* RPC capture */
+    struct hg_core_peer_errors peer_errors;   /* Peer failure handling */
+    struct hg_bulk_reg_cache *bulk_reg_cache; /* Bulk registration cache */
+    struct hg_bulk_desc_cache *bulk_desc_cache; /* Bulk descriptor cache */
+    struct hg_bulk_dereg_queue *bulk_dereg_queue; /* Deferred deregistrations */
+    struct hg_core_rails rails;               /* NA classes used for bulk */
+    hg_atomic_int64_t *response_table;        /* Pending unexpected responses */
+    na_tag_t response_table_mask;             /* Response table size - 1 */
     na_tag_t request_max_tag;                 /* Max value for tag */
 #if defined(HG_HAS_DEBUG) && !defined(_WIN32)
     struct hg_core_counters counters; /* Diag counters */
 #endif
-    hg_atomic_int32_t n_contexts;  /* Total number of contexts */
-    hg_atomic_int32_t n_addrs;     /* Total number of addrs */
-    hg_atomic_int32_t n_bulks;     /* Total number of bulk handles */
-    hg_atomic_int32_t request_tag; /* Current global RPC tag */
+    hg_atomic_int32_t n_contexts; /* Total number of contexts */
+
+    /* Written when contexts reserve a new block of request tags */
+    HG_MEM_CACHE_ALIGNED(hg_atomic_int32_t request_block); /* Tag block */
+
+    /* Written when creating/freeing addrs, bulks and pool resources */
+    HG_MEM_CACHE_ALIGNED(hg_atomic_int32_t n_addrs); /* Number of addrs */
+    HG_MEM_FIELD_ALIGNED(hg_atomic_int32_t n_bulks); /* Number of bulks */
+    HG_MEM_FIELD_ALIGNED(struct hg_core_post_shared post_shared); /* Budget */
+    HG_MEM_FIELD_ALIGNED(struct hg_mem_budget mem_budget); /* Memory budget */
 };
 
+HG_MEM_CACHE_LINE_CHECK(struct hg_core_private_class, request_block, n_addrs);
+HG_MEM_CACHE_LINE_CHECK(
+    struct hg_core_private_class, request_block, request_max_tag);
+
 /* Poll type */
 typedef enum hg_core_poll_type {
     HG_CORE_POLL_LOOPBACK = 1,
 #ifdef NA_HAS_SM
     HG_CORE_POLL_SM,
 #endif
-    HG_CORE_POLL_NA
+    HG_CORE_POLL_NA,
+    HG_CORE_POLL_RAIL /* Followed by index of additional rails */
 } hg_core_poll_type_t;
 
-/* Completion queue */
-struct hg_core_completion_queue {
-    HG_QUEUE_HEAD(hg_completion_entry) queue; /* Completion queue */
-    hg_thread_cond_t cond;                    /* Completion queue cond */
-    hg_thread_mutex_t mutex;                  /* Completion queue mutex */
-    hg_atomic_int32_t count;                  /* Number of entries */
+/* Completion wait (wakes up threads waiting in trigger) */
+struct hg_core_completion_wait {
+    hg_thread_cond_t cond;     /* Completion wait cond */
+    hg_thread_mutex_t mutex;   /* Completion wait mutex */
+    hg_atomic_int32_t waiters; /* Number of threads waiting in trigger */
 };
 
 /* List of handles */
 struct hg_core_handle_list {
     HG_LIST_HEAD(hg_core_private_handle) list; /* Handle list */
     hg_thread_spin_t lock;                     /* Handle list lock */
+    hg_bool_t single_thread;                   /* Lock is elided */
+};
+
+/* Addr reference shared by the handles of a context */
+struct hg_core_addr_ref {
+    struct hg_core_private_addr *addr; /* Addr (one reference held) */
+    unsigned int count;                /* Handles using that reference */
+};
+
+/* Per-context cache of addr references, handles targeting the same addr
+ * count on the context instead of the addr refcount shared by all contexts.
+ * The reference is released once the last of these handles is destroyed so
+ * that freed addrs do not outlive their users. */
+struct hg_core_addr_refs {
+    struct hg_core_addr_ref slots[HG_CORE_ADDR_REF_SLOTS]; /* Cached refs */
+    hg_thread_spin_t lock;                                 /* Slots lock */
+};
+
+/* Traffic counters of a peer */
+struct hg_core_peer_entry {
+    na_class_t *na_class;       /* NA class of addr */
+    na_addr_t *na_addr;         /* NA addr (NULL if empty, reference held) */
+    struct hg_peer_stats stats; /* Counters */
+};
+
+/* Per-context open-addressed table of peer counters, keyed on NA addr */
+struct hg_core_peer_table {
+    struct hg_core_peer_entry *entries; /* Entries (NULL if disabled) */
+    unsigned int mask;                  /* Number of entries - 1 */
+    unsigned int count;                 /* Number of peers counted */
+    unsigned int max;                   /* Max number of peers counted */
+    hg_thread_spin_t lock;              /* Table lock */
+};
+
+/* Ack of extra output data that the origin holds back (output lease) */
+struct hg_core_lease {
+    HG_LIST_ENTRY(hg_core_lease) entry;      /* Deferred list entry */
+    struct hg_core_private_context *context; /* Context */
+    struct hg_core_private_addr *addr;       /* Target addr (reference held) */
+    struct hg_core_ack *ack;                 /* Ack resources (if sent) */
+    na_class_t *na_class;                    /* NA class */
+    na_context_t *na_context;                /* NA context */
+    na_addr_t *na_addr;                      /* Target NA addr */
+    hg_time_t deadline;                      /* Explicit ack deadline */
+    size_t ack_size;                         /* Size of ack message */
+    na_tag_t tag;                            /* Tag of leased response */
+    hg_uint8_t context_id;                   /* Target context ID */
+};
+
+/* Output leases, targets keep the extra output data of a response until the
+ * origin releases it, either with its next request to the same target or with
+ * an explicit ack once the ack delay expires */
+struct hg_core_leases {
+    HG_LIST_HEAD(hg_core_ack) granted;     /* Leases granted by target */
+    HG_LIST_HEAD(hg_core_lease) deferred;  /* Acks held back by origin */
+    hg_thread_spin_t lock;                 /* Lists lock */
+    hg_atomic_int32_t deferred_count;      /* Number of acks held back */
+    hg_atomic_int32_t ack_count;           /* Explicit acks being sent */
 };
 
 /* Handle create callback info */
@@ -219,9 +542,8 @@ struct hg_core_handle_create_cb {
 
 /* Loopback notifications */
 struct hg_core_loopback_notify {
-    hg_thread_mutex_t mutex;       /* Notify mutex */
-    hg_atomic_int32_t must_notify; /* Will notify if set */
-    int event;                     /* Loopback event */
+    hg_atomic_int32_t state; /* Wait word (HG_CORE_LOOPBACK_*) */
+    int event;               /* Loopback event */
 };
 
 /* Multi-recv buffer context */
@@ -234,6 +556,7 @@ struct hg_core_multi_recv_op {
     hg_atomic_int32_t last;      /* Buffer is consumed */
     hg_atomic_int32_t ref_count; /* Number of handles using that buffer */
     hg_atomic_int32_t op_count;  /* Total number of ops completed */
+    hg_atomic_int32_t pressure;  /* Consumed while others were running low */
 };
 
 /* Pool of handles */
@@ -245,11 +568,114 @@ struct hg_core_handle_pool {
     na_class_t *na_class;                    /* NA class */
     na_context_t *na_context;                /* NA context */
     struct hg_core_handle_list pending_list; /* Pending handle list */
+    struct hg_atomic_queue *free_queue;      /* Free handles (multi-recv) */
+    hg_atomic_int32_t available;             /* Number of available handles */
+    hg_atomic_int32_t extend_pending;        /* Extend pool from progress */
     unsigned int count;                      /* Number of handles */
     unsigned int incr_count;                 /* Incremement count */
+    unsigned int target_count;               /* Count reached lazily */
+    unsigned int low_watermark;              /* Extend when below that count */
+    unsigned int max_count;                  /* Soft cap (0 if none) */
+    unsigned int shared_count;               /* Drawn from shared budget */
+    unsigned int mem_count;                  /* Charged to memory budget */
+    unsigned long extend_count;              /* Number of extensions */
+    unsigned long extend_wait_count;         /* Number of extension waits */
+    hg_uint64_t extend_wait_time;            /* Time waiting on extension */
+    hg_atomic_int32_t cap_count;             /* Ran out of handles at cap */
+    hg_atomic_int32_t starved;               /* Waiting on shared budget */
+    hg_atomic_int32_t reclaim_count;         /* Handles given back */
     hg_bool_t extending;                     /* When extending the pool */
 };
 
+/* Adaptive spin before blocking in progress */
+struct hg_core_spin_policy {
+    hg_atomic_int32_t budget;   /* Current spin budget (us) */
+    hg_atomic_int32_t wait_avg; /* Moving average of wait times (us) */
+    unsigned int max;           /* Max spin budget (us) */
+};
+
+/* Sampled profile of progress and trigger calls (times in ns) */
+struct hg_core_progress_profile {
+    hg_atomic_int64_t progress_count;    /* Number of progress calls */
+    hg_atomic_int64_t progress_samples;  /* Sampled progress calls */
+    hg_atomic_int64_t trigger_count;     /* Number of trigger calls */
+    hg_atomic_int64_t trigger_samples;   /* Sampled trigger calls */
+    hg_atomic_int64_t progress_time;     /* Time in progress */
+    hg_atomic_int64_t poll_wait_time;    /* Time blocked in poll */
+    hg_atomic_int64_t na_time;           /* Time in NA progress */
+    hg_atomic_int64_t na_sm_time;        /* Time in NA SM progress */
+    hg_atomic_int64_t trigger_time;      /* Time in trigger */
+    hg_atomic_int64_t trigger_wait_time; /* Time waiting in trigger */
+    hg_atomic_int64_t callback_time;     /* Time in callbacks */
+};
+
+/* Message packing several requests to the same target */
+struct hg_core_coalesce_msg {
+    HG_LIST_ENTRY(hg_core_coalesce_msg) entry; /* Pending/free list entry */
+    struct hg_core_private_context *context;   /* Context */
+    struct hg_core_private_handle **handles;   /* Packed handles */
+    na_class_t *na_class;                      /* NA class */
+    na_context_t *na_context;                  /* NA context */
+    na_addr_t *na_addr;                        /* Target NA addr */
+    na_op_id_t *op_id;                         /* NA operation ID */
+    void *buf;                                 /* Message buffer */
+    void *plugin_data;                         /* NA plugin data */
+    size_t buf_size;                           /* Message buffer size */
+    size_t buf_used;                           /* Amount of buffer used */
+    hg_time_t deadline;                        /* Flush deadline */
+    unsigned int count;                        /* Number of packed handles */
+    hg_uint8_t context_id;                     /* Target context ID */
+};
+
+/* Arrivals of requests to a target, used to size its coalescing window */
+struct hg_core_coalesce_peer {
+    na_addr_t *na_addr; /* Target NA addr (NULL if unused) */
+    hg_time_t last;     /* Time of last request */
+    double gap_avg;     /* Average time between requests (s) */
+};
+
+/* Sends of responses collected by HG_Core_respond_batch(), along with the
+ * NA class and context that each of them is posted to */
+struct hg_core_respond_batch {
+    struct na_msg_send_info send_infos[HG_CORE_RESPOND_BATCH_MAX];
+    na_class_t *na_classes[HG_CORE_RESPOND_BATCH_MAX];
+    na_context_t *na_contexts[HG_CORE_RESPOND_BATCH_MAX];
+    unsigned int count;
+};
+
+/* Request coalescing */
+struct hg_core_coalesce {
+    HG_LIST_HEAD(hg_core_coalesce_msg) pending_list; /* Messages being filled */
+    HG_LIST_HEAD(hg_core_coalesce_msg) free_list;    /* Messages to re-use */
+    struct hg_core_coalesce_peer *peers; /* Arrivals (if adaptive) */
+    hg_thread_mutex_t mutex;             /* Lists mutex */
+    hg_atomic_int32_t pending_count;     /* Pending messages */
+    unsigned int max;                    /* Max requests per msg */
+    unsigned int delay;                  /* Max flush delay (us) */
+};
+
+/* Admission control of received requests */
+struct hg_core_admission {
+    hg_atomic_int64_t wait_avg;   /* Average wait for callback (cycles) */
+    hg_atomic_int64_t shed_count; /* Number of requests rejected */
+    hg_atomic_int32_t queued;     /* Requests waiting for their callback */
+    hg_uint64_t wait_max;         /* Max average wait (cycles, 0 if none) */
+    hg_uint32_t queue_max;        /* Max waiting requests (0 if none) */
+};
+
+/* Forward deadlines, handles are hashed into slots by deadline tick and only
+ * slots between the last tick processed and now are visited */
+struct hg_core_timer_wheel {
+    HG_LIST_HEAD(hg_core_private_handle)
+    slots[HG_CORE_TIMER_WHEEL_SIZE]; /* Handles per tick */
+    hg_time_t start;                 /* Time of tick 0 */
+    hg_time_t next;                  /* Earliest deadline (if next_valid) */
+    hg_uint64_t tick;                /* Last tick processed */
+    hg_thread_spin_t lock;           /* Slots lock */
+    hg_atomic_int32_t count;         /* Number of handles in wheel */
+    hg_bool_t next_valid;            /* Earliest deadline is known */
+};
+
 #ifdef HG_HAS_MULTI_PROGRESS
 /* Ensure thread safety when progressing context from multiple threads */
 struct hg_core_progress_multi {
@@ -265,36 +691,60 @@ struct hg_core_private_context {
 #ifdef HG_HAS_MULTI_PROGRESS
     struct hg_core_progress_multi progress_multi; /* Progress multi */
 #endif
-    struct hg_core_completion_queue backfill_queue; /* Backfill queue */
-    struct hg_atomic_queue *completion_queue;       /* Default queue */
+    struct hg_core_completion_wait completion_wait; /* Trigger wait */
+    struct hg_atomic_seg_queue *completion_queue;   /* Default queue */
+    struct hg_atomic_seg_queue *completion_high;    /* High priority queue */
+    struct hg_atomic_seg_queue **completion_shards; /* Sharded queues */
+    unsigned int n_completion_shards;               /* Number of shards */
     struct hg_core_loopback_notify loopback_notify; /* Loopback notification */
+    struct hg_core_spin_policy spin_policy;         /* Progress spin policy */
+    struct hg_core_progress_profile profile;        /* Progress profile */
+    struct hg_core_coalesce coalesce;               /* Request coalescing */
+    struct hg_core_timer_wheel timer_wheel;         /* Forward deadlines */
+    struct hg_core_admission admission;             /* Admission control */
     struct hg_core_handle_list user_list;           /* Created handle list */
     struct hg_core_handle_list internal_list;       /* Created handle list */
+    struct hg_core_addr_refs addr_refs;             /* Cached addr refs */
+    struct hg_core_peer_table peer_table;           /* Per-peer counters */
+    struct hg_core_leases leases;                   /* Output leases */
     struct hg_core_handle_pool *handle_pool;        /* Pool of handles */
 #ifdef NA_HAS_SM
     struct hg_core_handle_pool *sm_handle_pool; /* Pool of SM handles */
 #endif
     struct hg_core_multi_recv_op multi_recv_ops[HG_CORE_MULTI_RECV_OP_MAX];
+    hg_thread_mutex_t multi_recv_mutex; /* To add/resize multi-recv bufs */
+    size_t multi_recv_buf_size;         /* Base multi-recv buffer size */
+    size_t multi_recv_mem;              /* Multi-recv buffer memory used */
+    unsigned int multi_recv_shared;     /* Drawn from shared budget */
+    int multi_recv_op_active;           /* Number of multi-recv bufs used */
     struct hg_core_handle_create_cb handle_create_cb; /* Handle create cb */
     struct hg_bulk_op_pool *hg_bulk_op_pool;          /* Pool of op IDs */
     struct hg_poll_set *poll_set;                     /* Poll set */
+    HG_LIST_ENTRY(hg_core_private_context) entry;     /* Class list entry */
     int na_event;                                     /* NA event */
 #ifdef NA_HAS_SM
     int na_sm_event; /* NA SM event */
 #endif
-    hg_atomic_int32_t multi_recv_op_count; /* Number of multi-recv posted */
-    hg_atomic_int32_t n_handles;           /* Number of handles */
-    hg_atomic_int32_t unposting;           /* Prevent re-posting handles */
-    hg_bool_t posted;                      /* Posted receives on context */
+    na_context_t *na_rail_contexts[HG_CORE_RAIL_MAX]; /* Bulk rail contexts */
+    int na_rail_events[HG_CORE_RAIL_MAX];             /* Bulk rail events */
+    hg_bool_t posted;            /* Posted receives on context */
+    hg_bool_t canceled;          /* Posted receives were canceled */
+    hg_bool_t inline_completion; /* Run callbacks from progress */
+    hg_bool_t inline_ready;      /* Progress may run callbacks now */
+    hg_bool_t poll_pending;      /* Edge-triggered fd left undrained */
+
+    /* Written by threads receiving and completing operations, kept away
+     * from the fields that progress reads */
+    HG_MEM_CACHE_ALIGNED(hg_atomic_int32_t n_handles); /* Number of handles */
+    HG_MEM_FIELD_ALIGNED(hg_atomic_int32_t multi_recv_op_count); /* Posted */
+    HG_MEM_FIELD_ALIGNED(hg_atomic_int32_t multi_recv_starved); /* Starved */
+    HG_MEM_FIELD_ALIGNED(hg_atomic_int32_t unposting); /* Prevent re-post */
+    HG_MEM_FIELD_ALIGNED(hg_atomic_int32_t completion_shard_next); /* Shard */
+    HG_MEM_FIELD_ALIGNED(hg_atomic_int64_t request_tags); /* Tag block */
 };
 
-/* Info for wrapping callbacks if self addr */
-struct hg_core_self_cb_info {
-    hg_core_cb_t forward_cb;
-    void *forward_arg;
-    hg_core_cb_t respond_cb;
-    void *respond_arg;
-};
+HG_MEM_CACHE_LINE_CHECK(struct hg_core_private_context, posted, n_handles);
+HG_MEM_CACHE_LINE_CHECK(struct hg_core_private_context, poll_set, n_handles);
 
 /* HG addr */
 struct hg_core_private_addr {
@@ -303,6 +753,7 @@ struct hg_core_private_addr {
 #ifdef NA_HAS_SM
     size_t na_sm_addr_serialize_size; /* Cached serialization size */
     na_sm_id_t host_id;               /* NA SM Host ID */
+    char *cache_key;                  /* Key in addr lookup cache */
 #endif
     hg_atomic_int32_t ref_count; /* Reference count */
 };
@@ -327,12 +778,59 @@ struct hg_core_ops {
         struct hg_core_private_handle *hg_core_handle); /* no_respond */
 };
 
+/* HG core ack resources (only allocated when more data is exchanged) */
+struct hg_core_ack {
+    HG_LIST_ENTRY(hg_core_ack) entry;       /* Granted list entry */
+    struct hg_core_private_handle *handle; /* Handle (if granted) */
+    void *buf;                             /* Ack buf for more data */
+    void *buf_plugin_data;                 /* Ack plugin data */
+    na_op_id_t *na_op_id;                  /* Operation ID for ack */
+    hg_bool_t granted;                     /* Lease can be released */
+    hg_bool_t released;                    /* Lease released by request */
+};
+
+/* HG core stream chunk (origin buffer receiving a response of a stream) */
+struct hg_core_stream_chunk {
+    HG_QUEUE_ENTRY(hg_core_stream_chunk) entry; /* Received queue entry */
+    struct hg_core_private_handle *handle;      /* Handle */
+    void *buf;                                  /* Recv buffer */
+    void *buf_plugin_data;                      /* Recv buffer plugin data */
+    na_op_id_t *na_op_id;                       /* Operation ID for recv */
+    size_t size;                                /* Size received */
+    hg_bool_t posted;                           /* Recv is posted */
+};
+
+/* HG core stream resources (only allocated when responses are streamed) */
+struct hg_core_stream {
+    struct hg_completion_entry hg_completion_entry; /* Completion queue entry */
+    HG_QUEUE_HEAD(hg_core_stream_chunk) received;   /* Chunks to trigger */
+    struct hg_core_stream_chunk *chunks; /* Response chunks (origin only) */
+    struct hg_core_ack *slots[HG_CORE_STREAM_CREDIT_SLOTS]; /* Credit msgs */
+    hg_bool_t slot_posted[HG_CORE_STREAM_CREDIT_SLOTS];    /* Recv posted */
+    hg_bool_t slot_canceled[HG_CORE_STREAM_CREDIT_SLOTS];  /* Recv canceled */
+    hg_thread_spin_t lock;  /* Lock */
+    na_class_t *na_class;   /* NA class of resources */
+    hg_core_cb_t callback;  /* Partial respond callback (target) */
+    void *arg;              /* Partial respond callback arguments */
+    hg_return_t ret;        /* Return code of partial respond (target) */
+    unsigned int count;     /* Number of chunks (origin) */
+    unsigned int batch;     /* Credits returned per credit msg */
+    unsigned int credits;   /* Credits left to send responses (target) */
+    unsigned int partials;  /* Partials consumed (origin) / sent (target) */
+    unsigned int msgs;      /* Credit msgs owed (origin) / recvd (target) */
+    hg_bool_t queued;       /* Completion entry is queued */
+    hg_bool_t busy;         /* Credit msg / partial response in flight */
+    hg_bool_t pending;      /* Response waits for a credit (target) */
+    hg_bool_t done;         /* Final response received / posted */
+};
+
 /* HG core handle */
 struct hg_core_private_handle {
     struct hg_core_handle core_handle; /* Must remain as first field */
     struct hg_completion_entry hg_completion_entry; /* Completion queue entry */
     HG_LIST_ENTRY(hg_core_private_handle) created;  /* Created list entry */
     HG_LIST_ENTRY(hg_core_private_handle) pending;  /* Pending list entry */
+    HG_LIST_ENTRY(hg_core_private_handle) timer;    /* Timer wheel entry */
     struct hg_core_header in_header;                /* Input header */
     struct hg_core_header out_header;               /* Output header */
     struct hg_core_handle_list *created_list;       /* Created list */
@@ -344,16 +842,28 @@ struct hg_core_private_handle {
     hg_core_cb_t response_callback; /* Response callback */
     void *response_arg;             /* Response callback arguments */
     struct hg_core_ops ops;         /* Handle ops */
-    void *ack_buf;                  /* Ack buf for more data */
+    struct hg_core_ack *ack;        /* Ack resources (allocated on use) */
+    struct hg_core_stream *stream;  /* Stream resources (allocated on use) */
+    hg_core_cb_t stream_callback;   /* Partial response callback (origin) */
+    void *stream_arg;               /* Partial response callback arguments */
+    struct hg_core_lease *lease;    /* Lease released by request */
+    struct hg_core_coalesce_msg *coalesce_msg; /* Message holding request */
     void *in_buf_plugin_data;       /* Input buffer NA plugin data */
     void *out_buf_plugin_data;      /* Output buffer NA plugin data */
-    void *ack_buf_plugin_data;      /* Ack plugin data */
     na_op_id_t *na_send_op_id;      /* Operation ID for send */
     na_op_id_t *na_recv_op_id;      /* Operation ID for recv */
-    na_op_id_t *na_ack_op_id;       /* Operation ID for ack */
     struct hg_core_multi_recv_op *multi_recv_op; /* Multi-recv operation */
     size_t in_buf_used;                 /* Amount of input buffer used */
     size_t out_buf_used;                /* Amount of output buffer used */
+    hg_uint64_t forward_start;          /* Cycles at forward (stats) */
+    hg_uint64_t handler_start;          /* Cycles at RPC callback (stats) */
+    hg_uint64_t queue_start;            /* Cycles at completion (stats) */
+    hg_uint64_t acquire_start;          /* Cycles at creation or receive */
+    hg_uint64_t bulk_size;              /* Bulk size decoded (capture) */
+    hg_uint64_t in_extra_size;          /* Extra input size (capture) */
+    hg_uint8_t trace_context[HG_TRACE_CONTEXT_SIZE]; /* Trace context */
+    hg_time_t deadline;                 /* Forward deadline (if timed) */
+    unsigned int timeout_ms;            /* Forward timeout (0 if default) */
     na_tag_t tag;                       /* Tag used for request and response */
     hg_atomic_int32_t ref_count;        /* Reference count */
     hg_atomic_int32_t no_response_done; /* Reference count to reach for done */
@@ -365,9 +875,17 @@ struct hg_core_private_handle {
     hg_core_op_type_t op_type; /* Core operation type */
     hg_return_t ret;           /* Return code associated to handle */
     hg_uint8_t cookie;         /* Cookie */
+    hg_uint8_t stream_credits; /* Partial responses in flight (0 if none) */
     hg_bool_t reuse;           /* Re-use handle once ref_count is 0 */
     hg_bool_t is_self;         /* Self processed */
     hg_bool_t no_response;     /* Require response or not */
+    hg_bool_t unexpected_response; /* Response is an unexpected msg */
+    hg_bool_t trace_context_set;   /* Trace context is valid */
+    hg_bool_t timed;               /* Handle is in timer wheel */
+    hg_bool_t admitted;            /* Request waits for its callback */
+    hg_bool_t persistent;          /* Target and ID are bound to handle */
+    hg_bool_t addr_ref_cached;     /* Addr reference held by context */
+    hg_bool_t in_header_encoded;   /* Input header is already encoded */
 };
 
 /* HG op id */
@@ -399,10 +917,44 @@ hg_core_counters_init(struct hg_core_counters *hg_core_counters);
 #endif
 
 /**
- * Generate a new tag.
+ * Generate a new tag from the block of tags reserved by the context.
  */
 static HG_INLINE na_tag_t
-hg_core_gen_request_tag(struct hg_core_private_class *hg_core_class);
+hg_core_gen_request_tag(struct hg_core_private_context *context);
+
+/**
+ * Create table of responses received as unexpected messages.
+ */
+static hg_return_t
+hg_core_response_table_create(
+    struct hg_core_private_class *hg_core_class, hg_uint32_t size);
+
+/**
+ * Check that responses can be sent as unexpected messages with that class.
+ */
+static hg_bool_t
+hg_core_response_table_supported(na_class_t *na_class);
+
+/**
+ * Generate a tag whose response table slot is free and store handle into it.
+ * Returns HG_FALSE if no slot could be found.
+ */
+static hg_bool_t
+hg_core_response_table_insert(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Remove the handle stored for tag, if hg_core_handle is not NULL, only
+ * remove that handle. Returns the handle that was removed or NULL.
+ */
+static struct hg_core_private_handle *
+hg_core_response_table_remove(struct hg_core_private_class *hg_core_class,
+    na_tag_t tag, struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Complete pending unexpected response of handle as canceled.
+ */
+static void
+hg_core_response_cancel(struct hg_core_private_handle *hg_core_handle);
 
 /**
  * Proc request header and verify it if decoded.
@@ -432,18 +984,52 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
 static hg_return_t
 hg_core_finalize(struct hg_core_private_class *hg_core_class);
 
+/**
+ * Initialize additional NA classes used for bulk transfers.
+ */
+static hg_return_t
+hg_core_rails_init(struct hg_core_private_class *hg_core_class,
+    const char *const *info_strings, hg_uint32_t count,
+    const struct na_init_info *na_init_info);
+
+/**
+ * Finalize additional NA classes used for bulk transfers.
+ */
+static hg_return_t
+hg_core_rails_finalize(struct hg_core_private_class *hg_core_class);
+
 /**
  * Create context.
  */
 static hg_return_t
 hg_core_context_create(struct hg_core_private_class *hg_core_class,
-    hg_uint8_t id, struct hg_core_private_context **context_p);
+    hg_uint8_t id, const struct na_context_info *na_context_info,
+    struct hg_core_private_context **context_p);
+
+/**
+ * Destroy context. Waits for posted requests, user handles and lease acks are
+ * bounded by timeout_ms, waits for user handles and lease acks are skipped if
+ * quiescent is set.
+ */
+static hg_return_t
+hg_core_context_destroy(struct hg_core_private_context *context,
+    unsigned int timeout_ms, hg_bool_t quiescent);
 
 /**
- * Destroy context.
+ * Destroy several contexts, operations of all contexts are canceled first and
+ * waited on together. Destroyed contexts are set to NULL.
  */
 static hg_return_t
-hg_core_context_destroy(struct hg_core_private_context *context);
+hg_core_context_destroy_multi(struct hg_core_private_context **contexts,
+    unsigned int count, hg_bool_t quiescent);
+
+/**
+ * Check whether context has no remaining operations to wait on before it can
+ * be destroyed.
+ */
+static hg_bool_t
+hg_core_context_drained(
+    struct hg_core_private_context *context, hg_bool_t quiescent);
 
 /**
  * Start listening for incoming RPC requests.
@@ -458,6 +1044,12 @@ static hg_return_t
 hg_core_context_unpost(
     struct hg_core_private_context *context, unsigned int timeout_ms);
 
+/**
+ * Cancel posted requests without waiting for their completion.
+ */
+static hg_return_t
+hg_core_context_unpost_cancel(struct hg_core_private_context *context);
+
 /**
  * Allocate multi-recv resources.
  */
@@ -483,8 +1075,68 @@ hg_core_context_multi_recv_post(struct hg_core_private_context *context,
  * Cancel posted multi-recv operations.
  */
 static hg_return_t
-hg_core_context_multi_recv_unpost(struct hg_core_private_context *context,
-    na_class_t *na_class, na_context_t *na_context, unsigned int timeout_ms);
+hg_core_context_multi_recv_cancel(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context);
+
+/**
+ * Wait for canceled multi-recv operations to complete.
+ */
+static hg_return_t
+hg_core_context_multi_recv_wait(
+    struct hg_core_private_context *context, unsigned int timeout_ms);
+
+/**
+ * Post an additional multi-recv buffer if memory budget allows.
+ */
+static void
+hg_core_context_multi_recv_grow(struct hg_core_private_context *context);
+
+/**
+ * Draw multi-recv memory from the shared budget of the class (all or nothing).
+ */
+static hg_bool_t
+hg_core_context_multi_recv_acquire(
+    struct hg_core_private_context *context, size_t buf_size);
+
+/**
+ * Return multi-recv memory to the shared budget of the class.
+ */
+static void
+hg_core_context_multi_recv_release(
+    struct hg_core_private_context *context, size_t buf_size);
+
+/**
+ * Allocate multi-recv buffer and operation.
+ */
+static hg_return_t
+hg_core_multi_recv_op_alloc(struct hg_core_multi_recv_op *multi_recv_op,
+    na_class_t *na_class, size_t buf_size);
+
+/**
+ * Free multi-recv buffer and operation.
+ */
+static void
+hg_core_multi_recv_op_free(
+    struct hg_core_multi_recv_op *multi_recv_op, na_class_t *na_class);
+
+/**
+ * Replace multi-recv buffer with a buffer of buf_size.
+ */
+static void
+hg_core_multi_recv_op_resize(struct hg_core_multi_recv_op *multi_recv_op,
+    na_class_t *na_class, size_t buf_size, size_t *mem_p);
+
+/**
+ * Lock handle list (no-op if class is single-threaded).
+ */
+static HG_INLINE void
+hg_core_handle_list_lock(struct hg_core_handle_list *handle_list);
+
+/**
+ * Unlock handle list (no-op if class is single-threaded).
+ */
+static HG_INLINE void
+hg_core_handle_list_unlock(struct hg_core_handle_list *handle_list);
 
 /**
  * Check list of handles not freed.
@@ -514,12 +1166,110 @@ hg_core_handle_pool_create(struct hg_core_private_context *context,
 static void
 hg_core_handle_pool_destroy(struct hg_core_handle_pool *hg_core_handle_pool);
 
+/**
+ * Charge handles to the memory budget of the class.
+ */
+static HG_INLINE hg_bool_t
+hg_core_handle_pool_mem_acquire(
+    struct hg_core_private_context *context, unsigned int count);
+
+/**
+ * Return handles to the memory budget of the class.
+ */
+static HG_INLINE void
+hg_core_handle_pool_mem_release(
+    struct hg_core_private_context *context, unsigned int count);
+
 /**
  * Pool is empty.
  */
 static HG_INLINE hg_bool_t
 hg_core_handle_pool_empty(struct hg_core_handle_pool *hg_core_handle_pool);
 
+/**
+ * Pool has reached its soft cap.
+ */
+static HG_INLINE hg_bool_t
+hg_core_handle_pool_capped(struct hg_core_handle_pool *hg_core_handle_pool);
+
+/**
+ * Pool can still be extended (incrementally or lazily).
+ */
+static HG_INLINE hg_bool_t
+hg_core_handle_pool_growable(struct hg_core_handle_pool *hg_core_handle_pool);
+
+/**
+ * Number of available handles below which the pool is extended.
+ */
+static HG_INLINE unsigned int
+hg_core_handle_pool_watermark(struct hg_core_handle_pool *hg_core_handle_pool);
+
+/**
+ * Add stats of pool to handle stats.
+ */
+static void
+hg_core_handle_pool_get_stats(struct hg_core_handle_pool *hg_core_handle_pool,
+    struct hg_handle_stats *stats);
+
+/**
+ * Count outstanding handles of a list and find the oldest one.
+ */
+static void
+hg_core_handle_list_get_age(struct hg_core_handle_list *handle_list,
+    hg_id_t id, hg_uint64_t now, hg_uint32_t *count_p, hg_uint64_t *age_p);
+
+/**
+ * Return handle to pool.
+ */
+static HG_INLINE void
+hg_core_handle_pool_put(struct hg_core_handle_pool *hg_core_handle_pool,
+    struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Mark pool for extension from progress if running low on handles.
+ */
+static HG_INLINE void
+hg_core_handle_pool_check(struct hg_core_handle_pool *hg_core_handle_pool);
+
+/**
+ * Extend pools of handles that were marked for extension.
+ */
+static hg_return_t
+hg_core_context_pools_extend(struct hg_core_private_context *context);
+
+/**
+ * Draw up to count requests from the shared budget of the class.
+ */
+static unsigned int
+hg_core_post_shared_acquire(
+    struct hg_core_private_class *hg_core_class, unsigned int count);
+
+/**
+ * Return requests to the shared budget of the class.
+ */
+static void
+hg_core_post_shared_release(
+    struct hg_core_private_class *hg_core_class, unsigned int count);
+
+/**
+ * Ask other contexts to give back requests (or withdraw that request).
+ */
+static void
+hg_core_post_shared_starve(struct hg_core_private_class *hg_core_class,
+    hg_atomic_int32_t *starved, hg_bool_t starve);
+
+/**
+ * Cancel idle handles drawn from the shared budget if other contexts wait.
+ */
+static void
+hg_core_handle_pool_reclaim(struct hg_core_handle_pool *hg_core_handle_pool);
+
+/**
+ * Remove posted handle that is being destroyed from pool count.
+ */
+static void
+hg_core_handle_pool_release(struct hg_core_handle_pool *hg_core_handle_pool);
+
 /**
  * Get handle from pool and extend pool if needed.
  */
@@ -548,12 +1298,24 @@ static hg_return_t
 hg_core_handle_pool_unpost(
     struct hg_core_handle_pool *hg_core_handle_pool, unsigned int timeout_ms);
 
+/**
+ * Cancel pending operations on pool without waiting for their completion.
+ */
+static hg_return_t
+hg_core_handle_pool_cancel(struct hg_core_handle_pool *hg_core_handle_pool);
+
 /**
  * Hash map keys based on RPC ID.
  */
 static HG_INLINE unsigned int
 hg_core_map_hash(hg_hash_table_key_t key);
 
+/**
+ * Hash RPC ID for RPC map snapshot.
+ */
+static HG_INLINE unsigned int
+hg_core_map_slot_hash(hg_id_t id);
+
 /**
  * Determine if map keys are equal using RPC ID.
  */
@@ -586,37 +1348,230 @@ static hg_return_t
 hg_core_map_remove(struct hg_core_map *hg_core_map, hg_id_t *id);
 
 /**
- * Lookup addr.
+ * Build and publish a new snapshot of the RPC map, excluding exclude_id if
+ * non-NULL. Must be called with map lock held.
  */
 static hg_return_t
-hg_core_addr_lookup(struct hg_core_private_class *hg_core_class,
-    const char *name, struct hg_core_private_addr **addr_p);
+hg_core_map_publish(struct hg_core_map *hg_core_map, const hg_id_t *exclude_id);
 
 /**
- * Create addr.
+ * Free snapshots of the RPC map that were replaced (lock must be held and no
+ * lookup may be in progress).
  */
-static hg_return_t
-hg_core_addr_create(struct hg_core_private_class *hg_core_class,
-    struct hg_core_private_addr **hg_core_private_addr_p);
+static void
+hg_core_map_retired_free(struct hg_core_map *hg_core_map);
 
 /**
- * Free addr.
+ * Free all snapshots of the RPC map.
  */
 static void
-hg_core_addr_free(struct hg_core_private_addr *hg_core_addr);
+hg_core_map_snapshot_free(struct hg_core_map *hg_core_map);
 
 /**
- * Free NA addr.
+ * Get histogram bucket of value.
  */
-static void
-hg_core_addr_free_na(struct hg_core_private_addr *hg_core_addr);
+static HG_INLINE unsigned int
+hg_core_histogram_bucket(hg_uint64_t value);
 
 /**
- * Set addr to be removed.
+ * Add sample to histogram.
+ */
+static HG_INLINE void
+hg_core_histogram_record(
+    struct hg_core_histogram *hg_core_histogram, hg_uint64_t value);
+
+/**
+ * Add time elapsed between two cycle counts to histogram.
+ */
+static HG_INLINE void
+hg_core_histogram_record_time(struct hg_core_histogram *hg_core_histogram,
+    hg_uint64_t start, hg_uint64_t end);
+
+/**
+ * Copy histogram.
+ */
+static void
+hg_core_histogram_get(struct hg_core_histogram *hg_core_histogram,
+    struct hg_stats_histogram *histogram);
+
+/**
+ * Call trace callback.
+ */
+static void
+hg_core_trace(
+    struct hg_core_private_handle *hg_core_handle, hg_trace_event_t event);
+
+/**
+ * Append capture record of processed RPC.
+ */
+static void
+hg_core_capture(struct hg_core_private_handle *hg_core_handle,
+    hg_size_t out_size, hg_uint64_t end);
+
+/**
+ * Parse lookup name and select NA class / addr that must be resolved.
+ */
+static hg_return_t
+hg_core_addr_lookup_parse(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr *hg_core_addr,
+    struct hg_core_addr_lookup_target *target);
+
+/**
+ * Lookup addr.
+ */
+static hg_return_t
+hg_core_addr_lookup(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr **addr_p);
+
+/**
+ * Lookup multiple addrs at once, batching NA lookups.
+ */
+static hg_return_t
+hg_core_addr_lookup_multi(struct hg_core_private_class *hg_core_class,
+    const char *const *names, unsigned int count,
+    struct hg_core_private_addr **addrs);
+
+/**
+ * Warm up transport state of addrs, batching NA calls per NA class.
+ */
+static hg_return_t
+hg_core_addr_warm(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr *const *addrs, unsigned int count);
+
+/**
+ * Create addr.
+ */
+static hg_return_t
+hg_core_addr_create(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr **hg_core_private_addr_p);
+
+/**
+ * Free addr.
+ */
+static void
+hg_core_addr_free(struct hg_core_private_addr *hg_core_addr);
+
+/**
+ * Free NA addr.
+ */
+static void
+hg_core_addr_free_na(struct hg_core_private_addr *hg_core_addr);
+
+/**
+ * Take a reference to addr for a handle of context, through the context
+ * cache when possible. Returns true if the reference is cached.
+ */
+static hg_bool_t
+hg_core_addr_ref_get(struct hg_core_private_context *context,
+    struct hg_core_private_addr *hg_core_addr);
+
+/**
+ * Release a reference taken with hg_core_addr_ref_get().
+ */
+static void
+hg_core_addr_ref_put(struct hg_core_private_context *context,
+    struct hg_core_private_addr *hg_core_addr, hg_bool_t cached);
+
+/**
+ * Allocate table of per-peer counters (if enabled).
+ */
+static hg_return_t
+hg_core_peer_table_init(
+    struct hg_core_peer_table *peer_table, unsigned int max);
+
+/**
+ * Free table of per-peer counters and release NA addrs.
+ */
+static void
+hg_core_peer_table_free(struct hg_core_peer_table *peer_table);
+
+/**
+ * Get counters of peer on context and lock peer table. Returns NULL if
+ * counters are disabled or peer is not counted, table is not locked then.
+ */
+static HG_INLINE struct hg_peer_stats *
+hg_core_peer_lock(struct hg_core_private_context *context,
+    na_class_t *na_class, na_addr_t *na_addr);
+
+/**
+ * Get counters of the peer of a handle (see hg_core_peer_lock()).
+ */
+static HG_INLINE struct hg_peer_stats *
+hg_core_peer_lock_handle(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Unlock peer table locked by hg_core_peer_lock().
+ */
+static HG_INLINE void
+hg_core_peer_unlock(struct hg_core_private_context *context);
+
+/**
+ * Add counters of NA addr counted in peer table to stats.
+ */
+static void
+hg_core_peer_table_get(struct hg_core_peer_table *peer_table,
+    const na_addr_t *na_addr, struct hg_peer_stats *stats);
+
+/**
+ * Add peer counters.
+ */
+static HG_INLINE void
+hg_core_peer_stats_add(
+    struct hg_peer_stats *stats, const struct hg_peer_stats *delta);
+
+/**
+ * Sort peer entries by NA addr.
+ */
+static int
+hg_core_peer_cmp_addr(const void *a, const void *b);
+
+/**
+ * Sort peer entries by decreasing traffic.
+ */
+static int
+hg_core_peer_cmp_traffic(const void *a, const void *b);
+
+/**
+ * Set addr to be removed.
  */
 static hg_return_t
 hg_core_addr_set_remove(struct hg_core_private_addr *hg_core_addr);
 
+/**
+ * Hash lookup string for addr cache.
+ */
+static HG_INLINE unsigned int
+hg_core_addr_cache_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare lookup strings for addr cache.
+ */
+static HG_INLINE int
+hg_core_addr_cache_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+#ifdef NA_HAS_SM
+/**
+ * Get addr previously looked up with the same string from cache. A
+ * reference to the addr is taken if found.
+ */
+static struct hg_core_private_addr *
+hg_core_addr_cache_lookup(
+    struct hg_core_private_class *hg_core_class, const char *name);
+
+/**
+ * Insert addr in cache (ignored if an entry already exists).
+ */
+static void
+hg_core_addr_cache_insert(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr *hg_core_addr);
+
+/**
+ * Evict addr from cache.
+ */
+static void
+hg_core_addr_cache_remove(struct hg_core_private_addr *hg_core_addr);
+#endif
+
 /**
  * Self addr.
  */
@@ -667,6 +1622,46 @@ hg_core_addr_deserialize(struct hg_core_private_class *hg_core_class,
     struct hg_core_private_addr **hg_core_addr_p, const void *buf,
     hg_size_t buf_size);
 
+/**
+ * Get size required to serialize addrs into an addr book.
+ */
+static hg_size_t
+hg_core_addr_book_get_size(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr *const *addrs, unsigned int count,
+    hg_uint8_t flags, struct hg_core_addr_book_hdr *hdr);
+
+/**
+ * Serialize addrs into an addr book.
+ */
+static hg_return_t
+hg_core_addr_book_serialize(void *buf, hg_size_t buf_size, hg_uint8_t flags,
+    struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr *const *addrs, unsigned int count);
+
+/**
+ * Decode and check addr book header.
+ */
+static hg_return_t
+hg_core_addr_book_decode_hdr(struct hg_core_private_class *hg_core_class,
+    const char **buf_ptr_p, hg_size_t *buf_size_left_p,
+    struct hg_core_addr_book_hdr *hdr);
+
+/**
+ * Count entries of one or more concatenated addr books.
+ */
+static hg_return_t
+hg_core_addr_book_count(struct hg_core_private_class *hg_core_class,
+    const void *buf, hg_size_t buf_size, unsigned int *count_p);
+
+/**
+ * Deserialize one or more concatenated addr books, count must be the total
+ * number of entries and addrs must be initialized to NULL.
+ */
+static hg_return_t
+hg_core_addr_book_deserialize(struct hg_core_private_class *hg_core_class,
+    const void *buf, hg_size_t buf_size, struct hg_core_private_addr **addrs,
+    unsigned int count);
+
 /**
  * Determine which NA component should be used.
  */
@@ -683,6 +1678,20 @@ hg_core_create(struct hg_core_private_context *context, na_class_t *na_class,
     na_context_t *na_context, unsigned long flags,
     struct hg_core_private_handle **hg_core_handle_p);
 
+/**
+ * Increment handle refcount (plain load and store if class is
+ * single-threaded).
+ */
+static HG_INLINE int32_t
+hg_core_handle_ref_incr(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Decrement handle refcount (plain load and store if class is
+ * single-threaded).
+ */
+static HG_INLINE int32_t
+hg_core_handle_ref_decr(struct hg_core_private_handle *hg_core_handle);
+
 /**
  * Free handle.
  */
@@ -715,6 +1724,53 @@ hg_core_alloc_na(struct hg_core_private_handle *hg_core_handle,
 static void
 hg_core_free_na(struct hg_core_private_handle *hg_core_handle);
 
+/**
+ * Allocate output buffer (deferred for handles posted to receive requests).
+ */
+static hg_return_t
+hg_core_alloc_output(
+    struct hg_core_private_handle *hg_core_handle, unsigned long flags);
+
+/**
+ * Allocate ack resources.
+ */
+static hg_return_t
+hg_core_alloc_ack(
+    struct hg_core_private_handle *hg_core_handle, unsigned long flags);
+
+/**
+ * Free ack resources.
+ */
+static void
+hg_core_free_ack(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Create ack message buffer and operation ID.
+ */
+static hg_return_t
+hg_core_ack_create(na_class_t *na_class, size_t buf_size, unsigned long flags,
+    struct hg_core_ack **ack_p);
+
+/**
+ * Destroy ack resources.
+ */
+static void
+hg_core_ack_destroy(na_class_t *na_class, struct hg_core_ack *ack);
+
+/**
+ * Allocate stream resources, count chunks are allocated on the origin while
+ * the target only allocates credit msg slots (count is 0).
+ */
+static hg_return_t
+hg_core_alloc_stream(
+    struct hg_core_private_handle *hg_core_handle, unsigned int count);
+
+/**
+ * Free stream resources.
+ */
+static void
+hg_core_free_stream(struct hg_core_private_handle *hg_core_handle);
+
 /**
  * Reset handle.
  */
@@ -747,6 +1803,14 @@ static hg_return_t
 hg_core_post_multi(struct hg_core_multi_recv_op *multi_recv_op,
     na_class_t *na_class, na_context_t *na_context);
 
+/**
+ * Repost (or release) multi-recv operation once its buffer is consumed.
+ */
+static hg_return_t
+hg_core_repost_multi(struct hg_core_private_context *context,
+    struct hg_core_handle_pool *hg_core_handle_pool,
+    struct hg_core_multi_recv_op *multi_recv_op);
+
 /**
  * Release hold on input buffer so that it can be re-used early.
  */
@@ -773,2006 +1837,8872 @@ static hg_return_t
 hg_core_forward_na(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Send response.
+ * Post unexpected send of handle input buffer.
  */
 static hg_return_t
-hg_core_respond(struct hg_core_private_handle *hg_core_handle,
-    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size,
-    hg_return_t ret_code);
+hg_core_forward_na_send(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Send response locally.
+ * Pack handle input into a pending message to the same target. Returns
+ * HG_FALSE if the request must be sent on its own.
  */
-static HG_INLINE hg_return_t
-hg_core_respond_self(struct hg_core_private_handle *hg_core_handle);
+static hg_bool_t
+hg_core_coalesce_add(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Do not send response locally.
+ * Remove canceled request from the pending message that holds it, request
+ * then completes as canceled. Returns HG_FALSE if the request is not held
+ * back (e.g., message was already sent).
  */
-static HG_INLINE hg_return_t
-hg_core_no_respond_self(struct hg_core_private_handle *hg_core_handle);
+static hg_bool_t
+hg_core_coalesce_cancel(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Send response through NA.
+ * Remove message from pending list, requests are no longer held back by it.
+ * Must be called with coalesce mutex held.
  */
-static hg_return_t
-hg_core_respond_na(struct hg_core_private_handle *hg_core_handle);
+static void
+hg_core_coalesce_unlink(struct hg_core_coalesce *coalesce,
+    struct hg_core_coalesce_msg *coalesce_msg);
 
 /**
- * Do not send response through NA.
+ * Record arrival of a request to na_addr and return how long (in seconds)
+ * requests to that target may be held back, 0 if the target is idle.
  */
-static HG_INLINE hg_return_t
-hg_core_no_respond_na(struct hg_core_private_handle *hg_core_handle);
+static double
+hg_core_coalesce_window(
+    struct hg_core_coalesce *coalesce, na_addr_t *na_addr, hg_time_t now);
 
 /**
- * Send input callback.
+ * Post sends of pending coalesced messages that reached their deadline (or
+ * all of them if force is set). Returns HG_TRUE if messages remain pending,
+ * in which case deadline_p is set to the earliest flush deadline.
  */
-static HG_INLINE void
-hg_core_send_input_cb(const struct na_cb_info *callback_info);
+static hg_bool_t
+hg_core_coalesce_flush(struct hg_core_private_context *context,
+    hg_bool_t force, hg_time_t *deadline_p);
 
 /**
- * Recv input callback.
+ * Encode header of coalesced message. Returns HG_FALSE if the message was
+ * already sent through the regular path or completed with an error.
  */
-static void
-hg_core_recv_input_cb(const struct na_cb_info *callback_info);
+static hg_bool_t
+hg_core_coalesce_prepare(struct hg_core_coalesce_msg *coalesce_msg);
 
 /**
- * Multi-recv input callback.
+ * Post send of coalesced message.
  */
 static void
-hg_core_multi_recv_input_cb(const struct na_cb_info *callback_info);
+hg_core_coalesce_send(struct hg_core_coalesce_msg *coalesce_msg);
 
 /**
- * Process input.
+ * Post sends of prepared coalesced messages sharing the same NA class and
+ * context at once.
  */
-static hg_return_t
-hg_core_process_input(struct hg_core_private_handle *hg_core_handle);
+static void
+hg_core_coalesce_send_batch(
+    struct hg_core_coalesce_msg **coalesce_msgs, unsigned int count);
 
 /**
- * Send output callback.
+ * Complete coalesced message that could not be sent.
  */
-static HG_INLINE void
-hg_core_send_output_cb(const struct na_cb_info *callback_info);
+static void
+hg_core_coalesce_send_error(
+    struct hg_core_coalesce_msg *coalesce_msg, hg_return_t ret);
 
 /**
- * Recv output callback.
+ * Coalesced message send callback.
  */
-static HG_INLINE void
-hg_core_recv_output_cb(const struct na_cb_info *callback_info);
+static void
+hg_core_coalesce_send_cb(const struct na_cb_info *callback_info);
 
 /**
- * Process output.
+ * Return coalesced message to the free list.
  */
-static hg_return_t
-hg_core_process_output(struct hg_core_private_handle *hg_core_handle,
-    void (*done_callback)(hg_core_handle_t, hg_return_t));
+static void
+hg_core_coalesce_release(struct hg_core_coalesce_msg *coalesce_msg);
 
 /**
- * Callback for HG_CORE_MORE_DATA operation.
+ * Free coalesced message.
  */
-static HG_INLINE void
-hg_core_more_data_complete(hg_core_handle_t handle, hg_return_t ret);
+static void
+hg_core_coalesce_msg_free(struct hg_core_coalesce_msg *coalesce_msg);
 
 /**
- * Send ack for HG_CORE_MORE_DATA flag on output.
+ * Get timer wheel tick of time t.
  */
-static void
-hg_core_send_ack(hg_core_handle_t handle, hg_return_t ret);
+static HG_INLINE hg_uint64_t
+hg_core_timer_tick(const struct hg_core_timer_wheel *timer_wheel, hg_time_t t);
 
 /**
- * Ack callback. (HG_CORE_MORE_DATA flag on output)
+ * Add handle to timer wheel with a deadline of timeout_ms from now.
  */
-static HG_INLINE void
-hg_core_ack_cb(const struct na_cb_info *callback_info);
+static void
+hg_core_timer_add(
+    struct hg_core_private_handle *hg_core_handle, unsigned int timeout_ms);
 
 /**
- * Wrapper for local callback execution.
+ * Remove handle from timer wheel.
  */
-static hg_return_t
-hg_core_self_cb(const struct hg_core_cb_info *callback_info);
+static void
+hg_core_timer_remove(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Process handle (used for self execution).
+ * Cancel handles that reached their deadline. Returns HG_TRUE if handles
+ * remain in the timer wheel, in which case deadline_p is set to the earliest
+ * time at which progress must check the wheel again.
  */
-static hg_return_t
-hg_core_process_self(struct hg_core_private_handle *hg_core_handle);
+static hg_bool_t
+hg_core_timer_expire(
+    struct hg_core_private_context *context, hg_time_t *deadline_p);
 
 /**
- * Process handle.
+ * Queue peer reported as unreachable by NA (NA peer error callback).
  */
-static hg_return_t
-hg_core_process(struct hg_core_private_handle *hg_core_handle);
+static void
+hg_core_peer_error_cb(
+    na_class_t *na_class, na_addr_t *na_addr, na_return_t error, void *arg);
 
 /**
- * Complete handle operation.
+ * Purge peers queued by hg_core_peer_error_cb() and notify user.
  */
-static HG_INLINE void
-hg_core_complete_op(struct hg_core_private_handle *hg_core_handle);
+static void
+hg_core_peer_error_process(struct hg_core_private_class *hg_core_class);
 
 /**
- * Complete handle and add to completion queue.
+ * Fail forwards pending to NA addr on all contexts of class, returns the
+ * number of handles that were failed.
  */
-static HG_INLINE void
-hg_core_complete(
-    struct hg_core_private_handle *hg_core_handle, hg_return_t ret);
+static unsigned int
+hg_core_peer_purge(struct hg_core_private_class *hg_core_class,
+    na_class_t *na_class, na_addr_t *na_addr);
 
 /**
- * Make progress.
+ * Send response. Sends through NA are added to batch instead of being posted
+ * if batch is not NULL.
  */
 static hg_return_t
-hg_core_progress(
-    struct hg_core_private_context *context, unsigned int timeout_ms);
+hg_core_respond(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size,
+    hg_return_t ret_code, struct hg_core_respond_batch *batch);
 
 /**
- * Determines when it is safe to block.
+ * Post sends collected in batch, grouped by NA context and destination.
  */
-static HG_INLINE hg_bool_t
-hg_core_poll_try_wait(struct hg_core_private_context *context);
+static void
+hg_core_respond_batch_post(struct hg_core_respond_batch *batch);
+
+/**
+ * Send response locally.
+ */
+static HG_INLINE hg_return_t
+hg_core_respond_self(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Poll for timeout ms on context.
+ * Do not send response locally.
  */
-static hg_return_t
-hg_core_poll_wait(struct hg_core_private_context *context,
-    unsigned int timeout_ms, hg_bool_t *progressed_p);
+static HG_INLINE hg_return_t
+hg_core_no_respond_self(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Poll context without blocking.
+ * Send response through NA.
  */
 static hg_return_t
-hg_core_poll(struct hg_core_private_context *context, unsigned int timeout_ms,
-    hg_bool_t *progressed_p);
+hg_core_respond_na(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Make progress on NA layer.
+ * Send response through NA, expected sends are added to batch if not NULL.
  */
 static hg_return_t
-hg_core_progress_na(na_class_t *na_class, na_context_t *na_context,
-    unsigned int timeout_ms, hg_bool_t *progressed_p);
+hg_core_respond_na_batch(struct hg_core_private_handle *hg_core_handle,
+    struct hg_core_respond_batch *batch);
 
 /**
- * Completion queue notification callback.
+ * Do not send response through NA.
  */
 static HG_INLINE hg_return_t
-hg_core_progress_loopback_notify(
-    struct hg_core_private_context *context, hg_bool_t *progressed_p);
+hg_core_no_respond_na(struct hg_core_private_handle *hg_core_handle);
 
 /**
- * Trigger callbacks.
+ * Send input callback.
  */
-static hg_return_t
-hg_core_trigger(struct hg_core_private_context *context,
-    unsigned int timeout_ms, unsigned int max_count,
-    unsigned int *actual_count_p);
+static HG_INLINE void
+hg_core_send_input_cb(const struct na_cb_info *callback_info);
 
 /**
- * Trigger callback from HG lookup op ID.
+ * Complete send of input.
  */
-static hg_return_t
-hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id);
+static void
+hg_core_send_input_complete(
+    struct hg_core_private_handle *hg_core_handle, na_return_t na_ret);
 
 /**
- * Trigger callback from HG core handle.
+ * Recv input callback.
  */
-static hg_return_t
-hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle);
+static void
+hg_core_recv_input_cb(const struct na_cb_info *callback_info);
+
+/**
+ * Multi-recv input callback.
+ */
+static void
+hg_core_multi_recv_input_cb(const struct na_cb_info *callback_info);
 
 /**
- * Cancel handle.
+ * Process input.
  */
 static hg_return_t
-hg_core_cancel(struct hg_core_private_handle *hg_core_handle);
+hg_core_process_input(struct hg_core_private_handle *hg_core_handle);
 
-/*******************/
-/* Local Variables */
-/*******************/
+/**
+ * Check whether context is overloaded and request must be rejected.
+ */
+static HG_INLINE hg_bool_t
+hg_core_admission_reject(struct hg_core_private_handle *hg_core_handle);
 
-/* Default ops */
-static const struct hg_core_ops hg_core_ops_na_g = {
-    .forward = hg_core_forward_na,
-    .respond = hg_core_respond_na,
-    .no_respond = hg_core_no_respond_na};
+/**
+ * Reject request without invoking its RPC callback, respond with HG_BUSY
+ * from the receive path if a response is expected.
+ */
+static void
+hg_core_admission_shed(struct hg_core_private_handle *hg_core_handle);
 
-static const struct hg_core_ops hg_core_ops_self_g = {
-    .forward = hg_core_forward_self,
-    .respond = hg_core_respond_self,
-    .no_respond = hg_core_no_respond_self};
+/**
+ * Remove request from requests waiting for their callback.
+ */
+static HG_INLINE void
+hg_core_admission_dequeue(struct hg_core_private_handle *hg_core_handle);
 
-/* Default log outlets */
-#ifdef _WIN32
-static HG_LOG_SUBSYS_DECL_REGISTER(HG_CORE_SUBSYS_NAME, hg);
-#else
-/* HG_LOG_DEBUG_LESIZE: default number of debug log entries. */
-#    define HG_LOG_DEBUG_LESIZE (256)
+/**
+ * Split coalesced input into separate handles.
+ */
+static hg_return_t
+hg_core_process_coalesced(struct hg_core_private_handle *hg_core_handle);
 
-/* Declare debug log for hg */
-static HG_LOG_DEBUG_DECL_LE(HG_CORE_SUBSYS_NAME, HG_LOG_DEBUG_LESIZE);
-static HG_LOG_DEBUG_DECL_DLOG(HG_CORE_SUBSYS_NAME) = HG_LOG_DLOG_INITIALIZER(
-    HG_CORE_SUBSYS_NAME, HG_LOG_DEBUG_LESIZE);
+/**
+ * Get a new handle for a request that was packed into a coalesced message.
+ */
+static hg_return_t
+hg_core_coalesced_handle_get(struct hg_core_private_handle *hg_core_handle,
+    char *record, size_t record_size, na_tag_t tag,
+    struct hg_core_private_handle **hg_core_handle_p);
 
-static HG_LOG_SUBSYS_DLOG_DECL_REGISTER(HG_CORE_SUBSYS_NAME, hg);
-#endif
-static HG_LOG_SUBSYS_DECL_STATE_REGISTER(fatal, HG_CORE_SUBSYS_NAME, HG_LOG_ON);
+/**
+ * Send output callback.
+ */
+static HG_INLINE void
+hg_core_send_output_cb(const struct na_cb_info *callback_info);
 
-/* Specific log outlets */
-static HG_LOG_SUBSYS_DECL_REGISTER(cls, HG_CORE_SUBSYS_NAME);
-static HG_LOG_SUBSYS_DECL_REGISTER(ctx, HG_CORE_SUBSYS_NAME);
-static HG_LOG_SUBSYS_DECL_REGISTER(addr, HG_CORE_SUBSYS_NAME);
-static HG_LOG_SUBSYS_DECL_REGISTER(rpc, HG_CORE_SUBSYS_NAME);
-static HG_LOG_SUBSYS_DECL_REGISTER(poll, HG_CORE_SUBSYS_NAME);
+/**
+ * Recv output callback.
+ */
+static HG_INLINE void
+hg_core_recv_output_cb(const struct na_cb_info *callback_info);
 
-/* Off by default because of potientally excessive logs */
-static HG_LOG_SUBSYS_DECL_REGISTER(rpc_ref, HG_CORE_SUBSYS_NAME);
+/**
+ * Process output.
+ */
+static hg_return_t
+hg_core_process_output(struct hg_core_private_handle *hg_core_handle,
+    void (*done_callback)(hg_core_handle_t, hg_return_t));
 
-/* Off by default because of potientally excessive logs */
-static HG_LOG_SUBSYS_DECL_STATE_REGISTER(
-    poll_loop, HG_CORE_SUBSYS_NAME, HG_LOG_OFF);
-static HG_LOG_SUBSYS_DECL_STATE_REGISTER(perf, HG_CORE_SUBSYS_NAME, HG_LOG_OFF);
+/**
+ * Match response received as an unexpected message with the handle that
+ * forwarded the request, then repost the handle that received it.
+ */
+static void
+hg_core_process_response(struct hg_core_private_handle *hg_core_handle);
 
-#ifndef _WIN32
-/* Declare debug log for stats */
-static HG_LOG_DEBUG_DECL_LE(diag, HG_LOG_DEBUG_LESIZE);
-static HG_LOG_DEBUG_DECL_DLOG(diag) = HG_LOG_DLOG_INITIALIZER(
-    diag, HG_LOG_DEBUG_LESIZE);
-static HG_LOG_SUBSYS_DLOG_DECL_REGISTER(diag, HG_CORE_SUBSYS_NAME);
-#endif
+/**
+ * Post recvs for all the chunks of a streamed response.
+ */
+static hg_return_t
+hg_core_stream_post(
+    struct hg_core_private_handle *hg_core_handle, unsigned int *posted_p);
 
-/*---------------------------------------------------------------------------*/
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+/**
+ * Post recv for a chunk of a streamed response.
+ */
+static HG_INLINE na_return_t
+hg_core_stream_chunk_post(struct hg_core_stream_chunk *chunk);
+
+/**
+ * Recv chunk callback.
+ */
 static void
-hg_core_counters_init(struct hg_core_counters *hg_core_counters)
-{
-    /* TODO we could revert the linked list to avoid registration in reverse
-     * order */
-    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->bulk_count, "bulk_count",
-        "Bulk transfers (inc. extra bulks)");
-    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_resp_extra_count,
-        "rpc_resp_extra_count", "RPCs with extra bulk response");
-    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_req_extra_count,
-        "rpc_req_extra_count", "RPCs with extra bulk request");
-    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_resp_recv_count,
-        "rpc_resp_recv_count", "RPC responses received");
-    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_resp_sent_count,
-        "rpc_resp_sent_count", "RPC responses sent");
-    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_req_recv_count,
-        "rpc_req_recv_count", "RPC requests received");
-    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_req_sent_count,
-        "rpc_req_sent_count", "RPC requests sent");
-}
-#endif
+hg_core_stream_recv_cb(const struct na_cb_info *callback_info);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE na_tag_t
-hg_core_gen_request_tag(struct hg_core_private_class *hg_core_class)
-{
-    na_tag_t request_tag = 0;
+/**
+ * Add stream completion entry to completion queue.
+ */
+static HG_INLINE void
+hg_core_stream_queue(struct hg_core_private_handle *hg_core_handle);
 
-    /* Compare and swap tag if reached max tag */
-    if (!hg_atomic_cas32(&hg_core_class->request_tag,
-            (int32_t) hg_core_class->request_max_tag, 0)) {
-        /* Increment tag */
-        request_tag = (na_tag_t) hg_atomic_incr32(&hg_core_class->request_tag);
-    }
+/**
+ * Process next chunk received, partial responses are passed to the stream
+ * callback before the chunk is re-posted.
+ */
+static void
+hg_core_stream_process(struct hg_core_private_handle *hg_core_handle);
 
-    return request_tag;
-}
+/**
+ * Send credit msg if credits are owed and no other credit msg is in flight.
+ */
+static void
+hg_core_stream_credit_send(struct hg_core_private_handle *hg_core_handle);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_proc_header_request(struct hg_core_handle *hg_core_handle,
-    struct hg_core_header *hg_core_header, hg_proc_op_t op)
-{
-    char *header_buf =
-        (char *) hg_core_handle->in_buf + hg_core_handle->na_in_header_offset;
-    size_t header_buf_size =
-        hg_core_handle->in_buf_size - hg_core_handle->na_in_header_offset;
-    hg_return_t ret;
+/**
+ * Send credit msg callback.
+ */
+static void
+hg_core_stream_credit_send_cb(const struct na_cb_info *callback_info);
 
-    /* Proc request header */
-    ret = hg_core_header_request_proc(
-        op, header_buf, header_buf_size, hg_core_header);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not process request header");
+/**
+ * Mark stream as done and cancel pending recvs.
+ */
+static void
+hg_core_stream_cancel(struct hg_core_private_handle *hg_core_handle);
 
-    if (op == HG_DECODE) {
-        ret = hg_core_header_request_verify(hg_core_header);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            rpc, error, ret, "Could not verify request header");
-    }
+/**
+ * Reset stream counters for a new request.
+ */
+static void
+hg_core_stream_reset(struct hg_core_private_handle *hg_core_handle);
 
-    return HG_SUCCESS;
+/**
+ * Send partial response.
+ */
+static hg_return_t
+hg_core_respond_partial(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_size_t payload_size);
 
-error:
-    return ret;
-}
+/**
+ * Mark final response as posted, returns true if it can be sent now.
+ */
+static hg_bool_t
+hg_core_stream_respond(struct hg_core_private_handle *hg_core_handle);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_proc_header_response(struct hg_core_handle *hg_core_handle,
-    struct hg_core_header *hg_core_header, hg_proc_op_t op)
-{
-    char *header_buf =
-        (char *) hg_core_handle->out_buf + hg_core_handle->na_out_header_offset;
-    size_t header_buf_size =
-        hg_core_handle->out_buf_size - hg_core_handle->na_out_header_offset;
-    hg_return_t ret;
+/**
+ * Send partial or final response of a stream.
+ */
+static void
+hg_core_stream_send(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t final);
 
-    /* Proc response header */
-    ret = hg_core_header_response_proc(
-        op, header_buf, header_buf_size, hg_core_header);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not process response header");
+/**
+ * Send partial response callback.
+ */
+static void
+hg_core_stream_send_cb(const struct na_cb_info *callback_info);
 
-    if (op == HG_DECODE) {
-        ret = hg_core_header_response_verify(hg_core_header);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            rpc, error, ret, "Could not verify response header");
-    }
+/**
+ * Post recv for credit msg slot (lock must be held).
+ */
+static na_return_t
+hg_core_stream_slot_post(
+    struct hg_core_private_handle *hg_core_handle, unsigned int i);
 
-    return HG_SUCCESS;
+/**
+ * Cancel slots that are no longer needed once the final response is posted
+ * (lock must be held).
+ */
+static void
+hg_core_stream_slots_trim(struct hg_core_private_handle *hg_core_handle);
 
-error:
-    return ret;
-}
+/**
+ * Recv credit msg callback.
+ */
+static void
+hg_core_stream_credit_recv_cb(const struct na_cb_info *callback_info);
 
-/*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_init(const char *na_info_string, hg_bool_t na_listen,
-    unsigned int version, const struct hg_init_info *hg_init_info_p,
+/**
+ * Callback for HG_CORE_MORE_DATA operation.
+ */
+static HG_INLINE void
+hg_core_more_data_complete(hg_core_handle_t handle, hg_return_t ret);
+
+/**
+ * Send ack for HG_CORE_MORE_DATA flag on output.
+ */
+static void
+hg_core_send_ack(hg_core_handle_t handle, hg_return_t ret);
+
+/**
+ * Ack callback. (HG_CORE_MORE_DATA flag on output)
+ */
+static HG_INLINE void
+hg_core_ack_cb(const struct na_cb_info *callback_info);
+
+/**
+ * Hold back ack for HG_CORE_MORE_DATA flag on output so that the next request
+ * to the same target releases the output lease instead.
+ */
+static void
+hg_core_defer_ack(hg_core_handle_t handle, hg_return_t ret);
+
+/**
+ * Grant output lease, the leased handle completes once its ack is received or
+ * a request releases the lease.
+ */
+static void
+hg_core_lease_grant(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Withdraw output lease before its ack completes. Returns HG_TRUE if the
+ * lease was released by a request.
+ */
+static hg_bool_t
+hg_core_lease_revoke(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Release the output lease that a received request refers to.
+ */
+static void
+hg_core_lease_release(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Take a deferred ack that can be carried by the request of hg_core_handle.
+ */
+static void
+hg_core_lease_take(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Request that carried a deferred ack was sent, ack is sent explicitly if the
+ * request could not be delivered.
+ */
+static void
+hg_core_lease_sent(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t delivered);
+
+/**
+ * Send explicit acks that reached their deadline (or all of them if force is
+ * set). Returns HG_TRUE if acks remain deferred, in which case deadline_p is
+ * set to the earliest ack deadline.
+ */
+static hg_bool_t
+hg_core_lease_flush(struct hg_core_private_context *context,
+    hg_bool_t force, hg_time_t *deadline_p);
+
+/**
+ * Send explicit ack of deferred lease.
+ */
+static void
+hg_core_lease_ack(struct hg_core_lease *lease);
+
+/**
+ * Explicit ack callback.
+ */
+static void
+hg_core_lease_ack_cb(const struct na_cb_info *callback_info);
+
+/**
+ * Free deferred lease.
+ */
+static void
+hg_core_lease_free(struct hg_core_lease *lease);
+
+/**
+ * Wait for explicit acks of context to be sent.
+ */
+static hg_return_t
+hg_core_lease_wait(
+    struct hg_core_private_context *context, unsigned int timeout_ms);
+
+/**
+ * Wrapper for local callback execution.
+ */
+static hg_return_t
+hg_core_self_cb(const struct hg_core_cb_info *callback_info);
+
+/**
+ * Process handle (used for self execution).
+ */
+static hg_return_t
+hg_core_process_self(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Process handle.
+ */
+static hg_return_t
+hg_core_process(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Complete handle operation.
+ */
+static HG_INLINE void
+hg_core_complete_op(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Complete handle and add to completion queue.
+ */
+static HG_INLINE void
+hg_core_complete(
+    struct hg_core_private_handle *hg_core_handle, hg_return_t ret);
+
+/**
+ * Make progress.
+ */
+static hg_return_t
+hg_core_progress(
+    struct hg_core_private_context *context, unsigned int timeout_ms);
+
+/**
+ * Make progress on several contexts, ready_p is set to the mask of contexts
+ * that progressed or have completions to trigger.
+ */
+static hg_return_t
+hg_core_progress_multi(struct hg_core_private_context **contexts,
+    unsigned int count, unsigned int timeout_ms, hg_uint64_t *ready_p);
+
+/**
+ * Wait on the poll sets of several contexts at once and process the contexts
+ * that have events.
+ */
+static hg_return_t
+hg_core_progress_multi_wait(struct hg_core_private_context **contexts,
+    unsigned int count, struct hg_poll_set **poll_set_p,
+    unsigned int timeout_ms, hg_uint64_t *ready_p);
+
+/**
+ * Run deferred work of context that is due (expired operations, acks and
+ * coalesced requests) and return the time that a blocking wait must not
+ * exceed.
+ */
+static hg_time_t
+hg_core_progress_deadline(
+    struct hg_core_private_context *context, hg_time_t now, hg_time_t deadline);
+
+/**
+ * Busy-spin on context for at most the current spin budget.
+ */
+static hg_return_t
+hg_core_progress_spin(struct hg_core_private_context *context,
+    hg_time_t deadline, hg_bool_t sampled, hg_bool_t *progressed_p);
+
+/**
+ * Update spin budget from the time spent waiting for a completion.
+ */
+static void
+hg_core_spin_policy_update(
+    struct hg_core_spin_policy *spin_policy, hg_time_t wait_start);
+
+/**
+ * Determines when it is safe to block.
+ */
+static HG_INLINE hg_bool_t
+hg_core_poll_try_wait(struct hg_core_private_context *context);
+
+/**
+ * Poll for timeout ms on context, time spent is profiled if sampled.
+ */
+static hg_return_t
+hg_core_poll_wait(struct hg_core_private_context *context,
+    unsigned int timeout_ms, hg_bool_t sampled, hg_bool_t *progressed_p);
+
+/**
+ * Poll context without blocking, time spent is profiled if sampled.
+ */
+static hg_return_t
+hg_core_poll(struct hg_core_private_context *context, unsigned int timeout_ms,
+    hg_bool_t sampled, hg_bool_t *progressed_p);
+
+/**
+ * Make progress on NA layer, time spent is added to time_p if not NULL.
+ */
+static hg_return_t
+hg_core_progress_na(na_class_t *na_class, na_context_t *na_context,
+    unsigned int timeout_ms, hg_bool_t *progressed_p,
+    hg_atomic_int64_t *time_p);
+
+/**
+ * Make progress on NA layer until no further operation completes, so that
+ * an edge-triggered fd does not need to be reported again. Sets
+ * poll_pending on the context if the fd may not be fully drained.
+ */
+static hg_return_t
+hg_core_progress_na_drain(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context, hg_bool_t *progressed_p,
+    hg_atomic_int64_t *time_p);
+
+/**
+ * Cycles elapsed since cycle count start.
+ */
+static HG_INLINE hg_uint64_t
+hg_core_profile_elapsed(hg_uint64_t start);
+
+/**
+ * Add time elapsed since cycle count start to profile time.
+ */
+static HG_INLINE void
+hg_core_profile_add(hg_atomic_int64_t *time_p, hg_uint64_t start);
+
+/**
+ * Mark progress as about to block so that completions signal the loopback
+ * event.
+ */
+static HG_INLINE void
+hg_core_loopback_arm(struct hg_core_private_context *context);
+
+/**
+ * Signal the loopback event if progress is blocked and it has not been
+ * signaled yet.
+ */
+static HG_INLINE void
+hg_core_loopback_signal(struct hg_core_private_context *context);
+
+/**
+ * Completion queue notification callback.
+ */
+static HG_INLINE hg_return_t
+hg_core_progress_loopback_notify(
+    struct hg_core_private_context *context, hg_bool_t *progressed_p);
+
+/**
+ * Trigger callbacks.
+ */
+static hg_return_t
+hg_core_trigger(struct hg_core_private_context *context,
+    unsigned int timeout_ms, unsigned int max_count,
+    unsigned int *actual_count_p, unsigned int *remaining_count_p);
+
+/**
+ * Free completion queue(s).
+ */
+static void
+hg_core_completion_queue_free(struct hg_core_private_context *context);
+
+/**
+ * Push entry to completion queue(s), high priority entries are pushed to a
+ * separate queue that is always drained first.
+ */
+static HG_INLINE int
+hg_core_completion_queue_push(struct hg_core_private_context *context,
+    struct hg_completion_entry *hg_completion_entry, hg_bool_t high);
+
+/**
+ * Add entry to completion queue and wake up waiters.
+ */
+static void
+hg_core_completion_add_prio(struct hg_core_private_context *context,
+    struct hg_completion_entry *hg_completion_entry, hg_bool_t high,
+    hg_bool_t loopback_notify);
+
+/**
+ * Pop up to max_count entries from completion queue(s).
+ */
+static HG_INLINE unsigned int
+hg_core_completion_queue_pop(struct hg_core_private_context *context,
+    struct hg_completion_entry **entries, unsigned int max_count);
+
+/**
+ * Determine whether completion queue(s) are empty.
+ */
+static HG_INLINE hg_bool_t
+hg_core_completion_queue_is_empty(struct hg_core_private_context *context);
+
+/**
+ * Number of entries in completion queue(s).
+ */
+static HG_INLINE unsigned int
+hg_core_completion_queue_count(struct hg_core_private_context *context);
+
+/**
+ * Trigger a single completion entry.
+ */
+static hg_return_t
+hg_core_trigger_completion_entry(
+    struct hg_completion_entry *hg_completion_entry);
+
+/**
+ * Trigger callback from HG lookup op ID.
+ */
+static hg_return_t
+hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id);
+
+/**
+ * Trigger callback from HG core handle.
+ */
+static hg_return_t
+hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Trigger partial response (origin) or partial respond callback (target).
+ */
+static hg_return_t
+hg_core_trigger_stream_entry(struct hg_core_private_handle *hg_core_handle);
+
+/**
+ * Cancel handle, operation completes with ret_status (e.g., HG_CANCELED or
+ * HG_TIMEOUT) unless it already completed.
+ */
+static hg_return_t
+hg_core_cancel(
+    struct hg_core_private_handle *hg_core_handle, hg_return_t ret_status);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Default ops */
+static const struct hg_core_ops hg_core_ops_na_g = {
+    .forward = hg_core_forward_na,
+    .respond = hg_core_respond_na,
+    .no_respond = hg_core_no_respond_na};
+
+static const struct hg_core_ops hg_core_ops_self_g = {
+    .forward = hg_core_forward_self,
+    .respond = hg_core_respond_self,
+    .no_respond = hg_core_no_respond_self};
+
+/* Default log outlets */
+#ifdef _WIN32
+static HG_LOG_SUBSYS_DECL_REGISTER(HG_CORE_SUBSYS_NAME, hg);
+#else
+/* HG_LOG_DEBUG_LESIZE: default number of debug log entries. */
+#    define HG_LOG_DEBUG_LESIZE (256)
+
+/* Declare debug log for hg */
+static HG_LOG_DEBUG_DECL_LE(HG_CORE_SUBSYS_NAME, HG_LOG_DEBUG_LESIZE);
+static HG_LOG_DEBUG_DECL_DLOG(HG_CORE_SUBSYS_NAME) = HG_LOG_DLOG_INITIALIZER(
+    HG_CORE_SUBSYS_NAME, HG_LOG_DEBUG_LESIZE);
+
+static HG_LOG_SUBSYS_DLOG_DECL_REGISTER(HG_CORE_SUBSYS_NAME, hg);
+#endif
+static HG_LOG_SUBSYS_DECL_STATE_REGISTER(fatal, HG_CORE_SUBSYS_NAME, HG_LOG_ON);
+
+/* Specific log outlets */
+static HG_LOG_SUBSYS_DECL_REGISTER(cls, HG_CORE_SUBSYS_NAME);
+static HG_LOG_SUBSYS_DECL_REGISTER(ctx, HG_CORE_SUBSYS_NAME);
+static HG_LOG_SUBSYS_DECL_REGISTER(addr, HG_CORE_SUBSYS_NAME);
+static HG_LOG_SUBSYS_DECL_REGISTER(rpc, HG_CORE_SUBSYS_NAME);
+static HG_LOG_SUBSYS_DECL_REGISTER(poll, HG_CORE_SUBSYS_NAME);
+
+/* Off by default because of potientally excessive logs */
+static HG_LOG_SUBSYS_DECL_REGISTER(rpc_ref, HG_CORE_SUBSYS_NAME);
+
+/* Off by default because of potientally excessive logs */
+static HG_LOG_SUBSYS_DECL_STATE_REGISTER(
+    poll_loop, HG_CORE_SUBSYS_NAME, HG_LOG_OFF);
+static HG_LOG_SUBSYS_DECL_STATE_REGISTER(perf, HG_CORE_SUBSYS_NAME, HG_LOG_OFF);
+
+#ifndef _WIN32
+/* Declare debug log for stats */
+static HG_LOG_DEBUG_DECL_LE(diag, HG_LOG_DEBUG_LESIZE);
+static HG_LOG_DEBUG_DECL_DLOG(diag) = HG_LOG_DLOG_INITIALIZER(
+    diag, HG_LOG_DEBUG_LESIZE);
+static HG_LOG_SUBSYS_DLOG_DECL_REGISTER(diag, HG_CORE_SUBSYS_NAME);
+#endif
+
+/*---------------------------------------------------------------------------*/
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+static void
+hg_core_counters_init(struct hg_core_counters *hg_core_counters)
+{
+    /* TODO we could revert the linked list to avoid registration in reverse
+     * order */
+    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->bulk_count, "bulk_count",
+        "Bulk transfers (inc. extra bulks)");
+    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_resp_extra_count,
+        "rpc_resp_extra_count", "RPCs with extra bulk response");
+    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_req_extra_count,
+        "rpc_req_extra_count", "RPCs with extra bulk request");
+    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_resp_recv_count,
+        "rpc_resp_recv_count", "RPC responses received");
+    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_resp_sent_count,
+        "rpc_resp_sent_count", "RPC responses sent");
+    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_req_recv_count,
+        "rpc_req_recv_count", "RPC requests received");
+    HG_LOG_ADD_COUNTER64(diag, &hg_core_counters->rpc_req_sent_count,
+        "rpc_req_sent_count", "RPC requests sent");
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_tag_t
+hg_core_gen_request_tag(struct hg_core_private_context *context)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    uint32_t n_blocks =
+        ((uint32_t) hg_core_class->request_max_tag + 1) /
+        HG_CORE_REQUEST_TAG_BLOCK;
+
+    /* Tag space too small to be split, use class-wide tags */
+    if (unlikely(n_blocks < 2)) {
+        na_tag_t request_tag = 0;
+
+        /* Compare and swap tag if reached max tag */
+        if (!hg_atomic_cas32(&hg_core_class->request_block,
+                (int32_t) hg_core_class->request_max_tag, 0)) {
+            /* Increment tag */
+            request_tag =
+                (na_tag_t) hg_atomic_incr32(&hg_core_class->request_block);
+        }
+
+        return request_tag;
+    }
+
+    for (;;) {
+        /* Next tag in low bits, end of block in high bits */
+        int64_t tags = hg_atomic_get64(&context->request_tags);
+        uint32_t next = (uint32_t) tags, end = (uint32_t) (tags >> 32);
+        uint32_t block;
+
+        if (next < end) {
+            if (hg_atomic_cas64(&context->request_tags, tags, tags + 1))
+                return (na_tag_t) next;
+            continue;
+        }
+
+        /* Block is used up, reserve a new one (blocks wrap around within
+         * request_max_tag), a concurrent refill may win the swap in which
+         * case the block is dropped */
+        block = (uint32_t) hg_atomic_incr32(&hg_core_class->request_block) %
+                n_blocks;
+        next = block * HG_CORE_REQUEST_TAG_BLOCK;
+        end = next + HG_CORE_REQUEST_TAG_BLOCK;
+        (void) hg_atomic_cas64(&context->request_tags, tags,
+            (int64_t) (((uint64_t) end << 32) | next));
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_response_table_create(
+    struct hg_core_private_class *hg_core_class, hg_uint32_t size)
+{
+    hg_uint32_t table_size = 1, i;
+    hg_return_t ret;
+
+    /* Rounded up to a power of 2 so that slots are indexed by tag */
+    while (table_size < size && table_size < HG_CORE_RESPONSE_TABLE_MAX)
+        table_size <<= 1;
+
+    hg_core_class->response_table = (hg_atomic_int64_t *) malloc(
+        table_size * sizeof(*hg_core_class->response_table));
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class->response_table == NULL, error,
+        ret, HG_NOMEM, "Could not allocate response table of %" PRIu32 " slots",
+        table_size);
+    for (i = 0; i < table_size; i++)
+        hg_atomic_init64(&hg_core_class->response_table[i], 0);
+    hg_core_class->response_table_mask = (na_tag_t) (table_size - 1);
+
+    HG_LOG_SUBSYS_DEBUG(cls,
+        "Receiving responses as unexpected messages (%" PRIu32 " slots)",
+        table_size);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_response_table_supported(na_class_t *na_class)
+{
+    /* Output buffers are filled from unexpected buffers as is */
+    return NA_Msg_get_max_tag(na_class) >=
+               (HG_CORE_RESPONSE_TAG | (HG_CORE_RESPONSE_TAG - 1)) &&
+           NA_Msg_get_unexpected_header_size(na_class) == 0 &&
+           NA_Msg_get_expected_header_size(na_class) == 0 &&
+           NA_Msg_get_max_unexpected_size(na_class) >=
+               NA_Msg_get_max_expected_size(na_class);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_response_table_insert(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    unsigned int i;
+
+    for (i = 0; i < HG_CORE_RESPONSE_TABLE_PROBES; i++) {
+        na_tag_t tag =
+            hg_core_gen_request_tag(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
+
+        /* Tag must be set before the handle can be matched */
+        hg_core_handle->tag = tag;
+        if (hg_atomic_cas64(&hg_core_class->response_table
+                                 [tag & hg_core_class->response_table_mask],
+                0, (int64_t) (intptr_t) hg_core_handle))
+            return HG_TRUE;
+    }
+
+    HG_LOG_SUBSYS_DEBUG(perf,
+        "Response table is full, pre-posting response of handle %p",
+        (void *) hg_core_handle);
+
+    return HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_private_handle *
+hg_core_response_table_remove(struct hg_core_private_class *hg_core_class,
+    na_tag_t tag, struct hg_core_private_handle *hg_core_handle)
+{
+    na_tag_t index = tag & hg_core_class->response_table_mask;
+    hg_atomic_int64_t *slot = &hg_core_class->response_table[index];
+    int64_t value = hg_atomic_get64(slot);
+    struct hg_core_private_handle *slot_handle =
+        (struct hg_core_private_handle *) (intptr_t) value;
+
+    /* Stale responses (e.g., of canceled requests) do not match */
+    if (slot_handle == NULL || slot_handle->tag != tag ||
+        (hg_core_handle != NULL && slot_handle != hg_core_handle))
+        return NULL;
+
+    /* Only one of the response and cancel paths may remove the handle */
+    return hg_atomic_cas64(slot, value, 0) ? slot_handle : NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_response_cancel(struct hg_core_private_handle *hg_core_handle)
+{
+    /* Response is already being processed */
+    if (hg_core_response_table_remove(HG_CORE_HANDLE_CLASS(hg_core_handle),
+            hg_core_handle->tag, hg_core_handle) == NULL)
+        return;
+
+    HG_LOG_SUBSYS_DEBUG(rpc, "Canceled unexpected response of handle %p",
+        (void *) hg_core_handle);
+
+    hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+        (int32_t) HG_CANCELED);
+
+    /* Complete operation */
+    hg_core_complete_op(hg_core_handle);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_proc_header_request(struct hg_core_handle *hg_core_handle,
+    struct hg_core_header *hg_core_header, hg_proc_op_t op)
+{
+    char *header_buf =
+        (char *) hg_core_handle->in_buf + hg_core_handle->na_in_header_offset;
+    size_t header_buf_size =
+        hg_core_handle->in_buf_size - hg_core_handle->na_in_header_offset;
+    hg_return_t ret;
+
+    /* Proc request header */
+    ret = hg_core_header_request_proc(
+        op, header_buf, header_buf_size, hg_core_header);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not process request header");
+
+    if (op == HG_DECODE) {
+        ret = hg_core_header_request_verify(hg_core_header);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not verify request header");
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_return_t
+hg_core_proc_header_response(struct hg_core_handle *hg_core_handle,
+    struct hg_core_header *hg_core_header, hg_proc_op_t op)
+{
+    char *header_buf =
+        (char *) hg_core_handle->out_buf + hg_core_handle->na_out_header_offset;
+    size_t header_buf_size =
+        hg_core_handle->out_buf_size - hg_core_handle->na_out_header_offset;
+    hg_return_t ret;
+
+    /* Proc response header */
+    ret = hg_core_header_response_proc(
+        op, header_buf, header_buf_size, hg_core_header);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not process response header");
+
+    if (op == HG_DECODE) {
+        ret = hg_core_header_response_verify(hg_core_header);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not verify response header");
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_init(const char *na_info_string, hg_bool_t na_listen,
+    unsigned int version, const struct hg_init_info *hg_init_info_p,
     struct hg_core_private_class **class_p)
 {
-    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
-    struct hg_core_private_class *hg_core_class = NULL;
-#ifdef NA_HAS_SM
-    const char *na_class_name;
-#endif
-    hg_return_t ret;
-    int rc;
+    struct hg_init_info hg_init_info = HG_INIT_INFO_INITIALIZER;
+    struct hg_core_private_class *hg_core_class = NULL;
+#ifdef NA_HAS_SM
+    const char *na_class_name;
+#endif
+    hg_return_t ret;
+    int rc;
+
+    /* Create new HG class (cache line aligned) */
+    hg_core_class = (struct hg_core_private_class *) hg_mem_aligned_alloc(
+        HG_MEM_CACHE_LINE_SIZE, sizeof(*hg_core_class));
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error_free, ret, HG_NOMEM,
+        "Could not allocate HG class");
+    memset(hg_core_class, 0, sizeof(*hg_core_class));
+
+    hg_atomic_init32(&hg_core_class->request_block, 0);
+    hg_atomic_init32(&hg_core_class->n_contexts, 0);
+    hg_atomic_init32(&hg_core_class->n_addrs, 0);
+    hg_atomic_init32(&hg_core_class->n_bulks, 0);
+
+    /* Initialize mutex */
+    rc = hg_thread_rwlock_init(&hg_core_class->rpc_map.lock);
+    HG_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error_free, ret, HG_NOMEM,
+        "hg_thread_rwlock_init() failed");
+
+    /* Peer failure handling */
+    HG_QUEUE_INIT(&hg_core_class->peer_errors.queue);
+    HG_LIST_INIT(&hg_core_class->peer_errors.contexts);
+    hg_atomic_init32(&hg_core_class->peer_errors.count, 0);
+    hg_thread_spin_init(&hg_core_class->peer_errors.lock);
+    hg_thread_mutex_init(&hg_core_class->peer_errors.mutex);
+
+    /* RPC capture */
+    hg_core_class->capture.file = NULL;
+    hg_thread_mutex_init(&hg_core_class->capture.mutex);
+
+    /* Create new function map */
+    hg_core_class->rpc_map.map =
+        hg_hash_table_new(hg_core_map_hash, hg_core_map_equal);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class->rpc_map.map == NULL, error, ret,
+        HG_NOMEM, "Could not create RPC map");
+
+    /* Automatically free all the values with the hash map */
+    hg_hash_table_register_free_functions(
+        hg_core_class->rpc_map.map, NULL, hg_core_map_value_free);
+    hg_atomic_init64(&hg_core_class->rpc_map.snapshot, 0);
+    hg_core_class->rpc_map.retired = NULL;
+    hg_atomic_init32(&hg_core_class->rpc_map.readers, 0);
+
+    /* Ensure init info is API compatible */
+    if (hg_init_info_p) {
+        HG_CHECK_SUBSYS_ERROR(cls, version == 0, error, ret, HG_INVALID_ARG,
+            "API version cannot be 0");
+        HG_LOG_SUBSYS_DEBUG(cls, "Init info version used: v%d.%d",
+            HG_MAJOR(version), HG_MINOR(version));
+
+        /* Get init info and overwrite defaults */
+        if (HG_VERSION_GE(version, HG_VERSION(2, 4)))
+            hg_init_info = *hg_init_info_p;
+        else if (HG_VERSION_GE(version, HG_VERSION(2, 3)))
+            hg_init_info_dup_2_3(&hg_init_info,
+                (const struct hg_init_info_2_3 *) hg_init_info_p);
+        else
+            hg_init_info_dup_2_2(&hg_init_info,
+                (const struct hg_init_info_2_2 *) hg_init_info_p);
+    }
+
+    /* request_post_incr is used only if request_post_init is non-zero */
+    if (hg_init_info.request_post_init == 0) {
+        hg_core_class->init_info.request_post_init = HG_CORE_POST_INIT;
+        hg_core_class->init_info.request_post_incr = HG_CORE_POST_INCR;
+    } else {
+        hg_core_class->init_info.request_post_init =
+            hg_init_info.request_post_init;
+        hg_core_class->init_info.request_post_incr =
+            hg_init_info.request_post_incr;
+    }
+
+    /* Save checksum level */
+#ifdef HG_HAS_CHECKSUMS
+    hg_core_class->init_info.checksum_level = hg_init_info.checksum_level;
+#else
+    HG_CHECK_SUBSYS_WARNING(cls,
+        hg_init_info.checksum_level != HG_CHECKSUM_NONE,
+        "Option checksum_level requires CMake option MERCURY_USE_CHECKSUMS "
+        "to be turned ON.");
+    hg_core_class->init_info.checksum_level = HG_CHECKSUM_NONE;
+#endif
+
+    /* Save progress mode */
+    hg_core_class->init_info.progress_mode =
+        hg_init_info.na_init_info.progress_mode;
+
+    /* Loopback capability */
+    hg_core_class->init_info.loopback = !hg_init_info.no_loopback;
+
+    /* Listening */
+    hg_core_class->init_info.listen = na_listen;
+
+    /* Completion queue sharding */
+    hg_core_class->init_info.completion_queue_shards =
+        hg_init_info.completion_queue_shards;
+
+    /* Progress spin policy */
+    hg_core_class->init_info.progress_spin_max = hg_init_info.progress_spin_max;
+
+    /* Request coalescing */
+    hg_core_class->init_info.request_coalesce_max =
+        hg_init_info.request_coalesce_max;
+    hg_core_class->init_info.request_coalesce_delay =
+        hg_init_info.request_coalesce_delay;
+    hg_core_class->init_info.request_coalesce_adaptive =
+        hg_init_info.request_coalesce_adaptive;
+
+    /* Bulk pipelining */
+    hg_core_class->init_info.bulk_chunk_size = hg_init_info.bulk_chunk_size;
+    hg_core_class->init_info.bulk_max_inflight = hg_init_info.bulk_max_inflight;
+
+    /* Deferred bulk registration */
+    hg_core_class->init_info.bulk_lazy_register =
+        hg_init_info.bulk_lazy_register;
+
+    /* Bulk flow control */
+    hg_core_class->init_info.bulk_max_inflight_size =
+        hg_init_info.bulk_max_inflight_size;
+
+    /* Soft cap on posted requests */
+    hg_core_class->init_info.request_post_max = hg_init_info.request_post_max;
+
+    /* Admission control */
+    hg_core_class->init_info.admission_queue_max =
+        hg_init_info.admission_queue_max;
+    hg_core_class->init_info.admission_delay_max =
+        hg_init_info.admission_delay_max;
+
+    /* Lazy posting of requests */
+    hg_core_class->init_info.request_post_seed = hg_init_info.request_post_seed;
+
+    /* Requests posted across contexts */
+    hg_core_class->init_info.request_post_shared =
+        hg_init_info.request_post_shared;
+    hg_atomic_init32(&hg_core_class->post_shared.count, 0);
+    hg_atomic_init32(&hg_core_class->post_shared.demand, 0);
+
+    /* Memory budget, also charged by NA buffers */
+    hg_core_class->init_info.mem_max = hg_init_info.mem_max;
+    hg_mem_budget_init(&hg_core_class->mem_budget, hg_init_info.mem_max);
+    if (hg_init_info.mem_max > 0 &&
+        hg_init_info.na_init_info.mem_budget == NULL)
+        hg_init_info.na_init_info.mem_budget = &hg_core_class->mem_budget;
+
+    /* Multi-recv buffer auto-tuning */
+    hg_core_class->init_info.multi_recv_mem_max =
+        hg_init_info.multi_recv_mem_max;
+
+    /* Single-threaded class, NA classes are accessed by a single thread too */
+    hg_core_class->init_info.single_thread = hg_init_info.single_thread;
+    if (hg_init_info.single_thread)
+        hg_init_info.na_init_info.thread_mode |= NA_THREAD_MODE_SINGLE;
+
+    /* Per-peer counters */
+    hg_core_class->init_info.peer_stats_max = hg_init_info.peer_stats_max;
+
+    /* Edge-triggered poll set */
+    hg_core_class->init_info.poll_edge_triggered =
+        hg_init_info.poll_edge_triggered;
+
+    /* Stats / counters */
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+    hg_core_counters_init(&hg_core_class->counters);
+#endif
+
+    /* Calibrate cycle counter used for RPC stats now rather than on the first
+     * RPC that completes */
+    (void) hg_time_cycles_freq();
+
+    if (hg_init_info.stats) {
+#ifdef HG_HAS_DEBUG
+        hg_log_set_subsys_level("diag", HG_LOG_LEVEL_DEBUG);
+#else
+        HG_LOG_SUBSYS_WARNING(cls, "stats option requires MERCURY_ENABLE_DEBUG "
+                                   "CMake option to be turned ON.");
+#endif
+    }
+
+    if (hg_init_info.na_class != NULL) {
+        /* External NA class */
+        hg_core_class->core_class.na_class = hg_init_info.na_class;
+        hg_core_class->init_info.na_ext_init = HG_TRUE;
+    } else {
+        /* Initialize NA if not provided externally */
+        hg_core_class->core_class.na_class = NA_Initialize_opt2(na_info_string,
+            hg_core_class->init_info.listen,
+            NA_VERSION(NA_VERSION_MAJOR, NA_VERSION_MINOR),
+            &hg_init_info.na_init_info);
+        HG_CHECK_SUBSYS_ERROR(cls, hg_core_class->core_class.na_class == NULL,
+            error, ret, HG_NA_ERROR,
+            "Could not initialize NA class (info_string=%s, listen=%d)",
+            na_info_string, hg_core_class->init_info.listen);
+    }
+
+    /* Multi-recv capability (currently not compatible with auto_sm) */
+    hg_core_class->init_info.multi_recv =
+        NA_Has_opt_feature(
+            hg_core_class->core_class.na_class, NA_OPT_MULTI_RECV) &&
+        !hg_init_info.no_multi_recv && !hg_init_info.auto_sm;
+    HG_LOG_SUBSYS_DEBUG(
+        cls, "Multi-recv set to %" PRIu8, hg_core_class->init_info.multi_recv);
+
+    /* Compute max request tag */
+    hg_core_class->request_max_tag =
+        NA_Msg_get_max_tag(hg_core_class->core_class.na_class);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class->request_max_tag == 0, error, ret,
+        HG_NA_ERROR, "NA Max tag is not defined");
+
+#ifdef NA_HAS_SM
+    /* Retrieve NA class name */
+    na_class_name = NA_Get_class_name(hg_core_class->core_class.na_class);
+
+    /* Initialize SM plugin */
+    if (hg_init_info.auto_sm && ((strcmp(na_class_name, "mpi") == 0) ||
+                                    (strcmp(na_class_name, "na") == 0))) {
+        HG_LOG_SUBSYS_WARNING(cls,
+            "Auto SM mode is not compatible with current NA class, disabling");
+    } else if (hg_init_info.auto_sm) {
+        char info_string[HG_CORE_ADDR_MAX_SIZE], *info_string_p;
+        na_tag_t na_sm_max_tag;
+        na_return_t na_ret;
+
+        if (hg_init_info.sm_info_string != NULL) {
+            rc = snprintf(info_string, HG_CORE_ADDR_MAX_SIZE, "na+sm://%s",
+                hg_init_info.sm_info_string);
+            HG_CHECK_SUBSYS_ERROR(cls, rc < 0 || rc > HG_CORE_ADDR_MAX_SIZE,
+                error, ret, HG_OVERFLOW, "snprintf() failed, rc: %d", rc);
+            info_string_p = info_string;
+        } else
+            info_string_p = "na+sm";
+
+        /* Initialize NA SM first so that tmp directories are created */
+        hg_core_class->core_class.na_sm_class = NA_Initialize_opt2(
+            info_string_p, hg_core_class->init_info.listen,
+            NA_VERSION(NA_VERSION_MAJOR, NA_VERSION_MINOR),
+            &hg_init_info.na_init_info);
+        HG_CHECK_SUBSYS_ERROR(cls,
+            hg_core_class->core_class.na_sm_class == NULL, error, ret,
+            HG_NA_ERROR,
+            "Could not initialize NA SM class (info_string=%s, listen=%d)",
+            info_string_p, hg_core_class->init_info.listen);
+
+        /* Get SM host ID */
+        na_ret = NA_SM_Host_id_get(&hg_core_class->host_id);
+        HG_CHECK_SUBSYS_ERROR(cls, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "NA_SM_Host_id_get() failed (%s)",
+            NA_Error_to_string(na_ret));
+
+        /* Create addr lookup cache */
+        hg_thread_mutex_init(&hg_core_class->addr_cache.lock);
+        hg_core_class->addr_cache.map = hg_hash_table_new(
+            hg_core_addr_cache_hash, hg_core_addr_cache_equal);
+        HG_CHECK_SUBSYS_ERROR(cls, hg_core_class->addr_cache.map == NULL, error,
+            ret, HG_NOMEM, "Could not create addr lookup cache");
+
+        /* Get max tag */
+        na_sm_max_tag =
+            NA_Msg_get_max_tag(hg_core_class->core_class.na_sm_class);
+        HG_CHECK_SUBSYS_ERROR(cls, na_sm_max_tag == 0, error, ret, HG_NA_ERROR,
+            "NA Max tag is not defined");
+        hg_core_class->request_max_tag =
+            MIN(hg_core_class->request_max_tag, na_sm_max_tag);
+    }
+#else
+    HG_CHECK_SUBSYS_WARNING(cls, hg_init_info.auto_sm,
+        "Option auto_sm requested but NA SM pluging was not compiled, "
+        "please turn ON NA_USE_SM in CMake options");
+#endif
+
+    /* Top tag bit is reserved for responses sent as unexpected messages */
+    hg_core_class->request_max_tag =
+        MIN(hg_core_class->request_max_tag, HG_CORE_RESPONSE_TAG - 1);
+
+    /* Responses received through the unexpected path */
+    if (hg_init_info.response_table_size > 0) {
+        hg_bool_t supported = hg_core_response_table_supported(
+            hg_core_class->core_class.na_class);
+
+#ifdef NA_HAS_SM
+        if (hg_core_class->core_class.na_sm_class != NULL)
+            supported = supported && hg_core_response_table_supported(
+                                         hg_core_class->core_class.na_sm_class);
+#endif
+        if (!hg_core_class->init_info.listen || !supported) {
+            HG_LOG_SUBSYS_WARNING(cls,
+                "Option response_table_size requires a listening class and "
+                "an NA class that supports unexpected responses, disabling");
+        } else {
+            ret = hg_core_response_table_create(
+                hg_core_class, hg_init_info.response_table_size);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                cls, error, ret, "Could not create response table");
+        }
+    }
+
+    /* Additional NA classes used for bulk transfers */
+    hg_core_class->rails.rail[0].na_class = hg_core_class->core_class.na_class;
+    hg_core_class->rails.count = 1;
+    hg_core_class->rails.min_size = (hg_init_info.bulk_rail_min_size > 0)
+                                        ? hg_init_info.bulk_rail_min_size
+                                        : HG_CORE_RAIL_MIN_SIZE_DEFAULT;
+    if (hg_init_info.bulk_rail_count > 0) {
+        ret = hg_core_rails_init(hg_core_class,
+            hg_init_info.bulk_rail_info_strings, hg_init_info.bulk_rail_count,
+            &hg_init_info.na_init_info);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            cls, error, ret, "Could not initialize bulk rails");
+    }
+
+    /* Deferred bulk deregistrations */
+    if (hg_init_info.bulk_dereg_batch > 0) {
+        ret = hg_bulk_dereg_queue_create(
+            hg_init_info.bulk_dereg_batch, &hg_core_class->bulk_dereg_queue);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            cls, error, ret, "Could not create bulk deregistration queue");
+    }
+
+    /* Bulk registration cache (created once NA classes are initialized) */
+    if (hg_init_info.bulk_reg_cache_max > 0) {
+        ret = hg_bulk_reg_cache_create(hg_init_info.bulk_reg_cache_max,
+            hg_core_class->bulk_dereg_queue, &hg_core_class->bulk_reg_cache);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            cls, error, ret, "Could not create bulk registration cache");
+    }
+
+    /* Bulk descriptor cache */
+    if (hg_init_info.bulk_desc_cache_max > 0) {
+        ret = hg_bulk_desc_cache_create(
+            hg_init_info.bulk_desc_cache_max, &hg_core_class->bulk_desc_cache);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            cls, error, ret, "Could not create bulk descriptor cache");
+    }
+
+    /* Fail pending RPCs as soon as NA reports a peer as unreachable */
+    (void) NA_Addr_set_error_callback(hg_core_class->core_class.na_class,
+        hg_core_peer_error_cb, hg_core_class);
+#ifdef NA_HAS_SM
+    if (hg_core_class->core_class.na_sm_class != NULL)
+        (void) NA_Addr_set_error_callback(hg_core_class->core_class.na_sm_class,
+            hg_core_peer_error_cb, hg_core_class);
+#endif
+
+    *class_p = hg_core_class;
+
+    return HG_SUCCESS;
+
+error:
+    (void) hg_core_rails_finalize(hg_core_class);
+    if (hg_core_class->core_class.na_class != NULL &&
+        !hg_core_class->init_info.na_ext_init) {
+        na_return_t na_ret = NA_Finalize(hg_core_class->core_class.na_class);
+        HG_CHECK_SUBSYS_ERROR_DONE(cls, na_ret != NA_SUCCESS,
+            "Could not finalize NA class (%s)", NA_Error_to_string(na_ret));
+    }
+#ifdef NA_HAS_SM
+    if (hg_core_class->core_class.na_sm_class != NULL) {
+        na_return_t na_ret = NA_Finalize(hg_core_class->core_class.na_sm_class);
+        HG_CHECK_SUBSYS_ERROR_DONE(cls, na_ret != NA_SUCCESS,
+            "Could not finalize NA SM class (%s)", NA_Error_to_string(na_ret));
+    }
+    if (hg_core_class->addr_cache.map != NULL) {
+        hg_hash_table_free(hg_core_class->addr_cache.map);
+        (void) hg_thread_mutex_destroy(&hg_core_class->addr_cache.lock);
+    }
+#endif
+    if (hg_core_class->rpc_map.map)
+        hg_hash_table_free(hg_core_class->rpc_map.map);
+    hg_core_map_snapshot_free(&hg_core_class->rpc_map);
+    (void) hg_thread_rwlock_destroy(&hg_core_class->rpc_map.lock);
+    (void) hg_thread_spin_destroy(&hg_core_class->peer_errors.lock);
+    (void) hg_thread_mutex_destroy(&hg_core_class->peer_errors.mutex);
+    if (hg_core_class->capture.file != NULL)
+        fclose(hg_core_class->capture.file);
+    (void) hg_thread_mutex_destroy(&hg_core_class->capture.mutex);
+    free(hg_core_class->response_table);
+
+error_free:
+    hg_mem_aligned_free(hg_core_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_finalize(struct hg_core_private_class *hg_core_class)
+{
+    int32_t n_addrs, n_contexts, n_bulks;
+    hg_return_t ret;
+
+    if (hg_core_class == NULL)
+        return HG_SUCCESS;
+
+    /* Cached bulk handles hold bulk and addr references */
+    if (hg_core_class->bulk_desc_cache != NULL) {
+        hg_bulk_desc_cache_destroy(hg_core_class->bulk_desc_cache);
+        hg_core_class->bulk_desc_cache = NULL;
+    }
+
+    /* Deferred handles still hold bulk and addr references */
+    if (hg_core_class->bulk_dereg_queue != NULL)
+        hg_bulk_dereg_queue_drain(hg_core_class->bulk_dereg_queue, HG_TRUE);
+
+    n_bulks = hg_atomic_get32(&hg_core_class->n_bulks);
+    HG_CHECK_SUBSYS_ERROR(cls, n_bulks != 0, error, ret, HG_BUSY,
+        "HG bulk handles must be destroyed before finalizing HG (%d "
+        "remaining)",
+        n_bulks);
+
+    n_contexts = hg_atomic_get32(&hg_core_class->n_contexts);
+    HG_CHECK_SUBSYS_ERROR(cls, n_contexts != 0, error, ret, HG_BUSY,
+        "HG contexts must be destroyed before finalizing HG (%d remaining)",
+        n_contexts);
+
+    n_addrs = hg_atomic_get32(&hg_core_class->n_addrs);
+    HG_CHECK_SUBSYS_ERROR(cls, n_addrs != 0, error, ret, HG_BUSY,
+        "HG addrs must be freed before finalizing HG (%d remaining)", n_addrs);
+
+    /* Release cached registrations before NA classes are finalized */
+    if (hg_core_class->bulk_reg_cache != NULL) {
+        ret = hg_bulk_reg_cache_destroy(hg_core_class->bulk_reg_cache);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            cls, error, ret, "Could not destroy bulk registration cache");
+        hg_core_class->bulk_reg_cache = NULL;
+    }
+    if (hg_core_class->bulk_dereg_queue != NULL) {
+        hg_bulk_dereg_queue_destroy(hg_core_class->bulk_dereg_queue);
+        hg_core_class->bulk_dereg_queue = NULL;
+    }
+
+    /* Release dead peers that were never purged */
+    while (!HG_QUEUE_IS_EMPTY(&hg_core_class->peer_errors.queue)) {
+        struct hg_core_dead_peer *dead_peer =
+            HG_QUEUE_FIRST(&hg_core_class->peer_errors.queue);
+
+        HG_QUEUE_POP_HEAD(&hg_core_class->peer_errors.queue, entry);
+        NA_Addr_free(dead_peer->na_class, dead_peer->na_addr);
+        free(dead_peer);
+    }
+    hg_atomic_set32(&hg_core_class->peer_errors.count, 0);
+
+    /* Finalize additional NA classes used for bulk transfers */
+    ret = hg_core_rails_finalize(hg_core_class);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret, "Could not finalize bulk rails");
+
+    /* External NA class outlives HG class */
+    if (hg_core_class->core_class.na_class != NULL &&
+        hg_core_class->init_info.na_ext_init)
+        (void) NA_Addr_set_error_callback(
+            hg_core_class->core_class.na_class, NULL, NULL);
+
+    /* Finalize NA class */
+    if (hg_core_class->core_class.na_class != NULL &&
+        !hg_core_class->init_info.na_ext_init) {
+        na_return_t na_ret = NA_Finalize(hg_core_class->core_class.na_class);
+        HG_CHECK_SUBSYS_ERROR(cls, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not finalize NA class (%s)",
+            NA_Error_to_string(na_ret));
+        hg_core_class->core_class.na_class = NULL;
+    }
+
+#ifdef NA_HAS_SM
+    /* Finalize NA SM class */
+    if (hg_core_class->core_class.na_sm_class != NULL) {
+        na_return_t na_ret = NA_Finalize(hg_core_class->core_class.na_sm_class);
+        HG_CHECK_SUBSYS_ERROR(cls, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not finalize NA SM class (%s)",
+            NA_Error_to_string(na_ret));
+        hg_core_class->core_class.na_sm_class = NULL;
+    }
+#endif
+
+#ifdef NA_HAS_SM
+    /* Delete addr lookup cache (all addrs have been freed) */
+    if (hg_core_class->addr_cache.map != NULL) {
+        hg_hash_table_free(hg_core_class->addr_cache.map);
+        hg_core_class->addr_cache.map = NULL;
+        (void) hg_thread_mutex_destroy(&hg_core_class->addr_cache.lock);
+    }
+#endif
+
+    /* Free user data */
+    if (hg_core_class->core_class.data_free_callback)
+        hg_core_class->core_class.data_free_callback(
+            hg_core_class->core_class.data);
+
+    /* Delete RPC map */
+    if (hg_core_class->rpc_map.map != NULL) {
+        hg_hash_table_free(hg_core_class->rpc_map.map);
+        hg_core_class->rpc_map.map = NULL;
+    }
+    hg_core_map_snapshot_free(&hg_core_class->rpc_map);
+    (void) hg_thread_rwlock_destroy(&hg_core_class->rpc_map.lock);
+    (void) hg_thread_spin_destroy(&hg_core_class->peer_errors.lock);
+    (void) hg_thread_mutex_destroy(&hg_core_class->peer_errors.mutex);
+    if (hg_core_class->capture.file != NULL)
+        fclose(hg_core_class->capture.file);
+    (void) hg_thread_mutex_destroy(&hg_core_class->capture.mutex);
+    free(hg_core_class->response_table);
+    hg_mem_aligned_free(hg_core_class);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_rails_init(struct hg_core_private_class *hg_core_class,
+    const char *const *info_strings, hg_uint32_t count,
+    const struct na_init_info *na_init_info)
+{
+    struct hg_core_rails *rails = &hg_core_class->rails;
+    hg_uint32_t i;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(cls, info_strings == NULL, error, ret,
+        HG_INVALID_ARG, "NULL bulk rail info strings");
+    HG_CHECK_SUBSYS_ERROR(cls, count > HG_CORE_RAIL_MAX - 1, error, ret,
+        HG_INVALID_ARG, "Number of bulk rails (%" PRIu32 ") exceeds %d", count,
+        HG_CORE_RAIL_MAX - 1);
+
+    for (i = 0; i < count; i++) {
+        struct hg_core_rail *rail = &rails->rail[i + 1];
+        na_return_t na_ret;
+
+        rail->na_class = NA_Initialize_opt2(info_strings[i],
+            hg_core_class->init_info.listen,
+            NA_VERSION(NA_VERSION_MAJOR, NA_VERSION_MINOR), na_init_info);
+        HG_CHECK_SUBSYS_ERROR(cls, rail->na_class == NULL, error, ret,
+            HG_NA_ERROR,
+            "Could not initialize NA class for bulk rail (info_string=%s)",
+            info_strings[i]);
+        rails->count++;
+
+        /* Peers reach rails through the address embedded in descriptors */
+        na_ret = NA_Addr_self(rail->na_class, &rail->self_addr);
+        HG_CHECK_SUBSYS_ERROR(cls, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret,
+            "Could not get self address of bulk rail (%s)",
+            NA_Error_to_string(na_ret));
+
+        rail->self_addr_size =
+            NA_Addr_get_serialize_size(rail->na_class, rail->self_addr);
+        HG_CHECK_SUBSYS_ERROR(cls, rail->self_addr_size == 0, error, ret,
+            HG_OPNOTSUPPORTED,
+            "NA class of bulk rail (%s) does not support address serialization",
+            NA_Get_class_name(rail->na_class));
+
+        HG_LOG_SUBSYS_DEBUG(cls, "Initialized bulk rail %" PRIu32 " (%s)",
+            i + 1, info_strings[i]);
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_rails_finalize(struct hg_core_private_class *hg_core_class)
+{
+    struct hg_core_rails *rails = &hg_core_class->rails;
+    hg_return_t ret;
+
+    for (; rails->count > 1; rails->count--) {
+        struct hg_core_rail *rail = &rails->rail[rails->count - 1];
+        na_return_t na_ret;
+
+        if (rail->self_addr != NULL) {
+            NA_Addr_free(rail->na_class, rail->self_addr);
+            rail->self_addr = NULL;
+        }
+
+        na_ret = NA_Finalize(rail->na_class);
+        HG_CHECK_SUBSYS_ERROR(cls, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret,
+            "Could not finalize NA class of bulk rail (%s)",
+            NA_Error_to_string(na_ret));
+        rail->na_class = NULL;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_core_rails *
+hg_core_class_get_rails(hg_core_class_t *hg_core_class)
+{
+    return &((struct hg_core_private_class *) hg_core_class)->rails;
+}
+
+/*---------------------------------------------------------------------------*/
+na_context_t *
+hg_core_context_get_na_rail(hg_core_context_t *core_context, hg_uint8_t index)
+{
+    return ((struct hg_core_private_context *) core_context)
+        ->na_rail_contexts[index];
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_reg_cache *
+hg_core_class_get_bulk_reg_cache(hg_core_class_t *hg_core_class)
+{
+    return ((struct hg_core_private_class *) hg_core_class)->bulk_reg_cache;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_mem_budget *
+hg_core_class_get_mem_budget(hg_core_class_t *hg_core_class)
+{
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+
+    return (private_class->init_info.mem_max > 0) ? &private_class->mem_budget
+                                                  : NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_desc_cache *
+hg_core_class_get_bulk_desc_cache(hg_core_class_t *hg_core_class)
+{
+    return ((struct hg_core_private_class *) hg_core_class)->bulk_desc_cache;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_dereg_queue *
+hg_core_class_get_bulk_dereg_queue(hg_core_class_t *hg_core_class)
+{
+    return ((struct hg_core_private_class *) hg_core_class)->bulk_dereg_queue;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_class_get_bulk_pipeline_info(hg_core_class_t *hg_core_class,
+    hg_size_t *chunk_size_p, hg_uint32_t *max_inflight_p)
+{
+    const struct hg_core_init_info *init_info =
+        &((struct hg_core_private_class *) hg_core_class)->init_info;
+
+    *chunk_size_p = init_info->bulk_chunk_size;
+    *max_inflight_p = init_info->bulk_max_inflight;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+hg_core_class_get_bulk_lazy_register(hg_core_class_t *hg_core_class)
+{
+    return ((struct hg_core_private_class *) hg_core_class)
+        ->init_info.bulk_lazy_register;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_size_t
+hg_core_class_get_bulk_max_inflight_size(hg_core_class_t *hg_core_class)
+{
+    return ((struct hg_core_private_class *) hg_core_class)
+        ->init_info.bulk_max_inflight_size;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_bulk_incr(hg_core_class_t *hg_core_class)
+{
+    hg_atomic_incr32(
+        &((struct hg_core_private_class *) hg_core_class)->n_bulks);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_bulk_decr(hg_core_class_t *hg_core_class)
+{
+    hg_atomic_decr32(
+        &((struct hg_core_private_class *) hg_core_class)->n_bulks);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_create(struct hg_core_private_class *hg_core_class,
+    hg_uint8_t id, const struct na_context_info *na_context_info,
+    struct hg_core_private_context **context_p)
+{
+    struct hg_core_private_context *context = NULL;
+    struct hg_core_completion_wait *completion_wait = NULL;
+    hg_return_t ret;
+    int na_poll_fd, loopback_event = 0, rc;
+    unsigned int i;
+    hg_bool_t completion_wait_mutex_init = HG_FALSE,
+              completion_wait_cond_init = HG_FALSE,
+              coalesce_mutex_init = HG_FALSE,
+              multi_recv_mutex_init = HG_FALSE,
+              user_list_lock_init = HG_FALSE,
+              internal_list_lock_init = HG_FALSE,
+              addr_refs_lock_init = HG_FALSE,
+              leases_lock_init = HG_FALSE,
+              timer_wheel_lock_init = HG_FALSE;
+#ifdef HG_HAS_MULTI_PROGRESS
+    struct hg_core_progress_multi *progress_multi = NULL;
+    bool progress_multi_mutex_init = false, progress_multi_cond_init = false;
+#endif
+
+    context = (struct hg_core_private_context *) hg_mem_aligned_alloc(
+        HG_MEM_CACHE_LINE_SIZE, sizeof(*context));
+    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG context");
+    memset(context, 0, sizeof(*context));
+    hg_atomic_init32(&context->n_handles, 0);
+    hg_atomic_init32(&context->unposting, 0);
+    hg_atomic_init64(&context->request_tags, 0);
+
+    /* Start optimistically with the max spin budget */
+    context->spin_policy.max = hg_core_class->init_info.progress_spin_max;
+    hg_atomic_init32(
+        &context->spin_policy.budget, (int32_t) context->spin_policy.max);
+    hg_atomic_init32(&context->spin_policy.wait_avg, 0);
+
+    /* Request coalescing */
+    HG_LIST_INIT(&context->coalesce.pending_list);
+    HG_LIST_INIT(&context->coalesce.free_list);
+    hg_atomic_init32(&context->coalesce.pending_count, 0);
+    context->coalesce.max =
+        (hg_core_class->init_info.request_coalesce_max > 1)
+            ? hg_core_class->init_info.request_coalesce_max
+            : 0;
+    context->coalesce.delay = hg_core_class->init_info.request_coalesce_delay;
+    if (context->coalesce.max > 0 &&
+        hg_core_class->init_info.request_coalesce_adaptive) {
+        context->coalesce.peers = (struct hg_core_coalesce_peer *) calloc(
+            HG_CORE_COALESCE_PEER_MAX, sizeof(*context->coalesce.peers));
+        HG_CHECK_SUBSYS_ERROR(ctx, context->coalesce.peers == NULL, error, ret,
+            HG_NOMEM, "Could not allocate coalescing peer table");
+    }
+
+    /* Admission control */
+    context->admission.queue_max =
+        hg_core_class->init_info.admission_queue_max;
+    context->admission.wait_max =
+        (hg_uint64_t) hg_core_class->init_info.admission_delay_max *
+        hg_time_cycles_freq() / 1000000;
+    hg_atomic_init64(&context->admission.wait_avg, 0);
+    hg_atomic_init64(&context->admission.shed_count, 0);
+    hg_atomic_init32(&context->admission.queued, 0);
+    rc = hg_thread_mutex_init(&context->coalesce.mutex);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_mutex_init() failed");
+    coalesce_mutex_init = HG_TRUE;
+
+    context->core_context.core_class = (struct hg_core_class *) hg_core_class;
+    completion_wait = &context->completion_wait;
+
+    rc = hg_thread_mutex_init(&completion_wait->mutex);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_mutex_init() failed");
+    completion_wait_mutex_init = HG_TRUE;
+    rc = hg_thread_cond_init(&completion_wait->cond);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_cond_init() failed");
+    completion_wait_cond_init = HG_TRUE;
+    hg_atomic_init32(&completion_wait->waiters, 0);
+
+    if (hg_core_class->init_info.completion_queue_shards > 1) {
+        context->n_completion_shards =
+            hg_core_class->init_info.completion_queue_shards;
+        context->completion_shards = (struct hg_atomic_seg_queue **) calloc(
+            context->n_completion_shards, sizeof(struct hg_atomic_seg_queue *));
+        HG_CHECK_SUBSYS_ERROR(ctx, context->completion_shards == NULL, error,
+            ret, HG_NOMEM, "Could not allocate array of queues");
+
+        for (i = 0; i < context->n_completion_shards; i++) {
+            context->completion_shards[i] =
+                hg_atomic_seg_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
+            HG_CHECK_SUBSYS_ERROR(ctx, context->completion_shards[i] == NULL,
+                error, ret, HG_NOMEM, "Could not allocate queue");
+        }
+        hg_atomic_init32(&context->completion_shard_next, 0);
+        HG_LOG_SUBSYS_DEBUG(ctx, "Using %u completion queues",
+            context->n_completion_shards);
+
+        /* First shard is also the default queue */
+        context->completion_queue = context->completion_shards[0];
+    } else {
+        context->completion_queue =
+            hg_atomic_seg_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
+        HG_CHECK_SUBSYS_ERROR(ctx, context->completion_queue == NULL, error,
+            ret, HG_NOMEM, "Could not allocate queue");
+    }
+
+    context->completion_high =
+        hg_atomic_seg_queue_alloc(HG_CORE_ATOMIC_QUEUE_HIGH_SIZE);
+    HG_CHECK_SUBSYS_ERROR(ctx, context->completion_high == NULL, error, ret,
+        HG_NOMEM, "Could not allocate high priority queue");
+
+    /* Notifications of completion queue events */
+    hg_atomic_init32(&context->loopback_notify.state, 0);
+
+    rc = hg_thread_mutex_init(&context->multi_recv_mutex);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_mutex_init() failed");
+    multi_recv_mutex_init = HG_TRUE;
+
+    HG_LIST_INIT(&context->user_list.list);
+    rc = hg_thread_spin_init(&context->user_list.lock);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_spin_init() failed");
+    user_list_lock_init = HG_TRUE;
+    context->user_list.single_thread = hg_core_class->init_info.single_thread;
+
+    HG_LIST_INIT(&context->internal_list.list);
+    rc = hg_thread_spin_init(&context->internal_list.lock);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_spin_init() failed");
+    internal_list_lock_init = HG_TRUE;
+    context->internal_list.single_thread =
+        hg_core_class->init_info.single_thread;
+
+    rc = hg_thread_spin_init(&context->addr_refs.lock);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_spin_init() failed");
+    addr_refs_lock_init = HG_TRUE;
+
+    ret = hg_core_peer_table_init(
+        &context->peer_table, hg_core_class->init_info.peer_stats_max);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not create peer table");
+
+    HG_LIST_INIT(&context->leases.granted);
+    HG_LIST_INIT(&context->leases.deferred);
+    hg_atomic_init32(&context->leases.deferred_count, 0);
+    hg_atomic_init32(&context->leases.ack_count, 0);
+    rc = hg_thread_spin_init(&context->leases.lock);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_spin_init() failed");
+    leases_lock_init = HG_TRUE;
+
+    for (i = 0; i < HG_CORE_TIMER_WHEEL_SIZE; i++)
+        HG_LIST_INIT(&context->timer_wheel.slots[i]);
+    hg_time_get_current(&context->timer_wheel.start);
+    hg_atomic_init32(&context->timer_wheel.count, 0);
+    rc = hg_thread_spin_init(&context->timer_wheel.lock);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_spin_init() failed");
+    timer_wheel_lock_init = HG_TRUE;
+
+#ifdef HG_HAS_MULTI_PROGRESS
+    /* Initialize multi-progress lock */
+    progress_multi = &context->progress_multi;
+    hg_atomic_init32(&progress_multi->count, 0);
+    rc = hg_thread_mutex_init(&progress_multi->mutex);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_mutex_init() failed");
+    progress_multi_mutex_init = true;
+
+    rc = hg_thread_cond_init(&progress_multi->cond);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_cond_init() failed");
+    progress_multi_cond_init = true;
+#endif
+
+    /* Create NA context */
+    context->core_context.na_context = NA_Context_create_opt(
+        hg_core_class->core_class.na_class, id, na_context_info);
+    HG_CHECK_SUBSYS_ERROR(ctx, context->core_context.na_context == NULL, error,
+        ret, HG_NOMEM, "Could not create NA context");
+
+#ifdef NA_HAS_SM
+    if (hg_core_class->core_class.na_sm_class) {
+        context->core_context.na_sm_context =
+            NA_Context_create(hg_core_class->core_class.na_sm_class);
+        HG_CHECK_SUBSYS_ERROR(ctx, context->core_context.na_sm_context == NULL,
+            error, ret, HG_NOMEM, "Could not create NA SM context");
+    }
+#endif
+
+    /* Create NA contexts of additional bulk rails (with the same ID so that
+     * remote rail contexts can be targeted) */
+    for (i = 1; i < hg_core_class->rails.count; i++) {
+        context->na_rail_contexts[i] =
+            NA_Context_create_id(hg_core_class->rails.rail[i].na_class, id);
+        HG_CHECK_SUBSYS_ERROR(ctx, context->na_rail_contexts[i] == NULL, error,
+            ret, HG_NOMEM, "Could not create NA context of bulk rail %u", i);
+    }
+
+    /* If NA plugin exposes fd, we will use poll set and use appropriate
+     * progress function */
+    na_poll_fd = NA_Poll_get_fd(
+        hg_core_class->core_class.na_class, context->core_context.na_context);
+
+    if (!(hg_core_class->init_info.progress_mode & NA_NO_BLOCK) &&
+        (na_poll_fd > 0)) {
+        struct hg_poll_event event = {.events = HG_POLLIN, .data.u64 = 0};
+
+        /* Fds are then drained by hg_core_poll_wait() */
+        if (hg_core_class->init_info.poll_edge_triggered)
+            event.events |= HG_POLLET;
+
+        /* Create poll set */
+        context->poll_set = hg_poll_create();
+        HG_CHECK_SUBSYS_ERROR(ctx, context->poll_set == NULL, error, ret,
+            HG_NOMEM, "Could not create poll set");
+
+        event.data.u32 = (uint32_t) HG_CORE_POLL_NA;
+        rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+            "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
+        context->na_event = na_poll_fd;
+
+#ifdef NA_HAS_SM
+        if (hg_core_class->core_class.na_sm_class &&
+            context->core_context.na_sm_context) {
+            na_poll_fd = NA_Poll_get_fd(hg_core_class->core_class.na_sm_class,
+                context->core_context.na_sm_context);
+            HG_CHECK_SUBSYS_ERROR(ctx, na_poll_fd < 0, error, ret,
+                HG_PROTOCOL_ERROR, "Could not get NA SM poll fd");
+
+            event.data.u32 = (uint32_t) HG_CORE_POLL_SM;
+            rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
+            HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+                HG_NOMEM, "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
+            context->na_sm_event = na_poll_fd;
+        }
+#endif
+
+        for (i = 1; i < hg_core_class->rails.count; i++) {
+            na_poll_fd = NA_Poll_get_fd(hg_core_class->rails.rail[i].na_class,
+                context->na_rail_contexts[i]);
+            if (na_poll_fd <= 0) {
+                /* Cannot block on that rail, do not use it on this context */
+                HG_LOG_SUBSYS_WARNING(ctx,
+                    "Bulk rail %u does not expose a poll fd, disabling it", i);
+                (void) NA_Context_destroy(hg_core_class->rails.rail[i].na_class,
+                    context->na_rail_contexts[i]);
+                context->na_rail_contexts[i] = NULL;
+                continue;
+            }
+
+            event.data.u32 = (uint32_t) HG_CORE_POLL_RAIL + i;
+            rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
+            HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+                HG_NOMEM, "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
+            context->na_rail_events[i] = na_poll_fd;
+        }
+
+        if (hg_core_class->init_info.loopback) {
+            /* Create event for completion queue notification */
+            loopback_event = hg_event_create();
+            HG_CHECK_SUBSYS_ERROR(ctx, loopback_event < 0, error, ret, HG_NOMEM,
+                "Could not create event");
+
+            /* Add event to context poll set */
+            event.data.u32 = (uint32_t) HG_CORE_POLL_LOOPBACK;
+            rc = hg_poll_add(context->poll_set, loopback_event, &event);
+            HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+                HG_NOMEM, "hg_poll_add() failed (loopback_event=%d)",
+                loopback_event);
+            context->loopback_notify.event = loopback_event;
+        }
+    }
+
+    /* Assign context ID */
+    context->core_context.id = id;
+
+    /* Create pool of bulk op IDs */
+    ret = hg_bulk_op_pool_create((hg_core_context_t *) context,
+        HG_CORE_BULK_OP_INIT_COUNT, &context->hg_bulk_op_pool);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not create bulk op pool");
+
+    /* Increment context count of parent class */
+    hg_atomic_incr32(&HG_CORE_CONTEXT_CLASS(context)->n_contexts);
+
+    /* Make handles of context visible to peer purges */
+    hg_thread_mutex_lock(&hg_core_class->peer_errors.mutex);
+    HG_LIST_INSERT_HEAD(&hg_core_class->peer_errors.contexts, context, entry);
+    hg_thread_mutex_unlock(&hg_core_class->peer_errors.mutex);
+
+    *context_p = context;
+
+    return HG_SUCCESS;
+
+error:
+    if (context != NULL) {
+        if (context->poll_set != NULL) {
+            if (context->na_event > 0) {
+                rc = hg_poll_remove(context->poll_set, context->na_event);
+                HG_CHECK_SUBSYS_ERROR_DONE(ctx, rc != HG_UTIL_SUCCESS,
+                    "Could not remove NA poll descriptor from poll set");
+            }
+#ifdef NA_HAS_SM
+            if (context->na_sm_event > 0) {
+                rc = hg_poll_remove(context->poll_set, context->na_sm_event);
+                HG_CHECK_SUBSYS_ERROR_DONE(ctx, rc != HG_UTIL_SUCCESS,
+                    "Could not remove NA SM poll descriptor from poll set");
+            }
+#endif
+            for (i = 1; i < HG_CORE_RAIL_MAX; i++) {
+                if (context->na_rail_events[i] <= 0)
+                    continue;
+                rc = hg_poll_remove(
+                    context->poll_set, context->na_rail_events[i]);
+                HG_CHECK_SUBSYS_ERROR_DONE(ctx, rc != HG_UTIL_SUCCESS,
+                    "Could not remove NA rail poll descriptor from poll set");
+            }
+            if (context->loopback_notify.event > 0) {
+                rc = hg_poll_remove(
+                    context->poll_set, context->loopback_notify.event);
+                HG_CHECK_SUBSYS_ERROR_DONE(ctx, rc != HG_UTIL_SUCCESS,
+                    "Could not remove loopback poll descriptor from poll set");
+            }
+            rc = hg_poll_destroy(context->poll_set);
+            HG_CHECK_SUBSYS_ERROR_DONE(
+                ctx, rc != HG_UTIL_SUCCESS, "Could not destroy poll set");
+        }
+
+        if (loopback_event > 0) {
+            rc = hg_event_destroy(loopback_event);
+            HG_CHECK_SUBSYS_ERROR_DONE(
+                ctx, rc != HG_UTIL_SUCCESS, "Could not destroy loopback event");
+        }
+
+        if (context->core_context.na_context != NULL) {
+            na_return_t na_ret =
+                NA_Context_destroy(hg_core_class->core_class.na_class,
+                    context->core_context.na_context);
+            HG_CHECK_SUBSYS_ERROR_DONE(ctx, na_ret != NA_SUCCESS,
+                "Could not destroy NA context (%s)",
+                NA_Error_to_string(na_ret));
+        }
+#ifdef NA_HAS_SM
+        if (context->core_context.na_sm_context != NULL) {
+            na_return_t na_ret =
+                NA_Context_destroy(hg_core_class->core_class.na_sm_class,
+                    context->core_context.na_sm_context);
+            HG_CHECK_SUBSYS_ERROR_DONE(ctx, na_ret != NA_SUCCESS,
+                "Could not destroy NA SM context (%s)",
+                NA_Error_to_string(na_ret));
+        }
+#endif
+        for (i = 1; i < HG_CORE_RAIL_MAX; i++) {
+            na_return_t na_ret;
+
+            if (context->na_rail_contexts[i] == NULL)
+                continue;
+            na_ret = NA_Context_destroy(hg_core_class->rails.rail[i].na_class,
+                context->na_rail_contexts[i]);
+            HG_CHECK_SUBSYS_ERROR_DONE(ctx, na_ret != NA_SUCCESS,
+                "Could not destroy NA rail context (%s)",
+                NA_Error_to_string(na_ret));
+        }
+
+        if (completion_wait_mutex_init)
+            (void) hg_thread_mutex_destroy(&completion_wait->mutex);
+        if (completion_wait_cond_init)
+            (void) hg_thread_cond_destroy(&completion_wait->cond);
+        if (multi_recv_mutex_init)
+            (void) hg_thread_mutex_destroy(&context->multi_recv_mutex);
+        if (coalesce_mutex_init)
+            (void) hg_thread_mutex_destroy(&context->coalesce.mutex);
+        free(context->coalesce.peers);
+        if (user_list_lock_init)
+            (void) hg_thread_spin_destroy(&context->user_list.lock);
+        if (internal_list_lock_init)
+            (void) hg_thread_spin_destroy(&context->internal_list.lock);
+        if (addr_refs_lock_init)
+            (void) hg_thread_spin_destroy(&context->addr_refs.lock);
+        hg_core_peer_table_free(&context->peer_table);
+        if (leases_lock_init)
+            (void) hg_thread_spin_destroy(&context->leases.lock);
+        if (timer_wheel_lock_init)
+            (void) hg_thread_spin_destroy(&context->timer_wheel.lock);
+#ifdef HG_HAS_MULTI_PROGRESS
+        if (progress_multi_mutex_init)
+            (void) hg_thread_mutex_destroy(&progress_multi->mutex);
+        if (progress_multi_cond_init)
+            (void) hg_thread_cond_destroy(&progress_multi->cond);
+#endif
+        hg_core_completion_queue_free(context);
+        hg_mem_aligned_free(context);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_destroy(struct hg_core_private_context *context,
+    unsigned int timeout_ms, hg_bool_t quiescent)
+{
+    struct hg_core_private_class *hg_core_class = NULL;
+#ifdef HG_HAS_MULTI_PROGRESS
+    struct hg_core_progress_multi *progress_multi = NULL;
+#endif
+    hg_bool_t empty;
+    hg_return_t ret;
+    unsigned int i;
+    int rc;
+
+    if (context == NULL)
+        return HG_SUCCESS;
+
+    /* Keep reference to class */
+    hg_core_class = HG_CORE_CONTEXT_CLASS(context);
+#ifdef HG_HAS_MULTI_PROGRESS
+    /* Check that we are no longer progressing */
+    progress_multi = &context->progress_multi;
+    HG_CHECK_SUBSYS_ERROR(ctx, hg_atomic_get32(&progress_multi->count) > 0,
+        error, ret, HG_BUSY, "Still progressing on context");
+#endif
+
+    /* Send requests that are still held back for coalescing */
+    if (context->coalesce.max > 0)
+        (void) hg_core_coalesce_flush(context, HG_TRUE, NULL);
+
+    /* Send acks that are still held back so that targets release their
+     * output leases */
+    (void) hg_core_lease_flush(context, HG_TRUE, NULL);
+
+    if (context->posted) {
+        /* Unpost requests */
+        ret = hg_core_context_unpost(context, timeout_ms);
+        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not unpost requests");
+    }
+
+    /* Caller guarantees that user handles and leases are no longer in use */
+    if (!quiescent) {
+        /* Wait on created list (user created handles) */
+        ret = hg_core_context_list_wait(
+            context, &context->user_list, timeout_ms);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not wait on handle list");
+
+        /* Wait on acks of output leases */
+        ret = hg_core_lease_wait(context, timeout_ms);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not wait on lease acks");
+    }
+    HG_CHECK_SUBSYS_ERROR(ctx,
+        hg_atomic_get32(&context->leases.ack_count) > 0, error, ret, HG_BUSY,
+        "Acks of output leases are still being sent");
+
+    /* Number of handles for that context should be 0 */
+    if (hg_atomic_get32(&context->n_handles) > 0) {
+        HG_LOG_SUBSYS_ERROR(ctx,
+            "HG core handles must be freed before destroying context (%" PRId32
+            " remaining)",
+            hg_atomic_get32(&context->n_handles));
+
+        ret = hg_core_context_check_handle_list(&context->user_list);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "User-created handles are still in use");
+
+        ret = hg_core_context_check_handle_list(&context->internal_list);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Internal handles are still in use");
+    }
+
+    /* Check that completion queue is empty now */
+    empty = hg_core_completion_queue_is_empty(context);
+    HG_CHECK_SUBSYS_ERROR(ctx, empty == HG_FALSE, error, ret, HG_BUSY,
+        "Completion queue should be empty");
+
+    hg_thread_mutex_lock(&hg_core_class->peer_errors.mutex);
+    HG_LIST_REMOVE(context, entry);
+    hg_thread_mutex_unlock(&hg_core_class->peer_errors.mutex);
+
+    /* Release NA addrs of peers counted, no longer visible to readers */
+    hg_core_peer_table_free(&context->peer_table);
+
+    /* Destroy pool of bulk op IDs */
+    if (context->hg_bulk_op_pool != NULL) {
+        hg_bulk_op_pool_destroy(context->hg_bulk_op_pool);
+        context->hg_bulk_op_pool = NULL;
+    }
+
+    /* Free coalesced messages */
+    while (!HG_LIST_IS_EMPTY(&context->coalesce.free_list)) {
+        struct hg_core_coalesce_msg *coalesce_msg =
+            HG_LIST_FIRST(&context->coalesce.free_list);
+        HG_LIST_REMOVE(coalesce_msg, entry);
+        hg_core_coalesce_msg_free(coalesce_msg);
+    }
+    free(context->coalesce.peers);
+    context->coalesce.peers = NULL;
+
+    /* Stop listening for events */
+    if (context->loopback_notify.event > 0) {
+        rc = hg_poll_remove(context->poll_set, context->loopback_notify.event);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+            HG_NOENTRY, "Could not remove loopback notify event from poll set");
+
+        rc = hg_event_destroy(context->loopback_notify.event);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+            HG_NOENTRY, "Could not destroy loopback notify event");
+        context->loopback_notify.event = 0;
+    }
+
+    if (context->na_event > 0) {
+        rc = hg_poll_remove(context->poll_set, context->na_event);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+            HG_NOENTRY, "Could not remove NA event from poll set");
+        context->na_event = 0;
+    }
+
+#ifdef NA_HAS_SM
+    if (context->na_sm_event > 0) {
+        rc = hg_poll_remove(context->poll_set, context->na_sm_event);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+            HG_NOENTRY, "Could not remove NA SM event from poll set");
+        context->na_sm_event = 0;
+    }
+#endif
+
+    for (i = 1; i < HG_CORE_RAIL_MAX; i++) {
+        if (context->na_rail_events[i] <= 0)
+            continue;
+        rc = hg_poll_remove(context->poll_set, context->na_rail_events[i]);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+            HG_NOENTRY, "Could not remove NA rail event from poll set");
+        context->na_rail_events[i] = 0;
+    }
+
+    /* Destroy poll set */
+    if (context->poll_set != NULL) {
+        rc = hg_poll_destroy(context->poll_set);
+        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_FAULT,
+            "Could not destroy poll set");
+        context->poll_set = NULL;
+    }
+
+    /* Destroy NA context */
+    if (context->core_context.na_context != NULL) {
+        na_return_t na_ret =
+            NA_Context_destroy(context->core_context.core_class->na_class,
+                context->core_context.na_context);
+        HG_CHECK_SUBSYS_ERROR(ctx, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not destroy NA context (%s)",
+            NA_Error_to_string(na_ret));
+        context->core_context.na_context = NULL;
+    }
+
+#ifdef NA_HAS_SM
+    /* Destroy NA SM context */
+    if (context->core_context.na_sm_context) {
+        na_return_t na_ret =
+            NA_Context_destroy(context->core_context.core_class->na_sm_class,
+                context->core_context.na_sm_context);
+        HG_CHECK_SUBSYS_ERROR(ctx, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not destroy NA SM context (%s)",
+            NA_Error_to_string(na_ret));
+        context->core_context.na_sm_context = NULL;
+    }
+#endif
+
+    /* Destroy NA contexts of bulk rails */
+    for (i = 1; i < HG_CORE_RAIL_MAX; i++) {
+        na_return_t na_ret;
+
+        if (context->na_rail_contexts[i] == NULL)
+            continue;
+        na_ret = NA_Context_destroy(hg_core_class->rails.rail[i].na_class,
+            context->na_rail_contexts[i]);
+        HG_CHECK_SUBSYS_ERROR(ctx, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not destroy NA rail context (%s)",
+            NA_Error_to_string(na_ret));
+        context->na_rail_contexts[i] = NULL;
+    }
+
+    /* Free user data */
+    if (context->core_context.data_free_callback)
+        context->core_context.data_free_callback(context->core_context.data);
+
+    /* Destroy completion wait mutex/cond */
+    (void) hg_thread_mutex_destroy(&context->completion_wait.mutex);
+    (void) hg_thread_cond_destroy(&context->completion_wait.cond);
+    (void) hg_thread_mutex_destroy(&context->multi_recv_mutex);
+    (void) hg_thread_mutex_destroy(&context->coalesce.mutex);
+    (void) hg_thread_spin_destroy(&context->user_list.lock);
+    (void) hg_thread_spin_destroy(&context->internal_list.lock);
+    (void) hg_thread_spin_destroy(&context->addr_refs.lock);
+    (void) hg_thread_spin_destroy(&context->leases.lock);
+    (void) hg_thread_spin_destroy(&context->timer_wheel.lock);
+#ifdef HG_HAS_MULTI_PROGRESS
+    (void) hg_thread_mutex_destroy(&progress_multi->mutex);
+    (void) hg_thread_cond_destroy(&progress_multi->cond);
+#endif
+
+    hg_core_completion_queue_free(context);
+    hg_mem_aligned_free(context);
+
+    /* Decrement context count of parent class */
+    hg_atomic_decr32(&hg_core_class->n_contexts);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_destroy_multi(struct hg_core_private_context **contexts,
+    unsigned int count, hg_bool_t quiescent)
+{
+    hg_time_t deadline, now;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    /* Cancel everything first so that cancelations of all contexts complete
+     * concurrently instead of one context after the other */
+    for (i = 0; i < count; i++) {
+        if (contexts[i]->coalesce.max > 0)
+            (void) hg_core_coalesce_flush(contexts[i], HG_TRUE, NULL);
+        (void) hg_core_lease_flush(contexts[i], HG_TRUE, NULL);
+
+        ret = hg_core_context_unpost_cancel(contexts[i]);
+        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+            "Could not cancel requests of context (%p)", (void *) contexts[i]);
+    }
+
+    /* All contexts share a single cleanup timeout */
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(HG_CORE_CLEANUP_TIMEOUT));
+
+    for (;;) {
+        hg_bool_t drained = HG_TRUE;
+        unsigned int timeout_ms;
+
+        for (i = 0; i < count; i++) {
+            unsigned int actual_count = 0;
+
+            do {
+                ret = hg_core_trigger(contexts[i], 0, 1, &actual_count, NULL);
+            } while (ret == HG_SUCCESS && actual_count > 0);
+            HG_CHECK_SUBSYS_ERROR_NORET(ctx,
+                ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+                "Could not trigger entry");
+
+            if (!hg_core_context_drained(contexts[i], quiescent))
+                drained = HG_FALSE;
+        }
+        if (drained)
+            break;
+
+        hg_time_get_current_ms(&now);
+        if (!hg_time_less(now, deadline))
+            break;
+
+        /* Only block when all contexts can be waited on at once */
+        timeout_ms = (count <= HG_CORE_PROGRESS_MULTI_MAX)
+                         ? hg_time_to_ms(hg_time_subtract(deadline, now))
+                         : 0;
+        for (i = 0; i < count; i += HG_CORE_PROGRESS_MULTI_MAX) {
+            hg_uint64_t ready = 0;
+
+            ret = hg_core_progress_multi(&contexts[i],
+                MIN(count - i, HG_CORE_PROGRESS_MULTI_MAX), timeout_ms, &ready);
+            HG_CHECK_SUBSYS_ERROR_NORET(ctx,
+                ret != HG_SUCCESS && ret != HG_TIMEOUT, error,
+                "Could not make progress");
+        }
+    }
+
+    /* Remaining waits only complete what was not drained in time */
+    hg_time_get_current_ms(&now);
+    for (i = 0; i < count; i++) {
+        unsigned int timeout_ms = hg_time_less(now, deadline)
+                                      ? hg_time_to_ms(
+                                            hg_time_subtract(deadline, now))
+                                      : 0;
+
+        ret = hg_core_context_destroy(contexts[i], timeout_ms, quiescent);
+        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+            "Could not destroy context (%p)", (void *) contexts[i]);
+        contexts[i] = NULL;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_context_drained(
+    struct hg_core_private_context *context, hg_bool_t quiescent)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    bool list_empty;
+
+    if (context->posted) {
+        if (hg_core_class->init_info.multi_recv &&
+            hg_atomic_get32(&context->multi_recv_op_count) > 0)
+            return HG_FALSE;
+
+        if (context->handle_pool != NULL) {
+            hg_core_handle_list_lock(&context->handle_pool->pending_list);
+            list_empty =
+                HG_LIST_IS_EMPTY(&context->handle_pool->pending_list.list);
+            hg_core_handle_list_unlock(&context->handle_pool->pending_list);
+            if (!list_empty)
+                return HG_FALSE;
+        }
+#ifdef NA_HAS_SM
+        if (context->sm_handle_pool != NULL) {
+            hg_core_handle_list_lock(&context->sm_handle_pool->pending_list);
+            list_empty =
+                HG_LIST_IS_EMPTY(&context->sm_handle_pool->pending_list.list);
+            hg_core_handle_list_unlock(&context->sm_handle_pool->pending_list);
+            if (!list_empty)
+                return HG_FALSE;
+        }
+#endif
+    }
+
+    /* Internal list still holds the handles of the pools, it is waited on
+     * once the pools are destroyed */
+    if (quiescent)
+        return HG_TRUE;
+
+    hg_core_handle_list_lock(&context->user_list);
+    list_empty = HG_LIST_IS_EMPTY(&context->user_list.list);
+    hg_core_handle_list_unlock(&context->user_list);
+
+    return list_empty && hg_atomic_get32(&context->leases.ack_count) == 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_post(struct hg_core_private_context *context)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    unsigned long flags = HG_CORE_HANDLE_LISTEN;
+    hg_return_t ret;
+
+    /* Allocate resources for "listening" on incoming RPCs */
+    HG_CHECK_SUBSYS_ERROR(ctx, !hg_core_class->init_info.listen, error, ret,
+        HG_OPNOTSUPPORTED, "Cannot post handles on non-listening class");
+
+    /* Allocate multi-recv operations */
+    if (hg_core_class->init_info.multi_recv) {
+        ret = hg_core_context_multi_recv_alloc(context,
+            hg_core_class->core_class.na_class,
+            hg_core_class->init_info.request_post_init);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not allocate multi-recv resources");
+        flags |= HG_CORE_HANDLE_MULTI_RECV;
+    }
+
+    /* Create pool of handles */
+    ret = hg_core_handle_pool_create(context,
+        hg_core_class->core_class.na_class, context->core_context.na_context,
+        flags, hg_core_class->init_info.request_post_init,
+        hg_core_class->init_info.request_post_incr, &context->handle_pool);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        ctx, error, ret, "Could not allocate pool of handles");
+
+#ifdef NA_HAS_SM
+    /* Create pool of SM handles */
+    if (context->core_context.na_sm_context != NULL) {
+        ret = hg_core_handle_pool_create(context,
+            hg_core_class->core_class.na_sm_class,
+            context->core_context.na_sm_context, flags,
+            hg_core_class->init_info.request_post_init,
+            hg_core_class->init_info.request_post_incr,
+            &context->sm_handle_pool);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not allocate pool of SM handles");
+    }
+#endif
+
+    /* Only post multi-recv after pool of handles has been created */
+    if (hg_core_class->init_info.multi_recv) {
+        ret = hg_core_context_multi_recv_post(context,
+            hg_core_class->core_class.na_class,
+            context->core_context.na_context);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not post multi-recv operations");
+    }
+
+    context->posted = HG_TRUE;
+    context->canceled = HG_FALSE;
+
+    return HG_SUCCESS;
+
+error:
+    if (context->handle_pool != NULL) {
+        (void) hg_core_handle_pool_unpost(
+            context->handle_pool, HG_CORE_CLEANUP_TIMEOUT);
+        hg_core_handle_pool_destroy(context->handle_pool);
+    }
+#ifdef NA_HAS_SM
+    if (context->sm_handle_pool != NULL) {
+        (void) hg_core_handle_pool_unpost(
+            context->sm_handle_pool, HG_CORE_CLEANUP_TIMEOUT);
+        hg_core_handle_pool_destroy(context->sm_handle_pool);
+    }
+#endif
+    if (hg_core_class->init_info.multi_recv)
+        hg_core_context_multi_recv_free(
+            context, hg_core_class->core_class.na_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_unpost(
+    struct hg_core_private_context *context, unsigned int timeout_ms)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    hg_return_t ret;
+
+    if (!hg_core_class->init_info.listen || !context->posted)
+        return HG_SUCCESS;
+
+    ret = hg_core_context_unpost_cancel(context);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not cancel requests");
+
+    if (hg_core_class->init_info.multi_recv) {
+        ret = hg_core_context_multi_recv_wait(context, timeout_ms);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not unpost multi-recv operations");
+    }
+
+    if (context->handle_pool != NULL) {
+        ret = hg_core_handle_pool_unpost(context->handle_pool, timeout_ms);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not unpost pool of handles");
+
+        hg_core_handle_pool_destroy(context->handle_pool);
+        context->handle_pool = NULL;
+    }
+
+#ifdef NA_HAS_SM
+    if (context->sm_handle_pool != NULL) {
+        ret = hg_core_handle_pool_unpost(context->sm_handle_pool, timeout_ms);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not unpost pool of handles");
+
+        hg_core_handle_pool_destroy(context->sm_handle_pool);
+        context->sm_handle_pool = NULL;
+    }
+#endif
+
+    /* Wait on internal list */
+    ret =
+        hg_core_context_list_wait(context, &context->internal_list, timeout_ms);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not wait on handle list");
+
+    if (hg_core_class->init_info.multi_recv)
+        hg_core_context_multi_recv_free(
+            context, hg_core_class->core_class.na_class);
+
+    context->posted = HG_FALSE;
+    context->canceled = HG_FALSE;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_unpost_cancel(struct hg_core_private_context *context)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    hg_return_t ret;
+
+    if (!hg_core_class->init_info.listen || !context->posted ||
+        context->canceled)
+        return HG_SUCCESS;
+
+    /* Prevent requests from being reposted as they complete */
+    hg_atomic_set32(&context->unposting, 1);
+
+    /* Each multi-recv buffer covers many requests and is canceled at once */
+    if (hg_core_class->init_info.multi_recv) {
+        ret = hg_core_context_multi_recv_cancel(context,
+            hg_core_class->core_class.na_class,
+            context->core_context.na_context);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not cancel multi-recv operations");
+    }
+
+    if (context->handle_pool != NULL) {
+        ret = hg_core_handle_pool_cancel(context->handle_pool);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not cancel pool of handles");
+    }
+
+#ifdef NA_HAS_SM
+    if (context->sm_handle_pool != NULL) {
+        ret = hg_core_handle_pool_cancel(context->sm_handle_pool);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not cancel pool of SM handles");
+    }
+#endif
+
+    context->canceled = HG_TRUE;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_multi_recv_alloc(struct hg_core_private_context *context,
+    na_class_t *na_class, unsigned int request_count)
+{
+    size_t unexpected_msg_size;
+    hg_return_t ret;
+    int i;
+
+    unexpected_msg_size = NA_Msg_get_max_unexpected_size(na_class);
+    HG_CHECK_SUBSYS_ERROR(ctx, unexpected_msg_size == 0, error, ret,
+        HG_INVALID_PARAM, "Invalid unexpected message size");
+
+    /* Keep total buffer size as max of unexpected msg size x number of
+     * "pre-posted" operations. */
+    context->multi_recv_buf_size = request_count * unexpected_msg_size;
+    context->multi_recv_mem = 0;
+    context->multi_recv_shared = 0;
+    hg_atomic_init32(&context->multi_recv_starved, 0);
+    context->multi_recv_op_active = HG_CORE_MULTI_RECV_OP_INIT;
+
+    for (i = 0; i < HG_CORE_MULTI_RECV_OP_MAX; i++)
+        context->multi_recv_ops[i].id = i;
+
+    for (i = 0; i < HG_CORE_MULTI_RECV_OP_INIT; i++) {
+        ret = hg_core_multi_recv_op_alloc(&context->multi_recv_ops[i],
+            na_class, context->multi_recv_buf_size);
+        HG_CHECK_SUBSYS_HG_ERROR(ctx, cleanup, ret,
+            "Could not allocate multi-recv operation %d", i);
+        context->multi_recv_mem += context->multi_recv_buf_size;
+    }
+
+    return HG_SUCCESS;
+
+cleanup:
+    for (i = 0; i < HG_CORE_MULTI_RECV_OP_INIT; i++)
+        hg_core_multi_recv_op_free(&context->multi_recv_ops[i], na_class);
+    context->multi_recv_op_active = 0;
+    context->multi_recv_mem = 0;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_context_multi_recv_free(
+    struct hg_core_private_context *context, na_class_t *na_class)
+{
+    int i;
+
+    for (i = 0; i < context->multi_recv_op_active; i++) {
+        struct hg_core_multi_recv_op *multi_recv_op =
+            &context->multi_recv_ops[i];
+
+        HG_CHECK_SUBSYS_WARNING(ctx,
+            hg_atomic_get32(&multi_recv_op->ref_count) != 0,
+            "Freeing multi-recv operation that is still being referenced "
+            "(%" PRId32 ")",
+            hg_atomic_get32(&multi_recv_op->ref_count));
+
+        hg_core_multi_recv_op_free(multi_recv_op, na_class);
+    }
+    context->multi_recv_op_active = 0;
+    context->multi_recv_mem = 0;
+
+    hg_core_post_shared_starve(HG_CORE_CONTEXT_CLASS(context),
+        &context->multi_recv_starved, HG_FALSE);
+    hg_core_post_shared_release(
+        HG_CORE_CONTEXT_CLASS(context), context->multi_recv_shared);
+    context->multi_recv_shared = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_multi_recv_post(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context)
+{
+    hg_return_t ret;
+    int i;
+
+    /* Ensure we have enough recvs pre-posted so that handles can be re-assigned
+     * a new buffer until the previous buffer can be safely re-used once it's
+     * consumed. */
+    for (i = 0; i < context->multi_recv_op_active; i++) {
+        ret = hg_core_post_multi(
+            &context->multi_recv_ops[i], na_class, na_context);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not post multi-recv buffer %d", i);
+    }
+    hg_atomic_init32(
+        &context->multi_recv_op_count, context->multi_recv_op_active);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_multi_recv_cancel(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context)
+{
+    hg_return_t ret;
+    int i, active;
+
+    /* No buffer can be added once unposting is set */
+    hg_thread_mutex_lock(&context->multi_recv_mutex);
+    active = context->multi_recv_op_active;
+    hg_thread_mutex_unlock(&context->multi_recv_mutex);
+
+    for (i = 0; i < active; i++) {
+        struct hg_core_multi_recv_op *multi_recv_op =
+            &context->multi_recv_ops[i];
+        na_return_t na_ret;
+
+        na_ret = NA_Cancel(na_class, na_context, multi_recv_op->op_id);
+        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "NA_Cancel() of multi-recv op failed (%s)",
+            NA_Error_to_string(na_ret));
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_multi_recv_wait(
+    struct hg_core_private_context *context, unsigned int timeout_ms)
+{
+    hg_return_t ret;
+
+    for (;;) {
+        unsigned int actual_count = 0;
+
+        /* Trigger everything we can from HG */
+        do {
+            ret = hg_core_trigger(context, 0, 1, &actual_count, NULL);
+        } while (ret == HG_SUCCESS && actual_count > 0);
+        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+            error, "Could not trigger entry");
+
+        if (hg_atomic_get32(&context->multi_recv_op_count) == 0)
+            break;
+
+        ret = hg_core_progress(context, timeout_ms);
+        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+            error, "Could not make progress");
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_context_multi_recv_grow(struct hg_core_private_context *context)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    na_class_t *na_class = hg_core_class->core_class.na_class;
+    struct hg_core_multi_recv_op *multi_recv_op;
+    hg_return_t ret;
+
+    hg_thread_mutex_lock(&context->multi_recv_mutex);
+
+    if (hg_atomic_get32(&context->unposting) ||
+        context->multi_recv_op_active == HG_CORE_MULTI_RECV_OP_MAX ||
+        context->multi_recv_mem + context->multi_recv_buf_size >
+            hg_core_class->init_info.multi_recv_mem_max ||
+        !hg_core_context_multi_recv_acquire(
+            context, context->multi_recv_buf_size))
+        goto unlock;
+
+    multi_recv_op = &context->multi_recv_ops[context->multi_recv_op_active];
+    ret = hg_core_multi_recv_op_alloc(
+        multi_recv_op, na_class, context->multi_recv_buf_size);
+    if (ret != HG_SUCCESS) {
+        hg_core_context_multi_recv_release(
+            context, context->multi_recv_buf_size);
+        HG_GOTO_SUBSYS_ERROR_NORET(ctx, unlock,
+            "Could not allocate multi-recv operation %d", multi_recv_op->id);
+    }
+
+    /* Count it as posted before it can complete */
+    hg_atomic_incr32(&context->multi_recv_op_count);
+    ret = hg_core_post_multi(
+        multi_recv_op, na_class, context->core_context.na_context);
+    if (ret != HG_SUCCESS) {
+        hg_atomic_decr32(&context->multi_recv_op_count);
+        hg_core_multi_recv_op_free(multi_recv_op, na_class);
+        hg_core_context_multi_recv_release(
+            context, context->multi_recv_buf_size);
+        HG_GOTO_SUBSYS_ERROR_NORET(ctx, unlock,
+            "Could not post multi-recv buffer %d", multi_recv_op->id);
+    }
+    context->multi_recv_mem += multi_recv_op->buf_size;
+    context->multi_recv_op_active++;
+
+    HG_LOG_SUBSYS_DEBUG(ctx,
+        "Added multi-recv buffer %d (%d buffers, %zu bytes)",
+        multi_recv_op->id, context->multi_recv_op_active,
+        context->multi_recv_mem);
+
+unlock:
+    hg_thread_mutex_unlock(&context->multi_recv_mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_context_multi_recv_acquire(
+    struct hg_core_private_context *context, size_t buf_size)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    unsigned int count, grant;
+
+    if (hg_core_class->init_info.request_post_shared == 0)
+        return HG_TRUE;
+
+    /* Memory is counted in requests of max unexpected size */
+    count = (unsigned int) MAX(buf_size *
+                                   hg_core_class->init_info.request_post_init /
+                                   context->multi_recv_buf_size,
+        1);
+    grant = hg_core_post_shared_acquire(hg_core_class, count);
+    if (grant < count) {
+        hg_core_post_shared_release(hg_core_class, grant);
+        hg_core_post_shared_starve(
+            hg_core_class, &context->multi_recv_starved, HG_TRUE);
+        return HG_FALSE;
+    }
+    hg_core_post_shared_starve(
+        hg_core_class, &context->multi_recv_starved, HG_FALSE);
+    context->multi_recv_shared += count;
+
+    return HG_TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_context_multi_recv_release(
+    struct hg_core_private_context *context, size_t buf_size)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    unsigned int count;
+
+    if (hg_core_class->init_info.request_post_shared == 0)
+        return;
+
+    count = (unsigned int) MAX(buf_size *
+                                   hg_core_class->init_info.request_post_init /
+                                   context->multi_recv_buf_size,
+        1);
+    count = MIN(count, context->multi_recv_shared);
+    hg_core_post_shared_release(hg_core_class, count);
+    context->multi_recv_shared -= count;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_multi_recv_op_alloc(struct hg_core_multi_recv_op *multi_recv_op,
+    na_class_t *na_class, size_t buf_size)
+{
+    hg_return_t ret;
+
+    multi_recv_op->op_id = NA_Op_create(na_class, NA_OP_MULTI);
+    HG_CHECK_SUBSYS_ERROR(ctx, multi_recv_op->op_id == NULL, error, ret,
+        HG_NOMEM, "Could not create new OP ID");
+
+    multi_recv_op->buf = NA_Msg_buf_alloc(
+        na_class, buf_size, NA_MULTI_RECV, &multi_recv_op->plugin_data);
+    HG_CHECK_SUBSYS_ERROR(ctx, multi_recv_op->buf == NULL, error, ret,
+        HG_NOMEM, "Could not allocate multi-recv buffer of size %zu",
+        buf_size);
+    multi_recv_op->buf_size = buf_size;
+
+    hg_atomic_init32(&multi_recv_op->last, 0);
+    hg_atomic_init32(&multi_recv_op->ref_count, 0);
+    hg_atomic_init32(&multi_recv_op->op_count, 0);
+    hg_atomic_init32(&multi_recv_op->pressure, 0);
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_multi_recv_op_free(multi_recv_op, na_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_multi_recv_op_free(
+    struct hg_core_multi_recv_op *multi_recv_op, na_class_t *na_class)
+{
+    if (multi_recv_op->op_id != NULL) {
+        NA_Op_destroy(na_class, multi_recv_op->op_id);
+        multi_recv_op->op_id = NULL;
+    }
+    if (multi_recv_op->buf != NULL) {
+        NA_Msg_buf_free(
+            na_class, multi_recv_op->buf, multi_recv_op->plugin_data);
+        multi_recv_op->buf = NULL;
+    }
+    multi_recv_op->plugin_data = NULL;
+    multi_recv_op->buf_size = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_multi_recv_op_resize(struct hg_core_multi_recv_op *multi_recv_op,
+    na_class_t *na_class, size_t buf_size, size_t *mem_p)
+{
+    void *plugin_data = NULL;
+    void *buf;
+
+    /* Keep current buffer if a new one cannot be allocated */
+    buf = NA_Msg_buf_alloc(na_class, buf_size, NA_MULTI_RECV, &plugin_data);
+    if (buf == NULL) {
+        HG_LOG_SUBSYS_WARNING(ctx,
+            "Could not resize multi-recv buffer %d to %zu bytes",
+            multi_recv_op->id, buf_size);
+        return;
+    }
+    NA_Msg_buf_free(na_class, multi_recv_op->buf, multi_recv_op->plugin_data);
+
+    *mem_p = *mem_p - multi_recv_op->buf_size + buf_size;
+    multi_recv_op->buf = buf;
+    multi_recv_op->plugin_data = plugin_data;
+    multi_recv_op->buf_size = buf_size;
+
+    HG_LOG_SUBSYS_DEBUG(ctx, "Resized multi-recv buffer %d to %zu bytes",
+        multi_recv_op->id, buf_size);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_handle_list_lock(struct hg_core_handle_list *handle_list)
+{
+    if (!handle_list->single_thread)
+        hg_thread_spin_lock(&handle_list->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_handle_list_unlock(struct hg_core_handle_list *handle_list)
+{
+    if (!handle_list->single_thread)
+        hg_thread_spin_unlock(&handle_list->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_check_handle_list(struct hg_core_handle_list *handle_list)
+{
+    struct hg_core_private_handle *hg_core_handle = NULL;
+    hg_return_t ret;
+
+    hg_core_handle_list_lock(handle_list);
+
+    if (HG_LIST_IS_EMPTY(&handle_list->list))
+        HG_GOTO_DONE(unlock, ret, HG_SUCCESS);
+
+    HG_LIST_FOREACH (hg_core_handle, &handle_list->list, created) {
+        /* TODO ideally we'd want the upper layer to print that */
+        if (hg_core_handle->core_handle.data)
+            HG_LOG_SUBSYS_ERROR(ctx, "Handle (%p) was not destroyed",
+                hg_core_handle->core_handle.data);
+        HG_LOG_SUBSYS_DEBUG(
+            ctx, "Core handle (%p) was not destroyed", (void *) hg_core_handle);
+    }
+    ret = HG_BUSY;
+
+unlock:
+    hg_core_handle_list_unlock(handle_list);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_list_wait(struct hg_core_private_context *context,
+    struct hg_core_handle_list *handle_list, unsigned int timeout_ms)
+{
+    bool list_empty = false;
+    hg_time_t deadline, now = hg_time_from_ms(0);
+    hg_return_t ret;
+
+    if (timeout_ms != 0)
+        hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
+
+    /* Make first progress pass without waiting to empty trigger queues */
+    ret = hg_core_progress(context, 0);
+    HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+        error, "Could not make progress");
+
+    for (;;) {
+        unsigned int actual_count = 0;
+
+        /* Trigger everything we can from HG */
+        do {
+            ret = hg_core_trigger(context, 0, 1, &actual_count, NULL);
+        } while (ret == HG_SUCCESS && actual_count > 0);
+        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+            error, "Could not trigger entry");
+
+        /* Make progress until list is empty */
+        hg_core_handle_list_lock(handle_list);
+        list_empty = HG_LIST_IS_EMPTY(&handle_list->list);
+        hg_core_handle_list_unlock(handle_list);
+        if (list_empty)
+            break;
+
+        /* Gives a chance to always call trigger after progress */
+        if (timeout_ms != 0)
+            hg_time_get_current_ms(&now);
+        if (!hg_time_less(now, deadline))
+            break;
+
+        ret = hg_core_progress(
+            context, hg_time_to_ms(hg_time_subtract(deadline, now)));
+        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+            error, "Could not make progress");
+    }
+
+    HG_LOG_SUBSYS_DEBUG(ctx, "List empty: %d (timeout=%u ms)", list_empty,
+        hg_time_to_ms(hg_time_subtract(deadline, now)));
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_bulk_op_pool *
+hg_core_context_get_bulk_op_pool(struct hg_core_context *core_context)
+{
+    return ((struct hg_core_private_context *) core_context)->hg_bulk_op_pool;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_handle_pool_create(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context, unsigned long flags,
+    unsigned int init_count, unsigned int incr_count,
+    struct hg_core_handle_pool **hg_core_handle_pool_p)
+{
+    struct hg_core_handle_pool *hg_core_handle_pool = NULL;
+    hg_bool_t pending_list_lock_init = HG_FALSE, extend_mutex_init = HG_FALSE,
+              extend_cond_init = HG_FALSE;
+    hg_return_t ret;
+    unsigned int i, seed_count;
+    int rc;
+
+    HG_LOG_SUBSYS_DEBUG(ctx,
+        "Creating pool of handles (init_count=%u, incr_count=%u)", init_count,
+        incr_count);
+
+    hg_core_handle_pool =
+        (struct hg_core_handle_pool *) calloc(1, sizeof(*hg_core_handle_pool));
+    HG_CHECK_SUBSYS_ERROR(ctx, hg_core_handle_pool == NULL, error, ret,
+        HG_NOMEM, "Could not allocate handle pool");
+
+    HG_LIST_INIT(&hg_core_handle_pool->pending_list.list);
+    rc = hg_thread_spin_init(&hg_core_handle_pool->pending_list.lock);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_spin_init() failed");
+    pending_list_lock_init = HG_TRUE;
+    hg_core_handle_pool->pending_list.single_thread =
+        HG_CORE_CONTEXT_CLASS(context)->init_info.single_thread;
+
+    rc = hg_thread_mutex_init(&hg_core_handle_pool->extend_mutex);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_mutex_init() failed");
+    extend_mutex_init = HG_TRUE;
+    hg_thread_cond_init(&hg_core_handle_pool->extend_cond);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_cond_init() failed");
+    extend_cond_init = HG_TRUE;
+
+    /* Free handles can be retrieved from any thread with multi-recv, use a
+     * lock-free queue for these and only fall back to the pending list when
+     * the queue is full */
+    if (flags & HG_CORE_HANDLE_MULTI_RECV) {
+        unsigned int queue_size = HG_CORE_HANDLE_POOL_QUEUE_MIN;
+
+        while (queue_size < 4 * init_count)
+            queue_size <<= 1;
+        hg_core_handle_pool->free_queue = hg_atomic_queue_alloc(queue_size);
+        HG_CHECK_SUBSYS_ERROR(ctx, hg_core_handle_pool->free_queue == NULL,
+            error, ret, HG_NOMEM, "Could not allocate queue of free handles");
+    }
+    hg_atomic_init32(&hg_core_handle_pool->available, 0);
+    hg_atomic_init32(&hg_core_handle_pool->extend_pending, 0);
+
+    /* When posting lazily, only post a seed set of handles, the pool then
+     * grows towards init_count as handles get consumed */
+    hg_core_handle_pool->target_count = init_count;
+    seed_count = HG_CORE_CONTEXT_CLASS(context)->init_info.request_post_seed;
+    if (seed_count > 0 && seed_count < init_count)
+        init_count = seed_count;
+
+    /* With a shared budget, pools only keep a few handles of their own */
+    if (HG_CORE_CONTEXT_CLASS(context)->init_info.request_post_shared > 0 &&
+        !(flags & HG_CORE_HANDLE_MULTI_RECV) &&
+        init_count > HG_CORE_POST_SHARED_MIN) {
+        hg_core_handle_pool->shared_count =
+            hg_core_post_shared_acquire(HG_CORE_CONTEXT_CLASS(context),
+                init_count - HG_CORE_POST_SHARED_MIN);
+        init_count =
+            HG_CORE_POST_SHARED_MIN + hg_core_handle_pool->shared_count;
+    }
+
+    HG_CHECK_SUBSYS_ERROR(ctx,
+        !hg_core_handle_pool_mem_acquire(context, init_count), error, ret,
+        HG_NOMEM, "Memory budget is too small for initial pool of %u handles",
+        init_count);
+    hg_core_handle_pool->mem_count = init_count;
+    hg_core_handle_pool->count = init_count;
+    hg_core_handle_pool->incr_count = incr_count;
+    /* Extend pool ahead of time so that it never runs dry */
+    hg_core_handle_pool->low_watermark =
+        hg_core_handle_pool_watermark(hg_core_handle_pool);
+    /* Only pre-posted handles hold their own buffers */
+    if (!(flags & HG_CORE_HANDLE_MULTI_RECV))
+        hg_core_handle_pool->max_count =
+            HG_CORE_CONTEXT_CLASS(context)->init_info.request_post_max;
+    hg_atomic_init32(&hg_core_handle_pool->cap_count, 0);
+    hg_atomic_init32(&hg_core_handle_pool->starved, 0);
+    hg_atomic_init32(&hg_core_handle_pool->reclaim_count, 0);
+    hg_core_handle_pool->extending = HG_FALSE;
+    hg_core_handle_pool->context = context;
+    hg_core_handle_pool->na_class = na_class;
+    hg_core_handle_pool->na_context = na_context;
+    hg_core_handle_pool->flags = flags;
+
+    for (i = 0; i < init_count; i++) {
+        ret = hg_core_handle_pool_insert(
+            context, na_class, na_context, flags, hg_core_handle_pool);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not insert handle %u into pool", i);
+    }
+
+    HG_LOG_SUBSYS_DEBUG(
+        ctx, "Created handle pool (%p)", (void *) hg_core_handle_pool);
+
+    *hg_core_handle_pool_p = hg_core_handle_pool;
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_core_handle_pool != NULL) {
+        struct hg_core_private_handle *hg_core_handle;
+
+        if (hg_core_handle_pool->free_queue != NULL) {
+            while ((hg_core_handle = hg_atomic_queue_pop_mc(
+                        hg_core_handle_pool->free_queue)) != NULL) {
+                hg_core_handle->reuse = HG_FALSE;
+                (void) hg_core_destroy(hg_core_handle);
+            }
+            hg_atomic_queue_free(hg_core_handle_pool->free_queue);
+        }
+
+        hg_core_handle = HG_LIST_FIRST(&hg_core_handle_pool->pending_list.list);
+        while (hg_core_handle) {
+            struct hg_core_private_handle *hg_core_handle_next =
+                HG_LIST_NEXT(hg_core_handle, pending);
+            HG_LIST_REMOVE(hg_core_handle, pending);
+
+            /* Prevent re-initialization */
+            hg_core_handle->reuse = HG_FALSE;
+
+            /* Destroy handle */
+            (void) hg_core_destroy(hg_core_handle);
+            hg_core_handle = hg_core_handle_next;
+        }
+
+        if (pending_list_lock_init)
+            (void) hg_thread_spin_destroy(
+                &hg_core_handle_pool->pending_list.lock);
+        if (extend_mutex_init)
+            (void) hg_thread_mutex_destroy(&hg_core_handle_pool->extend_mutex);
+        if (extend_cond_init)
+            (void) hg_thread_cond_destroy(&hg_core_handle_pool->extend_cond);
+
+        hg_core_post_shared_release(
+            HG_CORE_CONTEXT_CLASS(context), hg_core_handle_pool->shared_count);
+        hg_core_handle_pool_mem_release(
+            context, hg_core_handle_pool->mem_count);
+        free(hg_core_handle_pool);
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_handle_pool_destroy(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    struct hg_core_private_handle *hg_core_handle = NULL;
+
+    HG_LOG_DEBUG("Free handle pool (%p)", (void *) hg_core_handle_pool);
+
+    if (hg_core_handle_pool->free_queue != NULL) {
+        while ((hg_core_handle = hg_atomic_queue_pop_mc(
+                    hg_core_handle_pool->free_queue)) != NULL) {
+            /* Prevent re-initialization */
+            hg_core_handle->reuse = HG_FALSE;
+
+            /* Destroy handle */
+            (void) hg_core_destroy(hg_core_handle);
+        }
+        hg_atomic_queue_free(hg_core_handle_pool->free_queue);
+    }
+
+    hg_core_handle_list_lock(&hg_core_handle_pool->pending_list);
+    hg_core_handle = HG_LIST_FIRST(&hg_core_handle_pool->pending_list.list);
+    while (hg_core_handle) {
+        struct hg_core_private_handle *hg_core_handle_next =
+            HG_LIST_NEXT(hg_core_handle, pending);
+        HG_LIST_REMOVE(hg_core_handle, pending);
+
+        /* Prevent re-initialization */
+        hg_core_handle->reuse = HG_FALSE;
+
+        /* Destroy handle */
+        (void) hg_core_destroy(hg_core_handle);
+        hg_core_handle = hg_core_handle_next;
+    }
+    hg_core_handle_list_unlock(&hg_core_handle_pool->pending_list);
+
+    /* Handles that were not canceled also return to the shared budget */
+    hg_core_post_shared_starve(
+        HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context),
+        &hg_core_handle_pool->starved, HG_FALSE);
+    hg_core_post_shared_release(
+        HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context),
+        hg_core_handle_pool->shared_count);
+    hg_core_handle_pool_mem_release(
+        hg_core_handle_pool->context, hg_core_handle_pool->mem_count);
+
+    (void) hg_thread_mutex_destroy(&hg_core_handle_pool->extend_mutex);
+    (void) hg_thread_cond_destroy(&hg_core_handle_pool->extend_cond);
+    (void) hg_thread_spin_destroy(&hg_core_handle_pool->pending_list.lock);
+
+    free(hg_core_handle_pool);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_handle_pool_mem_acquire(
+    struct hg_core_private_context *context, unsigned int count)
+{
+    /* Only handles are charged here, their buffers are charged by NA */
+    return hg_mem_budget_acquire(
+        hg_core_class_get_mem_budget(context->core_context.core_class),
+        count * sizeof(struct hg_core_private_handle));
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_handle_pool_mem_release(
+    struct hg_core_private_context *context, unsigned int count)
+{
+    hg_mem_budget_release(
+        hg_core_class_get_mem_budget(context->core_context.core_class),
+        count * sizeof(struct hg_core_private_handle));
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_handle_pool_empty(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    return hg_atomic_get32(&hg_core_handle_pool->available) <= 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_handle_pool_capped(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context);
+
+    return (hg_core_handle_pool->max_count > 0 &&
+               hg_core_handle_pool->count >= hg_core_handle_pool->max_count) ||
+           (hg_core_class->init_info.request_post_shared > 0 &&
+               !(hg_core_handle_pool->flags & HG_CORE_HANDLE_MULTI_RECV) &&
+               hg_atomic_get32(&hg_core_class->post_shared.count) >=
+                   (int32_t) hg_core_class->init_info.request_post_shared);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_handle_pool_growable(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    return hg_core_handle_pool->incr_count > 0 ||
+           hg_core_handle_pool->count < hg_core_handle_pool->target_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_handle_pool_watermark(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    /* While growing lazily, extend once 3/4 of the pool is consumed */
+    if (hg_core_handle_pool->count < hg_core_handle_pool->target_count)
+        return MAX(hg_core_handle_pool->count / 4, 1);
+
+    return hg_core_handle_pool->incr_count / 4;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_handle_pool_get_stats(struct hg_core_handle_pool *hg_core_handle_pool,
+    struct hg_handle_stats *stats)
+{
+    hg_thread_mutex_lock(&hg_core_handle_pool->extend_mutex);
+    stats->pool_count += hg_core_handle_pool->count;
+    stats->extend_count += hg_core_handle_pool->extend_count;
+    stats->extend_wait_count += hg_core_handle_pool->extend_wait_count;
+    stats->extend_wait_time += hg_core_handle_pool->extend_wait_time;
+    hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+
+    stats->pool_available += (hg_uint64_t) MAX(
+        hg_atomic_get32(&hg_core_handle_pool->available), 0);
+    stats->cap_count +=
+        (hg_uint64_t) hg_atomic_get32(&hg_core_handle_pool->cap_count);
+    stats->reclaim_count +=
+        (hg_uint64_t) hg_atomic_get32(&hg_core_handle_pool->reclaim_count);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_handle_list_get_age(struct hg_core_handle_list *handle_list,
+    hg_id_t id, hg_uint64_t now, hg_uint32_t *count_p, hg_uint64_t *age_p)
+{
+    struct hg_core_private_handle *hg_core_handle;
+
+    hg_core_handle_list_lock(handle_list);
+    HG_LIST_FOREACH (hg_core_handle, &handle_list->list, created) {
+        hg_uint64_t start = hg_core_handle->acquire_start;
+
+        /* Handles that are back in their pool are not outstanding */
+        if (start == 0 ||
+            (id != 0 && hg_core_handle->core_handle.info.id != id))
+            continue;
+
+        (*count_p)++;
+        if (now > start && now - start > *age_p)
+            *age_p = now - start;
+    }
+    hg_core_handle_list_unlock(handle_list);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_handle_pool_put(struct hg_core_handle_pool *hg_core_handle_pool,
+    struct hg_core_private_handle *hg_core_handle)
+{
+    hg_core_handle->acquire_start = 0;
+    if (hg_core_handle_pool->free_queue == NULL ||
+        hg_atomic_queue_push(hg_core_handle_pool->free_queue, hg_core_handle) !=
+            HG_UTIL_SUCCESS) {
+        hg_core_handle_list_lock(&hg_core_handle_pool->pending_list);
+        HG_LIST_INSERT_HEAD(
+            &hg_core_handle_pool->pending_list.list, hg_core_handle, pending);
+        hg_core_handle_list_unlock(&hg_core_handle_pool->pending_list);
+    }
+    hg_atomic_incr32(&hg_core_handle_pool->available);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_handle_pool_check(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    if (!hg_core_handle_pool_growable(hg_core_handle_pool) ||
+        hg_atomic_get32(&hg_core_handle_pool->available) >=
+            (int32_t) hg_core_handle_pool->low_watermark)
+        return;
+
+    if (hg_core_handle_pool_capped(hg_core_handle_pool))
+        hg_core_post_shared_starve(
+            HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context),
+            &hg_core_handle_pool->starved, HG_TRUE);
+    else if (hg_atomic_cas32(&hg_core_handle_pool->extend_pending, 0, 1))
+        HG_LOG_SUBSYS_DEBUG(perf,
+            "Running low on handles (%" PRId32 " left), pool will be extended",
+            hg_atomic_get32(&hg_core_handle_pool->available));
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_context_pools_extend(struct hg_core_private_context *context)
+{
+    struct hg_core_handle_pool *pools[2] = {context->handle_pool, NULL};
+    hg_return_t ret;
+    size_t i;
+
+#ifdef NA_HAS_SM
+    pools[1] = context->sm_handle_pool;
+#endif
+
+    if (hg_atomic_get32(&context->unposting))
+        return HG_SUCCESS;
+
+    for (i = 0; i < sizeof(pools) / sizeof(pools[0]); i++) {
+        if (pools[i] == NULL)
+            continue;
+
+        hg_core_handle_pool_reclaim(pools[i]);
+
+        /* Retry starved pools once other contexts have returned budget */
+        if (hg_atomic_get32(&pools[i]->starved) &&
+            !hg_core_handle_pool_capped(pools[i]))
+            hg_atomic_cas32(&pools[i]->extend_pending, 0, 1);
+
+        if (!hg_atomic_get32(&pools[i]->extend_pending) ||
+            !hg_atomic_cas32(&pools[i]->extend_pending, 1, 0))
+            continue;
+
+        /* When memory is exhausted, extension is attempted again once more
+         * handles are consumed */
+        ret = hg_core_handle_pool_extend(pools[i]);
+        if (ret == HG_AGAIN || ret == HG_NOMEM)
+            continue;
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not extend pool of handles");
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_core_post_shared_acquire(
+    struct hg_core_private_class *hg_core_class, unsigned int count)
+{
+    int32_t max = (int32_t) hg_core_class->init_info.request_post_shared,
+            used;
+    unsigned int grant;
+
+    if (max == 0)
+        return count;
+
+    do {
+        used = hg_atomic_get32(&hg_core_class->post_shared.count);
+        grant = (used >= max) ? 0 : MIN(count, (unsigned int) (max - used));
+    } while (grant > 0 &&
+             !hg_atomic_cas32(&hg_core_class->post_shared.count, used,
+                 used + (int32_t) grant));
+
+    return grant;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_post_shared_release(
+    struct hg_core_private_class *hg_core_class, unsigned int count)
+{
+    int32_t used;
+
+    if (hg_core_class->init_info.request_post_shared == 0 || count == 0)
+        return;
+
+    do {
+        used = hg_atomic_get32(&hg_core_class->post_shared.count);
+    } while (!hg_atomic_cas32(
+        &hg_core_class->post_shared.count, used, used - (int32_t) count));
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_post_shared_starve(struct hg_core_private_class *hg_core_class,
+    hg_atomic_int32_t *starved, hg_bool_t starve)
+{
+    int32_t demand;
+
+    if (hg_core_class->init_info.request_post_shared == 0)
+        return;
+
+    if (starve) {
+        /* Only count each waiting context once */
+        if (hg_atomic_cas32(starved, 0, 1)) {
+            hg_atomic_incr32(&hg_core_class->post_shared.demand);
+            HG_LOG_SUBSYS_DEBUG(perf,
+                "Shared budget of %u requests used up, asking other "
+                "contexts to give back requests",
+                hg_core_class->init_info.request_post_shared);
+        }
+    } else if (hg_atomic_get32(starved) && hg_atomic_cas32(starved, 1, 0)) {
+        /* Demand may already have been served by another context */
+        do {
+            demand = hg_atomic_get32(&hg_core_class->post_shared.demand);
+        } while (demand > 0 &&
+                 !hg_atomic_cas32(
+                     &hg_core_class->post_shared.demand, demand, demand - 1));
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_handle_pool_reclaim(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context);
+    struct hg_core_private_handle *hg_core_handle;
+    unsigned int reclaim_count, keep_count, i = 0;
+    int32_t demand, available;
+
+    /* Fast path, no context waiting on the shared budget */
+    if (hg_atomic_get32(&hg_core_class->post_shared.demand) <= 0 ||
+        hg_core_handle_pool->shared_count == 0 ||
+        hg_atomic_get32(&hg_core_handle_pool->starved))
+        return;
+
+    /* Only give back handles that sit idle, about half of the pool */
+    available = hg_atomic_get32(&hg_core_handle_pool->available);
+    keep_count = MAX(hg_core_handle_pool->count / 2, HG_CORE_POST_SHARED_MIN);
+    if (available <= (int32_t) keep_count)
+        return;
+    reclaim_count = MIN((unsigned int) available - keep_count,
+        MIN(hg_core_handle_pool->shared_count, HG_CORE_POST_RECLAIM_MAX));
+
+    /* Serve one waiting context */
+    do {
+        demand = hg_atomic_get32(&hg_core_class->post_shared.demand);
+        if (demand <= 0)
+            return;
+    } while (!hg_atomic_cas32(
+        &hg_core_class->post_shared.demand, demand, demand - 1));
+
+    HG_LOG_SUBSYS_DEBUG(perf,
+        "Giving back %u idle handles to shared budget (%" PRId32
+        " available)",
+        reclaim_count, available);
+
+    /* Canceled handles are destroyed and released from the pool */
+    hg_core_handle_list_lock(&hg_core_handle_pool->pending_list);
+    HG_LIST_FOREACH (
+        hg_core_handle, &hg_core_handle_pool->pending_list.list, pending) {
+        if (i++ == reclaim_count)
+            break;
+        (void) hg_core_cancel(hg_core_handle, HG_CANCELED);
+    }
+    hg_core_handle_list_unlock(&hg_core_handle_pool->pending_list);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_handle_pool_release(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context);
+
+    if (hg_core_class->init_info.request_post_shared == 0 ||
+        (hg_core_handle_pool->flags & HG_CORE_HANDLE_MULTI_RECV))
+        return;
+
+    hg_thread_mutex_lock(&hg_core_handle_pool->extend_mutex);
+    hg_core_handle_pool->count--;
+    if (hg_core_handle_pool->mem_count > 0) {
+        hg_core_handle_pool->mem_count--;
+        hg_core_handle_pool_mem_release(hg_core_handle_pool->context, 1);
+    }
+    if (hg_core_handle_pool->shared_count > 0) {
+        hg_core_handle_pool->shared_count--;
+        hg_core_post_shared_release(hg_core_class, 1);
+        if (!hg_atomic_get32(&hg_core_handle_pool->context->unposting))
+            hg_atomic_incr32(&hg_core_handle_pool->reclaim_count);
+    }
+    hg_core_handle_pool->low_watermark =
+        hg_core_handle_pool_watermark(hg_core_handle_pool);
+    hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_handle_pool_get(struct hg_core_handle_pool *hg_core_handle_pool,
+    struct hg_core_private_handle **hg_core_handle_p)
+{
+    struct hg_core_private_handle *hg_core_handle;
+    hg_return_t ret;
+
+    do {
+        if (hg_core_handle_pool->free_queue != NULL) {
+            hg_core_handle =
+                hg_atomic_queue_pop_mc(hg_core_handle_pool->free_queue);
+            if (hg_core_handle != NULL)
+                break;
+        }
+
+        hg_core_handle_list_lock(&hg_core_handle_pool->pending_list);
+        hg_core_handle = HG_LIST_FIRST(&hg_core_handle_pool->pending_list.list);
+        if (hg_core_handle != NULL) {
+            HG_LIST_REMOVE(hg_core_handle, pending);
+            hg_core_handle_list_unlock(&hg_core_handle_pool->pending_list);
+            break;
+        }
+        hg_core_handle_list_unlock(&hg_core_handle_pool->pending_list);
+
+        /* Grow pool when needed */
+        ret = hg_core_handle_pool_extend(hg_core_handle_pool);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, error, ret, "Could not extend pool of handles");
+
+    } while (hg_core_handle == NULL);
+
+    hg_core_handle->acquire_start = hg_time_get_cycles();
+    hg_atomic_decr32(&hg_core_handle_pool->available);
+    hg_core_handle_pool_check(hg_core_handle_pool);
+
+    *hg_core_handle_p = hg_core_handle;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_handle_pool_extend(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    unsigned int i, incr_count;
+    hg_bool_t charged = HG_FALSE;
+    hg_return_t ret;
+
+    /* Create another batch of IDs if empty */
+    hg_thread_mutex_lock(&hg_core_handle_pool->extend_mutex);
+    if (hg_core_handle_pool->extending) {
+        hg_uint64_t wait_start = hg_time_get_cycles(), wait_end;
+
+        hg_thread_cond_wait(&hg_core_handle_pool->extend_cond,
+            &hg_core_handle_pool->extend_mutex);
+        wait_end = hg_time_get_cycles();
+        hg_core_handle_pool->extend_wait_count++;
+        if (wait_end > wait_start)
+            hg_core_handle_pool->extend_wait_time +=
+                hg_time_cycles_to_ns(wait_end - wait_start);
+        hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+        return HG_SUCCESS;
+    }
+
+    /* Do not grow past the soft cap, handles are re-posted as they complete
+     * and NA is left to queue incoming requests */
+    incr_count = hg_core_handle_pool->incr_count;
+    /* Double pool size until target is reached when posting lazily */
+    if (hg_core_handle_pool->count < hg_core_handle_pool->target_count)
+        incr_count = MIN(hg_core_handle_pool->count,
+            hg_core_handle_pool->target_count - hg_core_handle_pool->count);
+    if (hg_core_handle_pool->max_count > 0)
+        incr_count = hg_core_handle_pool_capped(hg_core_handle_pool)
+                         ? 0
+                         : MIN(incr_count, hg_core_handle_pool->max_count -
+                                               hg_core_handle_pool->count);
+    /* Pre-posted handles are drawn from the shared budget if any */
+    if (incr_count > 0 &&
+        !(hg_core_handle_pool->flags & HG_CORE_HANDLE_MULTI_RECV)) {
+        incr_count = hg_core_post_shared_acquire(
+            HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context), incr_count);
+        hg_core_post_shared_starve(
+            HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context),
+            &hg_core_handle_pool->starved, incr_count == 0);
+        if (HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context)
+                ->init_info.request_post_shared > 0)
+            hg_core_handle_pool->shared_count += incr_count;
+    }
+    if (incr_count == 0) {
+        hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+        return HG_SUCCESS;
+    }
+    /* Fail fast once the memory budget is exhausted. Handles that consume
+     * multi-recv buffers have no buffer of their own (these are bounded by
+     * multi_recv_mem_max) and must not fail, they are left uncharged */
+    if (hg_core_handle_pool_mem_acquire(
+            hg_core_handle_pool->context, incr_count)) {
+        hg_core_handle_pool->mem_count += incr_count;
+        charged = HG_TRUE;
+    } else if (!(hg_core_handle_pool->flags & HG_CORE_HANDLE_MULTI_RECV)) {
+        if (hg_core_handle_pool->shared_count > 0) {
+            hg_core_handle_pool->shared_count -= incr_count;
+            hg_core_post_shared_release(
+                HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context),
+                incr_count);
+        }
+        hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+        HG_LOG_SUBSYS_DEBUG(perf,
+            "Memory budget exhausted, could not extend pool of handles");
+        return HG_AGAIN;
+    }
+    hg_core_handle_pool->extending = HG_TRUE;
+    hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+
+    /* Only a single thread can extend the pool */
+    for (i = 0; i < incr_count; i++) {
+        ret = hg_core_handle_pool_insert(hg_core_handle_pool->context,
+            hg_core_handle_pool->na_class, hg_core_handle_pool->na_context,
+            hg_core_handle_pool->flags, hg_core_handle_pool);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            ctx, unlock, ret, "Could not insert handle %u into pool", i);
+    }
+
+unlock:
+    hg_thread_mutex_lock(&hg_core_handle_pool->extend_mutex);
+    if (charged && i < incr_count) {
+        hg_core_handle_pool->mem_count -= incr_count - i;
+        hg_core_handle_pool_mem_release(
+            hg_core_handle_pool->context, incr_count - i);
+    }
+    if (i < incr_count && hg_core_handle_pool->shared_count > 0) {
+        hg_core_handle_pool->shared_count -= incr_count - i;
+        hg_core_post_shared_release(
+            HG_CORE_CONTEXT_CLASS(hg_core_handle_pool->context),
+            incr_count - i);
+    }
+    hg_core_handle_pool->count += i;
+    hg_core_handle_pool->low_watermark =
+        hg_core_handle_pool_watermark(hg_core_handle_pool);
+    hg_core_handle_pool->extend_count++;
+    hg_core_handle_pool->extending = HG_FALSE;
+    hg_thread_cond_broadcast(&hg_core_handle_pool->extend_cond);
+    hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_handle_pool_insert(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context, unsigned long flags,
+    struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    struct hg_core_private_handle *hg_core_handle = NULL;
+    struct hg_core_private_addr *hg_core_addr = NULL;
+    hg_return_t ret;
+    hg_bool_t post = HG_FALSE;
+
+    /* Create new handle */
+    ret = hg_core_create(context, na_class, na_context, flags, &hg_core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        ctx, error, ret, "Could not create HG core handle");
+
+    /* Reset status */
+    hg_atomic_set32(&hg_core_handle->status, 0);
+    hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS);
+
+    /* Create new (empty) source addresses */
+    ret = hg_core_addr_create(HG_CORE_CONTEXT_CLASS(context), &hg_core_addr);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not create HG addr");
+    hg_core_handle->core_handle.info.addr = (hg_core_addr_t) hg_core_addr;
+
+    /* Re-use handle on completion */
+    hg_core_handle->reuse = HG_TRUE;
+
+    /* Add handle to pending list */
+    hg_core_handle_pool_put(hg_core_handle_pool, hg_core_handle);
+
+    /* Handle is pre-posted only when muti-recv is off */
+    if (!(flags & HG_CORE_HANDLE_MULTI_RECV)) {
+        /* Handle will need to be posted */
+        post = HG_TRUE;
+
+        ret = hg_core_post(hg_core_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not post handle (%p)",
+            (void *) hg_core_handle);
+    }
+
+    return HG_SUCCESS;
+
+error:
+    if (hg_core_handle != NULL) {
+        if (post) {
+            hg_core_handle_list_lock(&hg_core_handle_pool->pending_list);
+            HG_LIST_REMOVE(hg_core_handle, pending);
+            hg_core_handle_list_unlock(&hg_core_handle_pool->pending_list);
+            hg_atomic_decr32(&hg_core_handle_pool->available);
+        }
+        hg_core_handle->reuse = HG_FALSE;
+        (void) hg_core_destroy(hg_core_handle);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_handle_pool_unpost(
+    struct hg_core_handle_pool *hg_core_handle_pool, unsigned int timeout_ms)
+{
+    hg_return_t ret;
+
+    if (hg_core_handle_pool->flags & HG_CORE_HANDLE_MULTI_RECV)
+        return HG_SUCCESS; /* Nothing to do */
+
+    ret = hg_core_handle_pool_cancel(hg_core_handle_pool);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not cancel pool handles");
+
+    /* Check that operations have completed */
+    ret = hg_core_context_list_wait(hg_core_handle_pool->context,
+        &hg_core_handle_pool->pending_list, timeout_ms);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        ctx, error, ret, "Could not wait on pool handle list");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_handle_pool_cancel(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    struct hg_core_private_handle *hg_core_handle;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (hg_core_handle_pool->flags & HG_CORE_HANDLE_MULTI_RECV)
+        return HG_SUCCESS; /* Nothing to do */
+
+    /* Check pending list and cancel posted handles */
+    hg_core_handle_list_lock(&hg_core_handle_pool->pending_list);
+
+    HG_LIST_FOREACH (
+        hg_core_handle, &hg_core_handle_pool->pending_list.list, pending) {
+        /* Cancel handle */
+        ret = hg_core_cancel(hg_core_handle, HG_CANCELED);
+        HG_CHECK_SUBSYS_HG_ERROR(ctx, unlock, ret,
+            "Could not cancel handle (%p)", (void *) hg_core_handle);
+    }
+
+unlock:
+    hg_core_handle_list_unlock(&hg_core_handle_pool->pending_list);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_map_hash(hg_hash_table_key_t key)
+{
+    return *((hg_id_t *) key) & 0xffffffff;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_map_slot_hash(hg_id_t id)
+{
+    /* Fibonacci hashing, RPC IDs may not be uniformly distributed */
+    return (unsigned int) ((id * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int
+hg_core_map_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return *((hg_id_t *) key1) == *((hg_id_t *) key2);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_map_value_free(hg_hash_table_value_t value)
+{
+    struct hg_core_rpc_info *hg_core_rpc_info =
+        (struct hg_core_rpc_info *) value;
+
+    if (hg_core_rpc_info->free_callback)
+        hg_core_rpc_info->free_callback(hg_core_rpc_info->data);
+    free(hg_core_rpc_info);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_core_rpc_info *
+hg_core_map_lookup(struct hg_core_map *hg_core_map, hg_id_t *id)
+{
+    const struct hg_core_map_snapshot *snapshot;
+    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
+    unsigned int i;
+
+    /* Snapshots are never modified once published, no lock needed but
+     * writers must not release the snapshot while it is being read */
+    hg_atomic_incr32(&hg_core_map->readers);
+    snapshot = (const struct hg_core_map_snapshot *) hg_atomic_get64(
+        &hg_core_map->snapshot);
+    if (snapshot != NULL) {
+        for (i = hg_core_map_slot_hash(*id) & snapshot->mask;
+             snapshot->slots[i].rpc_info != NULL; i = (i + 1) & snapshot->mask)
+            if (snapshot->slots[i].id == *id) {
+                hg_core_rpc_info = snapshot->slots[i].rpc_info;
+                break;
+            }
+    }
+    hg_atomic_decr32(&hg_core_map->readers);
+
+    return hg_core_rpc_info;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_map_insert(struct hg_core_map *hg_core_map, hg_id_t *id,
+    struct hg_core_rpc_info **hg_core_rpc_info_p)
+{
+    struct hg_core_rpc_info *hg_core_rpc_info;
+    hg_return_t ret = HG_SUCCESS;
+    int rc;
+
+    /* Allocate new RPC info */
+    hg_core_rpc_info = (struct hg_core_rpc_info *) calloc(
+        1, sizeof(struct hg_core_private_rpc_info));
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG core RPC info");
+    hg_core_rpc_info->id = *id;
+
+    hg_thread_rwlock_wrlock(&hg_core_map->lock);
+    rc = hg_hash_table_insert(hg_core_map->map,
+        (hg_hash_table_key_t) &hg_core_rpc_info->id,
+        (hg_hash_table_value_t) hg_core_rpc_info);
+    if (rc != 0) {
+        ret = hg_core_map_publish(hg_core_map, NULL);
+        /* Do not leave an entry that cannot be looked up (frees RPC info) */
+        if (ret != HG_SUCCESS)
+            (void) hg_hash_table_remove(
+                hg_core_map->map, (hg_hash_table_key_t) id);
+    }
+    hg_thread_rwlock_release_wrlock(&hg_core_map->lock);
+    HG_CHECK_SUBSYS_ERROR(
+        cls, rc == 0, error, ret, HG_NOMEM, "hg_hash_table_insert() failed");
+    HG_CHECK_SUBSYS_HG_ERROR(cls, done, ret, "Could not publish RPC map");
+
+    *hg_core_rpc_info_p = hg_core_rpc_info;
+
+    return HG_SUCCESS;
+
+error:
+    free(hg_core_rpc_info);
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_map_remove(struct hg_core_map *hg_core_map, hg_id_t *id)
+{
+    hg_return_t ret;
+    int rc = 0;
+
+    /* Unpublish key first so that lookups no longer return its RPC info */
+    hg_thread_rwlock_wrlock(&hg_core_map->lock);
+    ret = hg_core_map_publish(hg_core_map, id);
+    if (ret == HG_SUCCESS)
+        /* Remove key */
+        rc = hg_hash_table_remove(hg_core_map->map, (hg_hash_table_key_t) id);
+    hg_thread_rwlock_release_wrlock(&hg_core_map->lock);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret, "Could not publish RPC map");
+    HG_CHECK_SUBSYS_ERROR(
+        cls, rc != 1, error, ret, HG_NOENTRY, "hg_hash_table_remove() failed");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_map_publish(struct hg_core_map *hg_core_map, const hg_id_t *exclude_id)
+{
+    struct hg_core_map_snapshot *snapshot, *prev;
+    hg_hash_table_iter_t iter;
+    unsigned int n_slots = HG_CORE_MAP_SNAPSHOT_MIN;
+    hg_return_t ret;
+
+    /* Keep load factor under 1/2 so that probing sequences remain short */
+    while (n_slots < 2 * hg_hash_table_num_entries(hg_core_map->map))
+        n_slots <<= 1;
+
+    snapshot = (struct hg_core_map_snapshot *) calloc(
+        1, sizeof(*snapshot) + n_slots * sizeof(struct hg_core_map_slot));
+    HG_CHECK_SUBSYS_ERROR(cls, snapshot == NULL, error, ret, HG_NOMEM,
+        "Could not allocate RPC map snapshot");
+    snapshot->mask = n_slots - 1;
+
+    hg_hash_table_iterate(hg_core_map->map, &iter);
+    while (hg_hash_table_iter_has_more(&iter)) {
+        struct hg_core_rpc_info *hg_core_rpc_info =
+            (struct hg_core_rpc_info *) hg_hash_table_iter_next(&iter);
+        unsigned int i;
+
+        if (exclude_id != NULL && hg_core_rpc_info->id == *exclude_id)
+            continue;
+
+        for (i = hg_core_map_slot_hash(hg_core_rpc_info->id) & snapshot->mask;
+             snapshot->slots[i].rpc_info != NULL; i = (i + 1) & snapshot->mask)
+            continue;
+        snapshot->slots[i].id = hg_core_rpc_info->id;
+        snapshot->slots[i].rpc_info = hg_core_rpc_info;
+    }
+
+    /* Lookups may still be using the previous snapshot */
+    prev = (struct hg_core_map_snapshot *) hg_atomic_get64(
+        &hg_core_map->snapshot);
+    hg_atomic_set64(&hg_core_map->snapshot, (int64_t) snapshot);
+    if (prev != NULL) {
+        prev->next = hg_core_map->retired;
+        hg_core_map->retired = prev;
+    }
+
+    /* Lookups that start after publication cannot see retired snapshots, the
+     * CAS orders the check of readers after the swap. Otherwise, retry on
+     * next update (or when the class is finalized). */
+    if (hg_core_map->retired != NULL &&
+        hg_atomic_cas32(&hg_core_map->readers, 0, 0))
+        hg_core_map_retired_free(hg_core_map);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_map_retired_free(struct hg_core_map *hg_core_map)
+{
+    while (hg_core_map->retired != NULL) {
+        struct hg_core_map_snapshot *next = hg_core_map->retired->next;
+        free(hg_core_map->retired);
+        hg_core_map->retired = next;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_map_snapshot_free(struct hg_core_map *hg_core_map)
+{
+    hg_core_map_retired_free(hg_core_map);
+    free((struct hg_core_map_snapshot *) hg_atomic_get64(
+        &hg_core_map->snapshot));
+    hg_atomic_set64(&hg_core_map->snapshot, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_histogram_bucket(hg_uint64_t value)
+{
+    unsigned int msb;
+
+    if (value < 4)
+        return (unsigned int) value;
+
+#if defined(__GNUC__)
+    msb = 63 - (unsigned int) __builtin_clzll(value);
+#else
+    for (msb = 2; (value >> msb) > 1; msb++)
+        continue;
+#endif
+
+    /* Power of 2 followed by the next 2 bits */
+    return ((msb - 1) << 2) | (unsigned int) ((value >> (msb - 2)) & 0x3);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_histogram_record(
+    struct hg_core_histogram *hg_core_histogram, hg_uint64_t value)
+{
+    int64_t max = hg_atomic_get64(&hg_core_histogram->max);
+
+    hg_atomic_incr64(
+        &hg_core_histogram->buckets[hg_core_histogram_bucket(value)]);
+    hg_atomic_add64(&hg_core_histogram->sum, (int64_t) value);
+    while ((hg_uint64_t) max < value &&
+           !hg_atomic_cas64(&hg_core_histogram->max, max, (int64_t) value))
+        max = hg_atomic_get64(&hg_core_histogram->max);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_histogram_record_time(struct hg_core_histogram *hg_core_histogram,
+    hg_uint64_t start, hg_uint64_t end)
+{
+    /* Counters of different CPUs may not be perfectly synchronized */
+    hg_core_histogram_record(hg_core_histogram,
+        (end > start) ? hg_time_cycles_to_ns(end - start) : 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_histogram_get(struct hg_core_histogram *hg_core_histogram,
+    struct hg_stats_histogram *histogram)
+{
+    unsigned int i;
+
+    histogram->count = 0;
+    for (i = 0; i < HG_STATS_BUCKET_COUNT; i++) {
+        histogram->buckets[i] =
+            (hg_uint64_t) hg_atomic_get64(&hg_core_histogram->buckets[i]);
+        histogram->count += histogram->buckets[i];
+    }
+    histogram->sum = (hg_uint64_t) hg_atomic_get64(&hg_core_histogram->sum);
+    histogram->max = (hg_uint64_t) hg_atomic_get64(&hg_core_histogram->max);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_trace(
+    struct hg_core_private_handle *hg_core_handle, hg_trace_event_t event)
+{
+    struct hg_core_trace_cb *trace_cb =
+        &HG_CORE_HANDLE_CLASS(hg_core_handle)->trace_cb;
+    struct hg_trace_info trace_info = {
+        .context = hg_core_handle->trace_context_set
+                       ? hg_core_handle->trace_context
+                       : NULL,
+        .cycles = hg_time_get_cycles(),
+        .id = hg_core_handle->core_handle.info.id,
+        .event = event};
+
+    trace_cb->callback((hg_core_handle_t) hg_core_handle, &trace_info,
+        trace_cb->arg);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_capture(struct hg_core_private_handle *hg_core_handle,
+    hg_size_t out_size, hg_uint64_t end)
+{
+    struct hg_core_capture *capture =
+        &HG_CORE_HANDLE_CLASS(hg_core_handle)->capture;
+    size_t in_offset = hg_core_handle->core_handle.na_in_header_offset +
+                       hg_core_header_request_get_size();
+    struct hg_capture_record record = {
+        .id = hg_core_handle->core_handle.info.id,
+        .handler_time =
+            (end > hg_core_handle->handler_start)
+                ? hg_time_cycles_to_ns(end - hg_core_handle->handler_start)
+                : 0,
+        .bulk_size = hg_core_handle->bulk_size,
+        .in_size = 0,
+        .out_size = (hg_uint32_t) out_size};
+
+    /* Payload that did not fit in the request was transferred separately */
+    if (hg_core_handle->in_extra_size > 0)
+        record.in_size = (hg_uint32_t) hg_core_handle->in_extra_size;
+    else if (hg_core_handle->in_buf_used > in_offset)
+        record.in_size =
+            (hg_uint32_t) (hg_core_handle->in_buf_used - in_offset);
+
+    hg_thread_mutex_lock(&capture->mutex);
+    /* Capture may have been stopped concurrently */
+    if (capture->file != NULL) {
+        /* Counters of different CPUs may not be perfectly synchronized */
+        record.arrival =
+            (hg_core_handle->handler_start > capture->start)
+                ? hg_time_cycles_to_ns(
+                      hg_core_handle->handler_start - capture->start)
+                : 0;
+        if (fwrite(&record, sizeof(record), 1, capture->file) != 1)
+            HG_LOG_SUBSYS_WARNING(rpc, "Could not write capture record");
+    }
+    hg_thread_mutex_unlock(&capture->mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup_parse(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr *hg_core_addr,
+    struct hg_core_addr_lookup_target *target)
+{
+    const char *name_str = NULL;
+#ifdef NA_HAS_SM
+    hg_return_t ret;
+#else
+    (void) hg_core_class;
+#endif
+
+    /* TODO lookup could also create self addresses */
+
+#ifdef NA_HAS_SM
+    if (hg_core_class->core_class.na_sm_class != NULL)
+        name_str = strstr(name, HG_CORE_ADDR_DELIMITER);
+
+    /* Parse name string */
+    if (name_str != NULL) {
+        char uuid_str[NA_SM_HOST_ID_LEN + 1];
+        na_return_t na_ret;
+        int rc;
+
+        /* Get first part of address string with host ID */
+        rc = sscanf(name, "uid://%11[^#]", uuid_str);
+        HG_CHECK_SUBSYS_ERROR(addr, rc != 1, error, ret, HG_PROTONOSUPPORT,
+            "Malformed address format (%s)", name);
+
+        na_ret = NA_SM_String_to_host_id(uuid_str, &hg_core_addr->host_id);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "NA_SM_String_to_host_id() failed (%s)",
+            NA_Error_to_string(na_ret));
+
+        /* Skip delimiter */
+        name_str += HG_CORE_ADDR_DELIMITER_LEN;
+
+        /* Compare IDs, if they match it's local address */
+        if (NA_SM_Host_id_cmp(hg_core_addr->host_id, hg_core_class->host_id)) {
+            HG_LOG_SUBSYS_DEBUG(addr, "%s is a local address", name);
+            target->na_class_p =
+                &hg_core_addr->core_addr.core_class->na_sm_class;
+            target->na_addr_p = &hg_core_addr->core_addr.na_sm_addr;
+            target->na_addr_serialize_size_p =
+                &hg_core_addr->na_sm_addr_serialize_size;
+        } else {
+            /* Remote lookup */
+            name_str = strstr(name_str, HG_CORE_ADDR_DELIMITER);
+            HG_CHECK_SUBSYS_ERROR(addr, name_str == NULL, error, ret,
+                HG_PROTONOSUPPORT, "Malformed remote address string (%s)",
+                name);
+
+            target->na_class_p = &hg_core_addr->core_addr.core_class->na_class;
+            target->na_addr_p = &hg_core_addr->core_addr.na_addr;
+            target->na_addr_serialize_size_p =
+                &hg_core_addr->na_addr_serialize_size;
+            name_str += HG_CORE_ADDR_DELIMITER_LEN;
+        }
+    } else {
+#endif
+        /* Remote lookup */
+        target->na_class_p = &hg_core_addr->core_addr.core_class->na_class;
+        target->na_addr_p = &hg_core_addr->core_addr.na_addr;
+        target->na_addr_serialize_size_p =
+            &hg_core_addr->na_addr_serialize_size;
+        name_str = name;
+#ifdef NA_HAS_SM
+    }
+#endif
+    target->name_str = name_str;
+
+    return HG_SUCCESS;
+
+#ifdef NA_HAS_SM
+error:
+    return ret;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr **addr_p)
+{
+    struct hg_core_private_addr *hg_core_addr = NULL;
+    struct hg_core_addr_lookup_target target;
+    na_return_t na_ret;
+    hg_return_t ret;
+
+#ifdef NA_HAS_SM
+    /* Re-use addr previously resolved with the same string */
+    if (hg_core_class->addr_cache.map != NULL) {
+        hg_core_addr = hg_core_addr_cache_lookup(hg_core_class, name);
+        if (hg_core_addr != NULL) {
+            HG_LOG_SUBSYS_DEBUG(addr, "Found %s in addr cache", name);
+            *addr_p = hg_core_addr;
+            return HG_SUCCESS;
+        }
+    }
+#endif
+
+    /* Allocate addr */
+    ret = hg_core_addr_create(hg_core_class, &hg_core_addr);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not create HG core addr");
+
+    ret = hg_core_addr_lookup_parse(hg_core_class, name, hg_core_addr, &target);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not parse %s", name);
+
+    /* Lookup adress */
+    na_ret = NA_Addr_lookup(*target.na_class_p, target.name_str,
+        target.na_addr_p);
+    HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not lookup address %s (%s)",
+        target.name_str, NA_Error_to_string(na_ret));
+
+    /* Cache serialize size */
+    *target.na_addr_serialize_size_p =
+        NA_Addr_get_serialize_size(*target.na_class_p, *target.na_addr_p);
+
+#ifdef NA_HAS_SM
+    if (hg_core_class->addr_cache.map != NULL)
+        hg_core_addr_cache_insert(hg_core_class, name, hg_core_addr);
+#endif
+
+    *addr_p = hg_core_addr;
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_addr_free(hg_core_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup_multi(struct hg_core_private_class *hg_core_class,
+    const char *const *names, unsigned int count,
+    struct hg_core_private_addr **addrs)
+{
+    struct hg_core_addr_lookup_target *targets = NULL;
+    unsigned int *target_index = NULL, *first_index = NULL;
+    const char **batch_names = NULL;
+    na_addr_t **batch_addrs = NULL;
+    hg_hash_table_t *name_map = NULL;
+    unsigned int i, j, n_targets = 0;
+    hg_return_t ret;
+
+    for (i = 0; i < count; i++)
+        addrs[i] = NULL;
+
+    targets = (struct hg_core_addr_lookup_target *) malloc(
+        count * sizeof(*targets));
+    target_index = (unsigned int *) malloc(count * sizeof(*target_index));
+    first_index = (unsigned int *) malloc(count * sizeof(*first_index));
+    batch_names = (const char **) malloc(count * sizeof(*batch_names));
+    batch_addrs = (na_addr_t **) malloc(count * sizeof(*batch_addrs));
+    HG_CHECK_SUBSYS_ERROR(addr,
+        targets == NULL || target_index == NULL || first_index == NULL ||
+            batch_names == NULL || batch_addrs == NULL,
+        error, ret, HG_NOMEM, "Could not allocate lookup arrays");
+
+    /* Names that appear more than once within the list are resolved once */
+    name_map =
+        hg_hash_table_new(hg_core_addr_cache_hash, hg_core_addr_cache_equal);
+    HG_CHECK_SUBSYS_ERROR(addr, name_map == NULL, error, ret, HG_NOMEM,
+        "Could not allocate lookup name map");
+
+    for (i = 0; i < count; i++) {
+        hg_hash_table_value_t value;
+
+        HG_CHECK_SUBSYS_ERROR(addr, names[i] == NULL, error, ret,
+            HG_INVALID_ARG, "Lookup name %u is NULL", i);
+
+        value = hg_hash_table_lookup(
+            name_map, (hg_hash_table_key_t) (uintptr_t) names[i]);
+        if (value != HG_HASH_TABLE_NULL) {
+            first_index[i] = (unsigned int) ((uintptr_t) value - 1);
+            continue;
+        }
+        first_index[i] = i;
+        HG_CHECK_SUBSYS_ERROR(addr,
+            hg_hash_table_insert(name_map,
+                (hg_hash_table_key_t) (uintptr_t) names[i],
+                (hg_hash_table_value_t) (uintptr_t) (i + 1)) == 0,
+            error, ret, HG_NOMEM, "Could not insert %s into name map",
+            names[i]);
+
+#ifdef NA_HAS_SM
+        /* Re-use addr previously resolved with the same string */
+        if (hg_core_class->addr_cache.map != NULL) {
+            addrs[i] = hg_core_addr_cache_lookup(hg_core_class, names[i]);
+            if (addrs[i] != NULL) {
+                HG_LOG_SUBSYS_DEBUG(addr, "Found %s in addr cache", names[i]);
+                continue;
+            }
+        }
+#endif
+
+        ret = hg_core_addr_create(hg_core_class, &addrs[i]);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            addr, error, ret, "Could not create HG core addr");
+
+        ret = hg_core_addr_lookup_parse(
+            hg_core_class, names[i], addrs[i], &targets[n_targets]);
+        HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not parse %s",
+            names[i]);
+        target_index[n_targets++] = i;
+    }
+
+    /* Issue one NA batch lookup per NA class */
+    for (i = 0; i < n_targets; i++) {
+        na_class_t *na_class = *targets[i].na_class_p;
+        unsigned int batch_count = 0;
+        na_return_t na_ret;
+
+        if (*targets[i].na_addr_p != NULL)
+            continue;
+
+        for (j = i; j < n_targets; j++) {
+            if (*targets[j].na_class_p == na_class &&
+                *targets[j].na_addr_p == NULL)
+                batch_names[batch_count++] = targets[j].name_str;
+        }
+
+        HG_LOG_SUBSYS_DEBUG(
+            addr, "Looking up batch of %u addrs", batch_count);
+
+        na_ret = NA_Addr_lookup_batch(
+            na_class, batch_names, (size_t) batch_count, batch_addrs);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not lookup batch of %u addrs (%s)",
+            batch_count, NA_Error_to_string(na_ret));
+
+        for (j = i, batch_count = 0; j < n_targets; j++) {
+            if (*targets[j].na_class_p == na_class &&
+                *targets[j].na_addr_p == NULL) {
+                *targets[j].na_addr_p = batch_addrs[batch_count++];
+
+                /* Cache serialize size */
+                *targets[j].na_addr_serialize_size_p =
+                    NA_Addr_get_serialize_size(
+                        na_class, *targets[j].na_addr_p);
+            }
+        }
+    }
+
+#ifdef NA_HAS_SM
+    if (hg_core_class->addr_cache.map != NULL)
+        for (i = 0; i < n_targets; i++)
+            hg_core_addr_cache_insert(hg_core_class, names[target_index[i]],
+                addrs[target_index[i]]);
+#endif
+
+    /* Duplicate names share the same addr */
+    for (i = 0; i < count; i++) {
+        if (first_index[i] != i) {
+            addrs[i] = addrs[first_index[i]];
+            hg_atomic_incr32(&addrs[i]->ref_count);
+        }
+    }
+
+    hg_hash_table_free(name_map);
+    free(batch_addrs);
+    free(batch_names);
+    free(first_index);
+    free(target_index);
+    free(targets);
+
+    return HG_SUCCESS;
+
+error:
+    /* Duplicate names have not been assigned yet */
+    for (i = 0; i < count; i++) {
+        hg_core_addr_free(addrs[i]);
+        addrs[i] = NULL;
+    }
+    if (name_map != NULL)
+        hg_hash_table_free(name_map);
+    free(batch_addrs);
+    free(batch_names);
+    free(first_index);
+    free(target_index);
+    free(targets);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_warm(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr *const *addrs, unsigned int count)
+{
+    na_addr_t **na_addrs = NULL;
+    size_t na_count = 0;
+#ifdef NA_HAS_SM
+    na_addr_t **na_sm_addrs = NULL;
+    size_t na_sm_count = 0;
+#endif
+    unsigned int i;
+    na_return_t na_ret;
+    hg_return_t ret;
+
+    na_addrs = (na_addr_t **) malloc(count * sizeof(*na_addrs));
+    HG_CHECK_SUBSYS_ERROR(addr, na_addrs == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %u NA addrs", count);
+#ifdef NA_HAS_SM
+    na_sm_addrs = (na_addr_t **) malloc(count * sizeof(*na_sm_addrs));
+    HG_CHECK_SUBSYS_ERROR(addr, na_sm_addrs == NULL, error, ret, HG_NOMEM,
+        "Could not allocate array of %u NA SM addrs", count);
+#endif
+
+    /* Only warm up the NA addr that will be used to reach the target */
+    for (i = 0; i < count; i++) {
+        const struct hg_core_addr *core_addr = &addrs[i]->core_addr;
+
+        HG_CHECK_SUBSYS_ERROR(addr,
+            core_addr->core_class != &hg_core_class->core_class, error, ret,
+            HG_INVALID_ARG, "Address %u does not belong to HG core class", i);
+        if (core_addr->is_self)
+            continue;
+#ifdef NA_HAS_SM
+        if (core_addr->na_sm_addr != NULL) {
+            na_sm_addrs[na_sm_count++] = core_addr->na_sm_addr;
+            continue;
+        }
+#endif
+        if (core_addr->na_addr != NULL)
+            na_addrs[na_count++] = core_addr->na_addr;
+    }
+
+    if (na_count > 0) {
+        na_ret = NA_Addr_warm(hg_core_class->core_class.na_class,
+            (na_addr_t *const *) na_addrs, na_count);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not warm up %zu NA addrs (%s)",
+            na_count, NA_Error_to_string(na_ret));
+    }
+#ifdef NA_HAS_SM
+    if (na_sm_count > 0) {
+        na_ret = NA_Addr_warm(hg_core_class->core_class.na_sm_class,
+            (na_addr_t *const *) na_sm_addrs, na_sm_count);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not warm up %zu NA SM addrs (%s)",
+            na_sm_count, NA_Error_to_string(na_ret));
+    }
+    free(na_sm_addrs);
+#endif
+    free(na_addrs);
+
+    return HG_SUCCESS;
+
+error:
+#ifdef NA_HAS_SM
+    free(na_sm_addrs);
+#endif
+    free(na_addrs);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_create(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr **hg_core_addr_p)
+{
+    struct hg_core_private_addr *hg_core_addr = NULL;
+    hg_return_t ret;
+
+    hg_core_addr =
+        (struct hg_core_private_addr *) calloc(1, sizeof(*hg_core_addr));
+    HG_CHECK_SUBSYS_ERROR(addr, hg_core_addr == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG core addr");
+
+    hg_core_addr->core_addr.core_class = (hg_core_class_t *) hg_core_class;
+    hg_core_addr->core_addr.na_addr = NULL;
+#ifdef NA_HAS_SM
+    hg_core_addr->core_addr.na_sm_addr = NULL;
+#endif
+    hg_core_addr->core_addr.is_self = HG_FALSE;
+
+    hg_atomic_init32(&hg_core_addr->ref_count, 1);
+
+    /* Increment N addrs from HG class */
+    hg_atomic_incr32(&hg_core_class->n_addrs);
+
+    *hg_core_addr_p = hg_core_addr;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_free(struct hg_core_private_addr *hg_core_addr)
+{
+    struct hg_core_private_class *hg_core_class;
+
+    if (hg_core_addr == NULL)
+        return;
+
+    if (hg_atomic_decr32(&hg_core_addr->ref_count))
+        /* Cannot free yet */
+        return;
+
+    /* Keep reference to core class */
+    hg_core_class = HG_CORE_ADDR_CLASS(hg_core_addr);
+
+#ifdef NA_HAS_SM
+    /* Evict from addr cache */
+    hg_core_addr_cache_remove(hg_core_addr);
+#endif
+
+    /* Free NA addresses */
+    hg_core_addr_free_na(hg_core_addr);
+
+    free(hg_core_addr);
+
+    /* Decrement N addrs from HG class */
+    hg_atomic_decr32(&hg_core_class->n_addrs);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_free_na(struct hg_core_private_addr *hg_core_addr)
+{
+    /* Free NA address */
+    if (hg_core_addr->core_addr.na_addr != NULL) {
+        NA_Addr_free(hg_core_addr->core_addr.core_class->na_class,
+            hg_core_addr->core_addr.na_addr);
+        hg_core_addr->core_addr.na_addr = NULL;
+        hg_core_addr->na_addr_serialize_size = 0;
+    }
+
+#ifdef NA_HAS_SM
+    /* Free NA SM address */
+    if (hg_core_addr->core_addr.na_sm_addr != NULL) {
+        NA_Addr_free(hg_core_addr->core_addr.core_class->na_sm_class,
+            hg_core_addr->core_addr.na_sm_addr);
+        hg_core_addr->core_addr.na_sm_addr = NULL;
+        hg_core_addr->na_sm_addr_serialize_size = 0;
+    }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_addr_ref_get(struct hg_core_private_context *context,
+    struct hg_core_private_addr *hg_core_addr)
+{
+    struct hg_core_addr_ref *slot =
+        &context->addr_refs
+             .slots[((uintptr_t) hg_core_addr >> 4) % HG_CORE_ADDR_REF_SLOTS];
+    hg_bool_t cached = HG_TRUE;
+
+    hg_thread_spin_lock(&context->addr_refs.lock);
+    if (slot->addr == hg_core_addr)
+        slot->count++;
+    else if (slot->addr == NULL) {
+        /* Take free entry, the context holds one reference to addr */
+        slot->addr = hg_core_addr;
+        slot->count = 1;
+        hg_atomic_incr32(&hg_core_addr->ref_count);
+    } else
+        cached = HG_FALSE;
+    hg_thread_spin_unlock(&context->addr_refs.lock);
+
+    if (!cached)
+        hg_atomic_incr32(&hg_core_addr->ref_count);
+
+    return cached;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_ref_put(struct hg_core_private_context *context,
+    struct hg_core_private_addr *hg_core_addr, hg_bool_t cached)
+{
+    if (cached) {
+        struct hg_core_addr_ref *slot =
+            &context->addr_refs
+                 .slots[((uintptr_t) hg_core_addr >> 4) %
+                        HG_CORE_ADDR_REF_SLOTS];
+        hg_bool_t last;
+
+        /* Last handle releases the reference held by the context */
+        hg_thread_spin_lock(&context->addr_refs.lock);
+        last = (--slot->count == 0);
+        if (last)
+            slot->addr = NULL;
+        hg_thread_spin_unlock(&context->addr_refs.lock);
+
+        if (!last)
+            return;
+    }
+
+    hg_core_addr_free(hg_core_addr);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_peer_table_init(
+    struct hg_core_peer_table *peer_table, unsigned int max)
+{
+    unsigned int n_entries = 2;
+    hg_return_t ret;
+    int rc;
+
+    if (max == 0)
+        return HG_SUCCESS;
+
+    /* Keep table at most half full */
+    while (n_entries < 2 * max)
+        n_entries <<= 1;
+
+    peer_table->entries = (struct hg_core_peer_entry *) calloc(
+        n_entries, sizeof(*peer_table->entries));
+    HG_CHECK_SUBSYS_ERROR(ctx, peer_table->entries == NULL, error, ret,
+        HG_NOMEM, "Could not allocate peer table of %u entries", n_entries);
+    peer_table->mask = n_entries - 1;
+    peer_table->count = 0;
+    peer_table->max = max;
+
+    rc = hg_thread_spin_init(&peer_table->lock);
+    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
+        "hg_thread_spin_init() failed");
+
+    return HG_SUCCESS;
+
+error:
+    free(peer_table->entries);
+    peer_table->entries = NULL;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_peer_table_free(struct hg_core_peer_table *peer_table)
+{
+    unsigned int i;
+
+    if (peer_table->entries == NULL)
+        return;
+
+    for (i = 0; i <= peer_table->mask; i++)
+        if (peer_table->entries[i].na_addr != NULL)
+            NA_Addr_free(peer_table->entries[i].na_class,
+                peer_table->entries[i].na_addr);
+    free(peer_table->entries);
+    peer_table->entries = NULL;
+    (void) hg_thread_spin_destroy(&peer_table->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_peer_stats *
+hg_core_peer_lock(struct hg_core_private_context *context,
+    na_class_t *na_class, na_addr_t *na_addr)
+{
+    struct hg_core_peer_table *peer_table = &context->peer_table;
+    struct hg_core_peer_entry *entry;
+    unsigned int i;
+
+    if (peer_table->entries == NULL || na_addr == NULL)
+        return NULL;
+
+    /* NA addrs of the same peer are shared, key on the pointer */
+    i = (unsigned int) ((uintptr_t) na_addr >> 4) & peer_table->mask;
+    hg_thread_spin_lock(&peer_table->lock);
+    for (entry = &peer_table->entries[i]; entry->na_addr != na_addr;
+         entry = &peer_table->entries[i]) {
+        if (entry->na_addr == NULL) {
+            /* New peer, not counted once table is full */
+            if (peer_table->count == peer_table->max ||
+                NA_Addr_dup(na_class, na_addr, &entry->na_addr) != NA_SUCCESS) {
+                entry->na_addr = NULL;
+                hg_thread_spin_unlock(&peer_table->lock);
+                return NULL;
+            }
+            entry->na_class = na_class;
+            peer_table->count++;
+            break;
+        }
+        i = (i + 1) & peer_table->mask;
+    }
+
+    return &entry->stats;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_peer_stats *
+hg_core_peer_lock_handle(struct hg_core_private_handle *hg_core_handle)
+{
+    if (hg_core_handle->is_self)
+        return NULL;
+
+    return hg_core_peer_lock(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+        hg_core_handle->na_class, hg_core_handle->na_addr);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_peer_unlock(struct hg_core_private_context *context)
+{
+    hg_thread_spin_unlock(&context->peer_table.lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_peer_table_get(struct hg_core_peer_table *peer_table,
+    const na_addr_t *na_addr, struct hg_peer_stats *stats)
+{
+    unsigned int i;
+
+    if (peer_table->entries == NULL || na_addr == NULL)
+        return;
+
+    i = (unsigned int) ((uintptr_t) na_addr >> 4) & peer_table->mask;
+    hg_thread_spin_lock(&peer_table->lock);
+    while (peer_table->entries[i].na_addr != NULL) {
+        if (peer_table->entries[i].na_addr == na_addr) {
+            hg_core_peer_stats_add(stats, &peer_table->entries[i].stats);
+            break;
+        }
+        i = (i + 1) & peer_table->mask;
+    }
+    hg_thread_spin_unlock(&peer_table->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_peer_stats_add(
+    struct hg_peer_stats *stats, const struct hg_peer_stats *delta)
+{
+    stats->rpc_in += delta->rpc_in;
+    stats->rpc_out += delta->rpc_out;
+    stats->bytes_in += delta->bytes_in;
+    stats->bytes_out += delta->bytes_out;
+    stats->bulk_bytes += delta->bulk_bytes;
+    stats->error_count += delta->error_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_core_peer_cmp_addr(const void *a, const void *b)
+{
+    uintptr_t addr_a =
+        (uintptr_t) ((const struct hg_core_peer_entry *) a)->na_addr;
+    uintptr_t addr_b =
+        (uintptr_t) ((const struct hg_core_peer_entry *) b)->na_addr;
+
+    return (addr_a > addr_b) - (addr_a < addr_b);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_core_peer_cmp_traffic(const void *a, const void *b)
+{
+    const struct hg_peer_stats *stats_a =
+        &((const struct hg_core_peer_entry *) a)->stats;
+    const struct hg_peer_stats *stats_b =
+        &((const struct hg_core_peer_entry *) b)->stats;
+    hg_uint64_t rpcs_a = stats_a->rpc_in + stats_a->rpc_out,
+                rpcs_b = stats_b->rpc_in + stats_b->rpc_out;
+    hg_uint64_t bytes_a =
+        stats_a->bytes_in + stats_a->bytes_out + stats_a->bulk_bytes;
+    hg_uint64_t bytes_b =
+        stats_b->bytes_in + stats_b->bytes_out + stats_b->bulk_bytes;
+
+    if (rpcs_a != rpcs_b)
+        return (rpcs_a < rpcs_b) ? 1 : -1;
+
+    return (bytes_a < bytes_b) - (bytes_a > bytes_b);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_set_remove(struct hg_core_private_addr *hg_core_addr)
+{
+    hg_return_t ret;
+
+#ifdef NA_HAS_SM
+    /* Further lookups must resolve addr again */
+    hg_core_addr_cache_remove(hg_core_addr);
+#endif
+
+    if (hg_core_addr->core_addr.na_addr != NULL) {
+        na_return_t na_ret =
+            NA_Addr_set_remove(hg_core_addr->core_addr.core_class->na_class,
+                hg_core_addr->core_addr.na_addr);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "NA_Addr_set_remove() failed (%s)",
+            NA_Error_to_string(na_ret));
+    }
+
+#ifdef NA_HAS_SM
+    if (hg_core_addr->core_addr.na_sm_addr != NULL) {
+        na_return_t na_ret =
+            NA_Addr_set_remove(hg_core_addr->core_addr.core_class->na_sm_class,
+                hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "NA_Addr_set_remove() failed (%s)",
+            NA_Error_to_string(na_ret));
+    }
+#endif
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_addr_cache_hash(hg_hash_table_key_t key)
+{
+    return hg_hash_string((const char *) key);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int
+hg_core_addr_cache_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return strcmp((const char *) key1, (const char *) key2) == 0;
+}
+
+#ifdef NA_HAS_SM
+/*---------------------------------------------------------------------------*/
+static struct hg_core_private_addr *
+hg_core_addr_cache_lookup(
+    struct hg_core_private_class *hg_core_class, const char *name)
+{
+    struct hg_core_addr_cache *addr_cache = &hg_core_class->addr_cache;
+    struct hg_core_private_addr *hg_core_addr;
+
+    hg_thread_mutex_lock(&addr_cache->lock);
+    hg_core_addr = (struct hg_core_private_addr *) hg_hash_table_lookup(
+        addr_cache->map, (hg_hash_table_key_t) (uintptr_t) name);
+    if (hg_core_addr != HG_HASH_TABLE_NULL) {
+        int32_t ref_count;
+
+        /* Only take a reference if addr is not already being freed */
+        do {
+            ref_count = hg_atomic_get32(&hg_core_addr->ref_count);
+        } while (ref_count > 0 && !hg_atomic_cas32(&hg_core_addr->ref_count,
+                                      ref_count, ref_count + 1));
+        if (ref_count == 0)
+            hg_core_addr = NULL;
+    } else
+        hg_core_addr = NULL;
+    hg_thread_mutex_unlock(&addr_cache->lock);
+
+    return hg_core_addr;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_cache_insert(struct hg_core_private_class *hg_core_class,
+    const char *name, struct hg_core_private_addr *hg_core_addr)
+{
+    struct hg_core_addr_cache *addr_cache = &hg_core_class->addr_cache;
+    char *cache_key;
+
+    cache_key = strdup(name);
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        addr, cache_key == NULL, error, "Could not dup cache key");
+
+    hg_thread_mutex_lock(&addr_cache->lock);
+    if (hg_hash_table_lookup(addr_cache->map,
+            (hg_hash_table_key_t) cache_key) == HG_HASH_TABLE_NULL &&
+        hg_hash_table_insert(addr_cache->map, (hg_hash_table_key_t) cache_key,
+            (hg_hash_table_value_t) hg_core_addr) != 0) {
+        hg_core_addr->cache_key = cache_key;
+        cache_key = NULL;
+    }
+    hg_thread_mutex_unlock(&addr_cache->lock);
+
+    free(cache_key);
+
+error:
+    return;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_cache_remove(struct hg_core_private_addr *hg_core_addr)
+{
+    struct hg_core_addr_cache *addr_cache;
+
+    if (hg_core_addr->cache_key == NULL)
+        return;
+
+    addr_cache = &HG_CORE_ADDR_CLASS(hg_core_addr)->addr_cache;
+
+    hg_thread_mutex_lock(&addr_cache->lock);
+    if (hg_hash_table_lookup(addr_cache->map,
+            (hg_hash_table_key_t) hg_core_addr->cache_key) == hg_core_addr)
+        hg_hash_table_remove(
+            addr_cache->map, (hg_hash_table_key_t) hg_core_addr->cache_key);
+    hg_thread_mutex_unlock(&addr_cache->lock);
+
+    free(hg_core_addr->cache_key);
+    hg_core_addr->cache_key = NULL;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_self(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr **hg_core_addr_p)
+{
+    struct hg_core_private_addr *hg_core_addr = NULL;
+    hg_return_t ret;
+    na_return_t na_ret;
+
+    ret = hg_core_addr_create(hg_core_class, &hg_core_addr);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not create HG core addr");
+    hg_core_addr->core_addr.is_self = HG_TRUE;
+
+    /* Get NA address */
+    na_ret = NA_Addr_self(
+        hg_core_class->core_class.na_class, &hg_core_addr->core_addr.na_addr);
+    HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not get self address (%s)",
+        NA_Error_to_string(na_ret));
+
+    /* Cache serialize size */
+    hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
+        hg_core_class->core_class.na_class, hg_core_addr->core_addr.na_addr);
+
+#ifdef NA_HAS_SM
+    if (hg_core_class->core_class.na_sm_class) {
+        /* Get SM address */
+        na_ret = NA_Addr_self(hg_core_class->core_class.na_sm_class,
+            &hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not get self SM address (%s)",
+            NA_Error_to_string(na_ret));
+
+        /* Cache serialize size */
+        hg_core_addr->na_sm_addr_serialize_size =
+            NA_Addr_get_serialize_size(hg_core_class->core_class.na_sm_class,
+                hg_core_addr->core_addr.na_sm_addr);
+
+        /* Copy local host ID */
+        NA_SM_Host_id_copy(&hg_core_addr->host_id, hg_core_class->host_id);
+    }
+#endif
+
+    *hg_core_addr_p = hg_core_addr;
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_addr_free(hg_core_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_dup(struct hg_core_private_addr *hg_core_addr,
+    struct hg_core_private_addr **hg_core_addr_p)
+{
+    struct hg_core_private_addr *hg_new_addr = NULL;
+    hg_return_t ret;
+
+    ret = hg_core_addr_create(HG_CORE_ADDR_CLASS(hg_core_addr), &hg_new_addr);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not create HG core addr");
+    hg_new_addr->core_addr.is_self = hg_core_addr->core_addr.is_self;
+
+    if (hg_core_addr->core_addr.na_addr != NULL) {
+        na_return_t na_ret = NA_Addr_dup(
+            hg_core_addr->core_addr.core_class->na_class,
+            hg_core_addr->core_addr.na_addr, &hg_new_addr->core_addr.na_addr);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not duplicate address (%s)",
+            NA_Error_to_string(na_ret));
+
+        /* Copy serialize size */
+        hg_new_addr->na_addr_serialize_size =
+            hg_core_addr->na_addr_serialize_size;
+    }
+
+#ifdef NA_HAS_SM
+    if (hg_core_addr->core_addr.na_sm_addr != NULL) {
+        na_return_t na_ret =
+            NA_Addr_dup(hg_core_addr->core_addr.core_class->na_sm_class,
+                hg_core_addr->core_addr.na_sm_addr,
+                &hg_new_addr->core_addr.na_sm_addr);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not duplicate address (%s)",
+            NA_Error_to_string(na_ret));
+
+        /* Copy serialize size */
+        hg_new_addr->na_sm_addr_serialize_size =
+            hg_core_addr->na_sm_addr_serialize_size;
+
+        /* Copy local host ID */
+        NA_SM_Host_id_copy(&hg_new_addr->host_id, hg_core_addr->host_id);
+    }
+#endif
+
+    *hg_core_addr_p = hg_new_addr;
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_addr_free(hg_new_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_addr_cmp(
+    struct hg_core_private_addr *addr1, struct hg_core_private_addr *addr2)
+{
+    hg_bool_t ret = HG_TRUE;
+
+    /* Cannot be separate classes */
+    if (addr1->core_addr.core_class != addr2->core_addr.core_class)
+        return HG_FALSE;
+
+    /* Self addresses are always equal */
+    if (addr1->core_addr.is_self && addr2->core_addr.is_self)
+        return HG_TRUE;
+
+    /* Compare NA addresses */
+    ret &= (hg_bool_t) NA_Addr_cmp(addr1->core_addr.core_class->na_class,
+        addr1->core_addr.na_addr, addr2->core_addr.na_addr);
+
+#ifdef NA_HAS_SM
+    /* Compare NA SM addresses */
+    if (addr1->core_addr.core_class->na_sm_class)
+        ret &= (hg_bool_t) NA_Addr_cmp(addr1->core_addr.core_class->na_sm_class,
+            addr1->core_addr.na_sm_addr, addr2->core_addr.na_sm_addr);
+#endif
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_to_string(
+    char *buf, hg_size_t *buf_size, struct hg_core_private_addr *hg_core_addr)
+{
+    na_class_t *na_class = hg_core_addr->core_addr.core_class->na_class;
+    na_addr_t *na_addr = hg_core_addr->core_addr.na_addr;
+    char *buf_ptr = buf;
+    size_t new_buf_size = 0, buf_size_used = 0;
+    hg_return_t ret;
+    na_return_t na_ret;
+
+    new_buf_size = (size_t) *buf_size;
+
+#ifdef NA_HAS_SM
+    /* When we have local and remote addresses */
+    if ((hg_core_addr->core_addr.na_sm_addr != NULL) &&
+        (hg_core_addr->core_addr.na_addr != NULL)) {
+        char addr_str[HG_CORE_ADDR_MAX_SIZE];
+        char uuid_str[NA_SM_HOST_ID_LEN + 1];
+        int desc_len;
+
+        /* Convert host ID to string and generate addr string */
+        na_ret = NA_SM_Host_id_to_string(hg_core_addr->host_id, uuid_str);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "NA_SM_Host_id_to_string() failed (%s)",
+            NA_Error_to_string(na_ret));
+
+        desc_len = snprintf(addr_str, HG_CORE_ADDR_MAX_SIZE,
+            "uid://%s" HG_CORE_ADDR_DELIMITER, uuid_str);
+        HG_CHECK_SUBSYS_ERROR(addr, desc_len > HG_CORE_ADDR_MAX_SIZE, error,
+            ret, HG_OVERFLOW, "Exceeding max addr name");
+
+        if (buf_ptr) {
+            strcpy(buf_ptr, addr_str);
+            buf_ptr += desc_len;
+        }
+        buf_size_used += (hg_size_t) desc_len;
+        if (*buf_size > (unsigned int) desc_len)
+            new_buf_size = *buf_size - (size_t) desc_len;
+
+        /* Get NA SM address string */
+        na_ret =
+            NA_Addr_to_string(hg_core_addr->core_addr.core_class->na_sm_class,
+                buf_ptr, &new_buf_size, hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not convert SM address to string (%s)",
+            NA_Error_to_string(na_ret));
+
+        if (buf_ptr) {
+            buf_ptr[new_buf_size - 1] = *HG_CORE_ADDR_DELIMITER;
+            buf_ptr += new_buf_size;
+        }
+        buf_size_used += new_buf_size;
+        if (*buf_size > new_buf_size)
+            new_buf_size = *buf_size - new_buf_size;
+    } else if (hg_core_addr->core_addr.na_sm_addr != NULL) {
+        na_class = hg_core_addr->core_addr.core_class->na_sm_class;
+        na_addr = hg_core_addr->core_addr.na_sm_addr;
+    }
+#endif
+
+    /* Get NA address string */
+    na_ret = NA_Addr_to_string(na_class, buf_ptr, &new_buf_size, na_addr);
+    HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not convert address (%p) to string (%s)",
+        (void *) na_addr, NA_Error_to_string(na_ret));
+
+    *buf_size = (hg_size_t) (new_buf_size + buf_size_used);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_core_addr_get_serialize_size(
+    struct hg_core_private_addr *hg_core_addr, hg_uint8_t flags)
+{
+    hg_size_t ret = sizeof(size_t);
+
+    if (hg_core_addr->core_addr.na_addr != NULL) {
+        if (hg_core_addr->na_addr_serialize_size == 0) {
+            /* Cache serialize size */
+            hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
+                hg_core_addr->core_addr.core_class->na_class,
+                hg_core_addr->core_addr.na_addr);
+        }
+
+        ret += hg_core_addr->na_addr_serialize_size;
+    }
+
+#ifdef NA_HAS_SM
+    ret += sizeof(size_t);
+
+    if ((flags & HG_CORE_SM) && hg_core_addr->core_addr.na_sm_addr != NULL) {
+        if (hg_core_addr->na_sm_addr_serialize_size == 0) {
+            /* Cache serialize size */
+            hg_core_addr->na_sm_addr_serialize_size =
+                NA_Addr_get_serialize_size(
+                    hg_core_addr->core_addr.core_class->na_sm_class,
+                    hg_core_addr->core_addr.na_sm_addr);
+        }
+
+        ret += hg_core_addr->na_sm_addr_serialize_size +
+               sizeof(hg_core_addr->host_id);
+    }
+#else
+    (void) flags;
+#endif
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_serialize(void *buf, hg_size_t buf_size, hg_uint8_t flags,
+    struct hg_core_private_addr *hg_core_addr)
+{
+    char *buf_ptr = (char *) buf;
+    hg_size_t buf_size_left = buf_size;
+    hg_return_t ret;
+
+    if (hg_core_addr->core_addr.na_addr != NULL) {
+        na_return_t na_ret;
+
+        HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
+            &hg_core_addr->na_addr_serialize_size, size_t);
+
+        na_ret = NA_Addr_serialize(hg_core_addr->core_addr.core_class->na_class,
+            buf_ptr, buf_size_left, hg_core_addr->core_addr.na_addr);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not serialize NA address (%s)",
+            NA_Error_to_string(na_ret));
+        buf_ptr += hg_core_addr->na_addr_serialize_size;
+        buf_size_left -= hg_core_addr->na_addr_serialize_size;
+    } else {
+        size_t na_sm_addr_serialize_size = 0;
+
+        /* Encode a 0 instead of flag */
+        HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
+            &na_sm_addr_serialize_size, size_t);
+    }
+
+#ifdef NA_HAS_SM
+    if ((flags & HG_CORE_SM) && hg_core_addr->core_addr.na_sm_addr != NULL) {
+        na_return_t na_ret;
+
+        HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
+            &hg_core_addr->na_sm_addr_serialize_size, size_t);
+
+        na_ret =
+            NA_Addr_serialize(hg_core_addr->core_addr.core_class->na_sm_class,
+                buf_ptr, buf_size_left, hg_core_addr->core_addr.na_sm_addr);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not serialize NA SM address (%s)",
+            NA_Error_to_string(na_ret));
+        /*
+        buf_ptr += hg_core_addr->na_sm_addr_serialize_size;
+        buf_size_left -= hg_core_addr->na_sm_addr_serialize_size;
+*/
+    } else {
+        size_t na_sm_addr_serialize_size = 0;
+
+        /* Encode a 0 instead of flag */
+        HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
+            &na_sm_addr_serialize_size, size_t);
+    }
+#else
+    (void) flags;
+#endif
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_deserialize(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr **hg_core_addr_p, const void *buf,
+    hg_size_t buf_size)
+{
+    struct hg_core_private_addr *hg_core_addr = NULL;
+    const char *buf_ptr = (const char *) buf;
+    hg_size_t buf_size_left = buf_size;
+    hg_bool_t is_self = HG_TRUE;
+    hg_return_t ret;
+
+    /* Create new address */
+    ret = hg_core_addr_create(hg_core_class, &hg_core_addr);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not create HG core addr");
+
+    HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
+        &hg_core_addr->na_addr_serialize_size, size_t);
+
+    if (hg_core_addr->na_addr_serialize_size != 0) {
+        na_return_t na_ret =
+            NA_Addr_deserialize(hg_core_class->core_class.na_class,
+                &hg_core_addr->core_addr.na_addr, buf_ptr, buf_size_left);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not deserialize NA address (%s)",
+            NA_Error_to_string(na_ret));
+        buf_ptr += hg_core_addr->na_addr_serialize_size;
+        buf_size_left -= hg_core_addr->na_addr_serialize_size;
+
+        is_self &=
+            (hg_bool_t) NA_Addr_is_self(hg_core_class->core_class.na_class,
+                hg_core_addr->core_addr.na_addr);
+    }
+
+#ifdef NA_HAS_SM
+    HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
+        &hg_core_addr->na_sm_addr_serialize_size, size_t);
+
+    if (hg_core_addr->na_sm_addr_serialize_size != 0) {
+        na_return_t na_ret =
+            NA_Addr_deserialize(hg_core_class->core_class.na_sm_class,
+                &hg_core_addr->core_addr.na_sm_addr, buf_ptr, buf_size_left);
+        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not deserialize NA SM address (%s)",
+            NA_Error_to_string(na_ret));
+        /*
+        buf_ptr += hg_core_addr->na_sm_addr_serialize_size;
+        buf_size_left -= hg_core_addr->na_sm_addr_serialize_size;
+        */
+        is_self &=
+            (hg_bool_t) NA_Addr_is_self(hg_core_class->core_class.na_class,
+                hg_core_addr->core_addr.na_addr);
+    }
+#endif
+    hg_core_addr->core_addr.is_self = is_self;
+
+    *hg_core_addr_p = hg_core_addr;
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_addr_free(hg_core_addr);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_size_t
+hg_core_addr_book_get_size(struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr *const *addrs, unsigned int count,
+    hg_uint8_t flags, struct hg_core_addr_book_hdr *hdr)
+{
+    const char *protocol =
+        NA_Get_class_protocol(hg_core_class->core_class.na_class);
+    hg_size_t na_size_sum = 0, na_sm_size_sum = 0;
+    hg_bool_t na_size_fixed = HG_TRUE, na_sm_size_fixed = HG_TRUE;
+    unsigned int i;
+
+    hdr->magic = HG_CORE_ADDR_BOOK_MAGIC;
+    hdr->version = HG_CORE_ADDR_BOOK_VERSION;
+    hdr->flags = 0;
+    hdr->proto_len = (hg_uint16_t) strlen(protocol);
+    hdr->count = (hg_uint32_t) count;
+    hdr->na_size = 0;
+    hdr->na_sm_size = 0;
+#ifdef NA_HAS_SM
+    if ((flags & HG_CORE_SM) && hg_core_class->core_class.na_sm_class != NULL)
+        hdr->flags |= HG_CORE_ADDR_BOOK_SM;
+#else
+    (void) flags;
+#endif
+
+    for (i = 0; i < count; i++) {
+        struct hg_core_private_addr *hg_core_addr = addrs[i];
+        size_t na_size = 0;
+
+        /* Serialize sizes are cached on the addr */
+        if (hg_core_addr->core_addr.na_addr != NULL) {
+            if (hg_core_addr->na_addr_serialize_size == 0)
+                hg_core_addr->na_addr_serialize_size =
+                    NA_Addr_get_serialize_size(
+                        hg_core_class->core_class.na_class,
+                        hg_core_addr->core_addr.na_addr);
+            na_size = hg_core_addr->na_addr_serialize_size;
+        }
+        if (i == 0)
+            hdr->na_size = (hg_uint32_t) na_size;
+        else if (hdr->na_size != (hg_uint32_t) na_size)
+            na_size_fixed = HG_FALSE;
+        na_size_sum += na_size;
+
+#ifdef NA_HAS_SM
+        if (hdr->flags & HG_CORE_ADDR_BOOK_SM) {
+            size_t na_sm_size = 0;
+
+            if (hg_core_addr->core_addr.na_sm_addr != NULL) {
+                if (hg_core_addr->na_sm_addr_serialize_size == 0)
+                    hg_core_addr->na_sm_addr_serialize_size =
+                        NA_Addr_get_serialize_size(
+                            hg_core_class->core_class.na_sm_class,
+                            hg_core_addr->core_addr.na_sm_addr);
+                na_sm_size = hg_core_addr->na_sm_addr_serialize_size;
+            }
+            if (i == 0)
+                hdr->na_sm_size = (hg_uint32_t) na_sm_size;
+            else if (hdr->na_sm_size != (hg_uint32_t) na_sm_size)
+                na_sm_size_fixed = HG_FALSE;
+            na_sm_size_sum += na_sm_size + sizeof(na_sm_id_t);
+        }
+#endif
+    }
+
+    /* Sizes are only encoded per entry when they differ between entries */
+    if (!na_size_fixed || hdr->na_size == 0) {
+        hdr->na_size = 0;
+        na_size_sum += count * sizeof(hg_uint32_t);
+    }
+    if ((hdr->flags & HG_CORE_ADDR_BOOK_SM) &&
+        (!na_sm_size_fixed || hdr->na_sm_size == 0)) {
+        hdr->na_sm_size = 0;
+        na_sm_size_sum += count * sizeof(hg_uint32_t);
+    }
+
+    return sizeof(*hdr) + hdr->proto_len + na_size_sum + na_sm_size_sum;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_book_serialize(void *buf, hg_size_t buf_size, hg_uint8_t flags,
+    struct hg_core_private_class *hg_core_class,
+    struct hg_core_private_addr *const *addrs, unsigned int count)
+{
+    struct hg_core_addr_book_hdr hdr;
+    char *buf_ptr = (char *) buf;
+    hg_size_t buf_size_left = buf_size, book_size;
+    unsigned int i;
+    hg_return_t ret;
+
+    /* Also fills header */
+    book_size =
+        hg_core_addr_book_get_size(hg_core_class, addrs, count, flags, &hdr);
+    HG_CHECK_SUBSYS_ERROR(addr, book_size > buf_size, error, ret, HG_OVERFLOW,
+        "Buffer size too small for addr book (%" PRIu64 " < %" PRIu64 ")",
+        buf_size, book_size);
+
+    HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left, &hdr,
+        struct hg_core_addr_book_hdr);
+    HG_CORE_TYPE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
+        NA_Get_class_protocol(hg_core_class->core_class.na_class),
+        (hg_size_t) hdr.proto_len);
+
+    for (i = 0; i < count; i++) {
+        struct hg_core_private_addr *hg_core_addr = addrs[i];
+        hg_uint32_t na_size = (hg_core_addr->core_addr.na_addr != NULL)
+                                  ? (hg_uint32_t)
+                                        hg_core_addr->na_addr_serialize_size
+                                  : 0;
+
+        if (hdr.na_size == 0)
+            HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left, &na_size,
+                hg_uint32_t);
+        if (na_size > 0) {
+            na_return_t na_ret =
+                NA_Addr_serialize(hg_core_class->core_class.na_class, buf_ptr,
+                    buf_size_left, hg_core_addr->core_addr.na_addr);
+            HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+                (hg_return_t) na_ret, "Could not serialize NA address (%s)",
+                NA_Error_to_string(na_ret));
+            buf_ptr += na_size;
+            buf_size_left -= na_size;
+        }
+
+#ifdef NA_HAS_SM
+        if (hdr.flags & HG_CORE_ADDR_BOOK_SM) {
+            hg_uint32_t na_sm_size =
+                (hg_core_addr->core_addr.na_sm_addr != NULL)
+                    ? (hg_uint32_t) hg_core_addr->na_sm_addr_serialize_size
+                    : 0;
+
+            HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
+                &hg_core_addr->host_id, na_sm_id_t);
+            if (hdr.na_sm_size == 0)
+                HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
+                    &na_sm_size, hg_uint32_t);
+            if (na_sm_size > 0) {
+                na_return_t na_ret = NA_Addr_serialize(
+                    hg_core_class->core_class.na_sm_class, buf_ptr,
+                    buf_size_left, hg_core_addr->core_addr.na_sm_addr);
+                HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+                    (hg_return_t) na_ret,
+                    "Could not serialize NA SM address (%s)",
+                    NA_Error_to_string(na_ret));
+                buf_ptr += na_sm_size;
+                buf_size_left -= na_sm_size;
+            }
+        }
+#endif
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_book_decode_hdr(struct hg_core_private_class *hg_core_class,
+    const char **buf_ptr_p, hg_size_t *buf_size_left_p,
+    struct hg_core_addr_book_hdr *hdr)
+{
+    const char *protocol =
+        NA_Get_class_protocol(hg_core_class->core_class.na_class);
+    const char *buf_ptr = *buf_ptr_p;
+    hg_size_t buf_size_left = *buf_size_left_p;
+    hg_return_t ret;
+
+    HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left, hdr,
+        struct hg_core_addr_book_hdr);
+    HG_CHECK_SUBSYS_ERROR(addr, hdr->magic != HG_CORE_ADDR_BOOK_MAGIC, error,
+        ret, HG_PROTOCOL_ERROR, "Not an addr book (magic 0x%" PRIx32 ")",
+        hdr->magic);
+    HG_CHECK_SUBSYS_ERROR(addr, hdr->version != HG_CORE_ADDR_BOOK_VERSION,
+        error, ret, HG_PROTONOSUPPORT, "Unsupported addr book version (%u)",
+        (unsigned int) hdr->version);
+
+    /* Protocol is stored once for all entries */
+    HG_CHECK_SUBSYS_ERROR(addr, buf_size_left < hdr->proto_len, error, ret,
+        HG_OVERFLOW, "Buffer size too small (%" PRIu64 ")", buf_size_left);
+    HG_CHECK_SUBSYS_ERROR(addr,
+        strlen(protocol) != hdr->proto_len ||
+            strncmp(protocol, buf_ptr, hdr->proto_len) != 0,
+        error, ret, HG_PROTONOSUPPORT,
+        "Addr book protocol (%.*s) does not match class protocol (%s)",
+        (int) hdr->proto_len, buf_ptr, protocol);
+    buf_ptr += hdr->proto_len;
+    buf_size_left -= hdr->proto_len;
+
+    *buf_ptr_p = buf_ptr;
+    *buf_size_left_p = buf_size_left;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_book_count(struct hg_core_private_class *hg_core_class,
+    const void *buf, hg_size_t buf_size, unsigned int *count_p)
+{
+    const char *buf_ptr = (const char *) buf;
+    hg_size_t buf_size_left = buf_size;
+    unsigned int count = 0;
+    hg_return_t ret;
+
+    while (buf_size_left > 0) {
+        struct hg_core_addr_book_hdr hdr;
+        hg_uint32_t i;
+
+        ret = hg_core_addr_book_decode_hdr(
+            hg_core_class, &buf_ptr, &buf_size_left, &hdr);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            addr, error, ret, "Could not decode addr book header");
+
+        /* Skip entries */
+        for (i = 0; i < hdr.count; i++) {
+            hg_uint32_t na_size = hdr.na_size;
+
+            if (na_size == 0)
+                HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
+                    &na_size, hg_uint32_t);
+            HG_CHECK_SUBSYS_ERROR(addr, buf_size_left < na_size, error, ret,
+                HG_OVERFLOW, "Buffer size too small (%" PRIu64 ")",
+                buf_size_left);
+            buf_ptr += na_size;
+            buf_size_left -= na_size;
+
+            if (hdr.flags & HG_CORE_ADDR_BOOK_SM) {
+#ifdef NA_HAS_SM
+                hg_uint32_t na_sm_size = hdr.na_sm_size;
+                na_sm_id_t host_id;
+
+                HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
+                    &host_id, na_sm_id_t);
+                if (na_sm_size == 0)
+                    HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
+                        &na_sm_size, hg_uint32_t);
+                HG_CHECK_SUBSYS_ERROR(addr, buf_size_left < na_sm_size, error,
+                    ret, HG_OVERFLOW, "Buffer size too small (%" PRIu64 ")",
+                    buf_size_left);
+                buf_ptr += na_sm_size;
+                buf_size_left -= na_sm_size;
+#else
+                HG_GOTO_SUBSYS_ERROR(addr, error, ret, HG_PROTONOSUPPORT,
+                    "Addr book contains SM addrs but SM is not supported");
+#endif
+            }
+        }
+        count += hdr.count;
+    }
+
+    *count_p = count;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_book_deserialize(struct hg_core_private_class *hg_core_class,
+    const void *buf, hg_size_t buf_size, struct hg_core_private_addr **addrs,
+    unsigned int count)
+{
+    const char *buf_ptr = (const char *) buf;
+    hg_size_t buf_size_left = buf_size;
+    unsigned int n = 0;
+    hg_return_t ret;
+
+    /* Books can be concatenated (e.g., gathered from all peers) */
+    while (buf_size_left > 0) {
+        struct hg_core_addr_book_hdr hdr;
+        hg_uint32_t i;
+
+        ret = hg_core_addr_book_decode_hdr(
+            hg_core_class, &buf_ptr, &buf_size_left, &hdr);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            addr, error, ret, "Could not decode addr book header");
+
+        for (i = 0; i < hdr.count; i++, n++) {
+            struct hg_core_private_addr *hg_core_addr;
+            hg_uint32_t na_size = hdr.na_size;
+            hg_bool_t is_self = HG_TRUE;
+
+            ret = hg_core_addr_create(hg_core_class, &addrs[n]);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                addr, error, ret, "Could not create HG core addr");
+            hg_core_addr = addrs[n];
+
+            if (na_size == 0)
+                HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
+                    &na_size, hg_uint32_t);
+            if (na_size > 0) {
+                na_return_t na_ret;
+
+                HG_CHECK_SUBSYS_ERROR(addr, buf_size_left < na_size, error,
+                    ret, HG_OVERFLOW, "Buffer size too small (%" PRIu64 ")",
+                    buf_size_left);
+                na_ret = NA_Addr_deserialize(hg_core_class->core_class.na_class,
+                    &hg_core_addr->core_addr.na_addr, buf_ptr, na_size);
+                HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
+                    (hg_return_t) na_ret,
+                    "Could not deserialize NA address (%s)",
+                    NA_Error_to_string(na_ret));
+                hg_core_addr->na_addr_serialize_size = na_size;
+                buf_ptr += na_size;
+                buf_size_left -= na_size;
+
+                is_self &= (hg_bool_t) NA_Addr_is_self(
+                    hg_core_class->core_class.na_class,
+                    hg_core_addr->core_addr.na_addr);
+            }
+
+#ifdef NA_HAS_SM
+            if (hdr.flags & HG_CORE_ADDR_BOOK_SM) {
+                hg_uint32_t na_sm_size = hdr.na_sm_size;
+
+                HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
+                    &hg_core_addr->host_id, na_sm_id_t);
+                if (na_sm_size == 0)
+                    HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
+                        &na_sm_size, hg_uint32_t);
+                HG_CHECK_SUBSYS_ERROR(addr, buf_size_left < na_sm_size, error,
+                    ret, HG_OVERFLOW, "Buffer size too small (%" PRIu64 ")",
+                    buf_size_left);
+
+                /* Only resolve SM addrs of peers that are on the same host */
+                if (na_sm_size > 0 &&
+                    hg_core_class->core_class.na_sm_class != NULL &&
+                    NA_SM_Host_id_cmp(
+                        hg_core_addr->host_id, hg_core_class->host_id)) {
+                    na_return_t na_ret = NA_Addr_deserialize(
+                        hg_core_class->core_class.na_sm_class,
+                        &hg_core_addr->core_addr.na_sm_addr, buf_ptr,
+                        na_sm_size);
+                    HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error,
+                        ret, (hg_return_t) na_ret,
+                        "Could not deserialize NA SM address (%s)",
+                        NA_Error_to_string(na_ret));
+                    hg_core_addr->na_sm_addr_serialize_size = na_sm_size;
+                }
+                buf_ptr += na_sm_size;
+                buf_size_left -= na_sm_size;
+            }
+#endif
+            hg_core_addr->core_addr.is_self = is_self;
+        }
+    }
+
+    return HG_SUCCESS;
+
+error:
+    for (n = 0; n < count; n++) {
+        hg_core_addr_free(addrs[n]);
+        addrs[n] = NULL;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_resolve_na(struct hg_core_private_context *context,
+    struct hg_core_private_addr *hg_core_addr, na_class_t **na_class_p,
+    na_context_t **na_context_p, na_addr_t **na_addr_p)
+{
+    hg_return_t ret;
+
+    /* Determine which NA class/context to use */
+    if (hg_core_addr != NULL) {
+        HG_CHECK_SUBSYS_ERROR(addr,
+            hg_core_addr->core_addr.core_class !=
+                context->core_context.core_class,
+            error, ret, HG_INVALID_ARG,
+            "Address and context passed belong to different classes");
+
+#ifdef NA_HAS_SM
+        if (!hg_core_addr->core_addr.is_self &&
+            (hg_core_addr->core_addr.na_sm_addr != NULL)) {
+            HG_LOG_SUBSYS_DEBUG(rpc, "Using NA SM class");
+            *na_class_p = context->core_context.core_class->na_sm_class;
+            *na_context_p = context->core_context.na_sm_context;
+            *na_addr_p = hg_core_addr->core_addr.na_sm_addr;
+        } else {
+#endif
+            /* Default */
+            HG_LOG_SUBSYS_DEBUG(rpc, "Using default NA class");
+            *na_class_p = context->core_context.core_class->na_class;
+            *na_context_p = context->core_context.na_context;
+            *na_addr_p = hg_core_addr->core_addr.na_addr;
+#ifdef NA_HAS_SM
+        }
+#endif
+    } else {
+        /* Default */
+        HG_LOG_SUBSYS_DEBUG(rpc, "Using default NA class");
+        *na_class_p = context->core_context.core_class->na_class;
+        *na_context_p = context->core_context.na_context;
+        *na_addr_p = NULL;
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_create(struct hg_core_private_context *context, na_class_t *na_class,
+    na_context_t *na_context, unsigned long flags,
+    struct hg_core_private_handle **hg_core_handle_p)
+{
+    struct hg_core_private_handle *hg_core_handle = NULL;
+    hg_return_t ret;
+
+    /* Allocate new handle */
+    ret = hg_core_alloc(context, flags & HG_CORE_HANDLE_USER, &hg_core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not allocate handle");
+
+    /* Alloc/init NA resources */
+    ret = hg_core_alloc_na(hg_core_handle, na_class, na_context, flags);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not allocate NA handle resources");
+
+    /* Execute class callback on handle, this allows upper layers to
+     * allocate private data on handle creation */
+    if (context->handle_create_cb.callback) {
+        ret = context->handle_create_cb.callback(
+            (hg_core_handle_t) hg_core_handle, context->handle_create_cb.arg);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Error in HG handle create callback");
+    }
+
+    HG_LOG_SUBSYS_DEBUG(
+        rpc, "Created new handle (%p)", (void *) hg_core_handle);
+
+    *hg_core_handle_p = hg_core_handle;
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_destroy(hg_core_handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int32_t
+hg_core_handle_ref_incr(struct hg_core_private_handle *hg_core_handle)
+{
+    int32_t ref_count;
+
+    if (!HG_CORE_HANDLE_CLASS(hg_core_handle)->init_info.single_thread)
+        return hg_atomic_incr32(&hg_core_handle->ref_count);
+
+    ref_count = hg_atomic_get32(&hg_core_handle->ref_count) + 1;
+    hg_atomic_set32(&hg_core_handle->ref_count, ref_count);
+
+    return ref_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int32_t
+hg_core_handle_ref_decr(struct hg_core_private_handle *hg_core_handle)
+{
+    int32_t ref_count;
+
+    if (!HG_CORE_HANDLE_CLASS(hg_core_handle)->init_info.single_thread)
+        return hg_atomic_decr32(&hg_core_handle->ref_count);
+
+    ref_count = hg_atomic_get32(&hg_core_handle->ref_count) - 1;
+    hg_atomic_set32(&hg_core_handle->ref_count, ref_count);
+
+    return ref_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_destroy(struct hg_core_private_handle *hg_core_handle)
+{
+    int32_t ref_count;
+    hg_return_t ret;
+
+    if (hg_core_handle == NULL)
+        return HG_SUCCESS;
+
+    /* This will push the RPC handle back to completion queue when no
+     * response is sent and we are sending to ourselves. This ensures that
+     * there is no race between the callback execution and the RPC
+     * completion. */
+    if (hg_core_handle->is_self && hg_core_handle->no_response &&
+        hg_atomic_get32(&hg_core_handle->no_response_done) > 0 &&
+        hg_atomic_cas32(&hg_core_handle->no_response_done,
+            hg_atomic_get32(&hg_core_handle->ref_count), 0)) {
+        /* Safe as the decremented refcount will always be > 0 */
+        ref_count = hg_core_handle_ref_decr(hg_core_handle);
+        HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count decr to %" PRId32,
+            (void *) hg_core_handle, ref_count);
+
+        ret = hg_core_handle->ops.no_respond(hg_core_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not complete handle");
+
+        return HG_SUCCESS;
+    }
+
+    /* Standard destroy refcount decrement */
+    ref_count = hg_core_handle_ref_decr(hg_core_handle);
+    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count decr to %" PRId32,
+        (void *) hg_core_handle, ref_count);
+
+    if (ref_count > 0)
+        return HG_SUCCESS; /* Cannot free yet */
+
+    /* Re-use handle if we were listening, otherwise destroy it */
+    if (hg_core_handle->reuse &&
+        !hg_atomic_get32(&HG_CORE_HANDLE_CONTEXT(hg_core_handle)->unposting)) {
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "Re-using handle (%p)", (void *) hg_core_handle);
+
+        /* Repost handle */
+        ret = hg_core_reset_post(hg_core_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Cannot re-use handle (%p)",
+            (void *) hg_core_handle);
+
+        /* TODO handle error */
+    } else {
+        struct hg_core_private_class *hg_core_class =
+            HG_CORE_HANDLE_CLASS(hg_core_handle);
+
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "Freeing handle (%p)", (void *) hg_core_handle);
+
+        /* Free extra data here if needed */
+        if (hg_core_class->more_data_cb.release)
+            hg_core_class->more_data_cb.release(
+                (hg_core_handle_t) hg_core_handle);
+
+        /* Free user data */
+        if (hg_core_handle->core_handle.data_free_callback)
+            hg_core_handle->core_handle.data_free_callback(
+                hg_core_handle->core_handle.data);
+
+        /* Free NA resources */
+        if (hg_core_handle->na_class)
+            hg_core_free_na(hg_core_handle);
+
+        /* Free handle */
+        hg_core_free(hg_core_handle);
+    }
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_alloc(struct hg_core_private_context *context, hg_bool_t user,
+    struct hg_core_private_handle **hg_core_handle_p)
+{
+    hg_checksum_level_t checksum_level =
+        HG_CORE_CONTEXT_CLASS(context)->init_info.checksum_level;
+    struct hg_core_private_handle *hg_core_handle = NULL;
+    hg_return_t ret;
+
+    hg_core_handle =
+        (struct hg_core_private_handle *) calloc(1, sizeof(*hg_core_handle));
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle == NULL, error, ret, HG_NOMEM,
+        "Could not allocate handle");
+
+    hg_core_handle->op_type = HG_CORE_PROCESS; /* Default */
+    hg_core_handle->core_handle.info.core_class =
+        context->core_context.core_class;
+    hg_core_handle->core_handle.info.context = &context->core_context;
+    hg_core_handle->core_handle.info.addr = HG_CORE_ADDR_NULL;
+
+    /* Default ops */
+    hg_core_handle->ops = hg_core_ops_na_g;
+
+    /* Default return code */
+    hg_core_handle->ret = HG_SUCCESS;
+
+    /* Add handle to handle list so that we can track it */
+    hg_core_handle->acquire_start = hg_time_get_cycles();
+    hg_core_handle->created_list =
+        (user) ? &context->user_list : &context->internal_list;
+    hg_core_handle_list_lock(hg_core_handle->created_list);
+    HG_LIST_INSERT_HEAD(
+        &hg_core_handle->created_list->list, hg_core_handle, created);
+    hg_core_handle_list_unlock(hg_core_handle->created_list);
+
+    /* Completed by default */
+    hg_atomic_init32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+    hg_atomic_init32(
+        &hg_core_handle->ret_status, (int32_t) hg_core_handle->ret);
+
+    /* Init in/out header */
+    hg_core_header_request_init(
+        &hg_core_handle->in_header, checksum_level > HG_CHECKSUM_NONE);
+    hg_core_header_response_init(
+        &hg_core_handle->out_header, checksum_level > HG_CHECKSUM_NONE);
+
+    /* Set refcount to 1 */
+    hg_atomic_init32(&hg_core_handle->ref_count, 1);
+    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count set to %" PRId32,
+        (void *) hg_core_handle, 1);
+
+    /* Increment N handles from HG context */
+    hg_atomic_incr32(&context->n_handles);
+
+    *hg_core_handle_p = hg_core_handle;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_free(struct hg_core_private_handle *hg_core_handle)
+{
+    /* Remove reference to HG addr */
+    if (hg_core_handle->core_handle.info.addr != HG_CORE_ADDR_NULL)
+        hg_core_addr_ref_put(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+            (struct hg_core_private_addr *)
+                hg_core_handle->core_handle.info.addr,
+            hg_core_handle->addr_ref_cached);
+
+    /* Remove handle from list */
+    hg_core_handle_list_lock(hg_core_handle->created_list);
+    HG_LIST_REMOVE(hg_core_handle, created);
+    hg_core_handle_list_unlock(hg_core_handle->created_list);
+
+    hg_core_header_request_finalize(&hg_core_handle->in_header);
+    hg_core_header_response_finalize(&hg_core_handle->out_header);
+
+    /* Decrement N handles from HG context */
+    hg_atomic_decr32(&HG_CORE_HANDLE_CONTEXT(hg_core_handle)->n_handles);
+
+    free(hg_core_handle);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_alloc_na(struct hg_core_private_handle *hg_core_handle,
+    na_class_t *na_class, na_context_t *na_context, unsigned long flags)
+{
+    hg_return_t ret;
+    na_return_t na_ret;
+
+    /* Set NA class / context */
+    hg_core_handle->na_class = na_class;
+    hg_core_handle->na_context = na_context;
+
+    /* When using multi-recv, only allocate resources per handle for expected
+     * messages. */
+    if (flags & HG_CORE_HANDLE_MULTI_RECV) {
+        hg_core_handle->core_handle.in_buf = NULL;
+        hg_core_handle->core_handle.in_buf_size = 0;
+    } else {
+        /* Initialize in/out buffers and use unexpected message size */
+        hg_core_handle->core_handle.in_buf_size =
+            NA_Msg_get_max_unexpected_size(na_class);
+
+        hg_core_handle->core_handle.in_buf =
+            NA_Msg_buf_alloc(na_class, hg_core_handle->core_handle.in_buf_size,
+                (flags & HG_CORE_HANDLE_LISTEN) ? NA_RECV : NA_SEND,
+                &hg_core_handle->in_buf_plugin_data);
+        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->core_handle.in_buf == NULL,
+            error, ret, HG_NOMEM, "Could not allocate buffer for input");
+
+        na_ret =
+            NA_Msg_init_unexpected(na_class, hg_core_handle->core_handle.in_buf,
+                hg_core_handle->core_handle.in_buf_size);
+        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not initialize input buffer (%s)",
+            NA_Error_to_string(na_ret));
+
+        hg_core_handle->na_recv_op_id = NA_Op_create(na_class, NA_OP_SINGLE);
+        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->na_recv_op_id == NULL, error,
+            ret, HG_NA_ERROR, "Could not create NA op ID");
+    }
+
+    hg_core_handle->core_handle.out_buf_size =
+        NA_Msg_get_max_expected_size(na_class);
+
+    hg_core_handle->core_handle.na_in_header_offset =
+        NA_Msg_get_unexpected_header_size(na_class);
+    hg_core_handle->core_handle.na_out_header_offset =
+        NA_Msg_get_expected_header_size(na_class);
+
+    /* Posted handles may serve RPCs that never respond, defer allocation of
+     * their output buffer until a response is sent */
+    if (!(flags & HG_CORE_HANDLE_LISTEN)) {
+        ret = hg_core_alloc_output(hg_core_handle, NA_RECV);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate output buffer");
+    }
+
+    /* Create NA operation IDs */
+    hg_core_handle->na_send_op_id = NA_Op_create(na_class, NA_OP_SINGLE);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->na_send_op_id == NULL, error,
+        ret, HG_NA_ERROR, "Could not create NA op ID");
+
+    hg_atomic_init32(
+        &hg_core_handle->op_expected_count, 1); /* Default (no response) */
+    hg_atomic_init32(&hg_core_handle->op_completed_count, 0);
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_free_na(hg_core_handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_free_na(struct hg_core_private_handle *hg_core_handle)
+{
+    /* Destroy NA op IDs */
+    NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_send_op_id);
+    hg_core_handle->na_send_op_id = NULL;
+
+    NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_recv_op_id);
+    hg_core_handle->na_recv_op_id = NULL;
+
+    /* Free buffers */
+    if (hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_MULTI_RECV) {
+        if (hg_core_handle->multi_recv_op != NULL) {
+            hg_atomic_decr32(&hg_core_handle->multi_recv_op->ref_count);
+            hg_core_handle->multi_recv_op = NULL;
+        }
+    } else {
+        NA_Msg_buf_free(hg_core_handle->na_class,
+            hg_core_handle->core_handle.in_buf,
+            hg_core_handle->in_buf_plugin_data);
+    }
+    hg_core_handle->core_handle.in_buf = NULL;
+    hg_core_handle->in_buf_plugin_data = NULL;
+
+    if (hg_core_handle->core_handle.out_buf != NULL) {
+        NA_Msg_buf_free(hg_core_handle->na_class,
+            hg_core_handle->core_handle.out_buf,
+            hg_core_handle->out_buf_plugin_data);
+        hg_core_handle->core_handle.out_buf = NULL;
+        hg_core_handle->out_buf_plugin_data = NULL;
+    }
+
+    hg_core_free_ack(hg_core_handle);
+    hg_core_free_stream(hg_core_handle);
+
+    hg_core_handle->na_class = NULL;
+    hg_core_handle->na_context = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_alloc_output(
+    struct hg_core_private_handle *hg_core_handle, unsigned long flags)
+{
+    na_class_t *na_class = hg_core_handle->na_class;
+    hg_return_t ret;
+    na_return_t na_ret;
+
+    hg_core_handle->core_handle.out_buf =
+        NA_Msg_buf_alloc(na_class, hg_core_handle->core_handle.out_buf_size,
+            flags, &hg_core_handle->out_buf_plugin_data);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->core_handle.out_buf == NULL,
+        error, ret, HG_NOMEM, "Could not allocate buffer for output");
+
+    na_ret = NA_Msg_init_expected(na_class, hg_core_handle->core_handle.out_buf,
+        hg_core_handle->core_handle.out_buf_size);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error_free, ret,
+        (hg_return_t) na_ret, "Could not initialize output buffer (%s)",
+        NA_Error_to_string(na_ret));
+
+    return HG_SUCCESS;
+
+error_free:
+    NA_Msg_buf_free(na_class, hg_core_handle->core_handle.out_buf,
+        hg_core_handle->out_buf_plugin_data);
+    hg_core_handle->core_handle.out_buf = NULL;
+    hg_core_handle->out_buf_plugin_data = NULL;
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_alloc_ack(
+    struct hg_core_private_handle *hg_core_handle, unsigned long flags)
+{
+    size_t buf_size =
+        hg_core_handle->core_handle.na_out_header_offset + sizeof(hg_uint8_t);
+    hg_return_t ret;
+
+    HG_LOG_SUBSYS_WARNING(perf,
+        "Allocating %zu byte(s) to ack extra data for handle %p", buf_size,
+        (void *) hg_core_handle);
+
+    ret = hg_core_ack_create(
+        hg_core_handle->na_class, buf_size, flags, &hg_core_handle->ack);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not create ack resources");
+    hg_core_handle->ack->handle = hg_core_handle;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_free_ack(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_core_ack_destroy(hg_core_handle->na_class, hg_core_handle->ack);
+    hg_core_handle->ack = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_ack_create(na_class_t *na_class, size_t buf_size, unsigned long flags,
+    struct hg_core_ack **ack_p)
+{
+    struct hg_core_ack *ack;
+    hg_return_t ret;
+    na_return_t na_ret;
+
+    ack = (struct hg_core_ack *) calloc(1, sizeof(*ack));
+    HG_CHECK_SUBSYS_ERROR(rpc, ack == NULL, error, ret, HG_NOMEM,
+        "Could not allocate ack resources");
+
+    ack->buf =
+        NA_Msg_buf_alloc(na_class, buf_size, flags, &ack->buf_plugin_data);
+    HG_CHECK_SUBSYS_ERROR(rpc, ack->buf == NULL, error, ret, HG_NOMEM,
+        "Could not allocate buffer for ack");
+
+    na_ret = NA_Msg_init_expected(na_class, ack->buf, buf_size);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not initialize ack buffer (%s)",
+        NA_Error_to_string(na_ret));
+
+    ack->na_op_id = NA_Op_create(na_class, NA_OP_SINGLE);
+    HG_CHECK_SUBSYS_ERROR(rpc, ack->na_op_id == NULL, error, ret, HG_NA_ERROR,
+        "Could not create NA op ID");
+
+    *ack_p = ack;
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_ack_destroy(na_class, ack);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_ack_destroy(na_class_t *na_class, struct hg_core_ack *ack)
+{
+    if (ack == NULL)
+        return;
+
+    NA_Op_destroy(na_class, ack->na_op_id);
+    if (ack->buf != NULL)
+        NA_Msg_buf_free(na_class, ack->buf, ack->buf_plugin_data);
+    free(ack);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_alloc_stream(
+    struct hg_core_private_handle *hg_core_handle, unsigned int count)
+{
+    na_class_t *na_class = hg_core_handle->na_class;
+    size_t slot_size =
+        hg_core_handle->core_handle.na_out_header_offset + sizeof(hg_uint8_t);
+    struct hg_core_stream *stream;
+    unsigned int i;
+    hg_return_t ret;
+
+    stream = (struct hg_core_stream *) calloc(1, sizeof(*stream));
+    HG_CHECK_SUBSYS_ERROR(rpc, stream == NULL, error, ret, HG_NOMEM,
+        "Could not allocate stream resources");
+    hg_thread_spin_init(&stream->lock);
+    HG_QUEUE_INIT(&stream->received);
+    stream->na_class = na_class;
+    stream->hg_completion_entry.op_type = HG_STREAM;
+    stream->hg_completion_entry.op_id.hg_core_handle =
+        (hg_core_handle_t) hg_core_handle;
+    hg_core_handle->stream = stream;
+
+    if (count > 0) {
+        /* Origin receives each response in its own chunk and sends credits */
+        stream->chunks = (struct hg_core_stream_chunk *) calloc(
+            count, sizeof(*stream->chunks));
+        HG_CHECK_SUBSYS_ERROR(rpc, stream->chunks == NULL, error, ret,
+            HG_NOMEM, "Could not allocate stream chunks");
+        stream->count = count;
+
+        for (i = 0; i < count; i++) {
+            struct hg_core_stream_chunk *chunk = &stream->chunks[i];
+            na_return_t na_ret;
+
+            chunk->handle = hg_core_handle;
+            chunk->buf = NA_Msg_buf_alloc(na_class,
+                hg_core_handle->core_handle.out_buf_size, NA_RECV,
+                &chunk->buf_plugin_data);
+            HG_CHECK_SUBSYS_ERROR(rpc, chunk->buf == NULL, error, ret,
+                HG_NOMEM, "Could not allocate buffer for stream chunk");
+
+            na_ret = NA_Msg_init_expected(
+                na_class, chunk->buf, hg_core_handle->core_handle.out_buf_size);
+            HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+                (hg_return_t) na_ret,
+                "Could not initialize stream chunk buffer (%s)",
+                NA_Error_to_string(na_ret));
+
+            chunk->na_op_id = NA_Op_create(na_class, NA_OP_SINGLE);
+            HG_CHECK_SUBSYS_ERROR(rpc, chunk->na_op_id == NULL, error, ret,
+                HG_NA_ERROR, "Could not create NA op ID");
+        }
+
+        ret = hg_core_ack_create(
+            na_class, slot_size, NA_SEND, &stream->slots[0]);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not create credit msg resources");
+        stream->slots[0]->handle = hg_core_handle;
+    } else {
+        /* Target receives credits, at most two credit msgs are in flight */
+        for (i = 0; i < HG_CORE_STREAM_CREDIT_SLOTS; i++) {
+            ret = hg_core_ack_create(
+                na_class, slot_size, NA_RECV, &stream->slots[i]);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                rpc, error, ret, "Could not create credit msg resources");
+            stream->slots[i]->handle = hg_core_handle;
+        }
+    }
+
+    return HG_SUCCESS;
+
+error:
+    hg_core_free_stream(hg_core_handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_free_stream(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    unsigned int i;
 
-    /* Create new HG class */
-    hg_core_class =
-        (struct hg_core_private_class *) calloc(1, sizeof(*hg_core_class));
-    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error_free, ret, HG_NOMEM,
-        "Could not allocate HG class");
+    if (stream == NULL)
+        return;
 
-    hg_atomic_init32(&hg_core_class->request_tag, 0);
-    hg_atomic_init32(&hg_core_class->n_contexts, 0);
-    hg_atomic_init32(&hg_core_class->n_addrs, 0);
-    hg_atomic_init32(&hg_core_class->n_bulks, 0);
+    if (stream->chunks != NULL) {
+        for (i = 0; i < stream->count; i++) {
+            NA_Op_destroy(stream->na_class, stream->chunks[i].na_op_id);
+            if (stream->chunks[i].buf != NULL)
+                NA_Msg_buf_free(stream->na_class, stream->chunks[i].buf,
+                    stream->chunks[i].buf_plugin_data);
+        }
+        free(stream->chunks);
+    }
+    for (i = 0; i < HG_CORE_STREAM_CREDIT_SLOTS; i++)
+        hg_core_ack_destroy(stream->na_class, stream->slots[i]);
 
-    /* Initialize mutex */
-    rc = hg_thread_rwlock_init(&hg_core_class->rpc_map.lock);
-    HG_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error_free, ret, HG_NOMEM,
-        "hg_thread_rwlock_init() failed");
+    (void) hg_thread_spin_destroy(&stream->lock);
+    free(stream);
+    hg_core_handle->stream = NULL;
+}
 
-    /* Create new function map */
-    hg_core_class->rpc_map.map =
-        hg_hash_table_new(hg_core_map_hash, hg_core_map_equal);
-    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class->rpc_map.map == NULL, error, ret,
-        HG_NOMEM, "Could not create RPC map");
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_reset(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
 
-    /* Automatically free all the values with the hash map */
-    hg_hash_table_register_free_functions(
-        hg_core_class->rpc_map.map, NULL, hg_core_map_value_free);
+    /* TODO context ID must always be reset as it is not passed along with
+     * the addr */
+    hg_core_handle->core_handle.info.context_id = 0;
 
-    /* Ensure init info is API compatible */
-    if (hg_init_info_p) {
-        HG_CHECK_SUBSYS_ERROR(cls, version == 0, error, ret, HG_INVALID_ARG,
-            "API version cannot be 0");
-        HG_LOG_SUBSYS_DEBUG(cls, "Init info version used: v%d.%d",
-            HG_MAJOR(version), HG_MINOR(version));
+    hg_core_handle->request_callback = NULL;
+    hg_core_handle->request_arg = NULL;
+    hg_core_handle->response_callback = NULL;
+    hg_core_handle->response_arg = NULL;
+    hg_core_handle->op_type = HG_CORE_PROCESS; /* Default */
+    hg_core_handle->tag = 0;
+    hg_core_handle->cookie = 0;
+    hg_core_handle->stream_credits = 0;
+    hg_core_handle->stream_callback = NULL;
+    hg_core_handle->stream_arg = NULL;
+    hg_core_handle->ret = HG_SUCCESS;
+    hg_core_handle->in_buf_used = 0;
+    hg_core_handle->out_buf_used = 0;
+    hg_core_handle->forward_start = 0;
+    hg_core_handle->handler_start = 0;
+    hg_atomic_init32(
+        &hg_core_handle->op_expected_count, 1); /* Default (no response) */
+    hg_atomic_init32(&hg_core_handle->op_completed_count, 0);
+    hg_core_handle->no_response = HG_FALSE;
+    hg_core_handle->unexpected_response = HG_FALSE;
+    hg_core_handle->trace_context_set = HG_FALSE;
+    hg_core_handle->timeout_ms = 0;
+    hg_core_handle->persistent = HG_FALSE;
+    hg_core_handle->in_header_encoded = HG_FALSE;
 
-        /* Get init info and overwrite defaults */
-        if (HG_VERSION_GE(version, HG_VERSION(2, 3)))
-            hg_init_info = *hg_init_info_p;
-        else
-            hg_init_info_dup_2_2(&hg_init_info,
-                (const struct hg_init_info_2_2 *) hg_init_info_p);
+    /* Free extra data here if needed */
+    if (hg_core_class->more_data_cb.release)
+        hg_core_class->more_data_cb.release((hg_core_handle_t) hg_core_handle);
+
+    hg_core_header_request_reset(&hg_core_handle->in_header);
+    hg_core_header_response_reset(&hg_core_handle->out_header);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_reset_post(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_handle_pool *hg_core_handle_pool;
+    bool use_multi_recv =
+        hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_MULTI_RECV;
+    struct hg_core_multi_recv_op *multi_recv_op = hg_core_handle->multi_recv_op;
+    hg_return_t ret;
+
+    /* Reset handle info */
+    if (hg_core_handle->core_handle.info.addr != HG_CORE_ADDR_NULL) {
+        hg_core_addr_free_na((struct hg_core_private_addr *)
+                                 hg_core_handle->core_handle.info.addr);
     }
+    hg_core_handle->core_handle.info.id = 0;
 
-    /* request_post_incr is used only if request_post_init is non-zero */
-    if (hg_init_info.request_post_init == 0) {
-        hg_core_class->init_info.request_post_init = HG_CORE_POST_INIT;
-        hg_core_class->init_info.request_post_incr = HG_CORE_POST_INCR;
-    } else {
-        hg_core_class->init_info.request_post_init =
-            hg_init_info.request_post_init;
-        hg_core_class->init_info.request_post_incr =
-            hg_init_info.request_post_incr;
+    /* Reset the handle */
+    hg_core_reset(hg_core_handle);
+
+    /* Also reset additional handle parameters */
+    hg_atomic_set32(&hg_core_handle->ref_count, 1);
+    hg_core_handle->core_handle.rpc_info = NULL;
+    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count set to %" PRId32,
+        (void *) hg_core_handle, 1);
+
+    /* Reset status */
+    hg_atomic_set32(&hg_core_handle->status, 0);
+    hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) hg_core_handle->ret);
+
+    /* Multi-recv buffers */
+    if (use_multi_recv && multi_recv_op != NULL) {
+        hg_core_handle->core_handle.in_buf = NULL;
+        hg_core_handle->core_handle.in_buf_size = 0;
+        hg_core_handle->multi_recv_op = NULL;
     }
 
-    /* Save checksum level */
-#ifdef HG_HAS_CHECKSUMS
-    hg_core_class->init_info.checksum_level = hg_init_info.checksum_level;
+#ifdef NA_HAS_SM
+    hg_core_handle_pool = (hg_core_handle->na_class ==
+                              context->core_context.core_class->na_sm_class)
+                              ? context->sm_handle_pool
+                              : context->handle_pool;
 #else
-    HG_CHECK_SUBSYS_WARNING(cls,
-        hg_init_info.checksum_level != HG_CHECKSUM_NONE,
-        "Option checksum_level requires CMake option MERCURY_USE_CHECKSUMS "
-        "to be turned ON.");
-    hg_core_class->init_info.checksum_level = HG_CHECKSUM_NONE;
+    hg_core_handle_pool = context->handle_pool;
 #endif
 
-    /* Save progress mode */
-    hg_core_class->init_info.progress_mode =
-        hg_init_info.na_init_info.progress_mode;
+    /* Add handle back to pending list */
+    hg_core_handle_pool_put(hg_core_handle_pool, hg_core_handle);
 
-    /* Loopback capability */
-    hg_core_class->init_info.loopback = !hg_init_info.no_loopback;
+    if (use_multi_recv) {
+        if (multi_recv_op != NULL &&
+            hg_atomic_decr32(&multi_recv_op->ref_count) == 0 &&
+            hg_atomic_get32(&multi_recv_op->last)) {
+            ret = hg_core_repost_multi(
+                context, hg_core_handle_pool, multi_recv_op);
+            HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+                "Cannot repost multi-recv operation (%d)", multi_recv_op->id);
+        }
+    } else {
+        /* Repost single recv */
+        ret = hg_core_post(hg_core_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Cannot post handle");
+    }
 
-    /* Listening */
-    hg_core_class->init_info.listen = na_listen;
+    return HG_SUCCESS;
 
-    /* Stats / counters */
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
-    hg_core_counters_init(&hg_core_class->counters);
-#endif
+error:
+    return ret;
+}
 
-    if (hg_init_info.stats) {
-#ifdef HG_HAS_DEBUG
-        hg_log_set_subsys_level("diag", HG_LOG_LEVEL_DEBUG);
-#else
-        HG_LOG_SUBSYS_WARNING(cls, "stats option requires MERCURY_ENABLE_DEBUG "
-                                   "CMake option to be turned ON.");
-#endif
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_set_rpc(struct hg_core_private_handle *hg_core_handle,
+    struct hg_core_private_addr *hg_core_addr, na_addr_t *na_addr, hg_id_t id)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    struct hg_core_info *info = &hg_core_handle->core_handle.info;
+    hg_return_t ret;
+
+    /* We allow for NULL addr to be passed at creation time, this allows
+     * for pool of handles to be created and later re-used after a call to
+     * HG_Core_reset() */
+    if (hg_core_addr && (info->addr != (hg_core_addr_t) hg_core_addr)) {
+        struct hg_core_private_context *context =
+            HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+
+        if (info->addr != HG_CORE_ADDR_NULL)
+            hg_core_addr_ref_put(context,
+                (struct hg_core_private_addr *) info->addr,
+                hg_core_handle->addr_ref_cached);
+        info->addr = (hg_core_addr_t) hg_core_addr;
+        hg_core_handle->addr_ref_cached =
+            hg_core_addr_ref_get(context, hg_core_addr);
+
+        /* Set NA addr to use */
+        hg_core_handle->na_addr = na_addr;
+
+        /* Set forward call depending on address self */
+        hg_core_handle->is_self = hg_core_class->init_info.loopback &&
+                                  hg_core_addr->core_addr.is_self;
+        hg_core_handle->ops =
+            (hg_core_handle->is_self) ? hg_core_ops_self_g : hg_core_ops_na_g;
     }
 
-    if (hg_init_info.na_class != NULL) {
-        /* External NA class */
-        hg_core_class->core_class.na_class = hg_init_info.na_class;
-        hg_core_class->init_info.na_ext_init = HG_TRUE;
-    } else {
-        /* Initialize NA if not provided externally */
-        hg_core_class->core_class.na_class = NA_Initialize_opt(na_info_string,
-            hg_core_class->init_info.listen, &hg_init_info.na_init_info);
-        HG_CHECK_SUBSYS_ERROR(cls, hg_core_class->core_class.na_class == NULL,
-            error, ret, HG_NA_ERROR,
-            "Could not initialize NA class (info_string=%s, listen=%d)",
-            na_info_string, hg_core_class->init_info.listen);
+    /* We also allow for NULL RPC id to be passed (same reason as above) */
+    if (id && info->id != id) {
+        struct hg_core_rpc_info *hg_core_rpc_info;
+
+        /* Retrieve ID function from function map */
+        hg_core_rpc_info = hg_core_map_lookup(&hg_core_class->rpc_map, &id);
+        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_rpc_info == NULL, error, ret,
+            HG_NOENTRY, "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
+
+        info->id = id;
+
+        /* Cache RPC info */
+        hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
     }
 
-    /* Multi-recv capability (currently not compatible with auto_sm) */
-    hg_core_class->init_info.multi_recv =
-        NA_Has_opt_feature(
-            hg_core_class->core_class.na_class, NA_OPT_MULTI_RECV) &&
-        !hg_init_info.no_multi_recv && !hg_init_info.auto_sm;
-    HG_LOG_SUBSYS_DEBUG(
-        cls, "Multi-recv set to %" PRIu8, hg_core_class->init_info.multi_recv);
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_post(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_return_t ret;
+    na_return_t na_ret;
+
+    /* Post a new unexpected receive */
+    na_ret = NA_Msg_recv_unexpected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_recv_input_cb, hg_core_handle,
+        hg_core_handle->core_handle.in_buf,
+        hg_core_handle->core_handle.in_buf_size,
+        hg_core_handle->in_buf_plugin_data, hg_core_handle->na_recv_op_id);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret,
+        "Could not post unexpected recv for input buffer (%s)",
+        NA_Error_to_string(na_ret));
+
+    HG_LOG_SUBSYS_DEBUG(rpc, "Posted handle (%p)", (void *) hg_core_handle);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_post_multi(struct hg_core_multi_recv_op *multi_recv_op,
+    na_class_t *na_class, na_context_t *na_context)
+{
+    hg_return_t ret;
+    na_return_t na_ret;
 
-    /* Compute max request tag */
-    hg_core_class->request_max_tag =
-        NA_Msg_get_max_tag(hg_core_class->core_class.na_class);
-    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class->request_max_tag == 0, error, ret,
-        HG_NA_ERROR, "NA Max tag is not defined");
+    hg_atomic_init32(&multi_recv_op->last, 0);
+    hg_atomic_init32(&multi_recv_op->ref_count, 0);
+    hg_atomic_init32(&multi_recv_op->op_count, 0);
+    hg_atomic_init32(&multi_recv_op->pressure, 0);
 
-#ifdef NA_HAS_SM
-    /* Retrieve NA class name */
-    na_class_name = NA_Get_class_name(hg_core_class->core_class.na_class);
+    /* Post a new unexpected receive */
+    na_ret = NA_Msg_multi_recv_unexpected(na_class, na_context,
+        hg_core_multi_recv_input_cb, multi_recv_op, multi_recv_op->buf,
+        multi_recv_op->buf_size, multi_recv_op->plugin_data,
+        multi_recv_op->op_id);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "NA_Msg_multi_recv_unexpected() failed (%s)",
+        NA_Error_to_string(na_ret));
 
-    /* Initialize SM plugin */
-    if (hg_init_info.auto_sm && ((strcmp(na_class_name, "mpi") == 0) ||
-                                    (strcmp(na_class_name, "na") == 0))) {
-        HG_LOG_SUBSYS_WARNING(cls,
-            "Auto SM mode is not compatible with current NA class, disabling");
-    } else if (hg_init_info.auto_sm) {
-        char info_string[HG_CORE_ADDR_MAX_SIZE], *info_string_p;
-        na_tag_t na_sm_max_tag;
-        na_return_t na_ret;
+    HG_LOG_SUBSYS_DEBUG(rpc, "Posted multi-recv buffer (%p, %zu)",
+        multi_recv_op->buf, multi_recv_op->buf_size);
 
-        if (hg_init_info.sm_info_string != NULL) {
-            rc = snprintf(info_string, HG_CORE_ADDR_MAX_SIZE, "na+sm://%s",
-                hg_init_info.sm_info_string);
-            HG_CHECK_SUBSYS_ERROR(cls, rc < 0 || rc > HG_CORE_ADDR_MAX_SIZE,
-                error, ret, HG_OVERFLOW, "snprintf() failed, rc: %d", rc);
-            info_string_p = info_string;
-        } else
-            info_string_p = "na+sm";
+    return HG_SUCCESS;
 
-        /* Initialize NA SM first so that tmp directories are created */
-        hg_core_class->core_class.na_sm_class = NA_Initialize_opt(info_string_p,
-            hg_core_class->init_info.listen, &hg_init_info.na_init_info);
-        HG_CHECK_SUBSYS_ERROR(cls,
-            hg_core_class->core_class.na_sm_class == NULL, error, ret,
-            HG_NA_ERROR,
-            "Could not initialize NA SM class (info_string=%s, listen=%d)",
-            info_string_p, hg_core_class->init_info.listen);
+error:
+    return ret;
+}
 
-        /* Get SM host ID */
-        na_ret = NA_SM_Host_id_get(&hg_core_class->host_id);
-        HG_CHECK_SUBSYS_ERROR(cls, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "NA_SM_Host_id_get() failed (%s)",
-            NA_Error_to_string(na_ret));
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_repost_multi(struct hg_core_private_context *context,
+    struct hg_core_handle_pool *hg_core_handle_pool,
+    struct hg_core_multi_recv_op *multi_recv_op)
+{
+    size_t mem_max =
+        HG_CORE_CONTEXT_CLASS(context)->init_info.multi_recv_mem_max;
+    hg_return_t ret;
 
-        /* Get max tag */
-        na_sm_max_tag =
-            NA_Msg_get_max_tag(hg_core_class->core_class.na_sm_class);
-        HG_CHECK_SUBSYS_ERROR(cls, na_sm_max_tag == 0, error, ret, HG_NA_ERROR,
-            "NA Max tag is not defined");
-        hg_core_class->request_max_tag =
-            MIN(hg_core_class->request_max_tag, na_sm_max_tag);
+    if (mem_max > 0) {
+        size_t buf_size = multi_recv_op->buf_size,
+               buf_size_max =
+                   context->multi_recv_buf_size * HG_CORE_MULTI_RECV_SIZE_MAX;
+
+        hg_thread_mutex_lock(&context->multi_recv_mutex);
+        if (hg_atomic_get32(&multi_recv_op->pressure)) {
+            /* Buffers are consumed faster than they are released, grow it */
+            if (buf_size * 2 <= buf_size_max &&
+                context->multi_recv_mem + buf_size <= mem_max &&
+                hg_core_context_multi_recv_acquire(context, buf_size)) {
+                hg_core_multi_recv_op_resize(multi_recv_op,
+                    hg_core_handle_pool->na_class, buf_size * 2,
+                    &context->multi_recv_mem);
+                if (multi_recv_op->buf_size == buf_size)
+                    hg_core_context_multi_recv_release(context, buf_size);
+            }
+        } else if (hg_atomic_get32(&context->multi_recv_op_count) ==
+                       context->multi_recv_op_active - 1 &&
+                   !hg_atomic_get32(&context->unposting)) {
+            /* All other buffers are still posted, traffic has dropped */
+            if (multi_recv_op->id == context->multi_recv_op_active - 1 &&
+                multi_recv_op->id >= HG_CORE_MULTI_RECV_OP_INIT) {
+                HG_LOG_SUBSYS_DEBUG(
+                    ctx, "Releasing multi-recv buffer %d", multi_recv_op->id);
+                context->multi_recv_mem -= buf_size;
+                context->multi_recv_op_active--;
+                hg_core_multi_recv_op_free(
+                    multi_recv_op, hg_core_handle_pool->na_class);
+                hg_core_context_multi_recv_release(context, buf_size);
+                hg_thread_mutex_unlock(&context->multi_recv_mutex);
+                return HG_SUCCESS;
+            } else if (buf_size > context->multi_recv_buf_size) {
+                hg_core_multi_recv_op_resize(multi_recv_op,
+                    hg_core_handle_pool->na_class, buf_size / 2,
+                    &context->multi_recv_mem);
+                if (multi_recv_op->buf_size < buf_size)
+                    hg_core_context_multi_recv_release(context, buf_size / 2);
+            }
+        }
+        hg_thread_mutex_unlock(&context->multi_recv_mutex);
     }
-#else
-    HG_CHECK_SUBSYS_WARNING(cls, hg_init_info.auto_sm,
-        "Option auto_sm requested but NA SM pluging was not compiled, "
-        "please turn ON NA_USE_SM in CMake options");
-#endif
 
-    *class_p = hg_core_class;
+    HG_LOG_SUBSYS_DEBUG(
+        ctx, "Reposting multi-recv buffer %d", multi_recv_op->id);
+
+    /* Repost multi recv */
+    ret = hg_core_post_multi(multi_recv_op, hg_core_handle_pool->na_class,
+        hg_core_handle_pool->na_context);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+        "Cannot repost multi-recv operation (%d)", multi_recv_op->id);
+    hg_atomic_incr32(&context->multi_recv_op_count);
 
     return HG_SUCCESS;
 
 error:
-    if (hg_core_class->core_class.na_class != NULL &&
-        !hg_core_class->init_info.na_ext_init) {
-        na_return_t na_ret = NA_Finalize(hg_core_class->core_class.na_class);
-        HG_CHECK_SUBSYS_ERROR_DONE(cls, na_ret != NA_SUCCESS,
-            "Could not finalize NA class (%s)", NA_Error_to_string(na_ret));
-    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_release_input(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_handle_pool *hg_core_handle_pool;
+    struct hg_core_multi_recv_op *multi_recv_op = hg_core_handle->multi_recv_op;
+    hg_return_t ret;
+
+    if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_MULTI_RECV))
+        return HG_SUCCESS;
+
 #ifdef NA_HAS_SM
-    if (hg_core_class->core_class.na_sm_class != NULL) {
-        na_return_t na_ret = NA_Finalize(hg_core_class->core_class.na_sm_class);
-        HG_CHECK_SUBSYS_ERROR_DONE(cls, na_ret != NA_SUCCESS,
-            "Could not finalize NA SM class (%s)", NA_Error_to_string(na_ret));
-    }
+    hg_core_handle_pool = (hg_core_handle->na_class ==
+                              context->core_context.core_class->na_sm_class)
+                              ? context->sm_handle_pool
+                              : context->handle_pool;
+#else
+    hg_core_handle_pool = context->handle_pool;
 #endif
-    if (hg_core_class->rpc_map.map)
-        hg_hash_table_free(hg_core_class->rpc_map.map);
-    (void) hg_thread_rwlock_destroy(&hg_core_class->rpc_map.lock);
 
-error_free:
-    free(hg_core_class);
+    /* Multi-recv buffers */
+    if (multi_recv_op != NULL) {
+        hg_core_handle->core_handle.in_buf = NULL;
+        hg_core_handle->core_handle.in_buf_size = 0;
+        hg_core_handle->multi_recv_op = NULL;
+
+        if (hg_atomic_decr32(&multi_recv_op->ref_count) == 0 &&
+            hg_atomic_get32(&multi_recv_op->last)) {
+            ret = hg_core_repost_multi(
+                context, hg_core_handle_pool, multi_recv_op);
+            HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
+                "Cannot repost multi-recv operation (%d)", multi_recv_op->id);
+        }
+    }
 
+    return HG_SUCCESS;
+
+error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_finalize(struct hg_core_private_class *hg_core_class)
+hg_core_forward(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size)
 {
-    int32_t n_addrs, n_contexts, n_bulks;
-    hg_return_t ret;
+    struct hg_peer_stats *peer_stats;
+    int32_t HG_DEBUG_LOG_USED ref_count;
+    int32_t status;
+    hg_size_t header_size;
+    unsigned int timeout_ms;
+    hg_return_t ret = HG_SUCCESS;
 
-    if (hg_core_class == NULL)
-        return HG_SUCCESS;
+    status = hg_atomic_get32(&hg_core_handle->status);
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        !(status & HG_CORE_OP_COMPLETED) || (status & HG_CORE_OP_QUEUED), done,
+        ret, HG_BUSY, "Attempting to use handle that was not completed");
 
-    n_bulks = hg_atomic_get32(&hg_core_class->n_bulks);
-    HG_CHECK_SUBSYS_ERROR(cls, n_bulks != 0, error, ret, HG_BUSY,
-        "HG bulk handles must be destroyed before finalizing HG (%d "
-        "remaining)",
-        n_bulks);
+    /* Increment ref_count on handle to allow for destroy to be
+     * pre-emptively called */
+    ref_count = hg_core_handle_ref_incr(hg_core_handle);
+    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count incr to %" PRId32,
+        (void *) hg_core_handle, ref_count);
 
-    n_contexts = hg_atomic_get32(&hg_core_class->n_contexts);
-    HG_CHECK_SUBSYS_ERROR(cls, n_contexts != 0, error, ret, HG_BUSY,
-        "HG contexts must be destroyed before finalizing HG (%d remaining)",
-        n_contexts);
+    /* Reset op counts */
+    hg_atomic_set32(
+        &hg_core_handle->op_expected_count, 1); /* Default (no response) */
+    hg_atomic_set32(&hg_core_handle->op_completed_count, 0);
 
-    n_addrs = hg_atomic_get32(&hg_core_class->n_addrs);
-    HG_CHECK_SUBSYS_ERROR(cls, n_addrs != 0, error, ret, HG_BUSY,
-        "HG addrs must be freed before finalizing HG (%d remaining)", n_addrs);
+    /* Reset handle ret */
+    hg_core_handle->ret = HG_SUCCESS;
 
-    /* Finalize NA class */
-    if (hg_core_class->core_class.na_class != NULL &&
-        !hg_core_class->init_info.na_ext_init) {
-        na_return_t na_ret = NA_Finalize(hg_core_class->core_class.na_class);
-        HG_CHECK_SUBSYS_ERROR(cls, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not finalize NA class (%s)",
-            NA_Error_to_string(na_ret));
-        hg_core_class->core_class.na_class = NULL;
+    /* Reset status */
+    hg_atomic_set32(&hg_core_handle->status, 0);
+    hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) hg_core_handle->ret);
+
+    /* Set header size */
+    header_size = hg_core_header_request_get_size() +
+                  hg_core_handle->core_handle.na_in_header_offset;
+
+    /* Set the actual size of the msg that needs to be transmitted */
+    hg_core_handle->in_buf_used = header_size + payload_size;
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        hg_core_handle->in_buf_used > hg_core_handle->core_handle.in_buf_size,
+        error, ret, HG_MSGSIZE, "Exceeding input buffer size");
+
+    /* Parse flags */
+    if (flags & HG_CORE_NO_RESPONSE)
+        hg_core_handle->no_response = HG_TRUE;
+    if (hg_core_handle->is_self)
+        flags |= HG_CORE_SELF_FORWARD;
+    if (hg_core_handle->stream_credits > 0) {
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            hg_core_handle->is_self || hg_core_handle->no_response, error, ret,
+            HG_OPNOTSUPPORTED,
+            "Responses can only be streamed from a remote target");
+        flags |= HG_CORE_STREAM;
     }
 
-#ifdef NA_HAS_SM
-    /* Finalize NA SM class */
-    if (hg_core_class->core_class.na_sm_class != NULL) {
-        na_return_t na_ret = NA_Finalize(hg_core_class->core_class.na_sm_class);
-        HG_CHECK_SUBSYS_ERROR(cls, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not finalize NA SM class (%s)",
-            NA_Error_to_string(na_ret));
-        hg_core_class->core_class.na_sm_class = NULL;
+    /* Handles that were posted and reset for forwarding may not have an
+     * output buffer yet */
+    if (!hg_core_handle->no_response &&
+        hg_core_handle->core_handle.out_buf == NULL) {
+        ret = hg_core_alloc_output(hg_core_handle, NA_RECV);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate output buffer");
     }
-#endif
 
-    /* Free user data */
-    if (hg_core_class->core_class.data_free_callback)
-        hg_core_class->core_class.data_free_callback(
-            hg_core_class->core_class.data);
+    /* Let the target send the response as an unexpected message when a
+     * response table slot is available, this also generates the tag */
+    hg_core_handle->unexpected_response =
+        !hg_core_handle->is_self && !hg_core_handle->no_response &&
+        hg_core_handle->stream_credits == 0 &&
+        HG_CORE_HANDLE_CLASS(hg_core_handle)->response_table != NULL &&
+        hg_core_response_table_insert(hg_core_handle);
+    if (hg_core_handle->unexpected_response)
+        flags |= HG_CORE_UNEXPECTED_RESPONSE;
+
+    /* Let the trace callback fill the trace context and append it after the
+     * payload if there is room left for it */
+    if (unlikely(HG_CORE_HANDLE_CLASS(hg_core_handle)->trace_cb.callback)) {
+        memset(hg_core_handle->trace_context, 0, HG_TRACE_CONTEXT_SIZE);
+        hg_core_handle->trace_context_set = HG_TRUE;
+        hg_core_trace(hg_core_handle, HG_TRACE_FORWARD);
+        if (hg_core_handle->in_buf_used + HG_TRACE_CONTEXT_SIZE <=
+            hg_core_handle->core_handle.in_buf_size) {
+            memcpy((char *) hg_core_handle->core_handle.in_buf +
+                       hg_core_handle->in_buf_used,
+                hg_core_handle->trace_context, HG_TRACE_CONTEXT_SIZE);
+            hg_core_handle->in_buf_used += HG_TRACE_CONTEXT_SIZE;
+            flags |= HG_CORE_TRACE;
+        }
+    }
 
-    /* Delete RPC map */
-    if (hg_core_class->rpc_map.map != NULL) {
-        hg_hash_table_free(hg_core_class->rpc_map.map);
-        hg_core_class->rpc_map.map = NULL;
+    /* Credits are appended last so that the target strips them first */
+    if (hg_core_handle->stream_credits > 0) {
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            hg_core_handle->in_buf_used + sizeof(hg_uint8_t) >
+                hg_core_handle->core_handle.in_buf_size,
+            error, ret, HG_MSGSIZE, "Exceeding input buffer size");
+        ((hg_uint8_t *) hg_core_handle->core_handle
+                .in_buf)[hg_core_handle->in_buf_used] =
+            hg_core_handle->stream_credits;
+        hg_core_handle->in_buf_used += sizeof(hg_uint8_t);
     }
-    (void) hg_thread_rwlock_destroy(&hg_core_class->rpc_map.lock);
-    free(hg_core_class);
 
-    return HG_SUCCESS;
+    /* Set callback, keep request and response callbacks separate so that
+     * they do not get overwritten when forwarding to ourself */
+    hg_core_handle->request_callback = callback;
+    hg_core_handle->request_arg = arg;
 
-error:
+    /* Release output lease of a previous response from the same target with
+     * this request instead of a separate ack */
+    if (!hg_core_handle->is_self) {
+        hg_core_lease_take(hg_core_handle);
+        if (hg_core_handle->lease != NULL)
+            flags |= HG_CORE_RELEASE;
+    }
+
+    /* Header of persistent handles is only encoded again if flags differ
+     * from the previous forward or if a lease is released */
+    if (!hg_core_handle->in_header_encoded ||
+        hg_core_handle->in_header.msg.request.flags != flags ||
+        hg_core_handle->lease != NULL) {
+        /* Set header */
+        hg_core_handle->in_header.msg.request.id =
+            hg_core_handle->core_handle.info.id;
+        hg_core_handle->in_header.msg.request.flags = flags;
+        hg_core_handle->in_header.msg.request.release =
+            (hg_core_handle->lease != NULL)
+                ? (hg_uint32_t) hg_core_handle->lease->tag
+                : 0;
+        /* Set the cookie as origin context ID, so that when the cookie is
+         * unpacked by the target and assigned to HG info context_id, the NA
+         * layer knows which context ID it needs to send the response to. */
+        hg_core_handle->in_header.msg.request.cookie =
+            hg_core_handle->core_handle.info.context->id;
+
+        /* Encode request header */
+        ret = hg_core_proc_header_request(&hg_core_handle->core_handle,
+            &hg_core_handle->in_header, HG_ENCODE);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode header");
+        hg_core_handle->in_header_encoded = hg_core_handle->persistent;
+    }
+
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+    /* Increment counter */
+    hg_atomic_incr64(
+        HG_CORE_HANDLE_CLASS(hg_core_handle)->counters.rpc_req_sent_count);
+#endif
+
+    /* Stats, latency is recorded once the forward callback is triggered */
+    if (hg_core_handle->core_handle.rpc_info != NULL)
+        hg_core_histogram_record(
+            &((struct hg_core_private_rpc_info *)
+                    hg_core_handle->core_handle.rpc_info)
+                 ->payload,
+            payload_size);
+    hg_core_handle->forward_start = hg_time_get_cycles();
+    peer_stats = hg_core_peer_lock_handle(hg_core_handle);
+    if (peer_stats != NULL) {
+        peer_stats->rpc_out++;
+        peer_stats->bytes_out += hg_core_handle->in_buf_used;
+        hg_core_peer_unlock(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
+    }
+
+    /* Let progress cancel the handle once its deadline is reached (local
+     * cancellation is not supported) */
+    timeout_ms = hg_core_handle->timeout_ms;
+    if (timeout_ms == 0 && hg_core_handle->core_handle.rpc_info != NULL)
+        timeout_ms = ((struct hg_core_private_rpc_info *)
+                          hg_core_handle->core_handle.rpc_info)
+                         ->timeout_ms;
+    if (timeout_ms != 0 && !hg_core_handle->is_self)
+        hg_core_timer_add(hg_core_handle, timeout_ms);
+
+    /* If addr is self, forward locally, otherwise send the encoded buffer
+     * through NA and pre-post response */
+    ret = hg_core_handle->ops.forward(hg_core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward buffer");
+
+done:
     return ret;
-}
 
-/*---------------------------------------------------------------------------*/
-void
-hg_core_bulk_incr(hg_core_class_t *hg_core_class)
-{
-    hg_atomic_incr32(
-        &((struct hg_core_private_class *) hg_core_class)->n_bulks);
+error:
+    if (hg_core_handle->timed)
+        hg_core_timer_remove(hg_core_handle);
+
+    /* Lease must be released through an explicit ack */
+    hg_core_lease_sent(hg_core_handle, HG_FALSE);
+
+    /* Release response table slot */
+    if (hg_core_handle->unexpected_response)
+        (void) hg_core_response_table_remove(
+            HG_CORE_HANDLE_CLASS(hg_core_handle), hg_core_handle->tag,
+            hg_core_handle);
+
+    /* Handle is no longer in use */
+    hg_atomic_set32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+
+    /* Rollback ref_count taken above */
+    hg_core_handle_ref_decr(hg_core_handle);
+
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void
-hg_core_bulk_decr(hg_core_class_t *hg_core_class)
+static hg_return_t
+hg_core_forward_self(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_atomic_decr32(
-        &((struct hg_core_private_class *) hg_core_class)->n_bulks);
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+
+    /* Post operation to self processing pool */
+    return hg_core_process_self(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_context_create(struct hg_core_private_class *hg_core_class,
-    hg_uint8_t id, struct hg_core_private_context **context_p)
+hg_core_forward_na(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_context *context = NULL;
-    struct hg_core_completion_queue *backfill_queue = NULL;
     hg_return_t ret;
-    int na_poll_fd, loopback_event = 0, rc;
-    hg_bool_t backfill_queue_mutex_init = HG_FALSE,
-              backfill_queue_cond_init = HG_FALSE,
-              loopback_notify_mutex_init = HG_FALSE,
-              user_list_lock_init = HG_FALSE,
-              internal_list_lock_init = HG_FALSE;
-#ifdef HG_HAS_MULTI_PROGRESS
-    struct hg_core_progress_multi *progress_multi = NULL;
-    bool progress_multi_mutex_init = false, progress_multi_cond_init = false;
-#endif
-
-    context = (struct hg_core_private_context *) calloc(1, sizeof(*context));
-    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_NOMEM,
-        "Could not allocate HG context");
-    hg_atomic_init32(&context->n_handles, 0);
-    hg_atomic_init32(&context->unposting, 0);
-
-    context->core_context.core_class = (struct hg_core_class *) hg_core_class;
-    backfill_queue = &context->backfill_queue;
-
-    HG_QUEUE_INIT(&backfill_queue->queue);
-    hg_atomic_init32(&backfill_queue->count, 0);
-    rc = hg_thread_mutex_init(&backfill_queue->mutex);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_mutex_init() failed");
-    backfill_queue_mutex_init = HG_TRUE;
-    rc = hg_thread_cond_init(&backfill_queue->cond);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_cond_init() failed");
-    backfill_queue_cond_init = HG_TRUE;
-
-    context->completion_queue =
-        hg_atomic_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
-    HG_CHECK_SUBSYS_ERROR(ctx, context->completion_queue == NULL, error, ret,
-        HG_NOMEM, "Could not allocate queue");
+    na_return_t na_ret;
 
-    /* Notifications of completion queue events */
-    hg_atomic_init32(&context->loopback_notify.must_notify, 0);
-    rc = hg_thread_mutex_init(&context->loopback_notify.mutex);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_mutex_init() failed");
-    loopback_notify_mutex_init = HG_TRUE;
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_FORWARD;
 
-    HG_LIST_INIT(&context->user_list.list);
-    rc = hg_thread_spin_init(&context->user_list.lock);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_spin_init() failed");
-    user_list_lock_init = HG_TRUE;
+    if (hg_core_handle->unexpected_response) {
+        /* Tag was generated with the response table slot, response is
+         * received through the unexpected path */
+        hg_atomic_incr32(&hg_core_handle->op_expected_count);
+    } else {
+        /* Generate tag */
+        hg_core_handle->tag =
+            hg_core_gen_request_tag(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
+    }
 
-    HG_LIST_INIT(&context->internal_list.list);
-    rc = hg_thread_spin_init(&context->internal_list.lock);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_spin_init() failed");
-    internal_list_lock_init = HG_TRUE;
+    /* Pre-post recvs (output) if response is expected */
+    if (hg_core_handle->stream_credits > 0) {
+        unsigned int posted;
 
-#ifdef HG_HAS_MULTI_PROGRESS
-    /* Initialize multi-progress lock */
-    progress_multi = &context->progress_multi;
-    hg_atomic_init32(&progress_multi->count, 0);
-    rc = hg_thread_mutex_init(&progress_multi->mutex);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_mutex_init() failed");
-    progress_multi_mutex_init = true;
+        ret = hg_core_stream_post(hg_core_handle, &posted);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_SUBSYS_ERROR(rpc, "Could not post recvs for stream");
+            if (posted == 0)
+                goto error_recv;
+            goto error_send;
+        }
+    } else if (!hg_core_handle->no_response &&
+               !hg_core_handle->unexpected_response) {
+        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_recv_output_cb, hg_core_handle,
+            hg_core_handle->core_handle.out_buf,
+            hg_core_handle->core_handle.out_buf_size,
+            hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
+            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+            hg_core_handle->na_recv_op_id);
+        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error_recv, ret,
+            (hg_return_t) na_ret, "Could not post recv for output buffer (%s)",
+            NA_Error_to_string(na_ret));
 
-    rc = hg_thread_cond_init(&progress_multi->cond);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_cond_init() failed");
-    progress_multi_cond_init = true;
-#endif
+        /* Increment number of expected operations */
+        hg_atomic_incr32(&hg_core_handle->op_expected_count);
+    }
 
-    /* Create NA context */
-    context->core_context.na_context =
-        NA_Context_create_id(hg_core_class->core_class.na_class, id);
-    HG_CHECK_SUBSYS_ERROR(ctx, context->core_context.na_context == NULL, error,
-        ret, HG_NOMEM, "Could not create NA context");
+    /* Mark handle as posted */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
 
-#ifdef NA_HAS_SM
-    if (hg_core_class->core_class.na_sm_class) {
-        context->core_context.na_sm_context =
-            NA_Context_create(hg_core_class->core_class.na_sm_class);
-        HG_CHECK_SUBSYS_ERROR(ctx, context->core_context.na_sm_context == NULL,
-            error, ret, HG_NOMEM, "Could not create NA SM context");
-    }
-#endif
+    /* Hold request back if it can be packed with others to the same target,
+     * send completes once the coalesced message is sent. High priority
+     * requests, requests of RPCs that opted out and requests of streams are
+     * never held back */
+    if (HG_CORE_HANDLE_CONTEXT(hg_core_handle)->coalesce.max > 0 &&
+        !HG_CORE_HANDLE_PRIO_HIGH(hg_core_handle) &&
+        !HG_CORE_HANDLE_NO_COALESCE(hg_core_handle) &&
+        hg_core_handle->stream_credits == 0 &&
+        hg_core_coalesce_add(hg_core_handle))
+        return HG_SUCCESS;
 
-    /* If NA plugin exposes fd, we will use poll set and use appropriate
-     * progress function */
-    na_poll_fd = NA_Poll_get_fd(
-        hg_core_class->core_class.na_class, context->core_context.na_context);
+    /* Post send (input) */
+    ret = hg_core_forward_na_send(hg_core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error_send, ret, "Could not post send for input buffer");
 
-    if (!(hg_core_class->init_info.progress_mode & NA_NO_BLOCK) &&
-        (na_poll_fd > 0)) {
-        struct hg_poll_event event = {.events = HG_POLLIN, .data.u64 = 0};
+    return HG_SUCCESS;
 
-        /* Create poll set */
-        context->poll_set = hg_poll_create();
-        HG_CHECK_SUBSYS_ERROR(ctx, context->poll_set == NULL, error, ret,
-            HG_NOMEM, "Could not create poll set");
+error_recv:
+    return ret;
 
-        event.data.u32 = (uint32_t) HG_CORE_POLL_NA;
-        rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
-        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-            "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
-        context->na_event = na_poll_fd;
+error_send:
+    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_POSTED);
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
 
-#ifdef NA_HAS_SM
-        if (hg_core_class->core_class.na_sm_class &&
-            context->core_context.na_sm_context) {
-            na_poll_fd = NA_Poll_get_fd(hg_core_class->core_class.na_sm_class,
-                context->core_context.na_sm_context);
-            HG_CHECK_SUBSYS_ERROR(ctx, na_poll_fd < 0, error, ret,
-                HG_PROTOCOL_ERROR, "Could not get NA SM poll fd");
+    /* Lease must be released through an explicit ack */
+    hg_core_lease_sent(hg_core_handle, HG_FALSE);
 
-            event.data.u32 = (uint32_t) HG_CORE_POLL_SM;
-            rc = hg_poll_add(context->poll_set, na_poll_fd, &event);
-            HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
-                HG_NOMEM, "hg_poll_add() failed (na_poll_fd=%d)", na_poll_fd);
-            context->na_sm_event = na_poll_fd;
-        }
-#endif
+    if (hg_core_handle->no_response) {
+        /* No recv was posted */
+        return ret;
+    } else if (hg_core_handle->unexpected_response) {
+        /* No recv was posted, slot is released by caller */
+        hg_atomic_decr32(&hg_core_handle->op_expected_count);
 
-        if (hg_core_class->init_info.loopback) {
-            /* Create event for completion queue notification */
-            loopback_event = hg_event_create();
-            HG_CHECK_SUBSYS_ERROR(ctx, loopback_event < 0, error, ret, HG_NOMEM,
-                "Could not create event");
+        return ret;
+    } else if (hg_core_handle->stream_credits > 0) {
+        hg_atomic_decr32(&hg_core_handle->op_expected_count);
 
-            /* Add event to context poll set */
-            event.data.u32 = (uint32_t) HG_CORE_POLL_LOOPBACK;
-            rc = hg_poll_add(context->poll_set, loopback_event, &event);
-            HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
-                HG_NOMEM, "hg_poll_add() failed (loopback_event=%d)",
-                loopback_event);
-            context->loopback_notify.event = loopback_event;
-        }
-    }
+        /* Keep error for return status */
+        hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) ret);
 
-    /* Assign context ID */
-    context->core_context.id = id;
+        /* Mark op as canceled and let chunks complete */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+        hg_core_stream_cancel(hg_core_handle);
 
-    /* Create pool of bulk op IDs */
-    ret = hg_bulk_op_pool_create((hg_core_context_t *) context,
-        HG_CORE_BULK_OP_INIT_COUNT, &context->hg_bulk_op_pool);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not create bulk op pool");
+        /* Return success here but callback will return canceled */
+        return HG_SUCCESS;
+    } else {
+        hg_atomic_decr32(&hg_core_handle->op_expected_count);
 
-    /* Increment context count of parent class */
-    hg_atomic_incr32(&HG_CORE_CONTEXT_CLASS(context)->n_contexts);
+        /* Keep error for return status */
+        hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) ret);
 
-    *context_p = context;
+        /* Mark op as canceled and let it complete */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
 
-    return HG_SUCCESS;
+        /* Cancel the above posted recv op */
+        na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
+            hg_core_handle->na_recv_op_id);
+        HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
+            "Could not cancel recv op id (%s)", NA_Error_to_string(na_ret));
 
-error:
-    if (context != NULL) {
-        if (context->poll_set != NULL) {
-            if (context->na_event > 0) {
-                rc = hg_poll_remove(context->poll_set, context->na_event);
-                HG_CHECK_SUBSYS_ERROR_DONE(ctx, rc != HG_UTIL_SUCCESS,
-                    "Could not remove NA poll descriptor from poll set");
-            }
-#ifdef NA_HAS_SM
-            if (context->na_sm_event > 0) {
-                rc = hg_poll_remove(context->poll_set, context->na_sm_event);
-                HG_CHECK_SUBSYS_ERROR_DONE(ctx, rc != HG_UTIL_SUCCESS,
-                    "Could not remove NA SM poll descriptor from poll set");
-            }
-#endif
-            if (context->loopback_notify.event > 0) {
-                rc = hg_poll_remove(
-                    context->poll_set, context->loopback_notify.event);
-                HG_CHECK_SUBSYS_ERROR_DONE(ctx, rc != HG_UTIL_SUCCESS,
-                    "Could not remove loopback poll descriptor from poll set");
-            }
-            rc = hg_poll_destroy(context->poll_set);
-            HG_CHECK_SUBSYS_ERROR_DONE(
-                ctx, rc != HG_UTIL_SUCCESS, "Could not destroy poll set");
-        }
+        /* Return success here but callback will return canceled */
+        return HG_SUCCESS;
+    }
+}
 
-        if (loopback_event > 0) {
-            rc = hg_event_destroy(loopback_event);
-            HG_CHECK_SUBSYS_ERROR_DONE(
-                ctx, rc != HG_UTIL_SUCCESS, "Could not destroy loopback event");
-        }
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_forward_na_send(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_return_t ret;
+    na_return_t na_ret;
 
-        if (context->core_context.na_context != NULL) {
-            na_return_t na_ret =
-                NA_Context_destroy(hg_core_class->core_class.na_class,
-                    context->core_context.na_context);
-            HG_CHECK_SUBSYS_ERROR_DONE(ctx, na_ret != NA_SUCCESS,
-                "Could not destroy NA context (%s)",
-                NA_Error_to_string(na_ret));
-        }
-#ifdef NA_HAS_SM
-        if (context->core_context.na_sm_context != NULL) {
-            na_return_t na_ret =
-                NA_Context_destroy(hg_core_class->core_class.na_sm_class,
-                    context->core_context.na_sm_context);
-            HG_CHECK_SUBSYS_ERROR_DONE(ctx, na_ret != NA_SUCCESS,
-                "Could not destroy NA SM context (%s)",
-                NA_Error_to_string(na_ret));
-        }
-#endif
+    na_ret = NA_Msg_send_unexpected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_send_input_cb, hg_core_handle,
+        hg_core_handle->core_handle.in_buf, hg_core_handle->in_buf_used,
+        hg_core_handle->in_buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        hg_core_handle->na_send_op_id);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "NA_Msg_send_unexpected() failed (%s)",
+        NA_Error_to_string(na_ret));
 
-        if (backfill_queue_mutex_init)
-            (void) hg_thread_mutex_destroy(&backfill_queue->mutex);
-        if (backfill_queue_cond_init)
-            (void) hg_thread_cond_destroy(&backfill_queue->cond);
-        if (loopback_notify_mutex_init)
-            (void) hg_thread_mutex_destroy(&context->loopback_notify.mutex);
-        if (user_list_lock_init)
-            (void) hg_thread_spin_destroy(&context->user_list.lock);
-        if (internal_list_lock_init)
-            (void) hg_thread_spin_destroy(&context->internal_list.lock);
-#ifdef HG_HAS_MULTI_PROGRESS
-        if (progress_multi_mutex_init)
-            (void) hg_thread_mutex_destroy(&progress_multi->mutex);
-        if (progress_multi_cond_init)
-            (void) hg_thread_cond_destroy(&progress_multi->cond);
-#endif
-        hg_atomic_queue_free(context->completion_queue);
-        free(context);
-    }
+    return HG_SUCCESS;
 
+error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_destroy(struct hg_core_private_context *context)
+static hg_bool_t
+hg_core_coalesce_add(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_class *hg_core_class = NULL;
-#ifdef HG_HAS_MULTI_PROGRESS
-    struct hg_core_progress_multi *progress_multi = NULL;
-#endif
-    struct hg_core_completion_queue *backfill_queue = NULL;
-    hg_bool_t empty;
-    hg_return_t ret;
-    int rc;
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_coalesce *coalesce = &context->coalesce;
+    struct hg_core_coalesce_msg *coalesce_msg, *full_msg = NULL;
+    size_t na_header_size = hg_core_handle->core_handle.na_in_header_offset;
+    size_t request_size = hg_core_handle->in_buf_used - na_header_size;
+    size_t record_size = HG_CORE_COALESCE_ALIGN(
+        HG_CORE_COALESCE_RECORD_HEADER_SIZE + request_size);
+    size_t msg_header_size = HG_CORE_COALESCE_ALIGN(
+        na_header_size + hg_core_header_request_get_size());
+    hg_uint8_t context_id = hg_core_handle->core_handle.info.context_id;
+    hg_bool_t notify = HG_FALSE, flush = HG_FALSE;
+    double window = (double) coalesce->delay / 1e6;
+    hg_uint32_t record_header[2];
+    hg_time_t now;
+    char *record;
+
+    /* Record must fit into a message of its own */
+    if (msg_header_size + record_size >
+        NA_Msg_get_max_unexpected_size(hg_core_handle->na_class))
+        return HG_FALSE;
 
-    if (context == NULL)
-        return HG_SUCCESS;
+    hg_time_get_current(&now);
 
-    /* Keep reference to class */
-    hg_core_class = HG_CORE_CONTEXT_CLASS(context);
-#ifdef HG_HAS_MULTI_PROGRESS
-    /* Check that we are no longer progressing */
-    progress_multi = &context->progress_multi;
-    HG_CHECK_SUBSYS_ERROR(ctx, hg_atomic_get32(&progress_multi->count) > 0,
-        error, ret, HG_BUSY, "Still progressing on context");
-#endif
+    hg_thread_mutex_lock(&coalesce->mutex);
 
-    if (context->posted) {
-        /* Unpost requests */
-        ret = hg_core_context_unpost(context, HG_CORE_CLEANUP_TIMEOUT);
-        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not unpost requests");
+    /* Requests to an idle target are not held back */
+    if (coalesce->peers != NULL) {
+        window = hg_core_coalesce_window(
+            coalesce, hg_core_handle->na_addr, now);
+        flush = (window == 0.);
     }
 
-    /* Wait on created list (user created handles) */
-    ret = hg_core_context_list_wait(
-        context, &context->user_list, HG_CORE_CLEANUP_TIMEOUT);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not wait on handle list");
+    /* Look for a message being filled for the same target, responses are
+     * matched against the NA addr that the request was sent through so
+     * distinct NA addrs to the same peer cannot share a message */
+    coalesce_msg = HG_LIST_FIRST(&coalesce->pending_list);
+    while (coalesce_msg != NULL) {
+        if (coalesce_msg->na_class == hg_core_handle->na_class &&
+            coalesce_msg->na_addr == hg_core_handle->na_addr &&
+            coalesce_msg->context_id == context_id)
+            break;
+        coalesce_msg = HG_LIST_NEXT(coalesce_msg, entry);
+    }
 
-    /* Number of handles for that context should be 0 */
-    if (hg_atomic_get32(&context->n_handles) > 0) {
-        HG_LOG_SUBSYS_ERROR(ctx,
-            "HG core handles must be freed before destroying context (%" PRId32
-            " remaining)",
-            hg_atomic_get32(&context->n_handles));
+    /* Send message right away if request does not fit */
+    if (coalesce_msg != NULL &&
+        coalesce_msg->buf_used + record_size > coalesce_msg->buf_size) {
+        hg_core_coalesce_unlink(coalesce, coalesce_msg);
+        full_msg = coalesce_msg;
+        coalesce_msg = NULL;
+    }
 
-        ret = hg_core_context_check_handle_list(&context->user_list);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "User-created handles are still in use");
+    if (coalesce_msg == NULL) {
+        /* Nothing to pack this request with */
+        if (flush) {
+            hg_thread_mutex_unlock(&coalesce->mutex);
+            if (full_msg != NULL)
+                hg_core_coalesce_send(full_msg);
+            return HG_FALSE;
+        }
 
-        ret = hg_core_context_check_handle_list(&context->internal_list);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Internal handles are still in use");
+        /* Re-use a message that was allocated for the same NA class */
+        coalesce_msg = HG_LIST_FIRST(&coalesce->free_list);
+        while (coalesce_msg != NULL &&
+               coalesce_msg->na_class != hg_core_handle->na_class)
+            coalesce_msg = HG_LIST_NEXT(coalesce_msg, entry);
+
+        if (coalesce_msg != NULL)
+            HG_LIST_REMOVE(coalesce_msg, entry);
+        else {
+            coalesce_msg = (struct hg_core_coalesce_msg *) calloc(
+                1, sizeof(*coalesce_msg));
+            HG_CHECK_SUBSYS_ERROR_NORET(
+                rpc, coalesce_msg == NULL, error, "Could not allocate message");
+            coalesce_msg->context = context;
+            coalesce_msg->na_class = hg_core_handle->na_class;
+            coalesce_msg->na_context = hg_core_handle->na_context;
+
+            coalesce_msg->handles = (struct hg_core_private_handle **) malloc(
+                coalesce->max * sizeof(*coalesce_msg->handles));
+            HG_CHECK_SUBSYS_ERROR_NORET(rpc, coalesce_msg->handles == NULL,
+                error, "Could not allocate array of handles");
+
+            coalesce_msg->op_id = NA_Op_create(coalesce_msg->na_class, 0);
+            HG_CHECK_SUBSYS_ERROR_NORET(rpc, coalesce_msg->op_id == NULL,
+                error, "Could not create NA op ID");
+
+            coalesce_msg->buf_size =
+                NA_Msg_get_max_unexpected_size(coalesce_msg->na_class);
+            coalesce_msg->buf = NA_Msg_buf_alloc(coalesce_msg->na_class,
+                coalesce_msg->buf_size, NA_SEND, &coalesce_msg->plugin_data);
+            HG_CHECK_SUBSYS_ERROR_NORET(rpc, coalesce_msg->buf == NULL, error,
+                "Could not allocate buffer for coalesced requests");
+
+            HG_CHECK_SUBSYS_ERROR_NORET(rpc,
+                NA_Msg_init_unexpected(coalesce_msg->na_class,
+                    coalesce_msg->buf, coalesce_msg->buf_size) != NA_SUCCESS,
+                error, "Could not initialize buffer for coalesced requests");
+        }
+
+        coalesce_msg->na_addr = hg_core_handle->na_addr;
+        coalesce_msg->context_id = context_id;
+        coalesce_msg->buf_used = msg_header_size;
+        coalesce_msg->count = 0;
+        coalesce_msg->deadline =
+            hg_time_add(now, hg_time_from_double(window));
+
+        HG_LIST_INSERT_HEAD(&coalesce->pending_list, coalesce_msg, entry);
+        hg_atomic_incr32(&coalesce->pending_count);
+        notify = HG_TRUE;
     }
 
-    /* Check that backfill completion queue is empty now */
-    backfill_queue = &context->backfill_queue;
-    hg_thread_mutex_lock(&backfill_queue->mutex);
-    empty = HG_QUEUE_IS_EMPTY(&backfill_queue->queue);
-    hg_thread_mutex_unlock(&backfill_queue->mutex);
-    HG_CHECK_SUBSYS_ERROR(ctx, empty == HG_FALSE, error, ret, HG_BUSY,
-        "Completion queue should be empty");
+    /* Append record */
+    record = (char *) coalesce_msg->buf + coalesce_msg->buf_used;
+    record_header[0] = htonl((hg_uint32_t) request_size);
+    record_header[1] = htonl((hg_uint32_t) hg_core_handle->tag);
+    memcpy(record, record_header, sizeof(record_header));
+    memcpy(record + HG_CORE_COALESCE_RECORD_HEADER_SIZE,
+        (const char *) hg_core_handle->core_handle.in_buf + na_header_size,
+        request_size);
+    coalesce_msg->buf_used += record_size;
+    coalesce_msg->handles[coalesce_msg->count++] = hg_core_handle;
+    hg_core_handle->coalesce_msg = coalesce_msg;
 
-    /* Check that atomic completion queue is empty now */
-    empty = hg_atomic_queue_is_empty(context->completion_queue);
-    HG_CHECK_SUBSYS_ERROR(ctx, empty == HG_FALSE, error, ret, HG_BUSY,
-        "Completion queue should be empty");
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Packed handle %p into coalesced message %p (%u request(s), %zu "
+        "bytes)",
+        (void *) hg_core_handle, (void *) coalesce_msg, coalesce_msg->count,
+        coalesce_msg->buf_used);
+
+    if (coalesce_msg->count == coalesce->max || flush) {
+        hg_core_coalesce_unlink(coalesce, coalesce_msg);
+        notify = HG_FALSE;
+    } else
+        coalesce_msg = NULL;
 
-    /* Destroy pool of bulk op IDs */
-    if (context->hg_bulk_op_pool != NULL) {
-        hg_bulk_op_pool_destroy(context->hg_bulk_op_pool);
-        context->hg_bulk_op_pool = NULL;
-    }
+    hg_thread_mutex_unlock(&coalesce->mutex);
 
-    /* Stop listening for events */
-    if (context->loopback_notify.event > 0) {
-        rc = hg_poll_remove(context->poll_set, context->loopback_notify.event);
-        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
-            HG_NOENTRY, "Could not remove loopback notify event from poll set");
+    if (full_msg != NULL)
+        hg_core_coalesce_send(full_msg);
+    if (coalesce_msg != NULL)
+        hg_core_coalesce_send(coalesce_msg);
 
-        rc = hg_event_destroy(context->loopback_notify.event);
-        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
-            HG_NOENTRY, "Could not destroy loopback notify event");
-        context->loopback_notify.event = 0;
-    }
+    /* Wake up progress so that it can wait for the flush deadline */
+    if (notify)
+        hg_core_loopback_signal(context);
 
-    if (context->na_event > 0) {
-        rc = hg_poll_remove(context->poll_set, context->na_event);
-        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
-            HG_NOENTRY, "Could not remove NA event from poll set");
-        context->na_event = 0;
-    }
+    return HG_TRUE;
 
-#ifdef NA_HAS_SM
-    if (context->na_sm_event > 0) {
-        rc = hg_poll_remove(context->poll_set, context->na_sm_event);
-        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
-            HG_NOENTRY, "Could not remove NA SM event from poll set");
-        context->na_sm_event = 0;
-    }
-#endif
+error:
+    if (coalesce_msg != NULL)
+        hg_core_coalesce_msg_free(coalesce_msg);
+    hg_thread_mutex_unlock(&coalesce->mutex);
 
-    /* Destroy poll set */
-    if (context->poll_set != NULL) {
-        rc = hg_poll_destroy(context->poll_set);
-        HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_FAULT,
-            "Could not destroy poll set");
-        context->poll_set = NULL;
+    if (full_msg != NULL)
+        hg_core_coalesce_send(full_msg);
+
+    return HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_coalesce_cancel(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_coalesce *coalesce =
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->coalesce;
+    struct hg_core_coalesce_msg *coalesce_msg;
+    size_t na_header_size = hg_core_handle->core_handle.na_in_header_offset;
+    size_t offset = HG_CORE_COALESCE_ALIGN(
+        na_header_size + hg_core_header_request_get_size());
+    size_t record_size = 0;
+    unsigned int i;
+
+    if (coalesce->max == 0)
+        return HG_FALSE;
+
+    hg_thread_mutex_lock(&coalesce->mutex);
+    coalesce_msg = hg_core_handle->coalesce_msg;
+    if (coalesce_msg == NULL) {
+        hg_thread_mutex_unlock(&coalesce->mutex);
+        return HG_FALSE;
     }
 
-    /* Destroy NA context */
-    if (context->core_context.na_context != NULL) {
-        na_return_t na_ret =
-            NA_Context_destroy(context->core_context.core_class->na_class,
-                context->core_context.na_context);
-        HG_CHECK_SUBSYS_ERROR(ctx, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not destroy NA context (%s)",
-            NA_Error_to_string(na_ret));
-        context->core_context.na_context = NULL;
+    /* Locate record of request, records are packed in handle order */
+    for (i = 0; i < coalesce_msg->count; i++) {
+        struct hg_core_private_handle *handle = coalesce_msg->handles[i];
+
+        record_size = HG_CORE_COALESCE_ALIGN(
+            HG_CORE_COALESCE_RECORD_HEADER_SIZE + handle->in_buf_used -
+            handle->core_handle.na_in_header_offset);
+        if (handle == hg_core_handle)
+            break;
+        offset += record_size;
     }
 
-#ifdef NA_HAS_SM
-    /* Destroy NA SM context */
-    if (context->core_context.na_sm_context) {
-        na_return_t na_ret =
-            NA_Context_destroy(context->core_context.core_class->na_sm_class,
-                context->core_context.na_sm_context);
-        HG_CHECK_SUBSYS_ERROR(ctx, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not destroy NA SM context (%s)",
-            NA_Error_to_string(na_ret));
-        context->core_context.na_sm_context = NULL;
+    /* Remove record and handle from message */
+    memmove((char *) coalesce_msg->buf + offset,
+        (const char *) coalesce_msg->buf + offset + record_size,
+        coalesce_msg->buf_used - offset - record_size);
+    coalesce_msg->buf_used -= record_size;
+    memmove(&coalesce_msg->handles[i], &coalesce_msg->handles[i + 1],
+        (coalesce_msg->count - i - 1) * sizeof(*coalesce_msg->handles));
+    coalesce_msg->count--;
+    hg_core_handle->coalesce_msg = NULL;
+
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Removed handle %p from coalesced message %p (%u request(s) left)",
+        (void *) hg_core_handle, (void *) coalesce_msg, coalesce_msg->count);
+
+    /* Nothing left to send */
+    if (coalesce_msg->count == 0) {
+        hg_core_coalesce_unlink(coalesce, coalesce_msg);
+        coalesce_msg->na_addr = NULL;
+        HG_LIST_INSERT_HEAD(&coalesce->free_list, coalesce_msg, entry);
     }
-#endif
+    hg_thread_mutex_unlock(&coalesce->mutex);
 
-    /* Free user data */
-    if (context->core_context.data_free_callback)
-        context->core_context.data_free_callback(context->core_context.data);
+    /* Send of request completes as canceled */
+    hg_core_send_input_complete(hg_core_handle, NA_CANCELED);
 
-    /* Destroy completion queue mutex/cond */
-    (void) hg_thread_mutex_destroy(&backfill_queue->mutex);
-    (void) hg_thread_cond_destroy(&backfill_queue->cond);
-    (void) hg_thread_mutex_destroy(&context->loopback_notify.mutex);
-    (void) hg_thread_spin_destroy(&context->user_list.lock);
-    (void) hg_thread_spin_destroy(&context->internal_list.lock);
-#ifdef HG_HAS_MULTI_PROGRESS
-    (void) hg_thread_mutex_destroy(&progress_multi->mutex);
-    (void) hg_thread_cond_destroy(&progress_multi->cond);
-#endif
+    return HG_TRUE;
+}
 
-    hg_atomic_queue_free(context->completion_queue);
-    free(context);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_coalesce_unlink(struct hg_core_coalesce *coalesce,
+    struct hg_core_coalesce_msg *coalesce_msg)
+{
+    unsigned int i;
 
-    /* Decrement context count of parent class */
-    hg_atomic_decr32(&hg_core_class->n_contexts);
+    HG_LIST_REMOVE(coalesce_msg, entry);
+    hg_atomic_decr32(&coalesce->pending_count);
 
-    return HG_SUCCESS;
+    for (i = 0; i < coalesce_msg->count; i++)
+        coalesce_msg->handles[i]->coalesce_msg = NULL;
+}
 
-error:
-    return ret;
+/*---------------------------------------------------------------------------*/
+static double
+hg_core_coalesce_window(
+    struct hg_core_coalesce *coalesce, na_addr_t *na_addr, hg_time_t now)
+{
+    struct hg_core_coalesce_peer *peer =
+        &coalesce->peers[((uintptr_t) na_addr >> 4) &
+                         (HG_CORE_COALESCE_PEER_MAX - 1)];
+    double budget = (double) coalesce->delay / 1e6, gap, window;
+
+    /* Slots are shared by targets that hash the same, a target that takes
+     * over a slot is considered idle */
+    if (peer->na_addr != na_addr) {
+        peer->na_addr = na_addr;
+        peer->last = now;
+        peer->gap_avg = budget;
+        return 0.;
+    }
+
+    gap = hg_time_to_double(hg_time_subtract(now, peer->last));
+    peer->last = now;
+    peer->gap_avg += (gap - peer->gap_avg) / 8.;
+
+    /* Next request is not expected within budget */
+    if (gap > budget)
+        return 0.;
+
+    /* Long enough to fill the message at the current rate, within budget */
+    window = peer->gap_avg * (double) (coalesce->max - 1);
+
+    return (window < budget) ? window : budget;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_post(struct hg_core_private_context *context)
+static hg_bool_t
+hg_core_coalesce_flush(struct hg_core_private_context *context,
+    hg_bool_t force, hg_time_t *deadline_p)
 {
-    struct hg_core_private_class *hg_core_class =
-        HG_CORE_CONTEXT_CLASS(context);
-    unsigned long flags = HG_CORE_HANDLE_LISTEN;
-    hg_return_t ret;
+    struct hg_core_coalesce *coalesce = &context->coalesce;
+    HG_LIST_HEAD(hg_core_coalesce_msg) flush_list;
+    struct hg_core_coalesce_msg *coalesce_msg;
+    hg_bool_t pending = HG_FALSE;
+    hg_time_t now;
 
-    /* Allocate resources for "listening" on incoming RPCs */
-    HG_CHECK_SUBSYS_ERROR(ctx, !hg_core_class->init_info.listen, error, ret,
-        HG_OPNOTSUPPORTED, "Cannot post handles on non-listening class");
+    if (hg_atomic_get32(&coalesce->pending_count) == 0)
+        return HG_FALSE;
 
-    /* Allocate multi-recv operations */
-    if (hg_core_class->init_info.multi_recv) {
-        ret = hg_core_context_multi_recv_alloc(context,
-            hg_core_class->core_class.na_class,
-            hg_core_class->init_info.request_post_init);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not allocate multi-recv resources");
-        flags |= HG_CORE_HANDLE_MULTI_RECV;
-    }
+    HG_LIST_INIT(&flush_list);
+    hg_time_get_current(&now);
 
-    /* Create pool of handles */
-    ret = hg_core_handle_pool_create(context,
-        hg_core_class->core_class.na_class, context->core_context.na_context,
-        flags, hg_core_class->init_info.request_post_init,
-        hg_core_class->init_info.request_post_incr, &context->handle_pool);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        ctx, error, ret, "Could not allocate pool of handles");
+    hg_thread_mutex_lock(&coalesce->mutex);
+    coalesce_msg = HG_LIST_FIRST(&coalesce->pending_list);
+    while (coalesce_msg != NULL) {
+        struct hg_core_coalesce_msg *next = HG_LIST_NEXT(coalesce_msg, entry);
 
-#ifdef NA_HAS_SM
-    /* Create pool of SM handles */
-    if (context->core_context.na_sm_context != NULL) {
-        ret = hg_core_handle_pool_create(context,
-            hg_core_class->core_class.na_sm_class,
-            context->core_context.na_sm_context, flags,
-            hg_core_class->init_info.request_post_init,
-            hg_core_class->init_info.request_post_incr,
-            &context->sm_handle_pool);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not allocate pool of SM handles");
+        if (force || !hg_time_less(now, coalesce_msg->deadline)) {
+            hg_core_coalesce_unlink(coalesce, coalesce_msg);
+            HG_LIST_INSERT_HEAD(&flush_list, coalesce_msg, entry);
+        } else {
+            if (deadline_p != NULL &&
+                (!pending || hg_time_less(coalesce_msg->deadline, *deadline_p)))
+                *deadline_p = coalesce_msg->deadline;
+            pending = HG_TRUE;
+        }
+        coalesce_msg = next;
+    }
+    hg_thread_mutex_unlock(&coalesce->mutex);
+
+    /* Post sends that share the same NA class and context together */
+    while (!HG_LIST_IS_EMPTY(&flush_list)) {
+        struct hg_core_coalesce_msg *batch[HG_CORE_COALESCE_BATCH_MAX];
+        unsigned int batch_count = 0;
+
+        while ((coalesce_msg = HG_LIST_FIRST(&flush_list)) != NULL &&
+               batch_count < HG_CORE_COALESCE_BATCH_MAX) {
+            if (batch_count > 0 &&
+                (coalesce_msg->na_class != batch[0]->na_class ||
+                    coalesce_msg->na_context != batch[0]->na_context))
+                break;
+            HG_LIST_REMOVE(coalesce_msg, entry);
+            if (hg_core_coalesce_prepare(coalesce_msg))
+                batch[batch_count++] = coalesce_msg;
+        }
+        hg_core_coalesce_send_batch(batch, batch_count);
     }
-#endif
 
-    /* Only post multi-recv after pool of handles has been created */
-    if (hg_core_class->init_info.multi_recv) {
-        ret = hg_core_context_multi_recv_post(context,
-            hg_core_class->core_class.na_class,
-            context->core_context.na_context);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not post multi-recv operations");
+    return pending;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_coalesce_prepare(struct hg_core_coalesce_msg *coalesce_msg)
+{
+    struct hg_core_private_handle *hg_core_handle = coalesce_msg->handles[0];
+    size_t na_header_size = hg_core_handle->core_handle.na_in_header_offset;
+    struct hg_core_header hg_core_header;
+    hg_return_t ret;
+
+    /* No need for the extra header and copy if there is a single request */
+    if (coalesce_msg->count == 1) {
+        hg_core_coalesce_release(coalesce_msg);
+
+        ret = hg_core_forward_na_send(hg_core_handle);
+        if (ret != HG_SUCCESS)
+            hg_core_send_input_complete(hg_core_handle, (na_return_t) ret);
+        return HG_FALSE;
     }
 
-    context->posted = HG_TRUE;
+    /* Request header carries the number of requests packed */
+    memset(&hg_core_header, 0, sizeof(hg_core_header));
+    hg_core_header_request_init(&hg_core_header,
+        HG_CORE_CONTEXT_CLASS(coalesce_msg->context)->init_info.checksum_level >
+            HG_CHECKSUM_NONE);
+    hg_core_header.msg.request.id = coalesce_msg->count;
+    hg_core_header.msg.request.flags = HG_CORE_COALESCED;
+    hg_core_header.msg.request.cookie = coalesce_msg->context->core_context.id;
+    ret = hg_core_header_request_proc(HG_ENCODE,
+        (char *) coalesce_msg->buf + na_header_size,
+        coalesce_msg->buf_size - na_header_size, &hg_core_header);
+    hg_core_header_request_finalize(&hg_core_header);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode header");
 
-    return HG_SUCCESS;
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Sending coalesced message %p (%u requests, %zu bytes)",
+        (void *) coalesce_msg, coalesce_msg->count, coalesce_msg->buf_used);
+
+    return HG_TRUE;
 
 error:
-    if (context->handle_pool != NULL) {
-        (void) hg_core_handle_pool_unpost(
-            context->handle_pool, HG_CORE_CLEANUP_TIMEOUT);
-        hg_core_handle_pool_destroy(context->handle_pool);
-    }
-#ifdef NA_HAS_SM
-    if (context->sm_handle_pool != NULL) {
-        (void) hg_core_handle_pool_unpost(
-            context->sm_handle_pool, HG_CORE_CLEANUP_TIMEOUT);
-        hg_core_handle_pool_destroy(context->sm_handle_pool);
-    }
-#endif
-    if (hg_core_class->init_info.multi_recv)
-        hg_core_context_multi_recv_free(
-            context, hg_core_class->core_class.na_class);
+    hg_core_coalesce_send_error(coalesce_msg, ret);
 
-    return ret;
+    return HG_FALSE;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_unpost(
-    struct hg_core_private_context *context, unsigned int timeout_ms)
+static void
+hg_core_coalesce_send(struct hg_core_coalesce_msg *coalesce_msg)
+{
+    hg_return_t ret;
+    na_return_t na_ret;
+
+    if (!hg_core_coalesce_prepare(coalesce_msg))
+        return;
+
+    na_ret = NA_Msg_send_unexpected(coalesce_msg->na_class,
+        coalesce_msg->na_context, hg_core_coalesce_send_cb, coalesce_msg,
+        coalesce_msg->buf, coalesce_msg->buf_used, coalesce_msg->plugin_data,
+        coalesce_msg->na_addr, coalesce_msg->context_id,
+        coalesce_msg->handles[0]->tag, coalesce_msg->op_id);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret,
+        "Could not post send for coalesced requests (%s)",
+        NA_Error_to_string(na_ret));
+
+    return;
+
+error:
+    hg_core_coalesce_send_error(coalesce_msg, ret);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_coalesce_send_batch(
+    struct hg_core_coalesce_msg **coalesce_msgs, unsigned int count)
 {
-    struct hg_core_private_class *hg_core_class =
-        HG_CORE_CONTEXT_CLASS(context);
+    struct na_msg_send_info send_infos[HG_CORE_COALESCE_BATCH_MAX];
+    size_t posted_count = 0;
     hg_return_t ret;
+    na_return_t na_ret;
+    unsigned int i;
 
-    if (!hg_core_class->init_info.listen || !context->posted)
-        return HG_SUCCESS;
-
-    /* Prevent requests from being reposted as they complete */
-    hg_atomic_set32(&context->unposting, 1);
-
-    if (hg_core_class->init_info.multi_recv) {
-        ret = hg_core_context_multi_recv_unpost(context,
-            hg_core_class->core_class.na_class,
-            context->core_context.na_context, timeout_ms);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not unpost multi-recv operations");
+    if (count == 0)
+        return;
+    if (count == 1) {
+        hg_core_coalesce_send(coalesce_msgs[0]);
+        return;
     }
 
-    if (context->handle_pool != NULL) {
-        ret = hg_core_handle_pool_unpost(context->handle_pool, timeout_ms);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not unpost pool of handles");
+    for (i = 0; i < count; i++)
+        send_infos[i] =
+            (struct na_msg_send_info){.callback = hg_core_coalesce_send_cb,
+                .arg = coalesce_msgs[i],
+                .buf = coalesce_msgs[i]->buf,
+                .buf_size = coalesce_msgs[i]->buf_used,
+                .plugin_data = coalesce_msgs[i]->plugin_data,
+                .dest_addr = coalesce_msgs[i]->na_addr,
+                .op_id = coalesce_msgs[i]->op_id,
+                .tag = coalesce_msgs[i]->handles[0]->tag,
+                .dest_id = coalesce_msgs[i]->context_id};
+
+    na_ret = NA_Msg_send_batch(coalesce_msgs[0]->na_class,
+        coalesce_msgs[0]->na_context, NA_CB_SEND_UNEXPECTED, send_infos, count,
+        &posted_count);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret,
+        "Could not post sends for %u coalesced messages (%s)", count,
+        NA_Error_to_string(na_ret));
 
-        hg_core_handle_pool_destroy(context->handle_pool);
-        context->handle_pool = NULL;
-    }
+    return;
 
-#ifdef NA_HAS_SM
-    if (context->sm_handle_pool != NULL) {
-        ret = hg_core_handle_pool_unpost(context->sm_handle_pool, timeout_ms);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not unpost pool of handles");
+error:
+    /* Messages that were posted complete through their callback */
+    for (i = (unsigned int) posted_count; i < count; i++)
+        hg_core_coalesce_send_error(coalesce_msgs[i], ret);
+}
 
-        hg_core_handle_pool_destroy(context->sm_handle_pool);
-        context->sm_handle_pool = NULL;
-    }
-#endif
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_coalesce_send_error(
+    struct hg_core_coalesce_msg *coalesce_msg, hg_return_t ret)
+{
+    unsigned int i;
 
-    /* Wait on internal list */
-    ret =
-        hg_core_context_list_wait(context, &context->internal_list, timeout_ms);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not wait on handle list");
+    for (i = 0; i < coalesce_msg->count; i++)
+        hg_core_send_input_complete(
+            coalesce_msg->handles[i], (na_return_t) ret);
+    hg_core_coalesce_release(coalesce_msg);
+}
 
-    if (hg_core_class->init_info.multi_recv)
-        hg_core_context_multi_recv_free(
-            context, hg_core_class->core_class.na_class);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_coalesce_send_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_core_coalesce_msg *coalesce_msg =
+        (struct hg_core_coalesce_msg *) callback_info->arg;
+    unsigned int i;
 
-    context->posted = HG_FALSE;
+    for (i = 0; i < coalesce_msg->count; i++)
+        hg_core_send_input_complete(
+            coalesce_msg->handles[i], callback_info->ret);
 
-error:
-    return ret;
+    hg_core_coalesce_release(coalesce_msg);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_multi_recv_alloc(struct hg_core_private_context *context,
-    na_class_t *na_class, unsigned int request_count)
+static void
+hg_core_coalesce_release(struct hg_core_coalesce_msg *coalesce_msg)
 {
-    size_t unexpected_msg_size;
-    hg_return_t ret;
-    int i;
+    struct hg_core_coalesce *coalesce = &coalesce_msg->context->coalesce;
 
-    unexpected_msg_size = NA_Msg_get_max_unexpected_size(na_class);
-    HG_CHECK_SUBSYS_ERROR(ctx, unexpected_msg_size == 0, error, ret,
-        HG_INVALID_PARAM, "Invalid unexpected message size");
+    coalesce_msg->na_addr = NULL;
+    coalesce_msg->count = 0;
 
-    for (i = 0; i < HG_CORE_MULTI_RECV_OP_MAX; i++) {
-        struct hg_core_multi_recv_op *multi_recv_op =
-            &context->multi_recv_ops[i];
+    hg_thread_mutex_lock(&coalesce->mutex);
+    HG_LIST_INSERT_HEAD(&coalesce->free_list, coalesce_msg, entry);
+    hg_thread_mutex_unlock(&coalesce->mutex);
+}
 
-        multi_recv_op->op_id = NA_Op_create(na_class, NA_OP_MULTI);
-        HG_CHECK_SUBSYS_ERROR(ctx, multi_recv_op->op_id == NULL, error, ret,
-            HG_NOMEM, "Could not create new OP ID");
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_coalesce_msg_free(struct hg_core_coalesce_msg *coalesce_msg)
+{
+    if (coalesce_msg->buf != NULL)
+        NA_Msg_buf_free(coalesce_msg->na_class, coalesce_msg->buf,
+            coalesce_msg->plugin_data);
+    if (coalesce_msg->op_id != NULL)
+        NA_Op_destroy(coalesce_msg->na_class, coalesce_msg->op_id);
+    free(coalesce_msg->handles);
+    free(coalesce_msg);
+}
 
-        /* Keep total buffer size as max of unexpected msg size x number of
-         * "pre-posted" operations. */
-        multi_recv_op->buf_size = request_count * unexpected_msg_size;
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_uint64_t
+hg_core_timer_tick(const struct hg_core_timer_wheel *timer_wheel, hg_time_t t)
+{
+    double elapsed = hg_time_diff(t, timer_wheel->start);
 
-        multi_recv_op->buf = NA_Msg_buf_alloc(na_class, multi_recv_op->buf_size,
-            NA_MULTI_RECV, &multi_recv_op->plugin_data);
-        HG_CHECK_SUBSYS_ERROR(ctx, multi_recv_op->buf == NULL, error, ret,
-            HG_NOMEM, "Could not allocate multi-recv buffer of size %zu",
-            multi_recv_op->buf_size);
+    return (elapsed > 0.)
+               ? (hg_uint64_t) (elapsed * 1000.) / HG_CORE_TIMER_TICK_MS
+               : 0;
+}
 
-        hg_atomic_init32(&multi_recv_op->last, 0);
-        hg_atomic_init32(&multi_recv_op->ref_count, 0);
-        hg_atomic_init32(&multi_recv_op->op_count, 0);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_timer_add(
+    struct hg_core_private_handle *hg_core_handle, unsigned int timeout_ms)
+{
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_timer_wheel *timer_wheel = &context->timer_wheel;
+    hg_bool_t notify = HG_FALSE;
+    hg_uint64_t tick;
+
+    hg_time_get_current(&hg_core_handle->deadline);
+    hg_core_handle->deadline = hg_time_add(
+        hg_core_handle->deadline, hg_time_from_ms(timeout_ms));
+    tick = hg_core_timer_tick(timer_wheel, hg_core_handle->deadline);
+
+    hg_thread_spin_lock(&timer_wheel->lock);
+    /* Deadlines behind the last tick processed are visited on next pass */
+    if (tick < timer_wheel->tick)
+        tick = timer_wheel->tick;
+    HG_LIST_INSERT_HEAD(&timer_wheel->slots[tick % HG_CORE_TIMER_WHEEL_SIZE],
+        hg_core_handle, timer);
+    hg_core_handle->timed = HG_TRUE;
+    if (hg_atomic_incr32(&timer_wheel->count) == 1 ||
+        (timer_wheel->next_valid &&
+            hg_time_less(hg_core_handle->deadline, timer_wheel->next))) {
+        timer_wheel->next = hg_core_handle->deadline;
+        timer_wheel->next_valid = HG_TRUE;
+        notify = HG_TRUE;
     }
+    hg_thread_spin_unlock(&timer_wheel->lock);
 
-    return HG_SUCCESS;
+    /* Wake up progress so that it does not wait past the new deadline */
+    if (notify)
+        hg_core_loopback_signal(context);
+}
 
-error:
-    for (i = 0; i < HG_CORE_MULTI_RECV_OP_MAX; i++) {
-        struct hg_core_multi_recv_op *multi_recv_op =
-            &context->multi_recv_ops[i];
-        NA_Op_destroy(na_class, multi_recv_op->op_id);
-        multi_recv_op->op_id = NULL;
-        NA_Msg_buf_free(
-            na_class, multi_recv_op->buf, multi_recv_op->plugin_data);
-        multi_recv_op->buf = NULL;
-        multi_recv_op->plugin_data = NULL;
-        multi_recv_op->buf_size = 0;
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_timer_remove(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_timer_wheel *timer_wheel =
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->timer_wheel;
+
+    /* The earliest deadline is left as is, progress only wakes up once more
+     * than needed */
+    hg_thread_spin_lock(&timer_wheel->lock);
+    if (hg_core_handle->timed) {
+        HG_LIST_REMOVE(hg_core_handle, timer);
+        hg_core_handle->timed = HG_FALSE;
+        hg_atomic_decr32(&timer_wheel->count);
     }
-    return ret;
+    hg_thread_spin_unlock(&timer_wheel->lock);
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_core_context_multi_recv_free(
-    struct hg_core_private_context *context, na_class_t *na_class)
+static hg_bool_t
+hg_core_timer_expire(
+    struct hg_core_private_context *context, hg_time_t *deadline_p)
 {
-    int i;
+    struct hg_core_timer_wheel *timer_wheel = &context->timer_wheel;
+    HG_LIST_HEAD(hg_core_private_handle) expired_list;
+    struct hg_core_private_handle *hg_core_handle;
+    hg_uint64_t tick, now_tick;
+    hg_bool_t pending;
+    hg_time_t now;
 
-    for (i = 0; i < HG_CORE_MULTI_RECV_OP_MAX; i++) {
-        struct hg_core_multi_recv_op *multi_recv_op =
-            &context->multi_recv_ops[i];
+    if (hg_atomic_get32(&timer_wheel->count) == 0)
+        return HG_FALSE;
 
-        HG_CHECK_SUBSYS_WARNING(ctx,
-            hg_atomic_get32(&multi_recv_op->ref_count) != 0,
-            "Freeing multi-recv operation that is still being referenced "
-            "(%" PRId32 ")",
-            hg_atomic_get32(&multi_recv_op->ref_count));
+    HG_LIST_INIT(&expired_list);
+    hg_time_get_current(&now);
 
-        NA_Op_destroy(na_class, multi_recv_op->op_id);
-        multi_recv_op->op_id = NULL;
-        NA_Msg_buf_free(
-            na_class, multi_recv_op->buf, multi_recv_op->plugin_data);
-        multi_recv_op->buf = NULL;
-        multi_recv_op->plugin_data = NULL;
-        multi_recv_op->buf_size = 0;
+    hg_thread_spin_lock(&timer_wheel->lock);
+
+    /* Nothing to visit before the earliest deadline */
+    if (timer_wheel->next_valid && hg_time_less(now, timer_wheel->next)) {
+        if (deadline_p != NULL)
+            *deadline_p = timer_wheel->next;
+        hg_thread_spin_unlock(&timer_wheel->lock);
+        return HG_TRUE;
+    }
+
+    /* Visit slots of ticks elapsed since last pass (at most one revolution),
+     * keep a reference to expired handles so that they cannot be released
+     * while they are canceled */
+    now_tick = hg_core_timer_tick(timer_wheel, now);
+    tick = (now_tick - timer_wheel->tick >= HG_CORE_TIMER_WHEEL_SIZE)
+               ? now_tick - HG_CORE_TIMER_WHEEL_SIZE + 1
+               : timer_wheel->tick;
+    for (; tick <= now_tick; tick++) {
+        hg_core_handle = HG_LIST_FIRST(
+            &timer_wheel->slots[tick % HG_CORE_TIMER_WHEEL_SIZE]);
+        while (hg_core_handle != NULL) {
+            struct hg_core_private_handle *next =
+                HG_LIST_NEXT(hg_core_handle, timer);
+
+            if (!hg_time_less(now, hg_core_handle->deadline)) {
+                HG_LIST_REMOVE(hg_core_handle, timer);
+                hg_core_handle->timed = HG_FALSE;
+                hg_atomic_decr32(&timer_wheel->count);
+                hg_core_handle_ref_incr(hg_core_handle);
+                HG_LIST_INSERT_HEAD(&expired_list, hg_core_handle, timer);
+            }
+            hg_core_handle = next;
+        }
+    }
+    timer_wheel->tick = now_tick;
+
+    /* Find earliest deadline from the first slot that has a deadline within
+     * the next revolution, otherwise check again after one revolution */
+    pending = (hg_atomic_get32(&timer_wheel->count) > 0);
+    timer_wheel->next_valid = pending;
+    if (pending) {
+        hg_bool_t found = HG_FALSE;
+
+        for (tick = now_tick;
+             !found && tick < now_tick + HG_CORE_TIMER_WHEEL_SIZE; tick++) {
+            HG_LIST_FOREACH (hg_core_handle,
+                &timer_wheel->slots[tick % HG_CORE_TIMER_WHEEL_SIZE], timer) {
+                if (hg_core_timer_tick(timer_wheel, hg_core_handle->deadline) ==
+                        tick &&
+                    (!found ||
+                        hg_time_less(
+                            hg_core_handle->deadline, timer_wheel->next))) {
+                    timer_wheel->next = hg_core_handle->deadline;
+                    found = HG_TRUE;
+                }
+            }
+        }
+        if (!found)
+            timer_wheel->next = hg_time_add(now,
+                hg_time_from_ms(
+                    HG_CORE_TIMER_WHEEL_SIZE * HG_CORE_TIMER_TICK_MS));
+        if (deadline_p != NULL)
+            *deadline_p = timer_wheel->next;
+    }
+
+    hg_thread_spin_unlock(&timer_wheel->lock);
+
+    while ((hg_core_handle = HG_LIST_FIRST(&expired_list)) != NULL) {
+        hg_return_t ret;
+
+        HG_LIST_REMOVE(hg_core_handle, timer);
+
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "Handle (%p) reached its deadline", (void *) hg_core_handle);
+
+        /* Report timeout instead of cancelation */
+        ret = hg_core_cancel(hg_core_handle, HG_TIMEOUT);
+        if (ret != HG_SUCCESS)
+            HG_LOG_SUBSYS_ERROR(rpc, "Could not cancel expired handle (%p)",
+                (void *) hg_core_handle);
+
+        (void) hg_core_destroy(hg_core_handle);
     }
+
+    return pending;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_multi_recv_post(struct hg_core_private_context *context,
-    na_class_t *na_class, na_context_t *na_context)
+static void
+hg_core_peer_error_cb(
+    na_class_t *na_class, na_addr_t *na_addr, na_return_t error, void *arg)
 {
-    hg_return_t ret;
-    int i;
+    struct hg_core_private_class *hg_core_class =
+        (struct hg_core_private_class *) arg;
+    struct hg_core_peer_errors *peer_errors = &hg_core_class->peer_errors;
+    struct hg_core_dead_peer *dead_peer;
+    na_return_t na_ret;
 
-    /* Ensure we have enough recvs pre-posted so that handles can be re-assigned
-     * a new buffer until the previous buffer can be safely re-used once it's
-     * consumed. */
-    for (i = 0; i < HG_CORE_MULTI_RECV_OP_MAX; i++) {
-        struct hg_core_multi_recv_op *multi_recv_op =
-            &context->multi_recv_ops[i];
+    /* Called from NA progress, defer purge to HG progress */
+    dead_peer = (struct hg_core_dead_peer *) malloc(sizeof(*dead_peer));
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        addr, dead_peer == NULL, error, "Could not allocate dead peer entry");
+    dead_peer->na_class = na_class;
+    dead_peer->ret = (hg_return_t) error;
 
-        multi_recv_op->id = i;
+    na_ret = NA_Addr_dup(na_class, na_addr, &dead_peer->na_addr);
+    HG_CHECK_SUBSYS_ERROR_NORET(addr, na_ret != NA_SUCCESS, error,
+        "Could not duplicate NA addr (%s)", NA_Error_to_string(na_ret));
 
-        ret = hg_core_post_multi(multi_recv_op, na_class, na_context);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not post multi-recv buffer %d", i);
-    }
-    hg_atomic_init32(&context->multi_recv_op_count, HG_CORE_MULTI_RECV_OP_MAX);
+    HG_LOG_SUBSYS_DEBUG(addr, "Peer (%p) reported as unreachable (%s)",
+        (void *) na_addr, NA_Error_to_string(error));
 
-    return HG_SUCCESS;
+    hg_thread_spin_lock(&peer_errors->lock);
+    HG_QUEUE_PUSH_TAIL(&peer_errors->queue, dead_peer, entry);
+    hg_atomic_incr32(&peer_errors->count);
+    hg_thread_spin_unlock(&peer_errors->lock);
+
+    return;
 
 error:
-    return ret;
+    free(dead_peer);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_multi_recv_unpost(struct hg_core_private_context *context,
-    na_class_t *na_class, na_context_t *na_context, unsigned int timeout_ms)
+static void
+hg_core_peer_error_process(struct hg_core_private_class *hg_core_class)
 {
-    hg_return_t ret;
-    int i;
+    struct hg_core_peer_errors *peer_errors = &hg_core_class->peer_errors;
 
-    for (i = 0; i < HG_CORE_MULTI_RECV_OP_MAX; i++) {
-        struct hg_core_multi_recv_op *multi_recv_op =
-            &context->multi_recv_ops[i];
-        na_return_t na_ret;
+    while (hg_atomic_get32(&peer_errors->count) > 0) {
+        struct hg_core_dead_peer *dead_peer;
+        struct hg_core_private_addr *hg_core_addr = NULL;
+        unsigned int HG_DEBUG_LOG_USED purged;
 
-        na_ret = NA_Cancel(na_class, na_context, multi_recv_op->op_id);
-        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "NA_Cancel() of multi-recv op failed (%s)",
-            NA_Error_to_string(na_ret));
-    }
+        hg_thread_spin_lock(&peer_errors->lock);
+        dead_peer = HG_QUEUE_FIRST(&peer_errors->queue);
+        if (dead_peer != NULL) {
+            HG_QUEUE_POP_HEAD(&peer_errors->queue, entry);
+            hg_atomic_decr32(&peer_errors->count);
+        }
+        hg_thread_spin_unlock(&peer_errors->lock);
+        if (dead_peer == NULL)
+            break;
 
-    for (;;) {
-        unsigned int actual_count = 0;
+        purged = hg_core_peer_purge(
+            hg_core_class, dead_peer->na_class, dead_peer->na_addr);
+        HG_LOG_SUBSYS_DEBUG(addr, "Failed %u pending RPCs to peer (%p)", purged,
+            (void *) dead_peer->na_addr);
 
-        /* Trigger everything we can from HG */
-        do {
-            ret = hg_core_trigger(context, 0, 1, &actual_count);
-        } while (ret == HG_SUCCESS && actual_count > 0);
-        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
-            error, "Could not trigger entry");
+        /* Pass an HG addr that wraps the NA addr to the user */
+        if (peer_errors->callback != NULL &&
+            hg_core_addr_create(hg_core_class, &hg_core_addr) == HG_SUCCESS) {
+#ifdef NA_HAS_SM
+            if (dead_peer->na_class == hg_core_class->core_class.na_sm_class)
+                hg_core_addr->core_addr.na_sm_addr = dead_peer->na_addr;
+            else
+#endif
+                hg_core_addr->core_addr.na_addr = dead_peer->na_addr;
+            dead_peer->na_addr = NULL;
 
-        if (hg_atomic_get32(&context->multi_recv_op_count) == 0)
-            break;
+            peer_errors->callback((hg_core_addr_t) hg_core_addr,
+                dead_peer->ret, peer_errors->arg);
+            hg_core_addr_free(hg_core_addr);
+        }
 
-        ret = hg_core_progress(context, timeout_ms);
-        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
-            error, "Could not make progress");
+        if (dead_peer->na_addr != NULL)
+            NA_Addr_free(dead_peer->na_class, dead_peer->na_addr);
+        free(dead_peer);
     }
-
-    return HG_SUCCESS;
-
-error:
-    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_context_check_handle_list(struct hg_core_handle_list *handle_list)
+static unsigned int
+hg_core_peer_purge(struct hg_core_private_class *hg_core_class,
+    na_class_t *na_class, na_addr_t *na_addr)
 {
-    struct hg_core_private_handle *hg_core_handle = NULL;
-    hg_return_t ret;
+    struct hg_core_peer_errors *peer_errors = &hg_core_class->peer_errors;
+    struct hg_core_private_context *context;
+    unsigned int purged = 0;
+
+    hg_thread_mutex_lock(&peer_errors->mutex);
+    HG_LIST_FOREACH (context, &peer_errors->contexts, entry) {
+        struct hg_core_private_handle **handles, *hg_core_handle;
+        unsigned int max, count = 0, i;
+
+        /* Handles created after that point target a peer that is known to be
+         * dead and are not tracked */
+        max = (unsigned int) hg_atomic_get32(&context->n_handles);
+        if (max == 0)
+            continue;
+        handles = (struct hg_core_private_handle **) malloc(
+            max * sizeof(*handles));
+        HG_CHECK_SUBSYS_ERROR_NORET(addr, handles == NULL, done,
+            "Could not allocate array of %u handles", max);
+
+        /* Keep a reference to forwards still pending to that peer so that
+         * they cannot be released while they are canceled */
+        hg_core_handle_list_lock(&context->user_list);
+        HG_LIST_FOREACH (hg_core_handle, &context->user_list.list, created) {
+            int32_t status = hg_atomic_get32(&hg_core_handle->status);
+
+            if (count == max)
+                break;
+            if (hg_core_handle->is_self ||
+                hg_core_handle->op_type != HG_CORE_FORWARD ||
+                !(status & HG_CORE_OP_POSTED) ||
+                (status & (HG_CORE_OP_COMPLETED | HG_CORE_OP_CANCELED |
+                              HG_CORE_OP_ERRORED)) ||
+                hg_core_handle->na_class != na_class ||
+                hg_core_handle->na_addr == NULL ||
+                (hg_core_handle->na_addr != na_addr &&
+                    !NA_Addr_cmp(na_class, hg_core_handle->na_addr, na_addr)))
+                continue;
+            hg_core_handle_ref_incr(hg_core_handle);
+            handles[count++] = hg_core_handle;
+        }
+        hg_core_handle_list_unlock(&context->user_list);
 
-    hg_thread_spin_lock(&handle_list->lock);
+        for (i = 0; i < count; i++) {
+            hg_core_handle = handles[i];
 
-    if (HG_LIST_IS_EMPTY(&handle_list->list))
-        HG_GOTO_DONE(unlock, ret, HG_SUCCESS);
+            HG_LOG_SUBSYS_DEBUG(rpc, "Handle (%p) targets unreachable peer",
+                (void *) hg_core_handle);
 
-    HG_LIST_FOREACH (hg_core_handle, &handle_list->list, created) {
-        /* TODO ideally we'd want the upper layer to print that */
-        if (hg_core_handle->core_handle.data)
-            HG_LOG_SUBSYS_ERROR(ctx, "Handle (%p) was not destroyed",
-                hg_core_handle->core_handle.data);
-        HG_LOG_SUBSYS_DEBUG(
-            ctx, "Core handle (%p) was not destroyed", (void *) hg_core_handle);
+            /* Report unreachable peer instead of cancelation */
+            if (hg_core_cancel(hg_core_handle, HG_HOSTUNREACH) != HG_SUCCESS)
+                HG_LOG_SUBSYS_ERROR(rpc,
+                    "Could not cancel handle (%p) to unreachable peer",
+                    (void *) hg_core_handle);
+            else
+                purged++;
+
+            (void) hg_core_destroy(hg_core_handle);
+        }
+        free(handles);
     }
-    ret = HG_BUSY;
 
-unlock:
-    hg_thread_spin_unlock(&handle_list->lock);
+done:
+    hg_thread_mutex_unlock(&peer_errors->mutex);
 
-    return ret;
+    return purged;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_context_list_wait(struct hg_core_private_context *context,
-    struct hg_core_handle_list *handle_list, unsigned int timeout_ms)
+hg_core_respond(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size,
+    hg_return_t ret_code, struct hg_core_respond_batch *batch)
 {
-    bool list_empty = false;
-    hg_time_t deadline, now = hg_time_from_ms(0);
-    hg_return_t ret;
+    struct hg_peer_stats *peer_stats;
+    hg_size_t header_size;
+    hg_return_t ret = HG_SUCCESS;
 
-    if (timeout_ms != 0)
-        hg_time_get_current_ms(&now);
-    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
+    /* Cannot respond if no_response flag set */
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->no_response, done, ret,
+        HG_OPNOTSUPPORTED, "Sending response was disabled on that RPC");
 
-    /* Make first progress pass without waiting to empty trigger queues */
-    ret = hg_core_progress(context, 0);
-    HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
-        error, "Could not make progress");
+    /* Final response of a stream is only sent once the partial response
+     * before it completed and must fit in the output buffer */
+    if (hg_core_handle->stream_credits > 0) {
+        HG_CHECK_SUBSYS_ERROR(rpc, flags & HG_CORE_MORE_DATA, done, ret,
+            HG_MSGSIZE, "Final response of a stream exceeds output buffer");
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            hg_core_handle->stream != NULL && hg_core_handle->stream->busy,
+            done, ret, HG_BUSY, "Partial response has not completed");
+    }
+
+    /* Reset handle ret */
+    hg_core_handle->ret = HG_SUCCESS;
+
+    /* Reset status */
+    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_COMPLETED);
+    hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) hg_core_handle->ret);
+
+    /* Set header size */
+    header_size = hg_core_header_response_get_size() +
+                  hg_core_handle->core_handle.na_out_header_offset;
+
+    /* Set the actual size of the msg that needs to be transmitted */
+    hg_core_handle->out_buf_used = header_size + payload_size;
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        hg_core_handle->out_buf_used > hg_core_handle->core_handle.out_buf_size,
+        error, ret, HG_MSGSIZE, "Exceeding output buffer size");
+
+    /* Output buffer of posted handles is allocated on first response */
+    if (hg_core_handle->core_handle.out_buf == NULL) {
+        ret = hg_core_alloc_output(hg_core_handle, NA_SEND);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate output buffer");
+    }
+
+    /* Set callback, keep request and response callbacks separate so that
+     * they do not get overwritten when forwarding to ourself */
+    hg_core_handle->response_callback = callback;
+    hg_core_handle->response_arg = arg;
 
-    for (;;) {
-        unsigned int actual_count = 0;
+    /* Set header */
+    hg_core_handle->out_header.msg.response.ret_code = (hg_int8_t) ret_code;
+    hg_core_handle->out_header.msg.response.flags = flags;
+    hg_core_handle->out_header.msg.response.cookie = hg_core_handle->cookie;
 
-        /* Trigger everything we can from HG */
-        do {
-            ret = hg_core_trigger(context, 0, 1, &actual_count);
-        } while (ret == HG_SUCCESS && actual_count > 0);
-        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
-            error, "Could not trigger entry");
+    /* Encode response header */
+    ret = hg_core_proc_header_response(
+        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_ENCODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode header");
 
-        /* Make progress until list is empty */
-        hg_thread_spin_lock(&handle_list->lock);
-        list_empty = HG_LIST_IS_EMPTY(&handle_list->list);
-        hg_thread_spin_unlock(&handle_list->lock);
-        if (list_empty)
-            break;
+    /* Stats */
+    if (hg_core_handle->handler_start != 0) {
+        struct hg_core_private_rpc_info *hg_core_rpc_info =
+            (struct hg_core_private_rpc_info *)
+                hg_core_handle->core_handle.rpc_info;
 
-        /* Gives a chance to always call trigger after progress */
-        if (timeout_ms != 0)
-            hg_time_get_current_ms(&now);
-        if (!hg_time_less(now, deadline))
-            break;
+        hg_uint64_t now = hg_time_get_cycles();
 
-        ret = hg_core_progress(
-            context, hg_time_to_ms(hg_time_subtract(deadline, now)));
-        HG_CHECK_SUBSYS_ERROR_NORET(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
-            error, "Could not make progress");
+        hg_core_histogram_record_time(&hg_core_rpc_info->handler,
+            hg_core_handle->handler_start, now);
+        hg_core_histogram_record(&hg_core_rpc_info->payload, payload_size);
+        if (unlikely(HG_CORE_HANDLE_CLASS(hg_core_handle)->capture.file))
+            hg_core_capture(hg_core_handle, payload_size, now);
+        hg_core_handle->handler_start = 0;
+    }
+    peer_stats = hg_core_peer_lock_handle(hg_core_handle);
+    if (peer_stats != NULL) {
+        peer_stats->bytes_out += hg_core_handle->out_buf_used;
+        hg_core_peer_unlock(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
     }
+    HG_CORE_TRACE_EVENT(hg_core_handle, HG_TRACE_RESPOND);
 
-    HG_LOG_SUBSYS_DEBUG(ctx, "List empty: %d (timeout=%u ms)", list_empty,
-        hg_time_to_ms(hg_time_subtract(deadline, now)));
+    /* If addr is self, forward locally, otherwise send the encoded buffer
+     * through NA and pre-post response */
+    if (batch != NULL && hg_core_handle->ops.respond == hg_core_respond_na)
+        ret = hg_core_respond_na_batch(hg_core_handle, batch);
+    else
+        ret = hg_core_handle->ops.respond(hg_core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not respond");
 
-    return HG_SUCCESS;
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+    /* Increment counter */
+    hg_atomic_incr64(
+        HG_CORE_HANDLE_CLASS(hg_core_handle)->counters.rpc_resp_sent_count);
+#endif
+
+done:
+    return ret;
 
 error:
+    /* Handle is no longer in use */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+
+    /* Decrement refcount on handle */
+    hg_core_handle_ref_decr(hg_core_handle);
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-struct hg_bulk_op_pool *
-hg_core_context_get_bulk_op_pool(struct hg_core_context *core_context)
+static HG_INLINE hg_return_t
+hg_core_respond_self(struct hg_core_private_handle *hg_core_handle)
 {
-    return ((struct hg_core_private_context *) core_context)->hg_bulk_op_pool;
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_RESPOND_SELF;
+
+    /* Increment number of expected operations */
+    hg_atomic_incr32(&hg_core_handle->op_expected_count);
+
+    /* Complete and add to completion queue */
+    hg_core_complete_op(hg_core_handle);
+
+    return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_handle_pool_create(struct hg_core_private_context *context,
-    na_class_t *na_class, na_context_t *na_context, unsigned long flags,
-    unsigned int init_count, unsigned int incr_count,
-    struct hg_core_handle_pool **hg_core_handle_pool_p)
+static HG_INLINE hg_return_t
+hg_core_no_respond_self(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_handle_pool *hg_core_handle_pool = NULL;
-    hg_bool_t pending_list_lock_init = HG_FALSE, extend_mutex_init = HG_FALSE,
-              extend_cond_init = HG_FALSE;
-    hg_return_t ret;
-    unsigned int i;
-    int rc;
-
-    HG_LOG_SUBSYS_DEBUG(ctx,
-        "Creating pool of handles (init_count=%u, incr_count=%u)", init_count,
-        init_count);
-
-    hg_core_handle_pool =
-        (struct hg_core_handle_pool *) calloc(1, sizeof(*hg_core_handle_pool));
-    HG_CHECK_SUBSYS_ERROR(ctx, hg_core_handle_pool == NULL, error, ret,
-        HG_NOMEM, "Could not allocate handle pool");
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
 
-    HG_LIST_INIT(&hg_core_handle_pool->pending_list.list);
-    rc = hg_thread_spin_init(&hg_core_handle_pool->pending_list.lock);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_spin_init() failed");
-    pending_list_lock_init = HG_TRUE;
+    /* Increment number of expected operations */
+    hg_atomic_incr32(&hg_core_handle->op_expected_count);
 
-    rc = hg_thread_mutex_init(&hg_core_handle_pool->extend_mutex);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_mutex_init() failed");
-    extend_mutex_init = HG_TRUE;
-    hg_thread_cond_init(&hg_core_handle_pool->extend_cond);
-    HG_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, HG_NOMEM,
-        "hg_thread_cond_init() failed");
-    extend_cond_init = HG_TRUE;
+    /* Complete and add to completion queue */
+    hg_core_complete_op(hg_core_handle);
 
-    hg_core_handle_pool->count = init_count;
-    hg_core_handle_pool->incr_count = incr_count;
-    hg_core_handle_pool->extending = HG_FALSE;
-    hg_core_handle_pool->context = context;
-    hg_core_handle_pool->na_class = na_class;
-    hg_core_handle_pool->na_context = na_context;
-    hg_core_handle_pool->flags = flags;
+    return HG_SUCCESS;
+}
 
-    for (i = 0; i < init_count; i++) {
-        ret = hg_core_handle_pool_insert(
-            context, na_class, na_context, flags, hg_core_handle_pool);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not insert handle %u into pool", i);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_respond_batch_post(struct hg_core_respond_batch *batch)
+{
+    unsigned int i, j, start;
+
+    /* Group sends by NA context and destination, the order of responses to
+     * different origins does not matter */
+    for (i = 1; i < batch->count; i++) {
+        struct na_msg_send_info send_info = batch->send_infos[i];
+        na_class_t *na_class = batch->na_classes[i];
+        na_context_t *na_context = batch->na_contexts[i];
+
+        for (j = i; j > 0; j--) {
+            if ((uintptr_t) batch->na_contexts[j - 1] <
+                    (uintptr_t) na_context ||
+                (batch->na_contexts[j - 1] == na_context &&
+                    (uintptr_t) batch->send_infos[j - 1].dest_addr <=
+                        (uintptr_t) send_info.dest_addr))
+                break;
+            batch->send_infos[j] = batch->send_infos[j - 1];
+            batch->na_classes[j] = batch->na_classes[j - 1];
+            batch->na_contexts[j] = batch->na_contexts[j - 1];
+        }
+        batch->send_infos[j] = send_info;
+        batch->na_classes[j] = na_class;
+        batch->na_contexts[j] = na_context;
     }
 
-    HG_LOG_SUBSYS_DEBUG(
-        ctx, "Created handle pool (%p)", (void *) hg_core_handle_pool);
-
-    *hg_core_handle_pool_p = hg_core_handle_pool;
-
-    return HG_SUCCESS;
-
-error:
-    if (hg_core_handle_pool != NULL) {
-        struct hg_core_private_handle *hg_core_handle;
+    for (start = 0; start < batch->count; start = i) {
+        size_t posted_count = 0;
+        na_return_t na_ret;
 
-        hg_core_handle = HG_LIST_FIRST(&hg_core_handle_pool->pending_list.list);
-        while (hg_core_handle) {
-            struct hg_core_private_handle *hg_core_handle_next =
-                HG_LIST_NEXT(hg_core_handle, pending);
-            HG_LIST_REMOVE(hg_core_handle, pending);
+        for (i = start + 1; i < batch->count &&
+                            batch->na_contexts[i] == batch->na_contexts[start];
+             i++)
+            continue;
+
+        na_ret = NA_Msg_send_batch(batch->na_classes[start],
+            batch->na_contexts[start], NA_CB_SEND_EXPECTED,
+            &batch->send_infos[start], i - start, &posted_count);
+        if (na_ret != NA_SUCCESS) {
+            HG_LOG_SUBSYS_ERROR(rpc,
+                "Could not post sends for %u output buffers (%s)", i - start,
+                NA_Error_to_string(na_ret));
 
-            /* Prevent re-initialization */
-            hg_core_handle->reuse = HG_FALSE;
+            /* Responses that were not posted complete with the error */
+            for (j = start + (unsigned int) posted_count; j < i; j++) {
+                struct na_cb_info callback_info = {
+                    .arg = batch->send_infos[j].arg,
+                    .type = NA_CB_SEND_EXPECTED,
+                    .ret = na_ret};
 
-            /* Destroy handle */
-            (void) hg_core_destroy(hg_core_handle);
-            hg_core_handle = hg_core_handle_next;
+                hg_core_send_output_cb(&callback_info);
+            }
         }
+    }
 
-        if (pending_list_lock_init)
-            (void) hg_thread_spin_destroy(
-                &hg_core_handle_pool->pending_list.lock);
-        if (extend_mutex_init)
-            (void) hg_thread_mutex_destroy(&hg_core_handle_pool->extend_mutex);
-        if (extend_cond_init)
-            (void) hg_thread_cond_destroy(&hg_core_handle_pool->extend_cond);
+    batch->count = 0;
+}
 
-        free(hg_core_handle_pool);
-    }
-    return ret;
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_respond_na(struct hg_core_private_handle *hg_core_handle)
+{
+    return hg_core_respond_na_batch(hg_core_handle, NULL);
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_core_handle_pool_destroy(struct hg_core_handle_pool *hg_core_handle_pool)
+static hg_return_t
+hg_core_respond_na_batch(struct hg_core_private_handle *hg_core_handle,
+    struct hg_core_respond_batch *batch)
 {
-    struct hg_core_private_handle *hg_core_handle = NULL;
+    hg_return_t ret;
+    na_return_t na_ret;
+    hg_bool_t ack_recv_posted = HG_FALSE;
 
-    HG_LOG_DEBUG("Free handle pool (%p)", (void *) hg_core_handle_pool);
+    /* Increment number of expected operations */
+    hg_atomic_incr32(&hg_core_handle->op_expected_count);
 
-    hg_thread_spin_lock(&hg_core_handle_pool->pending_list.lock);
-    hg_core_handle = HG_LIST_FIRST(&hg_core_handle_pool->pending_list.list);
-    while (hg_core_handle) {
-        struct hg_core_private_handle *hg_core_handle_next =
-            HG_LIST_NEXT(hg_core_handle, pending);
-        HG_LIST_REMOVE(hg_core_handle, pending);
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_RESPOND;
 
-        /* Prevent re-initialization */
-        hg_core_handle->reuse = HG_FALSE;
+    /* More data on output requires an ack once it is processed */
+    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_MORE_DATA) {
+        size_t buf_size = hg_core_handle->core_handle.na_out_header_offset +
+                          sizeof(hg_uint8_t);
 
-        /* Destroy handle */
-        (void) hg_core_destroy(hg_core_handle);
-        hg_core_handle = hg_core_handle_next;
+        /* Keep ack resources allocated if we are prone to using them */
+        if (hg_core_handle->ack == NULL) {
+            ret = hg_core_alloc_ack(hg_core_handle, NA_RECV);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                rpc, error, ret, "Could not allocate ack resources");
+        }
+
+        /* Increment number of expected operations */
+        hg_atomic_incr32(&hg_core_handle->op_expected_count);
+
+        /* Pre-post recv (ack) if more data is expected */
+        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_ack_cb, hg_core_handle,
+            hg_core_handle->ack->buf, buf_size,
+            hg_core_handle->ack->buf_plugin_data, hg_core_handle->na_addr,
+            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+            hg_core_handle->ack->na_op_id);
+        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not post recv for ack buffer (%s)",
+            NA_Error_to_string(na_ret));
+        ack_recv_posted = HG_TRUE;
+
+        /* Next request from origin may release extra data instead of ack */
+        hg_core_lease_grant(hg_core_handle);
     }
-    hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
 
-    (void) hg_thread_mutex_destroy(&hg_core_handle_pool->extend_mutex);
-    (void) hg_thread_cond_destroy(&hg_core_handle_pool->extend_cond);
-    (void) hg_thread_spin_destroy(&hg_core_handle_pool->pending_list.lock);
+    /* Mark handle as posted */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
 
-    free(hg_core_handle_pool);
-}
+    /* Final response of a stream waits for a credit */
+    if (hg_core_handle->stream != NULL && hg_core_handle->stream_credits > 0 &&
+        !hg_core_stream_respond(hg_core_handle))
+        return HG_SUCCESS;
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE hg_bool_t
-hg_core_handle_pool_empty(struct hg_core_handle_pool *hg_core_handle_pool)
-{
-    hg_bool_t ret;
+    /* Origin did not pre-post a recv, send output as unexpected message */
+    if (hg_core_handle->unexpected_response) {
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            hg_core_handle->out_buf_used >
+                NA_Msg_get_max_unexpected_size(hg_core_handle->na_class),
+            error, ret, HG_MSGSIZE,
+            "Output exceeds max unexpected size (%zu)",
+            hg_core_handle->out_buf_used);
+
+        na_ret = NA_Msg_send_unexpected(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_send_output_cb, hg_core_handle,
+            hg_core_handle->core_handle.out_buf, hg_core_handle->out_buf_used,
+            hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
+            hg_core_handle->core_handle.info.context_id,
+            hg_core_handle->tag | HG_CORE_RESPONSE_TAG,
+            hg_core_handle->na_send_op_id);
+    } else if (batch != NULL) {
+        /* Expected send is posted along with other responses */
+        batch->send_infos[batch->count] =
+            (struct na_msg_send_info){.callback = hg_core_send_output_cb,
+                .arg = hg_core_handle,
+                .buf = hg_core_handle->core_handle.out_buf,
+                .buf_size = hg_core_handle->out_buf_used,
+                .plugin_data = hg_core_handle->out_buf_plugin_data,
+                .dest_addr = hg_core_handle->na_addr,
+                .op_id = hg_core_handle->na_send_op_id,
+                .tag = hg_core_handle->tag,
+                .dest_id = hg_core_handle->core_handle.info.context_id};
+        batch->na_classes[batch->count] = hg_core_handle->na_class;
+        batch->na_contexts[batch->count] = hg_core_handle->na_context;
+        batch->count++;
 
-    hg_thread_spin_lock(&hg_core_handle_pool->pending_list.lock);
-    ret = HG_LIST_IS_EMPTY(&hg_core_handle_pool->pending_list.list);
-    hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
+        return HG_SUCCESS;
+    } else
+        /* Post expected send (output) */
+        na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_send_output_cb, hg_core_handle,
+            hg_core_handle->core_handle.out_buf, hg_core_handle->out_buf_used,
+            hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
+            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+            hg_core_handle->na_send_op_id);
+    /* Expected sends should always succeed after retry */
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not post send for output buffer (%s)",
+        NA_Error_to_string(na_ret));
 
-    return ret;
-}
+    return HG_SUCCESS;
 
-/*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_handle_pool_get(struct hg_core_handle_pool *hg_core_handle_pool,
-    struct hg_core_private_handle **hg_core_handle_p)
-{
-    struct hg_core_private_handle *hg_core_handle;
-    hg_return_t ret;
+error:
+    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_POSTED);
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
 
-    do {
-        hg_thread_spin_lock(&hg_core_handle_pool->pending_list.lock);
-        hg_core_handle = HG_LIST_FIRST(&hg_core_handle_pool->pending_list.list);
-        if (hg_core_handle != NULL) {
-            HG_LIST_REMOVE(hg_core_handle, pending);
-            hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
-            break;
-        }
-        hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
+    if (ack_recv_posted) {
+        hg_atomic_decr32(&hg_core_handle->op_expected_count);
 
-        /* Grow pool when needed */
-        ret = hg_core_handle_pool_extend(hg_core_handle_pool);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, error, ret, "Could not extend pool of handles");
+        /* Keep error for return status */
+        hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) ret);
 
-    } while (hg_core_handle == NULL);
+        /* Mark op as canceled and let it complete */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
 
-    *hg_core_handle_p = hg_core_handle;
+        /* Cancel the above posted recv ack op */
+        na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
+            hg_core_handle->ack->na_op_id);
+        HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
+            "Could not cancel ack op id (%s)", NA_Error_to_string(na_ret));
 
-    return HG_SUCCESS;
+        /* Return success here but callback will return canceled */
+        return HG_SUCCESS;
+    } else
+        hg_core_free_ack(hg_core_handle);
 
-error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_handle_pool_extend(struct hg_core_handle_pool *hg_core_handle_pool)
+static HG_INLINE hg_return_t
+hg_core_no_respond_na(struct hg_core_private_handle *hg_core_handle)
 {
-    unsigned int i;
-    hg_return_t ret;
-
-    /* Create another batch of IDs if empty */
-    hg_thread_mutex_lock(&hg_core_handle_pool->extend_mutex);
-    if (hg_core_handle_pool->extending) {
-        hg_thread_cond_wait(&hg_core_handle_pool->extend_cond,
-            &hg_core_handle_pool->extend_mutex);
-        hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
-        return HG_SUCCESS;
-    }
-    hg_core_handle_pool->extending = HG_TRUE;
-    hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_NO_RESPOND;
 
-    /* Only a single thread can extend the pool */
-    for (i = 0; i < hg_core_handle_pool->incr_count; i++) {
-        ret = hg_core_handle_pool_insert(hg_core_handle_pool->context,
-            hg_core_handle_pool->na_class, hg_core_handle_pool->na_context,
-            hg_core_handle_pool->flags, hg_core_handle_pool);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            ctx, unlock, ret, "Could not insert handle %u into pool", i);
-    }
-    hg_core_handle_pool->count += hg_core_handle_pool->incr_count;
+    /* Increment number of expected operations */
+    hg_atomic_incr32(&hg_core_handle->op_expected_count);
 
-unlock:
-    hg_thread_mutex_lock(&hg_core_handle_pool->extend_mutex);
-    hg_core_handle_pool->extending = HG_FALSE;
-    hg_thread_cond_broadcast(&hg_core_handle_pool->extend_cond);
-    hg_thread_mutex_unlock(&hg_core_handle_pool->extend_mutex);
+    hg_core_complete_op(hg_core_handle);
 
-    return ret;
+    return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_handle_pool_insert(struct hg_core_private_context *context,
-    na_class_t *na_class, na_context_t *na_context, unsigned long flags,
-    struct hg_core_handle_pool *hg_core_handle_pool)
+static HG_INLINE void
+hg_core_send_input_cb(const struct na_cb_info *callback_info)
 {
-    struct hg_core_private_handle *hg_core_handle = NULL;
-    struct hg_core_private_addr *hg_core_addr = NULL;
-    hg_return_t ret;
-    hg_bool_t post = HG_FALSE;
+    hg_core_send_input_complete(
+        (struct hg_core_private_handle *) callback_info->arg,
+        callback_info->ret);
+}
 
-    /* Create new handle */
-    ret = hg_core_create(context, na_class, na_context, flags, &hg_core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        ctx, error, ret, "Could not create HG core handle");
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_send_input_complete(
+    struct hg_core_private_handle *hg_core_handle, na_return_t na_ret)
+{
+    /* Output lease carried by request is released once delivered */
+    if (hg_core_handle->lease != NULL)
+        hg_core_lease_sent(hg_core_handle, na_ret == NA_SUCCESS);
 
-    /* Reset status */
-    hg_atomic_set32(&hg_core_handle->status, 0);
-    hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS);
+    if (na_ret == NA_SUCCESS) {
+        HG_CORE_TRACE_EVENT(hg_core_handle, HG_TRACE_SEND_COMPLETE);
+    } else if (na_ret == NA_CANCELED) {
+        HG_CHECK_SUBSYS_WARNING(rpc,
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
 
-    /* Create new (empty) source addresses */
-    ret = hg_core_addr_create(HG_CORE_CONTEXT_CLASS(context), &hg_core_addr);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not create HG addr");
-    hg_core_handle->core_handle.info.addr = (hg_core_addr_t) hg_core_addr;
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) HG_CANCELED);
+    } else { /* All other errors */
+        int32_t status;
 
-    /* Re-use handle on completion */
-    hg_core_handle->reuse = HG_TRUE;
+        /* Mark handle as errored */
+        status = hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
 
-    /* Add handle to pending list */
-    hg_thread_spin_lock(&hg_core_handle_pool->pending_list.lock);
-    HG_LIST_INSERT_HEAD(
-        &hg_core_handle_pool->pending_list.list, hg_core_handle, pending);
-    hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
+        /* Keep first non-success ret status */
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) na_ret);
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(na_ret));
 
-    /* Handle is pre-posted only when muti-recv is off */
-    if (!(flags & HG_CORE_HANDLE_MULTI_RECV)) {
-        /* Handle will need to be posted */
-        post = HG_TRUE;
+        if (!(status & HG_CORE_OP_CANCELED) &&
+            hg_core_handle->unexpected_response) {
+            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
 
-        ret = hg_core_post(hg_core_handle);
-        HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not post handle (%p)",
-            (void *) hg_core_handle);
-    }
+            /* No recv was posted for response */
+            hg_core_response_cancel(hg_core_handle);
+        } else if (!(status & HG_CORE_OP_CANCELED) &&
+                   !hg_core_handle->no_response) {
+            na_return_t cancel_ret;
 
-    return HG_SUCCESS;
+            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
 
-error:
-    if (hg_core_handle != NULL) {
-        if (post) {
-            hg_thread_spin_lock(&hg_core_handle_pool->pending_list.lock);
-            HG_LIST_REMOVE(hg_core_handle, pending);
-            hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
+            /* Cancel posted recv for response */
+            cancel_ret = NA_Cancel(hg_core_handle->na_class,
+                hg_core_handle->na_context, hg_core_handle->na_recv_op_id);
+            HG_CHECK_SUBSYS_ERROR_DONE(rpc, cancel_ret != NA_SUCCESS,
+                "Could not cancel recv op id (%s)",
+                NA_Error_to_string(cancel_ret));
         }
-        hg_core_handle->reuse = HG_FALSE;
-        (void) hg_core_destroy(hg_core_handle);
     }
 
-    return ret;
+    hg_core_complete_op(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_handle_pool_unpost(
-    struct hg_core_handle_pool *hg_core_handle_pool, unsigned int timeout_ms)
+static void
+hg_core_recv_input_cb(const struct na_cb_info *callback_info)
 {
-    struct hg_core_private_handle *hg_core_handle;
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_handle_pool *hg_core_handle_pool;
+    const struct na_cb_info_recv_unexpected *na_cb_info_recv_unexpected =
+        &callback_info->info.recv_unexpected;
     hg_return_t ret;
 
-    if (hg_core_handle_pool->flags & HG_CORE_HANDLE_MULTI_RECV)
-        return HG_SUCCESS; /* Nothing to do */
+/* Remove handle from pending list */
+#ifdef NA_HAS_SM
+    hg_core_handle_pool = (hg_core_handle->na_class ==
+                              context->core_context.core_class->na_sm_class)
+                              ? context->sm_handle_pool
+                              : context->handle_pool;
+#else
+    hg_core_handle_pool = context->handle_pool;
+#endif
+    hg_core_handle_list_lock(&hg_core_handle_pool->pending_list);
+    HG_LIST_REMOVE(hg_core_handle, pending);
+    hg_core_handle_list_unlock(&hg_core_handle_pool->pending_list);
+    hg_atomic_decr32(&hg_core_handle_pool->available);
+    hg_core_handle->acquire_start = hg_time_get_cycles();
 
-    /* Check pending list and cancel posted handles */
-    hg_thread_spin_lock(&hg_core_handle_pool->pending_list.lock);
+    if (callback_info->ret == NA_SUCCESS) {
+        /* Extend pool if all handles are being utilized, otherwise let
+         * progress extend it once running low */
+        if (hg_core_handle_pool_capped(hg_core_handle_pool)) {
+            hg_core_handle_pool_check(hg_core_handle_pool);
+            if (hg_core_handle_pool_empty(hg_core_handle_pool) &&
+                hg_atomic_incr32(&hg_core_handle_pool->cap_count) == 1)
+                HG_LOG_SUBSYS_WARNING(perf,
+                    "Pre-posted handles have all been consumed and limit "
+                    "of posted handles was reached (%u), not posting more",
+                    hg_core_handle_pool->count);
+        } else if (hg_core_handle_pool_growable(hg_core_handle_pool) &&
+                   !hg_atomic_get32(&context->unposting) &&
+                   hg_core_handle_pool_empty(hg_core_handle_pool)) {
+            HG_LOG_SUBSYS_WARNING(perf,
+                "Pre-posted handles have all been consumed / are being "
+                "utilized, posting %u more",
+                hg_core_handle_pool->incr_count);
 
-    HG_LIST_FOREACH (
-        hg_core_handle, &hg_core_handle_pool->pending_list.list, pending) {
-        /* Cancel handle */
-        ret = hg_core_cancel(hg_core_handle);
-        HG_CHECK_SUBSYS_HG_ERROR(ctx, unlock, ret,
-            "Could not cancel handle (%p)", (void *) hg_core_handle);
-    }
+            ret = hg_core_handle_pool_extend(hg_core_handle_pool);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                rpc, error, ret, "Could not extend handle pool");
+        } else
+            hg_core_handle_pool_check(hg_core_handle_pool);
 
-    hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
+        /* Fill unexpected info */
+        hg_core_handle->na_addr = na_cb_info_recv_unexpected->source;
+#ifdef NA_HAS_SM
+        if (hg_core_handle->na_class ==
+            hg_core_handle->core_handle.info.core_class->na_sm_class) {
+            HG_LOG_SUBSYS_DEBUG(rpc, "Using NA SM class for this handle");
+            hg_core_handle->core_handle.info.addr->na_sm_addr =
+                hg_core_handle->na_addr;
+        } else
+#endif
+            hg_core_handle->core_handle.info.addr->na_addr =
+                hg_core_handle->na_addr;
+        hg_core_handle->tag = na_cb_info_recv_unexpected->tag;
+        HG_CHECK_SUBSYS_ERROR_NORET(rpc,
+            na_cb_info_recv_unexpected->actual_buf_size >
+                hg_core_handle->core_handle.in_buf_size,
+            error, "Actual transfer size is too large for unexpected recv");
+        hg_core_handle->in_buf_used =
+            na_cb_info_recv_unexpected->actual_buf_size;
 
-    /* Check that operations have completed */
-    ret = hg_core_context_list_wait(hg_core_handle_pool->context,
-        &hg_core_handle_pool->pending_list, timeout_ms);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        ctx, error, ret, "Could not wait on pool handle list");
+        /* Responses that were not pre-posted */
+        if (hg_core_handle->tag & HG_CORE_RESPONSE_TAG) {
+            hg_core_process_response(hg_core_handle);
+            return;
+        }
 
-    return HG_SUCCESS;
+        HG_LOG_SUBSYS_DEBUG(rpc,
+            "Processing input for handle %p, tag=%u, buf_size=%zu",
+            (void *) hg_core_handle, hg_core_handle->tag,
+            hg_core_handle->in_buf_used);
 
-unlock:
-    hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
+        /* Process input information */
+        ret = hg_core_process_input(hg_core_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process input");
 
-error:
-    return ret;
-}
+        /* Complete operation */
+        hg_core_complete_op(hg_core_handle);
+    } else if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_SUBSYS_WARNING(rpc,
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE unsigned int
-hg_core_map_hash(hg_hash_table_key_t key)
-{
-    return *((hg_id_t *) key) & 0xffffffff;
-}
+        /* Prevent re-initialization */
+        hg_core_handle->reuse = HG_FALSE;
+        hg_core_handle_pool_release(hg_core_handle_pool);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE int
-hg_core_map_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
-{
-    return *((hg_id_t *) key1) == *((hg_id_t *) key2);
+        /* Clean up handle */
+        (void) hg_core_destroy(hg_core_handle);
+    } else {
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
+
+        /* Prevent re-initialization */
+        hg_core_handle->reuse = HG_FALSE;
+        hg_core_handle_pool_release(hg_core_handle_pool);
+
+        /* Clean up handle */
+        (void) hg_core_destroy(hg_core_handle);
+    }
+
+    return;
+
+error:
+    /* Mark handle as errored */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    hg_atomic_cas32(
+        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+
+    /* Complete operation */
+    hg_core_complete_op(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
 static void
-hg_core_map_value_free(hg_hash_table_value_t value)
+hg_core_multi_recv_input_cb(const struct na_cb_info *callback_info)
 {
-    struct hg_core_rpc_info *hg_core_rpc_info =
-        (struct hg_core_rpc_info *) value;
+    struct hg_core_multi_recv_op *multi_recv_op =
+        (struct hg_core_multi_recv_op *) callback_info->arg;
+    struct hg_core_private_context *context = container_of(
+        multi_recv_op - multi_recv_op->id * (ptrdiff_t) sizeof(*multi_recv_op),
+        struct hg_core_private_context, multi_recv_ops);
+    const struct na_cb_info_multi_recv_unexpected
+        *na_cb_info_multi_recv_unexpected =
+            &callback_info->info.multi_recv_unexpected;
+    struct hg_core_private_handle *hg_core_handle = NULL;
+    hg_return_t ret;
+
+    if (callback_info->ret == NA_SUCCESS) {
+        /* Get a new handle from the pool */
+        ret = hg_core_handle_pool_get(context->handle_pool, &hg_core_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not get handle from pool");
+        hg_core_handle->multi_recv_op = multi_recv_op;
+        hg_atomic_incr32(&multi_recv_op->op_count);
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_MULTI_RECV);
 
-    if (hg_core_rpc_info->free_callback)
-        hg_core_rpc_info->free_callback(hg_core_rpc_info->data);
-    free(hg_core_rpc_info);
-}
+        if (na_cb_info_multi_recv_unexpected->last) {
+            HG_LOG_SUBSYS_DEBUG(rpc,
+                "Multi-recv buffer %d has been consumed (%" PRId32
+                " operations completed)",
+                multi_recv_op->id, hg_atomic_get32(&multi_recv_op->op_count));
+            hg_atomic_set32(&multi_recv_op->last, HG_TRUE);
 
-/*---------------------------------------------------------------------------*/
-static HG_INLINE struct hg_core_rpc_info *
-hg_core_map_lookup(struct hg_core_map *hg_core_map, hg_id_t *id)
-{
-    hg_hash_table_value_t value = NULL;
+            /* Post more buffers when running low on posted buffers */
+            if (hg_atomic_decr32(&context->multi_recv_op_count) <= 1 &&
+                HG_CORE_CONTEXT_CLASS(context)->init_info.multi_recv_mem_max) {
+                hg_atomic_set32(&multi_recv_op->pressure, 1);
+                hg_core_context_multi_recv_grow(context);
+            }
+        }
+        HG_CHECK_SUBSYS_WARNING(ctx,
+            hg_atomic_get32(&context->multi_recv_op_count) == 0,
+            "All multi-recv buffers have been consumed, consider increasing "
+            "request_post_init or multi_recv_mem_max init info in order to "
+            "increase buffer sizes");
 
-    /* Lookup key */
-    hg_thread_rwlock_rdlock(&hg_core_map->lock);
-    value = hg_hash_table_lookup(hg_core_map->map, (hg_hash_table_key_t) id);
-    hg_thread_rwlock_release_rdlock(&hg_core_map->lock);
+        /* Prevent from reposting multi-recv buffer until done with handle */
+        hg_atomic_incr32(&multi_recv_op->ref_count);
 
-    return (value == HG_HASH_TABLE_NULL) ? NULL
-                                         : (struct hg_core_rpc_info *) value;
-}
+        /* Fill unexpected info */
+        hg_core_handle->na_addr = na_cb_info_multi_recv_unexpected->source;
+        hg_core_handle->core_handle.info.addr->na_addr =
+            hg_core_handle->na_addr;
+        hg_core_handle->tag = na_cb_info_multi_recv_unexpected->tag;
+        hg_core_handle->core_handle.in_buf_size =
+            na_cb_info_multi_recv_unexpected->actual_buf_size;
+        hg_core_handle->in_buf_used = hg_core_handle->core_handle.in_buf_size;
+        hg_core_handle->core_handle.in_buf =
+            na_cb_info_multi_recv_unexpected->actual_buf;
 
-/*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_map_insert(struct hg_core_map *hg_core_map, hg_id_t *id,
-    struct hg_core_rpc_info **hg_core_rpc_info_p)
-{
-    struct hg_core_rpc_info *hg_core_rpc_info;
-    hg_return_t ret;
-    int rc;
+        /* Responses that were not pre-posted */
+        if (hg_core_handle->tag & HG_CORE_RESPONSE_TAG) {
+            hg_core_process_response(hg_core_handle);
+            return;
+        }
 
-    /* Allocate new RPC info */
-    hg_core_rpc_info =
-        (struct hg_core_rpc_info *) calloc(1, sizeof(*hg_core_rpc_info));
-    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret, HG_NOMEM,
-        "Could not allocate HG core RPC info");
-    hg_core_rpc_info->id = *id;
+        HG_LOG_SUBSYS_DEBUG(rpc,
+            "Processing input for handle %p, tag=%u, buf_size=%zu",
+            (void *) hg_core_handle, hg_core_handle->tag,
+            hg_core_handle->in_buf_used);
 
-    hg_thread_rwlock_wrlock(&hg_core_map->lock);
-    rc = hg_hash_table_insert(hg_core_map->map,
-        (hg_hash_table_key_t) &hg_core_rpc_info->id,
-        (hg_hash_table_value_t) hg_core_rpc_info);
-    hg_thread_rwlock_release_wrlock(&hg_core_map->lock);
-    HG_CHECK_SUBSYS_ERROR(
-        cls, rc == 0, error, ret, HG_NOMEM, "hg_hash_table_insert() failed");
+        /* Process input information */
+        ret = hg_core_process_input(hg_core_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process input");
 
-    *hg_core_rpc_info_p = hg_core_rpc_info;
+        /* Complete operation */
+        hg_core_complete_op(hg_core_handle);
+    } else if (callback_info->ret == NA_CANCELED) {
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "NA_CANCELED event on multi-recv op %d", multi_recv_op->id);
+        hg_atomic_decr32(&context->multi_recv_op_count);
+    } else {
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
+        hg_atomic_decr32(&context->multi_recv_op_count);
+        /* TODO can an unexpected multi-recv operation ever fail? */
+    }
 
-    return HG_SUCCESS;
+    return;
 
 error:
-    free(hg_core_rpc_info);
+    if (hg_core_handle == NULL)
+        return;
 
-    return ret;
+    /* Mark handle as errored */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    hg_atomic_cas32(
+        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+
+    /* Complete operation */
+    hg_core_complete_op(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_map_remove(struct hg_core_map *hg_core_map, hg_id_t *id)
+hg_core_process_input(struct hg_core_private_handle *hg_core_handle)
 {
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    struct hg_peer_stats *peer_stats;
     hg_return_t ret;
-    int rc;
 
-    /* Remove key */
-    hg_thread_rwlock_wrlock(&hg_core_map->lock);
-    rc = hg_hash_table_remove(hg_core_map->map, (hg_hash_table_key_t) id);
-    hg_thread_rwlock_release_wrlock(&hg_core_map->lock);
-    HG_CHECK_SUBSYS_ERROR(
-        cls, rc != 1, error, ret, HG_NOENTRY, "hg_hash_table_remove() failed");
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+    /* Increment counter */
+    hg_atomic_incr64(hg_core_class->counters.rpc_req_recv_count);
+#endif
 
-    return HG_SUCCESS;
+    /* Get and verify input header */
+    ret = hg_core_proc_header_request(
+        &hg_core_handle->core_handle, &hg_core_handle->in_header, HG_DECODE);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not decode request header");
 
-error:
-    return ret;
-}
+    /* Get operation ID from header */
+    hg_core_handle->core_handle.info.id =
+        hg_core_handle->in_header.msg.request.id;
+    hg_core_handle->cookie = hg_core_handle->in_header.msg.request.cookie;
+    /* TODO assign target ID from cookie directly for now */
+    hg_core_handle->core_handle.info.context_id = hg_core_handle->cookie;
 
-/*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_lookup(struct hg_core_private_class *hg_core_class,
-    const char *name, struct hg_core_private_addr **addr_p)
-{
-    struct hg_core_private_addr *hg_core_addr = NULL;
-    na_class_t **na_class_p = NULL;
-    na_addr_t **na_addr_p = NULL;
-    size_t *na_addr_serialize_size_p = NULL;
-    na_return_t na_ret;
-    const char *name_str = NULL;
-    hg_return_t ret;
+    /* Requests packed together by the origin are split into separate
+     * handles */
+    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_COALESCED)
+        return hg_core_process_coalesced(hg_core_handle);
 
-    /* Allocate addr */
-    ret = hg_core_addr_create(hg_core_class, &hg_core_addr);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not create HG core addr");
+    /* Parse flags */
+    hg_core_handle->no_response =
+        hg_core_handle->in_header.msg.request.flags & HG_CORE_NO_RESPONSE;
+    hg_core_handle->unexpected_response =
+        hg_core_handle->in_header.msg.request.flags &
+        HG_CORE_UNEXPECTED_RESPONSE;
+
+    /* Origin no longer needs extra output data of a previous response */
+    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_RELEASE)
+        hg_core_lease_release(hg_core_handle);
+
+    /* Bulk handles and extra input are only known once input is decoded */
+    hg_core_handle->bulk_size = 0;
+    hg_core_handle->in_extra_size = 0;
+
+    peer_stats = hg_core_peer_lock_handle(hg_core_handle);
+    if (peer_stats != NULL) {
+        peer_stats->rpc_in++;
+        peer_stats->bytes_in += hg_core_handle->in_buf_used;
+        hg_core_peer_unlock(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
+    }
 
-    /* TODO lookup could also create self addresses */
+    /* Credits of streamed responses were appended after the trace context */
+    hg_core_handle->stream_credits = 0;
+    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_STREAM) {
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            hg_core_handle->in_buf_used <
+                hg_core_handle->core_handle.na_in_header_offset +
+                    hg_core_header_request_get_size() + sizeof(hg_uint8_t),
+            error, ret, HG_PROTOCOL_ERROR, "Truncated stream credits");
+        hg_core_handle->in_buf_used -= sizeof(hg_uint8_t);
+        hg_core_handle->stream_credits =
+            ((const hg_uint8_t *) hg_core_handle->core_handle
+                    .in_buf)[hg_core_handle->in_buf_used];
+        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->stream_credits == 0, error,
+            ret, HG_PROTOCOL_ERROR, "Invalid stream credits");
+        if (hg_core_handle->stream != NULL)
+            hg_core_stream_reset(hg_core_handle);
+    }
 
-#ifdef NA_HAS_SM
-    if (hg_core_class->core_class.na_sm_class != NULL)
-        name_str = strstr(name, HG_CORE_ADDR_DELIMITER);
+    /* Trace context was appended after the payload */
+    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_TRACE) {
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            hg_core_handle->in_buf_used <
+                hg_core_handle->core_handle.na_in_header_offset +
+                    hg_core_header_request_get_size() + HG_TRACE_CONTEXT_SIZE,
+            error, ret, HG_PROTOCOL_ERROR, "Truncated trace context");
+        hg_core_handle->in_buf_used -= HG_TRACE_CONTEXT_SIZE;
+        memcpy(hg_core_handle->trace_context,
+            (const char *) hg_core_handle->core_handle.in_buf +
+                hg_core_handle->in_buf_used,
+            HG_TRACE_CONTEXT_SIZE);
+        hg_core_handle->trace_context_set = HG_TRUE;
+    }
+    HG_CORE_TRACE_EVENT(hg_core_handle, HG_TRACE_RECV);
 
-    /* Parse name string */
-    if (name_str != NULL) {
-        char uuid_str[NA_SM_HOST_ID_LEN + 1];
-        int rc;
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Processed input for handle %p, ID=%" PRIu64 ", cookie=%" PRIu8
+        ", no_response=%d",
+        (void *) hg_core_handle, hg_core_handle->core_handle.info.id,
+        hg_core_handle->cookie, hg_core_handle->no_response);
 
-        /* Get first part of address string with host ID */
-        rc = sscanf(name, "uid://%11[^#]", uuid_str);
-        HG_CHECK_SUBSYS_ERROR(addr, rc != 1, error, ret, HG_PROTONOSUPPORT,
-            "Malformed address format (%s)", name);
+    /* RPC info is needed to know the priority class of the request, it is
+     * then re-used when the request is processed */
+    hg_core_handle->core_handle.rpc_info =
+        hg_core_map_lookup(&HG_CORE_HANDLE_CLASS(hg_core_handle)->rpc_map,
+            &hg_core_handle->core_handle.info.id);
 
-        na_ret = NA_SM_String_to_host_id(uuid_str, &hg_core_addr->host_id);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "NA_SM_String_to_host_id() failed (%s)",
-            NA_Error_to_string(na_ret));
+    /* Reject request before any extra payload is received if overloaded */
+    if (hg_core_admission_reject(hg_core_handle)) {
+        hg_core_admission_shed(hg_core_handle);
+        return HG_SUCCESS;
+    }
 
-        /* Skip delimiter */
-        name_str += HG_CORE_ADDR_DELIMITER_LEN;
+    /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
+    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_MORE_DATA) {
+        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_class->more_data_cb.acquire == NULL,
+            error, ret, HG_OPNOTSUPPORTED,
+            "No callback defined for acquiring more data");
 
-        /* Compare IDs, if they match it's local address */
-        if (NA_SM_Host_id_cmp(hg_core_addr->host_id, hg_core_class->host_id)) {
-            HG_LOG_SUBSYS_DEBUG(addr, "%s is a local address", name);
-            na_class_p = &hg_core_addr->core_addr.core_class->na_sm_class;
-            na_addr_p = &hg_core_addr->core_addr.na_sm_addr;
-            na_addr_serialize_size_p = &hg_core_addr->na_sm_addr_serialize_size;
-        } else {
-            /* Remote lookup */
-            name_str = strstr(name_str, HG_CORE_ADDR_DELIMITER);
-            HG_CHECK_SUBSYS_ERROR(addr, name_str == NULL, error, ret,
-                HG_PROTONOSUPPORT, "Malformed remote address string (%s)",
-                name);
+        HG_LOG_SUBSYS_WARNING(perf,
+            "Must recv extra input data payload for handle %p",
+            (void *) hg_core_handle);
 
-            na_class_p = &hg_core_addr->core_addr.core_class->na_class;
-            na_addr_p = &hg_core_addr->core_addr.na_addr;
-            na_addr_serialize_size_p = &hg_core_addr->na_addr_serialize_size;
-            name_str += HG_CORE_ADDR_DELIMITER_LEN;
-        }
-    } else {
-#endif
-        /* Remote lookup */
-        na_class_p = &hg_core_addr->core_addr.core_class->na_class;
-        na_addr_p = &hg_core_addr->core_addr.na_addr;
-        na_addr_serialize_size_p = &hg_core_addr->na_addr_serialize_size;
-        name_str = name;
-#ifdef NA_HAS_SM
-    }
-#endif
+        /* Increment number of expected operations */
+        hg_atomic_incr32(&hg_core_handle->op_expected_count);
 
-    /* Lookup adress */
-    na_ret = NA_Addr_lookup(*na_class_p, name_str, na_addr_p);
-    HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-        (hg_return_t) na_ret, "Could not lookup address %s (%s)", name_str,
-        NA_Error_to_string(na_ret));
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+        /* Increment counter */
+        hg_atomic_incr64(hg_core_class->counters.rpc_req_extra_count);
+#endif
 
-    /* Cache serialize size */
-    *na_addr_serialize_size_p =
-        NA_Addr_get_serialize_size(*na_class_p, *na_addr_p);
+        ret = hg_core_class->more_data_cb.acquire(
+            (hg_core_handle_t) hg_core_handle, HG_INPUT,
+            hg_core_more_data_complete);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+            "Error in HG core handle more data acquire callback for handle %p",
+            (void *) hg_core_handle);
+    }
 
-    *addr_p = hg_core_addr;
+    /* Request now waits for its callback to be triggered */
+    if (HG_CORE_HANDLE_CONTEXT(hg_core_handle)->admission.queue_max > 0 ||
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle)->admission.wait_max > 0) {
+        hg_atomic_incr32(
+            &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->admission.queued);
+        hg_core_handle->admitted = HG_TRUE;
+    }
 
     return HG_SUCCESS;
 
 error:
-    hg_core_addr_free(hg_core_addr);
-
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_create(struct hg_core_private_class *hg_core_class,
-    struct hg_core_private_addr **hg_core_addr_p)
+static HG_INLINE hg_bool_t
+hg_core_admission_reject(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_addr *hg_core_addr = NULL;
-    hg_return_t ret;
-
-    hg_core_addr =
-        (struct hg_core_private_addr *) calloc(1, sizeof(*hg_core_addr));
-    HG_CHECK_SUBSYS_ERROR(addr, hg_core_addr == NULL, error, ret, HG_NOMEM,
-        "Could not allocate HG core addr");
-
-    hg_core_addr->core_addr.core_class = (hg_core_class_t *) hg_core_class;
-    hg_core_addr->core_addr.na_addr = NULL;
-#ifdef NA_HAS_SM
-    hg_core_addr->core_addr.na_sm_addr = NULL;
-#endif
-    hg_core_addr->core_addr.is_self = HG_FALSE;
-
-    hg_atomic_init32(&hg_core_addr->ref_count, 1);
+    struct hg_core_admission *admission =
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->admission;
+    struct hg_core_private_rpc_info *hg_core_rpc_info;
+    int32_t queued;
 
-    /* Increment N addrs from HG class */
-    hg_atomic_incr32(&hg_core_class->n_addrs);
+    if (admission->queue_max == 0 && admission->wait_max == 0)
+        return HG_FALSE;
 
-    *hg_core_addr_p = hg_core_addr;
+    /* Average wait only matters while requests are waiting, it is then
+     * updated again once the backlog drains */
+    queued = hg_atomic_get32(&admission->queued);
+    if (!(admission->queue_max > 0 &&
+            queued >= (int32_t) admission->queue_max) &&
+        !(admission->wait_max > 0 && queued > 0 &&
+            (hg_uint64_t) hg_atomic_get64(&admission->wait_avg) >
+                admission->wait_max))
+        return HG_FALSE;
 
-    return HG_SUCCESS;
+    /* Control and high priority RPCs are always admitted */
+    hg_core_rpc_info = (struct hg_core_private_rpc_info *)
+                           hg_core_handle->core_handle.rpc_info;
 
-error:
-    return ret;
+    return (hg_core_rpc_info == NULL ||
+            !(hg_core_rpc_info->bypass_admission ||
+                hg_core_rpc_info->prio == HG_PRIO_HIGH));
 }
 
 /*---------------------------------------------------------------------------*/
 static void
-hg_core_addr_free(struct hg_core_private_addr *hg_core_addr)
+hg_core_admission_shed(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_class *hg_core_class;
-
-    if (hg_core_addr == NULL)
-        return;
-
-    if (hg_atomic_decr32(&hg_core_addr->ref_count))
-        /* Cannot free yet */
-        return;
+    hg_return_t ret;
 
-    /* Keep reference to core class */
-    hg_core_class = HG_CORE_ADDR_CLASS(hg_core_addr);
+    hg_atomic_incr64(
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->admission.shed_count);
 
-    /* Free NA addresses */
-    hg_core_addr_free_na(hg_core_addr);
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Context overloaded, rejecting request of handle %p (ID=%" PRIu64 ")",
+        (void *) hg_core_handle, hg_core_handle->core_handle.info.id);
 
-    free(hg_core_addr);
+    if (!hg_core_handle->no_response) {
+        /* Reference is released by hg_core_respond() on error, the response
+         * itself cannot complete before the recv operation does */
+        hg_core_handle_ref_incr(hg_core_handle);
+        ret =
+            hg_core_respond(hg_core_handle, NULL, NULL, 0, 0, HG_BUSY, NULL);
+        if (ret == HG_SUCCESS) {
+            hg_core_handle_ref_decr(hg_core_handle);
+            return;
+        }
+        HG_LOG_SUBSYS_ERROR(rpc, "Could not respond to rejected request (%d)",
+            (int) ret);
+    }
 
-    /* Decrement N addrs from HG class */
-    hg_atomic_decr32(&hg_core_class->n_addrs);
+    /* Handle is released without triggering its RPC callback */
+    hg_atomic_cas32(
+        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) HG_BUSY);
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_core_addr_free_na(struct hg_core_private_addr *hg_core_addr)
+static HG_INLINE void
+hg_core_admission_dequeue(struct hg_core_private_handle *hg_core_handle)
 {
-    /* Free NA address */
-    if (hg_core_addr->core_addr.na_addr != NULL) {
-        NA_Addr_free(hg_core_addr->core_addr.core_class->na_class,
-            hg_core_addr->core_addr.na_addr);
-        hg_core_addr->core_addr.na_addr = NULL;
-        hg_core_addr->na_addr_serialize_size = 0;
-    }
+    struct hg_core_admission *admission =
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->admission;
+    int64_t wait = (int64_t) (hg_time_get_cycles() -
+                              hg_core_handle->queue_start),
+            wait_avg = hg_atomic_get64(&admission->wait_avg);
 
-#ifdef NA_HAS_SM
-    /* Free NA SM address */
-    if (hg_core_addr->core_addr.na_sm_addr != NULL) {
-        NA_Addr_free(hg_core_addr->core_addr.core_class->na_sm_class,
-            hg_core_addr->core_addr.na_sm_addr);
-        hg_core_addr->core_addr.na_sm_addr = NULL;
-        hg_core_addr->na_sm_addr_serialize_size = 0;
-    }
-#endif
+    hg_core_handle->admitted = HG_FALSE;
+    hg_atomic_decr32(&admission->queued);
+
+    /* Concurrent updates may lose a sample, which is fine for an average */
+    hg_atomic_set64(&admission->wait_avg,
+        wait_avg + ((wait - wait_avg) >> HG_CORE_ADMISSION_WAIT_SHIFT));
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_addr_set_remove(struct hg_core_private_addr *hg_core_addr)
-{
+hg_core_process_coalesced(struct hg_core_private_handle *hg_core_handle)
+{
+    size_t na_header_size = hg_core_handle->core_handle.na_in_header_offset;
+    unsigned int count =
+        (unsigned int) hg_core_handle->in_header.msg.request.id;
+    char *buf = (char *) hg_core_handle->core_handle.in_buf;
+    char *first_record = NULL;
+    size_t offset, first_record_size = 0;
+    na_tag_t first_tag = 0;
+    unsigned int i;
     hg_return_t ret;
 
-    if (hg_core_addr->core_addr.na_addr != NULL) {
-        na_return_t na_ret =
-            NA_Addr_set_remove(hg_core_addr->core_addr.core_class->na_class,
-                hg_core_addr->core_addr.na_addr);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "NA_Addr_set_remove() failed (%s)",
-            NA_Error_to_string(na_ret));
-    }
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+    /* Requests are counted individually */
+    hg_atomic_decr64(HG_CORE_HANDLE_CLASS(hg_core_handle)
+                         ->counters.rpc_req_recv_count);
+#endif
 
-#ifdef NA_HAS_SM
-    if (hg_core_addr->core_addr.na_sm_addr != NULL) {
-        na_return_t na_ret =
-            NA_Addr_set_remove(hg_core_addr->core_addr.core_class->na_sm_class,
-                hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "NA_Addr_set_remove() failed (%s)",
-            NA_Error_to_string(na_ret));
+    HG_CHECK_SUBSYS_ERROR(rpc, count == 0, error, ret, HG_PROTOCOL_ERROR,
+        "No request found in coalesced message");
+
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Splitting coalesced message of handle %p (%u requests)",
+        (void *) hg_core_handle, count);
+
+    offset = HG_CORE_COALESCE_ALIGN(
+        na_header_size + hg_core_header_request_get_size());
+    for (i = 0; i < count; i++) {
+        hg_uint32_t record_header[2];
+        size_t record_size;
+        na_tag_t tag;
+
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            offset + HG_CORE_COALESCE_RECORD_HEADER_SIZE >
+                hg_core_handle->in_buf_used,
+            error, ret, HG_PROTOCOL_ERROR, "Truncated coalesced message");
+        memcpy(record_header, buf + offset, sizeof(record_header));
+        record_size = (size_t) ntohl(record_header[0]);
+        tag = (na_tag_t) ntohl(record_header[1]);
+        HG_CHECK_SUBSYS_ERROR(rpc,
+            offset + HG_CORE_COALESCE_RECORD_HEADER_SIZE + record_size >
+                hg_core_handle->in_buf_used,
+            error, ret, HG_PROTOCOL_ERROR, "Truncated coalesced message");
+
+        if (i == 0) {
+            /* First request is processed on the handle that received it */
+            first_record = buf + offset + HG_CORE_COALESCE_RECORD_HEADER_SIZE;
+            first_record_size = record_size;
+            first_tag = tag;
+        } else {
+            struct hg_core_private_handle *record_handle = NULL;
+
+            ret = hg_core_coalesced_handle_get(hg_core_handle,
+                buf + offset + HG_CORE_COALESCE_RECORD_HEADER_SIZE,
+                record_size, tag, &record_handle);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                rpc, error, ret, "Could not get handle for coalesced request");
+
+            ret = hg_core_process_input(record_handle);
+            if (ret != HG_SUCCESS) {
+                HG_LOG_SUBSYS_ERROR(rpc,
+                    "Could not process coalesced input for handle %p",
+                    (void *) record_handle);
+
+                /* Mark handle as errored */
+                hg_atomic_or32(&record_handle->status, HG_CORE_OP_ERRORED);
+                hg_atomic_cas32(&record_handle->ret_status,
+                    (int32_t) HG_SUCCESS, (int32_t) ret);
+            }
+
+            /* Complete operation */
+            hg_core_complete_op(record_handle);
+        }
+
+        offset += HG_CORE_COALESCE_ALIGN(
+            HG_CORE_COALESCE_RECORD_HEADER_SIZE + record_size);
     }
-#endif
 
-    return HG_SUCCESS;
+    if (hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_MULTI_RECV) {
+        /* Decode in place, header offset is never read */
+        hg_core_handle->core_handle.in_buf = first_record - na_header_size;
+        hg_core_handle->core_handle.in_buf_size =
+            na_header_size + first_record_size;
+    } else
+        memmove(buf + na_header_size, first_record, first_record_size);
+    hg_core_handle->in_buf_used = na_header_size + first_record_size;
+    hg_core_handle->tag = first_tag;
+
+    return hg_core_process_input(hg_core_handle);
 
 error:
     return ret;
@@ -2780,1025 +10710,1325 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_addr_self(struct hg_core_private_class *hg_core_class,
-    struct hg_core_private_addr **hg_core_addr_p)
+hg_core_coalesced_handle_get(struct hg_core_private_handle *hg_core_handle,
+    char *record, size_t record_size, na_tag_t tag,
+    struct hg_core_private_handle **hg_core_handle_p)
 {
-    struct hg_core_private_addr *hg_core_addr = NULL;
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    size_t na_header_size = hg_core_handle->core_handle.na_in_header_offset;
+    struct hg_core_private_handle *record_handle = NULL;
+    na_addr_t *na_addr = NULL;
     hg_return_t ret;
     na_return_t na_ret;
 
-    ret = hg_core_addr_create(hg_core_class, &hg_core_addr);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not create HG core addr");
-    hg_core_addr->core_addr.is_self = HG_TRUE;
-
-    /* Get NA address */
-    na_ret = NA_Addr_self(
-        hg_core_class->core_class.na_class, &hg_core_addr->core_addr.na_addr);
-    HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-        (hg_return_t) na_ret, "Could not get self address (%s)",
+    /* Each handle releases its own reference to the source address */
+    na_ret = NA_Addr_dup(
+        hg_core_handle->na_class, hg_core_handle->na_addr, &na_addr);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not duplicate source address (%s)",
         NA_Error_to_string(na_ret));
 
-    /* Cache serialize size */
-    hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
-        hg_core_class->core_class.na_class, hg_core_addr->core_addr.na_addr);
+    if (hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_MULTI_RECV) {
+        struct hg_core_multi_recv_op *multi_recv_op =
+            hg_core_handle->multi_recv_op;
 
-#ifdef NA_HAS_SM
-    if (hg_core_class->core_class.na_sm_class) {
-        /* Get SM address */
-        na_ret = NA_Addr_self(hg_core_class->core_class.na_sm_class,
-            &hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not get self SM address (%s)",
-            NA_Error_to_string(na_ret));
+        /* Get a new handle from the pool */
+        ret = hg_core_handle_pool_get(context->handle_pool, &record_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not get handle from pool");
+        record_handle->multi_recv_op = multi_recv_op;
+        hg_atomic_incr32(&multi_recv_op->op_count);
+        hg_atomic_or32(&record_handle->status, HG_CORE_OP_MULTI_RECV);
 
-        /* Cache serialize size */
-        hg_core_addr->na_sm_addr_serialize_size =
-            NA_Addr_get_serialize_size(hg_core_class->core_class.na_sm_class,
-                hg_core_addr->core_addr.na_sm_addr);
+        /* Prevent from reposting multi-recv buffer until done with handle */
+        hg_atomic_incr32(&multi_recv_op->ref_count);
 
-        /* Copy local host ID */
-        NA_SM_Host_id_copy(&hg_core_addr->host_id, hg_core_class->host_id);
+        /* Decode in place, header offset is never read */
+        record_handle->core_handle.in_buf = record - na_header_size;
+        record_handle->core_handle.in_buf_size = na_header_size + record_size;
+    } else {
+        struct hg_core_private_addr *hg_core_addr = NULL;
+
+        /* Pre-posted handles cannot be used, create a new one */
+        ret = hg_core_create(context, hg_core_handle->na_class,
+            hg_core_handle->na_context, HG_CORE_HANDLE_LISTEN, &record_handle);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not create HG core handle");
+        hg_atomic_set32(&record_handle->status, 0);
+        hg_atomic_set32(&record_handle->ret_status, (int32_t) HG_SUCCESS);
+
+        ret = hg_core_addr_create(
+            HG_CORE_CONTEXT_CLASS(context), &hg_core_addr);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not create HG addr");
+        record_handle->core_handle.info.addr = (hg_core_addr_t) hg_core_addr;
+
+        memcpy((char *) record_handle->core_handle.in_buf + na_header_size,
+            record, record_size);
     }
+
+    /* Fill unexpected info */
+    record_handle->na_addr = na_addr;
+#ifdef NA_HAS_SM
+    if (record_handle->na_class ==
+        record_handle->core_handle.info.core_class->na_sm_class)
+        record_handle->core_handle.info.addr->na_sm_addr = na_addr;
+    else
 #endif
+        record_handle->core_handle.info.addr->na_addr = na_addr;
+    record_handle->tag = tag;
+    record_handle->in_buf_used = na_header_size + record_size;
 
-    *hg_core_addr_p = hg_core_addr;
+    *hg_core_handle_p = record_handle;
 
     return HG_SUCCESS;
 
 error:
-    hg_core_addr_free(hg_core_addr);
+    if (record_handle != NULL)
+        (void) hg_core_destroy(record_handle);
+    if (na_addr != NULL)
+        NA_Addr_free(hg_core_handle->na_class, na_addr);
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_dup(struct hg_core_private_addr *hg_core_addr,
-    struct hg_core_private_addr **hg_core_addr_p)
+static HG_INLINE void
+hg_core_send_output_cb(const struct na_cb_info *callback_info)
 {
-    struct hg_core_private_addr *hg_new_addr = NULL;
-    hg_return_t ret;
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
 
-    ret = hg_core_addr_create(HG_CORE_ADDR_CLASS(hg_core_addr), &hg_new_addr);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not create HG core addr");
-    hg_new_addr->core_addr.is_self = hg_core_addr->core_addr.is_self;
+    if (callback_info->ret == NA_SUCCESS) {
+        /* Nothing */
+    } else if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_SUBSYS_WARNING(rpc,
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
 
-    if (hg_core_addr->core_addr.na_addr != NULL) {
-        na_return_t na_ret = NA_Addr_dup(
-            hg_core_addr->core_addr.core_class->na_class,
-            hg_core_addr->core_addr.na_addr, &hg_new_addr->core_addr.na_addr);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not duplicate address (%s)",
-            NA_Error_to_string(na_ret));
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) HG_CANCELED);
+    } else {
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
 
-        /* Copy serialize size */
-        hg_new_addr->na_addr_serialize_size =
-            hg_core_addr->na_addr_serialize_size;
+        /* Keep first non-success ret status */
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) callback_info->ret);
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
     }
 
-#ifdef NA_HAS_SM
-    if (hg_core_addr->core_addr.na_sm_addr != NULL) {
-        na_return_t na_ret =
-            NA_Addr_dup(hg_core_addr->core_addr.core_class->na_sm_class,
-                hg_core_addr->core_addr.na_sm_addr,
-                &hg_new_addr->core_addr.na_sm_addr);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not duplicate address (%s)",
-            NA_Error_to_string(na_ret));
+    /* Complete operation */
+    hg_core_complete_op(hg_core_handle);
+}
 
-        /* Copy serialize size */
-        hg_new_addr->na_sm_addr_serialize_size =
-            hg_core_addr->na_sm_addr_serialize_size;
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_recv_output_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
+    struct hg_peer_stats *peer_stats;
+    hg_return_t ret;
 
-        /* Copy local host ID */
-        NA_SM_Host_id_copy(&hg_new_addr->host_id, hg_core_addr->host_id);
-    }
-#endif
+    if (callback_info->ret == NA_SUCCESS) {
+        HG_LOG_SUBSYS_DEBUG(rpc, "Processing output for handle %p, tag=%u",
+            (void *) hg_core_handle, hg_core_handle->tag);
 
-    *hg_core_addr_p = hg_new_addr;
+        peer_stats = hg_core_peer_lock_handle(hg_core_handle);
+        if (peer_stats != NULL) {
+            peer_stats->bytes_in +=
+                callback_info->info.recv_expected.actual_buf_size;
+            hg_core_peer_unlock(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
+        }
 
-    return HG_SUCCESS;
+        /* Process output information */
+        ret = hg_core_process_output(hg_core_handle, hg_core_defer_ack);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process output");
+
+    } else if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_SUBSYS_WARNING(rpc,
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
+
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) HG_CANCELED);
+    } else
+        HG_GOTO_SUBSYS_ERROR(rpc, error, ret, (hg_return_t) callback_info->ret,
+            "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
+
+    /* Complete operation */
+    hg_core_complete_op(hg_core_handle);
+
+    return;
 
 error:
-    hg_core_addr_free(hg_new_addr);
+    /* Mark handle as errored */
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    hg_atomic_cas32(
+        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
 
-    return ret;
+    /* Complete operation */
+    hg_core_complete_op(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_bool_t
-hg_core_addr_cmp(
-    struct hg_core_private_addr *addr1, struct hg_core_private_addr *addr2)
+static hg_return_t
+hg_core_process_output(struct hg_core_private_handle *hg_core_handle,
+    void (*done_callback)(hg_core_handle_t, hg_return_t))
 {
-    hg_bool_t ret = HG_TRUE;
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    hg_return_t ret;
 
-    /* Cannot be separate classes */
-    if (addr1->core_addr.core_class != addr2->core_addr.core_class)
-        return HG_FALSE;
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+    /* Increment counter */
+    hg_atomic_incr64(hg_core_class->counters.rpc_resp_recv_count);
+#endif
 
-    /* Self addresses are always equal */
-    if (addr1->core_addr.is_self && addr2->core_addr.is_self)
-        return HG_TRUE;
+    /* Get and verify output header */
+    ret = hg_core_proc_header_response(
+        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_DECODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not decode header");
 
-    /* Compare NA addresses */
-    ret &= (hg_bool_t) NA_Addr_cmp(addr1->core_addr.core_class->na_class,
-        addr1->core_addr.na_addr, addr2->core_addr.na_addr);
+    /* Get return code from header */
+    hg_atomic_set32(&hg_core_handle->ret_status,
+        (int32_t) hg_core_handle->out_header.msg.response.ret_code);
+
+    /* Parse flags */
+
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Processed output for handle %p, ID=%" PRIu64 ", ret=%" PRId32,
+        (void *) hg_core_handle, hg_core_handle->core_handle.info.id,
+        hg_atomic_get32(&hg_core_handle->ret_status));
+
+    /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
+    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_MORE_DATA) {
+        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_class->more_data_cb.acquire == NULL,
+            error, ret, HG_OPNOTSUPPORTED,
+            "No callback defined for acquiring more data");
+
+        HG_LOG_SUBSYS_WARNING(perf,
+            "Must recv extra output data payload for handle %p",
+            (void *) hg_core_handle);
 
-#ifdef NA_HAS_SM
-    /* Compare NA SM addresses */
-    if (addr1->core_addr.core_class->na_sm_class)
-        ret &= (hg_bool_t) NA_Addr_cmp(addr1->core_addr.core_class->na_sm_class,
-            addr1->core_addr.na_sm_addr, addr2->core_addr.na_sm_addr);
+        /* Increment number of expected operations */
+        hg_atomic_incr32(&hg_core_handle->op_expected_count);
+
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+        /* Increment counter */
+        hg_atomic_incr64(hg_core_class->counters.rpc_resp_extra_count);
 #endif
 
+        ret = hg_core_class->more_data_cb.acquire(
+            (hg_core_handle_t) hg_core_handle, HG_OUTPUT, done_callback);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+            "Error in HG core handle more data acquire callback for handle %p",
+            (void *) hg_core_handle);
+    }
+
+    return HG_SUCCESS;
+
+error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_to_string(
-    char *buf, hg_size_t *buf_size, struct hg_core_private_addr *hg_core_addr)
+static void
+hg_core_process_response(struct hg_core_private_handle *hg_core_handle)
 {
-    na_class_t *na_class = hg_core_addr->core_addr.core_class->na_class;
-    na_addr_t *na_addr = hg_core_addr->core_addr.na_addr;
-    char *buf_ptr = buf;
-    size_t new_buf_size = 0, buf_size_used = 0;
+    na_tag_t tag = hg_core_handle->tag & ~HG_CORE_RESPONSE_TAG;
+    struct hg_core_private_handle *origin_handle;
     hg_return_t ret;
-    na_return_t na_ret;
-
-    new_buf_size = (size_t) *buf_size;
-
-#ifdef NA_HAS_SM
-    /* When we have local and remote addresses */
-    if ((hg_core_addr->core_addr.na_sm_addr != NULL) &&
-        (hg_core_addr->core_addr.na_addr != NULL)) {
-        char addr_str[HG_CORE_ADDR_MAX_SIZE];
-        char uuid_str[NA_SM_HOST_ID_LEN + 1];
-        int desc_len;
 
-        /* Convert host ID to string and generate addr string */
-        na_ret = NA_SM_Host_id_to_string(hg_core_addr->host_id, uuid_str);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "NA_SM_Host_id_to_string() failed (%s)",
-            NA_Error_to_string(na_ret));
+    origin_handle = hg_core_response_table_remove(
+        HG_CORE_HANDLE_CLASS(hg_core_handle), tag, NULL);
+    if (origin_handle == NULL) {
+        HG_LOG_SUBSYS_WARNING(rpc,
+            "Dropping response with tag %u that matches no pending request",
+            tag);
+        goto done;
+    }
 
-        desc_len = snprintf(addr_str, HG_CORE_ADDR_MAX_SIZE,
-            "uid://%s" HG_CORE_ADDR_DELIMITER, uuid_str);
-        HG_CHECK_SUBSYS_ERROR(addr, desc_len > HG_CORE_ADDR_MAX_SIZE, error,
-            ret, HG_OVERFLOW, "Exceeding max addr name");
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Processing output for handle %p, tag=%u (received by handle %p)",
+        (void *) origin_handle, tag, (void *) hg_core_handle);
 
-        if (buf_ptr) {
-            strcpy(buf_ptr, addr_str);
-            buf_ptr += desc_len;
-        }
-        buf_size_used += (hg_size_t) desc_len;
-        if (*buf_size > (unsigned int) desc_len)
-            new_buf_size = *buf_size - (size_t) desc_len;
+    /* NA headers are empty, output is copied as is */
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        hg_core_handle->in_buf_used > origin_handle->core_handle.out_buf_size,
+        error, ret, HG_MSGSIZE,
+        "Response size is too large for output buffer (%zu)",
+        hg_core_handle->in_buf_used);
+    memcpy(origin_handle->core_handle.out_buf,
+        hg_core_handle->core_handle.in_buf, hg_core_handle->in_buf_used);
+
+    /* Process output information */
+    ret = hg_core_process_output(origin_handle, hg_core_defer_ack);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process output");
 
-        /* Get NA SM address string */
-        na_ret =
-            NA_Addr_to_string(hg_core_addr->core_addr.core_class->na_sm_class,
-                buf_ptr, &new_buf_size, hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not convert SM address to string (%s)",
-            NA_Error_to_string(na_ret));
+    /* Complete operation */
+    hg_core_complete_op(origin_handle);
 
-        if (buf_ptr) {
-            buf_ptr[new_buf_size - 1] = *HG_CORE_ADDR_DELIMITER;
-            buf_ptr += new_buf_size;
-        }
-        buf_size_used += new_buf_size;
-        if (*buf_size > new_buf_size)
-            new_buf_size = *buf_size - new_buf_size;
-    } else if (hg_core_addr->core_addr.na_sm_addr != NULL) {
-        na_class = hg_core_addr->core_addr.core_class->na_sm_class;
-        na_addr = hg_core_addr->core_addr.na_sm_addr;
-    }
-#endif
+done:
+    /* Repost handle that received the response */
+    (void) hg_core_destroy(hg_core_handle);
 
-    /* Get NA address string */
-    na_ret = NA_Addr_to_string(na_class, buf_ptr, &new_buf_size, na_addr);
-    HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-        (hg_return_t) na_ret, "Could not convert address (%p) to string (%s)",
-        (void *) na_addr, NA_Error_to_string(na_ret));
+    return;
 
-    *buf_size = (hg_size_t) (new_buf_size + buf_size_used);
+error:
+    /* Mark handle as errored */
+    hg_atomic_or32(&origin_handle->status, HG_CORE_OP_ERRORED);
+    hg_atomic_cas32(
+        &origin_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
 
-    return HG_SUCCESS;
+    /* Complete operation */
+    hg_core_complete_op(origin_handle);
 
-error:
-    return ret;
+    goto done;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_size_t
-hg_core_addr_get_serialize_size(
-    struct hg_core_private_addr *hg_core_addr, hg_uint8_t flags)
+static hg_return_t
+hg_core_stream_post(
+    struct hg_core_private_handle *hg_core_handle, unsigned int *posted_p)
 {
-    hg_size_t ret = sizeof(size_t);
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    unsigned int i;
+    hg_return_t ret;
 
-    if (hg_core_addr->core_addr.na_addr != NULL) {
-        if (hg_core_addr->na_addr_serialize_size == 0) {
-            /* Cache serialize size */
-            hg_core_addr->na_addr_serialize_size = NA_Addr_get_serialize_size(
-                hg_core_addr->core_addr.core_class->na_class,
-                hg_core_addr->core_addr.na_addr);
-        }
+    *posted_p = 0;
 
-        ret += hg_core_addr->na_addr_serialize_size;
+    /* Resources depend on the NA class of the target and on the credits */
+    if (stream != NULL &&
+        (stream->na_class != hg_core_handle->na_class ||
+            stream->count != hg_core_handle->stream_credits))
+        hg_core_free_stream(hg_core_handle);
+    if (hg_core_handle->stream == NULL) {
+        ret = hg_core_alloc_stream(
+            hg_core_handle, hg_core_handle->stream_credits);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate stream resources");
     }
+    stream = hg_core_handle->stream;
+
+    stream->batch = (stream->count + 1) / 2;
+    stream->partials = 0;
+    stream->msgs = 0;
+    stream->queued = HG_FALSE;
+    stream->busy = HG_FALSE;
+    stream->done = HG_FALSE;
+
+    /* Each chunk is one operation of the handle, chunks are re-posted until
+     * the final response is received */
+    hg_thread_spin_lock(&stream->lock);
+    for (i = 0; i < stream->count; i++) {
+        na_return_t na_ret = hg_core_stream_chunk_post(&stream->chunks[i]);
+        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error_unlock, ret,
+            (hg_return_t) na_ret, "Could not post recv for stream chunk (%s)",
+            NA_Error_to_string(na_ret));
 
-#ifdef NA_HAS_SM
-    ret += sizeof(size_t);
-
-    if ((flags & HG_CORE_SM) && hg_core_addr->core_addr.na_sm_addr != NULL) {
-        if (hg_core_addr->na_sm_addr_serialize_size == 0) {
-            /* Cache serialize size */
-            hg_core_addr->na_sm_addr_serialize_size =
-                NA_Addr_get_serialize_size(
-                    hg_core_addr->core_addr.core_class->na_sm_class,
-                    hg_core_addr->core_addr.na_sm_addr);
-        }
-
-        ret += hg_core_addr->na_sm_addr_serialize_size +
-               sizeof(hg_core_addr->host_id);
+        hg_atomic_incr32(&hg_core_handle->op_expected_count);
+        (*posted_p)++;
     }
-#else
-    (void) flags;
-#endif
+    hg_thread_spin_unlock(&stream->lock);
 
+    return HG_SUCCESS;
+
+error_unlock:
+    hg_thread_spin_unlock(&stream->lock);
+error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_serialize(void *buf, hg_size_t buf_size, hg_uint8_t flags,
-    struct hg_core_private_addr *hg_core_addr)
+static HG_INLINE na_return_t
+hg_core_stream_chunk_post(struct hg_core_stream_chunk *chunk)
 {
-    char *buf_ptr = (char *) buf;
-    hg_size_t buf_size_left = buf_size;
-    hg_return_t ret;
+    struct hg_core_private_handle *hg_core_handle = chunk->handle;
+    na_return_t na_ret;
 
-    if (hg_core_addr->core_addr.na_addr != NULL) {
-        na_return_t na_ret;
+    na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_stream_recv_cb, chunk, chunk->buf,
+        hg_core_handle->core_handle.out_buf_size, chunk->buf_plugin_data,
+        hg_core_handle->na_addr, hg_core_handle->core_handle.info.context_id,
+        hg_core_handle->tag, chunk->na_op_id);
+    chunk->posted = (na_ret == NA_SUCCESS);
 
-        HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
-            &hg_core_addr->na_addr_serialize_size, size_t);
+    return na_ret;
+}
 
-        na_ret = NA_Addr_serialize(hg_core_addr->core_addr.core_class->na_class,
-            buf_ptr, buf_size_left, hg_core_addr->core_addr.na_addr);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not serialize NA address (%s)",
-            NA_Error_to_string(na_ret));
-        buf_ptr += hg_core_addr->na_addr_serialize_size;
-        buf_size_left -= hg_core_addr->na_addr_serialize_size;
-    } else {
-        size_t na_sm_addr_serialize_size = 0;
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_stream_recv_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_core_stream_chunk *chunk =
+        (struct hg_core_stream_chunk *) callback_info->arg;
+    struct hg_core_private_handle *hg_core_handle = chunk->handle;
+    struct hg_core_stream *stream = hg_core_handle->stream;
 
-        /* Encode a 0 instead of flag */
-        HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
-            &na_sm_addr_serialize_size, size_t);
+    if (callback_info->ret == NA_SUCCESS) {
+        hg_bool_t queue;
+
+        /* Chunks are triggered one at a time in the order received */
+        hg_thread_spin_lock(&stream->lock);
+        chunk->posted = HG_FALSE;
+        chunk->size = callback_info->info.recv_expected.actual_buf_size;
+        HG_QUEUE_PUSH_TAIL(&stream->received, chunk, entry);
+        queue = !stream->queued;
+        stream->queued = HG_TRUE;
+        hg_thread_spin_unlock(&stream->lock);
+
+        if (queue)
+            hg_core_stream_queue(hg_core_handle);
+        return;
     }
 
-#ifdef NA_HAS_SM
-    if ((flags & HG_CORE_SM) && hg_core_addr->core_addr.na_sm_addr != NULL) {
-        na_return_t na_ret;
-
-        HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
-            &hg_core_addr->na_sm_addr_serialize_size, size_t);
+    hg_thread_spin_lock(&stream->lock);
+    chunk->posted = HG_FALSE;
+    hg_thread_spin_unlock(&stream->lock);
 
-        na_ret =
-            NA_Addr_serialize(hg_core_addr->core_addr.core_class->na_sm_class,
-                buf_ptr, buf_size_left, hg_core_addr->core_addr.na_sm_addr);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not serialize NA SM address (%s)",
-            NA_Error_to_string(na_ret));
-        /*
-        buf_ptr += hg_core_addr->na_sm_addr_serialize_size;
-        buf_size_left -= hg_core_addr->na_sm_addr_serialize_size;
-*/
+    if (callback_info->ret == NA_CANCELED) {
+        /* Chunks still posted once the final response is received are
+         * canceled internally, only report user cancelation */
+        if (hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_CANCELED)
+            hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+                (int32_t) HG_CANCELED);
     } else {
-        size_t na_sm_addr_serialize_size = 0;
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
 
-        /* Encode a 0 instead of flag */
-        HG_CORE_ENCODE(addr, error, ret, buf_ptr, buf_size_left,
-            &na_sm_addr_serialize_size, size_t);
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) callback_info->ret);
+
+        /* Final response can no longer be received */
+        hg_core_stream_cancel(hg_core_handle);
     }
-#else
-    (void) flags;
-#endif
 
-    return HG_SUCCESS;
+    hg_core_complete_op(hg_core_handle);
+}
 
-error:
-    return ret;
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_stream_queue(struct hg_core_private_handle *hg_core_handle)
+{
+    hg_core_completion_add_prio(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+        &hg_core_handle->stream->hg_completion_entry,
+        HG_CORE_HANDLE_PRIO_HIGH(hg_core_handle), HG_FALSE);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_addr_deserialize(struct hg_core_private_class *hg_core_class,
-    struct hg_core_private_addr **hg_core_addr_p, const void *buf,
-    hg_size_t buf_size)
+static void
+hg_core_stream_process(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_addr *hg_core_addr = NULL;
-    const char *buf_ptr = (const char *) buf;
-    hg_size_t buf_size_left = buf_size;
-    hg_bool_t is_self = HG_TRUE;
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    struct hg_core_stream_chunk *chunk;
+    hg_bool_t reposted = HG_FALSE, queue;
     hg_return_t ret;
 
-    /* Create new address */
-    ret = hg_core_addr_create(hg_core_class, &hg_core_addr);
-    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not create HG core addr");
+    hg_thread_spin_lock(&stream->lock);
+    chunk = HG_QUEUE_FIRST(&stream->received);
+    HG_QUEUE_POP_HEAD(&stream->received, entry);
+    hg_thread_spin_unlock(&stream->lock);
 
-    HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
-        &hg_core_addr->na_addr_serialize_size, size_t);
+    /* Output buffer is not posted when streaming, each response is copied
+     * to it so that it can be decoded as a regular response */
+    memcpy(hg_core_handle->core_handle.out_buf, chunk->buf, chunk->size);
+    hg_core_header_response_reset(&hg_core_handle->out_header);
+    ret = hg_core_proc_header_response(
+        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_DECODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not decode header");
 
-    if (hg_core_addr->na_addr_serialize_size != 0) {
-        na_return_t na_ret =
-            NA_Addr_deserialize(hg_core_class->core_class.na_class,
-                &hg_core_addr->core_addr.na_addr, buf_ptr, buf_size_left);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not deserialize NA address (%s)",
-            NA_Error_to_string(na_ret));
-        buf_ptr += hg_core_addr->na_addr_serialize_size;
-        buf_size_left -= hg_core_addr->na_addr_serialize_size;
+    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_STREAM) {
+        /* Partial response */
+        if (hg_core_handle->stream_callback != NULL) {
+            struct hg_core_cb_info hg_core_cb_info;
 
-        is_self &=
-            (hg_bool_t) NA_Addr_is_self(hg_core_class->core_class.na_class,
-                hg_core_addr->core_addr.na_addr);
-    }
+            hg_core_cb_info.arg = hg_core_handle->stream_arg;
+            hg_core_cb_info.ret =
+                (hg_return_t) hg_core_handle->out_header.msg.response.ret_code;
+            hg_core_cb_info.type = HG_CB_FORWARD;
+            hg_core_cb_info.info.forward.handle =
+                (hg_core_handle_t) hg_core_handle;
 
-#ifdef NA_HAS_SM
-    HG_CORE_DECODE(addr, error, ret, buf_ptr, buf_size_left,
-        &hg_core_addr->na_sm_addr_serialize_size, size_t);
+            hg_core_handle->stream_callback(&hg_core_cb_info);
+        }
 
-    if (hg_core_addr->na_sm_addr_serialize_size != 0) {
-        na_return_t na_ret =
-            NA_Addr_deserialize(hg_core_class->core_class.na_sm_class,
-                &hg_core_addr->core_addr.na_sm_addr, buf_ptr, buf_size_left);
-        HG_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not deserialize NA SM address (%s)",
-            NA_Error_to_string(na_ret));
-        /*
-        buf_ptr += hg_core_addr->na_sm_addr_serialize_size;
-        buf_size_left -= hg_core_addr->na_sm_addr_serialize_size;
-        */
-        is_self &=
-            (hg_bool_t) NA_Addr_is_self(hg_core_class->core_class.na_class,
-                hg_core_addr->core_addr.na_addr);
-    }
-#endif
-    hg_core_addr->core_addr.is_self = is_self;
+        /* Chunk must be re-posted before credits are returned */
+        hg_thread_spin_lock(&stream->lock);
+        if (!stream->done &&
+            !(hg_atomic_get32(&hg_core_handle->status) &
+                (HG_CORE_OP_CANCELED | HG_CORE_OP_ERRORED))) {
+            na_return_t na_ret = hg_core_stream_chunk_post(chunk);
+            if (na_ret == NA_SUCCESS) {
+                reposted = HG_TRUE;
+                if (++stream->partials % stream->batch == 0)
+                    stream->msgs++;
+            } else
+                ret = (hg_return_t) na_ret;
+        }
+        hg_thread_spin_unlock(&stream->lock);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not post recv for stream chunk");
 
-    *hg_core_addr_p = hg_core_addr;
+        if (reposted)
+            hg_core_stream_credit_send(hg_core_handle);
+    } else {
+        /* Final response completes the handle */
+        ret = hg_core_process_output(hg_core_handle, hg_core_defer_ack);
+        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process output");
 
-    return HG_SUCCESS;
+        hg_core_stream_cancel(hg_core_handle);
+    }
+
+    goto done;
 
 error:
-    hg_core_addr_free(hg_core_addr);
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    hg_atomic_cas32(
+        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+    hg_core_stream_cancel(hg_core_handle);
 
-    return ret;
+done:
+    /* Next chunk is queued before the operation of this chunk completes as
+     * it may complete the handle */
+    hg_thread_spin_lock(&stream->lock);
+    queue = !HG_QUEUE_IS_EMPTY(&stream->received);
+    stream->queued = queue;
+    hg_thread_spin_unlock(&stream->lock);
+    if (queue)
+        hg_core_stream_queue(hg_core_handle);
+
+    if (!reposted)
+        hg_core_complete_op(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_resolve_na(struct hg_core_private_context *context,
-    struct hg_core_private_addr *hg_core_addr, na_class_t **na_class_p,
-    na_context_t **na_context_p, na_addr_t **na_addr_p)
+static void
+hg_core_stream_credit_send(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_return_t ret;
-
-    /* Determine which NA class/context to use */
-    if (hg_core_addr != NULL) {
-        HG_CHECK_SUBSYS_ERROR(addr,
-            hg_core_addr->core_addr.core_class !=
-                context->core_context.core_class,
-            error, ret, HG_INVALID_ARG,
-            "Address and context passed belong to different classes");
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    struct hg_core_ack *slot = stream->slots[0];
+    na_return_t na_ret;
 
-#ifdef NA_HAS_SM
-        if (!hg_core_addr->core_addr.is_self &&
-            (hg_core_addr->core_addr.na_sm_addr != NULL)) {
-            HG_LOG_SUBSYS_DEBUG(rpc, "Using NA SM class");
-            *na_class_p = context->core_context.core_class->na_sm_class;
-            *na_context_p = context->core_context.na_sm_context;
-            *na_addr_p = hg_core_addr->core_addr.na_sm_addr;
-        } else {
-#endif
-            /* Default */
-            HG_LOG_SUBSYS_DEBUG(rpc, "Using default NA class");
-            *na_class_p = context->core_context.core_class->na_class;
-            *na_context_p = context->core_context.na_context;
-            *na_addr_p = hg_core_addr->core_addr.na_addr;
-#ifdef NA_HAS_SM
-        }
-#endif
-    } else {
-        /* Default */
-        HG_LOG_SUBSYS_DEBUG(rpc, "Using default NA class");
-        *na_class_p = context->core_context.core_class->na_class;
-        *na_context_p = context->core_context.na_context;
-        *na_addr_p = NULL;
+    /* Only one credit msg is in flight at a time */
+    hg_thread_spin_lock(&stream->lock);
+    if (stream->busy || stream->msgs == 0) {
+        hg_thread_spin_unlock(&stream->lock);
+        return;
     }
+    stream->msgs--;
+    stream->busy = HG_TRUE;
 
-    return HG_SUCCESS;
+    /* Increment number of expected operations */
+    hg_atomic_incr32(&hg_core_handle->op_expected_count);
+
+    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_stream_credit_send_cb,
+        hg_core_handle, slot->buf,
+        hg_core_handle->core_handle.na_out_header_offset + sizeof(hg_uint8_t),
+        slot->buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        slot->na_op_id);
+    if (na_ret != NA_SUCCESS)
+        stream->busy = HG_FALSE;
+    hg_thread_spin_unlock(&stream->lock);
+    HG_CHECK_SUBSYS_ERROR_NORET(rpc, na_ret != NA_SUCCESS, error,
+        "Could not post send for credit msg (%s)", NA_Error_to_string(na_ret));
+
+    return;
 
 error:
-    return ret;
+    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+        (int32_t) na_ret);
+
+    /* Target cannot send the final response without credits */
+    hg_core_stream_cancel(hg_core_handle);
+    hg_core_complete_op(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_create(struct hg_core_private_context *context, na_class_t *na_class,
-    na_context_t *na_context, unsigned long flags,
-    struct hg_core_private_handle **hg_core_handle_p)
+static void
+hg_core_stream_credit_send_cb(const struct na_cb_info *callback_info)
 {
-    struct hg_core_private_handle *hg_core_handle = NULL;
-    hg_return_t ret;
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
+    struct hg_core_stream *stream = hg_core_handle->stream;
 
-    /* Allocate new handle */
-    ret = hg_core_alloc(context, flags & HG_CORE_HANDLE_USER, &hg_core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not allocate handle");
+    hg_thread_spin_lock(&stream->lock);
+    stream->busy = HG_FALSE;
+    hg_thread_spin_unlock(&stream->lock);
 
-    /* Alloc/init NA resources */
-    ret = hg_core_alloc_na(hg_core_handle, na_class, na_context, flags);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not allocate NA handle resources");
+    if (callback_info->ret == NA_SUCCESS)
+        /* Send credits owed in the meantime */
+        hg_core_stream_credit_send(hg_core_handle);
+    else if (callback_info->ret != NA_CANCELED) {
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
 
-    /* Execute class callback on handle, this allows upper layers to
-     * allocate private data on handle creation */
-    if (context->handle_create_cb.callback) {
-        ret = context->handle_create_cb.callback(
-            (hg_core_handle_t) hg_core_handle, context->handle_create_cb.arg);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            rpc, error, ret, "Error in HG handle create callback");
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) callback_info->ret);
+        hg_core_stream_cancel(hg_core_handle);
     }
 
-    HG_LOG_SUBSYS_DEBUG(
-        rpc, "Created new handle (%p)", (void *) hg_core_handle);
+    hg_core_complete_op(hg_core_handle);
+}
 
-    *hg_core_handle_p = hg_core_handle;
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_stream_cancel(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    unsigned int i;
 
-    return HG_SUCCESS;
+    hg_thread_spin_lock(&stream->lock);
+    stream->done = HG_TRUE;
 
-error:
-    hg_core_destroy(hg_core_handle);
+    for (i = 0; i < stream->count; i++) {
+        if (stream->chunks[i].posted) {
+            na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
+                hg_core_handle->na_context, stream->chunks[i].na_op_id);
+            HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
+                "Could not cancel stream chunk op id (%s)",
+                NA_Error_to_string(na_ret));
+        }
+    }
 
-    return ret;
+    for (i = 0; i < HG_CORE_STREAM_CREDIT_SLOTS; i++) {
+        if (stream->slot_posted[i] && !stream->slot_canceled[i]) {
+            na_return_t na_ret;
+
+            stream->slot_canceled[i] = HG_TRUE;
+            na_ret = NA_Cancel(hg_core_handle->na_class,
+                hg_core_handle->na_context, stream->slots[i]->na_op_id);
+            HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
+                "Could not cancel credit msg op id (%s)",
+                NA_Error_to_string(na_ret));
+        }
+    }
+    hg_thread_spin_unlock(&stream->lock);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_destroy(struct hg_core_private_handle *hg_core_handle)
+static void
+hg_core_stream_reset(struct hg_core_private_handle *hg_core_handle)
 {
-    int32_t ref_count;
-    hg_return_t ret;
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    unsigned int i;
 
-    if (hg_core_handle == NULL)
-        return HG_SUCCESS;
+    stream->credits = hg_core_handle->stream_credits;
+    stream->batch = (stream->credits + 1) / 2;
+    stream->partials = 0;
+    stream->msgs = 0;
+    stream->ret = HG_SUCCESS;
+    stream->busy = HG_FALSE;
+    stream->pending = HG_FALSE;
+    stream->done = HG_FALSE;
+    for (i = 0; i < HG_CORE_STREAM_CREDIT_SLOTS; i++) {
+        stream->slot_posted[i] = HG_FALSE;
+        stream->slot_canceled[i] = HG_FALSE;
+    }
+}
 
-    /* This will push the RPC handle back to completion queue when no
-     * response is sent and we are sending to ourselves. This ensures that
-     * there is no race between the callback execution and the RPC
-     * completion. */
-    if (hg_core_handle->is_self && hg_core_handle->no_response &&
-        hg_atomic_get32(&hg_core_handle->no_response_done) > 0 &&
-        hg_atomic_cas32(&hg_core_handle->no_response_done,
-            hg_atomic_get32(&hg_core_handle->ref_count), 0)) {
-        /* Safe as the decremented refcount will always be > 0 */
-        ref_count = hg_atomic_decr32(&hg_core_handle->ref_count);
-        HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count decr to %" PRId32,
-            (void *) hg_core_handle, ref_count);
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_respond_partial(struct hg_core_private_handle *hg_core_handle,
+    hg_core_cb_t callback, void *arg, hg_size_t payload_size)
+{
+    struct hg_core_stream *stream;
+    hg_bool_t send = HG_FALSE;
+    unsigned int i;
+    hg_return_t ret;
 
-        ret = hg_core_handle->ops.no_respond(hg_core_handle);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not complete handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->stream_credits == 0, error, ret,
+        HG_OPNOTSUPPORTED, "Origin did not request a streamed response");
 
-        return HG_SUCCESS;
+    /* Keep stream resources allocated once they have been used */
+    if (hg_core_handle->stream != NULL &&
+        hg_core_handle->stream->na_class != hg_core_handle->na_class)
+        hg_core_free_stream(hg_core_handle);
+    if (hg_core_handle->stream == NULL) {
+        ret = hg_core_alloc_stream(hg_core_handle, 0);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate stream resources");
+        hg_core_stream_reset(hg_core_handle);
     }
+    stream = hg_core_handle->stream;
+    HG_CHECK_SUBSYS_ERROR(rpc, stream->busy, error, ret, HG_BUSY,
+        "Previous partial response has not completed");
+    HG_CHECK_SUBSYS_ERROR(rpc, stream->done, error, ret, HG_INVALID_ARG,
+        "Final response was already posted");
 
-    /* Standard destroy refcount decrement */
-    ref_count = hg_atomic_decr32(&hg_core_handle->ref_count);
-    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count decr to %" PRId32,
-        (void *) hg_core_handle, ref_count);
-
-    if (ref_count > 0)
-        return HG_SUCCESS; /* Cannot free yet */
+    /* Set the actual size of the msg that needs to be transmitted */
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        hg_core_header_response_get_size() +
+                hg_core_handle->core_handle.na_out_header_offset +
+                payload_size >
+            hg_core_handle->core_handle.out_buf_size,
+        error, ret, HG_MSGSIZE, "Exceeding output buffer size");
+    hg_core_handle->out_buf_used =
+        hg_core_header_response_get_size() +
+        hg_core_handle->core_handle.na_out_header_offset + payload_size;
 
-    /* Re-use handle if we were listening, otherwise destroy it */
-    if (hg_core_handle->reuse &&
-        !hg_atomic_get32(&HG_CORE_HANDLE_CONTEXT(hg_core_handle)->unposting)) {
-        HG_LOG_SUBSYS_DEBUG(
-            rpc, "Re-using handle (%p)", (void *) hg_core_handle);
+    /* Output buffer of posted handles is allocated on first response */
+    if (hg_core_handle->core_handle.out_buf == NULL) {
+        ret = hg_core_alloc_output(hg_core_handle, NA_SEND);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate output buffer");
+    }
 
-        /* Repost handle */
-        ret = hg_core_reset_post(hg_core_handle);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Cannot re-use handle (%p)",
-            (void *) hg_core_handle);
+    /* Set header */
+    hg_core_handle->out_header.msg.response.ret_code = (hg_int8_t) HG_SUCCESS;
+    hg_core_handle->out_header.msg.response.flags = HG_CORE_STREAM;
+    hg_core_handle->out_header.msg.response.cookie = hg_core_handle->cookie;
 
-        /* TODO handle error */
-    } else {
-        struct hg_core_private_class *hg_core_class =
-            HG_CORE_HANDLE_CLASS(hg_core_handle);
+    /* Encode response header */
+    ret = hg_core_proc_header_response(
+        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_ENCODE);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode header");
 
-        HG_LOG_SUBSYS_DEBUG(
-            rpc, "Freeing handle (%p)", (void *) hg_core_handle);
+    stream->callback = callback;
+    stream->arg = arg;
 
-        /* Free extra data here if needed */
-        if (hg_core_class->more_data_cb.release)
-            hg_core_class->more_data_cb.release(
-                (hg_core_handle_t) hg_core_handle);
+    hg_thread_spin_lock(&stream->lock);
+    /* Credit msgs are expected once the first partial response is sent */
+    if (stream->partials == 0) {
+        for (i = 0; i < hg_core_handle->stream_credits / stream->batch;
+             i++) {
+            na_return_t na_ret;
 
-        /* Free user data */
-        if (hg_core_handle->core_handle.data_free_callback)
-            hg_core_handle->core_handle.data_free_callback(
-                hg_core_handle->core_handle.data);
+            if (stream->slot_posted[i])
+                continue;
+            na_ret = hg_core_stream_slot_post(hg_core_handle, i);
+            HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error_unlock,
+                ret, (hg_return_t) na_ret,
+                "Could not post recv for credit msg (%s)",
+                NA_Error_to_string(na_ret));
+        }
+    }
 
-        /* Free NA resources */
-        if (hg_core_handle->na_class)
-            hg_core_free_na(hg_core_handle);
+    /* Response is sent once a credit is returned if none is left */
+    stream->busy = HG_TRUE;
+    if (stream->credits > 0) {
+        stream->credits--;
+        stream->partials++;
+        send = HG_TRUE;
+    } else
+        stream->pending = HG_TRUE;
+    hg_thread_spin_unlock(&stream->lock);
 
-        /* Free handle */
-        hg_core_free(hg_core_handle);
-    }
+    if (send)
+        hg_core_stream_send(hg_core_handle, HG_FALSE);
 
     return HG_SUCCESS;
 
+error_unlock:
+    hg_thread_spin_unlock(&stream->lock);
 error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_alloc(struct hg_core_private_context *context, hg_bool_t user,
-    struct hg_core_private_handle **hg_core_handle_p)
+static hg_bool_t
+hg_core_stream_respond(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_checksum_level_t checksum_level =
-        HG_CORE_CONTEXT_CLASS(context)->init_info.checksum_level;
-    struct hg_core_private_handle *hg_core_handle = NULL;
-    hg_return_t ret;
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    hg_bool_t send;
+    unsigned int i;
 
-    hg_core_handle =
-        (struct hg_core_private_handle *) calloc(1, sizeof(*hg_core_handle));
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle == NULL, error, ret, HG_NOMEM,
-        "Could not allocate handle");
+    hg_thread_spin_lock(&stream->lock);
+    stream->done = HG_TRUE;
 
-    hg_core_handle->op_type = HG_CORE_PROCESS; /* Default */
-    hg_core_handle->core_handle.info.core_class =
-        context->core_context.core_class;
-    hg_core_handle->core_handle.info.context = &context->core_context;
-    hg_core_handle->core_handle.info.addr = HG_CORE_ADDR_NULL;
+    /* Credit msgs still expected complete with the handle */
+    for (i = 0; i < HG_CORE_STREAM_CREDIT_SLOTS; i++)
+        if (stream->slot_posted[i])
+            hg_atomic_incr32(&hg_core_handle->op_expected_count);
+    hg_core_stream_slots_trim(hg_core_handle);
 
-    /* Default ops */
-    hg_core_handle->ops = hg_core_ops_na_g;
+    send = (stream->credits > 0);
+    if (send)
+        stream->credits--;
+    else
+        stream->pending = HG_TRUE;
+    hg_thread_spin_unlock(&stream->lock);
 
-    /* Default return code */
-    hg_core_handle->ret = HG_SUCCESS;
+    return send;
+}
 
-    /* Add handle to handle list so that we can track it */
-    hg_core_handle->created_list =
-        (user) ? &context->user_list : &context->internal_list;
-    hg_thread_spin_lock(&hg_core_handle->created_list->lock);
-    HG_LIST_INSERT_HEAD(
-        &hg_core_handle->created_list->list, hg_core_handle, created);
-    hg_thread_spin_unlock(&hg_core_handle->created_list->lock);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_stream_send(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t final)
+{
+    na_return_t na_ret;
 
-    /* Completed by default */
-    hg_atomic_init32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
-    hg_atomic_init32(
-        &hg_core_handle->ret_status, (int32_t) hg_core_handle->ret);
+    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context,
+        final ? hg_core_send_output_cb : hg_core_stream_send_cb,
+        hg_core_handle, hg_core_handle->core_handle.out_buf,
+        hg_core_handle->out_buf_used, hg_core_handle->out_buf_plugin_data,
+        hg_core_handle->na_addr, hg_core_handle->core_handle.info.context_id,
+        hg_core_handle->tag, hg_core_handle->na_send_op_id);
+    HG_CHECK_SUBSYS_ERROR_NORET(rpc, na_ret != NA_SUCCESS, error,
+        "Could not post send for output buffer (%s)",
+        NA_Error_to_string(na_ret));
 
-    /* Init in/out header */
-    hg_core_header_request_init(
-        &hg_core_handle->in_header, checksum_level > HG_CHECKSUM_NONE);
-    hg_core_header_response_init(
-        &hg_core_handle->out_header, checksum_level > HG_CHECKSUM_NONE);
+    return;
+
+error:
+    if (final) {
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) na_ret);
+        hg_core_stream_cancel(hg_core_handle);
+        hg_core_complete_op(hg_core_handle);
+    } else {
+        /* Error is reported through the partial respond callback */
+        hg_core_handle->stream->ret = (hg_return_t) na_ret;
+        hg_core_stream_queue(hg_core_handle);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_stream_send_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
 
-    /* Set refcount to 1 */
-    hg_atomic_init32(&hg_core_handle->ref_count, 1);
-    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count set to %" PRId32,
-        (void *) hg_core_handle, 1);
+    if (callback_info->ret != NA_SUCCESS && callback_info->ret != NA_CANCELED)
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
 
-    /* Increment N handles from HG context */
-    hg_atomic_incr32(&context->n_handles);
+    hg_core_handle->stream->ret = (hg_return_t) callback_info->ret;
+    hg_core_stream_queue(hg_core_handle);
+}
 
-    *hg_core_handle_p = hg_core_handle;
+/*---------------------------------------------------------------------------*/
+static na_return_t
+hg_core_stream_slot_post(
+    struct hg_core_private_handle *hg_core_handle, unsigned int i)
+{
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    struct hg_core_ack *slot = stream->slots[i];
+    na_return_t na_ret;
 
-    return HG_SUCCESS;
+    na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_stream_credit_recv_cb, slot,
+        slot->buf,
+        hg_core_handle->core_handle.na_out_header_offset + sizeof(hg_uint8_t),
+        slot->buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        slot->na_op_id);
+    stream->slot_posted[i] = (na_ret == NA_SUCCESS);
+    stream->slot_canceled[i] = HG_FALSE;
 
-error:
-    return ret;
+    return na_ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static void
-hg_core_free(struct hg_core_private_handle *hg_core_handle)
+hg_core_stream_slots_trim(struct hg_core_private_handle *hg_core_handle)
 {
-    /* Remove reference to HG addr */
-    hg_core_addr_free(
-        (struct hg_core_private_addr *) hg_core_handle->core_handle.info.addr);
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    unsigned int needed = 0, i;
 
-    /* Remove handle from list */
-    hg_thread_spin_lock(&hg_core_handle->created_list->lock);
-    HG_LIST_REMOVE(hg_core_handle, created);
-    hg_thread_spin_unlock(&hg_core_handle->created_list->lock);
+    /* Origin returns one credit msg per batch of partial responses */
+    if (stream->partials / stream->batch > stream->msgs)
+        needed = stream->partials / stream->batch - stream->msgs;
 
-    hg_core_header_request_finalize(&hg_core_handle->in_header);
-    hg_core_header_response_finalize(&hg_core_handle->out_header);
+    for (i = 0; i < HG_CORE_STREAM_CREDIT_SLOTS; i++) {
+        na_return_t na_ret;
 
-    /* Decrement N handles from HG context */
-    hg_atomic_decr32(&HG_CORE_HANDLE_CONTEXT(hg_core_handle)->n_handles);
+        if (!stream->slot_posted[i] || stream->slot_canceled[i])
+            continue;
+        if (needed > 0) {
+            needed--;
+            continue;
+        }
 
-    free(hg_core_handle);
+        stream->slot_canceled[i] = HG_TRUE;
+        na_ret = NA_Cancel(hg_core_handle->na_class,
+            hg_core_handle->na_context, stream->slots[i]->na_op_id);
+        HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
+            "Could not cancel credit msg op id (%s)",
+            NA_Error_to_string(na_ret));
+    }
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_alloc_na(struct hg_core_private_handle *hg_core_handle,
-    na_class_t *na_class, na_context_t *na_context, unsigned long flags)
+static void
+hg_core_stream_credit_recv_cb(const struct na_cb_info *callback_info)
 {
-    hg_return_t ret;
-    na_return_t na_ret;
+    struct hg_core_ack *slot = (struct hg_core_ack *) callback_info->arg;
+    struct hg_core_private_handle *hg_core_handle = slot->handle;
+    struct hg_core_stream *stream = hg_core_handle->stream;
+    hg_bool_t retired = HG_TRUE, counted, send = HG_FALSE, final = HG_FALSE;
+    unsigned int i;
 
-    /* Set NA class / context */
-    hg_core_handle->na_class = na_class;
-    hg_core_handle->na_context = na_context;
+    for (i = 0; stream->slots[i] != slot; i++)
+        continue;
 
-    /* When using multi-recv, only allocate resources per handle for expected
-     * messages. */
-    if (flags & HG_CORE_HANDLE_MULTI_RECV) {
-        hg_core_handle->core_handle.in_buf = NULL;
-        hg_core_handle->core_handle.in_buf_size = 0;
-    } else {
-        /* Initialize in/out buffers and use unexpected message size */
-        hg_core_handle->core_handle.in_buf_size =
-            NA_Msg_get_max_unexpected_size(na_class);
+    hg_thread_spin_lock(&stream->lock);
+    stream->slot_posted[i] = HG_FALSE;
 
-        hg_core_handle->core_handle.in_buf =
-            NA_Msg_buf_alloc(na_class, hg_core_handle->core_handle.in_buf_size,
-                (flags & HG_CORE_HANDLE_LISTEN) ? NA_RECV : NA_SEND,
-                &hg_core_handle->in_buf_plugin_data);
-        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->core_handle.in_buf == NULL,
-            error, ret, HG_NOMEM, "Could not allocate buffer for input");
+    /* Slots are operations of the handle once the final response is posted */
+    counted = stream->done;
 
-        na_ret =
-            NA_Msg_init_unexpected(na_class, hg_core_handle->core_handle.in_buf,
-                hg_core_handle->core_handle.in_buf_size);
-        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not initialize input buffer (%s)",
-            NA_Error_to_string(na_ret));
+    if (callback_info->ret == NA_SUCCESS) {
+        stream->msgs++;
+        stream->credits += stream->batch;
+
+        /* Re-post slot while credit msgs may still be received */
+        if (!stream->done || stream->partials / stream->batch > stream->msgs) {
+            na_return_t na_ret = hg_core_stream_slot_post(hg_core_handle, i);
+            if (na_ret == NA_SUCCESS)
+                retired = HG_FALSE;
+            else
+                HG_LOG_SUBSYS_ERROR(rpc,
+                    "Could not post recv for credit msg (%s)",
+                    NA_Error_to_string(na_ret));
+        }
+        if (stream->done)
+            hg_core_stream_slots_trim(hg_core_handle);
+
+        /* Send response that was waiting for a credit */
+        if (stream->pending && stream->credits > 0) {
+            stream->pending = HG_FALSE;
+            stream->credits--;
+            final = stream->done;
+            if (!final)
+                stream->partials++;
+            send = HG_TRUE;
+        }
+    } else if (callback_info->ret != NA_CANCELED)
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
+    hg_thread_spin_unlock(&stream->lock);
 
-        hg_core_handle->na_recv_op_id = NA_Op_create(na_class, NA_OP_SINGLE);
-        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->na_recv_op_id == NULL, error,
-            ret, HG_NA_ERROR, "Could not create NA op ID");
-    }
+    if (send)
+        hg_core_stream_send(hg_core_handle, final);
 
-    hg_core_handle->core_handle.out_buf_size =
-        NA_Msg_get_max_expected_size(na_class);
+    if (retired && counted)
+        hg_core_complete_op(hg_core_handle);
+}
 
-    hg_core_handle->core_handle.na_in_header_offset =
-        NA_Msg_get_unexpected_header_size(na_class);
-    hg_core_handle->core_handle.na_out_header_offset =
-        NA_Msg_get_expected_header_size(na_class);
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_more_data_complete(hg_core_handle_t handle, hg_return_t ret)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
 
-    hg_core_handle->core_handle.out_buf =
-        NA_Msg_buf_alloc(na_class, hg_core_handle->core_handle.out_buf_size,
-            (flags & HG_CORE_HANDLE_LISTEN) ? NA_SEND : NA_RECV,
-            &hg_core_handle->out_buf_plugin_data);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->core_handle.out_buf == NULL,
-        error, ret, HG_NOMEM, "Could not allocate buffer for output");
+    if (ret != HG_SUCCESS) {
+        if (ret != HG_CANCELED) {
+            /* Mark handle as errored */
+            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+        }
+        hg_atomic_cas32(
+            &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+    }
 
-    na_ret = NA_Msg_init_expected(na_class, hg_core_handle->core_handle.out_buf,
-        hg_core_handle->core_handle.out_buf_size);
-    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-        (hg_return_t) na_ret, "Could not initialize output buffer (%s)",
-        NA_Error_to_string(na_ret));
+    /* Complete and add to completion queue */
+    hg_core_complete_op(hg_core_handle);
+}
 
-    /* Create NA operation IDs */
-    hg_core_handle->na_send_op_id = NA_Op_create(na_class, NA_OP_SINGLE);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->na_send_op_id == NULL, error,
-        ret, HG_NA_ERROR, "Could not create NA op ID");
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_send_ack(hg_core_handle_t handle, hg_return_t ret)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    na_return_t na_ret;
+    size_t buf_size = handle->na_out_header_offset + sizeof(hg_uint8_t);
 
-    hg_core_handle->na_ack_op_id = NA_Op_create(na_class, NA_OP_SINGLE);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->na_ack_op_id == NULL, error, ret,
-        HG_NA_ERROR, "Could not create NA op ID");
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Aborting ack send");
 
-    hg_atomic_init32(
-        &hg_core_handle->op_expected_count, 1); /* Default (no response) */
-    hg_atomic_init32(&hg_core_handle->op_completed_count, 0);
+    /* Keep ack resources allocated if we are prone to using them */
+    if (hg_core_handle->ack == NULL) {
+        ret = hg_core_alloc_ack(hg_core_handle, NA_SEND);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            rpc, error, ret, "Could not allocate ack resources");
+    }
 
-    return HG_SUCCESS;
+    /* Post expected send (ack) */
+    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
+        hg_core_handle->na_context, hg_core_ack_cb, hg_core_handle,
+        hg_core_handle->ack->buf, buf_size,
+        hg_core_handle->ack->buf_plugin_data, hg_core_handle->na_addr,
+        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
+        hg_core_handle->ack->na_op_id);
+    /* Expected sends should always succeed after retry */
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+        (hg_return_t) na_ret, "Could not post send for ack buffer (%s)",
+        NA_Error_to_string(na_ret));
+
+    return;
 
 error:
-    hg_core_free_na(hg_core_handle);
+    hg_core_free_ack(hg_core_handle);
 
-    return ret;
+    /* Mark handle as errored */
+    if (ret != HG_CANCELED)
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    hg_atomic_cas32(
+        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+
+    /* Complete and add to completion queue */
+    hg_core_complete_op(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_core_free_na(struct hg_core_private_handle *hg_core_handle)
+static HG_INLINE void
+hg_core_ack_cb(const struct na_cb_info *callback_info)
 {
-    /* Destroy NA op IDs */
-    NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_send_op_id);
-    hg_core_handle->na_send_op_id = NULL;
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->arg;
+    hg_bool_t released;
 
-    NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_recv_op_id);
-    hg_core_handle->na_recv_op_id = NULL;
+    /* Lease is withdrawn once the ack completes, the recv of the ack is
+     * canceled if a request released the lease */
+    released = hg_core_lease_revoke(hg_core_handle);
 
-    NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_ack_op_id);
-    hg_core_handle->na_ack_op_id = NULL;
+    if (callback_info->ret == NA_SUCCESS || released) {
+        /* Nothing */
+    } else if (callback_info->ret == NA_CANCELED) {
+        HG_CHECK_SUBSYS_WARNING(rpc,
+            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
+            "Operation was completed");
+        HG_LOG_SUBSYS_DEBUG(
+            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
 
-    /* Free buffers */
-    if (hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_MULTI_RECV) {
-        if (hg_core_handle->multi_recv_op != NULL) {
-            hg_atomic_decr32(&hg_core_handle->multi_recv_op->ref_count);
-            hg_core_handle->multi_recv_op = NULL;
-        }
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) HG_CANCELED);
     } else {
-        NA_Msg_buf_free(hg_core_handle->na_class,
-            hg_core_handle->core_handle.in_buf,
-            hg_core_handle->in_buf_plugin_data);
-    }
-    hg_core_handle->core_handle.in_buf = NULL;
-    hg_core_handle->in_buf_plugin_data = NULL;
-
-    NA_Msg_buf_free(hg_core_handle->na_class,
-        hg_core_handle->core_handle.out_buf,
-        hg_core_handle->out_buf_plugin_data);
-    hg_core_handle->core_handle.out_buf = NULL;
-    hg_core_handle->out_buf_plugin_data = NULL;
+        /* Mark handle as errored */
+        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
 
-    if (hg_core_handle->ack_buf != NULL) {
-        NA_Msg_buf_free(hg_core_handle->na_class, hg_core_handle->ack_buf,
-            hg_core_handle->ack_buf_plugin_data);
-        hg_core_handle->ack_buf = NULL;
-        hg_core_handle->ack_buf_plugin_data = NULL;
+        /* Keep first non-success ret status */
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) callback_info->ret);
+        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
+            NA_Error_to_string(callback_info->ret));
     }
 
-    hg_core_handle->na_class = NULL;
-    hg_core_handle->na_context = NULL;
+    /* Complete operation */
+    hg_core_complete_op(hg_core_handle);
 }
 
 /*---------------------------------------------------------------------------*/
 static void
-hg_core_reset(struct hg_core_private_handle *hg_core_handle)
+hg_core_defer_ack(hg_core_handle_t handle, hg_return_t ret)
 {
-    struct hg_core_private_class *hg_core_class =
-        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    struct hg_core_private_context *context =
+        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
+    struct hg_core_private_addr *hg_core_addr =
+        (struct hg_core_private_addr *) handle->info.addr;
+    struct hg_core_lease *lease;
 
-    /* TODO context ID must always be reset as it is not passed along with
-     * the addr */
-    hg_core_handle->core_handle.info.context_id = 0;
+    /* Errors are reported through the regular ack path */
+    if (ret != HG_SUCCESS || hg_core_addr == NULL)
+        goto send_ack;
 
-    hg_core_handle->request_callback = NULL;
-    hg_core_handle->request_arg = NULL;
-    hg_core_handle->response_callback = NULL;
-    hg_core_handle->response_arg = NULL;
-    hg_core_handle->op_type = HG_CORE_PROCESS; /* Default */
-    hg_core_handle->tag = 0;
-    hg_core_handle->cookie = 0;
-    hg_core_handle->ret = HG_SUCCESS;
-    hg_core_handle->in_buf_used = 0;
-    hg_core_handle->out_buf_used = 0;
-    hg_atomic_init32(
-        &hg_core_handle->op_expected_count, 1); /* Default (no response) */
-    hg_atomic_init32(&hg_core_handle->op_completed_count, 0);
-    hg_core_handle->no_response = HG_FALSE;
+    lease = (struct hg_core_lease *) malloc(sizeof(*lease));
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        rpc, lease == NULL, send_ack, "Could not allocate deferred ack");
+
+    lease->context = context;
+    lease->addr = hg_core_addr;
+    hg_atomic_incr32(&hg_core_addr->ref_count);
+    lease->ack = NULL;
+    lease->na_class = hg_core_handle->na_class;
+    lease->na_context = hg_core_handle->na_context;
+    lease->na_addr = hg_core_handle->na_addr;
+    hg_time_get_current(&lease->deadline);
+    lease->deadline = hg_time_add(
+        lease->deadline, hg_time_from_ms(HG_CORE_LEASE_ACK_DELAY_MS));
+    lease->ack_size = handle->na_out_header_offset + sizeof(hg_uint8_t);
+    lease->tag = hg_core_handle->tag;
+    lease->context_id = handle->info.context_id;
+
+    hg_thread_spin_lock(&context->leases.lock);
+    HG_LIST_INSERT_HEAD(&context->leases.deferred, lease, entry);
+    hg_atomic_incr32(&context->leases.deferred_count);
+    hg_thread_spin_unlock(&context->leases.lock);
+
+    /* Extra data was received, no need to wait for the ack */
+    hg_core_complete_op(hg_core_handle);
 
-    /* Free extra data here if needed */
-    if (hg_core_class->more_data_cb.release)
-        hg_core_class->more_data_cb.release((hg_core_handle_t) hg_core_handle);
+    return;
 
-    hg_core_header_request_reset(&hg_core_handle->in_header);
-    hg_core_header_response_reset(&hg_core_handle->out_header);
+send_ack:
+    hg_core_send_ack(handle, ret);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_reset_post(struct hg_core_private_handle *hg_core_handle)
+static void
+hg_core_lease_grant(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_context *context =
-        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
-    struct hg_core_handle_pool *hg_core_handle_pool;
-    bool use_multi_recv =
-        hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_MULTI_RECV;
-    struct hg_core_multi_recv_op *multi_recv_op = hg_core_handle->multi_recv_op;
-    hg_return_t ret;
-
-    /* Reset handle info */
-    if (hg_core_handle->core_handle.info.addr != HG_CORE_ADDR_NULL) {
-        hg_core_addr_free_na((struct hg_core_private_addr *)
-                                 hg_core_handle->core_handle.info.addr);
-    }
-    hg_core_handle->core_handle.info.id = 0;
-
-    /* Reset the handle */
-    hg_core_reset(hg_core_handle);
+    struct hg_core_leases *leases =
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->leases;
+    struct hg_core_ack *ack = hg_core_handle->ack;
 
-    /* Also reset additional handle parameters */
-    hg_atomic_set32(&hg_core_handle->ref_count, 1);
-    hg_core_handle->core_handle.rpc_info = NULL;
-    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count set to %" PRId32,
-        (void *) hg_core_handle, 1);
+    hg_thread_spin_lock(&leases->lock);
+    ack->granted = HG_TRUE;
+    ack->released = HG_FALSE;
+    HG_LIST_INSERT_HEAD(&leases->granted, ack, entry);
+    hg_thread_spin_unlock(&leases->lock);
+}
 
-    /* Reset status */
-    hg_atomic_set32(&hg_core_handle->status, 0);
-    hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) hg_core_handle->ret);
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_lease_revoke(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_leases *leases =
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->leases;
+    struct hg_core_ack *ack = hg_core_handle->ack;
+    hg_bool_t released;
 
-    /* Multi-recv buffers */
-    if (use_multi_recv && multi_recv_op != NULL) {
-        hg_core_handle->core_handle.in_buf = NULL;
-        hg_core_handle->core_handle.in_buf_size = 0;
-        hg_core_handle->multi_recv_op = NULL;
+    hg_thread_spin_lock(&leases->lock);
+    if (ack->granted) {
+        HG_LIST_REMOVE(ack, entry);
+        ack->granted = HG_FALSE;
     }
+    released = ack->released;
+    hg_thread_spin_unlock(&leases->lock);
 
-#ifdef NA_HAS_SM
-    hg_core_handle_pool = (hg_core_handle->na_class ==
-                              context->core_context.core_class->na_sm_class)
-                              ? context->sm_handle_pool
-                              : context->handle_pool;
-#else
-    hg_core_handle_pool = context->handle_pool;
-#endif
-
-    /* Add handle back to pending list */
-    hg_thread_spin_lock(&hg_core_handle_pool->pending_list.lock);
-    HG_LIST_INSERT_HEAD(
-        &hg_core_handle_pool->pending_list.list, hg_core_handle, pending);
-    hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
+    return released;
+}
 
-    if (use_multi_recv) {
-        if (multi_recv_op != NULL &&
-            hg_atomic_decr32(&multi_recv_op->ref_count) == 0 &&
-            hg_atomic_get32(&multi_recv_op->last)) {
-            HG_LOG_SUBSYS_DEBUG(
-                ctx, "Reposting multi-recv buffer %d", multi_recv_op->id);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_lease_release(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_leases *leases =
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->leases;
+    na_tag_t tag = (na_tag_t) hg_core_handle->in_header.msg.request.release;
+    struct hg_core_private_handle *leased_handle = NULL;
+    struct hg_core_ack *ack;
+    na_return_t na_ret;
 
-            /* Repost multi recv */
-            ret = hg_core_post_multi(multi_recv_op,
-                hg_core_handle_pool->na_class, hg_core_handle_pool->na_context);
-            HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
-                "Cannot repost multi-recv operation (%d)", multi_recv_op->id);
-            hg_atomic_incr32(&context->multi_recv_op_count);
+    /* Leases are matched against the tag and source of their request, keep a
+     * reference to the leased handle so that it cannot be released while its
+     * ack recv is canceled */
+    hg_thread_spin_lock(&leases->lock);
+    HG_LIST_FOREACH (ack, &leases->granted, entry) {
+        if (ack->handle->tag == tag &&
+            ack->handle->na_class == hg_core_handle->na_class &&
+            NA_Addr_cmp(hg_core_handle->na_class, ack->handle->na_addr,
+                hg_core_handle->na_addr)) {
+            HG_LIST_REMOVE(ack, entry);
+            ack->granted = HG_FALSE;
+            ack->released = HG_TRUE;
+            leased_handle = ack->handle;
+            hg_core_handle_ref_incr(leased_handle);
+            break;
         }
-    } else {
-        /* Repost single recv */
-        ret = hg_core_post(hg_core_handle);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Cannot post handle");
     }
+    hg_thread_spin_unlock(&leases->lock);
 
-    return HG_SUCCESS;
+    if (leased_handle == NULL) {
+        HG_LOG_SUBSYS_DEBUG(rpc, "No output lease with tag %u to release", tag);
+        return;
+    }
 
-error:
-    return ret;
+    HG_LOG_SUBSYS_DEBUG(rpc, "Output lease of handle %p released, tag=%u",
+        (void *) leased_handle, tag);
+
+    /* Ack is no longer expected */
+    na_ret = NA_Cancel(leased_handle->na_class, leased_handle->na_context,
+        leased_handle->ack->na_op_id);
+    HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
+        "Could not cancel ack op id (%s)", NA_Error_to_string(na_ret));
+
+    (void) hg_core_destroy(leased_handle);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_set_rpc(struct hg_core_private_handle *hg_core_handle,
-    struct hg_core_private_addr *hg_core_addr, na_addr_t *na_addr, hg_id_t id)
+static void
+hg_core_lease_take(struct hg_core_private_handle *hg_core_handle)
 {
-    struct hg_core_private_class *hg_core_class =
-        HG_CORE_HANDLE_CLASS(hg_core_handle);
-    struct hg_core_info *info = &hg_core_handle->core_handle.info;
-    hg_return_t ret;
-
-    /* We allow for NULL addr to be passed at creation time, this allows
-     * for pool of handles to be created and later re-used after a call to
-     * HG_Core_reset() */
-    if (hg_core_addr && (info->addr != (hg_core_addr_t) hg_core_addr)) {
-        if (info->addr != HG_CORE_ADDR_NULL)
-            hg_core_addr_free((struct hg_core_private_addr *) info->addr);
-        info->addr = (hg_core_addr_t) hg_core_addr;
-        hg_atomic_incr32(&hg_core_addr->ref_count);
+    struct hg_core_leases *leases =
+        &HG_CORE_HANDLE_CONTEXT(hg_core_handle)->leases;
+    hg_uint8_t context_id = hg_core_handle->core_handle.info.context_id;
+    struct hg_core_lease *lease;
 
-        /* Set NA addr to use */
-        hg_core_handle->na_addr = na_addr;
+    if (hg_atomic_get32(&leases->deferred_count) == 0)
+        return;
 
-        /* Set forward call depending on address self */
-        hg_core_handle->is_self = hg_core_class->init_info.loopback &&
-                                  hg_core_addr->core_addr.is_self;
-        hg_core_handle->ops =
-            (hg_core_handle->is_self) ? hg_core_ops_self_g : hg_core_ops_na_g;
+    hg_thread_spin_lock(&leases->lock);
+    HG_LIST_FOREACH (lease, &leases->deferred, entry) {
+        if (lease->na_class == hg_core_handle->na_class &&
+            lease->na_addr == hg_core_handle->na_addr &&
+            lease->context_id == context_id) {
+            HG_LIST_REMOVE(lease, entry);
+            hg_atomic_decr32(&leases->deferred_count);
+            break;
+        }
     }
+    hg_thread_spin_unlock(&leases->lock);
 
-    /* We also allow for NULL RPC id to be passed (same reason as above) */
-    if (id && info->id != id) {
-        struct hg_core_rpc_info *hg_core_rpc_info;
+    hg_core_handle->lease = lease;
+}
 
-        /* Retrieve ID function from function map */
-        hg_core_rpc_info = hg_core_map_lookup(&hg_core_class->rpc_map, &id);
-        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_rpc_info == NULL, error, ret,
-            HG_NOENTRY, "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_lease_sent(
+    struct hg_core_private_handle *hg_core_handle, hg_bool_t delivered)
+{
+    struct hg_core_lease *lease = hg_core_handle->lease;
+    struct hg_core_leases *leases;
 
-        info->id = id;
+    if (lease == NULL)
+        return;
+    hg_core_handle->lease = NULL;
 
-        /* Cache RPC info */
-        hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
+    if (delivered) {
+        hg_core_lease_free(lease);
+        return;
     }
 
-    return HG_SUCCESS;
-
-error:
-    return ret;
+    /* Ack must be sent explicitly on next flush */
+    leases = &lease->context->leases;
+    hg_time_get_current(&lease->deadline);
+    hg_thread_spin_lock(&leases->lock);
+    HG_LIST_INSERT_HEAD(&leases->deferred, lease, entry);
+    hg_atomic_incr32(&leases->deferred_count);
+    hg_thread_spin_unlock(&leases->lock);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_post(struct hg_core_private_handle *hg_core_handle)
+static hg_bool_t
+hg_core_lease_flush(struct hg_core_private_context *context,
+    hg_bool_t force, hg_time_t *deadline_p)
 {
-    hg_return_t ret;
-    na_return_t na_ret;
+    struct hg_core_leases *leases = &context->leases;
+    HG_LIST_HEAD(hg_core_lease) flush_list;
+    struct hg_core_lease *lease;
+    hg_bool_t pending = HG_FALSE;
+    hg_time_t now;
 
-    /* Post a new unexpected receive */
-    na_ret = NA_Msg_recv_unexpected(hg_core_handle->na_class,
-        hg_core_handle->na_context, hg_core_recv_input_cb, hg_core_handle,
-        hg_core_handle->core_handle.in_buf,
-        hg_core_handle->core_handle.in_buf_size,
-        hg_core_handle->in_buf_plugin_data, hg_core_handle->na_recv_op_id);
-    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-        (hg_return_t) na_ret,
-        "Could not post unexpected recv for input buffer (%s)",
-        NA_Error_to_string(na_ret));
+    if (hg_atomic_get32(&leases->deferred_count) == 0)
+        return HG_FALSE;
 
-    HG_LOG_SUBSYS_DEBUG(rpc, "Posted handle (%p)", (void *) hg_core_handle);
+    HG_LIST_INIT(&flush_list);
+    hg_time_get_current(&now);
 
-    return HG_SUCCESS;
+    hg_thread_spin_lock(&leases->lock);
+    lease = HG_LIST_FIRST(&leases->deferred);
+    while (lease != NULL) {
+        struct hg_core_lease *next = HG_LIST_NEXT(lease, entry);
 
-error:
-    return ret;
+        if (force || !hg_time_less(now, lease->deadline)) {
+            HG_LIST_REMOVE(lease, entry);
+            hg_atomic_decr32(&leases->deferred_count);
+            HG_LIST_INSERT_HEAD(&flush_list, lease, entry);
+        } else {
+            if (deadline_p != NULL &&
+                (!pending || hg_time_less(lease->deadline, *deadline_p)))
+                *deadline_p = lease->deadline;
+            pending = HG_TRUE;
+        }
+        lease = next;
+    }
+    hg_thread_spin_unlock(&leases->lock);
+
+    while ((lease = HG_LIST_FIRST(&flush_list)) != NULL) {
+        HG_LIST_REMOVE(lease, entry);
+        hg_core_lease_ack(lease);
+    }
+
+    return pending;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_post_multi(struct hg_core_multi_recv_op *multi_recv_op,
-    na_class_t *na_class, na_context_t *na_context)
+static void
+hg_core_lease_ack(struct hg_core_lease *lease)
 {
     hg_return_t ret;
     na_return_t na_ret;
 
-    hg_atomic_init32(&multi_recv_op->last, 0);
-    hg_atomic_init32(&multi_recv_op->ref_count, 0);
-    hg_atomic_init32(&multi_recv_op->op_count, 0);
+    ret = hg_core_ack_create(
+        lease->na_class, lease->ack_size, NA_SEND, &lease->ack);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Could not create ack resources");
 
-    /* Post a new unexpected receive */
-    na_ret = NA_Msg_multi_recv_unexpected(na_class, na_context,
-        hg_core_multi_recv_input_cb, multi_recv_op, multi_recv_op->buf,
-        multi_recv_op->buf_size, multi_recv_op->plugin_data,
-        multi_recv_op->op_id);
-    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-        (hg_return_t) na_ret, "NA_Msg_multi_recv_unexpected() failed (%s)",
-        NA_Error_to_string(na_ret));
+    hg_atomic_incr32(&lease->context->leases.ack_count);
 
-    HG_LOG_SUBSYS_DEBUG(rpc, "Posted multi-recv buffer (%p, %zu)",
-        multi_recv_op->buf, multi_recv_op->buf_size);
+    /* Post expected send (ack) */
+    na_ret = NA_Msg_send_expected(lease->na_class, lease->na_context,
+        hg_core_lease_ack_cb, lease, lease->ack->buf, lease->ack_size,
+        lease->ack->buf_plugin_data, lease->na_addr, lease->context_id,
+        lease->tag, lease->ack->na_op_id);
+    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error_send, ret,
+        (hg_return_t) na_ret, "Could not post send for ack buffer (%s)",
+        NA_Error_to_string(na_ret));
 
-    return HG_SUCCESS;
+    return;
 
+error_send:
+    hg_atomic_decr32(&lease->context->leases.ack_count);
 error:
-    return ret;
+    hg_core_lease_free(lease);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_release_input(struct hg_core_private_handle *hg_core_handle)
+static void
+hg_core_lease_ack_cb(const struct na_cb_info *callback_info)
 {
-    struct hg_core_private_context *context =
-        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
-    struct hg_core_handle_pool *hg_core_handle_pool;
-    struct hg_core_multi_recv_op *multi_recv_op = hg_core_handle->multi_recv_op;
-    hg_return_t ret;
+    struct hg_core_lease *lease = (struct hg_core_lease *) callback_info->arg;
+    struct hg_core_private_context *context = lease->context;
 
-    if (!(hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_MULTI_RECV))
-        return HG_SUCCESS;
+    HG_CHECK_SUBSYS_ERROR_DONE(rpc, callback_info->ret != NA_SUCCESS,
+        "Could not send ack of output lease (%s)",
+        NA_Error_to_string(callback_info->ret));
 
-#ifdef NA_HAS_SM
-    hg_core_handle_pool = (hg_core_handle->na_class ==
-                              context->core_context.core_class->na_sm_class)
-                              ? context->sm_handle_pool
-                              : context->handle_pool;
-#else
-    hg_core_handle_pool = context->handle_pool;
-#endif
+    hg_core_lease_free(lease);
+    hg_atomic_decr32(&context->leases.ack_count);
+}
 
-    /* Multi-recv buffers */
-    if (multi_recv_op != NULL) {
-        hg_core_handle->core_handle.in_buf = NULL;
-        hg_core_handle->core_handle.in_buf_size = 0;
-        hg_core_handle->multi_recv_op = NULL;
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_lease_free(struct hg_core_lease *lease)
+{
+    hg_core_ack_destroy(lease->na_class, lease->ack);
+    hg_core_addr_free(lease->addr);
+    free(lease);
+}
 
-        if (hg_atomic_decr32(&multi_recv_op->ref_count) == 0 &&
-            hg_atomic_get32(&multi_recv_op->last)) {
-            HG_LOG_SUBSYS_DEBUG(
-                ctx, "Reposting multi-recv buffer %d", multi_recv_op->id);
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_lease_wait(
+    struct hg_core_private_context *context, unsigned int timeout_ms)
+{
+    hg_time_t deadline, now = hg_time_from_ms(0);
+    hg_return_t ret;
 
-            /* Repost multi recv */
-            ret = hg_core_post_multi(multi_recv_op,
-                hg_core_handle_pool->na_class, hg_core_handle_pool->na_context);
-            HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret,
-                "Cannot repost multi-recv operation (%d)", multi_recv_op->id);
-            hg_atomic_incr32(&context->multi_recv_op_count);
-        }
+    if (timeout_ms != 0)
+        hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
+
+    while (hg_atomic_get32(&context->leases.ack_count) > 0) {
+        if (timeout_ms != 0)
+            hg_time_get_current_ms(&now);
+        if (!hg_time_less(now, deadline))
+            break;
+
+        ret = hg_core_progress(
+            context, hg_time_to_ms(hg_time_subtract(deadline, now)));
+        HG_CHECK_SUBSYS_ERROR(ctx, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+            error, ret, ret, "Could not make progress");
     }
 
     return HG_SUCCESS;
@@ -3809,1328 +12039,1626 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_forward(struct hg_core_private_handle *hg_core_handle,
-    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size)
+hg_core_self_cb(const struct hg_core_cb_info *callback_info)
 {
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) callback_info->info.respond.handle;
     int32_t HG_DEBUG_LOG_USED ref_count;
-    int32_t status;
-    hg_size_t header_size;
-    hg_return_t ret = HG_SUCCESS;
-
-    status = hg_atomic_get32(&hg_core_handle->status);
-    HG_CHECK_SUBSYS_ERROR(rpc,
-        !(status & HG_CORE_OP_COMPLETED) || (status & HG_CORE_OP_QUEUED), done,
-        ret, HG_BUSY, "Attempting to use handle that was not completed");
-
-    /* Increment ref_count on handle to allow for destroy to be
-     * pre-emptively called */
-    ref_count = hg_atomic_incr32(&hg_core_handle->ref_count);
-    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count incr to %" PRId32,
-        (void *) hg_core_handle, ref_count);
-
-    /* Reset op counts */
-    hg_atomic_set32(
-        &hg_core_handle->op_expected_count, 1); /* Default (no response) */
-    hg_atomic_set32(&hg_core_handle->op_completed_count, 0);
-
-    /* Reset handle ret */
-    hg_core_handle->ret = HG_SUCCESS;
-
-    /* Reset status */
-    hg_atomic_set32(&hg_core_handle->status, 0);
-    hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) hg_core_handle->ret);
-
-    /* Set header size */
-    header_size = hg_core_header_request_get_size() +
-                  hg_core_handle->core_handle.na_in_header_offset;
+    hg_return_t ret;
 
-    /* Set the actual size of the msg that needs to be transmitted */
-    hg_core_handle->in_buf_used = header_size + payload_size;
-    HG_CHECK_SUBSYS_ERROR(rpc,
-        hg_core_handle->in_buf_used > hg_core_handle->core_handle.in_buf_size,
-        error, ret, HG_MSGSIZE, "Exceeding input buffer size");
+    /* Increment number of expected operations */
+    hg_atomic_incr32(&hg_core_handle->op_expected_count);
 
-    /* Parse flags */
-    if (flags & HG_CORE_NO_RESPONSE)
-        hg_core_handle->no_response = HG_TRUE;
-    if (hg_core_handle->is_self)
-        flags |= HG_CORE_SELF_FORWARD;
+    /* First execute response callback */
+    if (hg_core_handle->response_callback) {
+        struct hg_core_cb_info hg_core_cb_info;
 
-    /* Set callback, keep request and response callbacks separate so that
-     * they do not get overwritten when forwarding to ourself */
-    hg_core_handle->request_callback = callback;
-    hg_core_handle->request_arg = arg;
+        hg_core_cb_info.arg = hg_core_handle->response_arg;
+        hg_core_cb_info.ret = HG_SUCCESS; /* TODO report failure */
+        hg_core_cb_info.type = HG_CB_RESPOND;
+        hg_core_cb_info.info.respond.handle = (hg_core_handle_t) hg_core_handle;
 
-    /* Set header */
-    hg_core_handle->in_header.msg.request.id =
-        hg_core_handle->core_handle.info.id;
-    hg_core_handle->in_header.msg.request.flags = flags;
-    /* Set the cookie as origin context ID, so that when the cookie is
-     * unpacked by the target and assigned to HG info context_id, the NA
-     * layer knows which context ID it needs to send the response to. */
-    hg_core_handle->in_header.msg.request.cookie =
-        hg_core_handle->core_handle.info.context->id;
-
-    /* Encode request header */
-    ret = hg_core_proc_header_request(
-        &hg_core_handle->core_handle, &hg_core_handle->in_header, HG_ENCODE);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode header");
+        hg_core_handle->response_callback(&hg_core_cb_info);
+    }
 
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
-    /* Increment counter */
-    hg_atomic_incr64(
-        HG_CORE_HANDLE_CLASS(hg_core_handle)->counters.rpc_req_sent_count);
-#endif
+    /* Assign forward callback back to handle */
+    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
 
-    /* If addr is self, forward locally, otherwise send the encoded buffer
-     * through NA and pre-post response */
-    ret = hg_core_handle->ops.forward(hg_core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not forward buffer");
+    /* Increment refcount and push handle back to completion queue */
+    ref_count = hg_core_handle_ref_incr(hg_core_handle);
+    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count incr to %" PRId32,
+        (void *) hg_core_handle, ref_count);
 
-done:
-    return ret;
+    /* Process output */
+    ret = hg_core_process_output(hg_core_handle, hg_core_more_data_complete);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process output");
 
-error:
-    /* Handle is no longer in use */
-    hg_atomic_set32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+    /* Mark as completed */
+    hg_core_complete_op(hg_core_handle);
 
-    /* Rollback ref_count taken above */
-    hg_atomic_decr32(&hg_core_handle->ref_count);
+    return HG_SUCCESS;
 
-    return ret;
-}
+error:
+    hg_atomic_cas32(
+        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
 
-/*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_forward_self(struct hg_core_private_handle *hg_core_handle)
-{
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+    /* Mark as completed */
+    hg_core_complete_op(hg_core_handle);
 
-    /* Post operation to self processing pool */
-    return hg_core_process_self(hg_core_handle);
+    return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_forward_na(struct hg_core_private_handle *hg_core_handle)
+hg_core_process_self(struct hg_core_private_handle *hg_core_handle)
 {
     hg_return_t ret;
-    na_return_t na_ret;
 
     /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_FORWARD;
+    hg_core_handle->op_type = HG_CORE_PROCESS;
 
-    /* Generate tag */
-    hg_core_handle->tag =
-        hg_core_gen_request_tag(HG_CORE_HANDLE_CLASS(hg_core_handle));
+    /* Process input */
+    ret = hg_core_process_input(hg_core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process input");
 
-    /* Pre-post recv (output) if response is expected */
-    if (!hg_core_handle->no_response) {
-        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_recv_output_cb, hg_core_handle,
-            hg_core_handle->core_handle.out_buf,
-            hg_core_handle->core_handle.out_buf_size,
-            hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
-            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-            hg_core_handle->na_recv_op_id);
-        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error_recv, ret,
-            (hg_return_t) na_ret, "Could not post recv for output buffer (%s)",
-            NA_Error_to_string(na_ret));
+    /* Mark as completed */
+    hg_core_complete_op(hg_core_handle);
 
-        /* Increment number of expected operations */
-        hg_atomic_incr32(&hg_core_handle->op_expected_count);
-    }
+    return HG_SUCCESS;
 
-    /* Mark handle as posted */
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
+error:
+    hg_atomic_cas32(
+        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
 
-    /* Post send (input) */
-    na_ret = NA_Msg_send_unexpected(hg_core_handle->na_class,
-        hg_core_handle->na_context, hg_core_send_input_cb, hg_core_handle,
-        hg_core_handle->core_handle.in_buf, hg_core_handle->in_buf_used,
-        hg_core_handle->in_buf_plugin_data, hg_core_handle->na_addr,
-        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-        hg_core_handle->na_send_op_id);
-    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error_send, ret,
-        (hg_return_t) na_ret, "Could not post send for input buffer (%s)",
-        NA_Error_to_string(na_ret));
+    /* Mark as completed */
+    hg_core_complete_op(hg_core_handle);
 
     return HG_SUCCESS;
+}
 
-error_recv:
-    return ret;
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_process(struct hg_core_private_handle *hg_core_handle)
+{
+    struct hg_core_rpc_info *hg_core_rpc_info;
+    int32_t HG_DEBUG_LOG_USED ref_count;
+    hg_return_t ret;
 
-error_send:
-    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_POSTED);
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    /* Retrieve exe function from function map if not already cached */
+    hg_core_rpc_info = hg_core_handle->core_handle.rpc_info;
+    if (hg_core_rpc_info == NULL)
+        hg_core_rpc_info =
+            hg_core_map_lookup(&HG_CORE_HANDLE_CLASS(hg_core_handle)->rpc_map,
+                &hg_core_handle->core_handle.info.id);
+    if (hg_core_rpc_info == NULL) {
+        HG_LOG_SUBSYS_WARNING(rpc,
+            "Could not find RPC ID (%" PRIu64 ") in RPC map",
+            hg_core_handle->core_handle.info.id);
+        HG_GOTO_DONE(error, ret, HG_NOENTRY);
+    }
+    // HG_CHECK_SUBSYS_ERROR(rpc, hg_core_rpc_info == NULL, error, ret,
+    // HG_NOENTRY,
+    //     "Could not find RPC ID (%" PRIu64 ") in RPC map",
+    //     hg_core_handle->core_handle.info.id);
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_rpc_info->rpc_cb == NULL, error, ret,
+        HG_INVALID_ARG, "No RPC callback registered");
 
-    if (hg_core_handle->no_response) {
-        /* No recv was posted */
-        return ret;
-    } else {
-        hg_atomic_decr32(&hg_core_handle->op_expected_count);
+    /* Cache RPC info */
+    hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
 
-        /* Keep error for return status */
-        hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) ret);
+    /* Stats, the RPC ID of requests is only known once they are processed */
+    hg_core_handle->handler_start = hg_time_get_cycles();
+    hg_core_histogram_record_time(
+        &((struct hg_core_private_rpc_info *) hg_core_rpc_info)->queue_wait,
+        hg_core_handle->queue_start, hg_core_handle->handler_start);
+    HG_CORE_TRACE_EVENT(hg_core_handle, HG_TRACE_HANDLER);
 
-        /* Mark op as canceled and let it complete */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+    /* Increment ref count here so that a call to HG_Destroy in user's RPC
+     * callback does not free the handle but only schedules its completion
+     */
+    ref_count = hg_core_handle_ref_incr(hg_core_handle);
+    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count incr to %" PRId32,
+        (void *) hg_core_handle, ref_count);
 
-        /* Cancel the above posted recv op */
-        na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
-            hg_core_handle->na_recv_op_id);
-        HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
-            "Could not cancel recv op id (%s)", NA_Error_to_string(na_ret));
+    /* Execute RPC callback */
+    ret = hg_core_rpc_info->rpc_cb((hg_core_handle_t) hg_core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        rpc, error, ret, "Error while executing RPC callback");
 
-        /* Return success here but callback will return canceled */
-        return HG_SUCCESS;
-    }
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_respond(struct hg_core_private_handle *hg_core_handle,
-    hg_core_cb_t callback, void *arg, hg_uint8_t flags, hg_size_t payload_size,
-    hg_return_t ret_code)
+static HG_INLINE void
+hg_core_complete_op(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_size_t header_size;
-    hg_return_t ret = HG_SUCCESS;
-
-    /* Cannot respond if no_response flag set */
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->no_response, done, ret,
-        HG_OPNOTSUPPORTED, "Sending response was disabled on that RPC");
-
-    /* Reset handle ret */
-    hg_core_handle->ret = HG_SUCCESS;
-
-    /* Reset status */
-    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_COMPLETED);
-    hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) hg_core_handle->ret);
-
-    /* Set header size */
-    header_size = hg_core_header_response_get_size() +
-                  hg_core_handle->core_handle.na_out_header_offset;
+    int32_t op_completed_count =
+                hg_atomic_incr32(&hg_core_handle->op_completed_count),
+            op_expected_count =
+                hg_atomic_get32(&hg_core_handle->op_expected_count);
 
-    /* Set the actual size of the msg that needs to be transmitted */
-    hg_core_handle->out_buf_used = header_size + payload_size;
-    HG_CHECK_SUBSYS_ERROR(rpc,
-        hg_core_handle->out_buf_used > hg_core_handle->core_handle.out_buf_size,
-        error, ret, HG_MSGSIZE, "Exceeding output buffer size");
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Completed %" PRId32 "/%" PRId32 " NA operations for handle (%p)",
+        op_completed_count, op_expected_count, (void *) hg_core_handle);
 
-    /* Set callback, keep request and response callbacks separate so that
-     * they do not get overwritten when forwarding to ourself */
-    hg_core_handle->response_callback = callback;
-    hg_core_handle->response_arg = arg;
+    /* Add handle to completion queue when expected operations have
+     * completed */
+    if (op_completed_count == op_expected_count)
+        hg_core_complete(hg_core_handle,
+            (hg_return_t) hg_atomic_get32(&hg_core_handle->ret_status));
+}
 
-    /* Set header */
-    hg_core_handle->out_header.msg.response.ret_code = (hg_int8_t) ret_code;
-    hg_core_handle->out_header.msg.response.flags = flags;
-    hg_core_handle->out_header.msg.response.cookie = hg_core_handle->cookie;
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_complete(struct hg_core_private_handle *hg_core_handle, hg_return_t ret)
+{
+    /* Deadline no longer applies */
+    if (hg_core_handle->timed)
+        hg_core_timer_remove(hg_core_handle);
 
-    /* Encode response header */
-    ret = hg_core_proc_header_response(
-        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_ENCODE);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not encode header");
+    /* Mark op id as completed, also mark the operation as queued to track
+     * when it will be released from the completion queue. */
+    hg_atomic_or32(
+        &hg_core_handle->status, HG_CORE_OP_COMPLETED | HG_CORE_OP_QUEUED);
 
-    /* If addr is self, forward locally, otherwise send the encoded buffer
-     * through NA and pre-post response */
-    ret = hg_core_handle->ops.respond(hg_core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not respond");
+    /* Forward status to callback */
+    hg_core_handle->ret = ret;
 
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
-    /* Increment counter */
-    hg_atomic_incr64(
-        HG_CORE_HANDLE_CLASS(hg_core_handle)->counters.rpc_resp_sent_count);
-#endif
+    hg_core_handle->hg_completion_entry.op_type = HG_RPC;
+    hg_core_handle->hg_completion_entry.op_id.hg_core_handle =
+        (hg_core_handle_t) hg_core_handle;
+    hg_core_handle->queue_start = hg_time_get_cycles();
 
-done:
-    return ret;
+    hg_core_completion_add_prio(HG_CORE_HANDLE_CONTEXT(hg_core_handle),
+        &hg_core_handle->hg_completion_entry,
+        HG_CORE_HANDLE_PRIO_HIGH(hg_core_handle), hg_core_handle->is_self);
+}
 
-error:
-    /* Handle is no longer in use */
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_COMPLETED);
+/*---------------------------------------------------------------------------*/
+void
+hg_core_completion_add(struct hg_core_context *core_context,
+    struct hg_completion_entry *hg_completion_entry, hg_bool_t loopback_notify)
+{
+    hg_core_completion_add_prio(
+        (struct hg_core_private_context *) core_context, hg_completion_entry,
+        HG_FALSE, loopback_notify);
+}
 
-    /* Decrement refcount on handle */
-    hg_atomic_decr32(&hg_core_handle->ref_count);
+/*---------------------------------------------------------------------------*/
+void
+hg_core_completion_wait(struct hg_core_context *core_context,
+    hg_atomic_int32_t *done_p, hg_bool_t any_completion,
+    unsigned int timeout_ms)
+{
+    struct hg_core_private_context *context =
+        (struct hg_core_private_context *) core_context;
+    struct hg_core_completion_wait *completion_wait = &context->completion_wait;
 
-    return ret;
+    hg_thread_mutex_lock(&completion_wait->mutex);
+    /* Register before checking so that hg_core_completion_wake() and
+     * completions pushed from now on signal the condition */
+    hg_atomic_incr32(&completion_wait->waiters);
+    if (hg_atomic_get32(done_p) == 0 &&
+        (!any_completion || hg_core_completion_queue_is_empty(context)))
+        (void) hg_thread_cond_timedwait(
+            &completion_wait->cond, &completion_wait->mutex, timeout_ms);
+    hg_atomic_decr32(&completion_wait->waiters);
+    hg_thread_mutex_unlock(&completion_wait->mutex);
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_respond_self(struct hg_core_private_handle *hg_core_handle)
+void
+hg_core_completion_wake(struct hg_core_context *core_context)
 {
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_RESPOND_SELF;
+    struct hg_core_completion_wait *completion_wait =
+        &((struct hg_core_private_context *) core_context)->completion_wait;
 
-    /* Increment number of expected operations */
-    hg_atomic_incr32(&hg_core_handle->op_expected_count);
+    /* Waiters check their wait word after registering, read the count with
+     * an RMW so that it is ordered after the caller set it */
+    if (hg_atomic_or32(&completion_wait->waiters, 0) > 0) {
+        hg_thread_mutex_lock(&completion_wait->mutex);
+        hg_thread_cond_broadcast(&completion_wait->cond);
+        hg_thread_mutex_unlock(&completion_wait->mutex);
+    }
+}
 
-    /* Complete and add to completion queue */
-    hg_core_complete_op(hg_core_handle);
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+hg_core_context_progressing(struct hg_core_context *core_context)
+{
+#ifdef HG_HAS_MULTI_PROGRESS
+    return (hg_atomic_get32(&((struct hg_core_private_context *) core_context)
+                                 ->progress_multi.count) &
+               (int32_t) HG_CORE_PROGRESS_LOCK) != 0;
+#else
+    (void) core_context;
 
-    return HG_SUCCESS;
+    return HG_FALSE;
+#endif
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_no_respond_self(struct hg_core_private_handle *hg_core_handle)
+static void
+hg_core_completion_add_prio(struct hg_core_private_context *context,
+    struct hg_completion_entry *hg_completion_entry, hg_bool_t high,
+    hg_bool_t loopback_notify)
 {
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+    struct hg_core_completion_wait *completion_wait = &context->completion_wait;
+    int rc;
+
+#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
+    /* Increment counter */
+    if (hg_completion_entry->op_type == HG_BULK)
+        hg_atomic_incr64(HG_CORE_CONTEXT_CLASS(context)->counters.bulk_count);
+#endif
 
-    /* Increment number of expected operations */
-    hg_atomic_incr32(&hg_core_handle->op_expected_count);
+    /* Run callback now if completing from progress, completions that occur
+     * while it executes are queued */
+    if (context->inline_ready) {
+        context->inline_ready = HG_FALSE;
+        (void) hg_core_trigger_completion_entry(hg_completion_entry);
+        context->inline_ready = HG_TRUE;
+        return;
+    }
 
-    /* Complete and add to completion queue */
-    hg_core_complete_op(hg_core_handle);
+    /* Queue is unbounded, this can only fail if a new queue segment cannot
+     * be allocated */
+    rc = hg_core_completion_queue_push(context, hg_completion_entry, high);
+    HG_CHECK_SUBSYS_ERROR_DONE(ctx, rc != HG_UTIL_SUCCESS,
+        "Could not push completion entry to completion queue");
 
-    return HG_SUCCESS;
+    /* Callback is pushed to the completion queue when something completes
+     * so wake up anyone waiting in trigger. The count is read with an RMW so
+     * that it is ordered after the push, a waiter that registers afterwards
+     * sees the entry instead */
+    if (hg_atomic_or32(&completion_wait->waiters, 0) > 0) {
+        hg_thread_mutex_lock(&completion_wait->mutex);
+        hg_thread_cond_signal(&completion_wait->cond);
+        hg_thread_mutex_unlock(&completion_wait->mutex);
+    }
+
+    if (loopback_notify)
+        hg_core_loopback_signal(context);
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_respond_na(struct hg_core_private_handle *hg_core_handle)
+hg_core_progress(
+    struct hg_core_private_context *context, unsigned int timeout_ms)
 {
+    hg_time_t deadline, now = hg_time_from_ms(0), wait_start;
+    hg_bool_t spin = (timeout_ms != 0 && context->spin_policy.max > 0);
+    hg_bool_t inline_ready = context->inline_ready;
+    hg_bool_t sampled = HG_FALSE;
+    hg_uint64_t profile_start = 0;
     hg_return_t ret;
-    na_return_t na_ret;
-    hg_bool_t ack_recv_posted = HG_FALSE;
 
-    /* Increment number of expected operations */
-    hg_atomic_incr32(&hg_core_handle->op_expected_count);
+    /* Completions that occur from now on may run their callback directly */
+    context->inline_ready = context->inline_completion;
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_RESPOND;
+    /* Sample calls so that profiling remains cheap */
+    if (hg_atomic_incr64(&context->profile.progress_count) %
+            HG_CORE_PROFILE_SAMPLE_RATE ==
+        0) {
+        sampled = HG_TRUE;
+        profile_start = hg_time_get_cycles();
+    }
 
-    /* More data on output requires an ack once it is processed */
-    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_MORE_DATA) {
-        size_t buf_size = hg_core_handle->core_handle.na_out_header_offset +
-                          sizeof(hg_uint8_t);
+    if (timeout_ms != 0)
+        hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
 
-        HG_LOG_SUBSYS_WARNING(perf,
-            "Allocating %zu byte(s) to send extra output data for handle %p",
-            buf_size, (void *) hg_core_handle);
+    /* Extend pools of handles outside of the receive path */
+    if (context->posted) {
+        ret = hg_core_context_pools_extend(context);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            poll, done, ret, "Could not extend pools of handles");
+    }
 
-        /* Keep the buffer allocated if we are prone to using ack buffers */
-        if (hg_core_handle->ack_buf == NULL) {
-            hg_core_handle->ack_buf = NA_Msg_buf_alloc(hg_core_handle->na_class,
-                buf_size, NA_RECV, &hg_core_handle->ack_buf_plugin_data);
-            HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->ack_buf == NULL, error,
-                ret, HG_NA_ERROR, "Could not allocate buffer for ack");
+    /* Busy-spin first, completions that arrive within the spin budget do not
+     * pay for the cost of a blocking wait and its wake-up */
+    if (spin) {
+        hg_bool_t progressed = HG_FALSE;
+
+        hg_time_get_current(&wait_start);
+        if (context->coalesce.max > 0)
+            (void) hg_core_coalesce_flush(context, HG_FALSE, NULL);
+        (void) hg_bulk_op_pool_expire(context->hg_bulk_op_pool, NULL);
+        (void) hg_bulk_op_pool_device_poll(context->hg_bulk_op_pool);
+        (void) hg_core_timer_expire(context, NULL);
+        (void) hg_core_lease_flush(context, HG_FALSE, NULL);
+        hg_core_peer_error_process(HG_CORE_CONTEXT_CLASS(context));
+        if (context->poll_set &&
+            hg_atomic_get32(&context->spin_policy.budget) > 0) {
+            ret = hg_core_progress_spin(
+                context, deadline, sampled, &progressed);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                poll, done, ret, "Could not spin on context");
 
-            na_ret = NA_Msg_init_expected(
-                hg_core_handle->na_class, hg_core_handle->ack_buf, buf_size);
-            HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-                (hg_return_t) na_ret, "Could not initialize ack buffer (%s)",
-                NA_Error_to_string(na_ret));
+            if (progressed) {
+                hg_core_spin_policy_update(&context->spin_policy, wait_start);
+                goto done;
+            }
         }
+    }
 
-        /* Increment number of expected operations */
-        hg_atomic_incr32(&hg_core_handle->op_expected_count);
+    do {
+        hg_bool_t safe_wait = HG_FALSE, progressed = HG_FALSE;
+        unsigned int poll_timeout = 0;
+        hg_time_t wait_deadline =
+            hg_core_progress_deadline(context, now, deadline);
 
-        /* Pre-post recv (ack) if more data is expected */
-        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_ack_cb, hg_core_handle,
-            hg_core_handle->ack_buf, buf_size,
-            hg_core_handle->ack_buf_plugin_data, hg_core_handle->na_addr,
-            hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-            hg_core_handle->na_ack_op_id);
-        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not post recv for ack buffer (%s)",
-            NA_Error_to_string(na_ret));
-        ack_recv_posted = HG_TRUE;
-    }
+        /* Bypass notifications if timeout_ms is 0 to prevent system calls
+         */
+        if (timeout_ms == 0) {
+            ; // nothing to do
+        } else if (context->poll_set) {
+            /* We need to be notified when doing blocking progress, this must
+             * be set before checking the completion queues */
+            hg_core_loopback_arm(context);
 
-    /* Mark handle as posted */
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_POSTED);
+            if (hg_core_poll_try_wait(context)) {
+                safe_wait = HG_TRUE;
+                poll_timeout =
+                    hg_time_to_ms(hg_time_subtract(wait_deadline, now));
+            } else
+                hg_atomic_set32(&context->loopback_notify.state, 0);
+        } else if (!HG_CORE_CONTEXT_CLASS(context)->init_info.loopback &&
+                   hg_core_poll_try_wait(context)) {
+            /* This is the case for NA plugins that don't expose a fd */
+            poll_timeout = hg_time_to_ms(hg_time_subtract(wait_deadline, now));
+        }
 
-    /* Post expected send (output) */
-    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
-        hg_core_handle->na_context, hg_core_send_output_cb, hg_core_handle,
-        hg_core_handle->core_handle.out_buf, hg_core_handle->out_buf_used,
-        hg_core_handle->out_buf_plugin_data, hg_core_handle->na_addr,
-        hg_core_handle->core_handle.info.context_id, hg_core_handle->tag,
-        hg_core_handle->na_send_op_id);
-    /* Expected sends should always succeed after retry */
-    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-        (hg_return_t) na_ret, "Could not post send for output buffer (%s)",
-        NA_Error_to_string(na_ret));
+        /* Only enter blocking wait if it is safe to */
+        if (safe_wait) {
+            ret = hg_core_poll_wait(
+                context, poll_timeout, sampled, &progressed);
+            HG_CHECK_SUBSYS_HG_ERROR(poll, done, ret,
+                "Could not make blocking progress on context");
+        } else {
+            ret = hg_core_poll(context, poll_timeout, sampled, &progressed);
+            HG_CHECK_SUBSYS_HG_ERROR(poll, done, ret,
+                "Could not make non-blocking progress on context");
+        }
 
-    return HG_SUCCESS;
+        /* We progressed or we have something to trigger */
+        if (progressed || !hg_core_completion_queue_is_empty(context)) {
+            if (spin)
+                hg_core_spin_policy_update(&context->spin_policy, wait_start);
+            goto done;
+        }
 
-error:
-    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_POSTED);
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+        /* Context is idle, release a batch of deferred deregistrations */
+        if (HG_CORE_CONTEXT_CLASS(context)->bulk_dereg_queue != NULL)
+            hg_bulk_dereg_queue_drain(
+                HG_CORE_CONTEXT_CLASS(context)->bulk_dereg_queue, HG_FALSE);
 
-    if (ack_recv_posted) {
-        hg_atomic_decr32(&hg_core_handle->op_expected_count);
+        if (timeout_ms != 0)
+            hg_time_get_current_ms(&now);
+    } while (hg_time_less(now, deadline));
 
-        /* Keep error for return status */
-        hg_atomic_set32(&hg_core_handle->ret_status, (int32_t) ret);
+    if (spin)
+        hg_core_spin_policy_update(&context->spin_policy, wait_start);
 
-        /* Mark op as canceled and let it complete */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+    ret = HG_TIMEOUT;
 
-        /* Cancel the above posted recv ack op */
-        na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
-            hg_core_handle->na_ack_op_id);
-        HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
-            "Could not cancel ack op id (%s)", NA_Error_to_string(na_ret));
+done:
+    context->inline_ready = inline_ready;
 
-        /* Return success here but callback will return canceled */
-        return HG_SUCCESS;
-    } else if (hg_core_handle->ack_buf != NULL) {
-        NA_Msg_buf_free(hg_core_handle->na_class, hg_core_handle->ack_buf,
-            hg_core_handle->ack_buf_plugin_data);
-        hg_core_handle->ack_buf = NULL;
-        hg_core_handle->ack_buf_plugin_data = NULL;
+    if (sampled) {
+        hg_core_profile_add(&context->profile.progress_time, profile_start);
+        hg_atomic_incr64(&context->profile.progress_samples);
     }
 
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_no_respond_na(struct hg_core_private_handle *hg_core_handle)
-{
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_NO_RESPOND;
-
-    /* Increment number of expected operations */
-    hg_atomic_incr32(&hg_core_handle->op_expected_count);
-
-    hg_core_complete_op(hg_core_handle);
+static hg_time_t
+hg_core_progress_deadline(
+    struct hg_core_private_context *context, hg_time_t now, hg_time_t deadline)
+{
+    hg_time_t wait_deadline = deadline, expiry_deadline;
+
+    /* Cancel bulk transfers that reached their deadline and do not wait
+     * past the deadline of the ones still pending */
+    if (hg_bulk_op_pool_expire(context->hg_bulk_op_pool, &expiry_deadline) &&
+        hg_time_less(expiry_deadline, wait_deadline))
+        wait_deadline =
+            hg_time_less(now, expiry_deadline) ? expiry_deadline : now;
+
+    /* Complete device copies to self, they cannot wake up a blocking wait */
+    if (hg_bulk_op_pool_device_poll(context->hg_bulk_op_pool))
+        wait_deadline = now;
+
+    /* Cancel forwards that reached their deadline and do not wait past
+     * the deadline of the ones still pending */
+    if (hg_core_timer_expire(context, &expiry_deadline) &&
+        hg_time_less(expiry_deadline, wait_deadline))
+        wait_deadline =
+            hg_time_less(now, expiry_deadline) ? expiry_deadline : now;
+
+    /* Send acks that could not be carried by a request in time and do
+     * not wait past the deadline of the ones still held back */
+    if (hg_core_lease_flush(context, HG_FALSE, &expiry_deadline) &&
+        hg_time_less(expiry_deadline, wait_deadline))
+        wait_deadline =
+            hg_time_less(now, expiry_deadline) ? expiry_deadline : now;
+
+    /* Fail forwards to peers that NA reported as unreachable */
+    hg_core_peer_error_process(HG_CORE_CONTEXT_CLASS(context));
+
+    /* Send coalesced requests that are due and do not wait past the
+     * deadline of the ones still pending */
+    if (context->coalesce.max > 0) {
+        hg_time_t flush_deadline, flush_now;
+
+        if (hg_core_coalesce_flush(context, HG_FALSE, &flush_deadline) &&
+            hg_time_less(flush_deadline, wait_deadline)) {
+            /* Blocking waits have a granularity of 1 ms, poll without
+             * blocking until deadlines that are closer are reached */
+            hg_time_get_current(&flush_now);
+            if (hg_time_less(flush_deadline,
+                    hg_time_add(flush_now, hg_time_from_ms(1))))
+                wait_deadline = now;
+            else
+                wait_deadline =
+                    hg_time_less(now, flush_deadline) ? flush_deadline : now;
+        }
+    }
 
-    return HG_SUCCESS;
+    return wait_deadline;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE void
-hg_core_send_input_cb(const struct na_cb_info *callback_info)
+static hg_return_t
+hg_core_progress_multi(struct hg_core_private_context **contexts,
+    unsigned int count, unsigned int timeout_ms, hg_uint64_t *ready_p)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
-
-    if (callback_info->ret == NA_SUCCESS) {
-        /* Nothing */
-    } else if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_SUBSYS_WARNING(rpc,
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_SUBSYS_DEBUG(
-            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
-
-        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
-            (int32_t) HG_CANCELED);
-    } else { /* All other errors */
-        int32_t status;
-
-        /* Mark handle as errored */
-        status = hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    hg_time_t deadline, now = hg_time_from_ms(0);
+    struct hg_poll_set *poll_set = NULL;
+    hg_uint64_t ready = 0;
+    hg_bool_t can_wait = (timeout_ms != 0);
+    unsigned int i;
+    hg_return_t ret = HG_TIMEOUT;
 
-        /* Keep first non-success ret status */
-        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
-            (int32_t) callback_info->ret);
-        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+    /* Contexts can only be waited on together if they all expose a fd */
+    for (i = 0; i < count && can_wait; i++)
+        can_wait = (contexts[i]->poll_set != NULL);
 
-        if (!(status & HG_CORE_OP_CANCELED) && !hg_core_handle->no_response) {
-            na_return_t na_ret;
+    if (timeout_ms != 0)
+        hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
 
-            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+    do {
+        hg_time_t wait_deadline = deadline;
+        hg_bool_t safe_wait = can_wait;
+        unsigned int armed = 0;
+
+        /* Poll each context without blocking first */
+        for (i = 0; i < count; i++) {
+            struct hg_core_private_context *context = contexts[i];
+            hg_bool_t inline_ready = context->inline_ready,
+                      progressed = HG_FALSE;
+            hg_time_t context_deadline;
+
+            context_deadline =
+                hg_core_progress_deadline(context, now, deadline);
+            if (hg_time_less(context_deadline, wait_deadline))
+                wait_deadline = context_deadline;
+
+            context->inline_ready = context->inline_completion;
+            ret = hg_core_poll(context, 0, HG_FALSE, &progressed);
+            context->inline_ready = inline_ready;
+            HG_CHECK_SUBSYS_HG_ERROR(poll, done, ret,
+                "Could not make non-blocking progress on context");
 
-            /* Cancel posted recv for response */
-            na_ret = NA_Cancel(hg_core_handle->na_class,
-                hg_core_handle->na_context, hg_core_handle->na_recv_op_id);
-            HG_CHECK_SUBSYS_ERROR_DONE(rpc, na_ret != NA_SUCCESS,
-                "Could not cancel recv op id (%s)", NA_Error_to_string(na_ret));
+            if (progressed || !hg_core_completion_queue_is_empty(context))
+                ready |= (hg_uint64_t) 1 << i;
         }
-    }
-
-    hg_core_complete_op(hg_core_handle);
-}
-
-/*---------------------------------------------------------------------------*/
-static void
-hg_core_recv_input_cb(const struct na_cb_info *callback_info)
-{
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
-    struct hg_core_private_context *context =
-        HG_CORE_HANDLE_CONTEXT(hg_core_handle);
-    struct hg_core_handle_pool *hg_core_handle_pool;
-    const struct na_cb_info_recv_unexpected *na_cb_info_recv_unexpected =
-        &callback_info->info.recv_unexpected;
-    hg_return_t ret;
-
-/* Remove handle from pending list */
-#ifdef NA_HAS_SM
-    hg_core_handle_pool = (hg_core_handle->na_class ==
-                              context->core_context.core_class->na_sm_class)
-                              ? context->sm_handle_pool
-                              : context->handle_pool;
-#else
-    hg_core_handle_pool = context->handle_pool;
-#endif
-    hg_thread_spin_lock(&hg_core_handle_pool->pending_list.lock);
-    HG_LIST_REMOVE(hg_core_handle, pending);
-    hg_thread_spin_unlock(&hg_core_handle_pool->pending_list.lock);
+        if (ready != 0)
+            break;
 
-    if (callback_info->ret == NA_SUCCESS) {
-        /* Extend pool if all handles are being utilized */
-        if (hg_core_handle_pool->incr_count > 0 &&
-            !hg_atomic_get32(&context->unposting) &&
-            hg_core_handle_pool_empty(hg_core_handle_pool)) {
-            HG_LOG_SUBSYS_WARNING(perf,
-                "Pre-posted handles have all been consumed / are being "
-                "utilized, posting %u more",
-                hg_core_handle_pool->incr_count);
+        /* Block only if it is safe to on every context, notifications must
+         * be armed before checking the completion queues */
+        for (i = 0; i < count && safe_wait; i++, armed++) {
+            hg_core_loopback_arm(contexts[i]);
+            safe_wait = hg_core_poll_try_wait(contexts[i]);
+        }
 
-            ret = hg_core_handle_pool_extend(hg_core_handle_pool);
+        if (safe_wait) {
+            ret = hg_core_progress_multi_wait(contexts, count, &poll_set,
+                hg_time_to_ms(hg_time_subtract(wait_deadline, now)), &ready);
             HG_CHECK_SUBSYS_HG_ERROR(
-                rpc, error, ret, "Could not extend handle pool");
+                poll, done, ret, "Could not wait on contexts");
+        } else {
+            for (i = 0; i < armed; i++)
+                hg_atomic_set32(&contexts[i]->loopback_notify.state, 0);
         }
+        if (ready != 0)
+            break;
 
-        /* Fill unexpected info */
-        hg_core_handle->na_addr = na_cb_info_recv_unexpected->source;
-#ifdef NA_HAS_SM
-        if (hg_core_handle->na_class ==
-            hg_core_handle->core_handle.info.core_class->na_sm_class) {
-            HG_LOG_SUBSYS_DEBUG(rpc, "Using NA SM class for this handle");
-            hg_core_handle->core_handle.info.addr->na_sm_addr =
-                hg_core_handle->na_addr;
-        } else
-#endif
-            hg_core_handle->core_handle.info.addr->na_addr =
-                hg_core_handle->na_addr;
-        hg_core_handle->tag = na_cb_info_recv_unexpected->tag;
-        HG_CHECK_SUBSYS_ERROR_NORET(rpc,
-            na_cb_info_recv_unexpected->actual_buf_size >
-                hg_core_handle->core_handle.in_buf_size,
-            error, "Actual transfer size is too large for unexpected recv");
-        hg_core_handle->in_buf_used =
-            na_cb_info_recv_unexpected->actual_buf_size;
-
-        HG_LOG_SUBSYS_DEBUG(rpc,
-            "Processing input for handle %p, tag=%u, buf_size=%zu",
-            (void *) hg_core_handle, hg_core_handle->tag,
-            hg_core_handle->in_buf_used);
-
-        /* Process input information */
-        ret = hg_core_process_input(hg_core_handle);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process input");
-
-        /* Complete operation */
-        hg_core_complete_op(hg_core_handle);
-    } else if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_SUBSYS_WARNING(rpc,
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_SUBSYS_DEBUG(
-            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
-
-        /* Prevent re-initialization */
-        hg_core_handle->reuse = HG_FALSE;
-
-        /* Clean up handle */
-        (void) hg_core_destroy(hg_core_handle);
-    } else {
-        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+        if (timeout_ms != 0)
+            hg_time_get_current_ms(&now);
+    } while (hg_time_less(now, deadline));
 
-        /* Prevent re-initialization */
-        hg_core_handle->reuse = HG_FALSE;
+    ret = (ready != 0) ? HG_SUCCESS : HG_TIMEOUT;
 
-        /* Clean up handle */
-        (void) hg_core_destroy(hg_core_handle);
+done:
+    if (poll_set != NULL) {
+        for (i = 0; i < count; i++)
+            (void) hg_poll_remove(
+                poll_set, hg_poll_get_fd(contexts[i]->poll_set));
+        (void) hg_poll_destroy(poll_set);
     }
+    *ready_p = ready;
 
-    return;
-
-error:
-    /* Mark handle as errored */
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
-    hg_atomic_cas32(
-        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
-
-    /* Complete operation */
-    hg_core_complete_op(hg_core_handle);
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_core_multi_recv_input_cb(const struct na_cb_info *callback_info)
+static hg_return_t
+hg_core_progress_multi_wait(struct hg_core_private_context **contexts,
+    unsigned int count, struct hg_poll_set **poll_set_p,
+    unsigned int timeout_ms, hg_uint64_t *ready_p)
 {
-    struct hg_core_multi_recv_op *multi_recv_op =
-        (struct hg_core_multi_recv_op *) callback_info->arg;
-    struct hg_core_private_context *context = container_of(
-        multi_recv_op - multi_recv_op->id * (ptrdiff_t) sizeof(*multi_recv_op),
-        struct hg_core_private_context, multi_recv_ops);
-    const struct na_cb_info_multi_recv_unexpected
-        *na_cb_info_multi_recv_unexpected =
-            &callback_info->info.multi_recv_unexpected;
-    struct hg_core_private_handle *hg_core_handle = NULL;
+    struct hg_poll_event poll_events[HG_CORE_PROGRESS_MULTI_MAX];
+    struct hg_poll_set *poll_set = *poll_set_p;
+    unsigned int i, nevents = 0;
     hg_return_t ret;
+    int rc;
 
-    if (callback_info->ret == NA_SUCCESS) {
-        /* Get a new handle from the pool */
-        ret = hg_core_handle_pool_get(context->handle_pool, &hg_core_handle);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            rpc, error, ret, "Could not get handle from pool");
-        hg_core_handle->multi_recv_op = multi_recv_op;
-        hg_atomic_incr32(&multi_recv_op->op_count);
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_MULTI_RECV);
-
-        if (na_cb_info_multi_recv_unexpected->last) {
-            HG_LOG_SUBSYS_DEBUG(rpc,
-                "Multi-recv buffer %d has been consumed (%" PRId32
-                " operations completed)",
-                multi_recv_op->id, hg_atomic_get32(&multi_recv_op->op_count));
-            hg_atomic_set32(&multi_recv_op->last, HG_TRUE);
-            hg_atomic_decr32(&context->multi_recv_op_count);
+    /* Poll set of each context is added to a single poll set, it is only
+     * created once a blocking wait is needed */
+    if (poll_set == NULL) {
+        poll_set = hg_poll_create();
+        HG_CHECK_SUBSYS_ERROR(poll, poll_set == NULL, error, ret, HG_NOMEM,
+            "Could not create poll set");
+
+        for (i = 0; i < count; i++) {
+            struct hg_poll_event event = {.events = HG_POLLIN, .data.u64 = 0};
+            int fd = hg_poll_get_fd(contexts[i]->poll_set);
+
+            event.data.u32 = i;
+            rc = hg_poll_add(poll_set, fd, &event);
+            HG_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error_poll, ret,
+                HG_NOMEM, "hg_poll_add() failed (fd=%d)", fd);
         }
-        HG_CHECK_SUBSYS_WARNING(ctx,
-            hg_atomic_get32(&context->multi_recv_op_count) == 0,
-            "All multi-recv buffers have been consumed, consider increasing "
-            "request_post_init init info in order to increase buffer sizes");
+        *poll_set_p = poll_set;
+    }
 
-        /* Prevent from reposting multi-recv buffer until done with handle */
-        hg_atomic_incr32(&multi_recv_op->ref_count);
+    rc = hg_poll_wait(poll_set, timeout_ms, count, poll_events, &nevents);
 
-        /* Fill unexpected info */
-        hg_core_handle->na_addr = na_cb_info_multi_recv_unexpected->source;
-        hg_core_handle->core_handle.info.addr->na_addr =
-            hg_core_handle->na_addr;
-        hg_core_handle->tag = na_cb_info_multi_recv_unexpected->tag;
-        hg_core_handle->core_handle.in_buf_size =
-            na_cb_info_multi_recv_unexpected->actual_buf_size;
-        hg_core_handle->in_buf_used = hg_core_handle->core_handle.in_buf_size;
-        hg_core_handle->core_handle.in_buf =
-            na_cb_info_multi_recv_unexpected->actual_buf;
+    /* No longer need to notify when we're not waiting */
+    for (i = 0; i < count; i++)
+        hg_atomic_set32(&contexts[i]->loopback_notify.state, 0);
 
-        HG_LOG_SUBSYS_DEBUG(rpc,
-            "Processing input for handle %p, tag=%u, buf_size=%zu",
-            (void *) hg_core_handle, hg_core_handle->tag,
-            hg_core_handle->in_buf_used);
+    HG_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
+        HG_PROTOCOL_ERROR, "hg_poll_wait() failed");
 
-        /* Process input information */
-        ret = hg_core_process_input(hg_core_handle);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process input");
+    if (nevents == 1 && (poll_events[0].events & HG_POLLINTR))
+        return HG_SUCCESS;
 
-        /* Complete operation */
-        hg_core_complete_op(hg_core_handle);
-    } else if (callback_info->ret == NA_CANCELED) {
-        HG_LOG_SUBSYS_DEBUG(
-            rpc, "NA_CANCELED event on multi-recv op %d", multi_recv_op->id);
-        hg_atomic_decr32(&context->multi_recv_op_count);
-    } else {
-        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
-        hg_atomic_decr32(&context->multi_recv_op_count);
-        /* TODO can an unexpected multi-recv operation ever fail? */
+    /* Only contexts that have events are processed */
+    for (i = 0; i < nevents; i++) {
+        struct hg_core_private_context *context =
+            contexts[poll_events[i].data.u32];
+        hg_bool_t inline_ready = context->inline_ready, progressed = HG_FALSE;
+
+        context->inline_ready = context->inline_completion;
+        ret = hg_core_poll_wait(context, 0, HG_FALSE, &progressed);
+        context->inline_ready = inline_ready;
+        HG_CHECK_SUBSYS_HG_ERROR(poll, error, ret,
+            "Could not make non-blocking progress on context");
+
+        if (progressed || !hg_core_completion_queue_is_empty(context))
+            *ready_p |= (hg_uint64_t) 1 << poll_events[i].data.u32;
     }
 
-    return;
+    return HG_SUCCESS;
 
+error_poll:
+    while (i-- > 0)
+        (void) hg_poll_remove(
+            poll_set, hg_poll_get_fd(contexts[i]->poll_set));
+    (void) hg_poll_destroy(poll_set);
 error:
-    if (hg_core_handle == NULL)
-        return;
-
-    /* Mark handle as errored */
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
-    hg_atomic_cas32(
-        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
-
-    /* Complete operation */
-    hg_core_complete_op(hg_core_handle);
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_process_input(struct hg_core_private_handle *hg_core_handle)
+hg_core_progress_spin(struct hg_core_private_context *context,
+    hg_time_t deadline, hg_bool_t sampled, hg_bool_t *progressed_p)
 {
-    struct hg_core_private_class *hg_core_class =
-        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    hg_time_t now, spin_deadline;
     hg_return_t ret;
 
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
-    /* Increment counter */
-    hg_atomic_incr64(hg_core_class->counters.rpc_req_recv_count);
-#endif
+    hg_time_get_current(&now);
+    spin_deadline = hg_time_add(now,
+        hg_time_from_double(
+            (double) hg_atomic_get32(&context->spin_policy.budget) / 1e6));
+    if (hg_time_less(deadline, spin_deadline))
+        spin_deadline = deadline;
 
-    /* Get and verify input header */
-    ret = hg_core_proc_header_request(
-        &hg_core_handle->core_handle, &hg_core_handle->in_header, HG_DECODE);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Could not decode request header");
+    do {
+        /* Only poll when there may be something to process */
+        if (!hg_core_poll_try_wait(context)) {
+            hg_bool_t progressed = HG_FALSE;
 
-    /* Get operation ID from header */
-    hg_core_handle->core_handle.info.id =
-        hg_core_handle->in_header.msg.request.id;
-    hg_core_handle->cookie = hg_core_handle->in_header.msg.request.cookie;
-    /* TODO assign target ID from cookie directly for now */
-    hg_core_handle->core_handle.info.context_id = hg_core_handle->cookie;
+            ret = hg_core_poll(context, 0, sampled, &progressed);
+            HG_CHECK_SUBSYS_HG_ERROR(poll, error, ret,
+                "Could not make non-blocking progress on context");
 
-    /* Parse flags */
-    hg_core_handle->no_response =
-        hg_core_handle->in_header.msg.request.flags & HG_CORE_NO_RESPONSE;
+            if (progressed || !hg_core_completion_queue_is_empty(context)) {
+                *progressed_p = HG_TRUE;
+                return HG_SUCCESS;
+            }
+        }
+        cpu_spinwait();
+        hg_time_get_current(&now);
+    } while (hg_time_less(now, spin_deadline));
 
-    HG_LOG_SUBSYS_DEBUG(rpc,
-        "Processed input for handle %p, ID=%" PRIu64 ", cookie=%" PRIu8
-        ", no_response=%d",
-        (void *) hg_core_handle, hg_core_handle->core_handle.info.id,
-        hg_core_handle->cookie, hg_core_handle->no_response);
+    *progressed_p = HG_FALSE;
 
-    /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
-    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_MORE_DATA) {
-        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_class->more_data_cb.acquire == NULL,
-            error, ret, HG_OPNOTSUPPORTED,
-            "No callback defined for acquiring more data");
+    return HG_SUCCESS;
 
-        HG_LOG_SUBSYS_WARNING(perf,
-            "Must recv extra input data payload for handle %p",
-            (void *) hg_core_handle);
+error:
+    return ret;
+}
 
-        /* Increment number of expected operations */
-        hg_atomic_incr32(&hg_core_handle->op_expected_count);
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_spin_policy_update(
+    struct hg_core_spin_policy *spin_policy, hg_time_t wait_start)
+{
+    hg_time_t now;
+    double wait_us;
+    int32_t sample, wait_avg, budget;
 
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
-        /* Increment counter */
-        hg_atomic_incr64(hg_core_class->counters.rpc_req_extra_count);
+    hg_time_get_current(&now);
+    wait_us = hg_time_diff(now, wait_start) * 1e6;
+
+    /* Clamp long waits so that a single idle period does not prevent from
+     * spinning for a long time */
+    sample = (wait_us > (double) (16 * spin_policy->max))
+                 ? (int32_t) (16 * spin_policy->max)
+                 : (int32_t) wait_us;
+
+    /* Exponential moving average (1/8 weight for new samples) */
+    wait_avg = hg_atomic_get32(&spin_policy->wait_avg);
+    wait_avg += (sample - wait_avg) / 8;
+    hg_atomic_set32(&spin_policy->wait_avg, wait_avg);
+
+    /* Spin only if completions are expected to arrive within the max budget,
+     * leave headroom for arrival jitter */
+    if ((unsigned int) wait_avg > spin_policy->max)
+        budget = 0;
+    else
+        budget = MIN(2 * wait_avg + 1, (int32_t) spin_policy->max);
+    hg_atomic_set32(&spin_policy->budget, budget);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_poll_try_wait(struct hg_core_private_context *context)
+{
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    unsigned int i;
+
+    /* Something is in one of the completion queues */
+    if (!hg_core_completion_queue_is_empty(context))
+        return HG_FALSE;
+
+    /* An edge-triggered fd would not be reported again */
+    if (context->poll_pending)
+        return HG_FALSE;
+
+#ifdef NA_HAS_SM
+    if (context->core_context.core_class->na_sm_class &&
+        !NA_Poll_try_wait(context->core_context.core_class->na_sm_class,
+            context->core_context.na_sm_context))
+        return HG_FALSE;
 #endif
 
-        ret = hg_core_class->more_data_cb.acquire(
-            (hg_core_handle_t) hg_core_handle, HG_INPUT,
-            hg_core_more_data_complete);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
-            "Error in HG core handle more data acquire callback for handle %p",
-            (void *) hg_core_handle);
-    }
+    if (!NA_Poll_try_wait(context->core_context.core_class->na_class,
+            context->core_context.na_context))
+        return HG_FALSE;
 
-    return HG_SUCCESS;
+    for (i = 1; i < hg_core_class->rails.count; i++)
+        if (context->na_rail_contexts[i] &&
+            !NA_Poll_try_wait(hg_core_class->rails.rail[i].na_class,
+                context->na_rail_contexts[i]))
+            return HG_FALSE;
 
-error:
-    return ret;
+    return HG_TRUE;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE void
-hg_core_send_output_cb(const struct na_cb_info *callback_info)
+static hg_return_t
+hg_core_poll_wait(struct hg_core_private_context *context,
+    unsigned int timeout_ms, hg_bool_t sampled, hg_bool_t *progressed_p)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
+    struct hg_poll_event poll_events[HG_CORE_MAX_EVENTS]; /* Poll events */
+    unsigned int i, nevents;
+    hg_return_t ret;
+    hg_bool_t progressed = HG_FALSE;
+    hg_uint64_t wait_start = sampled ? hg_time_get_cycles() : 0;
+    int rc;
 
-    if (callback_info->ret == NA_SUCCESS) {
-        /* Nothing */
-    } else if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_SUBSYS_WARNING(rpc,
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_SUBSYS_DEBUG(
-            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
+    rc = hg_poll_wait(context->poll_set, timeout_ms, HG_CORE_MAX_EVENTS,
+        poll_events, &nevents);
+    if (sampled)
+        hg_core_profile_add(&context->profile.poll_wait_time, wait_start);
 
-        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
-            (int32_t) HG_CANCELED);
-    } else {
-        /* Mark handle as errored */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    /* No longer need to notify when we're not waiting */
+    hg_atomic_set32(&context->loopback_notify.state, 0);
 
-        /* Keep first non-success ret status */
-        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
-            (int32_t) callback_info->ret);
-        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+    HG_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
+        HG_PROTOCOL_ERROR, "hg_poll_wait() failed");
+
+    if (nevents == 1 && (poll_events[0].events & HG_POLLINTR)) {
+        HG_LOG_SUBSYS_DEBUG(poll_loop, "Interrupted");
+        *progressed_p = HG_FALSE;
+        return HG_SUCCESS;
     }
 
-    /* Complete operation */
-    hg_core_complete_op(hg_core_handle);
+    /* Process events */
+    for (i = 0; i < nevents; i++) {
+        hg_bool_t progressed_event = HG_FALSE;
+
+        switch (poll_events[i].data.u32) {
+            case HG_CORE_POLL_LOOPBACK:
+                HG_LOG_SUBSYS_DEBUG(poll_loop, "HG_CORE_POLL_LOOPBACK event");
+                ret = hg_core_progress_loopback_notify(
+                    context, &progressed_event);
+                HG_CHECK_SUBSYS_HG_ERROR(poll, error, ret,
+                    "hg_core_progress_loopback_notify() failed");
+                break;
+#ifdef NA_HAS_SM
+            case HG_CORE_POLL_SM:
+                HG_LOG_SUBSYS_DEBUG(poll_loop, "HG_CORE_POLL_SM event");
+
+                /* TODO force epoll_wait */
+                ret = hg_core_progress_na_drain(context,
+                    HG_CORE_CONTEXT_CLASS(context)->core_class.na_sm_class,
+                    context->core_context.na_sm_context, &progressed_event,
+                    HG_CORE_PROFILE(context, sampled, na_sm_time));
+                HG_CHECK_SUBSYS_HG_ERROR(
+                    poll, error, ret, "hg_core_progress_na_drain() failed");
+                break;
+#endif
+            case HG_CORE_POLL_NA:
+                HG_LOG_SUBSYS_DEBUG(poll_loop, "HG_CORE_POLL_NA event");
+
+                /* TODO force epoll_wait */
+                ret = hg_core_progress_na_drain(context,
+                    HG_CORE_CONTEXT_CLASS(context)->core_class.na_class,
+                    context->core_context.na_context, &progressed_event,
+                    HG_CORE_PROFILE(context, sampled, na_time));
+                HG_CHECK_SUBSYS_HG_ERROR(
+                    poll, error, ret, "hg_core_progress_na_drain() failed");
+                break;
+            default: {
+                /* Additional bulk rails */
+                unsigned int rail =
+                    poll_events[i].data.u32 - (uint32_t) HG_CORE_POLL_RAIL;
+
+                HG_CHECK_SUBSYS_ERROR(poll,
+                    poll_events[i].data.u32 < (uint32_t) HG_CORE_POLL_RAIL ||
+                        rail >= HG_CORE_RAIL_MAX ||
+                        context->na_rail_contexts[rail] == NULL,
+                    error, ret, HG_INVALID_ARG,
+                    "Invalid type of poll event (%d)",
+                    (int) poll_events[i].data.u32);
+                HG_LOG_SUBSYS_DEBUG(poll_loop, "HG_CORE_POLL_RAIL event");
+
+                ret = hg_core_progress_na_drain(context,
+                    HG_CORE_CONTEXT_CLASS(context)->rails.rail[rail].na_class,
+                    context->na_rail_contexts[rail], &progressed_event,
+                    HG_CORE_PROFILE(context, sampled, na_time));
+                HG_CHECK_SUBSYS_HG_ERROR(
+                    poll, error, ret, "hg_core_progress_na_drain() failed");
+                break;
+            }
+        }
+        progressed |= progressed_event;
+    }
+
+    *progressed_p = progressed;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE void
-hg_core_recv_output_cb(const struct na_cb_info *callback_info)
+static hg_return_t
+hg_core_poll(struct hg_core_private_context *context, unsigned int timeout_ms,
+    hg_bool_t sampled, hg_bool_t *progressed_p)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
+    struct hg_core_private_class *hg_core_class =
+        HG_CORE_CONTEXT_CLASS(context);
+    hg_bool_t progressed = HG_FALSE, progressed_na = HG_FALSE;
+    unsigned int progress_timeout, i;
     hg_return_t ret;
 
-    if (callback_info->ret == NA_SUCCESS) {
-        HG_LOG_SUBSYS_DEBUG(rpc, "Processing output for handle %p, tag=%u",
-            (void *) hg_core_handle, hg_core_handle->tag);
+    /* Poll over additional bulk rails (do not block on default NA then) */
+    for (i = 1; i < hg_core_class->rails.count; i++) {
+        if (context->na_rail_contexts[i] == NULL)
+            continue;
 
-        /* Process output information */
-        ret = hg_core_process_output(hg_core_handle, hg_core_send_ack);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process output");
+        ret = hg_core_progress_na(hg_core_class->rails.rail[i].na_class,
+            context->na_rail_contexts[i], 0, &progressed_na,
+            HG_CORE_PROFILE(context, sampled, na_time));
+        HG_CHECK_SUBSYS_HG_ERROR(
+            poll, error, ret, "hg_core_progress_na() failed");
 
-    } else if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_SUBSYS_WARNING(rpc,
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_SUBSYS_DEBUG(
-            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
+        progressed |= progressed_na;
+        timeout_ms = 0;
+    }
 
-        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
-            (int32_t) HG_CANCELED);
-    } else
-        HG_GOTO_SUBSYS_ERROR(rpc, error, ret, (hg_return_t) callback_info->ret,
-            "NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+#ifdef NA_HAS_SM
+    /* Poll over SM first if set */
+    if (context->core_context.na_sm_context) {
+        ret = hg_core_progress_na(hg_core_class->core_class.na_sm_class,
+            context->core_context.na_sm_context, 0, &progressed_na,
+            HG_CORE_PROFILE(context, sampled, na_sm_time));
+        HG_CHECK_SUBSYS_HG_ERROR(
+            poll, error, ret, "hg_core_progress_na() failed");
 
-    /* Complete operation */
-    hg_core_complete_op(hg_core_handle);
+        progressed |= progressed_na;
 
-    return;
+        progress_timeout = 0;
+    } else {
+#endif
+        progress_timeout = timeout_ms;
+#ifdef NA_HAS_SM
+    }
+#endif
 
-error:
-    /* Mark handle as errored */
-    hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
-    hg_atomic_cas32(
-        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+    /* Poll over defaut NA */
+    ret = hg_core_progress_na(hg_core_class->core_class.na_class,
+        context->core_context.na_context, progress_timeout, &progressed_na,
+        HG_CORE_PROFILE(context, sampled, na_time));
+    HG_CHECK_SUBSYS_HG_ERROR(poll, error, ret, "hg_core_progress_na() failed");
 
-    /* Complete operation */
-    hg_core_complete_op(hg_core_handle);
+    /* Nothing left to drain on any of the fds */
+    if (!(progressed | progressed_na))
+        context->poll_pending = HG_FALSE;
+
+    *progressed_p = progressed | progressed_na;
+
+    return HG_SUCCESS; /* TODO return HG_TIMEOUT ? */
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_process_output(struct hg_core_private_handle *hg_core_handle,
-    void (*done_callback)(hg_core_handle_t, hg_return_t))
+hg_core_progress_na(na_class_t *na_class, na_context_t *na_context,
+    unsigned int timeout_ms, hg_bool_t *progressed_p,
+    hg_atomic_int64_t *time_p)
 {
-    struct hg_core_private_class *hg_core_class =
-        HG_CORE_HANDLE_CLASS(hg_core_handle);
+    hg_time_t deadline, now = hg_time_from_ms(0);
+    hg_uint64_t start = (time_p != NULL) ? hg_time_get_cycles() : 0;
+    unsigned int completed_count = 0;
+    hg_bool_t progressed = HG_FALSE;
     hg_return_t ret;
 
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
-    /* Increment counter */
-    hg_atomic_incr64(hg_core_class->counters.rpc_resp_recv_count);
-#endif
-
-    /* Get and verify output header */
-    ret = hg_core_proc_header_response(
-        &hg_core_handle->core_handle, &hg_core_handle->out_header, HG_DECODE);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not decode header");
+    if (timeout_ms != 0)
+        hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
 
-    /* Get return code from header */
-    hg_atomic_set32(&hg_core_handle->ret_status,
-        (int32_t) hg_core_handle->out_header.msg.response.ret_code);
+    for (;;) {
+        unsigned int actual_count = 0;
+        na_return_t na_ret;
 
-    /* Parse flags */
+        /* Trigger everything we can from NA, if something completed it will
+         * be moved to the HG context completion queue */
+        do {
+            na_ret = NA_Trigger(
+                na_context, HG_CORE_MAX_TRIGGER_COUNT, &actual_count);
+            completed_count += actual_count;
+        } while (na_ret == NA_SUCCESS && actual_count > 0);
+        HG_CHECK_SUBSYS_ERROR(poll, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "NA_Trigger() failed (%s)",
+            NA_Error_to_string(na_ret));
 
-    HG_LOG_SUBSYS_DEBUG(rpc,
-        "Processed output for handle %p, ID=%" PRIu64 ", ret=%" PRId32,
-        (void *) hg_core_handle, hg_core_handle->core_handle.info.id,
-        hg_atomic_get32(&hg_core_handle->ret_status));
+        /* Progressed */
+        if (completed_count > 0) {
+            progressed = HG_TRUE;
+            break;
+        }
 
-    /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
-    if (hg_core_handle->out_header.msg.response.flags & HG_CORE_MORE_DATA) {
-        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_class->more_data_cb.acquire == NULL,
-            error, ret, HG_OPNOTSUPPORTED,
-            "No callback defined for acquiring more data");
+        /* Make sure that timeout of 0 enters progress */
+        if (timeout_ms != 0 && !hg_time_less(now, deadline))
+            break;
 
-        HG_LOG_SUBSYS_WARNING(perf,
-            "Must recv extra output data payload for handle %p",
-            (void *) hg_core_handle);
+        /* Otherwise try to make progress on NA */
+        na_ret = NA_Progress(na_class, na_context,
+            hg_time_to_ms(hg_time_subtract(deadline, now)));
 
-        /* Increment number of expected operations */
-        hg_atomic_incr32(&hg_core_handle->op_expected_count);
+        if (na_ret == NA_TIMEOUT)
+            break;
 
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
-        /* Increment counter */
-        hg_atomic_incr64(hg_core_class->counters.rpc_resp_extra_count);
-#endif
+        HG_CHECK_SUBSYS_ERROR(poll, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "NA_Progress() failed (%s)",
+            NA_Error_to_string(na_ret));
 
-        ret = hg_core_class->more_data_cb.acquire(
-            (hg_core_handle_t) hg_core_handle, HG_OUTPUT, done_callback);
-        HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
-            "Error in HG core handle more data acquire callback for handle %p",
-            (void *) hg_core_handle);
+        if (timeout_ms != 0)
+            hg_time_get_current_ms(&now);
     }
 
-    return HG_SUCCESS;
+    if (time_p != NULL)
+        hg_core_profile_add(time_p, start);
+
+    *progressed_p = progressed;
+
+    return HG_SUCCESS; /* TODO return HG_TIMEOUT ? */
 
 error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE void
-hg_core_more_data_complete(hg_core_handle_t handle, hg_return_t ret)
+static hg_return_t
+hg_core_progress_na_drain(struct hg_core_private_context *context,
+    na_class_t *na_class, na_context_t *na_context, hg_bool_t *progressed_p,
+    hg_atomic_int64_t *time_p)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) handle;
+    hg_bool_t progressed = HG_FALSE, progressed_na = HG_FALSE;
+    unsigned int i;
+    hg_return_t ret;
 
-    if (ret != HG_SUCCESS) {
-        if (ret != HG_CANCELED) {
-            /* Mark handle as errored */
-            hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
-        }
-        hg_atomic_cas32(
-            &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+    /* Level-triggered fds are reported again by the next wait */
+    if (!HG_CORE_CONTEXT_CLASS(context)->init_info.poll_edge_triggered)
+        return hg_core_progress_na(
+            na_class, na_context, 0, progressed_p, time_p);
+
+    for (i = 0; i < HG_CORE_POLL_DRAIN_MAX; i++) {
+        ret = hg_core_progress_na(
+            na_class, na_context, 0, &progressed_na, time_p);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            poll, error, ret, "hg_core_progress_na() failed");
+        if (!progressed_na)
+            break;
+        progressed = HG_TRUE;
     }
 
-    /* Complete and add to completion queue */
-    hg_core_complete_op(hg_core_handle);
+    /* Remaining events must be processed before blocking again, completions
+     * are left for trigger to consume in the meantime */
+    if (progressed_na)
+        context->poll_pending = HG_TRUE;
+
+    *progressed_p = progressed;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-hg_core_send_ack(hg_core_handle_t handle, hg_return_t ret)
+static HG_INLINE hg_uint64_t
+hg_core_profile_elapsed(hg_uint64_t start)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) handle;
-    na_return_t na_ret;
-    size_t buf_size = handle->na_out_header_offset + sizeof(hg_uint8_t);
+    hg_uint64_t end = hg_time_get_cycles();
 
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Aborting ack send");
+    /* Counters of different CPUs may not be perfectly synchronized */
+    return (end > start) ? end - start : 0;
+}
 
-    /* Keep the buffer allocated if we are prone to using ack buffers */
-    if (hg_core_handle->ack_buf == NULL) {
-        /* Allocate buffer for ack */
-        hg_core_handle->ack_buf = NA_Msg_buf_alloc(hg_core_handle->na_class,
-            buf_size, NA_SEND, &hg_core_handle->ack_buf_plugin_data);
-        HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->ack_buf == NULL, error, ret,
-            HG_NOMEM, "Could not allocate buffer for ack");
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_profile_add(hg_atomic_int64_t *time_p, hg_uint64_t start)
+{
+    hg_atomic_add64(
+        time_p, (int64_t) hg_time_cycles_to_ns(hg_core_profile_elapsed(start)));
+}
 
-        na_ret = NA_Msg_init_expected(
-            hg_core_handle->na_class, hg_core_handle->ack_buf, buf_size);
-        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not initialize ack buffer (%s)",
-            NA_Error_to_string(na_ret));
-    }
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_loopback_arm(struct hg_core_private_context *context)
+{
+    int32_t state;
 
-    /* Post expected send (ack) */
-    na_ret = NA_Msg_send_expected(hg_core_handle->na_class,
-        hg_core_handle->na_context, hg_core_ack_cb, hg_core_handle,
-        hg_core_handle->ack_buf, buf_size, hg_core_handle->ack_buf_plugin_data,
-        hg_core_handle->na_addr, hg_core_handle->core_handle.info.context_id,
-        hg_core_handle->tag, hg_core_handle->na_ack_op_id);
-    /* Expected sends should always succeed after retry */
-    HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-        (hg_return_t) na_ret, "Could not post send for ack buffer (%s)",
-        NA_Error_to_string(na_ret));
+    /* Clear any signal left from a previous wait, completions pushed before
+     * this RMW are visible to the queue checks that follow it */
+    do {
+        state = hg_atomic_get32(&context->loopback_notify.state);
+    } while (!hg_atomic_cas32(
+        &context->loopback_notify.state, state, HG_CORE_LOOPBACK_WAITING));
+}
 
-    return;
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_loopback_signal(struct hg_core_private_context *context)
+{
+    int32_t state;
 
-error:
-    if (hg_core_handle->ack_buf != NULL) {
-        NA_Msg_buf_free(hg_core_handle->na_class, hg_core_handle->ack_buf,
-            hg_core_handle->ack_buf_plugin_data);
-        hg_core_handle->ack_buf = NULL;
-        hg_core_handle->ack_buf_plugin_data = NULL;
-    }
-    /* Mark handle as errored */
-    if (ret != HG_CANCELED)
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
-    hg_atomic_cas32(
-        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+    if (context->loopback_notify.event <= 0)
+        return;
 
-    /* Complete and add to completion queue */
-    hg_core_complete_op(hg_core_handle);
+    /* Only the first completion that follows a blocking wait pays for the
+     * event, others only update the wait word */
+    state = hg_atomic_or32(
+        &context->loopback_notify.state, HG_CORE_LOOPBACK_SIGNALED);
+    if (state == HG_CORE_LOOPBACK_WAITING) {
+        int rc = hg_event_set(context->loopback_notify.event);
+        HG_CHECK_SUBSYS_ERROR_DONE(poll, rc != HG_UTIL_SUCCESS,
+            "Could not signal completion queue");
+    }
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE void
-hg_core_ack_cb(const struct na_cb_info *callback_info)
+static HG_INLINE hg_return_t
+hg_core_progress_loopback_notify(
+    struct hg_core_private_context *context, hg_bool_t *progressed_p)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->arg;
+    hg_return_t ret;
+    int rc;
+    bool progressed;
 
-    if (callback_info->ret == NA_SUCCESS) {
-        /* Nothing */
-    } else if (callback_info->ret == NA_CANCELED) {
-        HG_CHECK_SUBSYS_WARNING(rpc,
-            hg_atomic_get32(&hg_core_handle->status) & HG_CORE_OP_COMPLETED,
-            "Operation was completed");
-        HG_LOG_SUBSYS_DEBUG(
-            rpc, "NA_CANCELED event on handle %p", (void *) hg_core_handle);
+    /* TODO we should be able to safely remove EFD_SEMAPHORE behavior */
+    rc = hg_event_get(context->loopback_notify.event, &progressed);
+    HG_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
+        HG_PROTOCOL_ERROR, "Could not get loopback event notification");
 
-        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
-            (int32_t) HG_CANCELED);
-    } else {
-        /* Mark handle as errored */
-        hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_ERRORED);
+    /* Semaphore count would not be reported again if edge-triggered */
+    if (progressed &&
+        HG_CORE_CONTEXT_CLASS(context)->init_info.poll_edge_triggered) {
+        bool signaled;
 
-        /* Keep first non-success ret status */
-        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
-            (int32_t) callback_info->ret);
-        HG_LOG_SUBSYS_ERROR(rpc, "NA callback returned error (%s)",
-            NA_Error_to_string(callback_info->ret));
+        do {
+            rc = hg_event_get(context->loopback_notify.event, &signaled);
+            HG_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
+                HG_PROTOCOL_ERROR,
+                "Could not get loopback event notification");
+        } while (signaled);
     }
 
-    /* Complete operation */
-    hg_core_complete_op(hg_core_handle);
+    *progressed_p = (hg_bool_t) progressed;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_self_cb(const struct hg_core_cb_info *callback_info)
+hg_core_trigger(struct hg_core_private_context *context,
+    unsigned int timeout_ms, unsigned int max_count,
+    unsigned int *actual_count_p, unsigned int *remaining_count_p)
 {
-    struct hg_core_private_handle *hg_core_handle =
-        (struct hg_core_private_handle *) callback_info->info.respond.handle;
-    int32_t HG_DEBUG_LOG_USED ref_count;
-    hg_return_t ret;
-
-    /* Increment number of expected operations */
-    hg_atomic_incr32(&hg_core_handle->op_expected_count);
-
-    /* First execute response callback */
-    if (hg_core_handle->response_callback) {
-        struct hg_core_cb_info hg_core_cb_info;
-
-        hg_core_cb_info.arg = hg_core_handle->response_arg;
-        hg_core_cb_info.ret = HG_SUCCESS; /* TODO report failure */
-        hg_core_cb_info.type = HG_CB_RESPOND;
-        hg_core_cb_info.info.respond.handle = (hg_core_handle_t) hg_core_handle;
+    struct hg_core_completion_wait *completion_wait = &context->completion_wait;
+    struct hg_completion_entry *entries[HG_CORE_TRIGGER_BATCH_SIZE];
+    hg_time_t deadline, now = hg_time_from_ms(0);
+    hg_uint64_t profile_start = 0, wait_time = 0;
+    hg_bool_t sampled = HG_FALSE;
+    unsigned int count = 0;
+    hg_return_t ret = HG_SUCCESS;
 
-        hg_core_handle->response_callback(&hg_core_cb_info);
+    /* Sample calls so that profiling remains cheap */
+    if (hg_atomic_incr64(&context->profile.trigger_count) %
+            HG_CORE_PROFILE_SAMPLE_RATE ==
+        0) {
+        sampled = HG_TRUE;
+        profile_start = hg_time_get_cycles();
     }
 
-    /* Assign forward callback back to handle */
-    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+    if (timeout_ms != 0)
+        hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
 
-    /* Increment refcount and push handle back to completion queue */
-    ref_count = hg_atomic_incr32(&hg_core_handle->ref_count);
-    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count incr to %" PRId32,
-        (void *) hg_core_handle, ref_count);
+    while (count < max_count) {
+        unsigned int batch_count = MIN(
+            max_count - count, (unsigned int) HG_CORE_TRIGGER_BATCH_SIZE);
+        hg_uint64_t callback_start;
+        unsigned int i, n_entries;
+
+        /* Reserve as many entries as possible at once */
+        n_entries =
+            hg_core_completion_queue_pop(context, entries, batch_count);
+        if (n_entries == 0) {
+            /* If something was already processed leave */
+            if (count > 0)
+                break;
 
-    /* Process output */
-    ret = hg_core_process_output(hg_core_handle, hg_core_more_data_complete);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process output");
+            /* Timeout is 0 so leave */
+            if (!hg_time_less(now, deadline)) {
+                ret = HG_TIMEOUT;
+                break;
+            }
 
-    /* Mark as completed */
-    hg_core_complete_op(hg_core_handle);
+            hg_thread_mutex_lock(&completion_wait->mutex);
+            /* Register before checking the queue again so that completions
+             * pushed from now on signal the condition */
+            hg_atomic_incr32(&completion_wait->waiters);
+            /* Otherwise wait remaining ms */
+            if (hg_core_completion_queue_is_empty(context)) {
+                hg_uint64_t wait_start = sampled ? hg_time_get_cycles() : 0;
+
+                if (hg_thread_cond_timedwait(&completion_wait->cond,
+                        &completion_wait->mutex,
+                        hg_time_to_ms(hg_time_subtract(deadline, now))) !=
+                    HG_UTIL_SUCCESS)
+                    ret = HG_TIMEOUT; /* Timeout occurred so leave */
+                if (sampled)
+                    wait_time += hg_core_profile_elapsed(wait_start);
+            }
+            hg_atomic_decr32(&completion_wait->waiters);
+            hg_thread_mutex_unlock(&completion_wait->mutex);
+            if (ret == HG_TIMEOUT)
+                break;
 
-    return HG_SUCCESS;
+            if (timeout_ms != 0)
+                hg_time_get_current_ms(&now);
+            continue; /* Give another change to grab it */
+        }
 
-error:
-    hg_atomic_cas32(
-        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+        /* Entries are now owned by us, trigger all of them even if one of
+         * them fails so that none gets lost */
+        callback_start = sampled ? hg_time_get_cycles() : 0;
+        for (i = 0; i < n_entries; i++) {
+            hg_return_t trigger_ret =
+                hg_core_trigger_completion_entry(entries[i]);
+            if (trigger_ret != HG_SUCCESS && ret == HG_SUCCESS)
+                ret = trigger_ret;
+        }
+        if (sampled)
+            hg_core_profile_add(
+                &context->profile.callback_time, callback_start);
+        count += n_entries;
+        HG_CHECK_SUBSYS_HG_ERROR(
+            poll, done, ret, "Could not trigger completion entries");
+    }
 
-    /* Mark as completed */
-    hg_core_complete_op(hg_core_handle);
+done:
+    if (actual_count_p)
+        *actual_count_p = count;
+    if (remaining_count_p)
+        *remaining_count_p = hg_core_completion_queue_count(context);
+
+    if (sampled) {
+        hg_uint64_t total = hg_core_profile_elapsed(profile_start);
+
+        /* Time spent waiting is idle time */
+        hg_atomic_add64(&context->profile.trigger_wait_time,
+            (int64_t) hg_time_cycles_to_ns(wait_time));
+        hg_atomic_add64(&context->profile.trigger_time,
+            (int64_t) hg_time_cycles_to_ns(
+                (total > wait_time) ? total - wait_time : 0));
+        hg_atomic_incr64(&context->profile.trigger_samples);
+    }
 
-    return HG_SUCCESS;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_process_self(struct hg_core_private_handle *hg_core_handle)
+static void
+hg_core_completion_queue_free(struct hg_core_private_context *context)
 {
-    hg_return_t ret;
+    if (context->completion_high != NULL)
+        hg_atomic_seg_queue_free(context->completion_high);
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_PROCESS;
+    if (context->completion_shards != NULL) {
+        unsigned int i;
 
-    /* Process input */
-    ret = hg_core_process_input(hg_core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret, "Could not process input");
+        for (i = 0; i < context->n_completion_shards; i++)
+            hg_atomic_seg_queue_free(context->completion_shards[i]);
+        free(context->completion_shards);
+    } else
+        hg_atomic_seg_queue_free(context->completion_queue);
+}
 
-    /* Mark as completed */
-    hg_core_complete_op(hg_core_handle);
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int
+hg_core_completion_queue_push(struct hg_core_private_context *context,
+    struct hg_completion_entry *hg_completion_entry, hg_bool_t high)
+{
+    unsigned int shard;
 
-    return HG_SUCCESS;
+    if (high)
+        return hg_atomic_seg_queue_push(
+            context->completion_high, hg_completion_entry);
 
-error:
-    hg_atomic_cas32(
-        &hg_core_handle->ret_status, (int32_t) HG_SUCCESS, (int32_t) ret);
+    if (context->completion_shards == NULL)
+        return hg_atomic_seg_queue_push(
+            context->completion_queue, hg_completion_entry);
 
-    /* Mark as completed */
-    hg_core_complete_op(hg_core_handle);
+    /* Distribute entries across shards */
+    shard = (unsigned int) hg_atomic_incr32(&context->completion_shard_next);
 
-    return HG_SUCCESS;
+    return hg_atomic_seg_queue_push(
+        context->completion_shards[shard % context->n_completion_shards],
+        hg_completion_entry);
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_process(struct hg_core_private_handle *hg_core_handle)
-{
-    struct hg_core_rpc_info *hg_core_rpc_info;
-    int32_t HG_DEBUG_LOG_USED ref_count;
-    hg_return_t ret;
-
-    /* Retrieve exe function from function map */
-    hg_core_rpc_info =
-        hg_core_map_lookup(&HG_CORE_HANDLE_CLASS(hg_core_handle)->rpc_map,
-            &hg_core_handle->core_handle.info.id);
-    if (hg_core_rpc_info == NULL) {
-        HG_LOG_SUBSYS_WARNING(rpc,
-            "Could not find RPC ID (%" PRIu64 ") in RPC map",
-            hg_core_handle->core_handle.info.id);
-        HG_GOTO_DONE(error, ret, HG_NOENTRY);
+static HG_INLINE unsigned int
+hg_core_completion_queue_pop(struct hg_core_private_context *context,
+    struct hg_completion_entry **entries, unsigned int max_count)
+{
+    uint64_t self_hash;
+    unsigned int i, home, count;
+
+    /* High priority entries are triggered first */
+    count = hg_atomic_seg_queue_pop_batch(
+        context->completion_high, (void **) entries, max_count);
+    if (count > 0)
+        return count;
+
+    if (context->completion_shards == NULL)
+        return hg_atomic_seg_queue_pop_batch(
+            context->completion_queue, (void **) entries, max_count);
+
+    /* Each thread has a home shard, only steal from other shards if empty */
+    self_hash = (uint64_t) (uintptr_t) hg_thread_self() * 0x9E3779B97F4A7C15ULL;
+    home = (unsigned int) ((self_hash >> 32) % context->n_completion_shards);
+    for (i = 0; i < context->n_completion_shards; i++) {
+        count = hg_atomic_seg_queue_pop_batch(
+            context->completion_shards[(home + i) %
+                                       context->n_completion_shards],
+            (void **) entries, max_count);
+        if (count > 0)
+            return count;
     }
-    // HG_CHECK_SUBSYS_ERROR(rpc, hg_core_rpc_info == NULL, error, ret,
-    // HG_NOENTRY,
-    //     "Could not find RPC ID (%" PRIu64 ") in RPC map",
-    //     hg_core_handle->core_handle.info.id);
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_rpc_info->rpc_cb == NULL, error, ret,
-        HG_INVALID_ARG, "No RPC callback registered");
 
-    /* Cache RPC info */
-    hg_core_handle->core_handle.rpc_info = hg_core_rpc_info;
+    return 0;
+}
 
-    /* Increment ref count here so that a call to HG_Destroy in user's RPC
-     * callback does not free the handle but only schedules its completion
-     */
-    ref_count = hg_atomic_incr32(&hg_core_handle->ref_count);
-    HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count incr to %" PRId32,
-        (void *) hg_core_handle, ref_count);
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_completion_queue_is_empty(struct hg_core_private_context *context)
+{
+    unsigned int i;
 
-    /* Execute RPC callback */
-    ret = hg_core_rpc_info->rpc_cb((hg_core_handle_t) hg_core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        rpc, error, ret, "Error while executing RPC callback");
+    if (!hg_atomic_seg_queue_is_empty(context->completion_high))
+        return HG_FALSE;
 
-    return HG_SUCCESS;
+    if (context->completion_shards == NULL)
+        return hg_atomic_seg_queue_is_empty(context->completion_queue);
 
-error:
-    return ret;
+    for (i = 0; i < context->n_completion_shards; i++)
+        if (!hg_atomic_seg_queue_is_empty(context->completion_shards[i]))
+            return HG_FALSE;
+
+    return HG_TRUE;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE void
-hg_core_complete_op(struct hg_core_private_handle *hg_core_handle)
+static HG_INLINE unsigned int
+hg_core_completion_queue_count(struct hg_core_private_context *context)
 {
-    int32_t op_completed_count =
-                hg_atomic_incr32(&hg_core_handle->op_completed_count),
-            op_expected_count =
-                hg_atomic_get32(&hg_core_handle->op_expected_count);
+    unsigned int i, count = hg_atomic_seg_queue_count(context->completion_high);
 
-    HG_LOG_SUBSYS_DEBUG(rpc,
-        "Completed %" PRId32 "/%" PRId32 " NA operations for handle (%p)",
-        op_completed_count, op_expected_count, (void *) hg_core_handle);
+    if (context->completion_shards == NULL)
+        return count + hg_atomic_seg_queue_count(context->completion_queue);
 
-    /* Add handle to completion queue when expected operations have
-     * completed */
-    if (op_completed_count == op_expected_count)
-        hg_core_complete(hg_core_handle,
-            (hg_return_t) hg_atomic_get32(&hg_core_handle->ret_status));
+    for (i = 0; i < context->n_completion_shards; i++)
+        count += hg_atomic_seg_queue_count(context->completion_shards[i]);
+
+    return count;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE void
-hg_core_complete(struct hg_core_private_handle *hg_core_handle, hg_return_t ret)
+static hg_return_t
+hg_core_trigger_completion_entry(
+    struct hg_completion_entry *hg_completion_entry)
 {
-    /* Mark op id as completed, also mark the operation as queued to track
-     * when it will be released from the completion queue. */
-    hg_atomic_or32(
-        &hg_core_handle->status, HG_CORE_OP_COMPLETED | HG_CORE_OP_QUEUED);
+    hg_return_t ret;
 
-    /* Forward status to callback */
-    hg_core_handle->ret = ret;
+    switch (hg_completion_entry->op_type) {
+        case HG_ADDR:
+            ret = hg_core_trigger_lookup_entry(
+                hg_completion_entry->op_id.hg_core_op_id);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                poll, error, ret, "Could not trigger addr completion entry");
+            break;
+        case HG_RPC:
+            ret = hg_core_trigger_entry((struct hg_core_private_handle *)
+                                            hg_completion_entry->op_id
+                                                .hg_core_handle);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                poll, error, ret, "Could not trigger RPC completion entry");
+            break;
+        case HG_BULK:
+            ret = hg_bulk_trigger_entry(
+                hg_completion_entry->op_id.hg_bulk_op_id);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                poll, error, ret, "Could not trigger bulk completion entry");
+            break;
+        case HG_STREAM:
+            ret = hg_core_trigger_stream_entry(
+                (struct hg_core_private_handle *)
+                    hg_completion_entry->op_id.hg_core_handle);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                poll, error, ret, "Could not trigger stream completion entry");
+            break;
+        default:
+            HG_GOTO_SUBSYS_ERROR(poll, error, ret, HG_INVALID_ARG,
+                "Invalid type of completion entry (%d)",
+                (int) hg_completion_entry->op_type);
+    }
 
-    hg_core_handle->hg_completion_entry.op_type = HG_RPC;
-    hg_core_handle->hg_completion_entry.op_id.hg_core_handle =
-        (hg_core_handle_t) hg_core_handle;
+    return HG_SUCCESS;
 
-    hg_core_completion_add(hg_core_handle->core_handle.info.context,
-        &hg_core_handle->hg_completion_entry, hg_core_handle->is_self);
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void
-hg_core_completion_add(struct hg_core_context *core_context,
-    struct hg_completion_entry *hg_completion_entry, hg_bool_t loopback_notify)
+static hg_return_t
+hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id)
 {
-    struct hg_core_private_context *context =
-        (struct hg_core_private_context *) core_context;
-    struct hg_core_completion_queue *backfill_queue = &context->backfill_queue;
-    int rc;
-
-#if defined(HG_HAS_DEBUG) && !defined(_WIN32)
-    /* Increment counter */
-    if (hg_completion_entry->op_type == HG_BULK)
-        hg_atomic_incr64(HG_CORE_CONTEXT_CLASS(context)->counters.bulk_count);
-#endif
+    /* Execute callback */
+    if (hg_core_op_id->callback) {
+        struct hg_core_cb_info hg_core_cb_info;
 
-    rc = hg_atomic_queue_push(context->completion_queue, hg_completion_entry);
-    if (rc != HG_UTIL_SUCCESS) {
-        HG_LOG_SUBSYS_WARNING(perf, "Atomic completion queue is full, pushing "
-                                    "completion data to backfill queue");
+        hg_core_cb_info.arg = hg_core_op_id->arg;
+        hg_core_cb_info.ret = HG_SUCCESS;
+        hg_core_cb_info.type = hg_core_op_id->type;
+        hg_core_cb_info.info.lookup.addr =
+            (hg_core_addr_t) hg_core_op_id->info.lookup.hg_core_addr;
 
-        /* Queue is full */
-        hg_thread_mutex_lock(&backfill_queue->mutex);
-        HG_QUEUE_PUSH_TAIL(&backfill_queue->queue, hg_completion_entry, entry);
-        hg_atomic_incr32(&backfill_queue->count);
-        hg_thread_mutex_unlock(&backfill_queue->mutex);
+        hg_core_op_id->callback(&hg_core_cb_info);
     }
 
-    /* Callback is pushed to the completion queue when something completes
-     * so wake up anyone waiting in trigger */
-    hg_thread_mutex_lock(&backfill_queue->mutex);
-    hg_thread_cond_signal(&backfill_queue->cond);
-    hg_thread_mutex_unlock(&backfill_queue->mutex);
-
-    if (loopback_notify && context->loopback_notify.event > 0) {
-        hg_thread_mutex_lock(&context->loopback_notify.mutex);
-        /* Do not bother notifying if it's not needed as any event call will
-         * increase latency */
-        if (hg_atomic_get32(&context->loopback_notify.must_notify)) {
-            rc = hg_event_set(context->loopback_notify.event);
-            HG_CHECK_SUBSYS_ERROR_NORET(poll, rc != HG_UTIL_SUCCESS, unlock,
-                "Could not signal completion queue");
-        }
-unlock:
-        hg_thread_mutex_unlock(&context->loopback_notify.mutex);
-    }
+    /* NB. OK to free after callback execution, op ID is not re-used */
+    free(hg_core_op_id);
+
+    return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_progress(
-    struct hg_core_private_context *context, unsigned int timeout_ms)
+hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle)
 {
-    hg_time_t deadline, now = hg_time_from_ms(0);
     hg_return_t ret;
 
-    if (timeout_ms != 0)
-        hg_time_get_current_ms(&now);
-    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
+    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_QUEUED);
 
-    do {
-        hg_bool_t safe_wait = HG_FALSE, progressed = HG_FALSE;
-        unsigned int poll_timeout = 0;
+    if (hg_core_handle->op_type == HG_CORE_PROCESS) {
+        struct hg_peer_stats *peer_stats;
+        int32_t HG_DEBUG_LOG_USED ref_count;
 
-        /* Bypass notifications if timeout_ms is 0 to prevent system calls
-         */
-        if (timeout_ms == 0) {
-            ; // nothing to do
-        } else if (context->poll_set) {
-            hg_thread_mutex_lock(&context->loopback_notify.mutex);
+        if (hg_core_handle->admitted)
+            hg_core_admission_dequeue(hg_core_handle);
+
+        /* Simply exit if error occurred */
+        if (hg_core_handle->ret != HG_SUCCESS) {
+            peer_stats = hg_core_peer_lock_handle(hg_core_handle);
+            if (peer_stats != NULL) {
+                peer_stats->error_count++;
+                hg_core_peer_unlock(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
+            }
+            HG_GOTO_DONE(done, ret, HG_SUCCESS);
+        }
+
+        /* Take another reference to make sure the handle only gets freed
+         * after the response is sent */
+        ref_count = hg_core_handle_ref_incr(hg_core_handle);
+        HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count incr to %" PRId32,
+            (void *) hg_core_handle, ref_count);
+
+        /* Save ref_count, when sending to self and no response is being sent,
+         * we can only use that refcount to determine that the RPC callback has
+         * been fully executed. */
+        if (hg_core_handle->is_self && hg_core_handle->no_response)
+            hg_atomic_set32(&hg_core_handle->no_response_done, ref_count);
+
+        /* Run RPC callback */
+        ret = hg_core_process(hg_core_handle);
+        if (ret != HG_SUCCESS && !hg_core_handle->no_response) {
+            hg_size_t header_size =
+                hg_core_header_response_get_size() +
+                hg_core_handle->core_handle.na_out_header_offset;
+
+            /* Respond in case of error */
+            ret = hg_core_respond(
+                hg_core_handle, NULL, NULL, 0, header_size, ret, NULL);
+            HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not respond");
+        }
+
+        /* Without response, handler time is the time spent in the callback */
+        if (hg_core_handle->no_response && hg_core_handle->handler_start != 0) {
+            hg_uint64_t now = hg_time_get_cycles();
+
+            hg_core_histogram_record_time(
+                &((struct hg_core_private_rpc_info *)
+                        hg_core_handle->core_handle.rpc_info)
+                     ->handler,
+                hg_core_handle->handler_start, now);
+            if (unlikely(HG_CORE_HANDLE_CLASS(hg_core_handle)->capture.file))
+                hg_core_capture(hg_core_handle, 0, now);
+            hg_core_handle->handler_start = 0;
+        }
+
+        /* No response callback */
+        if (hg_core_handle->no_response && !hg_core_handle->is_self) {
+            ret = hg_core_handle->ops.no_respond(hg_core_handle);
+            HG_CHECK_SUBSYS_HG_ERROR(
+                rpc, done, ret, "Could not complete handle");
+        }
+    } else {
+        struct hg_core_private_rpc_info *hg_core_rpc_info =
+            (struct hg_core_private_rpc_info *)
+                hg_core_handle->core_handle.rpc_info;
+        hg_core_cb_t hg_cb = NULL;
+        struct hg_core_cb_info hg_core_cb_info;
 
-            if (hg_core_poll_try_wait(context)) {
-                safe_wait = HG_TRUE;
-                poll_timeout = hg_time_to_ms(hg_time_subtract(deadline, now));
+        /* Stats */
+        if (hg_core_handle->ret != HG_SUCCESS &&
+            (hg_core_handle->op_type == HG_CORE_FORWARD ||
+                hg_core_handle->op_type == HG_CORE_RESPOND)) {
+            struct hg_peer_stats *peer_stats =
+                hg_core_peer_lock_handle(hg_core_handle);
 
-                /* We need to be notified when doing blocking progress */
-                hg_atomic_set32(&context->loopback_notify.must_notify, 1);
+            if (peer_stats != NULL) {
+                peer_stats->error_count++;
+                hg_core_peer_unlock(HG_CORE_HANDLE_CONTEXT(hg_core_handle));
             }
-            hg_thread_mutex_unlock(&context->loopback_notify.mutex);
-        } else if (!HG_CORE_CONTEXT_CLASS(context)->init_info.loopback &&
-                   hg_core_poll_try_wait(context)) {
-            /* This is the case for NA plugins that don't expose a fd */
-            poll_timeout = hg_time_to_ms(hg_time_subtract(deadline, now));
         }
-
-        /* Only enter blocking wait if it is safe to */
-        if (safe_wait) {
-            ret = hg_core_poll_wait(context, poll_timeout, &progressed);
-            HG_CHECK_SUBSYS_HG_ERROR(poll, error, ret,
-                "Could not make blocking progress on context");
-        } else {
-            ret = hg_core_poll(context, poll_timeout, &progressed);
-            HG_CHECK_SUBSYS_HG_ERROR(poll, error, ret,
-                "Could not make non-blocking progress on context");
+        if (hg_core_rpc_info != NULL) {
+            hg_uint64_t now = hg_time_get_cycles();
+
+            hg_core_histogram_record_time(&hg_core_rpc_info->queue_wait,
+                hg_core_handle->queue_start, now);
+            if ((hg_core_handle->op_type == HG_CORE_FORWARD ||
+                    hg_core_handle->op_type == HG_CORE_FORWARD_SELF) &&
+                hg_core_handle->ret == HG_SUCCESS)
+                hg_core_histogram_record_time(&hg_core_rpc_info->latency,
+                    hg_core_handle->forward_start, now);
         }
 
-        /* We progressed or we have something to trigger */
-        if (progressed ||
-            !hg_atomic_queue_is_empty(context->completion_queue) ||
-            hg_atomic_get32(&context->backfill_queue.count) > 0)
-            return HG_SUCCESS;
+        hg_core_cb_info.ret = hg_core_handle->ret;
 
-        if (timeout_ms != 0)
-            hg_time_get_current_ms(&now);
-    } while (hg_time_less(now, deadline));
+        switch (hg_core_handle->op_type) {
+            case HG_CORE_FORWARD_SELF:
+            case HG_CORE_FORWARD:
+                hg_cb = hg_core_handle->request_callback;
+                hg_core_cb_info.arg = hg_core_handle->request_arg;
+                hg_core_cb_info.type = HG_CB_FORWARD;
+                hg_core_cb_info.info.forward.handle =
+                    (hg_core_handle_t) hg_core_handle;
+                HG_CORE_TRACE_EVENT(hg_core_handle, HG_TRACE_COMPLETE);
+                break;
+            case HG_CORE_RESPOND:
+                hg_cb = hg_core_handle->response_callback;
+                hg_core_cb_info.arg = hg_core_handle->response_arg;
+                hg_core_cb_info.type = HG_CB_RESPOND;
+                hg_core_cb_info.info.respond.handle =
+                    (hg_core_handle_t) hg_core_handle;
+                break;
+            case HG_CORE_RESPOND_SELF:
+                hg_cb = hg_core_self_cb;
+                hg_core_cb_info.arg = hg_core_handle->response_arg;
+                hg_core_cb_info.type = HG_CB_RESPOND;
+                hg_core_cb_info.info.respond.handle =
+                    (hg_core_handle_t) hg_core_handle;
+                break;
+            case HG_CORE_NO_RESPOND:
+                /* Nothing */
+                break;
+            case HG_CORE_PROCESS:
+            default:
+                HG_GOTO_SUBSYS_ERROR(rpc, done, ret, HG_OPNOTSUPPORTED,
+                    "Invalid core operation type");
+        }
+
+        /* Execute user callback.
+         * NB. The handle cannot be destroyed before the callback execution
+         * as the user may carry the handle in the callback. */
+        if (hg_cb)
+            hg_cb(&hg_core_cb_info);
+    }
 
-    return HG_TIMEOUT;
+done:
+    /* Reuse handle if we were listening, otherwise destroy it */
+    ret = hg_core_destroy(hg_core_handle);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not destroy handle");
 
-error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_bool_t
-hg_core_poll_try_wait(struct hg_core_private_context *context)
+static hg_return_t
+hg_core_trigger_stream_entry(struct hg_core_private_handle *hg_core_handle)
 {
-    /* Something is in one of the completion queues */
-    if (!hg_atomic_queue_is_empty(context->completion_queue) ||
-        (hg_atomic_get32(&context->backfill_queue.count) > 0))
-        return HG_FALSE;
+    struct hg_core_stream *stream = hg_core_handle->stream;
 
-#ifdef NA_HAS_SM
-    if (context->core_context.core_class->na_sm_class &&
-        !NA_Poll_try_wait(context->core_context.core_class->na_sm_class,
-            context->core_context.na_sm_context))
-        return HG_FALSE;
-#endif
+    /* Only the origin receives chunks */
+    if (stream->chunks != NULL) {
+        hg_core_stream_process(hg_core_handle);
+        return HG_SUCCESS;
+    }
 
-    if (!NA_Poll_try_wait(context->core_context.core_class->na_class,
-            context->core_context.na_context))
-        return HG_FALSE;
+    /* Partial response was sent, another one can be posted */
+    hg_thread_spin_lock(&stream->lock);
+    stream->busy = HG_FALSE;
+    hg_thread_spin_unlock(&stream->lock);
 
-    return HG_TRUE;
+    if (stream->callback != NULL) {
+        struct hg_core_cb_info hg_core_cb_info;
+
+        hg_core_cb_info.arg = stream->arg;
+        hg_core_cb_info.ret = stream->ret;
+        hg_core_cb_info.type = HG_CB_RESPOND;
+        hg_core_cb_info.info.respond.handle = (hg_core_handle_t) hg_core_handle;
+
+        stream->callback(&hg_core_cb_info);
+    }
+
+    return HG_SUCCESS;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_poll_wait(struct hg_core_private_context *context,
-    unsigned int timeout_ms, hg_bool_t *progressed_p)
+hg_core_cancel(
+    struct hg_core_private_handle *hg_core_handle, hg_return_t ret_status)
 {
-    struct hg_poll_event poll_events[HG_CORE_MAX_EVENTS]; /* Poll events */
-    unsigned int i, nevents;
     hg_return_t ret;
-    hg_bool_t progressed = HG_FALSE;
-    int rc;
-
-    rc = hg_poll_wait(context->poll_set, timeout_ms, HG_CORE_MAX_EVENTS,
-        poll_events, &nevents);
-
-    /* No longer need to notify when we're not waiting */
-    hg_atomic_set32(&context->loopback_notify.must_notify, 0);
+    int32_t status;
 
-    HG_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
-        HG_PROTOCOL_ERROR, "hg_poll_wait() failed");
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->is_self, error, ret,
+        HG_OPNOTSUPPORTED, "Local cancellation is not supported");
 
-    if (nevents == 1 && (poll_events[0].events & HG_POLLINTR)) {
-        HG_LOG_SUBSYS_DEBUG(poll_loop, "Interrupted");
-        *progressed_p = HG_FALSE;
+    /* Exit if op has already completed */
+    status = hg_atomic_get32(&hg_core_handle->status);
+    if ((status & HG_CORE_OP_COMPLETED) || (status & HG_CORE_OP_ERRORED) ||
+        (status & HG_CORE_OP_CANCELED))
         return HG_SUCCESS;
-    }
-
-    /* Process events */
-    for (i = 0; i < nevents; i++) {
-        hg_bool_t progressed_event = HG_FALSE;
 
-        switch (poll_events[i].data.u32) {
-            case HG_CORE_POLL_LOOPBACK:
-                HG_LOG_SUBSYS_DEBUG(poll_loop, "HG_CORE_POLL_LOOPBACK event");
-                ret = hg_core_progress_loopback_notify(
-                    context, &progressed_event);
-                HG_CHECK_SUBSYS_HG_ERROR(poll, error, ret,
-                    "hg_core_progress_loopback_notify() failed");
-                break;
-#ifdef NA_HAS_SM
-            case HG_CORE_POLL_SM:
-                HG_LOG_SUBSYS_DEBUG(poll_loop, "HG_CORE_POLL_SM event");
+    /* Let only one thread call NA_Cancel() */
+    status = hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED);
+    if (status & HG_CORE_OP_CANCELED)
+        return HG_SUCCESS;
 
-                /* TODO force epoll_wait */
-                ret = hg_core_progress_na(
-                    HG_CORE_CONTEXT_CLASS(context)->core_class.na_sm_class,
-                    context->core_context.na_sm_context, 0, &progressed_event);
-                HG_CHECK_SUBSYS_HG_ERROR(
-                    poll, error, ret, "hg_core_progress_na() failed");
-                break;
-#endif
-            case HG_CORE_POLL_NA:
-                HG_LOG_SUBSYS_DEBUG(poll_loop, "HG_CORE_POLL_NA event");
+    /* Report status other than cancelation, unless operation completed */
+    if (ret_status != HG_CANCELED && !(status & HG_CORE_OP_COMPLETED))
+        hg_atomic_cas32(&hg_core_handle->ret_status, (int32_t) HG_SUCCESS,
+            (int32_t) ret_status);
+
+    /* Cancel all NA operations issued, unexpected responses were not
+     * pre-posted */
+    if (hg_core_handle->unexpected_response)
+        hg_core_response_cancel(hg_core_handle);
+    else if (hg_core_handle->stream != NULL &&
+             hg_core_handle->stream_credits > 0)
+        hg_core_stream_cancel(hg_core_handle);
+    else if (hg_core_handle->na_recv_op_id != NULL) {
+        na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_handle->na_recv_op_id);
+        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not cancel recv op id (%s)",
+            NA_Error_to_string(na_ret));
+    }
 
-                /* TODO force epoll_wait */
-                ret = hg_core_progress_na(
-                    HG_CORE_CONTEXT_CLASS(context)->core_class.na_class,
-                    context->core_context.na_context, 0, &progressed_event);
-                HG_CHECK_SUBSYS_HG_ERROR(
-                    poll, error, ret, "hg_core_progress_na() failed");
-                break;
-            default:
-                HG_GOTO_SUBSYS_ERROR(poll, error, ret, HG_INVALID_ARG,
-                    "Invalid type of poll event (%d)",
-                    (int) poll_events[i].data.u32);
-        }
-        progressed |= progressed_event;
+    /* Requests held back for coalescing have not been posted yet */
+    if (!hg_core_coalesce_cancel(hg_core_handle) &&
+        hg_core_handle->na_send_op_id != NULL) {
+        na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_handle->na_send_op_id);
+        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not cancel send op id (%s)",
+            NA_Error_to_string(na_ret));
     }
 
-    *progressed_p = progressed;
+    if (hg_core_handle->ack != NULL) {
+        na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_handle->ack->na_op_id);
+        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
+            (hg_return_t) na_ret, "Could not cancel ack op id (%s)",
+            NA_Error_to_string(na_ret));
+    }
 
     return HG_SUCCESS;
 
@@ -5139,124 +13667,133 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_poll(struct hg_core_private_context *context, unsigned int timeout_ms,
-    hg_bool_t *progressed_p)
+hg_return_t
+HG_Core_get_na_protocol_info(
+    const char *info_string, struct na_protocol_info **na_protocol_info_p)
 {
-    struct hg_core_private_class *hg_core_class =
-        HG_CORE_CONTEXT_CLASS(context);
-    hg_bool_t progressed = HG_FALSE, progressed_na = HG_FALSE;
-    unsigned int progress_timeout;
-    hg_return_t ret;
+    return (hg_return_t) NA_Get_protocol_info(info_string, na_protocol_info_p);
+}
 
-#ifdef NA_HAS_SM
-    /* Poll over SM first if set */
-    if (context->core_context.na_sm_context) {
-        ret = hg_core_progress_na(hg_core_class->core_class.na_sm_class,
-            context->core_context.na_sm_context, 0, &progressed_na);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            poll, error, ret, "hg_core_progress_na() failed");
+/*---------------------------------------------------------------------------*/
+void
+HG_Core_free_na_protocol_info(struct na_protocol_info *na_protocol_info)
+{
+    NA_Free_protocol_info(na_protocol_info);
+}
 
-        progressed |= progressed_na;
+/*---------------------------------------------------------------------------*/
+hg_core_class_t *
+HG_Core_init(const char *na_info_string, hg_bool_t na_listen)
+{
+    struct hg_core_private_class *hg_core_class;
+    hg_return_t ret;
 
-        progress_timeout = 0;
-    } else {
-#endif
-        progress_timeout = timeout_ms;
-#ifdef NA_HAS_SM
-    }
-#endif
+    HG_LOG_SUBSYS_DEBUG(
+        cls, "Initializing with %s, listen=%d", na_info_string, na_listen);
 
-    /* Poll over defaut NA */
-    ret = hg_core_progress_na(hg_core_class->core_class.na_class,
-        context->core_context.na_context, progress_timeout, &progressed_na);
-    HG_CHECK_SUBSYS_HG_ERROR(poll, error, ret, "hg_core_progress_na() failed");
+    ret = hg_core_init(na_info_string, na_listen, 0, NULL, &hg_core_class);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret, "Cannot initialize core class");
 
-    *progressed_p = progressed | progressed_na;
+    HG_LOG_SUBSYS_DEBUG(
+        cls, "Initialized core class (%p)", (void *) hg_core_class);
 
-    return HG_SUCCESS; /* TODO return HG_TIMEOUT ? */
+    return (hg_core_class_t *) hg_core_class;
 
 error:
-    return ret;
+    return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_progress_na(na_class_t *na_class, na_context_t *na_context,
-    unsigned int timeout_ms, hg_bool_t *progressed_p)
+hg_core_class_t *
+HG_Core_init_opt(const char *na_info_string, hg_bool_t na_listen,
+    const struct hg_init_info *hg_init_info)
 {
-    hg_time_t deadline, now = hg_time_from_ms(0);
-    unsigned int completed_count = 0;
-    hg_bool_t progressed = HG_FALSE;
+    struct hg_core_private_class *hg_core_class;
     hg_return_t ret;
 
-    if (timeout_ms != 0)
-        hg_time_get_current_ms(&now);
-    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
+    HG_LOG_SUBSYS_DEBUG(
+        cls, "Initializing with %s, listen=%d", na_info_string, na_listen);
 
-    for (;;) {
-        unsigned int actual_count = 0;
-        na_return_t na_ret;
+    /* v2.2 is latest version for which init struct was not versioned */
+    ret = hg_core_init(na_info_string, na_listen, HG_VERSION(2, 2),
+        hg_init_info, &hg_core_class);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret, "Cannot initialize core class");
 
-        /* Trigger everything we can from NA, if something completed it will
-         * be moved to the HG context completion queue */
-        do {
-            na_ret = NA_Trigger(
-                na_context, HG_CORE_MAX_TRIGGER_COUNT, &actual_count);
-            completed_count += actual_count;
-        } while (na_ret == NA_SUCCESS && actual_count > 0);
-        HG_CHECK_SUBSYS_ERROR(poll, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "NA_Trigger() failed (%s)",
-            NA_Error_to_string(na_ret));
+    HG_LOG_SUBSYS_DEBUG(
+        cls, "Initialized core class (%p)", (void *) hg_core_class);
+
+    return (hg_core_class_t *) hg_core_class;
+
+error:
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_core_class_t *
+HG_Core_init_opt2(const char *na_info_string, hg_bool_t na_listen,
+    unsigned int version, const struct hg_init_info *hg_init_info)
+{
+    struct hg_core_private_class *hg_core_class;
+    hg_return_t ret;
 
-        /* Progressed */
-        if (completed_count > 0) {
-            progressed = HG_TRUE;
-            break;
-        }
+    HG_LOG_SUBSYS_DEBUG(
+        cls, "Initializing with %s, listen=%d", na_info_string, na_listen);
 
-        /* Make sure that timeout of 0 enters progress */
-        if (timeout_ms != 0 && !hg_time_less(now, deadline))
-            break;
+    ret = hg_core_init(
+        na_info_string, na_listen, version, hg_init_info, &hg_core_class);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret, "Cannot initialize core class");
 
-        /* Otherwise try to make progress on NA */
-        na_ret = NA_Progress(na_class, na_context,
-            hg_time_to_ms(hg_time_subtract(deadline, now)));
+    HG_LOG_SUBSYS_DEBUG(
+        cls, "Initialized core class (%p)", (void *) hg_core_class);
 
-        if (na_ret == NA_TIMEOUT)
-            break;
+    return (hg_core_class_t *) hg_core_class;
 
-        HG_CHECK_SUBSYS_ERROR(poll, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "NA_Progress() failed (%s)",
-            NA_Error_to_string(na_ret));
+error:
+    return NULL;
+}
 
-        if (timeout_ms != 0)
-            hg_time_get_current_ms(&now);
-    }
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_finalize(hg_core_class_t *hg_core_class)
+{
+    hg_return_t ret;
 
-    *progressed_p = progressed;
+    HG_LOG_SUBSYS_DEBUG(
+        cls, "Finalizing core class (%p)", (void *) hg_core_class);
 
-    return HG_SUCCESS; /* TODO return HG_TIMEOUT ? */
+    ret = hg_core_finalize((struct hg_core_private_class *) hg_core_class);
+    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
+        "Cannot finalize HG core class (%p)", (void *) hg_core_class);
+
+    return HG_SUCCESS;
 
 error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE hg_return_t
-hg_core_progress_loopback_notify(
-    struct hg_core_private_context *context, hg_bool_t *progressed_p)
+void
+HG_Core_cleanup(void)
+{
+    NA_Cleanup();
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_set_more_data_callback(struct hg_core_class *hg_core_class,
+    hg_return_t (*more_data_acquire_callback)(hg_core_handle_t, hg_op_t,
+        void (*done_callback)(hg_core_handle_t, hg_return_t)),
+    void (*more_data_release_callback)(hg_core_handle_t))
 {
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
     hg_return_t ret;
-    int rc;
-    bool progressed;
 
-    /* TODO we should be able to safely remove EFD_SEMAPHORE behavior */
-    rc = hg_event_get(context->loopback_notify.event, &progressed);
-    HG_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
-        HG_PROTOCOL_ERROR, "Could not get loopback event notification");
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
 
-    *progressed_p = (hg_bool_t) progressed;
+    private_class->more_data_cb.acquire = more_data_acquire_callback;
+    private_class->more_data_cb.release = more_data_release_callback;
 
     return HG_SUCCESS;
 
@@ -5265,278 +13802,242 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_trigger(struct hg_core_private_context *context,
-    unsigned int timeout_ms, unsigned int max_count,
-    unsigned int *actual_count_p)
+hg_core_context_t *
+HG_Core_context_create(hg_core_class_t *hg_core_class)
 {
-    hg_time_t deadline, now = hg_time_from_ms(0);
-    unsigned int count = 0;
-    hg_return_t ret = HG_SUCCESS;
+    struct hg_core_private_context *context;
+    hg_return_t ret;
 
-    if (timeout_ms != 0)
-        hg_time_get_current_ms(&now);
-    deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        ctx, hg_core_class == NULL, error, "NULL HG core class");
 
-    while (count < max_count) {
-        struct hg_completion_entry *hg_completion_entry = NULL;
-
-        hg_completion_entry = hg_atomic_queue_pop_mc(context->completion_queue);
-        if (!hg_completion_entry) {
-            struct hg_core_completion_queue *backfill_queue =
-                &context->backfill_queue;
-
-            /* Check backfill queue */
-            if (hg_atomic_get32(&backfill_queue->count) > 0) {
-                hg_thread_mutex_lock(&backfill_queue->mutex);
-                if (hg_atomic_get32(&backfill_queue->count) > 0) {
-                    hg_completion_entry =
-                        HG_QUEUE_FIRST(&backfill_queue->queue);
-                    HG_QUEUE_POP_HEAD(&backfill_queue->queue, entry);
-                    hg_atomic_decr32(&backfill_queue->count);
-                }
-                hg_thread_mutex_unlock(&backfill_queue->mutex);
-                if (hg_completion_entry == NULL)
-                    continue; /* Give another change to grab it */
-            } else {
-                /* If something was already processed leave */
-                if (count > 0)
-                    break;
-
-                /* Timeout is 0 so leave */
-                if (!hg_time_less(now, deadline)) {
-                    ret = HG_TIMEOUT;
-                    break;
-                }
+    HG_LOG_SUBSYS_DEBUG(ctx, "Creating new context with id=%u", 0);
 
-                hg_thread_mutex_lock(&backfill_queue->mutex);
-                /* Otherwise wait remaining ms */
-                if (hg_atomic_queue_is_empty(context->completion_queue) &&
-                    hg_atomic_get32(&backfill_queue->count) == 0) {
-                    if (hg_thread_cond_timedwait(&backfill_queue->cond,
-                            &backfill_queue->mutex,
-                            hg_time_to_ms(hg_time_subtract(deadline, now))) !=
-                        HG_UTIL_SUCCESS)
-                        ret = HG_TIMEOUT; /* Timeout occurred so leave */
-                }
-                hg_thread_mutex_unlock(&backfill_queue->mutex);
-                if (ret == HG_TIMEOUT)
-                    break;
+    ret = hg_core_context_create(
+        (struct hg_core_private_class *) hg_core_class, 0, NULL, &context);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not create context");
 
-                if (timeout_ms != 0)
-                    hg_time_get_current_ms(&now);
-                continue; /* Give another change to grab it */
-            }
-        }
+    HG_LOG_SUBSYS_DEBUG(ctx, "Created new context (%p)", (void *) context);
 
-        /* Completion queue should not be empty now */
-        HG_CHECK_SUBSYS_ERROR(poll, hg_completion_entry == NULL, done, ret,
-            HG_FAULT, "NULL completion entry");
+    return (hg_core_context_t *) context;
 
-        /* Trigger entry */
-        switch (hg_completion_entry->op_type) {
-            case HG_ADDR:
-                ret = hg_core_trigger_lookup_entry(
-                    hg_completion_entry->op_id.hg_core_op_id);
-                HG_CHECK_SUBSYS_HG_ERROR(
-                    poll, done, ret, "Could not trigger addr completion entry");
-                break;
-            case HG_RPC:
-                ret = hg_core_trigger_entry(
-                    (struct hg_core_private_handle *)
-                        hg_completion_entry->op_id.hg_core_handle);
-                HG_CHECK_SUBSYS_HG_ERROR(
-                    poll, done, ret, "Could not trigger RPC completion entry");
-                break;
-            case HG_BULK:
-                ret = hg_bulk_trigger_entry(
-                    hg_completion_entry->op_id.hg_bulk_op_id);
-                HG_CHECK_SUBSYS_HG_ERROR(
-                    poll, done, ret, "Could not trigger bulk completion entry");
-                break;
-            default:
-                HG_GOTO_SUBSYS_ERROR(poll, done, ret, HG_INVALID_ARG,
-                    "Invalid type of completion entry (%d)",
-                    (int) hg_completion_entry->op_type);
-        }
+error:
+    return NULL;
+}
 
-        count++;
-    }
+/*---------------------------------------------------------------------------*/
+hg_core_context_t *
+HG_Core_context_create_id(hg_core_class_t *hg_core_class, hg_uint8_t id)
+{
+    struct hg_core_private_context *context;
+    hg_return_t ret;
 
-    if (actual_count_p)
-        *actual_count_p = count;
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        ctx, hg_core_class == NULL, error, "NULL HG core class");
 
-done:
-    return ret;
+    HG_LOG_SUBSYS_DEBUG(ctx, "Creating new context with id=%u", id);
+
+    ret = hg_core_context_create(
+        (struct hg_core_private_class *) hg_core_class, id, NULL, &context);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        ctx, error, ret, "Could not create context with id=%u", id);
+
+    HG_LOG_SUBSYS_DEBUG(ctx, "Created new context (%p)", (void *) context);
+
+    return (hg_core_context_t *) context;
+
+error:
+    return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id)
+hg_core_context_t *
+HG_Core_context_create_opt(hg_core_class_t *hg_core_class, hg_uint8_t id,
+    const struct hg_context_info *info)
 {
-    /* Execute callback */
-    if (hg_core_op_id->callback) {
-        struct hg_core_cb_info hg_core_cb_info;
+    const struct na_context_info *na_context_info =
+        (info != NULL) ? &info->na_context_info : NULL;
+    struct hg_core_private_context *context;
+    hg_cpu_set_t cpu_mask, prev_mask;
+    bool bound = false;
+    hg_return_t ret;
+    int rc;
 
-        hg_core_cb_info.arg = hg_core_op_id->arg;
-        hg_core_cb_info.ret = HG_SUCCESS;
-        hg_core_cb_info.type = HG_CB_LOOKUP;
-        hg_core_cb_info.info.lookup.addr =
-            (hg_core_addr_t) hg_core_op_id->info.lookup.hg_core_addr;
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        ctx, hg_core_class == NULL, error, "NULL HG core class");
 
-        hg_core_op_id->callback(&hg_core_cb_info);
+    HG_LOG_SUBSYS_DEBUG(ctx, "Creating new context with id=%u", id);
+
+    /* Bind calling thread so that context memory gets allocated locally on
+     * first touch, NA contexts are placed by NA_Context_create_opt() */
+    if (na_context_info != NULL &&
+        (na_context_info->cpus != NULL || na_context_info->numa_node >= 0) &&
+        hg_thread_cpu_mask_init(na_context_info->cpus,
+            na_context_info->cpu_count, na_context_info->numa_node,
+            &cpu_mask) == HG_UTIL_SUCCESS &&
+        hg_thread_getaffinity(hg_thread_self(), &prev_mask) ==
+            HG_UTIL_SUCCESS &&
+        hg_thread_setaffinity(hg_thread_self(), &cpu_mask) == HG_UTIL_SUCCESS)
+        bound = true;
+
+    ret = hg_core_context_create((struct hg_core_private_class *) hg_core_class,
+        id, na_context_info, &context);
+    if (ret == HG_SUCCESS && info != NULL)
+        context->inline_completion = info->inline_completion;
+
+    if (bound) {
+        rc = hg_thread_setaffinity(hg_thread_self(), &prev_mask);
+        HG_CHECK_SUBSYS_WARNING(ctx, rc != HG_UTIL_SUCCESS,
+            "Could not restore calling thread affinity");
     }
+    HG_CHECK_SUBSYS_HG_ERROR(
+        ctx, error, ret, "Could not create context with id=%u", id);
 
-    /* NB. OK to free after callback execution, op ID is not re-used */
-    free(hg_core_op_id);
+    HG_LOG_SUBSYS_DEBUG(ctx, "Created new context (%p)", (void *) context);
 
-    return HG_SUCCESS;
+    return (hg_core_context_t *) context;
+
+error:
+    return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_trigger_entry(struct hg_core_private_handle *hg_core_handle)
+hg_return_t
+HG_Core_context_destroy(hg_core_context_t *context)
 {
     hg_return_t ret;
 
-    hg_atomic_and32(&hg_core_handle->status, ~HG_CORE_OP_QUEUED);
-
-    if (hg_core_handle->op_type == HG_CORE_PROCESS) {
-        int32_t HG_DEBUG_LOG_USED ref_count;
-
-        /* Simply exit if error occurred */
-        if (hg_core_handle->ret != HG_SUCCESS)
-            HG_GOTO_DONE(done, ret, HG_SUCCESS);
-
-        /* Take another reference to make sure the handle only gets freed
-         * after the response is sent */
-        ref_count = hg_atomic_incr32(&hg_core_handle->ref_count);
-        HG_LOG_SUBSYS_DEBUG(rpc_ref, "Handle (%p) ref_count incr to %" PRId32,
-            (void *) hg_core_handle, ref_count);
+    HG_LOG_SUBSYS_DEBUG(ctx, "Destroying context (%p)", (void *) context);
 
-        /* Save ref_count, when sending to self and no response is being sent,
-         * we can only use that refcount to determine that the RPC callback has
-         * been fully executed. */
-        if (hg_core_handle->is_self && hg_core_handle->no_response)
-            hg_atomic_set32(&hg_core_handle->no_response_done, ref_count);
+    ret = hg_core_context_destroy((struct hg_core_private_context *) context,
+        HG_CORE_CLEANUP_TIMEOUT, HG_FALSE);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        ctx, error, ret, "Could not destroy context (%p)", (void *) context);
 
-        /* Run RPC callback */
-        ret = hg_core_process(hg_core_handle);
-        if (ret != HG_SUCCESS && !hg_core_handle->no_response) {
-            hg_size_t header_size =
-                hg_core_header_response_get_size() +
-                hg_core_handle->core_handle.na_out_header_offset;
+    return HG_SUCCESS;
 
-            /* Respond in case of error */
-            ret = hg_core_respond(
-                hg_core_handle, NULL, NULL, 0, header_size, ret);
-            HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not respond");
-        }
+error:
+    return ret;
+}
 
-        /* No response callback */
-        if (hg_core_handle->no_response && !hg_core_handle->is_self) {
-            ret = hg_core_handle->ops.no_respond(hg_core_handle);
-            HG_CHECK_SUBSYS_HG_ERROR(
-                rpc, done, ret, "Could not complete handle");
-        }
-    } else {
-        hg_core_cb_t hg_cb = NULL;
-        struct hg_core_cb_info hg_core_cb_info;
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_destroy_multi(
+    hg_core_context_t *contexts[], unsigned int count, hg_bool_t quiescent)
+{
+    unsigned int i;
+    hg_return_t ret;
 
-        hg_core_cb_info.ret = hg_core_handle->ret;
+    HG_CHECK_SUBSYS_ERROR(ctx, contexts == NULL && count > 0, error, ret,
+        HG_INVALID_ARG, "NULL context array");
+    for (i = 0; i < count; i++)
+        HG_CHECK_SUBSYS_ERROR(ctx, contexts[i] == NULL, error, ret,
+            HG_INVALID_ARG, "NULL HG core context (index %u)", i);
 
-        switch (hg_core_handle->op_type) {
-            case HG_CORE_FORWARD_SELF:
-            case HG_CORE_FORWARD:
-                hg_cb = hg_core_handle->request_callback;
-                hg_core_cb_info.arg = hg_core_handle->request_arg;
-                hg_core_cb_info.type = HG_CB_FORWARD;
-                hg_core_cb_info.info.forward.handle =
-                    (hg_core_handle_t) hg_core_handle;
-                break;
-            case HG_CORE_RESPOND:
-                hg_cb = hg_core_handle->response_callback;
-                hg_core_cb_info.arg = hg_core_handle->response_arg;
-                hg_core_cb_info.type = HG_CB_RESPOND;
-                hg_core_cb_info.info.respond.handle =
-                    (hg_core_handle_t) hg_core_handle;
-                break;
-            case HG_CORE_RESPOND_SELF:
-                hg_cb = hg_core_self_cb;
-                hg_core_cb_info.arg = hg_core_handle->response_arg;
-                hg_core_cb_info.type = HG_CB_RESPOND;
-                hg_core_cb_info.info.respond.handle =
-                    (hg_core_handle_t) hg_core_handle;
-                break;
-            case HG_CORE_NO_RESPOND:
-                /* Nothing */
-                break;
-            case HG_CORE_PROCESS:
-            default:
-                HG_GOTO_SUBSYS_ERROR(rpc, done, ret, HG_OPNOTSUPPORTED,
-                    "Invalid core operation type");
-        }
+    HG_LOG_SUBSYS_DEBUG(ctx, "Destroying %u contexts (quiescent=%d)", count,
+        (int) quiescent);
 
-        /* Execute user callback.
-         * NB. The handle cannot be destroyed before the callback execution
-         * as the user may carry the handle in the callback. */
-        if (hg_cb)
-            hg_cb(&hg_core_cb_info);
-    }
+    ret = hg_core_context_destroy_multi(
+        (struct hg_core_private_context **) contexts, count, quiescent);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not destroy contexts");
 
-done:
-    /* Reuse handle if we were listening, otherwise destroy it */
-    ret = hg_core_destroy(hg_core_handle);
-    HG_CHECK_SUBSYS_HG_ERROR(rpc, done, ret, "Could not destroy handle");
+    return HG_SUCCESS;
 
+error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_cancel(struct hg_core_private_handle *hg_core_handle)
+unsigned int
+HG_Core_context_get_spin_budget(hg_core_context_t *context)
 {
-    hg_return_t ret;
-    int32_t status;
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        ctx, context == NULL, error, "NULL HG core context");
 
-    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle->is_self, error, ret,
-        HG_OPNOTSUPPORTED, "Local cancellation is not supported");
+    return (unsigned int) hg_atomic_get32(
+        &((struct hg_core_private_context *) context)->spin_policy.budget);
 
-    /* Exit if op has already completed */
-    status = hg_atomic_get32(&hg_core_handle->status);
-    if ((status & HG_CORE_OP_COMPLETED) || (status & HG_CORE_OP_ERRORED) ||
-        (status & HG_CORE_OP_CANCELED))
-        return HG_SUCCESS;
+error:
+    return 0;
+}
 
-    /* Let only one thread call NA_Cancel() */
-    if (hg_atomic_or32(&hg_core_handle->status, HG_CORE_OP_CANCELED) &
-        HG_CORE_OP_CANCELED)
-        return HG_SUCCESS;
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_get_progress_stats(
+    hg_core_context_t *context, struct hg_progress_stats *stats)
+{
+    struct hg_core_progress_profile *profile;
+    double idle, total;
+    hg_return_t ret;
 
-    /* Cancel all NA operations issued */
-    if (hg_core_handle->na_recv_op_id != NULL) {
-        na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_handle->na_recv_op_id);
-        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not cancel recv op id (%s)",
-            NA_Error_to_string(na_ret));
-    }
+    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG core context");
+    HG_CHECK_SUBSYS_ERROR(
+        ctx, stats == NULL, error, ret, HG_INVALID_ARG, "NULL stats");
+    profile = &((struct hg_core_private_context *) context)->profile;
+
+    stats->progress_count =
+        (hg_uint64_t) hg_atomic_get64(&profile->progress_count);
+    stats->progress_samples =
+        (hg_uint64_t) hg_atomic_get64(&profile->progress_samples);
+    stats->trigger_count =
+        (hg_uint64_t) hg_atomic_get64(&profile->trigger_count);
+    stats->trigger_samples =
+        (hg_uint64_t) hg_atomic_get64(&profile->trigger_samples);
+    stats->progress_time =
+        (hg_uint64_t) hg_atomic_get64(&profile->progress_time);
+    stats->poll_wait_time =
+        (hg_uint64_t) hg_atomic_get64(&profile->poll_wait_time);
+    stats->na_time = (hg_uint64_t) hg_atomic_get64(&profile->na_time);
+    stats->na_sm_time = (hg_uint64_t) hg_atomic_get64(&profile->na_sm_time);
+    stats->trigger_time =
+        (hg_uint64_t) hg_atomic_get64(&profile->trigger_time);
+    stats->trigger_wait_time =
+        (hg_uint64_t) hg_atomic_get64(&profile->trigger_wait_time);
+    stats->callback_time =
+        (hg_uint64_t) hg_atomic_get64(&profile->callback_time);
+
+    idle = (double) (stats->poll_wait_time + stats->trigger_wait_time);
+    total = (double) (stats->progress_time + stats->trigger_time +
+                      stats->trigger_wait_time);
+    stats->idle_ratio = (total > 0.0) ? MIN(idle / total, 1.0) : 0.0;
+    stats->busy_ratio = (total > 0.0) ? 1.0 - stats->idle_ratio : 0.0;
 
-    if (hg_core_handle->na_send_op_id != NULL) {
-        na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_handle->na_send_op_id);
-        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not cancel send op id (%s)",
-            NA_Error_to_string(na_ret));
-    }
+    return HG_SUCCESS;
 
-    if (hg_core_handle->na_ack_op_id != NULL) {
-        na_return_t na_ret = NA_Cancel(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_handle->na_ack_op_id);
-        HG_CHECK_SUBSYS_ERROR(rpc, na_ret != NA_SUCCESS, error, ret,
-            (hg_return_t) na_ret, "Could not cancel ack op id (%s)",
-            NA_Error_to_string(na_ret));
-    }
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_get_handle_stats(
+    hg_core_context_t *context, struct hg_handle_stats *stats)
+{
+    struct hg_core_private_context *private_context =
+        (struct hg_core_private_context *) context;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG core context");
+    HG_CHECK_SUBSYS_ERROR(
+        ctx, stats == NULL, error, ret, HG_INVALID_ARG, "NULL stats");
+
+    memset(stats, 0, sizeof(*stats));
+    stats->handle_count =
+        (hg_uint64_t) hg_atomic_get32(&private_context->n_handles);
+    stats->queued_count =
+        (hg_uint64_t) hg_atomic_get32(&private_context->admission.queued);
+    stats->shed_count =
+        (hg_uint64_t) hg_atomic_get64(&private_context->admission.shed_count);
+    stats->mem_used = (hg_uint64_t) hg_atomic_get64(
+        &HG_CORE_CONTEXT_CLASS(private_context)->mem_budget.used);
+    if (private_context->handle_pool != NULL)
+        hg_core_handle_pool_get_stats(private_context->handle_pool, stats);
+#ifdef NA_HAS_SM
+    if (private_context->sm_handle_pool != NULL)
+        hg_core_handle_pool_get_stats(private_context->sm_handle_pool, stats);
+#endif
 
     return HG_SUCCESS;
 
@@ -5546,102 +14047,149 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_get_na_protocol_info(
-    const char *info_string, struct na_protocol_info **na_protocol_info_p)
+HG_Core_context_get_handle_age(hg_core_context_t *context, hg_id_t id,
+    hg_uint32_t *count_p, hg_uint64_t *age_p)
 {
-    return (hg_return_t) NA_Get_protocol_info(info_string, na_protocol_info_p);
+    struct hg_core_private_context *private_context =
+        (struct hg_core_private_context *) context;
+    hg_uint64_t now, age = 0;
+    hg_uint32_t count = 0;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG core context");
+
+    now = hg_time_get_cycles();
+    hg_core_handle_list_get_age(
+        &private_context->user_list, id, now, &count, &age);
+    hg_core_handle_list_get_age(
+        &private_context->internal_list, id, now, &count, &age);
+
+    if (count_p != NULL)
+        *count_p = count;
+    if (age_p != NULL)
+        *age_p = hg_time_cycles_to_ns(age);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Core_free_na_protocol_info(struct na_protocol_info *na_protocol_info)
+hg_return_t
+HG_Core_context_set_handle_create_callback(hg_core_context_t *context,
+    hg_return_t (*callback)(hg_core_handle_t, void *), void *arg)
 {
-    NA_Free_protocol_info(na_protocol_info);
+    struct hg_core_private_context *private_context =
+        (struct hg_core_private_context *) context;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG core context");
+
+    private_context->handle_create_cb.callback = callback;
+    private_context->handle_create_cb.arg = arg;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_core_class_t *
-HG_Core_init(const char *na_info_string, hg_bool_t na_listen)
+hg_return_t
+HG_Core_context_post(hg_core_context_t *context)
 {
-    struct hg_core_private_class *hg_core_class;
     hg_return_t ret;
 
-    HG_LOG_SUBSYS_DEBUG(
-        cls, "Initializing with %s, listen=%d", na_info_string, na_listen);
+    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG core context");
 
-    ret = hg_core_init(na_info_string, na_listen, 0, NULL, &hg_core_class);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret, "Cannot initialize core class");
+    ret = hg_core_context_post((struct hg_core_private_context *) context);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not post context");
 
     HG_LOG_SUBSYS_DEBUG(
-        cls, "Initialized core class (%p)", (void *) hg_core_class);
+        ctx, "Pre-posted handles on context (%p)", (void *) context);
 
-    return (hg_core_class_t *) hg_core_class;
+    return HG_SUCCESS;
 
 error:
-    return NULL;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_core_class_t *
-HG_Core_init_opt(const char *na_info_string, hg_bool_t na_listen,
-    const struct hg_init_info *hg_init_info)
+hg_return_t
+HG_Core_context_unpost(hg_core_context_t *context)
 {
-    struct hg_core_private_class *hg_core_class;
     hg_return_t ret;
 
-    HG_LOG_SUBSYS_DEBUG(
-        cls, "Initializing with %s, listen=%d", na_info_string, na_listen);
+    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG core context");
 
-    /* v2.2 is latest version for which init struct was not versioned */
-    ret = hg_core_init(na_info_string, na_listen, HG_VERSION(2, 2),
-        hg_init_info, &hg_core_class);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret, "Cannot initialize core class");
+    ret = hg_core_context_unpost((struct hg_core_private_context *) context,
+        HG_CORE_CLEANUP_TIMEOUT * 10);
+    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not unpost context");
 
     HG_LOG_SUBSYS_DEBUG(
-        cls, "Initialized core class (%p)", (void *) hg_core_class);
+        ctx, "Unposted handles on context (%p)", (void *) context);
 
-    return (hg_core_class_t *) hg_core_class;
+    return HG_SUCCESS;
 
 error:
-    return NULL;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-hg_core_class_t *
-HG_Core_init_opt2(const char *na_info_string, hg_bool_t na_listen,
-    unsigned int version, const struct hg_init_info *hg_init_info)
+hg_return_t
+HG_Core_register(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_core_rpc_cb_t rpc_cb)
 {
-    struct hg_core_private_class *hg_core_class;
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_rpc_info *hg_core_rpc_info;
     hg_return_t ret;
 
-    HG_LOG_SUBSYS_DEBUG(
-        cls, "Initializing with %s, listen=%d", na_info_string, na_listen);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
 
-    ret = hg_core_init(
-        na_info_string, na_listen, version, hg_init_info, &hg_core_class);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret, "Cannot initialize core class");
+    /* Check if registered and set RPC CB */
+    hg_core_rpc_info = hg_core_map_lookup(&private_class->rpc_map, &id);
+    if (hg_core_rpc_info == NULL) {
+        HG_LOG_SUBSYS_DEBUG(cls, "Inserting new RPC ID (%" PRIu64 ")", id);
 
-    HG_LOG_SUBSYS_DEBUG(
-        cls, "Initialized core class (%p)", (void *) hg_core_class);
+        ret =
+            hg_core_map_insert(&private_class->rpc_map, &id, &hg_core_rpc_info);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            cls, error, ret, "Could not insert new RPC ID (%" PRIu64 ")", id);
+    } else
+        HG_LOG_SUBSYS_WARNING(cls,
+            "Overwriting RPC callback for a previously registered RPC ID "
+            "(%" PRIu64 ")",
+            id);
 
-    return (hg_core_class_t *) hg_core_class;
+    hg_core_rpc_info->rpc_cb = rpc_cb;
+
+    return HG_SUCCESS;
 
 error:
-    return NULL;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_finalize(hg_core_class_t *hg_core_class)
+HG_Core_deregister(hg_core_class_t *hg_core_class, hg_id_t id)
 {
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
     hg_return_t ret;
 
-    HG_LOG_SUBSYS_DEBUG(
-        cls, "Finalizing core class (%p)", (void *) hg_core_class);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
 
-    ret = hg_core_finalize((struct hg_core_private_class *) hg_core_class);
+    ret = hg_core_map_remove(&private_class->rpc_map, &id);
     HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
-        "Cannot finalize HG core class (%p)", (void *) hg_core_class);
+        "Could not deregister RPC ID (%" PRIu64 ") from function map", id);
 
     return HG_SUCCESS;
 
@@ -5650,28 +14198,50 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-void
-HG_Core_cleanup(void)
+hg_return_t
+HG_Core_registered(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_bool_t *flag_p)
 {
-    NA_Cleanup();
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR(
+        cls, flag_p == NULL, error, ret, HG_INVALID_ARG, "NULL flag pointer");
+
+    *flag_p =
+        (hg_bool_t) (hg_core_map_lookup(&private_class->rpc_map, &id) != NULL);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_set_more_data_callback(struct hg_core_class *hg_core_class,
-    hg_return_t (*more_data_acquire_callback)(hg_core_handle_t, hg_op_t,
-        void (*done_callback)(hg_core_handle_t, hg_return_t)),
-    void (*more_data_release_callback)(hg_core_handle_t))
+HG_Core_register_data(hg_core_class_t *hg_core_class, hg_id_t id, void *data,
+    void (*free_callback)(void *))
 {
     struct hg_core_private_class *private_class =
         (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
         HG_INVALID_ARG, "NULL HG core class");
 
-    private_class->more_data_cb.acquire = more_data_acquire_callback;
-    private_class->more_data_cb.release = more_data_release_callback;
+    hg_core_rpc_info = hg_core_map_lookup(&private_class->rpc_map, &id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret, HG_NOENTRY,
+        "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
+
+    /* We assume that only one thread will edit data for a given RPC ID */
+    HG_CHECK_SUBSYS_WARNING(cls, hg_core_rpc_info->data != NULL,
+        "Overwriting data previously registered for RPC ID (%" PRIu64 ")", id);
+    hg_core_rpc_info->data = data;
+    hg_core_rpc_info->free_callback = free_callback;
 
     return HG_SUCCESS;
 
@@ -5680,65 +14250,71 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-hg_core_context_t *
-HG_Core_context_create(hg_core_class_t *hg_core_class)
+void *
+HG_Core_registered_data(hg_core_class_t *hg_core_class, hg_id_t id)
 {
-    struct hg_core_private_context *context;
-    hg_return_t ret;
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
 
     HG_CHECK_SUBSYS_ERROR_NORET(
-        ctx, hg_core_class == NULL, error, "NULL HG core class");
-
-    HG_LOG_SUBSYS_DEBUG(ctx, "Creating new context with id=%u", 0);
-
-    ret = hg_core_context_create(
-        (struct hg_core_private_class *) hg_core_class, 0, &context);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not create context");
+        cls, hg_core_class == NULL, error, "NULL HG core class");
 
-    HG_LOG_SUBSYS_DEBUG(ctx, "Created new context (%p)", (void *) context);
+    hg_core_rpc_info = hg_core_map_lookup(&private_class->rpc_map, &id);
+    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_core_rpc_info == NULL, error,
+        "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
 
-    return (hg_core_context_t *) context;
+    return hg_core_rpc_info->data;
 
 error:
     return NULL;
 }
 
-/*---------------------------------------------------------------------------*/
-hg_core_context_t *
-HG_Core_context_create_id(hg_core_class_t *hg_core_class, hg_uint8_t id)
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_registered_set_timeout(
+    hg_core_class_t *hg_core_class, hg_id_t id, unsigned int timeout_ms)
 {
-    struct hg_core_private_context *context;
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_private_rpc_info *hg_core_rpc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR_NORET(
-        ctx, hg_core_class == NULL, error, "NULL HG core class");
-
-    HG_LOG_SUBSYS_DEBUG(ctx, "Creating new context with id=%u", id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
 
-    ret = hg_core_context_create(
-        (struct hg_core_private_class *) hg_core_class, id, &context);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        ctx, error, ret, "Could not create context with id=%u", id);
+    hg_core_rpc_info = (struct hg_core_private_rpc_info *) hg_core_map_lookup(
+        &private_class->rpc_map, &id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret,
+        HG_NOENTRY, "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
 
-    HG_LOG_SUBSYS_DEBUG(ctx, "Created new context (%p)", (void *) context);
+    hg_core_rpc_info->timeout_ms = timeout_ms;
 
-    return (hg_core_context_t *) context;
+    return HG_SUCCESS;
 
 error:
-    return NULL;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_context_destroy(hg_core_context_t *context)
+HG_Core_registered_bypass_admission(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_bool_t bypass)
 {
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_private_rpc_info *hg_core_rpc_info;
     hg_return_t ret;
 
-    HG_LOG_SUBSYS_DEBUG(ctx, "Destroying context (%p)", (void *) context);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
 
-    ret = hg_core_context_destroy((struct hg_core_private_context *) context);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        ctx, error, ret, "Could not destroy context (%p)", (void *) context);
+    hg_core_rpc_info = (struct hg_core_private_rpc_info *) hg_core_map_lookup(
+        &private_class->rpc_map, &id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret,
+        HG_NOENTRY, "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
+
+    hg_core_rpc_info->bypass_admission = bypass;
 
     return HG_SUCCESS;
 
@@ -5748,18 +14324,23 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_context_set_handle_create_callback(hg_core_context_t *context,
-    hg_return_t (*callback)(hg_core_handle_t, void *), void *arg)
+HG_Core_registered_disable_coalescing(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_bool_t disable)
 {
-    struct hg_core_private_context *private_context =
-        (struct hg_core_private_context *) context;
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_private_rpc_info *hg_core_rpc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
-        "NULL HG core context");
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
 
-    private_context->handle_create_cb.callback = callback;
-    private_context->handle_create_cb.arg = arg;
+    hg_core_rpc_info = (struct hg_core_private_rpc_info *) hg_core_map_lookup(
+        &private_class->rpc_map, &id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret,
+        HG_NOENTRY, "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
+
+    hg_core_rpc_info->no_coalesce = disable;
 
     return HG_SUCCESS;
 
@@ -5769,18 +14350,23 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_context_post(hg_core_context_t *context)
+HG_Core_registered_set_priority(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_prio_t prio)
 {
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_private_rpc_info *hg_core_rpc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
-        "NULL HG core context");
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
 
-    ret = hg_core_context_post((struct hg_core_private_context *) context);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not post context");
+    hg_core_rpc_info = (struct hg_core_private_rpc_info *) hg_core_map_lookup(
+        &private_class->rpc_map, &id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret,
+        HG_NOENTRY, "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
 
-    HG_LOG_SUBSYS_DEBUG(
-        ctx, "Pre-posted handles on context (%p)", (void *) context);
+    hg_core_rpc_info->prio = prio;
 
     return HG_SUCCESS;
 
@@ -5790,19 +14376,28 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_context_unpost(hg_core_context_t *context)
+HG_Core_class_get_stats(
+    hg_core_class_t *hg_core_class, hg_id_t id, struct hg_rpc_stats *stats)
 {
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_private_rpc_info *hg_core_rpc_info;
     hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR(ctx, context == NULL, error, ret, HG_INVALID_ARG,
-        "NULL HG core context");
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR(
+        cls, stats == NULL, error, ret, HG_INVALID_ARG, "NULL stats");
 
-    ret = hg_core_context_unpost((struct hg_core_private_context *) context,
-        HG_CORE_CLEANUP_TIMEOUT * 10);
-    HG_CHECK_SUBSYS_HG_ERROR(ctx, error, ret, "Could not unpost context");
+    hg_core_rpc_info = (struct hg_core_private_rpc_info *) hg_core_map_lookup(
+        &private_class->rpc_map, &id);
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret,
+        HG_NOENTRY, "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
 
-    HG_LOG_SUBSYS_DEBUG(
-        ctx, "Unposted handles on context (%p)", (void *) context);
+    hg_core_histogram_get(&hg_core_rpc_info->latency, &stats->latency);
+    hg_core_histogram_get(&hg_core_rpc_info->handler, &stats->handler);
+    hg_core_histogram_get(&hg_core_rpc_info->queue_wait, &stats->queue_wait);
+    hg_core_histogram_get(&hg_core_rpc_info->payload, &stats->payload);
 
     return HG_SUCCESS;
 
@@ -5812,33 +14407,34 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_register(
-    hg_core_class_t *hg_core_class, hg_id_t id, hg_core_rpc_cb_t rpc_cb)
+HG_Core_class_get_peer_stats(hg_core_class_t *hg_core_class,
+    hg_core_addr_t addr, struct hg_peer_stats *stats)
 {
     struct hg_core_private_class *private_class =
         (struct hg_core_private_class *) hg_core_class;
-    struct hg_core_rpc_info *hg_core_rpc_info;
+    struct hg_core_private_context *context;
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
         HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR(cls, addr == HG_CORE_ADDR_NULL, error, ret,
+        HG_INVALID_ARG, "NULL addr");
+    HG_CHECK_SUBSYS_ERROR(
+        cls, stats == NULL, error, ret, HG_INVALID_ARG, "NULL stats");
+    HG_CHECK_SUBSYS_ERROR(cls, private_class->init_info.peer_stats_max == 0,
+        error, ret, HG_OPNOTSUPPORTED, "Per-peer counters are disabled");
 
-    /* Check if registered and set RPC CB */
-    hg_core_rpc_info = hg_core_map_lookup(&private_class->rpc_map, &id);
-    if (hg_core_rpc_info == NULL) {
-        HG_LOG_SUBSYS_DEBUG(cls, "Inserting new RPC ID (%" PRIu64 ")", id);
-
-        ret =
-            hg_core_map_insert(&private_class->rpc_map, &id, &hg_core_rpc_info);
-        HG_CHECK_SUBSYS_HG_ERROR(
-            cls, error, ret, "Could not insert new RPC ID (%" PRIu64 ")", id);
-    } else
-        HG_LOG_SUBSYS_WARNING(cls,
-            "Overwriting RPC callback for a previously registered RPC ID "
-            "(%" PRIu64 ")",
-            id);
+    memset(stats, 0, sizeof(*stats));
 
-    hg_core_rpc_info->rpc_cb = rpc_cb;
+    /* Contexts release their peer table once removed from the list */
+    hg_thread_mutex_lock(&private_class->peer_errors.mutex);
+    HG_LIST_FOREACH (context, &private_class->peer_errors.contexts, entry) {
+        hg_core_peer_table_get(&context->peer_table, addr->na_addr, stats);
+#ifdef NA_HAS_SM
+        hg_core_peer_table_get(&context->peer_table, addr->na_sm_addr, stats);
+#endif
+    }
+    hg_thread_mutex_unlock(&private_class->peer_errors.mutex);
 
     return HG_SUCCESS;
 
@@ -5848,29 +14444,148 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_deregister(hg_core_class_t *hg_core_class, hg_id_t id)
+HG_Core_class_get_hot_peers(hg_core_class_t *hg_core_class,
+    hg_core_addr_t *addrs, struct hg_peer_stats *stats, unsigned int *count_p)
 {
     struct hg_core_private_class *private_class =
         (struct hg_core_private_class *) hg_core_class;
+    struct hg_core_private_context *context;
+    struct hg_core_peer_entry *peers = NULL;
+    unsigned int n_contexts = 0, n_peers = 0, n_merged = 0, i;
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
         HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR(cls, count_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL count pointer");
+    HG_CHECK_SUBSYS_ERROR(cls, *count_p > 0 && (addrs == NULL || stats == NULL),
+        error, ret, HG_INVALID_ARG, "NULL addrs or stats");
+    HG_CHECK_SUBSYS_ERROR(cls, private_class->init_info.peer_stats_max == 0,
+        error, ret, HG_OPNOTSUPPORTED, "Per-peer counters are disabled");
+
+    hg_thread_mutex_lock(&private_class->peer_errors.mutex);
+
+    /* Gather peers of all contexts, each context counts at most max peers */
+    HG_LIST_FOREACH (context, &private_class->peer_errors.contexts, entry)
+        n_contexts++;
+    if (n_contexts > 0) {
+        peers = (struct hg_core_peer_entry *) malloc(n_contexts *
+            private_class->init_info.peer_stats_max * sizeof(*peers));
+        HG_CHECK_SUBSYS_ERROR(cls, peers == NULL, unlock, ret, HG_NOMEM,
+            "Could not allocate array of peers");
+    }
+    HG_LIST_FOREACH (context, &private_class->peer_errors.contexts, entry) {
+        struct hg_core_peer_table *peer_table = &context->peer_table;
+
+        hg_thread_spin_lock(&peer_table->lock);
+        for (i = 0; i <= peer_table->mask; i++)
+            if (peer_table->entries[i].na_addr != NULL)
+                peers[n_peers++] = peer_table->entries[i];
+        hg_thread_spin_unlock(&peer_table->lock);
+    }
 
-    ret = hg_core_map_remove(&private_class->rpc_map, &id);
-    HG_CHECK_SUBSYS_HG_ERROR(cls, error, ret,
-        "Could not deregister RPC ID (%" PRIu64 ") from function map", id);
+    /* Merge counters of peers seen by several contexts */
+    if (n_peers > 0) {
+        qsort(peers, n_peers, sizeof(*peers), hg_core_peer_cmp_addr);
+        for (i = 1; i < n_peers; i++) {
+            if (peers[i].na_addr == peers[n_merged].na_addr)
+                hg_core_peer_stats_add(
+                    &peers[n_merged].stats, &peers[i].stats);
+            else
+                peers[++n_merged] = peers[i];
+        }
+        n_merged++;
+        qsort(peers, n_merged, sizeof(*peers), hg_core_peer_cmp_traffic);
+    }
+    if (n_merged > *count_p)
+        n_merged = *count_p;
+
+    /* NA addrs are still referenced by peer tables while the lock is held */
+    for (i = 0; i < n_merged; i++) {
+        struct hg_core_private_addr *hg_core_addr = NULL;
+        na_addr_t **na_addr_p;
+        na_return_t na_ret;
+
+        ret = hg_core_addr_create(private_class, &hg_core_addr);
+        HG_CHECK_SUBSYS_HG_ERROR(cls, free_addrs, ret, "Could not create addr");
+
+#ifdef NA_HAS_SM
+        if (peers[i].na_class == hg_core_class->na_sm_class)
+            na_addr_p = &hg_core_addr->core_addr.na_sm_addr;
+        else
+#endif
+            na_addr_p = &hg_core_addr->core_addr.na_addr;
+        na_ret = NA_Addr_dup(peers[i].na_class, peers[i].na_addr, na_addr_p);
+        if (na_ret != NA_SUCCESS) {
+            hg_core_addr_free(hg_core_addr);
+            HG_GOTO_SUBSYS_ERROR(cls, free_addrs, ret, (hg_return_t) na_ret,
+                "Could not duplicate NA addr (%s)", NA_Error_to_string(na_ret));
+        }
+        addrs[i] = (hg_core_addr_t) hg_core_addr;
+        stats[i] = peers[i].stats;
+    }
+    hg_thread_mutex_unlock(&private_class->peer_errors.mutex);
+
+    free(peers);
+    *count_p = n_merged;
 
     return HG_SUCCESS;
 
+free_addrs:
+    while (i-- > 0)
+        hg_core_addr_free((struct hg_core_private_addr *) addrs[i]);
+unlock:
+    hg_thread_mutex_unlock(&private_class->peer_errors.mutex);
+    free(peers);
 error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_uint64_t
+HG_Core_stats_percentile(
+    const struct hg_stats_histogram *histogram, double percentile)
+{
+    hg_uint64_t rank, count = 0;
+    unsigned int i;
+
+    if (histogram == NULL || histogram->count == 0)
+        return 0;
+
+    /* Rank of sample, from 1 to count */
+    if (percentile <= 0.0)
+        rank = 1;
+    else if (percentile >= 100.0)
+        rank = histogram->count;
+    else {
+        rank = (hg_uint64_t) ((double) histogram->count * percentile / 100.0);
+        if ((double) rank < (double) histogram->count * percentile / 100.0)
+            rank++;
+    }
+
+    for (i = 0; i < HG_STATS_BUCKET_COUNT; i++) {
+        count += histogram->buckets[i];
+        if (count >= rank)
+            break;
+    }
+    if (i == HG_STATS_BUCKET_COUNT)
+        return histogram->max;
+
+    /* Upper bound of bucket */
+    if (i < 4)
+        return i;
+    else {
+        unsigned int shift = (i >> 2) - 1;
+        hg_uint64_t upper = (((hg_uint64_t) (4 | (i & 0x3)) + 1) << shift) - 1;
+
+        return (upper < histogram->max) ? upper : histogram->max;
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_registered(
-    hg_core_class_t *hg_core_class, hg_id_t id, hg_bool_t *flag_p)
+HG_Core_class_set_trace_callback(
+    hg_core_class_t *hg_core_class, hg_core_trace_cb_t callback, void *arg)
 {
     struct hg_core_private_class *private_class =
         (struct hg_core_private_class *) hg_core_class;
@@ -5878,11 +14593,9 @@ HG_Core_registered(
 
     HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
         HG_INVALID_ARG, "NULL HG core class");
-    HG_CHECK_SUBSYS_ERROR(
-        cls, flag_p == NULL, error, ret, HG_INVALID_ARG, "NULL flag pointer");
 
-    *flag_p =
-        (hg_bool_t) (hg_core_map_lookup(&private_class->rpc_map, &id) != NULL);
+    private_class->trace_cb.arg = arg;
+    private_class->trace_cb.callback = callback;
 
     return HG_SUCCESS;
 
@@ -5892,52 +14605,104 @@ error:
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_register_data(hg_core_class_t *hg_core_class, hg_id_t id, void *data,
-    void (*free_callback)(void *))
+HG_Core_class_set_capture(hg_core_class_t *hg_core_class, const char *path)
 {
     struct hg_core_private_class *private_class =
         (struct hg_core_private_class *) hg_core_class;
-    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
+    const struct hg_capture_header header = {.magic = HG_CAPTURE_MAGIC,
+        .version = HG_CAPTURE_VERSION,
+        .record_size = (hg_uint32_t) sizeof(struct hg_capture_record),
+        .reserved = 0};
+    FILE *file = NULL;
     hg_return_t ret;
 
     HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
         HG_INVALID_ARG, "NULL HG core class");
 
-    hg_core_rpc_info = hg_core_map_lookup(&private_class->rpc_map, &id);
-    HG_CHECK_SUBSYS_ERROR(cls, hg_core_rpc_info == NULL, error, ret, HG_NOENTRY,
-        "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
+    if (path != NULL) {
+        file = fopen(path, "wb");
+        HG_CHECK_SUBSYS_ERROR(cls, file == NULL, error, ret, HG_NOENTRY,
+            "Could not open capture file %s", path);
+        HG_CHECK_SUBSYS_ERROR(cls,
+            fwrite(&header, sizeof(header), 1, file) != 1, error_close, ret,
+            HG_OTHER_ERROR, "Could not write capture header to %s", path);
+    }
 
-    /* We assume that only one thread will edit data for a given RPC ID */
-    HG_CHECK_SUBSYS_WARNING(cls, hg_core_rpc_info->data != NULL,
-        "Overwriting data previously registered for RPC ID (%" PRIu64 ")", id);
-    hg_core_rpc_info->data = data;
-    hg_core_rpc_info->free_callback = free_callback;
+    /* Replace previous capture file, if any */
+    hg_thread_mutex_lock(&private_class->capture.mutex);
+    if (private_class->capture.file != NULL)
+        fclose(private_class->capture.file);
+    private_class->capture.start = hg_time_get_cycles();
+    private_class->capture.file = file;
+    hg_thread_mutex_unlock(&private_class->capture.mutex);
+
+    HG_LOG_SUBSYS_DEBUG(cls, "RPC capture %s%s",
+        (path != NULL) ? "started to " : "stopped", (path != NULL) ? path : "");
 
     return HG_SUCCESS;
 
+error_close:
+    fclose(file);
 error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-void *
-HG_Core_registered_data(hg_core_class_t *hg_core_class, hg_id_t id)
+void
+hg_core_capture_bulk(hg_core_handle_t handle, hg_size_t size)
+{
+    ((struct hg_core_private_handle *) handle)->bulk_size += size;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_capture_extra(hg_core_handle_t handle, hg_size_t size)
+{
+    ((struct hg_core_private_handle *) handle)->in_extra_size = size;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_peer_stats_bulk(
+    struct hg_core_context *core_context, hg_core_addr_t addr, hg_size_t size)
+{
+    struct hg_core_private_context *context =
+        (struct hg_core_private_context *) core_context;
+    struct hg_peer_stats *peer_stats;
+
+#ifdef NA_HAS_SM
+    if (addr->na_sm_addr != NULL)
+        peer_stats = hg_core_peer_lock(
+            context, addr->core_class->na_sm_class, addr->na_sm_addr);
+    else
+#endif
+        peer_stats = hg_core_peer_lock(
+            context, addr->core_class->na_class, addr->na_addr);
+    if (peer_stats != NULL) {
+        peer_stats->bulk_bytes += size;
+        hg_core_peer_unlock(context);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_class_set_peer_error_callback(
+    hg_core_class_t *hg_core_class, hg_core_peer_error_cb_t callback, void *arg)
 {
     struct hg_core_private_class *private_class =
         (struct hg_core_private_class *) hg_core_class;
-    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
+    hg_return_t ret;
 
-    HG_CHECK_SUBSYS_ERROR_NORET(
-        cls, hg_core_class == NULL, error, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR(cls, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
 
-    hg_core_rpc_info = hg_core_map_lookup(&private_class->rpc_map, &id);
-    HG_CHECK_SUBSYS_ERROR_NORET(cls, hg_core_rpc_info == NULL, error,
-        "Could not find RPC ID (%" PRIu64 ") in RPC map", id);
+    private_class->peer_errors.arg = arg;
+    private_class->peer_errors.callback = callback;
 
-    return hg_core_rpc_info->data;
+    return HG_SUCCESS;
 
 error:
-    return NULL;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -6010,18 +14775,123 @@ HG_Core_addr_lookup2(
     HG_CHECK_SUBSYS_ERROR(addr, addr_p == NULL, error, ret, HG_INVALID_ARG,
         "NULL pointer to address");
 
-    HG_LOG_SUBSYS_DEBUG(addr, "Looking up \"%s\"", name);
+    HG_LOG_SUBSYS_DEBUG(addr, "Looking up \"%s\"", name);
+
+    ret = hg_core_addr_lookup((struct hg_core_private_class *) hg_core_class,
+        name, (struct hg_core_private_addr **) addr_p);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        addr, error, ret, "Could not lookup address for %s", name);
+
+    HG_LOG_SUBSYS_DEBUG(addr, "Created new address (%p)", (void *) *addr_p);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_lookup_multi(hg_core_context_t *context, hg_core_cb_t callback,
+    void *arg, const char *const *names, unsigned int count,
+    hg_core_addr_t *addrs, hg_core_op_id_t *op_id)
+{
+    struct hg_core_op_id *hg_core_op_id = NULL;
+    struct hg_completion_entry *hg_completion_entry = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(addr, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG core context");
+    HG_CHECK_SUBSYS_ERROR(
+        addr, callback == NULL, error, ret, HG_INVALID_ARG, "NULL callback");
+    HG_CHECK_SUBSYS_ERROR(addr, count > 0 && names == NULL, error, ret,
+        HG_INVALID_ARG, "NULL lookup names");
+    HG_CHECK_SUBSYS_ERROR(addr, count > 0 && addrs == NULL, error, ret,
+        HG_INVALID_ARG, "NULL array of addresses");
+    (void) op_id;
+
+    HG_LOG_SUBSYS_DEBUG(addr, "Looking up %u names", count);
+
+    /* Allocate op_id */
+    hg_core_op_id = (struct hg_core_op_id *) calloc(1, sizeof(*hg_core_op_id));
+    HG_CHECK_SUBSYS_ERROR(addr, hg_core_op_id == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG operation ID");
+    hg_core_op_id->context = (struct hg_core_private_context *) context;
+    hg_core_op_id->type = HG_CB_LOOKUP;
+    hg_core_op_id->callback = callback;
+    hg_core_op_id->arg = arg;
+    hg_core_op_id->info.lookup.hg_core_addr = NULL;
+
+    ret = hg_core_addr_lookup_multi(
+        (struct hg_core_private_class *) context->core_class, names, count,
+        (struct hg_core_private_addr **) addrs);
+    HG_CHECK_SUBSYS_HG_ERROR(
+        addr, error, ret, "Could not lookup %u addresses", count);
+
+    /* Single completion for the whole list */
+    hg_completion_entry = &hg_core_op_id->hg_completion_entry;
+    hg_completion_entry->op_type = HG_ADDR;
+    hg_completion_entry->op_id.hg_core_op_id = hg_core_op_id;
+
+    hg_core_completion_add(context, hg_completion_entry, HG_TRUE);
+
+    return HG_SUCCESS;
+
+error:
+    free(hg_core_op_id);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_warm(hg_core_context_t *context, hg_core_cb_t callback, void *arg,
+    const hg_core_addr_t *addrs, unsigned int count, hg_core_op_id_t *op_id)
+{
+    struct hg_core_op_id *hg_core_op_id = NULL;
+    struct hg_completion_entry *hg_completion_entry = NULL;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(addr, context == NULL, error, ret, HG_INVALID_ARG,
+        "NULL HG core context");
+    HG_CHECK_SUBSYS_ERROR(
+        addr, callback == NULL, error, ret, HG_INVALID_ARG, "NULL callback");
+    HG_CHECK_SUBSYS_ERROR(addr, count > 0 && addrs == NULL, error, ret,
+        HG_INVALID_ARG, "NULL array of addresses");
+    (void) op_id;
+
+    HG_LOG_SUBSYS_DEBUG(addr, "Warming up %u addresses", count);
+
+    /* Allocate op_id */
+    hg_core_op_id = (struct hg_core_op_id *) calloc(1, sizeof(*hg_core_op_id));
+    HG_CHECK_SUBSYS_ERROR(addr, hg_core_op_id == NULL, error, ret, HG_NOMEM,
+        "Could not allocate HG operation ID");
+    hg_core_op_id->context = (struct hg_core_private_context *) context;
+    hg_core_op_id->type = HG_CB_WARM;
+    hg_core_op_id->callback = callback;
+    hg_core_op_id->arg = arg;
+    hg_core_op_id->info.lookup.hg_core_addr = NULL;
+
+    if (count > 0) {
+        ret = hg_core_addr_warm(
+            (struct hg_core_private_class *) context->core_class,
+            (struct hg_core_private_addr *const *) addrs, count);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            addr, error, ret, "Could not warm up %u addresses", count);
+    }
 
-    ret = hg_core_addr_lookup((struct hg_core_private_class *) hg_core_class,
-        name, (struct hg_core_private_addr **) addr_p);
-    HG_CHECK_SUBSYS_HG_ERROR(
-        addr, error, ret, "Could not lookup address for %s", name);
+    /* Single completion for the whole list */
+    hg_completion_entry = &hg_core_op_id->hg_completion_entry;
+    hg_completion_entry->op_type = HG_ADDR;
+    hg_completion_entry->op_id.hg_core_op_id = hg_core_op_id;
 
-    HG_LOG_SUBSYS_DEBUG(addr, "Created new address (%p)", (void *) *addr_p);
+    hg_core_completion_add(context, hg_completion_entry, HG_TRUE);
 
     return HG_SUCCESS;
 
 error:
+    free(hg_core_op_id);
+
     return ret;
 }
 
@@ -6055,6 +14925,54 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_purge(hg_core_class_t *hg_core_class, const hg_core_addr_t *addrs,
+    unsigned int count)
+{
+    struct hg_core_private_class *private_class =
+        (struct hg_core_private_class *) hg_core_class;
+    unsigned int i, purged = 0;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(addr, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR(addr, count > 0 && addrs == NULL, error, ret,
+        HG_INVALID_ARG, "NULL array of addresses");
+
+    for (i = 0; i < count; i++) {
+        struct hg_core_private_addr *hg_core_addr =
+            (struct hg_core_private_addr *) addrs[i];
+
+        if (hg_core_addr == NULL || hg_core_addr->core_addr.is_self)
+            continue;
+        HG_CHECK_SUBSYS_ERROR(addr,
+            hg_core_addr->core_addr.core_class != hg_core_class, error, ret,
+            HG_INVALID_ARG, "Address %u does not belong to HG core class", i);
+
+        if (hg_core_addr->core_addr.na_addr != NULL)
+            purged += hg_core_peer_purge(private_class, hg_core_class->na_class,
+                hg_core_addr->core_addr.na_addr);
+#ifdef NA_HAS_SM
+        if (hg_core_addr->core_addr.na_sm_addr != NULL)
+            purged += hg_core_peer_purge(private_class,
+                hg_core_class->na_sm_class, hg_core_addr->core_addr.na_sm_addr);
+#endif
+
+        ret = hg_core_addr_set_remove(hg_core_addr);
+        HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+            "Could not set address to be removed (%p)", (void *) hg_core_addr);
+    }
+
+    HG_LOG_SUBSYS_DEBUG(
+        addr, "Purged %u addresses, failed %u pending RPCs", count, purged);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_addr_self(hg_core_class_t *hg_core_class, hg_core_addr_t *addr_p)
@@ -6224,6 +15142,112 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_size_t
+HG_Core_addr_get_book_size(hg_core_class_t *hg_core_class,
+    const hg_core_addr_t *addrs, unsigned int count, unsigned long flags)
+{
+    struct hg_core_addr_book_hdr hdr;
+    unsigned int i;
+
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        addr, hg_core_class == NULL, error, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        addr, count > 0 && addrs == NULL, error, "NULL array of addresses");
+    for (i = 0; i < count; i++)
+        HG_CHECK_SUBSYS_ERROR_NORET(addr, addrs[i] == HG_CORE_ADDR_NULL, error,
+            "NULL HG core address %u", i);
+
+    return hg_core_addr_book_get_size(
+        (struct hg_core_private_class *) hg_core_class,
+        (struct hg_core_private_addr *const *) addrs, count, flags & 0xff,
+        &hdr);
+
+error:
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_serialize_book(void *buf, hg_size_t buf_size, unsigned long flags,
+    hg_core_class_t *hg_core_class, const hg_core_addr_t *addrs,
+    unsigned int count)
+{
+    unsigned int i;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(addr, buf == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to buffer");
+    HG_CHECK_SUBSYS_ERROR(addr, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR(addr, count > 0 && addrs == NULL, error, ret,
+        HG_INVALID_ARG, "NULL array of addresses");
+    for (i = 0; i < count; i++)
+        HG_CHECK_SUBSYS_ERROR(addr, addrs[i] == HG_CORE_ADDR_NULL, error, ret,
+            HG_INVALID_ARG, "NULL HG core address %u", i);
+
+    HG_LOG_SUBSYS_DEBUG(addr, "Serializing book of %u addresses", count);
+
+    ret = hg_core_addr_book_serialize(buf, buf_size, flags & 0xff,
+        (struct hg_core_private_class *) hg_core_class,
+        (struct hg_core_private_addr *const *) addrs, count);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret, "Could not serialize addr book");
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_deserialize_book(hg_core_class_t *hg_core_class, const void *buf,
+    hg_size_t buf_size, hg_core_addr_t *addrs, unsigned int *count_p)
+{
+    unsigned int count, i;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(addr, hg_core_class == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core class");
+    HG_CHECK_SUBSYS_ERROR(addr, buf == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to buffer");
+    HG_CHECK_SUBSYS_ERROR(addr, count_p == NULL, error, ret, HG_INVALID_ARG,
+        "NULL pointer to count");
+
+    ret = hg_core_addr_book_count(
+        (struct hg_core_private_class *) hg_core_class, buf, buf_size, &count);
+    HG_CHECK_SUBSYS_ERROR(addr, ret == HG_OVERFLOW, error, ret,
+        HG_PROTOCOL_ERROR, "Truncated addr book (%zu bytes)",
+        (size_t) buf_size);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+        "Could not parse addr book from (%p, %zu)", buf, (size_t) buf_size);
+
+    /* Let caller know how many addresses are needed */
+    if (addrs == NULL || *count_p < count) {
+        *count_p = count;
+        return HG_OVERFLOW;
+    }
+
+    for (i = 0; i < count; i++)
+        addrs[i] = HG_CORE_ADDR_NULL;
+
+    ret = hg_core_addr_book_deserialize(
+        (struct hg_core_private_class *) hg_core_class, buf, buf_size,
+        (struct hg_core_private_addr **) addrs, count);
+    HG_CHECK_SUBSYS_HG_ERROR(addr, error, ret,
+        "Could not deserialize addr book from (%p, %zu)", buf,
+        (size_t) buf_size);
+
+    HG_LOG_SUBSYS_DEBUG(addr, "Deserialized book of %u addresses", count);
+
+    *count_p = count;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_create(hg_core_context_t *context, hg_core_addr_t addr, hg_id_t id,
@@ -6391,6 +15415,19 @@ error:
     return -1;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+HG_Core_is_self(hg_core_handle_t handle)
+{
+    HG_CHECK_SUBSYS_ERROR_NORET(
+        rpc, handle == HG_CORE_HANDLE_NULL, error, "NULL HG core handle");
+
+    return ((struct hg_core_private_handle *) handle)->is_self;
+
+error:
+    return HG_FALSE;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_release_input(hg_core_handle_t handle)
@@ -6412,6 +15449,33 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_alloc_output(hg_core_handle_t handle)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_CORE_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core handle");
+
+    if (handle->out_buf != NULL)
+        return HG_SUCCESS;
+
+    HG_LOG_SUBSYS_DEBUG(
+        rpc, "Allocating output buffer for handle (%p)", (void *) handle);
+
+    ret = hg_core_alloc_output(hg_core_handle, NA_SEND);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not allocate output buffer for handle (%p)", (void *) handle);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_forward(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
@@ -6456,7 +15520,7 @@ HG_Core_respond(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
 
     /* Explicit response return code is always success here */
     ret = hg_core_respond((struct hg_core_private_handle *) handle, callback,
-        arg, flags, payload_size, HG_SUCCESS);
+        arg, flags, payload_size, HG_SUCCESS, NULL);
     HG_CHECK_SUBSYS_HG_ERROR(
         rpc, error, ret, "Could not respond on handle (%p)", (void *) handle);
 
@@ -6466,6 +15530,77 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_respond_batch(hg_core_handle_t handles[], unsigned int count,
+    hg_core_cb_t callback, void *const args[], const hg_uint8_t flags[],
+    const hg_size_t payload_sizes[], hg_return_t rets[])
+{
+    struct hg_core_respond_batch batch;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        count > 0 && (handles == NULL || payload_sizes == NULL), done, ret,
+        HG_INVALID_ARG, "NULL array of handles or payload sizes");
+
+    HG_LOG_SUBSYS_DEBUG(rpc, "Responding on %u handles", count);
+
+    batch.count = 0;
+    for (i = 0; i < count; i++) {
+        hg_return_t ret_handle;
+
+        /* Post sends collected so far once the batch is full */
+        if (batch.count == HG_CORE_RESPOND_BATCH_MAX)
+            hg_core_respond_batch_post(&batch);
+
+        if (handles[i] == HG_CORE_HANDLE_NULL)
+            ret_handle = HG_INVALID_ARG;
+        else
+            ret_handle = hg_core_respond(
+                (struct hg_core_private_handle *) handles[i], callback,
+                (args != NULL) ? args[i] : NULL,
+                (flags != NULL) ? flags[i] : 0, payload_sizes[i], HG_SUCCESS,
+                &batch);
+        HG_CHECK_SUBSYS_WARNING(rpc, ret_handle != HG_SUCCESS,
+            "Could not respond on handle (%p)", (void *) handles[i]);
+
+        if (rets != NULL)
+            rets[i] = ret_handle;
+        if (ret == HG_SUCCESS)
+            ret = ret_handle;
+    }
+    hg_core_respond_batch_post(&batch);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_respond_partial(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_size_t payload_size)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_CORE_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core handle");
+
+    HG_LOG_SUBSYS_DEBUG(rpc,
+        "Responding partially on handle (%p), payload size is %" PRIu64,
+        (void *) handle, payload_size);
+
+    ret = hg_core_respond_partial((struct hg_core_private_handle *) handle,
+        callback, arg, payload_size);
+    HG_CHECK_SUBSYS_HG_ERROR(rpc, error, ret,
+        "Could not respond partially on handle (%p)", (void *) handle);
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 #ifdef HG_HAS_MULTI_PROGRESS
 hg_return_t
@@ -6564,6 +15699,37 @@ done:
 }
 #endif
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_progress_multi(hg_core_context_t *contexts[], unsigned int count,
+    unsigned int timeout, hg_uint64_t *ready_p)
+{
+    hg_uint64_t ready = 0;
+    unsigned int i;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(poll, contexts == NULL || count == 0, done, ret,
+        HG_INVALID_ARG, "NULL HG core contexts");
+    HG_CHECK_SUBSYS_ERROR(poll, count > HG_CORE_PROGRESS_MULTI_MAX, done, ret,
+        HG_INVALID_ARG, "Number of contexts (%u) exceeds max (%u)", count,
+        (unsigned int) HG_CORE_PROGRESS_MULTI_MAX);
+    for (i = 0; i < count; i++)
+        HG_CHECK_SUBSYS_ERROR(poll, contexts[i] == NULL, done, ret,
+            HG_INVALID_ARG, "NULL HG core context");
+
+    /* Make progress on the HG layer */
+    ret = hg_core_progress_multi((struct hg_core_private_context **) contexts,
+        count, timeout, &ready);
+    HG_CHECK_SUBSYS_ERROR_NORET(poll, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+        done, "Could not make progress");
+
+done:
+    if (ready_p != NULL)
+        *ready_p = ready;
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_trigger(hg_core_context_t *context, unsigned int timeout,
@@ -6575,7 +15741,27 @@ HG_Core_trigger(hg_core_context_t *context, unsigned int timeout,
         "NULL HG core context");
 
     ret = hg_core_trigger((struct hg_core_private_context *) context, timeout,
-        max_count, actual_count_p);
+        max_count, actual_count_p, NULL);
+    HG_CHECK_SUBSYS_ERROR_NORET(poll, ret != HG_SUCCESS && ret != HG_TIMEOUT,
+        done, "Could not trigger callbacks");
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_trigger_batch(hg_core_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count_p,
+    unsigned int *remaining_count_p)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(poll, context == NULL, done, ret, HG_INVALID_ARG,
+        "NULL HG core context");
+
+    ret = hg_core_trigger((struct hg_core_private_context *) context, timeout,
+        max_count, actual_count_p, remaining_count_p);
     HG_CHECK_SUBSYS_ERROR_NORET(poll, ret != HG_SUCCESS && ret != HG_TIMEOUT,
         done, "Could not trigger callbacks");
 
@@ -6594,7 +15780,7 @@ HG_Core_cancel(hg_core_handle_t handle)
 
     HG_LOG_SUBSYS_DEBUG(rpc, "Canceling handle (%p)", (void *) handle);
 
-    ret = hg_core_cancel((struct hg_core_private_handle *) handle);
+    ret = hg_core_cancel((struct hg_core_private_handle *) handle, HG_CANCELED);
     HG_CHECK_SUBSYS_HG_ERROR(
         rpc, error, ret, "Could not cancel handle (%p)", (void *) handle);
 
@@ -6603,3 +15789,74 @@ HG_Core_cancel(hg_core_handle_t handle)
 error:
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_set_timeout(hg_core_handle_t handle, unsigned int timeout_ms)
+{
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, handle == HG_CORE_HANDLE_NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core handle");
+
+    ((struct hg_core_private_handle *) handle)->timeout_ms = timeout_ms;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_set_stream(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
+    unsigned int credits)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    int32_t status;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core handle");
+    HG_CHECK_SUBSYS_ERROR(rpc, credits > HG_CORE_STREAM_CREDITS_MAX, error,
+        ret, HG_INVALID_ARG, "Number of credits (%u) exceeds max (%u)",
+        credits, (unsigned int) HG_CORE_STREAM_CREDITS_MAX);
+
+    status = hg_atomic_get32(&hg_core_handle->status);
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        !(status & HG_CORE_OP_COMPLETED) || (status & HG_CORE_OP_QUEUED), error,
+        ret, HG_BUSY, "Attempting to use handle that was not completed");
+
+    hg_core_handle->stream_callback = callback;
+    hg_core_handle->stream_arg = arg;
+    hg_core_handle->stream_credits = (hg_uint8_t) credits;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_set_persistent(hg_core_handle_t handle)
+{
+    struct hg_core_private_handle *hg_core_handle =
+        (struct hg_core_private_handle *) handle;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(rpc, hg_core_handle == NULL, error, ret,
+        HG_INVALID_ARG, "NULL HG core handle");
+    HG_CHECK_SUBSYS_ERROR(rpc,
+        hg_core_handle->core_handle.info.addr == HG_CORE_ADDR_NULL, error, ret,
+        HG_INVALID_ARG, "NULL target addr");
+
+    hg_core_handle->persistent = HG_TRUE;
+    hg_core_handle->in_header_encoded = HG_FALSE;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
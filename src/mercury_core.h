@@ -61,6 +61,14 @@ typedef hg_return_t (*hg_core_rpc_cb_t)(hg_core_handle_t handle);
 typedef hg_return_t (*hg_core_cb_t)(
     const struct hg_core_cb_info *callback_info);
 
+/* Trace callback */
+typedef void (*hg_core_trace_cb_t)(
+    hg_core_handle_t handle, const struct hg_trace_info *trace_info, void *arg);
+
+/* Peer error callback */
+typedef void (*hg_core_peer_error_cb_t)(
+    hg_core_addr_t addr, hg_return_t ret, void *arg);
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -318,6 +326,23 @@ HG_Core_context_create(hg_core_class_t *hg_core_class);
 HG_PUBLIC hg_core_context_t *
 HG_Core_context_create_id(hg_core_class_t *hg_core_class, hg_uint8_t id);
 
+/**
+ * Same as HG_Core_context_create_id() but place the context on the CPUs or
+ * NUMA node given by \info, so that memory owned by the context is allocated
+ * locally. A warning is emitted if the network device is on a different
+ * NUMA node.
+ * Context must be destroyed by calling HG_Core_context_destroy().
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               context ID
+ * \param info [IN]             optional context info (NULL for none)
+ *
+ * \return Pointer to HG core context or NULL in case of failure
+ */
+HG_PUBLIC hg_core_context_t *
+HG_Core_context_create_opt(hg_core_class_t *hg_core_class, hg_uint8_t id,
+    const struct hg_context_info *info);
+
 /**
  * Destroy a context created by HG_Core_context_create().
  *
@@ -328,6 +353,24 @@ HG_Core_context_create_id(hg_core_class_t *hg_core_class, hg_uint8_t id);
 HG_PUBLIC hg_return_t
 HG_Core_context_destroy(hg_core_context_t *context);
 
+/**
+ * Destroy several contexts at once. Posted requests of all contexts are
+ * canceled first and their completion is waited on together, so that the
+ * cleanup timeout applies once instead of once per context. If \quiescent
+ * is set, the caller guarantees that no user handle or output lease is still
+ * in use and the corresponding waits are skipped.
+ * On failure, entries of contexts that were destroyed are set to NULL.
+ *
+ * \param contexts [IN/OUT]     array of HG core contexts
+ * \param count [IN]            number of contexts
+ * \param quiescent [IN]        skip waits on user handles and leases
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_context_destroy_multi(
+    hg_core_context_t *contexts[], unsigned int count, hg_bool_t quiescent);
+
 /**
  * Retrieve the class used to create the given context.
  *
@@ -394,6 +437,69 @@ HG_Core_context_set_data(
 static HG_INLINE void *
 HG_Core_context_get_data(const hg_core_context_t *context);
 
+/**
+ * Retrieve the current amount of time that progress may busy-spin on that
+ * context before blocking (see progress_spin_max init info).
+ *
+ * \param context [IN]          pointer to HG core context
+ *
+ * \return Spin budget in microseconds or 0 if progress does not spin
+ */
+HG_PUBLIC unsigned int
+HG_Core_context_get_spin_budget(hg_core_context_t *context);
+
+/**
+ * Retrieve progress loop stats of a context. One out of several progress and
+ * trigger calls is sampled, times are accumulated over sampled calls only and
+ * split between:
+ * - progress: time blocked in poll wait, time spent in NA and NA SM progress
+ * - trigger: time spent in callbacks, time waiting for completions
+ * Idle time is the time spent blocking in poll wait and waiting for
+ * completions in trigger, busy time is the remaining sampled time.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param stats [OUT]           pointer to returned stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_context_get_progress_stats(
+    hg_core_context_t *context, struct hg_progress_stats *stats);
+
+/**
+ * Retrieve stats of the pools of handles of a context: number of handles
+ * allocated and available, number of times pools were extended, time threads
+ * spent waiting on another thread to extend a pool, and number of times pools
+ * ran out of handles after reaching the request_post_max soft cap. Also
+ * reports the memory of the class that is charged to the mem_max budget.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param stats [OUT]           pointer to returned stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_context_get_handle_stats(
+    hg_core_context_t *context, struct hg_handle_stats *stats);
+
+/**
+ * Retrieve the number of outstanding handles of a context for a given RPC ID
+ * and the age of the oldest one. Handles created by the user are outstanding
+ * from their creation until they are freed, handles used for incoming RPCs
+ * from their reception until they are returned to their pool. Handles are
+ * walked under lock, this call is intended for diagnostics only.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param id [IN]               registered function ID (0 for any ID)
+ * \param count_p [OUT]         pointer to number of outstanding handles
+ * \param age_p [OUT]           pointer to age of the oldest handle (ns)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_context_get_handle_age(hg_core_context_t *context, hg_id_t id,
+    hg_uint32_t *count_p, hg_uint64_t *age_p);
+
 /**
  * Set callback to be called on HG core handle creation. Handles are created
  * both on HG_Core_create() and HG_Core_context_post() calls. This allows
@@ -505,6 +611,192 @@ HG_Core_register_data(hg_core_class_t *hg_core_class, hg_id_t id, void *data,
 HG_PUBLIC void *
 HG_Core_registered_data(hg_core_class_t *hg_core_class, hg_id_t id);
 
+/**
+ * Set default timeout of forwards of RPC ID, see HG_Core_set_timeout().
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param timeout_ms [IN]       timeout in ms (0 for no timeout)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_registered_set_timeout(
+    hg_core_class_t *hg_core_class, hg_id_t id, unsigned int timeout_ms);
+
+/**
+ * Exempt requests of RPC ID from admission control, these requests are then
+ * never rejected with HG_BUSY when the context is overloaded (e.g., health
+ * checks or control RPCs). See hg_init_info::admission_queue_max.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param bypass [IN]           boolean (HG_TRUE to always admit requests)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_registered_bypass_admission(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_bool_t bypass);
+
+/**
+ * Never hold requests of RPC ID back to coalesce them with other requests
+ * to the same target (see hg_init_info::request_coalesce_max), so that
+ * latency-critical RPCs are sent right away.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param disable [IN]          boolean (HG_TRUE to disable coalescing)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_registered_disable_coalescing(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_bool_t disable);
+
+/**
+ * Set priority class of RPC ID. High priority requests are never coalesced
+ * with other requests, their completions are triggered before other
+ * completions and they are not rejected by admission control. The priority
+ * must be set on both origin and target.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param prio [IN]             priority class
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_registered_set_priority(
+    hg_core_class_t *hg_core_class, hg_id_t id, hg_prio_t prio);
+
+/**
+ * Retrieve stats of a registered RPC ID. Stats are collected on both origin
+ * and target sides from the time the RPC ID is registered and include:
+ * - latency: time from forward to completion of an RPC (origin)
+ * - handler: time from execution of the RPC callback to its response, or to
+ *   the return of the callback if the RPC has no response (target)
+ * - queue_wait: time spent in the completion queue before being triggered
+ * - payload: payload size of requests sent (origin) and responses sent
+ *   (target)
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param stats [OUT]           pointer to returned stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_get_stats(
+    hg_core_class_t *hg_core_class, hg_id_t id, struct hg_rpc_stats *stats);
+
+/**
+ * Retrieve traffic exchanged with a peer, summed over all contexts of the
+ * class. Requires per-peer counters to be enabled through the
+ * peer_stats_max init info field. Peers are identified by their NA address,
+ * traffic with a peer that was not counted (see peer_stats_max) is zero.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param addr [IN]             abstract address of peer
+ * \param stats [OUT]           pointer to returned stats
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_get_peer_stats(hg_core_class_t *hg_core_class,
+    hg_core_addr_t addr, struct hg_peer_stats *stats);
+
+/**
+ * Retrieve the peers that exchanged the most RPCs with that class (ties are
+ * broken by the number of bytes exchanged), summed over all contexts of the
+ * class. Requires per-peer counters to be enabled through the
+ * peer_stats_max init info field. Returned addresses must be freed with
+ * HG_Core_addr_free().
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param addrs [OUT]           array of returned addresses, ordered by
+ *                              decreasing traffic
+ * \param stats [OUT]           array of returned stats of each address
+ * \param count_p [IN/OUT]      pointer to number of entries in arrays, set
+ *                              to the number of peers returned
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_get_hot_peers(hg_core_class_t *hg_core_class,
+    hg_core_addr_t *addrs, struct hg_peer_stats *stats, unsigned int *count_p);
+
+/**
+ * Estimate a percentile of a histogram returned in RPC stats. The returned
+ * value is the upper bound of the bucket that contains that percentile, and
+ * is therefore at most 25% larger than the exact value.
+ *
+ * \param histogram [IN]        pointer to histogram
+ * \param percentile [IN]       percentile between 0 and 100 (e.g., 99.9)
+ *
+ * \return Value or 0 if histogram is empty
+ */
+HG_PUBLIC hg_uint64_t
+HG_Core_stats_percentile(
+    const struct hg_stats_histogram *histogram, double percentile);
+
+/**
+ * Set callback that gets called on each trace event of an RPC (see
+ * hg_trace_event_t). Callbacks are made from the progress or trigger path and
+ * must therefore not block.
+ *
+ * On HG_TRACE_FORWARD, the trace context of the handle is zeroed and can be
+ * filled by the callback, it is then propagated to the target along with the
+ * request if there is room left in the input buffer. On the target side, the
+ * trace context is NULL unless the origin propagated one. Passing a NULL
+ * callback disables tracing, in which case no trace context is sent.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_set_trace_callback(
+    hg_core_class_t *hg_core_class, hg_core_trace_cb_t callback, void *arg);
+
+/**
+ * Capture RPCs processed by the class to a binary file so that the same mix of
+ * RPCs can later be replayed. The file starts with a struct hg_capture_header
+ * followed by one struct hg_capture_record per RPC, appended once its callback
+ * responded (or returned if the RPC has no response). Arrival times are
+ * relative to the call that started the capture. Passing a NULL path stops
+ * the capture and closes the previous file, if any.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param path [IN]             path of capture file (truncated if it exists)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_set_capture(hg_core_class_t *hg_core_class, const char *path);
+
+/**
+ * Set callback that gets called when the NA plugin reports a peer as no
+ * longer reachable (e.g., UCX endpoint error, OFI unreachable host). Before
+ * the callback is made, all forwards still pending to that peer on every
+ * context of the class are completed with HG_HOSTUNREACH. The callback is
+ * made from the progress path and must not block; the address passed is only
+ * valid for the duration of the callback and must be duplicated with
+ * HG_Core_addr_dup() if it needs to be kept, it can be compared against
+ * other addresses using HG_Core_addr_cmp().
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_class_set_peer_error_callback(hg_core_class_t *hg_core_class,
+    hg_core_peer_error_cb_t callback, void *arg);
+
 /**
  * Lookup an addr from a peer address/name. Addresses need to be
  * freed by calling HG_Core_addr_free(). After completion, user callback is
@@ -536,6 +828,52 @@ HG_PUBLIC hg_return_t
 HG_Core_addr_lookup2(
     hg_core_class_t *hg_core_class, const char *name, hg_core_addr_t *addr_p);
 
+/**
+ * Lookup a list of addrs from peer addresses/names. Names that were already
+ * resolved are re-used and names that appear more than once in the list are
+ * only resolved once, remaining names are resolved together so that NA
+ * plugins can batch the lookups. Addresses need to be freed by calling
+ * HG_Core_addr_free() on each entry of \addrs. After completion of the
+ * entire list, a single user callback is placed into a completion queue and
+ * can be triggered using HG_Core_trigger().
+ *
+ * \param context [IN]          pointer to context of execution
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param names [IN]            array of lookup names
+ * \param count [IN]            number of names
+ * \param addrs [OUT]           array of count abstract addresses
+ * \param op_id [OUT]           pointer to returned operation ID (unused)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_lookup_multi(hg_core_context_t *context, hg_core_cb_t callback,
+    void *arg, const char *const *names, unsigned int count,
+    hg_core_addr_t *addrs, hg_core_op_id_t *op_id);
+
+/**
+ * Start establishing transport state (connections, endpoints, shared-memory
+ * mappings) for a list of previously looked up addresses so that the first
+ * RPC sent to each of them does not pay for it. Warming up is a hint, NA
+ * plugins that do not need it leave addresses untouched. Once the warm-up
+ * has been initiated for the entire list, a single user callback of type
+ * HG_CB_WARM is placed into a completion queue and can be triggered using
+ * HG_Core_trigger().
+ *
+ * \param context [IN]          pointer to context of execution
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ * \param op_id [OUT]           pointer to returned operation ID (unused)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_warm(hg_core_context_t *context, hg_core_cb_t callback, void *arg,
+    const hg_core_addr_t *addrs, unsigned int count, hg_core_op_id_t *op_id);
+
 /**
  * Free the addr from the list of peers.
  *
@@ -559,6 +897,23 @@ HG_Core_addr_free(hg_core_addr_t addr);
 HG_PUBLIC hg_return_t
 HG_Core_addr_set_remove(hg_core_addr_t addr);
 
+/**
+ * Purge a list of peers that are known to be dead: forwards still pending to
+ * any of them on every context of the class are immediately completed with
+ * HG_HOSTUNREACH and the addresses are set to be removed (see
+ * HG_Core_addr_set_remove()). Addresses must still be freed by calling
+ * HG_Core_addr_free().
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_purge(hg_core_class_t *hg_core_class, const hg_core_addr_t *addrs,
+    unsigned int count);
+
 /**
  * Obtain the underlying NA address from an HG address.
  *
@@ -682,6 +1037,59 @@ HG_PUBLIC hg_return_t
 HG_Core_addr_deserialize(hg_core_class_t *hg_core_class, hg_core_addr_t *addr_p,
     const void *buf, hg_size_t buf_size);
 
+/**
+ * Get size required to serialize a list of addresses into an address book.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ * \param flags [IN]            optional flags
+ *
+ * \return Non-negative value
+ */
+HG_PUBLIC hg_size_t
+HG_Core_addr_get_book_size(hg_core_class_t *hg_core_class,
+    const hg_core_addr_t *addrs, unsigned int count, unsigned long flags);
+
+/**
+ * Serialize a list of addresses into a compact binary address book. The
+ * protocol is stored once for the entire book and sizes of serialized
+ * addresses are only stored per entry when they differ. Books produced by
+ * several peers can be concatenated (e.g., through an allgather) and
+ * deserialized at once.
+ *
+ * \param buf [IN/OUT]          pointer to destination buffer
+ * \param buf_size [IN]         buffer size
+ * \param flags [IN]            optional flags
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param addrs [IN]            array of abstract addresses
+ * \param count [IN]            number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_serialize_book(void *buf, hg_size_t buf_size, unsigned long flags,
+    hg_core_class_t *hg_core_class, const hg_core_addr_t *addrs,
+    unsigned int count);
+
+/**
+ * Deserialize one or more concatenated address books in one call. If \addrs
+ * is NULL or *count_p is smaller than the number of entries, HG_OVERFLOW is
+ * returned and *count_p is set to the number of entries. The returned
+ * addresses must be freed with HG_Core_addr_free().
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param buf [IN]              pointer to buffer used for deserialization
+ * \param buf_size [IN]         buffer size
+ * \param addrs [OUT]           array of abstract addresses
+ * \param count_p [IN/OUT]      pointer to number of addresses
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_addr_deserialize_book(hg_core_class_t *hg_core_class, const void *buf,
+    hg_size_t buf_size, hg_core_addr_t *addrs, unsigned int *count_p);
+
 /**
  * Initiate a new HG RPC using the specified function ID and the local/remote
  * target defined by addr. The HG handle created can be used to query input
@@ -806,6 +1214,17 @@ HG_Core_get_rpc_data(hg_core_handle_t handle);
 static HG_INLINE hg_return_t
 HG_Core_set_target_id(hg_core_handle_t handle, hg_uint8_t id);
 
+/**
+ * Determine whether the handle forwards to ourself through the loopback
+ * interface, in which case origin and target share that same handle.
+ *
+ * \param handle [IN]           HG handle
+ *
+ * \return HG_TRUE if forwarding to ourself, HG_FALSE otherwise
+ */
+HG_PUBLIC hg_bool_t
+HG_Core_is_self(hg_core_handle_t handle);
+
 /**
  * Get input buffer from handle that can be used for serializing/deserializing
  * parameters.
@@ -847,6 +1266,18 @@ static HG_INLINE hg_return_t
 HG_Core_get_output(
     hg_core_handle_t handle, void **out_buf_p, hg_size_t *out_buf_size_p);
 
+/**
+ * Allocate the output buffer of a handle. Handles posted to receive requests
+ * only allocate their output buffer once it is first needed, this is called
+ * from HG_Core_get_output() and does not need to be called directly.
+ *
+ * \param handle [IN]           HG handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_alloc_output(hg_core_handle_t handle);
+
 /**
  * Forward a call using an existing HG handle. Input and output buffers can be
  * queried from the handle to serialize/deserialize parameters.
@@ -884,6 +1315,50 @@ HG_PUBLIC hg_return_t
 HG_Core_respond(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
     hg_uint8_t flags, hg_size_t payload_size);
 
+/**
+ * Respond back to the origins of several handles at once, as if
+ * HG_Core_respond() was called on each of them. Responses that are sent
+ * through NA are posted together, grouped by NA context and destination,
+ * so that plugins can amortize the cost of posting them. Responses that
+ * could not be posted are still completed through the callback with an
+ * error.
+ *
+ * \param handles [IN]          array of HG handles
+ * \param count [IN]            number of handles
+ * \param callback [IN]         pointer to function callback
+ * \param args [IN]             array of data passed to callback (may be NULL)
+ * \param flags [IN]            array of flags (may be NULL)
+ * \param payload_sizes [IN]    array of sizes of payload to send
+ * \param rets [OUT]            array of return codes of each response
+ *                              (may be NULL)
+ *
+ * \return HG_SUCCESS if all responses were posted or first error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_respond_batch(hg_core_handle_t handles[], unsigned int count,
+    hg_core_cb_t callback, void *const args[], const hg_uint8_t flags[],
+    const hg_size_t payload_sizes[], hg_return_t rets[]);
+
+/**
+ * Send a partial response to an origin that enabled streaming with
+ * HG_Core_set_stream(). The output buffer is encoded as for
+ * HG_Core_respond() and the partial response must fit in it. Only one
+ * partial response can be in flight, the next one can be posted once the
+ * callback is triggered. A partial response is held back until the origin
+ * returns credits if it already has as many partial responses in flight as
+ * it gave credits. The stream ends with HG_Core_respond().
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param payload_size [IN]     size of payload to send
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_respond_partial(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_size_t payload_size);
+
 /**
  * Try to progress RPC execution for at most timeout until timeout is reached or
  * any completion has occurred.
@@ -899,6 +1374,29 @@ HG_Core_respond(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
 HG_PUBLIC hg_return_t
 HG_Core_progress(hg_core_context_t *context, unsigned int timeout);
 
+/**
+ * Progress several contexts from a single call, which saves threads that own
+ * several contexts (one per NIC, SM and NA, etc) from round-robin calls to
+ * progress with small timeouts. Contexts are first polled without blocking,
+ * if none of them has work, the calling thread blocks on the wait fds of all
+ * contexts at once until one of them has work or timeout is reached. If one
+ * of the contexts does not expose a wait fd, contexts are polled without
+ * blocking until timeout is reached. Bit i of ready_p is set if contexts[i]
+ * progressed or has completions to trigger, so that only these contexts
+ * need to be triggered. Contexts must not be progressed concurrently by
+ * other threads.
+ *
+ * \param contexts [IN]         array of HG core contexts
+ * \param count [IN]            number of contexts (at most 64)
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param ready_p [OUT]         pointer to mask of ready contexts
+ *
+ * \return HG_SUCCESS if any context is ready / HG error code otherwise
+ */
+HG_PUBLIC hg_return_t
+HG_Core_progress_multi(hg_core_context_t *contexts[], unsigned int count,
+    unsigned int timeout, hg_uint64_t *ready_p);
+
 /**
  * Execute at most max_count callbacks. If timeout is non-zero, wait up to
  * timeout before returning. Function can return when at least one or more
@@ -915,6 +1413,25 @@ HG_PUBLIC hg_return_t
 HG_Core_trigger(hg_core_context_t *context, unsigned int timeout,
     unsigned int max_count, unsigned int *actual_count_p);
 
+/**
+ * Execute at most max_count callbacks, draining completion entries in batches
+ * rather than one at a time. Same semantics as HG_Core_trigger(), except that
+ * the number of completion entries still queued on return is also reported,
+ * so that callers can decide whether to trigger again or make progress.
+ *
+ * \param context [IN]              pointer to HG core context
+ * \param timeout [IN]              timeout (in milliseconds)
+ * \param max_count [IN]            maximum number of callbacks triggered
+ * \param actual_count_p [OUT]      actual number of callbacks triggered
+ * \param remaining_count_p [OUT]   number of completions left in queue
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_trigger_batch(hg_core_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count_p,
+    unsigned int *remaining_count_p);
+
 /**
  * Cancel an ongoing operation.
  *
@@ -925,6 +1442,54 @@ HG_Core_trigger(hg_core_context_t *context, unsigned int timeout,
 HG_PUBLIC hg_return_t
 HG_Core_cancel(hg_core_handle_t handle);
 
+/**
+ * Set timeout of next forwards of handle, which overrides the default
+ * timeout of its RPC ID. Forwards that have not completed once the timeout
+ * is reached are canceled from progress and complete with HG_TIMEOUT.
+ * Forwards to self cannot be canceled and do not expire.
+ *
+ * \param handle [IN]           HG core handle
+ * \param timeout_ms [IN]       timeout in ms (0 for default)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_set_timeout(hg_core_handle_t handle, unsigned int timeout_ms);
+
+/**
+ * Let the target of the next forwards of handle stream partial responses
+ * before its final response. Each partial response is passed to callback
+ * (of type HG_CB_FORWARD) as it is triggered, its output can be decoded from
+ * the callback only. The forward callback is triggered once the final
+ * response is received. At most credits partial responses are in flight,
+ * credits are returned to the target as partial responses are triggered.
+ * Streaming is not supported for forwards to self or without response.
+ *
+ * \param handle [IN]           HG core handle
+ * \param callback [IN]         pointer to partial response callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param credits [IN]          max partial responses in flight (0 to
+ *                              disable, at most 255)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_set_stream(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
+    unsigned int credits);
+
+/**
+ * Mark handle as persistent: its target address and RPC ID are not expected
+ * to change until the handle is reset, so that the request header is only
+ * encoded once and re-used by subsequent forwards that use the same flags.
+ * HG_Core_reset() clears that state.
+ *
+ * \param handle [IN]           HG core handle
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+HG_Core_set_persistent(hg_core_handle_t handle);
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -1199,6 +1764,12 @@ HG_Core_get_output(
     hg_size_t header_offset =
         hg_core_header_response_get_size() + handle->na_out_header_offset;
 
+    if (handle->out_buf == NULL) {
+        hg_return_t ret = HG_Core_alloc_output(handle);
+        if (ret != HG_SUCCESS)
+            return ret;
+    }
+
     /* Space must be left for response header */
     *out_buf_p = (char *) handle->out_buf + header_offset;
     *out_buf_size_p = handle->out_buf_size - header_offset;
@@ -208,6 +208,10 @@ hg_core_header_request_proc(hg_proc_op_t op, void *buf, size_t buf_size,
     HG_CORE_HEADER_PROC(
         hg_core_header, buf_ptr, header->cookie, hg_uint8_t, op);
 
+    /* Released lease */
+    HG_CORE_HEADER_PROC(
+        hg_core_header, buf_ptr, header->release, hg_uint32_t, op);
+
 #ifdef HG_HAS_CHECKSUMS
     if (hg_core_header->checksum != MCHECKSUM_OBJECT_NULL) {
         /* Checksum of header */
@@ -26,8 +26,9 @@ HG_PACKED(struct hg_core_header_request {
     hg_uint64_t id;                 /* RPC request identifier */
     hg_uint8_t flags;               /* Flags */
     hg_uint8_t cookie;              /* Cookie */
+    hg_uint32_t release;            /* Tag of released output lease */
     union hg_core_header_hash hash; /* Hash */
-    /* 128 bits here */
+    /* 160 bits here */
 });
 
 HG_PACKED(struct hg_core_header_response {
@@ -45,7 +46,8 @@ HG_PACKED(struct hg_core_header_request {
     hg_uint64_t id;      /* RPC request identifier */
     hg_uint8_t flags;    /* Flags */
     hg_uint8_t cookie;   /* Cookie */
-    /* 96 bits here */
+    hg_uint32_t release; /* Tag of released output lease */
+    /* 128 bits here */
 });
 
 HG_PACKED(struct hg_core_header_response {
@@ -76,7 +78,8 @@ struct hg_core_header {
  *
  *
  * Request:
- * mercury byte / protocol version number / rpc id / flags / cookie / checksum
+ * mercury byte / protocol version number / rpc id / flags / cookie / release
+ * / checksum
  *
  * Response:
  * flags / return code / cookie / checksum
@@ -90,7 +93,7 @@ struct hg_core_header {
 #define HG_CORE_IDENTIFIER (('H' << 1) | ('G')) /* 0xD7 */
 
 /* Mercury protocol version number */
-#define HG_CORE_PROTOCOL_VERSION 0x05
+#define HG_CORE_PROTOCOL_VERSION 0x07
 
 /*********************/
 /* Public Prototypes */
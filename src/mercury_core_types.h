@@ -95,6 +95,287 @@ struct hg_init_info {
      * beneficial in cases where the RPC execution time is longer than usual.
      * Default is: false */
     hg_bool_t release_input_early;
+
+    /* Number of completion queues that each context distributes completions
+     * to. When greater than 1, threads calling HG_Trigger() on the same
+     * context preferentially drain their own queue and only steal from other
+     * queues when it is empty, which reduces contention when many threads
+     * trigger on the same context. A value of 0 or 1 uses a single queue.
+     * Default is: 0 */
+    hg_uint32_t completion_queue_shards;
+
+    /* Maximum amount of time (in microseconds) that progress may busy-spin
+     * before blocking on the context's file descriptors. The actual spin
+     * budget adapts to the recently observed wait times between completions
+     * and can be retrieved through HG_Context_get_spin_budget(). Only applies
+     * when blocking progress is possible. A value of 0 disables spinning.
+     * Default is: 0 */
+    hg_uint32_t progress_spin_max;
+
+    /* Maximum number of RPC requests to the same target that may be packed
+     * into a single unexpected message. Requests are held back until that
+     * count is reached, the message is full or request_coalesce_delay has
+     * elapsed. Responses are not coalesced. A value of 0 or 1 disables
+     * coalescing. Default is: 0 */
+    hg_uint32_t request_coalesce_max;
+
+    /* Maximum amount of time (in microseconds) that a request may be held
+     * back when request_coalesce_max is set. Pending requests are sent from
+     * progress once that delay has elapsed, a value of 0 sends them on the
+     * next call to progress. Default is: 0 */
+    hg_uint32_t request_coalesce_delay;
+
+    /* When request_coalesce_max is set, size the coalescing window of each
+     * target from the observed arrival rate of requests to that target
+     * instead of always holding requests back for request_coalesce_delay,
+     * which then acts as a budget of added latency. Requests to a target
+     * that is idle (i.e., whose previous request is older than that budget)
+     * are sent right away. Default is: false */
+    hg_bool_t request_coalesce_adaptive;
+
+    /* When multi-recv is used, input is decoded in place from the
+     * multi-recv buffer that it was received in. Setting this option releases
+     * that buffer as soon as HG_Free_input() is called instead of waiting for
+     * the handle to be destroyed, so that the buffer can be re-posted while
+     * the RPC is still being executed. Pointers returned by
+     * HG_Get_input_buf() are no longer valid after HG_Free_input().
+     * Default is: false */
+    hg_bool_t release_input_on_free;
+
+    /* Input fields processed through hg_proc_bytes() whose size is at least
+     * this many bytes are not copied when encoding but referenced directly
+     * from user memory and exposed to the target through the extra bulk
+     * handle that is used for payloads that do not fit into the eager
+     * buffer. Referenced memory must remain valid until the forward
+     * completes. Values smaller than the eager buffer size are raised to it.
+     * A value of 0 disables input references. Default is: 0 */
+    hg_size_t input_ref_threshold;
+
+    /* Maximum amount of memory (in bytes) whose registration may be kept in
+     * a cache after the bulk handles that use it are freed, so that further
+     * calls to HG_Bulk_create() on the same buffer (same address, length,
+     * permission flags and memory type) do not register memory again. Only
+     * bulk handles with a single segment are cached. Least recently used
+     * registrations are released first when the limit is exceeded. Memory
+     * must be invalidated with HG_Bulk_cache_invalidate() before it is
+     * freed. A value of 0 disables the cache. Default is: 0 */
+    hg_size_t bulk_reg_cache_max;
+
+    /* Maximum size (in bytes) of a single NA operation issued by bulk
+     * transfers. Transfers (or segments) that are larger are split into
+     * chunks of at most that size. A value of 0 does not split transfers.
+     * Default is: 0 */
+    hg_size_t bulk_chunk_size;
+
+    /* Maximum number of NA operations that a single bulk transfer may have
+     * in flight. When a transfer requires more operations, the remaining
+     * ones are issued as previous ones complete. A value of 0 does not limit
+     * the number of operations in flight. Default is: 0 */
+    hg_uint32_t bulk_max_inflight;
+
+    /* Maximum amount of memory (in bytes) that multi-recv buffers of a
+     * context may use. When buffers are consumed faster than they can be
+     * released, additional and larger buffers are posted within that limit,
+     * and they are released again once traffic drops. A value of 0 keeps a
+     * fixed set of buffers. Only used when multi-recv is available.
+     * Default is: 0 */
+    hg_size_t multi_recv_mem_max;
+
+    /* Number of forwarded RPCs whose response may be received through the
+     * listening class' unexpected (or multi-recv) path instead of a
+     * receive that is pre-posted for each request. Responses are matched
+     * against a table of that many slots (rounded up to a power of 2), RPCs
+     * forwarded while the table is full pre-post their receive as usual.
+     * Requires a listening class and an NA plugin without message headers
+     * whose max unexpected size is at least its max expected size. A value
+     * of 0 pre-posts all response receives. Default is: 0 */
+    hg_uint32_t response_table_size;
+
+    /* Maximum amount of memory (in bytes) that may be kept in a pool of
+     * buffers used to receive payloads that do not fit into the eager
+     * buffer. Pooled buffers remain registered so that receiving such a
+     * payload does not allocate and register memory each time. Buffers are
+     * pooled by power-of-2 multiples of the page size, larger payloads are
+     * not pooled. A value of 0 disables the pool. Default is: 0 */
+    hg_size_t extra_buf_pool_max;
+
+    /* When checksum_level is HG_CHECKSUM_RPC_PAYLOAD, compute the payload
+     * checksum as a CRC32C of the encoded payload in a single pass when it
+     * has been entirely encoded or decoded (using CRC32 instructions when
+     * the CPU supports them), instead of updating it for each field that is
+     * processed. Origin and target must use the same setting.
+     * Default is: false */
+    hg_bool_t checksum_payload_buf;
+
+    /* Maximum number of bulk handles that HG_Bulk_deserialize() may keep in
+     * a cache indexed by the serialized descriptor, so that receiving the
+     * same descriptor again (e.g., a client re-using a registered buffer
+     * across RPCs) returns a reference to the existing handle instead of
+     * deserializing NA memory handles and addresses again. Descriptors that
+     * embed eager data are not cached. Least recently used handles are
+     * released first when the limit is exceeded. A value of 0 disables the
+     * cache. Default is: 0 */
+    hg_uint32_t bulk_desc_cache_max;
+
+    /* NA info strings of additional NA classes (e.g., one per additional
+     * NIC) that bulk transfers may be striped across. These classes are only
+     * used for RMA operations, RPCs remain sent through the default NA class.
+     * Memory of bulk handles that have a single registration is also
+     * registered with these classes (registrations on additional classes are
+     * not cached). Both origin and target must use the same number and order
+     * of classes. Default is: NULL */
+    const char *const *bulk_rail_info_strings;
+
+    /* Number of info strings in bulk_rail_info_strings (at most 3).
+     * Default is: 0 */
+    hg_uint32_t bulk_rail_count;
+
+    /* Transfers that are smaller than that size (and bulk handles that are
+     * smaller than that size) do not use the additional NA classes of
+     * bulk_rail_info_strings. Transfers that are larger are split across all
+     * classes in proportion to the bandwidth that was measured on each of
+     * them. A value of 0 uses a default of 64 KiB. Default is: 0 */
+    hg_size_t bulk_rail_min_size;
+
+    /* Defer NA registration of host memory bulk handles until they are
+     * serialized for a peer in another process or used in a transfer with
+     * such a peer. Handles that are only exchanged within the process (e.g.,
+     * services co-located in one binary that forward RPCs to themselves) are
+     * transferred through copies and never registered. Registration errors
+     * are then reported by HG_Bulk_serialize() or HG_Bulk_transfer().
+     * Default is: false */
+    hg_bool_t bulk_lazy_register;
+
+    /* Maximum number of bytes that bulk transfers of a context may have in
+     * flight over NA. Once reached, new transfers are queued per origin and
+     * started in round-robin order across origins as previous transfers
+     * complete, so that a server pulling data from many clients neither
+     * saturates the network nor delays RPC traffic. Transfers larger than
+     * the limit are started alone. A value of 0 does not limit transfers.
+     * Default is: 0 */
+    hg_size_t bulk_max_inflight_size;
+
+    /* Soft cap on the number of requests that are posted per context and NA
+     * class when pools of handles are extended (see \request_post_incr). Once
+     * reached, handles are only re-posted after they complete and incoming
+     * requests are left for the NA transport to queue, which bounds the memory
+     * held by pre-posted buffers. This does not apply to multi-recv, whose
+     * buffers are bounded by \multi_recv_mem_max. A value of 0 does not
+     * limit the number of posted requests.
+     * Default is: 0 */
+    hg_uint32_t request_post_max;
+
+    /* Maximum number of received requests of a context that may wait for
+     * their RPC callback to be triggered. Requests received beyond that
+     * number are rejected from the receive path without invoking their RPC
+     * callback: the forward completes on the origin with HG_BUSY (requests
+     * that expect no response are dropped). RPCs marked with
+     * HG_Registered_bypass_admission() are never rejected. A value of 0 does
+     * not limit the number of waiting requests. Default is: 0 */
+    hg_uint32_t admission_queue_max;
+
+    /* Maximum average time (in microseconds) that received requests may
+     * wait before their RPC callback is triggered, which grows with both the
+     * number of requests ahead and the time spent in RPC callbacks. While
+     * requests are waiting and that average is exceeded, new requests are
+     * rejected in the same way as with \admission_queue_max. A value of 0
+     * does not limit the wait. Default is: 0 */
+    hg_uint32_t admission_delay_max;
+
+    /* Number of requests that are posted on context creation when posting
+     * lazily. Pools of handles then grow towards \request_post_init from
+     * progress as posted requests get consumed, doubling each time, and
+     * continue with \request_post_incr afterwards. This avoids allocating and
+     * registering buffers for requests that short-lived contexts never
+     * receive. A value of 0 (or a value greater than or equal to
+     * \request_post_init) posts all requests on context creation.
+     * Default is: 0 */
+    hg_uint32_t request_post_seed;
+
+    /* Number of requests that may be posted across all contexts of the class
+     * on top of a few requests that each pool of handles always keeps posted.
+     * Pools draw from that shared budget as they grow, and once it is used
+     * up, contexts that run low on posted requests ask the others to give
+     * back some of theirs: contexts with many idle requests then cancel them
+     * from progress and the budget moves to where requests are received.
+     * Multi-recv buffers that grow past their initial size draw from the
+     * same budget (counted in max unexpected message sizes). This bounds the
+     * memory held by pre-posted buffers of many mostly idle contexts. A
+     * value of 0 lets each context post requests independently.
+     * Default is: 0 */
+    hg_uint32_t request_post_shared;
+
+    /* Maximum amount of memory (in bytes) that the class may use for pools
+     * of handles and bulk operations, NA message buffers and buffer pools,
+     * and extra buffers of large payloads. Once reached, these stop growing
+     * and operations that need more memory fail with HG_NOMEM or HG_AGAIN,
+     * letting callers apply backpressure. The memory in use is reported by
+     * HG_Core_context_get_handle_stats(). A value of 0 does not limit memory.
+     * Default is: 0 */
+    hg_size_t mem_max;
+
+    /* The class and its contexts are only ever used by a single thread
+     * (e.g., one event loop per core that does not share its class). Locks on
+     * handle lists are then skipped and handle refcounts use plain loads and
+     * stores. NA classes that are initialized by HG use
+     * NA_THREAD_MODE_SINGLE in that case.
+     * Default is: false */
+    hg_bool_t single_thread;
+
+    /* Eager bulk data received along with RPC input is not copied when the
+     * input is decoded. Segments of the deserialized bulk handle instead point
+     * into the input buffer (HG_Bulk_access() returns that pointer, which may
+     * not be aligned) and the RPC handle is kept alive until the bulk handle
+     * is freed. Note that this also delays the re-posting of multi-recv
+     * buffers. Ignored when release_input_early or release_input_on_free is
+     * set. Default is: false */
+    hg_bool_t bulk_eager_ref;
+
+    /* Deregistration of memory registered by bulk handles, and of cached
+     * registrations that are evicted (see bulk_reg_cache_max), is deferred
+     * when the last reference is released and performed from progress once
+     * the context is idle, at most this many at a time. Memory allocated by
+     * HG for bulk handles is only freed after it is deregistered. Note that
+     * memory passed to HG_Bulk_create() may still be registered after
+     * HG_Bulk_free() returns. A value of 0 deregisters memory immediately.
+     * Default is: 0 */
+    hg_uint32_t bulk_dereg_batch;
+
+    /* Maximum number of peers whose traffic is counted on each context (see
+     * HG_Core_class_get_hot_peers()). Peers are identified by their NA
+     * address, counters are kept per context and summed when read. Traffic
+     * with peers beyond that number is not counted. A value of 0 disables
+     * per-peer counters. Default is: 0 */
+    hg_uint32_t peer_stats_max;
+
+    /* Register the file descriptors of NA classes and of the loopback event
+     * as edge-triggered in the poll set of contexts (when the platform
+     * supports it). A descriptor that is reported as ready is then drained
+     * by progress until no further operation completes instead of being
+     * reported again by each wait while it is still being processed, which
+     * reduces wakeups and system calls under load.
+     * Default is: false */
+    hg_bool_t poll_edge_triggered;
+};
+
+/**
+ * HG context info struct (see HG_Context_create_opt())
+ */
+struct hg_context_info {
+    /* NA context info struct (CPUs / NUMA node the context is placed on),
+     * see na_types.h for documentation */
+    struct na_context_info na_context_info;
+
+    /* Run callbacks of operations that complete while progress is made on
+     * the context directly from progress instead of queueing them for
+     * HG_Trigger(). This saves a queue push / pop and a call to trigger per
+     * operation for single-threaded run-to-completion servers (see
+     * hg_init_info.single_thread). Only one thread may then make progress on
+     * the context, callbacks must not make progress on it, and operations
+     * that complete outside of progress (or while a callback executes) are
+     * still queued and require HG_Trigger().
+     * Default is: false */
+    hg_bool_t inline_completion;
 };
 
 /* Error return codes:
@@ -139,23 +420,33 @@ typedef enum hg_return { HG_RETURN_VALUES } hg_return_t;
 
 /* Callback operation type */
 typedef enum hg_cb_type {
-    HG_CB_LOOKUP,  /*!< lookup callback */
-    HG_CB_FORWARD, /*!< forward callback */
-    HG_CB_RESPOND, /*!< respond callback */
-    HG_CB_BULK     /*!< bulk transfer callback */
+    HG_CB_LOOKUP,        /*!< lookup callback */
+    HG_CB_FORWARD,       /*!< forward callback */
+    HG_CB_RESPOND,       /*!< respond callback */
+    HG_CB_BULK,          /*!< bulk transfer callback */
+    HG_CB_FORWARD_MULTI, /*!< fan-out forward callback */
+    HG_CB_WARM           /*!< address warm-up callback */
 } hg_cb_type_t;
 
 /* Input / output operation type */
 typedef enum { HG_UNDEF, HG_INPUT, HG_OUTPUT } hg_op_t;
 
+/* RPC priority class */
+typedef enum hg_prio {
+    HG_PRIO_NORMAL, /*!< default */
+    HG_PRIO_HIGH    /*!< latency-sensitive RPCs (e.g., heartbeats) */
+} hg_prio_t;
+
 /**
  * Encode/decode operations.
  */
 typedef enum {
     HG_ENCODE, /*!< causes the type to be encoded into the stream */
     HG_DECODE, /*!< causes the type to be extracted from the stream */
-    HG_FREE    /*!< can be used to release the space allocated by an HG_DECODE
+    HG_FREE,   /*!< can be used to release the space allocated by an HG_DECODE
                   request */
+    HG_SIZE    /*!< causes the encoded size of the type to be computed without
+                  encoding it */
 } hg_proc_op_t;
 
 /**
@@ -163,6 +454,114 @@ typedef enum {
  */
 #define HG_CORE_SM (1 << 0)
 
+/* Number of histogram buckets, values below 4 have their own bucket, each
+ * power of 2 above is then split into 4 buckets of equal width */
+#define HG_STATS_BUCKET_COUNT (252)
+
+/* Size of the trace context propagated along with RPC requests */
+#define HG_TRACE_CONTEXT_SIZE (32)
+
+/* RPC capture file magic ("HGCP") and format version */
+#define HG_CAPTURE_MAGIC   (0x48474350)
+#define HG_CAPTURE_VERSION (1)
+
+/* Histogram of samples with log-scaled buckets */
+struct hg_stats_histogram {
+    hg_uint64_t count;                          /* Number of samples */
+    hg_uint64_t sum;                            /* Sum of samples */
+    hg_uint64_t max;                            /* Largest sample */
+    hg_uint64_t buckets[HG_STATS_BUCKET_COUNT]; /* Samples per bucket */
+};
+
+/* RPC stats, times are in ns */
+struct hg_rpc_stats {
+    struct hg_stats_histogram latency;    /* Origin: forward to completion */
+    struct hg_stats_histogram handler;    /* Target: RPC callback to respond */
+    struct hg_stats_histogram queue_wait; /* Wait in completion queue */
+    struct hg_stats_histogram payload;    /* Payload of messages sent */
+};
+
+/* Traffic exchanged with a peer */
+struct hg_peer_stats {
+    hg_uint64_t rpc_in;      /* RPC requests received from peer */
+    hg_uint64_t rpc_out;     /* RPC requests sent to peer */
+    hg_uint64_t bytes_in;    /* Request and response bytes received */
+    hg_uint64_t bytes_out;   /* Request and response bytes sent */
+    hg_uint64_t bulk_bytes;  /* Bytes of bulk transfers posted with peer */
+    hg_uint64_t error_count; /* RPCs with peer that completed with an error */
+};
+
+/* Progress loop stats of a context. Times are in ns and only accumulated
+ * over sampled calls, time spent in NA progress includes the time NA plugins
+ * that do not expose a file descriptor block for. */
+struct hg_progress_stats {
+    hg_uint64_t progress_count;    /* Number of progress calls */
+    hg_uint64_t progress_samples;  /* Number of sampled progress calls */
+    hg_uint64_t trigger_count;     /* Number of trigger calls */
+    hg_uint64_t trigger_samples;   /* Number of sampled trigger calls */
+    hg_uint64_t progress_time;     /* Time spent in progress */
+    hg_uint64_t poll_wait_time;    /* Time blocked in poll (idle) */
+    hg_uint64_t na_time;           /* Time spent in NA progress */
+    hg_uint64_t na_sm_time;        /* Time spent in NA SM progress */
+    hg_uint64_t trigger_time;      /* Time spent in trigger (busy) */
+    hg_uint64_t trigger_wait_time; /* Time waiting in trigger (idle) */
+    hg_uint64_t callback_time;     /* Time spent in callbacks */
+    double idle_ratio;             /* Idle over total sampled time */
+    double busy_ratio;             /* Busy over total sampled time */
+};
+
+/* Handle stats of a context, pool stats include both NA and NA SM pools */
+struct hg_handle_stats {
+    hg_uint64_t handle_count;      /* Number of handles created on context */
+    hg_uint64_t pool_count;        /* Number of handles in pools */
+    hg_uint64_t pool_available;    /* Number of pool handles available */
+    hg_uint64_t extend_count;      /* Number of pool extensions */
+    hg_uint64_t extend_wait_count; /* Waits on extension by other threads */
+    hg_uint64_t extend_wait_time;  /* Time waiting on extensions (ns) */
+    hg_uint64_t cap_count;         /* Pools ran out of handles at soft cap */
+    hg_uint64_t queued_count;      /* Requests waiting for their callback */
+    hg_uint64_t shed_count;        /* Requests rejected when overloaded */
+    hg_uint64_t reclaim_count;     /* Posted requests given to other contexts */
+    hg_uint64_t mem_used;          /* Bytes of class memory budget in use */
+};
+
+/* Trace events */
+typedef enum hg_trace_event {
+    HG_TRACE_FORWARD,       /*!< origin: request is about to be sent */
+    HG_TRACE_SEND_COMPLETE, /*!< origin: request was sent */
+    HG_TRACE_RECV,          /*!< target: request was received */
+    HG_TRACE_HANDLER,       /*!< target: RPC callback is about to run */
+    HG_TRACE_RESPOND,       /*!< target: response is about to be sent */
+    HG_TRACE_COMPLETE       /*!< origin: forward callback is about to run */
+} hg_trace_event_t;
+
+/* Trace event info */
+struct hg_trace_info {
+    void *context;          /* Trace context (HG_TRACE_CONTEXT_SIZE bytes) */
+    hg_uint64_t cycles;     /* Cycle counter value (see hg_time_get_cycles()) */
+    hg_id_t id;             /* RPC ID */
+    hg_trace_event_t event; /* Trace event */
+};
+
+/* RPC capture file header, followed by records in host byte order */
+struct hg_capture_header {
+    hg_uint32_t magic;       /* HG_CAPTURE_MAGIC */
+    hg_uint32_t version;     /* HG_CAPTURE_VERSION */
+    hg_uint32_t record_size; /* Size of each record */
+    hg_uint32_t reserved;    /* Unused */
+};
+
+/* RPC capture record, written by the target once the RPC callback responded.
+ * Times are in ns. */
+struct hg_capture_record {
+    hg_uint64_t arrival;      /* RPC callback start since capture start */
+    hg_uint64_t id;           /* RPC ID */
+    hg_uint64_t handler_time; /* RPC callback to respond */
+    hg_uint64_t bulk_size;    /* Size of bulk handles decoded from input */
+    hg_uint32_t in_size;      /* Request payload (including extra payload) */
+    hg_uint32_t out_size;     /* Response payload (0 if no response) */
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -188,7 +587,23 @@ typedef enum {
         .request_post_init = 0, .request_post_incr = 0, .auto_sm = HG_FALSE,   \
         .sm_info_string = NULL, .checksum_level = HG_CHECKSUM_NONE,            \
         .no_bulk_eager = HG_FALSE, .no_loopback = HG_FALSE, .stats = HG_FALSE, \
-        .no_multi_recv = HG_FALSE, .release_input_early = HG_FALSE             \
+        .no_multi_recv = HG_FALSE, .release_input_early = HG_FALSE,            \
+        .completion_queue_shards = 0, .progress_spin_max = 0,                  \
+        .request_coalesce_max = 0, .request_coalesce_delay = 0,                \
+        .request_coalesce_adaptive = HG_FALSE,                                 \
+        .release_input_on_free = HG_FALSE, .input_ref_threshold = 0,           \
+        .bulk_reg_cache_max = 0, .bulk_chunk_size = 0,                         \
+        .bulk_max_inflight = 0, .multi_recv_mem_max = 0,                       \
+        .response_table_size = 0, .extra_buf_pool_max = 0,                     \
+        .checksum_payload_buf = HG_FALSE, .bulk_desc_cache_max = 0,            \
+        .bulk_rail_info_strings = NULL, .bulk_rail_count = 0,                  \
+        .bulk_rail_min_size = 0, .bulk_lazy_register = HG_FALSE,               \
+        .bulk_max_inflight_size = 0, .request_post_max = 0,                    \
+        .admission_queue_max = 0, .admission_delay_max = 0,                    \
+        .request_post_seed = 0, .request_post_shared = 0, .mem_max = 0,        \
+        .single_thread = HG_FALSE, .bulk_eager_ref = HG_FALSE,                 \
+        .bulk_dereg_batch = 0, .peer_stats_max = 0,                            \
+        .poll_edge_triggered = HG_FALSE                                        \
     }
 
 #endif /* MERCURY_CORE_TYPES_H */
@@ -0,0 +1,448 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MERCURY_CORO_HPP
+#define MERCURY_CORO_HPP
+
+#include "mercury.h"
+#include "mercury_bulk.h"
+
+#include <coroutine>
+#include <utility>
+
+/**
+ * Header-only C++20 layer over the mercury callback API. Awaiters pass
+ * themselves as the callback argument of the operation they post: they live
+ * in the frame of the suspended coroutine and hold its handle, so awaiting
+ * an operation does not allocate and the coroutine is resumed in place from
+ * HG_Trigger(). Awaiting returns the hg_return_t of the operation (errors of
+ * the posting call are returned without suspending). RAII wrappers release
+ * handles, bulk handles and addresses on destruction.
+ */
+namespace hg {
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/* Owning wrapper of hg_handle_t (copies increment the ref count) */
+class handle {
+public:
+    handle() noexcept = default;
+    explicit handle(hg_handle_t h) noexcept : h_(h) {}
+    handle(const handle &other) noexcept : h_(other.h_)
+    {
+        if (h_ != HG_HANDLE_NULL)
+            (void) HG_Ref_incr(h_);
+    }
+    handle(handle &&other) noexcept
+        : h_(std::exchange(other.h_, HG_HANDLE_NULL))
+    {
+    }
+    handle &
+    operator=(handle other) noexcept
+    {
+        std::swap(h_, other.h_);
+        return *this;
+    }
+    ~handle() { reset(); }
+
+    /* Create a new handle */
+    static hg_return_t
+    create(hg_context_t *context, hg_addr_t addr, hg_id_t id, handle &h)
+    {
+        hg_handle_t new_h = HG_HANDLE_NULL;
+        hg_return_t ret = HG_Create(context, addr, id, &new_h);
+
+        if (ret == HG_SUCCESS)
+            h = handle(new_h);
+        return ret;
+    }
+
+    /* Release ownership */
+    hg_handle_t
+    release() noexcept
+    {
+        return std::exchange(h_, HG_HANDLE_NULL);
+    }
+
+    /* Destroy handle (decrement ref count) */
+    void
+    reset() noexcept
+    {
+        if (h_ != HG_HANDLE_NULL)
+            (void) HG_Destroy(std::exchange(h_, HG_HANDLE_NULL));
+    }
+
+    hg_handle_t
+    get() const noexcept
+    {
+        return h_;
+    }
+    explicit operator bool() const noexcept { return h_ != HG_HANDLE_NULL; }
+
+private:
+    hg_handle_t h_ = HG_HANDLE_NULL;
+};
+
+/* Owning wrapper of hg_bulk_t (copies increment the ref count) */
+class bulk {
+public:
+    bulk() noexcept = default;
+    explicit bulk(hg_bulk_t b) noexcept : b_(b) {}
+    bulk(const bulk &other) noexcept : b_(other.b_)
+    {
+        if (b_ != HG_BULK_NULL)
+            (void) HG_Bulk_ref_incr(b_);
+    }
+    bulk(bulk &&other) noexcept : b_(std::exchange(other.b_, HG_BULK_NULL)) {}
+    bulk &
+    operator=(bulk other) noexcept
+    {
+        std::swap(b_, other.b_);
+        return *this;
+    }
+    ~bulk() { reset(); }
+
+    /* Create a new bulk handle */
+    static hg_return_t
+    create(hg_class_t *hg_class, hg_uint32_t count, void **buf_ptrs,
+        const hg_size_t *buf_sizes, hg_uint8_t flags, bulk &b)
+    {
+        hg_bulk_t new_b = HG_BULK_NULL;
+        hg_return_t ret =
+            HG_Bulk_create(hg_class, count, buf_ptrs, buf_sizes, flags, &new_b);
+
+        if (ret == HG_SUCCESS)
+            b = bulk(new_b);
+        return ret;
+    }
+
+    /* Release ownership */
+    hg_bulk_t
+    release() noexcept
+    {
+        return std::exchange(b_, HG_BULK_NULL);
+    }
+
+    /* Free bulk handle (decrement ref count) */
+    void
+    reset() noexcept
+    {
+        if (b_ != HG_BULK_NULL)
+            (void) HG_Bulk_free(std::exchange(b_, HG_BULK_NULL));
+    }
+
+    hg_bulk_t
+    get() const noexcept
+    {
+        return b_;
+    }
+    explicit operator bool() const noexcept { return b_ != HG_BULK_NULL; }
+
+private:
+    hg_bulk_t b_ = HG_BULK_NULL;
+};
+
+/* Owning wrapper of hg_addr_t (copies duplicate the address) */
+class addr {
+public:
+    addr() noexcept = default;
+    addr(hg_class_t *hg_class, hg_addr_t a) noexcept : cls_(hg_class), a_(a) {}
+    addr(const addr &other) noexcept : cls_(other.cls_)
+    {
+        if (other.a_ != HG_ADDR_NULL &&
+            HG_Addr_dup(cls_, other.a_, &a_) != HG_SUCCESS)
+            a_ = HG_ADDR_NULL;
+    }
+    addr(addr &&other) noexcept
+        : cls_(other.cls_), a_(std::exchange(other.a_, HG_ADDR_NULL))
+    {
+    }
+    addr &
+    operator=(addr other) noexcept
+    {
+        std::swap(cls_, other.cls_);
+        std::swap(a_, other.a_);
+        return *this;
+    }
+    ~addr() { reset(); }
+
+    /* Look up an address (blocking) */
+    static hg_return_t
+    lookup(hg_class_t *hg_class, const char *name, addr &a)
+    {
+        hg_addr_t new_a = HG_ADDR_NULL;
+        hg_return_t ret = HG_Addr_lookup2(hg_class, name, &new_a);
+
+        if (ret == HG_SUCCESS)
+            a = addr(hg_class, new_a);
+        return ret;
+    }
+
+    /* Get self address */
+    static hg_return_t
+    self(hg_class_t *hg_class, addr &a)
+    {
+        hg_addr_t new_a = HG_ADDR_NULL;
+        hg_return_t ret = HG_Addr_self(hg_class, &new_a);
+
+        if (ret == HG_SUCCESS)
+            a = addr(hg_class, new_a);
+        return ret;
+    }
+
+    /* Release ownership */
+    hg_addr_t
+    release() noexcept
+    {
+        return std::exchange(a_, HG_ADDR_NULL);
+    }
+
+    /* Free address */
+    void
+    reset() noexcept
+    {
+        if (a_ != HG_ADDR_NULL)
+            (void) HG_Addr_free(cls_, std::exchange(a_, HG_ADDR_NULL));
+    }
+
+    hg_addr_t
+    get() const noexcept
+    {
+        return a_;
+    }
+    explicit operator bool() const noexcept { return a_ != HG_ADDR_NULL; }
+
+private:
+    hg_class_t *cls_ = nullptr;
+    hg_addr_t a_ = HG_ADDR_NULL;
+};
+
+/* Base of awaiters, post() is called with the callback and argument to pass
+ * to the operation and the coroutine is resumed from the callback */
+template<typename derived>
+class awaiter_base {
+public:
+    bool
+    await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool
+    await_suspend(std::coroutine_handle<> coro) noexcept
+    {
+        hg_return_t ret;
+
+        coro_ = coro;
+
+        /* Awaiter must not be accessed once posted, callback may already
+         * have been triggered from another thread */
+        ret = static_cast<derived *>(this)->post(callback, this);
+        if (ret == HG_SUCCESS)
+            return true;
+
+        /* Resume immediately if operation could not be posted */
+        ret_ = ret;
+        return false;
+    }
+
+    hg_return_t
+    await_resume() const noexcept
+    {
+        return ret_;
+    }
+
+protected:
+    static hg_return_t
+    callback(const struct hg_cb_info *callback_info)
+    {
+        awaiter_base *self = static_cast<awaiter_base *>(callback_info->arg);
+
+        self->ret_ = callback_info->ret;
+        self->coro_.resume();
+
+        return HG_SUCCESS;
+    }
+
+private:
+    std::coroutine_handle<> coro_;
+    hg_return_t ret_ = HG_SUCCESS;
+};
+
+/* Awaiter of HG_Forward() */
+class forward_awaiter : public awaiter_base<forward_awaiter> {
+public:
+    forward_awaiter(hg_handle_t h, void *in_struct) noexcept
+        : h_(h), in_struct_(in_struct)
+    {
+    }
+
+    hg_return_t
+    post(hg_cb_t cb, void *arg) noexcept
+    {
+        return HG_Forward(h_, cb, arg, in_struct_);
+    }
+
+private:
+    hg_handle_t h_;
+    void *in_struct_;
+};
+
+/* Awaiter of HG_Respond() */
+class respond_awaiter : public awaiter_base<respond_awaiter> {
+public:
+    respond_awaiter(hg_handle_t h, void *out_struct) noexcept
+        : h_(h), out_struct_(out_struct)
+    {
+    }
+
+    hg_return_t
+    post(hg_cb_t cb, void *arg) noexcept
+    {
+        return HG_Respond(h_, cb, arg, out_struct_);
+    }
+
+private:
+    hg_handle_t h_;
+    void *out_struct_;
+};
+
+/* Awaiter of HG_Bulk_transfer() */
+class bulk_transfer_awaiter : public awaiter_base<bulk_transfer_awaiter> {
+public:
+    bulk_transfer_awaiter(hg_context_t *context, hg_bulk_op_t op,
+        hg_addr_t origin_addr, hg_bulk_t origin_handle, hg_size_t origin_offset,
+        hg_bulk_t local_handle, hg_size_t local_offset, hg_size_t size) noexcept
+        : context_(context), op_(op), origin_addr_(origin_addr),
+          origin_handle_(origin_handle), origin_offset_(origin_offset),
+          local_handle_(local_handle), local_offset_(local_offset), size_(size)
+    {
+    }
+
+    hg_return_t
+    post(hg_cb_t cb, void *arg) noexcept
+    {
+        return HG_Bulk_transfer(context_, cb, arg, op_, origin_addr_,
+            origin_handle_, origin_offset_, local_handle_, local_offset_, size_,
+            HG_OP_ID_IGNORE);
+    }
+
+private:
+    hg_context_t *context_;
+    hg_bulk_op_t op_;
+    hg_addr_t origin_addr_;
+    hg_bulk_t origin_handle_;
+    hg_size_t origin_offset_;
+    hg_bulk_t local_handle_;
+    hg_size_t local_offset_;
+    hg_size_t size_;
+};
+
+/* Awaiter of HG_Forward_multi(), the fan-out operation must be released with
+ * HG_Multi_destroy() once resumed */
+class forward_multi_awaiter : public awaiter_base<forward_multi_awaiter> {
+public:
+    forward_multi_awaiter(hg_context_t *context, hg_id_t id,
+        const hg_addr_t *addrs, unsigned int count, unsigned int tree_arity,
+        void *in_struct, hg_multi_t *multi_p) noexcept
+        : context_(context), id_(id), addrs_(addrs), count_(count),
+          tree_arity_(tree_arity), in_struct_(in_struct), multi_p_(multi_p)
+    {
+    }
+
+    hg_return_t
+    post(hg_cb_t cb, void *arg) noexcept
+    {
+        return HG_Forward_multi(context_, id_, addrs_, count_, tree_arity_, cb,
+            arg, in_struct_, multi_p_);
+    }
+
+private:
+    hg_context_t *context_;
+    hg_id_t id_;
+    const hg_addr_t *addrs_;
+    unsigned int count_;
+    unsigned int tree_arity_;
+    void *in_struct_;
+    hg_multi_t *multi_p_;
+};
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+/**
+ * Forward a call, co_await returns the result of the call.
+ *
+ * \param h [IN]                handle
+ * \param in_struct [IN]        pointer to input structure
+ */
+inline forward_awaiter
+forward(const handle &h, void *in_struct) noexcept
+{
+    return forward_awaiter(h.get(), in_struct);
+}
+
+/**
+ * Respond to a call, co_await returns once the response has been sent.
+ *
+ * \param h [IN]                handle
+ * \param out_struct [IN]       pointer to output structure
+ */
+inline respond_awaiter
+respond(const handle &h, void *out_struct) noexcept
+{
+    return respond_awaiter(h.get(), out_struct);
+}
+
+/**
+ * Transfer data, co_await returns the result of the transfer.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param op [IN]               transfer operation
+ * \param origin_addr [IN]      address of origin
+ * \param origin_handle [IN]    origin bulk handle
+ * \param origin_offset [IN]    offset within origin handle
+ * \param local_handle [IN]     local bulk handle
+ * \param local_offset [IN]     offset within local handle
+ * \param size [IN]             size of data to be transferred
+ */
+inline bulk_transfer_awaiter
+bulk_transfer(hg_context_t *context, hg_bulk_op_t op, hg_addr_t origin_addr,
+    const bulk &origin_handle, hg_size_t origin_offset,
+    const bulk &local_handle, hg_size_t local_offset, hg_size_t size) noexcept
+{
+    return bulk_transfer_awaiter(context, op, origin_addr, origin_handle.get(),
+        origin_offset, local_handle.get(), local_offset, size);
+}
+
+/**
+ * Forward a call to a list of targets, co_await returns the first error
+ * returned by a target.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param id [IN]               registered function ID
+ * \param addrs [IN]            array of target addresses
+ * \param count [IN]            number of target addresses
+ * \param tree_arity [IN]       arity of forwarding tree (0 for direct)
+ * \param in_struct [IN]        pointer to input structure
+ * \param multi_p [OUT]         pointer to fan-out operation
+ */
+inline forward_multi_awaiter
+forward_multi(hg_context_t *context, hg_id_t id, const hg_addr_t *addrs,
+    unsigned int count, unsigned int tree_arity, void *in_struct,
+    hg_multi_t *multi_p) noexcept
+{
+    return forward_multi_awaiter(
+        context, id, addrs, count, tree_arity, in_struct, multi_p);
+}
+
+} // namespace hg
+
+#endif /* MERCURY_CORO_HPP */
@@ -85,36 +85,52 @@ hg_header_proc(
 {
 #ifdef HG_HAS_CHECKSUMS
     struct hg_header_hash *header_hash = NULL;
-    void *buf_ptr = buf;
 #endif
+    hg_uint8_t *compress = NULL, *flags = NULL;
+    void *buf_ptr = buf;
     hg_return_t ret = HG_SUCCESS;
 
-#ifdef HG_HAS_CHECKSUMS
     switch (hg_header->op) {
         case HG_INPUT:
             HG_CHECK_ERROR(buf_size < sizeof(struct hg_header_input), done, ret,
                 HG_INVALID_ARG, "Invalid buffer size");
+#ifdef HG_HAS_CHECKSUMS
             header_hash = &hg_header->msg.input.hash;
+#endif
+            compress = &hg_header->msg.input.compress;
+            flags = &hg_header->msg.input.flags;
             break;
         case HG_OUTPUT:
             HG_CHECK_ERROR(buf_size < sizeof(struct hg_header_output), done,
                 ret, HG_INVALID_ARG, "Invalid buffer size");
+#ifdef HG_HAS_CHECKSUMS
             header_hash = &hg_header->msg.output.hash;
+#endif
+            compress = &hg_header->msg.output.compress;
+            flags = &hg_header->msg.output.flags;
             break;
         default:
             HG_GOTO_ERROR(done, ret, HG_INVALID_ARG, "Invalid header op");
     }
 
+#ifdef HG_HAS_CHECKSUMS
     /* Checksum of user payload */
     HG_HEADER_PROC_TYPE(buf_ptr, header_hash->payload, hg_uint32_t, op);
-
-done:
-#else
-    (void) hg_header;
-    (void) buf;
-    (void) buf_size;
-    (void) op;
 #endif
 
+    /* Compressor ID (single byte) */
+    if (op == HG_ENCODE)
+        memcpy(buf_ptr, compress, sizeof(*compress));
+    else
+        memcpy(compress, buf_ptr, sizeof(*compress));
+    buf_ptr = (char *) buf_ptr + sizeof(*compress);
+
+    /* Header flags (single byte) */
+    if (op == HG_ENCODE)
+        memcpy(buf_ptr, flags, sizeof(*flags));
+    else
+        memcpy(flags, buf_ptr, sizeof(*flags));
+
+done:
     return ret;
 }
@@ -21,21 +21,31 @@ HG_PACKED(struct hg_header_hash {
 
 HG_PACKED(struct hg_header_input {
     struct hg_header_hash hash; /* Hash */
-    /* 160 bits here */
+    hg_uint8_t compress;        /* Compressor ID */
+    hg_uint8_t flags;           /* Header flags */
+    hg_uint8_t pad[2];
+    /* 192 bits here */
 });
 
 HG_PACKED(struct hg_header_output {
     struct hg_header_hash hash; /* Hash */
-    /* 160 bits here */
+    hg_uint8_t compress;        /* Compressor ID */
+    hg_uint8_t flags;           /* Header flags */
+    hg_uint8_t pad[2];
+    /* 192 bits here */
 });
 #else
 HG_PACKED(struct hg_header_input {
-    hg_uint32_t pad;
+    hg_uint8_t compress; /* Compressor ID */
+    hg_uint8_t flags;    /* Header flags */
+    hg_uint8_t pad[2];
     /* 128 bits here */
 });
 
 HG_PACKED(struct hg_header_output {
-    hg_uint32_t pad;
+    hg_uint8_t compress; /* Compressor ID */
+    hg_uint8_t flags;    /* Header flags */
+    hg_uint8_t pad[2];
     /* 128 bits here */
 });
 #endif
@@ -53,6 +63,13 @@ struct hg_header {
 /* Public Macros */
 /*****************/
 
+/* Input header flags */
+#define HG_HEADER_TREE       (1 << 0) /* Payload is relayed through a tree */
+#define HG_HEADER_OUT_REGION (1 << 1) /* Output region descriptor first */
+
+/* Output header flags */
+#define HG_HEADER_REGION (1 << 0) /* Payload written to output region */
+
 /*********************/
 /* Public Prototypes */
 /*********************/
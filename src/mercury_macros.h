@@ -24,6 +24,8 @@
  *   - MERCURY_REGISTER
  *   - MERCURY_GEN_PROC
  *   - MERCURY_GEN_STRUCT_PROC
+ *   - MERCURY_GEN_POD_PROC
+ *   - MERCURY_GEN_POD_STRUCT_PROC
  */
 
 /****************/
@@ -67,6 +69,96 @@
             return ret;                                                        \
         }
 
+/* Encoded size of fixed-size types (i.e., size processed by their proc), types
+ * that are not listed here cannot be used with MERCURY_GEN_POD_PROC */
+#    define HG_GEN_POD_SIZE_int8_t      sizeof(hg_int8_t)
+#    define HG_GEN_POD_SIZE_uint8_t     sizeof(hg_uint8_t)
+#    define HG_GEN_POD_SIZE_int16_t     sizeof(hg_int16_t)
+#    define HG_GEN_POD_SIZE_uint16_t    sizeof(hg_uint16_t)
+#    define HG_GEN_POD_SIZE_int32_t     sizeof(hg_int32_t)
+#    define HG_GEN_POD_SIZE_uint32_t    sizeof(hg_uint32_t)
+#    define HG_GEN_POD_SIZE_int64_t     sizeof(hg_int64_t)
+#    define HG_GEN_POD_SIZE_uint64_t    sizeof(hg_uint64_t)
+#    define HG_GEN_POD_SIZE_hg_int8_t   sizeof(hg_int8_t)
+#    define HG_GEN_POD_SIZE_hg_uint8_t  sizeof(hg_uint8_t)
+#    define HG_GEN_POD_SIZE_hg_int16_t  sizeof(hg_int16_t)
+#    define HG_GEN_POD_SIZE_hg_uint16_t sizeof(hg_uint16_t)
+#    define HG_GEN_POD_SIZE_hg_int32_t  sizeof(hg_int32_t)
+#    define HG_GEN_POD_SIZE_hg_uint32_t sizeof(hg_uint32_t)
+#    define HG_GEN_POD_SIZE_hg_int64_t  sizeof(hg_int64_t)
+#    define HG_GEN_POD_SIZE_hg_uint64_t sizeof(hg_uint64_t)
+#    define HG_GEN_POD_SIZE_hg_bool_t   sizeof(hg_uint8_t)
+#    define HG_GEN_POD_SIZE_hg_ptr_t    sizeof(hg_uint64_t)
+#    define HG_GEN_POD_SIZE_hg_size_t   sizeof(hg_uint64_t)
+#    define HG_GEN_POD_SIZE_hg_id_t     sizeof(hg_uint32_t)
+
+/* Get encoded size of fixed-size field */
+#    define HG_GEN_POD_SIZE(field)                                             \
+        BOOST_PP_CAT(HG_GEN_POD_SIZE_, HG_GEN_GET_TYPE(field))
+
+/* Add encoded size of fixed-size field */
+#    define HG_GEN_POD_ADD_SIZE(r, data, field) +HG_GEN_POD_SIZE(field)
+
+/* Encode fixed-size field and move buf_ptr past it */
+#    define HG_GEN_POD_ENCODE(r, struct_name, field)                           \
+        memcpy(buf_ptr, &struct_name->HG_GEN_GET_NAME(field),                  \
+            HG_GEN_POD_SIZE(field));                                           \
+        buf_ptr += HG_GEN_POD_SIZE(field);
+
+/* Decode fixed-size field and move buf_ptr past it */
+#    define HG_GEN_POD_DECODE(r, struct_name, field)                           \
+        memcpy(&struct_name->HG_GEN_GET_NAME(field), buf_ptr,                  \
+            HG_GEN_POD_SIZE(field));                                           \
+        buf_ptr += HG_GEN_POD_SIZE(field);
+
+/* Generate proc for struct of fixed-size fields. The encoded layout is the
+ * same as HG_GEN_STRUCT_PROC but the op and the size left are only checked
+ * once and fields are copied at constant offsets. XDR must convert each
+ * field so it falls back to HG_GEN_STRUCT_PROC, fields are also processed
+ * one by one when HG_PROC_VARINT is set. */
+#    ifdef HG_HAS_XDR
+#        define HG_GEN_POD_STRUCT_PROC(struct_type_name, fields)               \
+            HG_GEN_STRUCT_PROC(struct_type_name, fields)
+#    else
+#        define HG_GEN_POD_STRUCT_PROC(struct_type_name, fields)               \
+            static HG_INLINE hg_return_t BOOST_PP_CAT(                         \
+                hg_proc_, struct_type_name)(hg_proc_t proc, void *data)        \
+            {                                                                  \
+                hg_return_t ret = HG_SUCCESS;                                  \
+                struct_type_name *struct_data = (struct_type_name *) data;     \
+                const hg_size_t size =                                         \
+                    0 BOOST_PP_SEQ_FOR_EACH(HG_GEN_POD_ADD_SIZE, , fields);    \
+                char *buf_ptr;                                                 \
+                                                                               \
+                if (hg_proc_get_op(proc) == HG_FREE)                           \
+                    return ret;                                                \
+                if (unlikely(hg_proc_get_flags(proc) & HG_PROC_VARINT)) {      \
+                    BOOST_PP_SEQ_FOR_EACH(HG_GEN_PROC, struct_data, fields)    \
+                    return ret;                                                \
+                }                                                              \
+                if (hg_proc_get_op(proc) == HG_SIZE) {                         \
+                    HG_PROC_SIZE_UPDATE(proc, size);                           \
+                    return ret;                                                \
+                }                                                              \
+                                                                               \
+                HG_PROC_CHECK_SIZE(proc, size, done, ret);                     \
+                buf_ptr =                                                      \
+                    (char *) ((struct hg_proc *) proc)->current_buf->buf_ptr;  \
+                if (hg_proc_get_op(proc) == HG_ENCODE) {                       \
+                    BOOST_PP_SEQ_FOR_EACH(HG_GEN_POD_ENCODE, struct_data,      \
+                        fields)                                                \
+                } else {                                                       \
+                    BOOST_PP_SEQ_FOR_EACH(HG_GEN_POD_DECODE, struct_data,      \
+                        fields)                                                \
+                }                                                              \
+                HG_PROC_CHECKSUM_UPDATE(proc, buf_ptr - size, size);           \
+                HG_PROC_UPDATE(proc, size);                                    \
+                                                                               \
+            done:                                                              \
+                return ret;                                                    \
+            }
+#    endif
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -95,6 +187,22 @@
 #    define MERCURY_GEN_STRUCT_PROC(struct_type_name, fields)                  \
         HG_GEN_STRUCT_PROC(struct_type_name, fields)
 
+/* Same as MERCURY_GEN_PROC but for structs made only of fixed-size scalar
+ * fields (see HG_GEN_POD_SIZE_xxx types), the generated proc processes all
+ * fields at once and is compatible with the one of MERCURY_GEN_PROC.
+ * E.g.,
+ *   MERCURY_GEN_POD_PROC( bla_in_t, ((hg_uint64_t)(cookie))((int32_t)(op)) )
+ */
+#    define MERCURY_GEN_POD_PROC(struct_type_name, fields)                     \
+        HG_GEN_STRUCT(struct_type_name, fields)                                \
+        HG_GEN_POD_STRUCT_PROC(struct_type_name, fields)
+
+/* Same as MERCURY_GEN_STRUCT_PROC for user defined structures made only of
+ * fixed-size scalar fields.
+ */
+#    define MERCURY_GEN_POD_STRUCT_PROC(struct_type_name, fields)              \
+        HG_GEN_POD_STRUCT_PROC(struct_type_name, fields)
+
 #else /* HG_HAS_BOOST */
 
 /* Register func_name */
@@ -10,7 +10,9 @@
 
 #include "mercury_core.h"
 
+#include "mercury_atomic.h"
 #include "mercury_queue.h"
+#include "mercury_time.h"
 
 /*************************************/
 /* Public Type and Struct Definition */
@@ -18,7 +20,7 @@
 
 /* Previous versions of init info to keep compatiblity with older versions */
 struct hg_init_info_2_2 {
-    struct na_init_info na_init_info;
+    struct na_init_info_4_0 na_init_info;
     na_class_t *na_class;
     hg_uint32_t request_post_init;
     hg_uint32_t request_post_incr;
@@ -30,14 +32,30 @@ struct hg_init_info_2_2 {
     hg_bool_t stats;
 };
 
+struct hg_init_info_2_3 {
+    struct na_init_info_4_0 na_init_info;
+    na_class_t *na_class;
+    hg_uint32_t request_post_init;
+    hg_uint32_t request_post_incr;
+    hg_bool_t auto_sm;
+    const char *sm_info_string;
+    hg_checksum_level_t checksum_level;
+    hg_bool_t no_bulk_eager;
+    hg_bool_t no_loopback;
+    hg_bool_t stats;
+    hg_bool_t no_multi_recv;
+    hg_bool_t release_input_early;
+};
+
 /* Private callback type after completion of operations */
 typedef void (*hg_core_completion_cb_t)(void *arg);
 
 /* Completion type */
 typedef enum {
-    HG_ADDR, /*!< Addr completion */
-    HG_RPC,  /*!< RPC completion */
-    HG_BULK  /*!< Bulk completion */
+    HG_ADDR,  /*!< Addr completion */
+    HG_RPC,   /*!< RPC completion */
+    HG_BULK,  /*!< Bulk completion */
+    HG_STREAM /*!< Partial response completion */
 } hg_op_type_t;
 
 /* Completion queue entry */
@@ -51,7 +69,36 @@ struct hg_completion_entry {
     hg_op_type_t op_type;
 };
 
+/* Operation that the calling thread blocks on until it completes */
+struct hg_wait {
+    struct hg_core_context *core_context; /* Context of operation */
+    hg_atomic_int32_t done;               /* Wait word, set on completion */
+    hg_return_t ret;                      /* Return code of operation */
+};
+
+struct hg_context;
 struct hg_bulk_op_pool;
+struct hg_bulk_reg_cache;
+struct hg_bulk_desc_cache;
+struct hg_bulk_dereg_queue;
+
+/* Max number of NA classes that bulk transfers may be striped across */
+#define HG_CORE_RAIL_MAX (4)
+
+/* NA class used for bulk transfers */
+struct hg_core_rail {
+    na_class_t *na_class;        /* NA class */
+    na_addr_t *self_addr;        /* Self address (additional rails only) */
+    size_t self_addr_size;       /* Self address serialize size */
+    hg_atomic_int32_t bandwidth; /* Measured bandwidth (bytes/us, 0 if none) */
+};
+
+/* NA classes used for bulk transfers (rail 0 is the default NA class) */
+struct hg_core_rails {
+    struct hg_core_rail rail[HG_CORE_RAIL_MAX]; /* Rails */
+    hg_size_t min_size;                         /* Min size of transfers */
+    hg_uint8_t count;                           /* Number of rails */
+};
 
 /*****************/
 /* Public Macros */
@@ -90,6 +137,20 @@ static HG_INLINE void
 hg_init_info_dup_2_2(struct hg_init_info *hg_init_info,
     const struct hg_init_info_2_2 *hg_init_info_2_2);
 
+/**
+ * Duplicate init info for ABI compatibility.
+ */
+static HG_INLINE void
+hg_init_info_dup_2_3(struct hg_init_info *hg_init_info,
+    const struct hg_init_info_2_3 *hg_init_info_2_3);
+
+/**
+ * Duplicate NA init info embedded in previous versions of init info.
+ */
+static HG_INLINE void
+hg_na_init_info_dup_4_0(struct na_init_info *na_init_info,
+    const struct na_init_info_4_0 *na_init_info_4_0);
+
 /**
  * Increment bulk handle counter.
  */
@@ -102,6 +163,83 @@ hg_core_bulk_incr(hg_core_class_t *hg_core_class);
 HG_PRIVATE void
 hg_core_bulk_decr(hg_core_class_t *hg_core_class);
 
+/**
+ * Get bulk registration cache.
+ */
+HG_PRIVATE struct hg_bulk_reg_cache *
+hg_core_class_get_bulk_reg_cache(hg_core_class_t *hg_core_class);
+
+/**
+ * Get memory budget of class (NULL if memory is not limited).
+ */
+HG_PRIVATE struct hg_mem_budget *
+hg_core_class_get_mem_budget(hg_core_class_t *hg_core_class);
+
+/**
+ * Get bulk descriptor cache.
+ */
+HG_PRIVATE struct hg_bulk_desc_cache *
+hg_core_class_get_bulk_desc_cache(hg_core_class_t *hg_core_class);
+
+/**
+ * Get deferred deregistration queue (NULL if deregistration is not deferred).
+ */
+HG_PRIVATE struct hg_bulk_dereg_queue *
+hg_core_class_get_bulk_dereg_queue(hg_core_class_t *hg_core_class);
+
+/**
+ * Get NA classes used for bulk transfers.
+ */
+HG_PRIVATE struct hg_core_rails *
+hg_core_class_get_rails(hg_core_class_t *hg_core_class);
+
+/**
+ * Get NA context of bulk rail (NULL if not available on that context).
+ */
+HG_PRIVATE na_context_t *
+hg_core_context_get_na_rail(hg_core_context_t *core_context, hg_uint8_t index);
+
+/**
+ * Get bulk chunk size and maximum number of NA operations in flight.
+ */
+HG_PRIVATE void
+hg_core_class_get_bulk_pipeline_info(hg_core_class_t *hg_core_class,
+    hg_size_t *chunk_size_p, hg_uint32_t *max_inflight_p);
+
+/**
+ * Get whether registration of bulk handles is deferred.
+ */
+HG_PRIVATE hg_bool_t
+hg_core_class_get_bulk_lazy_register(hg_core_class_t *hg_core_class);
+
+/**
+ * Get max number of bytes that bulk transfers of a context may have in flight.
+ */
+HG_PRIVATE hg_size_t
+hg_core_class_get_bulk_max_inflight_size(hg_core_class_t *hg_core_class);
+
+/**
+ * Add size of bulk handle decoded from the input of an RPC to its capture
+ * record.
+ */
+HG_PRIVATE void
+hg_core_capture_bulk(hg_core_handle_t handle, hg_size_t size);
+
+/**
+ * Set size of the extra input payload of an RPC (payload that did not fit in
+ * the request) in its capture record.
+ */
+HG_PRIVATE void
+hg_core_capture_extra(hg_core_handle_t handle, hg_size_t size);
+
+/**
+ * Add size of a bulk transfer posted with addr to the peer counters of
+ * context (if enabled).
+ */
+HG_PRIVATE void
+hg_core_peer_stats_bulk(
+    struct hg_core_context *core_context, hg_core_addr_t addr, hg_size_t size);
+
 /**
  * Get bulk op pool.
  */
@@ -115,6 +253,43 @@ HG_PRIVATE void
 hg_core_completion_add(struct hg_core_context *core_context,
     struct hg_completion_entry *hg_completion_entry, hg_bool_t loopback_notify);
 
+/**
+ * Wait until the value pointed to by done_p is set and
+ * hg_core_completion_wake() is called, or until timeout_ms. If any_completion
+ * is set, also return as soon as the completion queue is not empty.
+ */
+HG_PRIVATE void
+hg_core_completion_wait(struct hg_core_context *core_context,
+    hg_atomic_int32_t *done_p, hg_bool_t any_completion,
+    unsigned int timeout_ms);
+
+/**
+ * Wake up threads waiting in hg_core_completion_wait() or trigger.
+ */
+HG_PRIVATE void
+hg_core_completion_wake(struct hg_core_context *core_context);
+
+/**
+ * Get whether a thread is currently making progress on context (always
+ * HG_FALSE if HG_HAS_MULTI_PROGRESS is not defined).
+ */
+HG_PRIVATE hg_bool_t
+hg_core_context_progressing(struct hg_core_context *core_context);
+
+/**
+ * Block until the operation of hg_wait completes or timeout_ms expires (in
+ * which case HG_TIMEOUT is returned and the operation is still pending).
+ */
+HG_PRIVATE hg_return_t
+hg_wait_progress(struct hg_context *context, struct hg_wait *hg_wait,
+    unsigned int timeout_ms);
+
+/**
+ * Complete operation of hg_wait and wake up the thread blocked on it.
+ */
+HG_PRIVATE void
+hg_wait_signal(struct hg_wait *hg_wait, hg_return_t ret);
+
 /**
  * Trigger callback from bulk op ID.
  */
@@ -134,24 +309,132 @@ hg_bulk_op_pool_create(hg_core_context_t *core_context, unsigned int init_count,
 HG_PRIVATE void
 hg_bulk_op_pool_destroy(struct hg_bulk_op_pool *hg_bulk_op_pool);
 
+/**
+ * Cancel bulk transfers of pool that reached their deadline. Returns HG_TRUE
+ * if transfers with a deadline remain, in which case deadline_p (if not NULL)
+ * is set to the earliest deadline.
+ */
+HG_PRIVATE hg_bool_t
+hg_bulk_op_pool_expire(
+    struct hg_bulk_op_pool *hg_bulk_op_pool, hg_time_t *deadline_p);
+
+/**
+ * Complete transfers to self whose device copies are done. Returns HG_TRUE
+ * if device copies remain in flight.
+ */
+HG_PRIVATE hg_bool_t
+hg_bulk_op_pool_device_poll(struct hg_bulk_op_pool *hg_bulk_op_pool);
+
+/**
+ * Create bulk registration cache.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_reg_cache_create(hg_size_t max_size,
+    struct hg_bulk_dereg_queue *hg_bulk_dereg_queue,
+    struct hg_bulk_reg_cache **hg_bulk_reg_cache_p);
+
+/**
+ * Destroy bulk registration cache, fails with HG_BUSY if registrations are
+ * still in use.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_reg_cache_destroy(struct hg_bulk_reg_cache *hg_bulk_reg_cache);
+
+/**
+ * Invalidate cached registrations that overlap range.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_reg_cache_invalidate(
+    struct hg_bulk_reg_cache *hg_bulk_reg_cache, hg_ptr_t base, hg_size_t len);
+
+/**
+ * Create bulk descriptor cache.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_desc_cache_create(
+    hg_uint32_t max_count, struct hg_bulk_desc_cache **hg_bulk_desc_cache_p);
+
+/**
+ * Destroy bulk descriptor cache and release cached handles.
+ */
+HG_PRIVATE void
+hg_bulk_desc_cache_destroy(struct hg_bulk_desc_cache *hg_bulk_desc_cache);
+
+/**
+ * Create queue of deferred deregistrations, released by batches of batch.
+ */
+HG_PRIVATE hg_return_t
+hg_bulk_dereg_queue_create(
+    hg_uint32_t batch, struct hg_bulk_dereg_queue **hg_bulk_dereg_queue_p);
+
+/**
+ * Release remaining deregistrations and destroy queue.
+ */
+HG_PRIVATE void
+hg_bulk_dereg_queue_destroy(struct hg_bulk_dereg_queue *hg_bulk_dereg_queue);
+
+/**
+ * Release one batch of deferred deregistrations (or all of them).
+ */
+HG_PRIVATE void
+hg_bulk_dereg_queue_drain(
+    struct hg_bulk_dereg_queue *hg_bulk_dereg_queue, hg_bool_t all);
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE void
 hg_init_info_dup_2_2(struct hg_init_info *hg_init_info,
     const struct hg_init_info_2_2 *hg_init_info_2_2)
 {
-    *hg_init_info =
-        (struct hg_init_info){.na_init_info = hg_init_info_2_2->na_init_info,
-            .na_class = hg_init_info_2_2->na_class,
-            .request_post_init = hg_init_info_2_2->request_post_init,
-            .request_post_incr = hg_init_info_2_2->request_post_incr,
-            .auto_sm = hg_init_info_2_2->auto_sm,
-            .sm_info_string = hg_init_info_2_2->sm_info_string,
-            .checksum_level = hg_init_info_2_2->checksum_level,
-            .no_bulk_eager = hg_init_info_2_2->no_bulk_eager,
-            .no_loopback = hg_init_info_2_2->no_loopback,
-            .stats = hg_init_info_2_2->stats,
-            .no_multi_recv = HG_FALSE,
-            .release_input_early = HG_FALSE};
+    *hg_init_info = HG_INIT_INFO_INITIALIZER;
+    hg_na_init_info_dup_4_0(
+        &hg_init_info->na_init_info, &hg_init_info_2_2->na_init_info);
+    hg_init_info->na_class = hg_init_info_2_2->na_class;
+    hg_init_info->request_post_init = hg_init_info_2_2->request_post_init;
+    hg_init_info->request_post_incr = hg_init_info_2_2->request_post_incr;
+    hg_init_info->auto_sm = hg_init_info_2_2->auto_sm;
+    hg_init_info->sm_info_string = hg_init_info_2_2->sm_info_string;
+    hg_init_info->checksum_level = hg_init_info_2_2->checksum_level;
+    hg_init_info->no_bulk_eager = hg_init_info_2_2->no_bulk_eager;
+    hg_init_info->no_loopback = hg_init_info_2_2->no_loopback;
+    hg_init_info->stats = hg_init_info_2_2->stats;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_init_info_dup_2_3(struct hg_init_info *hg_init_info,
+    const struct hg_init_info_2_3 *hg_init_info_2_3)
+{
+    *hg_init_info = HG_INIT_INFO_INITIALIZER;
+    hg_na_init_info_dup_4_0(
+        &hg_init_info->na_init_info, &hg_init_info_2_3->na_init_info);
+    hg_init_info->na_class = hg_init_info_2_3->na_class;
+    hg_init_info->request_post_init = hg_init_info_2_3->request_post_init;
+    hg_init_info->request_post_incr = hg_init_info_2_3->request_post_incr;
+    hg_init_info->auto_sm = hg_init_info_2_3->auto_sm;
+    hg_init_info->sm_info_string = hg_init_info_2_3->sm_info_string;
+    hg_init_info->checksum_level = hg_init_info_2_3->checksum_level;
+    hg_init_info->no_bulk_eager = hg_init_info_2_3->no_bulk_eager;
+    hg_init_info->no_loopback = hg_init_info_2_3->no_loopback;
+    hg_init_info->stats = hg_init_info_2_3->stats;
+    hg_init_info->no_multi_recv = hg_init_info_2_3->no_multi_recv;
+    hg_init_info->release_input_early = hg_init_info_2_3->release_input_early;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_na_init_info_dup_4_0(struct na_init_info *na_init_info,
+    const struct na_init_info_4_0 *na_init_info_4_0)
+{
+    *na_init_info = NA_INIT_INFO_INITIALIZER;
+    na_init_info->ip_subnet = na_init_info_4_0->ip_subnet;
+    na_init_info->auth_key = na_init_info_4_0->auth_key;
+    na_init_info->max_unexpected_size = na_init_info_4_0->max_unexpected_size;
+    na_init_info->max_expected_size = na_init_info_4_0->max_expected_size;
+    na_init_info->progress_mode = na_init_info_4_0->progress_mode;
+    na_init_info->addr_format = na_init_info_4_0->addr_format;
+    na_init_info->max_contexts = na_init_info_4_0->max_contexts;
+    na_init_info->thread_mode = na_init_info_4_0->thread_mode;
+    na_init_info->request_mem_device = na_init_info_4_0->request_mem_device;
 }
 
 #ifdef __cplusplus
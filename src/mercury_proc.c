@@ -6,10 +6,15 @@
  */
 
 #include "mercury_proc.h"
+#include "mercury.h"
 #include "mercury_error.h"
+#include "mercury_private.h"
+
 #include "mercury_mem.h"
+#include "mercury_mem_pool.h"
 
 #ifdef HG_HAS_CHECKSUMS
+#    include "mercury_crc32c.h"
 #    include <mchecksum.h>
 #endif
 #include <stdlib.h>
@@ -18,14 +23,81 @@
 /* Local Macros */
 /****************/
 
+/* Initial number of references */
+#define HG_PROC_REF_COUNT_INIT (4)
+
+/* Initial number of interned entries */
+#define HG_PROC_INTERN_COUNT_INIT (16)
+
+/* XDR encodes values in big-endian order */
+#if defined(HG_HAS_XDR) &&                                                     \
+    !(defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__))
+#    define HG_PROC_ARRAY_BSWAP
+#    include "mercury_byteswap.h"
+#endif
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Interned data */
+struct hg_proc_intern_entry {
+    const void *data;  /* Pointer to data */
+    hg_size_t size;    /* Size of data */
+    unsigned int hash; /* Hash of data (encode only) */
+};
+
+/* Intern table */
+struct hg_proc_intern {
+    struct hg_proc_intern_entry *entries; /* Array of entries */
+    hg_uint32_t *slots; /* Entry index + 1, 0 if empty (2 * max slots) */
+    hg_uint32_t count;  /* Number of entries */
+    hg_uint32_t max;    /* Size of entry array */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
 
+/**
+ * Process array of count values of size value_size.
+ */
+static hg_return_t
+hg_proc_array(
+    hg_proc_t proc, void *data, hg_size_t count, hg_size_t value_size);
+
+/**
+ * Hash interned data.
+ */
+static HG_INLINE unsigned int
+hg_proc_intern_hash(const void *data, hg_size_t data_size);
+
+/**
+ * Insert entry into slots of intern table.
+ */
+static void
+hg_proc_intern_insert(struct hg_proc_intern *intern, hg_uint32_t index);
+
+/**
+ * Charge extra buffer to the memory budget of the class.
+ */
+static HG_INLINE hg_bool_t
+hg_proc_mem_acquire(struct hg_proc *hg_proc, hg_size_t size);
+
+/**
+ * Return extra buffer to the memory budget of the class.
+ */
+static HG_INLINE void
+hg_proc_mem_release(struct hg_proc *hg_proc, hg_size_t size);
+
+#ifdef HG_HAS_CHECKSUMS
+/**
+ * Compute CRC32C of data processed so far (HG_CRC32C_BUF).
+ */
+static void
+hg_proc_checksum_buf(struct hg_proc *hg_proc);
+#endif
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -75,6 +147,13 @@ hg_proc_create(hg_class_t *hg_class, hg_proc_hash_t hash, hg_proc_t *proc_p)
             "Could not initialize checksum");
 
         hg_proc->checksum_size = mchecksum_get_size(hg_proc->checksum);
+    } else if (hash == HG_CRC32C_BUF) {
+        /* Fields are not hashed individually */
+        hg_proc->checksum_buf = HG_TRUE;
+        hg_proc->checksum_size = sizeof(hg_uint32_t);
+    }
+
+    if (hg_proc->checksum_size > 0) {
         hg_proc->checksum_hash = (char *) malloc(hg_proc->checksum_size);
         HG_CHECK_SUBSYS_ERROR(proc, hg_proc->checksum_hash == NULL, error, ret,
             HG_NOMEM, "Could not allocate space for checksum hash");
@@ -141,8 +220,20 @@ hg_proc_free(hg_proc_t proc)
 #endif
 
     /* Free extra proc buffer if needed */
-    if (hg_proc->extra_buf.buf && hg_proc->extra_buf.is_mine)
+    if (hg_proc->extra_buf.buf && hg_proc->extra_buf.is_mine) {
         hg_mem_aligned_free(hg_proc->extra_buf.buf);
+        hg_proc_mem_release(hg_proc, hg_proc->extra_buf.size);
+    }
+
+    /* Free references */
+    free(hg_proc->refs);
+
+    /* Free intern table */
+    if (hg_proc->intern) {
+        free(hg_proc->intern->entries);
+        free(hg_proc->intern->slots);
+        free(hg_proc->intern);
+    }
 
     /* Free proc */
     free(hg_proc);
@@ -159,8 +250,8 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
 
     HG_CHECK_SUBSYS_ERROR(
         proc, proc == HG_PROC_NULL, error, ret, HG_INVALID_ARG, "NULL HG proc");
-    HG_CHECK_SUBSYS_ERROR(
-        proc, !buf && op != HG_FREE, error, ret, HG_INVALID_ARG, "NULL buffer");
+    HG_CHECK_SUBSYS_ERROR(proc, !buf && op != HG_FREE && op != HG_SIZE, error,
+        ret, HG_INVALID_ARG, "NULL buffer");
 
     hg_proc->op = op;
 #ifdef HG_HAS_XDR
@@ -177,6 +268,9 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
             xdrmem_create(&hg_proc->proc_buf.xdr, (char *) buf,
                 (hg_uint32_t) buf_size, XDR_FREE);
             break;
+        case HG_SIZE:
+            HG_GOTO_SUBSYS_ERROR(proc, error, ret, HG_OPNOTSUPPORTED,
+                "HG_SIZE is not supported with XDR");
         default:
             HG_GOTO_SUBSYS_ERROR(
                 proc, error, ret, HG_INVALID_PARAM, "Unknown proc operation");
@@ -185,16 +279,19 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
 
     /* Reset flags */
     hg_proc->flags = 0;
+    hg_proc->handle = HG_HANDLE_NULL;
 
-    /* Reset proc buf */
+    /* Reset proc buf, sizing does not write anything and is never limited */
     hg_proc->proc_buf.buf = buf;
-    hg_proc->proc_buf.size = buf_size;
+    hg_proc->proc_buf.size = (op == HG_SIZE) ? HG_SIZE_MAX : buf_size;
     hg_proc->proc_buf.buf_ptr = hg_proc->proc_buf.buf;
     hg_proc->proc_buf.size_left = hg_proc->proc_buf.size;
 
     /* Free extra proc buffer if needed */
-    if (hg_proc->extra_buf.buf && hg_proc->extra_buf.is_mine)
+    if (hg_proc->extra_buf.buf && hg_proc->extra_buf.is_mine) {
         hg_mem_aligned_free(hg_proc->extra_buf.buf);
+        hg_proc_mem_release(hg_proc, hg_proc->extra_buf.size);
+    }
     hg_proc->extra_buf.buf = NULL;
     hg_proc->extra_buf.size = 0;
     hg_proc->extra_buf.buf_ptr = hg_proc->extra_buf.buf;
@@ -203,14 +300,28 @@ hg_proc_reset(hg_proc_t proc, void *buf, hg_size_t buf_size, hg_proc_op_t op)
     /* Default to proc_buf */
     hg_proc->current_buf = &hg_proc->proc_buf;
 
+    /* Reset references, array is kept for re-use */
+    hg_proc->ref_count = 0;
+    hg_proc->ref_size = 0;
+    hg_proc->ref_threshold = 0;
+    hg_proc->bulk_eager_budget = HG_SIZE_MAX;
+
+    /* Empty intern table */
+    if (hg_proc->intern && hg_proc->intern->count > 0) {
+        memset(hg_proc->intern->slots, 0,
+            2 * hg_proc->intern->max * sizeof(*hg_proc->intern->slots));
+        hg_proc->intern->count = 0;
+    }
+
 #ifdef HG_HAS_CHECKSUMS
     /* Reset checksum */
     if (hg_proc->checksum != MCHECKSUM_OBJECT_NULL) {
         int rc = mchecksum_reset(hg_proc->checksum);
         HG_CHECK_SUBSYS_ERROR(proc, rc != 0, error, ret, HG_CHECKSUM_ERROR,
             "Could not reset checksum");
-        memset(hg_proc->checksum_hash, 0, hg_proc->checksum_size);
     }
+    if (hg_proc->checksum_hash != NULL)
+        memset(hg_proc->checksum_hash, 0, hg_proc->checksum_size);
 #endif
 
     return HG_SUCCESS;
@@ -226,6 +337,7 @@ hg_proc_set_size(hg_proc_t proc, hg_size_t req_buf_size)
     struct hg_proc *hg_proc = (struct hg_proc *) proc;
     hg_size_t new_buf_size;
     hg_size_t page_size = (hg_size_t) hg_mem_get_page_size();
+    hg_size_t charged_size;
     void *new_buf = NULL;
     ptrdiff_t current_pos;
     hg_bool_t allocated = HG_FALSE;
@@ -243,6 +355,17 @@ hg_proc_set_size(hg_proc_t proc, hg_size_t req_buf_size)
     HG_CHECK_SUBSYS_ERROR(proc, new_buf_size <= hg_proc_get_size(proc), error,
         ret, HG_INVALID_ARG, "Buffer is already of the size requested");
 
+    /* Fail fast once the memory budget is exhausted, only the growth of a
+     * buffer that is already charged is charged */
+    charged_size = (hg_proc->extra_buf.buf && hg_proc->extra_buf.is_mine)
+                       ? hg_proc->extra_buf.size
+                       : 0;
+    HG_CHECK_SUBSYS_ERROR(proc,
+        !hg_proc_mem_acquire(hg_proc, new_buf_size - charged_size), error, ret,
+        HG_NOMEM,
+        "Memory budget exhausted, could not grow buffer to %" PRIu64 " bytes",
+        new_buf_size);
+
     /* If was not using extra buffer init extra buffer */
     if (!hg_proc->extra_buf.buf) {
         /* Allocate buffer */
@@ -250,8 +373,11 @@ hg_proc_set_size(hg_proc_t proc, hg_size_t req_buf_size)
         allocated = HG_TRUE;
     } else
         new_buf = realloc(hg_proc->extra_buf.buf, new_buf_size);
-    HG_CHECK_SUBSYS_ERROR(proc, new_buf == NULL, error, ret, HG_NOMEM,
-        "Could not allocate buffer of size %" PRIu64, new_buf_size);
+    if (new_buf == NULL) {
+        hg_proc_mem_release(hg_proc, new_buf_size - charged_size);
+        HG_GOTO_SUBSYS_ERROR(proc, error, ret, HG_NOMEM,
+            "Could not allocate buffer of size %" PRIu64, new_buf_size);
+    }
 
     if (!hg_proc->extra_buf.buf) {
         /* Copy proc_buf (should be small) */
@@ -291,6 +417,12 @@ hg_proc_save_ptr(hg_proc_t proc, hg_size_t data_size)
     HG_CHECK_SUBSYS_ERROR_NORET(
         proc, hg_proc->op == HG_FREE, error, "Cannot save_ptr on HG_FREE");
 
+    /* Nothing is written on HG_SIZE */
+    if (hg_proc->op == HG_SIZE) {
+        HG_PROC_SIZE_UPDATE(proc, data_size);
+        return NULL;
+    }
+
     /* If not enough space allocate extra space if encoding or
      * just get extra buffer if decoding */
     if (data_size && hg_proc->current_buf->size_left < data_size)
@@ -324,7 +456,9 @@ hg_proc_restore_ptr(hg_proc_t proc, void *data, hg_size_t data_size)
         ret, HG_INVALID_ARG, "Cannot restore_ptr on HG_FREE");
 
 #ifdef HG_HAS_CHECKSUMS
-    hg_proc_checksum_update(proc, data, data_size);
+    /* Nothing was written on HG_SIZE */
+    if (((struct hg_proc *) proc)->op != HG_SIZE)
+        hg_proc_checksum_update(proc, data, data_size);
 #else
     /* Silent warning */
     (void) data;
@@ -337,6 +471,102 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_bytes_ref(hg_proc_t proc, void *data, hg_size_t data_size)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    struct hg_proc_ref *ref;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(proc, proc == HG_PROC_NULL, error, ret,
+        HG_INVALID_ARG, "Proc is not initialized");
+    HG_CHECK_SUBSYS_ERROR(proc, hg_proc->op != HG_ENCODE, error, ret,
+        HG_INVALID_ARG, "References can only be taken on HG_ENCODE");
+
+    /* Referenced data is only sent through the extra buffer, switch to it
+     * now so that the encoded stream does not live in the proc_buf */
+    if (hg_proc->current_buf != &hg_proc->extra_buf) {
+        ret = hg_proc_set_size(proc, hg_proc_get_size(proc) + 1);
+        HG_CHECK_SUBSYS_HG_ERROR(
+            proc, error, ret, "Could not switch to extra buffer");
+    }
+
+    /* Grow reference array */
+    if (hg_proc->ref_count == hg_proc->ref_max) {
+        hg_uint32_t new_max = (hg_proc->ref_max > 0) ? hg_proc->ref_max * 2
+                                                      : HG_PROC_REF_COUNT_INIT;
+        struct hg_proc_ref *new_refs = (struct hg_proc_ref *) realloc(
+            hg_proc->refs, new_max * sizeof(*new_refs));
+        HG_CHECK_SUBSYS_ERROR(proc, new_refs == NULL, error, ret, HG_NOMEM,
+            "Could not allocate array of %" PRIu32 " references", new_max);
+
+        hg_proc->refs = new_refs;
+        hg_proc->ref_max = new_max;
+    }
+
+    ref = &hg_proc->refs[hg_proc->ref_count++];
+    ref->buf = data;
+    ref->size = data_size;
+    ref->offset = (hg_size_t) ((char *) hg_proc->extra_buf.buf_ptr -
+                               (char *) hg_proc->extra_buf.buf);
+    hg_proc->ref_size += data_size;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_get_ref_segments(hg_proc_t proc, void **buf_ptrs,
+    hg_size_t *buf_sizes, hg_uint32_t *count_p)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    hg_size_t offset = 0, size_used;
+    hg_uint32_t count = 0, i;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(proc, proc == HG_PROC_NULL, error, ret,
+        HG_INVALID_ARG, "Proc is not initialized");
+    HG_CHECK_SUBSYS_ERROR(proc, hg_proc->extra_buf.buf == NULL, error, ret,
+        HG_INVALID_ARG, "Extra buf is not set");
+
+    size_used = hg_proc->extra_buf.size - hg_proc->extra_buf.size_left;
+
+    for (i = 0; i < hg_proc->ref_count; i++) {
+        const struct hg_proc_ref *ref = &hg_proc->refs[i];
+
+        /* Encoded data that precedes the reference */
+        if (ref->offset > offset) {
+            buf_ptrs[count] = (char *) hg_proc->extra_buf.buf + offset;
+            buf_sizes[count] = ref->offset - offset;
+            count++;
+            offset = ref->offset;
+        }
+        if (ref->size > 0) {
+            buf_ptrs[count] = ref->buf;
+            buf_sizes[count] = ref->size;
+            count++;
+        }
+    }
+
+    /* Remaining encoded data */
+    if (size_used > offset) {
+        buf_ptrs[count] = (char *) hg_proc->extra_buf.buf + offset;
+        buf_sizes[count] = size_used - offset;
+        count++;
+    }
+
+    *count_p = count;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_proc_set_extra_buf_is_mine(hg_proc_t proc, hg_bool_t theirs)
@@ -349,6 +579,9 @@ hg_proc_set_extra_buf_is_mine(hg_proc_t proc, hg_bool_t theirs)
     HG_CHECK_SUBSYS_ERROR(proc, hg_proc->extra_buf.buf == NULL, error, ret,
         HG_INVALID_ARG, "Extra buf is not set");
 
+    /* Buffer is no longer charged once it is handed over */
+    if (theirs && hg_proc->extra_buf.is_mine)
+        hg_proc_mem_release(hg_proc, hg_proc->extra_buf.size);
     hg_proc->extra_buf.is_mine = (hg_bool_t) (!theirs);
 
     return HG_SUCCESS;
@@ -357,6 +590,187 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_proc_mem_acquire(struct hg_proc *hg_proc, hg_size_t size)
+{
+    return hg_mem_budget_acquire(
+        hg_core_class_get_mem_budget(hg_proc->hg_class->core_class),
+        (size_t) size);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_proc_mem_release(struct hg_proc *hg_proc, hg_size_t size)
+{
+    hg_mem_budget_release(
+        hg_core_class_get_mem_budget(hg_proc->hg_class->core_class),
+        (size_t) size);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_proc_intern_hash(const void *data, hg_size_t data_size)
+{
+    /* djb2, same as hg_hash_string() */
+    const unsigned char *p = (const unsigned char *) data;
+    unsigned int result = 5381;
+    hg_size_t i;
+
+    for (i = 0; i < data_size; i++)
+        result = (result << 5) + result + p[i];
+
+    return result;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_proc_intern_insert(struct hg_proc_intern *intern, hg_uint32_t index)
+{
+    hg_uint32_t mask = 2 * intern->max - 1,
+                slot = intern->entries[index].hash & mask;
+
+    while (intern->slots[slot] != 0)
+        slot = (slot + 1) & mask;
+    intern->slots[slot] = index + 1;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_intern_add(hg_proc_t proc, const void *data, hg_size_t data_size)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    struct hg_proc_intern *intern;
+    struct hg_proc_intern_entry *entry;
+    hg_return_t ret;
+
+    HG_CHECK_SUBSYS_ERROR(proc, proc == HG_PROC_NULL, error, ret,
+        HG_INVALID_ARG, "Proc is not initialized");
+
+    if (hg_proc->intern == NULL) {
+        hg_proc->intern =
+            (struct hg_proc_intern *) calloc(1, sizeof(*hg_proc->intern));
+        HG_CHECK_SUBSYS_ERROR(proc, hg_proc->intern == NULL, error, ret,
+            HG_NOMEM, "Could not allocate intern table");
+    }
+    intern = hg_proc->intern;
+
+    /* Both sides stop adding entries at the same point */
+    if (intern->count == HG_PROC_INTERN_MAX)
+        return HG_SUCCESS;
+
+    /* Grow table and rebuild slots */
+    if (intern->count == intern->max) {
+        hg_uint32_t new_max =
+            (intern->max > 0) ? intern->max * 2 : HG_PROC_INTERN_COUNT_INIT;
+        struct hg_proc_intern_entry *new_entries =
+            (struct hg_proc_intern_entry *) realloc(
+                intern->entries, new_max * sizeof(*new_entries));
+        hg_uint32_t *new_slots;
+        hg_uint32_t i;
+
+        HG_CHECK_SUBSYS_ERROR(proc, new_entries == NULL, error, ret, HG_NOMEM,
+            "Could not allocate array of %" PRIu32 " entries", new_max);
+        intern->entries = new_entries;
+
+        new_slots = (hg_uint32_t *) calloc(2 * new_max, sizeof(*new_slots));
+        HG_CHECK_SUBSYS_ERROR(proc, new_slots == NULL, error, ret, HG_NOMEM,
+            "Could not allocate array of %" PRIu32 " slots", 2 * new_max);
+        free(intern->slots);
+        intern->slots = new_slots;
+        intern->max = new_max;
+
+        if (hg_proc->op != HG_DECODE)
+            for (i = 0; i < intern->count; i++)
+                hg_proc_intern_insert(intern, i);
+    }
+
+    entry = &intern->entries[intern->count];
+    entry->data = data;
+    entry->size = data_size;
+
+    /* Entries are only looked up by index when decoding */
+    if (hg_proc->op != HG_DECODE) {
+        entry->hash = hg_proc_intern_hash(data, data_size);
+        hg_proc_intern_insert(intern, intern->count);
+    }
+    intern->count++;
+
+    return HG_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+hg_proc_intern_find(hg_proc_t proc, const void *data, hg_size_t data_size,
+    hg_uint32_t *index_p)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    struct hg_proc_intern *intern = hg_proc->intern;
+    hg_uint32_t mask, slot;
+    unsigned int hash;
+
+    if (intern == NULL || intern->count == 0)
+        return HG_FALSE;
+
+    hash = hg_proc_intern_hash(data, data_size);
+    mask = 2 * intern->max - 1;
+    for (slot = hash & mask; intern->slots[slot] != 0;
+         slot = (slot + 1) & mask) {
+        const struct hg_proc_intern_entry *entry =
+            &intern->entries[intern->slots[slot] - 1];
+
+        if (entry->hash == hash && entry->size == data_size &&
+            memcmp(entry->data, data, (size_t) data_size) == 0) {
+            *index_p = intern->slots[slot] - 1;
+            return HG_TRUE;
+        }
+    }
+
+    return HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+const void *
+hg_proc_intern_get(hg_proc_t proc, hg_uint32_t index, hg_size_t *data_size_p)
+{
+    struct hg_proc_intern *intern = ((struct hg_proc *) proc)->intern;
+
+    if (intern == NULL || index >= intern->count)
+        return NULL;
+
+    *data_size_p = intern->entries[index].size;
+
+    return intern->entries[index].data;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_CHECKSUMS
+static void
+hg_proc_checksum_buf(struct hg_proc *hg_proc)
+{
+    const char *buf = (const char *) hg_proc->current_buf->buf;
+    hg_size_t size_used = hg_proc_get_size_used((hg_proc_t) hg_proc),
+              offset = 0;
+    hg_uint32_t crc = 0, i;
+
+    /* References are only taken on encode, the target receives referenced
+     * data inline and hashes the same stream */
+    for (i = 0; i < hg_proc->ref_count; i++) {
+        const struct hg_proc_ref *ref = &hg_proc->refs[i];
+
+        crc = hg_crc32c(crc, buf + offset, (size_t) (ref->offset - offset));
+        crc = hg_crc32c(crc, ref->buf, (size_t) ref->size);
+        offset = ref->offset;
+    }
+    crc = hg_crc32c(crc, buf + offset, (size_t) (size_used - offset));
+
+    memcpy(hg_proc->checksum_hash, &crc, sizeof(crc));
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_proc_flush(hg_proc_t proc)
@@ -371,6 +785,12 @@ hg_proc_flush(hg_proc_t proc)
         HG_INVALID_ARG, "Proc is not initialized");
 
 #ifdef HG_HAS_CHECKSUMS
+    if (hg_proc->checksum_buf) {
+        if (hg_proc->op == HG_ENCODE || hg_proc->op == HG_DECODE)
+            hg_proc_checksum_buf(hg_proc);
+        return HG_SUCCESS;
+    }
+
     if (hg_proc->checksum == MCHECKSUM_OBJECT_NULL)
         return HG_SUCCESS;
 
@@ -477,3 +897,186 @@ error:
     return ret;
 }
 #endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_array(hg_proc_t proc, void *data, hg_size_t count, hg_size_t value_size)
+{
+    hg_size_t size = count * value_size;
+#ifdef HG_HAS_XDR
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    void *buf_ptr;
+    XDR *xdrs;
+#endif
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Count may come from an untrusted stream */
+    HG_CHECK_SUBSYS_ERROR(proc, count > ((hg_size_t) -1) / value_size, done,
+        ret, HG_OVERFLOW, "Array of %" PRIu64 " values is too large", count);
+
+#ifdef HG_HAS_XDR
+    if (hg_proc->op == HG_FREE || size == 0)
+        goto done;
+
+    HG_PROC_CHECK_SIZE(proc, size, done, ret);
+
+    buf_ptr = hg_proc->current_buf->buf_ptr;
+#    ifdef HG_PROC_ARRAY_BSWAP
+    if (value_size == sizeof(hg_uint32_t)) {
+        if (hg_proc->op == HG_ENCODE)
+            hg_bswap_32_array(buf_ptr, data, (size_t) count);
+        else
+            hg_bswap_32_array(data, buf_ptr, (size_t) count);
+    } else {
+        if (hg_proc->op == HG_ENCODE)
+            hg_bswap_64_array(buf_ptr, data, (size_t) count);
+        else
+            hg_bswap_64_array(data, buf_ptr, (size_t) count);
+    }
+#    else
+    if (hg_proc->op == HG_ENCODE)
+        HG_PROC_TYPE_ENCODE(proc, data, size);
+    else
+        HG_PROC_TYPE_DECODE(proc, data, size);
+#    endif
+
+    /* Keep XDR stream position in sync */
+    xdrs = hg_proc_get_xdr_ptr(proc);
+    HG_CHECK_SUBSYS_ERROR(proc,
+        xdr_setpos(xdrs, xdr_getpos(xdrs) + (u_int) size) == 0, done, ret,
+        HG_OVERFLOW, "Could not set XDR position");
+
+    HG_PROC_UPDATE(proc, size);
+    HG_PROC_CHECKSUM_UPDATE(proc, data, size);
+#else
+    ret = hg_proc_bytes(proc, data, size);
+#endif
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_varint(hg_proc_t proc, void *data, hg_size_t value_size)
+{
+    struct hg_proc *hg_proc = (struct hg_proc *) proc;
+    /* 7 bits per encoded byte */
+    hg_size_t max_len = (value_size * 8 + 6) / 7, len;
+    hg_uint8_t buf[(sizeof(hg_uint64_t) * 8 + 6) / 7];
+    hg_uint64_t value;
+    hg_return_t ret = HG_SUCCESS;
+
+#ifdef HG_HAS_XDR
+    XDR *xdrs = hg_proc_get_xdr_ptr(proc);
+#endif
+
+    switch (hg_proc->op) {
+        case HG_ENCODE:
+        case HG_SIZE:
+            if (value_size == sizeof(hg_uint32_t))
+                value = *(const hg_uint32_t *) data;
+            else
+                value = *(const hg_uint64_t *) data;
+            len = 0;
+            do {
+                buf[len] = (hg_uint8_t) (value & 0x7f);
+                value >>= 7;
+                if (value)
+                    buf[len] |= 0x80;
+                len++;
+            } while (value);
+
+            if (hg_proc->op == HG_SIZE) {
+                HG_PROC_SIZE_UPDATE(proc, len);
+                break;
+            }
+            HG_PROC_CHECK_SIZE(proc, len, done, ret);
+            memcpy(hg_proc->current_buf->buf_ptr, buf, len);
+#ifdef HG_HAS_XDR
+            HG_CHECK_SUBSYS_ERROR(proc,
+                xdr_setpos(xdrs, xdr_getpos(xdrs) + (u_int) len) == 0, done,
+                ret, HG_OVERFLOW, "Could not set XDR position");
+#endif
+            HG_PROC_UPDATE(proc, len);
+            HG_PROC_CHECKSUM_UPDATE(proc, data, value_size);
+            break;
+        case HG_DECODE: {
+            const hg_uint8_t *ptr =
+                (const hg_uint8_t *) hg_proc->current_buf->buf_ptr;
+            hg_size_t size_left = hg_proc->current_buf->size_left;
+
+            /* Fast path for single byte values */
+            if (likely(size_left > 0 && ptr[0] < 0x80)) {
+                value = ptr[0];
+                len = 1;
+            } else {
+                hg_size_t scan_len =
+                    (size_left < max_len) ? size_left : max_len;
+                unsigned int shift = 0;
+
+                value = 0;
+                for (len = 0; len < scan_len; len++, shift += 7) {
+                    value |= (hg_uint64_t) (ptr[len] & 0x7f) << shift;
+                    if (!(ptr[len] & 0x80))
+                        break;
+                }
+                HG_CHECK_SUBSYS_ERROR(proc, len == scan_len, done, ret,
+                    (scan_len < max_len) ? HG_OVERFLOW : HG_PROTOCOL_ERROR,
+                    "Unterminated varint");
+                /* Last byte may only carry the remaining bits */
+                HG_CHECK_SUBSYS_ERROR(proc,
+                    len == max_len - 1 &&
+                        (ptr[len] >> (value_size * 8 - shift)) != 0,
+                    done, ret, HG_PROTOCOL_ERROR, "Varint value overflow");
+                len++;
+            }
+
+            if (value_size == sizeof(hg_uint32_t))
+                *(hg_uint32_t *) data = (hg_uint32_t) value;
+            else
+                *(hg_uint64_t *) data = value;
+#ifdef HG_HAS_XDR
+            HG_CHECK_SUBSYS_ERROR(proc,
+                xdr_setpos(xdrs, xdr_getpos(xdrs) + (u_int) len) == 0, done,
+                ret, HG_OVERFLOW, "Could not set XDR position");
+#endif
+            HG_PROC_UPDATE(proc, len);
+            HG_PROC_CHECKSUM_UPDATE(proc, data, value_size);
+        } break;
+        case HG_FREE:
+        default:
+            break;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_uint32_varint(hg_proc_t proc, void *data)
+{
+    return hg_proc_varint(proc, data, sizeof(hg_uint32_t));
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_uint64_varint(hg_proc_t proc, void *data)
+{
+    return hg_proc_varint(proc, data, sizeof(hg_uint64_t));
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_uint32_array(hg_proc_t proc, void *data, hg_size_t count)
+{
+    return hg_proc_array(proc, data, count, sizeof(hg_uint32_t));
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_uint64_array(hg_proc_t proc, void *data, hg_size_t count)
+{
+    return hg_proc_array(proc, data, count, sizeof(hg_uint64_t));
+}
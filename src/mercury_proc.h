@@ -39,7 +39,13 @@
 /**
  * Hash methods available for proc.
  */
-typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
+typedef enum {
+    HG_CRC16,
+    HG_CRC32,
+    HG_CRC64,
+    HG_NOHASH,
+    HG_CRC32C_BUF /* CRC32C of encoded buffer, computed on hg_proc_flush() */
+} hg_proc_hash_t;
 
 /*****************/
 /* Public Macros */
@@ -50,6 +56,13 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
  */
 #define HG_PROC_SM         (1 << 0)
 #define HG_PROC_BULK_EAGER (1 << 1)
+#define HG_PROC_VARINT     (1 << 2) /* Encode unsigned integers as varints */
+#define HG_PROC_SELF       (1 << 3) /* Encoded for a peer of the same process */
+
+/**
+ * Max number of entries interned in a single payload.
+ */
+#define HG_PROC_INTERN_MAX (1 << 16)
 
 /* Branch predictor hints */
 #ifndef _WIN32
@@ -98,6 +111,10 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
 #define HG_PROC_TYPE_DECODE(proc, data, size)                                  \
     memcpy(data, ((struct hg_proc *) proc)->current_buf->buf_ptr, size)
 
+/* Only account for size (HG_SIZE) */
+#define HG_PROC_SIZE_UPDATE(proc, size)                                        \
+    (((struct hg_proc *) proc)->current_buf->size_left -= size)
+
 /* Update proc pointers */
 #define HG_PROC_UPDATE(proc, size)                                             \
     do {                                                                       \
@@ -106,10 +123,18 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
         ((struct hg_proc *) proc)->current_buf->size_left -= size;             \
     } while (0)
 
+/* Check whether data of that size must be encoded by reference */
+#define HG_PROC_IS_REF(proc, size)                                             \
+    (((struct hg_proc *) proc)->ref_threshold > 0 &&                           \
+        (size) >= ((struct hg_proc *) proc)->ref_threshold)
+
 /* Update checksum */
 #ifdef HG_HAS_CHECKSUMS
 #    define HG_PROC_CHECKSUM_UPDATE(proc, data, size)                          \
-        hg_proc_checksum_update(proc, data, size)
+        do {                                                                   \
+            if (((struct hg_proc *) proc)->checksum)                           \
+                hg_proc_checksum_update(proc, data, size);                     \
+        } while (0)
 #else
 #    define HG_PROC_CHECKSUM_UPDATE(proc, data, size)
 #endif
@@ -131,9 +156,12 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
 #else
 #    define HG_PROC_TYPE(proc, type, data, label, ret)                         \
         do {                                                                   \
-            /* Do nothing in HG_FREE for basic types */                        \
-            if (hg_proc_get_op(proc) == HG_FREE)                               \
+            /* Do nothing in HG_FREE for basic types, only count in HG_SIZE */ \
+            if (unlikely(hg_proc_get_op(proc) > HG_DECODE)) {                  \
+                if (hg_proc_get_op(proc) == HG_SIZE)                           \
+                    HG_PROC_SIZE_UPDATE(proc, sizeof(type));                   \
                 goto label;                                                    \
+            }                                                                  \
                                                                                \
             /* If not enough space allocate extra space if encoding or just */ \
             /* get extra buffer if decoding */                                 \
@@ -169,22 +197,35 @@ typedef enum { HG_CRC16, HG_CRC32, HG_CRC64, HG_NOHASH } hg_proc_hash_t;
 #else
 #    define HG_PROC_BYTES(proc, data, size, label, ret)                        \
         do {                                                                   \
-            /* Do nothing in HG_FREE for basic types */                        \
-            if (hg_proc_get_op(proc) == HG_FREE)                               \
+            /* Do nothing in HG_FREE for basic types, only count in HG_SIZE */ \
+            /* (references are not part of the encoded buffer) */              \
+            if (unlikely(hg_proc_get_op(proc) > HG_DECODE)) {                  \
+                if (hg_proc_get_op(proc) == HG_SIZE &&                         \
+                    !HG_PROC_IS_REF(proc, size))                               \
+                    HG_PROC_SIZE_UPDATE(proc, size);                           \
                 goto label;                                                    \
+            }                                                                  \
                                                                                \
-            /* If not enough space allocate extra space if encoding or just */ \
-            /* get extra buffer if decoding */                                 \
-            HG_PROC_CHECK_SIZE(proc, size, label, ret);                        \
+            /* Large fields may be kept as references to user memory */        \
+            if (hg_proc_get_op(proc) == HG_ENCODE &&                           \
+                unlikely(HG_PROC_IS_REF(proc, size))) {                        \
+                ret = hg_proc_bytes_ref(proc, data, size);                     \
+                if (ret != HG_SUCCESS)                                         \
+                    goto label;                                                \
+            } else {                                                           \
+                /* If not enough space allocate extra space if encoding or */  \
+                /* just get extra buffer if decoding */                        \
+                HG_PROC_CHECK_SIZE(proc, size, label, ret);                    \
                                                                                \
-            /* Encode, decode type */                                          \
-            if (hg_proc_get_op(proc) == HG_ENCODE)                             \
-                HG_PROC_TYPE_ENCODE(proc, data, size);                         \
-            else                                                               \
-                HG_PROC_TYPE_DECODE(proc, data, size);                         \
+                /* Encode, decode type */                                      \
+                if (hg_proc_get_op(proc) == HG_ENCODE)                         \
+                    HG_PROC_TYPE_ENCODE(proc, data, size);                     \
+                else                                                           \
+                    HG_PROC_TYPE_DECODE(proc, data, size);                     \
                                                                                \
-            /* Update proc pointers etc */                                     \
-            HG_PROC_UPDATE(proc, size);                                        \
+                /* Update proc pointers etc */                                 \
+                HG_PROC_UPDATE(proc, size);                                    \
+            }                                                                  \
             HG_PROC_CHECKSUM_UPDATE(proc, data, size);                         \
         } while (0)
 #endif
@@ -203,7 +244,8 @@ extern "C" {
  * \param hg_class [IN]         HG class
  * \param hash [IN]             hash method used for computing checksum
  *                              (if NULL, checksum is not computed)
- *                              hash method: HG_CRC16, HG_CRC64, HG_NOHASH
+ *                              hash method: HG_CRC16, HG_CRC32, HG_CRC64,
+ *                              HG_CRC32C_BUF, HG_NOHASH
  * \param proc_p [OUT]          pointer to abstract processor object
  *
  * \return HG_SUCCESS or corresponding HG error code
@@ -221,7 +263,8 @@ hg_proc_create(hg_class_t *hg_class, hg_proc_hash_t hash, hg_proc_t *proc_p);
  * \param op [IN]               operation type: HG_ENCODE / HG_DECODE / HG_FREE
  * \param hash [IN]             hash method used for computing checksum
  *                              (if NULL, checksum is not computed)
- *                              hash method: HG_CRC16, HG_CRC64, HG_NOHASH
+ *                              hash method: HG_CRC16, HG_CRC32, HG_CRC64,
+ *                              HG_CRC32C_BUF, HG_NOHASH
  * \param proc_p [OUT]          pointer to abstract processor object
  *
  * \return HG_SUCCESS or corresponding HG error code
@@ -248,6 +291,11 @@ hg_proc_free(hg_proc_t proc);
  *                              serialization/deserialization
  * \param buf_size [IN]         buffer size
  * \param op [IN]               operation type: HG_ENCODE / HG_DECODE / HG_FREE
+ *                              / HG_SIZE
+ *
+ * \remark When \op is HG_SIZE, \buf may be NULL and nothing is written, the
+ * encoded size of the types that are processed can then be retrieved with
+ * hg_proc_get_size_used(). HG_SIZE is not supported with XDR.
  *
  * \return HG_SUCCESS or corresponding HG error code
  */
@@ -295,6 +343,28 @@ hg_proc_set_flags(hg_proc_t proc, hg_uint8_t flags);
 static HG_INLINE hg_uint8_t
 hg_proc_get_flags(hg_proc_t proc);
 
+/**
+ * Set the handle that owns the buffer being decoded. Decoded data (e.g.,
+ * eager bulk data) may then point into that buffer and take a reference on
+ * the handle instead of being copied.
+ * Handle is reset after a call to hg_proc_reset().
+ *
+ * \param proc [IN]             abstract processor object
+ * \param handle [IN]           HG handle
+ */
+static HG_INLINE void
+hg_proc_set_handle(hg_proc_t proc, hg_handle_t handle);
+
+/**
+ * Get the handle that owns the buffer being decoded.
+ *
+ * \param proc [IN]             abstract processor object
+ *
+ * \return HG handle or HG_HANDLE_NULL
+ */
+static HG_INLINE hg_handle_t
+hg_proc_get_handle(hg_proc_t proc);
+
 /**
  * Get buffer size available for processing.
  *
@@ -339,7 +409,7 @@ hg_proc_get_size_left(hg_proc_t proc);
 
 /**
  * Get pointer to current buffer. Will reserve data_size for manual
- * encoding.
+ * encoding. On HG_SIZE, data_size is only accounted for and NULL is returned.
  *
  * \param proc [IN]             abstract processor object
  * \param data_size [IN]        data size
@@ -404,9 +474,143 @@ hg_proc_get_extra_size(hg_proc_t proc);
 HG_PUBLIC hg_return_t
 hg_proc_set_extra_buf_is_mine(hg_proc_t proc, hg_bool_t mine);
 
+/**
+ * Set the size from which data processed through hg_proc_bytes() is no
+ * longer copied when encoding but kept as a reference to the user memory.
+ * Referenced data is not part of the proc buffers and can be retrieved
+ * along with the encoded data through hg_proc_get_ref_segments(). Setting
+ * a threshold forces the use of an extra buffer as soon as a first
+ * reference is taken. The threshold is cleared on hg_proc_reset().
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param threshold [IN]        minimum size of referenced data (0 disables)
+ */
+static HG_INLINE void
+hg_proc_set_ref_threshold(hg_proc_t proc, hg_size_t threshold);
+
+/**
+ * Set the maximum amount of bulk data that hg_proc_hg_bulk_t() may still
+ * embed along with bulk descriptors when HG_PROC_BULK_EAGER is set. The
+ * budget is reduced by the amount of data embedded for each bulk handle and
+ * is reset to HG_SIZE_MAX (no limit other than the buffer size left) on
+ * hg_proc_reset().
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param budget [IN]           max size of embedded bulk data
+ */
+static HG_INLINE void
+hg_proc_set_bulk_eager_budget(hg_proc_t proc, hg_size_t budget);
+
+/**
+ * Get the remaining bulk eager budget.
+ *
+ * \param proc [IN]             abstract processor object
+ *
+ * \return Max size of bulk data that may still be embedded
+ */
+static HG_INLINE hg_size_t
+hg_proc_get_bulk_eager_budget(hg_proc_t proc);
+
+/**
+ * Get number of references taken while encoding.
+ *
+ * \param proc [IN]             abstract processor object
+ *
+ * \return Number of references
+ */
+static HG_INLINE hg_uint32_t
+hg_proc_get_ref_count(hg_proc_t proc);
+
+/**
+ * Get total size of the data that was referenced while encoding.
+ *
+ * \param proc [IN]             abstract processor object
+ *
+ * \return Size of referenced data
+ */
+static HG_INLINE hg_size_t
+hg_proc_get_ref_size(hg_proc_t proc);
+
+/**
+ * Encode data of size data_size by reference. The data is not copied and
+ * must remain valid for as long as the encoded stream is being used.
+ * This routine is called by hg_proc_bytes() and should not need to be
+ * called directly.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN]             pointer to data
+ * \param data_size [IN]        data size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_bytes_ref(hg_proc_t proc, void *data, hg_size_t data_size);
+
+/**
+ * Get the list of segments that, once concatenated, form the encoded stream,
+ * interleaving the extra buffer with the referenced data. Arrays must be
+ * able to hold up to (2 * hg_proc_get_ref_count() + 1) entries. Empty
+ * segments are omitted.
+ *
+ * \param proc [IN]             abstract processor object
+ * \param buf_ptrs [OUT]        array of segment pointers
+ * \param buf_sizes [OUT]       array of segment sizes
+ * \param count_p [OUT]         pointer to returned number of segments
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_get_ref_segments(hg_proc_t proc, void **buf_ptrs,
+    hg_size_t *buf_sizes, hg_uint32_t *count_p);
+
+/**
+ * Add data to the table of data interned in the payload being processed so
+ * that repeated occurrences can be encoded as a reference to their index
+ * (see hg_proc_intern_find() and hg_proc_intern_get()). Entries are added in
+ * the order in which they are processed, the table is emptied by
+ * hg_proc_reset() and data must remain valid until then. Once the table
+ * contains HG_PROC_INTERN_MAX entries, data is no longer added.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN]             pointer to data
+ * \param data_size [IN]        data size
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_intern_add(hg_proc_t proc, const void *data, hg_size_t data_size);
+
+/**
+ * Look up data in the intern table (only when encoding or computing size).
+ *
+ * \param proc [IN]             abstract processor object
+ * \param data [IN]             pointer to data
+ * \param data_size [IN]        data size
+ * \param index_p [OUT]         index of interned data
+ *
+ * \return HG_TRUE if data was found, HG_FALSE otherwise
+ */
+HG_PUBLIC hg_bool_t
+hg_proc_intern_find(hg_proc_t proc, const void *data, hg_size_t data_size,
+    hg_uint32_t *index_p);
+
+/**
+ * Get interned data from its index.
+ *
+ * \param proc [IN]             abstract processor object
+ * \param index [IN]            index of interned data
+ * \param data_size_p [OUT]     pointer to data size
+ *
+ * \return Pointer to data or NULL if index is not valid
+ */
+HG_PUBLIC const void *
+hg_proc_intern_get(hg_proc_t proc, hg_uint32_t index, hg_size_t *data_size_p);
+
 /**
  * Flush the proc after data has been encoded or decoded and finalize
  * internal checksum if checksum of data processed was initially requested.
+ * With HG_CRC32C_BUF, the checksum is computed at that point in one pass over
+ * the encoded data, including data encoded by reference.
  *
  * \param proc [IN]             abstract processor object
  *
@@ -548,6 +752,62 @@ hg_proc_hg_uint64_t(hg_proc_t proc, void *data);
 static HG_INLINE hg_return_t
 hg_proc_bytes(hg_proc_t proc, void *data, hg_size_t data_size);
 
+/**
+ * Processing routine for arrays of 32-bit values. The array is processed at
+ * once and values are only converted when the encoding byte order differs
+ * from the host byte order (i.e., XDR on little-endian hosts), using SIMD
+ * byteswap kernels when available. The encoded stream is the same as when
+ * processing each value through hg_proc_hg_uint32_t().
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of values in array
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_uint32_array(hg_proc_t proc, void *data, hg_size_t count);
+
+/**
+ * Processing routine for arrays of 64-bit values. Same as
+ * hg_proc_uint32_array() for hg_proc_hg_uint64_t().
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to array
+ * \param count [IN]            number of values in array
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_uint64_array(hg_proc_t proc, void *data, hg_size_t count);
+
+/**
+ * Processing routine for 32-bit values encoded as LEB128 varints (7 bits per
+ * byte, least significant group first, high bit set on all bytes but the
+ * last), i.e., values lower than 128 take a single byte. This routine is
+ * used by hg_proc_hg_uint32_t() when the HG_PROC_VARINT flag is set on the
+ * proc. Arrays are always encoded with fixed-size values.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to data
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_uint32_varint(hg_proc_t proc, void *data);
+
+/**
+ * Processing routine for 64-bit values encoded as LEB128 varints. Same as
+ * hg_proc_uint32_varint() for hg_proc_hg_uint64_t().
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to data
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_uint64_varint(hg_proc_t proc, void *data);
+
 /**
  * For convenience map stdint types to hg types
  */
@@ -566,6 +826,13 @@ hg_proc_bytes(hg_proc_t proc, void *data, hg_size_t data_size);
 #define hg_proc_hg_size_t hg_proc_hg_uint64_t
 #define hg_proc_hg_id_t   hg_proc_hg_uint32_t
 
+/* Map arrays of other types of the same size (IEEE 754 floats only need to
+ * be byteswapped as well) */
+#define hg_proc_int32_array  hg_proc_uint32_array
+#define hg_proc_int64_array  hg_proc_uint64_array
+#define hg_proc_float_array  hg_proc_uint32_array
+#define hg_proc_double_array hg_proc_uint64_array
+
 /* Map hg_proc_raw/hg_proc_memcpy to hg_proc_bytes */
 #define hg_proc_memcpy hg_proc_raw
 #define hg_proc_raw    hg_proc_bytes
@@ -592,17 +859,33 @@ struct hg_proc_buf {
 #endif
 };
 
+/* HG proc reference */
+struct hg_proc_ref {
+    void *buf;        /* Pointer to user data */
+    hg_size_t size;   /* Size of user data */
+    hg_size_t offset; /* Position in extra buffer */
+};
+
 /* HG proc */
 struct hg_proc {
     struct hg_proc_buf proc_buf;
     struct hg_proc_buf extra_buf;
     hg_class_t *hg_class; /* HG class */
     struct hg_proc_buf *current_buf;
+    struct hg_proc_ref *refs; /* Array of references */
+    hg_uint32_t ref_count;    /* Number of references */
+    hg_uint32_t ref_max;      /* Size of reference array */
+    hg_size_t ref_size;       /* Total size of referenced data */
+    hg_size_t ref_threshold;  /* Min size of referenced data */
+    hg_size_t bulk_eager_budget;   /* Max bulk data embedded inline */
+    struct hg_proc_intern *intern; /* Interned data */
 #ifdef HG_HAS_CHECKSUMS
     struct mchecksum_object *checksum; /* Checksum */
     void *checksum_hash;               /* Base checksum buf */
     size_t checksum_size;              /* Checksum size */
+    hg_bool_t checksum_buf;            /* Checksum buffer on flush */
 #endif
+    hg_handle_t handle; /* Handle kept by references to decoded data */
     hg_proc_op_t op;
     hg_uint8_t flags;
 };
@@ -635,6 +918,20 @@ hg_proc_get_flags(hg_proc_t proc)
     return ((struct hg_proc *) proc)->flags;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_proc_set_handle(hg_proc_t proc, hg_handle_t handle)
+{
+    ((struct hg_proc *) proc)->handle = handle;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_handle_t
+hg_proc_get_handle(hg_proc_t proc)
+{
+    return ((struct hg_proc *) proc)->handle;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_size_t
 hg_proc_get_size(hg_proc_t proc)
@@ -681,6 +978,41 @@ hg_proc_get_extra_size(hg_proc_t proc)
     return ((struct hg_proc *) proc)->extra_buf.size;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_proc_set_ref_threshold(hg_proc_t proc, hg_size_t threshold)
+{
+    ((struct hg_proc *) proc)->ref_threshold = threshold;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_proc_set_bulk_eager_budget(hg_proc_t proc, hg_size_t budget)
+{
+    ((struct hg_proc *) proc)->bulk_eager_budget = budget;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_size_t
+hg_proc_get_bulk_eager_budget(hg_proc_t proc)
+{
+    return ((struct hg_proc *) proc)->bulk_eager_budget;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_uint32_t
+hg_proc_get_ref_count(hg_proc_t proc)
+{
+    return ((struct hg_proc *) proc)->ref_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_size_t
+hg_proc_get_ref_size(hg_proc_t proc)
+{
+    return ((struct hg_proc *) proc)->ref_size;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
 hg_proc_hg_int8_t(hg_proc_t proc, void *data)
@@ -747,6 +1079,10 @@ hg_proc_hg_uint32_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret = HG_SUCCESS;
 
+#ifndef HG_HAS_XDR
+    if (unlikely(((struct hg_proc *) proc)->flags & HG_PROC_VARINT))
+        return hg_proc_uint32_varint(proc, data);
+#endif
     HG_PROC_TYPE(proc, hg_uint32_t, data, done, ret);
 
 done:
@@ -771,6 +1107,10 @@ hg_proc_hg_uint64_t(hg_proc_t proc, void *data)
 {
     hg_return_t ret = HG_SUCCESS;
 
+#ifndef HG_HAS_XDR
+    if (unlikely(((struct hg_proc *) proc)->flags & HG_PROC_VARINT))
+        return hg_proc_uint64_varint(proc, data);
+#endif
     HG_PROC_TYPE(proc, hg_uint64_t, data, done, ret);
 
 done:
@@ -0,0 +1,387 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MERCURY_PROC_HPP
+#define MERCURY_PROC_HPP
+
+#include "mercury.h"
+#include "mercury_proc_bulk.h"
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Compile-time generation of proc routines for C++ types and typed RPC
+ * registration, complements mercury_coro.hpp. The proc of a type is resolved
+ * at compile time from its structure:
+ *   - arithmetic and enum types use the scalar procs (XDR and varint aware),
+ *   - hg_bulk_t uses hg_proc_hg_bulk_t(),
+ *   - std::string, std::vector and std::array are encoded with a count
+ *     followed by their elements (arrays of trivially copyable elements in a
+ *     single copy, 32/64-bit scalars through hg_proc_uint32/64_array()),
+ *   - other trivially copyable class types are copied at once as raw memory
+ *     (origin and target must then share the same ABI),
+ *   - remaining aggregates (including those that contain bulk handles) are
+ *     decomposed field by field with structured bindings (up to
+ *     HG_PROC_HPP_FIELD_MAX fields).
+ * Types can provide their own encoding by defining a member function
+ * hg_return_t hg_proc(hg_proc_t proc). Decoded objects own their memory and
+ * must be destroyed normally, the HG_FREE operation only frees bulk handles.
+ */
+
+/* Max number of fields of aggregates decomposed with structured bindings */
+#define HG_PROC_HPP_FIELD_MAX (12)
+
+namespace hg {
+
+/**
+ * Compute the ID of an RPC name at compile time, matches the one computed
+ * by HG_Register_name() (see hg_hash_string()).
+ *
+ * \param name [IN]             RPC name
+ *
+ * \return ID that corresponds to name
+ */
+constexpr hg_id_t
+rpc_id(const char *name) noexcept
+{
+    unsigned int result = 5381;
+
+    while (*name != '\0')
+        result = (result << 5) + result + static_cast<unsigned char>(*name++);
+
+    return result;
+}
+
+namespace detail {
+
+/* Convertible to any field type, used to count fields of aggregates */
+struct any_field {
+    template<typename T>
+    operator T() const;
+};
+
+template<typename T, typename... fields>
+constexpr std::size_t
+field_count() noexcept
+{
+    /* Braced initializers prevent brace elision, which would otherwise count
+     * each element of C array fields */
+    if constexpr (requires { T{{fields{}}..., {any_field{}}}; })
+        return field_count<T, fields..., any_field>();
+    else
+        return sizeof...(fields);
+}
+
+/* Call f with references to the fields of aggregate value */
+template<typename T, typename F>
+constexpr decltype(auto)
+visit_fields(T &value, F &&f)
+{
+    constexpr std::size_t count = field_count<T>();
+
+    static_assert(count <= HG_PROC_HPP_FIELD_MAX,
+        "Too many fields, define a hg_proc() member function");
+
+    if constexpr (count == 0)
+        return f();
+    else if constexpr (count == 1) {
+        auto &[f1] = value;
+        return f(f1);
+    } else if constexpr (count == 2) {
+        auto &[f1, f2] = value;
+        return f(f1, f2);
+    } else if constexpr (count == 3) {
+        auto &[f1, f2, f3] = value;
+        return f(f1, f2, f3);
+    } else if constexpr (count == 4) {
+        auto &[f1, f2, f3, f4] = value;
+        return f(f1, f2, f3, f4);
+    } else if constexpr (count == 5) {
+        auto &[f1, f2, f3, f4, f5] = value;
+        return f(f1, f2, f3, f4, f5);
+    } else if constexpr (count == 6) {
+        auto &[f1, f2, f3, f4, f5, f6] = value;
+        return f(f1, f2, f3, f4, f5, f6);
+    } else if constexpr (count == 7) {
+        auto &[f1, f2, f3, f4, f5, f6, f7] = value;
+        return f(f1, f2, f3, f4, f5, f6, f7);
+    } else if constexpr (count == 8) {
+        auto &[f1, f2, f3, f4, f5, f6, f7, f8] = value;
+        return f(f1, f2, f3, f4, f5, f6, f7, f8);
+    } else if constexpr (count == 9) {
+        auto &[f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+        return f(f1, f2, f3, f4, f5, f6, f7, f8, f9);
+    } else if constexpr (count == 10) {
+        auto &[f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+        return f(f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+    } else if constexpr (count == 11) {
+        auto &[f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+        return f(f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+    } else {
+        auto &[f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = value;
+        return f(f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+    }
+}
+
+template<typename T>
+struct is_vector : std::false_type {};
+template<typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template<typename T>
+struct is_array : std::false_type {};
+template<typename T, std::size_t N>
+struct is_array<std::array<T, N>> : std::true_type {};
+
+template<typename T>
+concept has_member_proc = requires(T &value, hg_proc_t proc) {
+    {
+        value.hg_proc(proc)
+    } -> std::same_as<hg_return_t>;
+};
+
+template<typename T>
+concept scalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+/* Bulk handles must be processed (and freed) one by one, types that contain
+ * them cannot be copied as raw memory */
+template<typename T>
+constexpr bool
+contains_bulk() noexcept
+{
+    if constexpr (std::is_same_v<T, hg_bulk_t>)
+        return true;
+    else if constexpr (is_vector<T>::value || is_array<T>::value)
+        return contains_bulk<typename T::value_type>();
+    else if constexpr (std::is_class_v<T> && std::is_aggregate_v<T> &&
+                       !has_member_proc<T>)
+        return decltype(visit_fields(std::declval<T &>(), [](auto &...fields) {
+            return std::bool_constant<(
+                contains_bulk<std::remove_cvref_t<decltype(fields)>>() ||
+                ... || false)>{};
+        }))::value;
+    else
+        return false;
+}
+
+/* Class types copied at once as raw memory */
+template<typename T>
+concept raw_copyable = std::is_class_v<T> && std::is_trivially_copyable_v<T> &&
+                       !has_member_proc<T> && !is_array<T>::value &&
+                       !contains_bulk<T>();
+
+/* Process scalar through the proc routine of the same size */
+template<scalar T>
+inline hg_return_t
+proc_scalar(hg_proc_t proc, T &value)
+{
+    if constexpr (std::is_enum_v<T>) {
+        auto underlying = static_cast<std::underlying_type_t<T>>(value);
+        hg_return_t ret = proc_scalar(proc, underlying);
+
+        value = static_cast<T>(underlying);
+        return ret;
+    } else if constexpr (std::is_same_v<T, bool>) {
+        hg_uint8_t byte = value ? 1 : 0;
+        hg_return_t ret = hg_proc_hg_uint8_t(proc, &byte);
+
+        value = (byte != 0);
+        return ret;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        /* IEEE 754 floats are processed as unsigned integers of same size */
+        using bits_t =
+            std::conditional_t<sizeof(T) == 4, hg_uint32_t, hg_uint64_t>;
+        static_assert(sizeof(T) == sizeof(bits_t), "Unsupported float type");
+        bits_t bits = std::bit_cast<bits_t>(value);
+        hg_return_t ret = proc_scalar(proc, bits);
+
+        value = std::bit_cast<T>(bits);
+        return ret;
+    } else {
+        /* Go through fixed-width type, e.g., char or long long may not be
+         * the same type as hg_int8_t or hg_int64_t */
+        using fixed_t = std::conditional_t<std::is_signed_v<T>,
+            std::conditional_t<sizeof(T) == 1, hg_int8_t,
+                std::conditional_t<sizeof(T) == 2, hg_int16_t,
+                    std::conditional_t<sizeof(T) == 4, hg_int32_t,
+                        hg_int64_t>>>,
+            std::conditional_t<sizeof(T) == 1, hg_uint8_t,
+                std::conditional_t<sizeof(T) == 2, hg_uint16_t,
+                    std::conditional_t<sizeof(T) == 4, hg_uint32_t,
+                        hg_uint64_t>>>>;
+        static_assert(sizeof(T) == sizeof(fixed_t), "Unsupported scalar type");
+        fixed_t fixed = static_cast<fixed_t>(value);
+        hg_return_t ret;
+
+        if constexpr (std::is_same_v<fixed_t, hg_int8_t>)
+            ret = hg_proc_hg_int8_t(proc, &fixed);
+        else if constexpr (std::is_same_v<fixed_t, hg_uint8_t>)
+            ret = hg_proc_hg_uint8_t(proc, &fixed);
+        else if constexpr (std::is_same_v<fixed_t, hg_int16_t>)
+            ret = hg_proc_hg_int16_t(proc, &fixed);
+        else if constexpr (std::is_same_v<fixed_t, hg_uint16_t>)
+            ret = hg_proc_hg_uint16_t(proc, &fixed);
+        else if constexpr (std::is_same_v<fixed_t, hg_int32_t>)
+            ret = hg_proc_hg_int32_t(proc, &fixed);
+        else if constexpr (std::is_same_v<fixed_t, hg_uint32_t>)
+            ret = hg_proc_hg_uint32_t(proc, &fixed);
+        else if constexpr (std::is_same_v<fixed_t, hg_int64_t>)
+            ret = hg_proc_hg_int64_t(proc, &fixed);
+        else
+            ret = hg_proc_hg_uint64_t(proc, &fixed);
+
+        value = static_cast<T>(fixed);
+        return ret;
+    }
+}
+
+} // namespace detail
+
+/**
+ * Process value of type T (encode, decode, compute size or free depending
+ * on the operation of proc).
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param value [IN/OUT]        value to process
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+template<typename T>
+inline hg_return_t
+proc(hg_proc_t proc, T &value);
+
+namespace detail {
+
+/* Process elements of contiguous range */
+template<typename T>
+inline hg_return_t
+proc_elements(hg_proc_t p, T *data, hg_uint64_t count)
+{
+    constexpr bool plain_scalar =
+        scalar<T> && !std::is_same_v<T, bool> && !std::is_enum_v<T>;
+    hg_return_t ret = HG_SUCCESS;
+
+    if constexpr (plain_scalar && sizeof(T) == 4)
+        ret = hg_proc_uint32_array(p, data, count);
+    else if constexpr (plain_scalar && sizeof(T) == 8)
+        ret = hg_proc_uint64_array(p, data, count);
+    else if constexpr ((plain_scalar && sizeof(T) == 1) || raw_copyable<T>)
+        ret = hg_proc_bytes(p, data, count * sizeof(T));
+    else
+        for (hg_uint64_t i = 0; i < count && ret == HG_SUCCESS; i++)
+            ret = hg::proc(p, data[i]);
+
+    return ret;
+}
+
+/* Process count then elements of string or vector */
+template<typename T>
+inline hg_return_t
+proc_sequence(hg_proc_t p, T &value)
+{
+    hg_uint64_t count = value.size();
+    hg_return_t ret;
+
+    static_assert(!std::is_same_v<T, std::vector<bool>>,
+        "std::vector<bool> is not supported");
+
+    ret = hg_proc_hg_uint64_t(p, &count);
+    if (ret != HG_SUCCESS)
+        return ret;
+
+    if (hg_proc_get_op(p) == HG_DECODE) {
+        /* Do not trust count beyond what is left to decode */
+        if (count > hg_proc_get_size_left(p))
+            return HG_OVERFLOW;
+        value.resize(count);
+    }
+
+    return proc_elements(p, value.data(), count);
+}
+
+} // namespace detail
+
+/*---------------------------------------------------------------------------*/
+template<typename T>
+inline hg_return_t
+proc(hg_proc_t p, T &value)
+{
+    /* Decoded objects own their memory, only bulk handles must be freed */
+    if constexpr (!detail::has_member_proc<T> && !detail::contains_bulk<T>())
+        if (hg_proc_get_op(p) == HG_FREE)
+            return HG_SUCCESS;
+
+    if constexpr (detail::has_member_proc<T>)
+        return value.hg_proc(p);
+    else if constexpr (detail::scalar<T>)
+        return detail::proc_scalar(p, value);
+    else if constexpr (std::is_same_v<T, hg_bulk_t>)
+        return hg_proc_hg_bulk_t(p, &value);
+    else if constexpr (std::is_same_v<T, std::string> ||
+                       detail::is_vector<T>::value)
+        return detail::proc_sequence(p, value);
+    else if constexpr (detail::is_array<T>::value)
+        return detail::proc_elements(p, value.data(), value.size());
+    else if constexpr (detail::raw_copyable<T>)
+        return hg_proc_bytes(p, &value, sizeof(T));
+    else if constexpr (std::is_class_v<T> && std::is_aggregate_v<T>)
+        return detail::visit_fields(value, [p](auto &...fields) {
+            hg_return_t ret = HG_SUCCESS;
+
+            ((ret = (ret == HG_SUCCESS) ? hg::proc(p, fields) : ret), ...);
+            return ret;
+        });
+    else
+        static_assert(sizeof(T) == 0,
+            "No proc for type, define a hg_proc() member function");
+}
+
+/**
+ * Get proc callback of type T that can be passed to HG_Register() (NULL for
+ * void).
+ *
+ * \return Pointer to proc callback
+ */
+template<typename T>
+constexpr hg_proc_cb_t
+proc_cb() noexcept
+{
+    if constexpr (std::is_void_v<T>)
+        return nullptr;
+    else
+        return [](hg_proc_t p, void *data) -> hg_return_t {
+            return hg::proc(p, *static_cast<T *>(data));
+        };
+}
+
+/**
+ * Register RPC name with procs generated for its input and output types.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param name [IN]             RPC name
+ * \param rpc_cb [IN]           RPC callback
+ *
+ * \return ID of registered RPC (same as rpc_id(name)) or 0 on failure
+ */
+template<typename in_t, typename out_t>
+inline hg_id_t
+register_rpc(hg_class_t *hg_class, const char *name, hg_rpc_cb_t rpc_cb)
+{
+    return HG_Register_name(
+        hg_class, name, proc_cb<in_t>(), proc_cb<out_t>(), rpc_cb);
+}
+
+} // namespace hg
+
+#endif /* MERCURY_PROC_HPP */
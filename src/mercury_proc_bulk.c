@@ -6,8 +6,10 @@
  */
 
 #include "mercury_proc_bulk.h"
+#include "mercury.h"
 #include "mercury_bulk_proc.h"
 #include "mercury_error.h"
+#include "mercury_private.h"
 
 /****************/
 /* Local Macros */
@@ -35,10 +37,12 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
     hg_uint64_t buf_size = 0;
 
     switch (hg_proc_get_op(proc)) {
-        case HG_ENCODE: {
-            hg_uint8_t flags = 0;
+        case HG_ENCODE:
+        case HG_SIZE: {
+            unsigned long flags = 0;
             hg_bool_t try_eager = HG_FALSE; /* Flag will not be set if bulk
                                                handle does not support it */
+            hg_uint64_t eager_size = 0;
 
             HG_LOG_DEBUG("HG_ENCODE");
 
@@ -55,23 +59,38 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
             if (hg_proc_get_flags(proc) & HG_PROC_SM)
                 flags |= HG_BULK_SM;
 #endif
+            /* Handles that are only transferred locally need not be
+             * registered */
+            if (hg_proc_get_flags(proc) & HG_PROC_SELF)
+                flags |= HG_BULK_SELF;
 
-            /* Try to make everything fit in an eager buffer */
+            buf_size = HG_Bulk_get_serialize_size(*bulk_ptr, flags);
+
+            /* Try to make everything fit in an eager buffer, within the
+             * amount of data that may still be embedded */
             if (hg_proc_get_flags(proc) & HG_PROC_BULK_EAGER) {
-                HG_LOG_DEBUG("Proc size left is %" PRIu64 " bytes",
-                    hg_proc_get_size_left(proc));
-                buf_size = HG_Bulk_get_serialize_size(
+                HG_LOG_DEBUG("Proc size left is %" PRIu64
+                             " bytes, eager budget is %" PRIu64 " bytes",
+                    hg_proc_get_size_left(proc),
+                    hg_proc_get_bulk_eager_budget(proc));
+                eager_size = HG_Bulk_get_serialize_size(
                     *bulk_ptr, HG_BULK_EAGER | flags);
 
                 if (hg_proc_get_size_left(proc) >=
-                    (buf_size + sizeof(hg_uint64_t)))
+                        (eager_size + sizeof(hg_uint64_t)) &&
+                    (eager_size - buf_size) <=
+                        hg_proc_get_bulk_eager_budget(proc))
                     try_eager = HG_TRUE;
             }
             if (try_eager) {
                 HG_LOG_DEBUG("HG_BULK_EAGER flag set");
                 flags |= HG_BULK_EAGER;
-            } else /* We must recompute the serialize size without eager flag */
-                buf_size = HG_Bulk_get_serialize_size(*bulk_ptr, flags);
+                if (hg_proc_get_bulk_eager_budget(proc) != HG_SIZE_MAX)
+                    hg_proc_set_bulk_eager_budget(proc,
+                        hg_proc_get_bulk_eager_budget(proc) -
+                            (eager_size - buf_size));
+                buf_size = eager_size;
+            }
 
             HG_LOG_DEBUG(
                 "Serialize size for bulk handle is %" PRIu64, buf_size);
@@ -80,7 +99,11 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
             ret = hg_proc_uint64_t(proc, &buf_size);
             HG_CHECK_HG_ERROR(done, ret, "Could not encode serialize size");
 
-            if (buf_size == hg_bulk_get_serialize_cached_size(*bulk_ptr)) {
+            if (hg_proc_get_op(proc) == HG_SIZE) {
+                /* Size left is unlimited, eager size is an upper bound */
+                hg_proc_save_ptr(proc, buf_size);
+            } else if (buf_size ==
+                       hg_bulk_get_serialize_cached_size(*bulk_ptr)) {
                 HG_LOG_DEBUG("Using cached pointer to serialized handle");
                 void *cached_ptr = hg_bulk_get_serialize_cached_ptr(*bulk_ptr);
                 hg_proc_bytes(proc, cached_ptr, buf_size);
@@ -94,6 +117,7 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
         }
         case HG_DECODE: {
             hg_class_t *hg_class = hg_proc_get_class(proc);
+            hg_handle_t handle;
 
             HG_LOG_DEBUG("HG_DECODE");
 
@@ -108,9 +132,17 @@ hg_proc_hg_bulk_t(hg_proc_t proc, void *data)
             }
 
             buf = hg_proc_save_ptr(proc, buf_size);
-            ret = HG_Bulk_deserialize(hg_class, bulk_ptr, buf, buf_size);
+            handle = hg_proc_get_handle(proc);
+            ret = hg_bulk_deserialize_pinned(hg_class, bulk_ptr, buf,
+                buf_size,
+                (handle != HG_HANDLE_NULL) ? handle->core_handle : NULL);
             HG_CHECK_HG_ERROR(done, ret, "Could not deserialize handle");
 
+            /* Bulk size of RPC input is captured along with the RPC */
+            if (handle != HG_HANDLE_NULL)
+                hg_core_capture_bulk(
+                    handle->core_handle, HG_Bulk_get_size(*bulk_ptr));
+
             /* Cache serialize ptr to buf */
             HG_LOG_DEBUG(
                 "Caching pointer to serialized bulk handle (%p, %" PRIu64 ")",
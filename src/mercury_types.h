@@ -21,6 +21,7 @@ typedef struct hg_handle *hg_handle_t;  /* Abstract RPC handle */
 typedef struct hg_bulk *hg_bulk_t;      /* Abstract bulk data handle */
 typedef struct hg_proc *hg_proc_t;      /* Abstract serialization processor */
 typedef struct hg_op_id *hg_op_id_t;    /* Abstract operation id */
+typedef struct hg_multi *hg_multi_t;    /* Abstract fan-out operation */
 
 /* HG info struct */
 struct hg_info {
@@ -44,6 +45,7 @@ typedef enum hg_mem_type {
 struct hg_bulk_attr {
     hg_mem_type_t mem_type; /*!< Memory type */
     hg_uint64_t device;     /*!< Optional device ID */
+    hg_bool_t file_backed;  /*!< Memory is a file mapping (host only) */
 };
 
 /**
@@ -54,6 +56,14 @@ typedef enum {
     HG_BULK_PULL  /*!< pull data from origin */
 } hg_bulk_op_t;
 
+/**
+ * Bulk atomic operators.
+ */
+typedef enum {
+    HG_BULK_ATOMIC_FETCH_ADD = NA_ATOMIC_FETCH_ADD, /*!< fetch and add */
+    HG_BULK_ATOMIC_CAS = NA_ATOMIC_CAS              /*!< compare and swap */
+} hg_bulk_atomic_op_t;
+
 /* Callback info structs */
 struct hg_cb_info_lookup {
     hg_addr_t addr; /* HG address */
@@ -67,11 +77,17 @@ struct hg_cb_info_respond {
     hg_handle_t handle; /* HG handle */
 };
 
+struct hg_cb_info_forward_multi {
+    hg_multi_t multi; /* HG fan-out operation */
+};
+
 struct hg_cb_info_bulk {
     hg_bulk_t origin_handle; /* HG Bulk origin handle */
     hg_bulk_t local_handle;  /* HG Bulk local handle */
     hg_bulk_op_t op;         /* Operation type */
+    hg_uint32_t checksum;    /* CRC32C of data (if requested) */
     hg_size_t size;          /* Total size transferred */
+    hg_uint64_t result;      /* Previous value (HG_Bulk_atomic() only) */
 };
 
 struct hg_cb_info {
@@ -80,6 +96,7 @@ struct hg_cb_info {
         struct hg_cb_info_forward forward;
         struct hg_cb_info_respond respond;
         struct hg_cb_info_bulk bulk;
+        struct hg_cb_info_forward_multi forward_multi;
     } info;
     void *arg;         /* User data */
     hg_cb_type_t type; /* Callback type */
@@ -90,9 +107,50 @@ struct hg_cb_info {
 typedef hg_return_t (*hg_rpc_cb_t)(hg_handle_t handle);
 typedef hg_return_t (*hg_cb_t)(const struct hg_cb_info *callback_info);
 
+/* Trace callback (see HG_Class_set_trace_callback()) */
+typedef void (*hg_trace_cb_t)(
+    hg_handle_t handle, const struct hg_trace_info *trace_info, void *arg);
+
+/* Peer error callback (see HG_Class_set_peer_error_callback()) */
+typedef void (*hg_peer_error_cb_t)(hg_addr_t addr, hg_return_t ret, void *arg);
+
+/* Bulk chunk callback (offset is relative to the start of the transfer) */
+typedef void (*hg_bulk_chunk_cb_t)(void *arg, hg_size_t offset, hg_size_t size);
+
 /* Proc callback for serializing/deserializing parameters */
 typedef hg_return_t (*hg_proc_cb_t)(hg_proc_t proc, void *data);
 
+/* Reduce callback combining out_struct into acc_struct (see
+ * HG_Registered_reduce()) */
+typedef hg_return_t (*hg_reduce_cb_t)(void *acc_struct, void *out_struct);
+
+/* Payload compressor (see HG_Registered_compress()) */
+struct hg_compressor {
+    const char *name; /* Compressor name */
+    hg_uint8_t id;    /* Non-zero ID sent in the header of compressed RPCs */
+    /* Max compressed size of a payload of size bytes */
+    hg_size_t (*bound)(void *arg, hg_size_t size);
+    /* Compress src into dest, dest_size is the size of dest on input and the
+     * compressed size on output */
+    hg_return_t (*compress)(void *arg, const void *src, hg_size_t src_size,
+        void *dest, hg_size_t *dest_size);
+    /* Decompress src into dest, dest_size must match the original size */
+    hg_return_t (*decompress)(void *arg, const void *src, hg_size_t src_size,
+        void *dest, hg_size_t dest_size);
+    void *arg; /* Argument passed to callbacks */
+};
+
+/* Execution model of a context (see HG_Context_exec_start()) */
+struct hg_exec_info {
+    /* Number of threads running offloaded RPC callbacks (0 runs all RPC
+     * callbacks on the progress thread) */
+    unsigned int handler_thread_count;
+
+    /* Timeout passed to HG_Progress() by the progress thread, bounds the
+     * time needed to stop it (ms, 0 for default) */
+    unsigned int progress_timeout;
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -105,4 +163,11 @@ typedef hg_return_t (*hg_proc_cb_t)(hg_proc_t proc, void *data);
 #define HG_OP_ID_NULL   ((hg_op_id_t) 0)
 #define HG_OP_ID_IGNORE ((hg_op_id_t *) 1)
 
+/* Compressor IDs of built-in compressors, user-defined compressors should use
+ * IDs starting from HG_COMPRESSOR_USER */
+#define HG_COMPRESSOR_LZ4    1
+#define HG_COMPRESSOR_ZSTD   2
+#define HG_COMPRESSOR_SNAPPY 3
+#define HG_COMPRESSOR_USER   16
+
 #endif /* MERCURY_TYPES_H */
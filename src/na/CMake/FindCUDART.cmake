@@ -0,0 +1,36 @@
+# - Try to find the CUDA runtime
+# Once done this will define
+#  CUDART_FOUND - System has the CUDA runtime
+#  CUDART_INCLUDE_DIRS - The CUDA runtime include directories
+#  CUDART_LIBRARIES - The libraries needed to use the CUDA runtime
+
+find_package(PkgConfig)
+pkg_search_module(PC_CUDART cudart cudart-12 cudart-11)
+
+find_path(CUDART_INCLUDE_DIR cuda_runtime.h
+  HINTS ${PC_CUDART_INCLUDEDIR} ${PC_CUDART_INCLUDE_DIRS} $ENV{CUDA_HOME}/include
+  PATHS /usr/local/cuda/include /usr/local/include /usr/include)
+
+find_library(CUDART_LIBRARY NAMES cudart
+  HINTS ${PC_CUDART_LIBDIR} ${PC_CUDART_LIBRARY_DIRS} $ENV{CUDA_HOME}/lib64
+  PATHS /usr/local/cuda/lib64 /usr/local/lib64 /usr/local/lib /usr/lib64
+  /usr/lib)
+
+# Driver API (cuMemGetAddressRange)
+find_library(CUDART_CUDA_LIBRARY NAMES cuda
+  HINTS ${PC_CUDART_LIBDIR} ${PC_CUDART_LIBRARY_DIRS} $ENV{CUDA_HOME}/lib64
+  $ENV{CUDA_HOME}/lib64/stubs
+  PATHS /usr/local/cuda/lib64 /usr/local/cuda/lib64/stubs /usr/local/lib64
+  /usr/local/lib /usr/lib64 /usr/lib)
+
+set(CUDART_INCLUDE_DIRS ${CUDART_INCLUDE_DIR})
+set(CUDART_LIBRARIES ${CUDART_LIBRARY} ${CUDART_CUDA_LIBRARY})
+
+include(FindPackageHandleStandardArgs)
+# handle the QUIETLY and REQUIRED arguments and set CUDART_FOUND to TRUE
+# if all listed variables are TRUE
+find_package_handle_standard_args(CUDART DEFAULT_MSG
+                                  CUDART_INCLUDE_DIR CUDART_LIBRARY
+                                  CUDART_CUDA_LIBRARY)
+
+mark_as_advanced(CUDART_INCLUDE_DIR CUDART_LIBRARY CUDART_CUDA_LIBRARY)
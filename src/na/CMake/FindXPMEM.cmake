@@ -0,0 +1,27 @@
+# - Try to find XPMEM
+# Once done this will define
+#  XPMEM_FOUND - System has XPMEM
+#  XPMEM_INCLUDE_DIRS - The XPMEM include directories
+#  XPMEM_LIBRARIES - The libraries needed to use XPMEM
+
+find_package(PkgConfig)
+pkg_search_module(PC_XPMEM xpmem cray-xpmem)
+
+find_path(XPMEM_INCLUDE_DIR xpmem.h
+  HINTS ${PC_XPMEM_INCLUDEDIR} ${PC_XPMEM_INCLUDE_DIRS}
+  PATHS /usr/local/include /usr/include)
+
+find_library(XPMEM_LIBRARY NAMES xpmem
+  HINTS ${PC_XPMEM_LIBDIR} ${PC_XPMEM_LIBRARY_DIRS}
+  PATHS /usr/local/lib64 /usr/local/lib /usr/lib64 /usr/lib)
+
+set(XPMEM_INCLUDE_DIRS ${XPMEM_INCLUDE_DIR})
+set(XPMEM_LIBRARIES ${XPMEM_LIBRARY})
+
+include(FindPackageHandleStandardArgs)
+# handle the QUIETLY and REQUIRED arguments and set XPMEM_FOUND to TRUE
+# if all listed variables are TRUE
+find_package_handle_standard_args(XPMEM DEFAULT_MSG
+                                  XPMEM_INCLUDE_DIR XPMEM_LIBRARY)
+
+mark_as_advanced(XPMEM_INCLUDE_DIR XPMEM_LIBRARY)
@@ -5,15 +5,23 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE
+#endif
 #include "na_plugin.h"
 
 #include "mercury_atomic_queue.h"
 #include "mercury_mem.h"
+#include "mercury_mem_pool.h"
 #ifdef NA_HAS_MULTI_PROGRESS
 #    include "mercury_thread_condition.h"
+#endif
+#if defined(NA_HAS_MULTI_PROGRESS) || defined(NA_HAS_DYNAMIC_PLUGINS)
 #    include "mercury_thread_mutex.h"
 #endif
+#include "mercury_thread.h"
 #include "mercury_thread_spin.h"
+#include "mercury_time.h"
 #ifdef NA_HAS_DYNAMIC_PLUGINS
 #    include "mercury_dl.h"
 #    ifdef _WIN32
@@ -23,6 +31,7 @@
 #    endif
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -46,9 +55,33 @@
 
 #define NA_ATOMIC_QUEUE_SIZE 1024 /* TODO make it configurable */
 
+/* Max number of op IDs cached per context */
+#define NA_OP_POOL_SIZE 256
+
+/* Max number of completion entries popped at once */
+#define NA_TRIGGER_BATCH_SIZE 16
+
+/* Default number of pending submissions to a progress thread */
+#define NA_SUBMIT_QUEUE_SIZE 1024
+
+/* Max number of submissions posted between two progress calls */
+#define NA_SUBMIT_BATCH_SIZE 64
+
+/* Protocol selection defaults */
+#define NA_SELECT_ITERATIONS 100
+#define NA_SELECT_REG_SIZE   (1 << 20)
+#define NA_SELECT_TIMEOUT    1000 /* ms */
+#define NA_SELECT_MAX_STRING 256
+
 /* 32-bit lock value for serial progress */
 #define NA_PROGRESS_LOCK 0x80000000
 
+/* Zigzag mapping of signed deltas so that small negative values stay short */
+#define NA_ZIGZAG_ENCODE(x)                                                    \
+    (((uint64_t) (x) << 1) ^ (uint64_t) ((int64_t) (x) >> 63))
+#define NA_ZIGZAG_DECODE(x)                                                    \
+    (((uint64_t) (x) >> 1) ^ ((uint64_t) 0 - ((uint64_t) (x) & 1)))
+
 /* Dynamic plugins */
 #define NA_PLUGIN_PREFIX   "libna_plugin_"
 #define NA_PLUGIN_SCN_NAME "libna_plugin_%16[^_.]"
@@ -58,22 +91,38 @@
 /* Max number of NA plugins */
 #define NA_PLUGIN_MAX (16)
 
+/* Manifest match rank of a dynamic plugin for a requested protocol */
+#define NA_PLUGIN_RANK_NONE   (0) /* Not a candidate */
+#define NA_PLUGIN_RANK_ANY    (1) /* Plugin does not list its protocols */
+#define NA_PLUGIN_RANK_LISTED (2) /* Requested by name or protocol listed */
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
 
 #ifdef NA_HAS_DYNAMIC_PLUGINS
+/* Protocols served by a dynamic plugin */
+struct na_plugin_manifest {
+    const char *name;             /* Plugin name */
+    const char *const *protocols; /* NULL-terminated list, NULL if any */
+};
+
 /* Plugin entries */
 struct na_plugin_entry {
-    char *path;
-    HG_DL_HANDLE dl_handle;
-    const struct na_class_ops *ops;
+    char *path;                        /* Path to plugin */
+    char name[NA_PLUGIN_NAME_MAX + 1]; /* Plugin name */
+    const char *const *protocols;      /* Protocols from manifest */
+    HG_DL_HANDLE dl_handle;            /* Handle, NULL until first used */
+    const struct na_class_ops *ops;    /* Plugin ops */
 };
 #endif
 
 /* Private class */
 struct na_private_class {
-    struct na_class na_class; /* Must remain as first field */
+    struct na_class na_class;         /* Must remain as first field */
+    na_addr_error_cb_t addr_error_cb; /* Peer error callback */
+    void *addr_error_arg;             /* Peer error callback arg */
+    struct hg_mem_budget *mem_budget; /* Memory budget */
 };
 
 /* Completion queue */
@@ -83,6 +132,13 @@ struct na_completion_queue {
     hg_atomic_int32_t count;                    /* Number of entries */
 };
 
+/* Op ID pool */
+struct na_op_pool {
+    na_op_id_t *ops[NA_OP_POOL_SIZE]; /* Cached op IDs */
+    unsigned int count;               /* Number of cached op IDs */
+    hg_thread_spin_t lock;            /* Pool lock */
+};
+
 #ifdef NA_HAS_MULTI_PROGRESS
 /* Ensure thread safety when progressing context from multiple threads */
 struct na_progress_multi {
@@ -92,6 +148,34 @@ struct na_progress_multi {
 };
 #endif
 
+/* Submission queue entry */
+struct na_submit_entry {
+    struct na_submit_info info;                   /* Submitted operation */
+    struct na_cb_completion_data completion_data; /* Post error completion */
+    struct na_progress_engine *engine;            /* Owning progress engine */
+};
+
+/* Progress thread and its submission queue */
+struct na_progress_engine {
+    struct hg_atomic_queue *submit_queue; /* Pending submissions */
+    struct hg_atomic_queue *free_queue;   /* Free submission entries */
+    struct na_submit_entry *entries;      /* Submission entries */
+    na_class_t *na_class;                 /* NA class */
+    na_context_t *context;                /* NA context */
+    hg_thread_t thread;                   /* Progress thread */
+    hg_atomic_int32_t stopping;           /* Progress thread must exit */
+    hg_atomic_int32_t failed;             /* Failed posts not yet triggered */
+    unsigned int progress_timeout;        /* Timeout when idle (ms) */
+    bool running;                         /* Progress thread is running */
+};
+
+/* Protocol selection measurement state */
+struct na_select_bench {
+    na_class_t *na_class;   /* Measured class */
+    unsigned int completed; /* Number of completed operations */
+    na_return_t ret;        /* First error */
+};
+
 /* Private context / do not expose private members to plugins */
 struct na_private_context {
     struct na_context context; /* Must remain as first field */
@@ -99,8 +183,12 @@ struct na_private_context {
     struct na_progress_multi progress_multi; /* Progress multi */
 #endif
     struct na_completion_queue backfill_queue; /* Backfill queue */
+    struct na_op_pool op_pool;                 /* Op ID pool */
     struct hg_atomic_queue *completion_queue;  /* Default completion queue */
+    struct na_progress_engine *engine;         /* Progress thread (optional) */
     na_class_t *na_class;                      /* Pointer to NA class */
+    hg_cpu_set_t cpu_mask;                     /* Context CPUs */
+    bool bound;                                /* Context placed on CPUs */
 };
 
 /* NA address */
@@ -125,6 +213,11 @@ na_info_parse(
 static void
 na_info_free(struct na_info *na_info);
 
+/* Duplicate init info for ABI compatibility */
+static void
+na_init_info_dup_4_0(struct na_init_info *na_init_info,
+    const struct na_init_info_4_0 *na_init_info_4_0);
+
 /* Get protocol info from plugins */
 static na_return_t
 na_plugin_get_protocol_info(const struct na_class_ops *const class_ops[],
@@ -152,16 +245,86 @@ na_plugin_filter(const struct dirent *entry);
 static void
 na_plugin_close_all(struct na_plugin_entry *entries);
 
-/* Open plugin in a given path */
+/* Fill plugin entry from file name without loading it */
 static na_return_t
-na_plugin_open(
+na_plugin_entry_init(
     const char *path, const char *file, struct na_plugin_entry *entry);
 
+/* Rank plugin entry against requested class and protocol */
+static int
+na_plugin_rank(const struct na_plugin_entry *entry, const char *class_name,
+    const char *protocol_name);
+
+/* Load plugins of a given rank and return their ops */
+static int
+na_plugin_load(const char *class_name, const char *protocol_name, int rank,
+    const struct na_class_ops *ops[], int max_count);
+
+/* Open plugin entry */
+static na_return_t
+na_plugin_open(struct na_plugin_entry *entry);
+
 /* Close plugin entry */
 static void
 na_plugin_close(struct na_plugin_entry *entry);
 #endif /* NA_HAS_DYNAMIC_PLUGINS */
 
+/* Pop up to max_count entries from completion queues */
+static unsigned int
+na_completion_pop(struct na_private_context *na_private_context,
+    struct na_cb_completion_data **entries, unsigned int max_count);
+
+/* Progress thread loop */
+static HG_THREAD_RETURN_TYPE
+na_progress_thread(void *arg);
+
+/* Post a batch of pending submissions, return true if some remain */
+static bool
+na_progress_submit_drain(struct na_progress_engine *engine);
+
+/* Post a submitted operation */
+static void
+na_progress_submit_post(
+    struct na_progress_engine *engine, struct na_submit_entry *entry);
+
+/* Release a submission entry after its error completion is triggered */
+static void
+na_progress_submit_release(void *arg);
+
+/* Free progress engine resources */
+static void
+na_progress_engine_free(struct na_progress_engine *engine);
+
+/* Look up a recorded protocol selection */
+static bool
+na_select_cache_get(
+    const char *cache_path, const char *key, char *buf, size_t buf_size);
+
+/* Record a protocol selection */
+static void
+na_select_cache_put(const char *cache_path, const char *key, const char *value);
+
+/* Measure loopback latency and registration cost of a protocol (us) */
+static na_return_t
+na_select_measure(const char *info_string, unsigned int iterations,
+    size_t reg_size, double *latency_p, double *reg_cost_p);
+
+/* Completion callback of measured operations */
+static void
+na_select_cb(const struct na_cb_info *callback_info);
+
+/* Wait until count operations have completed */
+static na_return_t
+na_select_wait(na_class_t *na_class, na_context_t *context,
+    struct na_select_bench *bench, unsigned int count);
+
+/* Check and post remote atomic operation */
+static na_return_t
+na_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -179,6 +342,9 @@ static const struct na_class_ops *const na_plugin_static_g[] = {
     &NA_PLUGIN_OPS(ucx),
 #    endif
 #endif
+#ifdef NA_HAS_TCP
+    &NA_PLUGIN_OPS(tcp),
+#endif
 #ifdef NA_HAS_BMI
     &NA_PLUGIN_OPS(bmi),
 #endif
@@ -196,9 +362,31 @@ static const struct na_class_ops *const na_plugin_static_g[] = {
 #endif
     NULL};
 
-/* Dynamic plugin ops table */
 #ifdef NA_HAS_DYNAMIC_PLUGINS
+#    ifdef NA_HAS_OFI
+/* Protocols (libfabric providers) accepted by NA OFI */
+static const char *const na_plugin_ofi_protocols_g[] = {"shm", "sm",
+    "sockets", "tcp", "tcp_exp", "tcp;ofi_rxm", "psm2", "opx", "verbs",
+    "verbs;ofi_rxm", "gni", "cxi", NULL};
+#    endif
+
+/* Manifest of dynamic plugins, only plugins that may serve the requested
+ * protocol are loaded. Plugins that are not listed or that do not list their
+ * protocols are only tried once listed plugins have been */
+static const struct na_plugin_manifest na_plugin_manifest_g[] = {
+#    ifdef NA_HAS_OFI
+    {"ofi", na_plugin_ofi_protocols_g},
+#    endif
+#    ifdef NA_HAS_UCX
+    {"ucx", NULL}, /* UCX transports are not a fixed set */
+#    endif
+    {NULL, NULL}};
+
+/* Dynamic plugin table (plugins are opened on first use) */
 static struct na_plugin_entry *na_plugin_dynamic_g = NULL;
+
+/* Serialize plugin loading */
+static hg_thread_mutex_t na_plugin_mutex_g;
 #endif
 
 /* Return code string table */
@@ -267,6 +455,9 @@ na_initialize(void)
     if (plugin_path == NULL)
         plugin_path = NA_DEFAULT_PLUGIN_PATH;
 
+    (void) hg_thread_mutex_init(&na_plugin_mutex_g);
+
+    /* Only list plugins, they are loaded when a protocol requires them */
     ret = na_plugin_scan_path(plugin_path, &na_plugin_dynamic_g);
     NA_CHECK_SUBSYS_WARNING(fatal, ret != NA_SUCCESS,
         "No plugin found in path (%s), consider setting NA_PLUGIN_PATH.",
@@ -278,6 +469,8 @@ static void
 na_finalize(void)
 {
     na_plugin_close_all(na_plugin_dynamic_g);
+    free(na_plugin_dynamic_g);
+    (void) hg_thread_mutex_destroy(&na_plugin_mutex_g);
 }
 #endif
 
@@ -375,6 +568,23 @@ na_info_free(struct na_info *na_info)
     free(na_info);
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_init_info_dup_4_0(struct na_init_info *na_init_info,
+    const struct na_init_info_4_0 *na_init_info_4_0)
+{
+    *na_init_info = NA_INIT_INFO_INITIALIZER;
+    na_init_info->ip_subnet = na_init_info_4_0->ip_subnet;
+    na_init_info->auth_key = na_init_info_4_0->auth_key;
+    na_init_info->max_unexpected_size = na_init_info_4_0->max_unexpected_size;
+    na_init_info->max_expected_size = na_init_info_4_0->max_expected_size;
+    na_init_info->progress_mode = na_init_info_4_0->progress_mode;
+    na_init_info->addr_format = na_init_info_4_0->addr_format;
+    na_init_info->max_contexts = na_init_info_4_0->max_contexts;
+    na_init_info->thread_mode = na_init_info_4_0->thread_mode;
+    na_init_info->request_mem_device = na_init_info_4_0->request_mem_device;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_plugin_get_protocol_info(const struct na_class_ops *const class_ops[],
@@ -490,7 +700,7 @@ na_plugin_scan_path(const char *path, struct na_plugin_entry **entries_p)
     struct dirent **plugin_list;
     struct na_plugin_entry *entries = NULL;
     na_return_t ret;
-    int n, n_entries = 0;
+    int i, n;
 
     n = scandir(path, &plugin_list, na_plugin_filter, alphasort);
     NA_CHECK_SUBSYS_ERROR(
@@ -500,15 +710,16 @@ na_plugin_scan_path(const char *path, struct na_plugin_entry **entries_p)
         (struct na_plugin_entry *) calloc((size_t) n + 1, sizeof(*entries));
     NA_CHECK_SUBSYS_ERROR(cls, entries == NULL, error, ret, NA_NOMEM,
         "Could not allocate %d plugin entries", n);
-    n_entries = n;
 
-    while (n--) {
-        ret = na_plugin_open(path, plugin_list[n]->d_name, &entries[n]);
-        free(plugin_list[n]);
-        NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not open plugin (%s)",
-            plugin_list[n]->d_name);
+    /* Plugins are not opened until a protocol requires them */
+    for (i = 0; i < n; i++) {
+        ret = na_plugin_entry_init(path, plugin_list[i]->d_name, &entries[i]);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not add plugin (%s)",
+            plugin_list[i]->d_name);
     }
 
+    for (i = 0; i < n; i++)
+        free(plugin_list[i]);
     free(plugin_list);
 
     *entries_p = entries;
@@ -516,18 +727,12 @@ na_plugin_scan_path(const char *path, struct na_plugin_entry **entries_p)
     return NA_SUCCESS;
 
 error:
-    if (n > 0) {
-        if (entries != NULL) {
-            int i;
-
-            /* close entry */
-            for (i = n + 1; i < n_entries; i++)
-                na_plugin_close(&entries[i]);
-            free(entries);
-        }
+    if (n >= 0) {
+        na_plugin_close_all(entries);
+        free(entries);
 
-        while (n--)
-            free(plugin_list[n]);
+        for (i = 0; i < n; i++)
+            free(plugin_list[i]);
         free(plugin_list);
     }
 
@@ -552,19 +757,18 @@ na_plugin_close_all(struct na_plugin_entry *entries)
     if (entries == NULL)
         return;
 
-    for (i = 0, entry = &entries[0]; entry->ops != NULL;
+    for (i = 0, entry = &entries[0]; entry->path != NULL;
          i++, entry = &entries[i])
         na_plugin_close(entry);
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_plugin_open(
+na_plugin_entry_init(
     const char *path, const char *file, struct na_plugin_entry *entry)
 {
     char full_path[NA_PLUGIN_PATH_MAX + 1];
-    char plugin_name[NA_PLUGIN_NAME_MAX + 1];
-    char plugin_ops_name[NA_PLUGIN_NAME_MAX * 2 + 1];
+    const struct na_plugin_manifest *manifest;
     na_return_t ret;
     int rc;
 
@@ -575,25 +779,97 @@ na_plugin_open(
         "snprintf() failed or name truncated, rc: %d (expected %zu)", rc,
         sizeof(full_path));
 
-    /* Keep a copy of path for debug purposes */
+    /* Retrieve plugin name from file name */
+    rc = sscanf(file, NA_PLUGIN_SCN_NAME, entry->name);
+    NA_CHECK_SUBSYS_ERROR(cls, rc != 1, error, ret, NA_PROTONOSUPPORT,
+        "Could not find plugin name (%s)", file);
+
+    /* Keep a copy of path to open plugin later */
     entry->path = strdup(full_path);
     NA_CHECK_SUBSYS_ERROR(cls, entry->path == NULL, error, ret, NA_NOMEM,
         "Could not dup %s", full_path);
 
+    /* Plugins not in manifest may serve any protocol */
+    for (manifest = na_plugin_manifest_g; manifest->name != NULL; manifest++)
+        if (strcmp(manifest->name, entry->name) == 0)
+            break;
+    entry->protocols = manifest->protocols;
+
+    NA_LOG_SUBSYS_DEBUG(cls, "Found plugin %s (%s)", entry->name, entry->path);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+na_plugin_rank(const struct na_plugin_entry *entry, const char *class_name,
+    const char *protocol_name)
+{
+    const char *const *protocol;
+
+    if (class_name != NULL)
+        return (strcmp(entry->name, class_name) == 0) ? NA_PLUGIN_RANK_LISTED
+                                                      : NA_PLUGIN_RANK_NONE;
+    if (protocol_name == NULL)
+        return NA_PLUGIN_RANK_LISTED;
+    if (entry->protocols == NULL)
+        return NA_PLUGIN_RANK_ANY;
+
+    for (protocol = entry->protocols; *protocol != NULL; protocol++)
+        if (strcmp(*protocol, protocol_name) == 0)
+            return NA_PLUGIN_RANK_LISTED;
+
+    return NA_PLUGIN_RANK_NONE;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+na_plugin_load(const char *class_name, const char *protocol_name, int rank,
+    const struct na_class_ops *ops[], int max_count)
+{
+    struct na_plugin_entry *entry;
+    int count = 0;
+
+    if (na_plugin_dynamic_g == NULL)
+        return 0;
+
+    hg_thread_mutex_lock(&na_plugin_mutex_g);
+    for (entry = na_plugin_dynamic_g; entry->path != NULL && count < max_count;
+         entry++) {
+        if (na_plugin_rank(entry, class_name, protocol_name) != rank)
+            continue;
+
+        /* Plugins that cannot be opened are skipped */
+        if (entry->ops == NULL && na_plugin_open(entry) != NA_SUCCESS)
+            continue;
+
+        ops[count++] = entry->ops;
+    }
+    hg_thread_mutex_unlock(&na_plugin_mutex_g);
+
+    return count;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_plugin_open(struct na_plugin_entry *entry)
+{
+    char plugin_ops_name[NA_PLUGIN_NAME_MAX * 2 + 1];
+    na_return_t ret;
+    int rc;
+
     /* Open plugin */
     NA_LOG_SUBSYS_DEBUG(cls, "Opening plugin %s", entry->path);
     entry->dl_handle = hg_dl_open(entry->path);
     NA_CHECK_SUBSYS_ERROR(cls, entry->dl_handle == NULL, error, ret, NA_NOENTRY,
         "Could not open lib %s", entry->path);
 
-    /* Retrieve plugin name from file name */
-    rc = sscanf(file, NA_PLUGIN_SCN_NAME, plugin_name);
-    NA_CHECK_SUBSYS_ERROR(cls, rc != 1, error, ret, NA_PROTONOSUPPORT,
-        "Could not find plugin name (%s)", file);
-
     /* Generate plugin ops symbol name */
     rc = snprintf(plugin_ops_name, sizeof(plugin_ops_name), "na_%s_class_ops_g",
-        plugin_name);
+        entry->name);
     NA_CHECK_SUBSYS_ERROR(cls, rc < 0 || rc > (int) sizeof(plugin_ops_name),
         error, ret, NA_OVERFLOW,
         "snprintf() failed or name truncated, rc: %d (expected %zu)", rc,
@@ -608,6 +884,10 @@ na_plugin_open(
     return NA_SUCCESS;
 
 error:
+    if (entry->dl_handle != NULL) {
+        (void) hg_dl_close(entry->dl_handle);
+        entry->dl_handle = NULL;
+    }
     return ret;
 }
 
@@ -618,13 +898,436 @@ na_plugin_close(struct na_plugin_entry *entry)
     if (entry->path) {
         NA_LOG_SUBSYS_DEBUG(cls, "Closing plugin %s", entry->path);
         free(entry->path);
+        entry->path = NULL;
     }
-    if (entry->dl_handle != NULL)
+    if (entry->dl_handle != NULL) {
         (void) hg_dl_close(entry->dl_handle);
+        entry->dl_handle = NULL;
+    }
     entry->ops = NULL;
 }
 #endif /* NA_HAS_DYNAMIC_PLUGINS */
 
+/*---------------------------------------------------------------------------*/
+static unsigned int
+na_completion_pop(struct na_private_context *na_private_context,
+    struct na_cb_completion_data **entries, unsigned int max_count)
+{
+    struct na_completion_queue *backfill_queue =
+        &na_private_context->backfill_queue;
+    unsigned int count;
+
+    count = hg_atomic_queue_pop_mc_batch(
+        na_private_context->completion_queue, (void **) entries, max_count);
+
+    /* Check backfill queue */
+    if (count < max_count && hg_atomic_get32(&backfill_queue->count) > 0) {
+        hg_thread_spin_lock(&backfill_queue->lock);
+        while (
+            count < max_count && !HG_QUEUE_IS_EMPTY(&backfill_queue->queue)) {
+            entries[count++] = HG_QUEUE_FIRST(&backfill_queue->queue);
+            HG_QUEUE_POP_HEAD(&backfill_queue->queue, entry);
+            hg_atomic_decr32(&backfill_queue->count);
+        }
+        hg_thread_spin_unlock(&backfill_queue->lock);
+    }
+
+    return count;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+na_progress_thread(void *arg)
+{
+    struct na_progress_engine *engine = (struct na_progress_engine *) arg;
+    hg_thread_ret_t tret = (hg_thread_ret_t) 0;
+    na_return_t ret;
+
+    while (!hg_atomic_get32(&engine->stopping)) {
+        bool pending = na_progress_submit_drain(engine);
+
+        ret = NA_Progress(engine->na_class, engine->context,
+            pending ? 0 : engine->progress_timeout);
+        NA_CHECK_SUBSYS_ERROR_NORET(ctx, ret != NA_SUCCESS && ret != NA_TIMEOUT,
+            done, "NA_Progress() failed (%s)", NA_Error_to_string(ret));
+
+        /* Busy polling, let other threads run if idle */
+        if (ret == NA_TIMEOUT && !pending && engine->progress_timeout == 0)
+            hg_thread_yield();
+    }
+
+done:
+    return tret;
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+na_progress_submit_drain(struct na_progress_engine *engine)
+{
+    struct na_submit_entry *entries[NA_SUBMIT_BATCH_SIZE];
+    unsigned int i, n_entries;
+
+    n_entries = hg_atomic_queue_pop_sc_batch(
+        engine->submit_queue, (void **) entries, NA_SUBMIT_BATCH_SIZE);
+    for (i = 0; i < n_entries; i++)
+        na_progress_submit_post(engine, entries[i]);
+
+    return !hg_atomic_queue_is_empty(engine->submit_queue);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_progress_submit_post(
+    struct na_progress_engine *engine, struct na_submit_entry *entry)
+{
+    const struct na_submit_info *info = &entry->info;
+    na_class_t *na_class = engine->na_class;
+    na_context_t *context = engine->context;
+    na_return_t ret;
+
+    switch (info->type) {
+        case NA_CB_SEND_UNEXPECTED:
+            ret = na_class->ops->msg_send_unexpected(na_class, context,
+                info->callback, info->arg, info->info.msg.buf,
+                info->info.msg.buf_size, info->info.msg.plugin_data,
+                info->info.msg.addr, info->info.msg.id, info->info.msg.tag,
+                info->op_id);
+            break;
+        case NA_CB_RECV_UNEXPECTED:
+            ret = na_class->ops->msg_recv_unexpected(na_class, context,
+                info->callback, info->arg, info->info.msg.buf,
+                info->info.msg.buf_size, info->info.msg.plugin_data,
+                info->op_id);
+            break;
+        case NA_CB_SEND_EXPECTED:
+            ret = na_class->ops->msg_send_expected(na_class, context,
+                info->callback, info->arg, info->info.msg.buf,
+                info->info.msg.buf_size, info->info.msg.plugin_data,
+                info->info.msg.addr, info->info.msg.id, info->info.msg.tag,
+                info->op_id);
+            break;
+        case NA_CB_RECV_EXPECTED:
+            ret = na_class->ops->msg_recv_expected(na_class, context,
+                info->callback, info->arg, info->info.msg.buf,
+                info->info.msg.buf_size, info->info.msg.plugin_data,
+                info->info.msg.addr, info->info.msg.id, info->info.msg.tag,
+                info->op_id);
+            break;
+        case NA_CB_PUT:
+            ret = na_class->ops->put(na_class, context, info->callback,
+                info->arg, info->info.rma.local_mem_handle,
+                info->info.rma.local_offset, info->info.rma.remote_mem_handle,
+                info->info.rma.remote_offset, info->info.rma.data_size,
+                info->info.rma.remote_addr, info->info.rma.remote_id,
+                info->op_id);
+            break;
+        case NA_CB_GET:
+            ret = na_class->ops->get(na_class, context, info->callback,
+                info->arg, info->info.rma.local_mem_handle,
+                info->info.rma.local_offset, info->info.rma.remote_mem_handle,
+                info->info.rma.remote_offset, info->info.rma.data_size,
+                info->info.rma.remote_addr, info->info.rma.remote_id,
+                info->op_id);
+            break;
+        case NA_CB_MULTI_RECV_UNEXPECTED:
+        case NA_CB_MAX:
+        default:
+            ret = NA_INVALID_ARG;
+            break;
+    }
+
+    if (ret == NA_SUCCESS) {
+        (void) hg_atomic_queue_push(engine->free_queue, entry);
+        return;
+    }
+
+    /* Retry later, there is always room since the entry was just popped */
+    if (ret == NA_AGAIN) {
+        (void) hg_atomic_queue_push(engine->submit_queue, entry);
+        return;
+    }
+
+    NA_LOG_SUBSYS_ERROR(op, "Could not post submitted %s operation (%s)",
+        na_cb_type_to_string(info->type), NA_Error_to_string(ret));
+
+    /* Report error through the completion queue of the context */
+    entry->completion_data.callback_info.arg = info->arg;
+    entry->completion_data.callback_info.type = info->type;
+    entry->completion_data.callback_info.ret = ret;
+    entry->completion_data.callback = info->callback;
+    entry->completion_data.plugin_callback = na_progress_submit_release;
+    entry->completion_data.plugin_callback_args = entry;
+    hg_atomic_incr32(&engine->failed);
+
+    na_cb_completion_add(context, &entry->completion_data);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_progress_submit_release(void *arg)
+{
+    struct na_submit_entry *entry = (struct na_submit_entry *) arg;
+    struct na_progress_engine *engine = entry->engine;
+
+    (void) hg_atomic_queue_push(engine->free_queue, entry);
+    hg_atomic_decr32(&engine->failed);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_progress_engine_free(struct na_progress_engine *engine)
+{
+    hg_atomic_queue_free(engine->submit_queue);
+    hg_atomic_queue_free(engine->free_queue);
+    free(engine->entries);
+    free(engine);
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+na_select_cache_get(
+    const char *cache_path, const char *key, char *buf, size_t buf_size)
+{
+    char line[2 * NA_SELECT_MAX_STRING];
+    size_t key_len = strlen(key);
+    bool found = false;
+    FILE *file;
+
+    file = fopen(cache_path, "r");
+    if (file == NULL)
+        return false;
+
+    /* Lines are "<info string> <selection>", last record wins */
+    while (fgets(line, (int) sizeof(line), file) != NULL) {
+        size_t value_len;
+
+        if (strncmp(line, key, key_len) != 0 || line[key_len] != ' ')
+            continue;
+        value_len = strcspn(&line[key_len + 1], "\r\n");
+        if (value_len == 0 || value_len >= buf_size)
+            continue;
+        memcpy(buf, &line[key_len + 1], value_len);
+        buf[value_len] = '\0';
+        found = true;
+    }
+    fclose(file);
+
+    return found;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_select_cache_put(const char *cache_path, const char *key, const char *value)
+{
+    FILE *file;
+
+    file = fopen(cache_path, "a");
+    NA_CHECK_SUBSYS_WARNING(cls, file == NULL,
+        "Could not record protocol selection to %s", cache_path);
+    if (file == NULL)
+        return;
+
+    fprintf(file, "%s %s\n", key, value);
+    fclose(file);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_select_measure(const char *info_string, unsigned int iterations,
+    size_t reg_size, double *latency_p, double *reg_cost_p)
+{
+    struct na_select_bench bench = {
+        .na_class = NULL, .completed = 0, .ret = NA_SUCCESS};
+    na_class_t *na_class = NULL;
+    na_context_t *context = NULL;
+    na_addr_t *self_addr = NULL;
+    na_op_id_t *send_op = NULL, *recv_op = NULL;
+    void *send_buf = NULL, *recv_buf = NULL;
+    void *send_data = NULL, *recv_data = NULL;
+    void *reg_buf = NULL;
+    size_t send_size, recv_size;
+    hg_time_t t1, t2;
+    unsigned int i;
+    na_return_t ret;
+
+    na_class = NA_Initialize(info_string, true);
+    NA_CHECK_SUBSYS_ERROR(cls, na_class == NULL, done, ret, NA_PROTONOSUPPORT,
+        "Could not initialize %s", info_string);
+    bench.na_class = na_class;
+
+    context = NA_Context_create(na_class);
+    NA_CHECK_SUBSYS_ERROR(cls, context == NULL, done, ret, NA_NOMEM,
+        "Could not create context");
+
+    ret = NA_Addr_self(na_class, &self_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not get self address");
+
+    /* Small unexpected message */
+    send_size = NA_Msg_get_unexpected_header_size(na_class) + sizeof(uint64_t);
+    recv_size = NA_Msg_get_max_unexpected_size(na_class);
+    send_buf = NA_Msg_buf_alloc(na_class, send_size, NA_SEND, &send_data);
+    recv_buf = NA_Msg_buf_alloc(na_class, recv_size, NA_RECV, &recv_data);
+    NA_CHECK_SUBSYS_ERROR(cls, send_buf == NULL || recv_buf == NULL, done, ret,
+        NA_NOMEM, "Could not allocate message buffers");
+    ret = NA_Msg_init_unexpected(na_class, send_buf, send_size);
+    NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not init message");
+
+    send_op = NA_Op_create(na_class, NA_OP_SINGLE);
+    recv_op = NA_Op_create(na_class, NA_OP_SINGLE);
+    NA_CHECK_SUBSYS_ERROR(cls, send_op == NULL || recv_op == NULL, done, ret,
+        NA_NOMEM, "Could not create op IDs");
+
+    /* First round-trip is not measured */
+    for (i = 0; i <= iterations; i++) {
+        if (i == 1)
+            hg_time_get_current(&t1);
+
+        bench.completed = 0;
+        ret = NA_Msg_recv_unexpected(na_class, context, na_select_cb, &bench,
+            recv_buf, recv_size, recv_data, recv_op);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not post recv");
+        ret = NA_Msg_send_unexpected(na_class, context, na_select_cb, &bench,
+            send_buf, send_size, send_data, self_addr, 0, 0, send_op);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, cancel, ret, "Could not post send");
+
+        ret = na_select_wait(na_class, context, &bench, 2);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, cancel, ret, "Loopback did not complete");
+    }
+    hg_time_get_current(&t2);
+    *latency_p =
+        (iterations > 0)
+            ? hg_time_to_double(hg_time_subtract(t2, t1)) * 1e6 / iterations
+            : 0.;
+
+    /* Registration cost */
+    reg_buf = malloc(reg_size);
+    NA_CHECK_SUBSYS_ERROR(cls, reg_buf == NULL, done, ret, NA_NOMEM,
+        "Could not allocate registration buffer");
+    memset(reg_buf, 0, reg_size);
+
+    hg_time_get_current(&t1);
+    for (i = 0; i < iterations; i++) {
+        na_mem_handle_t *mem_handle = NULL;
+
+        ret = NA_Mem_handle_create(
+            na_class, reg_buf, reg_size, NA_MEM_READWRITE, &mem_handle);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not create handle");
+        ret = NA_Mem_register(na_class, mem_handle, NA_MEM_TYPE_HOST, 0);
+        if (ret == NA_SUCCESS)
+            ret = NA_Mem_deregister(na_class, mem_handle);
+        NA_Mem_handle_free(na_class, mem_handle);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not register memory");
+    }
+    hg_time_get_current(&t2);
+    *reg_cost_p =
+        (iterations > 0)
+            ? hg_time_to_double(hg_time_subtract(t2, t1)) * 1e6 / iterations
+            : 0.;
+
+    ret = NA_SUCCESS;
+    goto done;
+
+cancel:
+    /* Let pending operations complete before tearing down */
+    (void) NA_Cancel(na_class, context, recv_op);
+    (void) NA_Cancel(na_class, context, send_op);
+    (void) na_select_wait(na_class, context, &bench, 2);
+
+done:
+    free(reg_buf);
+    if (na_class != NULL) {
+        NA_Op_destroy(na_class, send_op);
+        NA_Op_destroy(na_class, recv_op);
+        if (send_buf != NULL)
+            NA_Msg_buf_free(na_class, send_buf, send_data);
+        if (recv_buf != NULL)
+            NA_Msg_buf_free(na_class, recv_buf, recv_data);
+        if (self_addr != NULL)
+            NA_Addr_free(na_class, self_addr);
+        if (context != NULL)
+            (void) NA_Context_destroy(na_class, context);
+        (void) NA_Finalize(na_class);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_select_cb(const struct na_cb_info *callback_info)
+{
+    struct na_select_bench *bench =
+        (struct na_select_bench *) callback_info->arg;
+
+    if (callback_info->ret != NA_SUCCESS && bench->ret == NA_SUCCESS)
+        bench->ret = callback_info->ret;
+    else if (callback_info->type == NA_CB_RECV_UNEXPECTED &&
+             callback_info->ret == NA_SUCCESS)
+        NA_Addr_free(
+            bench->na_class, callback_info->info.recv_unexpected.source);
+
+    bench->completed++;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_select_wait(na_class_t *na_class, na_context_t *context,
+    struct na_select_bench *bench, unsigned int count)
+{
+    hg_time_t deadline, now;
+
+    hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(NA_SELECT_TIMEOUT));
+
+    while (bench->completed < count) {
+        unsigned int actual_count = 0;
+        na_return_t ret;
+
+        ret = NA_Trigger(context, count, &actual_count);
+        if (ret != NA_SUCCESS)
+            return ret;
+        if (bench->completed >= count)
+            break;
+
+        hg_time_get_current_ms(&now);
+        if (hg_time_less(deadline, now))
+            return NA_TIMEOUT;
+
+        ret = NA_Progress(na_class, context, 0);
+        if (ret != NA_SUCCESS && ret != NA_TIMEOUT)
+            return ret;
+    }
+
+    return bench->ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id)
+{
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        rma, na_class == NULL, error, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(rma, remote_mem_handle == NULL, error, ret,
+        NA_INVALID_ARG, "NULL remote memory handle");
+    NA_CHECK_SUBSYS_ERROR(rma, remote_offset % sizeof(uint64_t) != 0, error,
+        ret, NA_INVALID_ARG, "Remote offset (%" PRIu64 ") is not aligned",
+        remote_offset);
+    NA_CHECK_SUBSYS_ERROR(rma, na_class->ops->atomic == NULL, error, ret,
+        NA_OPNOTSUPPORTED, "Remote atomic operations not supported");
+
+    return na_class->ops->atomic(na_class, context, callback, arg, op, operand,
+        compare, remote_mem_handle, remote_offset, remote_addr, remote_id,
+        op_id);
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 void
 NA_Version_get(unsigned int *major, unsigned int *minor, unsigned int *patch)
@@ -659,18 +1362,21 @@ NA_Get_protocol_info(
         na_plugin_static_g, class_name, na_info, &na_protocol_info);
     NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not check static plugins");
 
-    /* Check list of dynamic plugins */
+    /* Check list of dynamic plugins, only loading the ones that may serve
+     * the requested protocol */
 #ifdef NA_HAS_DYNAMIC_PLUGINS
-    if (na_plugin_dynamic_g != NULL) {
+    {
         struct na_protocol_info *dynamic_protocol_info = NULL;
-        const struct na_class_ops *na_plugin_dynamic[NA_PLUGIN_MAX] = {NULL};
-        const struct na_class_ops *ops = NULL;
-        int i;
+        const struct na_class_ops *na_plugin_dynamic[NA_PLUGIN_MAX + 1] = {
+            NULL};
+        const char *protocol_name =
+            (na_info != NULL) ? na_info->protocol_name : NULL;
+        int count;
 
-        for (i = 0, ops = na_plugin_dynamic_g[0].ops;
-             i < NA_PLUGIN_MAX && ops != NULL;
-             i++, ops = na_plugin_dynamic_g[i].ops)
-            na_plugin_dynamic[i] = ops;
+        count = na_plugin_load(class_name, protocol_name,
+            NA_PLUGIN_RANK_LISTED, na_plugin_dynamic, NA_PLUGIN_MAX);
+        (void) na_plugin_load(class_name, protocol_name, NA_PLUGIN_RANK_ANY,
+            na_plugin_dynamic + count, NA_PLUGIN_MAX - count);
 
         ret = na_plugin_get_protocol_info(
             na_plugin_dynamic, class_name, na_info, &dynamic_protocol_info);
@@ -690,11 +1396,13 @@ NA_Get_protocol_info(
 
     *na_protocol_info_p = na_protocol_info;
 
+    free(class_name);
     na_info_free(na_info);
 
     return NA_SUCCESS;
 
 error:
+    free(class_name);
     na_info_free(na_info);
     while (na_protocol_info != NULL) {
         struct na_protocol_info *tmp = na_protocol_info;
@@ -716,6 +1424,114 @@ NA_Free_protocol_info(struct na_protocol_info *na_protocol_info)
     }
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Select_protocol(const char *info_string,
+    const struct na_select_info *select_info, char *buf, size_t buf_size)
+{
+    struct na_protocol_info *protocol_infos = NULL, *protocol_info;
+    const char *cache_path = NULL, *wildcard;
+    char candidate[NA_SELECT_MAX_STRING], class_name[NA_SELECT_MAX_STRING];
+    unsigned int iterations = NA_SELECT_ITERATIONS;
+    size_t reg_size = NA_SELECT_REG_SIZE;
+    double best_score = -1.;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(cls, info_string == NULL, error, ret,
+        NA_INVALID_ARG, "NULL info string");
+    NA_CHECK_SUBSYS_ERROR(cls, strlen(info_string) >= NA_SELECT_MAX_STRING,
+        error, ret, NA_OVERFLOW, "Info string is too long");
+    NA_CHECK_SUBSYS_ERROR(
+        cls, buf == NULL, error, ret, NA_INVALID_ARG, "NULL buffer");
+
+    if (select_info != NULL) {
+        cache_path = select_info->cache_path;
+        if (select_info->iterations > 0)
+            iterations = select_info->iterations;
+        if (select_info->reg_size > 0)
+            reg_size = select_info->reg_size;
+    }
+    if (cache_path == NULL)
+        cache_path = getenv("NA_SELECT_CACHE");
+
+    /* Reuse recorded selection */
+    if (cache_path != NULL &&
+        na_select_cache_get(cache_path, info_string, buf, buf_size)) {
+        NA_LOG_SUBSYS_DEBUG(cls, "Using recorded selection for %s (%s)",
+            info_string, buf);
+        return NA_SUCCESS;
+    }
+
+    /* "<plugin>+*" matches all protocols of that plugin */
+    wildcard = strstr(info_string, NA_CLASS_DELIMITER "*");
+    if (wildcard != NULL) {
+        snprintf(class_name, sizeof(class_name), "%.*s",
+            (int) (wildcard - info_string), info_string);
+        ret = NA_Get_protocol_info(NULL, &protocol_infos);
+    } else {
+        class_name[0] = '\0';
+        ret = NA_Get_protocol_info(info_string, &protocol_infos);
+    }
+    NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not get protocol info");
+
+    for (protocol_info = protocol_infos; protocol_info != NULL;
+         protocol_info = protocol_info->next) {
+        double latency = 0., reg_cost = 0., score;
+        int rc;
+
+        if (class_name[0] != '\0' &&
+            strcmp(protocol_info->class_name, class_name) != 0)
+            continue;
+
+        if (protocol_info->device_name != NULL &&
+            protocol_info->device_name[0] != '\0')
+            rc = snprintf(candidate, sizeof(candidate), "%s+%s://%s",
+                protocol_info->class_name, protocol_info->protocol_name,
+                protocol_info->device_name);
+        else
+            rc = snprintf(candidate, sizeof(candidate), "%s+%s",
+                protocol_info->class_name, protocol_info->protocol_name);
+        if (rc < 0 || rc >= (int) sizeof(candidate))
+            continue;
+
+        ret = na_select_measure(
+            candidate, iterations, reg_size, &latency, &reg_cost);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_SUBSYS_DEBUG(cls, "Skipping %s (%s)", candidate,
+                NA_Error_to_string(ret));
+            continue;
+        }
+
+        /* Registrations typically accompany each RPC that carries bulk data,
+         * weigh them the same as a round-trip */
+        score = latency + reg_cost;
+        NA_LOG_SUBSYS_DEBUG(cls,
+            "%s: latency %.2f us, registration %.2f us, score %.2f", candidate,
+            latency, reg_cost, score);
+        if (best_score < 0. || score < best_score) {
+            NA_CHECK_SUBSYS_ERROR(cls, strlen(candidate) >= buf_size, error,
+                ret, NA_OVERFLOW, "Buffer too small to hold %s", candidate);
+            strcpy(buf, candidate);
+            best_score = score;
+        }
+    }
+    NA_CHECK_SUBSYS_ERROR(cls, best_score < 0., error, ret, NA_PROTONOSUPPORT,
+        "No usable protocol found for %s", info_string);
+
+    NA_LOG_SUBSYS_DEBUG(cls, "Selected %s for %s", buf, info_string);
+    if (cache_path != NULL)
+        na_select_cache_put(cache_path, info_string, buf);
+
+    NA_Free_protocol_info(protocol_infos);
+
+    return NA_SUCCESS;
+
+error:
+    NA_Free_protocol_info(protocol_infos);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_class_t *
 NA_Initialize(const char *info_string, bool listen)
@@ -728,9 +1544,9 @@ na_class_t *
 NA_Initialize_opt(const char *info_string, bool listen,
     const struct na_init_info *na_init_info)
 {
-    /* Keep as latest version until info struct is modified */
-    return NA_Initialize_opt2(info_string, listen,
-        NA_VERSION(NA_VERSION_MAJOR, NA_VERSION_MINOR), na_init_info);
+    /* Info struct was last modified in 4.1 */
+    return NA_Initialize_opt2(
+        info_string, listen, NA_VERSION(4, 0), na_init_info);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -739,6 +1555,7 @@ NA_Initialize_opt2(const char *info_string, bool listen, unsigned int version,
     const struct na_init_info *na_init_info)
 {
     struct na_private_class *na_private_class = NULL;
+    struct na_init_info na_init_info_compat;
     char *class_name = NULL;
     struct na_info *na_info = NULL;
     const struct na_class_ops *ops = NULL;
@@ -762,8 +1579,16 @@ NA_Initialize_opt2(const char *info_string, bool listen, unsigned int version,
         NA_LOG_SUBSYS_DEBUG(cls, "Init info version used: v%d.%d",
             NA_MAJOR(version), NA_MINOR(version));
 
+        /* Older versions have fewer fields, copy them and keep defaults */
+        if (version < NA_VERSION(4, 1)) {
+            na_init_info_dup_4_0(&na_init_info_compat,
+                (const struct na_init_info_4_0 *) na_init_info);
+            na_init_info = &na_init_info_compat;
+        }
+
         na_info->na_init_info = na_init_info;
         na_private_class->na_class.progress_mode = na_init_info->progress_mode;
+        na_private_class->mem_budget = na_init_info->mem_budget;
     }
 
     /* Print debug info */
@@ -777,23 +1602,28 @@ NA_Initialize_opt2(const char *info_string, bool listen, unsigned int version,
 
 #ifdef NA_HAS_DYNAMIC_PLUGINS
     if (ops == NULL) {
-        const struct na_class_ops *na_plugin_dynamic[NA_PLUGIN_MAX] = {NULL};
-        int i;
+        int rank;
 
         NA_CHECK_SUBSYS_ERROR(cls, na_plugin_dynamic_g == NULL, error, ret,
             NA_NOENTRY, "No dynamic plugins were found");
 
-        for (i = 0, ops = na_plugin_dynamic_g[0].ops;
-             i < NA_PLUGIN_MAX && ops != NULL;
-             i++, ops = na_plugin_dynamic_g[i].ops)
-            na_plugin_dynamic[i] = ops;
-
-        /* Check list of dynamic plugins */
-        ret = na_plugin_check_protocol(
-            (const struct na_class_ops *const *) na_plugin_dynamic, class_name,
-            na_info->protocol_name, &ops);
-        NA_CHECK_SUBSYS_NA_ERROR(
-            cls, error, ret, "Could not check dynamic plugins");
+        /* Check list of dynamic plugins, loading plugins that list the
+         * requested protocol first and others only if none accepted it */
+        for (rank = NA_PLUGIN_RANK_LISTED; rank > NA_PLUGIN_RANK_NONE && !ops;
+             rank--) {
+            const struct na_class_ops *na_plugin_dynamic[NA_PLUGIN_MAX + 1] =
+                {NULL};
+
+            if (na_plugin_load(class_name, na_info->protocol_name, rank,
+                    na_plugin_dynamic, NA_PLUGIN_MAX) == 0)
+                continue;
+
+            ret = na_plugin_check_protocol(
+                (const struct na_class_ops *const *) na_plugin_dynamic,
+                class_name, na_info->protocol_name, &ops);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                cls, error, ret, "Could not check dynamic plugins");
+        }
 #endif
 
         NA_CHECK_SUBSYS_ERROR(fatal, ops == NULL, error, ret, NA_PROTONOSUPPORT,
@@ -885,6 +1715,16 @@ NA_Has_opt_feature(na_class_t *na_class, unsigned long flags)
         return false;
 }
 
+/*---------------------------------------------------------------------------*/
+int
+NA_Get_numa_node(na_class_t *na_class)
+{
+    if (na_class && na_class->ops && na_class->ops->get_numa_node)
+        return na_class->ops->get_numa_node(na_class);
+    else
+        return -1;
+}
+
 /*---------------------------------------------------------------------------*/
 void
 NA_Set_log_level(const char *level)
@@ -909,7 +1749,7 @@ NA_Context_create_id(na_class_t *na_class, uint8_t id)
     bool mutex_init = false, cond_init = false;
 #endif
     struct na_completion_queue *backfill_queue = NULL;
-    bool lock_init = false;
+    bool lock_init = false, pool_lock_init = false;
     na_return_t ret;
     int rc;
 
@@ -946,6 +1786,13 @@ NA_Context_create_id(na_class_t *na_class, uint8_t id)
         ctx, rc != HG_UTIL_SUCCESS, error, "hg_thread_spin_init() failed");
     lock_init = true;
 
+    /* Initialize op ID pool */
+    na_private_context->op_pool.count = 0;
+    rc = hg_thread_spin_init(&na_private_context->op_pool.lock);
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        ctx, rc != HG_UTIL_SUCCESS, error, "hg_thread_spin_init() failed");
+    pool_lock_init = true;
+
     /* Initialize completion queue */
     na_private_context->completion_queue =
         hg_atomic_queue_alloc(NA_ATOMIC_QUEUE_SIZE);
@@ -972,12 +1819,66 @@ error:
 #endif
         if (lock_init)
             (void) hg_thread_spin_destroy(&backfill_queue->lock);
+        if (pool_lock_init)
+            (void) hg_thread_spin_destroy(&na_private_context->op_pool.lock);
         hg_atomic_queue_free(na_private_context->completion_queue);
         free(na_private_context);
     }
     return NULL;
 }
 
+/*---------------------------------------------------------------------------*/
+na_context_t *
+NA_Context_create_opt(
+    na_class_t *na_class, uint8_t id, const struct na_context_info *info)
+{
+    struct na_private_context *na_private_context;
+    hg_cpu_set_t cpu_mask, prev_mask;
+    bool bound = false;
+    na_context_t *context;
+
+    if (info != NULL && (info->cpus != NULL || info->numa_node >= 0)) {
+        int numa_node = NA_Get_numa_node(na_class);
+
+        NA_CHECK_SUBSYS_WARNING(ctx,
+            numa_node >= 0 && info->numa_node >= 0 &&
+                numa_node != info->numa_node,
+            "Context placed on NUMA node %d but network device is on node %d",
+            info->numa_node, numa_node);
+
+        /* Bind calling thread so that context memory gets allocated locally
+         * on first touch */
+        if (hg_thread_cpu_mask_init(info->cpus, info->cpu_count,
+                info->numa_node, &cpu_mask) != HG_UTIL_SUCCESS)
+            NA_LOG_SUBSYS_WARNING(ctx, "Could not build context CPU mask");
+        else if (hg_thread_getaffinity(hg_thread_self(), &prev_mask) !=
+                     HG_UTIL_SUCCESS ||
+                 hg_thread_setaffinity(hg_thread_self(), &cpu_mask) !=
+                     HG_UTIL_SUCCESS)
+            NA_LOG_SUBSYS_WARNING(ctx, "Could not bind context to its CPUs");
+        else
+            bound = true;
+    }
+
+    context = NA_Context_create_id(na_class, id);
+
+    if (bound) {
+        int rc = hg_thread_setaffinity(hg_thread_self(), &prev_mask);
+        NA_CHECK_SUBSYS_WARNING(ctx, rc != HG_UTIL_SUCCESS,
+            "Could not restore calling thread affinity");
+    }
+    if (context == NULL)
+        return NULL;
+
+    if (bound) {
+        na_private_context = (struct na_private_context *) context;
+        na_private_context->cpu_mask = cpu_mask;
+        na_private_context->bound = true;
+    }
+
+    return context;
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_Context_destroy(na_class_t *na_class, na_context_t *context)
@@ -988,6 +1889,7 @@ NA_Context_destroy(na_class_t *na_class, na_context_t *context)
     struct na_progress_multi *progress_multi = NULL;
 #endif
     struct na_completion_queue *backfill_queue = NULL;
+    struct na_op_pool *op_pool = NULL;
     bool empty;
     na_return_t ret;
 
@@ -997,6 +1899,9 @@ NA_Context_destroy(na_class_t *na_class, na_context_t *context)
     if (na_private_context == NULL)
         return NA_SUCCESS;
 
+    NA_CHECK_SUBSYS_ERROR(ctx, na_private_context->engine != NULL,
+        error, ret, NA_BUSY, "Progress thread must be stopped first");
+
 #ifdef NA_HAS_MULTI_PROGRESS
     /* Check that we are no longer progressing */
     progress_multi = &na_private_context->progress_multi;
@@ -1018,6 +1923,11 @@ NA_Context_destroy(na_class_t *na_class, na_context_t *context)
         "Completion queue should be empty (%u entries remaining)",
         hg_atomic_queue_count(na_private_context->completion_queue));
 
+    /* Release cached op IDs */
+    op_pool = &na_private_context->op_pool;
+    while (op_pool->count > 0)
+        NA_Op_destroy(na_class, op_pool->ops[--op_pool->count]);
+
     /* Destroy NA plugin context */
     if (na_class->ops && na_class->ops->context_destroy) {
         ret = na_class->ops->context_destroy(
@@ -1028,6 +1938,7 @@ NA_Context_destroy(na_class_t *na_class, na_context_t *context)
 
     hg_atomic_queue_free(na_private_context->completion_queue);
     (void) hg_thread_spin_destroy(&backfill_queue->lock);
+    (void) hg_thread_spin_destroy(&op_pool->lock);
 #ifdef NA_HAS_MULTI_PROGRESS
     (void) hg_thread_mutex_destroy(&progress_multi->mutex);
     (void) hg_thread_cond_destroy(&progress_multi->cond);
@@ -1037,51 +1948,281 @@ NA_Context_destroy(na_class_t *na_class, na_context_t *context)
     return NA_SUCCESS;
 
 error:
-    return ret;
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Context_progress_start(na_class_t *na_class, na_context_t *context,
+    const struct na_progress_info *info)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+    struct na_progress_engine *engine = NULL;
+    unsigned int queue_size = (info != NULL && info->queue_size > 0)
+                                  ? info->queue_size
+                                  : NA_SUBMIT_QUEUE_SIZE;
+    unsigned int i;
+    na_return_t ret;
+    int rc;
+
+    NA_CHECK_SUBSYS_ERROR(
+        ctx, na_class == NULL, error, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, error, ret, NA_INVALID_ARG, "NULL context");
+    NA_CHECK_SUBSYS_ERROR(ctx, na_private_context->engine != NULL,
+        error, ret, NA_BUSY, "Progress thread already started");
+    NA_CHECK_SUBSYS_ERROR(ctx, queue_size < 2 || !powerof2(queue_size), error,
+        ret, NA_INVALID_ARG, "Queue size (%u) must be a power of 2",
+        queue_size);
+
+    engine = (struct na_progress_engine *) calloc(1, sizeof(*engine));
+    NA_CHECK_SUBSYS_ERROR(ctx, engine == NULL, error, ret, NA_NOMEM,
+        "Could not allocate progress engine");
+    engine->na_class = na_class;
+    engine->context = context;
+    engine->progress_timeout = (info != NULL) ? info->progress_timeout : 0;
+    hg_atomic_init32(&engine->stopping, 0);
+    hg_atomic_init32(&engine->failed, 0);
+
+    /* Queues can hold queue_size - 1 entries */
+    engine->submit_queue = hg_atomic_queue_alloc(queue_size);
+    NA_CHECK_SUBSYS_ERROR(ctx, engine->submit_queue == NULL, error, ret,
+        NA_NOMEM, "Could not allocate submission queue");
+    engine->free_queue = hg_atomic_queue_alloc(queue_size);
+    NA_CHECK_SUBSYS_ERROR(ctx, engine->free_queue == NULL, error, ret,
+        NA_NOMEM, "Could not allocate submission queue");
+    engine->entries = (struct na_submit_entry *) calloc(
+        queue_size - 1, sizeof(*engine->entries));
+    NA_CHECK_SUBSYS_ERROR(ctx, engine->entries == NULL, error, ret, NA_NOMEM,
+        "Could not allocate submission entries");
+    for (i = 0; i < queue_size - 1; i++) {
+        engine->entries[i].engine = engine;
+        (void) hg_atomic_queue_push(engine->free_queue, &engine->entries[i]);
+    }
+
+    rc = hg_thread_create(&engine->thread, na_progress_thread, engine);
+    NA_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+        "Could not create progress thread");
+    engine->running = true;
+
+    if (info != NULL && info->cpu_id >= 0) {
+#if defined(_WIN32) || defined(__APPLE__)
+        NA_LOG_SUBSYS_WARNING(ctx, "Progress thread pinning not supported");
+#else
+        hg_cpu_set_t cpu_set;
+
+        CPU_ZERO(&cpu_set);
+        CPU_SET(info->cpu_id, &cpu_set);
+        rc = hg_thread_setaffinity(engine->thread, &cpu_set);
+        NA_CHECK_SUBSYS_WARNING(ctx, rc != HG_UTIL_SUCCESS,
+            "Could not pin progress thread to CPU %d", info->cpu_id);
+#endif
+    } else if (na_private_context->bound) {
+        rc = hg_thread_setaffinity(
+            engine->thread, &na_private_context->cpu_mask);
+        NA_CHECK_SUBSYS_WARNING(ctx, rc != HG_UTIL_SUCCESS,
+            "Could not bind progress thread to context CPUs");
+    }
+
+    na_private_context->engine = engine;
+
+    return NA_SUCCESS;
+
+error:
+    if (engine != NULL)
+        na_progress_engine_free(engine);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Context_progress_stop(na_class_t *na_class, na_context_t *context)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+    struct na_progress_engine *engine;
+    na_return_t ret;
+    int rc;
+
+    NA_CHECK_SUBSYS_ERROR(
+        ctx, na_class == NULL, error, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(
+        ctx, context == NULL, error, ret, NA_INVALID_ARG, "NULL context");
+    engine = na_private_context->engine;
+    NA_CHECK_SUBSYS_ERROR(ctx, engine == NULL, error, ret, NA_PROTOCOL_ERROR,
+        "Progress thread was not started");
+
+    if (engine->running) {
+        hg_atomic_set32(&engine->stopping, 1);
+        rc = hg_thread_join(engine->thread);
+        NA_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret,
+            NA_PROTOCOL_ERROR, "Could not join progress thread");
+        engine->running = false;
+    }
+
+    /* Post remaining submissions from this thread */
+    while (na_progress_submit_drain(engine))
+        continue;
+
+    NA_CHECK_SUBSYS_ERROR(ctx, hg_atomic_get32(&engine->failed) > 0, error,
+        ret, NA_BUSY, "%d failed submission(s) must be triggered first",
+        hg_atomic_get32(&engine->failed));
+
+    na_private_context->engine = NULL;
+    na_progress_engine_free(engine);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Submit(na_context_t *context, const struct na_submit_info *info)
+{
+    struct na_progress_engine *engine;
+    struct na_submit_entry *entry;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        op, context == NULL, error, ret, NA_INVALID_ARG, "NULL context");
+    NA_CHECK_SUBSYS_ERROR(
+        op, info == NULL, error, ret, NA_INVALID_ARG, "NULL submit info");
+    engine = ((struct na_private_context *) context)->engine;
+    NA_CHECK_SUBSYS_ERROR(op, engine == NULL || !engine->running, error, ret,
+        NA_PROTOCOL_ERROR, "No progress thread running on context");
+
+    entry = (struct na_submit_entry *) hg_atomic_queue_pop_mc(
+        engine->free_queue);
+    if (entry == NULL)
+        return NA_AGAIN;
+
+    entry->info = *info;
+    (void) hg_atomic_queue_push(engine->submit_queue, entry);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_op_id_t *
+NA_Op_create(na_class_t *na_class, unsigned long flags)
+{
+    na_op_id_t *ret;
+
+    NA_CHECK_SUBSYS_ERROR_NORET(op, na_class == NULL, error, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR_NORET(op,
+        na_class->ops == NULL || na_class->ops->op_create == NULL, error,
+        "op_create plugin callback is not defined");
+
+    ret = na_class->ops->op_create(na_class, flags);
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        op, ret == NULL, error, "Could not create OP ID");
+
+    NA_LOG_SUBSYS_DEBUG(op, "Created new OP ID (%p)", (void *) ret);
+
+    return ret;
+
+error:
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+NA_Op_destroy(na_class_t *na_class, na_op_id_t *op_id)
+{
+    NA_CHECK_SUBSYS_ERROR_NORET(op, na_class == NULL, error, "NULL NA class");
+
+    if (op_id == NULL)
+        return;
+
+    NA_CHECK_SUBSYS_ERROR_NORET(op,
+        na_class->ops == NULL || na_class->ops->op_destroy == NULL, error,
+        "op_destroy plugin callback is not defined");
+
+    NA_LOG_SUBSYS_DEBUG(op, "Destroying OP ID (%p)", (void *) op_id);
+
+    na_class->ops->op_destroy(na_class, op_id);
+
+error:
+    return;
 }
 
 /*---------------------------------------------------------------------------*/
 na_op_id_t *
-NA_Op_create(na_class_t *na_class, unsigned long flags)
+NA_Op_get(na_class_t *na_class, na_context_t *context)
 {
-    na_op_id_t *ret;
+    struct na_op_pool *op_pool;
+    na_op_id_t *op_id = NULL;
 
     NA_CHECK_SUBSYS_ERROR_NORET(op, na_class == NULL, error, "NULL NA class");
-    NA_CHECK_SUBSYS_ERROR_NORET(op,
-        na_class->ops == NULL || na_class->ops->op_create == NULL, error,
-        "op_create plugin callback is not defined");
+    NA_CHECK_SUBSYS_ERROR_NORET(op, context == NULL, error, "NULL context");
 
-    ret = na_class->ops->op_create(na_class, flags);
-    NA_CHECK_SUBSYS_ERROR_NORET(
-        op, ret == NULL, error, "Could not create OP ID");
+    op_pool = &((struct na_private_context *) context)->op_pool;
+    hg_thread_spin_lock(&op_pool->lock);
+    if (op_pool->count > 0)
+        op_id = op_pool->ops[--op_pool->count];
+    hg_thread_spin_unlock(&op_pool->lock);
 
-    NA_LOG_SUBSYS_DEBUG(op, "Created new OP ID (%p)", (void *) ret);
+    if (op_id == NULL)
+        return NA_Op_create(na_class, NA_OP_SINGLE);
 
-    return ret;
+    NA_LOG_SUBSYS_DEBUG(op, "Reusing OP ID (%p)", (void *) op_id);
+
+    return op_id;
 
 error:
     return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
-void
-NA_Op_destroy(na_class_t *na_class, na_op_id_t *op_id)
+na_return_t
+NA_Op_put(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id)
 {
-    NA_CHECK_SUBSYS_ERROR_NORET(op, na_class == NULL, error, "NULL NA class");
+    struct na_op_pool *op_pool;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        op, na_class == NULL, error, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(
+        op, context == NULL, error, ret, NA_INVALID_ARG, "NULL context");
 
     if (op_id == NULL)
-        return;
+        return NA_SUCCESS;
 
-    NA_CHECK_SUBSYS_ERROR_NORET(op,
-        na_class->ops == NULL || na_class->ops->op_destroy == NULL, error,
-        "op_destroy plugin callback is not defined");
+    /* Let the plugin check and clear per-operation state, op IDs that cannot
+     * be reset are destroyed rather than cached */
+    if (na_class->ops->op_reset != NULL) {
+        ret = na_class->ops->op_reset(na_class, op_id);
+        NA_CHECK_SUBSYS_ERROR(op, ret == NA_BUSY, error, ret, NA_BUSY,
+            "OP ID (%p) has not completed", (void *) op_id);
+        if (ret != NA_SUCCESS) {
+            NA_Op_destroy(na_class, op_id);
+            return NA_SUCCESS;
+        }
+    }
 
-    NA_LOG_SUBSYS_DEBUG(op, "Destroying OP ID (%p)", (void *) op_id);
+    op_pool = &((struct na_private_context *) context)->op_pool;
+    hg_thread_spin_lock(&op_pool->lock);
+    if (op_pool->count < NA_OP_POOL_SIZE) {
+        op_pool->ops[op_pool->count++] = op_id;
+        op_id = NULL;
+    }
+    hg_thread_spin_unlock(&op_pool->lock);
 
-    na_class->ops->op_destroy(na_class, op_id);
+    /* Pool is full */
+    if (op_id != NULL)
+        NA_Op_destroy(na_class, op_id);
+
+    return NA_SUCCESS;
 
 error:
-    return;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1122,6 +2263,107 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Addr_lookup_batch(na_class_t *na_class, const char *const *names,
+    size_t count, na_addr_t **addrs)
+{
+    const char **short_names = NULL;
+    size_t i;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        addr, na_class == NULL, error, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(addr, count > 0 && names == NULL, error, ret,
+        NA_INVALID_ARG, "Lookup names are NULL");
+    NA_CHECK_SUBSYS_ERROR(addr, count > 0 && addrs == NULL, error, ret,
+        NA_INVALID_ARG, "NULL array of NA addrs");
+
+    NA_CHECK_SUBSYS_ERROR(addr,
+        na_class->ops == NULL || na_class->ops->addr_lookup == NULL, error, ret,
+        NA_PROTOCOL_ERROR, "addr_lookup plugin callback is not defined");
+
+    if (count == 0)
+        return NA_SUCCESS;
+
+    for (i = 0; i < count; i++)
+        addrs[i] = NULL;
+
+    /* Fallback to individual lookups */
+    if (na_class->ops->addr_lookup_batch == NULL) {
+        for (i = 0; i < count; i++) {
+            ret = NA_Addr_lookup(na_class, names[i], &addrs[i]);
+            NA_CHECK_SUBSYS_NA_ERROR(addr, release, ret,
+                "Could not lookup address %zu of batch of %zu", i, count);
+        }
+        return NA_SUCCESS;
+    }
+
+    short_names = (const char **) malloc(count * sizeof(*short_names));
+    NA_CHECK_SUBSYS_ERROR(addr, short_names == NULL, error, ret, NA_NOMEM,
+        "Could not allocate array of %zu names", count);
+
+    /* Remove NA class name from names (see NA_Addr_lookup()) */
+    for (i = 0; i < count; i++) {
+        const char *short_name;
+
+        NA_CHECK_SUBSYS_ERROR(addr, names[i] == NULL, error, ret,
+            NA_INVALID_ARG, "Lookup name %zu is NULL", i);
+        short_name = strstr(names[i], NA_CLASS_DELIMITER);
+        short_names[i] = (short_name == NULL)
+                             ? names[i]
+                             : short_name + NA_CLASS_DELIMITER_LEN;
+    }
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Looking up batch of %zu addrs", count);
+
+    ret = na_class->ops->addr_lookup_batch(
+        na_class, short_names, count, addrs);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, error, ret, "Could not lookup batch of %zu addrs", count);
+
+    free(short_names);
+
+    return NA_SUCCESS;
+
+release:
+    while (i-- > 0) {
+        NA_Addr_free(na_class, addrs[i]);
+        addrs[i] = NULL;
+    }
+error:
+    free(short_names);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Addr_warm(na_class_t *na_class, na_addr_t *const *addrs, size_t count)
+{
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        addr, na_class == NULL, error, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(addr, count > 0 && addrs == NULL, error, ret,
+        NA_INVALID_ARG, "NULL array of NA addrs");
+
+    /* Nothing to warm up */
+    if (count == 0 || na_class->ops == NULL || na_class->ops->addr_warm == NULL)
+        return NA_SUCCESS;
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Warming up %zu addrs", count);
+
+    ret = na_class->ops->addr_warm(na_class, addrs, count);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, error, ret, "Could not warm up %zu addrs", count);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 void
 NA_Addr_free(na_class_t *na_class, na_addr_t *addr)
@@ -1166,6 +2408,27 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Addr_set_error_callback(
+    na_class_t *na_class, na_addr_error_cb_t callback, void *arg)
+{
+    struct na_private_class *na_private_class =
+        (struct na_private_class *) na_class;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        addr, na_class == NULL, error, ret, NA_INVALID_ARG, "NULL NA class");
+
+    na_private_class->addr_error_arg = arg;
+    na_private_class->addr_error_cb = callback;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_Addr_self(na_class_t *na_class, na_addr_t **addr_p)
@@ -1393,13 +2656,23 @@ NA_Msg_buf_alloc(na_class_t *na_class, size_t buf_size, unsigned long flags,
         NA_CHECK_SUBSYS_ERROR_NORET(msg, ret == NULL, error,
             "Could not allocate buffer of size %zu", buf_size);
     } else {
+        struct hg_mem_budget *mem_budget =
+            ((struct na_private_class *) na_class)->mem_budget;
         size_t page_size = (size_t) hg_mem_get_page_size();
 
+        NA_CHECK_SUBSYS_ERROR_NORET(msg,
+            !hg_mem_budget_acquire(mem_budget, buf_size), error,
+            "Memory budget exhausted, could not allocate buffer of size %zu",
+            buf_size);
         ret = hg_mem_aligned_alloc(page_size, buf_size);
-        NA_CHECK_SUBSYS_ERROR_NORET(msg, ret == NULL, error,
-            "Could not allocate buffer of size %zu", buf_size);
+        if (ret == NULL) {
+            hg_mem_budget_release(mem_budget, buf_size);
+            NA_GOTO_SUBSYS_ERROR_NORET(
+                msg, error, "Could not allocate buffer of size %zu", buf_size);
+        }
         memset(ret, 0, buf_size);
-        *plugin_data_p = (void *) 1; /* Sanity check on free */
+        /* Keep size to return it to the budget on free */
+        *plugin_data_p = (void *) (uintptr_t) buf_size;
     }
 
     NA_LOG_SUBSYS_DEBUG(msg,
@@ -1428,8 +2701,11 @@ NA_Msg_buf_free(na_class_t *na_class, void *buf, void *plugin_data)
         na_class->ops->msg_buf_free(na_class, buf, plugin_data);
     } else {
         NA_CHECK_SUBSYS_WARNING(
-            msg, plugin_data != (void *) 1, "Invalid plugin data value");
+            msg, plugin_data == NULL, "Invalid plugin data value");
         hg_mem_aligned_free(buf);
+        hg_mem_budget_release(
+            ((struct na_private_class *) na_class)->mem_budget,
+            (size_t) (uintptr_t) plugin_data);
     }
 
 error:
@@ -1465,6 +2741,114 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Msg_send_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+    size_t count, size_t *posted_count_p)
+{
+    size_t posted_count = 0;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        msg, na_class == NULL, done, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(msg,
+        cb_type != NA_CB_SEND_UNEXPECTED && cb_type != NA_CB_SEND_EXPECTED,
+        done, ret, NA_INVALID_ARG, "Invalid send type (%s)",
+        na_cb_type_to_string(cb_type));
+    NA_CHECK_SUBSYS_ERROR(msg, count > 0 && send_infos == NULL, done, ret,
+        NA_INVALID_ARG, "NULL send infos");
+
+    if (count == 0) {
+        ret = NA_SUCCESS;
+        goto done;
+    }
+
+    if (na_class->ops->msg_send_batch) {
+        ret = na_class->ops->msg_send_batch(
+            na_class, context, cb_type, send_infos, count, &posted_count);
+        NA_CHECK_SUBSYS_NA_ERROR(msg, done, ret,
+            "Could not post batch of %zu sends (%zu posted)", count,
+            posted_count);
+        goto done;
+    }
+
+    /* Fallback to individual sends */
+    for (ret = NA_SUCCESS; posted_count < count; posted_count++) {
+        const struct na_msg_send_info *send_info = &send_infos[posted_count];
+
+        ret = (cb_type == NA_CB_SEND_UNEXPECTED)
+                  ? na_class->ops->msg_send_unexpected(na_class, context,
+                        send_info->callback, send_info->arg, send_info->buf,
+                        send_info->buf_size, send_info->plugin_data,
+                        send_info->dest_addr, send_info->dest_id,
+                        send_info->tag, send_info->op_id)
+                  : na_class->ops->msg_send_expected(na_class, context,
+                        send_info->callback, send_info->arg, send_info->buf,
+                        send_info->buf_size, send_info->plugin_data,
+                        send_info->dest_addr, send_info->dest_id,
+                        send_info->tag, send_info->op_id);
+        NA_CHECK_SUBSYS_NA_ERROR(msg, done, ret,
+            "Could not post send %zu of batch of %zu", posted_count, count);
+    }
+
+done:
+    if (posted_count_p != NULL)
+        *posted_count_p = posted_count;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Rma_batch(na_class_t *na_class, na_context_t *context, na_cb_type_t cb_type,
+    na_cb_t callback, void *arg, const struct na_rma_segment *segments,
+    size_t count, na_addr_t *remote_addr, uint8_t remote_id,
+    na_op_id_t *op_id)
+{
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(
+        rma, na_class == NULL, error, ret, NA_INVALID_ARG, "NULL NA class");
+    NA_CHECK_SUBSYS_ERROR(rma, cb_type != NA_CB_PUT && cb_type != NA_CB_GET,
+        error, ret, NA_INVALID_ARG, "Invalid RMA type (%s)",
+        na_cb_type_to_string(cb_type));
+    NA_CHECK_SUBSYS_ERROR(rma, segments == NULL || count == 0, error, ret,
+        NA_INVALID_ARG, "NULL or empty RMA segments");
+    NA_CHECK_SUBSYS_ERROR(rma, na_class->ops->rma_batch == NULL, error, ret,
+        NA_OPNOTSUPPORTED, "Batched RMA operations not supported");
+
+    return na_class->ops->rma_batch(na_class, context, cb_type, callback, arg,
+        segments, count, remote_addr, remote_id, op_id);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Atomic_fetch_add(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, uint64_t operand,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id)
+{
+    return na_atomic(na_class, context, callback, arg, NA_ATOMIC_FETCH_ADD,
+        operand, 0, remote_mem_handle, remote_offset, remote_addr, remote_id,
+        op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Atomic_cas(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id)
+{
+    return na_atomic(na_class, context, callback, arg, NA_ATOMIC_CAS, operand,
+        compare, remote_mem_handle, remote_offset, remote_addr, remote_id,
+        op_id);
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_Msg_init_expected(na_class_t *na_class, void *buf, size_t buf_size)
@@ -1729,7 +3113,7 @@ NA_Poll_try_wait(na_class_t *na_class, na_context_t *context)
 
     /* Check plugin try wait */
     if (na_class->ops && na_class->ops->na_poll_try_wait)
-        return na_class->ops->na_poll_try_wait(na_class, context);
+        return NA_OPS(na_class)->na_poll_try_wait(na_class, context);
 
     NA_LOG_SUBSYS_DEBUG(
         poll_loop, "Safe to wait on context (%p)", (void *) context);
@@ -1820,7 +3204,7 @@ NA_Progress(
     }
 
     /* Try to make progress for remaining time */
-    ret = na_class->ops->progress(
+    ret = NA_OPS(na_class)->progress(
         na_class, context, (unsigned int) (remaining * 1000.0));
 
 unlock:
@@ -1858,7 +3242,7 @@ NA_Progress(
     }
 
     /* Try to make progress for remaining time */
-    return na_class->ops->progress(na_class, context, timeout_ms);
+    return NA_OPS(na_class)->progress(na_class, context, timeout_ms);
 }
 #endif
 
@@ -1876,49 +3260,74 @@ NA_Trigger(
         op, context == NULL, error, ret, NA_INVALID_ARG, "NULL context");
 
     while (count < max_count) {
-        struct na_cb_completion_data *completion_data_p = NULL;
-        struct na_cb_completion_data completion_data;
-
-        completion_data_p =
-            hg_atomic_queue_pop_mc(na_private_context->completion_queue);
-        if (completion_data_p == NULL) { /* Check backfill queue */
-            struct na_completion_queue *backfill_queue =
-                &na_private_context->backfill_queue;
-
-            if (hg_atomic_get32(&backfill_queue->count)) {
-                hg_thread_spin_lock(&backfill_queue->lock);
-                if (hg_atomic_get32(&backfill_queue->count)) {
-                    completion_data_p = HG_QUEUE_FIRST(&backfill_queue->queue);
-                    HG_QUEUE_POP_HEAD(&backfill_queue->queue, entry);
-                    hg_atomic_decr32(&backfill_queue->count);
-                }
-                hg_thread_spin_unlock(&backfill_queue->lock);
-                if (completion_data_p == NULL)
-                    continue; /* Give another chance to grab it */
-            } else
-                break; /* Completion queues are empty */
+        struct na_cb_completion_data *entries[NA_TRIGGER_BATCH_SIZE];
+        unsigned int i, n_entries;
+
+        n_entries = na_completion_pop(na_private_context, entries,
+            MIN(max_count - count, NA_TRIGGER_BATCH_SIZE));
+        if (n_entries == 0)
+            break; /* Completion queues are empty */
+
+        for (i = 0; i < n_entries; i++) {
+            struct na_cb_completion_data completion_data = *entries[i];
+
+            /* Execute plugin callback (free resources etc) first since actual
+             * callback will notify user that operation has completed.
+             * NB. If the NA operation ID is reused by the plugin for another
+             * operation we must be careful that resources are released BEFORE
+             * that operation ID gets re-used.
+             */
+            if (completion_data.plugin_callback)
+                completion_data.plugin_callback(
+                    completion_data.plugin_callback_args);
+
+            /* Execute callback */
+            if (completion_data.callback)
+                completion_data.callback(&completion_data.callback_info);
         }
+        count += n_entries;
+    }
+
+    if (actual_count)
+        *actual_count = count;
 
-        /* Completion data should be valid */
-        NA_CHECK_SUBSYS_ERROR(op, completion_data_p == NULL, error, ret,
-            NA_INVALID_ARG, "NULL completion data");
-        completion_data = *completion_data_p;
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
 
-        /* Execute plugin callback (free resources etc) first since actual
-         * callback will notify user that operation has completed.
-         * NB. If the NA operation ID is reused by the plugin for another
-         * operation we must be careful that resources are released BEFORE
-         * that operation ID gets re-used.
-         */
-        if (completion_data.plugin_callback)
-            completion_data.plugin_callback(
-                completion_data.plugin_callback_args);
+/*---------------------------------------------------------------------------*/
+na_return_t
+NA_Poll_completions(na_context_t *context, struct na_cb_info *cb_infos,
+    unsigned int max_count, unsigned int *actual_count)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+    unsigned int count = 0;
+    na_return_t ret;
 
-        /* Execute callback */
-        if (completion_data.callback)
-            completion_data.callback(&completion_data.callback_info);
+    NA_CHECK_SUBSYS_ERROR(
+        op, context == NULL, error, ret, NA_INVALID_ARG, "NULL context");
+    NA_CHECK_SUBSYS_ERROR(op, cb_infos == NULL && max_count > 0, error, ret,
+        NA_INVALID_ARG, "NULL callback info array");
 
-        count++;
+    while (count < max_count) {
+        struct na_cb_completion_data *entries[NA_TRIGGER_BATCH_SIZE];
+        unsigned int i, n_entries;
+
+        n_entries = na_completion_pop(na_private_context, entries,
+            MIN(max_count - count, NA_TRIGGER_BATCH_SIZE));
+        if (n_entries == 0)
+            break; /* Completion queues are empty */
+
+        for (i = 0; i < n_entries; i++) {
+            /* Copy info before the plugin callback releases the op ID */
+            cb_infos[count + i] = entries[i]->callback_info;
+            if (entries[i]->plugin_callback)
+                entries[i]->plugin_callback(entries[i]->plugin_callback_args);
+        }
+        count += n_entries;
     }
 
     if (actual_count)
@@ -1949,7 +3358,7 @@ NA_Cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id)
 
     NA_LOG_SUBSYS_DEBUG(op, "Canceling op ID (%p)", (void *) op_id);
 
-    ret = na_class->ops->cancel(na_class, context, op_id);
+    ret = NA_OPS(na_class)->cancel(na_class, context, op_id);
     NA_CHECK_SUBSYS_NA_ERROR(
         op, error, ret, "Could not cancel op ID (%p)", (void *) op_id);
 
@@ -2015,6 +3424,171 @@ na_protocol_info_free(struct na_protocol_info *entry)
     free(entry);
 }
 
+/*---------------------------------------------------------------------------*/
+void
+na_cb_addr_error(na_class_t *na_class, na_addr_t *addr, na_return_t error)
+{
+    struct na_private_class *na_private_class =
+        (struct na_private_class *) na_class;
+
+    if (na_private_class->addr_error_cb == NULL)
+        return;
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Peer error on address (%p): %s", (void *) addr,
+        NA_Error_to_string(error));
+
+    na_private_class->addr_error_cb(
+        na_class, addr, error, na_private_class->addr_error_arg);
+}
+
+/*---------------------------------------------------------------------------*/
+size_t
+na_varint_get_serialize_size(uint64_t value)
+{
+    size_t len = 1;
+
+    while (value >>= 7)
+        len++;
+
+    return len;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+na_varint_serialize(char **buf_p, size_t *buf_size_left_p, uint64_t value)
+{
+    uint8_t *ptr = (uint8_t *) *buf_p;
+    size_t len = na_varint_get_serialize_size(value);
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(mem, *buf_size_left_p < len, error, ret, NA_OVERFLOW,
+        "Buffer size too small (%zu)", *buf_size_left_p);
+
+    while (value >= 0x80) {
+        *ptr++ = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    *ptr = (uint8_t) value;
+
+    *buf_p += len;
+    *buf_size_left_p -= len;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+na_varint_deserialize(
+    const char **buf_p, size_t *buf_size_left_p, uint64_t *value_p)
+{
+    const uint8_t *ptr = (const uint8_t *) *buf_p;
+    uint64_t value = 0;
+    size_t i;
+
+    for (i = 0; i < *buf_size_left_p && i < 10; i++) {
+        value |= (uint64_t) (ptr[i] & 0x7f) << (7 * i);
+        if (!(ptr[i] & 0x80)) {
+            *value_p = value;
+            *buf_p += i + 1;
+            *buf_size_left_p -= i + 1;
+            return NA_SUCCESS;
+        }
+    }
+
+    NA_LOG_SUBSYS_ERROR(mem, "Could not decode varint (%zu bytes left)",
+        *buf_size_left_p);
+
+    return NA_OVERFLOW;
+}
+
+#ifndef _WIN32
+/*---------------------------------------------------------------------------*/
+size_t
+na_iov_get_serialize_size(const struct iovec *iov, unsigned long iovcnt)
+{
+    uint64_t prev_end = 0;
+    size_t ret = 0;
+    unsigned long i;
+
+    for (i = 0; i < iovcnt; i++) {
+        uint64_t base = (uint64_t) (uintptr_t) iov[i].iov_base;
+
+        ret +=
+            na_varint_get_serialize_size(NA_ZIGZAG_ENCODE(base - prev_end));
+        ret += na_varint_get_serialize_size((uint64_t) iov[i].iov_len);
+        prev_end = base + (uint64_t) iov[i].iov_len;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+na_iov_serialize(char **buf_p, size_t *buf_size_left_p,
+    const struct iovec *iov, unsigned long iovcnt)
+{
+    uint64_t prev_end = 0;
+    unsigned long i;
+    na_return_t ret;
+
+    for (i = 0; i < iovcnt; i++) {
+        uint64_t base = (uint64_t) (uintptr_t) iov[i].iov_base;
+
+        ret = na_varint_serialize(
+            buf_p, buf_size_left_p, NA_ZIGZAG_ENCODE(base - prev_end));
+        NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not encode base");
+
+        ret = na_varint_serialize(
+            buf_p, buf_size_left_p, (uint64_t) iov[i].iov_len);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not encode length");
+
+        prev_end = base + (uint64_t) iov[i].iov_len;
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+na_iov_deserialize(const char **buf_p, size_t *buf_size_left_p,
+    struct iovec *iov, unsigned long iovcnt, size_t *len_p)
+{
+    uint64_t prev_end = 0;
+    size_t len = 0;
+    unsigned long i;
+    na_return_t ret;
+
+    for (i = 0; i < iovcnt; i++) {
+        uint64_t delta, iov_len;
+
+        ret = na_varint_deserialize(buf_p, buf_size_left_p, &delta);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode base");
+
+        ret = na_varint_deserialize(buf_p, buf_size_left_p, &iov_len);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode length");
+
+        iov[i].iov_base =
+            (void *) (uintptr_t) (prev_end + NA_ZIGZAG_DECODE(delta));
+        iov[i].iov_len = (size_t) iov_len;
+        prev_end = (uint64_t) (uintptr_t) iov[i].iov_base + iov_len;
+        len += (size_t) iov_len;
+    }
+
+    *len_p = len;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 void
 na_cb_completion_add(
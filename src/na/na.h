@@ -62,6 +62,29 @@ NA_Get_protocol_info(
 NA_PUBLIC void
 NA_Free_protocol_info(struct na_protocol_info *na_protocol_info);
 
+/**
+ * Select the fastest protocol among the ones matching info_string, which can
+ * be of the form "<plugin+protocol>" or "<plugin>+*" (e.g., "ofi+*") to
+ * consider all the protocols and devices of a plugin. Each candidate is
+ * initialized and briefly measured: loopback round-trip latency of a small
+ * unexpected message and cost of registering memory. The candidate with the
+ * lowest sum of both is selected and its info string, which can be passed to
+ * NA_Initialize(), is copied to buf.
+ * If a cache path is set, the selection is recorded there and returned by
+ * later calls with the same info_string without measuring again.
+ *
+ * \param info_string [IN]      "<plugin+protocol>" or "<plugin>+*"
+ * \param select_info [IN]      optional selection parameters (NULL for
+ *                              defaults)
+ * \param buf [OUT]             buffer receiving the selected info string
+ * \param buf_size [IN]         buffer size
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Select_protocol(const char *info_string,
+    const struct na_select_info *select_info, char *buf, size_t buf_size);
+
 /**
  * Initialize the NA layer.
  * Must be finalized with NA_Finalize().
@@ -78,7 +101,9 @@ NA_Initialize(const char *info_string, bool listen) NA_WARN_UNUSED_RESULT;
 
 /**
  * Initialize the NA layer with options provided by init_info.
- * Must be finalized with NA_Finalize().
+ * Must be finalized with NA_Finalize(). Using this routine limits the info
+ * struct version to 4.0 version. It is recommended to use NA_Initialize_opt2()
+ * for NA versions >= 4.1.0.
  *
  * \param info_string [IN]      host address with port number (e.g.,
  *                              "tcp://localhost:3344" or
@@ -124,7 +149,8 @@ NA_Finalize(na_class_t *na_class);
  * While temporary resources (e.g., tmp files) are cleaned up on a call
  * to NA_Finalize(), this routine gives a chance to programs that terminate
  * abnormally to easily clean up those resources. This includes instances
- * from all plugins.
+ * from all plugins. Results of provider discovery that plugins cache across
+ * initializations are also released.
  */
 NA_PUBLIC void
 NA_Cleanup(void);
@@ -133,6 +159,7 @@ NA_Cleanup(void);
  * Check if a class supports a given set of optional features.
  * Currently supported flags:
  *   - NA_OPT_MULTI_RECV
+ *   - NA_OPT_ATOMIC
  *
  * \param na_class [IN/OUT]     pointer to NA class
  * \param flags [IN]            feature flags
@@ -142,6 +169,16 @@ NA_Cleanup(void);
 NA_PUBLIC bool
 NA_Has_opt_feature(na_class_t *na_class, unsigned long flags);
 
+/**
+ * Return the NUMA node of the network device used by the class.
+ *
+ * \param na_class [IN]         pointer to NA class
+ *
+ * \return NUMA node index or -1 if unknown
+ */
+NA_PUBLIC int
+NA_Get_numa_node(na_class_t *na_class);
+
 /**
  * Set the log level for NA. That setting is valid for all NA classes.
  *
@@ -202,6 +239,24 @@ NA_Context_create(na_class_t *na_class) NA_WARN_UNUSED_RESULT;
 NA_PUBLIC na_context_t *
 NA_Context_create_id(na_class_t *na_class, uint8_t id) NA_WARN_UNUSED_RESULT;
 
+/**
+ * Same as NA_Context_create_id() but place the context on a set of CPUs or a
+ * NUMA node. The calling thread is temporarily bound to these CPUs while the
+ * context is created, so that memory owned by the context (completion queues
+ * and plugin resources) is allocated locally. A progress thread started on
+ * the context with NA_Context_progress_start() is bound to these CPUs unless
+ * a specific CPU is requested.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param id [IN]               context ID
+ * \param info [IN]             optional context placement (NULL for none)
+ *
+ * \return Pointer to NA context or NULL in case of failure
+ */
+NA_PUBLIC na_context_t *
+NA_Context_create_opt(na_class_t *na_class, uint8_t id,
+    const struct na_context_info *info) NA_WARN_UNUSED_RESULT;
+
 /**
  * Destroy a context created by using NA_Context_create().
  *
@@ -213,6 +268,57 @@ NA_Context_create_id(na_class_t *na_class, uint8_t id) NA_WARN_UNUSED_RESULT;
 NA_PUBLIC na_return_t
 NA_Context_destroy(na_class_t *na_class, na_context_t *context);
 
+/**
+ * Start a progress thread on context. The thread makes progress on the context
+ * and posts operations submitted with NA_Submit(), so that application threads
+ * never call into the plugin to post operations. Completion callbacks are not
+ * executed by the progress thread and must still be triggered with
+ * NA_Trigger() or retrieved with NA_Poll_completions().
+ * The progress thread must be stopped with NA_Context_progress_stop() before
+ * the context is destroyed.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param info [IN]             optional progress thread info (NULL for
+ *                              defaults)
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Context_progress_start(na_class_t *na_class, na_context_t *context,
+    const struct na_progress_info *info);
+
+/**
+ * Stop the progress thread started with NA_Context_progress_start(). Pending
+ * submissions are posted by the calling thread before returning. If some
+ * submissions failed to be posted and their completion has not been
+ * triggered yet, NA_BUSY is returned and the call must be repeated after
+ * triggering them.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Context_progress_stop(na_class_t *na_class, na_context_t *context);
+
+/**
+ * Submit an operation to the progress thread of context, which will post it
+ * on behalf of the caller. Submission only copies the descriptor to a
+ * lock-free queue and may be called concurrently from any thread. If the
+ * operation cannot be posted by the progress thread, its callback is
+ * completed with the corresponding error.
+ *
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param info [IN]             pointer to operation descriptor
+ *
+ * \return NA_SUCCESS, NA_AGAIN if the submission queue is full or
+ *         corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Submit(na_context_t *context, const struct na_submit_info *info);
+
 /**
  * Allocate an operation ID for the higher level layer to save and
  * pass back to the NA layer rather than have the NA layer allocate operation
@@ -241,6 +347,36 @@ NA_Op_create(na_class_t *na_class, unsigned long flags);
 NA_PUBLIC void
 NA_Op_destroy(na_class_t *na_class, na_op_id_t *op_id);
 
+/**
+ * Get an operation ID from the context pool, creating a new one
+ * with NA_Op_create() if the pool is empty. This avoids an allocation per
+ * operation for users that directly post NA operations at a high rate.
+ * Operation IDs returned by NA_Op_get() cannot be used for operations that
+ * generate multiple events (see NA_OP_MULTI), which must still be created
+ * with NA_Op_create().
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ *
+ * \return valid pointer to operation ID or NULL
+ */
+NA_PUBLIC na_op_id_t *
+NA_Op_get(na_class_t *na_class, na_context_t *context);
+
+/**
+ * Return an operation ID obtained with NA_Op_get() to the context pool.
+ * The operation must have completed and its callback must have been
+ * triggered. If the pool is full, the operation ID is destroyed.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param op_id [IN]            pointer to operation ID
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Op_put(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id);
+
 /**
  * Lookup an addr from a peer address/name. Addresses need to be
  * freed by calling NA_Addr_free().
@@ -254,6 +390,42 @@ NA_Op_destroy(na_class_t *na_class, na_op_id_t *op_id);
 NA_PUBLIC na_return_t
 NA_Addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p);
 
+/**
+ * Lookup an array of addrs from peer addresses/names. Plugins that support it
+ * resolve all the addresses at once, other plugins look them up one by one.
+ * Each address needs to be freed by calling NA_Addr_free().
+ *
+ * If an error is returned, no address is returned and addrs is filled with
+ * NULL entries.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param names [IN]            array of lookup names
+ * \param count [IN]            number of names
+ * \param addrs [OUT]           array of count pointers to NA addresses
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Addr_lookup_batch(na_class_t *na_class, const char *const *names,
+    size_t count, na_addr_t **addrs);
+
+/**
+ * Start establishing transport state (connections, endpoints, address
+ * resolution) for an array of previously looked up addrs so that the first
+ * message sent to each of them does not pay for it. This is only a hint:
+ * plugins that have nothing to set up, or that do not support it, return
+ * NA_SUCCESS without doing anything.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param addrs [IN]            array of NA addresses
+ * \param count [IN]            number of addresses
+ *
+ * 
+eturn NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Addr_warm(na_class_t *na_class, na_addr_t *const *addrs, size_t count);
+
 /**
  * Free the addr from the list of peers.
  *
@@ -277,6 +449,24 @@ NA_Addr_free(na_class_t *na_class, na_addr_t *addr);
 NA_PUBLIC na_return_t
 NA_Addr_set_remove(na_class_t *na_class, na_addr_t *addr);
 
+/**
+ * Set callback that gets called when the plugin detects that a peer is no
+ * longer reachable (e.g., connection reset, unreachable host). The callback
+ * is made from the progress path of the context that detected the error and
+ * must not block; the address is only valid for the duration of the callback
+ * and must be duplicated with NA_Addr_dup() if it needs to be kept. Passing a
+ * NULL callback disables notifications.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Addr_set_error_callback(
+    na_class_t *na_class, na_addr_error_cb_t callback, void *arg);
+
 /**
  * Access self address.
  *
@@ -621,6 +811,31 @@ NA_Msg_send_expected(na_class_t *na_class, na_context_t *context,
     void *plugin_data, na_addr_t *dest_addr, uint8_t dest_id, na_tag_t tag,
     na_op_id_t *op_id);
 
+/**
+ * Post a batch of unexpected (cb_type set to NA_CB_SEND_UNEXPECTED) or
+ * expected (cb_type set to NA_CB_SEND_EXPECTED) message sends. Each entry of
+ * send_infos follows the same rules as NA_Msg_send_unexpected() and
+ * NA_Msg_send_expected() and completes with its own callback. Plugins that
+ * support it amortize notifications of the destination over consecutive
+ * entries sharing the same address, other plugins post entries one by one.
+ *
+ * If an error is returned, entries before send_infos[*posted_count_p] were
+ * posted and will complete normally, remaining entries were not posted.
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param cb_type [IN]          type of send
+ * \param send_infos [IN]       array of send descriptors
+ * \param count [IN]            number of send descriptors
+ * \param posted_count_p [OUT]  number of entries posted (may be NULL)
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Msg_send_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+    size_t count, size_t *posted_count_p);
+
 /**
  * Receive an expected message from source_addr. After completion, the user
  * callback is placed into the context completion queue and can be triggered
@@ -852,6 +1067,105 @@ NA_Get(na_class_t *na_class, na_context_t *context, na_cb_t callback, void *arg,
     size_t data_size, na_addr_t *remote_addr, uint8_t remote_id,
     na_op_id_t *op_id);
 
+/**
+ * Get the maximum number of contiguous pieces that a single call to
+ * NA_Rma_batch() can transfer. A segment counts for as many pieces as memory
+ * handle entries it spans. Returns 0 if the plugin does not support batched
+ * RMA operations.
+ *
+ * \param na_class [IN]         pointer to NA class
+ *
+ * \return Non-negative value
+ */
+static NA_INLINE size_t
+NA_Rma_batch_get_max_segments(
+    const na_class_t *na_class) NA_WARN_UNUSED_RESULT;
+
+/**
+ * Put (cb_type set to NA_CB_PUT) or get (cb_type set to NA_CB_GET) a list of
+ * segments to / from the same remote address as a single operation. Segments
+ * follow the same rules as NA_Put() and NA_Get(), but the whole transfer
+ * produces a single completion once all of them are done, rather than one
+ * completion per segment.
+ *
+ * Supported only if NA_Rma_batch_get_max_segments() returns a non-zero value,
+ * NA_OVERFLOW is returned if segments span more pieces than that value.
+ *
+ * \param na_class [IN/OUT]      pointer to NA class
+ * \param context [IN/OUT]       pointer to context of execution
+ * \param cb_type [IN]           type of RMA operation
+ * \param callback [IN]          pointer to function callback
+ * \param arg [IN]               pointer to data passed to callback
+ * \param segments [IN]          array of RMA segments
+ * \param count [IN]             number of RMA segments
+ * \param remote_addr [IN]       NA address of remote peer
+ * \param remote_id [IN]         target ID of remote peer
+ * \param op_id [IN/OUT]         pointer to operation ID
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Rma_batch(na_class_t *na_class, na_context_t *context, na_cb_type_t cb_type,
+    na_cb_t callback, void *arg, const struct na_rma_segment *segments,
+    size_t count, na_addr_t *remote_addr, uint8_t remote_id,
+    na_op_id_t *op_id);
+
+/**
+ * Atomically add operand to the 64-bit unsigned integer stored at
+ * remote_offset of the remote memory handle. The value that was stored before
+ * the addition is returned in the atomic info of the callback info. Remote
+ * memory must be registered with NA_MEM_READWRITE and remote_offset must be
+ * 8-byte aligned. Operations are only atomic with respect to other remote
+ * atomic operations issued through the same class type.
+ *
+ * Supported only if NA_Has_opt_feature() returns true for NA_OPT_ATOMIC.
+ *
+ * \param na_class [IN/OUT]      pointer to NA class
+ * \param context [IN/OUT]       pointer to context of execution
+ * \param callback [IN]          pointer to function callback
+ * \param arg [IN]               pointer to data passed to callback
+ * \param operand [IN]           value to add
+ * \param remote_mem_handle [IN] pointer to remote memory handle
+ * \param remote_offset [IN]     offset from remote memory handle
+ * \param remote_addr [IN]       NA address of remote peer
+ * \param remote_id [IN]         target ID of remote peer
+ * \param op_id [IN/OUT]         pointer to operation ID
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Atomic_fetch_add(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, uint64_t operand,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id);
+
+/**
+ * Atomically replace the 64-bit unsigned integer stored at remote_offset of
+ * the remote memory handle with operand if it is equal to compare. The value
+ * that was stored before the operation is returned in the atomic info of the
+ * callback info, the swap took place if it is equal to compare. Same rules as
+ * NA_Atomic_fetch_add() apply.
+ *
+ * \param na_class [IN/OUT]      pointer to NA class
+ * \param context [IN/OUT]       pointer to context of execution
+ * \param callback [IN]          pointer to function callback
+ * \param arg [IN]               pointer to data passed to callback
+ * \param operand [IN]           value to swap in
+ * \param compare [IN]           value to compare with
+ * \param remote_mem_handle [IN] pointer to remote memory handle
+ * \param remote_offset [IN]     offset from remote memory handle
+ * \param remote_addr [IN]       NA address of remote peer
+ * \param remote_id [IN]         target ID of remote peer
+ * \param op_id [IN/OUT]         pointer to operation ID
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Atomic_cas(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id);
+
 /**
  * Retrieve file descriptor from NA plugin when supported. The descriptor
  * can be used by upper layers for manual polling through the usual
@@ -908,6 +1222,25 @@ NA_PUBLIC na_return_t
 NA_Trigger(
     na_context_t *context, unsigned int max_count, unsigned int *actual_count);
 
+/**
+ * Retrieve at most max_count completed operations without executing their
+ * callbacks. The callback info of each completed operation is copied to
+ * cb_infos, operations can then be identified from the arg that was passed
+ * when they were posted. Plugin resources associated to the operations are
+ * released as they would be with NA_Trigger(), so that operation IDs can be
+ * reused immediately.
+ *
+ * \param context [IN/OUT]      pointer to context of execution
+ * \param cb_infos [OUT]        array of at least max_count callback infos
+ * \param max_count [IN]        maximum number of completions retrieved
+ * \param actual_count [OUT]    actual number of completions retrieved
+ *
+ * \return NA_SUCCESS or corresponding NA error code
+ */
+NA_PUBLIC na_return_t
+NA_Poll_completions(na_context_t *context, struct na_cb_info *cb_infos,
+    unsigned int max_count, unsigned int *actual_count);
+
 /**
  * Cancel an ongoing operation.
  *
@@ -967,13 +1300,19 @@ struct na_class_ops {
     na_return_t (*finalize)(na_class_t *na_class);
     void (*cleanup)(void);
     bool (*has_opt_feature)(na_class_t *na_class, unsigned long flags);
+    int (*get_numa_node)(na_class_t *na_class);
     na_return_t (*context_create)(
         na_class_t *na_class, void **plugin_context_p, uint8_t id);
     na_return_t (*context_destroy)(na_class_t *na_class, void *plugin_context);
     na_op_id_t *(*op_create)(na_class_t *na_class, unsigned long flags);
     void (*op_destroy)(na_class_t *na_class, na_op_id_t *op_id);
+    na_return_t (*op_reset)(na_class_t *na_class, na_op_id_t *op_id);
     na_return_t (*addr_lookup)(
         na_class_t *na_class, const char *name, na_addr_t **addr_p);
+    na_return_t (*addr_lookup_batch)(na_class_t *na_class,
+        const char *const *names, size_t count, na_addr_t **addrs);
+    na_return_t (*addr_warm)(
+        na_class_t *na_class, na_addr_t *const *addrs, size_t count);
     void (*addr_free)(na_class_t *na_class, na_addr_t *addr);
     na_return_t (*addr_set_remove)(na_class_t *na_class, na_addr_t *addr);
     na_return_t (*addr_self)(na_class_t *na_class, na_addr_t **addr_p);
@@ -1018,6 +1357,9 @@ struct na_class_ops {
         na_context_t *context, na_cb_t callback, void *arg, void *buf,
         size_t buf_size, void *plugin_data, na_addr_t *source_addr,
         uint8_t source_id, na_tag_t tag, na_op_id_t *op_id);
+    na_return_t (*msg_send_batch)(na_class_t *na_class, na_context_t *context,
+        na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+        size_t count, size_t *posted_count_p);
     na_return_t (*mem_handle_create)(na_class_t *na_class, void *buf,
         size_t buf_size, unsigned long flags, na_mem_handle_t **mem_handle_p);
     na_return_t (*mem_handle_create_segments)(na_class_t *na_class,
@@ -1046,6 +1388,16 @@ struct na_class_ops {
         na_offset_t local_offset, na_mem_handle_t *remote_mem_handle,
         na_offset_t remote_offset, size_t length, na_addr_t *remote_addr,
         uint8_t remote_id, na_op_id_t *op_id);
+    size_t (*rma_batch_get_max_segments)(const na_class_t *na_class);
+    na_return_t (*rma_batch)(na_class_t *na_class, na_context_t *context,
+        na_cb_type_t cb_type, na_cb_t callback, void *arg,
+        const struct na_rma_segment *segments, size_t count,
+        na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id);
+    na_return_t (*atomic)(na_class_t *na_class, na_context_t *context,
+        na_cb_t callback, void *arg, na_atomic_op_t op, uint64_t operand,
+        uint64_t compare, na_mem_handle_t *remote_mem_handle,
+        na_offset_t remote_offset, na_addr_t *remote_addr, uint8_t remote_id,
+        na_op_id_t *op_id);
     int (*na_poll_get_fd)(na_class_t *na_class, na_context_t *context);
     bool (*na_poll_try_wait)(na_class_t *na_class, na_context_t *context);
     na_return_t (*progress)(
@@ -1054,11 +1406,19 @@ struct na_class_ops {
         na_class_t *na_class, na_context_t *context, na_op_id_t *op_id);
 };
 
+/* NA class ops, calls are direct when NA is built with a single plugin */
+#ifdef NA_STATIC_PLUGIN_OPS
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_STATIC_PLUGIN_OPS;
+#    define NA_OPS(na_class) ((void) (na_class), &NA_STATIC_PLUGIN_OPS)
+#else
+#    define NA_OPS(na_class) ((na_class)->ops)
+#endif
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE const char *
 NA_Get_class_name(const na_class_t *na_class)
 {
-    return na_class->ops->class_name;
+    return NA_OPS(na_class)->class_name;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1079,15 +1439,15 @@ NA_Is_listening(const na_class_t *na_class)
 static NA_INLINE bool
 NA_Addr_is_self(na_class_t *na_class, na_addr_t *addr)
 {
-    return na_class->ops->addr_is_self(na_class, addr);
+    return NA_OPS(na_class)->addr_is_self(na_class, addr);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE size_t
 NA_Addr_get_serialize_size(na_class_t *na_class, na_addr_t *addr)
 {
-    return (na_class->ops->addr_get_serialize_size)
-               ? na_class->ops->addr_get_serialize_size(na_class, addr)
+    return (NA_OPS(na_class)->addr_get_serialize_size)
+               ? NA_OPS(na_class)->addr_get_serialize_size(na_class, addr)
                : 0;
 }
 
@@ -1095,22 +1455,22 @@ NA_Addr_get_serialize_size(na_class_t *na_class, na_addr_t *addr)
 static NA_INLINE size_t
 NA_Msg_get_max_unexpected_size(const na_class_t *na_class)
 {
-    return na_class->ops->msg_get_max_unexpected_size(na_class);
+    return NA_OPS(na_class)->msg_get_max_unexpected_size(na_class);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE size_t
 NA_Msg_get_max_expected_size(const na_class_t *na_class)
 {
-    return na_class->ops->msg_get_max_expected_size(na_class);
+    return NA_OPS(na_class)->msg_get_max_expected_size(na_class);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE size_t
 NA_Msg_get_unexpected_header_size(const na_class_t *na_class)
 {
-    return (na_class->ops->msg_get_unexpected_header_size)
-               ? na_class->ops->msg_get_unexpected_header_size(na_class)
+    return (NA_OPS(na_class)->msg_get_unexpected_header_size)
+               ? NA_OPS(na_class)->msg_get_unexpected_header_size(na_class)
                : 0;
 }
 
@@ -1118,8 +1478,8 @@ NA_Msg_get_unexpected_header_size(const na_class_t *na_class)
 static NA_INLINE size_t
 NA_Msg_get_expected_header_size(const na_class_t *na_class)
 {
-    return (na_class->ops->msg_get_expected_header_size)
-               ? na_class->ops->msg_get_expected_header_size(na_class)
+    return (NA_OPS(na_class)->msg_get_expected_header_size)
+               ? NA_OPS(na_class)->msg_get_expected_header_size(na_class)
                : 0;
 }
 
@@ -1127,7 +1487,7 @@ NA_Msg_get_expected_header_size(const na_class_t *na_class)
 static NA_INLINE na_tag_t
 NA_Msg_get_max_tag(const na_class_t *na_class)
 {
-    return na_class->ops->msg_get_max_tag(na_class);
+    return NA_OPS(na_class)->msg_get_max_tag(na_class);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1137,8 +1497,8 @@ NA_Msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     void *plugin_data, na_addr_t *dest_addr, uint8_t dest_id, na_tag_t tag,
     na_op_id_t *op_id)
 {
-    return na_class->ops->msg_send_unexpected(na_class, context, callback, arg,
-        buf, buf_size, plugin_data, dest_addr, dest_id, tag, op_id);
+    return NA_OPS(na_class)->msg_send_unexpected(na_class, context, callback,
+        arg, buf, buf_size, plugin_data, dest_addr, dest_id, tag, op_id);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1147,7 +1507,7 @@ NA_Msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
     na_op_id_t *op_id)
 {
-    return na_class->ops->msg_recv_unexpected(
+    return NA_OPS(na_class)->msg_recv_unexpected(
         na_class, context, callback, arg, buf, buf_size, plugin_data, op_id);
 }
 
@@ -1157,8 +1517,8 @@ NA_Msg_multi_recv_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
     na_op_id_t *op_id)
 {
-    return (na_class->ops->msg_multi_recv_unexpected)
-               ? na_class->ops->msg_multi_recv_unexpected(na_class, context,
+    return (NA_OPS(na_class)->msg_multi_recv_unexpected)
+               ? NA_OPS(na_class)->msg_multi_recv_unexpected(na_class, context,
                      callback, arg, buf, buf_size, plugin_data, op_id)
                : NA_OPNOTSUPPORTED;
 }
@@ -1170,7 +1530,7 @@ NA_Msg_send_expected(na_class_t *na_class, na_context_t *context,
     void *plugin_data, na_addr_t *dest_addr, uint8_t dest_id, na_tag_t tag,
     na_op_id_t *op_id)
 {
-    return na_class->ops->msg_send_expected(na_class, context, callback, arg,
+    return NA_OPS(na_class)->msg_send_expected(na_class, context, callback, arg,
         buf, buf_size, plugin_data, dest_addr, dest_id, tag, op_id);
 }
 
@@ -1180,7 +1540,7 @@ NA_Msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
     na_addr_t *source_addr, uint8_t source_id, na_tag_t tag, na_op_id_t *op_id)
 {
-    return na_class->ops->msg_recv_expected(na_class, context, callback, arg,
+    return NA_OPS(na_class)->msg_recv_expected(na_class, context, callback, arg,
         buf, buf_size, plugin_data, source_addr, source_id, tag, op_id);
 }
 
@@ -1188,8 +1548,8 @@ NA_Msg_recv_expected(na_class_t *na_class, na_context_t *context,
 static NA_INLINE size_t
 NA_Mem_handle_get_max_segments(const na_class_t *na_class)
 {
-    return (na_class->ops->mem_handle_get_max_segments)
-               ? na_class->ops->mem_handle_get_max_segments(na_class)
+    return (NA_OPS(na_class)->mem_handle_get_max_segments)
+               ? NA_OPS(na_class)->mem_handle_get_max_segments(na_class)
                : 1;
 }
 
@@ -1198,7 +1558,8 @@ static NA_INLINE size_t
 NA_Mem_handle_get_serialize_size(
     na_class_t *na_class, na_mem_handle_t *mem_handle)
 {
-    return na_class->ops->mem_handle_get_serialize_size(na_class, mem_handle);
+    return NA_OPS(na_class)->mem_handle_get_serialize_size(
+        na_class, mem_handle);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1209,7 +1570,7 @@ NA_Put(na_class_t *na_class, na_context_t *context, na_cb_t callback, void *arg,
     size_t data_size, na_addr_t *remote_addr, uint8_t remote_id,
     na_op_id_t *op_id)
 {
-    return na_class->ops->put(na_class, context, callback, arg,
+    return NA_OPS(na_class)->put(na_class, context, callback, arg,
         local_mem_handle, local_offset, remote_mem_handle, remote_offset,
         data_size, remote_addr, remote_id, op_id);
 }
@@ -1222,17 +1583,26 @@ NA_Get(na_class_t *na_class, na_context_t *context, na_cb_t callback, void *arg,
     size_t data_size, na_addr_t *remote_addr, uint8_t remote_id,
     na_op_id_t *op_id)
 {
-    return na_class->ops->get(na_class, context, callback, arg,
+    return NA_OPS(na_class)->get(na_class, context, callback, arg,
         local_mem_handle, local_offset, remote_mem_handle, remote_offset,
         data_size, remote_addr, remote_id, op_id);
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE size_t
+NA_Rma_batch_get_max_segments(const na_class_t *na_class)
+{
+    return (NA_OPS(na_class)->rma_batch_get_max_segments)
+               ? NA_OPS(na_class)->rma_batch_get_max_segments(na_class)
+               : 0;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE int
 NA_Poll_get_fd(na_class_t *na_class, na_context_t *context)
 {
-    return (na_class->ops->na_poll_get_fd)
-               ? na_class->ops->na_poll_get_fd(na_class, context)
+    return (NA_OPS(na_class)->na_poll_get_fd)
+               ? NA_OPS(na_class)->na_poll_get_fd(na_class, context)
                : -1;
 }
 
@@ -449,11 +449,15 @@ const struct na_class_ops NA_PLUGIN_OPS(bmi) = {
     na_bmi_finalize,                      /* finalize */
     NULL,                                 /* cleanup */
     NULL,                                 /* has_opt_feature */
+    NULL,                                 /* get_numa_node */
     na_bmi_context_create,                /* context_create */
     na_bmi_context_destroy,               /* context_destroy */
     na_bmi_op_create,                     /* op_create */
     na_bmi_op_destroy,                    /* op_destroy */
+    NULL,                                 /* op_reset */
     na_bmi_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
+    NULL,                                 /* addr_warm */
     na_bmi_addr_free,                     /* addr_free */
     NULL,                                 /* addr_set_remove */
     na_bmi_addr_self,                     /* addr_self */
@@ -478,6 +482,7 @@ const struct na_class_ops NA_PLUGIN_OPS(bmi) = {
     NULL,                                 /* msg_init_expected */
     na_bmi_msg_send_expected,             /* msg_send_expected */
     na_bmi_msg_recv_expected,             /* msg_recv_expected */
+    NULL,                                 /* msg_send_batch */
     na_bmi_mem_handle_create,             /* mem_handle_create */
     NULL,                                 /* mem_handle_create_segment */
     na_bmi_mem_handle_free,               /* mem_handle_free */
@@ -489,6 +494,9 @@ const struct na_class_ops NA_PLUGIN_OPS(bmi) = {
     na_bmi_mem_handle_deserialize,        /* mem_handle_deserialize */
     na_bmi_put,                           /* put */
     na_bmi_get,                           /* get */
+    NULL,                                 /* rma_batch_get_max_segments */
+    NULL,                                 /* rma_batch */
+    NULL,                                 /* atomic */
     NULL,                                 /* poll_get_fd */
     NULL,                                 /* poll_try_wait */
     na_bmi_progress,                      /* progress */
@@ -367,11 +367,15 @@ const struct na_class_ops NA_PLUGIN_OPS(cci) = {
     na_cci_finalize,                      /* finalize */
     NULL,                                 /* cleanup */
     NULL,                                 /* has_opt_feature */
+    NULL,                                 /* get_numa_node */
     NULL,                                 /* context_create */
     NULL,                                 /* context_destroy */
     na_cci_op_create,                     /* op_create */
     na_cci_op_destroy,                    /* op_destroy */
+    NULL,                                 /* op_reset */
     na_cci_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
+    NULL,                                 /* addr_warm */
     na_cci_addr_free,                     /* addr_free */
     NULL,                                 /* addr_set_remove */
     na_cci_addr_self,                     /* addr_self */
@@ -396,6 +400,7 @@ const struct na_class_ops NA_PLUGIN_OPS(cci) = {
     NULL,                                 /* msg_init_expected */
     na_cci_msg_send_expected,             /* msg_send_expected */
     na_cci_msg_recv_expected,             /* msg_recv_expected */
+    NULL,                                 /* msg_send_batch */
     na_cci_mem_handle_create,             /* mem_handle_create */
     NULL,                                 /* mem_handle_create_segment */
     na_cci_mem_handle_free,               /* mem_handle_free */
@@ -407,6 +412,9 @@ const struct na_class_ops NA_PLUGIN_OPS(cci) = {
     na_cci_mem_handle_deserialize,        /* mem_handle_deserialize */
     na_cci_put,                           /* put */
     na_cci_get,                           /* get */
+    NULL,                                 /* rma_batch_get_max_segments */
+    NULL,                                 /* rma_batch */
+    NULL,                                 /* atomic */
     na_cci_poll_get_fd,                   /* poll_get_fd */
     NULL,                                 /* poll_try_wait */
     na_cci_progress,                      /* progress */
@@ -41,7 +41,7 @@ struct na_loc_info {
 
 /*---------------------------------------------------------------------------*/
 na_return_t
-na_loc_info_init(struct na_loc_info **na_loc_info_p)
+na_loc_info_init(const char *cpu_set, struct na_loc_info **na_loc_info_p)
 {
     struct na_loc_info *na_loc_info = NULL;
     na_return_t ret;
@@ -80,11 +80,22 @@ na_loc_info_init(struct na_loc_info **na_loc_info_p)
     NA_CHECK_SUBSYS_ERROR(cls, na_loc_info->proc_cpuset == NULL, error, ret,
         NA_NOMEM, "hwloc_bitmap_alloc() failed");
 
-    /* Fill cpuset with the collection of cpu cores that the process runs on */
-    rc = hwloc_get_cpubind(
-        na_loc_info->topology, na_loc_info->proc_cpuset, HWLOC_CPUBIND_PROCESS);
-    NA_CHECK_SUBSYS_ERROR(cls, rc < 0, error, ret, NA_PROTOCOL_ERROR,
-        "hwloc_get_cpubind() failed");
+    if (cpu_set != NULL) {
+        /* Use the CPUs that were requested */
+        rc = hwloc_bitmap_list_sscanf(na_loc_info->proc_cpuset, cpu_set);
+        NA_CHECK_SUBSYS_ERROR(cls,
+            rc < 0 || hwloc_bitmap_iszero(na_loc_info->proc_cpuset), error, ret,
+            NA_INVALID_ARG, "Could not parse CPU set (%s)", cpu_set);
+    } else {
+        /* Fill cpuset with the collection of cpu cores that the process runs
+         * on */
+        rc = hwloc_get_cpubind(na_loc_info->topology, na_loc_info->proc_cpuset,
+            HWLOC_CPUBIND_PROCESS);
+        NA_CHECK_SUBSYS_ERROR(cls, rc < 0, error, ret, NA_PROTOCOL_ERROR,
+            "hwloc_get_cpubind() failed");
+    }
+#else
+    (void) cpu_set;
 #endif
 
     *na_loc_info_p = na_loc_info;
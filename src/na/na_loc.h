@@ -31,12 +31,13 @@ extern "C" {
 /**
  * Init loc info. Must be freed with na_loc_info_destroy().
  *
+ * \param cpu_set [IN]          CPUs in list format (NULL if process binding)
  * \param na_loc_info_p [OUT]   pointer to returned loc info
  *
  * \return NA_SUCCESS or corresponding NA error code
  */
 NA_PLUGIN_VISIBILITY na_return_t
-na_loc_info_init(struct na_loc_info **na_loc_info_p);
+na_loc_info_init(const char *cpu_set, struct na_loc_info **na_loc_info_p);
 
 /**
  * Free loc info.
@@ -47,7 +48,7 @@ NA_PLUGIN_VISIBILITY void
 na_loc_info_destroy(struct na_loc_info *na_loc_info);
 
 /**
- * Check if a process and a pci device share the same cpuset.
+ * Check if the CPUs of loc info and a pci device share the same cpuset.
  *
  * \param na_loc_info [IN]      pointer to loc info
  * \param domain_id  [IN]       PCI domain ID
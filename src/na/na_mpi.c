@@ -48,6 +48,9 @@ static int MPI_MAX_TAG = 32767;
 #define NA_MPI_RMA_TAG         (NA_MPI_RMA_REQUEST_TAG + 1)
 #define NA_MPI_MAX_RMA_TAG     (MPI_MAX_TAG >> 1)
 
+/* Initial number of requests tested at once */
+#define NA_MPI_TEST_COUNT_MIN 64
+
 #define NA_MPI_CLASS(na_class)                                                 \
     ((struct na_mpi_class *) (na_class->plugin_class))
 
@@ -66,6 +69,7 @@ struct na_mpi_addr {
     MPI_Comm comm;     /* Communicator */
     MPI_Comm rma_comm; /* Communicator used for one sided emulation */
     int rank;          /* Rank in this communicator */
+    int win_rank;      /* Rank in RMA window (-1 if not resolved yet) */
     bool unexpected;   /* Address generated from unexpected recv */
     bool self;         /* Boolean for self */
     bool dynamic;      /* Address generated using MPI DPM routines */
@@ -75,9 +79,11 @@ struct na_mpi_addr {
 
 /* na_mpi_mem_handle */
 struct na_mpi_mem_handle {
-    void *base;    /* Initial address of memory */
-    MPI_Aint size; /* Size of memory */
-    uint8_t attr;  /* Flag of operation access */
+    void *base;       /* Initial address of memory */
+    MPI_Aint size;    /* Size of memory */
+    MPI_Aint disp;    /* Displacement of base in RMA window */
+    uint8_t attr;     /* Flag of operation access */
+    uint8_t attached; /* Memory attached to RMA window */
 };
 
 /* na_mpi_rma_op */
@@ -126,6 +132,7 @@ struct na_mpi_info_put {
     MPI_Request rma_request;
     MPI_Request data_request;
     struct na_mpi_rma_info *rma_info;
+    int flush_rank; /* Window rank to flush on completion (-1 if none) */
     bool internal_progress; /* Used for internal RMA emulation */
 };
 
@@ -179,9 +186,18 @@ struct na_mpi_class {
     hg_thread_mutex_t unexpected_op_queue_mutex;     /* Mutex */
 
     hg_atomic_int32_t rma_tag; /* Atomic RMA tag value */
+    MPI_Win rma_win;           /* Dynamic window used for one-sided RMA */
+    bool use_rma_win;          /* RMA window created */
 
     HG_LIST_HEAD(na_mpi_op_id) op_id_list; /* List of na_mpi_op_ids */
     hg_thread_mutex_t op_id_list_mutex;    /* Mutex */
+
+    /* Arrays passed to MPI_Testsome(), protected by op_id_list_mutex */
+    struct na_mpi_op_id **test_op_ids; /* Op IDs of tested requests */
+    MPI_Request *test_requests;        /* Tested requests */
+    MPI_Status *test_statuses;         /* Statuses of completed requests */
+    int *test_indices;                 /* Indices of completed requests */
+    size_t test_count_max;             /* Size of test arrays */
 };
 
 /********************/
@@ -315,6 +331,15 @@ na_mpi_mem_handle_create(na_class_t *na_class, void *buf, size_t buf_size,
 static void
 na_mpi_mem_handle_free(na_class_t *na_class, na_mem_handle_t *mem_handle);
 
+/* mem_register */
+static na_return_t
+na_mpi_mem_register(na_class_t *na_class, na_mem_handle_t *mem_handle,
+    enum na_mem_type mem_type, uint64_t device);
+
+/* mem_deregister */
+static na_return_t
+na_mpi_mem_deregister(na_class_t *na_class, na_mem_handle_t *mem_handle);
+
 /* mem_handle serialization */
 static size_t
 na_mpi_mem_handle_get_serialize_size(
@@ -328,6 +353,10 @@ static na_return_t
 na_mpi_mem_handle_deserialize(na_class_t *na_class,
     na_mem_handle_t **mem_handle, const void *buf, size_t buf_size);
 
+/* na_mpi_addr_win_rank */
+static na_return_t
+na_mpi_addr_win_rank(struct na_mpi_addr *na_mpi_addr, int *win_rank);
+
 /* put */
 static na_return_t
 na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
@@ -357,18 +386,28 @@ na_mpi_progress_unexpected(
 /* na_mpi_progress_unexpected_msg */
 static na_return_t
 na_mpi_progress_unexpected_msg(na_class_t *na_class, na_context_t *context,
-    struct na_mpi_addr *na_mpi_addr, const MPI_Status *status);
+    struct na_mpi_addr *na_mpi_addr, bool *progressed);
 
 /* na_mpi_progress_unexpected_rma */
 static na_return_t
 na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
-    struct na_mpi_addr *na_mpi_addr, const MPI_Status *status);
+    struct na_mpi_addr *na_mpi_addr, MPI_Message *message,
+    const MPI_Status *status);
 
 /* na_mpi_progress_expected */
 static na_return_t
 na_mpi_progress_expected(
     na_class_t *na_class, na_context_t *context, unsigned int timeout);
 
+/* na_mpi_op_id_request */
+static MPI_Request *
+na_mpi_op_id_request(struct na_mpi_op_id *na_mpi_op_id, MPI_Status **status,
+    bool *complete_op_id);
+
+/* na_mpi_test_resize */
+static na_return_t
+na_mpi_test_resize(struct na_mpi_class *na_mpi_class, size_t count);
+
 /* na_mpi_complete */
 static na_return_t
 na_mpi_complete(struct na_mpi_op_id *na_mpi_op_id);
@@ -393,11 +432,15 @@ const struct na_class_ops NA_PLUGIN_OPS(mpi) = {
     na_mpi_finalize,                      /* finalize */
     NULL,                                 /* cleanup */
     NULL,                                 /* has_opt_feature */
+    NULL,                                 /* get_numa_node */
     NULL,                                 /* context_create */
     NULL,                                 /* context_destroy */
     na_mpi_op_create,                     /* op_create */
     na_mpi_op_destroy,                    /* op_destroy */
+    NULL,                                 /* op_reset */
     na_mpi_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
+    NULL,                                 /* addr_warm */
     na_mpi_addr_free,                     /* addr_free */
     NULL,                                 /* addr_set_remove */
     na_mpi_addr_self,                     /* addr_self */
@@ -422,17 +465,21 @@ const struct na_class_ops NA_PLUGIN_OPS(mpi) = {
     NULL,                                 /* msg_init_expected */
     na_mpi_msg_send_expected,             /* msg_send_expected */
     na_mpi_msg_recv_expected,             /* msg_recv_expected */
+    NULL,                                 /* msg_send_batch */
     na_mpi_mem_handle_create,             /* mem_handle_create */
     NULL,                                 /* mem_handle_create_segment */
     na_mpi_mem_handle_free,               /* mem_handle_free */
     NULL,                                 /* mem_handle_get_max_segments */
-    NULL,                                 /* mem_register */
-    NULL,                                 /* mem_deregister */
+    na_mpi_mem_register,                  /* mem_register */
+    na_mpi_mem_deregister,                /* mem_deregister */
     na_mpi_mem_handle_get_serialize_size, /* mem_handle_get_serialize_size */
     na_mpi_mem_handle_serialize,          /* mem_handle_serialize */
     na_mpi_mem_handle_deserialize,        /* mem_handle_deserialize */
     na_mpi_put,                           /* put */
     na_mpi_get,                           /* get */
+    NULL,                                 /* rma_batch_get_max_segments */
+    NULL,                                 /* rma_batch */
+    NULL,                                 /* atomic */
     NULL,                                 /* poll_get_fd */
     NULL,                                 /* poll_try_wait */
     na_mpi_progress,                      /* progress */
@@ -605,6 +652,7 @@ na_mpi_accept(struct na_mpi_class *na_mpi_class)
     na_mpi_addr->comm = new_comm;
     na_mpi_addr->rma_comm = new_rma_comm;
     na_mpi_addr->rank = MPI_ANY_SOURCE;
+    na_mpi_addr->win_rank = -1;
     na_mpi_addr->unexpected = false;
     na_mpi_addr->dynamic = (bool) (!na_mpi_class->use_static_inter_comm);
     memset(na_mpi_addr->port_name, '\0', MPI_MAX_PORT_NAME);
@@ -969,6 +1017,24 @@ na_mpi_initialize(
     /* Initialize atomic op */
     hg_atomic_set32(&na_mpi_class->rma_tag, NA_MPI_RMA_TAG);
 
+    /* All processes share MPI_COMM_WORLD when using the static
+     * inter-communicator, create a dynamic window over it so that RMA
+     * operations can be issued directly, without two-sided emulation */
+    if (use_static_inter_comm && na_mpi_init_comm_g == MPI_COMM_NULL) {
+        mpi_ret = MPI_Win_create_dynamic(
+            MPI_INFO_NULL, MPI_COMM_WORLD, &na_mpi_class->rma_win);
+        if (mpi_ret == MPI_SUCCESS) {
+            mpi_ret = MPI_Win_lock_all(MPI_MODE_NOCHECK, na_mpi_class->rma_win);
+            if (mpi_ret != MPI_SUCCESS)
+                MPI_Win_free(&na_mpi_class->rma_win);
+        }
+        if (mpi_ret != MPI_SUCCESS)
+            NA_LOG_WARNING("Could not create RMA window, using two-sided "
+                           "RMA emulation");
+        else
+            na_mpi_class->use_rma_win = true;
+    }
+
     /* If server opens a port */
     if (listening) {
         na_mpi_class->accepting = true;
@@ -1038,6 +1104,18 @@ na_mpi_finalize(na_class_t *na_class)
         ret = NA_PROTOCOL_ERROR;
     }
 
+    /* Free RMA window */
+    if (NA_MPI_CLASS(na_class)->use_rma_win) {
+        MPI_Win_unlock_all(NA_MPI_CLASS(na_class)->rma_win);
+        mpi_ret = MPI_Win_free(&NA_MPI_CLASS(na_class)->rma_win);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("Could not free RMA window");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+        NA_MPI_CLASS(na_class)->use_rma_win = false;
+    }
+
     /* Free the private dup'ed comm */
     mpi_ret = MPI_Comm_free(&NA_MPI_CLASS(na_class)->intra_comm);
     if (mpi_ret != MPI_SUCCESS) {
@@ -1070,6 +1148,10 @@ na_mpi_finalize(na_class_t *na_class)
     hg_thread_mutex_destroy(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
     hg_thread_mutex_destroy(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
 
+    free(NA_MPI_CLASS(na_class)->test_op_ids);
+    free(NA_MPI_CLASS(na_class)->test_requests);
+    free(NA_MPI_CLASS(na_class)->test_statuses);
+    free(NA_MPI_CLASS(na_class)->test_indices);
     free(na_class->plugin_class);
 
 done:
@@ -1119,6 +1201,7 @@ na_mpi_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr)
         goto done;
     }
     na_mpi_addr->rank = 0;
+    na_mpi_addr->win_rank = -1;
     na_mpi_addr->comm = MPI_COMM_NULL;
     na_mpi_addr->rma_comm = MPI_COMM_NULL;
     na_mpi_addr->unexpected = false;
@@ -1215,6 +1298,7 @@ na_mpi_addr_self(na_class_t *na_class, na_addr_t **addr)
     na_mpi_addr->comm = MPI_COMM_NULL;
     na_mpi_addr->rma_comm = MPI_COMM_NULL;
     na_mpi_addr->rank = 0;
+    na_mpi_addr->win_rank = -1;
     na_mpi_addr->unexpected = false;
     na_mpi_addr->self = true;
     na_mpi_addr->dynamic = false;
@@ -1551,6 +1635,61 @@ na_mpi_mem_handle_free(
     free(mpi_mem_handle);
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_mem_register(na_class_t *na_class, na_mem_handle_t *mem_handle,
+    enum na_mem_type NA_UNUSED mem_type, uint64_t NA_UNUSED device)
+{
+    struct na_mpi_mem_handle *na_mpi_mem_handle =
+        (struct na_mpi_mem_handle *) mem_handle;
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    /* Nothing to do if RMA is emulated */
+    if (!NA_MPI_CLASS(na_class)->use_rma_win || na_mpi_mem_handle->size == 0)
+        goto done;
+
+    mpi_ret = MPI_Win_attach(NA_MPI_CLASS(na_class)->rma_win,
+        na_mpi_mem_handle->base, na_mpi_mem_handle->size);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_attach() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Dynamic windows are addressed with absolute addresses */
+    MPI_Get_address(na_mpi_mem_handle->base, &na_mpi_mem_handle->disp);
+    na_mpi_mem_handle->attached = 1;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_mem_deregister(na_class_t *na_class, na_mem_handle_t *mem_handle)
+{
+    struct na_mpi_mem_handle *na_mpi_mem_handle =
+        (struct na_mpi_mem_handle *) mem_handle;
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    if (!na_mpi_mem_handle->attached)
+        goto done;
+
+    mpi_ret = MPI_Win_detach(
+        NA_MPI_CLASS(na_class)->rma_win, na_mpi_mem_handle->base);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_detach() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    na_mpi_mem_handle->attached = 0;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static size_t
 na_mpi_mem_handle_get_serialize_size(
@@ -1612,6 +1751,48 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_addr_win_rank(struct na_mpi_addr *na_mpi_addr, int *win_rank)
+{
+    MPI_Group group = MPI_GROUP_NULL, world_group = MPI_GROUP_NULL;
+    na_return_t ret = NA_SUCCESS;
+    int inter = 0;
+    int mpi_ret;
+
+    if (na_mpi_addr->win_rank >= 0)
+        goto done;
+
+    if (na_mpi_addr->self) {
+        MPI_Comm_rank(MPI_COMM_WORLD, &na_mpi_addr->win_rank);
+        goto done;
+    }
+
+    /* Translate rank of remote into a rank of the window communicator */
+    MPI_Comm_test_inter(na_mpi_addr->comm, &inter);
+    mpi_ret = (inter) ? MPI_Comm_remote_group(na_mpi_addr->comm, &group)
+                      : MPI_Comm_group(na_mpi_addr->comm, &group);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("Could not get remote group");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+    mpi_ret = MPI_Group_translate_ranks(
+        group, 1, &na_mpi_addr->rank, world_group, &na_mpi_addr->win_rank);
+    if (mpi_ret != MPI_SUCCESS || na_mpi_addr->win_rank == MPI_UNDEFINED) {
+        NA_LOG_ERROR("Could not translate remote rank");
+        na_mpi_addr->win_rank = -1;
+        ret = NA_PROTOCOL_ERROR;
+    }
+    MPI_Group_free(&world_group);
+    MPI_Group_free(&group);
+
+done:
+    *win_rank = na_mpi_addr->win_rank;
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
@@ -1660,39 +1841,66 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_mpi_op_id->info.put.internal_progress = false;
     na_mpi_op_id->info.put.rma_info = NULL;
 
-    /* Allocate rma info (use calloc to avoid uninitialized transfer) */
-    na_mpi_rma_info =
-        (struct na_mpi_rma_info *) calloc(1, sizeof(struct na_mpi_rma_info));
-    if (!na_mpi_rma_info) {
-        NA_LOG_ERROR("Could not allocate NA MPI RMA info");
-        ret = NA_NOMEM_ERROR;
-        goto done;
-    }
-    na_mpi_rma_info->op = NA_MPI_RMA_PUT;
-    na_mpi_rma_info->base = mpi_remote_mem_handle->base;
-    na_mpi_rma_info->disp = mpi_remote_offset;
-    na_mpi_rma_info->count = mpi_length;
-    na_mpi_rma_info->tag = na_mpi_gen_rma_tag(na_class);
-    na_mpi_op_id->info.put.rma_info = na_mpi_rma_info;
-
-    /* Post the MPI send request */
-    mpi_ret = MPI_Isend(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
-        MPI_BYTE, na_mpi_addr->rank, NA_MPI_RMA_REQUEST_TAG,
-        na_mpi_addr->rma_comm, &na_mpi_op_id->info.put.rma_request);
-    if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Isend() failed");
-        ret = NA_PROTOCOL_ERROR;
-        goto done;
-    }
+    na_mpi_op_id->info.put.flush_rank = -1;
 
-    /* Simply do a non blocking synchronous send */
-    mpi_ret = MPI_Issend((char *) mpi_local_mem_handle->base + mpi_local_offset,
-        mpi_length, MPI_BYTE, na_mpi_addr->rank, (int) na_mpi_rma_info->tag,
-        na_mpi_addr->rma_comm, &na_mpi_op_id->info.put.data_request);
-    if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Issend() failed");
-        ret = NA_PROTOCOL_ERROR;
-        goto done;
+    if (NA_MPI_CLASS(na_class)->use_rma_win &&
+        mpi_remote_mem_handle->attached) {
+        int win_rank;
+
+        ret = na_mpi_addr_win_rank(na_mpi_addr, &win_rank);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not resolve window rank");
+            goto done;
+        }
+
+        /* Request completes locally, target is flushed on completion */
+        mpi_ret = MPI_Rput(
+            (char *) mpi_local_mem_handle->base + mpi_local_offset, mpi_length,
+            MPI_BYTE, win_rank, mpi_remote_mem_handle->disp + mpi_remote_offset,
+            mpi_length, MPI_BYTE, NA_MPI_CLASS(na_class)->rma_win,
+            &na_mpi_op_id->info.put.data_request);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Rput() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+        na_mpi_op_id->info.put.flush_rank = win_rank;
+    } else {
+        /* Allocate rma info (use calloc to avoid uninitialized transfer) */
+        na_mpi_rma_info = (struct na_mpi_rma_info *) calloc(
+            1, sizeof(struct na_mpi_rma_info));
+        if (!na_mpi_rma_info) {
+            NA_LOG_ERROR("Could not allocate NA MPI RMA info");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        na_mpi_rma_info->op = NA_MPI_RMA_PUT;
+        na_mpi_rma_info->base = mpi_remote_mem_handle->base;
+        na_mpi_rma_info->disp = mpi_remote_offset;
+        na_mpi_rma_info->count = mpi_length;
+        na_mpi_rma_info->tag = na_mpi_gen_rma_tag(na_class);
+        na_mpi_op_id->info.put.rma_info = na_mpi_rma_info;
+
+        /* Post the MPI send request */
+        mpi_ret = MPI_Isend(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
+            MPI_BYTE, na_mpi_addr->rank, NA_MPI_RMA_REQUEST_TAG,
+            na_mpi_addr->rma_comm, &na_mpi_op_id->info.put.rma_request);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Isend() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+
+        /* Simply do a non blocking synchronous send */
+        mpi_ret = MPI_Issend(
+            (char *) mpi_local_mem_handle->base + mpi_local_offset, mpi_length,
+            MPI_BYTE, na_mpi_addr->rank, (int) na_mpi_rma_info->tag,
+            na_mpi_addr->rma_comm, &na_mpi_op_id->info.put.data_request);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Issend() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
     }
 
     /* Append op_id to op_id list */
@@ -1757,39 +1965,63 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_mpi_op_id->info.put.internal_progress = false;
     na_mpi_op_id->info.get.rma_info = NULL;
 
-    /* Allocate rma info (use calloc to avoid uninitialized transfer) */
-    na_mpi_rma_info =
-        (struct na_mpi_rma_info *) calloc(1, sizeof(struct na_mpi_rma_info));
-    if (!na_mpi_rma_info) {
-        NA_LOG_ERROR("Could not allocate NA MPI RMA info");
-        ret = NA_NOMEM_ERROR;
-        goto done;
-    }
-    na_mpi_rma_info->op = NA_MPI_RMA_GET;
-    na_mpi_rma_info->base = mpi_remote_mem_handle->base;
-    na_mpi_rma_info->disp = mpi_remote_offset;
-    na_mpi_rma_info->count = mpi_length;
-    na_mpi_rma_info->tag = na_mpi_gen_rma_tag(na_class);
-    na_mpi_op_id->info.get.rma_info = na_mpi_rma_info;
-
-    /* Post the MPI send request */
-    mpi_ret = MPI_Isend(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
-        MPI_BYTE, na_mpi_addr->rank, NA_MPI_RMA_REQUEST_TAG,
-        na_mpi_addr->rma_comm, &na_mpi_op_id->info.get.rma_request);
-    if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Isend() failed");
-        ret = NA_PROTOCOL_ERROR;
-        goto done;
-    }
+    if (NA_MPI_CLASS(na_class)->use_rma_win &&
+        mpi_remote_mem_handle->attached) {
+        int win_rank;
 
-    /* Simply do an asynchronous recv */
-    mpi_ret = MPI_Irecv((char *) mpi_local_mem_handle->base + mpi_local_offset,
-        mpi_length, MPI_BYTE, na_mpi_addr->rank, (int) na_mpi_rma_info->tag,
-        na_mpi_addr->rma_comm, &na_mpi_op_id->info.get.data_request);
-    if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Irecv() failed");
-        ret = NA_PROTOCOL_ERROR;
-        goto done;
+        ret = na_mpi_addr_win_rank(na_mpi_addr, &win_rank);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not resolve window rank");
+            goto done;
+        }
+
+        /* Data is available once the request completes */
+        mpi_ret = MPI_Rget(
+            (char *) mpi_local_mem_handle->base + mpi_local_offset, mpi_length,
+            MPI_BYTE, win_rank, mpi_remote_mem_handle->disp + mpi_remote_offset,
+            mpi_length, MPI_BYTE, NA_MPI_CLASS(na_class)->rma_win,
+            &na_mpi_op_id->info.get.data_request);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Rget() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+    } else {
+        /* Allocate rma info (use calloc to avoid uninitialized transfer) */
+        na_mpi_rma_info = (struct na_mpi_rma_info *) calloc(
+            1, sizeof(struct na_mpi_rma_info));
+        if (!na_mpi_rma_info) {
+            NA_LOG_ERROR("Could not allocate NA MPI RMA info");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        na_mpi_rma_info->op = NA_MPI_RMA_GET;
+        na_mpi_rma_info->base = mpi_remote_mem_handle->base;
+        na_mpi_rma_info->disp = mpi_remote_offset;
+        na_mpi_rma_info->count = mpi_length;
+        na_mpi_rma_info->tag = na_mpi_gen_rma_tag(na_class);
+        na_mpi_op_id->info.get.rma_info = na_mpi_rma_info;
+
+        /* Post the MPI send request */
+        mpi_ret = MPI_Isend(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
+            MPI_BYTE, na_mpi_addr->rank, NA_MPI_RMA_REQUEST_TAG,
+            na_mpi_addr->rma_comm, &na_mpi_op_id->info.get.rma_request);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Isend() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+
+        /* Simply do an asynchronous recv */
+        mpi_ret = MPI_Irecv(
+            (char *) mpi_local_mem_handle->base + mpi_local_offset, mpi_length,
+            MPI_BYTE, na_mpi_addr->rank, (int) na_mpi_rma_info->tag,
+            na_mpi_addr->rma_comm, &na_mpi_op_id->info.get.data_request);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Irecv() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
     }
 
     /* Append op_id to op_id list */
@@ -1865,48 +2097,41 @@ na_mpi_progress_unexpected(
     hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->remote_list_mutex);
 
     HG_LIST_FOREACH (probe_addr, &NA_MPI_CLASS(na_class)->remote_list, entry) {
-        MPI_Status status1, status2;
+        MPI_Message message = MPI_MESSAGE_NULL;
+        MPI_Status status;
+        bool progressed = false;
         int flag = 0;
 
         /* First look for user unexpected message */
-        mpi_ret = MPI_Iprobe(
-            MPI_ANY_SOURCE, MPI_ANY_TAG, probe_addr->comm, &flag, &status1);
-        if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Iprobe() failed");
-            ret = NA_PROTOCOL_ERROR;
+        ret = na_mpi_progress_unexpected_msg(
+            na_class, context, probe_addr, &progressed);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not make unexpected MSG progress");
             goto done;
         }
-
-        if (flag) {
-            ret = na_mpi_progress_unexpected_msg(
-                na_class, context, probe_addr, &status1);
-            if (ret != NA_SUCCESS) {
-                if (ret != NA_TIMEOUT) {
-                    NA_LOG_ERROR("Could not make unexpected MSG progress");
-                    goto done;
-                }
-            } else
-                break; /* Progressed */
-        }
+        if (progressed)
+            break;
 
         /* Look for internal unexpected RMA requests */
-        mpi_ret = MPI_Iprobe(probe_addr->rank, NA_MPI_RMA_REQUEST_TAG,
-            probe_addr->rma_comm, &flag, &status2);
+        mpi_ret = MPI_Improbe(probe_addr->rank, NA_MPI_RMA_REQUEST_TAG,
+            probe_addr->rma_comm, &flag, &message, &status);
         if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Iprobe() failed");
+            NA_LOG_ERROR("MPI_Improbe() failed");
             ret = NA_PROTOCOL_ERROR;
             goto done;
         }
 
         if (flag) {
             ret = na_mpi_progress_unexpected_rma(
-                na_class, context, probe_addr, &status2);
+                na_class, context, probe_addr, &message, &status);
             if (ret != NA_SUCCESS) {
                 NA_LOG_ERROR("Could not make unexpected RMA progress");
                 goto done;
             } else
                 break; /* Progressed */
         }
+
+        ret = NA_TIMEOUT;
     }
 
 done:
@@ -1919,41 +2144,68 @@ done:
 static na_return_t
 na_mpi_progress_unexpected_msg(na_class_t *na_class,
     na_context_t NA_UNUSED *context, struct na_mpi_addr *na_mpi_addr,
-    const MPI_Status *status)
+    bool *progressed)
 {
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    MPI_Message message = MPI_MESSAGE_NULL;
+    MPI_Status status;
     int unexpected_buf_size = 0;
-    na_return_t ret = NA_TIMEOUT;
-    int mpi_ret;
+    na_return_t ret = NA_SUCCESS;
+    int flag = 0, mpi_ret = MPI_SUCCESS;
 
-    MPI_Get_count(status, MPI_BYTE, &unexpected_buf_size);
-    if (unexpected_buf_size >
-        (int) na_mpi_msg_get_max_unexpected_size(na_class)) {
-        NA_LOG_ERROR("Exceeding unexpected MSG size");
-        ret = NA_SIZE_ERROR;
+    /* A matched message must be received, so only match one if an unexpected
+     * recv is posted and dequeue it atomically with the match */
+    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+    if (!HG_QUEUE_IS_EMPTY(&NA_MPI_CLASS(na_class)->unexpected_op_queue)) {
+        mpi_ret = MPI_Improbe(MPI_ANY_SOURCE, MPI_ANY_TAG, na_mpi_addr->comm,
+            &flag, &message, &status);
+        if (mpi_ret == MPI_SUCCESS && flag) {
+            na_mpi_op_id =
+                HG_QUEUE_FIRST(&NA_MPI_CLASS(na_class)->unexpected_op_queue);
+            HG_QUEUE_POP_HEAD(
+                &NA_MPI_CLASS(na_class)->unexpected_op_queue, entry);
+        }
+    }
+    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->unexpected_op_queue_mutex);
+
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Improbe() failed");
+        ret = NA_PROTOCOL_ERROR;
         goto done;
     }
+    if (!na_mpi_op_id)
+        goto done; /* Nothing to receive */
 
-    /* Try to pop an unexpected recv op id */
-    na_mpi_op_id = na_mpi_msg_unexpected_op_pop(na_class);
-    if (!na_mpi_op_id) {
-        /* Can't process it since nobody has posted an unexpected recv yet */
+    *progressed = true;
+
+    MPI_Get_count(&status, MPI_BYTE, &unexpected_buf_size);
+    if (unexpected_buf_size > na_mpi_op_id->info.recv_unexpected.buf_size) {
+        void *drop_buf = malloc((size_t) unexpected_buf_size);
+
+        NA_LOG_ERROR("Exceeding unexpected MSG size");
+        /* Drop matched message and repost the recv */
+        if (drop_buf)
+            MPI_Mrecv(drop_buf, unexpected_buf_size, MPI_BYTE, &message,
+                MPI_STATUS_IGNORE);
+        free(drop_buf);
+        na_mpi_msg_unexpected_op_push(na_class, na_mpi_op_id);
+        ret = NA_SIZE_ERROR;
         goto done;
     }
 
-    mpi_ret = MPI_Recv(na_mpi_op_id->info.recv_unexpected.buf,
-        na_mpi_op_id->info.recv_unexpected.buf_size, MPI_BYTE,
-        status->MPI_SOURCE, status->MPI_TAG, na_mpi_addr->comm,
+    /* Message has been matched, receive it directly */
+    mpi_ret = MPI_Mrecv(na_mpi_op_id->info.recv_unexpected.buf,
+        na_mpi_op_id->info.recv_unexpected.buf_size, MPI_BYTE, &message,
         MPI_STATUS_IGNORE);
     if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Recv() failed");
+        NA_LOG_ERROR("MPI_Mrecv() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
     na_mpi_op_id->info.recv_unexpected.remote_addr = na_mpi_addr;
-    memcpy(
-        &na_mpi_op_id->info.recv_unexpected.status, status, sizeof(MPI_Status));
+    memcpy(&na_mpi_op_id->info.recv_unexpected.status, &status,
+        sizeof(MPI_Status));
     ret = na_mpi_complete(na_mpi_op_id);
     if (ret != NA_SUCCESS) {
         NA_LOG_ERROR("Could not complete op id");
@@ -1967,7 +2219,8 @@ done:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
-    struct na_mpi_addr *na_mpi_addr, const MPI_Status *status)
+    struct na_mpi_addr *na_mpi_addr, MPI_Message *message,
+    const MPI_Status *status)
 {
     struct na_mpi_rma_info *na_mpi_rma_info = NULL;
     struct na_mpi_op_id *na_mpi_op_id = NULL;
@@ -1991,12 +2244,11 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Recv message (already arrived) */
-    mpi_ret = MPI_Recv(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
-        MPI_BYTE, status->MPI_SOURCE, status->MPI_TAG, na_mpi_addr->rma_comm,
-        MPI_STATUS_IGNORE);
+    /* Recv matched message (already arrived) */
+    mpi_ret = MPI_Mrecv(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
+        MPI_BYTE, message, MPI_STATUS_IGNORE);
     if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Recv() failed");
+        NA_LOG_ERROR("MPI_Mrecv() failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
@@ -2023,6 +2275,7 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
             na_mpi_op_id->info.put.data_request = MPI_REQUEST_NULL;
             na_mpi_op_id->info.put.internal_progress = true;
             na_mpi_op_id->info.put.rma_info = na_mpi_rma_info;
+            na_mpi_op_id->info.put.flush_rank = -1;
 
             mpi_ret = MPI_Irecv(
                 (char *) na_mpi_rma_info->base + na_mpi_rma_info->disp,
@@ -2080,19 +2333,19 @@ static na_return_t
 na_mpi_progress_expected(na_class_t *na_class, na_context_t NA_UNUSED *context,
     unsigned int NA_UNUSED timeout)
 {
+    struct na_mpi_class *na_mpi_class = NA_MPI_CLASS(na_class);
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    int count = 0, outcount = 0, i;
     na_return_t ret = NA_TIMEOUT;
+    int mpi_ret;
 
-    hg_thread_mutex_lock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    hg_thread_mutex_lock(&na_mpi_class->op_id_list_mutex);
 
-    na_mpi_op_id = HG_LIST_FIRST(&NA_MPI_CLASS(na_class)->op_id_list);
-    while (na_mpi_op_id) {
+    /* Gather pending requests so that they can all be tested at once */
+    HG_LIST_FOREACH (na_mpi_op_id, &na_mpi_class->op_id_list, entry) {
         MPI_Request *request = NULL;
-        bool internal = false; /* Only used to complete internal ops */
-        struct na_mpi_rma_info **rma_info = NULL;
+        MPI_Status *status = NULL;
         bool complete_op_id = true;
-        int flag = 0, mpi_ret = 0;
-        MPI_Status *status = MPI_STATUS_IGNORE;
 
         /* If the op_id is marked as completed, something is wrong */
         if (hg_atomic_get32(&na_mpi_op_id->completed)) {
@@ -2101,77 +2354,63 @@ na_mpi_progress_expected(na_class_t *na_class, na_context_t NA_UNUSED *context,
             goto done;
         }
 
-        switch (na_mpi_op_id->type) {
-            case NA_CB_RECV_UNEXPECTED:
-                NA_LOG_ERROR("Should not complete unexpected recv here");
-                break;
-            case NA_CB_SEND_UNEXPECTED:
-                request = &na_mpi_op_id->info.send_unexpected.data_request;
-                break;
-            case NA_CB_RECV_EXPECTED:
-                status = &na_mpi_op_id->info.recv_expected.status;
-                request = &na_mpi_op_id->info.recv_expected.data_request;
-                break;
-            case NA_CB_SEND_EXPECTED:
-                request = &na_mpi_op_id->info.send_expected.data_request;
-                break;
-            case NA_CB_PUT:
-                if (na_mpi_op_id->info.put.internal_progress) {
-                    request = &na_mpi_op_id->info.put.data_request;
-                    rma_info = &na_mpi_op_id->info.put.rma_info;
-                    internal = true;
-                } else {
-                    request = &na_mpi_op_id->info.put.rma_request;
-                    if (*request != MPI_REQUEST_NULL) {
-                        complete_op_id = false;
-                    } else {
-                        request = &na_mpi_op_id->info.put.data_request;
-                    }
-                }
-                break;
-            case NA_CB_GET:
-                if (na_mpi_op_id->info.get.internal_progress) {
-                    request = &na_mpi_op_id->info.get.data_request;
-                    rma_info = &na_mpi_op_id->info.get.rma_info;
-                    internal = true;
-                } else {
-                    request = &na_mpi_op_id->info.get.rma_request;
-                    if (*request != MPI_REQUEST_NULL) {
-                        complete_op_id = false;
-                    } else {
-                        request = &na_mpi_op_id->info.get.data_request;
-                    }
-                }
-                break;
-            default:
-                NA_LOG_ERROR("Unknown type of operation ID");
-                ret = NA_PROTOCOL_ERROR;
-                goto done;
-        }
+        request = na_mpi_op_id_request(na_mpi_op_id, &status, &complete_op_id);
 
         /* If request is MPI_REQUEST_NULL, the operation should be completed */
-        if (!request || (request && (*request == MPI_REQUEST_NULL))) {
+        if (!request || (*request == MPI_REQUEST_NULL)) {
             NA_LOG_ERROR("NULL request found");
             ret = NA_PROTOCOL_ERROR;
             goto done;
         }
 
-        mpi_ret = MPI_Test(request, &flag, status);
-        if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Test() failed");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
-        if (!flag) {
-            na_mpi_op_id = HG_LIST_NEXT(na_mpi_op_id, entry);
-            continue;
+        if ((size_t) count == na_mpi_class->test_count_max) {
+            ret = na_mpi_test_resize(na_mpi_class,
+                (count > 0) ? (size_t) count * 2 : NA_MPI_TEST_COUNT_MIN);
+            if (ret != NA_SUCCESS) {
+                NA_LOG_ERROR("Could not resize test arrays");
+                goto done;
+            }
+            ret = NA_TIMEOUT;
         }
+        na_mpi_class->test_op_ids[count] = na_mpi_op_id;
+        na_mpi_class->test_requests[count] = *request;
+        count++;
+    }
+    if (count == 0)
+        goto done;
+
+    mpi_ret = MPI_Testsome(count, na_mpi_class->test_requests, &outcount,
+        na_mpi_class->test_indices, na_mpi_class->test_statuses);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Testsome() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    if (outcount == MPI_UNDEFINED)
+        goto done;
+
+    for (i = 0; i < outcount; i++) {
+        MPI_Request *request = NULL;
+        MPI_Status *status = NULL;
+        bool complete_op_id = true;
 
+        na_mpi_op_id = na_mpi_class->test_op_ids[na_mpi_class->test_indices[i]];
+        request = na_mpi_op_id_request(na_mpi_op_id, &status, &complete_op_id);
         *request = MPI_REQUEST_NULL;
+        if (status)
+            memcpy(status, &na_mpi_class->test_statuses[i], sizeof(MPI_Status));
 
         /* If internal operation call release directly otherwise add callback
          * to completion queue */
-        if (internal) {
+        if ((na_mpi_op_id->type == NA_CB_PUT &&
+                na_mpi_op_id->info.put.internal_progress) ||
+            (na_mpi_op_id->type == NA_CB_GET &&
+                na_mpi_op_id->info.get.internal_progress)) {
+            struct na_mpi_rma_info **rma_info =
+                (na_mpi_op_id->type == NA_CB_PUT)
+                    ? &na_mpi_op_id->info.put.rma_info
+                    : &na_mpi_op_id->info.get.rma_info;
+
             hg_atomic_set32(&na_mpi_op_id->completed, 1);
             /* Remove entry from list */
             HG_LIST_REMOVE(na_mpi_op_id, entry);
@@ -2180,10 +2419,21 @@ na_mpi_progress_expected(na_class_t *na_class, na_context_t NA_UNUSED *context,
             *rma_info = NULL;
             na_mpi_op_destroy(na_class, (na_op_id_t *) na_mpi_op_id);
         } else {
-            if (!complete_op_id) {
-                na_mpi_op_id = HG_LIST_NEXT(na_mpi_op_id, entry);
+            if (!complete_op_id)
                 continue;
+
+            /* Put is only locally complete, wait for remote completion */
+            if (na_mpi_op_id->type == NA_CB_PUT &&
+                na_mpi_op_id->info.put.flush_rank >= 0) {
+                mpi_ret = MPI_Win_flush(
+                    na_mpi_op_id->info.put.flush_rank, na_mpi_class->rma_win);
+                if (mpi_ret != MPI_SUCCESS) {
+                    NA_LOG_ERROR("MPI_Win_flush() failed");
+                    ret = NA_PROTOCOL_ERROR;
+                    goto done;
+                }
             }
+
             /* Remove entry from list */
             HG_LIST_REMOVE(na_mpi_op_id, entry);
 
@@ -2194,14 +2444,102 @@ na_mpi_progress_expected(na_class_t *na_class, na_context_t NA_UNUSED *context,
             }
         }
         ret = NA_SUCCESS; /* progressed */
-        break;
     }
 
 done:
-    hg_thread_mutex_unlock(&NA_MPI_CLASS(na_class)->op_id_list_mutex);
+    hg_thread_mutex_unlock(&na_mpi_class->op_id_list_mutex);
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static MPI_Request *
+na_mpi_op_id_request(struct na_mpi_op_id *na_mpi_op_id, MPI_Status **status,
+    bool *complete_op_id)
+{
+    MPI_Request *request = NULL;
+
+    switch (na_mpi_op_id->type) {
+        case NA_CB_RECV_UNEXPECTED:
+            NA_LOG_ERROR("Should not complete unexpected recv here");
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+            request = &na_mpi_op_id->info.send_unexpected.data_request;
+            break;
+        case NA_CB_RECV_EXPECTED:
+            *status = &na_mpi_op_id->info.recv_expected.status;
+            request = &na_mpi_op_id->info.recv_expected.data_request;
+            break;
+        case NA_CB_SEND_EXPECTED:
+            request = &na_mpi_op_id->info.send_expected.data_request;
+            break;
+        case NA_CB_PUT:
+            if (na_mpi_op_id->info.put.internal_progress)
+                request = &na_mpi_op_id->info.put.data_request;
+            else {
+                request = &na_mpi_op_id->info.put.rma_request;
+                if (*request != MPI_REQUEST_NULL)
+                    *complete_op_id = false;
+                else
+                    request = &na_mpi_op_id->info.put.data_request;
+            }
+            break;
+        case NA_CB_GET:
+            if (na_mpi_op_id->info.get.internal_progress)
+                request = &na_mpi_op_id->info.get.data_request;
+            else {
+                request = &na_mpi_op_id->info.get.rma_request;
+                if (*request != MPI_REQUEST_NULL)
+                    *complete_op_id = false;
+                else
+                    request = &na_mpi_op_id->info.get.data_request;
+            }
+            break;
+        default:
+            NA_LOG_ERROR("Unknown type of operation ID");
+            break;
+    }
+
+    return request;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_test_resize(struct na_mpi_class *na_mpi_class, size_t count)
+{
+    struct na_mpi_op_id **op_ids;
+    MPI_Request *requests;
+    MPI_Status *statuses;
+    int *indices;
+
+    op_ids = (struct na_mpi_op_id **) realloc(
+        na_mpi_class->test_op_ids, count * sizeof(*op_ids));
+    if (!op_ids)
+        return NA_NOMEM_ERROR;
+    na_mpi_class->test_op_ids = op_ids;
+
+    requests = (MPI_Request *) realloc(
+        na_mpi_class->test_requests, count * sizeof(*requests));
+    if (!requests)
+        return NA_NOMEM_ERROR;
+    na_mpi_class->test_requests = requests;
+
+    statuses = (MPI_Status *) realloc(
+        na_mpi_class->test_statuses, count * sizeof(*statuses));
+    if (!statuses)
+        return NA_NOMEM_ERROR;
+    na_mpi_class->test_statuses = statuses;
+
+    indices =
+        (int *) realloc(na_mpi_class->test_indices, count * sizeof(*indices));
+    if (!indices)
+        return NA_NOMEM_ERROR;
+    na_mpi_class->test_indices = indices;
+
+    na_mpi_class->test_count_max = count;
+
+    return NA_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_complete(struct na_mpi_op_id *na_mpi_op_id)
@@ -2258,6 +2596,7 @@ na_mpi_complete(struct na_mpi_op_id *na_mpi_op_id)
             na_mpi_addr->comm = na_mpi_remote_addr->comm;
             na_mpi_addr->rma_comm = na_mpi_remote_addr->rma_comm;
             na_mpi_addr->rank = status->MPI_SOURCE;
+            na_mpi_addr->win_rank = -1;
             na_mpi_addr->unexpected = true;
             na_mpi_addr->self = false;
             na_mpi_addr->dynamic = true;
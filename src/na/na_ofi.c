@@ -13,6 +13,7 @@
 #    include "na_loc.h"
 #endif
 
+#include "mercury_backoff.h"
 #include "mercury_hash_string.h"
 #include "mercury_hash_table.h"
 #include "mercury_inet.h"
@@ -26,6 +27,7 @@
 #include "mercury_time.h"
 
 #include <rdma/fabric.h>
+#include <rdma/fi_atomic.h>
 #include <rdma/fi_cm.h>
 #include <rdma/fi_domain.h>
 #include <rdma/fi_endpoint.h>
@@ -33,6 +35,7 @@
 #include <rdma/fi_ext.h>
 #include <rdma/fi_rma.h>
 #include <rdma/fi_tagged.h>
+#include <rdma/fi_trigger.h>
 #ifdef NA_OFI_HAS_EXT_GNI_H
 #    include <rdma/fi_ext_gni.h>
 #endif
@@ -182,7 +185,7 @@
       FI_ADDR_PSMX2,                                                           \
       FI_PROGRESS_MANUAL,                                                      \
       FI_PROTO_PSMX2,                                                          \
-      FI_SOURCE | FI_SOURCE_ERR | FI_MULTI_RECV,                               \
+      FI_SOURCE | FI_SOURCE_ERR | FI_MULTI_RECV | FI_ATOMIC,                   \
       NA_OFI_SIGNAL | NA_OFI_SEP | NA_OFI_LOC_INFO                             \
     )                                                                          \
     X(NA_OFI_PROV_OPX,                                                         \
@@ -212,7 +215,7 @@
       FI_ADDR_GNI,                                                             \
       FI_PROGRESS_AUTO,                                                        \
       FI_PROTO_GNI,                                                            \
-      FI_SOURCE | FI_SOURCE_ERR | FI_MULTI_RECV,                               \
+      FI_SOURCE | FI_SOURCE_ERR | FI_MULTI_RECV | FI_ATOMIC,                   \
       NA_OFI_WAIT_SET | NA_OFI_SIGNAL | NA_OFI_SEP                             \
     )                                                                          \
     X(NA_OFI_PROV_CXI,                                                         \
@@ -222,7 +225,7 @@
       FI_ADDR_CXI,                                                             \
       FI_PROGRESS_MANUAL,                                                      \
       FI_PROTO_CXI,                                                            \
-      FI_MULTI_RECV,                                                           \
+      FI_MULTI_RECV | FI_ATOMIC,                                               \
       NA_OFI_WAIT_FD | NA_OFI_LOC_INFO | NA_OFI_HMEM                           \
     )                                                                          \
     X(NA_OFI_PROV_MAX, "", "", 0, 0, 0, 0, 0, 0)
@@ -293,6 +296,7 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
 #define NA_OFI_HAS_MEM_POOL
 #define NA_OFI_MEM_CHUNK_COUNT (256)
 #define NA_OFI_MEM_BLOCK_COUNT (2)
+#define NA_OFI_MEM_CACHE_COUNT (32) /* Chunks cached per thread */
 
 /* Allocation using hugepages */
 #define NA_OFI_ALLOC_HUGE (NA_ALLOC_MAX)
@@ -302,11 +306,46 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
 #define NA_OFI_TAG_MASK       ((uint64_t) 0x0FFFFFFFF)
 #define NA_OFI_UNEXPECTED_TAG (NA_OFI_TAG_MASK + 1)
 
+/* Rendezvous RTS messages carry NA_OFI_RDV_TAG, FIN messages are matched on
+ * NA_OFI_RDV_FIN_TAG and a per-class sequence number */
+#define NA_OFI_RDV_TAG     (NA_OFI_UNEXPECTED_TAG << 1)
+#define NA_OFI_RDV_FIN_TAG (NA_OFI_UNEXPECTED_TAG << 2)
+
+/* RTS size (unexpected msg header followed by rendezvous header) */
+#define NA_OFI_RDV_RTS_MAX                                                     \
+    (sizeof(union na_ofi_raw_addr) + sizeof(struct na_ofi_rdv_hdr))
+
+/* Ring control messages carry NA_OFI_RING_TAG, requests also carry
+ * NA_OFI_UNEXPECTED_TAG while grants are matched on the request ID */
+#define NA_OFI_RING_TAG (NA_OFI_UNEXPECTED_TAG << 3)
+
+/* Ring limits (per context) and ring header preceding slots */
+#define NA_OFI_RING_SLOT_MAX   (4096)
+#define NA_OFI_RING_MAX        (1024)
+#define NA_OFI_RING_BOUNCE_NUM (64)
+#define NA_OFI_RING_HDR_SIZE   (64) /* Consumed count */
+#define NA_OFI_RING_TX_MAX     (UINT8_MAX + 1)
+
+/* Max number of CQ reads to reap canceled bounce recvs */
+#define NA_OFI_RING_CLOSE_POLL (1000)
+
+/* Remote CQ data of ring writes (ring ID and slot index) */
+#define NA_OFI_RING_DATA(_ring_id, _slot)                                      \
+    (((uint64_t) (_ring_id) << 16) | (uint64_t) (_slot))
+
+/* Control msg size (unexpected msg header followed by control msg) */
+#define NA_OFI_RING_CTL_MAX                                                    \
+    (sizeof(union na_ofi_raw_addr) + sizeof(struct na_ofi_ring_ctl))
+
 /* Default OP multi CQ size */
 #define NA_OFI_OP_MULTI_CQ_SIZE (64)
 
-/* Number of CQ event provided for fi_cq_read() */
+/* Min number of CQ events provided for fi_cq_read(), the number of events
+ * read at once grows up to the max while the CQ keeps returning full batches
+ * and shrinks back when it does not */
 #define NA_OFI_CQ_EVENT_NUM (16)
+/* Default max number of CQ events provided for fi_cq_read() */
+#define NA_OFI_CQ_EVENT_MAX (256)
 /**
  * CQ default provider sizes:
  * - tcp: 1024
@@ -319,6 +358,11 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
 #define NA_OFI_CQ_DEPTH (131072)
 /* CQ max err data size (fix to 48 to work around bug in gni provider code) */
 #define NA_OFI_CQ_MAX_ERR_DATA_SIZE (48)
+/* Default max number of unused registrations kept in MR cache */
+#define NA_OFI_MR_CACHE_UNUSED_MAX (64)
+
+/* Number of entries of per-context source address cache (power of 2) */
+#define NA_OFI_ADDR_CACHE_SIZE (64)
 
 /* Uncomment to register SGL regions */
 // #define NA_OFI_USE_REGV
@@ -335,10 +379,15 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
 #define NA_OFI_OP_CANCELED  (1 << 2)
 #define NA_OFI_OP_QUEUED    (1 << 3)
 #define NA_OFI_OP_ERRORED   (1 << 4)
+#define NA_OFI_OP_RING      (1 << 5) /* Waiting for a ring msg */
 
 /* Timeout (ms) until we give up on retry */
 #define NA_OFI_OP_RETRY_TIMEOUT (120 * 1000)
 
+/* Bounds of delay (us) between retries while ops keep returning NA_AGAIN */
+#define NA_OFI_OP_RETRY_BACKOFF_MIN (1)
+#define NA_OFI_OP_RETRY_BACKOFF_MAX (128)
+
 /* Private data access */
 #define NA_OFI_CLASS(x)   ((struct na_ofi_class *) ((x)->plugin_class))
 #define NA_OFI_CONTEXT(x) ((struct na_ofi_context *) ((x)->plugin_context))
@@ -351,7 +400,8 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
         .service = NULL,                                                       \
         .src_addr = NULL,                                                      \
         .src_addrlen = 0,                                                      \
-        .use_hmem = false})
+        .use_hmem = false,                                                     \
+        .use_trigger = false})
 
 /* Get IOV */
 #define NA_OFI_IOV(iov, iovcnt) (iovcnt > NA_OFI_IOV_STATIC_MAX) ? iov.d : iov.s
@@ -383,6 +433,7 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
             na_ofi_addr_ref_incr(_addr);                                       \
         _op->retry_op.msg = NULL;                                              \
         _op->fi_op_flags = _fi_op_flags;                                       \
+        _op->rdv.state = NA_OFI_RDV_NONE;                                      \
         _op->callback = _cb;                                                   \
         _op->arg = _arg;                                                       \
         _op->type = _cb_type;                                                  \
@@ -391,6 +442,7 @@ static unsigned long const na_ofi_prov_flags[] = {NA_OFI_PROV_TYPES};
 
 #define NA_OFI_OP_RELEASE(_op)                                                 \
     do {                                                                       \
+        na_ofi_rdv_release(_op);                                               \
         if (_op->addr)                                                         \
             na_ofi_addr_ref_decr(_op->addr);                                   \
         hg_atomic_set32(&_op->status, NA_OFI_OP_COMPLETED);                    \
@@ -520,8 +572,11 @@ struct na_ofi_addr {
     struct na_ofi_addr_key addr_key;   /* Address key               */
     HG_QUEUE_ENTRY(na_ofi_addr) entry; /* Entry in addr pool        */
     struct na_ofi_class *class;        /* Class                     */
+    struct na_ofi_addr **ep_addrs;     /* Per-context EP addrs      */
+    struct na_ofi_ring_tx **ring_tx;   /* Per-context remote rings  */
     fi_addr_t fi_addr;                 /* FI address                */
     hg_atomic_int32_t refcount;        /* Reference counter         */
+    bool ep_base;                      /* Addr of a base endpoint   */
 };
 
 /* Message buffer info */
@@ -550,8 +605,9 @@ struct na_ofi_mem_desc {
 
 /* Memory handle */
 struct na_ofi_mem_handle {
-    struct na_ofi_mem_desc desc; /* Memory descriptor        */
-    struct fid_mr *fi_mr;        /* FI MR handle             */
+    struct na_ofi_mem_desc desc;                  /* Memory descriptor       */
+    struct fid_mr *fi_mr;                         /* FI MR handle            */
+    struct na_ofi_mr_cache_entry *mr_cache_entry; /* MR cache entry, if any  */
 };
 
 /* Msg info */
@@ -594,6 +650,136 @@ struct na_ofi_rma_info {
     } remote_iov_storage;
     struct fi_rma_iov *remote_iov;
     size_t remote_iovcnt;
+    struct na_ofi_rma_deferred *deferred; /* Set if posted as triggered op */
+    uint64_t remote_cq_data; /* Sent with FI_REMOTE_CQ_DATA */
+};
+
+/* Atomic info (operands must remain valid until completion) */
+struct na_ofi_atomic_info {
+    enum fi_op fi_atomic_op; /* FI_SUM or FI_CSWAP */
+    fi_addr_t fi_addr;       /* Remote address */
+    uint64_t remote_addr;    /* Remote operand address */
+    uint64_t remote_key;     /* Remote key */
+    uint64_t operand;        /* Operand */
+    uint64_t compare;        /* Compare value (FI_CSWAP) */
+    uint64_t result;         /* Fetched value */
+};
+
+/* Deferred RMA (triggered op queued on the domain) */
+struct na_ofi_rma_deferred {
+    struct fi_deferred_work work; /* Deferred work */
+    struct fi_op_rma op;          /* RMA op to trigger */
+    struct fid_domain *fi_domain; /* Domain that work is queued on */
+};
+
+/* Rendezvous protocol step */
+enum na_ofi_rdv_state {
+    NA_OFI_RDV_NONE,     /* Eager message */
+    NA_OFI_RDV_RTS,      /* Sender: RTS posted */
+    NA_OFI_RDV_WAIT_FIN, /* Sender: waiting for FIN */
+    NA_OFI_RDV_READ,     /* Receiver: reading payload */
+    NA_OFI_RDV_FIN       /* Receiver: FIN posted */
+};
+
+/* Rendezvous header sent in RTS */
+struct na_ofi_rdv_hdr {
+    uint64_t addr;       /* Remote address of payload */
+    uint64_t key;        /* Remote key of payload */
+    uint64_t len;        /* Payload size */
+    uint32_t fin_id;     /* FIN sequence number */
+    uint32_t context_id; /* Sender context ID */
+};
+
+/* Rendezvous info */
+struct na_ofi_rdv_info {
+    struct na_ofi_mem_handle mem_handle; /* Payload registration (sender) */
+    struct na_ofi_rdv_hdr hdr;           /* Header sent or received */
+    char rts[NA_OFI_RDV_RTS_MAX];        /* RTS buffer (sender) */
+    enum na_ofi_rdv_state state;         /* Current step */
+};
+
+/* Ring state (sender) */
+enum na_ofi_ring_state {
+    NA_OFI_RING_NONE,      /* Not requested yet */
+    NA_OFI_RING_REQUESTED, /* REQ sent, waiting for GRANT */
+    NA_OFI_RING_GRANTED,   /* Ring can be written */
+    NA_OFI_RING_DENIED     /* Target has no ring for us */
+};
+
+/* Ring slot state (receiver) */
+enum na_ofi_ring_slot_state {
+    NA_OFI_RING_SLOT_FREE, /* Can be written by sender */
+    NA_OFI_RING_SLOT_FULL, /* Written, not received yet */
+    NA_OFI_RING_SLOT_DONE  /* Received, not released in order yet */
+};
+
+/* Ring control message (REQ and GRANT) */
+struct na_ofi_ring_ctl {
+    uint64_t addr;       /* GRANT: remote address of ring */
+    uint64_t key;        /* GRANT: remote key of ring */
+    uint32_t req_id;     /* Request ID, GRANT is matched on it */
+    uint32_t slot_size;  /* GRANT: slot size (header included) */
+    uint16_t ring_id;    /* GRANT: ring ID */
+    uint16_t slot_num;   /* GRANT: number of slots (0 if denied) */
+    uint32_t context_id; /* Sender context ID */
+};
+
+/* Ring slot header, followed by payload */
+struct na_ofi_ring_slot_hdr {
+    uint32_t len; /* Payload size */
+    uint32_t tag; /* Msg tag */
+};
+
+/* Ring granted by a remote context (sender) */
+struct na_ofi_ring_tx {
+    uint64_t addr;                /* Remote address of ring */
+    uint64_t key;                 /* Remote key of ring */
+    uint64_t head;                /* Next slot sequence number */
+    uint64_t consumed;            /* Last consumed count read */
+    size_t slot_size;             /* Slot size (header included) */
+    enum na_ofi_ring_state state; /* Ring state */
+    uint16_t ring_id;             /* Ring ID */
+    uint16_t slot_num;            /* Number of slots */
+    bool reading;                 /* Consumed count being read */
+};
+
+/* Msg received but not matched yet (receiver) */
+struct na_ofi_ring_msg {
+    HG_QUEUE_ENTRY(na_ofi_ring_msg) entry; /* Entry in msg queue */
+    struct na_ofi_ring *ring;              /* Ring holding msg */
+    struct na_ofi_ring_op *bounce;         /* Or bounce recv holding msg */
+    struct na_ofi_addr *addr;              /* Source address (ref held) */
+    const char *buf;                       /* Payload */
+    size_t len;                            /* Payload size */
+    uint64_t tag;                          /* Msg tag */
+    uint16_t slot;                         /* Ring slot */
+};
+
+/* Ring granted to a remote sender (receiver) */
+struct na_ofi_ring {
+    struct na_ofi_mem_handle mem_handle; /* Ring registration */
+    struct na_ofi_ring_msg *msgs;        /* Per-slot msgs */
+    struct na_ofi_addr *addr;            /* Sender address */
+    void *buf;                           /* Ring header followed by slots */
+    volatile uint64_t *consumed_p;       /* Consumed count read by sender */
+    char *slots;                         /* First slot */
+    uint8_t *slot_states;                /* Per-slot states */
+    size_t slot_size;                    /* Slot size (header included) */
+    uint64_t consumed;                   /* Slots released in order */
+    uint16_t id;                         /* Ring ID */
+    uint16_t slot_num;                   /* Number of slots */
+};
+
+/* Context rings and unexpected recvs (receiver) */
+struct na_ofi_ring_rx {
+    HG_QUEUE_HEAD(na_ofi_op_id) recv_queue;   /* Unexpected recvs posted */
+    HG_QUEUE_HEAD(na_ofi_ring_msg) msg_queue; /* Msgs not received yet */
+    struct na_ofi_ring *rings[NA_OFI_RING_MAX];
+    struct na_ofi_ring_op *bounce_ops[NA_OFI_RING_BOUNCE_NUM];
+    hg_thread_spin_t lock;   /* Queue and ring lock */
+    unsigned int ring_count; /* Ring IDs used */
+    bool started;            /* Bounce recvs posted */
+    bool closing;            /* Context being destroyed */
 };
 
 struct na_ofi_completion_multi {
@@ -614,10 +800,13 @@ struct na_ofi_op_id {
     union {
         struct na_ofi_msg_info msg;     /* Msg info (tagged and non-tagged) */
         struct na_ofi_rma_info rma;     /* RMA info */
+        struct na_ofi_atomic_info atomic; /* Atomic info */
     } info;                             /* Op info                  */
     HG_QUEUE_ENTRY(na_ofi_op_id) multi; /* Entry in multi queue     */
     HG_QUEUE_ENTRY(na_ofi_op_id) retry; /* Entry in retry queue     */
     struct fi_context fi_ctx[2];        /* Context handle           */
+    struct na_ofi_rdv_info rdv;         /* Rendezvous info          */
+    struct na_ofi_ring_slot_hdr ring_hdr; /* Ring slot header (sender) */
     hg_time_t retry_deadline;           /* Retry deadline           */
     hg_time_t retry_last;               /* Last retry time          */
     struct na_ofi_class *na_ofi_class;  /* NA class associated      */
@@ -628,15 +817,39 @@ struct na_ofi_op_id {
             struct fid_ep *, const struct na_ofi_msg_info *, void *);
         na_return_t (*rma)(
             struct fid_ep *, const struct na_ofi_rma_info *, void *);
+        na_return_t (*atomic)(
+            struct fid_ep *, const struct na_ofi_atomic_info *, void *);
     } retry_op; /* Operation used for retries */
     void (*complete)(struct na_ofi_op_id *, bool, na_return_t); /* Complete */
     struct na_cb_completion_data *completion_data; /* Completion data */
+    struct na_ofi_rma_deferred *rma_deferred; /* Deferred RMA storage */
     uint64_t fi_op_flags;     /* Operation flags          */
     na_cb_t callback;         /* Operation callback       */
     void *arg;                /* Callback args            */
     na_cb_type_t type;        /* Operation type           */
     hg_atomic_int32_t status; /* Operation status         */
     bool multi_event;         /* Triggers multiple events */
+    bool ring_op;             /* Internal ring operation  */
+};
+
+/* Internal ring operation */
+enum na_ofi_ring_op_type {
+    NA_OFI_RING_OP_BOUNCE, /* Receiver: unexpected msg and REQ recv */
+    NA_OFI_RING_OP_GRANT,  /* Receiver: GRANT send */
+    NA_OFI_RING_OP_REQ,    /* Sender: REQ send */
+    NA_OFI_RING_OP_WAIT,   /* Sender: GRANT recv */
+    NA_OFI_RING_OP_CREDIT  /* Sender: consumed count read */
+};
+
+struct na_ofi_ring_op {
+    struct na_ofi_op_id op_id;     /* Operation ID */
+    struct na_ofi_ring_msg msg;    /* Bounce: msg held */
+    struct na_ofi_ring_tx *tx;     /* Sender: ring state */
+    char *buf;                     /* Bounce: recv buffer */
+    uint64_t consumed;             /* Credit: consumed count read */
+    char ctl[NA_OFI_RING_CTL_MAX]; /* Control msg buffer */
+    enum na_ofi_ring_op_type type; /* Operation type */
+    bool posted;                   /* Bounce: recv posted */
 };
 
 /* Op ID queue */
@@ -649,17 +862,34 @@ struct na_ofi_op_queue {
 struct na_ofi_eq {
     struct fid_cq *fi_cq;                   /* CQ handle                */
     struct na_ofi_op_queue *retry_op_queue; /* Retry op queue           */
+    struct hg_backoff retry_backoff;        /* Retry backoff (locked)   */
     struct fid_wait *fi_wait;               /* Optional wait set handle */
 };
 
+/* Source address cache entry */
+struct na_ofi_addr_cache_entry {
+    struct na_ofi_addr *addr; /* Cached address */
+    fi_addr_t fi_addr;        /* FI addr of cached address */
+    int32_t gen;              /* Map generation when cached */
+};
+
 /* Context */
 struct na_ofi_context {
     struct na_ofi_op_queue multi_op_queue; /* To keep track of multi-events */
+    struct na_ofi_endpoint *endpoint;      /* Context endpoint (multi-EP)   */
     struct fid_ep *fi_tx;                  /* Transmit context handle       */
     struct fid_ep *fi_rx;                  /* Receive context handle        */
     struct na_ofi_eq *eq;                  /* Event queues                  */
-    hg_atomic_int32_t multi_op_count;      /* Number of multi-events ops    */
-    uint8_t idx;                           /* Context index                 */
+    struct fi_cq_tagged_entry *cq_events;  /* CQ events read buffer         */
+    fi_addr_t *cq_src_addrs;               /* CQ events source addresses    */
+    size_t cq_event_num;                   /* Current CQ read batch size    */
+    struct na_ofi_addr_cache_entry
+        addr_cache[NA_OFI_ADDR_CACHE_SIZE]; /* Recent source addresses   */
+    struct fid_cntr *rma_cntr;              /* Deferred RMA counter      */
+    struct na_ofi_ring_rx *ring_rx;         /* Rings (listening class)   */
+    hg_atomic_int64_t rma_posted;           /* Deferred RMA ops posted   */
+    hg_atomic_int32_t multi_op_count;       /* Number of multi-events ops */
+    uint8_t idx;                            /* Context index             */
 };
 
 /* Endpoint */
@@ -673,9 +903,10 @@ struct na_ofi_endpoint {
 
 /* Map (used to cache addresses) */
 struct na_ofi_map {
-    hg_thread_rwlock_t lock;
+    hg_thread_brlock_t lock;
     hg_hash_table_t *key_map; /* Primary */
     hg_hash_table_t *fi_map;  /* Secondary */
+    hg_atomic_int32_t gen;    /* Incremented on removal */
 };
 
 #ifndef NA_OFI_HAS_EXT_GNI_H
@@ -707,6 +938,34 @@ union na_ofi_auth_key {
 };
 
 /* Domain */
+/* MR cache key */
+struct na_ofi_mr_cache_key {
+    const void *base; /* Base address of region */
+    size_t len;       /* Size of region */
+    uint64_t access;  /* FI access flags */
+    uint64_t device;  /* Device ID */
+    int iface;        /* FI HMEM iface */
+};
+
+/* MR cache entry */
+struct na_ofi_mr_cache_entry {
+    struct na_ofi_mr_cache_key key;              /* Registration key */
+    HG_QUEUE_ENTRY(na_ofi_mr_cache_entry) entry; /* Entry in unused queue */
+    struct fid_mr *fi_mr;                        /* FI MR handle */
+    int32_t refcount; /* Number of handles using that MR (cache lock) */
+};
+
+/* MR cache */
+struct na_ofi_mr_cache {
+    HG_QUEUE_HEAD(na_ofi_mr_cache_entry) unused; /* Unused MRs, oldest first */
+    hg_thread_mutex_t lock;                      /* Cache lock */
+    hg_hash_table_t *map;                        /* Key to entry map */
+    hg_atomic_int32_t *hit_count;  /* Number of registrations reused */
+    hg_atomic_int32_t *miss_count; /* Number of new registrations */
+    unsigned int unused_count;     /* Number of unused MRs */
+    unsigned int unused_max;       /* Max number of unused MRs kept */
+};
+
 struct na_ofi_domain {
     HG_LIST_ENTRY(na_ofi_domain) entry; /* Entry in domain list */
     const struct na_ofi_fabric *fabric; /* Associated fabric */
@@ -714,6 +973,7 @@ struct na_ofi_domain {
     union na_ofi_auth_key auth_key;     /* Auth key */
     struct fid_domain *fi_domain;       /* Domain handle */
     struct fid_av *fi_av;               /* Address vector handle */
+    struct na_ofi_mr_cache *mr_cache;   /* MR cache (NULL if disabled) */
     char *name;                         /* Domain name */
     size_t context_max;                 /* Max contexts available */
     hg_atomic_int64_t requested_key; /* Requested key if not FI_MR_PROV_KEY */
@@ -750,6 +1010,16 @@ struct na_ofi_info {
     void *src_addr;                /* Native src addr */
     size_t src_addrlen;            /* Native src addr len */
     bool use_hmem;                 /* Use FI_HMEM */
+    bool use_trigger;              /* Use FI_TRIGGER */
+};
+
+/* Cached fi_getinfo() result */
+struct na_ofi_getinfo_entry {
+    HG_LIST_ENTRY(na_ofi_getinfo_entry) entry; /* Entry in getinfo cache */
+    struct fi_info *providers;                 /* Providers returned */
+    struct na_ofi_info info;                   /* Info passed (if has_info) */
+    enum na_ofi_prov_type prov_type;           /* Provider type */
+    bool has_info;                             /* Info was passed */
 };
 
 /* Verify info */
@@ -762,28 +1032,54 @@ struct na_ofi_verify_info {
 
 /* OFI class */
 struct na_ofi_class {
-    struct na_ofi_addr_pool addr_pool; /* Addr pool                */
     struct fi_info *fi_info;           /* OFI info                 */
     struct na_ofi_fabric *fabric;      /* Fabric pointer           */
     struct na_ofi_domain *domain;      /* Domain pointer           */
     struct na_ofi_endpoint *endpoint;  /* Endpoint pointer         */
+    na_class_t *na_class;              /* NA class (peer errors)   */
     struct hg_mem_pool *send_pool;     /* Msg send buf pool        */
     struct hg_mem_pool *recv_pool;     /* Msg recv buf pool        */
+    hg_atomic_int64_t *cq_read_count;  /* Non-empty CQ reads       */
+    hg_atomic_int64_t *cq_event_count; /* CQ events read           */
+    hg_atomic_int64_t *retry_count;    /* Ops pushed for retry     */
+    hg_atomic_int64_t *retry_again;    /* Retries that were busy   */
+    hg_atomic_int64_t *av_count;       /* Addrs inserted into AV   */
     na_return_t (*msg_send_unexpected)(
         struct fid_ep *, const struct na_ofi_msg_info *, void *);
     na_return_t (*msg_recv_unexpected)(
         struct fid_ep *, const struct na_ofi_msg_info *, void *);
     na_return_t (*cq_poll)(
-        struct na_ofi_class *, struct na_ofi_context *, size_t *);
+        struct na_ofi_class *, struct na_ofi_context *, size_t, size_t *);
     unsigned long opt_features;    /* Optional feature flags   */
     hg_atomic_int32_t n_contexts;  /* Number of context        */
     unsigned int op_retry_timeout; /* Retry timeout            */
     unsigned int op_retry_period;  /* Time elapsed until next retry */
+    size_t cq_event_max;           /* Max CQ events read at once */
+    size_t rdv_threshold;          /* Rendezvous above that size */
+    size_t inject_size;            /* Msgs injected up to that size */
+    size_t rdv_msg_size;           /* Max msg size with rendezvous */
+    size_t deferred_rma_max;       /* Max RMA ops left to the NIC */
+    size_t ring_slot_num;          /* Unexpected ring slots    */
     uint8_t context_max;           /* Max number of contexts   */
     bool no_wait;                  /* Ignore wait object       */
+    bool huge_pages;               /* Prefer huge pages        */
+    bool multi_ep;                 /* One endpoint per context */
+    bool ring_listen;              /* Grant rings to senders   */
     bool finalizing;               /* Class being destroyed    */
+
+    /* Written by threads posting operations, kept off the read-mostly
+     * fields above */
+    HG_MEM_CACHE_ALIGNED(hg_atomic_int32_t rdv_fin_id); /* FIN seq number */
+    HG_MEM_FIELD_ALIGNED(hg_atomic_int32_t ring_req_id); /* Ring req ID */
+    HG_MEM_FIELD_ALIGNED(hg_thread_spin_t ring_lock); /* Ring state lock */
+
+    /* Written when creating/freeing addrs */
+    HG_MEM_CACHE_ALIGNED(struct na_ofi_addr_pool addr_pool); /* Addr pool */
 };
 
+HG_MEM_CACHE_LINE_CHECK(struct na_ofi_class, finalizing, rdv_fin_id);
+HG_MEM_CACHE_LINE_CHECK(struct na_ofi_class, rdv_fin_id, addr_pool);
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -913,6 +1209,13 @@ static NA_INLINE void
 na_ofi_key_to_sin(struct sockaddr_in *addr, uint64_t key);
 #endif
 
+/**
+ * Shift the port of an IPv4/IPv6 address by offset.
+ */
+static na_return_t
+na_ofi_raw_addr_port_shift(
+    int addr_format, union na_ofi_raw_addr *addr, uint8_t offset);
+
 /**
  * Size required to serialize raw addr.
  */
@@ -940,6 +1243,14 @@ static na_return_t
 na_ofi_addr_key_lookup(struct na_ofi_class *na_ofi_class,
     struct na_ofi_addr_key *addr_key, struct na_ofi_addr **na_ofi_addr_p);
 
+/**
+ * Lookup array of addrs and insert keys that are not present.
+ */
+static na_return_t
+na_ofi_addr_key_lookup_batch(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_addr_key *addr_keys, size_t count,
+    struct na_ofi_addr **na_ofi_addrs);
+
 /**
  * Key hash for hash table.
  */
@@ -980,6 +1291,15 @@ na_ofi_addr_map_insert(struct na_ofi_class *na_ofi_class,
     struct na_ofi_map *na_ofi_map, struct na_ofi_addr_key *addr_key,
     struct na_ofi_addr **na_ofi_addr_p);
 
+/**
+ * Insert new addr keys into map with a single AV insertion. Entries of
+ * na_ofi_addrs that are not NULL are skipped.
+ */
+static na_return_t
+na_ofi_addr_map_insert_batch(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_map *na_ofi_map, struct na_ofi_addr_key *addr_keys,
+    size_t count, struct na_ofi_addr **na_ofi_addrs);
+
 /**
  * Remove addr key from map.
  */
@@ -1012,6 +1332,39 @@ static na_return_t
 na_ofi_getinfo(enum na_ofi_prov_type prov_type, const struct na_ofi_info *info,
     struct fi_info **fi_info_p);
 
+/**
+ * Duplicate providers from getinfo cache if they were already queried.
+ */
+static bool
+na_ofi_getinfo_cache_get(enum na_ofi_prov_type prov_type,
+    const struct na_ofi_info *info, struct fi_info **fi_info_p);
+
+/**
+ * Add copy of providers to getinfo cache.
+ */
+static void
+na_ofi_getinfo_cache_put(enum na_ofi_prov_type prov_type,
+    const struct na_ofi_info *info, const struct fi_info *providers);
+
+/**
+ * Check whether cache entry was queried with the same parameters.
+ */
+static bool
+na_ofi_getinfo_cache_match(const struct na_ofi_getinfo_entry *entry,
+    enum na_ofi_prov_type prov_type, const struct na_ofi_info *info);
+
+/**
+ * Free cache entry.
+ */
+static void
+na_ofi_getinfo_entry_free(struct na_ofi_getinfo_entry *entry);
+
+/**
+ * Duplicate list of providers.
+ */
+static struct fi_info *
+na_ofi_dupinfo_list(const struct fi_info *providers);
+
 /**
  * Match provider name with domain.
  */
@@ -1167,6 +1520,13 @@ na_ofi_sep_open(const struct na_ofi_domain *na_ofi_domain,
 static na_return_t
 na_ofi_endpoint_close(struct na_ofi_endpoint *na_ofi_endpoint);
 
+/**
+ * Open endpoint of context id when using one endpoint per context.
+ */
+static na_return_t
+na_ofi_context_ep_open(struct na_ofi_class *na_ofi_class, uint8_t id,
+    struct na_ofi_endpoint **na_ofi_endpoint_p);
+
 /**
  * Open event queues.
  */
@@ -1247,6 +1607,20 @@ na_ofi_addr_ref_incr(struct na_ofi_addr *na_ofi_addr);
 static void
 na_ofi_addr_ref_decr(struct na_ofi_addr *na_ofi_addr);
 
+/**
+ * Get FI addr used to reach context id of remote address.
+ */
+static NA_INLINE na_return_t
+na_ofi_addr_route(
+    struct na_ofi_addr *na_ofi_addr, uint8_t id, fi_addr_t *fi_addr_p);
+
+/**
+ * Lookup (and insert if needed) address of remote context endpoint.
+ */
+static na_return_t
+na_ofi_addr_ep_lookup(
+    struct na_ofi_addr *na_ofi_addr, uint8_t id, fi_addr_t *fi_addr_p);
+
 /**
  * Allocate memory for transfers.
  */
@@ -1280,6 +1654,54 @@ na_ofi_mem_buf_deregister(void *handle, void *arg);
 static uint64_t
 na_ofi_mem_key_gen(struct na_ofi_domain *na_ofi_domain);
 
+/**
+ * Create MR cache.
+ */
+static na_return_t
+na_ofi_mr_cache_create(struct na_ofi_mr_cache **mr_cache_p);
+
+/**
+ * Destroy MR cache and close unused MRs.
+ */
+static void
+na_ofi_mr_cache_destroy(
+    struct na_ofi_mr_cache *na_ofi_mr_cache, hg_atomic_int32_t *mr_reg_count);
+
+/**
+ * Hash MR cache key.
+ */
+static NA_INLINE unsigned int
+na_ofi_mr_cache_key_hash(hg_hash_table_key_t key);
+
+/**
+ * Compare MR cache keys.
+ */
+static NA_INLINE int
+na_ofi_mr_cache_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Get existing registration from MR cache, NULL if not found.
+ */
+static struct na_ofi_mr_cache_entry *
+na_ofi_mr_cache_get(struct na_ofi_mr_cache *na_ofi_mr_cache,
+    const struct na_ofi_mr_cache_key *key);
+
+/**
+ * Add new registration to MR cache. If another thread added the same key in
+ * the meantime, that entry is returned and the caller must close its MR.
+ */
+static na_return_t
+na_ofi_mr_cache_add(struct na_ofi_mr_cache *na_ofi_mr_cache,
+    const struct na_ofi_mr_cache_key *key, struct fid_mr *fi_mr,
+    struct na_ofi_mr_cache_entry **entry_p);
+
+/**
+ * Release registration from MR cache, MR is returned if it must be closed.
+ */
+static struct fid_mr *
+na_ofi_mr_cache_release(struct na_ofi_mr_cache *na_ofi_mr_cache,
+    struct na_ofi_mr_cache_entry *entry);
+
 /**
  * Msg send.
  */
@@ -1287,6 +1709,19 @@ static na_return_t
 na_ofi_msg_send(
     struct fid_ep *ep, const struct na_ofi_msg_info *msg_info, void *context);
 
+/**
+ * Msg send with flags (e.g., FI_MORE).
+ */
+static na_return_t
+na_ofi_msg_sendmsg(struct fid_ep *ep, const struct na_ofi_msg_info *msg_info,
+    void *context, uint64_t flags);
+
+/**
+ * Msg inject (no completion entry is generated).
+ */
+static na_return_t
+na_ofi_msg_inject(struct fid_ep *ep, const struct na_ofi_msg_info *msg_info);
+
 /**
  * Msg recv.
  */
@@ -1308,6 +1743,27 @@ static na_return_t
 na_ofi_tag_send(
     struct fid_ep *ep, const struct na_ofi_msg_info *msg_info, void *context);
 
+/**
+ * Tagged msg send with flags (e.g., FI_MORE).
+ */
+static na_return_t
+na_ofi_tag_sendmsg(struct fid_ep *ep, const struct na_ofi_msg_info *msg_info,
+    void *context, uint64_t flags);
+
+/**
+ * Tagged msg inject (no completion entry is generated).
+ */
+static na_return_t
+na_ofi_tag_inject(struct fid_ep *ep, const struct na_ofi_msg_info *msg_info);
+
+/**
+ * Inject msg and complete op ID right away, NA_AGAIN is returned if msg must
+ * be posted through a regular send instead.
+ */
+static na_return_t
+na_ofi_msg_send_inject(struct na_ofi_context *na_ofi_context,
+    struct na_ofi_op_id *na_ofi_op_id, bool tagged);
+
 /**
  * Tagged msg recv.
  */
@@ -1359,186 +1815,426 @@ na_ofi_rma_common(struct na_ofi_class *na_ofi_class, na_context_t *context,
     uint8_t remote_id, struct na_ofi_op_id *na_ofi_op_id);
 
 /**
- * Post RMA operation.
+ * Get IOV start index, offset and count of a memory handle range.
  */
-static na_return_t
-na_ofi_rma_post(
-    struct fid_ep *ep, const struct na_ofi_rma_info *rma_info, void *context);
+static NA_INLINE size_t
+na_ofi_mem_handle_iov_range(const struct na_ofi_mem_handle *na_ofi_mem_handle,
+    na_offset_t offset, size_t len, size_t *iov_start_index,
+    na_offset_t *iov_start_offset);
 
 /**
- * Release resources allocated for RMA operation.
+ * Allocate IOV arrays of RMA operation that exceed static storage.
  */
-static NA_INLINE void
-na_ofi_rma_release(struct na_ofi_rma_info *rma_info);
+static na_return_t
+na_ofi_rma_iov_alloc(struct na_ofi_rma_info *rma_info);
 
 /**
- * Poll from CQ (FI_SOURCE not supported).
+ * Post RMA operation.
  */
 static na_return_t
-na_ofi_cq_poll_no_source(struct na_ofi_class *na_ofi_class,
-    struct na_ofi_context *na_ofi_context, size_t *actual_count_p);
+na_ofi_rma_post(
+    struct fid_ep *ep, const struct na_ofi_rma_info *rma_info, void *context);
 
 /**
- * Poll from CQ (FI_SOURCE supported).
+ * Prepare RMA operation to be queued as deferred work.
  */
 static na_return_t
-na_ofi_cq_poll_fi_source(struct na_ofi_class *na_ofi_class,
-    struct na_ofi_context *na_ofi_context, size_t *actual_count_p);
+na_ofi_rma_deferred_init(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context, struct na_ofi_op_id *na_ofi_op_id);
 
 /**
- * Read from CQ (FI_SOURCE not supported).
+ * Queue RMA operation as deferred work triggered by the context counter.
  */
 static na_return_t
-na_ofi_cq_read(struct fid_cq *cq, struct fi_cq_tagged_entry cq_events[],
-    size_t max_count, size_t *actual_count, bool *err_avail);
+na_ofi_rma_post_deferred(
+    struct fid_ep *ep, const struct na_ofi_rma_info *rma_info, void *context);
 
 /**
- * Read from CQ (FI_SOURCE supported).
+ * Release resources allocated for RMA operation.
  */
-static na_return_t
-na_ofi_cq_readfrom(struct fid_cq *cq, struct fi_cq_tagged_entry cq_events[],
-    size_t max_count, fi_addr_t *src_addrs, size_t *actual_count,
-    bool *err_avail);
+static NA_INLINE void
+na_ofi_rma_release(struct na_ofi_rma_info *rma_info);
 
 /**
- * Read from error CQ.
+ * Post atomic operation.
  */
 static na_return_t
-na_ofi_cq_readerr(struct fid_cq *cq, struct fi_cq_tagged_entry *cq_event,
-    size_t *src_err_addrcount_p, void **src_err_addr_p,
-    size_t *src_err_addrlen_p);
+na_ofi_atomic_post(struct fid_ep *ep,
+    const struct na_ofi_atomic_info *atomic_info, void *context);
 
 /**
- * Retrieve source address of unexpected messages.
+ * Register payload and prepare RTS of rendezvous send.
  */
 static na_return_t
-na_ofi_cq_process_src_addr(struct na_ofi_class *na_ofi_class,
-    const struct fi_cq_tagged_entry *cq_event, fi_addr_t src_addr,
-    void *src_err_addr, size_t src_err_addrlen,
-    struct na_ofi_addr **na_ofi_addr_p);
+na_ofi_rdv_rts_init(na_class_t *na_class, struct na_ofi_context *na_ofi_context,
+    struct na_ofi_op_id *na_ofi_op_id, const void *buf, size_t buf_size,
+    size_t header_size, fi_addr_t fi_addr, uint64_t tag);
 
 /**
- * Retrieve source address of unexpected messages (FI_SOURCE supported).
+ * Move rendezvous operation to its next step.
  */
 static na_return_t
-na_ofi_cq_process_fi_src_addr(struct na_ofi_class *na_ofi_class,
-    fi_addr_t src_addr, struct na_ofi_addr **na_ofi_addr_p);
+na_ofi_rdv_process(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id,
+    const struct fi_cq_tagged_entry *cq_event, struct na_ofi_addr *na_ofi_addr,
+    bool *complete_p);
 
 /**
- * Retrieve source address of unexpected messages (FI_SOURCE_ERR supported).
+ * Read payload from sender once RTS is received.
  */
 static na_return_t
-na_ofi_cq_process_fi_src_err_addr(struct na_ofi_class *na_ofi_class,
-    void *src_err_addr, size_t src_err_addrlen,
-    struct na_ofi_addr **na_ofi_addr_p);
+na_ofi_rdv_read(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id,
+    const struct fi_cq_tagged_entry *cq_event, struct na_ofi_addr *na_ofi_addr);
 
 /**
- * Retrieve source address of unexpected messages (FI_SOURCE not supported).
+ * Post msg operation of rendezvous step, retry later if busy.
  */
 static na_return_t
-na_ofi_cq_process_raw_src_addr(struct na_ofi_class *na_ofi_class,
-    const void *buf, size_t len, struct na_ofi_addr **na_ofi_addr_p);
+na_ofi_rdv_post(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id, struct fid_ep *ep,
+    na_return_t (*msg_op)(
+        struct fid_ep *, const struct na_ofi_msg_info *, void *));
 
 /**
- * Process event from CQ.
+ * Release rendezvous payload registration.
  */
-static na_return_t
-na_ofi_cq_process_event(struct na_ofi_class *na_ofi_class,
-    const struct fi_cq_tagged_entry *cq_event, struct na_ofi_addr *na_ofi_addr);
+static void
+na_ofi_rdv_release(struct na_ofi_op_id *na_ofi_op_id);
 
 /**
- * Recv unexpected operation events.
+ * Allocate internal ring operation.
  */
-static NA_INLINE na_return_t
-na_ofi_cq_process_recv_unexpected(struct na_ofi_class *na_ofi_class,
-    const struct na_ofi_msg_info *msg_info,
-    struct na_cb_info_recv_unexpected *recv_unexpected_info, void *buf,
-    size_t len, struct na_ofi_addr *na_ofi_addr, uint64_t tag);
+static struct na_ofi_ring_op *
+na_ofi_ring_op_create(struct na_ofi_class *na_ofi_class,
+    enum na_ofi_ring_op_type type, struct na_ofi_ring_tx *tx);
 
 /**
- * Multi-recv unexpected operation events.
+ * Free internal ring operation.
  */
-static NA_INLINE na_return_t
-na_ofi_cq_process_multi_recv_unexpected(struct na_ofi_class *na_ofi_class,
-    const struct na_ofi_msg_info *msg_info,
-    struct na_cb_info_multi_recv_unexpected *multi_recv_unexpected_info,
-    void *buf, size_t len, struct na_ofi_addr *na_ofi_addr, uint64_t tag,
-    bool last);
+static void
+na_ofi_ring_op_free(struct na_ofi_ring_op *ring_op);
 
 /**
- * Recv expected operation events.
+ * Complete internal ring operation in error or canceled state.
  */
-static NA_INLINE na_return_t
-na_ofi_cq_process_recv_expected(const struct na_ofi_msg_info *msg_info,
-    struct na_cb_info_recv_expected *recv_expected_info, void *buf, size_t len,
-    uint64_t tag);
+static void
+na_ofi_ring_op_complete(
+    struct na_ofi_op_id *na_ofi_op_id, bool complete, na_return_t cb_ret);
 
 /**
- * Process retries.
+ * Post msg operation of internal ring operation, retry later if busy.
  */
 static na_return_t
-na_ofi_cq_process_retries(
-    struct na_ofi_context *na_ofi_context, unsigned retry_period_ms);
+na_ofi_ring_post(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_op *ring_op, struct fid_ep *ep,
+    na_return_t (*msg_op)(
+        struct fid_ep *, const struct na_ofi_msg_info *, void *));
 
 /**
- * Push op for retry.
+ * Process completion of internal ring operation.
  */
-static void
-na_ofi_op_retry(struct na_ofi_context *na_ofi_context, unsigned int timeout_ms,
-    struct na_ofi_op_id *na_ofi_op_id);
+static na_return_t
+na_ofi_ring_process(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_op *ring_op, const struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_addr *na_ofi_addr);
 
 /**
- * Abort all operations targeted at fi_addr.
+ * Get (or create) ring state of remote context, ring lock must be held.
  */
-static void
-na_ofi_op_retry_abort_addr(
-    struct na_ofi_context *na_ofi_context, fi_addr_t fi_addr, na_return_t ret);
+static struct na_ofi_ring_tx *
+na_ofi_ring_tx_get(struct na_ofi_addr *na_ofi_addr, uint8_t id);
 
 /**
- * Complete operation ID.
+ * Write unexpected msg into remote ring if one was granted.
  */
-static NA_INLINE void
-na_ofi_op_complete_single(
-    struct na_ofi_op_id *na_ofi_op_id, bool complete, na_return_t cb_ret);
+static na_return_t
+na_ofi_ring_send(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id, const void *buf, size_t buf_size,
+    uint8_t dest_id, fi_addr_t fi_addr, na_tag_t tag, bool *written_p);
 
 /**
- * Release OP ID resources.
+ * Request ring from remote context.
  */
-static NA_INLINE void
-na_ofi_op_release_single(void *arg);
+static na_return_t
+na_ofi_ring_request(struct na_ofi_class *na_ofi_class, na_context_t *context,
+    struct na_ofi_addr *na_ofi_addr, struct na_ofi_ring_tx *tx,
+    fi_addr_t fi_addr);
 
 /**
- * Complete operation ID.
+ * Read consumed count of remote ring to get slots back.
  */
-static void
-na_ofi_op_complete_multi(
-    struct na_ofi_op_id *na_ofi_op_id, bool complete, na_return_t cb_ret);
+static na_return_t
+na_ofi_ring_credit_read(struct na_ofi_class *na_ofi_class,
+    na_context_t *context, struct na_ofi_addr *na_ofi_addr,
+    struct na_ofi_ring_tx *tx, fi_addr_t fi_addr);
 
 /**
- * Release OP ID resources.
+ * Open ring table of context.
  */
-static NA_INLINE void
-na_ofi_op_release_multi(void *arg);
+static na_return_t
+na_ofi_ring_rx_open(struct na_ofi_ring_rx **ring_rx_p);
 
 /**
- * Cancel OP ID.
+ * Post bounce recvs of context.
  */
 static na_return_t
-na_ofi_op_cancel(struct na_ofi_op_id *na_ofi_op_id);
+na_ofi_ring_rx_start(struct na_ofi_class *na_ofi_class, na_context_t *context);
 
 /**
- * Init ring-buffer to hold multi CQ events.
+ * Cancel bounce recvs and free rings of context.
  */
-static na_return_t
-na_ofi_completion_multi_init(
-    struct na_ofi_completion_multi *completion_multi, uint32_t size);
+static void
+na_ofi_ring_rx_close(
+    struct na_ofi_class *na_ofi_class, struct na_ofi_context *na_ofi_context);
 
 /**
- * Destroy ring-buffer to hold multi CQ events.
+ * Post bounce recv.
  */
 static void
-na_ofi_completion_multi_destroy(
-    struct na_ofi_completion_multi *completion_multi);
+na_ofi_ring_bounce_post(
+    struct na_ofi_class *na_ofi_class, struct na_ofi_ring_op *ring_op);
+
+/**
+ * Create and register ring for sender and send GRANT back.
+ */
+static void
+na_ofi_ring_grant(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_op *bounce, const struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_addr *na_ofi_addr);
+
+/**
+ * Create and register ring.
+ */
+static na_return_t
+na_ofi_ring_create(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_addr *na_ofi_addr,
+    struct na_ofi_ring **ring_p);
+
+/**
+ * Deregister and free ring.
+ */
+static void
+na_ofi_ring_free(struct na_ofi_class *na_ofi_class, struct na_ofi_ring *ring);
+
+/**
+ * Process remote write into ring.
+ */
+static na_return_t
+na_ofi_ring_process_write(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context,
+    const struct fi_cq_tagged_entry *cq_event);
+
+/**
+ * Match msg with posted unexpected recv or queue it.
+ */
+static void
+na_ofi_ring_msg_push(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_ring_msg *msg);
+
+/**
+ * Copy msg into unexpected recv buffer and complete recv.
+ */
+static void
+na_ofi_ring_deliver(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_op_id *na_ofi_op_id,
+    struct na_ofi_ring_msg *msg);
+
+/**
+ * Release slot or bounce recv holding msg.
+ */
+static void
+na_ofi_ring_msg_release(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_ring_msg *msg);
+
+/**
+ * Match unexpected recv with queued msg or queue it.
+ */
+static na_return_t
+na_ofi_ring_recv_unexpected(struct na_ofi_class *na_ofi_class,
+    na_context_t *context, struct na_ofi_op_id *na_ofi_op_id);
+
+/**
+ * Cancel unexpected recv waiting for a msg.
+ */
+static void
+na_ofi_ring_cancel(
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_op_id *na_ofi_op_id);
+
+/**
+ * Poll from CQ (FI_SOURCE not supported).
+ */
+static na_return_t
+na_ofi_cq_poll_no_source(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context, size_t max_count,
+    size_t *actual_count_p);
+
+/**
+ * Poll from CQ (FI_SOURCE supported).
+ */
+static na_return_t
+na_ofi_cq_poll_fi_source(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context, size_t max_count,
+    size_t *actual_count_p);
+
+/**
+ * Read from CQ (FI_SOURCE not supported).
+ */
+static na_return_t
+na_ofi_cq_read(struct fid_cq *cq, struct fi_cq_tagged_entry cq_events[],
+    size_t max_count, size_t *actual_count, bool *err_avail);
+
+/**
+ * Read from CQ (FI_SOURCE supported).
+ */
+static na_return_t
+na_ofi_cq_readfrom(struct fid_cq *cq, struct fi_cq_tagged_entry cq_events[],
+    size_t max_count, fi_addr_t *src_addrs, size_t *actual_count,
+    bool *err_avail);
+
+/**
+ * Read from error CQ.
+ */
+static na_return_t
+na_ofi_cq_readerr(struct fid_cq *cq, struct fi_cq_tagged_entry *cq_event,
+    size_t *src_err_addrcount_p, void **src_err_addr_p,
+    size_t *src_err_addrlen_p);
+
+/**
+ * Retrieve source address of unexpected messages.
+ */
+static na_return_t
+na_ofi_cq_process_src_addr(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context,
+    const struct fi_cq_tagged_entry *cq_event, fi_addr_t src_addr,
+    void *src_err_addr, size_t src_err_addrlen,
+    struct na_ofi_addr **na_ofi_addr_p);
+
+/**
+ * Retrieve source address of unexpected messages (FI_SOURCE supported).
+ * Repeat senders are resolved from the context cache without locking.
+ */
+static na_return_t
+na_ofi_cq_process_fi_src_addr(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context, fi_addr_t src_addr,
+    struct na_ofi_addr **na_ofi_addr_p);
+
+/**
+ * Retrieve source address of unexpected messages (FI_SOURCE_ERR supported).
+ */
+static na_return_t
+na_ofi_cq_process_fi_src_err_addr(struct na_ofi_class *na_ofi_class,
+    void *src_err_addr, size_t src_err_addrlen,
+    struct na_ofi_addr **na_ofi_addr_p);
+
+/**
+ * Retrieve source address of unexpected messages (FI_SOURCE not supported).
+ */
+static na_return_t
+na_ofi_cq_process_raw_src_addr(struct na_ofi_class *na_ofi_class,
+    const void *buf, size_t len, struct na_ofi_addr **na_ofi_addr_p);
+
+/**
+ * Process event from CQ.
+ */
+static na_return_t
+na_ofi_cq_process_event(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id,
+    const struct fi_cq_tagged_entry *cq_event, struct na_ofi_addr *na_ofi_addr);
+
+/**
+ * Recv unexpected operation events.
+ */
+static NA_INLINE na_return_t
+na_ofi_cq_process_recv_unexpected(struct na_ofi_class *na_ofi_class,
+    const struct na_ofi_msg_info *msg_info,
+    struct na_cb_info_recv_unexpected *recv_unexpected_info, void *buf,
+    size_t len, struct na_ofi_addr *na_ofi_addr, uint64_t tag);
+
+/**
+ * Multi-recv unexpected operation events.
+ */
+static NA_INLINE na_return_t
+na_ofi_cq_process_multi_recv_unexpected(struct na_ofi_class *na_ofi_class,
+    const struct na_ofi_msg_info *msg_info,
+    struct na_cb_info_multi_recv_unexpected *multi_recv_unexpected_info,
+    void *buf, size_t len, struct na_ofi_addr *na_ofi_addr, uint64_t tag,
+    bool last);
+
+/**
+ * Recv expected operation events.
+ */
+static NA_INLINE na_return_t
+na_ofi_cq_process_recv_expected(const struct na_ofi_msg_info *msg_info,
+    struct na_cb_info_recv_expected *recv_expected_info, void *buf, size_t len,
+    uint64_t tag);
+
+/**
+ * Process retries.
+ */
+static na_return_t
+na_ofi_cq_process_retries(
+    struct na_ofi_context *na_ofi_context, unsigned retry_period_ms);
+
+/**
+ * Push op for retry.
+ */
+static void
+na_ofi_op_retry(struct na_ofi_context *na_ofi_context, unsigned int timeout_ms,
+    struct na_ofi_op_id *na_ofi_op_id);
+
+/**
+ * Abort all operations targeted at fi_addr.
+ */
+static void
+na_ofi_op_retry_abort_addr(
+    struct na_ofi_context *na_ofi_context, fi_addr_t fi_addr, na_return_t ret);
+
+/**
+ * Complete operation ID.
+ */
+static NA_INLINE void
+na_ofi_op_complete_single(
+    struct na_ofi_op_id *na_ofi_op_id, bool complete, na_return_t cb_ret);
+
+/**
+ * Release OP ID resources.
+ */
+static NA_INLINE void
+na_ofi_op_release_single(void *arg);
+
+/**
+ * Complete operation ID.
+ */
+static void
+na_ofi_op_complete_multi(
+    struct na_ofi_op_id *na_ofi_op_id, bool complete, na_return_t cb_ret);
+
+/**
+ * Release OP ID resources.
+ */
+static NA_INLINE void
+na_ofi_op_release_multi(void *arg);
+
+/**
+ * Cancel OP ID.
+ */
+static na_return_t
+na_ofi_op_cancel(struct na_ofi_op_id *na_ofi_op_id);
+
+/**
+ * Init ring-buffer to hold multi CQ events.
+ */
+static na_return_t
+na_ofi_completion_multi_init(
+    struct na_ofi_completion_multi *completion_multi, uint32_t size);
+
+/**
+ * Destroy ring-buffer to hold multi CQ events.
+ */
+static void
+na_ofi_completion_multi_destroy(
+    struct na_ofi_completion_multi *completion_multi);
 
 /**
  * Reserve entry to hold CQ data.
@@ -1588,10 +2284,18 @@ na_ofi_initialize(
 static na_return_t
 na_ofi_finalize(na_class_t *na_class);
 
+/* cleanup */
+static void
+na_ofi_cleanup(void);
+
 /* has_opt_feature */
 static bool
 na_ofi_has_opt_feature(na_class_t *na_class, unsigned long flags);
 
+/* get_numa_node */
+static int
+na_ofi_get_numa_node(na_class_t *na_class);
+
 /* context_create */
 static na_return_t
 na_ofi_context_create(na_class_t *na_class, void **context_p, uint8_t id);
@@ -1608,10 +2312,19 @@ na_ofi_op_create(na_class_t *na_class, unsigned long flags);
 static void
 na_ofi_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
 
+/* op_reset */
+static na_return_t
+na_ofi_op_reset(na_class_t *na_class, na_op_id_t *op_id);
+
 /* addr_lookup */
 static na_return_t
 na_ofi_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p);
 
+/* addr_lookup_batch */
+static na_return_t
+na_ofi_addr_lookup_batch(na_class_t *na_class, const char *const *names,
+    size_t count, na_addr_t **addrs);
+
 /* addr_free */
 static NA_INLINE void
 na_ofi_addr_free(na_class_t *na_class, na_addr_t *addr);
@@ -1716,6 +2429,12 @@ na_ofi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
     na_addr_t *source_addr, uint8_t source_id, na_tag_t tag, na_op_id_t *op_id);
 
+/* msg_send_batch */
+static na_return_t
+na_ofi_msg_send_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+    size_t count, size_t *posted_count_p);
+
 /* mem_handle */
 static na_return_t
 na_ofi_mem_handle_create(na_class_t *na_class, void *buf, size_t buf_size,
@@ -1768,6 +2487,24 @@ na_ofi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     size_t length, na_addr_t *remote_addr, uint8_t remote_id,
     na_op_id_t *op_id);
 
+/* rma_batch_get_max_segments */
+static size_t
+na_ofi_rma_batch_get_max_segments(const na_class_t *na_class);
+
+/* rma_batch */
+static na_return_t
+na_ofi_rma_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg,
+    const struct na_rma_segment *segments, size_t count,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id);
+
+/* atomic */
+static na_return_t
+na_ofi_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id);
+
 /* poll_get_fd */
 static NA_INLINE int
 na_ofi_poll_get_fd(na_class_t *na_class, na_context_t *context);
@@ -1795,13 +2532,17 @@ NA_PLUGIN const struct na_class_ops NA_PLUGIN_OPS(ofi) = {
     na_ofi_check_protocol,                 /* check_protocol */
     na_ofi_initialize,                     /* initialize */
     na_ofi_finalize,                       /* finalize */
-    NULL,                                  /* cleanup */
+    na_ofi_cleanup,                        /* cleanup */
     na_ofi_has_opt_feature,                /* has_opt_feature */
+    na_ofi_get_numa_node,                  /* get_numa_node */
     na_ofi_context_create,                 /* context_create */
     na_ofi_context_destroy,                /* context_destroy */
     na_ofi_op_create,                      /* op_create */
     na_ofi_op_destroy,                     /* op_destroy */
+    na_ofi_op_reset,                       /* op_reset */
     na_ofi_addr_lookup,                    /* addr_lookup */
+    na_ofi_addr_lookup_batch,              /* addr_lookup_batch */
+    NULL,                                  /* addr_warm */
     na_ofi_addr_free,                      /* addr_free */
     na_ofi_addr_set_remove,                /* addr_set_remove */
     na_ofi_addr_self,                      /* addr_self */
@@ -1826,6 +2567,7 @@ NA_PLUGIN const struct na_class_ops NA_PLUGIN_OPS(ofi) = {
     NULL,                                  /* msg_init_expected */
     na_ofi_msg_send_expected,              /* msg_send_expected */
     na_ofi_msg_recv_expected,              /* msg_recv_expected */
+    na_ofi_msg_send_batch,                 /* msg_send_batch */
     na_ofi_mem_handle_create,              /* mem_handle_create */
     na_ofi_mem_handle_create_segments,     /* mem_handle_create_segment */
     na_ofi_mem_handle_free,                /* mem_handle_free */
@@ -1837,6 +2579,9 @@ NA_PLUGIN const struct na_class_ops NA_PLUGIN_OPS(ofi) = {
     na_ofi_mem_handle_deserialize,         /* mem_handle_deserialize */
     na_ofi_put,                            /* put */
     na_ofi_get,                            /* get */
+    na_ofi_rma_batch_get_max_segments,     /* rma_batch_get_max_segments */
+    na_ofi_rma_batch,                      /* rma_batch */
+    na_ofi_atomic,                         /* atomic */
     na_ofi_poll_get_fd,                    /* poll_get_fd */
     na_ofi_poll_try_wait,                  /* poll_try_wait */
     na_ofi_progress,                       /* progress */
@@ -1859,6 +2604,14 @@ static HG_LIST_HEAD(na_ofi_domain)
 static hg_thread_mutex_t na_ofi_domain_list_mutex_g =
     HG_THREAD_MUTEX_INITIALIZER;
 
+/* Cache of fi_getinfo() results */
+static HG_LIST_HEAD(na_ofi_getinfo_entry)
+    na_ofi_getinfo_cache_g = HG_LIST_HEAD_INITIALIZER(na_ofi_getinfo_entry);
+
+/* Getinfo cache lock */
+static hg_thread_mutex_t na_ofi_getinfo_cache_mutex_g =
+    HG_THREAD_MUTEX_INITIALIZER;
+
 #if !defined(_WIN32) &&                                                        \
     FI_VERSION_GE(                                                             \
         FI_VERSION(FI_MAJOR_VERSION, FI_MINOR_VERSION), FI_VERSION(1, 16))
@@ -2606,6 +3359,38 @@ na_ofi_key_to_sin(struct sockaddr_in *addr, uint64_t key)
 }
 #endif
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_raw_addr_port_shift(
+    int addr_format, union na_ofi_raw_addr *addr, uint8_t offset)
+{
+    in_port_t *port_p;
+    unsigned int port;
+    na_return_t ret;
+
+    switch (addr_format) {
+        case FI_SOCKADDR_IN:
+            port_p = &addr->sin.sin_port;
+            break;
+        case FI_SOCKADDR_IN6:
+            port_p = &addr->sin6.sin6_port;
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(addr, error, ret, NA_PROTONOSUPPORT,
+                "Unsupported address format for port shift");
+    }
+
+    port = (unsigned int) ntohs(*port_p) + offset;
+    NA_CHECK_SUBSYS_ERROR(addr, port > UINT16_MAX, error, ret, NA_OVERFLOW,
+        "Port %u exceeds maximum port number", port);
+    *port_p = htons((uint16_t) port);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE size_t
 na_ofi_raw_addr_serialize_size(int addr_format)
@@ -2864,18 +3649,61 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-static NA_INLINE unsigned int
-na_ofi_addr_key_hash(hg_hash_table_key_t key)
+static na_return_t
+na_ofi_addr_key_lookup_batch(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_addr_key *addr_keys, size_t count,
+    struct na_ofi_addr **na_ofi_addrs)
 {
-    return NA_OFI_HASH64(((struct na_ofi_addr_key *) key)->val);
-}
+    struct na_ofi_map *na_ofi_map = &na_ofi_class->domain->addr_map;
+    size_t i, missing = 0;
+    na_return_t ret;
 
-/*---------------------------------------------------------------------------*/
-static NA_INLINE int
-na_ofi_addr_key_equal_default(
-    hg_hash_table_key_t key1, hg_hash_table_key_t key2)
-{
-    /* Only when 64-bit unique keys can be generated */
+    /* Lookup all addresses at once */
+    hg_thread_brlock_rdlock(&na_ofi_map->lock);
+    for (i = 0; i < count; i++) {
+        hg_hash_table_value_t value = hg_hash_table_lookup(
+            na_ofi_map->key_map, (hg_hash_table_key_t) &addr_keys[i]);
+
+        if (value == HG_HASH_TABLE_NULL) {
+            na_ofi_addrs[i] = NULL;
+            missing++;
+        } else {
+            na_ofi_addrs[i] = (struct na_ofi_addr *) value;
+            na_ofi_addr_ref_incr(na_ofi_addrs[i]);
+        }
+    }
+    hg_thread_brlock_release_rdlock(&na_ofi_map->lock);
+
+    if (missing > 0) {
+        NA_LOG_SUBSYS_DEBUG(addr,
+            "%zu addresses were not found, attempting to insert them",
+            missing);
+
+        ret = na_ofi_addr_map_insert_batch(na_ofi_class, na_ofi_map,
+            addr_keys, count, na_ofi_addrs);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, error, ret, "Could not insert %zu new addresses", missing);
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE unsigned int
+na_ofi_addr_key_hash(hg_hash_table_key_t key)
+{
+    return NA_OFI_HASH64(((struct na_ofi_addr_key *) key)->val);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_ofi_addr_key_equal_default(
+    hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    /* Only when 64-bit unique keys can be generated */
     return ((struct na_ofi_addr_key *) key1)->val ==
            ((struct na_ofi_addr_key *) key2)->val;
 }
@@ -2919,10 +3747,10 @@ na_ofi_addr_map_lookup(
     hg_hash_table_value_t value = NULL;
 
     /* Lookup key */
-    hg_thread_rwlock_rdlock(&na_ofi_map->lock);
+    hg_thread_brlock_rdlock(&na_ofi_map->lock);
     value = hg_hash_table_lookup(
         na_ofi_map->key_map, (hg_hash_table_key_t) addr_key);
-    hg_thread_rwlock_release_rdlock(&na_ofi_map->lock);
+    hg_thread_brlock_release_rdlock(&na_ofi_map->lock);
 
     return (value == HG_HASH_TABLE_NULL) ? NULL : (struct na_ofi_addr *) value;
 }
@@ -2937,7 +3765,7 @@ na_ofi_addr_map_insert(struct na_ofi_class *na_ofi_class,
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    hg_thread_rwlock_wrlock(&na_ofi_map->lock);
+    hg_thread_brlock_wrlock(&na_ofi_map->lock);
 
     /* Look up again to prevent race between lock release/acquire */
     na_ofi_addr = (struct na_ofi_addr *) hg_hash_table_lookup(
@@ -2956,6 +3784,7 @@ na_ofi_addr_map_insert(struct na_ofi_class *na_ofi_class,
         1, &na_ofi_addr->fi_addr, 0 /* flags */, NULL);
     NA_CHECK_SUBSYS_ERROR(addr, rc < 1, error, ret, na_ofi_errno_to_na(-rc),
         "fi_av_insert() failed, inserted: %d", rc);
+    hg_atomic_incr64(na_ofi_class->av_count);
 
     NA_LOG_SUBSYS_DEBUG(
         addr, "Inserted new addr, FI addr is %" PRIu64, na_ofi_addr->fi_addr);
@@ -2978,20 +3807,129 @@ na_ofi_addr_map_insert(struct na_ofi_class *na_ofi_class,
         addr, rc == 0, error, ret, NA_NOMEM, "hg_hash_table_insert() failed");
 
 out:
-    hg_thread_rwlock_release_wrlock(&na_ofi_map->lock);
+    hg_thread_brlock_release_wrlock(&na_ofi_map->lock);
 
     *na_ofi_addr_p = na_ofi_addr;
 
     return ret;
 
 error:
-    hg_thread_rwlock_release_wrlock(&na_ofi_map->lock);
+    hg_thread_brlock_release_wrlock(&na_ofi_map->lock);
     if (na_ofi_addr)
         na_ofi_addr_destroy(na_ofi_addr);
 
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_addr_map_insert_batch(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_map *na_ofi_map, struct na_ofi_addr_key *addr_keys,
+    size_t count, struct na_ofi_addr **na_ofi_addrs)
+{
+    size_t addrlen =
+        na_ofi_prov_addr_size((int) na_ofi_class->fi_info->addr_format);
+    struct na_ofi_addr **new_addrs = NULL;
+    fi_addr_t *fi_addrs = NULL;
+    char *raw_addrs = NULL;
+    size_t i, new_count = 0;
+    na_return_t ret = NA_SUCCESS;
+    int rc = 0;
+
+    new_addrs = (struct na_ofi_addr **) malloc(count * sizeof(*new_addrs));
+    fi_addrs = (fi_addr_t *) malloc(count * sizeof(*fi_addrs));
+    raw_addrs = (char *) malloc(count * addrlen);
+    NA_CHECK_SUBSYS_ERROR(addr,
+        new_addrs == NULL || fi_addrs == NULL || raw_addrs == NULL, out, ret,
+        NA_NOMEM, "Could not allocate arrays for %zu addresses", count);
+
+    hg_thread_brlock_wrlock(&na_ofi_map->lock);
+
+    for (i = 0; i < count; i++) {
+        struct na_ofi_addr *na_ofi_addr;
+
+        if (na_ofi_addrs[i] != NULL)
+            continue;
+
+        /* Look up again to prevent race between lock release/acquire, this
+         * also catches keys that are duplicated within the batch */
+        na_ofi_addr = (struct na_ofi_addr *) hg_hash_table_lookup(
+            na_ofi_map->key_map, (hg_hash_table_key_t) &addr_keys[i]);
+        if (na_ofi_addr) {
+            na_ofi_addr_ref_incr(na_ofi_addr);
+            na_ofi_addrs[i] = na_ofi_addr;
+            continue;
+        }
+
+        /* Allocate address, stop there on error but still insert previous
+         * addresses so that they can be released normally */
+        ret = na_ofi_addr_create(na_ofi_class, &addr_keys[i], &na_ofi_addr);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, insert, ret, "Could not allocate address");
+
+        rc = hg_hash_table_insert(na_ofi_map->key_map,
+            (hg_hash_table_key_t) &na_ofi_addr->addr_key,
+            (hg_hash_table_value_t) na_ofi_addr);
+        if (rc == 0) {
+            na_ofi_addr->addr_key.val = 0; /* Not in map */
+            na_ofi_addr_destroy(na_ofi_addr);
+            NA_GOTO_SUBSYS_ERROR(
+                addr, insert, ret, NA_NOMEM, "hg_hash_table_insert() failed");
+        }
+
+        memcpy(raw_addrs + new_count * addrlen, &na_ofi_addr->addr_key.addr,
+            addrlen);
+        fi_addrs[new_count] = FI_ADDR_NOTAVAIL;
+        new_addrs[new_count++] = na_ofi_addr;
+        na_ofi_addrs[i] = na_ofi_addr;
+    }
+
+insert:
+    if (new_count == 0)
+        goto unlock;
+
+    /* Insert all new addrs into AV at once */
+    rc = fi_av_insert(na_ofi_class->domain->fi_av, raw_addrs, new_count,
+        fi_addrs, 0 /* flags */, NULL);
+    NA_LOG_SUBSYS_DEBUG(
+        addr, "Inserted %d out of %zu new addrs into AV", rc, new_count);
+    if (rc > 0)
+        hg_atomic_add64(na_ofi_class->av_count, (int64_t) rc);
+
+    for (i = 0; i < new_count; i++) {
+        struct na_ofi_addr *na_ofi_addr = new_addrs[i];
+
+        if (rc < 0 || fi_addrs[i] == FI_ADDR_NOTAVAIL) {
+            /* Address is released by the caller, do not keep it in map */
+            (void) hg_hash_table_remove(na_ofi_map->key_map,
+                (hg_hash_table_key_t) &na_ofi_addr->addr_key);
+            na_ofi_addr->addr_key.val = 0;
+            ret = (rc < 0) ? na_ofi_errno_to_na(-rc) : NA_ADDRNOTAVAIL;
+            continue;
+        }
+        na_ofi_addr->fi_addr = fi_addrs[i];
+
+        /* Insert new value to secondary map (see na_ofi_addr_map_insert()) */
+        if (na_ofi_map->fi_map != NULL &&
+            hg_hash_table_insert(na_ofi_map->fi_map,
+                (hg_hash_table_key_t) &na_ofi_addr->fi_addr,
+                (hg_hash_table_value_t) na_ofi_addr) == 0)
+            ret = NA_NOMEM;
+    }
+    NA_CHECK_SUBSYS_ERROR_NORET(addr, ret != NA_SUCCESS, unlock,
+        "Could not insert all addresses (%s)", NA_Error_to_string(ret));
+
+unlock:
+    hg_thread_brlock_release_wrlock(&na_ofi_map->lock);
+
+out:
+    free(new_addrs);
+    free(fi_addrs);
+    free(raw_addrs);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_addr_map_remove(
@@ -3001,13 +3939,16 @@ na_ofi_addr_map_remove(
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    hg_thread_rwlock_wrlock(&na_ofi_map->lock);
+    hg_thread_brlock_wrlock(&na_ofi_map->lock);
 
     na_ofi_addr = (struct na_ofi_addr *) hg_hash_table_lookup(
         na_ofi_map->key_map, (hg_hash_table_key_t) addr_key);
     if (na_ofi_addr == NULL)
         goto unlock;
 
+    /* Invalidate context source address caches */
+    hg_atomic_incr32(&na_ofi_map->gen);
+
     /* Remove addr key from primary map */
     rc = hg_hash_table_remove(
         na_ofi_map->key_map, (hg_hash_table_key_t) addr_key);
@@ -3034,7 +3975,7 @@ na_ofi_addr_map_remove(
     na_ofi_addr->fi_addr = 0;
 
 unlock:
-    hg_thread_rwlock_release_wrlock(&na_ofi_map->lock);
+    hg_thread_brlock_release_wrlock(&na_ofi_map->lock);
 
     return ret;
 }
@@ -3060,10 +4001,10 @@ na_ofi_fi_addr_map_lookup(struct na_ofi_map *na_ofi_map, fi_addr_t *fi_addr)
     hg_hash_table_value_t value = NULL;
 
     /* Lookup key */
-    hg_thread_rwlock_rdlock(&na_ofi_map->lock);
+    hg_thread_brlock_rdlock(&na_ofi_map->lock);
     value =
         hg_hash_table_lookup(na_ofi_map->fi_map, (hg_hash_table_key_t) fi_addr);
-    hg_thread_rwlock_release_rdlock(&na_ofi_map->lock);
+    hg_thread_brlock_release_rdlock(&na_ofi_map->lock);
 
     return (value == HG_HASH_TABLE_NULL) ? NULL : (struct na_ofi_addr *) value;
 }
@@ -3150,9 +4091,22 @@ na_ofi_getinfo(enum na_ofi_prov_type prov_type, const struct na_ofi_info *info,
     struct fi_info *hints = NULL;
     const char *node = NULL, *service = NULL;
     uint64_t flags = 0;
+    const char *env;
     na_return_t ret = NA_SUCCESS;
     int rc;
 
+    /* Provider discovery may take long, reuse previous results */
+    if (na_ofi_getinfo_cache_get(prov_type, info, fi_info_p))
+        return NA_SUCCESS;
+
+    /* Register memory on demand (ODP) so that regions such as file mappings
+     * are neither pinned nor faulted in when registered, verbs reads that
+     * parameter once when the provider is first loaded */
+    env = getenv("NA_OFI_VERBS_ODP");
+    if (prov_type == NA_OFI_PROV_VERBS_RXM && env != NULL && env[0] != '0' &&
+        tolower(env[0]) != 'n' && setenv("FI_VERBS_USE_ODP", "1", 0) == 0)
+        NA_LOG_SUBSYS_DEBUG(cls, "Requesting on-demand paging registrations");
+
     /* Hints to query and filter providers */
     hints = fi_allocinfo();
     NA_CHECK_SUBSYS_ERROR(
@@ -3242,6 +4196,10 @@ na_ofi_getinfo(enum na_ofi_prov_type prov_type, const struct na_ofi_info *info,
             hints->domain_attr->mr_mode |= FI_MR_HMEM;
         }
 
+        /* Ask for triggered operations */
+        if (info->use_trigger)
+            hints->caps |= FI_TRIGGER;
+
         /* Set src addr hints (FI_SOURCE must not be set in that case) */
         if (info->src_addr) {
             hints->src_addr = info->src_addr;
@@ -3262,6 +4220,8 @@ na_ofi_getinfo(enum na_ofi_prov_type prov_type, const struct na_ofi_info *info,
         "fi_getinfo(%s) failed, rc: %d (%s)", hints->fabric_attr->prov_name, rc,
         fi_strerror(-rc));
 
+    na_ofi_getinfo_cache_put(prov_type, info, *fi_info_p);
+
 cleanup:
     free(hints->fabric_attr->prov_name);
     hints->fabric_attr->prov_name = NULL;
@@ -3272,6 +4232,145 @@ out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static bool
+na_ofi_getinfo_cache_get(enum na_ofi_prov_type prov_type,
+    const struct na_ofi_info *info, struct fi_info **fi_info_p)
+{
+    struct na_ofi_getinfo_entry *entry;
+    struct fi_info *providers = NULL;
+
+    hg_thread_mutex_lock(&na_ofi_getinfo_cache_mutex_g);
+    HG_LIST_FOREACH (entry, &na_ofi_getinfo_cache_g, entry)
+        if (na_ofi_getinfo_cache_match(entry, prov_type, info)) {
+            providers = na_ofi_dupinfo_list(entry->providers);
+            break;
+        }
+    hg_thread_mutex_unlock(&na_ofi_getinfo_cache_mutex_g);
+
+    if (providers == NULL)
+        return false;
+
+    NA_LOG_SUBSYS_DEBUG(cls, "Reusing cached fi_getinfo() result (%s)",
+        na_ofi_prov_name[prov_type]);
+    *fi_info_p = providers;
+
+    return true;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_getinfo_cache_put(enum na_ofi_prov_type prov_type,
+    const struct na_ofi_info *info, const struct fi_info *providers)
+{
+    struct na_ofi_getinfo_entry *entry;
+    const char *env = getenv("NA_OFI_GETINFO_CACHE");
+
+    /* Devices may be added or removed between two initializations */
+    if (env != NULL && (env[0] == '0' || tolower(env[0]) == 'n'))
+        return;
+
+    entry = (struct na_ofi_getinfo_entry *) calloc(1, sizeof(*entry));
+    if (entry == NULL)
+        return;
+    entry->prov_type = prov_type;
+    if (info != NULL) {
+        entry->has_info = true;
+        entry->info.thread_mode = info->thread_mode;
+        entry->info.addr_format = info->addr_format;
+        entry->info.use_hmem = info->use_hmem;
+        entry->info.use_trigger = info->use_trigger;
+        if (info->node != NULL &&
+            (entry->info.node = strdup(info->node)) == NULL)
+            goto error;
+        if (info->service != NULL &&
+            (entry->info.service = strdup(info->service)) == NULL)
+            goto error;
+        if (info->src_addr != NULL) {
+            entry->info.src_addr = malloc(info->src_addrlen);
+            if (entry->info.src_addr == NULL)
+                goto error;
+            memcpy(entry->info.src_addr, info->src_addr, info->src_addrlen);
+            entry->info.src_addrlen = info->src_addrlen;
+        }
+    }
+    entry->providers = na_ofi_dupinfo_list(providers);
+    if (entry->providers == NULL)
+        goto error;
+
+    hg_thread_mutex_lock(&na_ofi_getinfo_cache_mutex_g);
+    HG_LIST_INSERT_HEAD(&na_ofi_getinfo_cache_g, entry, entry);
+    hg_thread_mutex_unlock(&na_ofi_getinfo_cache_mutex_g);
+
+    return;
+
+error:
+    /* Caching is best effort */
+    na_ofi_getinfo_entry_free(entry);
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+na_ofi_getinfo_cache_match(const struct na_ofi_getinfo_entry *entry,
+    enum na_ofi_prov_type prov_type, const struct na_ofi_info *info)
+{
+    if (entry->prov_type != prov_type || entry->has_info != (info != NULL))
+        return false;
+    if (info == NULL)
+        return true;
+
+    return entry->info.thread_mode == info->thread_mode &&
+           entry->info.addr_format == info->addr_format &&
+           entry->info.use_hmem == info->use_hmem &&
+           entry->info.use_trigger == info->use_trigger &&
+           (entry->info.node == NULL
+                   ? info->node == NULL
+                   : info->node != NULL &&
+                         strcmp(entry->info.node, info->node) == 0) &&
+           (entry->info.service == NULL
+                   ? info->service == NULL
+                   : info->service != NULL &&
+                         strcmp(entry->info.service, info->service) == 0) &&
+           entry->info.src_addrlen == info->src_addrlen &&
+           (entry->info.src_addr == NULL
+                   ? info->src_addr == NULL
+                   : info->src_addr != NULL &&
+                         memcmp(entry->info.src_addr, info->src_addr,
+                             info->src_addrlen) == 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_getinfo_entry_free(struct na_ofi_getinfo_entry *entry)
+{
+    if (entry->providers != NULL)
+        fi_freeinfo(entry->providers);
+    free(entry->info.node);
+    free(entry->info.service);
+    free(entry->info.src_addr);
+    free(entry);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct fi_info *
+na_ofi_dupinfo_list(const struct fi_info *providers)
+{
+    struct fi_info *head = NULL, **next_p = &head;
+    const struct fi_info *prov;
+
+    for (prov = providers; prov != NULL; prov = prov->next) {
+        *next_p = fi_dupinfo(prov);
+        if (*next_p == NULL) {
+            if (head != NULL)
+                fi_freeinfo(head);
+            return NULL;
+        }
+        next_p = &(*next_p)->next;
+    }
+
+    return head;
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 na_ofi_freeinfo(struct fi_info *fi_info)
@@ -3664,10 +4763,12 @@ na_ofi_class_alloc(void)
     struct na_ofi_class *na_ofi_class = NULL;
     int rc;
 
-    /* Create private data */
-    na_ofi_class = (struct na_ofi_class *) calloc(1, sizeof(*na_ofi_class));
+    /* Create private data (cache line aligned) */
+    na_ofi_class = (struct na_ofi_class *) hg_mem_aligned_alloc(
+        HG_MEM_CACHE_LINE_SIZE, sizeof(*na_ofi_class));
     NA_CHECK_SUBSYS_ERROR_NORET(cls, na_ofi_class == NULL, error,
         "Could not allocate NA private data class");
+    memset(na_ofi_class, 0, sizeof(*na_ofi_class));
     hg_atomic_init32(&na_ofi_class->n_contexts, 0);
 
     /* Initialize addr pool */
@@ -3676,6 +4777,10 @@ na_ofi_class_alloc(void)
         cls, rc != HG_UTIL_SUCCESS, error, "hg_thread_spin_init() failed");
     HG_QUEUE_INIT(&na_ofi_class->addr_pool.queue);
 
+    rc = hg_thread_spin_init(&na_ofi_class->ring_lock);
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        cls, rc != HG_UTIL_SUCCESS, error, "hg_thread_spin_init() failed");
+
     return na_ofi_class;
 
 error:
@@ -3739,8 +4844,9 @@ na_ofi_class_free(struct na_ofi_class *na_ofi_class)
         na_ofi_freeinfo(na_ofi_class->fi_info);
 
     (void) hg_thread_spin_destroy(&na_ofi_class->addr_pool.lock);
+    (void) hg_thread_spin_destroy(&na_ofi_class->ring_lock);
 
-    free(na_ofi_class);
+    hg_mem_aligned_free(na_ofi_class);
 
 out:
     return ret;
@@ -3783,6 +4889,39 @@ na_ofi_class_env_config(struct na_ofi_class *na_ofi_class)
         "NA_OFI_OP_RETRY_PERIOD (%u) > NA_OFI_OP_RETRY_TIMEOUT(%u)",
         na_ofi_class->op_retry_period, na_ofi_class->op_retry_timeout);
 
+    /* Max number of CQ events read at once */
+    if ((env = getenv("NA_OFI_CQ_EVENT_MAX")) != NULL) {
+        na_ofi_class->cq_event_max = (size_t) atoi(env);
+    } else
+        na_ofi_class->cq_event_max = NA_OFI_CQ_EVENT_MAX;
+    NA_CHECK_SUBSYS_ERROR(cls, na_ofi_class->cq_event_max == 0, error, ret,
+        NA_INVALID_ARG, "NA_OFI_CQ_EVENT_MAX must be greater than 0");
+
+    /* Rendezvous for messages larger than threshold (disabled by default) */
+    if ((env = getenv("NA_OFI_RDV_SIZE")) != NULL)
+        na_ofi_class->rdv_msg_size = (size_t) atol(env);
+    if ((env = getenv("NA_OFI_RDV_THRESHOLD")) != NULL)
+        na_ofi_class->rdv_threshold = (size_t) atol(env);
+    else
+        na_ofi_class->rdv_threshold = NA_OFI_MSG_SIZE;
+
+    /* Let the NIC pace RMA ops through triggered ops (disabled by default) */
+    if ((env = getenv("NA_OFI_CXI_DEFERRED_RMA")) != NULL)
+        na_ofi_class->deferred_rma_max = (size_t) atol(env);
+
+    /* Open one endpoint per context on providers that do not support SEP */
+    env = getenv("NA_OFI_MULTI_EP");
+    na_ofi_class->multi_ep =
+        (env != NULL && env[0] != '0' && tolower(env[0]) != 'n');
+
+    /* Write unexpected msgs into per-sender rings (disabled by default) */
+    if ((env = getenv("NA_OFI_UNEXPECTED_RING")) != NULL)
+        na_ofi_class->ring_slot_num = (size_t) atol(env);
+    NA_CHECK_SUBSYS_ERROR(cls,
+        na_ofi_class->ring_slot_num > NA_OFI_RING_SLOT_MAX, error, ret,
+        NA_INVALID_ARG, "NA_OFI_UNEXPECTED_RING (%zu) > %d",
+        na_ofi_class->ring_slot_num, NA_OFI_RING_SLOT_MAX);
+
     return NA_SUCCESS;
 
 error:
@@ -4081,9 +5220,10 @@ na_ofi_domain_open(const struct na_ofi_fabric *na_ofi_fabric,
 #endif
 
     /* Init rw lock */
-    rc = hg_thread_rwlock_init(&na_ofi_domain->addr_map.lock);
+    rc = hg_thread_brlock_init(&na_ofi_domain->addr_map.lock);
     NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
-        "hg_thread_rwlock_init() failed");
+        "hg_thread_brlock_init() failed");
+    hg_atomic_init32(&na_ofi_domain->addr_map.gen, 0);
 
     /* Dup name */
     na_ofi_domain->name = strdup(domain_attr->name);
@@ -4115,6 +5255,12 @@ na_ofi_domain_open(const struct na_ofi_fabric *na_ofi_fabric,
     NA_CHECK_SUBSYS_ERROR(cls, rc != 0, error, ret, na_ofi_errno_to_na(-rc),
         "fi_domain() failed, rc: %d (%s)", rc, fi_strerror(-rc));
 
+    /* Create MR cache if requested */
+    if (getenv("NA_OFI_MR_CACHE") != NULL) {
+        ret = na_ofi_mr_cache_create(&na_ofi_domain->mr_cache);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not create MR cache");
+    }
+
     /* Cache max number of contexts */
     na_ofi_domain->context_max =
         MIN(domain_attr->tx_ctx_cnt, domain_attr->rx_ctx_cnt);
@@ -4227,6 +5373,8 @@ error:
     if (na_ofi_domain) {
         if (na_ofi_domain->fi_av)
             (void) fi_close(&na_ofi_domain->fi_av->fid);
+        na_ofi_mr_cache_destroy(
+            na_ofi_domain->mr_cache, na_ofi_domain->mr_reg_count);
         if (na_ofi_domain->fi_domain)
             (void) fi_close(&na_ofi_domain->fi_domain->fid);
         if (na_ofi_domain->addr_map.key_map)
@@ -4234,7 +5382,7 @@ error:
         if (na_ofi_domain->addr_map.fi_map)
             hg_hash_table_free(na_ofi_domain->addr_map.fi_map);
 
-        hg_thread_rwlock_destroy(&na_ofi_domain->addr_map.lock);
+        hg_thread_brlock_destroy(&na_ofi_domain->addr_map.lock);
         free(na_ofi_domain->name);
         free(na_ofi_domain);
     }
@@ -4268,6 +5416,11 @@ na_ofi_domain_close(
 
     NA_LOG_SUBSYS_DEBUG(cls, "Freeing domain");
 
+    /* Close unused MRs before closing domain */
+    na_ofi_mr_cache_destroy(
+        na_ofi_domain->mr_cache, na_ofi_domain->mr_reg_count);
+    na_ofi_domain->mr_cache = NULL;
+
     /* Close AV */
     if (na_ofi_domain->fi_av) {
         rc = fi_close(&na_ofi_domain->fi_av->fid);
@@ -4296,7 +5449,7 @@ na_ofi_domain_close(
     if (na_ofi_domain->addr_map.fi_map)
         hg_hash_table_free(na_ofi_domain->addr_map.fi_map);
 
-    hg_thread_rwlock_destroy(&na_ofi_domain->addr_map.lock);
+    hg_thread_brlock_destroy(&na_ofi_domain->addr_map.lock);
 
     free(na_ofi_domain->name);
     free(na_ofi_domain);
@@ -4546,6 +5699,69 @@ out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_context_ep_open(struct na_ofi_class *na_ofi_class, uint8_t id,
+    struct na_ofi_endpoint **na_ofi_endpoint_p)
+{
+    struct na_ofi_endpoint *na_ofi_endpoint = NULL;
+    struct fi_info *fi_info = NULL;
+    int addr_format = (int) na_ofi_class->fi_info->addr_format;
+    size_t addrlen = na_ofi_prov_addr_size(addr_format);
+    na_return_t ret;
+
+    na_ofi_endpoint =
+        (struct na_ofi_endpoint *) calloc(1, sizeof(*na_ofi_endpoint));
+    NA_CHECK_SUBSYS_ERROR(ctx, na_ofi_endpoint == NULL, error, ret, NA_NOMEM,
+        "Could not allocate na_ofi_endpoint");
+
+    /* Same msg size limits as class endpoint */
+    na_ofi_endpoint->unexpected_msg_size_max =
+        na_ofi_class->endpoint->unexpected_msg_size_max;
+    na_ofi_endpoint->expected_msg_size_max =
+        na_ofi_class->endpoint->expected_msg_size_max;
+
+    fi_info = fi_dupinfo(na_ofi_class->fi_info);
+    NA_CHECK_SUBSYS_ERROR(ctx, fi_info == NULL, error, ret, NA_NOMEM,
+        "fi_dupinfo() failed");
+
+    /* Bind to the class endpoint address with port shifted by context id */
+    free(fi_info->src_addr);
+    fi_info->src_addr = malloc(addrlen);
+    NA_CHECK_SUBSYS_ERROR(ctx, fi_info->src_addr == NULL, error, ret, NA_NOMEM,
+        "Could not allocate src_addr");
+    memcpy(fi_info->src_addr, &na_ofi_class->endpoint->src_addr->addr_key.addr,
+        addrlen);
+    fi_info->src_addrlen = addrlen;
+
+    ret = na_ofi_raw_addr_port_shift(
+        addr_format, (union na_ofi_raw_addr *) fi_info->src_addr, id);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        ctx, error, ret, "Could not derive address of context %" PRIu8, id);
+
+    NA_LOG_SUBSYS_DEBUG(ctx, "Opening endpoint for context %" PRIu8, id);
+
+    ret = na_ofi_basic_ep_open(na_ofi_class->fabric, na_ofi_class->domain,
+        fi_info, na_ofi_class->no_wait, na_ofi_endpoint);
+    NA_CHECK_SUBSYS_NA_ERROR(ctx, error, ret,
+        "Could not open endpoint for context %" PRIu8
+        " (port may already be in use)",
+        id);
+
+    fi_freeinfo(fi_info);
+
+    *na_ofi_endpoint_p = na_ofi_endpoint;
+
+    return NA_SUCCESS;
+
+error:
+    if (fi_info)
+        fi_freeinfo(fi_info);
+    free(na_ofi_endpoint);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_eq_open(const struct na_ofi_fabric *na_ofi_fabric,
@@ -4584,6 +5800,8 @@ na_ofi_eq_open(const struct na_ofi_fabric *na_ofi_fabric,
         NA_NOMEM, "Could not allocate retry_op_queue");
     HG_QUEUE_INIT(&na_ofi_eq->retry_op_queue->queue);
     hg_thread_spin_init(&na_ofi_eq->retry_op_queue->lock);
+    hg_backoff_init(&na_ofi_eq->retry_backoff, NA_OFI_OP_RETRY_BACKOFF_MIN,
+        NA_OFI_OP_RETRY_BACKOFF_MAX);
 
     if (!no_wait) {
         if (na_ofi_prov_flags[na_ofi_fabric->prov_type] & NA_OFI_WAIT_FD)
@@ -4724,6 +5942,7 @@ na_ofi_endpoint_get_src_addr(struct na_ofi_class *na_ofi_class)
         &addr_key, &na_ofi_class->endpoint->src_addr);
     NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not insert src address");
 
+    na_ofi_class->endpoint->src_addr->ep_base = true;
     na_ofi_addr_ref_incr(na_ofi_class->endpoint->src_addr);
 
     return NA_SUCCESS;
@@ -4788,8 +6007,18 @@ na_ofi_addr_alloc(struct na_ofi_class *na_ofi_class)
     struct na_ofi_addr *na_ofi_addr;
 
     na_ofi_addr = calloc(1, sizeof(*na_ofi_addr));
-    if (na_ofi_addr)
-        na_ofi_addr->class = na_ofi_class;
+    if (na_ofi_addr == NULL)
+        return NULL;
+    na_ofi_addr->class = na_ofi_class;
+
+    if (na_ofi_class->multi_ep) {
+        na_ofi_addr->ep_addrs = (struct na_ofi_addr **) calloc(
+            na_ofi_class->context_max, sizeof(*na_ofi_addr->ep_addrs));
+        if (na_ofi_addr->ep_addrs == NULL) {
+            free(na_ofi_addr);
+            return NULL;
+        }
+    }
 
     return na_ofi_addr;
 }
@@ -4801,6 +6030,7 @@ na_ofi_addr_destroy(struct na_ofi_addr *na_ofi_addr)
     NA_LOG_SUBSYS_DEBUG(addr, "Destroying address %p", (void *) na_ofi_addr);
 
     na_ofi_addr_release(na_ofi_addr);
+    free(na_ofi_addr->ep_addrs);
     free(na_ofi_addr);
 }
 
@@ -4830,6 +6060,28 @@ na_ofi_addr_pool_get(struct na_ofi_class *na_ofi_class)
 static void
 na_ofi_addr_release(struct na_ofi_addr *na_ofi_addr)
 {
+    /* Drop references to remote context endpoint addresses */
+    if (na_ofi_addr->ep_addrs != NULL) {
+        uint8_t i;
+
+        for (i = 1; i < na_ofi_addr->class->context_max; i++) {
+            if (na_ofi_addr->ep_addrs[i] == NULL)
+                continue;
+            na_ofi_addr_ref_decr(na_ofi_addr->ep_addrs[i]);
+            na_ofi_addr->ep_addrs[i] = NULL;
+        }
+    }
+
+    /* Rings granted by the remote contexts */
+    if (na_ofi_addr->ring_tx != NULL) {
+        unsigned int i;
+
+        for (i = 0; i < NA_OFI_RING_TX_MAX; i++)
+            free(na_ofi_addr->ring_tx[i]);
+        free(na_ofi_addr->ring_tx);
+        na_ofi_addr->ring_tx = NULL;
+    }
+
     if (na_ofi_addr->addr_key.val) {
         /* Removal is not needed when finalizing unless domain is shared */
         if (!na_ofi_addr->class->finalizing ||
@@ -4847,6 +6099,7 @@ na_ofi_addr_reset(
 {
     /* One refcount for the caller to hold until addr_free */
     hg_atomic_init32(&na_ofi_addr->refcount, 1);
+    na_ofi_addr->ep_base = false;
 
     /* Keep copy of the key */
     na_ofi_addr->addr_key = *addr_key;
@@ -4909,6 +6162,84 @@ na_ofi_addr_ref_decr(struct na_ofi_addr *na_ofi_addr)
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+na_ofi_addr_route(
+    struct na_ofi_addr *na_ofi_addr, uint8_t id, fi_addr_t *fi_addr_p)
+{
+    if (!na_ofi_addr->class->multi_ep) {
+        *fi_addr_p =
+            fi_rx_addr(na_ofi_addr->fi_addr, id, NA_OFI_SEP_RX_CTX_BITS);
+        return NA_SUCCESS;
+    }
+
+    /* Addresses that were not looked up by name (e.g., source addresses of
+     * incoming messages) already target the remote context endpoint */
+    if (id == 0 || !na_ofi_addr->ep_base) {
+        *fi_addr_p = na_ofi_addr->fi_addr;
+        return NA_SUCCESS;
+    }
+
+    return na_ofi_addr_ep_lookup(na_ofi_addr, id, fi_addr_p);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_addr_ep_lookup(
+    struct na_ofi_addr *na_ofi_addr, uint8_t id, fi_addr_t *fi_addr_p)
+{
+    struct na_ofi_class *na_ofi_class = na_ofi_addr->class;
+    struct na_ofi_map *na_ofi_map = &na_ofi_class->domain->addr_map;
+    int addr_format = (int) na_ofi_class->fi_info->addr_format;
+    struct na_ofi_addr *ep_addr;
+    struct na_ofi_addr_key addr_key;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(addr, id >= na_ofi_class->context_max, error, ret,
+        NA_INVALID_ARG, "Context id %" PRIu8 " exceeds max_contexts %" PRIu8,
+        id, na_ofi_class->context_max);
+
+    /* Fast path, address was already resolved */
+    hg_thread_brlock_rdlock(&na_ofi_map->lock);
+    ep_addr = na_ofi_addr->ep_addrs[id];
+    if (ep_addr != NULL)
+        *fi_addr_p = ep_addr->fi_addr;
+    hg_thread_brlock_release_rdlock(&na_ofi_map->lock);
+    if (ep_addr != NULL)
+        return NA_SUCCESS;
+
+    /* Context endpoints listen on consecutive ports after the base one */
+    addr_key.addr = na_ofi_addr->addr_key.addr;
+    ret = na_ofi_raw_addr_port_shift(addr_format, &addr_key.addr, id);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, error, ret, "Could not derive address of context %" PRIu8, id);
+
+    addr_key.val = na_ofi_raw_addr_to_key(addr_format, &addr_key.addr);
+    NA_CHECK_SUBSYS_ERROR(addr, addr_key.val == 0, error, ret,
+        NA_PROTONOSUPPORT, "Could not generate key from addr");
+
+    ret = na_ofi_addr_key_lookup(na_ofi_class, &addr_key, &ep_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret,
+        "Could not lookup address of context %" PRIu8, id);
+
+    /* Keep the first resolved address if another thread raced us */
+    hg_thread_brlock_wrlock(&na_ofi_map->lock);
+    if (na_ofi_addr->ep_addrs[id] == NULL) {
+        na_ofi_addr->ep_addrs[id] = ep_addr;
+        ep_addr = NULL;
+    }
+    *fi_addr_p = na_ofi_addr->ep_addrs[id]->fi_addr;
+    hg_thread_brlock_release_wrlock(&na_ofi_map->lock);
+
+    if (ep_addr != NULL)
+        na_ofi_addr_ref_decr(ep_addr);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void *
 na_ofi_mem_alloc(struct na_ofi_class *na_ofi_class, size_t size,
@@ -4920,8 +6251,10 @@ na_ofi_mem_alloc(struct na_ofi_class *na_ofi_class, size_t size,
     int rc;
 
 #if !defined(_WIN32) && !defined(__APPLE__)
+    /* Large buffers always attempt to use huge pages, smaller ones only if
+     * requested at init time */
     page_size = (size_t) hg_mem_get_hugepage_size();
-    if (page_size > 0 && size >= page_size) {
+    if (page_size > 0 && (size >= page_size || na_ofi_class->huge_pages)) {
         /* Allocate a multiple of page size (TODO use extra space) */
         alloc_size = ((size % page_size) == 0)
                          ? size
@@ -5064,33 +6397,330 @@ na_ofi_mem_key_gen(struct na_ofi_domain *na_ofi_domain)
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ofi_msg_send(
-    struct fid_ep *ep, const struct na_ofi_msg_info *msg_info, void *context)
+na_ofi_mr_cache_create(struct na_ofi_mr_cache **mr_cache_p)
 {
-    ssize_t rc;
+    struct na_ofi_mr_cache *na_ofi_mr_cache = NULL;
+    const char *env;
+    na_return_t ret;
+    int rc;
 
-    NA_LOG_SUBSYS_DEBUG(msg,
-        "Posting fi_senddata() (buf=%p, len=%zu, desc=%p, data=%" PRIu64
-        ", dest_addr=%" PRIu64 ", context=%p)",
-        msg_info->buf.const_ptr, msg_info->buf_size, msg_info->desc,
-        msg_info->tag & NA_OFI_TAG_MASK, msg_info->fi_addr, context);
+    na_ofi_mr_cache =
+        (struct na_ofi_mr_cache *) calloc(1, sizeof(*na_ofi_mr_cache));
+    NA_CHECK_SUBSYS_ERROR(mem, na_ofi_mr_cache == NULL, error, ret, NA_NOMEM,
+        "Could not allocate MR cache");
+    HG_QUEUE_INIT(&na_ofi_mr_cache->unused);
+
+    /* Unused MRs are kept registered until evicted, this is not safe if
+     * memory may be released without being monitored */
+    env = getenv("NA_OFI_MR_CACHE_MAX");
+    na_ofi_mr_cache->unused_max = (env != NULL)
+                                      ? (unsigned int) atoi(env)
+                                      : NA_OFI_MR_CACHE_UNUSED_MAX;
+    env = getenv("FI_MR_CACHE_MONITOR");
+    if (env != NULL && strcmp(env, "disabled") == 0) {
+        NA_LOG_SUBSYS_DEBUG(mem, "FI_MR_CACHE_MONITOR is disabled, MR cache "
+                                 "only shares registrations in use");
+        na_ofi_mr_cache->unused_max = 0;
+    }
+
+    rc = hg_thread_mutex_init(&na_ofi_mr_cache->lock);
+    NA_CHECK_SUBSYS_ERROR(mem, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+        "hg_thread_mutex_init() failed");
+
+    na_ofi_mr_cache->map =
+        hg_hash_table_new(na_ofi_mr_cache_key_hash, na_ofi_mr_cache_key_equal);
+    NA_CHECK_SUBSYS_ERROR(mem, na_ofi_mr_cache->map == NULL, error_lock, ret,
+        NA_NOMEM, "Could not allocate MR cache map");
 
-    rc = fi_senddata(ep, msg_info->buf.const_ptr, msg_info->buf_size,
-        msg_info->desc, msg_info->tag & NA_OFI_TAG_MASK, msg_info->fi_addr,
-        context);
-    if (rc == 0)
-        return NA_SUCCESS;
-    else if (rc == -FI_EAGAIN)
-        return NA_AGAIN;
-    else {
-        NA_LOG_SUBSYS_ERROR(msg,
-            "fi_senddata() failed, rc: %zd (%s), buf=%p, len=%zu, desc=%p, "
-            "data=%" PRIu64 ", dest_addr=%" PRIu64 ", context=%p",
-            rc, fi_strerror((int) -rc), msg_info->buf.const_ptr,
-            msg_info->buf_size, msg_info->desc, msg_info->tag & NA_OFI_TAG_MASK,
-            msg_info->fi_addr, context);
-        return na_ofi_errno_to_na((int) -rc);
-    }
+#ifndef _WIN32
+    HG_LOG_ADD_COUNTER32(na, &na_ofi_mr_cache->hit_count, "mr_cache_hit_count",
+        "MR cache hit count");
+    HG_LOG_ADD_COUNTER32(na, &na_ofi_mr_cache->miss_count,
+        "mr_cache_miss_count", "MR cache miss count");
+#endif
+
+    NA_LOG_SUBSYS_DEBUG(mem, "Created MR cache (unused max: %u)",
+        na_ofi_mr_cache->unused_max);
+
+    *mr_cache_p = na_ofi_mr_cache;
+
+    return NA_SUCCESS;
+
+error_lock:
+    hg_thread_mutex_destroy(&na_ofi_mr_cache->lock);
+error:
+    free(na_ofi_mr_cache);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_mr_cache_destroy(
+    struct na_ofi_mr_cache *na_ofi_mr_cache, hg_atomic_int32_t *mr_reg_count)
+{
+    hg_hash_table_iter_t iter;
+
+    if (na_ofi_mr_cache == NULL)
+        return;
+
+    /* Entries still in use at that point cannot be released anymore */
+    NA_CHECK_SUBSYS_WARNING(mem,
+        hg_hash_table_num_entries(na_ofi_mr_cache->map) !=
+            na_ofi_mr_cache->unused_count,
+        "%u registrations are still in use",
+        hg_hash_table_num_entries(na_ofi_mr_cache->map) -
+            na_ofi_mr_cache->unused_count);
+
+    hg_hash_table_iterate(na_ofi_mr_cache->map, &iter);
+    while (hg_hash_table_iter_has_more(&iter)) {
+        struct na_ofi_mr_cache_entry *entry =
+            (struct na_ofi_mr_cache_entry *) hg_hash_table_iter_next(&iter);
+
+        if (entry->refcount == 0) {
+            (void) fi_close(&entry->fi_mr->fid);
+            hg_atomic_decr32(mr_reg_count);
+        }
+        free(entry);
+    }
+    hg_hash_table_free(na_ofi_mr_cache->map);
+    hg_thread_mutex_destroy(&na_ofi_mr_cache->lock);
+    free(na_ofi_mr_cache);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE unsigned int
+na_ofi_mr_cache_key_hash(hg_hash_table_key_t key)
+{
+    const struct na_ofi_mr_cache_key *mr_cache_key =
+        (const struct na_ofi_mr_cache_key *) key;
+    uint64_t val = (uint64_t) mr_cache_key->base ^ (uint64_t) mr_cache_key->len;
+
+    /* Regions are usually page aligned, mix upper bits in */
+    return (unsigned int) ((val >> 12) ^ (val >> 32) ^ val);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_ofi_mr_cache_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    const struct na_ofi_mr_cache_key *mr_cache_key1 =
+        (const struct na_ofi_mr_cache_key *) key1;
+    const struct na_ofi_mr_cache_key *mr_cache_key2 =
+        (const struct na_ofi_mr_cache_key *) key2;
+
+    return mr_cache_key1->base == mr_cache_key2->base &&
+           mr_cache_key1->len == mr_cache_key2->len &&
+           mr_cache_key1->access == mr_cache_key2->access &&
+           mr_cache_key1->iface == mr_cache_key2->iface &&
+           mr_cache_key1->device == mr_cache_key2->device;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_ofi_mr_cache_entry *
+na_ofi_mr_cache_get(struct na_ofi_mr_cache *na_ofi_mr_cache,
+    const struct na_ofi_mr_cache_key *key)
+{
+    struct na_ofi_mr_cache_entry *entry;
+
+    hg_thread_mutex_lock(&na_ofi_mr_cache->lock);
+    entry = (struct na_ofi_mr_cache_entry *) hg_hash_table_lookup(
+        na_ofi_mr_cache->map, (hg_hash_table_key_t) key);
+    if (entry != HG_HASH_TABLE_NULL) {
+        if (entry->refcount++ == 0) {
+            HG_QUEUE_REMOVE(&na_ofi_mr_cache->unused, entry,
+                na_ofi_mr_cache_entry, entry);
+            na_ofi_mr_cache->unused_count--;
+        }
+    } else
+        entry = NULL;
+    hg_thread_mutex_unlock(&na_ofi_mr_cache->lock);
+
+    if (entry != NULL)
+        hg_atomic_incr32(na_ofi_mr_cache->hit_count);
+
+    return entry;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_mr_cache_add(struct na_ofi_mr_cache *na_ofi_mr_cache,
+    const struct na_ofi_mr_cache_key *key, struct fid_mr *fi_mr,
+    struct na_ofi_mr_cache_entry **entry_p)
+{
+    struct na_ofi_mr_cache_entry *entry;
+    na_return_t ret = NA_SUCCESS;
+    int rc;
+
+    hg_atomic_incr32(na_ofi_mr_cache->miss_count);
+
+    hg_thread_mutex_lock(&na_ofi_mr_cache->lock);
+
+    /* Look up again in case the same region was registered concurrently */
+    entry = (struct na_ofi_mr_cache_entry *) hg_hash_table_lookup(
+        na_ofi_mr_cache->map, (hg_hash_table_key_t) key);
+    if (entry != HG_HASH_TABLE_NULL) {
+        if (entry->refcount++ == 0) {
+            HG_QUEUE_REMOVE(&na_ofi_mr_cache->unused, entry,
+                na_ofi_mr_cache_entry, entry);
+            na_ofi_mr_cache->unused_count--;
+        }
+        goto out;
+    }
+
+    entry = (struct na_ofi_mr_cache_entry *) malloc(sizeof(*entry));
+    NA_CHECK_SUBSYS_ERROR(mem, entry == NULL, out, ret, NA_NOMEM,
+        "Could not allocate MR cache entry");
+    entry->key = *key;
+    entry->fi_mr = fi_mr;
+    entry->refcount = 1;
+
+    rc = hg_hash_table_insert(na_ofi_mr_cache->map,
+        (hg_hash_table_key_t) &entry->key, (hg_hash_table_value_t) entry);
+    if (rc == 0) {
+        free(entry);
+        entry = NULL;
+        NA_GOTO_SUBSYS_ERROR(
+            mem, out, ret, NA_NOMEM, "hg_hash_table_insert() failed");
+    }
+
+out:
+    hg_thread_mutex_unlock(&na_ofi_mr_cache->lock);
+
+    *entry_p = entry;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct fid_mr *
+na_ofi_mr_cache_release(struct na_ofi_mr_cache *na_ofi_mr_cache,
+    struct na_ofi_mr_cache_entry *entry)
+{
+    struct fid_mr *fi_mr = NULL;
+
+    hg_thread_mutex_lock(&na_ofi_mr_cache->lock);
+    if (--entry->refcount > 0)
+        goto unlock;
+
+    /* Keep MR registered for reuse and evict oldest unused MR if needed */
+    if (na_ofi_mr_cache->unused_max > 0) {
+        HG_QUEUE_PUSH_TAIL(&na_ofi_mr_cache->unused, entry, entry);
+        if (++na_ofi_mr_cache->unused_count <= na_ofi_mr_cache->unused_max)
+            goto unlock;
+
+        entry = HG_QUEUE_FIRST(&na_ofi_mr_cache->unused);
+        HG_QUEUE_POP_HEAD(&na_ofi_mr_cache->unused, entry);
+        na_ofi_mr_cache->unused_count--;
+    }
+
+    (void) hg_hash_table_remove(
+        na_ofi_mr_cache->map, (hg_hash_table_key_t) &entry->key);
+    fi_mr = entry->fi_mr;
+    free(entry);
+
+unlock:
+    hg_thread_mutex_unlock(&na_ofi_mr_cache->lock);
+
+    return fi_mr;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_msg_send(
+    struct fid_ep *ep, const struct na_ofi_msg_info *msg_info, void *context)
+{
+    ssize_t rc;
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Posting fi_senddata() (buf=%p, len=%zu, desc=%p, data=%" PRIu64
+        ", dest_addr=%" PRIu64 ", context=%p)",
+        msg_info->buf.const_ptr, msg_info->buf_size, msg_info->desc,
+        msg_info->tag & NA_OFI_TAG_MASK, msg_info->fi_addr, context);
+
+    rc = fi_senddata(ep, msg_info->buf.const_ptr, msg_info->buf_size,
+        msg_info->desc, msg_info->tag & NA_OFI_TAG_MASK, msg_info->fi_addr,
+        context);
+    if (rc == 0)
+        return NA_SUCCESS;
+    else if (rc == -FI_EAGAIN)
+        return NA_AGAIN;
+    else {
+        NA_LOG_SUBSYS_ERROR(msg,
+            "fi_senddata() failed, rc: %zd (%s), buf=%p, len=%zu, desc=%p, "
+            "data=%" PRIu64 ", dest_addr=%" PRIu64 ", context=%p",
+            rc, fi_strerror((int) -rc), msg_info->buf.const_ptr,
+            msg_info->buf_size, msg_info->desc, msg_info->tag & NA_OFI_TAG_MASK,
+            msg_info->fi_addr, context);
+        return na_ofi_errno_to_na((int) -rc);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_msg_inject(struct fid_ep *ep, const struct na_ofi_msg_info *msg_info)
+{
+    ssize_t rc;
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Posting fi_injectdata() (buf=%p, len=%zu, data=%" PRIu64
+        ", dest_addr=%" PRIu64 ")",
+        msg_info->buf.const_ptr, msg_info->buf_size,
+        msg_info->tag & NA_OFI_TAG_MASK, msg_info->fi_addr);
+
+    rc = fi_injectdata(ep, msg_info->buf.const_ptr, msg_info->buf_size,
+        msg_info->tag & NA_OFI_TAG_MASK, msg_info->fi_addr);
+    if (rc == 0)
+        return NA_SUCCESS;
+    else if (rc == -FI_EAGAIN)
+        return NA_AGAIN;
+    else {
+        NA_LOG_SUBSYS_ERROR(msg,
+            "fi_injectdata() failed, rc: %zd (%s), buf=%p, len=%zu, "
+            "data=%" PRIu64 ", dest_addr=%" PRIu64,
+            rc, fi_strerror((int) -rc), msg_info->buf.const_ptr,
+            msg_info->buf_size, msg_info->tag & NA_OFI_TAG_MASK,
+            msg_info->fi_addr);
+        return na_ofi_errno_to_na((int) -rc);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_msg_sendmsg(struct fid_ep *ep, const struct na_ofi_msg_info *msg_info,
+    void *context, uint64_t flags)
+{
+    struct iovec msg_iov = {
+        .iov_base = (void *) (uintptr_t) msg_info->buf.const_ptr,
+        .iov_len = msg_info->buf_size};
+    void *descs[1] = {msg_info->desc};
+    struct fi_msg msg = {.msg_iov = &msg_iov,
+        .desc = descs,
+        .iov_count = 1,
+        .addr = msg_info->fi_addr,
+        .context = context,
+        .data = msg_info->tag & NA_OFI_TAG_MASK};
+    ssize_t rc;
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Posting fi_sendmsg() (iov_base=%p, iov_len=%zu, desc=%p, data=%" PRIu64
+        ", addr=%" PRIu64 ", context=%p, flags=%" PRIx64 ")",
+        msg.msg_iov[0].iov_base, msg.msg_iov[0].iov_len, msg.desc[0], msg.data,
+        msg.addr, context, flags);
+
+    rc = fi_sendmsg(ep, &msg, flags | FI_REMOTE_CQ_DATA);
+    if (rc == 0)
+        return NA_SUCCESS;
+    else if (rc == -FI_EAGAIN)
+        return NA_AGAIN;
+    else {
+        NA_LOG_SUBSYS_ERROR(msg,
+            "fi_sendmsg() failed, rc: %zd (%s), iov_base=%p, iov_len=%zu, "
+            "desc=%p, data=%" PRIu64 ", addr=%" PRIu64 ", context=%p",
+            rc, fi_strerror((int) -rc), msg.msg_iov[0].iov_base,
+            msg.msg_iov[0].iov_len, msg.desc[0], msg.data, msg.addr, context);
+        return na_ofi_errno_to_na((int) -rc);
+    }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -5190,6 +6820,94 @@ na_ofi_tag_send(
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_tag_inject(struct fid_ep *ep, const struct na_ofi_msg_info *msg_info)
+{
+    ssize_t rc;
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Posting fi_tinject() (buf=%p, len=%zu, dest_addr=%" PRIu64
+        ", tag=%" PRIu64 ")",
+        msg_info->buf.const_ptr, msg_info->buf_size, msg_info->fi_addr,
+        msg_info->tag);
+
+    rc = fi_tinject(ep, msg_info->buf.const_ptr, msg_info->buf_size,
+        msg_info->fi_addr, msg_info->tag);
+    if (rc == 0)
+        return NA_SUCCESS;
+    else if (rc == -FI_EAGAIN)
+        return NA_AGAIN;
+    else {
+        NA_LOG_SUBSYS_ERROR(msg,
+            "fi_tinject() failed, rc: %zd (%s), buf=%p, len=%zu, "
+            "dest_addr=%" PRIu64 ", tag=%" PRIu64,
+            rc, fi_strerror((int) -rc), msg_info->buf.const_ptr,
+            msg_info->buf_size, msg_info->fi_addr, msg_info->tag);
+        return na_ofi_errno_to_na((int) -rc);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_msg_send_inject(struct na_ofi_context *na_ofi_context,
+    struct na_ofi_op_id *na_ofi_op_id, bool tagged)
+{
+    na_return_t ret;
+
+    ret = (tagged) ? na_ofi_tag_inject(
+                         na_ofi_context->fi_tx, &na_ofi_op_id->info.msg)
+                   : na_ofi_msg_inject(
+                         na_ofi_context->fi_tx, &na_ofi_op_id->info.msg);
+    if (ret != NA_SUCCESS)
+        return ret;
+
+    /* Buffer can be reused and no CQ entry will be generated */
+    na_ofi_op_id->complete(na_ofi_op_id, true, NA_SUCCESS);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_tag_sendmsg(struct fid_ep *ep, const struct na_ofi_msg_info *msg_info,
+    void *context, uint64_t flags)
+{
+    struct iovec msg_iov = {
+        .iov_base = (void *) (uintptr_t) msg_info->buf.const_ptr,
+        .iov_len = msg_info->buf_size};
+    void *descs[1] = {msg_info->desc};
+    struct fi_msg_tagged msg = {.msg_iov = &msg_iov,
+        .desc = descs,
+        .iov_count = 1,
+        .addr = msg_info->fi_addr,
+        .tag = msg_info->tag,
+        .ignore = 0,
+        .context = context,
+        .data = 0};
+    ssize_t rc;
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Posting fi_tsendmsg() (iov_base=%p, iov_len=%zu, desc=%p, "
+        "addr=%" PRIu64 ", tag=%" PRIu64 ", context=%p, flags=%" PRIx64 ")",
+        msg.msg_iov[0].iov_base, msg.msg_iov[0].iov_len, msg.desc[0], msg.addr,
+        msg.tag, context, flags);
+
+    rc = fi_tsendmsg(ep, &msg, flags);
+    if (rc == 0)
+        return NA_SUCCESS;
+    else if (rc == -FI_EAGAIN)
+        return NA_AGAIN;
+    else {
+        NA_LOG_SUBSYS_ERROR(msg,
+            "fi_tsendmsg() failed, rc: %zd (%s), iov_base=%p, iov_len=%zu, "
+            "desc=%p, addr=%" PRIu64 ", tag=%" PRIu64 ", context=%p",
+            rc, fi_strerror((int) -rc), msg.msg_iov[0].iov_base,
+            msg.msg_iov[0].iov_len, msg.desc[0], msg.addr, msg.tag, context);
+        return na_ofi_errno_to_na((int) -rc);
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_tag_recv(
@@ -5354,187 +7072,1569 @@ na_ofi_rma_common(struct na_ofi_class *na_ofi_class, na_context_t *context,
     size_t local_iov_start_index = 0, remote_iov_start_index = 0;
     na_offset_t local_iov_start_offset = 0, remote_iov_start_offset = 0;
     struct na_ofi_rma_info *rma_info;
+    na_return_t (*rma_post)(
+        struct fid_ep *, const struct na_ofi_rma_info *, void *);
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_ofi_op_id->type));
+
+    NA_OFI_OP_RESET(
+        na_ofi_op_id, context, FI_RMA, cb_type, callback, arg, na_ofi_addr);
+
+    /* Set RMA info */
+    rma_info = &na_ofi_op_id->info.rma;
+    rma_info->fi_rma_op = fi_rma_op;
+    rma_info->fi_rma_op_string = fi_rma_op_string;
+    rma_info->fi_rma_flags = fi_rma_flags;
+    rma_info->deferred = NULL;
+    rma_info->remote_cq_data = 0;
+
+    /* Translate local offset */
+    if (local_offset > 0)
+        na_ofi_iov_get_index_offset(local_iov, local_iovcnt, local_offset,
+            &local_iov_start_index, &local_iov_start_offset);
+
+    rma_info->local_iovcnt =
+        (length == na_ofi_mem_handle_local->desc.info.len)
+            ? local_iovcnt
+            : na_ofi_iov_get_count(local_iov, local_iovcnt,
+                  local_iov_start_index, local_iov_start_offset, length);
+
+    /* Translate remote offset */
+    if (remote_offset > 0)
+        na_ofi_iov_get_index_offset(remote_iov, remote_iovcnt, remote_offset,
+            &remote_iov_start_index, &remote_iov_start_offset);
+
+    rma_info->remote_iovcnt =
+        (length == na_ofi_mem_handle_remote->desc.info.len)
+            ? remote_iovcnt
+            : na_ofi_iov_get_count(remote_iov, remote_iovcnt,
+                  remote_iov_start_index, remote_iov_start_offset, length);
+
+    ret = na_ofi_rma_iov_alloc(rma_info);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "Could not allocate RMA IOVs");
+
+    /* TODO: support multiple local descs for each iov */
+    na_ofi_iov_translate(local_iov, local_desc, local_iovcnt,
+        local_iov_start_index, local_iov_start_offset, length,
+        rma_info->local_iov, rma_info->local_desc, rma_info->local_iovcnt);
+
+    na_ofi_rma_iov_translate(na_ofi_class->fi_info, remote_iov, remote_iovcnt,
+        remote_key, remote_iov_start_index, remote_iov_start_offset, length,
+        rma_info->remote_iov, rma_info->remote_iovcnt);
+
+    ret = na_ofi_addr_route(na_ofi_addr, remote_id, &rma_info->fi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        rma, release, ret, "Could not resolve remote context address");
+
+    /* Leave ops past the window to the NIC if requested */
+    if (na_ofi_context->rma_cntr != NULL) {
+        ret = na_ofi_rma_deferred_init(
+            na_ofi_class, na_ofi_context, na_ofi_op_id);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            rma, release, ret, "Could not prepare deferred RMA op");
+        rma_post = na_ofi_rma_post_deferred;
+    } else
+        rma_post = na_ofi_rma_post;
+
+    /* Post the OFI RMA operation */
+    ret = rma_post(na_ofi_context->fi_tx, rma_info, &na_ofi_op_id->fi_ctx);
+    if (ret != NA_SUCCESS) {
+        if (ret == NA_AGAIN) {
+            na_ofi_op_id->retry_op.rma = rma_post;
+            na_ofi_op_retry(
+                na_ofi_context, na_ofi_class->op_retry_timeout, na_ofi_op_id);
+        } else
+            NA_GOTO_SUBSYS_ERROR_NORET(rma, release, "Could not post RMA op");
+    }
+
+    return NA_SUCCESS;
+
+release:
+    /* Ops queued after this one count on its completion */
+    if (rma_info->deferred != NULL)
+        (void) fi_cntr_add(na_ofi_context->rma_cntr, 1);
+    na_ofi_rma_release(rma_info);
+
+    NA_OFI_OP_RELEASE(na_ofi_op_id);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE size_t
+na_ofi_mem_handle_iov_range(const struct na_ofi_mem_handle *na_ofi_mem_handle,
+    na_offset_t offset, size_t len, size_t *iov_start_index,
+    na_offset_t *iov_start_offset)
+{
+    size_t iovcnt = (size_t) na_ofi_mem_handle->desc.info.iovcnt;
+    const struct iovec *iov = NA_OFI_IOV(na_ofi_mem_handle->desc.iov, iovcnt);
+
+    *iov_start_index = 0;
+    *iov_start_offset = 0;
+    if (offset > 0)
+        na_ofi_iov_get_index_offset(
+            iov, iovcnt, offset, iov_start_index, iov_start_offset);
+
+    return (len == na_ofi_mem_handle->desc.info.len)
+               ? iovcnt
+               : na_ofi_iov_get_count(
+                     iov, iovcnt, *iov_start_index, *iov_start_offset, len);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rma_iov_alloc(struct na_ofi_rma_info *rma_info)
+{
+    if (rma_info->local_iovcnt > NA_OFI_IOV_STATIC_MAX) {
+        rma_info->local_iov_storage.d = (struct iovec *) malloc(
+            rma_info->local_iovcnt * sizeof(struct iovec));
+        rma_info->local_iov = rma_info->local_iov_storage.d;
+        rma_info->local_desc_storage.d =
+            (void **) malloc(rma_info->local_iovcnt * sizeof(void *));
+        rma_info->local_desc = rma_info->local_desc_storage.d;
+    } else {
+        rma_info->local_iov = rma_info->local_iov_storage.s;
+        rma_info->local_desc = rma_info->local_desc_storage.s;
+    }
+
+    if (rma_info->remote_iovcnt > NA_OFI_IOV_STATIC_MAX) {
+        rma_info->remote_iov_storage.d = (struct fi_rma_iov *) malloc(
+            rma_info->remote_iovcnt * sizeof(struct fi_rma_iov));
+        rma_info->remote_iov = rma_info->remote_iov_storage.d;
+    } else
+        rma_info->remote_iov = rma_info->remote_iov_storage.s;
+
+    if (rma_info->local_iov == NULL || rma_info->local_desc == NULL ||
+        rma_info->remote_iov == NULL) {
+        NA_LOG_SUBSYS_ERROR(rma,
+            "Could not allocate IOV arrays (local_iovcnt=%zu, "
+            "remote_iovcnt=%zu)",
+            rma_info->local_iovcnt, rma_info->remote_iovcnt);
+        na_ofi_rma_release(rma_info);
+        rma_info->local_iovcnt = 0;
+        rma_info->remote_iovcnt = 0;
+        return NA_NOMEM;
+    }
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rma_post(
+    struct fid_ep *ep, const struct na_ofi_rma_info *rma_info, void *context)
+{
+    struct fi_msg_rma fi_msg_rma = {.msg_iov = rma_info->local_iov,
+        .desc = rma_info->local_desc,
+        .iov_count = rma_info->local_iovcnt,
+        .addr = rma_info->fi_addr,
+        .rma_iov = rma_info->remote_iov,
+        .rma_iov_count = rma_info->remote_iovcnt,
+        .context = context,
+        .data = rma_info->remote_cq_data};
+    ssize_t rc;
+
+    NA_LOG_SUBSYS_DEBUG(rma,
+        "Posting RMA op (%s, context=%p), iov_count=%zu, desc[0]=%p, "
+        "msg_iov[0].iov_base=%p, msg_iov[0].iov_len=%zu, addr=%" PRIu64
+        ", rma_iov_count=%zu, rma_iov[0].addr=%" PRIu64
+        ", rma_iov[0].len=%zu, rma_iov[0].key=%" PRIu64 ", data=%" PRIu64,
+        rma_info->fi_rma_op_string, context, fi_msg_rma.iov_count,
+        fi_msg_rma.desc[0], fi_msg_rma.msg_iov[0].iov_base,
+        fi_msg_rma.msg_iov[0].iov_len, fi_msg_rma.addr,
+        fi_msg_rma.rma_iov_count, fi_msg_rma.rma_iov[0].addr,
+        fi_msg_rma.rma_iov[0].len, fi_msg_rma.rma_iov[0].key, fi_msg_rma.data);
+
+    /* Post the OFI RMA operation */
+    rc = rma_info->fi_rma_op(ep, &fi_msg_rma, rma_info->fi_rma_flags);
+    if (rc == 0)
+        return NA_SUCCESS;
+    else if (rc == -FI_EAGAIN)
+        return NA_AGAIN;
+    else {
+        NA_LOG_SUBSYS_ERROR(rma,
+            "%s() failed, rc: %zd (%s), iov_count=%zu, desc[0]=%p, "
+            "msg_iov[0].iov_base=%p, msg_iov[0].iov_len=%zu, addr=%" PRIu64
+            ", rma_iov_count=%zu, rma_iov[0].addr=%" PRIu64
+            ", rma_iov[0].len=%zu, rma_iov[0].key=%" PRIu64
+            ", context=%p, data=%" PRIu64,
+            rma_info->fi_rma_op_string, rc, fi_strerror((int) -rc),
+            fi_msg_rma.iov_count, fi_msg_rma.desc[0],
+            fi_msg_rma.msg_iov[0].iov_base, fi_msg_rma.msg_iov[0].iov_len,
+            fi_msg_rma.addr, fi_msg_rma.rma_iov_count,
+            fi_msg_rma.rma_iov[0].addr, fi_msg_rma.rma_iov[0].len,
+            fi_msg_rma.rma_iov[0].key, fi_msg_rma.context, fi_msg_rma.data);
+        return na_ofi_errno_to_na((int) -rc);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rma_deferred_init(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context, struct na_ofi_op_id *na_ofi_op_id)
+{
+    struct na_ofi_rma_info *rma_info = &na_ofi_op_id->info.rma;
+    struct na_ofi_rma_deferred *deferred = na_ofi_op_id->rma_deferred;
+    int64_t window = (int64_t) na_ofi_class->deferred_rma_max, posted;
+    na_return_t ret;
+
+    /* Kept with the OP ID once allocated */
+    if (deferred == NULL) {
+        deferred = (struct na_ofi_rma_deferred *) malloc(sizeof(*deferred));
+        NA_CHECK_SUBSYS_ERROR(rma, deferred == NULL, error, ret, NA_NOMEM,
+            "Could not allocate deferred RMA op");
+        na_ofi_op_id->rma_deferred = deferred;
+    }
+
+    /* Op N + window is triggered once N ops have completed */
+    posted = hg_atomic_incr64(&na_ofi_context->rma_posted);
+
+    deferred->op = (struct fi_op_rma){.ep = na_ofi_context->fi_tx,
+        .msg = {.msg_iov = rma_info->local_iov,
+            .desc = rma_info->local_desc,
+            .iov_count = rma_info->local_iovcnt,
+            .addr = rma_info->fi_addr,
+            .rma_iov = rma_info->remote_iov,
+            .rma_iov_count = rma_info->remote_iovcnt,
+            .context = &na_ofi_op_id->fi_ctx,
+            .data = 0},
+        .flags = rma_info->fi_rma_flags};
+    deferred->work = (struct fi_deferred_work){
+        .threshold = (uint64_t) ((posted > window) ? posted - window : 0),
+        .triggering_cntr = na_ofi_context->rma_cntr,
+        .completion_cntr = na_ofi_context->rma_cntr,
+        .op_type = (rma_info->fi_rma_op == fi_readmsg) ? FI_OP_READ
+                                                       : FI_OP_WRITE,
+        .op.rma = &deferred->op};
+    deferred->fi_domain = na_ofi_class->domain->fi_domain;
+    rma_info->deferred = deferred;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rma_post_deferred(struct fid_ep NA_UNUSED *ep,
+    const struct na_ofi_rma_info *rma_info, void NA_UNUSED *context)
+{
+    struct na_ofi_rma_deferred *deferred = rma_info->deferred;
+    int rc;
+
+    NA_LOG_SUBSYS_DEBUG(rma,
+        "Queuing deferred RMA op (%s, context=%p), threshold=%" PRIu64
+        ", iov_count=%zu, rma_iov_count=%zu",
+        rma_info->fi_rma_op_string, deferred->op.msg.context,
+        deferred->work.threshold, deferred->op.msg.iov_count,
+        deferred->op.msg.rma_iov_count);
+
+    /* Queue work, it is triggered when the counter reaches the threshold */
+    rc = fi_control(&deferred->fi_domain->fid, FI_QUEUE_WORK, &deferred->work);
+    if (rc == 0)
+        return NA_SUCCESS;
+    else if (rc == -FI_EAGAIN)
+        return NA_AGAIN;
+    else {
+        NA_LOG_SUBSYS_ERROR(rma,
+            "fi_control(FI_QUEUE_WORK) failed for %s, rc: %d (%s)",
+            rma_info->fi_rma_op_string, rc, fi_strerror(-rc));
+        return na_ofi_errno_to_na(-rc);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ofi_rma_release(struct na_ofi_rma_info *rma_info)
+{
+    /* Can free extra IOVs here */
+    if (rma_info->local_iovcnt > NA_OFI_IOV_STATIC_MAX) {
+        free(rma_info->local_iov_storage.d);
+        rma_info->local_iov_storage.d = NULL;
+        free(rma_info->local_desc_storage.d);
+        rma_info->local_desc_storage.d = NULL;
+    }
+    if (rma_info->remote_iovcnt > NA_OFI_IOV_STATIC_MAX) {
+        free(rma_info->remote_iov_storage.d);
+        rma_info->remote_iov_storage.d = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_atomic_post(struct fid_ep *ep,
+    const struct na_ofi_atomic_info *atomic_info, void *context)
+{
+    /* Result is only written by the provider */
+    void *result = (void *) &atomic_info->result;
+    ssize_t rc;
+
+    NA_LOG_SUBSYS_DEBUG(rma,
+        "Posting atomic op (%s, context=%p), addr=%" PRIu64
+        ", remote_addr=%" PRIu64 ", key=%" PRIu64,
+        (atomic_info->fi_atomic_op == FI_CSWAP) ? "fi_compare_atomic"
+                                                : "fi_fetch_atomic",
+        context, atomic_info->fi_addr, atomic_info->remote_addr,
+        atomic_info->remote_key);
+
+    if (atomic_info->fi_atomic_op == FI_CSWAP)
+        rc = fi_compare_atomic(ep, &atomic_info->operand, 1, NULL,
+            &atomic_info->compare, NULL, result, NULL, atomic_info->fi_addr,
+            atomic_info->remote_addr, atomic_info->remote_key, FI_UINT64,
+            FI_CSWAP, context);
+    else
+        rc = fi_fetch_atomic(ep, &atomic_info->operand, 1, NULL, result, NULL,
+            atomic_info->fi_addr, atomic_info->remote_addr,
+            atomic_info->remote_key, FI_UINT64, FI_SUM, context);
+    if (rc == 0)
+        return NA_SUCCESS;
+    else if (rc == -FI_EAGAIN)
+        return NA_AGAIN;
+    else {
+        NA_LOG_SUBSYS_ERROR(rma,
+            "Atomic op failed, rc: %zd (%s), addr=%" PRIu64
+            ", remote_addr=%" PRIu64 ", key=%" PRIu64,
+            rc, fi_strerror((int) -rc), atomic_info->fi_addr,
+            atomic_info->remote_addr, atomic_info->remote_key);
+        return na_ofi_errno_to_na(-rc);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rdv_rts_init(na_class_t *na_class, struct na_ofi_context *na_ofi_context,
+    struct na_ofi_op_id *na_ofi_op_id, const void *buf, size_t buf_size,
+    size_t header_size, fi_addr_t fi_addr, uint64_t tag)
+{
+    struct na_ofi_class *na_ofi_class = NA_OFI_CLASS(na_class);
+    struct na_ofi_rdv_info *rdv = &na_ofi_op_id->rdv;
+    struct na_ofi_mem_handle *mem_handle = &rdv->mem_handle;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg,
+        header_size > buf_size ||
+            header_size + sizeof(rdv->hdr) > sizeof(rdv->rts),
+        error, ret, NA_OVERFLOW, "Invalid msg header size (%zu)", header_size);
+
+    /* Expose payload so that the receiver can read it */
+    mem_handle->desc.iov.s[0] =
+        (struct iovec){.iov_base = (void *) buf, .iov_len = buf_size};
+    mem_handle->desc.info.iovcnt = 1;
+    mem_handle->desc.info.flags = NA_MEM_READ_ONLY;
+    mem_handle->desc.info.len = buf_size;
+    mem_handle->fi_mr = NULL;
+    mem_handle->mr_cache_entry = NULL;
+
+    ret = na_ofi_mem_register(
+        na_class, (na_mem_handle_t *) mem_handle, NA_MEM_TYPE_HOST, 0);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        msg, error, ret, "Could not register rendezvous payload");
+
+    rdv->hdr = (struct na_ofi_rdv_hdr){
+        .addr = (na_ofi_class->fi_info->domain_attr->mr_mode & FI_MR_VIRT_ADDR)
+                    ? (uint64_t) buf
+                    : 0,
+        .key = mem_handle->desc.info.fi_mr_key,
+        .len = buf_size,
+        .fin_id = (uint32_t) hg_atomic_incr32(&na_ofi_class->rdv_fin_id),
+        .context_id = na_ofi_context->idx};
+
+    /* Unexpected msg header (source address) must remain first */
+    memcpy(rdv->rts, buf, header_size);
+    memcpy(rdv->rts + header_size, &rdv->hdr, sizeof(rdv->hdr));
+    rdv->state = NA_OFI_RDV_RTS;
+
+    na_ofi_op_id->info.msg = (struct na_ofi_msg_info){.buf.const_ptr = rdv->rts,
+        .buf_size = header_size + sizeof(rdv->hdr),
+        .fi_addr = fi_addr,
+        .desc = NULL,
+        .tag = tag | NA_OFI_RDV_TAG};
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Sending RTS for %zu bytes (op id=%p, fin_id=%" PRIu32 ")", buf_size,
+        (void *) na_ofi_op_id, rdv->hdr.fin_id);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rdv_process(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id,
+    const struct fi_cq_tagged_entry *cq_event, struct na_ofi_addr *na_ofi_addr,
+    bool *complete_p)
+{
+    struct na_ofi_context *na_ofi_context =
+        NA_OFI_CONTEXT(na_ofi_op_id->context);
+    struct na_ofi_rdv_info *rdv = &na_ofi_op_id->rdv;
+    fi_addr_t fi_addr;
+    na_return_t ret;
+
+    *complete_p = false;
+
+    switch (rdv->state) {
+        case NA_OFI_RDV_NONE:
+            ret = na_ofi_rdv_read(
+                na_ofi_class, na_ofi_op_id, cq_event, na_ofi_addr);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                msg, error, ret, "Could not read rendezvous payload");
+            break;
+        case NA_OFI_RDV_RTS:
+            /* Payload must remain exposed until the receiver is done */
+            rdv->state = NA_OFI_RDV_WAIT_FIN;
+            na_ofi_op_id->fi_op_flags = FI_RECV;
+            na_ofi_op_id->info.msg = (struct na_ofi_msg_info){.buf.ptr = NULL,
+                .buf_size = 0,
+                .fi_addr = FI_ADDR_UNSPEC,
+                .desc = NULL,
+                .tag = NA_OFI_RDV_FIN_TAG | rdv->hdr.fin_id,
+                .tag_mask = 0};
+
+            ret = na_ofi_rdv_post(na_ofi_class, na_ofi_op_id,
+                na_ofi_context->fi_rx, na_ofi_tag_recv);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                msg, error, ret, "Could not post FIN recv");
+            break;
+        case NA_OFI_RDV_READ:
+            /* Let the sender release its payload */
+            fi_addr = na_ofi_op_id->info.rma.fi_addr;
+            rdv->state = NA_OFI_RDV_FIN;
+            na_ofi_op_id->fi_op_flags = FI_SEND;
+            na_ofi_op_id->info.msg =
+                (struct na_ofi_msg_info){.buf.const_ptr = NULL,
+                    .buf_size = 0,
+                    .fi_addr = fi_addr,
+                    .desc = NULL,
+                    .tag = NA_OFI_RDV_FIN_TAG | rdv->hdr.fin_id};
+
+            ret = na_ofi_rdv_post(na_ofi_class, na_ofi_op_id,
+                na_ofi_context->fi_tx, na_ofi_tag_send);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                msg, error, ret, "Could not post FIN send");
+            break;
+        case NA_OFI_RDV_WAIT_FIN:
+        case NA_OFI_RDV_FIN:
+            /* Receiver is done reading the payload (no-op on receiver) */
+            na_ofi_rdv_release(na_ofi_op_id);
+            NA_LOG_SUBSYS_DEBUG(msg, "Rendezvous completed (op id=%p)",
+                (void *) na_ofi_op_id);
+            *complete_p = true;
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(msg, error, ret, NA_FAULT,
+                "Invalid rendezvous state (%d)", (int) rdv->state);
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rdv_read(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id,
+    const struct fi_cq_tagged_entry *cq_event, struct na_ofi_addr *na_ofi_addr)
+{
+    struct na_ofi_context *na_ofi_context =
+        NA_OFI_CONTEXT(na_ofi_op_id->context);
+    struct na_ofi_rdv_info *rdv = &na_ofi_op_id->rdv;
+    struct na_ofi_rma_info *rma_info = &na_ofi_op_id->info.rma;
+    struct na_cb_info *callback_info =
+        &na_ofi_op_id->completion_data->callback_info;
+    bool unexpected = (na_ofi_op_id->type == NA_CB_RECV_UNEXPECTED);
+    /* Save msg info, op info is reused for the RMA read */
+    void *buf = na_ofi_op_id->info.msg.buf.ptr;
+    void *desc = na_ofi_op_id->info.msg.desc;
+    size_t buf_size = na_ofi_op_id->info.msg.buf_size, header_size = 0;
+    uint64_t tag = cq_event->tag & ~NA_OFI_RDV_TAG;
+    fi_addr_t fi_addr;
+    na_return_t ret;
+
+    if (unexpected &&
+        !(na_ofi_prov_extra_caps[na_ofi_class->fabric->prov_type] &
+            FI_SOURCE_ERR))
+        header_size = na_ofi_raw_addr_serialize_size(
+            (int) na_ofi_class->fi_info->addr_format);
+
+    NA_CHECK_SUBSYS_ERROR(msg, cq_event->len != header_size + sizeof(rdv->hdr),
+        error, ret, NA_PROTOCOL_ERROR, "Invalid RTS size (%zu)",
+        cq_event->len);
+    memcpy(&rdv->hdr, (const char *) buf + header_size, sizeof(rdv->hdr));
+
+    /* Report payload size as if message had been received eagerly */
+    if (unexpected)
+        ret = na_ofi_cq_process_recv_unexpected(na_ofi_class,
+            &na_ofi_op_id->info.msg, &callback_info->info.recv_unexpected, buf,
+            (size_t) rdv->hdr.len, na_ofi_addr, tag);
+    else
+        ret = na_ofi_cq_process_recv_expected(&na_ofi_op_id->info.msg,
+            &callback_info->info.recv_expected, buf, (size_t) rdv->hdr.len,
+            tag);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, error, ret, "Could not process RTS");
+    NA_CHECK_SUBSYS_ERROR(msg, rdv->hdr.len > buf_size, error, ret, NA_MSGSIZE,
+        "Rendezvous payload too large for buffer (expected %zu, got %" PRIu64
+        ")",
+        buf_size, rdv->hdr.len);
+
+    /* Payload is read from the sender context */
+    ret = na_ofi_addr_route((unexpected) ? na_ofi_addr : na_ofi_op_id->addr,
+        (uint8_t) rdv->hdr.context_id, &fi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        msg, error, ret, "Could not resolve remote context address");
+
+    *rma_info = (struct na_ofi_rma_info){.fi_rma_op = fi_readmsg,
+        .fi_rma_op_string = "fi_readmsg",
+        .fi_rma_flags = FI_COMPLETION,
+        .local_iovcnt = 1,
+        .fi_addr = fi_addr,
+        .remote_iovcnt = 1};
+    rma_info->local_iov_storage.s[0] =
+        (struct iovec){.iov_base = buf, .iov_len = (size_t) rdv->hdr.len};
+    rma_info->local_iov = rma_info->local_iov_storage.s;
+    rma_info->local_desc_storage.s[0] = desc;
+    rma_info->local_desc = rma_info->local_desc_storage.s;
+    rma_info->remote_iov_storage.s[0] =
+        (struct fi_rma_iov){.addr = rdv->hdr.addr,
+            .len = (size_t) rdv->hdr.len,
+            .key = rdv->hdr.key};
+    rma_info->remote_iov = rma_info->remote_iov_storage.s;
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Received RTS for %" PRIu64 " bytes (op id=%p, fin_id=%" PRIu32 ")",
+        rdv->hdr.len, (void *) na_ofi_op_id, rdv->hdr.fin_id);
+
+    rdv->state = NA_OFI_RDV_READ;
+    na_ofi_op_id->fi_op_flags = FI_RMA;
+
+    ret =
+        na_ofi_rma_post(na_ofi_context->fi_tx, rma_info, &na_ofi_op_id->fi_ctx);
+    if (ret == NA_AGAIN) {
+        na_ofi_op_id->retry_op.rma = na_ofi_rma_post;
+        na_ofi_op_retry(
+            na_ofi_context, na_ofi_class->op_retry_timeout, na_ofi_op_id);
+    } else
+        NA_CHECK_SUBSYS_NA_ERROR(msg, error, ret, "Could not post RMA read");
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rdv_post(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id, struct fid_ep *ep,
+    na_return_t (*msg_op)(
+        struct fid_ep *, const struct na_ofi_msg_info *, void *))
+{
+    na_return_t ret;
+
+    ret = msg_op(ep, &na_ofi_op_id->info.msg, &na_ofi_op_id->fi_ctx);
+    if (ret == NA_AGAIN) {
+        na_ofi_op_id->retry_op.msg = msg_op;
+        na_ofi_op_retry(NA_OFI_CONTEXT(na_ofi_op_id->context),
+            na_ofi_class->op_retry_timeout, na_ofi_op_id);
+        ret = NA_SUCCESS;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_rdv_release(struct na_ofi_op_id *na_ofi_op_id)
+{
+    struct na_ofi_mem_handle *mem_handle = &na_ofi_op_id->rdv.mem_handle;
+    struct na_ofi_domain *domain;
+    struct fid_mr *fi_mr = mem_handle->fi_mr;
+
+    if (fi_mr == NULL)
+        return;
+
+    domain = na_ofi_op_id->na_ofi_class->domain;
+    if (mem_handle->mr_cache_entry != NULL) {
+        fi_mr = na_ofi_mr_cache_release(
+            domain->mr_cache, mem_handle->mr_cache_entry);
+        mem_handle->mr_cache_entry = NULL;
+    }
+    mem_handle->fi_mr = NULL;
+
+    if (fi_mr != NULL) {
+        int rc = fi_close(&fi_mr->fid);
+
+        NA_CHECK_SUBSYS_WARNING(mem, rc != 0,
+            "fi_close() mr_hdl failed, rc: %d (%s)", rc, fi_strerror(-rc));
+        hg_atomic_decr32(domain->mr_reg_count);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_ofi_ring_op *
+na_ofi_ring_op_create(struct na_ofi_class *na_ofi_class,
+    enum na_ofi_ring_op_type type, struct na_ofi_ring_tx *tx)
+{
+    struct na_ofi_ring_op *ring_op;
+
+    ring_op = (struct na_ofi_ring_op *) calloc(1, sizeof(*ring_op));
+    NA_CHECK_SUBSYS_ERROR_NORET(op, ring_op == NULL, error,
+        "Could not allocate ring operation");
+    ring_op->op_id.na_ofi_class = na_ofi_class;
+    ring_op->op_id.complete = na_ofi_ring_op_complete;
+    ring_op->op_id.completion_data =
+        &ring_op->op_id.completion_data_storage.single;
+    ring_op->op_id.ring_op = true;
+    hg_atomic_init32(&ring_op->op_id.status, NA_OFI_OP_COMPLETED);
+    ring_op->type = type;
+    ring_op->tx = tx;
+
+    return ring_op;
+
+error:
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_op_free(struct na_ofi_ring_op *ring_op)
+{
+    if (ring_op->op_id.addr != NULL)
+        na_ofi_addr_ref_decr(ring_op->op_id.addr);
+    free(ring_op->buf);
+    free(ring_op);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_op_complete(struct na_ofi_op_id *na_ofi_op_id,
+    bool NA_UNUSED complete, na_return_t cb_ret)
+{
+    struct na_ofi_ring_op *ring_op =
+        container_of(na_ofi_op_id, struct na_ofi_ring_op, op_id);
+    struct na_ofi_class *na_ofi_class = na_ofi_op_id->na_ofi_class;
+
+    NA_CHECK_SUBSYS_WARNING(msg, cb_ret != NA_CANCELED,
+        "Ring operation %d failed (%s)", (int) ring_op->type,
+        NA_Error_to_string(cb_ret));
+
+    hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_COMPLETED);
+
+    switch (ring_op->type) {
+        case NA_OFI_RING_OP_BOUNCE:
+            /* Not reposted, freed with the context */
+            ring_op->posted = false;
+            break;
+        case NA_OFI_RING_OP_CREDIT:
+            hg_thread_spin_lock(&na_ofi_class->ring_lock);
+            ring_op->tx->reading = false;
+            hg_thread_spin_unlock(&na_ofi_class->ring_lock);
+            na_ofi_ring_op_free(ring_op);
+            break;
+        case NA_OFI_RING_OP_GRANT:
+        case NA_OFI_RING_OP_REQ:
+        case NA_OFI_RING_OP_WAIT:
+        default:
+            /* Ring stays requested, sender keeps using regular sends */
+            na_ofi_ring_op_free(ring_op);
+            break;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_post(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_op *ring_op, struct fid_ep *ep,
+    na_return_t (*msg_op)(
+        struct fid_ep *, const struct na_ofi_msg_info *, void *))
+{
+    struct na_ofi_op_id *na_ofi_op_id = &ring_op->op_id;
+    na_return_t ret;
+
+    ret = msg_op(ep, &na_ofi_op_id->info.msg, &na_ofi_op_id->fi_ctx);
+    if (ret == NA_AGAIN) {
+        na_ofi_op_id->retry_op.msg = msg_op;
+        na_ofi_op_retry(NA_OFI_CONTEXT(na_ofi_op_id->context),
+            na_ofi_class->op_retry_timeout, na_ofi_op_id);
+        ret = NA_SUCCESS;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_process(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_op *ring_op, const struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_addr *na_ofi_addr)
+{
+    struct na_ofi_ring_ctl grant;
+    na_return_t ret;
+
+    switch (ring_op->type) {
+        case NA_OFI_RING_OP_BOUNCE:
+            ring_op->posted = false;
+
+            if (cq_event->tag & NA_OFI_RING_TAG) {
+                na_ofi_ring_grant(na_ofi_class, ring_op, cq_event, na_ofi_addr);
+                na_ofi_addr_ref_decr(na_ofi_addr);
+                na_ofi_ring_bounce_post(na_ofi_class, ring_op);
+                break;
+            }
+
+            /* Bounce recv is held until msg is received */
+            ring_op->msg = (struct na_ofi_ring_msg){.ring = NULL,
+                .bounce = ring_op,
+                .addr = na_ofi_addr,
+                .buf = ring_op->buf,
+                .len = cq_event->len,
+                .tag = cq_event->tag,
+                .slot = 0};
+            na_ofi_ring_msg_push(na_ofi_class,
+                NA_OFI_CONTEXT(ring_op->op_id.context)->ring_rx,
+                &ring_op->msg);
+            break;
+        case NA_OFI_RING_OP_WAIT:
+            if (cq_event->len == sizeof(grant))
+                memcpy(&grant, ring_op->ctl, sizeof(grant));
+            else {
+                NA_LOG_SUBSYS_ERROR(
+                    msg, "Invalid ring GRANT size (%zu)", cq_event->len);
+                grant = (struct na_ofi_ring_ctl){.slot_num = 0};
+            }
+
+            hg_thread_spin_lock(&na_ofi_class->ring_lock);
+            if (grant.slot_num > 0) {
+                ring_op->tx->addr = grant.addr;
+                ring_op->tx->key = grant.key;
+                ring_op->tx->slot_size = grant.slot_size;
+                ring_op->tx->ring_id = grant.ring_id;
+                ring_op->tx->slot_num = grant.slot_num;
+                ring_op->tx->state = NA_OFI_RING_GRANTED;
+            } else
+                ring_op->tx->state = NA_OFI_RING_DENIED;
+            hg_thread_spin_unlock(&na_ofi_class->ring_lock);
+
+            NA_LOG_SUBSYS_DEBUG(msg,
+                "Ring %" PRIu16 " granted with %" PRIu16 " slots of %" PRIu32
+                " bytes",
+                grant.ring_id, grant.slot_num, grant.slot_size);
+            na_ofi_ring_op_free(ring_op);
+            break;
+        case NA_OFI_RING_OP_CREDIT:
+            hg_thread_spin_lock(&na_ofi_class->ring_lock);
+            if (ring_op->consumed > ring_op->tx->consumed)
+                ring_op->tx->consumed = ring_op->consumed;
+            ring_op->tx->reading = false;
+            hg_thread_spin_unlock(&na_ofi_class->ring_lock);
+            na_ofi_ring_op_free(ring_op);
+            break;
+        case NA_OFI_RING_OP_GRANT:
+        case NA_OFI_RING_OP_REQ:
+            na_ofi_ring_op_free(ring_op);
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(msg, error, ret, NA_FAULT,
+                "Invalid ring operation type (%d)", (int) ring_op->type);
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_ofi_ring_tx *
+na_ofi_ring_tx_get(struct na_ofi_addr *na_ofi_addr, uint8_t id)
+{
+    if (na_ofi_addr->ring_tx == NULL) {
+        na_ofi_addr->ring_tx = (struct na_ofi_ring_tx **) calloc(
+            NA_OFI_RING_TX_MAX, sizeof(*na_ofi_addr->ring_tx));
+        if (na_ofi_addr->ring_tx == NULL)
+            return NULL;
+    }
+    if (na_ofi_addr->ring_tx[id] == NULL)
+        na_ofi_addr->ring_tx[id] =
+            (struct na_ofi_ring_tx *) calloc(1, sizeof(struct na_ofi_ring_tx));
+
+    return na_ofi_addr->ring_tx[id];
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_send(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id, const void *buf, size_t buf_size,
+    uint8_t dest_id, fi_addr_t fi_addr, na_tag_t tag, bool *written_p)
+{
+    struct na_ofi_context *na_ofi_context =
+        NA_OFI_CONTEXT(na_ofi_op_id->context);
+    struct na_ofi_addr *na_ofi_addr = na_ofi_op_id->addr;
+    struct na_ofi_rma_info *rma_info = &na_ofi_op_id->info.rma;
+    struct na_ofi_ring_tx *tx, ring = {.state = NA_OFI_RING_NONE};
+    uint64_t seq = 0;
+    bool write = false, credit_read = false;
+    uint16_t slot;
+    na_return_t ret;
+
+    *written_p = false;
+
+    hg_thread_spin_lock(&na_ofi_class->ring_lock);
+    tx = na_ofi_ring_tx_get(na_ofi_addr, dest_id);
+    if (tx != NULL) {
+        ring = *tx;
+        if (tx->state == NA_OFI_RING_NONE)
+            tx->state = NA_OFI_RING_REQUESTED;
+        else if (tx->state == NA_OFI_RING_GRANTED &&
+                 buf_size + sizeof(struct na_ofi_ring_slot_hdr) <=
+                     tx->slot_size) {
+            /* Slots are given back once the target consumed them */
+            if (tx->head - tx->consumed < tx->slot_num) {
+                seq = tx->head++;
+                write = true;
+            } else if (!tx->reading) {
+                tx->reading = true;
+                credit_read = true;
+            }
+        }
+    }
+    hg_thread_spin_unlock(&na_ofi_class->ring_lock);
+    NA_CHECK_SUBSYS_ERROR(msg, tx == NULL, error, ret, NA_NOMEM,
+        "Could not allocate ring state");
+
+    /* Regular sends are used until the ring is granted and when it is full */
+    if (ring.state == NA_OFI_RING_NONE) {
+        ret = na_ofi_ring_request(
+            na_ofi_class, na_ofi_op_id->context, na_ofi_addr, tx, fi_addr);
+        NA_CHECK_SUBSYS_WARNING(
+            msg, ret != NA_SUCCESS, "Could not request ring, using sends");
+        return NA_SUCCESS;
+    }
+    if (credit_read) {
+        ret = na_ofi_ring_credit_read(
+            na_ofi_class, na_ofi_op_id->context, na_ofi_addr, tx, fi_addr);
+        if (ret != NA_SUCCESS) {
+            hg_thread_spin_lock(&na_ofi_class->ring_lock);
+            tx->reading = false;
+            hg_thread_spin_unlock(&na_ofi_class->ring_lock);
+        }
+        return NA_SUCCESS;
+    }
+    if (!write)
+        return NA_SUCCESS;
+
+    slot = (uint16_t) (seq % ring.slot_num);
+    na_ofi_op_id->ring_hdr = (struct na_ofi_ring_slot_hdr){
+        .len = (uint32_t) buf_size, .tag = (uint32_t) tag};
+
+    /* Header and payload land in the slot, target is notified through the
+     * remote CQ data */
+    *rma_info = (struct na_ofi_rma_info){.fi_rma_op = fi_writemsg,
+        .fi_rma_op_string = "fi_writemsg",
+        .fi_rma_flags = FI_COMPLETION | FI_REMOTE_CQ_DATA,
+        .local_iovcnt = 2,
+        .fi_addr = fi_addr,
+        .remote_iovcnt = 1,
+        .remote_cq_data = NA_OFI_RING_DATA(ring.ring_id, slot)};
+    rma_info->local_iov_storage.s[0] =
+        (struct iovec){.iov_base = &na_ofi_op_id->ring_hdr,
+            .iov_len = sizeof(na_ofi_op_id->ring_hdr)};
+    rma_info->local_iov_storage.s[1] = (struct iovec){
+        .iov_base = (void *) (uintptr_t) buf, .iov_len = buf_size};
+    rma_info->local_iov = rma_info->local_iov_storage.s;
+    rma_info->local_desc_storage.s[0] = NULL;
+    rma_info->local_desc_storage.s[1] = NULL;
+    rma_info->local_desc = rma_info->local_desc_storage.s;
+    rma_info->remote_iov_storage.s[0] = (struct fi_rma_iov){
+        .addr = ring.addr + NA_OFI_RING_HDR_SIZE + slot * ring.slot_size,
+        .len = sizeof(na_ofi_op_id->ring_hdr) + buf_size,
+        .key = ring.key};
+    rma_info->remote_iov = rma_info->remote_iov_storage.s;
+    na_ofi_op_id->fi_op_flags = FI_RMA;
+
+    ret =
+        na_ofi_rma_post(na_ofi_context->fi_tx, rma_info, &na_ofi_op_id->fi_ctx);
+    if (ret == NA_AGAIN) {
+        na_ofi_op_id->retry_op.rma = na_ofi_rma_post;
+        na_ofi_op_retry(
+            na_ofi_context, na_ofi_class->op_retry_timeout, na_ofi_op_id);
+    } else
+        NA_CHECK_SUBSYS_NA_ERROR(msg, error, ret, "Could not post ring write");
+
+    *written_p = true;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_request(struct na_ofi_class *na_ofi_class, na_context_t *context,
+    struct na_ofi_addr *na_ofi_addr, struct na_ofi_ring_tx *tx,
+    fi_addr_t fi_addr)
+{
+    struct na_ofi_context *na_ofi_context = NA_OFI_CONTEXT(context);
+    size_t header_size =
+        na_ofi_msg_get_unexpected_header_size(na_ofi_class->na_class);
+    struct na_ofi_ring_ctl req = {
+        .req_id = (uint32_t) hg_atomic_incr32(&na_ofi_class->ring_req_id),
+        .context_id = na_ofi_context->idx};
+    struct na_ofi_ring_op *wait = NULL, *req_op = NULL;
+    na_return_t ret;
+
+    /* Post GRANT recv first so that the GRANT can never be unexpected */
+    wait = na_ofi_ring_op_create(na_ofi_class, NA_OFI_RING_OP_WAIT, tx);
+    NA_CHECK_SUBSYS_ERROR(msg, wait == NULL, error, ret, NA_NOMEM,
+        "Could not allocate ring operation");
+    NA_OFI_OP_RESET((&wait->op_id), context, FI_RECV, NA_CB_RECV_EXPECTED,
+        NULL, NULL, na_ofi_addr);
+    wait->op_id.info.msg = (struct na_ofi_msg_info){.buf.ptr = wait->ctl,
+        .buf_size = sizeof(req),
+        .fi_addr = FI_ADDR_UNSPEC,
+        .desc = NULL,
+        .tag = NA_OFI_RING_TAG | req.req_id,
+        .tag_mask = 0};
+
+    ret = na_ofi_ring_post(
+        na_ofi_class, wait, na_ofi_context->fi_rx, na_ofi_tag_recv);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, error, ret, "Could not post GRANT recv");
+
+    /* Unexpected msg header (source address) must remain first */
+    req_op = na_ofi_ring_op_create(na_ofi_class, NA_OFI_RING_OP_REQ, tx);
+    NA_CHECK_SUBSYS_ERROR(msg, req_op == NULL, cancel, ret, NA_NOMEM,
+        "Could not allocate ring operation");
+    ret = na_ofi_msg_init_unexpected(
+        na_ofi_class->na_class, req_op->ctl, sizeof(req_op->ctl));
+    NA_CHECK_SUBSYS_NA_ERROR(msg, cancel, ret, "Could not init REQ header");
+    memcpy(req_op->ctl + header_size, &req, sizeof(req));
+
+    NA_OFI_OP_RESET((&req_op->op_id), context, FI_SEND, NA_CB_SEND_UNEXPECTED,
+        NULL, NULL, na_ofi_addr);
+    req_op->op_id.info.msg =
+        (struct na_ofi_msg_info){.buf.const_ptr = req_op->ctl,
+            .buf_size = header_size + sizeof(req),
+            .fi_addr = fi_addr,
+            .desc = NULL,
+            .tag = NA_OFI_UNEXPECTED_TAG | NA_OFI_RING_TAG};
+
+    ret = na_ofi_ring_post(
+        na_ofi_class, req_op, na_ofi_context->fi_tx, na_ofi_tag_send);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, cancel, ret, "Could not post REQ send");
+
+    NA_LOG_SUBSYS_DEBUG(
+        msg, "Requesting ring (req_id=%" PRIu32 ")", req.req_id);
+
+    return NA_SUCCESS;
+
+cancel:
+    if (req_op != NULL)
+        na_ofi_ring_op_free(req_op);
+    /* GRANT recv is freed once canceled */
+    (void) na_ofi_cancel(
+        na_ofi_class->na_class, context, (na_op_id_t *) &wait->op_id);
+    return ret;
+
+error:
+    if (wait != NULL)
+        na_ofi_ring_op_free(wait);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_credit_read(struct na_ofi_class *na_ofi_class,
+    na_context_t *context, struct na_ofi_addr *na_ofi_addr,
+    struct na_ofi_ring_tx *tx, fi_addr_t fi_addr)
+{
+    struct na_ofi_context *na_ofi_context = NA_OFI_CONTEXT(context);
+    struct na_ofi_ring_op *ring_op;
+    struct na_ofi_rma_info *rma_info;
+    na_return_t ret;
+
+    ring_op = na_ofi_ring_op_create(na_ofi_class, NA_OFI_RING_OP_CREDIT, tx);
+    NA_CHECK_SUBSYS_ERROR(msg, ring_op == NULL, error, ret, NA_NOMEM,
+        "Could not allocate ring operation");
+    NA_OFI_OP_RESET((&ring_op->op_id), context, FI_RMA, NA_CB_GET, NULL, NULL,
+        na_ofi_addr);
+
+    rma_info = &ring_op->op_id.info.rma;
+    *rma_info = (struct na_ofi_rma_info){.fi_rma_op = fi_readmsg,
+        .fi_rma_op_string = "fi_readmsg",
+        .fi_rma_flags = FI_COMPLETION,
+        .local_iovcnt = 1,
+        .fi_addr = fi_addr,
+        .remote_iovcnt = 1};
+    rma_info->local_iov_storage.s[0] = (struct iovec){
+        .iov_base = &ring_op->consumed, .iov_len = sizeof(ring_op->consumed)};
+    rma_info->local_iov = rma_info->local_iov_storage.s;
+    rma_info->local_desc_storage.s[0] = NULL;
+    rma_info->local_desc = rma_info->local_desc_storage.s;
+    rma_info->remote_iov_storage.s[0] = (struct fi_rma_iov){
+        .addr = tx->addr, .len = sizeof(ring_op->consumed), .key = tx->key};
+    rma_info->remote_iov = rma_info->remote_iov_storage.s;
+
+    ret = na_ofi_rma_post(
+        na_ofi_context->fi_tx, rma_info, &ring_op->op_id.fi_ctx);
+    if (ret == NA_AGAIN) {
+        ring_op->op_id.retry_op.rma = na_ofi_rma_post;
+        na_ofi_op_retry(
+            na_ofi_context, na_ofi_class->op_retry_timeout, &ring_op->op_id);
+    } else
+        NA_CHECK_SUBSYS_NA_ERROR(msg, error, ret, "Could not post ring read");
+
+    return NA_SUCCESS;
+
+error:
+    if (ring_op != NULL)
+        na_ofi_ring_op_free(ring_op);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_rx_open(struct na_ofi_ring_rx **ring_rx_p)
+{
+    struct na_ofi_ring_rx *ring_rx;
+    na_return_t ret;
+    int rc;
+
+    ring_rx = (struct na_ofi_ring_rx *) calloc(1, sizeof(*ring_rx));
+    NA_CHECK_SUBSYS_ERROR(ctx, ring_rx == NULL, error, ret, NA_NOMEM,
+        "Could not allocate ring table");
+    HG_QUEUE_INIT(&ring_rx->recv_queue);
+    HG_QUEUE_INIT(&ring_rx->msg_queue);
+
+    rc = hg_thread_spin_init(&ring_rx->lock);
+    NA_CHECK_SUBSYS_ERROR(ctx, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+        "hg_thread_spin_init() failed");
+
+    *ring_rx_p = ring_rx;
+
+    return NA_SUCCESS;
+
+error:
+    free(ring_rx);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_rx_start(struct na_ofi_class *na_ofi_class, na_context_t *context)
+{
+    struct na_ofi_ring_rx *ring_rx = NA_OFI_CONTEXT(context)->ring_rx;
+    size_t buf_size =
+        na_ofi_msg_get_max_unexpected_size(na_ofi_class->na_class);
+    unsigned int i;
+    na_return_t ret;
+
+    for (i = 0; i < NA_OFI_RING_BOUNCE_NUM; i++) {
+        struct na_ofi_ring_op *ring_op =
+            na_ofi_ring_op_create(na_ofi_class, NA_OFI_RING_OP_BOUNCE, NULL);
+
+        NA_CHECK_SUBSYS_ERROR(msg, ring_op == NULL, error, ret, NA_NOMEM,
+            "Could not allocate bounce recv");
+        ring_op->op_id.context = context;
+        ring_op->buf = (char *) malloc(buf_size);
+        if (ring_op->buf == NULL) {
+            na_ofi_ring_op_free(ring_op);
+            NA_GOTO_SUBSYS_ERROR(msg, error, ret, NA_NOMEM,
+                "Could not allocate bounce buffer of %zu bytes", buf_size);
+        }
+        ring_rx->bounce_ops[i] = ring_op;
+
+        na_ofi_ring_bounce_post(na_ofi_class, ring_op);
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_rx_close(
+    struct na_ofi_class *na_ofi_class, struct na_ofi_context *na_ofi_context)
+{
+    struct na_ofi_ring_rx *ring_rx = na_ofi_context->ring_rx;
+    unsigned int i, posted = 0, poll_count = 0;
+
+    hg_thread_spin_lock(&ring_rx->lock);
+    ring_rx->closing = true;
+    hg_thread_spin_unlock(&ring_rx->lock);
+
+    /* Pull back bounce recvs still posted */
+    for (i = 0; i < NA_OFI_RING_BOUNCE_NUM; i++)
+        if (ring_rx->bounce_ops[i] != NULL && ring_rx->bounce_ops[i]->posted)
+            (void) na_ofi_cancel(na_ofi_class->na_class,
+                ring_rx->bounce_ops[i]->op_id.context,
+                (na_op_id_t *) &ring_rx->bounce_ops[i]->op_id);
+
+    /* Reap cancellation events */
+    do {
+        size_t actual_count = 0;
+
+        for (i = 0, posted = 0; i < NA_OFI_RING_BOUNCE_NUM; i++)
+            if (ring_rx->bounce_ops[i] != NULL &&
+                ring_rx->bounce_ops[i]->posted)
+                posted++;
+        if (posted == 0)
+            break;
+
+        if (na_ofi_class->cq_poll(na_ofi_class, na_ofi_context,
+                na_ofi_context->cq_event_num, &actual_count) != NA_SUCCESS)
+            break;
+    } while (++poll_count < NA_OFI_RING_CLOSE_POLL);
+    NA_CHECK_SUBSYS_WARNING(ctx, posted > 0,
+        "%u bounce recvs could not be canceled, leaking them", posted);
+
+    /* Drop msgs that were never received */
+    while (!HG_QUEUE_IS_EMPTY(&ring_rx->msg_queue)) {
+        struct na_ofi_ring_msg *msg = HG_QUEUE_FIRST(&ring_rx->msg_queue);
+
+        HG_QUEUE_POP_HEAD(&ring_rx->msg_queue, entry);
+        na_ofi_addr_ref_decr(msg->addr);
+    }
+    NA_CHECK_SUBSYS_WARNING(ctx, !HG_QUEUE_IS_EMPTY(&ring_rx->recv_queue),
+        "Unexpected recvs are still posted");
+
+    for (i = 0; i < NA_OFI_RING_BOUNCE_NUM; i++)
+        if (ring_rx->bounce_ops[i] != NULL && !ring_rx->bounce_ops[i]->posted)
+            na_ofi_ring_op_free(ring_rx->bounce_ops[i]);
+
+    for (i = 0; i < ring_rx->ring_count; i++)
+        if (ring_rx->rings[i] != NULL)
+            na_ofi_ring_free(na_ofi_class, ring_rx->rings[i]);
+
+    (void) hg_thread_spin_destroy(&ring_rx->lock);
+    free(ring_rx);
+    na_ofi_context->ring_rx = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_bounce_post(
+    struct na_ofi_class *na_ofi_class, struct na_ofi_ring_op *ring_op)
+{
+    struct na_ofi_context *na_ofi_context =
+        NA_OFI_CONTEXT(ring_op->op_id.context);
+    na_return_t ret;
+
+    if (na_ofi_context->ring_rx->closing)
+        return;
+
+    /* Bounce recvs get both unexpected msgs and ring requests */
+    NA_OFI_OP_RESET((&ring_op->op_id), ring_op->op_id.context, FI_RECV,
+        NA_CB_RECV_UNEXPECTED, NULL, NULL, NULL);
+    ring_op->op_id.info.msg = (struct na_ofi_msg_info){.buf.ptr = ring_op->buf,
+        .buf_size = na_ofi_msg_get_max_unexpected_size(na_ofi_class->na_class),
+        .fi_addr = FI_ADDR_UNSPEC,
+        .desc = NULL,
+        .tag = NA_OFI_UNEXPECTED_TAG,
+        .tag_mask = NA_OFI_TAG_MASK | NA_OFI_RING_TAG};
+    ring_op->posted = true;
+
+    ret = na_ofi_ring_post(
+        na_ofi_class, ring_op, na_ofi_context->fi_rx, na_ofi_tag_recv);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_SUBSYS_ERROR(msg, "Could not post bounce recv");
+        hg_atomic_set32(&ring_op->op_id.status, NA_OFI_OP_COMPLETED);
+        ring_op->posted = false;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_grant(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_op *bounce, const struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_addr *na_ofi_addr)
+{
+    struct na_ofi_context *na_ofi_context =
+        NA_OFI_CONTEXT(bounce->op_id.context);
+    size_t header_size =
+        na_ofi_msg_get_unexpected_header_size(na_ofi_class->na_class);
+    struct na_ofi_ring *ring = NULL;
+    struct na_ofi_ring_op *ring_op = NULL;
+    struct na_ofi_ring_ctl req, grant;
+    fi_addr_t fi_addr;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg, cq_event->len != header_size + sizeof(req),
+        error, ret, NA_PROTOCOL_ERROR, "Invalid ring REQ size (%zu)",
+        cq_event->len);
+    memcpy(&req, bounce->buf + header_size, sizeof(req));
+
+    /* Deny request if no ring can be created, sender then keeps sending */
+    ret = na_ofi_ring_create(
+        na_ofi_class, na_ofi_context->ring_rx, na_ofi_addr, &ring);
+    NA_CHECK_SUBSYS_WARNING(
+        msg, ret != NA_SUCCESS, "Could not create ring, denying request");
+
+    grant = (struct na_ofi_ring_ctl){.req_id = req.req_id,
+        .context_id = na_ofi_context->idx};
+    if (ring != NULL) {
+        grant.addr =
+            (na_ofi_class->fi_info->domain_attr->mr_mode & FI_MR_VIRT_ADDR)
+                ? (uint64_t) (uintptr_t) ring->buf
+                : 0;
+        grant.key = ring->mem_handle.desc.info.fi_mr_key;
+        grant.slot_size = (uint32_t) ring->slot_size;
+        grant.ring_id = ring->id;
+        grant.slot_num = ring->slot_num;
+    }
+
+    /* GRANT goes back to the requesting context */
+    ret = na_ofi_addr_route(na_ofi_addr, (uint8_t) req.context_id, &fi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        msg, error, ret, "Could not resolve remote context address");
+
+    ring_op = na_ofi_ring_op_create(na_ofi_class, NA_OFI_RING_OP_GRANT, NULL);
+    NA_CHECK_SUBSYS_ERROR(msg, ring_op == NULL, error, ret, NA_NOMEM,
+        "Could not allocate ring operation");
+    memcpy(ring_op->ctl, &grant, sizeof(grant));
+
+    NA_OFI_OP_RESET((&ring_op->op_id), bounce->op_id.context, FI_SEND,
+        NA_CB_SEND_EXPECTED, NULL, NULL, na_ofi_addr);
+    ring_op->op_id.info.msg =
+        (struct na_ofi_msg_info){.buf.const_ptr = ring_op->ctl,
+            .buf_size = sizeof(grant),
+            .fi_addr = fi_addr,
+            .desc = NULL,
+            .tag = NA_OFI_RING_TAG | req.req_id};
+
+    ret = na_ofi_ring_post(
+        na_ofi_class, ring_op, na_ofi_context->fi_tx, na_ofi_tag_send);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, error, ret, "Could not post GRANT send");
+
+    NA_LOG_SUBSYS_DEBUG(msg,
+        "Granting ring %" PRIu16 " (req_id=%" PRIu32 ", slots=%" PRIu16 ")",
+        grant.ring_id, req.req_id, grant.slot_num);
+
+    return;
+
+error:
+    if (ring_op != NULL)
+        na_ofi_ring_op_free(ring_op);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_create(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_addr *na_ofi_addr,
+    struct na_ofi_ring **ring_p)
+{
+    struct na_ofi_ring *ring = NULL;
+    struct na_ofi_mem_handle *mem_handle;
+    size_t slot_size, buf_size;
+    unsigned int id;
     na_return_t ret;
 
-    NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, error, ret, NA_INVALID_ARG,
-        "Invalid operation ID");
-    NA_CHECK_SUBSYS_ERROR(op,
-        !(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED), error,
-        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
-        na_cb_type_to_string(na_ofi_op_id->type));
+    /* Reserve ring ID, IDs are never reused */
+    hg_thread_spin_lock(&ring_rx->lock);
+    id = ring_rx->ring_count;
+    if (id < NA_OFI_RING_MAX)
+        ring_rx->ring_count++;
+    hg_thread_spin_unlock(&ring_rx->lock);
+    NA_CHECK_SUBSYS_ERROR(msg, id >= NA_OFI_RING_MAX, error, ret, NA_OVERFLOW,
+        "Reached max number of rings (%d)", NA_OFI_RING_MAX);
 
-    NA_OFI_OP_RESET(
-        na_ofi_op_id, context, FI_RMA, cb_type, callback, arg, na_ofi_addr);
+    ring = (struct na_ofi_ring *) calloc(1, sizeof(*ring));
+    NA_CHECK_SUBSYS_ERROR(
+        msg, ring == NULL, error, ret, NA_NOMEM, "Could not allocate ring");
+    ring->id = (uint16_t) id;
+    ring->slot_num = (uint16_t) na_ofi_class->ring_slot_num;
+
+    /* Slots hold the largest unexpected msg, kept 8-byte aligned */
+    slot_size = sizeof(struct na_ofi_ring_slot_hdr) +
+                na_ofi_msg_get_max_unexpected_size(na_ofi_class->na_class);
+    slot_size = (slot_size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+    ring->slot_size = slot_size;
+    buf_size = NA_OFI_RING_HDR_SIZE + ring->slot_num * slot_size;
+
+    ring->buf = hg_mem_aligned_alloc((size_t) hg_mem_get_page_size(), buf_size);
+    NA_CHECK_SUBSYS_ERROR(msg, ring->buf == NULL, error, ret, NA_NOMEM,
+        "Could not allocate ring buffer of %zu bytes", buf_size);
+    memset(ring->buf, 0, NA_OFI_RING_HDR_SIZE);
+    ring->consumed_p = (volatile uint64_t *) ring->buf;
+    ring->slots = (char *) ring->buf + NA_OFI_RING_HDR_SIZE;
+
+    ring->slot_states = (uint8_t *) calloc(ring->slot_num, sizeof(uint8_t));
+    NA_CHECK_SUBSYS_ERROR(msg, ring->slot_states == NULL, error, ret,
+        NA_NOMEM, "Could not allocate slot states");
+    ring->msgs = (struct na_ofi_ring_msg *) calloc(
+        ring->slot_num, sizeof(struct na_ofi_ring_msg));
+    NA_CHECK_SUBSYS_ERROR(msg, ring->msgs == NULL, error, ret, NA_NOMEM,
+        "Could not allocate slot msgs");
+
+    /* Sender writes slots and reads consumed count */
+    mem_handle = &ring->mem_handle;
+    mem_handle->desc.iov.s[0] =
+        (struct iovec){.iov_base = ring->buf, .iov_len = buf_size};
+    mem_handle->desc.info.iovcnt = 1;
+    mem_handle->desc.info.flags = NA_MEM_READWRITE;
+    mem_handle->desc.info.len = buf_size;
+
+    ret = na_ofi_mem_register(na_ofi_class->na_class,
+        (na_mem_handle_t *) mem_handle, NA_MEM_TYPE_HOST, 0);
+    NA_CHECK_SUBSYS_NA_ERROR(msg, error, ret, "Could not register ring");
 
-    /* Set RMA info */
-    rma_info = &na_ofi_op_id->info.rma;
-    rma_info->fi_rma_op = fi_rma_op;
-    rma_info->fi_rma_op_string = fi_rma_op_string;
-    rma_info->fi_rma_flags = fi_rma_flags;
+    na_ofi_addr_ref_incr(na_ofi_addr);
+    ring->addr = na_ofi_addr;
 
-    /* Translate local offset */
-    if (local_offset > 0)
-        na_ofi_iov_get_index_offset(local_iov, local_iovcnt, local_offset,
-            &local_iov_start_index, &local_iov_start_offset);
+    hg_thread_spin_lock(&ring_rx->lock);
+    ring_rx->rings[id] = ring;
+    hg_thread_spin_unlock(&ring_rx->lock);
 
-    rma_info->local_iovcnt =
-        (length == na_ofi_mem_handle_local->desc.info.len)
-            ? local_iovcnt
-            : na_ofi_iov_get_count(local_iov, local_iovcnt,
-                  local_iov_start_index, local_iov_start_offset, length);
+    *ring_p = ring;
 
-    if (rma_info->local_iovcnt > NA_OFI_IOV_STATIC_MAX) {
-        rma_info->local_iov_storage.d = (struct iovec *) malloc(
-            rma_info->local_iovcnt * sizeof(struct iovec));
-        NA_CHECK_SUBSYS_ERROR(rma, rma_info->local_iov_storage.d == NULL,
-            release, ret, NA_NOMEM,
-            "Could not allocate iovec array (local_iovcnt=%zu)",
-            rma_info->local_iovcnt);
-        rma_info->local_iov = rma_info->local_iov_storage.d;
+    return NA_SUCCESS;
 
-        rma_info->local_desc_storage.d =
-            (void **) malloc(rma_info->local_iovcnt * sizeof(void *));
-        NA_CHECK_SUBSYS_ERROR(rma, rma_info->local_desc_storage.d == NULL,
-            release, ret, NA_NOMEM,
-            "Could not allocate desc array (local_iovcnt=%zu)",
-            rma_info->local_iovcnt);
-        rma_info->local_desc = rma_info->local_desc_storage.d;
-    } else {
-        rma_info->local_iov = rma_info->local_iov_storage.s;
-        rma_info->local_desc = rma_info->local_desc_storage.s;
+error:
+    if (ring != NULL) {
+        free(ring->msgs);
+        free(ring->slot_states);
+        hg_mem_aligned_free(ring->buf);
+        free(ring);
     }
+    return ret;
+}
 
-    /* TODO: support multiple local descs for each iov */
-    na_ofi_iov_translate(local_iov, local_desc, local_iovcnt,
-        local_iov_start_index, local_iov_start_offset, length,
-        rma_info->local_iov, rma_info->local_desc, rma_info->local_iovcnt);
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_free(struct na_ofi_class *na_ofi_class, struct na_ofi_ring *ring)
+{
+    na_return_t ret;
 
-    /* Translate remote offset */
-    if (remote_offset > 0)
-        na_ofi_iov_get_index_offset(remote_iov, remote_iovcnt, remote_offset,
-            &remote_iov_start_index, &remote_iov_start_offset);
+    ret = na_ofi_mem_deregister(
+        na_ofi_class->na_class, (na_mem_handle_t *) &ring->mem_handle);
+    NA_CHECK_SUBSYS_WARNING(
+        msg, ret != NA_SUCCESS, "Could not deregister ring");
+    na_ofi_addr_ref_decr(ring->addr);
+    free(ring->msgs);
+    free(ring->slot_states);
+    hg_mem_aligned_free(ring->buf);
+    free(ring);
+}
 
-    rma_info->remote_iovcnt =
-        (length == na_ofi_mem_handle_remote->desc.info.len)
-            ? remote_iovcnt
-            : na_ofi_iov_get_count(remote_iov, remote_iovcnt,
-                  remote_iov_start_index, remote_iov_start_offset, length);
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_ring_process_write(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context,
+    const struct fi_cq_tagged_entry *cq_event)
+{
+    struct na_ofi_ring_rx *ring_rx = na_ofi_context->ring_rx;
+    unsigned int id = (unsigned int) ((cq_event->data >> 16) & 0xffff);
+    uint16_t slot = (uint16_t) (cq_event->data & 0xffff);
+    struct na_ofi_ring *ring = NULL;
+    struct na_ofi_ring_slot_hdr hdr;
+    struct na_ofi_ring_msg *msg;
+    na_return_t ret;
 
-    if (rma_info->remote_iovcnt > NA_OFI_IOV_STATIC_MAX) {
-        rma_info->remote_iov_storage.d = (struct fi_rma_iov *) malloc(
-            rma_info->remote_iovcnt * sizeof(struct fi_rma_iov));
-        NA_CHECK_SUBSYS_ERROR(rma, rma_info->remote_iov_storage.d == NULL,
-            release, ret, NA_NOMEM, "Could not allocate rma iovec");
-        rma_info->remote_iov = rma_info->remote_iov_storage.d;
+    NA_CHECK_SUBSYS_ERROR(msg,
+        ring_rx == NULL || !(cq_event->flags & FI_REMOTE_CQ_DATA), error, ret,
+        NA_PROTOCOL_ERROR, "Unexpected remote write (flags=0x%" PRIx64 ")",
+        cq_event->flags);
+
+    hg_thread_spin_lock(&ring_rx->lock);
+    if (id < ring_rx->ring_count)
+        ring = ring_rx->rings[id];
+    if (ring != NULL && slot < ring->slot_num &&
+        ring->slot_states[slot] == NA_OFI_RING_SLOT_FREE)
+        ring->slot_states[slot] = NA_OFI_RING_SLOT_FULL;
+    else
+        ring = NULL;
+    hg_thread_spin_unlock(&ring_rx->lock);
+    NA_CHECK_SUBSYS_ERROR(msg, ring == NULL, error, ret, NA_PROTOCOL_ERROR,
+        "Invalid ring write (ring=%u, slot=%" PRIu16 ")", id, slot);
+
+    /* Payload is visible once the remote CQ data event is read */
+    memcpy(&hdr, ring->slots + slot * ring->slot_size, sizeof(hdr));
+    NA_CHECK_SUBSYS_ERROR(msg, hdr.len + sizeof(hdr) > ring->slot_size, error,
+        ret, NA_PROTOCOL_ERROR, "Invalid ring msg size (%" PRIu32 ")",
+        hdr.len);
+
+    na_ofi_addr_ref_incr(ring->addr);
+    msg = &ring->msgs[slot];
+    *msg = (struct na_ofi_ring_msg){.ring = ring,
+        .bounce = NULL,
+        .addr = ring->addr,
+        .buf = ring->slots + slot * ring->slot_size + sizeof(hdr),
+        .len = hdr.len,
+        .tag = hdr.tag,
+        .slot = slot};
+    na_ofi_ring_msg_push(na_ofi_class, ring_rx, msg);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_msg_push(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_ring_msg *msg)
+{
+    struct na_ofi_op_id *na_ofi_op_id;
+
+    /* Unexpected recvs wait in the queue through their retry entry */
+    hg_thread_spin_lock(&ring_rx->lock);
+    na_ofi_op_id = HG_QUEUE_FIRST(&ring_rx->recv_queue);
+    if (na_ofi_op_id != NULL) {
+        HG_QUEUE_POP_HEAD(&ring_rx->recv_queue, retry);
+        hg_atomic_and32(&na_ofi_op_id->status, ~NA_OFI_OP_RING);
     } else
-        rma_info->remote_iov = rma_info->remote_iov_storage.s;
+        HG_QUEUE_PUSH_TAIL(&ring_rx->msg_queue, msg, entry);
+    hg_thread_spin_unlock(&ring_rx->lock);
 
-    na_ofi_rma_iov_translate(na_ofi_class->fi_info, remote_iov, remote_iovcnt,
-        remote_key, remote_iov_start_index, remote_iov_start_offset, length,
-        rma_info->remote_iov, rma_info->remote_iovcnt);
+    if (na_ofi_op_id != NULL)
+        na_ofi_ring_deliver(na_ofi_class, ring_rx, na_ofi_op_id, msg);
+}
 
-    rma_info->fi_addr =
-        fi_rx_addr(na_ofi_addr->fi_addr, remote_id, NA_OFI_SEP_RX_CTX_BITS);
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_deliver(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_op_id *na_ofi_op_id,
+    struct na_ofi_ring_msg *msg)
+{
+    struct na_cb_info_recv_unexpected *recv_unexpected_info =
+        &na_ofi_op_id->completion_data->callback_info.info.recv_unexpected;
+    na_return_t ret = NA_SUCCESS;
 
-    /* Post the OFI RMA operation */
-    ret =
-        na_ofi_rma_post(na_ofi_context->fi_tx, rma_info, &na_ofi_op_id->fi_ctx);
-    if (ret != NA_SUCCESS) {
-        if (ret == NA_AGAIN) {
-            na_ofi_op_id->retry_op.rma = na_ofi_rma_post;
-            na_ofi_op_retry(
-                na_ofi_context, na_ofi_class->op_retry_timeout, na_ofi_op_id);
-        } else
-            NA_GOTO_SUBSYS_ERROR_NORET(rma, release, "Could not post RMA op");
+    if (msg->len > na_ofi_op_id->info.msg.buf_size) {
+        NA_LOG_SUBSYS_ERROR(msg,
+            "Unexpected recv msg size too large for buffer (expected %zu, got "
+            "%zu)",
+            na_ofi_op_id->info.msg.buf_size, msg->len);
+        na_ofi_addr_ref_decr(msg->addr);
+        ret = NA_MSGSIZE;
+    } else {
+        memcpy(na_ofi_op_id->info.msg.buf.ptr, msg->buf, msg->len);
+
+        /* Source address reference is passed to the upper layer */
+        recv_unexpected_info->actual_buf_size = msg->len;
+        recv_unexpected_info->source = (na_addr_t *) msg->addr;
+        recv_unexpected_info->tag = (na_tag_t) (msg->tag & NA_OFI_TAG_MASK);
     }
 
-    return NA_SUCCESS;
+    na_ofi_ring_msg_release(na_ofi_class, ring_rx, msg);
+    na_ofi_op_complete_single(na_ofi_op_id, true, ret);
+}
 
-release:
-    na_ofi_rma_release(rma_info);
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_ring_msg_release(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_ring_msg *msg)
+{
+    struct na_ofi_ring *ring = msg->ring;
 
-    NA_OFI_OP_RELEASE(na_ofi_op_id);
+    if (ring == NULL) {
+        na_ofi_ring_bounce_post(na_ofi_class, msg->bounce);
+        return;
+    }
 
-error:
-    return ret;
+    /* Slots are given back to the sender in order */
+    hg_thread_spin_lock(&ring_rx->lock);
+    ring->slot_states[msg->slot] = NA_OFI_RING_SLOT_DONE;
+    while (ring->slot_states[ring->consumed % ring->slot_num] ==
+           NA_OFI_RING_SLOT_DONE) {
+        ring->slot_states[ring->consumed % ring->slot_num] =
+            NA_OFI_RING_SLOT_FREE;
+        ring->consumed++;
+    }
+    *ring->consumed_p = ring->consumed;
+    hg_thread_spin_unlock(&ring_rx->lock);
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ofi_rma_post(
-    struct fid_ep *ep, const struct na_ofi_rma_info *rma_info, void *context)
+na_ofi_ring_recv_unexpected(struct na_ofi_class *na_ofi_class,
+    na_context_t *context, struct na_ofi_op_id *na_ofi_op_id)
 {
-    struct fi_msg_rma fi_msg_rma = {.msg_iov = rma_info->local_iov,
-        .desc = rma_info->local_desc,
-        .iov_count = rma_info->local_iovcnt,
-        .addr = rma_info->fi_addr,
-        .rma_iov = rma_info->remote_iov,
-        .rma_iov_count = rma_info->remote_iovcnt,
-        .context = context,
-        .data = 0};
-    ssize_t rc;
+    struct na_ofi_ring_rx *ring_rx = NA_OFI_CONTEXT(context)->ring_rx;
+    struct na_ofi_ring_msg *msg;
+    bool start;
+    na_return_t ret;
 
-    NA_LOG_SUBSYS_DEBUG(rma,
-        "Posting RMA op (%s, context=%p), iov_count=%zu, desc[0]=%p, "
-        "msg_iov[0].iov_base=%p, msg_iov[0].iov_len=%zu, addr=%" PRIu64
-        ", rma_iov_count=%zu, rma_iov[0].addr=%" PRIu64
-        ", rma_iov[0].len=%zu, rma_iov[0].key=%" PRIu64 ", data=%" PRIu64,
-        rma_info->fi_rma_op_string, context, fi_msg_rma.iov_count,
-        fi_msg_rma.desc[0], fi_msg_rma.msg_iov[0].iov_base,
-        fi_msg_rma.msg_iov[0].iov_len, fi_msg_rma.addr,
-        fi_msg_rma.rma_iov_count, fi_msg_rma.rma_iov[0].addr,
-        fi_msg_rma.rma_iov[0].len, fi_msg_rma.rma_iov[0].key, fi_msg_rma.data);
+    /* Bounce recvs are posted once the context starts receiving */
+    hg_thread_spin_lock(&ring_rx->lock);
+    start = !ring_rx->started;
+    ring_rx->started = true;
+    hg_thread_spin_unlock(&ring_rx->lock);
+    if (start) {
+        ret = na_ofi_ring_rx_start(na_ofi_class, context);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            msg, error, ret, "Could not post bounce recvs");
+    }
 
-    /* Post the OFI RMA operation */
-    rc = rma_info->fi_rma_op(ep, &fi_msg_rma, rma_info->fi_rma_flags);
-    if (rc == 0)
-        return NA_SUCCESS;
-    else if (rc == -FI_EAGAIN)
-        return NA_AGAIN;
+    hg_thread_spin_lock(&ring_rx->lock);
+    msg = HG_QUEUE_FIRST(&ring_rx->msg_queue);
+    if (msg != NULL)
+        HG_QUEUE_POP_HEAD(&ring_rx->msg_queue, entry);
     else {
-        NA_LOG_SUBSYS_ERROR(rma,
-            "%s() failed, rc: %zd (%s), iov_count=%zu, desc[0]=%p, "
-            "msg_iov[0].iov_base=%p, msg_iov[0].iov_len=%zu, addr=%" PRIu64
-            ", rma_iov_count=%zu, rma_iov[0].addr=%" PRIu64
-            ", rma_iov[0].len=%zu, rma_iov[0].key=%" PRIu64
-            ", context=%p, data=%" PRIu64,
-            rma_info->fi_rma_op_string, rc, fi_strerror((int) -rc),
-            fi_msg_rma.iov_count, fi_msg_rma.desc[0],
-            fi_msg_rma.msg_iov[0].iov_base, fi_msg_rma.msg_iov[0].iov_len,
-            fi_msg_rma.addr, fi_msg_rma.rma_iov_count,
-            fi_msg_rma.rma_iov[0].addr, fi_msg_rma.rma_iov[0].len,
-            fi_msg_rma.rma_iov[0].key, fi_msg_rma.context, fi_msg_rma.data);
-        return na_ofi_errno_to_na((int) -rc);
+        HG_QUEUE_PUSH_TAIL(&ring_rx->recv_queue, na_ofi_op_id, retry);
+        hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_RING);
     }
+    hg_thread_spin_unlock(&ring_rx->lock);
+
+    if (msg != NULL)
+        na_ofi_ring_deliver(na_ofi_class, ring_rx, na_ofi_op_id, msg);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static NA_INLINE void
-na_ofi_rma_release(struct na_ofi_rma_info *rma_info)
+static void
+na_ofi_ring_cancel(
+    struct na_ofi_ring_rx *ring_rx, struct na_ofi_op_id *na_ofi_op_id)
 {
-    /* Can free extra IOVs here */
-    if (rma_info->local_iovcnt > NA_OFI_IOV_STATIC_MAX) {
-        free(rma_info->local_iov_storage.d);
-        rma_info->local_iov_storage.d = NULL;
-    }
-    if (rma_info->remote_iovcnt > NA_OFI_IOV_STATIC_MAX) {
-        free(rma_info->remote_iov_storage.d);
-        rma_info->remote_iov_storage.d = NULL;
+    bool canceled = false;
+
+    /* If matched in the meantime, let it complete */
+    hg_thread_spin_lock(&ring_rx->lock);
+    if (hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_RING) {
+        HG_QUEUE_REMOVE(
+            &ring_rx->recv_queue, na_ofi_op_id, na_ofi_op_id, retry);
+        hg_atomic_and32(&na_ofi_op_id->status, ~NA_OFI_OP_RING);
+        hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_CANCELED);
+        canceled = true;
     }
+    hg_thread_spin_unlock(&ring_rx->lock);
+
+    if (canceled)
+        na_ofi_op_id->complete(na_ofi_op_id, true, NA_CANCELED);
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_cq_poll_no_source(struct na_ofi_class *na_ofi_class,
-    struct na_ofi_context *na_ofi_context, size_t *actual_count_p)
+    struct na_ofi_context *na_ofi_context, size_t max_count,
+    size_t *actual_count_p)
 {
-    struct fi_cq_tagged_entry cq_events[NA_OFI_CQ_EVENT_NUM];
+    struct fi_cq_tagged_entry *cq_events = na_ofi_context->cq_events;
     size_t i, actual_count = 0;
     bool err_avail = false;
     na_return_t ret;
 
-    ret = na_ofi_cq_read(na_ofi_context->eq->fi_cq, cq_events,
-        NA_OFI_CQ_EVENT_NUM, &actual_count, &err_avail);
+    ret = na_ofi_cq_read(na_ofi_context->eq->fi_cq, cq_events, max_count,
+        &actual_count, &err_avail);
     NA_CHECK_SUBSYS_NA_ERROR(
         poll, error, ret, "Could not read events from context CQ");
 
@@ -5550,11 +8650,22 @@ na_ofi_cq_poll_no_source(struct na_ofi_class *na_ofi_class,
             container_of(cq_events[i].op_context, struct na_ofi_op_id, fi_ctx);
         struct na_ofi_addr *na_ofi_addr = NULL;
 
+        /* Ring writes carry no operation context */
+        if (unlikely(cq_events[i].flags & FI_REMOTE_WRITE)) {
+            ret = na_ofi_ring_process_write(
+                na_ofi_class, na_ofi_context, &cq_events[i]);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                poll, error, ret, "Could not process ring write");
+            continue;
+        }
+
         NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, error, ret,
             NA_INVALID_ARG, "Invalid operation ID");
 
-        if (na_ofi_op_id->type == NA_CB_RECV_UNEXPECTED ||
-            na_ofi_op_id->type == NA_CB_MULTI_RECV_UNEXPECTED) {
+        /* Later rendezvous steps already resolved the source */
+        if ((na_ofi_op_id->type == NA_CB_RECV_UNEXPECTED ||
+                na_ofi_op_id->type == NA_CB_MULTI_RECV_UNEXPECTED) &&
+            na_ofi_op_id->rdv.state == NA_OFI_RDV_NONE) {
             ret = na_ofi_cq_process_raw_src_addr(na_ofi_class,
                 (na_ofi_op_id->type == NA_CB_MULTI_RECV_UNEXPECTED)
                     ? cq_events[i].buf
@@ -5564,7 +8675,8 @@ na_ofi_cq_poll_no_source(struct na_ofi_class *na_ofi_class,
                 msg, error, ret, "Could not process raw src addr");
         }
 
-        ret = na_ofi_cq_process_event(na_ofi_class, &cq_events[i], na_ofi_addr);
+        ret = na_ofi_cq_process_event(
+            na_ofi_class, na_ofi_op_id, &cq_events[i], na_ofi_addr);
         NA_CHECK_SUBSYS_NA_ERROR(poll, error, ret, "Could not process event");
     }
 
@@ -5579,10 +8691,11 @@ error:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_cq_poll_fi_source(struct na_ofi_class *na_ofi_class,
-    struct na_ofi_context *na_ofi_context, size_t *actual_count_p)
+    struct na_ofi_context *na_ofi_context, size_t max_count,
+    size_t *actual_count_p)
 {
-    struct fi_cq_tagged_entry cq_events[NA_OFI_CQ_EVENT_NUM];
-    fi_addr_t src_addrs[NA_OFI_CQ_EVENT_NUM];
+    struct fi_cq_tagged_entry *cq_events = na_ofi_context->cq_events;
+    fi_addr_t *src_addrs = na_ofi_context->cq_src_addrs;
     char src_err_addr[NA_OFI_CQ_MAX_ERR_DATA_SIZE] = {0};
     void *src_err_addr_ptr = NULL;
     size_t src_err_addrlen = 0;
@@ -5590,8 +8703,8 @@ na_ofi_cq_poll_fi_source(struct na_ofi_class *na_ofi_class,
     bool err_avail = false;
     na_return_t ret;
 
-    ret = na_ofi_cq_readfrom(na_ofi_context->eq->fi_cq, cq_events,
-        NA_OFI_CQ_EVENT_NUM, src_addrs, &actual_count, &err_avail);
+    ret = na_ofi_cq_readfrom(na_ofi_context->eq->fi_cq, cq_events, max_count,
+        src_addrs, &actual_count, &err_avail);
     NA_CHECK_SUBSYS_NA_ERROR(
         poll, error, ret, "Could not read events from context CQ");
 
@@ -5610,18 +8723,31 @@ na_ofi_cq_poll_fi_source(struct na_ofi_class *na_ofi_class,
             container_of(cq_events[i].op_context, struct na_ofi_op_id, fi_ctx);
         struct na_ofi_addr *na_ofi_addr = NULL;
 
+        /* Ring writes carry no operation context */
+        if (unlikely(cq_events[i].flags & FI_REMOTE_WRITE)) {
+            ret = na_ofi_ring_process_write(
+                na_ofi_class, na_ofi_context, &cq_events[i]);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                poll, error, ret, "Could not process ring write");
+            continue;
+        }
+
         NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, error, ret,
             NA_INVALID_ARG, "Invalid operation ID");
 
-        if (na_ofi_op_id->type == NA_CB_RECV_UNEXPECTED ||
-            na_ofi_op_id->type == NA_CB_MULTI_RECV_UNEXPECTED) {
-            ret = na_ofi_cq_process_src_addr(na_ofi_class, &cq_events[i],
-                src_addrs[i], src_err_addr_ptr, src_err_addrlen, &na_ofi_addr);
+        /* Later rendezvous steps already resolved the source */
+        if ((na_ofi_op_id->type == NA_CB_RECV_UNEXPECTED ||
+                na_ofi_op_id->type == NA_CB_MULTI_RECV_UNEXPECTED) &&
+            na_ofi_op_id->rdv.state == NA_OFI_RDV_NONE) {
+            ret = na_ofi_cq_process_src_addr(na_ofi_class, na_ofi_context,
+                &cq_events[i], src_addrs[i], src_err_addr_ptr, src_err_addrlen,
+                &na_ofi_addr);
             NA_CHECK_SUBSYS_NA_ERROR(
                 poll, error, ret, "Could not process src addr");
         }
 
-        ret = na_ofi_cq_process_event(na_ofi_class, &cq_events[i], na_ofi_addr);
+        ret = na_ofi_cq_process_event(
+            na_ofi_class, na_ofi_op_id, &cq_events[i], na_ofi_addr);
         NA_CHECK_SUBSYS_NA_ERROR(poll, error, ret, "Could not process event");
     }
 
@@ -5786,11 +8912,15 @@ na_ofi_cq_readerr(struct fid_cq *cq, struct fi_cq_tagged_entry *cq_event,
                     NA_OFI_OP_CANCELED)
                     break;
 
-                /* Abort other retries if peer is unreachable */
-                if (na_ret == NA_HOSTUNREACH && na_ofi_op_id->addr)
+                /* Abort other retries and notify upper layer if peer is
+                 * unreachable */
+                if (na_ret == NA_HOSTUNREACH && na_ofi_op_id->addr) {
                     na_ofi_op_retry_abort_addr(
                         NA_OFI_CONTEXT(na_ofi_op_id->context),
                         na_ofi_op_id->addr->fi_addr, NA_HOSTUNREACH);
+                    na_cb_addr_error(na_ofi_op_id->na_ofi_class->na_class,
+                        (na_addr_t *) na_ofi_op_id->addr, NA_HOSTUNREACH);
+                }
 
                 /* Complete operation in error state */
                 na_ofi_op_id->complete(na_ofi_op_id, true, na_ret);
@@ -5805,6 +8935,7 @@ out:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_cq_process_src_addr(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_context *na_ofi_context,
     const struct fi_cq_tagged_entry *cq_event, fi_addr_t src_addr,
     void *src_err_addr, size_t src_err_addrlen,
     struct na_ofi_addr **na_ofi_addr_p)
@@ -5815,8 +8946,8 @@ na_ofi_cq_process_src_addr(struct na_ofi_class *na_ofi_class,
     na_return_t ret;
 
     if (src_addr != FI_ADDR_NOTAVAIL) {
-        ret =
-            na_ofi_cq_process_fi_src_addr(na_ofi_class, src_addr, &na_ofi_addr);
+        ret = na_ofi_cq_process_fi_src_addr(
+            na_ofi_class, na_ofi_context, src_addr, &na_ofi_addr);
         NA_CHECK_SUBSYS_NA_ERROR(
             msg, error, ret, "Could not process FI src addr");
     } else if (src_err_addr != NULL && src_err_addrlen != 0) {
@@ -5845,9 +8976,14 @@ error:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_cq_process_fi_src_addr(struct na_ofi_class *na_ofi_class,
-    fi_addr_t src_addr, struct na_ofi_addr **na_ofi_addr_p)
+    struct na_ofi_context *na_ofi_context, fi_addr_t src_addr,
+    struct na_ofi_addr **na_ofi_addr_p)
 {
+    struct na_ofi_map *na_ofi_map = &na_ofi_class->domain->addr_map;
+    struct na_ofi_addr_cache_entry *entry =
+        &na_ofi_context->addr_cache[src_addr & (NA_OFI_ADDR_CACHE_SIZE - 1)];
     struct na_ofi_addr *na_ofi_addr = NULL;
+    int32_t gen;
     na_return_t ret;
 
     NA_CHECK_SUBSYS_ERROR(addr, src_addr == FI_ADDR_NOTAVAIL, error, ret,
@@ -5860,10 +8996,21 @@ na_ofi_cq_process_fi_src_addr(struct na_ofi_class *na_ofi_class,
     NA_LOG_SUBSYS_DEBUG(
         addr, "Retrieving address for FI addr %" PRIu64, src_addr);
 
-    na_ofi_addr =
-        na_ofi_fi_addr_map_lookup(&na_ofi_class->domain->addr_map, &src_addr);
-    NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addr == NULL, error, ret, NA_NOENTRY,
-        "No entry found for previously inserted src addr");
+    /* Cache entries are only valid if no address was removed since then,
+     * read generation first so that a concurrent removal invalidates it */
+    gen = hg_atomic_get32(&na_ofi_map->gen);
+    if (entry->addr != NULL && entry->fi_addr == src_addr &&
+        entry->gen == gen)
+        na_ofi_addr = entry->addr;
+    else {
+        na_ofi_addr = na_ofi_fi_addr_map_lookup(na_ofi_map, &src_addr);
+        NA_CHECK_SUBSYS_ERROR(addr, na_ofi_addr == NULL, error, ret,
+            NA_NOENTRY, "No entry found for previously inserted src addr");
+
+        entry->addr = na_ofi_addr;
+        entry->fi_addr = src_addr;
+        entry->gen = gen;
+    }
 
     na_ofi_addr_ref_incr(na_ofi_addr);
 
@@ -5944,10 +9091,9 @@ error:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_cq_process_event(struct na_ofi_class *na_ofi_class,
+    struct na_ofi_op_id *na_ofi_op_id,
     const struct fi_cq_tagged_entry *cq_event, struct na_ofi_addr *na_ofi_addr)
 {
-    struct na_ofi_op_id *na_ofi_op_id =
-        container_of(cq_event->op_context, struct na_ofi_op_id, fi_ctx);
     bool complete = true;
     na_return_t ret;
 
@@ -5967,6 +9113,27 @@ na_ofi_cq_process_event(struct na_ofi_class *na_ofi_class,
         cq_event->op_context, cq_event->flags, cq_event->len, cq_event->buf,
         cq_event->data, cq_event->tag);
 
+    /* Ring control ops and bounce recvs are internal to the plugin */
+    if (unlikely(na_ofi_op_id->ring_op))
+        return na_ofi_ring_process(na_ofi_class,
+            container_of(na_ofi_op_id, struct na_ofi_ring_op, op_id), cq_event,
+            na_ofi_addr);
+
+    /* Rendezvous messages only complete once the payload was read */
+    if (na_ofi_op_id->rdv.state != NA_OFI_RDV_NONE ||
+        ((na_ofi_op_id->type == NA_CB_RECV_UNEXPECTED ||
+             na_ofi_op_id->type == NA_CB_RECV_EXPECTED) &&
+            (cq_event->flags & FI_TAGGED) &&
+            (cq_event->tag & NA_OFI_RDV_TAG))) {
+        ret = na_ofi_rdv_process(
+            na_ofi_class, na_ofi_op_id, cq_event, na_ofi_addr, &complete);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            msg, error, ret, "Could not process rendezvous event");
+        if (!complete)
+            return NA_SUCCESS;
+        goto done;
+    }
+
     switch (na_ofi_op_id->type) {
         case NA_CB_RECV_UNEXPECTED:
             /* Default to cq_event->tag for backward compatibility */
@@ -6003,6 +9170,10 @@ na_ofi_cq_process_event(struct na_ofi_class *na_ofi_class,
         case NA_CB_GET:
             na_ofi_rma_release(&na_ofi_op_id->info.rma);
             break;
+        case NA_CB_ATOMIC:
+            na_ofi_op_id->completion_data->callback_info.info.atomic.result =
+                na_ofi_op_id->info.atomic.result;
+            break;
         case NA_CB_SEND_UNEXPECTED:
         case NA_CB_SEND_EXPECTED:
             break;
@@ -6011,7 +9182,12 @@ na_ofi_cq_process_event(struct na_ofi_class *na_ofi_class,
                 "Operation type %d not supported", na_ofi_op_id->type);
     }
 
-    na_ofi_op_id->complete(na_ofi_op_id, complete, NA_SUCCESS);
+done:
+    /* Direct call rather than through op ID's complete() callback */
+    if (na_ofi_op_id->multi_event)
+        na_ofi_op_complete_multi(na_ofi_op_id, complete, NA_SUCCESS);
+    else
+        na_ofi_op_complete_single(na_ofi_op_id, complete, NA_SUCCESS);
 
     return NA_SUCCESS;
 
@@ -6115,6 +9291,7 @@ na_ofi_cq_process_retries(
     struct na_ofi_context *na_ofi_context, unsigned retry_period_ms)
 {
     struct na_ofi_op_queue *op_queue = na_ofi_context->eq->retry_op_queue;
+    struct hg_backoff *backoff = &na_ofi_context->eq->retry_backoff;
     struct na_ofi_op_id *na_ofi_op_id = NULL;
     na_return_t ret;
 
@@ -6123,9 +9300,6 @@ na_ofi_cq_process_retries(
         na_cb_type_t cb_type;
         hg_time_t now;
 
-        if (retry_period_ms > 0)
-            hg_time_get_current_ms(&now);
-
         hg_thread_spin_lock(&op_queue->lock);
         na_ofi_op_id = HG_QUEUE_FIRST(&op_queue->queue);
         if (!na_ofi_op_id) {
@@ -6134,10 +9308,15 @@ na_ofi_cq_process_retries(
             break;
         }
 
+        /* Ops are retried in order and all wait for the same resources, do
+         * not visit the queue again until the last busy retry backed off */
+        hg_time_get_current(&now);
+        if (!hg_backoff_ready(backoff, now))
+            skip_retry = true;
         /* Op in tail is always the most recent OP ID to be retried, if op in
          * head has already been retried less than the retry period, no need to
          * check the next ones. */
-        if (retry_period_ms > 0) {
+        else if (retry_period_ms > 0) {
             hg_time_t retry_period_deadline = hg_time_add(
                 na_ofi_op_id->retry_last, hg_time_from_ms(retry_period_ms));
             if (hg_time_less(retry_period_deadline, now))
@@ -6188,6 +9367,10 @@ na_ofi_cq_process_retries(
                 ret = na_ofi_op_id->retry_op.rma(na_ofi_context->fi_tx,
                     &na_ofi_op_id->info.rma, &na_ofi_op_id->fi_ctx);
                 break;
+            case FI_ATOMIC:
+                ret = na_ofi_op_id->retry_op.atomic(na_ofi_context->fi_tx,
+                    &na_ofi_op_id->info.atomic, &na_ofi_op_id->fi_ctx);
+                break;
             default:
                 NA_GOTO_SUBSYS_ERROR(op, error, ret, NA_INVALID_ARG,
                     "Operation type %" PRIu64 " not supported",
@@ -6195,6 +9378,10 @@ na_ofi_cq_process_retries(
         }
 
         if (ret == NA_SUCCESS) {
+            hg_thread_spin_lock(&op_queue->lock);
+            hg_backoff_reset(backoff);
+            hg_thread_spin_unlock(&op_queue->lock);
+
             /* If the operation got canceled while we retried it, attempt to
              * cancel it */
             if (hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_CANCELING) {
@@ -6204,8 +9391,10 @@ na_ofi_cq_process_retries(
             }
             continue;
         } else if (ret == NA_AGAIN) {
+            hg_atomic_incr64(na_ofi_op_id->na_ofi_class->retry_again);
+
             /* Do not retry past deadline */
-            hg_time_get_current_ms(&now);
+            hg_time_get_current(&now);
             if (hg_time_less(na_ofi_op_id->retry_deadline, now)) {
                 NA_LOG_SUBSYS_WARNING(op,
                     "Retry time elapsed, aborting operation %p (%s)",
@@ -6216,6 +9405,7 @@ na_ofi_cq_process_retries(
             }
 
             hg_thread_spin_lock(&op_queue->lock);
+            hg_backoff_fail(backoff, now);
             /* Do not repush OP ID if it was canceled in the meantime */
             if (hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_CANCELING) {
                 hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_CANCELED);
@@ -6263,6 +9453,8 @@ na_ofi_op_retry(struct na_ofi_context *na_ofi_context, unsigned int timeout_ms,
     NA_LOG_SUBSYS_DEBUG(op, "Pushing %p for retry (%s)", (void *) na_ofi_op_id,
         na_cb_type_to_string(na_ofi_op_id->type));
 
+    hg_atomic_incr64(na_ofi_op_id->na_ofi_class->retry_count);
+
     /* Set retry deadline */
     hg_time_get_current_ms(&na_ofi_op_id->retry_last);
     na_ofi_op_id->retry_deadline =
@@ -6311,6 +9503,11 @@ na_ofi_op_complete_single(struct na_ofi_op_id *na_ofi_op_id,
     struct na_cb_completion_data *completion_data =
         na_ofi_op_id->completion_data;
 
+    /* Failed deferred RMA ops do not bump the counter that others wait on */
+    if (cb_ret != NA_SUCCESS && na_ofi_op_id->fi_op_flags == FI_RMA &&
+        na_ofi_op_id->info.rma.deferred != NULL)
+        (void) fi_cntr_add(NA_OFI_CONTEXT(na_ofi_op_id->context)->rma_cntr, 1);
+
     /* Mark op id as completed (independent of cb_ret) */
     hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_COMPLETED);
 
@@ -6340,6 +9537,8 @@ na_ofi_op_release_single(void *arg)
             (!(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED)),
         "Releasing resources from an uncompleted operation");
 
+    na_ofi_rdv_release(na_ofi_op_id);
+
     if (na_ofi_op_id->addr) {
         na_ofi_addr_ref_decr(na_ofi_op_id->addr);
         na_ofi_op_id->addr = NULL;
@@ -6428,6 +9627,7 @@ na_ofi_op_cancel(struct na_ofi_op_id *na_ofi_op_id)
         case NA_CB_SEND_EXPECTED:
         case NA_CB_PUT:
         case NA_CB_GET:
+        case NA_CB_ATOMIC:
             fi_ep = NA_OFI_CONTEXT(na_ofi_op_id->context)->fi_tx;
             break;
         default:
@@ -6436,6 +9636,27 @@ na_ofi_op_cancel(struct na_ofi_op_id *na_ofi_op_id)
             break;
     }
 
+    /* Rendezvous steps may be posted on the other side of the context */
+    if (na_ofi_op_id->rdv.state != NA_OFI_RDV_NONE)
+        fi_ep = (na_ofi_op_id->fi_op_flags & FI_RECV)
+                    ? NA_OFI_CONTEXT(na_ofi_op_id->context)->fi_rx
+                    : NA_OFI_CONTEXT(na_ofi_op_id->context)->fi_tx;
+
+    /* Deferred work that has not been triggered yet is pulled back */
+    if (na_ofi_op_id->fi_op_flags == FI_RMA &&
+        na_ofi_op_id->info.rma.deferred != NULL) {
+        struct na_ofi_rma_deferred *deferred = na_ofi_op_id->info.rma.deferred;
+
+        rc = (ssize_t) fi_control(
+            &deferred->fi_domain->fid, FI_CANCEL_WORK, &deferred->work);
+        NA_LOG_SUBSYS_DEBUG(op, "fi_control(FI_CANCEL_WORK) rc: %d (%s)",
+            (int) rc, fi_strerror((int) -rc));
+        if (rc == 0) {
+            na_ofi_op_id->complete(na_ofi_op_id, true, NA_CANCELED);
+            return NA_SUCCESS;
+        }
+    }
+
     /* fi_cancel() is an asynchronous operation, either the operation
      * will be canceled and an FI_ECANCELED event will be generated
      * or it will show up in the regular completion queue.
@@ -6717,7 +9938,7 @@ out:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_initialize(
-    na_class_t *na_class, const struct na_info *na_info, bool NA_UNUSED listen)
+    na_class_t *na_class, const struct na_info *na_info, bool listen)
 {
     struct na_init_info na_init_info = NA_INIT_INFO_INITIALIZER;
     struct na_ofi_class *na_ofi_class = NULL;
@@ -6729,6 +9950,7 @@ na_ofi_initialize(
     na_return_t ret;
 #ifdef NA_OFI_HAS_MEM_POOL
     size_t pool_chunk_size;
+    int rc;
 #endif
 #ifdef NA_OFI_HAS_ADDR_POOL
     unsigned int i;
@@ -6799,11 +10021,39 @@ na_ofi_initialize(
     NA_CHECK_SUBSYS_NA_ERROR(
         cls, error, ret, "na_ofi_class_env_config() failed");
 
+    /* Triggered ops are only used with cxi where they are offloaded */
+    if (na_ofi_class->deferred_rma_max > 0) {
+        NA_CHECK_SUBSYS_WARNING(cls, prov_type != NA_OFI_PROV_CXI,
+            "NA_OFI_CXI_DEFERRED_RMA is ignored with provider %s",
+            na_ofi_prov_name[prov_type]);
+        if (prov_type != NA_OFI_PROV_CXI)
+            na_ofi_class->deferred_rma_max = 0;
+        else
+            info.use_trigger = true;
+    }
+
+#ifndef _WIN32
+    /* Average number of events per CQ read is cq_event_count / cq_read_count */
+    HG_LOG_ADD_COUNTER64(na, &na_ofi_class->cq_event_count, "cq_event_count",
+        "CQ events read");
+    HG_LOG_ADD_COUNTER64(na, &na_ofi_class->cq_read_count, "cq_read_count",
+        "Non-empty CQ reads");
+    HG_LOG_ADD_COUNTER64(
+        na, &na_ofi_class->retry_count, "retry_count", "Ops pushed for retry");
+    HG_LOG_ADD_COUNTER64(na, &na_ofi_class->retry_again,
+        "retry_again_count", "Retries that returned NA_AGAIN");
+    HG_LOG_ADD_COUNTER64(na, &na_ofi_class->av_count, "av_insert_count",
+        "Addrs inserted into AV");
+#endif
+
 #ifdef NA_HAS_HWLOC
-    /* Use autodetect if we can't guess which domain to use */
+    /* Use autodetect if we can't guess which domain to use, pick the domain
+     * local to the CPUs the class is used from if specified */
     if ((na_ofi_prov_flags[prov_type] & NA_OFI_LOC_INFO) && !domain_name &&
         !info.src_addr && !info.node) {
-        ret = na_loc_info_init(&loc_info);
+        NA_LOG_SUBSYS_DEBUG(cls, "Selecting domain local to CPUs %s",
+            na_init_info.cpu_set ? na_init_info.cpu_set : "of process");
+        ret = na_loc_info_init(na_init_info.cpu_set, &loc_info);
         NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could init loc info");
     }
 #endif
@@ -6826,6 +10076,11 @@ na_ofi_initialize(
             NA_PROTONOSUPPORT, "FI_MULTI_RECV is not supported by provider");
         na_ofi_class->opt_features |= NA_OPT_MULTI_RECV;
     }
+    /* Operands of atomics are not registered, skip FI_MR_LOCAL providers */
+    if ((na_ofi_prov_extra_caps[prov_type] & FI_ATOMIC) &&
+        (na_ofi_class->fi_info->caps & FI_ATOMIC) &&
+        !(na_ofi_class->fi_info->domain_attr->mr_mode & FI_MR_LOCAL))
+        na_ofi_class->opt_features |= NA_OPT_ATOMIC;
     if (na_ofi_prov_extra_caps[prov_type] & FI_SOURCE) {
         NA_CHECK_SUBSYS_ERROR(cls, !(na_ofi_class->fi_info->caps & FI_SOURCE),
             error, ret, NA_PROTONOSUPPORT,
@@ -6860,14 +10115,94 @@ na_ofi_initialize(
         na_ofi_class->domain->no_wait);
     na_ofi_class->no_wait = na_ofi_class->domain->no_wait || no_wait;
 
-    /* Set context limits */
-    NA_CHECK_SUBSYS_ERROR(fatal,
-        na_init_info.max_contexts > na_ofi_class->domain->context_max, error,
-        ret, NA_INVALID_ARG,
-        "Maximum number of requested contexts (%" PRIu8 ") exceeds provider "
-        "limitation(%zu)",
-        na_init_info.max_contexts, na_ofi_class->domain->context_max);
-    na_ofi_class->context_max = na_init_info.max_contexts;
+    /* Set context limits */
+    NA_CHECK_SUBSYS_ERROR(fatal,
+        na_init_info.max_contexts > na_ofi_class->domain->context_max, error,
+        ret, NA_INVALID_ARG,
+        "Maximum number of requested contexts (%" PRIu8 ") exceeds provider "
+        "limitation(%zu)",
+        na_init_info.max_contexts, na_ofi_class->domain->context_max);
+    na_ofi_class->context_max = na_init_info.max_contexts;
+    na_ofi_class->huge_pages = na_init_info.use_huge_pages;
+
+    /* Context endpoints listen on consecutive ports after the class one */
+    if (na_ofi_class->multi_ep) {
+        int addr_format = (int) na_ofi_class->fi_info->addr_format;
+
+        NA_CHECK_SUBSYS_ERROR(fatal,
+            (na_ofi_prov_flags[prov_type] & NA_OFI_SEP) ||
+                (addr_format != FI_SOCKADDR_IN &&
+                    addr_format != FI_SOCKADDR_IN6) ||
+                (na_ofi_class->fi_info->domain_attr->mr_mode & FI_MR_ENDPOINT),
+            error, ret, NA_OPNOTSUPPORTED,
+            "NA_OFI_MULTI_EP is not supported with provider %s",
+            na_ofi_prov_name[prov_type]);
+        na_ofi_class->multi_ep = (na_ofi_class->context_max > 1);
+    }
+
+    /* Messages above the threshold are read by the receiver, RTS is sent
+     * without a local descriptor */
+    if (na_ofi_class->rdv_msg_size > 0) {
+        NA_CHECK_SUBSYS_ERROR(fatal,
+            !(na_ofi_class->fi_info->caps & FI_RMA) ||
+                (na_ofi_class->fi_info->domain_attr->mr_mode & FI_MR_LOCAL),
+            error, ret, NA_OPNOTSUPPORTED,
+            "NA_OFI_RDV_SIZE is not supported with provider %s",
+            na_ofi_prov_name[prov_type]);
+        NA_CHECK_SUBSYS_ERROR(cls,
+            na_ofi_class->rdv_threshold >= na_ofi_class->rdv_msg_size, error,
+            ret, NA_INVALID_ARG,
+            "NA_OFI_RDV_THRESHOLD (%zu) must be smaller than NA_OFI_RDV_SIZE "
+            "(%zu)",
+            na_ofi_class->rdv_threshold, na_ofi_class->rdv_msg_size);
+        hg_atomic_init32(&na_ofi_class->rdv_fin_id, 0);
+
+        /* Unexpected messages can only use rendezvous when tagged */
+        if (na_init_info.max_expected_size == 0)
+            na_init_info.max_expected_size = na_ofi_class->rdv_msg_size;
+        if (na_init_info.max_unexpected_size == 0 &&
+            na_ofi_class->msg_send_unexpected == na_ofi_tag_send)
+            na_init_info.max_unexpected_size = na_ofi_class->rdv_msg_size;
+    } else
+        na_ofi_class->rdv_threshold = SIZE_MAX;
+
+    /* Ring slots are written with remote CQ data, control msgs share the
+     * unexpected tag space */
+    if (na_ofi_class->ring_slot_num > 0) {
+        NA_CHECK_SUBSYS_ERROR(fatal,
+            na_ofi_class->msg_send_unexpected != na_ofi_tag_send ||
+                na_ofi_class->rdv_msg_size > 0,
+            error, ret, NA_OPNOTSUPPORTED,
+            "NA_OFI_UNEXPECTED_RING requires NA_OFI_UNEXPECTED_TAG_MSG and "
+            "no NA_OFI_RDV_SIZE");
+        NA_CHECK_SUBSYS_ERROR(fatal,
+            !(na_ofi_class->fi_info->caps & FI_RMA) ||
+                (na_ofi_class->fi_info->domain_attr->mr_mode & FI_MR_LOCAL) ||
+                (na_ofi_class->fi_info->mode & FI_RX_CQ_DATA) ||
+                na_ofi_class->fi_info->domain_attr->cq_data_size <
+                    sizeof(uint32_t),
+            error, ret, NA_OPNOTSUPPORTED,
+            "NA_OFI_UNEXPECTED_RING is not supported with provider %s",
+            na_ofi_prov_name[prov_type]);
+        hg_atomic_init32(&na_ofi_class->ring_req_id, 0);
+        na_ofi_class->ring_listen = listen;
+        NA_LOG_SUBSYS_DEBUG(cls, "Using unexpected rings of %zu slots",
+            na_ofi_class->ring_slot_num);
+    }
+
+    /* Deferred RMA ops are queued on the domain and triggered by a counter */
+    if (na_ofi_class->deferred_rma_max > 0) {
+        NA_CHECK_SUBSYS_ERROR(fatal,
+            !(na_ofi_class->fi_info->caps & FI_TRIGGER), error, ret,
+            NA_OPNOTSUPPORTED, "FI_TRIGGER is not supported by provider");
+        NA_LOG_SUBSYS_DEBUG(cls, "Deferring RMA ops past %zu in flight",
+            na_ofi_class->deferred_rma_max);
+    }
+
+    /* Small msgs are injected without generating a CQ entry, OPX needs the
+     * op context to pass the persistent address */
+    if ((int) na_ofi_class->fi_info->addr_format != FI_ADDR_OPX)
+        na_ofi_class->inject_size = na_ofi_class->fi_info->tx_attr->inject_size;
 
     /* Create endpoint */
     ret = na_ofi_endpoint_open(na_ofi_class->fabric, na_ofi_class->domain,
@@ -6881,22 +10216,44 @@ na_ofi_initialize(
         na_ofi_class->endpoint->expected_msg_size_max);
 
     /* Register initial mempool */
-    na_ofi_class->send_pool = hg_mem_pool_create(pool_chunk_size,
-        NA_OFI_MEM_CHUNK_COUNT, NA_OFI_MEM_BLOCK_COUNT, na_ofi_mem_buf_register,
-        NA_SEND, na_ofi_mem_buf_deregister, (void *) na_ofi_class);
+    na_ofi_class->send_pool = hg_mem_pool_create_opt(pool_chunk_size,
+        NA_OFI_MEM_CHUNK_COUNT, NA_OFI_MEM_BLOCK_COUNT,
+        na_init_info.use_huge_pages, na_ofi_mem_buf_register, NA_SEND,
+        na_ofi_mem_buf_deregister, (void *) na_ofi_class);
     NA_CHECK_SUBSYS_ERROR(cls, na_ofi_class->send_pool == NULL, error, ret,
         NA_NOMEM,
         "Could not create send pool with %d blocks of size %d x %zu bytes",
         NA_OFI_MEM_BLOCK_COUNT, NA_OFI_MEM_CHUNK_COUNT, pool_chunk_size);
+    rc = hg_mem_pool_set_thread_cache(
+        na_ofi_class->send_pool, NA_OFI_MEM_CACHE_COUNT);
+    NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+        "Could not enable send pool thread cache");
+    if (na_init_info.mem_budget != NULL) {
+        rc = hg_mem_pool_set_budget(
+            na_ofi_class->send_pool, na_init_info.mem_budget);
+        NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret,
+            NA_NOMEM, "Could not charge send pool to memory budget");
+    }
 
     /* Register initial mempool */
-    na_ofi_class->recv_pool = hg_mem_pool_create(pool_chunk_size,
-        NA_OFI_MEM_CHUNK_COUNT, NA_OFI_MEM_BLOCK_COUNT, na_ofi_mem_buf_register,
-        NA_RECV, na_ofi_mem_buf_deregister, (void *) na_ofi_class);
+    na_ofi_class->recv_pool = hg_mem_pool_create_opt(pool_chunk_size,
+        NA_OFI_MEM_CHUNK_COUNT, NA_OFI_MEM_BLOCK_COUNT,
+        na_init_info.use_huge_pages, na_ofi_mem_buf_register, NA_RECV,
+        na_ofi_mem_buf_deregister, (void *) na_ofi_class);
     NA_CHECK_SUBSYS_ERROR(cls, na_ofi_class->recv_pool == NULL, error, ret,
         NA_NOMEM,
         "Could not create memory pool with %d blocks of size %d x %zu bytes",
         NA_OFI_MEM_BLOCK_COUNT, NA_OFI_MEM_CHUNK_COUNT, pool_chunk_size);
+    rc = hg_mem_pool_set_thread_cache(
+        na_ofi_class->recv_pool, NA_OFI_MEM_CACHE_COUNT);
+    NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+        "Could not enable recv pool thread cache");
+    if (na_init_info.mem_budget != NULL) {
+        rc = hg_mem_pool_set_budget(
+            na_ofi_class->recv_pool, na_init_info.mem_budget);
+        NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret,
+            NA_NOMEM, "Could not charge recv pool to memory budget");
+    }
 #endif
 
 #ifdef NA_OFI_HAS_ADDR_POOL
@@ -6914,6 +10271,7 @@ na_ofi_initialize(
     NA_CHECK_SUBSYS_NA_ERROR(
         cls, error, ret, "Could not get endpoint src address");
 
+    na_ofi_class->na_class = na_class;
     na_class->plugin_class = (void *) na_ofi_class;
 
     na_ofi_free_hostname_info(
@@ -6965,6 +10323,21 @@ out:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_ofi_cleanup(void)
+{
+    struct na_ofi_getinfo_entry *entry;
+
+    /* Drop cached fi_getinfo() results */
+    hg_thread_mutex_lock(&na_ofi_getinfo_cache_mutex_g);
+    while ((entry = HG_LIST_FIRST(&na_ofi_getinfo_cache_g)) != NULL) {
+        HG_LIST_REMOVE(entry, entry);
+        na_ofi_getinfo_entry_free(entry);
+    }
+    hg_thread_mutex_unlock(&na_ofi_getinfo_cache_mutex_g);
+}
+
 /*---------------------------------------------------------------------------*/
 static bool
 na_ofi_has_opt_feature(na_class_t *na_class, unsigned long flags)
@@ -6972,6 +10345,35 @@ na_ofi_has_opt_feature(na_class_t *na_class, unsigned long flags)
     return flags & NA_OFI_CLASS(na_class)->opt_features;
 }
 
+/*---------------------------------------------------------------------------*/
+static int
+na_ofi_get_numa_node(na_class_t *na_class)
+{
+    const struct fi_info *fi_info = NA_OFI_CLASS(na_class)->fi_info;
+    const struct fi_pci_attr *pci;
+    char path[128];
+    int numa_node = -1;
+    FILE *file;
+
+    if (fi_info->nic == NULL || fi_info->nic->bus_attr == NULL ||
+        fi_info->nic->bus_attr->bus_type != FI_BUS_PCI)
+        return -1;
+    pci = &fi_info->nic->bus_attr->attr.pci;
+
+    /* Kernel reports -1 when the platform does not expose NUMA locality */
+    snprintf(path, sizeof(path),
+        "/sys/bus/pci/devices/%04x:%02x:%02x.%x/numa_node", pci->domain_id,
+        pci->bus_id, pci->device_id, pci->function_id);
+    file = fopen(path, "r");
+    if (file == NULL)
+        return -1;
+    if (fscanf(file, "%d", &numa_node) != 1)
+        numa_node = -1;
+    fclose(file);
+
+    return numa_node;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_context_create(na_class_t *na_class, void **context_p, uint8_t id)
@@ -6987,8 +10389,35 @@ na_ofi_context_create(na_class_t *na_class, void **context_p, uint8_t id)
         "Could not allocate na_ofi_context");
     na_ofi_context->idx = id;
 
-    /* If not using SEP, just point to class' endpoint */
-    if (!na_ofi_with_sep(na_ofi_class)) {
+    /* CQ read buffers sized for the max number of events read at once */
+    na_ofi_context->cq_event_num =
+        MIN(NA_OFI_CQ_EVENT_NUM, na_ofi_class->cq_event_max);
+    na_ofi_context->cq_events = (struct fi_cq_tagged_entry *) malloc(
+        na_ofi_class->cq_event_max * sizeof(*na_ofi_context->cq_events));
+    NA_CHECK_SUBSYS_ERROR(ctx, na_ofi_context->cq_events == NULL, error, ret,
+        NA_NOMEM, "Could not allocate CQ events");
+    na_ofi_context->cq_src_addrs = (fi_addr_t *) malloc(
+        na_ofi_class->cq_event_max * sizeof(*na_ofi_context->cq_src_addrs));
+    NA_CHECK_SUBSYS_ERROR(ctx, na_ofi_context->cq_src_addrs == NULL, error,
+        ret, NA_NOMEM, "Could not allocate CQ source addresses");
+
+    if (na_ofi_class->multi_ep && id > 0) {
+        /* Open a separate endpoint that shares the class domain and AV */
+        NA_CHECK_SUBSYS_ERROR(fatal, id >= na_ofi_class->context_max, error,
+            ret, NA_OPNOTSUPPORTED,
+            "context id %" PRIu8 ", max_contexts %" PRIu8, id,
+            na_ofi_class->context_max);
+
+        ret = na_ofi_context_ep_open(
+            na_ofi_class, id, &na_ofi_context->endpoint);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            ctx, error, ret, "Could not open context endpoint");
+
+        na_ofi_context->fi_tx = na_ofi_context->endpoint->fi_ep;
+        na_ofi_context->fi_rx = na_ofi_context->endpoint->fi_ep;
+        na_ofi_context->eq = na_ofi_context->endpoint->eq;
+    } else if (!na_ofi_with_sep(na_ofi_class)) {
+        /* If not using SEP, just point to class' endpoint */
         na_ofi_context->fi_tx = na_ofi_class->endpoint->fi_ep;
         na_ofi_context->fi_rx = na_ofi_class->endpoint->fi_ep;
         na_ofi_context->eq = na_ofi_class->endpoint->eq;
@@ -7038,12 +10467,32 @@ na_ofi_context_create(na_class_t *na_class, void **context_p, uint8_t id)
             "fi_enable() noc_rx failed, rc: %d (%s)", rc, fi_strerror(-rc));
     }
 
+    /* Counter pacing deferred RMA ops, only bumped by their completions */
+    if (na_ofi_class->deferred_rma_max > 0) {
+        struct fi_cntr_attr cntr_attr = {.events = FI_CNTR_EVENTS_COMP,
+            .wait_obj = FI_WAIT_NONE,
+            .wait_set = NULL,
+            .flags = 0};
+
+        rc = fi_cntr_open(na_ofi_class->domain->fi_domain, &cntr_attr,
+            &na_ofi_context->rma_cntr, NULL);
+        NA_CHECK_SUBSYS_ERROR(ctx, rc < 0, error, ret, na_ofi_errno_to_na(-rc),
+            "fi_cntr_open() failed, rc: %d (%s)", rc, fi_strerror(-rc));
+        hg_atomic_init64(&na_ofi_context->rma_posted, 0);
+    }
+
     /* Create queue for tracking multi-event ops */
     rc = hg_thread_spin_init(&na_ofi_context->multi_op_queue.lock);
     NA_CHECK_SUBSYS_ERROR_NORET(
         ctx, rc != HG_UTIL_SUCCESS, error, "hg_thread_spin_init() failed");
     HG_QUEUE_INIT(&na_ofi_context->multi_op_queue.queue);
 
+    /* Rings are only granted by listening classes */
+    if (na_ofi_class->ring_slot_num > 0 && na_ofi_class->ring_listen) {
+        ret = na_ofi_ring_rx_open(&na_ofi_context->ring_rx);
+        NA_CHECK_SUBSYS_NA_ERROR(ctx, error, ret, "Could not open rings");
+    }
+
     hg_atomic_incr32(&na_ofi_class->n_contexts);
 
     *context_p = (void *) na_ofi_context;
@@ -7052,7 +10501,9 @@ na_ofi_context_create(na_class_t *na_class, void **context_p, uint8_t id)
 
 error:
     if (na_ofi_context) {
-        if (na_ofi_with_sep(na_ofi_class)) {
+        if (na_ofi_context->endpoint)
+            (void) na_ofi_endpoint_close(na_ofi_context->endpoint);
+        else if (na_ofi_with_sep(na_ofi_class)) {
             if (na_ofi_context->fi_tx)
                 (void) fi_close(&na_ofi_context->fi_tx->fid);
             if (na_ofi_context->fi_rx)
@@ -7060,6 +10511,10 @@ error:
             if (na_ofi_context->eq)
                 (void) na_ofi_eq_close(na_ofi_context->eq);
         }
+        if (na_ofi_context->rma_cntr)
+            (void) fi_close(&na_ofi_context->rma_cntr->fid);
+        free(na_ofi_context->cq_events);
+        free(na_ofi_context->cq_src_addrs);
         free(na_ofi_context);
     }
     return ret;
@@ -7074,7 +10529,17 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    if (na_ofi_with_sep(na_ofi_class)) {
+    /* Bounce recvs must be reaped before the endpoint is closed */
+    if (na_ofi_context->ring_rx)
+        na_ofi_ring_rx_close(na_ofi_class, na_ofi_context);
+
+    if (na_ofi_context->endpoint) {
+        /* Also checks that retry op queue is empty */
+        ret = na_ofi_endpoint_close(na_ofi_context->endpoint);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            ctx, out, ret, "Could not close context endpoint");
+        na_ofi_context->endpoint = NULL;
+    } else if (na_ofi_with_sep(na_ofi_class)) {
         bool empty;
 
         /* Check that retry op queue is empty */
@@ -7107,7 +10572,17 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
         }
     }
 
+    if (na_ofi_context->rma_cntr) {
+        rc = fi_close(&na_ofi_context->rma_cntr->fid);
+        NA_CHECK_SUBSYS_ERROR(ctx, rc != 0, out, ret, na_ofi_errno_to_na(-rc),
+            "fi_close() RMA counter failed, rc: %d (%s)", rc,
+            fi_strerror(-rc));
+        na_ofi_context->rma_cntr = NULL;
+    }
+
     (void) hg_thread_spin_destroy(&na_ofi_context->multi_op_queue.lock);
+    free(na_ofi_context->cq_events);
+    free(na_ofi_context->cq_src_addrs);
     free(na_ofi_context);
     hg_atomic_decr32(&na_ofi_class->n_contexts);
 
@@ -7189,9 +10664,32 @@ na_ofi_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
             "Attempting to free OP ID that was not completed");
     }
 
+    free(na_ofi_op_id->rma_deferred);
     free(na_ofi_op_id);
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_op_reset(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+{
+    struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+
+    /* Multi-event op IDs keep a completion queue and are not pooled */
+    if (na_ofi_op_id->multi_event)
+        return NA_OPNOTSUPPORTED;
+
+    if (!(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED))
+        return NA_BUSY;
+
+    /* Addr ref was dropped on release, only clear stale user data */
+    na_ofi_op_id->context = NULL;
+    na_ofi_op_id->callback = NULL;
+    na_ofi_op_id->arg = NULL;
+    na_ofi_op_id->completion_data->callback_info.arg = NULL;
+
+    return NA_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p)
@@ -7224,6 +10722,9 @@ na_ofi_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p)
     NA_CHECK_SUBSYS_NA_ERROR(
         addr, error, ret, "Could not lookup address key for %s", name);
 
+    /* Names refer to base endpoints, contexts are routed from there */
+    na_ofi_addr->ep_base = true;
+
     *addr_p = (na_addr_t *) na_ofi_addr;
 
     return NA_SUCCESS;
@@ -7232,6 +10733,81 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_addr_lookup_batch(na_class_t *na_class, const char *const *names,
+    size_t count, na_addr_t **addrs)
+{
+    struct na_ofi_class *na_ofi_class = NA_OFI_CLASS(na_class);
+    struct na_ofi_addr_key *addr_keys = NULL;
+    int addr_format = (int) na_ofi_class->fi_info->addr_format;
+    struct na_ofi_addr **na_ofi_addrs = (struct na_ofi_addr **) addrs;
+    size_t i;
+    na_return_t ret;
+
+    /* String and OPX addresses cannot be packed, look them up one by one */
+    if (addr_format == FI_ADDR_STR || addr_format == FI_ADDR_OPX) {
+        for (i = 0; i < count; i++) {
+            ret = na_ofi_addr_lookup(na_class, names[i], &addrs[i]);
+            NA_CHECK_SUBSYS_NA_ERROR(addr, release, ret,
+                "Could not lookup address for %s", names[i]);
+        }
+        return NA_SUCCESS;
+    }
+
+    addr_keys = (struct na_ofi_addr_key *) malloc(count * sizeof(*addr_keys));
+    NA_CHECK_SUBSYS_ERROR(addr, addr_keys == NULL, error, ret, NA_NOMEM,
+        "Could not allocate %zu address keys", count);
+
+    for (i = 0; i < count; i++) {
+        /* Check provider from name */
+        NA_CHECK_SUBSYS_ERROR(fatal,
+            na_ofi_class->fabric->prov_type != NA_OFI_PROV_TCP &&
+                na_ofi_addr_prov(names[i]) != na_ofi_class->fabric->prov_type,
+            error, ret, NA_INVALID_ARG,
+            "Unrecognized provider type found from: %s", names[i]);
+
+        /* Convert name to raw address */
+        ret = na_ofi_str_to_raw_addr(names[i], addr_format, &addr_keys[i].addr);
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret,
+            "Could not convert string to address (%s)", names[i]);
+
+        /* Create key from addr for faster lookups */
+        addr_keys[i].val =
+            na_ofi_raw_addr_to_key(addr_format, &addr_keys[i].addr);
+        NA_CHECK_SUBSYS_ERROR(addr, addr_keys[i].val == 0, error, ret,
+            NA_PROTONOSUPPORT, "Could not generate key from addr (%s)",
+            names[i]);
+    }
+
+    /* Lookup keys and create new addrs with a single AV insertion */
+    i = count;
+    ret = na_ofi_addr_key_lookup_batch(
+        na_ofi_class, addr_keys, count, na_ofi_addrs);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, release, ret, "Could not lookup %zu address keys", count);
+
+    /* Names refer to base endpoints, contexts are routed from there */
+    for (i = 0; i < count; i++)
+        na_ofi_addrs[i]->ep_base = true;
+
+    free(addr_keys);
+
+    return NA_SUCCESS;
+
+release:
+    while (i-- > 0) {
+        if (na_ofi_addrs[i] == NULL)
+            continue;
+        na_ofi_addr_ref_decr(na_ofi_addrs[i]);
+        na_ofi_addrs[i] = NULL;
+    }
+error:
+    free(addr_keys);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_ofi_addr_free(na_class_t NA_UNUSED *na_class, na_addr_t *addr)
@@ -7387,6 +10963,9 @@ na_ofi_addr_deserialize(
     ret = na_ofi_addr_key_lookup(na_ofi_class, &addr_key, &na_ofi_addr);
     NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not lookup address key");
 
+    /* Serialized addresses refer to base endpoints */
+    na_ofi_addr->ep_base = true;
+
     *addr_p = (na_addr_t *) na_ofi_addr;
 
     return NA_SUCCESS;
@@ -7531,6 +11110,7 @@ na_ofi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
         (plugin_data) ? ((struct na_ofi_msg_buf_handle *) plugin_data)->fi_mr
                       : NULL;
     struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+    fi_addr_t fi_addr;
     na_return_t ret;
 
     /* Check op_id */
@@ -7544,13 +11124,45 @@ na_ofi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     NA_OFI_OP_RESET(na_ofi_op_id, context, FI_SEND, NA_CB_SEND_UNEXPECTED,
         callback, arg, na_ofi_addr);
 
+    ret = na_ofi_addr_route(na_ofi_addr, dest_id, &fi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        msg, release, ret, "Could not resolve remote context address");
+
+    /* Write directly into the target's ring once granted */
+    if (na_ofi_class->ring_slot_num > 0) {
+        bool written = false;
+
+        ret = na_ofi_ring_send(na_ofi_class, na_ofi_op_id, buf, buf_size,
+            dest_id, fi_addr, tag, &written);
+        NA_CHECK_SUBSYS_NA_ERROR(msg, release, ret, "Could not write to ring");
+        if (written)
+            return NA_SUCCESS;
+    }
+
     /* We assume buf remains valid (safe because we pre-allocate buffers) */
-    na_ofi_op_id->info.msg = (struct na_ofi_msg_info){.buf.const_ptr = buf,
-        .buf_size = buf_size,
-        .fi_addr =
-            fi_rx_addr(na_ofi_addr->fi_addr, dest_id, NA_OFI_SEP_RX_CTX_BITS),
-        .desc = (fi_mr) ? fi_mr_desc(fi_mr) : NULL,
-        .tag = (uint64_t) tag | NA_OFI_UNEXPECTED_TAG};
+    if (buf_size > na_ofi_class->rdv_threshold &&
+        na_ofi_class->msg_send_unexpected == na_ofi_tag_send) {
+        ret = na_ofi_rdv_rts_init(na_class, na_ofi_context, na_ofi_op_id, buf,
+            buf_size, na_ofi_msg_get_unexpected_header_size(na_class), fi_addr,
+            (uint64_t) tag | NA_OFI_UNEXPECTED_TAG);
+        NA_CHECK_SUBSYS_NA_ERROR(msg, release, ret, "Could not prepare RTS");
+    } else
+        na_ofi_op_id->info.msg = (struct na_ofi_msg_info){.buf.const_ptr = buf,
+            .buf_size = buf_size,
+            .fi_addr = fi_addr,
+            .desc = (fi_mr) ? fi_mr_desc(fi_mr) : NULL,
+            .tag = (uint64_t) tag | NA_OFI_UNEXPECTED_TAG};
+
+    /* Small msgs are buffered by the provider and skip the CQ */
+    if (buf_size <= na_ofi_class->inject_size &&
+        buf_size <= na_ofi_class->rdv_threshold) {
+        ret = na_ofi_msg_send_inject(na_ofi_context, na_ofi_op_id,
+            na_ofi_class->msg_send_unexpected == na_ofi_tag_send);
+        if (ret != NA_AGAIN) {
+            NA_CHECK_SUBSYS_NA_ERROR(msg, release, ret, "Could not inject msg");
+            return NA_SUCCESS;
+        }
+    }
 
     /* OPX requires context2 to pass persistent address down to provider */
     if ((int) na_ofi_class->fi_info->addr_format == FI_ADDR_OPX)
@@ -7607,7 +11219,14 @@ na_ofi_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
         .fi_addr = FI_ADDR_UNSPEC,
         .desc = (fi_mr) ? fi_mr_desc(fi_mr) : NULL,
         .tag = NA_OFI_UNEXPECTED_TAG,
-        .tag_mask = NA_OFI_TAG_MASK};
+        .tag_mask = NA_OFI_TAG_MASK | NA_OFI_RDV_TAG};
+
+    /* Unexpected msgs are received through bounce buffers and rings */
+    if (na_ofi_context->ring_rx != NULL) {
+        ret = na_ofi_ring_recv_unexpected(na_ofi_class, context, na_ofi_op_id);
+        NA_CHECK_SUBSYS_NA_ERROR(msg, release, ret, "Could not post ring recv");
+        return NA_SUCCESS;
+    }
 
     ret = na_ofi_class->msg_recv_unexpected(
         na_ofi_context->fi_rx, &na_ofi_op_id->info.msg, &na_ofi_op_id->fi_ctx);
@@ -7709,6 +11328,7 @@ na_ofi_msg_send_expected(na_class_t *na_class, na_context_t *context,
         (plugin_data) ? ((struct na_ofi_msg_buf_handle *) plugin_data)->fi_mr
                       : NULL;
     struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+    fi_addr_t fi_addr;
     na_return_t ret;
 
     /* Check op_id */
@@ -7722,13 +11342,31 @@ na_ofi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     NA_OFI_OP_RESET(na_ofi_op_id, context, FI_SEND, NA_CB_SEND_EXPECTED,
         callback, arg, na_ofi_addr);
 
+    ret = na_ofi_addr_route(na_ofi_addr, dest_id, &fi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        msg, release, ret, "Could not resolve remote context address");
+
     /* We assume buf remains valid (safe because we pre-allocate buffers) */
-    na_ofi_op_id->info.msg = (struct na_ofi_msg_info){.buf.const_ptr = buf,
-        .buf_size = buf_size,
-        .fi_addr =
-            fi_rx_addr(na_ofi_addr->fi_addr, dest_id, NA_OFI_SEP_RX_CTX_BITS),
-        .desc = (fi_mr) ? fi_mr_desc(fi_mr) : NULL,
-        .tag = tag};
+    if (buf_size > na_ofi_class->rdv_threshold) {
+        ret = na_ofi_rdv_rts_init(na_class, na_ofi_context, na_ofi_op_id, buf,
+            buf_size, 0, fi_addr, tag);
+        NA_CHECK_SUBSYS_NA_ERROR(msg, release, ret, "Could not prepare RTS");
+    } else
+        na_ofi_op_id->info.msg = (struct na_ofi_msg_info){.buf.const_ptr = buf,
+            .buf_size = buf_size,
+            .fi_addr = fi_addr,
+            .desc = (fi_mr) ? fi_mr_desc(fi_mr) : NULL,
+            .tag = tag};
+
+    /* Small msgs are buffered by the provider and skip the CQ */
+    if (buf_size <= na_ofi_class->inject_size &&
+        buf_size <= na_ofi_class->rdv_threshold) {
+        ret = na_ofi_msg_send_inject(na_ofi_context, na_ofi_op_id, true);
+        if (ret != NA_AGAIN) {
+            NA_CHECK_SUBSYS_NA_ERROR(msg, release, ret, "Could not inject msg");
+            return NA_SUCCESS;
+        }
+    }
 
     /* OPX requires context2 to pass persistent address down to provider */
     if ((int) na_ofi_class->fi_info->addr_format == FI_ADDR_OPX)
@@ -7767,6 +11405,7 @@ na_ofi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
         (plugin_data) ? ((struct na_ofi_msg_buf_handle *) plugin_data)->fi_mr
                       : NULL;
     struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+    fi_addr_t fi_addr;
     na_return_t ret;
 
     /* Check op_id */
@@ -7780,13 +11419,18 @@ na_ofi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     NA_OFI_OP_RESET(na_ofi_op_id, context, FI_RECV, NA_CB_RECV_EXPECTED,
         callback, arg, na_ofi_addr);
 
-    /* We assume buf remains valid (safe because we pre-allocate buffers) */
+    ret = na_ofi_addr_route(na_ofi_addr, source_id, &fi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        msg, release, ret, "Could not resolve remote context address");
+
+    /* We assume buf remains valid (safe because we pre-allocate buffers),
+     * RTS of rendezvous sends also match */
     na_ofi_op_id->info.msg = (struct na_ofi_msg_info){.buf.ptr = buf,
         .buf_size = buf_size,
-        .fi_addr =
-            fi_rx_addr(na_ofi_addr->fi_addr, source_id, NA_OFI_SEP_RX_CTX_BITS),
+        .fi_addr = fi_addr,
         .desc = (fi_mr) ? fi_mr_desc(fi_mr) : NULL,
-        .tag = tag};
+        .tag = tag,
+        .tag_mask = NA_OFI_RDV_TAG};
 
     ret = na_ofi_tag_recv(
         na_ofi_context->fi_rx, &na_ofi_op_id->info.msg, &na_ofi_op_id->fi_ctx);
@@ -7808,6 +11452,115 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_msg_send_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+    size_t count, size_t *posted_count_p)
+{
+    struct na_ofi_class *na_ofi_class = NA_OFI_CLASS(na_class);
+    struct na_ofi_context *na_ofi_context = NA_OFI_CONTEXT(context);
+    bool expected = (cb_type == NA_CB_SEND_EXPECTED);
+    bool tagged = expected || (na_ofi_class->msg_send_unexpected ==
+                                  na_ofi_tag_send);
+    size_t i;
+    na_return_t ret = NA_SUCCESS;
+
+    for (i = 0; i < count; i++) {
+        const struct na_msg_send_info *send_info = &send_infos[i];
+        struct na_ofi_addr *na_ofi_addr =
+            (struct na_ofi_addr *) send_info->dest_addr;
+        struct fid_mr *fi_mr =
+            (send_info->plugin_data)
+                ? ((struct na_ofi_msg_buf_handle *) send_info->plugin_data)
+                      ->fi_mr
+                : NULL;
+        struct na_ofi_op_id *na_ofi_op_id =
+            (struct na_ofi_op_id *) send_info->op_id;
+        /* Let the provider defer submission until the last entry */
+        uint64_t flags = (i + 1 < count) ? FI_MORE : 0;
+        fi_addr_t fi_addr;
+
+        /* Rendezvous sends are posted individually */
+        if (tagged && send_info->buf_size > na_ofi_class->rdv_threshold) {
+            ret = (expected)
+                      ? na_ofi_msg_send_expected(na_class, context,
+                            send_info->callback, send_info->arg,
+                            send_info->buf, send_info->buf_size,
+                            send_info->plugin_data, send_info->dest_addr,
+                            send_info->dest_id, send_info->tag,
+                            send_info->op_id)
+                      : na_ofi_msg_send_unexpected(na_class, context,
+                            send_info->callback, send_info->arg,
+                            send_info->buf, send_info->buf_size,
+                            send_info->plugin_data, send_info->dest_addr,
+                            send_info->dest_id, send_info->tag,
+                            send_info->op_id);
+            if (ret != NA_SUCCESS)
+                goto done;
+            continue;
+        }
+
+        /* Check op_id */
+        NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, done, ret,
+            NA_INVALID_ARG, "Invalid operation ID");
+        NA_CHECK_SUBSYS_ERROR(op,
+            !(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED),
+            done, ret, NA_BUSY,
+            "Attempting to use OP ID that was not completed (%s)",
+            na_cb_type_to_string(na_ofi_op_id->type));
+
+        NA_OFI_OP_RESET(na_ofi_op_id, context, FI_SEND, cb_type,
+            send_info->callback, send_info->arg, na_ofi_addr);
+
+        ret = na_ofi_addr_route(na_ofi_addr, send_info->dest_id, &fi_addr);
+        if (ret != NA_SUCCESS) {
+            NA_OFI_OP_RELEASE(na_ofi_op_id);
+            NA_GOTO_SUBSYS_ERROR_NORET(
+                msg, done, "Could not resolve remote context address");
+        }
+
+        /* We assume buf remains valid (safe because we pre-allocate buffers) */
+        na_ofi_op_id->info.msg =
+            (struct na_ofi_msg_info){.buf.const_ptr = send_info->buf,
+                .buf_size = send_info->buf_size,
+                .fi_addr = fi_addr,
+                .desc = (fi_mr) ? fi_mr_desc(fi_mr) : NULL,
+                .tag = (expected)
+                           ? (uint64_t) send_info->tag
+                           : (uint64_t) send_info->tag | NA_OFI_UNEXPECTED_TAG};
+
+        /* OPX requires context2 to pass persistent address down to provider */
+        if ((int) na_ofi_class->fi_info->addr_format == FI_ADDR_OPX)
+            na_ofi_op_id->fi_ctx[0].internal[0] =
+                &na_ofi_addr->addr_key.addr.opx;
+
+        ret = (tagged) ? na_ofi_tag_sendmsg(na_ofi_context->fi_tx,
+                             &na_ofi_op_id->info.msg, &na_ofi_op_id->fi_ctx,
+                             flags)
+                       : na_ofi_msg_sendmsg(na_ofi_context->fi_tx,
+                             &na_ofi_op_id->info.msg, &na_ofi_op_id->fi_ctx,
+                             flags);
+        if (ret == NA_AGAIN) {
+            if (expected)
+                na_ofi_op_id->retry_op.msg = na_ofi_tag_send;
+            else
+                na_ofi_op_id->retry_op.msg = na_ofi_class->msg_send_unexpected;
+            na_ofi_op_retry(
+                na_ofi_context, na_ofi_class->op_retry_timeout, na_ofi_op_id);
+            ret = NA_SUCCESS;
+        } else if (ret != NA_SUCCESS) {
+            NA_OFI_OP_RELEASE(na_ofi_op_id);
+            NA_GOTO_SUBSYS_ERROR_NORET(msg, done, "Could not post msg send");
+        }
+    }
+
+done:
+    *posted_count_p = i;
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_mem_handle_create(na_class_t NA_UNUSED *na_class, void *buf,
@@ -7931,6 +11684,7 @@ na_ofi_mem_register(na_class_t *na_class, na_mem_handle_t *mem_handle,
     struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
     const struct fi_info *fi_info = NA_OFI_CLASS(na_class)->fi_info;
     int32_t mr_cnt = hg_atomic_get32(domain->mr_reg_count);
+    struct na_ofi_mr_cache_key mr_cache_key = {0};
     struct fi_mr_attr fi_mr_attr = {
         .mr_iov = NA_OFI_IOV(
             na_ofi_mem_handle->desc.iov, na_ofi_mem_handle->desc.info.iovcnt),
@@ -7992,6 +11746,26 @@ na_ofi_mem_register(na_class_t *na_class, na_mem_handle_t *mem_handle,
         error, ret, NA_OPNOTSUPPORTED,
         "selected provider does not support device registration");
 
+    /* Reuse existing registration of the same region if any, MRs that must
+     * be bound to an endpoint are not shared */
+    if (domain->mr_cache != NULL && fi_mr_attr.iov_count == 1 &&
+        !(fi_info->domain_attr->mr_mode & FI_MR_ENDPOINT)) {
+        mr_cache_key = (struct na_ofi_mr_cache_key){
+            .base = fi_mr_attr.mr_iov[0].iov_base,
+            .len = fi_mr_attr.mr_iov[0].iov_len,
+            .access = fi_mr_attr.access,
+            .device = device,
+            .iface = (int) fi_mr_attr.iface};
+
+        na_ofi_mem_handle->mr_cache_entry =
+            na_ofi_mr_cache_get(domain->mr_cache, &mr_cache_key);
+        if (na_ofi_mem_handle->mr_cache_entry != NULL) {
+            na_ofi_mem_handle->fi_mr =
+                na_ofi_mem_handle->mr_cache_entry->fi_mr;
+            goto done;
+        }
+    }
+
     /* Let the provider provide its own key otherwise generate our own */
     fi_mr_attr.requested_key = (fi_info->domain_attr->mr_mode & FI_MR_PROV_KEY)
                                    ? 0
@@ -8018,6 +11792,25 @@ na_ofi_mem_register(na_class_t *na_class, na_mem_handle_t *mem_handle,
             "fi_mr_enable() failed, rc: %d (%s)", rc, fi_strerror(-rc));
     }
 
+    /* Add new registration to cache */
+    if (domain->mr_cache != NULL && fi_mr_attr.iov_count == 1 &&
+        !(fi_info->domain_attr->mr_mode & FI_MR_ENDPOINT)) {
+        struct na_ofi_mr_cache_entry *entry = NULL;
+
+        ret = na_ofi_mr_cache_add(domain->mr_cache, &mr_cache_key,
+            na_ofi_mem_handle->fi_mr, &entry);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not add MR to cache");
+
+        /* Region was registered concurrently, use that MR instead */
+        if (entry->fi_mr != na_ofi_mem_handle->fi_mr) {
+            (void) fi_close(&na_ofi_mem_handle->fi_mr->fid);
+            hg_atomic_decr32(domain->mr_reg_count);
+            na_ofi_mem_handle->fi_mr = entry->fi_mr;
+        }
+        na_ofi_mem_handle->mr_cache_entry = entry;
+    }
+
+done:
     /* Retrieve key */
     na_ofi_mem_handle->desc.info.fi_mr_key =
         fi_mr_key(na_ofi_mem_handle->fi_mr);
@@ -8028,6 +11821,7 @@ error:
     if (na_ofi_mem_handle->fi_mr) {
         (void) fi_close(&na_ofi_mem_handle->fi_mr->fid);
         hg_atomic_decr32(domain->mr_reg_count);
+        na_ofi_mem_handle->fi_mr = NULL;
     }
     return ret;
 }
@@ -8039,12 +11833,21 @@ na_ofi_mem_deregister(na_class_t *na_class, na_mem_handle_t *mem_handle)
     struct na_ofi_domain *domain = NA_OFI_CLASS(na_class)->domain;
     struct na_ofi_mem_handle *na_ofi_mem_handle =
         (struct na_ofi_mem_handle *) mem_handle;
+    struct fid_mr *fi_mr = na_ofi_mem_handle->fi_mr;
     na_return_t ret;
     int rc;
 
+    /* Release shared registration, MR is only closed once unused and evicted */
+    if (na_ofi_mem_handle->mr_cache_entry != NULL) {
+        fi_mr = na_ofi_mr_cache_release(
+            domain->mr_cache, na_ofi_mem_handle->mr_cache_entry);
+        na_ofi_mem_handle->mr_cache_entry = NULL;
+        na_ofi_mem_handle->fi_mr = NULL;
+    }
+
     /* close MR handle */
-    if (na_ofi_mem_handle->fi_mr != NULL) {
-        rc = fi_close(&na_ofi_mem_handle->fi_mr->fid);
+    if (fi_mr != NULL) {
+        rc = fi_close(&fi_mr->fid);
         NA_CHECK_SUBSYS_ERROR(mem, rc != 0, error, ret, na_ofi_errno_to_na(-rc),
             "fi_close() mr_hdl failed, rc: %d (%s)", rc, fi_strerror(-rc));
         hg_atomic_decr32(domain->mr_reg_count);
@@ -8063,9 +11866,13 @@ na_ofi_mem_handle_get_serialize_size(
 {
     struct na_ofi_mem_handle *na_ofi_mem_handle =
         (struct na_ofi_mem_handle *) mem_handle;
+    const struct na_ofi_mem_desc_info *info = &na_ofi_mem_handle->desc.info;
 
-    return sizeof(na_ofi_mem_handle->desc.info) +
-           na_ofi_mem_handle->desc.info.iovcnt * sizeof(struct iovec);
+    return na_varint_get_serialize_size(info->fi_mr_key) +
+           na_varint_get_serialize_size(info->iovcnt) + sizeof(info->flags) +
+           na_iov_get_serialize_size(
+               NA_OFI_IOV(na_ofi_mem_handle->desc.iov, info->iovcnt),
+               (unsigned long) info->iovcnt);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -8075,19 +11882,26 @@ na_ofi_mem_handle_serialize(na_class_t NA_UNUSED *na_class, void *buf,
 {
     struct na_ofi_mem_handle *na_ofi_mem_handle =
         (struct na_ofi_mem_handle *) mem_handle;
-    const struct iovec *iov = NA_OFI_IOV(
-        na_ofi_mem_handle->desc.iov, na_ofi_mem_handle->desc.info.iovcnt);
+    const struct na_ofi_mem_desc_info *info = &na_ofi_mem_handle->desc.info;
+    const struct iovec *iov =
+        NA_OFI_IOV(na_ofi_mem_handle->desc.iov, info->iovcnt);
     char *buf_ptr = (char *) buf;
     size_t buf_size_left = buf_size;
     na_return_t ret;
 
-    /* Descriptor info */
-    NA_ENCODE(error, ret, buf_ptr, buf_size_left, &na_ofi_mem_handle->desc.info,
-        struct na_ofi_mem_desc_info);
+    /* Descriptor info (total length is recomputed from segments) */
+    ret = na_varint_serialize(&buf_ptr, &buf_size_left, info->fi_mr_key);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not encode MR key");
 
-    /* IOV */
-    NA_ENCODE_ARRAY(error, ret, buf_ptr, buf_size_left, iov, const struct iovec,
-        na_ofi_mem_handle->desc.info.iovcnt);
+    ret = na_varint_serialize(&buf_ptr, &buf_size_left, info->iovcnt);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not encode iovcnt");
+
+    NA_ENCODE(error, ret, buf_ptr, buf_size_left, &info->flags, uint8_t);
+
+    /* IOV (delta-encoded bases, varint lengths) */
+    ret = na_iov_serialize(
+        &buf_ptr, &buf_size_left, iov, (unsigned long) info->iovcnt);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not encode segments");
 
     return NA_SUCCESS;
 
@@ -8104,6 +11918,8 @@ na_ofi_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
     const char *buf_ptr = (const char *) buf;
     size_t buf_size_left = buf_size;
     struct iovec *iov = NULL;
+    uint64_t iovcnt;
+    size_t len;
     na_return_t ret;
 
     na_ofi_mem_handle =
@@ -8112,26 +11928,40 @@ na_ofi_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
         "Could not allocate NA OFI memory handle");
     na_ofi_mem_handle->desc.iov.d = NULL;
     na_ofi_mem_handle->fi_mr = NULL;
+    na_ofi_mem_handle->mr_cache_entry = NULL;
     na_ofi_mem_handle->desc.info.iovcnt = 0;
 
     /* Descriptor info */
-    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_ofi_mem_handle->desc.info,
-        struct na_ofi_mem_desc_info);
+    ret = na_varint_deserialize(
+        &buf_ptr, &buf_size_left, &na_ofi_mem_handle->desc.info.fi_mr_key);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode MR key");
+
+    ret = na_varint_deserialize(&buf_ptr, &buf_size_left, &iovcnt);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode iovcnt");
+
+    NA_DECODE(error, ret, buf_ptr, buf_size_left,
+        &na_ofi_mem_handle->desc.info.flags, uint8_t);
 
     /* IOV */
-    if (na_ofi_mem_handle->desc.info.iovcnt > NA_OFI_IOV_STATIC_MAX) {
+    if (iovcnt > NA_OFI_IOV_STATIC_MAX) {
+        NA_CHECK_SUBSYS_ERROR(mem, iovcnt > buf_size_left / 2, error, ret,
+            NA_OVERFLOW, "Invalid segment count (%" PRIu64 ")", iovcnt);
+
         /* Allocate IOV */
-        na_ofi_mem_handle->desc.iov.d = (struct iovec *) malloc(
-            na_ofi_mem_handle->desc.info.iovcnt * sizeof(struct iovec));
+        na_ofi_mem_handle->desc.iov.d =
+            (struct iovec *) malloc((size_t) iovcnt * sizeof(struct iovec));
         NA_CHECK_SUBSYS_ERROR(mem, na_ofi_mem_handle->desc.iov.d == NULL, error,
             ret, NA_NOMEM, "Could not allocate segment array");
 
         iov = na_ofi_mem_handle->desc.iov.d;
     } else
         iov = na_ofi_mem_handle->desc.iov.s;
+    na_ofi_mem_handle->desc.info.iovcnt = iovcnt;
 
-    NA_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left, iov, struct iovec,
-        na_ofi_mem_handle->desc.info.iovcnt);
+    ret = na_iov_deserialize(
+        &buf_ptr, &buf_size_left, iov, (unsigned long) iovcnt, &len);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode segments");
+    na_ofi_mem_handle->desc.info.len = (uint64_t) len;
 
     *mem_handle_p = (na_mem_handle_t *) na_ofi_mem_handle;
 
@@ -8177,6 +12007,242 @@ na_ofi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         (struct na_ofi_op_id *) op_id);
 }
 
+/*---------------------------------------------------------------------------*/
+static size_t
+na_ofi_rma_batch_get_max_segments(const na_class_t *na_class)
+{
+    const struct na_ofi_class *na_ofi_class = NA_OFI_CLASS(na_class);
+    const struct fi_tx_attr *tx_attr = na_ofi_class->fi_info->tx_attr;
+
+    /* Deferred ops are triggered one by one from the context counter */
+    if (na_ofi_class->deferred_rma_max > 0)
+        return 0;
+
+    return MIN(tx_attr->iov_limit, tx_attr->rma_iov_limit);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_rma_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg,
+    const struct na_rma_segment *segments, size_t count,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id)
+{
+    struct na_ofi_class *na_ofi_class = NA_OFI_CLASS(na_class);
+    struct na_ofi_context *na_ofi_context = NA_OFI_CONTEXT(context);
+    struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+    size_t max_iovcnt = na_ofi_rma_batch_get_max_segments(na_class),
+           local_iovcnt = 0, remote_iovcnt = 0;
+    struct na_ofi_rma_info *rma_info;
+    size_t i;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_ofi_op_id->type));
+    NA_CHECK_SUBSYS_ERROR(rma, max_iovcnt == 0, error, ret, NA_OPNOTSUPPORTED,
+        "Batched RMA operations not supported with deferred RMA ops");
+
+    /* All segments are posted as a single RMA msg, check that they fit */
+    for (i = 0; i < count; i++) {
+        size_t iov_start_index;
+        na_offset_t iov_start_offset;
+
+        local_iovcnt += na_ofi_mem_handle_iov_range(
+            (struct na_ofi_mem_handle *) segments[i].local_mem_handle,
+            segments[i].local_offset, segments[i].length, &iov_start_index,
+            &iov_start_offset);
+        remote_iovcnt += na_ofi_mem_handle_iov_range(
+            (struct na_ofi_mem_handle *) segments[i].remote_mem_handle,
+            segments[i].remote_offset, segments[i].length, &iov_start_index,
+            &iov_start_offset);
+    }
+    NA_CHECK_SUBSYS_ERROR(rma,
+        local_iovcnt > max_iovcnt || remote_iovcnt > max_iovcnt, error, ret,
+        NA_OVERFLOW,
+        "RMA batch exceeds IOV limit (local_iovcnt=%zu, remote_iovcnt=%zu, "
+        "max=%zu)",
+        local_iovcnt, remote_iovcnt, max_iovcnt);
+
+    NA_OFI_OP_RESET(na_ofi_op_id, context, FI_RMA, cb_type, callback, arg,
+        (struct na_ofi_addr *) remote_addr);
+
+    /* Set RMA info */
+    rma_info = &na_ofi_op_id->info.rma;
+    if (cb_type == NA_CB_PUT) {
+        rma_info->fi_rma_op = fi_writemsg;
+        rma_info->fi_rma_op_string = "fi_writemsg";
+        rma_info->fi_rma_flags = FI_COMPLETION | FI_DELIVERY_COMPLETE;
+    } else {
+        rma_info->fi_rma_op = fi_readmsg;
+        rma_info->fi_rma_op_string = "fi_readmsg";
+        rma_info->fi_rma_flags = FI_COMPLETION;
+    }
+    rma_info->deferred = NULL;
+    rma_info->remote_cq_data = 0;
+    rma_info->local_iovcnt = local_iovcnt;
+    rma_info->remote_iovcnt = remote_iovcnt;
+
+    ret = na_ofi_rma_iov_alloc(rma_info);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "Could not allocate RMA IOVs");
+
+    /* Each entry carries the desc / key of its own segment */
+    for (i = 0, local_iovcnt = 0, remote_iovcnt = 0; i < count; i++) {
+        struct na_ofi_mem_handle *local_handle =
+            (struct na_ofi_mem_handle *) segments[i].local_mem_handle;
+        struct na_ofi_mem_handle *remote_handle =
+            (struct na_ofi_mem_handle *) segments[i].remote_mem_handle;
+        size_t local_handle_iovcnt = (size_t) local_handle->desc.info.iovcnt,
+               remote_handle_iovcnt = (size_t) remote_handle->desc.info.iovcnt;
+        size_t iov_start_index, seg_iovcnt;
+        na_offset_t iov_start_offset;
+
+        seg_iovcnt = na_ofi_mem_handle_iov_range(local_handle,
+            segments[i].local_offset, segments[i].length, &iov_start_index,
+            &iov_start_offset);
+        na_ofi_iov_translate(
+            NA_OFI_IOV(local_handle->desc.iov, local_handle_iovcnt),
+            fi_mr_desc(local_handle->fi_mr), local_handle_iovcnt,
+            iov_start_index, iov_start_offset, segments[i].length,
+            rma_info->local_iov + local_iovcnt,
+            rma_info->local_desc + local_iovcnt, seg_iovcnt);
+        local_iovcnt += seg_iovcnt;
+
+        seg_iovcnt = na_ofi_mem_handle_iov_range(remote_handle,
+            segments[i].remote_offset, segments[i].length, &iov_start_index,
+            &iov_start_offset);
+        na_ofi_rma_iov_translate(na_ofi_class->fi_info,
+            NA_OFI_IOV(remote_handle->desc.iov, remote_handle_iovcnt),
+            remote_handle_iovcnt, remote_handle->desc.info.fi_mr_key,
+            iov_start_index, iov_start_offset, segments[i].length,
+            rma_info->remote_iov + remote_iovcnt, seg_iovcnt);
+        remote_iovcnt += seg_iovcnt;
+    }
+
+    ret = na_ofi_addr_route((struct na_ofi_addr *) remote_addr, remote_id,
+        &rma_info->fi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        rma, release, ret, "Could not resolve remote context address");
+
+    /* Post the OFI RMA operation */
+    ret = na_ofi_rma_post(
+        na_ofi_context->fi_tx, rma_info, &na_ofi_op_id->fi_ctx);
+    if (ret != NA_SUCCESS) {
+        if (ret == NA_AGAIN) {
+            na_ofi_op_id->retry_op.rma = na_ofi_rma_post;
+            na_ofi_op_retry(
+                na_ofi_context, na_ofi_class->op_retry_timeout, na_ofi_op_id);
+        } else
+            NA_GOTO_SUBSYS_ERROR_NORET(rma, release, "Could not post RMA op");
+    }
+
+    return NA_SUCCESS;
+
+release:
+    na_ofi_rma_release(rma_info);
+
+    NA_OFI_OP_RELEASE(na_ofi_op_id);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ofi_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id)
+{
+    struct na_ofi_class *na_ofi_class = NA_OFI_CLASS(na_class);
+    struct na_ofi_context *na_ofi_context = NA_OFI_CONTEXT(context);
+    struct na_ofi_op_id *na_ofi_op_id = (struct na_ofi_op_id *) op_id;
+    struct na_ofi_mem_handle *na_ofi_mem_handle_remote =
+        (struct na_ofi_mem_handle *) remote_mem_handle;
+    size_t remote_iovcnt = (size_t) na_ofi_mem_handle_remote->desc.info.iovcnt;
+    struct iovec *remote_iov =
+        NA_OFI_IOV(na_ofi_mem_handle_remote->desc.iov, remote_iovcnt);
+    size_t remote_iov_start_index = 0;
+    na_offset_t remote_iov_start_offset = 0;
+    struct na_ofi_atomic_info *atomic_info;
+    struct fi_rma_iov fi_rma_iov;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(rma,
+        !(na_ofi_class->opt_features & NA_OPT_ATOMIC), error, ret,
+        NA_OPNOTSUPPORTED, "Atomics are not supported by provider");
+    NA_CHECK_SUBSYS_ERROR(rma,
+        na_ofi_mem_handle_remote->desc.info.flags != NA_MEM_READWRITE, error,
+        ret, NA_PERMISSION,
+        "Registered memory requires read/write permission");
+    NA_CHECK_SUBSYS_ERROR(rma,
+        remote_offset + sizeof(uint64_t) >
+            na_ofi_mem_handle_remote->desc.info.len,
+        error, ret, NA_OVERFLOW, "Remote offset (%" PRIu64 ") out of bounds",
+        remote_offset);
+
+    NA_CHECK_SUBSYS_ERROR(op, na_ofi_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_ofi_op_id->type));
+
+    /* Translate remote offset, operand must not span segments */
+    if (remote_offset > 0)
+        na_ofi_iov_get_index_offset(remote_iov, remote_iovcnt, remote_offset,
+            &remote_iov_start_index, &remote_iov_start_offset);
+    NA_CHECK_SUBSYS_ERROR(rma,
+        remote_iov[remote_iov_start_index].iov_len - remote_iov_start_offset <
+            sizeof(uint64_t),
+        error, ret, NA_INVALID_ARG, "Remote operand spans segments");
+
+    na_ofi_rma_iov_translate(na_ofi_class->fi_info, remote_iov, remote_iovcnt,
+        na_ofi_mem_handle_remote->desc.info.fi_mr_key, remote_iov_start_index,
+        remote_iov_start_offset, sizeof(uint64_t), &fi_rma_iov, 1);
+
+    NA_OFI_OP_RESET(na_ofi_op_id, context, FI_ATOMIC, NA_CB_ATOMIC, callback,
+        arg, (struct na_ofi_addr *) remote_addr);
+
+    /* Set atomic info */
+    atomic_info = &na_ofi_op_id->info.atomic;
+    atomic_info->fi_atomic_op = (op == NA_ATOMIC_CAS) ? FI_CSWAP : FI_SUM;
+    atomic_info->remote_addr = fi_rma_iov.addr;
+    atomic_info->remote_key = fi_rma_iov.key;
+    atomic_info->operand = operand;
+    atomic_info->compare = compare;
+    atomic_info->result = 0;
+
+    ret = na_ofi_addr_route((struct na_ofi_addr *) remote_addr, remote_id,
+        &atomic_info->fi_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        rma, release, ret, "Could not resolve remote context address");
+
+    /* Post the OFI atomic operation */
+    ret = na_ofi_atomic_post(
+        na_ofi_context->fi_tx, atomic_info, &na_ofi_op_id->fi_ctx);
+    if (ret != NA_SUCCESS) {
+        if (ret == NA_AGAIN) {
+            na_ofi_op_id->retry_op.atomic = na_ofi_atomic_post;
+            na_ofi_op_retry(
+                na_ofi_context, na_ofi_class->op_retry_timeout, na_ofi_op_id);
+        } else
+            NA_GOTO_SUBSYS_ERROR_NORET(
+                rma, release, "Could not post atomic op");
+    }
+
+    return NA_SUCCESS;
+
+release:
+    NA_OFI_OP_RELEASE(na_ofi_op_id);
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE int
 na_ofi_poll_get_fd(na_class_t *na_class, na_context_t *context)
@@ -8255,7 +12321,7 @@ na_ofi_progress(
     deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
 
     do {
-        size_t actual_count = 0;
+        size_t max_count = na_ofi_context->cq_event_num, actual_count = 0;
 
         if (timeout_ms != 0 && na_ofi_context->eq->fi_wait != NULL) {
             /* Wait in wait set if provider does not support wait on FDs */
@@ -8274,8 +12340,9 @@ na_ofi_progress(
                 fi_strerror(-rc));
         }
 
-        /* If we can't hold more than NA_OFI_CQ_EVENT_NUM entries do not attempt
-         * to read from CQ until NA_Trigger() has been called */
+        /* Do not read more entries than multi-event ops can hold and do not
+         * attempt to read from CQ until NA_Trigger() has been called if we
+         * can't hold more than NA_OFI_CQ_EVENT_NUM entries */
         if (hg_atomic_get32(&na_ofi_context->multi_op_count) > 0) {
             struct na_ofi_op_id *na_ofi_op_id;
 
@@ -8288,15 +12355,32 @@ na_ofi_progress(
                     hg_thread_spin_unlock(&na_ofi_context->multi_op_queue.lock);
                     return NA_SUCCESS;
                 }
+                max_count = MIN(max_count, NA_OFI_OP_MULTI_CQ_SIZE - count);
             }
             hg_thread_spin_unlock(&na_ofi_context->multi_op_queue.lock);
         }
 
         /* Read from CQ and process events */
-        ret =
-            na_ofi_class->cq_poll(na_ofi_class, na_ofi_context, &actual_count);
+        ret = na_ofi_class->cq_poll(
+            na_ofi_class, na_ofi_context, max_count, &actual_count);
         NA_CHECK_SUBSYS_NA_ERROR(poll, error, ret, "Could not poll context CQ");
 
+        /* Grow read batch while CQ returns full batches, shrink it back when
+         * mostly idle */
+        if (actual_count == na_ofi_context->cq_event_num &&
+            na_ofi_context->cq_event_num < na_ofi_class->cq_event_max)
+            na_ofi_context->cq_event_num = MIN(
+                na_ofi_context->cq_event_num * 2, na_ofi_class->cq_event_max);
+        else if (actual_count < na_ofi_context->cq_event_num / 4 &&
+                 na_ofi_context->cq_event_num > NA_OFI_CQ_EVENT_NUM)
+            na_ofi_context->cq_event_num /= 2;
+
+        if (actual_count > 0) {
+            hg_atomic_incr64(na_ofi_class->cq_read_count);
+            hg_atomic_add64(
+                na_ofi_class->cq_event_count, (int64_t) actual_count);
+        }
+
         /* Attempt to process retries */
         ret = na_ofi_cq_process_retries(
             na_ofi_context, na_ofi_class->op_retry_period);
@@ -8341,8 +12425,11 @@ na_ofi_cancel(
     /* Must set canceling before we check for the retry queue */
     hg_atomic_or32(&na_ofi_op_id->status, NA_OFI_OP_CANCELING);
 
+    /* Check if op_id is waiting for a ring msg */
+    if (hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_RING)
+        na_ofi_ring_cancel(NA_OFI_CONTEXT(context)->ring_rx, na_ofi_op_id);
     /* Check if op_id is in retry queue */
-    if (hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_QUEUED) {
+    else if (hg_atomic_get32(&na_ofi_op_id->status) & NA_OFI_OP_QUEUED) {
         struct na_ofi_op_queue *op_queue =
             NA_OFI_CONTEXT(context)->eq->retry_op_queue;
         bool canceled = false;
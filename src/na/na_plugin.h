@@ -14,6 +14,10 @@
 #include "mercury_param.h"
 #include "mercury_queue.h"
 
+#ifndef _WIN32
+#    include <sys/uio.h>
+#endif
+
 /*************************************/
 /* Public Type and Struct Definition */
 /*************************************/
@@ -161,36 +165,130 @@ NA_PLUGIN_VISIBILITY void
 na_cb_completion_add(
     na_context_t *context, struct na_cb_completion_data *na_cb_completion_data);
 
+/**
+ * Notify upper layer that a peer is no longer reachable (see
+ * NA_Addr_set_error_callback()).
+ *
+ * \param na_class [IN/OUT]     pointer to NA class
+ * \param addr [IN]             NA address of the peer
+ * \param error [IN]            error encountered
+ */
+NA_PLUGIN_VISIBILITY void
+na_cb_addr_error(na_class_t *na_class, na_addr_t *addr, na_return_t error);
+
+/**
+ * Get size of LEB128 varint encoding of value.
+ *
+ * \param value [IN]            value
+ *
+ * eturn Size in bytes
+ */
+NA_PLUGIN_VISIBILITY size_t
+na_varint_get_serialize_size(uint64_t value);
+
+/**
+ * Encode value as LEB128 varint and advance buffer.
+ *
+ * \param buf_p [IN/OUT]            pointer to buffer pointer
+ * \param buf_size_left_p [IN/OUT]  pointer to size left in buffer
+ * \param value [IN]                value
+ *
+ * eturn NA_SUCCESS or NA_OVERFLOW if buffer is too small
+ */
+NA_PLUGIN_VISIBILITY na_return_t
+na_varint_serialize(char **buf_p, size_t *buf_size_left_p, uint64_t value);
+
+/**
+ * Decode LEB128 varint and advance buffer.
+ *
+ * \param buf_p [IN/OUT]            pointer to buffer pointer
+ * \param buf_size_left_p [IN/OUT]  pointer to size left in buffer
+ * \param value_p [OUT]             pointer to decoded value
+ *
+ * eturn NA_SUCCESS or NA_OVERFLOW if buffer is truncated
+ */
+NA_PLUGIN_VISIBILITY na_return_t
+na_varint_deserialize(
+    const char **buf_p, size_t *buf_size_left_p, uint64_t *value_p);
+
+#ifndef _WIN32
+/**
+ * Get size of compact encoding of segments. Each segment is encoded as the
+ * zigzag varint distance of its base from the end of the previous segment,
+ * followed by its varint length, so that segments of a same registration
+ * only take a few bytes each.
+ *
+ * \param iov [IN]              array of segments
+ * \param iovcnt [IN]           number of segments
+ *
+ * eturn Size in bytes
+ */
+NA_PLUGIN_VISIBILITY size_t
+na_iov_get_serialize_size(const struct iovec *iov, unsigned long iovcnt);
+
+/**
+ * Encode segments (see na_iov_get_serialize_size()) and advance buffer.
+ *
+ * \param buf_p [IN/OUT]            pointer to buffer pointer
+ * \param buf_size_left_p [IN/OUT]  pointer to size left in buffer
+ * \param iov [IN]                  array of segments
+ * \param iovcnt [IN]               number of segments
+ *
+ * eturn NA_SUCCESS or NA_OVERFLOW if buffer is too small
+ */
+NA_PLUGIN_VISIBILITY na_return_t
+na_iov_serialize(char **buf_p, size_t *buf_size_left_p,
+    const struct iovec *iov, unsigned long iovcnt);
+
+/**
+ * Decode segments (see na_iov_get_serialize_size()) and advance buffer.
+ *
+ * \param buf_p [IN/OUT]            pointer to buffer pointer
+ * \param buf_size_left_p [IN/OUT]  pointer to size left in buffer
+ * \param iov [OUT]                 array of iovcnt segments
+ * \param iovcnt [IN]               number of segments
+ * \param len_p [OUT]               pointer to total length of segments
+ *
+ * eturn NA_SUCCESS or NA_OVERFLOW if buffer is truncated
+ */
+NA_PLUGIN_VISIBILITY na_return_t
+na_iov_deserialize(const char **buf_p, size_t *buf_size_left_p,
+    struct iovec *iov, unsigned long iovcnt, size_t *len_p);
+#endif
+
 /*********************/
 /* Public Variables */
 /*********************/
 
 /* SM and MPI must remain in the library as they provide their own APIs */
 #ifdef NA_HAS_SM
-extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(sm);
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(sm);
 #endif
 #ifndef NA_HAS_DYNAMIC_PLUGINS
 #    ifdef NA_HAS_OFI
-extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(ofi);
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(ofi);
 #    endif
 #    ifdef NA_HAS_UCX
-extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(ucx);
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(ucx);
 #    endif
 #endif
+#ifdef NA_HAS_TCP
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(tcp);
+#endif
 #ifdef NA_HAS_BMI
-extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(bmi);
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(bmi);
 #endif
 #ifdef NA_HAS_MPI
-extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(mpi);
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(mpi);
 #endif
 #ifdef NA_HAS_CCI
-extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(cci);
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(cci);
 #endif
 #ifdef NA_HAS_PSM
-extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(psm);
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(psm);
 #endif
 #ifdef NA_HAS_PSM2
-extern NA_PRIVATE const struct na_class_ops NA_PLUGIN_OPS(psm2);
+extern NA_PLUGIN_OPS_VISIBILITY const struct na_class_ops NA_PLUGIN_OPS(psm2);
 #endif
 
 #ifdef __cplusplus
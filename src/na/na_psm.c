@@ -79,6 +79,13 @@ typedef struct psm_ep_open_opts psm_ep_open_opts_t;
 #define NA_PSM_MAX_EXPECTED   4096
 #define NA_PSM_MAX_UNEXPECTED 4096
 
+/*
+ * max number of completed psm requests harvested from the mq while
+ * holding ipeek_lock in one progress pass.   completions are processed
+ * after the lock is dropped.
+ */
+#define NA_PSM_PROG_BATCH 16
+
 /*
  * tag management.  data sent with psm_isend() is tagged with a uint64_t.
  * when recv buffers are posted to psm with psm_irecv(), you specify
@@ -296,6 +303,18 @@ struct na_psm_local_mem_handle {
     HG_LIST_ENTRY(na_psm_local_mem_handle) q; /* linkage (off class) */
 };
 
+/*
+ * na_psm_completion: a completed psm request collected by progress.
+ * it is either a subop (status saved in the subop) or a ucmsg (status
+ * saved here).   untracked psm ops are not collected.
+ */
+struct na_psm_completion {
+    struct na_psm_subop *subop; /* completed subop (or NULL) */
+    int op_idled;               /* subop's op_id is no longer busy */
+    struct na_psm_ucmsg *ucmsg; /* completed ucmsg (or NULL) */
+    psm_mq_status_t psmstatus;  /* ucmsg status */
+};
+
 /*
  * na_psm_class: the top-level structure that contains the state for psm
  *
@@ -2422,15 +2441,14 @@ na_psm_progress(
     na_class_t *na_class, na_context_t NA_UNUSED *context, unsigned int timeout)
 {
     struct na_psm_class *pc;
-    int completed, lcv, op_idled;
+    int completed, lcv, ncomps;
     double timeoutsecs, delta, left;
     hg_time_t tstart, tnow, tsleep;
+    struct na_psm_completion comps[NA_PSM_PROG_BATCH], *comp;
     struct na_psm_subop *subop;
-    struct na_psm_ucmsg *ucmsg;
     psm_error_t perr;
     psm_mq_req_t psmreq, orig_psmreq;
     psm_mq_status_t psmstatus;
-    struct na_psm_op_id *pop;
 
     /* recover psm class and setup for looping... */
     pc = na_class->plugin_class;
@@ -2441,41 +2459,48 @@ na_psm_progress(
     }
 
     do {
-        /*
-         * we may collect a subop, a ucmsg, or a NULL context (if we
-         * complete an untracked PSM op).
-         */
-        subop = NULL;
-        ucmsg = NULL;
-
         /*
          * hold ipeek lock to avoid ipeek/wait concurrency issue and
          * to prevent ops to be canceled while we are collecting them.
+         * we harvest as many completed reqs as we can (up to the batch
+         * size) in one lock hold, so that concurrent progress threads
+         * do not take the lock once per completion.  lcv only counts
+         * empty polls.
          */
+        ncomps = 0;
         hg_thread_mutex_lock(&pc->ipeek_lock);
-        for (lcv = 0; lcv < pc->prog_peeks_per_try; lcv++) {
+        for (lcv = 0;
+             lcv < pc->prog_peeks_per_try && ncomps < NA_PSM_PROG_BATCH;) {
 
             perr = psm_mq_ipeek(pc->psm_mq, &psmreq, NULL); /* << poll here */
-            if (perr != PSM_OK) /* no psmreq available? */
+            if (perr != PSM_OK) { /* no psmreq available? */
+                lcv++;
                 continue;
+            }
 
             /* test will NULL out psmreq, save a copy for handle sanity check */
             orig_psmreq = psmreq;
 
             /* collect req's status and retire it */
             perr = psm_mq_test(&psmreq, &psmstatus);
-            if (perr != PSM_OK)
+            if (perr != PSM_OK) {
+                lcv++;
                 continue; /* shouldn't happen: ipeek returns done req */
+            }
 
             if (psmstatus.context == NULL) /* untracked operation? */
-                break;
+                continue;
+
+            comp = &comps[ncomps++];
 
             /* unexpected control message buffer? */
             if (psmstatus.context >= (void *) &pc->ucmsgs[0] &&
                 psmstatus.context <=
                     (void *) &pc->ucmsgs[NA_PSM_UCMSG_COUNT - 1]) {
-                ucmsg = psmstatus.context;
-                break;
+                comp->subop = NULL;
+                comp->ucmsg = psmstatus.context;
+                comp->psmstatus = psmstatus;
+                continue;
             }
 
             /* must be a subop! */
@@ -2486,19 +2511,24 @@ na_psm_progress(
             }
             subop->psm_handle = NULL; /* want this w/ipeek lock held */
             subop->psm_status = psmstatus;
-            pop = subop->owner;
-            op_idled = (na_psm_opid_setbusy(pc, pop, -1) == 0);
-            break;
+            comp->subop = subop;
+            comp->ucmsg = NULL;
+            comp->op_idled = (na_psm_opid_setbusy(pc, subop->owner, -1) == 0);
         }
         hg_thread_mutex_unlock(&pc->ipeek_lock);
 
-        if (ucmsg) {
-            na_psm_progress_ucmsg(pc, &psmstatus, ucmsg);
-        } else if (subop) {
-            completed = na_psm_progress_op(pop, subop, op_idled);
-            if (completed)
-                break;
+        /* now process everything we collected, without the lock */
+        for (lcv = 0; lcv < ncomps; lcv++) {
+            comp = &comps[lcv];
+            if (comp->ucmsg) {
+                na_psm_progress_ucmsg(pc, &comp->psmstatus, comp->ucmsg);
+            } else if (na_psm_progress_op(
+                           comp->subop->owner, comp->subop, comp->op_idled)) {
+                completed = 1;
+            }
         }
+        if (completed)
+            break;
 
         if (timeout) {
             hg_time_get_current_ms(&tnow);
@@ -2621,11 +2651,15 @@ const struct na_class_ops NA_PSM_PLUGIN_VARIABLE = {
     na_psm_finalize,                       /* finalize */
     NULL,                                  /* cleanup */
     NULL,                                  /* has_opt_feature */
+    NULL,                                  /* get_numa_node */
     NULL,                                  /* context_create */
     NULL,                                  /* context_destroy */
     na_psm_op_create,                      /* op_create */
     na_psm_op_destroy,                     /* op_destroy */
+    NULL,                                  /* op_reset */
     na_psm_addr_lookup,                    /* addr_lookup */
+    NULL,                                  /* addr_lookup_batch */
+    NULL,                                  /* addr_warm */
     na_psm_addr_free,                      /* addr_free */
     NULL,                                  /* addr_set_remove */
     na_psm_addr_self,                      /* addr_self */
@@ -2650,6 +2684,7 @@ const struct na_class_ops NA_PSM_PLUGIN_VARIABLE = {
     NULL,                                  /* msg_init_expected */
     na_psm_msg_send_expected,              /* msg_send_expected */
     na_psm_msg_recv_expected,              /* msg_recv_expected */
+    NULL,                                  /* msg_send_batch */
     na_psm_mem_handle_create,              /* mem_handle_create */
     NULL,                                  /* mem_handle_create_segment */
     na_psm_mem_handle_free,                /* mem_handle_free */
@@ -2661,6 +2696,9 @@ const struct na_class_ops NA_PSM_PLUGIN_VARIABLE = {
     na_psm_mem_handle_deserialize,         /* mem_handle_deserialize */
     na_psm_put,                            /* put */
     na_psm_get,                            /* get */
+    NULL,                                  /* rma_batch_get_max_segments */
+    NULL,                                  /* rma_batch */
+    NULL,                                  /* atomic */
     NULL,                                  /* poll_get_fd */
     NULL,                                  /* poll_try_wait */
     na_psm_progress,                       /* progress */
@@ -12,8 +12,9 @@
 #include "na_plugin.h"
 
 #include "mercury_atomic_queue.h"
+#include "mercury_backoff.h"
 #include "mercury_event.h"
-#include "mercury_hash_table.h"
+#include "mercury_oa_hash_table.h"
 #include "mercury_list.h"
 #include "mercury_mem.h"
 #include "mercury_poll.h"
@@ -31,12 +32,27 @@
 #    include <uuid/uuid.h>
 #endif
 
+#ifdef NA_SM_HAS_XPMEM
+#    include <xpmem.h>
+#endif
+
+#ifdef NA_SM_HAS_CUDA
+#    include <cuda.h>
+#    include <cuda_runtime.h>
+#endif
+
+#ifdef NA_SM_HAS_NUMA
+#    include <linux/mempolicy.h>
+#    include <sys/syscall.h>
+#endif
+
 #ifdef _WIN32
 #    include <process.h>
 #else
 #    include <fcntl.h>
 #    include <ftw.h>
 #    include <pwd.h>
+#    include <signal.h>
 #    include <sys/mman.h>
 #    include <sys/resource.h>
 #    include <sys/socket.h>
@@ -64,32 +80,63 @@
 #define NA_SM_PAGE_SIZE HG_MEM_PAGE_SIZE
 
 /* Default filenames/paths */
-#define NA_SM_SHM_PATH  "/dev/shm"
-#define NA_SM_SOCK_NAME "/sock"
+#define NA_SM_SHM_PATH       "/dev/shm"
+#define NA_SM_HUGETLBFS_PATH "/dev/hugepages"
+#define NA_SM_SOCK_NAME      "/sock"
 
 /* Max filename length used for shared files */
 #define NA_SM_MAX_FILENAME 64
 
-/* Max number of shared-memory buffers (reserved by 64-bit atomic integer) */
+/* Default number of shared-memory buffers (must be a power of 2 and a
+ * multiple of 64 as buffers are reserved by 64-bit atomic integers) */
 #define NA_SM_NUM_BUFS 64
 
-/* Size of shared-memory buffer */
+/* Max number of shared-memory buffers (limited by msg header) */
+#define NA_SM_NUM_BUFS_MAX 4096
+
+/* Default size of shared-memory buffer */
 #define NA_SM_COPY_BUF_SIZE NA_SM_PAGE_SIZE
 
+/* Max size of shared-memory buffer (limited by msg header) */
+#define NA_SM_COPY_BUF_SIZE_MAX (32 * 1024)
+
+#ifdef NA_SM_HAS_XPMEM
+/* Granularity of XPMEM attachments (shared by neighboring buffers) */
+#    define NA_SM_XPMEM_ATTACH_ALIGN (2 * 1024 * 1024)
+#endif
+
 /* Max number of fds used for cleanup */
 #define NA_SM_CLEANUP_NFDS 16
 
-/* Max number of peers */
-#define NA_SM_MAX_PEERS (NA_CONTEXT_ID_MAX + 1)
+/* Default number of queue pairs, i.e., local peers of an endpoint (must be a
+ * power of 2 and a multiple of 64 as pairs are reserved by 64-bit atomic
+ * integers) */
+#define NA_SM_NUM_PAIRS 256
+
+/* Max number of queue pairs (limited by cmd header) */
+#define NA_SM_NUM_PAIRS_MAX 4096
+
+/* Max size of payloads carried inline within msg queue entries */
+#define NA_SM_INLINE_MAX (NA_SM_CACHE_LINE_SIZE * 2 - sizeof(uint64_t))
+
+/* Max number of msgs pushed at once by batched sends */
+#define NA_SM_SEND_BATCH_MAX (64)
+
+/* Max number of chunks in flight per RMA op staged through copy buffers */
+#define NA_SM_RMA_BOUNCE_DEPTH (8)
+
+/* Number of locks serializing emulated remote atomics (power of 2) */
+#define NA_SM_ATOMIC_LOCKS (16)
+
+/* Bounds of delay (us) between retries while remote queues stay full */
+#define NA_SM_RETRY_BACKOFF_MIN (1)
+#define NA_SM_RETRY_BACKOFF_MAX (128)
 
 /* Addr status bits */
 #define NA_SM_ADDR_RESERVED   (1 << 0)
 #define NA_SM_ADDR_CMD_PUSHED (1 << 1)
 #define NA_SM_ADDR_RESOLVED   (1 << 2)
-
-/* Msg sizes */
-#define NA_SM_UNEXPECTED_SIZE NA_SM_COPY_BUF_SIZE
-#define NA_SM_EXPECTED_SIZE   NA_SM_UNEXPECTED_SIZE
+#define NA_SM_ADDR_RECLAIMED  (1 << 3)
 
 /* Max tag */
 #define NA_SM_MAX_TAG NA_TAG_MAX
@@ -100,6 +147,14 @@
 /* Max events */
 #define NA_SM_MAX_EVENTS 16
 
+/* Number of completions that a multi-recv operation may have pending (must
+ * be a power of 2), buffers are returned early once exhausted */
+#define NA_SM_OP_MULTI_CQ_SIZE (256)
+
+/* Alignment of messages packed into multi-recv buffers */
+#define NA_SM_MULTI_RECV_ALIGN(x)                                              \
+    (((x) + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1))
+
 /* Op ID status bits */
 #define NA_SM_OP_COMPLETED (1 << 0)
 #define NA_SM_OP_RETRYING  (1 << 1)
@@ -156,6 +211,10 @@
 #define NA_SM_PRINT_SHM_NAME(str, size, uri)                                   \
     snprintf(str, size, NA_SM_SHM_PREFIX "-%s", uri)
 
+/* Generate hugetlbfs file path from SHM file name */
+#define NA_SM_PRINT_HUGETLBFS_PATH(str, size, name)                            \
+    snprintf(str, size, NA_SM_HUGETLBFS_PATH "/%s", name)
+
 /* Generate socket path */
 #define NA_SM_PRINT_SOCK_PATH(str, size, uri)                                  \
     snprintf(str, size, NA_SM_TMP_DIRECTORY "/" NA_SM_SHM_PREFIX "-%s", uri);
@@ -171,40 +230,78 @@
 #define NA_SM_IOV(x)                                                           \
     ((x)->info.iovcnt > NA_SM_IOV_STATIC_MAX) ? (x)->iov.d : (x)->iov.s
 
+/* Align size */
+#define NA_SM_ALIGN(x, a) (((x) + (a) -1) & ~((size_t) (a) -1))
+
+/* Access shared region members that follow the region header */
+#define NA_SM_REGION_PTR(region, offset)                                       \
+    ((void *) ((char *) (region) + (offset)))
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Msg types (not NA callback types, which may not fit in msg headers) */
+enum na_sm_msg_type {
+    NA_SM_MSG_UNEXPECTED, /* Unexpected msg */
+    NA_SM_MSG_EXPECTED,   /* Expected msg */
+    NA_SM_RMA_PUT,        /* RMA chunk to copy to target memory */
+    NA_SM_RMA_GET,        /* RMA chunk to copy from target memory */
+    NA_SM_RMA_ACK,        /* RMA chunk copied by target */
+    NA_SM_MSG_TYPE_MAX
+};
+
 /* Msg header */
 NA_PACKED(union na_sm_msg_hdr {
     struct {
-        unsigned int tag : 32;      /* Message tag : UINT MAX */
-        unsigned int buf_size : 16; /* Buffer length: 4KB MAX */
-        unsigned int buf_idx : 8;   /* Index reserved: 64 MAX */
-        unsigned int type : 8;      /* Message type */
+        unsigned int tag : 32;       /* Message tag : UINT MAX */
+        unsigned int buf_size : 16;  /* Buffer length: 32KB MAX */
+        unsigned int buf_idx : 12;   /* Index reserved: 4096 MAX */
+        unsigned int type : 3;       /* Message type: 8 MAX */
+        unsigned int inline_buf : 1; /* Payload follows header in entry */
     } hdr;
     uint64_t val;
 });
 
+/* Msg types must fit in the type field of msg headers */
+HG_UTIL_STATIC_ASSERT(
+    NA_SM_MSG_TYPE_MAX <= 8, "na_sm_msg_type does not fit in msg header");
+
 /* Make sure this is cache-line aligned */
 union na_sm_cacheline_atomic_int64 {
     hg_atomic_int64_t val;
     char pad[NA_SM_CACHE_LINE_SIZE];
 };
 
-union na_sm_cacheline_atomic_int256 {
-    hg_atomic_int64_t val[4];
+/* Locks of emulated remote atomics (striped by remote address) */
+union na_sm_cacheline_atomic_locks {
+    hg_thread_spin_t val[NA_SM_ATOMIC_LOCKS];
     char pad[NA_SM_CACHE_LINE_SIZE];
 };
 
-/* Msg buffers (page aligned) */
-struct na_sm_copy_buf {
-    hg_thread_spin_t buf_locks[NA_SM_NUM_BUFS];    /* Locks on buffers */
-    char buf[NA_SM_NUM_BUFS][NA_SM_COPY_BUF_SIZE]; /* Array of buffers */
-    union na_sm_cacheline_atomic_int64 available;  /* Available bitmask */
+/* Doorbell of region owner (waiters share a cache line with the pending bits
+ * of the first pairs) */
+struct na_sm_doorbell {
+    hg_atomic_int64_t waiting;   /* Owner waiting on notifications */
+    hg_atomic_int64_t pending[]; /* Pairs with msgs (one bit per pair) */
+};
+
+/* RMA chunk (inline payload, data is in a copy buffer reserved by origin) */
+struct na_sm_rma_chunk {
+    uint64_t op_id;   /* Op ID of origin */
+    uint64_t addr;    /* Target address */
+    uint64_t offset;  /* Offset of chunk within transfer */
+    uint32_t len;     /* Length of chunk */
+    uint32_t buf_idx; /* Copy buffer of chunk */
+};
+
+/* Msg queue entry (header and small payloads share two cache lines) */
+struct na_sm_msg_entry {
+    hg_atomic_int64_t hdr;
+    char buf[NA_SM_INLINE_MAX];
 };
 
-/* Msg queue (allocate queue's flexible array member statically) */
+/* Msg queue (ring is sized from the number of buffers of the region) */
 struct na_sm_msg_queue {
     hg_atomic_int32_t prod_head;
     hg_atomic_int32_t prod_tail;
@@ -215,31 +312,30 @@ struct na_sm_msg_queue {
     hg_atomic_int32_t cons_tail;
     unsigned int cons_size;
     unsigned int cons_mask;
-    NA_ALIGNED(hg_atomic_int64_t ring[NA_SM_NUM_BUFS], HG_MEM_CACHE_LINE_SIZE);
-};
-
-/* Shared queue pair */
-struct na_sm_queue_pair {
-    struct na_sm_msg_queue tx_queue; /* Send queue */
-    struct na_sm_msg_queue rx_queue; /* Recv queue */
+    hg_atomic_int32_t cons_waiting; /* Consumers blocked on notification */
+    NA_ALIGNED(struct na_sm_msg_entry ring[], HG_MEM_CACHE_LINE_SIZE);
 };
 
 /* Cmd values */
-enum na_sm_cmd { NA_SM_RESERVED = 1, NA_SM_RELEASED };
+enum na_sm_cmd {
+    NA_SM_RESERVED = 1, /* Queue pair reserved (cmd queue) */
+    NA_SM_RELEASED,     /* Queue pair released */
+    NA_SM_NOTIFY,       /* Events of reserved queue pair (sock only) */
+    NA_SM_RECLAIM       /* Reclaim queue pairs of peers that exited */
+};
 
 /* Cmd header */
 NA_PACKED(union na_sm_cmd_hdr {
     struct {
-        unsigned int pid : 32;     /* PID */
-        unsigned int id : 8;       /* ID */
-        unsigned int pair_idx : 8; /* Index reserved */
-        unsigned int type : 8;     /* Cmd type */
-        unsigned int pad : 8;      /* 8 bits left */
+        unsigned int pid : 32;      /* PID */
+        unsigned int id : 8;        /* ID */
+        unsigned int pair_idx : 16; /* Index reserved: 65536 MAX */
+        unsigned int type : 8;      /* Cmd type */
     } hdr;
     uint64_t val;
 });
 
-/* Cmd queue (allocate queue's flexible array member statically) */
+/* Cmd queue (ring is sized from the number of queue pairs of the region) */
 struct na_sm_cmd_queue {
     hg_atomic_int32_t prod_head;
     hg_atomic_int32_t prod_tail;
@@ -250,9 +346,7 @@ struct na_sm_cmd_queue {
     hg_atomic_int32_t cons_tail;
     unsigned int cons_size;
     unsigned int cons_mask;
-    /* To be safe, make the queue twice as large */
-    NA_ALIGNED(
-        hg_atomic_int64_t ring[NA_SM_MAX_PEERS * 2], HG_MEM_CACHE_LINE_SIZE);
+    NA_ALIGNED(hg_atomic_int64_t ring[], HG_MEM_CACHE_LINE_SIZE);
 };
 
 /* Address key */
@@ -261,14 +355,30 @@ struct na_sm_addr_key {
     uint8_t id; /* SM ID */
 };
 
-/* Shared region */
+/* Shared region layout (offsets are relative to the start of the region) */
+struct na_sm_region_layout {
+    size_t size;                   /* Total size of region */
+    size_t cmd_queue_offset;       /* Cmd queue */
+    size_t doorbell_offset;        /* Owner doorbell */
+    size_t pairs_available_offset; /* Queue pair availability bitmasks */
+    size_t available_offset;       /* Buffer availability bitmasks */
+    size_t buf_locks_offset;       /* Locks on buffers */
+    size_t bufs_offset;            /* Array of buffers (page aligned) */
+    size_t queue_pairs_offset;     /* Msg queue pairs (page aligned) */
+    size_t queue_size;             /* Size of a single msg queue */
+    unsigned int pair_count;       /* Number of queue pairs */
+    unsigned int buf_count;        /* Number of buffers */
+    unsigned int buf_size;         /* Size of a buffer */
+    bool huge;                     /* Backed by hugetlbfs */
+};
+
+/* Shared region (cmd queue, doorbell, buffers and queue pairs follow the
+ * header, their size depends on the layout) */
 struct na_sm_region {
-    struct na_sm_addr_key addr_key;  /* Region IDs */
-    struct na_sm_copy_buf copy_bufs; /* Pool of msg buffers */
-    NA_ALIGNED(struct na_sm_queue_pair queue_pairs[NA_SM_MAX_PEERS],
-        NA_SM_PAGE_SIZE);                          /* Msg queue pairs */
-    struct na_sm_cmd_queue cmd_queue;              /* Cmd queue */
-    union na_sm_cacheline_atomic_int256 available; /* Available pairs */
+    struct na_sm_addr_key addr_key;                  /* Region IDs */
+    struct na_sm_region_layout layout;               /* Region layout */
+    union na_sm_cacheline_atomic_locks atomic_locks; /* Atomic locks */
+    hg_atomic_int32_t reclaim; /* Reclaim of queue pairs requested */
 };
 
 /* Poll type */
@@ -294,8 +404,10 @@ struct na_sm_addr {
     enum na_sm_poll_type rx_poll_type;  /* Rx poll type */
     hg_atomic_int32_t refcount;         /* Ref count */
     hg_atomic_int32_t status;           /* Status bits */
-    uint8_t queue_pair_idx;             /* Shared queue pair index */
+    uint16_t queue_pair_idx;            /* Shared queue pair index */
     bool unexpected;                    /* Unexpected address */
+    bool rx_armed;                      /* Wait armed on rx queue */
+    bool tx_doorbell;                   /* Tx queue consumed by region owner */
 };
 
 /* Address list */
@@ -306,15 +418,23 @@ struct na_sm_addr_list {
 
 /* Map (used to cache addresses) */
 struct na_sm_map {
-    hg_thread_rwlock_t lock;
-    hg_hash_table_t *map;
+    hg_thread_brlock_t lock;
+    hg_oa_hash_table_t *map;
 };
 
 /* Memory descriptor info */
 struct na_sm_mem_desc_info {
     unsigned long iovcnt; /* Segment count */
     size_t len;           /* Size of region */
-    uint8_t flags;        /* Flag of operation access */
+#ifdef NA_SM_HAS_XPMEM
+    int64_t segid; /* XPMEM segment of owner (-1 if none) */
+#endif
+#ifdef NA_SM_HAS_CUDA
+    cudaIpcMemHandle_t cuda_ipc; /* IPC handle of owner allocation */
+    uint64_t cuda_offset;        /* Offset of region in allocation */
+    uint8_t mem_type;            /* Memory type (na_mem_type) */
+#endif
+    uint8_t flags; /* Flag of operation access */
 };
 
 /* IOV descriptor */
@@ -336,9 +456,36 @@ struct na_sm_msg_info {
         void *ptr;
     } buf;
     size_t buf_size;
+    size_t buf_offset; /* Space consumed (multi-recv) */
     na_tag_t tag;
 };
 
+/* RMA info (staged through copy buffers) */
+struct na_sm_rma_info {
+    struct na_sm_mem_handle *local_handle;  /* Local handle */
+    struct na_sm_mem_handle *remote_handle; /* Remote handle */
+    na_offset_t local_offset;               /* Local offset */
+    na_offset_t remote_offset;              /* Remote offset */
+    size_t length;                          /* Length of transfer */
+    size_t posted;                          /* Bytes posted to target */
+    size_t completed;                       /* Bytes acknowledged */
+    unsigned int inflight;                  /* Chunks in flight */
+    na_return_t ret;                        /* First error */
+};
+
+/* RMA ack that could not be posted (full queue) */
+struct na_sm_rma_ack {
+    HG_QUEUE_ENTRY(na_sm_rma_ack) entry;
+    struct na_sm_addr *na_sm_addr;
+    struct na_sm_rma_chunk chunk;
+};
+
+/* RMA ack queue */
+struct na_sm_rma_ack_queue {
+    HG_QUEUE_HEAD(na_sm_rma_ack) queue;
+    hg_thread_spin_t lock;
+};
+
 /* Unexpected msg info */
 struct na_sm_unexpected_info {
     HG_QUEUE_ENTRY(na_sm_unexpected_info) entry;
@@ -354,16 +501,65 @@ struct na_sm_unexpected_msg_queue {
     hg_thread_spin_t lock;
 };
 
+#ifdef NA_SM_HAS_XPMEM
+/* XPMEM attachment of remote address range */
+struct na_sm_xpmem_attach {
+    HG_LIST_ENTRY(na_sm_xpmem_attach) entry; /* Entry in peer list */
+    uintptr_t base;                          /* Remote (aligned) base */
+    size_t len;                              /* Attached length */
+    void *ptr;                               /* Local mapping of base */
+};
+
+/* XPMEM segment of remote process */
+struct na_sm_xpmem_peer {
+    HG_LIST_ENTRY(na_sm_xpmem_peer) entry;        /* Entry in peer map */
+    HG_LIST_HEAD(na_sm_xpmem_attach) attach_list; /* Attachments (MRU) */
+    xpmem_segid_t segid;                          /* Remote segment */
+    xpmem_apid_t apid;                            /* Access permit */
+};
+
+/* XPMEM peer map */
+struct na_sm_xpmem_map {
+    HG_LIST_HEAD(na_sm_xpmem_peer) list; /* List of peers */
+    hg_thread_mutex_t lock;              /* Lock */
+};
+#endif
+
+#ifdef NA_SM_HAS_CUDA
+/* CUDA IPC mapping of remote device allocation */
+struct na_sm_cuda_ipc {
+    HG_LIST_ENTRY(na_sm_cuda_ipc) entry; /* Entry in IPC map */
+    cudaIpcMemHandle_t handle;           /* Remote IPC handle */
+    void *ptr;                           /* Local mapping of allocation */
+};
+
+/* CUDA IPC map */
+struct na_sm_cuda_ipc_map {
+    HG_LIST_HEAD(na_sm_cuda_ipc) list; /* List of mappings (MRU) */
+    hg_thread_mutex_t lock;            /* Lock */
+};
+#endif
+
 /* RMA op */
 typedef na_return_t (*na_sm_process_vm_op_t)(pid_t pid,
     const struct iovec *local_iov, unsigned long liovcnt,
     const struct iovec *remote_iov, unsigned long riovcnt, size_t length);
 
+/* Completions of multi-event operations */
+struct na_sm_completion_multi {
+    struct na_cb_completion_data *data; /* Ring of completion data */
+    hg_atomic_int32_t head;             /* Next entry pushed */
+    hg_atomic_int32_t tail;             /* Next entry released */
+    int32_t mask;                       /* Ring mask */
+};
+
 /* Operation ID */
 struct na_sm_op_id {
     struct na_cb_completion_data completion_data; /* Completion data */
+    struct na_sm_completion_multi multi; /* Multi-recv completions   */
     union {
         struct na_sm_msg_info msg;
+        struct na_sm_rma_info rma;
     } info;                            /* Op info                  */
     HG_QUEUE_ENTRY(na_sm_op_id) entry; /* Entry in queue           */
     na_class_t *na_class;              /* NA class associated      */
@@ -386,13 +582,19 @@ struct na_sm_endpoint {
     struct na_sm_op_queue unexpected_op_queue; /* Unexpected op queue */
     struct na_sm_op_queue expected_op_queue;   /* Expected op queue */
     struct na_sm_op_queue retry_op_queue;      /* Retry op queue */
+    struct na_sm_op_queue rma_op_queue;        /* RMA ops waiting for bufs */
+    struct na_sm_rma_ack_queue rma_ack_queue;  /* RMA acks waiting for queue */
+    struct hg_backoff retry_backoff;           /* Retry backoff (locked) */
     struct na_sm_addr_list poll_addr_list;     /* List of addresses to poll */
+    struct na_sm_addr **pair_addrs;            /* Local pair addrs */
     struct na_sm_addr *source_addr;            /* Source addr */
     hg_poll_set_t *poll_set;                   /* Poll set */
     int sock;                                  /* Sock fd */
     enum na_sm_poll_type sock_poll_type;       /* Sock poll type */
     hg_atomic_int32_t nofile;                  /* Number of opened fds */
+    hg_atomic_int32_t armed;                   /* Wait armed on rx queues */
     uint32_t nofile_max;                       /* Max number of fds */
+    unsigned int pair_count;                   /* Number of local pairs */
     bool listen;                               /* Listen on sock */
 };
 
@@ -405,6 +607,17 @@ struct na_sm_context {
 struct na_sm_class {
     struct na_sm_endpoint endpoint; /* Endpoint */
     size_t iov_max;                 /* Max number of IOVs */
+    size_t msg_size_max;            /* Max size of messages */
+#ifdef NA_SM_HAS_XPMEM
+    struct na_sm_xpmem_map xpmem_map; /* Attached remote segments */
+    xpmem_segid_t xpmem_segid;        /* Local segment (-1 if none) */
+#endif
+#ifdef NA_SM_HAS_CUDA
+    struct na_sm_cuda_ipc_map cuda_ipc_map; /* Opened remote allocations */
+#endif
+    hg_atomic_int64_t *retry_count; /* Ops pushed for retry */
+    hg_atomic_int64_t *retry_again; /* Retries that were busy */
+    hg_atomic_int32_t rma_bounce;   /* Stage RMA through copy buffers */
     uint8_t context_max;            /* Max number of contexts */
 };
 
@@ -427,16 +640,23 @@ static na_return_t
 na_sm_errno_to_na(int rc);
 
 /**
- * Map shared-memory object.
+ * Map shared-memory object. On create, huge_p requests huge pages. On return,
+ * huge_p is set if the object is backed by hugetlbfs.
  */
 static void *
-na_sm_shm_map(const char *name, size_t length, bool create);
+na_sm_shm_map(const char *name, size_t length, bool create, bool *huge_p);
 
 /**
  * Unmap shared-memory object.
  */
 static na_return_t
-na_sm_shm_unmap(const char *name, void *addr, size_t length);
+na_sm_shm_unmap(const char *name, void *addr, size_t length, bool huge);
+
+/**
+ * Map hugetlbfs file (length is rounded up to huge page size).
+ */
+static void *
+na_sm_hugetlb_map(const char *name, size_t length, bool create);
 
 /**
  * Clean up dangling shm segments.
@@ -445,25 +665,42 @@ static int
 na_sm_shm_cleanup(
     const char *fpath, const struct stat *sb, int typeflag, struct FTW *ftwbuf);
 
+/**
+ * Clean up dangling hugetlbfs files.
+ */
+static int
+na_sm_hugetlb_cleanup(
+    const char *fpath, const struct stat *sb, int typeflag, struct FTW *ftwbuf);
+
 /**
  * Initialize queue.
  */
 static void
-na_sm_msg_queue_init(struct na_sm_msg_queue *na_sm_queue);
+na_sm_msg_queue_init(struct na_sm_msg_queue *na_sm_queue, unsigned int count);
 
 /**
- * Multi-producer enqueue.
+ * Multi-producer enqueue. Inline payloads are copied from buf.
  */
 static NA_INLINE bool
-na_sm_msg_queue_push(
-    struct na_sm_msg_queue *na_sm_queue, const union na_sm_msg_hdr *msg_hdr);
+na_sm_msg_queue_push(struct na_sm_msg_queue *na_sm_queue,
+    const union na_sm_msg_hdr *msg_hdr, const void *buf);
 
 /**
- * Multi-consumer dequeue.
+ * Multi-producer enqueue of up to count msgs, published with a single tail
+ * update. Returns the number of msgs enqueued.
+ */
+static NA_INLINE unsigned int
+na_sm_msg_queue_push_batch(struct na_sm_msg_queue *na_sm_queue,
+    const union na_sm_msg_hdr *msg_hdrs, const void *const *bufs,
+    unsigned int count);
+
+/**
+ * Multi-consumer dequeue. Inline payloads are copied to buf, which must be
+ * able to hold NA_SM_INLINE_MAX bytes.
  */
 static NA_INLINE bool
-na_sm_msg_queue_pop(
-    struct na_sm_msg_queue *na_sm_msg_queue, union na_sm_msg_hdr *msg_hdr);
+na_sm_msg_queue_pop(struct na_sm_msg_queue *na_sm_msg_queue,
+    union na_sm_msg_hdr *msg_hdr, void *buf);
 
 /**
  * Check whether queue is empty.
@@ -471,11 +708,18 @@ na_sm_msg_queue_pop(
 static NA_INLINE bool
 na_sm_msg_queue_is_empty(struct na_sm_msg_queue *na_sm_queue);
 
+/**
+ * Check whether consumer armed its wait and must be notified. Must be called
+ * after a push.
+ */
+static NA_INLINE bool
+na_sm_msg_queue_has_waiter(struct na_sm_msg_queue *na_sm_queue);
+
 /**
  * Initialize queue.
  */
 static void
-na_sm_cmd_queue_init(struct na_sm_cmd_queue *na_sm_queue);
+na_sm_cmd_queue_init(struct na_sm_cmd_queue *na_sm_queue, unsigned int count);
 
 /**
  * Multi-producer enqueue.
@@ -511,10 +755,62 @@ na_sm_string_to_addr(
     const char *str, char *uri, size_t size, struct na_sm_addr_key *addr_key_p);
 
 /**
- * Open shared-memory region.
+ * Compute layout of shared-memory region.
+ */
+static void
+na_sm_region_layout_init(unsigned int pair_count, unsigned int buf_count,
+    unsigned int buf_size, struct na_sm_region_layout *layout);
+
+/**
+ * Open shared-memory region (pair count, buffer count, size and huge page
+ * preference are only used on create).
  */
 static na_return_t
-na_sm_region_open(const char *uri, bool create, struct na_sm_region **region_p);
+na_sm_region_open(const char *uri, bool create, unsigned int pair_count,
+    unsigned int buf_count, unsigned int buf_size, bool huge,
+    struct na_sm_region **region_p);
+
+/**
+ * Get msg queue from queue pair.
+ */
+static NA_INLINE struct na_sm_msg_queue *
+na_sm_region_queue(
+    struct na_sm_region *na_sm_region, uint16_t queue_pair_idx, bool tx);
+
+/**
+ * Get cmd queue of region.
+ */
+static NA_INLINE struct na_sm_cmd_queue *
+na_sm_region_cmd_queue(struct na_sm_region *na_sm_region);
+
+/**
+ * Get doorbell of region owner.
+ */
+static NA_INLINE struct na_sm_doorbell *
+na_sm_region_doorbell(struct na_sm_region *na_sm_region);
+
+/**
+ * Signal region owner that queue pair has pending messages. Must be called
+ * after a push.
+ */
+static NA_INLINE void
+na_sm_region_doorbell_ring(
+    struct na_sm_region *na_sm_region, uint16_t queue_pair_idx);
+
+/**
+ * Check whether region owner armed its wait and must be notified. Must be
+ * called after ringing the doorbell.
+ */
+static NA_INLINE bool
+na_sm_region_has_waiter(struct na_sm_region *na_sm_region);
+
+#ifdef NA_SM_HAS_NUMA
+/**
+ * Place (page-aligned) range of shared region on NUMA node of caller.
+ */
+static void
+na_sm_region_numa_bind(const char *name, void *addr, size_t len);
+#endif
 
 /**
  * Close shared-memory region.
@@ -564,13 +860,13 @@ na_sm_sock_path_cleanup(
  */
 static na_return_t
 na_sm_event_create(
-    const char *uri, uint8_t pair_index, unsigned char pair, int *event);
+    const char *uri, uint16_t pair_index, unsigned char pair, int *event);
 
 /**
  * Destroy event.
  */
 static na_return_t
-na_sm_event_destroy(const char *uri, uint8_t pair_index, unsigned char pair,
+na_sm_event_destroy(const char *uri, uint16_t pair_index, unsigned char pair,
     bool remove, int event);
 
 /**
@@ -602,7 +898,8 @@ na_sm_poll_deregister(hg_poll_set_t *poll_set, int fd);
  */
 static na_return_t
 na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *name,
-    bool listen, bool no_wait, uint32_t nofile_max);
+    bool listen, bool no_wait, uint32_t nofile_max, unsigned int pair_count,
+    unsigned int buf_count, unsigned int buf_size, bool huge_pages);
 
 /**
  * Close shared-memory endpoint.
@@ -614,13 +911,34 @@ na_sm_endpoint_close(struct na_sm_endpoint *na_sm_endpoint);
  * Reserve queue pair.
  */
 static na_return_t
-na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, uint8_t *index);
+na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, uint16_t *index);
 
 /**
  * Release queue pair.
  */
 static NA_INLINE void
-na_sm_queue_pair_release(struct na_sm_region *na_sm_region, uint8_t index);
+na_sm_queue_pair_release(struct na_sm_region *na_sm_region, uint16_t index);
+
+/**
+ * Ask owner of region to reclaim queue pairs of peers that exited.
+ */
+static void
+na_sm_queue_pair_reclaim_request(
+    struct na_sm_endpoint *na_sm_endpoint, struct na_sm_addr *na_sm_addr);
+
+/**
+ * Reclaim queue pairs of local region that were reserved by peers that
+ * exited without releasing them.
+ */
+static void
+na_sm_queue_pair_reclaim(struct na_sm_endpoint *na_sm_endpoint);
+
+/**
+ * Drop msgs left in queue and release their shared buffers.
+ */
+static void
+na_sm_msg_queue_drain(
+    struct na_sm_region *na_sm_region, struct na_sm_msg_queue *na_sm_queue);
 
 /**
  * Lookup addr key from map.
@@ -706,6 +1024,21 @@ na_sm_msg_send(struct na_sm_class *na_sm_class, na_context_t *context,
     size_t buf_size, struct na_sm_addr *na_sm_addr, na_tag_t tag,
     struct na_sm_op_id *na_sm_op_id);
 
+/**
+ * Check send parameters and op ID.
+ */
+static NA_INLINE na_return_t
+na_sm_msg_send_check(struct na_sm_class *na_sm_class, size_t buf_size,
+    struct na_sm_op_id *na_sm_op_id);
+
+/**
+ * Reserve shared buffer if needed, copy payload and build msg header.
+ */
+static na_return_t
+na_sm_msg_hdr_fill(struct na_sm_region *na_sm_region, na_cb_type_t cb_type,
+    const void *buf, size_t buf_size, na_tag_t tag,
+    union na_sm_msg_hdr *msg_hdr);
+
 /**
  * Post msg.
  */
@@ -714,32 +1047,136 @@ na_sm_msg_send_post(struct na_sm_endpoint *na_sm_endpoint, na_cb_type_t cb_type,
     const void *buf, size_t buf_size, struct na_sm_addr *na_sm_addr,
     na_tag_t tag);
 
+/**
+ * Post batch of msgs to the same destination.
+ */
+static na_return_t
+na_sm_msg_send_batch_post(struct na_sm_class *na_sm_class,
+    na_context_t *context, na_cb_type_t cb_type,
+    const struct na_msg_send_info *send_infos, size_t count,
+    size_t *posted_count_p, bool *completed_p);
+
+/**
+ * Resolve destination of msg if not already resolved.
+ */
+static NA_INLINE na_return_t
+na_sm_msg_send_resolve(struct na_sm_addr *na_sm_addr);
+
+/**
+ * Notify destination of new msgs if it is waiting for them.
+ */
+static na_return_t
+na_sm_msg_send_notify(
+    struct na_sm_endpoint *na_sm_endpoint, struct na_sm_addr *na_sm_addr);
+
 /**
  * Reserve shared buffer.
  */
 static NA_INLINE na_return_t
-na_sm_buf_reserve(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int *index);
+na_sm_buf_reserve(struct na_sm_region *na_sm_region, unsigned int *index);
 
 /**
  * Release shared buffer.
  */
 static NA_INLINE void
-na_sm_buf_release(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index);
+na_sm_buf_release(struct na_sm_region *na_sm_region, unsigned int index);
+
+/**
+ * Get address of shared buffer.
+ */
+static NA_INLINE void *
+na_sm_buf_ptr(struct na_sm_region *na_sm_region, unsigned int index);
 
 /**
  * Copy src to shared buffer.
  */
 static NA_INLINE void
-na_sm_buf_copy_to(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index,
+na_sm_buf_copy_to(struct na_sm_region *na_sm_region, unsigned int index,
     const void *src, size_t n);
 
 /**
  * Copy from shared buffer to dest.
  */
 static NA_INLINE void
-na_sm_buf_copy_from(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index,
+na_sm_buf_copy_from(struct na_sm_region *na_sm_region, unsigned int index,
     void *dest, size_t n);
 
+/**
+ * Copy msg payload to dest, either from inline_buf or from shared buffer.
+ */
+static NA_INLINE void
+na_sm_msg_buf_copy_from(struct na_sm_region *na_sm_region,
+    union na_sm_msg_hdr msg_hdr, const void *inline_buf, void *dest);
+
+/**
+ * Release shared buffer used by msg payload, if any.
+ */
+static NA_INLINE void
+na_sm_msg_buf_release(
+    struct na_sm_region *na_sm_region, union na_sm_msg_hdr msg_hdr);
+
+#ifdef NA_SM_HAS_XPMEM
+/**
+ * Expose local address space through XPMEM.
+ */
+static void
+na_sm_xpmem_init(struct na_sm_class *na_sm_class);
+
+/**
+ * Release XPMEM segment and remote attachments.
+ */
+static void
+na_sm_xpmem_finalize(struct na_sm_class *na_sm_class);
+
+/**
+ * Map remote address range into local address space.
+ */
+static na_return_t
+na_sm_xpmem_attach(struct na_sm_class *na_sm_class, xpmem_segid_t segid,
+    uintptr_t base, size_t len, void **ptr_p);
+
+/**
+ * RMA op through XPMEM attachments.
+ */
+static na_return_t
+na_sm_xpmem_rma(struct na_sm_class *na_sm_class, na_cb_type_t cb_type,
+    xpmem_segid_t segid, const struct iovec *local_iov, unsigned long liovcnt,
+    const struct iovec *remote_iov, unsigned long riovcnt, size_t length);
+#endif
+
+#ifdef NA_SM_HAS_CUDA
+/**
+ * Initialize map of CUDA IPC mappings.
+ */
+static void
+na_sm_cuda_init(struct na_sm_class *na_sm_class);
+
+/**
+ * Close CUDA IPC mappings.
+ */
+static void
+na_sm_cuda_finalize(struct na_sm_class *na_sm_class);
+
+/**
+ * Map remote device allocation into local address space.
+ */
+static na_return_t
+na_sm_cuda_ipc_open(struct na_sm_class *na_sm_class,
+    const cudaIpcMemHandle_t *handle, void **ptr_p);
+
+/**
+ * Copy between local and remote regions, either of them being device memory.
+ * Host memory of another process is staged through a bounce buffer.
+ */
+static na_return_t
+na_sm_cuda_rma(struct na_sm_class *na_sm_class, na_cb_type_t cb_type,
+    na_sm_process_vm_op_t process_vm_op, pid_t pid,
+    const struct na_sm_mem_handle *na_sm_mem_handle_local,
+    const struct iovec *local_iov, unsigned long liovcnt,
+    const struct na_sm_mem_handle *na_sm_mem_handle_remote,
+    const struct iovec *remote_iov, unsigned long riovcnt, size_t length);
+#endif
+
 /**
  * RMA op.
  */
@@ -752,6 +1189,51 @@ na_sm_rma(struct na_sm_class *na_sm_class, na_context_t *context,
     size_t length, struct na_sm_addr *na_sm_addr,
     struct na_sm_op_id *na_sm_op_id);
 
+/**
+ * Start RMA op staged through copy buffers of the region shared with the
+ * target. Chunks are copied by the target during its progress, op completes
+ * once all chunks are acknowledged.
+ */
+static na_return_t
+na_sm_rma_bounce(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_op_id *na_sm_op_id,
+    struct na_sm_mem_handle *na_sm_mem_handle_local, na_offset_t local_offset,
+    struct na_sm_mem_handle *na_sm_mem_handle_remote, na_offset_t remote_offset,
+    size_t length);
+
+/**
+ * Post chunks of RMA op while copy buffers are available (RMA op queue lock
+ * must be held). Returns NA_AGAIN if no chunk is in flight.
+ */
+static na_return_t
+na_sm_rma_bounce_post(
+    struct na_sm_endpoint *na_sm_endpoint, struct na_sm_op_id *na_sm_op_id);
+
+/**
+ * Copy between local segments and a copy buffer.
+ */
+static void
+na_sm_rma_bounce_copy(const struct na_sm_mem_handle *na_sm_mem_handle,
+    na_offset_t offset, char *buf, size_t len, bool to_buf);
+
+/**
+ * Acknowledge chunk copied by target, deferred if queue is full.
+ */
+static na_return_t
+na_sm_rma_ack_post(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *na_sm_addr, const struct na_sm_rma_chunk *chunk);
+
+/**
+ * Remote atomic op, emulated by a read-modify-write of remote memory under a
+ * lock of the shared region used to reach the remote peer.
+ */
+static na_return_t
+na_sm_atomic_rmw(struct na_sm_class *na_sm_class, na_context_t *context,
+    na_cb_t callback, void *arg, na_atomic_op_t op, uint64_t operand,
+    uint64_t compare, struct na_sm_mem_handle *na_sm_mem_handle_remote,
+    na_offset_t remote_offset, struct na_sm_addr *na_sm_addr,
+    struct na_sm_op_id *na_sm_op_id);
+
 /**
  * Get IOV index and offset pair from an absolute offset.
  */
@@ -791,6 +1273,19 @@ na_sm_process_vm_readv(pid_t pid, const struct iovec *local_iov,
     unsigned long liovcnt, const struct iovec *remote_iov,
     unsigned long riovcnt, size_t length);
 
+/**
+ * Tell peers that we are about to block so that they notify us. Returns
+ * false if messages arrived in the meantime.
+ */
+static bool
+na_sm_poll_arm(struct na_sm_endpoint *na_sm_endpoint);
+
+/**
+ * Stop receiving notifications from peers.
+ */
+static void
+na_sm_poll_disarm(struct na_sm_endpoint *na_sm_endpoint);
+
 /**
  * Poll waiting for timeout milliseconds.
  */
@@ -804,6 +1299,13 @@ na_sm_poll_wait(na_context_t *context, struct na_sm_endpoint *na_sm_endpoint,
 static na_return_t
 na_sm_poll(struct na_sm_endpoint *na_sm_endpoint, bool *progressed_ptr);
 
+/**
+ * Progress rx queues of local queue pairs that rang the doorbell.
+ */
+static na_return_t
+na_sm_progress_doorbell(
+    struct na_sm_endpoint *na_sm_endpoint, bool *progressed);
+
 /**
  * Progress on endpoint sock.
  */
@@ -849,20 +1351,58 @@ na_sm_progress_rx_queue(struct na_sm_endpoint *na_sm_endpoint,
 static na_return_t
 na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
     struct na_sm_addr *poll_addr, union na_sm_msg_hdr msg_hdr,
+    const void *inline_buf,
     struct na_sm_unexpected_msg_queue *unexpected_msg_queue);
 
+/**
+ * Reserve space and completion data for a message received into a multi-recv
+ * buffer, messages must not exceed the max unexpected size. Called with the
+ * unexpected op queue lock held.
+ */
+static struct na_cb_completion_data *
+na_sm_multi_recv_reserve(struct na_sm_op_id *na_sm_op_id,
+    struct na_sm_addr *source, na_tag_t tag, size_t buf_size,
+    size_t msg_size_max, na_return_t cb_ret);
+
+/**
+ * Release completion data of multi-recv operation.
+ */
+static NA_INLINE void
+na_sm_release_multi(void *arg);
+
 /**
  * Process expected messages.
  */
 static void
 na_sm_process_expected(struct na_sm_op_queue *expected_op_queue,
-    struct na_sm_addr *poll_addr, union na_sm_msg_hdr msg_hdr);
+    struct na_sm_addr *poll_addr, union na_sm_msg_hdr msg_hdr,
+    const void *inline_buf);
 
 /**
  * Process retries.
  */
 static na_return_t
-na_sm_process_retries(struct na_sm_endpoint *na_sm_endpoint);
+na_sm_process_retries(struct na_sm_class *na_sm_class);
+
+/**
+ * Process RMA chunks (target) and acks (origin).
+ */
+static na_return_t
+na_sm_process_rma(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *poll_addr, union na_sm_msg_hdr msg_hdr,
+    const void *inline_buf);
+
+/**
+ * Process RMA ops waiting for copy buffers.
+ */
+static void
+na_sm_process_rma_ops(struct na_sm_endpoint *na_sm_endpoint);
+
+/**
+ * Process RMA acks waiting for queue space.
+ */
+static void
+na_sm_process_rma_acks(struct na_sm_endpoint *na_sm_endpoint);
 
 /**
  * Push operation for retry.
@@ -919,6 +1459,10 @@ na_sm_context_destroy(na_class_t *na_class, void *context);
 static void
 na_sm_cleanup(void);
 
+/* has_opt_feature */
+static bool
+na_sm_has_opt_feature(na_class_t *na_class, unsigned long flags);
+
 /* op_create */
 static na_op_id_t *
 na_sm_op_create(na_class_t *na_class, unsigned long flags);
@@ -927,10 +1471,18 @@ na_sm_op_create(na_class_t *na_class, unsigned long flags);
 static void
 na_sm_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
 
+/* op_reset */
+static na_return_t
+na_sm_op_reset(na_class_t *na_class, na_op_id_t *op_id);
+
 /* addr_lookup */
 static na_return_t
 na_sm_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p);
 
+/* addr_warm */
+static na_return_t
+na_sm_addr_warm(na_class_t *na_class, na_addr_t *const *addrs, size_t count);
+
 /* addr_free */
 static void
 na_sm_addr_free(na_class_t *na_class, na_addr_t *addr);
@@ -995,6 +1547,12 @@ na_sm_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
     na_op_id_t *op_id);
 
+/* msg_multi_recv_unexpected */
+static na_return_t
+na_sm_msg_multi_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
+    na_op_id_t *op_id);
+
 /* msg_send_expected */
 static na_return_t
 na_sm_msg_send_expected(na_class_t *na_class, na_context_t *context,
@@ -1008,6 +1566,12 @@ na_sm_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
     na_addr_t *source_addr, uint8_t source_id, na_tag_t tag, na_op_id_t *op_id);
 
+/* msg_send_batch */
+static na_return_t
+na_sm_msg_send_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+    size_t count, size_t *posted_count_p);
+
 /* mem_handle_create */
 static na_return_t
 na_sm_mem_handle_create(na_class_t *na_class, void *buf, size_t buf_size,
@@ -1029,7 +1593,14 @@ na_sm_mem_handle_free(na_class_t *na_class, na_mem_handle_t *mem_handle);
 static size_t
 na_sm_mem_handle_get_max_segments(const na_class_t *na_class);
 
-/* mem_handle_get_serialize_size */
+#ifdef NA_SM_HAS_CUDA
+/* mem_register */
+static na_return_t
+na_sm_mem_register(na_class_t *na_class, na_mem_handle_t *mem_handle,
+    enum na_mem_type mem_type, uint64_t device);
+#endif
+
+/* mem_handle_get_serialize_size */
 static NA_INLINE size_t
 na_sm_mem_handle_get_serialize_size(
     na_class_t *na_class, na_mem_handle_t *mem_handle);
@@ -1060,6 +1631,13 @@ na_sm_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     size_t length, na_addr_t *remote_addr, uint8_t remote_id,
     na_op_id_t *op_id);
 
+/* atomic */
+static na_return_t
+na_sm_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id);
+
 /* poll_get_fd */
 static NA_INLINE int
 na_sm_poll_get_fd(na_class_t *na_class, na_context_t *context);
@@ -1088,12 +1666,16 @@ const struct na_class_ops NA_PLUGIN_OPS(sm) = {
     na_sm_initialize,                  /* initialize */
     na_sm_finalize,                    /* finalize */
     na_sm_cleanup,                     /* cleanup */
-    NULL,                              /* has_opt_feature */
+    na_sm_has_opt_feature,             /* has_opt_feature */
+    NULL,                              /* get_numa_node */
     na_sm_context_create,              /* context_create */
     na_sm_context_destroy,             /* context_destroy */
     na_sm_op_create,                   /* op_create */
     na_sm_op_destroy,                  /* op_destroy */
+    na_sm_op_reset,                    /* op_reset */
     na_sm_addr_lookup,                 /* addr_lookup */
+    NULL,                              /* addr_lookup_batch */
+    na_sm_addr_warm,                   /* addr_warm */
     na_sm_addr_free,                   /* addr_free */
     NULL,                              /* addr_set_remove */
     na_sm_addr_self,                   /* addr_self */
@@ -1114,10 +1696,11 @@ const struct na_class_ops NA_PLUGIN_OPS(sm) = {
     NULL,                              /* msg_init_unexpected */
     na_sm_msg_send_unexpected,         /* msg_send_unexpected */
     na_sm_msg_recv_unexpected,         /* msg_recv_unexpected */
-    NULL,                              /* msg_multi_recv_unexpected */
+    na_sm_msg_multi_recv_unexpected,   /* msg_multi_recv_unexpected */
     NULL,                              /* msg_init_expected */
     na_sm_msg_send_expected,           /* msg_send_expected */
     na_sm_msg_recv_expected,           /* msg_recv_expected */
+    na_sm_msg_send_batch,              /* msg_send_batch */
     na_sm_mem_handle_create,           /* mem_handle_create */
 #ifdef NA_SM_HAS_CMA
     na_sm_mem_handle_create_segments, /* mem_handle_create_segments */
@@ -1126,13 +1709,20 @@ const struct na_class_ops NA_PLUGIN_OPS(sm) = {
 #endif
     na_sm_mem_handle_free,               /* mem_handle_free */
     na_sm_mem_handle_get_max_segments,   /* mem_handle_get_max_segments */
-    NULL,                                /* mem_register */
+#ifdef NA_SM_HAS_CUDA
+    na_sm_mem_register, /* mem_register */
+#else
+    NULL, /* mem_register */
+#endif
     NULL,                                /* mem_deregister */
     na_sm_mem_handle_get_serialize_size, /* mem_handle_get_serialize_size */
     na_sm_mem_handle_serialize,          /* mem_handle_serialize */
     na_sm_mem_handle_deserialize,        /* mem_handle_deserialize */
     na_sm_put,                           /* put */
     na_sm_get,                           /* get */
+    NULL,                                /* rma_batch_get_max_segments */
+    NULL,                                /* rma_batch */
+    na_sm_atomic,                        /* atomic */
     na_sm_poll_get_fd,                   /* poll_get_fd */
     na_sm_poll_try_wait,                 /* poll_try_wait */
     na_sm_progress,                      /* progress */
@@ -1360,25 +1950,132 @@ na_sm_errno_to_na(int rc)
 
 /*---------------------------------------------------------------------------*/
 static void *
-na_sm_shm_map(const char *name, size_t length, bool create)
+na_sm_shm_map(const char *name, size_t length, bool create, bool *huge_p)
 {
     size_t page_size = (size_t) hg_mem_get_page_size();
+    bool huge = create && *huge_p;
+    void *addr;
 
     /* Check alignment */
     NA_CHECK_SUBSYS_WARNING(mem, length / page_size * page_size != length,
         "Not aligned properly, page size=%zu bytes, length=%zu bytes",
         page_size, length);
 
-    return hg_mem_shm_map(name, length, create);
+    if (create) {
+        char path[NA_SM_MAX_FILENAME + sizeof(NA_SM_HUGETLBFS_PATH)];
+        int rc = NA_SM_PRINT_HUGETLBFS_PATH(path, sizeof(path), name);
+
+        /* Remove stale hugetlbfs object so that peers, which always look it up
+         * first, do not map it instead of the new object */
+        if (rc > 0 && rc < (int) sizeof(path))
+            (void) unlink(path);
+    }
+
+    if (huge || !create) {
+        addr = na_sm_hugetlb_map(name, length, create);
+        if (addr != NULL) {
+            *huge_p = true;
+            return addr;
+        }
+
+        if (create)
+            NA_LOG_SUBSYS_DEBUG(mem,
+                "Could not map %s from hugetlbfs, using regular pages", name);
+    }
+    *huge_p = false;
+
+    addr = hg_mem_shm_map(name, length, create);
+#ifdef MADV_HUGEPAGE
+    /* Transparent huge pages may still back shmem if set to advise mode */
+    if (addr != NULL && huge)
+        (void) madvise(addr, length, MADV_HUGEPAGE);
+#endif
+
+    return addr;
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_shm_unmap(const char *name, void *addr, size_t length)
+na_sm_shm_unmap(const char *name, void *addr, size_t length, bool huge)
+{
+    char path[NA_SM_MAX_FILENAME + sizeof(NA_SM_HUGETLBFS_PATH)];
+    int rc;
+
+    if (!huge)
+        return (hg_mem_shm_unmap(name, addr, length) == HG_UTIL_SUCCESS)
+                   ? NA_SUCCESS
+                   : na_sm_errno_to_na(errno);
+
+    /* Huge page mappings must be unmapped in multiples of huge page size */
+    if (addr != NULL) {
+        rc = munmap(addr,
+            NA_SM_ALIGN(length, (size_t) hg_mem_get_hugepage_size()));
+        NA_CHECK_SUBSYS_ERROR_NORET(mem, rc != 0, error,
+            "munmap() failed (%s)", strerror(errno));
+    }
+
+    if (name != NULL) {
+        rc = NA_SM_PRINT_HUGETLBFS_PATH(path, sizeof(path), name);
+        NA_CHECK_SUBSYS_ERROR_NORET(mem, rc < 0 || rc >= (int) sizeof(path),
+            error, "NA_SM_PRINT_HUGETLBFS_PATH() failed, rc: %d", rc);
+
+        rc = unlink(path);
+        NA_CHECK_SUBSYS_ERROR_NORET(mem, rc != 0, error,
+            "unlink() failed (%s)", strerror(errno));
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return na_sm_errno_to_na(errno);
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+na_sm_hugetlb_map(const char *name, size_t length, bool create)
 {
-    return (hg_mem_shm_unmap(name, addr, length) == HG_UTIL_SUCCESS)
-               ? NA_SUCCESS
-               : na_sm_errno_to_na(errno);
+    char path[NA_SM_MAX_FILENAME + sizeof(NA_SM_HUGETLBFS_PATH)];
+    size_t huge_page_size;
+    void *addr;
+    int fd, rc;
+
+    rc = NA_SM_PRINT_HUGETLBFS_PATH(path, sizeof(path), name);
+    if (rc < 0 || rc >= (int) sizeof(path))
+        return NULL;
+
+    /* Peers probe hugetlbfs in case the region was created there, failing to
+     * open the file is therefore not an error */
+    fd = open(path, O_RDWR | (create ? (O_CREAT | O_EXCL) : 0),
+        S_IRUSR | S_IWUSR);
+    if (fd < 0)
+        return NULL;
+
+    huge_page_size = (size_t) hg_mem_get_hugepage_size();
+    if (huge_page_size == 0)
+        goto error;
+    length = NA_SM_ALIGN(length, huge_page_size);
+
+    /* Huge pages are reserved on mmap(), which fails if not enough of them
+     * are available */
+    if (create && ftruncate(fd, (off_t) length) != 0)
+        goto error;
+    addr = mmap(NULL, length, PROT_WRITE | PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+        goto error;
+    (void) close(fd);
+
+    NA_LOG_SUBSYS_DEBUG(
+        mem, "Mapped %s (%zu bytes) using huge pages", path, length);
+
+    return addr;
+
+error:
+    NA_LOG_SUBSYS_DEBUG(mem, "Could not map %s (%s)", path, strerror(errno));
+    (void) close(fd);
+    if (create)
+        (void) unlink(path);
+
+    return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1400,23 +2097,38 @@ na_sm_shm_cleanup(const char *fpath, const struct stat NA_UNUSED *sb,
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-na_sm_msg_queue_init(struct na_sm_msg_queue *na_sm_queue)
+static int
+na_sm_hugetlb_cleanup(const char *fpath, const struct stat NA_UNUSED *sb,
+    int NA_UNUSED typeflag, struct FTW NA_UNUSED *ftwbuf)
 {
-    unsigned int count = NA_SM_NUM_BUFS;
+    const char *prefix = NA_SM_HUGETLBFS_PATH "/" NA_SM_SHM_PREFIX "-";
+    int ret = 0;
+
+    if (strncmp(fpath, prefix, strlen(prefix)) == 0) {
+        NA_LOG_SUBSYS_DEBUG(mem, "unlink() %s", fpath);
+        ret = unlink(fpath);
+    }
+
+    return ret;
+}
 
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_msg_queue_init(struct na_sm_msg_queue *na_sm_queue, unsigned int count)
+{
     na_sm_queue->prod_size = na_sm_queue->cons_size = count;
     na_sm_queue->prod_mask = na_sm_queue->cons_mask = count - 1;
     hg_atomic_init32(&na_sm_queue->prod_head, 0);
     hg_atomic_init32(&na_sm_queue->cons_head, 0);
     hg_atomic_init32(&na_sm_queue->prod_tail, 0);
     hg_atomic_init32(&na_sm_queue->cons_tail, 0);
+    hg_atomic_init32(&na_sm_queue->cons_waiting, 0);
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE bool
-na_sm_msg_queue_push(
-    struct na_sm_msg_queue *na_sm_queue, const union na_sm_msg_hdr *msg_hdr)
+na_sm_msg_queue_push(struct na_sm_msg_queue *na_sm_queue,
+    const union na_sm_msg_hdr *msg_hdr, const void *buf)
 {
     int32_t prod_head, prod_next, cons_tail;
 
@@ -1437,7 +2149,11 @@ na_sm_msg_queue_push(
         }
     } while (!hg_atomic_cas32(&na_sm_queue->prod_head, prod_head, prod_next));
 
-    hg_atomic_set64(&na_sm_queue->ring[prod_head], (int64_t) msg_hdr->val);
+    /* Payload is published along with the header by the prod_tail update */
+    if (msg_hdr->hdr.inline_buf)
+        memcpy(na_sm_queue->ring[prod_head].buf, buf, msg_hdr->hdr.buf_size);
+    hg_atomic_set64(
+        &na_sm_queue->ring[prod_head].hdr, (int64_t) msg_hdr->val);
 
     /*
      * If there are other enqueues in progress
@@ -1452,10 +2168,57 @@ na_sm_msg_queue_push(
     return true;
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE unsigned int
+na_sm_msg_queue_push_batch(struct na_sm_msg_queue *na_sm_queue,
+    const union na_sm_msg_hdr *msg_hdrs, const void *const *bufs,
+    unsigned int count)
+{
+    int32_t prod_head, prod_next, cons_tail;
+    unsigned int n, i;
+
+    do {
+        prod_head = hg_atomic_get32(&na_sm_queue->prod_head);
+        cons_tail = hg_atomic_get32(&na_sm_queue->cons_tail);
+        n = (unsigned int) ((cons_tail - prod_head - 1) &
+                            (int) na_sm_queue->prod_mask);
+
+        if (n == 0) {
+            hg_atomic_fence();
+            if (prod_head == hg_atomic_get32(&na_sm_queue->prod_head) &&
+                cons_tail == hg_atomic_get32(&na_sm_queue->cons_tail)) {
+                na_sm_queue->drops++;
+                /* Full */
+                return 0;
+            }
+            continue;
+        }
+        n = MIN(n, count);
+        prod_next = (prod_head + (int32_t) n) & (int) na_sm_queue->prod_mask;
+    } while (!hg_atomic_cas32(&na_sm_queue->prod_head, prod_head, prod_next));
+
+    for (i = 0; i < n; i++) {
+        int32_t idx = (prod_head + (int32_t) i) & (int) na_sm_queue->prod_mask;
+
+        if (msg_hdrs[i].hdr.inline_buf)
+            memcpy(
+                na_sm_queue->ring[idx].buf, bufs[i], msg_hdrs[i].hdr.buf_size);
+        hg_atomic_set64(&na_sm_queue->ring[idx].hdr, (int64_t) msg_hdrs[i].val);
+    }
+
+    /* Wait for preceding enqueues, then publish all entries at once */
+    while (hg_atomic_get32(&na_sm_queue->prod_tail) != prod_head)
+        cpu_spinwait();
+
+    hg_atomic_set32(&na_sm_queue->prod_tail, prod_next);
+
+    return n;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE bool
-na_sm_msg_queue_pop(
-    struct na_sm_msg_queue *na_sm_queue, union na_sm_msg_hdr *msg_hdr)
+na_sm_msg_queue_pop(struct na_sm_msg_queue *na_sm_queue,
+    union na_sm_msg_hdr *msg_hdr, void *buf)
 {
     int32_t cons_head, cons_next;
 
@@ -1467,7 +2230,12 @@ na_sm_msg_queue_pop(
             return false;
     } while (!hg_atomic_cas32(&na_sm_queue->cons_head, cons_head, cons_next));
 
-    msg_hdr->val = (uint64_t) hg_atomic_get64(&na_sm_queue->ring[cons_head]);
+    msg_hdr->val =
+        (uint64_t) hg_atomic_get64(&na_sm_queue->ring[cons_head].hdr);
+
+    /* Entry may be reused by producers once cons_tail moves past it */
+    if (msg_hdr->hdr.inline_buf)
+        memcpy(buf, na_sm_queue->ring[cons_head].buf, msg_hdr->hdr.buf_size);
 
     /*
      * If there are other dequeues in progress
@@ -1491,11 +2259,18 @@ na_sm_msg_queue_is_empty(struct na_sm_msg_queue *na_sm_queue)
 }
 
 /*---------------------------------------------------------------------------*/
-static void
-na_sm_cmd_queue_init(struct na_sm_cmd_queue *na_sm_queue)
+static NA_INLINE bool
+na_sm_msg_queue_has_waiter(struct na_sm_msg_queue *na_sm_queue)
 {
-    unsigned int count = NA_SM_MAX_PEERS * 2;
+    /* RMW orders the prior push with the consumer arming its wait so that
+     * either the consumer sees the message or we see the consumer waiting */
+    return hg_atomic_or32(&na_sm_queue->cons_waiting, 0) > 0;
+}
 
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_cmd_queue_init(struct na_sm_cmd_queue *na_sm_queue, unsigned int count)
+{
     na_sm_queue->prod_size = na_sm_queue->cons_size = count;
     na_sm_queue->prod_mask = na_sm_queue->cons_mask = count - 1;
     hg_atomic_init32(&na_sm_queue->prod_head, 0);
@@ -1620,12 +2395,69 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_region_layout_init(unsigned int pair_count, unsigned int buf_count,
+    unsigned int buf_size, struct na_sm_region_layout *layout)
+{
+    size_t offset =
+        NA_SM_ALIGN(sizeof(struct na_sm_region), NA_SM_CACHE_LINE_SIZE);
+
+    layout->pair_count = pair_count;
+    layout->buf_count = buf_count;
+    layout->buf_size = buf_size;
+
+    /* To be safe, make the cmd queue twice as large as the number of pairs */
+    layout->cmd_queue_offset = offset;
+    offset += sizeof(struct na_sm_cmd_queue) +
+              (size_t) pair_count * 2 * sizeof(hg_atomic_int64_t);
+    offset = NA_SM_ALIGN(offset, NA_SM_CACHE_LINE_SIZE);
+
+    layout->doorbell_offset = offset;
+    offset += sizeof(struct na_sm_doorbell) +
+              (pair_count / 64) * sizeof(hg_atomic_int64_t);
+    offset = NA_SM_ALIGN(offset, NA_SM_CACHE_LINE_SIZE);
+
+    /* One cache-line padded bitmask per 64 pairs */
+    layout->pairs_available_offset = offset;
+    offset += (pair_count / 64) * sizeof(union na_sm_cacheline_atomic_int64);
+
+    /* One cache-line padded bitmask per 64 buffers */
+    layout->available_offset = offset;
+    offset += (buf_count / 64) * sizeof(union na_sm_cacheline_atomic_int64);
+
+    layout->buf_locks_offset = offset;
+    offset += buf_count * sizeof(hg_thread_spin_t);
+
+    /* Buffers are page aligned */
+    offset = NA_SM_ALIGN(offset, NA_SM_PAGE_SIZE);
+    layout->bufs_offset = offset;
+    offset += (size_t) buf_count * buf_size;
+
+    /* Queues can hold as many messages as there are buffers, each queue is
+     * page aligned so that it can be placed on the NUMA node of its consumer
+     * and is only initialized once its pair is first reserved, pages of pairs
+     * that are never used are therefore never touched */
+    layout->queue_size =
+        NA_SM_ALIGN(sizeof(struct na_sm_msg_queue) +
+                        buf_count * sizeof(struct na_sm_msg_entry),
+            NA_SM_PAGE_SIZE);
+    offset = NA_SM_ALIGN(offset, NA_SM_PAGE_SIZE);
+    layout->queue_pairs_offset = offset;
+    offset += (size_t) pair_count * 2 * layout->queue_size;
+
+    layout->size = NA_SM_ALIGN(offset, NA_SM_PAGE_SIZE);
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_region_open(const char *uri, bool create, struct na_sm_region **region_p)
+na_sm_region_open(const char *uri, bool create, unsigned int pair_count,
+    unsigned int buf_count, unsigned int buf_size, bool huge,
+    struct na_sm_region **region_p)
 {
     char filename[NA_SM_MAX_FILENAME];
     struct na_sm_region *na_sm_region = NULL;
+    struct na_sm_region_layout layout;
     na_return_t ret = NA_SUCCESS;
     int rc;
 
@@ -1634,37 +2466,78 @@ na_sm_region_open(const char *uri, bool create, struct na_sm_region **region_p)
     NA_CHECK_SUBSYS_ERROR(cls, rc < 0 || rc > NA_SM_MAX_FILENAME, done, ret,
         NA_OVERFLOW, "NA_SM_PRINT_SHM_NAME() failed, rc: %d", rc);
 
+    if (create)
+        na_sm_region_layout_init(pair_count, buf_count, buf_size, &layout);
+    else {
+        /* Retrieve layout chosen by region owner from region header */
+        NA_LOG_SUBSYS_DEBUG(cls, "shm_map() %s", filename);
+        na_sm_region = (struct na_sm_region *) na_sm_shm_map(filename,
+            NA_SM_ALIGN(sizeof(*na_sm_region), NA_SM_PAGE_SIZE), false, &huge);
+        NA_CHECK_SUBSYS_ERROR(cls, na_sm_region == NULL, done, ret, NA_NODEV,
+            "Could not map SM region (%s)", filename);
+        layout = na_sm_region->layout;
+
+        ret = na_sm_shm_unmap(NULL, na_sm_region,
+            NA_SM_ALIGN(sizeof(*na_sm_region), NA_SM_PAGE_SIZE), huge);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not unmap SM region");
+    }
+
     /* Open SHM object */
-    NA_LOG_SUBSYS_DEBUG(cls, "shm_map() %s", filename);
+    NA_LOG_SUBSYS_DEBUG(cls,
+        "shm_map() %s (%zu bytes, %u pairs, %u buffers of %u bytes)", filename,
+        layout.size, layout.pair_count, layout.buf_count, layout.buf_size);
     na_sm_region = (struct na_sm_region *) na_sm_shm_map(
-        filename, sizeof(struct na_sm_region), create);
+        filename, layout.size, create, &huge);
     NA_CHECK_SUBSYS_ERROR(cls, na_sm_region == NULL, done, ret, NA_NODEV,
         "Could not map new SM region (%s)", filename);
 
     if (create) {
-        int i;
+        union na_sm_cacheline_atomic_int64 *available =
+            NA_SM_REGION_PTR(na_sm_region, layout.available_offset);
+        union na_sm_cacheline_atomic_int64 *pairs_available =
+            NA_SM_REGION_PTR(na_sm_region, layout.pairs_available_offset);
+        hg_thread_spin_t *buf_locks =
+            NA_SM_REGION_PTR(na_sm_region, layout.buf_locks_offset);
+        struct na_sm_doorbell *doorbell =
+            NA_SM_REGION_PTR(na_sm_region, layout.doorbell_offset);
+        unsigned int i;
+
+#ifdef NA_SM_HAS_NUMA
+        /* Region is first consumed by its owner, peers move their own rx
+         * queues once they reserve a queue pair */
+        na_sm_region_numa_bind(filename, na_sm_region, layout.size);
+#endif
 
-        /* Initialize copy buf (all buffers are available by default) */
-        hg_atomic_init64(
-            &na_sm_region->copy_bufs.available.val, ~((int64_t) 0));
-        memset(&na_sm_region->copy_bufs.buf, 0,
-            sizeof(na_sm_region->copy_bufs.buf));
+        na_sm_region->layout = layout;
+        na_sm_region->layout.huge = huge;
+
+        /* Initialize copy buf (all buffers are available by default, shm
+         * object is zero-filled on creation) */
+        for (i = 0; i < layout.buf_count / 64; i++)
+            hg_atomic_init64(&available[i].val, ~((int64_t) 0));
 
         /* Initialize locks */
-        for (i = 0; i < NA_SM_NUM_BUFS; i++)
-            hg_thread_spin_init(&na_sm_region->copy_bufs.buf_locks[i]);
+        for (i = 0; i < layout.buf_count; i++)
+            hg_thread_spin_init(&buf_locks[i]);
 
-        /* Initialize queue pairs */
-        for (i = 0; i < 4; i++)
-            hg_atomic_init64(&na_sm_region->available.val[i], ~((int64_t) 0));
+        /* Initialize queue pairs (msg queues are initialized on first
+         * reserve) */
+        for (i = 0; i < layout.pair_count / 64; i++)
+            hg_atomic_init64(&pairs_available[i].val, ~((int64_t) 0));
 
-        for (i = 0; i < NA_SM_MAX_PEERS; i++) {
-            na_sm_msg_queue_init(&na_sm_region->queue_pairs[i].rx_queue);
-            na_sm_msg_queue_init(&na_sm_region->queue_pairs[i].tx_queue);
-        }
+        /* Initialize doorbell */
+        for (i = 0; i < layout.pair_count / 64; i++)
+            hg_atomic_init64(&doorbell->pending[i], 0);
+        hg_atomic_init64(&doorbell->waiting, 0);
+        hg_atomic_init32(&na_sm_region->reclaim, 0);
+
+        /* Initialize atomic locks */
+        for (i = 0; i < NA_SM_ATOMIC_LOCKS; i++)
+            hg_thread_spin_init(&na_sm_region->atomic_locks.val[i]);
 
         /* Initialize command queue */
-        na_sm_cmd_queue_init(&na_sm_region->cmd_queue);
+        na_sm_cmd_queue_init(
+            na_sm_region_cmd_queue(na_sm_region), layout.pair_count * 2);
     }
 
     *region_p = na_sm_region;
@@ -1691,7 +2564,8 @@ na_sm_region_close(const char *uri, struct na_sm_region *region)
 
     NA_LOG_SUBSYS_DEBUG(
         cls, "shm_unmap() %s", (filename_p == NULL) ? "is NULL" : filename_p);
-    ret = na_sm_shm_unmap(filename_p, region, sizeof(struct na_sm_region));
+    ret = na_sm_shm_unmap(
+        filename_p, region, region->layout.size, region->layout.huge);
     NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not unmap SM region (%s)",
         (filename_p == NULL) ? "is NULL" : filename_p);
 
@@ -1706,6 +2580,7 @@ na_sm_region_get_addr_key(const char *uri, struct na_sm_addr_key *addr_key_p)
     char filename[NA_SM_MAX_FILENAME];
     struct na_sm_region *na_sm_region = NULL;
     na_return_t ret = NA_SUCCESS;
+    bool huge = false;
     int rc;
 
     /* Generate SHM object name */
@@ -1715,22 +2590,97 @@ na_sm_region_get_addr_key(const char *uri, struct na_sm_addr_key *addr_key_p)
 
     /* Open SHM object */
     NA_LOG_SUBSYS_DEBUG(cls, "shm_map() %s", filename);
-    na_sm_region = (struct na_sm_region *) na_sm_shm_map(
-        filename, sizeof(struct na_sm_region), false);
+    na_sm_region = (struct na_sm_region *) na_sm_shm_map(filename,
+        NA_SM_ALIGN(sizeof(*na_sm_region), NA_SM_PAGE_SIZE), false, &huge);
     NA_CHECK_SUBSYS_ERROR(cls, na_sm_region == NULL, done, ret, NA_NODEV,
         "Could not map SM region (%s)", filename);
 
     /* Copy addr_key */
     *addr_key_p = na_sm_region->addr_key;
 
-    /* Close SHM object */
-    ret = na_sm_shm_unmap(NULL, na_sm_region, sizeof(struct na_sm_region));
+    /* Close SHM object (only header was mapped) */
+    ret = na_sm_shm_unmap(NULL, na_sm_region,
+        NA_SM_ALIGN(sizeof(*na_sm_region), NA_SM_PAGE_SIZE), huge);
     NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not unmap SM region");
 
 done:
     return ret;
 }
 
+#ifdef NA_SM_HAS_NUMA
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_region_numa_bind(const char NA_UNUSED *name, void *addr, size_t len)
+{
+    unsigned long nodemask;
+    unsigned int cpu, node;
+
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0 ||
+        node >= sizeof(nodemask) * 8) {
+        NA_LOG_SUBSYS_DEBUG(mem, "Could not get NUMA node of CPU");
+        return;
+    }
+    nodemask = 1UL << node;
+
+    /* Best effort, pages already mapped by peers may not be moved */
+    if (syscall(SYS_mbind, addr, len, MPOL_PREFERRED, &nodemask,
+            sizeof(nodemask) * 8, MPOL_MF_MOVE) != 0)
+        NA_LOG_SUBSYS_DEBUG(mem, "mbind() failed for %s (%s)", name,
+            strerror(errno));
+    else
+        NA_LOG_SUBSYS_DEBUG(mem, "Placed %s (%zu bytes) on NUMA node %u",
+            name, len, node);
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE struct na_sm_msg_queue *
+na_sm_region_queue(
+    struct na_sm_region *na_sm_region, uint16_t queue_pair_idx, bool tx)
+{
+    /* Queue pairs are stored as consecutive tx / rx queues */
+    return (struct na_sm_msg_queue *) NA_SM_REGION_PTR(na_sm_region,
+        na_sm_region->layout.queue_pairs_offset +
+            ((size_t) queue_pair_idx * 2 + (tx ? 0 : 1)) *
+                na_sm_region->layout.queue_size);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE struct na_sm_cmd_queue *
+na_sm_region_cmd_queue(struct na_sm_region *na_sm_region)
+{
+    return (struct na_sm_cmd_queue *) NA_SM_REGION_PTR(
+        na_sm_region, na_sm_region->layout.cmd_queue_offset);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE struct na_sm_doorbell *
+na_sm_region_doorbell(struct na_sm_region *na_sm_region)
+{
+    return (struct na_sm_doorbell *) NA_SM_REGION_PTR(
+        na_sm_region, na_sm_region->layout.doorbell_offset);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_region_doorbell_ring(
+    struct na_sm_region *na_sm_region, uint16_t queue_pair_idx)
+{
+    /* RMW orders the prior push with the owner clearing the pending bits */
+    hg_atomic_or64(
+        &na_sm_region_doorbell(na_sm_region)->pending[queue_pair_idx / 64],
+        (int64_t) ((uint64_t) 1 << (queue_pair_idx % 64)));
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE bool
+na_sm_region_has_waiter(struct na_sm_region *na_sm_region)
+{
+    /* Same cache line as the pending bits of the first pairs */
+    return hg_atomic_or64(&na_sm_region_doorbell(na_sm_region)->waiting, 0) >
+           0;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_sock_open(const char *uri, bool create, int *sock)
@@ -1928,7 +2878,7 @@ na_sm_sock_path_cleanup(const char *fpath, const struct stat NA_UNUSED *sb,
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_event_create(const char NA_UNUSED *uri, uint8_t NA_UNUSED pair_index,
+na_sm_event_create(const char NA_UNUSED *uri, uint16_t NA_UNUSED pair_index,
     unsigned char NA_UNUSED pair, int *event)
 {
     na_return_t ret = NA_SUCCESS;
@@ -1988,7 +2938,7 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_event_destroy(const char NA_UNUSED *uri, uint8_t NA_UNUSED pair_index,
+na_sm_event_destroy(const char NA_UNUSED *uri, uint16_t NA_UNUSED pair_index,
     unsigned char NA_UNUSED pair, bool NA_UNUSED remove, int event)
 {
     na_return_t ret = NA_SUCCESS;
@@ -2113,16 +3063,17 @@ done:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *name,
-    bool listen, bool no_wait, uint32_t nofile_max)
+    bool listen, bool no_wait, uint32_t nofile_max, unsigned int pair_count,
+    unsigned int buf_count, unsigned int buf_size, bool huge_pages)
 {
     static hg_atomic_int32_t sm_id_g = HG_ATOMIC_VAR_INIT(0);
     struct na_sm_addr_key addr_key = {0, 0};
     struct na_sm_region *shared_region = NULL;
     char uri[NA_SM_MAX_FILENAME], *uri_p = NULL;
-    uint8_t queue_pair_idx = 0;
+    uint16_t queue_pair_idx = 0;
     bool queue_pair_reserved = false, sock_registered = false,
          tx_notify_registered = false;
-    int tx_notify = -1, rx_notify = -1;
+    int tx_notify = -1, rx_notify = -1, rc;
     na_return_t ret = NA_SUCCESS, err_ret;
 
     /* Get PID */
@@ -2152,8 +3103,17 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *name,
     HG_QUEUE_INIT(&na_sm_endpoint->retry_op_queue.queue);
     hg_thread_spin_init(&na_sm_endpoint->retry_op_queue.lock);
 
+    HG_QUEUE_INIT(&na_sm_endpoint->rma_op_queue.queue);
+    hg_thread_spin_init(&na_sm_endpoint->rma_op_queue.lock);
+
+    HG_QUEUE_INIT(&na_sm_endpoint->rma_ack_queue.queue);
+    hg_thread_spin_init(&na_sm_endpoint->rma_ack_queue.lock);
+    hg_backoff_init(&na_sm_endpoint->retry_backoff, NA_SM_RETRY_BACKOFF_MIN,
+        NA_SM_RETRY_BACKOFF_MAX);
+
     /* Initialize number of fds */
     hg_atomic_init32(&na_sm_endpoint->nofile, 0);
+    hg_atomic_init32(&na_sm_endpoint->armed, 0);
     na_sm_endpoint->nofile_max = nofile_max;
 
     /* Initialize poll addr list */
@@ -2162,10 +3122,12 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *name,
 
     /* Create addr hash-table */
     na_sm_endpoint->addr_map.map =
-        hg_hash_table_new(na_sm_addr_key_hash, na_sm_addr_key_equal);
+        hg_oa_hash_table_new(na_sm_addr_key_hash, na_sm_addr_key_equal);
     NA_CHECK_SUBSYS_ERROR(cls, na_sm_endpoint->addr_map.map == NULL, error, ret,
-        NA_NOMEM, "hg_hash_table_new() failed");
-    hg_thread_rwlock_init(&na_sm_endpoint->addr_map.lock);
+        NA_NOMEM, "hg_oa_hash_table_new() failed");
+    rc = hg_thread_brlock_init(&na_sm_endpoint->addr_map.lock);
+    NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+        "hg_thread_brlock_init() failed");
 
     if (listen) {
         /* Create URI */
@@ -2178,8 +3140,6 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *name,
                 name);
             strncpy(uri, name, NA_SM_MAX_FILENAME - 1);
         } else {
-            int rc;
-
             NA_LOG_SUBSYS_DEBUG(cls,
                 "No endpoint name, generating URI from PID=%d, ID=%u",
                 addr_key.pid, addr_key.id);
@@ -2191,10 +3151,19 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *name,
         uri_p = uri;
 
         /* If we're listening, create a new shm region using URI */
-        ret = na_sm_region_open(uri_p, true, &shared_region);
+        ret = na_sm_region_open(uri_p, true, pair_count, buf_count, buf_size,
+            huge_pages, &shared_region);
         NA_CHECK_SUBSYS_NA_ERROR(
             cls, error, ret, "Could not open shared-memory region");
 
+        /* Addresses of local queue pairs */
+        na_sm_endpoint->pair_addrs = (struct na_sm_addr **) calloc(
+            pair_count, sizeof(*na_sm_endpoint->pair_addrs));
+        NA_CHECK_SUBSYS_ERROR(cls, na_sm_endpoint->pair_addrs == NULL, error,
+            ret, NA_NOMEM, "Could not allocate array of %u pair addrs",
+            pair_count);
+        na_sm_endpoint->pair_count = pair_count;
+
         /* Keep addr key in shared-region in case URI does not have PID/ID */
         shared_region->addr_key = addr_key;
 
@@ -2254,10 +3223,11 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *name,
         na_sm_endpoint->source_addr->shared_region = shared_region;
 
         na_sm_endpoint->source_addr->tx_queue =
-            &shared_region->queue_pairs[queue_pair_idx].tx_queue;
+            na_sm_region_queue(shared_region, queue_pair_idx, true);
         /* Tx = Rx for loopback */
         na_sm_endpoint->source_addr->rx_queue =
             na_sm_endpoint->source_addr->tx_queue;
+        na_sm_endpoint->source_addr->tx_doorbell = true;
     }
 
     /* Add source tx/rx notify to poll set for local notifications */
@@ -2285,10 +3255,10 @@ na_sm_endpoint_open(struct na_sm_endpoint *na_sm_endpoint, const char *name,
     hg_atomic_or32(&na_sm_endpoint->source_addr->status, NA_SM_ADDR_RESOLVED);
 
     if (listen) {
-        /* Add address to list of addresses to poll */
+        /* Local queue pairs are polled through the doorbell */
         hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
-        HG_LIST_INSERT_HEAD(&na_sm_endpoint->poll_addr_list.list,
-            na_sm_endpoint->source_addr, entry);
+        na_sm_endpoint->pair_addrs[queue_pair_idx] =
+            na_sm_endpoint->source_addr;
         hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
     }
 
@@ -2331,15 +3301,20 @@ error:
         na_sm_queue_pair_release(shared_region, queue_pair_idx);
     if (shared_region)
         na_sm_region_close(uri_p, shared_region);
+    free(na_sm_endpoint->pair_addrs);
+    na_sm_endpoint->pair_addrs = NULL;
+    na_sm_endpoint->pair_count = 0;
     if (na_sm_endpoint->addr_map.map) {
-        hg_hash_table_free(na_sm_endpoint->addr_map.map);
-        hg_thread_rwlock_destroy(&na_sm_endpoint->addr_map.lock);
+        hg_oa_hash_table_free(na_sm_endpoint->addr_map.map);
+        hg_thread_brlock_destroy(&na_sm_endpoint->addr_map.lock);
     }
 
     hg_thread_spin_destroy(&na_sm_endpoint->unexpected_msg_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->unexpected_op_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->expected_op_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->retry_op_queue.lock);
+    hg_thread_spin_destroy(&na_sm_endpoint->rma_op_queue.lock);
+    hg_thread_spin_destroy(&na_sm_endpoint->rma_ack_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->poll_addr_list.lock);
 
     return ret;
@@ -2351,8 +3326,19 @@ na_sm_endpoint_close(struct na_sm_endpoint *na_sm_endpoint)
 {
     struct na_sm_addr *source_addr = na_sm_endpoint->source_addr;
     na_return_t ret = NA_SUCCESS;
+    unsigned int i;
     bool empty;
 
+    /* Drop acks of peers that never made room for them */
+    while (!HG_QUEUE_IS_EMPTY(&na_sm_endpoint->rma_ack_queue.queue)) {
+        struct na_sm_rma_ack *na_sm_rma_ack =
+            HG_QUEUE_FIRST(&na_sm_endpoint->rma_ack_queue.queue);
+
+        HG_QUEUE_POP_HEAD(&na_sm_endpoint->rma_ack_queue.queue, entry);
+        na_sm_addr_ref_decr(na_sm_rma_ack->na_sm_addr);
+        free(na_sm_rma_ack);
+    }
+
     /* Check that poll addr list is empty */
     empty = HG_LIST_IS_EMPTY(&na_sm_endpoint->poll_addr_list.list);
     if (!empty) {
@@ -2375,6 +3361,15 @@ na_sm_endpoint_close(struct na_sm_endpoint *na_sm_endpoint)
     NA_CHECK_SUBSYS_ERROR(cls, empty == false, done, ret, NA_BUSY,
         "Poll addr list should be empty");
 
+    /* Destroy remaining addresses of local queue pairs */
+    for (i = 0; i < na_sm_endpoint->pair_count; i++) {
+        struct na_sm_addr *na_sm_addr = na_sm_endpoint->pair_addrs[i];
+
+        na_sm_endpoint->pair_addrs[i] = NULL;
+        if (na_sm_addr != NULL && na_sm_addr != source_addr)
+            na_sm_addr_destroy(na_sm_addr);
+    }
+
     /* Check that unexpected message queue is empty */
     empty = HG_QUEUE_IS_EMPTY(&na_sm_endpoint->unexpected_msg_queue.queue);
     NA_CHECK_SUBSYS_ERROR(cls, empty == false, done, ret, NA_BUSY,
@@ -2395,6 +3390,11 @@ na_sm_endpoint_close(struct na_sm_endpoint *na_sm_endpoint)
     NA_CHECK_SUBSYS_ERROR(cls, empty == false, done, ret, NA_BUSY,
         "Retry op queue should be empty");
 
+    /* Check that RMA op queue is empty */
+    empty = HG_QUEUE_IS_EMPTY(&na_sm_endpoint->rma_op_queue.queue);
+    NA_CHECK_SUBSYS_ERROR(cls, empty == false, done, ret, NA_BUSY,
+        "RMA op queue should be empty");
+
     if (source_addr) {
         if (source_addr->shared_region) {
             na_sm_queue_pair_release(
@@ -2461,10 +3461,14 @@ na_sm_endpoint_close(struct na_sm_endpoint *na_sm_endpoint)
 
     /* Free hash table */
     if (na_sm_endpoint->addr_map.map) {
-        hg_hash_table_free(na_sm_endpoint->addr_map.map);
-        hg_thread_rwlock_destroy(&na_sm_endpoint->addr_map.lock);
+        hg_oa_hash_table_free(na_sm_endpoint->addr_map.map);
+        hg_thread_brlock_destroy(&na_sm_endpoint->addr_map.lock);
     }
 
+    free(na_sm_endpoint->pair_addrs);
+    na_sm_endpoint->pair_addrs = NULL;
+    na_sm_endpoint->pair_count = 0;
+
     /* Check that all fds have been freed */
     NA_CHECK_SUBSYS_ERROR(cls, hg_atomic_get32(&na_sm_endpoint->nofile) != 0,
         done, ret, NA_BUSY,
@@ -2476,6 +3480,8 @@ na_sm_endpoint_close(struct na_sm_endpoint *na_sm_endpoint)
     hg_thread_spin_destroy(&na_sm_endpoint->unexpected_op_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->expected_op_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->retry_op_queue.lock);
+    hg_thread_spin_destroy(&na_sm_endpoint->rma_op_queue.lock);
+    hg_thread_spin_destroy(&na_sm_endpoint->rma_ack_queue.lock);
     hg_thread_spin_destroy(&na_sm_endpoint->poll_addr_list.lock);
 
 done:
@@ -2484,8 +3490,10 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, uint8_t *index)
+na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, uint16_t *index)
 {
+    union na_sm_cacheline_atomic_int64 *pairs_available = NA_SM_REGION_PTR(
+        na_sm_region, na_sm_region->layout.pairs_available_offset);
     unsigned int j = 0;
 
     do {
@@ -2493,8 +3501,7 @@ na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, uint8_t *index)
         unsigned int i = 0;
 
         do {
-            int64_t available =
-                hg_atomic_get64(&na_sm_region->available.val[j]);
+            int64_t available = hg_atomic_get64(&pairs_available[j].val);
             if (!available) {
                 j++;
                 break;
@@ -2508,36 +3515,140 @@ na_sm_queue_pair_reserve(struct na_sm_region *na_sm_region, uint8_t *index)
                 continue;
             }
 
-            if (hg_atomic_cas64(&na_sm_region->available.val[j], available,
-                    available & ~bits)) {
+            if (hg_atomic_cas64(
+                    &pairs_available[j].val, available, available & ~bits)) {
+                struct na_sm_msg_queue *tx_queue;
 #ifdef NA_HAS_DEBUG
                 char buf[65] = {'\0'};
-                available = hg_atomic_get64(&na_sm_region->available.val[j]);
+                available = hg_atomic_get64(&pairs_available[j].val);
                 NA_LOG_SUBSYS_DEBUG(addr,
                     "Reserved pair index %u\n### Available: %s", (i + (j * 64)),
                     lltoa((uint64_t) available, buf, 2));
 #endif
-                *index = (uint8_t) (i + (j * 64));
+                *index = (uint16_t) (i + (j * 64));
+
+                /* Rings are initialized by the first peer reserving the pair
+                 * (shm object is zero-filled on creation), released pairs
+                 * are left with empty queues */
+                tx_queue = na_sm_region_queue(na_sm_region, *index, true);
+                if (tx_queue->prod_size == 0) {
+                    na_sm_msg_queue_init(
+                        tx_queue, na_sm_region->layout.buf_count);
+                    na_sm_msg_queue_init(
+                        na_sm_region_queue(na_sm_region, *index, false),
+                        na_sm_region->layout.buf_count);
+                }
                 return NA_SUCCESS;
             }
 
             /* Can't use atomic XOR directly, if there is a race and the cas
              * fails, we should be able to pick the next one available */
         } while (i < 64);
-    } while (j < 4);
+    } while (j < na_sm_region->layout.pair_count / 64);
 
     return NA_AGAIN;
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
-na_sm_queue_pair_release(struct na_sm_region *na_sm_region, uint8_t index)
+na_sm_queue_pair_release(struct na_sm_region *na_sm_region, uint16_t index)
 {
-    hg_atomic_or64(
-        &na_sm_region->available.val[index / 64], (int64_t) 1 << index % 64);
+    union na_sm_cacheline_atomic_int64 *pairs_available = NA_SM_REGION_PTR(
+        na_sm_region, na_sm_region->layout.pairs_available_offset);
+
+    hg_atomic_or64(&pairs_available[index / 64].val, (int64_t) 1 << index % 64);
     NA_LOG_SUBSYS_DEBUG(addr, "Released pair index %u", index);
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_queue_pair_reclaim_request(
+    struct na_sm_endpoint *na_sm_endpoint, struct na_sm_addr *na_sm_addr)
+{
+    struct na_sm_region *na_sm_region = na_sm_addr->shared_region;
+    union na_sm_cmd_hdr cmd_hdr = {.val = 0};
+    bool sent;
+
+    /* Only one request is pending at a time, owner clears it once done */
+    if (!hg_atomic_cas32(&na_sm_region->reclaim, 0, 1))
+        return;
+
+    cmd_hdr = (union na_sm_cmd_hdr){.hdr.type = NA_SM_RECLAIM,
+        .hdr.pid = (unsigned int) na_sm_endpoint->source_addr->addr_key.pid,
+        .hdr.id = na_sm_endpoint->source_addr->addr_key.id & 0xff};
+
+    /* Owner may be blocked waiting, go through its sock then */
+    if (na_sm_endpoint->poll_set)
+        sent = na_sm_addr_event_send(na_sm_endpoint->sock, na_sm_addr->uri,
+                   cmd_hdr, -1, -1, false) == NA_SUCCESS;
+    else
+        sent = na_sm_cmd_queue_push(
+            na_sm_region_cmd_queue(na_sm_region), &cmd_hdr);
+    if (!sent)
+        hg_atomic_set32(&na_sm_region->reclaim, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_queue_pair_reclaim(struct na_sm_endpoint *na_sm_endpoint)
+{
+    struct na_sm_region *na_sm_region =
+        na_sm_endpoint->source_addr->shared_region;
+    unsigned int i;
+
+    for (i = 0; i < na_sm_endpoint->pair_count; i++) {
+        struct na_sm_addr *na_sm_addr;
+        pid_t pid = 0;
+        bool reclaimed;
+
+        hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
+        na_sm_addr = na_sm_endpoint->pair_addrs[i];
+        if (na_sm_addr != NULL && na_sm_addr->unexpected)
+            pid = na_sm_addr->addr_key.pid;
+        hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
+
+        /* Only reclaim pairs of processes that no longer exist */
+        if (pid == 0 || kill(pid, 0) == 0 || errno != ESRCH)
+            continue;
+
+        /* Stop using pair, sends to that address now fail */
+        hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
+        reclaimed = na_sm_endpoint->pair_addrs[i] == na_sm_addr &&
+                    na_sm_addr->addr_key.pid == pid;
+        if (reclaimed) {
+            na_sm_endpoint->pair_addrs[i] = NULL;
+            hg_atomic_or32(&na_sm_addr->status, NA_SM_ADDR_RECLAIMED);
+        }
+        hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
+        if (!reclaimed)
+            continue;
+
+        /* Next peer reserving that pair must find empty queues */
+        na_sm_msg_queue_drain(na_sm_region, na_sm_addr->rx_queue);
+        na_sm_msg_queue_drain(na_sm_region, na_sm_addr->tx_queue);
+        na_sm_queue_pair_release(na_sm_region, (uint16_t) i);
+        NA_LOG_SUBSYS_DEBUG(
+            addr, "Reclaimed pair index %u of PID=%d", i, (int) pid);
+
+        /* Drop reference of reservation (see NA_SM_RELEASED) */
+        na_sm_addr_ref_decr(na_sm_addr);
+    }
+
+    hg_atomic_set32(&na_sm_region->reclaim, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_msg_queue_drain(
+    struct na_sm_region *na_sm_region, struct na_sm_msg_queue *na_sm_queue)
+{
+    union na_sm_msg_hdr msg_hdr = {.val = 0};
+    char inline_buf[NA_SM_INLINE_MAX];
+
+    while (na_sm_msg_queue_pop(na_sm_queue, &msg_hdr, inline_buf))
+        na_sm_msg_buf_release(na_sm_region, msg_hdr);
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE struct na_sm_addr *
 na_sm_addr_map_lookup(
@@ -2546,10 +3657,10 @@ na_sm_addr_map_lookup(
     hg_hash_table_value_t value = NULL;
 
     /* Lookup key */
-    hg_thread_rwlock_rdlock(&na_sm_map->lock);
+    hg_thread_brlock_rdlock(&na_sm_map->lock);
     value =
-        hg_hash_table_lookup(na_sm_map->map, (hg_hash_table_key_t) addr_key);
-    hg_thread_rwlock_release_rdlock(&na_sm_map->lock);
+        hg_oa_hash_table_lookup(na_sm_map->map, (hg_hash_table_key_t) addr_key);
+    hg_thread_brlock_release_rdlock(&na_sm_map->lock);
 
     return (value == HG_HASH_TABLE_NULL) ? NULL : (struct na_sm_addr *) value;
 }
@@ -2564,10 +3675,10 @@ na_sm_addr_map_insert(struct na_sm_endpoint *na_sm_endpoint,
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    hg_thread_rwlock_wrlock(&na_sm_map->lock);
+    hg_thread_brlock_wrlock(&na_sm_map->lock);
 
     /* Look up again to prevent race between lock release/acquire */
-    na_sm_addr = (struct na_sm_addr *) hg_hash_table_lookup(
+    na_sm_addr = (struct na_sm_addr *) hg_oa_hash_table_lookup(
         na_sm_map->map, (hg_hash_table_key_t) addr_key);
     if (na_sm_addr) {
         ret = NA_EXIST; /* Entry already exists */
@@ -2579,21 +3690,21 @@ na_sm_addr_map_insert(struct na_sm_endpoint *na_sm_endpoint,
     NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not allocate address");
 
     /* Insert new value */
-    rc = hg_hash_table_insert(na_sm_map->map,
+    rc = hg_oa_hash_table_insert(na_sm_map->map,
         (hg_hash_table_key_t) &na_sm_addr->addr_key,
         (hg_hash_table_value_t) na_sm_addr);
-    NA_CHECK_SUBSYS_ERROR(
-        addr, rc == 0, error, ret, NA_NOMEM, "hg_hash_table_insert() failed");
+    NA_CHECK_SUBSYS_ERROR(addr, rc == 0, error, ret, NA_NOMEM,
+        "hg_oa_hash_table_insert() failed");
 
 done:
-    hg_thread_rwlock_release_wrlock(&na_sm_map->lock);
+    hg_thread_brlock_release_wrlock(&na_sm_map->lock);
 
     *na_sm_addr_p = na_sm_addr;
 
     return ret;
 
 error:
-    hg_thread_rwlock_release_wrlock(&na_sm_map->lock);
+    hg_thread_brlock_release_wrlock(&na_sm_map->lock);
     if (na_sm_addr)
         na_sm_addr_destroy(na_sm_addr);
 
@@ -2608,16 +3719,17 @@ na_sm_addr_map_remove(
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    hg_thread_rwlock_wrlock(&na_sm_map->lock);
-    if (hg_hash_table_lookup(na_sm_map->map, (hg_hash_table_key_t) addr_key) ==
-        HG_HASH_TABLE_NULL)
+    hg_thread_brlock_wrlock(&na_sm_map->lock);
+    if (hg_oa_hash_table_lookup(na_sm_map->map,
+            (hg_hash_table_key_t) addr_key) == HG_HASH_TABLE_NULL)
         goto unlock;
 
-    rc = hg_hash_table_remove(na_sm_map->map, (hg_hash_table_key_t) addr_key);
+    rc = hg_oa_hash_table_remove(
+        na_sm_map->map, (hg_hash_table_key_t) addr_key);
     NA_CHECK_SUBSYS_ERROR_DONE(addr, rc == 0, "Could not remove key");
 
 unlock:
-    hg_thread_rwlock_release_wrlock(&na_sm_map->lock);
+    hg_thread_brlock_release_wrlock(&na_sm_map->lock);
 
     return ret;
 }
@@ -2711,7 +3823,17 @@ na_sm_addr_ref_decr(struct na_sm_addr *na_sm_addr)
     if (resolved) {
         /* Remove address from list of addresses to poll */
         hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
-        HG_LIST_REMOVE(na_sm_addr, entry);
+        if (na_sm_addr->queue_pair_idx < na_sm_endpoint->pair_count &&
+            na_sm_endpoint->pair_addrs[na_sm_addr->queue_pair_idx] ==
+                na_sm_addr)
+            na_sm_endpoint->pair_addrs[na_sm_addr->queue_pair_idx] = NULL;
+        else if (!(hg_atomic_get32(&na_sm_addr->status) &
+                     NA_SM_ADDR_RECLAIMED)) {
+            HG_LIST_REMOVE(na_sm_addr, entry);
+            /* Do not leave peer notifying a waiter that is no longer there */
+            if (na_sm_addr->rx_armed)
+                hg_atomic_decr32(&na_sm_addr->rx_queue->cons_waiting);
+        }
         hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
     }
 
@@ -2735,7 +3857,7 @@ na_sm_addr_resolve(struct na_sm_addr *na_sm_addr)
     /* Open shm region */
     if (!na_sm_addr->shared_region) {
         ret = na_sm_region_open(
-            na_sm_addr->uri, false, &na_sm_addr->shared_region);
+            na_sm_addr->uri, false, 0, 0, 0, false, &na_sm_addr->shared_region);
         NA_CHECK_SUBSYS_NA_ERROR(
             addr, error, ret, "Could not open shared-memory region");
     }
@@ -2744,33 +3866,45 @@ na_sm_addr_resolve(struct na_sm_addr *na_sm_addr)
     if (!(hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_RESERVED)) {
         ret = na_sm_queue_pair_reserve(
             na_sm_addr->shared_region, &na_sm_addr->queue_pair_idx);
-        NA_CHECK_SUBSYS_NA_ERROR(
-            addr, error, ret, "Could not reserve queue pair");
+        if (unlikely(ret == NA_AGAIN)) {
+            /* Pairs of peers that exited (e.g., before a restart) are only
+             * given back by the region owner, retry once it is done */
+            na_sm_queue_pair_reclaim_request(na_sm_endpoint, na_sm_addr);
+            return ret;
+        }
         hg_atomic_or32(&na_sm_addr->status, NA_SM_ADDR_RESERVED);
 
         /* Keep tx/rx queues for convenience */
-        na_sm_addr->tx_queue =
-            &na_sm_addr->shared_region->queue_pairs[na_sm_addr->queue_pair_idx]
-                 .tx_queue;
-        na_sm_addr->rx_queue =
-            &na_sm_addr->shared_region->queue_pairs[na_sm_addr->queue_pair_idx]
-                 .rx_queue;
+        na_sm_addr->tx_queue = na_sm_region_queue(
+            na_sm_addr->shared_region, na_sm_addr->queue_pair_idx, true);
+        na_sm_addr->rx_queue = na_sm_region_queue(
+            na_sm_addr->shared_region, na_sm_addr->queue_pair_idx, false);
+
+        /* Region owner only polls queue pairs that rang its doorbell */
+        na_sm_addr->tx_doorbell = true;
+
+#ifdef NA_SM_HAS_NUMA
+        /* We are the only consumer of that rx queue */
+        na_sm_region_numa_bind(na_sm_addr->uri, na_sm_addr->rx_queue,
+            na_sm_addr->shared_region->layout.queue_size);
+#endif
     }
 
     /* Fill cmd header */
     cmd_hdr = (union na_sm_cmd_hdr){.hdr.type = NA_SM_RESERVED,
         .hdr.pid = (unsigned int) na_sm_endpoint->source_addr->addr_key.pid,
         .hdr.id = na_sm_endpoint->source_addr->addr_key.id & 0xff,
-        .hdr.pair_idx = na_sm_addr->queue_pair_idx & 0xff};
+        .hdr.pair_idx = na_sm_addr->queue_pair_idx};
 
     NA_LOG_SUBSYS_DEBUG(addr, "Pushing cmd with %d for %d/%u/%u val=%" PRIu64,
         cmd_hdr.hdr.type, cmd_hdr.hdr.pid, cmd_hdr.hdr.id, cmd_hdr.hdr.pair_idx,
         cmd_hdr.val);
 
-    /* Push cmd to cmd queue */
+    /* Reservations only go through the cmd queue, which the region owner
+     * drains whether it waits or not */
     if (!(hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_CMD_PUSHED)) {
         rc = na_sm_cmd_queue_push(
-            &na_sm_addr->shared_region->cmd_queue, &cmd_hdr);
+            na_sm_region_cmd_queue(na_sm_addr->shared_region), &cmd_hdr);
         NA_CHECK_SUBSYS_ERROR(
             addr, rc == false, error, ret, NA_AGAIN, "Full queue");
         hg_atomic_or32(&na_sm_addr->status, NA_SM_ADDR_CMD_PUSHED);
@@ -2806,7 +3940,8 @@ na_sm_addr_resolve(struct na_sm_addr *na_sm_addr)
                 addr, error, ret, "Could not add rx notify to poll set");
         }
 
-        /* Send events to remote process */
+        /* Sock is only needed to pass events to remote process */
+        cmd_hdr.hdr.type = NA_SM_NOTIFY;
         ret = na_sm_addr_event_send(na_sm_endpoint->sock, na_sm_addr->uri,
             cmd_hdr, na_sm_addr->tx_notify, na_sm_addr->rx_notify, false);
         if (unlikely(ret == NA_AGAIN))
@@ -2872,9 +4007,10 @@ na_sm_addr_release(struct na_sm_addr *na_sm_addr)
     na_return_t ret = NA_SUCCESS;
 
     if (na_sm_addr->unexpected) {
-        /* Release queue pair */
-        na_sm_queue_pair_release(
-            na_sm_addr->shared_region, na_sm_addr->queue_pair_idx);
+        /* Release queue pair (already released if reclaimed) */
+        if (!(hg_atomic_get32(&na_sm_addr->status) & NA_SM_ADDR_RECLAIMED))
+            na_sm_queue_pair_release(
+                na_sm_addr->shared_region, na_sm_addr->queue_pair_idx);
     } else {
         union na_sm_cmd_hdr cmd_hdr = {.val = 0};
 
@@ -2882,7 +4018,7 @@ na_sm_addr_release(struct na_sm_addr *na_sm_addr)
         cmd_hdr = (union na_sm_cmd_hdr){.hdr.type = NA_SM_RELEASED,
             .hdr.pid = (unsigned int) na_sm_endpoint->source_addr->addr_key.pid,
             .hdr.id = na_sm_endpoint->source_addr->addr_key.id & 0xff,
-            .hdr.pair_idx = na_sm_addr->queue_pair_idx & 0xff};
+            .hdr.pair_idx = na_sm_addr->queue_pair_idx};
 
         if (na_sm_endpoint->poll_set) {
             /* Send events to remote process (silence error as this is best
@@ -2901,7 +4037,7 @@ na_sm_addr_release(struct na_sm_addr *na_sm_addr)
 
             /* Push cmd to cmd queue */
             rc = na_sm_cmd_queue_push(
-                &na_sm_addr->shared_region->cmd_queue, &cmd_hdr);
+                na_sm_region_cmd_queue(na_sm_addr->shared_region), &cmd_hdr);
             NA_CHECK_SUBSYS_ERROR(
                 addr, rc == false, done, ret, NA_AGAIN, "Full queue");
         }
@@ -3082,16 +4218,9 @@ na_sm_msg_send(struct na_sm_class *na_sm_class, na_context_t *context,
 {
     na_return_t ret;
 
-    NA_CHECK_SUBSYS_ERROR(msg, buf_size > NA_SM_COPY_BUF_SIZE, error, ret,
-        NA_OVERFLOW, "Exceeds copy buf size, %zu", buf_size);
-
-    /* Check op_id */
-    NA_CHECK_SUBSYS_ERROR(op, na_sm_op_id == NULL, error, ret, NA_INVALID_ARG,
-        "Invalid operation ID");
-    NA_CHECK_SUBSYS_ERROR(op,
-        !(hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_COMPLETED), error,
-        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
-        na_cb_type_to_string(na_sm_op_id->completion_data.callback_info.type));
+    ret = na_sm_msg_send_check(na_sm_class, buf_size, na_sm_op_id);
+    if (ret != NA_SUCCESS)
+        goto error;
 
     NA_SM_OP_RESET(na_sm_op_id, context, cb_type, callback, arg, na_sm_addr);
 
@@ -3124,159 +4253,1095 @@ error:
 }
 
 /*---------------------------------------------------------------------------*/
-static na_return_t
-na_sm_msg_send_post(struct na_sm_endpoint *na_sm_endpoint, na_cb_type_t cb_type,
-    const void *buf, size_t buf_size, struct na_sm_addr *na_sm_addr,
-    na_tag_t tag)
+static NA_INLINE na_return_t
+na_sm_msg_send_check(struct na_sm_class *na_sm_class, size_t buf_size,
+    struct na_sm_op_id *na_sm_op_id)
 {
-    unsigned int buf_idx = 0;
-    union na_sm_msg_hdr msg_hdr;
     na_return_t ret;
-    bool rc;
 
-    /* Attempt to resolve address first if not resolved */
-    if (hg_atomic_get32(&na_sm_addr->status) != NA_SM_ADDR_RESOLVED) {
-        hg_thread_mutex_lock(&na_sm_addr->resolve_lock);
-        ret = na_sm_addr_resolve(na_sm_addr);
-        hg_thread_mutex_unlock(&na_sm_addr->resolve_lock);
-        if (unlikely(ret == NA_AGAIN))
-            return NA_AGAIN;
-        else
-            NA_CHECK_SUBSYS_NA_ERROR(
-                addr, error, ret, "Could not resolve address");
-    }
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > na_sm_class->msg_size_max, error,
+        ret, NA_OVERFLOW, "Exceeds copy buf size, %zu", buf_size);
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_sm_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_sm_op_id->completion_data.callback_info.type));
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_hdr_fill(struct na_sm_region *na_sm_region, na_cb_type_t cb_type,
+    const void *buf, size_t buf_size, na_tag_t tag,
+    union na_sm_msg_hdr *msg_hdr)
+{
+    unsigned int buf_idx = 0;
 
-    /* No need to reserve for 0-size messages */
-    if (buf_size > 0) {
+    /* No need to reserve for 0-size or inline messages */
+    if (buf_size > NA_SM_INLINE_MAX) {
         /* Try to reserve buffer atomically */
-        ret =
-            na_sm_buf_reserve(&na_sm_addr->shared_region->copy_bufs, &buf_idx);
+        na_return_t ret = na_sm_buf_reserve(na_sm_region, &buf_idx);
         if (unlikely(ret == NA_AGAIN))
             return NA_AGAIN;
 
         /* Reservation succeeded, copy buffer */
-        na_sm_buf_copy_to(
-            &na_sm_addr->shared_region->copy_bufs, buf_idx, buf, buf_size);
+        na_sm_buf_copy_to(na_sm_region, buf_idx, buf, buf_size);
     }
 
-    /* Post message to queue */
-    msg_hdr = (union na_sm_msg_hdr){.hdr.type = cb_type,
-        .hdr.buf_idx = buf_idx & 0xff,
+    *msg_hdr = (union na_sm_msg_hdr){
+        .hdr.type = (cb_type == NA_CB_SEND_UNEXPECTED) ? NA_SM_MSG_UNEXPECTED
+                                                       : NA_SM_MSG_EXPECTED,
+        .hdr.buf_idx = buf_idx & 0xfff,
         .hdr.buf_size = buf_size & 0xffff,
+        .hdr.inline_buf = (buf_size > 0 && buf_size <= NA_SM_INLINE_MAX),
         .hdr.tag = tag};
 
-    rc = na_sm_msg_queue_push(na_sm_addr->tx_queue, &msg_hdr);
-    NA_CHECK_SUBSYS_ERROR(
-        msg, rc == false, release, ret, NA_AGAIN, "Full queue");
+    return NA_SUCCESS;
+}
 
-    /* Notify remote if notifications are enabled */
-    if (na_sm_addr == na_sm_endpoint->source_addr &&
-        na_sm_addr->rx_notify > 0) {
-        int rc1 = hg_event_set(na_sm_addr->rx_notify);
-        NA_CHECK_SUBSYS_ERROR(msg, rc1 != HG_UTIL_SUCCESS, release, ret,
-            na_sm_errno_to_na(errno), "Could not send completion notification");
-    } else if (na_sm_addr->tx_notify > 0) {
-        ret = na_sm_event_set(na_sm_addr->tx_notify);
-        NA_CHECK_SUBSYS_NA_ERROR(
-            msg, release, ret, "Could not send completion notification");
-    }
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_send_post(struct na_sm_endpoint *na_sm_endpoint, na_cb_type_t cb_type,
+    const void *buf, size_t buf_size, struct na_sm_addr *na_sm_addr,
+    na_tag_t tag)
+{
+    union na_sm_msg_hdr msg_hdr;
+    na_return_t ret;
+    bool rc;
 
-    return NA_SUCCESS;
+    /* Attempt to resolve address first if not resolved */
+    ret = na_sm_msg_send_resolve(na_sm_addr);
+    if (ret != NA_SUCCESS)
+        return ret;
+
+    /* Buffers of remote region may be smaller than local ones */
+    NA_CHECK_SUBSYS_ERROR(msg,
+        buf_size > na_sm_addr->shared_region->layout.buf_size, error, ret,
+        NA_OVERFLOW, "Exceeds remote copy buf size, %zu > %u", buf_size,
+        na_sm_addr->shared_region->layout.buf_size);
+
+    ret = na_sm_msg_hdr_fill(
+        na_sm_addr->shared_region, cb_type, buf, buf_size, tag, &msg_hdr);
+    if (unlikely(ret == NA_AGAIN))
+        return NA_AGAIN;
+
+    /* Post message to queue */
+    rc = na_sm_msg_queue_push(na_sm_addr->tx_queue, &msg_hdr, buf);
+    NA_CHECK_SUBSYS_ERROR(
+        msg, rc == false, release, ret, NA_AGAIN, "Full queue");
+
+    /* Msg is now owned by the queue, buffer must not be released */
+    return na_sm_msg_send_notify(na_sm_endpoint, na_sm_addr);
 
 release:
-    if (buf_size > 0)
-        na_sm_buf_release(&na_sm_addr->shared_region->copy_bufs, buf_idx);
+    if (buf_size > NA_SM_INLINE_MAX)
+        na_sm_buf_release(na_sm_addr->shared_region, msg_hdr.hdr.buf_idx);
 
 error:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
-static NA_INLINE na_return_t
-na_sm_buf_reserve(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int *index)
+static na_return_t
+na_sm_msg_send_batch_post(struct na_sm_class *na_sm_class,
+    na_context_t *context, na_cb_type_t cb_type,
+    const struct na_msg_send_info *send_infos, size_t count,
+    size_t *posted_count_p, bool *completed_p)
 {
-    int64_t bits = (int64_t) 1;
-    unsigned int i = 0;
+    struct na_sm_addr *na_sm_addr =
+        (struct na_sm_addr *) send_infos[0].dest_addr;
+    union na_sm_msg_hdr msg_hdrs[NA_SM_SEND_BATCH_MAX];
+    const void *bufs[NA_SM_SEND_BATCH_MAX];
+    size_t reset_count, valid_count, reserved_count = 0, pushed_count = 0, i;
+    na_return_t ret = NA_SUCCESS, post_ret;
+
+    /* Reset op IDs, stop at first invalid entry */
+    for (reset_count = 0; reset_count < count; reset_count++) {
+        const struct na_msg_send_info *send_info = &send_infos[reset_count];
+        struct na_sm_op_id *na_sm_op_id =
+            (struct na_sm_op_id *) send_info->op_id;
+
+        ret = na_sm_msg_send_check(
+            na_sm_class, send_info->buf_size, na_sm_op_id);
+        if (ret != NA_SUCCESS)
+            break;
 
-    do {
-        int64_t available = hg_atomic_get64(&na_sm_copy_buf->available.val);
-        if (!available) {
-            /* Nothing available */
+        NA_SM_OP_RESET(na_sm_op_id, context, cb_type, send_info->callback,
+            send_info->arg, na_sm_addr);
+        na_sm_op_id->info.msg =
+            (struct na_sm_msg_info){.buf.const_ptr = send_info->buf,
+                .buf_size = send_info->buf_size,
+                .tag = send_info->tag};
+    }
+    valid_count = reset_count;
+
+    /* Attempt to resolve address first if not resolved */
+    post_ret = na_sm_msg_send_resolve(na_sm_addr);
+    if (post_ret == NA_AGAIN)
+        goto retry;
+    else if (post_ret != NA_SUCCESS) {
+        ret = post_ret;
+        valid_count = 0;
+        goto release;
+    }
+
+    /* Reserve and fill shared buffers, remaining msgs are retried later */
+    for (; reserved_count < valid_count; reserved_count++) {
+        const struct na_msg_send_info *send_info = &send_infos[reserved_count];
+
+        /* Buffers of remote region may be smaller than local ones */
+        if (send_info->buf_size > na_sm_addr->shared_region->layout.buf_size) {
+            NA_LOG_SUBSYS_ERROR(msg, "Exceeds remote copy buf size, %zu > %u",
+                send_info->buf_size,
+                na_sm_addr->shared_region->layout.buf_size);
+            ret = NA_OVERFLOW;
+            valid_count = reserved_count;
             break;
         }
-        if ((available & bits) != bits) {
-            /* Already reserved */
-            hg_atomic_fence();
-            i++;
-            bits <<= 1;
-            continue;
-        }
 
-        if (hg_atomic_cas64(
-                &na_sm_copy_buf->available.val, available, available & ~bits)) {
+        if (na_sm_msg_hdr_fill(na_sm_addr->shared_region, cb_type,
+                send_info->buf, send_info->buf_size, send_info->tag,
+                &msg_hdrs[reserved_count]) != NA_SUCCESS)
+            break;
+        bufs[reserved_count] = send_info->buf;
+    }
+
+    /* Post msgs to queue with a single tail update */
+    if (reserved_count > 0)
+        pushed_count = na_sm_msg_queue_push_batch(na_sm_addr->tx_queue,
+            msg_hdrs, bufs, (unsigned int) reserved_count);
+    for (i = pushed_count; i < reserved_count; i++)
+        if (send_infos[i].buf_size > NA_SM_INLINE_MAX)
+            na_sm_buf_release(
+                na_sm_addr->shared_region, msg_hdrs[i].hdr.buf_idx);
+
+    if (pushed_count > 0) {
+        /* Notify remote once for all msgs, msgs are already posted and will
+         * be picked up on next poll in case of failure */
+        (void) na_sm_msg_send_notify(&na_sm_class->endpoint, na_sm_addr);
+
+        /* Immediate completion, add directly to completion queue. */
+        for (i = 0; i < pushed_count; i++)
+            na_sm_complete(
+                (struct na_sm_op_id *) send_infos[i].op_id, NA_SUCCESS);
+        *completed_p = true;
+    }
+
+retry:
+    for (i = pushed_count; i < valid_count; i++)
+        na_sm_op_retry(na_sm_class, (struct na_sm_op_id *) send_infos[i].op_id);
+
+release:
+    for (i = valid_count; i < reset_count; i++)
+        NA_SM_OP_RELEASE(((struct na_sm_op_id *) send_infos[i].op_id));
+
+    *posted_count_p = valid_count;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+na_sm_msg_send_resolve(struct na_sm_addr *na_sm_addr)
+{
+    na_return_t ret;
+
+    int32_t status = hg_atomic_get32(&na_sm_addr->status);
+
+    if ((status & (NA_SM_ADDR_RESOLVED | NA_SM_ADDR_RECLAIMED)) ==
+        NA_SM_ADDR_RESOLVED)
+        return NA_SUCCESS;
+    NA_CHECK_SUBSYS_ERROR(addr, status & NA_SM_ADDR_RECLAIMED, error, ret,
+        NA_ADDRNOTAVAIL, "Peer of address exited");
+
+    hg_thread_mutex_lock(&na_sm_addr->resolve_lock);
+    ret = na_sm_addr_resolve(na_sm_addr);
+    hg_thread_mutex_unlock(&na_sm_addr->resolve_lock);
+    if (unlikely(ret == NA_AGAIN))
+        return NA_AGAIN;
+    else
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not resolve address");
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_send_notify(
+    struct na_sm_endpoint *na_sm_endpoint, struct na_sm_addr *na_sm_addr)
+{
+    na_return_t ret;
+
+    /* Notify remote only if it is blocked waiting for notifications */
+    if (na_sm_addr->tx_doorbell) {
+        na_sm_region_doorbell_ring(
+            na_sm_addr->shared_region, na_sm_addr->queue_pair_idx);
+        if (!na_sm_region_has_waiter(na_sm_addr->shared_region))
+            return NA_SUCCESS;
+    } else if (!na_sm_msg_queue_has_waiter(na_sm_addr->tx_queue))
+        return NA_SUCCESS;
+
+    if (na_sm_addr == na_sm_endpoint->source_addr &&
+        na_sm_addr->rx_notify > 0) {
+        int rc = hg_event_set(na_sm_addr->rx_notify);
+        NA_CHECK_SUBSYS_ERROR(msg, rc != HG_UTIL_SUCCESS, error, ret,
+            na_sm_errno_to_na(errno), "Could not send completion notification");
+    } else if (na_sm_addr->tx_notify > 0) {
+        ret = na_sm_event_set(na_sm_addr->tx_notify);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            msg, error, ret, "Could not send completion notification");
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+na_sm_buf_reserve(struct na_sm_region *na_sm_region, unsigned int *index)
+{
+    union na_sm_cacheline_atomic_int64 *available = NA_SM_REGION_PTR(
+        na_sm_region, na_sm_region->layout.available_offset);
+    unsigned int j;
+
+    for (j = 0; j < na_sm_region->layout.buf_count / 64; j++) {
+        int64_t bits = (int64_t) 1;
+        unsigned int i = 0;
+
+        do {
+            int64_t val = hg_atomic_get64(&available[j].val);
+            if (!val) {
+                /* Nothing available in this bitmask */
+                break;
+            }
+            if ((val & bits) != bits) {
+                /* Already reserved */
+                hg_atomic_fence();
+                i++;
+                bits <<= 1;
+                continue;
+            }
+
+            if (hg_atomic_cas64(&available[j].val, val, val & ~bits)) {
 #ifdef NA_HAS_DEBUG
-            char buf[65] = {'\0'};
-            available = hg_atomic_get64(&na_sm_copy_buf->available.val);
-            NA_LOG_SUBSYS_DEBUG(msg, "Reserved bit index %u\n### Available: %s",
-                i, lltoa((uint64_t) available, buf, 2));
+                char buf[65] = {'\0'};
+                val = hg_atomic_get64(&available[j].val);
+                NA_LOG_SUBSYS_DEBUG(msg,
+                    "Reserved bit index %u\n### Available: %s", i + (j * 64),
+                    lltoa((uint64_t) val, buf, 2));
 #endif
-            *index = i;
-            return NA_SUCCESS;
-        }
-        /* Can't use atomic XOR directly, if there is a race and the cas
-         * fails, we should be able to pick the next one available */
-    } while (i < NA_SM_NUM_BUFS);
+                *index = i + (j * 64);
+                return NA_SUCCESS;
+            }
+            /* Can't use atomic XOR directly, if there is a race and the cas
+             * fails, we should be able to pick the next one available */
+        } while (i < 64);
+    }
 
     return NA_AGAIN;
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
-na_sm_buf_release(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index)
+na_sm_buf_release(struct na_sm_region *na_sm_region, unsigned int index)
 {
-    hg_atomic_or64(&na_sm_copy_buf->available.val, (int64_t) 1 << index);
+    union na_sm_cacheline_atomic_int64 *available = NA_SM_REGION_PTR(
+        na_sm_region, na_sm_region->layout.available_offset);
+
+    hg_atomic_or64(&available[index / 64].val, (int64_t) 1 << index % 64);
     NA_LOG_SUBSYS_DEBUG(msg, "Released bit index %u", index);
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void *
+na_sm_buf_ptr(struct na_sm_region *na_sm_region, unsigned int index)
+{
+    return NA_SM_REGION_PTR(na_sm_region,
+        na_sm_region->layout.bufs_offset +
+            (size_t) index * na_sm_region->layout.buf_size);
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
-na_sm_buf_copy_to(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index,
+na_sm_buf_copy_to(struct na_sm_region *na_sm_region, unsigned int index,
     const void *src, size_t n)
 {
-    hg_thread_spin_lock(&na_sm_copy_buf->buf_locks[index]);
-    memcpy(na_sm_copy_buf->buf[index], src, n);
-    hg_thread_spin_unlock(&na_sm_copy_buf->buf_locks[index]);
+    hg_thread_spin_t *buf_locks =
+        NA_SM_REGION_PTR(na_sm_region, na_sm_region->layout.buf_locks_offset);
+
+    hg_thread_spin_lock(&buf_locks[index]);
+    hg_mem_copy(NA_SM_REGION_PTR(na_sm_region,
+               na_sm_region->layout.bufs_offset +
+                   (size_t) index * na_sm_region->layout.buf_size),
+        src, n);
+    hg_thread_spin_unlock(&buf_locks[index]);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_buf_copy_from(struct na_sm_region *na_sm_region, unsigned int index,
+    void *dest, size_t n)
+{
+    hg_thread_spin_t *buf_locks =
+        NA_SM_REGION_PTR(na_sm_region, na_sm_region->layout.buf_locks_offset);
+
+    hg_thread_spin_lock(&buf_locks[index]);
+    hg_mem_copy(dest,
+        NA_SM_REGION_PTR(na_sm_region,
+            na_sm_region->layout.bufs_offset +
+                (size_t) index * na_sm_region->layout.buf_size),
+        n);
+    hg_thread_spin_unlock(&buf_locks[index]);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_msg_buf_copy_from(struct na_sm_region *na_sm_region,
+    union na_sm_msg_hdr msg_hdr, const void *inline_buf, void *dest)
+{
+    if (msg_hdr.hdr.inline_buf)
+        memcpy(dest, inline_buf, msg_hdr.hdr.buf_size);
+    else
+        na_sm_buf_copy_from(
+            na_sm_region, msg_hdr.hdr.buf_idx, dest, msg_hdr.hdr.buf_size);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_msg_buf_release(
+    struct na_sm_region *na_sm_region, union na_sm_msg_hdr msg_hdr)
+{
+    if (msg_hdr.hdr.buf_size > 0 && !msg_hdr.hdr.inline_buf)
+        na_sm_buf_release(na_sm_region, msg_hdr.hdr.buf_idx);
+}
+
+#ifdef NA_SM_HAS_XPMEM
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_xpmem_init(struct na_sm_class *na_sm_class)
+{
+    HG_LIST_INIT(&na_sm_class->xpmem_map.list);
+    hg_thread_mutex_init(&na_sm_class->xpmem_map.lock);
+
+    /* Expose entire address space, access is checked by handle flags */
+    na_sm_class->xpmem_segid = xpmem_make(
+        0, XPMEM_MAXADDR_SIZE, XPMEM_PERMIT_MODE, (void *) 0600);
+    NA_CHECK_SUBSYS_WARNING(cls, na_sm_class->xpmem_segid == -1,
+        "xpmem_make() failed (%s), falling back to CMA", strerror(errno));
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_xpmem_finalize(struct na_sm_class *na_sm_class)
+{
+    struct na_sm_xpmem_peer *na_sm_xpmem_peer =
+        HG_LIST_FIRST(&na_sm_class->xpmem_map.list);
+
+    while (na_sm_xpmem_peer) {
+        struct na_sm_xpmem_peer *next = HG_LIST_NEXT(na_sm_xpmem_peer, entry);
+        struct na_sm_xpmem_attach *na_sm_xpmem_attach =
+            HG_LIST_FIRST(&na_sm_xpmem_peer->attach_list);
+
+        while (na_sm_xpmem_attach) {
+            struct na_sm_xpmem_attach *next_attach =
+                HG_LIST_NEXT(na_sm_xpmem_attach, entry);
+
+            (void) xpmem_detach(na_sm_xpmem_attach->ptr);
+            free(na_sm_xpmem_attach);
+            na_sm_xpmem_attach = next_attach;
+        }
+        (void) xpmem_release(na_sm_xpmem_peer->apid);
+        free(na_sm_xpmem_peer);
+        na_sm_xpmem_peer = next;
+    }
+    hg_thread_mutex_destroy(&na_sm_class->xpmem_map.lock);
+
+    if (na_sm_class->xpmem_segid != -1)
+        (void) xpmem_remove(na_sm_class->xpmem_segid);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_xpmem_attach(struct na_sm_class *na_sm_class, xpmem_segid_t segid,
+    uintptr_t base, size_t len, void **ptr_p)
+{
+    struct na_sm_xpmem_map *na_sm_xpmem_map = &na_sm_class->xpmem_map;
+    struct na_sm_xpmem_peer *na_sm_xpmem_peer = NULL;
+    struct na_sm_xpmem_attach *na_sm_xpmem_attach = NULL;
+    na_return_t ret;
+
+    /* Local memory can be accessed directly */
+    if (segid == na_sm_class->xpmem_segid) {
+        *ptr_p = (void *) base;
+        return NA_SUCCESS;
+    }
+
+    hg_thread_mutex_lock(&na_sm_xpmem_map->lock);
+
+    HG_LIST_FOREACH (na_sm_xpmem_peer, &na_sm_xpmem_map->list, entry)
+        if (na_sm_xpmem_peer->segid == segid)
+            break;
+
+    if (na_sm_xpmem_peer == NULL) {
+        na_sm_xpmem_peer = (struct na_sm_xpmem_peer *) malloc(
+            sizeof(struct na_sm_xpmem_peer));
+        NA_CHECK_SUBSYS_ERROR(rma, na_sm_xpmem_peer == NULL, unlock, ret,
+            NA_NOMEM, "Could not allocate XPMEM peer");
+        HG_LIST_INIT(&na_sm_xpmem_peer->attach_list);
+        na_sm_xpmem_peer->segid = segid;
+
+        na_sm_xpmem_peer->apid =
+            xpmem_get(segid, XPMEM_RDWR, XPMEM_PERMIT_MODE, NULL);
+        if (na_sm_xpmem_peer->apid == -1) {
+            free(na_sm_xpmem_peer);
+            NA_GOTO_SUBSYS_ERROR(rma, unlock, ret, na_sm_errno_to_na(errno),
+                "xpmem_get() failed (%s)", strerror(errno));
+        }
+        HG_LIST_INSERT_HEAD(&na_sm_xpmem_map->list, na_sm_xpmem_peer, entry);
+    }
+
+    HG_LIST_FOREACH (
+        na_sm_xpmem_attach, &na_sm_xpmem_peer->attach_list, entry)
+        if (na_sm_xpmem_attach->base <= base &&
+            base + len <= na_sm_xpmem_attach->base + na_sm_xpmem_attach->len)
+            break;
+
+    if (na_sm_xpmem_attach == NULL) {
+        uintptr_t start = base & ~((uintptr_t) NA_SM_XPMEM_ATTACH_ALIGN - 1);
+        struct xpmem_addr xpmem_addr = {
+            .apid = na_sm_xpmem_peer->apid, .offset = (off_t) start};
+
+        na_sm_xpmem_attach = (struct na_sm_xpmem_attach *) malloc(
+            sizeof(struct na_sm_xpmem_attach));
+        NA_CHECK_SUBSYS_ERROR(rma, na_sm_xpmem_attach == NULL, unlock, ret,
+            NA_NOMEM, "Could not allocate XPMEM attachment");
+        na_sm_xpmem_attach->base = start;
+        na_sm_xpmem_attach->len =
+            NA_SM_ALIGN(base + len, NA_SM_XPMEM_ATTACH_ALIGN) - start;
+
+        na_sm_xpmem_attach->ptr =
+            xpmem_attach(xpmem_addr, na_sm_xpmem_attach->len, NULL);
+        if (na_sm_xpmem_attach->ptr == (void *) -1) {
+            free(na_sm_xpmem_attach);
+            NA_GOTO_SUBSYS_ERROR(rma, unlock, ret, na_sm_errno_to_na(errno),
+                "xpmem_attach() failed (%s)", strerror(errno));
+        }
+    } else
+        HG_LIST_REMOVE(na_sm_xpmem_attach, entry);
+
+    /* Keep most recently used attachments first */
+    HG_LIST_INSERT_HEAD(
+        &na_sm_xpmem_peer->attach_list, na_sm_xpmem_attach, entry);
+
+    hg_thread_mutex_unlock(&na_sm_xpmem_map->lock);
+
+    /* Attachments remain valid until finalize */
+    *ptr_p = (char *) na_sm_xpmem_attach->ptr +
+             (base - na_sm_xpmem_attach->base);
+
+    return NA_SUCCESS;
+
+unlock:
+    hg_thread_mutex_unlock(&na_sm_xpmem_map->lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_xpmem_rma(struct na_sm_class *na_sm_class, na_cb_type_t cb_type,
+    xpmem_segid_t segid, const struct iovec *local_iov, unsigned long liovcnt,
+    const struct iovec *remote_iov, unsigned long riovcnt, size_t length)
+{
+    unsigned long liov_index = 0, riov_index = 0;
+    size_t liov_offset = 0, riov_offset = 0;
+    char *remote_ptr = NULL;
+    na_return_t ret;
+
+    while (length > 0 && liov_index < liovcnt && riov_index < riovcnt) {
+        char *local_ptr = (char *) local_iov[liov_index].iov_base + liov_offset;
+        size_t len = MIN(local_iov[liov_index].iov_len - liov_offset,
+            remote_iov[riov_index].iov_len - riov_offset);
+
+        len = MIN(len, length);
+
+        /* Map remote segment when reaching it */
+        if (remote_ptr == NULL) {
+            ret = na_sm_xpmem_attach(na_sm_class, segid,
+                (uintptr_t) remote_iov[riov_index].iov_base,
+                remote_iov[riov_index].iov_len, (void **) &remote_ptr);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                rma, error, ret, "Could not attach remote segment");
+        }
+
+        if (cb_type == NA_CB_PUT)
+            hg_mem_copy(remote_ptr + riov_offset, local_ptr, len);
+        else
+            hg_mem_copy(local_ptr, remote_ptr + riov_offset, len);
+
+        length -= len;
+        liov_offset += len;
+        riov_offset += len;
+        if (liov_offset == local_iov[liov_index].iov_len) {
+            liov_index++;
+            liov_offset = 0;
+        }
+        if (riov_offset == remote_iov[riov_index].iov_len) {
+            riov_index++;
+            riov_offset = 0;
+            remote_ptr = NULL;
+        }
+    }
+
+    NA_CHECK_SUBSYS_ERROR(rma, length > 0, error, ret, NA_MSGSIZE,
+        "Could not transfer %zu remaining bytes", length);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+#endif
+
+#ifdef NA_SM_HAS_CUDA
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_cuda_init(struct na_sm_class *na_sm_class)
+{
+    HG_LIST_INIT(&na_sm_class->cuda_ipc_map.list);
+    hg_thread_mutex_init(&na_sm_class->cuda_ipc_map.lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_cuda_finalize(struct na_sm_class *na_sm_class)
+{
+    struct na_sm_cuda_ipc *na_sm_cuda_ipc =
+        HG_LIST_FIRST(&na_sm_class->cuda_ipc_map.list);
+
+    while (na_sm_cuda_ipc) {
+        struct na_sm_cuda_ipc *next = HG_LIST_NEXT(na_sm_cuda_ipc, entry);
+
+        (void) cudaIpcCloseMemHandle(na_sm_cuda_ipc->ptr);
+        free(na_sm_cuda_ipc);
+        na_sm_cuda_ipc = next;
+    }
+    hg_thread_mutex_destroy(&na_sm_class->cuda_ipc_map.lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_cuda_ipc_open(struct na_sm_class *na_sm_class,
+    const cudaIpcMemHandle_t *handle, void **ptr_p)
+{
+    struct na_sm_cuda_ipc_map *na_sm_cuda_ipc_map = &na_sm_class->cuda_ipc_map;
+    struct na_sm_cuda_ipc *na_sm_cuda_ipc = NULL;
+    na_return_t ret;
+
+    hg_thread_mutex_lock(&na_sm_cuda_ipc_map->lock);
+
+    HG_LIST_FOREACH (na_sm_cuda_ipc, &na_sm_cuda_ipc_map->list, entry)
+        if (memcmp(&na_sm_cuda_ipc->handle, handle, sizeof(*handle)) == 0)
+            break;
+
+    if (na_sm_cuda_ipc == NULL) {
+        cudaError_t cuda_rc;
+
+        na_sm_cuda_ipc =
+            (struct na_sm_cuda_ipc *) malloc(sizeof(struct na_sm_cuda_ipc));
+        NA_CHECK_SUBSYS_ERROR(rma, na_sm_cuda_ipc == NULL, unlock, ret,
+            NA_NOMEM, "Could not allocate CUDA IPC mapping");
+        na_sm_cuda_ipc->handle = *handle;
+
+        cuda_rc = cudaIpcOpenMemHandle(&na_sm_cuda_ipc->ptr, *handle,
+            cudaIpcMemLazyEnablePeerAccess);
+        if (cuda_rc != cudaSuccess) {
+            free(na_sm_cuda_ipc);
+            NA_GOTO_SUBSYS_ERROR(rma, unlock, ret, NA_PROTOCOL_ERROR,
+                "cudaIpcOpenMemHandle() failed (%s)",
+                cudaGetErrorString(cuda_rc));
+        }
+    } else
+        HG_LIST_REMOVE(na_sm_cuda_ipc, entry);
+
+    /* Keep most recently used mappings first */
+    HG_LIST_INSERT_HEAD(&na_sm_cuda_ipc_map->list, na_sm_cuda_ipc, entry);
+
+    hg_thread_mutex_unlock(&na_sm_cuda_ipc_map->lock);
+
+    /* Mappings remain valid until finalize */
+    *ptr_p = na_sm_cuda_ipc->ptr;
+
+    return NA_SUCCESS;
+
+unlock:
+    hg_thread_mutex_unlock(&na_sm_cuda_ipc_map->lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_cuda_rma(struct na_sm_class *na_sm_class, na_cb_type_t cb_type,
+    na_sm_process_vm_op_t process_vm_op, pid_t pid,
+    const struct na_sm_mem_handle *na_sm_mem_handle_local,
+    const struct iovec *local_iov, unsigned long liovcnt,
+    const struct na_sm_mem_handle *na_sm_mem_handle_remote,
+    const struct iovec *remote_iov, unsigned long riovcnt, size_t length)
+{
+    char *remote_ptr = NULL, *bounce_buf = NULL;
+    unsigned long i;
+    na_return_t ret;
+
+    if (na_sm_mem_handle_remote->info.mem_type != NA_MEM_TYPE_HOST) {
+        /* Device handles have a single segment, remote IOV is a sub-range */
+        size_t offset = (size_t) ((const char *) remote_iov[0].iov_base -
+                                  (const char *) NA_SM_IOV(
+                                      na_sm_mem_handle_remote)[0]
+                                      .iov_base);
+
+        if (pid == na_sm_class->endpoint.source_addr->addr_key.pid)
+            remote_ptr = (char *) remote_iov[0].iov_base;
+        else {
+            ret = na_sm_cuda_ipc_open(na_sm_class,
+                &na_sm_mem_handle_remote->info.cuda_ipc, (void **) &remote_ptr);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                rma, error, ret, "Could not open remote device allocation");
+            remote_ptr += na_sm_mem_handle_remote->info.cuda_offset + offset;
+        }
+    } else {
+        struct iovec bounce_iov;
+
+        /* Local memory is on device, stage remote host memory */
+        (void) na_sm_mem_handle_local;
+        bounce_buf = (char *) malloc(length);
+        NA_CHECK_SUBSYS_ERROR(rma, bounce_buf == NULL, error, ret, NA_NOMEM,
+            "Could not allocate bounce buffer of %zu bytes", length);
+        bounce_iov = (struct iovec){.iov_base = bounce_buf, .iov_len = length};
+
+        if (cb_type == NA_CB_GET) {
+            ret = process_vm_op(
+                pid, &bounce_iov, 1, remote_iov, riovcnt, length);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                rma, error, ret, "Could not read remote host memory");
+        }
+        remote_ptr = bounce_buf;
+    }
+
+    /* Copy local segments to/from contiguous remote region */
+    for (i = 0; i < liovcnt && length > 0; i++) {
+        size_t len = MIN(local_iov[i].iov_len, length);
+        cudaError_t cuda_rc =
+            (cb_type == NA_CB_PUT)
+                ? cudaMemcpy(remote_ptr, local_iov[i].iov_base, len,
+                      cudaMemcpyDefault)
+                : cudaMemcpy(local_iov[i].iov_base, remote_ptr, len,
+                      cudaMemcpyDefault);
+
+        NA_CHECK_SUBSYS_ERROR(rma, cuda_rc != cudaSuccess, error, ret,
+            NA_PROTOCOL_ERROR, "cudaMemcpy() failed (%s)",
+            cudaGetErrorString(cuda_rc));
+        remote_ptr += len;
+        length -= len;
+    }
+
+    if (bounce_buf != NULL && cb_type == NA_CB_PUT) {
+        struct iovec bounce_iov = {.iov_base = bounce_buf,
+            .iov_len = (size_t) (remote_ptr - bounce_buf)};
+
+        ret = process_vm_op(
+            pid, &bounce_iov, 1, remote_iov, riovcnt, bounce_iov.iov_len);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            rma, error, ret, "Could not write remote host memory");
+    }
+    free(bounce_buf);
+
+    return NA_SUCCESS;
+
+error:
+    free(bounce_buf);
+
+    return ret;
 }
+#endif
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_rma(struct na_sm_class *na_sm_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg,
+    na_sm_process_vm_op_t process_vm_op,
+    struct na_sm_mem_handle *na_sm_mem_handle_local, na_offset_t local_offset,
+    struct na_sm_mem_handle *na_sm_mem_handle_remote, na_offset_t remote_offset,
+    size_t length, struct na_sm_addr *na_sm_addr,
+    struct na_sm_op_id *na_sm_op_id)
+{
+    struct iovec *local_iov = NA_SM_IOV(na_sm_mem_handle_local),
+                 *remote_iov = NA_SM_IOV(na_sm_mem_handle_remote);
+    unsigned long local_iovcnt = na_sm_mem_handle_local->info.iovcnt,
+                  remote_iovcnt = na_sm_mem_handle_remote->info.iovcnt;
+    unsigned long local_iov_start_index = 0, remote_iov_start_index = 0;
+    na_offset_t local_iov_start_offset = 0, remote_iov_start_offset = 0;
+    union na_sm_iov local_trans_iov, remote_trans_iov;
+    struct iovec *liov, *riov;
+    unsigned long liovcnt = 0, riovcnt = 0;
+    bool bounce = false;
+    na_return_t ret;
+
+#if !defined(NA_SM_HAS_CMA) && !defined(__APPLE__)
+    NA_GOTO_SUBSYS_ERROR(
+        error, ret, NA_OPNOTSUPPORTED, "Not implemented for this platform");
+#endif
+
+    switch (na_sm_mem_handle_remote->info.flags) {
+        case NA_MEM_READ_ONLY:
+            NA_CHECK_SUBSYS_ERROR(rma, cb_type == NA_CB_PUT, error, ret,
+                NA_PERMISSION, "Registered memory requires write permission");
+            break;
+        case NA_MEM_WRITE_ONLY:
+            NA_CHECK_SUBSYS_ERROR(rma, cb_type == NA_CB_GET, error, ret,
+                NA_PERMISSION, "Registered memory requires write permission");
+            break;
+        case NA_MEM_READWRITE:
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(
+                rma, error, ret, NA_INVALID_ARG, "Invalid memory access flag");
+    }
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_sm_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_sm_op_id->completion_data.callback_info.type));
+
+    NA_SM_OP_RESET(na_sm_op_id, context, cb_type, callback, arg, na_sm_addr);
+
+    /* Translate local offset */
+    if (local_offset > 0)
+        na_sm_iov_get_index_offset(local_iov, local_iovcnt, local_offset,
+            &local_iov_start_index, &local_iov_start_offset);
+
+    if (length != na_sm_mem_handle_local->info.len) {
+        liovcnt = na_sm_iov_get_count(local_iov, local_iovcnt,
+            local_iov_start_index, local_iov_start_offset, length);
+
+        if (liovcnt > NA_SM_IOV_STATIC_MAX) {
+            local_trans_iov.d =
+                (struct iovec *) malloc(liovcnt * sizeof(struct iovec));
+            NA_CHECK_SUBSYS_ERROR(rma, local_trans_iov.d == NULL, release, ret,
+                NA_NOMEM, "Could not allocate iovec");
+
+            liov = local_trans_iov.d;
+        } else
+            liov = local_trans_iov.s;
+
+        na_sm_iov_translate(local_iov, local_iovcnt, local_iov_start_index,
+            local_iov_start_offset, length, liov, liovcnt);
+    } else {
+        liov = local_iov;
+        liovcnt = local_iovcnt;
+    }
+
+    /* Translate remote offset */
+    if (remote_offset > 0)
+        na_sm_iov_get_index_offset(remote_iov, remote_iovcnt, remote_offset,
+            &remote_iov_start_index, &remote_iov_start_offset);
+
+    if (length != na_sm_mem_handle_remote->info.len) {
+        riovcnt = na_sm_iov_get_count(remote_iov, remote_iovcnt,
+            remote_iov_start_index, remote_iov_start_offset, length);
+
+        if (riovcnt > NA_SM_IOV_STATIC_MAX) {
+            remote_trans_iov.d =
+                (struct iovec *) malloc(riovcnt * sizeof(struct iovec));
+            NA_CHECK_SUBSYS_ERROR(rma, remote_trans_iov.d == NULL, release, ret,
+                NA_NOMEM, "Could not allocate iovec");
+
+            riov = remote_trans_iov.d;
+        } else
+            riov = remote_trans_iov.s;
+
+        na_sm_iov_translate(remote_iov, remote_iovcnt, remote_iov_start_index,
+            remote_iov_start_offset, length, riov, riovcnt);
+    } else {
+        riov = remote_iov;
+        riovcnt = remote_iovcnt;
+    }
+
+    NA_LOG_SUBSYS_DEBUG(rma, "Posting rma op (op id=%p)", (void *) na_sm_op_id);
+
+    /* NB. addr does not need to be fully "resolved" to issue RMA */
+#ifdef NA_SM_HAS_CUDA
+    if (na_sm_mem_handle_local->info.mem_type != NA_MEM_TYPE_HOST ||
+        na_sm_mem_handle_remote->info.mem_type != NA_MEM_TYPE_HOST)
+        ret = na_sm_cuda_rma(na_sm_class, cb_type, process_vm_op,
+            na_sm_addr->addr_key.pid, na_sm_mem_handle_local, liov, liovcnt,
+            na_sm_mem_handle_remote, riov, riovcnt, length);
+    else
+#endif
+#ifdef NA_SM_HAS_XPMEM
+    if (na_sm_mem_handle_remote->info.segid != -1)
+        ret = na_sm_xpmem_rma(na_sm_class, cb_type,
+            (xpmem_segid_t) na_sm_mem_handle_remote->info.segid, liov, liovcnt,
+            riov, riovcnt, length);
+    else
+#endif
+    {
+        ret = NA_SUCCESS;
+        if (!hg_atomic_get32(&na_sm_class->rma_bounce)) {
+            ret = process_vm_op(
+                na_sm_addr->addr_key.pid, liov, liovcnt, riov, riovcnt, length);
+            if (ret == NA_PERMISSION) {
+                /* Cross-memory attach is not permitted (ptrace_scope,
+                 * container policies), stage through copy buffers instead */
+                NA_LOG_SUBSYS_WARNING(rma,
+                    "Falling back to RMA staged through copy buffers");
+                hg_atomic_set32(&na_sm_class->rma_bounce, 1);
+            }
+        }
+        bounce = hg_atomic_get32(&na_sm_class->rma_bounce) && length > 0;
+        if (bounce)
+            ret = na_sm_rma_bounce(&na_sm_class->endpoint, na_sm_op_id,
+                na_sm_mem_handle_local, local_offset, na_sm_mem_handle_remote,
+                remote_offset, length);
+    }
+    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "process_vm_op() failed");
+
+    /* Free before adding to completion queue */
+    if (liovcnt > NA_SM_IOV_STATIC_MAX &&
+        (length != na_sm_mem_handle_local->info.len))
+        free(local_trans_iov.d);
+    if (riovcnt > NA_SM_IOV_STATIC_MAX &&
+        (length != na_sm_mem_handle_remote->info.len))
+        free(remote_trans_iov.d);
+
+    /* Staged ops complete once target acknowledged all chunks */
+    if (bounce)
+        return NA_SUCCESS;
+
+    /* Immediate completion */
+    na_sm_complete(na_sm_op_id, NA_SUCCESS);
+
+    /* Notify local completion */
+    na_sm_complete_signal(na_sm_class);
+
+    return NA_SUCCESS;
+
+release:
+    if (liovcnt > NA_SM_IOV_STATIC_MAX &&
+        (length != na_sm_mem_handle_local->info.len))
+        free(local_trans_iov.d);
+    if (riovcnt > NA_SM_IOV_STATIC_MAX &&
+        (length != na_sm_mem_handle_remote->info.len))
+        free(remote_trans_iov.d);
+
+    NA_SM_OP_RELEASE(na_sm_op_id);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_rma_bounce(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_op_id *na_sm_op_id,
+    struct na_sm_mem_handle *na_sm_mem_handle_local, na_offset_t local_offset,
+    struct na_sm_mem_handle *na_sm_mem_handle_remote, na_offset_t remote_offset,
+    size_t length)
+{
+    struct na_sm_op_queue *rma_op_queue = &na_sm_endpoint->rma_op_queue;
+    na_return_t ret;
+
+    na_sm_op_id->info.rma =
+        (struct na_sm_rma_info){.local_handle = na_sm_mem_handle_local,
+            .remote_handle = na_sm_mem_handle_remote,
+            .local_offset = local_offset,
+            .remote_offset = remote_offset,
+            .length = length,
+            .posted = 0,
+            .completed = 0,
+            .inflight = 0,
+            .ret = NA_SUCCESS};
+
+    hg_thread_spin_lock(&rma_op_queue->lock);
+    ret = na_sm_rma_bounce_post(na_sm_endpoint, na_sm_op_id);
+    if (ret == NA_AGAIN) {
+        /* No copy buffer or queue entry left, posted again from progress */
+        hg_atomic_incr64(NA_SM_CLASS(na_sm_op_id->na_class)->retry_count);
+        HG_QUEUE_PUSH_TAIL(&rma_op_queue->queue, na_sm_op_id, entry);
+        hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_QUEUED);
+        ret = NA_SUCCESS;
+    }
+    hg_thread_spin_unlock(&rma_op_queue->lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_rma_bounce_post(
+    struct na_sm_endpoint *na_sm_endpoint, struct na_sm_op_id *na_sm_op_id)
+{
+    struct na_sm_rma_info *rma = &na_sm_op_id->info.rma;
+    struct na_sm_addr *na_sm_addr = na_sm_op_id->addr;
+    const struct iovec *remote_iov = NA_SM_IOV(rma->remote_handle);
+    na_cb_type_t cb_type = na_sm_op_id->completion_data.callback_info.type;
+    struct na_sm_region *na_sm_region;
+    unsigned int posted_count = 0;
+    na_return_t ret;
+
+    /* Chunks are handed off through the queue pair shared with target */
+    ret = na_sm_msg_send_resolve(na_sm_addr);
+    if (ret != NA_SUCCESS)
+        return ret;
+    NA_CHECK_SUBSYS_ERROR(rma, na_sm_addr->shared_region == NULL, error, ret,
+        NA_OPNOTSUPPORTED, "No region shared with peer (not listening)");
+    na_sm_region = na_sm_addr->shared_region;
+
+    while (rma->posted < rma->length &&
+           rma->inflight < NA_SM_RMA_BOUNCE_DEPTH) {
+        union na_sm_msg_hdr msg_hdr;
+        struct na_sm_rma_chunk chunk;
+        unsigned long riov_index = 0;
+        na_offset_t riov_offset = 0;
+        unsigned int buf_idx;
+        size_t len;
+
+        if (na_sm_buf_reserve(na_sm_region, &buf_idx) != NA_SUCCESS)
+            break;
+
+        /* Chunks do not span remote segments */
+        na_sm_iov_get_index_offset(remote_iov, rma->remote_handle->info.iovcnt,
+            rma->remote_offset + rma->posted, &riov_index, &riov_offset);
+        len = MIN(rma->length - rma->posted, na_sm_region->layout.buf_size);
+        len = MIN(len, remote_iov[riov_index].iov_len - riov_offset);
+
+        chunk = (struct na_sm_rma_chunk){
+            .op_id = (uint64_t) (uintptr_t) na_sm_op_id,
+            .addr = (uint64_t) (uintptr_t) remote_iov[riov_index].iov_base +
+                    riov_offset,
+            .offset = rma->posted,
+            .len = (uint32_t) len,
+            .buf_idx = buf_idx};
+        if (cb_type == NA_CB_PUT)
+            na_sm_rma_bounce_copy(rma->local_handle,
+                rma->local_offset + rma->posted,
+                na_sm_buf_ptr(na_sm_region, buf_idx), len, true);
+
+        msg_hdr = (union na_sm_msg_hdr){
+            .hdr.type = (cb_type == NA_CB_PUT) ? NA_SM_RMA_PUT : NA_SM_RMA_GET,
+            .hdr.buf_size = sizeof(chunk) & 0xffff,
+            .hdr.inline_buf = 1};
+        if (!na_sm_msg_queue_push(na_sm_addr->tx_queue, &msg_hdr, &chunk)) {
+            na_sm_buf_release(na_sm_region, buf_idx);
+            break;
+        }
+
+        rma->posted += len;
+        rma->inflight++;
+        posted_count++;
+    }
+
+    /* Notify target once for all chunks, chunks are already posted and will
+     * be picked up on next poll in case of failure */
+    if (posted_count > 0)
+        (void) na_sm_msg_send_notify(na_sm_endpoint, na_sm_addr);
+
+    /* Remaining chunks are posted as chunks in flight are acknowledged */
+    return (rma->inflight > 0) ? NA_SUCCESS : NA_AGAIN;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_rma_bounce_copy(const struct na_sm_mem_handle *na_sm_mem_handle,
+    na_offset_t offset, char *buf, size_t len, bool to_buf)
+{
+    const struct iovec *iov = NA_SM_IOV(na_sm_mem_handle);
+    unsigned long iovcnt = na_sm_mem_handle->info.iovcnt, i = 0;
+    na_offset_t iov_offset = 0;
+
+    na_sm_iov_get_index_offset(iov, iovcnt, offset, &i, &iov_offset);
+
+    for (; i < iovcnt && len > 0; i++) {
+        char *ptr = (char *) iov[i].iov_base + iov_offset;
+        size_t n = MIN(len, iov[i].iov_len - iov_offset);
+
+        if (to_buf)
+            hg_mem_copy(buf, ptr, n);
+        else
+            hg_mem_copy(ptr, buf, n);
+        buf += n;
+        len -= n;
+        iov_offset = 0;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_rma_ack_post(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *na_sm_addr, const struct na_sm_rma_chunk *chunk)
+{
+    union na_sm_msg_hdr msg_hdr = {.hdr.type = NA_SM_RMA_ACK,
+        .hdr.buf_size = sizeof(*chunk) & 0xffff,
+        .hdr.inline_buf = 1};
+    na_return_t ret;
+
+    if (!na_sm_msg_queue_push(na_sm_addr->tx_queue, &msg_hdr, chunk)) {
+        struct na_sm_rma_ack *na_sm_rma_ack =
+            (struct na_sm_rma_ack *) malloc(sizeof(*na_sm_rma_ack));
+        NA_CHECK_SUBSYS_ERROR(rma, na_sm_rma_ack == NULL, error, ret, NA_NOMEM,
+            "Could not allocate RMA ack");
+
+        /* Origin drains its queue while waiting for acks */
+        na_sm_rma_ack->na_sm_addr = na_sm_addr;
+        na_sm_rma_ack->chunk = *chunk;
+        na_sm_addr_ref_incr(na_sm_addr);
+
+        hg_thread_spin_lock(&na_sm_endpoint->rma_ack_queue.lock);
+        HG_QUEUE_PUSH_TAIL(
+            &na_sm_endpoint->rma_ack_queue.queue, na_sm_rma_ack, entry);
+        hg_thread_spin_unlock(&na_sm_endpoint->rma_ack_queue.lock);
+
+        return NA_SUCCESS;
+    }
+
+    return na_sm_msg_send_notify(na_sm_endpoint, na_sm_addr);
 
-/*---------------------------------------------------------------------------*/
-static NA_INLINE void
-na_sm_buf_copy_from(struct na_sm_copy_buf *na_sm_copy_buf, unsigned int index,
-    void *dest, size_t n)
-{
-    hg_thread_spin_lock(&na_sm_copy_buf->buf_locks[index]);
-    memcpy(dest, na_sm_copy_buf->buf[index], n);
-    hg_thread_spin_unlock(&na_sm_copy_buf->buf_locks[index]);
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_rma(struct na_sm_class *na_sm_class, na_context_t *context,
-    na_cb_type_t cb_type, na_cb_t callback, void *arg,
-    na_sm_process_vm_op_t process_vm_op,
-    struct na_sm_mem_handle *na_sm_mem_handle_local, na_offset_t local_offset,
-    struct na_sm_mem_handle *na_sm_mem_handle_remote, na_offset_t remote_offset,
-    size_t length, struct na_sm_addr *na_sm_addr,
+na_sm_atomic_rmw(struct na_sm_class *na_sm_class, na_context_t *context,
+    na_cb_t callback, void *arg, na_atomic_op_t op, uint64_t operand,
+    uint64_t compare, struct na_sm_mem_handle *na_sm_mem_handle_remote,
+    na_offset_t remote_offset, struct na_sm_addr *na_sm_addr,
     struct na_sm_op_id *na_sm_op_id)
 {
-    struct iovec *local_iov = NA_SM_IOV(na_sm_mem_handle_local),
-                 *remote_iov = NA_SM_IOV(na_sm_mem_handle_remote);
-    unsigned long local_iovcnt = na_sm_mem_handle_local->info.iovcnt,
-                  remote_iovcnt = na_sm_mem_handle_remote->info.iovcnt;
-    unsigned long local_iov_start_index = 0, remote_iov_start_index = 0;
-    na_offset_t local_iov_start_offset = 0, remote_iov_start_offset = 0;
-    union na_sm_iov local_trans_iov, remote_trans_iov;
-    struct iovec *liov, *riov;
-    unsigned long liovcnt = 0, riovcnt = 0;
+    struct iovec *remote_iov = NA_SM_IOV(na_sm_mem_handle_remote);
+    unsigned long remote_iov_start_index = 0;
+    na_offset_t remote_iov_start_offset = 0;
+    struct iovec liov, riov;
+    hg_thread_spin_t *lock;
+    uint64_t val, new_val;
     na_return_t ret;
 
 #if !defined(NA_SM_HAS_CMA) && !defined(__APPLE__)
@@ -3284,21 +5349,24 @@ na_sm_rma(struct na_sm_class *na_sm_class, na_context_t *context,
         error, ret, NA_OPNOTSUPPORTED, "Not implemented for this platform");
 #endif
 
-    switch (na_sm_mem_handle_remote->info.flags) {
-        case NA_MEM_READ_ONLY:
-            NA_CHECK_SUBSYS_ERROR(rma, cb_type == NA_CB_PUT, error, ret,
-                NA_PERMISSION, "Registered memory requires write permission");
-            break;
-        case NA_MEM_WRITE_ONLY:
-            NA_CHECK_SUBSYS_ERROR(rma, cb_type == NA_CB_GET, error, ret,
-                NA_PERMISSION, "Registered memory requires write permission");
-            break;
-        case NA_MEM_READWRITE:
-            break;
-        default:
-            NA_GOTO_SUBSYS_ERROR(
-                rma, error, ret, NA_INVALID_ARG, "Invalid memory access flag");
-    }
+    NA_CHECK_SUBSYS_ERROR(rma,
+        na_sm_mem_handle_remote->info.flags != NA_MEM_READWRITE, error, ret,
+        NA_PERMISSION, "Registered memory requires read/write permission");
+#ifdef NA_SM_HAS_CUDA
+    NA_CHECK_SUBSYS_ERROR(rma,
+        na_sm_mem_handle_remote->info.mem_type != NA_MEM_TYPE_HOST, error, ret,
+        NA_OPNOTSUPPORTED, "Atomics on device memory are not supported");
+#endif
+    NA_CHECK_SUBSYS_ERROR(rma,
+        remote_offset + sizeof(uint64_t) > na_sm_mem_handle_remote->info.len,
+        error, ret, NA_OVERFLOW, "Remote offset (%" PRIu64 ") out of bounds",
+        remote_offset);
+
+    /* Locks are in the region shared with peer, resolve addr to map it */
+    ret = na_sm_msg_send_resolve(na_sm_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, error, ret, "Could not resolve address");
+    NA_CHECK_SUBSYS_ERROR(rma, na_sm_addr->shared_region == NULL, error, ret,
+        NA_OPNOTSUPPORTED, "No region shared with peer (not listening)");
 
     /* Check op_id */
     NA_CHECK_SUBSYS_ERROR(op, na_sm_op_id == NULL, error, ret, NA_INVALID_ARG,
@@ -3308,75 +5376,47 @@ na_sm_rma(struct na_sm_class *na_sm_class, na_context_t *context,
         ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
         na_cb_type_to_string(na_sm_op_id->completion_data.callback_info.type));
 
-    NA_SM_OP_RESET(na_sm_op_id, context, cb_type, callback, arg, na_sm_addr);
-
-    /* Translate local offset */
-    if (local_offset > 0)
-        na_sm_iov_get_index_offset(local_iov, local_iovcnt, local_offset,
-            &local_iov_start_index, &local_iov_start_offset);
-
-    if (length != na_sm_mem_handle_local->info.len) {
-        liovcnt = na_sm_iov_get_count(local_iov, local_iovcnt,
-            local_iov_start_index, local_iov_start_offset, length);
-
-        if (liovcnt > NA_SM_IOV_STATIC_MAX) {
-            local_trans_iov.d =
-                (struct iovec *) malloc(liovcnt * sizeof(struct iovec));
-            NA_CHECK_SUBSYS_ERROR(rma, local_trans_iov.d == NULL, release, ret,
-                NA_NOMEM, "Could not allocate iovec");
-
-            liov = local_trans_iov.d;
-        } else
-            liov = local_trans_iov.s;
-
-        na_sm_iov_translate(local_iov, local_iovcnt, local_iov_start_index,
-            local_iov_start_offset, length, liov, liovcnt);
-    } else {
-        liov = local_iov;
-        liovcnt = local_iovcnt;
-    }
-
-    /* Translate remote offset */
-    if (remote_offset > 0)
-        na_sm_iov_get_index_offset(remote_iov, remote_iovcnt, remote_offset,
-            &remote_iov_start_index, &remote_iov_start_offset);
-
-    if (length != na_sm_mem_handle_remote->info.len) {
-        riovcnt = na_sm_iov_get_count(remote_iov, remote_iovcnt,
-            remote_iov_start_index, remote_iov_start_offset, length);
+    /* Translate remote offset, operand must not span segments */
+    na_sm_iov_get_index_offset(remote_iov,
+        na_sm_mem_handle_remote->info.iovcnt, remote_offset,
+        &remote_iov_start_index, &remote_iov_start_offset);
+    NA_CHECK_SUBSYS_ERROR(rma,
+        remote_iov[remote_iov_start_index].iov_len - remote_iov_start_offset <
+            sizeof(uint64_t),
+        error, ret, NA_INVALID_ARG, "Remote operand spans segments");
 
-        if (riovcnt > NA_SM_IOV_STATIC_MAX) {
-            remote_trans_iov.d =
-                (struct iovec *) malloc(riovcnt * sizeof(struct iovec));
-            NA_CHECK_SUBSYS_ERROR(rma, remote_trans_iov.d == NULL, release, ret,
-                NA_NOMEM, "Could not allocate iovec");
+    NA_SM_OP_RESET(
+        na_sm_op_id, context, NA_CB_ATOMIC, callback, arg, na_sm_addr);
 
-            riov = remote_trans_iov.d;
-        } else
-            riov = remote_trans_iov.s;
+    liov.iov_base = &val;
+    liov.iov_len = sizeof(val);
+    riov.iov_base = (char *) remote_iov[remote_iov_start_index].iov_base +
+                    remote_iov_start_offset;
+    riov.iov_len = sizeof(val);
 
-        na_sm_iov_translate(remote_iov, remote_iovcnt, remote_iov_start_index,
-            remote_iov_start_offset, length, riov, riovcnt);
-    } else {
-        riov = remote_iov;
-        riovcnt = remote_iovcnt;
+    NA_LOG_SUBSYS_DEBUG(
+        rma, "Posting atomic op (op id=%p)", (void *) na_sm_op_id);
+
+    lock = &na_sm_addr->shared_region->atomic_locks
+                .val[((uintptr_t) riov.iov_base / sizeof(uint64_t)) &
+                     (NA_SM_ATOMIC_LOCKS - 1)];
+    hg_thread_spin_lock(lock);
+    ret = na_sm_process_vm_readv(
+        na_sm_addr->addr_key.pid, &liov, 1, &riov, 1, sizeof(val));
+    if (ret == NA_SUCCESS) {
+        new_val = (op == NA_ATOMIC_FETCH_ADD) ? val + operand
+                  : (val == compare)          ? operand
+                                              : val;
+        na_sm_op_id->completion_data.callback_info.info.atomic.result = val;
+        if (new_val != val) {
+            val = new_val;
+            ret = na_sm_process_vm_writev(
+                na_sm_addr->addr_key.pid, &liov, 1, &riov, 1, sizeof(val));
+        }
     }
-
-    NA_LOG_SUBSYS_DEBUG(rma, "Posting rma op (op id=%p)", (void *) na_sm_op_id);
-
-    /* NB. addr does not need to be fully "resolved" to issue RMA */
-    ret = process_vm_op(
-        na_sm_addr->addr_key.pid, liov, liovcnt, riov, riovcnt, length);
+    hg_thread_spin_unlock(lock);
     NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "process_vm_op() failed");
 
-    /* Free before adding to completion queue */
-    if (liovcnt > NA_SM_IOV_STATIC_MAX &&
-        (length != na_sm_mem_handle_local->info.len))
-        free(local_trans_iov.d);
-    if (riovcnt > NA_SM_IOV_STATIC_MAX &&
-        (length != na_sm_mem_handle_remote->info.len))
-        free(remote_trans_iov.d);
-
     /* Immediate completion */
     na_sm_complete(na_sm_op_id, NA_SUCCESS);
 
@@ -3386,13 +5426,6 @@ na_sm_rma(struct na_sm_class *na_sm_class, na_context_t *context,
     return NA_SUCCESS;
 
 release:
-    if (liovcnt > NA_SM_IOV_STATIC_MAX &&
-        (length != na_sm_mem_handle_local->info.len))
-        free(local_trans_iov.d);
-    if (riovcnt > NA_SM_IOV_STATIC_MAX &&
-        (length != na_sm_mem_handle_remote->info.len))
-        free(remote_trans_iov.d);
-
     NA_SM_OP_RELEASE(na_sm_op_id);
 
 error:
@@ -3480,8 +5513,11 @@ na_sm_process_vm_writev(pid_t pid, const struct iovec *local_iov,
 
     nwrite = process_vm_writev(pid, local_iov, liovcnt, remote_iov, riovcnt, 0);
     if (unlikely(nwrite < 0)) {
-        if ((errno == EPERM) && na_sm_get_ptrace_scope_value()) {
-            NA_GOTO_SUBSYS_ERROR(fatal, error, ret, na_sm_errno_to_na(errno),
+        /* Save errno, reading ptrace scope may overwrite it */
+        int rc = errno;
+
+        if ((rc == EPERM) && na_sm_get_ptrace_scope_value()) {
+            NA_GOTO_SUBSYS_ERROR(fatal, error, ret, na_sm_errno_to_na(rc),
                 "process_vm_writev() failed (%s):\n"
                 "Kernel Yama configuration does not allow cross-memory attach, "
                 "either run as root: \n"
@@ -3491,10 +5527,10 @@ na_sm_process_vm_writev(pid_t pid, const struct iovec *local_iov,
                 "prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);\n"
                 "See https://www.kernel.org/doc/Documentation/security/Yama.txt"
                 " for more details.",
-                strerror(errno));
+                strerror(rc));
         } else
-            NA_GOTO_SUBSYS_ERROR(rma, error, ret, na_sm_errno_to_na(errno),
-                "process_vm_writev() failed (%s)", strerror(errno));
+            NA_GOTO_SUBSYS_ERROR(rma, error, ret, na_sm_errno_to_na(rc),
+                "process_vm_writev() failed (%s)", strerror(rc));
     }
 
     NA_CHECK_SUBSYS_ERROR(rma, (size_t) nwrite != length, error, ret,
@@ -3554,8 +5590,11 @@ na_sm_process_vm_readv(pid_t pid, const struct iovec *local_iov,
 
     nread = process_vm_readv(pid, local_iov, liovcnt, remote_iov, riovcnt, 0);
     if (unlikely(nread < 0)) {
-        if ((errno == EPERM) && na_sm_get_ptrace_scope_value()) {
-            NA_GOTO_SUBSYS_ERROR(fatal, error, ret, na_sm_errno_to_na(errno),
+        /* Save errno, reading ptrace scope may overwrite it */
+        int rc = errno;
+
+        if ((rc == EPERM) && na_sm_get_ptrace_scope_value()) {
+            NA_GOTO_SUBSYS_ERROR(fatal, error, ret, na_sm_errno_to_na(rc),
                 "process_vm_readv() failed (%s):\n"
                 "Kernel Yama configuration does not allow cross-memory attach, "
                 "either run as root: \n"
@@ -3565,10 +5604,10 @@ na_sm_process_vm_readv(pid_t pid, const struct iovec *local_iov,
                 "prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);\n"
                 "See https://www.kernel.org/doc/Documentation/security/Yama.txt"
                 " for more details.",
-                strerror(errno));
+                strerror(rc));
         } else
-            NA_GOTO_SUBSYS_ERROR(rma, error, ret, na_sm_errno_to_na(errno),
-                "process_vm_readv() failed (%s)", strerror(errno));
+            NA_GOTO_SUBSYS_ERROR(rma, error, ret, na_sm_errno_to_na(rc),
+                "process_vm_readv() failed (%s)", strerror(rc));
     }
 
     NA_CHECK_SUBSYS_ERROR(rma, (size_t) nread != length, error, ret, NA_MSGSIZE,
@@ -3619,6 +5658,71 @@ error:
 }
 #endif
 
+/*---------------------------------------------------------------------------*/
+static bool
+na_sm_poll_arm(struct na_sm_endpoint *na_sm_endpoint)
+{
+    struct na_sm_region *na_sm_region =
+        na_sm_endpoint->source_addr->shared_region;
+    struct na_sm_addr *poll_addr;
+    bool empty = true;
+
+    hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
+    if (!hg_atomic_get32(&na_sm_endpoint->armed)) {
+        hg_atomic_set32(&na_sm_endpoint->armed, 1);
+        /* Peers sending to local queue pairs check the doorbell */
+        if (na_sm_region)
+            hg_atomic_incr64(&na_sm_region_doorbell(na_sm_region)->waiting);
+    }
+    HG_LIST_FOREACH (poll_addr, &na_sm_endpoint->poll_addr_list.list, entry) {
+        if (!poll_addr->rx_armed) {
+            poll_addr->rx_armed = true;
+            hg_atomic_incr32(&poll_addr->rx_queue->cons_waiting);
+        }
+
+        /* Messages pushed before we armed are not notified */
+        if (!na_sm_msg_queue_is_empty(poll_addr->rx_queue))
+            empty = false;
+    }
+    hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
+
+    if (na_sm_region) {
+        struct na_sm_doorbell *doorbell = na_sm_region_doorbell(na_sm_region);
+        unsigned int i;
+
+        for (i = 0; i < na_sm_endpoint->pair_count / 64; i++)
+            if (hg_atomic_get64(&doorbell->pending[i]) != 0)
+                empty = false;
+    }
+
+    return empty;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_poll_disarm(struct na_sm_endpoint *na_sm_endpoint)
+{
+    struct na_sm_region *na_sm_region =
+        na_sm_endpoint->source_addr->shared_region;
+    struct na_sm_addr *poll_addr;
+
+    if (!hg_atomic_get32(&na_sm_endpoint->armed))
+        return;
+
+    hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
+    hg_atomic_set32(&na_sm_endpoint->armed, 0);
+    if (na_sm_region)
+        hg_atomic_decr64(&na_sm_region_doorbell(na_sm_region)->waiting);
+    HG_LIST_FOREACH (poll_addr, &na_sm_endpoint->poll_addr_list.list, entry) {
+        /* Addresses may have been added while we were waiting */
+        if (poll_addr->rx_armed) {
+            poll_addr->rx_armed = false;
+            hg_atomic_decr32(&poll_addr->rx_queue->cons_waiting);
+        }
+    }
+    hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_poll_wait(na_context_t *context, struct na_sm_endpoint *na_sm_endpoint,
@@ -3630,11 +5734,16 @@ na_sm_poll_wait(na_context_t *context, struct na_sm_endpoint *na_sm_endpoint,
     na_return_t ret = NA_SUCCESS;
     int rc;
 
+    /* Peers only signal rx notify events when we are about to block */
+    if (timeout > 0 && !na_sm_poll_arm(na_sm_endpoint))
+        timeout = 0;
+
     /* Just wait on a single event, anything greater may increase
      * latency, and slow down progress, we will not wait next round
      * if something is still in the queues */
     rc = hg_poll_wait(
         na_sm_endpoint->poll_set, timeout, NA_SM_MAX_EVENTS, events, &nevents);
+    na_sm_poll_disarm(na_sm_endpoint);
     NA_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, done, ret,
         na_sm_errno_to_na(errno), "hg_poll_wait() failed");
 
@@ -3703,7 +5812,7 @@ na_sm_poll(struct na_sm_endpoint *na_sm_endpoint, bool *progressed_ptr)
     bool progressed = false;
     na_return_t ret = NA_SUCCESS;
 
-    /* Check whether something is in one of the rx queues */
+    /* Check whether something is in one of the rx queues of remote regions */
     hg_thread_spin_lock(&poll_addr_list->lock);
     HG_LIST_FOREACH (poll_addr, &poll_addr_list->list, entry) {
         bool progressed_rx = false;
@@ -3720,7 +5829,18 @@ na_sm_poll(struct na_sm_endpoint *na_sm_endpoint, bool *progressed_ptr)
     }
     hg_thread_spin_unlock(&poll_addr_list->lock);
 
-    /* Look for message in cmd queue (if listening) */
+    /* Only visit local queue pairs that have pending messages */
+    if (na_sm_endpoint->source_addr->shared_region) {
+        bool progressed_rx = false;
+
+        ret = na_sm_progress_doorbell(na_sm_endpoint, &progressed_rx);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            poll, done, ret, "Could not progress rx queues");
+        progressed |= progressed_rx;
+    }
+
+    /* Look for message in cmd queue (if listening), reservations are only
+     * pushed there, their notify events come separately through sock */
     if (na_sm_endpoint->source_addr->shared_region) {
         bool progressed_cmd = false;
 
@@ -3736,12 +5856,75 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_progress_doorbell(
+    struct na_sm_endpoint *na_sm_endpoint, bool *progressed)
+{
+    struct na_sm_region *na_sm_region =
+        na_sm_endpoint->source_addr->shared_region;
+    struct na_sm_doorbell *doorbell = na_sm_region_doorbell(na_sm_region);
+    bool progressed_any = false;
+    na_return_t ret = NA_SUCCESS;
+    unsigned int i;
+
+    for (i = 0; i < na_sm_endpoint->pair_count / 64; i++) {
+        hg_atomic_int64_t *pending = &doorbell->pending[i];
+        uint64_t bits;
+
+        /* Do not take the cache line away from peers if nothing is pending */
+        if (hg_atomic_get64(pending) == 0)
+            continue;
+        bits = (uint64_t) hg_atomic_and64(pending, 0);
+
+        while (bits != 0) {
+            struct na_sm_addr *poll_addr;
+            bool progressed_rx = false;
+            unsigned int j = 0;
+            uint16_t idx;
+
+            while (!(bits & ((uint64_t) 1 << j)))
+                j++;
+            bits &= ~((uint64_t) 1 << j);
+            idx = (uint16_t) (i * 64 + j);
+
+            /* Pair was released or peer rang before its address was
+             * registered, in which case the doorbell is rung again then */
+            hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
+            poll_addr = na_sm_endpoint->pair_addrs[idx];
+            hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
+            if (poll_addr == NULL)
+                continue;
+
+            ret = na_sm_progress_rx_queue(
+                na_sm_endpoint, poll_addr, &progressed_rx);
+            if (unlikely(ret != NA_SUCCESS)) {
+                /* Leave this and remaining pairs pending */
+                hg_atomic_or64(pending, (int64_t) (bits | ((uint64_t) 1 << j)));
+                NA_GOTO_SUBSYS_ERROR_NORET(
+                    poll, done, "Could not progress rx queue");
+            }
+            progressed_any |= progressed_rx;
+
+            /* Only one message is processed per pair at a time */
+            if (!na_sm_msg_queue_is_empty(poll_addr->rx_queue))
+                na_sm_region_doorbell_ring(na_sm_region, idx);
+        }
+    }
+
+    *progressed = progressed_any;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_progress_sock(struct na_sm_endpoint *na_sm_endpoint, bool *progressed)
 {
     union na_sm_cmd_hdr cmd_hdr = {.val = 0};
     int tx_notify = -1, rx_notify = -1;
+    bool progressed_cmd;
     na_return_t ret = NA_SUCCESS;
 
     /* Attempt to receive addr info (events, queue index) */
@@ -3756,7 +5939,13 @@ na_sm_progress_sock(struct na_sm_endpoint *na_sm_endpoint, bool *progressed)
         if (rx_notify > 0)
             hg_atomic_incr32(&na_sm_endpoint->nofile);
 
-        /* Process received cmd, TODO would be nice to use cmd queue */
+        /* Events follow reservations pushed to the cmd queue */
+        do {
+            ret = na_sm_progress_cmd_queue(na_sm_endpoint, &progressed_cmd);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                addr, done, ret, "Could not progress cmd queue");
+        } while (progressed_cmd);
+
         ret = na_sm_process_cmd(na_sm_endpoint, cmd_hdr, tx_notify, rx_notify);
         NA_CHECK_SUBSYS_NA_ERROR(addr, done, ret, "Could not process cmd");
     }
@@ -3775,7 +5964,8 @@ na_sm_progress_cmd_queue(
 
     /* Look for message in cmd queue */
     if (!na_sm_cmd_queue_pop(
-            &na_sm_endpoint->source_addr->shared_region->cmd_queue, &cmd_hdr)) {
+            na_sm_region_cmd_queue(na_sm_endpoint->source_addr->shared_region),
+            &cmd_hdr)) {
         *progressed = false;
         goto done;
     }
@@ -3796,7 +5986,7 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint,
 
     NA_LOG_SUBSYS_DEBUG(addr,
         "Processing cmd with %d from %d/%u/%u val=%" PRIu64, cmd_hdr.hdr.type,
-        cmd_hdr.hdr.pid, cmd_hdr.hdr.id & 0xff, cmd_hdr.hdr.pair_idx & 0xff,
+        cmd_hdr.hdr.pid, cmd_hdr.hdr.id & 0xff, cmd_hdr.hdr.pair_idx,
         cmd_hdr.val);
 
     switch (cmd_hdr.hdr.type) {
@@ -3816,14 +6006,10 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint,
             na_sm_addr->queue_pair_idx = cmd_hdr.hdr.pair_idx;
 
             /* Invert queues so that local rx is remote tx */
-            na_sm_addr->tx_queue =
-                &na_sm_addr->shared_region
-                     ->queue_pairs[na_sm_addr->queue_pair_idx]
-                     .rx_queue;
-            na_sm_addr->rx_queue =
-                &na_sm_addr->shared_region
-                     ->queue_pairs[na_sm_addr->queue_pair_idx]
-                     .tx_queue;
+            na_sm_addr->tx_queue = na_sm_region_queue(
+                na_sm_addr->shared_region, na_sm_addr->queue_pair_idx, false);
+            na_sm_addr->rx_queue = na_sm_region_queue(
+                na_sm_addr->shared_region, na_sm_addr->queue_pair_idx, true);
 
             /* Invert descriptors so that local rx is remote tx */
             na_sm_addr->tx_notify = rx_notify;
@@ -3844,28 +6030,28 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint,
             /* Unexpected addresses are always resolved */
             hg_atomic_or32(&na_sm_addr->status, NA_SM_ADDR_RESOLVED);
 
-            /* Add address to list of addresses to poll */
+            /* Local queue pairs are polled through the doorbell */
             hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
-            HG_LIST_INSERT_HEAD(
-                &na_sm_endpoint->poll_addr_list.list, na_sm_addr, entry);
+            na_sm_endpoint->pair_addrs[na_sm_addr->queue_pair_idx] =
+                na_sm_addr;
             hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
+
+            /* Peer may have rung the doorbell before it was registered */
+            if (!na_sm_msg_queue_is_empty(na_sm_addr->rx_queue))
+                na_sm_region_doorbell_ring(
+                    na_sm_addr->shared_region, na_sm_addr->queue_pair_idx);
             break;
         }
         case NA_SM_RELEASED: {
             struct na_sm_addr *na_sm_addr = NULL;
             bool found = false;
 
-            /* Find address from list of addresses to poll */
+            /* Find address of local queue pair */
             hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
-            HG_LIST_FOREACH (
-                na_sm_addr, &na_sm_endpoint->poll_addr_list.list, entry) {
-                if ((na_sm_addr->queue_pair_idx == cmd_hdr.hdr.pair_idx) &&
+            na_sm_addr = na_sm_endpoint->pair_addrs[cmd_hdr.hdr.pair_idx];
+            found = na_sm_addr &&
                     (na_sm_addr->addr_key.pid == (pid_t) cmd_hdr.hdr.pid) &&
-                    (na_sm_addr->addr_key.id == cmd_hdr.hdr.id)) {
-                    found = true;
-                    break;
-                }
-            }
+                    (na_sm_addr->addr_key.id == cmd_hdr.hdr.id);
             hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
 
             if (!found) {
@@ -3879,6 +6065,63 @@ na_sm_process_cmd(struct na_sm_endpoint *na_sm_endpoint,
             na_sm_addr_ref_decr(na_sm_addr);
             break;
         }
+        case NA_SM_NOTIFY: {
+            struct na_sm_addr *na_sm_addr = NULL;
+            bool found = false;
+
+            /* Find address of queue pair reserved through cmd queue */
+            hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
+            na_sm_addr = na_sm_endpoint->pair_addrs[cmd_hdr.hdr.pair_idx];
+            found = na_sm_addr &&
+                    (na_sm_addr->addr_key.pid == (pid_t) cmd_hdr.hdr.pid) &&
+                    (na_sm_addr->addr_key.id == cmd_hdr.hdr.id) &&
+                    na_sm_addr->tx_notify < 0 && na_sm_addr->rx_notify < 0;
+            hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
+
+            if (!found) {
+                /* Pair was already released, close events */
+                NA_LOG_SUBSYS_DEBUG(addr,
+                    "Could not find address for PID=%d, ID=%u, pair_index=%u",
+                    cmd_hdr.hdr.pid, cmd_hdr.hdr.id, cmd_hdr.hdr.pair_idx);
+                if (tx_notify > 0) {
+                    (void) na_sm_event_destroy(NULL, 0, 't', false, tx_notify);
+                    hg_atomic_decr32(&na_sm_endpoint->nofile);
+                }
+                if (rx_notify > 0) {
+                    (void) na_sm_event_destroy(NULL, 0, 'r', false, rx_notify);
+                    hg_atomic_decr32(&na_sm_endpoint->nofile);
+                }
+                break;
+            }
+
+            /* Invert descriptors so that local rx is remote tx */
+            na_sm_addr->tx_notify = rx_notify;
+            na_sm_addr->rx_notify = tx_notify;
+
+            if (na_sm_endpoint->poll_set && (na_sm_addr->rx_notify > 0)) {
+                na_sm_addr->rx_poll_type = NA_SM_POLL_RX_NOTIFY;
+                NA_LOG_SUBSYS_DEBUG(addr,
+                    "Registering rx notify %d for polling",
+                    na_sm_addr->rx_notify);
+                /* Add remote rx notify to poll set */
+                ret = na_sm_poll_register(na_sm_endpoint->poll_set,
+                    na_sm_addr->rx_notify, &na_sm_addr->rx_poll_type);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    addr, done, ret, "Could not add rx notify to poll set");
+            }
+
+            /* Peer may be waiting on msgs sent before its events were known */
+            if (na_sm_addr->tx_notify > 0 &&
+                !na_sm_msg_queue_is_empty(na_sm_addr->tx_queue)) {
+                ret = na_sm_event_set(na_sm_addr->tx_notify);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    addr, done, ret, "Could not signal tx notify");
+            }
+            break;
+        }
+        case NA_SM_RECLAIM:
+            na_sm_queue_pair_reclaim(na_sm_endpoint);
+            break;
         default:
             NA_GOTO_SUBSYS_ERROR(
                 poll, done, ret, NA_INVALID_ARG, "Unknown type of operation");
@@ -3931,10 +6174,11 @@ na_sm_progress_rx_queue(struct na_sm_endpoint *na_sm_endpoint,
     struct na_sm_addr *poll_addr, bool *progressed)
 {
     union na_sm_msg_hdr msg_hdr = {.val = 0};
+    char inline_buf[NA_SM_INLINE_MAX];
     na_return_t ret = NA_SUCCESS;
 
     /* Look for message in rx queue */
-    if (!na_sm_msg_queue_pop(poll_addr->rx_queue, &msg_hdr)) {
+    if (!na_sm_msg_queue_pop(poll_addr->rx_queue, &msg_hdr, inline_buf)) {
         *progressed = false;
         goto done;
     }
@@ -3943,15 +6187,24 @@ na_sm_progress_rx_queue(struct na_sm_endpoint *na_sm_endpoint,
 
     /* Process expected and unexpected messages */
     switch (msg_hdr.hdr.type) {
-        case NA_CB_SEND_UNEXPECTED:
+        case NA_SM_MSG_UNEXPECTED:
             ret = na_sm_process_unexpected(&na_sm_endpoint->unexpected_op_queue,
-                poll_addr, msg_hdr, &na_sm_endpoint->unexpected_msg_queue);
+                poll_addr, msg_hdr, inline_buf,
+                &na_sm_endpoint->unexpected_msg_queue);
             NA_CHECK_SUBSYS_NA_ERROR(
                 msg, done, ret, "Could not make progress on unexpected msg");
             break;
-        case NA_CB_SEND_EXPECTED:
-            na_sm_process_expected(
-                &na_sm_endpoint->expected_op_queue, poll_addr, msg_hdr);
+        case NA_SM_MSG_EXPECTED:
+            na_sm_process_expected(&na_sm_endpoint->expected_op_queue,
+                poll_addr, msg_hdr, inline_buf);
+            break;
+        case NA_SM_RMA_PUT:
+        case NA_SM_RMA_GET:
+        case NA_SM_RMA_ACK:
+            ret = na_sm_process_rma(
+                na_sm_endpoint, poll_addr, msg_hdr, inline_buf);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                rma, done, ret, "Could not make progress on RMA chunk");
             break;
         default:
             NA_GOTO_SUBSYS_ERROR(
@@ -3968,24 +6221,67 @@ done:
 static na_return_t
 na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
     struct na_sm_addr *poll_addr, union na_sm_msg_hdr msg_hdr,
+    const void *inline_buf,
     struct na_sm_unexpected_msg_queue *unexpected_msg_queue)
 {
     struct na_sm_unexpected_info *na_sm_unexpected_info = NULL;
     struct na_sm_op_id *na_sm_op_id = NULL;
-    na_return_t ret = NA_SUCCESS;
+    struct na_cb_completion_data *completion_data = NULL;
+    na_return_t ret = NA_SUCCESS, cb_ret = NA_SUCCESS;
+    bool dropped = false;
 
     NA_LOG_SUBSYS_DEBUG(msg, "Processing unexpected msg");
 
-    /* Pop op ID from queue */
+    /* Pop op ID from queue, multi-recv operations remain queued until their
+     * buffer is consumed */
     hg_thread_spin_lock(&unexpected_op_queue->lock);
     na_sm_op_id = HG_QUEUE_FIRST(&unexpected_op_queue->queue);
     if (likely(na_sm_op_id)) {
-        HG_QUEUE_POP_HEAD(&unexpected_op_queue->queue, entry);
-        hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_QUEUED);
+        if (na_sm_op_id->completion_data.callback_info.type ==
+            NA_CB_MULTI_RECV_UNEXPECTED) {
+            size_t msg_size_max =
+                NA_SM_CLASS(na_sm_op_id->na_class)->msg_size_max;
+
+            /* Peer buffers may be larger than locally posted ones */
+            if (unlikely(msg_hdr.hdr.buf_size > msg_size_max))
+                dropped = true;
+            else
+                completion_data = na_sm_multi_recv_reserve(na_sm_op_id,
+                    poll_addr, (na_tag_t) msg_hdr.hdr.tag,
+                    (size_t) msg_hdr.hdr.buf_size, msg_size_max, NA_SUCCESS);
+        }
+        if (!dropped &&
+            (completion_data == NULL ||
+                completion_data->callback_info.info.multi_recv_unexpected
+                    .last)) {
+            HG_QUEUE_POP_HEAD(&unexpected_op_queue->queue, entry);
+            hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_QUEUED);
+        }
     }
     hg_thread_spin_unlock(&unexpected_op_queue->lock);
 
-    if (likely(na_sm_op_id)) {
+    if (unlikely(dropped)) {
+        NA_LOG_SUBSYS_ERROR(msg,
+            "Dropping unexpected msg of %zu bytes that exceeds multi-recv "
+            "max size",
+            (size_t) msg_hdr.hdr.buf_size);
+        na_sm_msg_buf_release(poll_addr->shared_region, msg_hdr);
+    } else if (completion_data != NULL) {
+        const struct na_cb_info_multi_recv_unexpected *info =
+            &completion_data->callback_info.info.multi_recv_unexpected;
+
+        na_sm_addr_ref_incr(poll_addr);
+        if (msg_hdr.hdr.buf_size > 0) {
+            na_sm_msg_buf_copy_from(poll_addr->shared_region, msg_hdr,
+                inline_buf, info->actual_buf);
+            na_sm_msg_buf_release(poll_addr->shared_region, msg_hdr);
+        }
+        if (info->last)
+            hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
+
+        /* Add to NA completion queue (no need to notify) */
+        na_cb_completion_add(na_sm_op_id->context, completion_data);
+    } else if (likely(na_sm_op_id)) {
         /* Fill info */
         na_sm_op_id->completion_data.callback_info.info.recv_unexpected =
             (struct na_cb_info_recv_unexpected){
@@ -3995,18 +6291,20 @@ na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
         na_sm_addr_ref_incr(poll_addr);
 
         if (msg_hdr.hdr.buf_size > 0) {
-            /* Copy buffer */
-            na_sm_buf_copy_from(&poll_addr->shared_region->copy_bufs,
-                msg_hdr.hdr.buf_idx, na_sm_op_id->info.msg.buf.ptr,
-                msg_hdr.hdr.buf_size);
+            /* Peer buffers may be larger than locally posted ones */
+            if (unlikely(msg_hdr.hdr.buf_size > na_sm_op_id->info.msg.buf_size))
+                cb_ret = NA_OVERFLOW;
+            else
+                /* Copy buffer */
+                na_sm_msg_buf_copy_from(poll_addr->shared_region, msg_hdr,
+                    inline_buf, na_sm_op_id->info.msg.buf.ptr);
 
             /* Release buffer */
-            na_sm_buf_release(
-                &poll_addr->shared_region->copy_bufs, msg_hdr.hdr.buf_idx);
+            na_sm_msg_buf_release(poll_addr->shared_region, msg_hdr);
         }
 
         /* Complete operation (no need to notify) */
-        na_sm_complete(na_sm_op_id, NA_SUCCESS);
+        na_sm_complete(na_sm_op_id, cb_ret);
     } else {
         NA_LOG_SUBSYS_WARNING(
             perf, "No operation was preposted, data must be copied");
@@ -4031,13 +6329,11 @@ na_sm_process_unexpected(struct na_sm_op_queue *unexpected_op_queue,
                 "Could not allocate na_sm_unexpected_info buf");
 
             /* Copy buffer */
-            na_sm_buf_copy_from(&poll_addr->shared_region->copy_bufs,
-                msg_hdr.hdr.buf_idx, na_sm_unexpected_info->buf,
-                msg_hdr.hdr.buf_size);
+            na_sm_msg_buf_copy_from(poll_addr->shared_region, msg_hdr,
+                inline_buf, na_sm_unexpected_info->buf);
 
             /* Release buffer */
-            na_sm_buf_release(
-                &poll_addr->shared_region->copy_bufs, msg_hdr.hdr.buf_idx);
+            na_sm_msg_buf_release(poll_addr->shared_region, msg_hdr);
         } else
             na_sm_unexpected_info->buf = NULL;
 
@@ -4060,9 +6356,11 @@ error:
 /*---------------------------------------------------------------------------*/
 static void
 na_sm_process_expected(struct na_sm_op_queue *expected_op_queue,
-    struct na_sm_addr *poll_addr, union na_sm_msg_hdr msg_hdr)
+    struct na_sm_addr *poll_addr, union na_sm_msg_hdr msg_hdr,
+    const void *inline_buf)
 {
     struct na_sm_op_id *na_sm_op_id = NULL;
+    na_return_t cb_ret = NA_SUCCESS;
 
     NA_LOG_SUBSYS_DEBUG(msg, "Processing expected msg");
 
@@ -4083,11 +6381,8 @@ na_sm_process_expected(struct na_sm_op_queue *expected_op_queue,
     if (na_sm_op_id == NULL) {
         NA_LOG_SUBSYS_WARNING(
             op, "No OP ID posted for that operation, dropping msg");
-        if (msg_hdr.hdr.buf_size > 0) {
-            /* Release buffer */
-            na_sm_buf_release(
-                &poll_addr->shared_region->copy_bufs, msg_hdr.hdr.buf_idx);
-        }
+        /* Release buffer */
+        na_sm_msg_buf_release(poll_addr->shared_region, msg_hdr);
         return;
     }
 
@@ -4095,29 +6390,35 @@ na_sm_process_expected(struct na_sm_op_queue *expected_op_queue,
         .actual_buf_size = msg_hdr.hdr.buf_size;
 
     if (msg_hdr.hdr.buf_size > 0) {
-        /* Copy buffer */
-        na_sm_buf_copy_from(&poll_addr->shared_region->copy_bufs,
-            msg_hdr.hdr.buf_idx, na_sm_op_id->info.msg.buf.ptr,
-            msg_hdr.hdr.buf_size);
+        /* Peer buffers may be larger than locally posted ones */
+        if (unlikely(msg_hdr.hdr.buf_size > na_sm_op_id->info.msg.buf_size))
+            cb_ret = NA_OVERFLOW;
+        else
+            /* Copy buffer */
+            na_sm_msg_buf_copy_from(poll_addr->shared_region, msg_hdr,
+                inline_buf, na_sm_op_id->info.msg.buf.ptr);
 
         /* Release buffer */
-        na_sm_buf_release(
-            &poll_addr->shared_region->copy_bufs, msg_hdr.hdr.buf_idx);
+        na_sm_msg_buf_release(poll_addr->shared_region, msg_hdr);
     }
 
     /* Complete operation */
-    na_sm_complete(na_sm_op_id, NA_SUCCESS);
+    na_sm_complete(na_sm_op_id, cb_ret);
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_sm_process_retries(struct na_sm_endpoint *na_sm_endpoint)
+na_sm_process_retries(struct na_sm_class *na_sm_class)
 {
+    struct na_sm_endpoint *na_sm_endpoint = &na_sm_class->endpoint;
     struct na_sm_op_queue *op_queue = &na_sm_endpoint->retry_op_queue;
+    struct hg_backoff *backoff = &na_sm_endpoint->retry_backoff;
     struct na_sm_op_id *na_sm_op_id = NULL;
     na_return_t ret = NA_SUCCESS;
 
     do {
+        hg_time_t now;
+
         hg_thread_spin_lock(&op_queue->lock);
         na_sm_op_id = HG_QUEUE_FIRST(&op_queue->queue);
         if (!na_sm_op_id) {
@@ -4125,6 +6426,17 @@ na_sm_process_retries(struct na_sm_endpoint *na_sm_endpoint)
             /* Queue is empty */
             break;
         }
+        /* Another context is already retrying this op */
+        if (hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_RETRYING) {
+            hg_thread_spin_unlock(&op_queue->lock);
+            break;
+        }
+        /* Leave time for peers to drain their queue after a busy retry */
+        hg_time_get_current(&now);
+        if (!hg_backoff_ready(backoff, now)) {
+            hg_thread_spin_unlock(&op_queue->lock);
+            break;
+        }
         /* We won't try to cancel an op that's being retried */
         hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_RETRYING);
         hg_thread_spin_unlock(&op_queue->lock);
@@ -4140,6 +6452,7 @@ na_sm_process_retries(struct na_sm_endpoint *na_sm_endpoint)
             /* Succeeded, cannot cancel anymore */
             hg_thread_spin_lock(&op_queue->lock);
             hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_RETRYING);
+            hg_backoff_reset(backoff);
 
             HG_QUEUE_REMOVE(&op_queue->queue, na_sm_op_id, na_sm_op_id, entry);
             hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_QUEUED);
@@ -4150,9 +6463,12 @@ na_sm_process_retries(struct na_sm_endpoint *na_sm_endpoint)
         } else if (ret == NA_AGAIN) {
             bool canceled = false;
 
+            hg_atomic_incr64(na_sm_class->retry_again);
+
             /* Check if it was canceled in the meantime */
             hg_thread_spin_lock(&op_queue->lock);
             hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_RETRYING);
+            hg_backoff_fail(backoff, now);
 
             if (hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_CANCELED) {
                 HG_QUEUE_REMOVE(
@@ -4184,6 +6500,139 @@ na_sm_process_retries(struct na_sm_endpoint *na_sm_endpoint)
     return NA_SUCCESS;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_process_rma(struct na_sm_endpoint *na_sm_endpoint,
+    struct na_sm_addr *poll_addr, union na_sm_msg_hdr msg_hdr,
+    const void *inline_buf)
+{
+    struct na_sm_region *na_sm_region = poll_addr->shared_region;
+    struct na_sm_op_queue *rma_op_queue = &na_sm_endpoint->rma_op_queue;
+    struct na_sm_rma_chunk chunk;
+    struct na_sm_op_id *na_sm_op_id;
+    struct na_sm_rma_info *rma;
+    char *buf;
+    bool complete;
+    na_return_t ret;
+
+    memcpy(&chunk, inline_buf, sizeof(chunk));
+    NA_CHECK_SUBSYS_ERROR(rma,
+        msg_hdr.hdr.buf_size != sizeof(chunk) ||
+            chunk.buf_idx >= na_sm_region->layout.buf_count ||
+            chunk.len > na_sm_region->layout.buf_size,
+        error, ret, NA_PROTOCOL_ERROR, "Invalid RMA chunk");
+    buf = (char *) na_sm_buf_ptr(na_sm_region, chunk.buf_idx);
+
+    if (msg_hdr.hdr.type != NA_SM_RMA_ACK) {
+        /* Target address was exposed by a local registration */
+        if (msg_hdr.hdr.type == NA_SM_RMA_PUT)
+            hg_mem_copy((void *) (uintptr_t) chunk.addr, buf, chunk.len);
+        else
+            hg_mem_copy(buf, (const void *) (uintptr_t) chunk.addr, chunk.len);
+
+        return na_sm_rma_ack_post(na_sm_endpoint, poll_addr, &chunk);
+    }
+
+    /* Origin owns copy buffers of its chunks */
+    na_sm_op_id = (struct na_sm_op_id *) (uintptr_t) chunk.op_id;
+    rma = &na_sm_op_id->info.rma;
+    if (na_sm_op_id->completion_data.callback_info.type == NA_CB_GET)
+        na_sm_rma_bounce_copy(
+            rma->local_handle, rma->local_offset + chunk.offset, buf,
+            chunk.len, false);
+    na_sm_buf_release(na_sm_region, chunk.buf_idx);
+
+    hg_thread_spin_lock(&rma_op_queue->lock);
+    rma->inflight--;
+    rma->completed += chunk.len;
+    if (rma->ret == NA_SUCCESS && rma->posted < rma->length) {
+        ret = na_sm_rma_bounce_post(na_sm_endpoint, na_sm_op_id);
+        if (ret == NA_AGAIN) {
+            hg_atomic_incr64(NA_SM_CLASS(na_sm_op_id->na_class)->retry_count);
+            HG_QUEUE_PUSH_TAIL(&rma_op_queue->queue, na_sm_op_id, entry);
+            hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_QUEUED);
+        } else if (ret != NA_SUCCESS)
+            rma->ret = ret;
+    }
+    complete = rma->inflight == 0 &&
+               !(hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_QUEUED);
+    hg_thread_spin_unlock(&rma_op_queue->lock);
+
+    /* Complete operation (no need to notify) */
+    if (complete)
+        na_sm_complete(na_sm_op_id, rma->ret);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_process_rma_ops(struct na_sm_endpoint *na_sm_endpoint)
+{
+    struct na_sm_op_queue *rma_op_queue = &na_sm_endpoint->rma_op_queue;
+
+    do {
+        struct na_sm_op_id *na_sm_op_id;
+        na_return_t ret;
+
+        hg_thread_spin_lock(&rma_op_queue->lock);
+        na_sm_op_id = HG_QUEUE_FIRST(&rma_op_queue->queue);
+        if (!na_sm_op_id) {
+            hg_thread_spin_unlock(&rma_op_queue->lock);
+            /* Queue is empty */
+            break;
+        }
+        ret = na_sm_rma_bounce_post(na_sm_endpoint, na_sm_op_id);
+        if (ret == NA_AGAIN) {
+            hg_thread_spin_unlock(&rma_op_queue->lock);
+            break; /* No need to try other op IDs */
+        }
+        HG_QUEUE_POP_HEAD(&rma_op_queue->queue, entry);
+        hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_QUEUED);
+        hg_thread_spin_unlock(&rma_op_queue->lock);
+
+        /* Nothing in flight, force internal completion in error mode */
+        if (ret != NA_SUCCESS) {
+            NA_LOG_SUBSYS_ERROR(rma, "Could not post RMA chunks");
+            hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_ERRORED);
+            na_sm_complete(na_sm_op_id, ret);
+        }
+    } while (1);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_sm_process_rma_acks(struct na_sm_endpoint *na_sm_endpoint)
+{
+    struct na_sm_rma_ack_queue *rma_ack_queue = &na_sm_endpoint->rma_ack_queue;
+
+    do {
+        struct na_sm_rma_ack *na_sm_rma_ack;
+        union na_sm_msg_hdr msg_hdr = {.hdr.type = NA_SM_RMA_ACK,
+            .hdr.buf_size = sizeof(na_sm_rma_ack->chunk) & 0xffff,
+            .hdr.inline_buf = 1};
+
+        hg_thread_spin_lock(&rma_ack_queue->lock);
+        na_sm_rma_ack = HG_QUEUE_FIRST(&rma_ack_queue->queue);
+        if (!na_sm_rma_ack ||
+            !na_sm_msg_queue_push(na_sm_rma_ack->na_sm_addr->tx_queue,
+                &msg_hdr, &na_sm_rma_ack->chunk)) {
+            hg_thread_spin_unlock(&rma_ack_queue->lock);
+            break;
+        }
+        HG_QUEUE_POP_HEAD(&rma_ack_queue->queue, entry);
+        hg_thread_spin_unlock(&rma_ack_queue->lock);
+
+        (void) na_sm_msg_send_notify(
+            na_sm_endpoint, na_sm_rma_ack->na_sm_addr);
+        na_sm_addr_ref_decr(na_sm_rma_ack->na_sm_addr);
+        free(na_sm_rma_ack);
+    } while (1);
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_sm_op_retry(struct na_sm_class *na_sm_class, struct na_sm_op_id *na_sm_op_id)
@@ -4194,6 +6643,9 @@ na_sm_op_retry(struct na_sm_class *na_sm_class, struct na_sm_op_id *na_sm_op_id)
     NA_LOG_SUBSYS_DEBUG(op, "Pushing %p for retry (%s)", (void *) na_sm_op_id,
         na_cb_type_to_string(na_sm_op_id->completion_data.callback_info.type));
 
+    /* Full msg queue or no copy buffer left on the remote side */
+    hg_atomic_incr64(na_sm_class->retry_count);
+
     /* Push op ID to retry queue */
     hg_thread_spin_lock(&retry_op_queue->lock);
     HG_QUEUE_PUSH_TAIL(&retry_op_queue->queue, na_sm_op_id, entry);
@@ -4243,6 +6695,63 @@ na_sm_release(void *arg)
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static struct na_cb_completion_data *
+na_sm_multi_recv_reserve(struct na_sm_op_id *na_sm_op_id,
+    struct na_sm_addr *source, na_tag_t tag, size_t buf_size,
+    size_t msg_size_max, na_return_t cb_ret)
+{
+    struct na_sm_completion_multi *multi = &na_sm_op_id->multi;
+    struct na_sm_msg_info *msg_info = &na_sm_op_id->info.msg;
+    struct na_cb_completion_data *completion_data;
+    int32_t head = hg_atomic_get32(&multi->head), next;
+    void *buf = (char *) msg_info->buf.ptr + msg_info->buf_offset;
+    bool last;
+
+    /* A multi-recv operation that is still queued always has a free entry,
+     * the buffer is returned as consumed when taking the last one */
+    completion_data = &multi->data[head];
+    next = (head + 1) & multi->mask;
+    hg_atomic_set32(&multi->head, next);
+    msg_info->buf_offset =
+        NA_SM_MULTI_RECV_ALIGN(msg_info->buf_offset + buf_size);
+    last = cb_ret == NA_CANCELED ||
+           ((next + 1) & multi->mask) == hg_atomic_get32(&multi->tail) ||
+           msg_info->buf_offset >= msg_info->buf_size ||
+           msg_info->buf_size - msg_info->buf_offset < msg_size_max;
+
+    *completion_data = (struct na_cb_completion_data){
+        .callback_info =
+            (struct na_cb_info){
+                .info.multi_recv_unexpected =
+                    (struct na_cb_info_multi_recv_unexpected){
+                        .actual_buf_size = buf_size,
+                        .source = (na_addr_t *) source,
+                        .tag = tag,
+                        .actual_buf = buf,
+                        .last = last},
+                .arg = na_sm_op_id->completion_data.callback_info.arg,
+                .type = NA_CB_MULTI_RECV_UNEXPECTED,
+                .ret = cb_ret},
+        .callback = na_sm_op_id->completion_data.callback,
+        .plugin_callback = na_sm_release_multi,
+        .plugin_callback_args = na_sm_op_id};
+
+    return completion_data;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_sm_release_multi(void *arg)
+{
+    struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) arg;
+    struct na_sm_completion_multi *multi = &na_sm_op_id->multi;
+
+    /* Completions are triggered in order */
+    hg_atomic_set32(
+        &multi->tail, (hg_atomic_get32(&multi->tail) + 1) & multi->mask);
+}
+
 /********************/
 /* Plugin callbacks */
 /********************/
@@ -4289,7 +6798,11 @@ na_sm_initialize(
 {
     struct na_init_info na_init_info = NA_INIT_INFO_INITIALIZER;
     struct na_sm_class *na_sm_class = NULL;
+    unsigned int pair_count = NA_SM_NUM_PAIRS;
+    unsigned int buf_count = NA_SM_NUM_BUFS;
+    size_t buf_size;
     struct rlimit rlimit;
+    const char *env;
     na_return_t ret;
     int rc;
 
@@ -4320,12 +6833,71 @@ na_sm_initialize(
 #endif
     na_sm_class->context_max = na_init_info.max_contexts;
 
+    /* Stage RMA through copy buffers (otherwise only once cross-memory
+     * attach is found not to be permitted) */
+    env = getenv("NA_SM_RMA_BOUNCE");
+    hg_atomic_init32(&na_sm_class->rma_bounce, (env && atoi(env) > 0) ? 1 : 0);
+
+    HG_LOG_ADD_COUNTER64(na, &na_sm_class->retry_count, "sm_retry_count",
+        "Ops retried (full msg queue or no copy buffer)");
+    HG_LOG_ADD_COUNTER64(na, &na_sm_class->retry_again,
+        "sm_retry_again_count", "Retries that returned NA_AGAIN");
+
+    /* Size copy buffers from msg size hints (rounded up to page size) */
+    buf_size = na_init_info.max_unexpected_size;
+    if (na_init_info.max_expected_size > buf_size)
+        buf_size = na_init_info.max_expected_size;
+    buf_size = (buf_size > 0) ? NA_SM_ALIGN(buf_size, NA_SM_PAGE_SIZE)
+                              : NA_SM_COPY_BUF_SIZE;
+    if (buf_size > NA_SM_COPY_BUF_SIZE_MAX) {
+        NA_LOG_SUBSYS_DEBUG(cls,
+            "Requested msg size (%zu) exceeds max copy buf size, using %d",
+            buf_size, NA_SM_COPY_BUF_SIZE_MAX);
+        buf_size = NA_SM_COPY_BUF_SIZE_MAX;
+    }
+    na_sm_class->msg_size_max = buf_size;
+
+    /* Number of copy buffers (rounded up to a power of 2) */
+    if ((env = getenv("NA_SM_NUM_BUFS")) != NULL) {
+        unsigned int num_bufs = (unsigned int) atoi(env);
+
+        NA_CHECK_SUBSYS_ERROR(cls, num_bufs > NA_SM_NUM_BUFS_MAX, error, ret,
+            NA_INVALID_ARG, "NA_SM_NUM_BUFS (%u) exceeds max (%d)", num_bufs,
+            NA_SM_NUM_BUFS_MAX);
+        while (buf_count < num_bufs)
+            buf_count <<= 1;
+    }
+    NA_LOG_SUBSYS_DEBUG(cls, "Using %u copy buffers of %zu bytes", buf_count,
+        buf_size);
+
+    /* Number of queue pairs, i.e., max number of local peers (rounded up to
+     * a power of 2) */
+    if ((env = getenv("NA_SM_NUM_PAIRS")) != NULL) {
+        unsigned int num_pairs = (unsigned int) atoi(env);
+
+        NA_CHECK_SUBSYS_ERROR(cls, num_pairs > NA_SM_NUM_PAIRS_MAX, error, ret,
+            NA_INVALID_ARG, "NA_SM_NUM_PAIRS (%u) exceeds max (%d)", num_pairs,
+            NA_SM_NUM_PAIRS_MAX);
+        while (pair_count < num_pairs)
+            pair_count <<= 1;
+    }
+    NA_LOG_SUBSYS_DEBUG(cls, "Using %u queue pairs", pair_count);
+
     /* Open endpoint */
     ret = na_sm_endpoint_open(&na_sm_class->endpoint, na_info->host_name,
         listen, na_init_info.progress_mode & NA_NO_BLOCK,
-        (uint32_t) rlimit.rlim_cur);
+        (uint32_t) rlimit.rlim_cur, pair_count, buf_count,
+        (unsigned int) buf_size, na_init_info.use_huge_pages);
     NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not open endpoint");
 
+#ifdef NA_SM_HAS_XPMEM
+    /* Single-copy RMA (falls back to CMA if XPMEM is not usable) */
+    na_sm_xpmem_init(na_sm_class);
+#endif
+#ifdef NA_SM_HAS_CUDA
+    na_sm_cuda_init(na_sm_class);
+#endif
+
     na_class->plugin_class = (void *) na_sm_class;
 
     return NA_SUCCESS;
@@ -4351,6 +6923,13 @@ na_sm_finalize(na_class_t *na_class)
     ret = na_sm_endpoint_close(&NA_SM_CLASS(na_class)->endpoint);
     NA_CHECK_SUBSYS_NA_ERROR(cls, done, ret, "Could not close endpoint");
 
+#ifdef NA_SM_HAS_XPMEM
+    na_sm_xpmem_finalize(NA_SM_CLASS(na_class));
+#endif
+#ifdef NA_SM_HAS_CUDA
+    na_sm_cuda_finalize(NA_SM_CLASS(na_class));
+#endif
+
     free(na_class->plugin_class);
     na_class->plugin_class = NULL;
 
@@ -4398,11 +6977,28 @@ na_sm_cleanup(void)
     rc = nftw(NA_SM_SHM_PATH, na_sm_shm_cleanup, NA_SM_CLEANUP_NFDS, FTW_PHYS);
     NA_CHECK_SUBSYS_WARNING(
         cls, rc != 0 && errno != ENOENT, "nftw() failed (%s)", strerror(errno));
+
+    rc = nftw(NA_SM_HUGETLBFS_PATH, na_sm_hugetlb_cleanup, NA_SM_CLEANUP_NFDS,
+        FTW_PHYS);
+    NA_CHECK_SUBSYS_WARNING(cls,
+        rc != 0 && errno != ENOENT && errno != EACCES, "nftw() failed (%s)",
+        strerror(errno));
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+na_sm_has_opt_feature(na_class_t NA_UNUSED *na_class, unsigned long flags)
+{
+#if defined(NA_SM_HAS_CMA) || defined(__APPLE__)
+    return !(flags & ~(unsigned long) (NA_OPT_MULTI_RECV | NA_OPT_ATOMIC));
+#else
+    return !(flags & ~(unsigned long) NA_OPT_MULTI_RECV);
+#endif
 }
 
 /*---------------------------------------------------------------------------*/
 static na_op_id_t *
-na_sm_op_create(na_class_t *na_class, unsigned long NA_UNUSED flags)
+na_sm_op_create(na_class_t *na_class, unsigned long flags)
 {
     struct na_sm_op_id *na_sm_op_id = NULL;
 
@@ -4413,6 +7009,21 @@ na_sm_op_create(na_class_t *na_class, unsigned long NA_UNUSED flags)
 
     na_sm_op_id->na_class = na_class;
 
+    /* Multi-recv operations complete once per message */
+    if (flags & NA_OP_MULTI) {
+        na_sm_op_id->multi.data = (struct na_cb_completion_data *) calloc(
+            NA_SM_OP_MULTI_CQ_SIZE, sizeof(struct na_cb_completion_data));
+        if (na_sm_op_id->multi.data == NULL) {
+            free(na_sm_op_id);
+            NA_GOTO_SUBSYS_ERROR_NORET(op, done,
+                "Could not allocate %d completion data entries",
+                NA_SM_OP_MULTI_CQ_SIZE);
+        }
+        na_sm_op_id->multi.mask = NA_SM_OP_MULTI_CQ_SIZE - 1;
+        hg_atomic_init32(&na_sm_op_id->multi.head, 0);
+        hg_atomic_init32(&na_sm_op_id->multi.tail, 0);
+    }
+
     /* Completed by default */
     hg_atomic_init32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
 
@@ -4435,9 +7046,27 @@ na_sm_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
         "Attempting to use OP ID that was not completed (%s)",
         na_cb_type_to_string(na_sm_op_id->completion_data.callback_info.type));
 
+    free(na_sm_op_id->multi.data);
     free(na_sm_op_id);
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_op_reset(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+{
+    struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
+
+    if (!(hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_COMPLETED))
+        return NA_BUSY;
+
+    /* Addr ref was dropped on release, only clear stale user data */
+    na_sm_op_id->context = NULL;
+    na_sm_op_id->completion_data.callback = NULL;
+    na_sm_op_id->completion_data.callback_info.arg = NULL;
+
+    return NA_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p)
@@ -4493,6 +7122,29 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_addr_warm(
+    na_class_t NA_UNUSED *na_class, na_addr_t *const *addrs, size_t count)
+{
+    size_t i;
+    na_return_t ret;
+
+    /* Map the peer's shared region and queue pair ahead of the first send */
+    for (i = 0; i < count; i++) {
+        ret = na_sm_msg_send_resolve((struct na_sm_addr *) addrs[i]);
+        if (ret == NA_AGAIN)
+            continue; /* Peer not ready yet, first send will resolve it */
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, error, ret, "Could not resolve address %zu", i);
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 na_sm_addr_free(na_class_t NA_UNUSED *na_class, na_addr_t *addr)
@@ -4609,6 +7261,7 @@ na_sm_addr_deserialize(
 {
     struct na_sm_endpoint *na_sm_endpoint = &NA_SM_CLASS(na_class)->endpoint;
     struct na_sm_addr *na_sm_addr = NULL;
+    char uri[NA_SM_MAX_FILENAME];
     struct na_sm_addr_key addr_key;
     const char *buf_ptr = (const char *) buf;
     size_t buf_size_left = buf_size;
@@ -4622,15 +7275,21 @@ na_sm_addr_deserialize(
     na_sm_addr = na_sm_addr_map_lookup(&na_sm_endpoint->addr_map, &addr_key);
     if (!na_sm_addr) {
         na_return_t na_ret;
+        int rc;
 
         NA_LOG_SUBSYS_DEBUG(addr,
             "Address for PID=%d, ID=%" PRIu8
             " was not found, attempting to insert it",
             addr_key.pid, addr_key.id);
 
+        /* Re-generate URI */
+        rc = NA_SM_PRINT_URI(uri, NA_SM_MAX_FILENAME, addr_key);
+        NA_CHECK_SUBSYS_ERROR(addr, rc < 0 || rc > NA_SM_MAX_FILENAME, done,
+            ret, NA_OVERFLOW, "NA_SM_PRINT_URI() failed, rc: %d", rc);
+
         /* Insert new entry and create new address if needed */
         na_ret = na_sm_addr_map_insert(na_sm_endpoint,
-            &na_sm_endpoint->addr_map, NULL, &addr_key, &na_sm_addr);
+            &na_sm_endpoint->addr_map, uri, &addr_key, &na_sm_addr);
         NA_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS && na_ret != NA_EXIST,
             done, ret, na_ret, "Could not insert new address");
     } else {
@@ -4649,16 +7308,16 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE size_t
-na_sm_msg_get_max_unexpected_size(const na_class_t NA_UNUSED *na_class)
+na_sm_msg_get_max_unexpected_size(const na_class_t *na_class)
 {
-    return NA_SM_UNEXPECTED_SIZE;
+    return NA_SM_CLASS(na_class)->msg_size_max;
 }
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE size_t
-na_sm_msg_get_max_expected_size(const na_class_t NA_UNUSED *na_class)
+na_sm_msg_get_max_expected_size(const na_class_t *na_class)
 {
-    return NA_SM_EXPECTED_SIZE;
+    return NA_SM_CLASS(na_class)->msg_size_max;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -4690,10 +7349,10 @@ na_sm_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
         &NA_SM_CLASS(na_class)->endpoint.unexpected_msg_queue;
     struct na_sm_unexpected_info *na_sm_unexpected_info;
     struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
-    na_return_t ret;
+    na_return_t ret, cb_ret = NA_SUCCESS;
 
-    NA_CHECK_SUBSYS_ERROR(msg, buf_size > NA_SM_UNEXPECTED_SIZE, error, ret,
-        NA_OVERFLOW, "Exceeds unexpected size, %zu", buf_size);
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > NA_SM_CLASS(na_class)->msg_size_max,
+        error, ret, NA_OVERFLOW, "Exceeds unexpected size, %zu", buf_size);
 
     /* Check op_id */
     NA_CHECK_SUBSYS_ERROR(op, na_sm_op_id == NULL, error, ret, NA_INVALID_ARG,
@@ -4724,13 +7383,18 @@ na_sm_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
         na_sm_addr_ref_incr(na_sm_unexpected_info->na_sm_addr);
 
         if (na_sm_unexpected_info->buf_size > 0) {
-            /* Copy buffers */
-            memcpy(na_sm_op_id->info.msg.buf.ptr, na_sm_unexpected_info->buf,
-                na_sm_unexpected_info->buf_size);
+            /* Peer buffers may be larger than locally posted ones */
+            if (unlikely(na_sm_unexpected_info->buf_size > buf_size))
+                cb_ret = NA_OVERFLOW;
+            else
+                /* Copy buffers */
+                memcpy(na_sm_op_id->info.msg.buf.ptr,
+                    na_sm_unexpected_info->buf,
+                    na_sm_unexpected_info->buf_size);
             free(na_sm_unexpected_info->buf);
         }
         free(na_sm_unexpected_info);
-        na_sm_complete(na_sm_op_id, NA_SUCCESS);
+        na_sm_complete(na_sm_op_id, cb_ret);
 
         /* Notify local completion */
         na_sm_complete_signal(NA_SM_CLASS(na_class));
@@ -4756,6 +7420,104 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_multi_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, size_t buf_size,
+    void NA_UNUSED *plugin_data, na_op_id_t *op_id)
+{
+    struct na_sm_class *na_sm_class = NA_SM_CLASS(na_class);
+    struct na_sm_unexpected_msg_queue *unexpected_msg_queue =
+        &na_sm_class->endpoint.unexpected_msg_queue;
+    struct na_sm_op_queue *unexpected_op_queue =
+        &na_sm_class->endpoint.unexpected_op_queue;
+    struct na_sm_op_id *na_sm_op_id = (struct na_sm_op_id *) op_id;
+    bool last = false, completed = false;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size < na_sm_class->msg_size_max, error,
+        ret, NA_INVALID_ARG,
+        "Multi-recv buffer must hold at least one message of max size (%zu)",
+        na_sm_class->msg_size_max);
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_sm_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op, na_sm_op_id->multi.data == NULL, error, ret,
+        NA_INVALID_ARG, "Operation ID was not created with NA_OP_MULTI");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_sm_op_id->status) & NA_SM_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_sm_op_id->completion_data.callback_info.type));
+
+    NA_SM_OP_RESET_UNEXPECTED_RECV(na_sm_op_id, context, callback, arg);
+    na_sm_op_id->completion_data.callback_info.type =
+        NA_CB_MULTI_RECV_UNEXPECTED;
+
+    /* We assume buf remains valid (safe because we pre-allocate buffers) */
+    na_sm_op_id->info.msg = (struct na_sm_msg_info){
+        .buf.ptr = buf, .buf_size = buf_size, .buf_offset = 0, .tag = 0};
+
+    /* Pack unexpected messages already received, then queue the operation
+     * unless its buffer was consumed */
+    hg_thread_spin_lock(&unexpected_op_queue->lock);
+    while (!last) {
+        struct na_sm_unexpected_info *na_sm_unexpected_info;
+        struct na_cb_completion_data *completion_data;
+
+        hg_thread_spin_lock(&unexpected_msg_queue->lock);
+        na_sm_unexpected_info = HG_QUEUE_FIRST(&unexpected_msg_queue->queue);
+        HG_QUEUE_POP_HEAD(&unexpected_msg_queue->queue, entry);
+        hg_thread_spin_unlock(&unexpected_msg_queue->lock);
+        if (na_sm_unexpected_info == NULL)
+            break;
+
+        /* Peer buffers may be larger than locally posted ones */
+        if (unlikely(na_sm_unexpected_info->buf_size >
+                     na_sm_class->msg_size_max)) {
+            NA_LOG_SUBSYS_ERROR(msg,
+                "Dropping unexpected msg of %zu bytes that exceeds multi-recv "
+                "max size",
+                na_sm_unexpected_info->buf_size);
+            free(na_sm_unexpected_info->buf);
+            free(na_sm_unexpected_info);
+            continue;
+        }
+
+        completion_data = na_sm_multi_recv_reserve(na_sm_op_id,
+            na_sm_unexpected_info->na_sm_addr, na_sm_unexpected_info->tag,
+            na_sm_unexpected_info->buf_size, na_sm_class->msg_size_max,
+            NA_SUCCESS);
+        last = completion_data->callback_info.info.multi_recv_unexpected.last;
+        na_sm_addr_ref_incr(na_sm_unexpected_info->na_sm_addr);
+        if (na_sm_unexpected_info->buf_size > 0)
+            memcpy(
+                completion_data->callback_info.info.multi_recv_unexpected
+                    .actual_buf,
+                na_sm_unexpected_info->buf, na_sm_unexpected_info->buf_size);
+        free(na_sm_unexpected_info->buf);
+        free(na_sm_unexpected_info);
+        if (last)
+            hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
+        na_cb_completion_add(context, completion_data);
+        completed = true;
+    }
+    if (!last) {
+        HG_QUEUE_PUSH_TAIL(&unexpected_op_queue->queue, na_sm_op_id, entry);
+        hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_QUEUED);
+    }
+    hg_thread_spin_unlock(&unexpected_op_queue->lock);
+
+    /* Notify local completion */
+    if (completed)
+        na_sm_complete_signal(na_sm_class);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_msg_send_expected(na_class_t *na_class, na_context_t *context,
@@ -4781,8 +7543,8 @@ na_sm_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     struct na_sm_addr *na_sm_addr = (struct na_sm_addr *) source_addr;
     na_return_t ret;
 
-    NA_CHECK_SUBSYS_ERROR(msg, buf_size > NA_SM_EXPECTED_SIZE, error, ret,
-        NA_OVERFLOW, "Exceeds expected size, %zu", buf_size);
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > NA_SM_CLASS(na_class)->msg_size_max,
+        error, ret, NA_OVERFLOW, "Exceeds expected size, %zu", buf_size);
 
     /* Check op_id */
     NA_CHECK_SUBSYS_ERROR(op, na_sm_op_id == NULL, error, ret, NA_INVALID_ARG,
@@ -4814,6 +7576,44 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_msg_send_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+    size_t count, size_t *posted_count_p)
+{
+    struct na_sm_class *na_sm_class = NA_SM_CLASS(na_class);
+    size_t posted_count = 0;
+    bool completed = false;
+    na_return_t ret = NA_SUCCESS;
+
+    /* Group consecutive msgs to the same destination */
+    while (posted_count < count) {
+        size_t batch_count = 1, batch_posted_count = 0;
+
+        while (posted_count + batch_count < count &&
+               batch_count < NA_SM_SEND_BATCH_MAX &&
+               send_infos[posted_count + batch_count].dest_addr ==
+                   send_infos[posted_count].dest_addr)
+            batch_count++;
+
+        ret = na_sm_msg_send_batch_post(na_sm_class, context, cb_type,
+            &send_infos[posted_count], batch_count, &batch_posted_count,
+            &completed);
+        posted_count += batch_posted_count;
+        NA_CHECK_SUBSYS_NA_ERROR(msg, done, ret, "Could not post msg batch");
+    }
+
+done:
+    /* Notify local completion once */
+    if (completed)
+        na_sm_complete_signal(na_sm_class);
+
+    *posted_count_p = posted_count;
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_sm_mem_handle_create(na_class_t NA_UNUSED *na_class, void *buf,
@@ -4833,6 +7633,9 @@ na_sm_mem_handle_create(na_class_t NA_UNUSED *na_class, void *buf,
     na_sm_mem_handle->info.iovcnt = 1;
     na_sm_mem_handle->info.flags = flags & 0xff;
     na_sm_mem_handle->info.len = buf_size;
+#ifdef NA_SM_HAS_XPMEM
+    na_sm_mem_handle->info.segid = NA_SM_CLASS(na_class)->xpmem_segid;
+#endif
 
     *mem_handle_p = (na_mem_handle_t *) na_sm_mem_handle;
 
@@ -4884,6 +7687,9 @@ na_sm_mem_handle_create_segments(na_class_t *na_class,
     }
     na_sm_mem_handle->info.iovcnt = segment_count;
     na_sm_mem_handle->info.flags = flags & 0xff;
+#ifdef NA_SM_HAS_XPMEM
+    na_sm_mem_handle->info.segid = NA_SM_CLASS(na_class)->xpmem_segid;
+#endif
 
     *mem_handle_p = (na_mem_handle_t *) na_sm_mem_handle;
 
@@ -4919,6 +7725,63 @@ na_sm_mem_handle_get_max_segments(const na_class_t *na_class)
     return NA_SM_CLASS(na_class)->iov_max;
 }
 
+/*---------------------------------------------------------------------------*/
+#ifdef NA_SM_HAS_CUDA
+static na_return_t
+na_sm_mem_register(na_class_t NA_UNUSED *na_class, na_mem_handle_t *mem_handle,
+    enum na_mem_type mem_type, uint64_t NA_UNUSED device)
+{
+    struct na_sm_mem_handle *na_sm_mem_handle =
+        (struct na_sm_mem_handle *) mem_handle;
+    CUdeviceptr base = 0;
+    size_t size = 0;
+    cudaError_t cuda_rc;
+    CUresult cu_rc;
+    na_return_t ret;
+
+    switch (mem_type) {
+        case NA_MEM_TYPE_CUDA:
+            break;
+        case NA_MEM_TYPE_ROCM:
+        case NA_MEM_TYPE_ZE:
+            NA_GOTO_SUBSYS_ERROR(mem, error, ret, NA_OPNOTSUPPORTED,
+                "Unsupported memory type (%d)", mem_type);
+        case NA_MEM_TYPE_HOST:
+        case NA_MEM_TYPE_UNKNOWN:
+        default:
+            return NA_SUCCESS;
+    }
+
+    /* Device memory is exported as a single allocation */
+    NA_CHECK_SUBSYS_ERROR(mem, na_sm_mem_handle->info.iovcnt != 1, error, ret,
+        NA_OPNOTSUPPORTED,
+        "Device memory handles must have a single segment (%zu)",
+        (size_t) na_sm_mem_handle->info.iovcnt);
+
+    /* IPC handles refer to the base of the allocation */
+    cu_rc = cuMemGetAddressRange(&base, &size,
+        (CUdeviceptr) NA_SM_IOV(na_sm_mem_handle)[0].iov_base);
+    NA_CHECK_SUBSYS_ERROR(mem, cu_rc != CUDA_SUCCESS, error, ret,
+        NA_INVALID_ARG, "cuMemGetAddressRange() failed (%d)", (int) cu_rc);
+
+    cuda_rc = cudaIpcGetMemHandle(&na_sm_mem_handle->info.cuda_ipc,
+        (void *) (uintptr_t) base);
+    NA_CHECK_SUBSYS_ERROR(mem, cuda_rc != cudaSuccess, error, ret,
+        NA_PROTOCOL_ERROR, "cudaIpcGetMemHandle() failed (%s)",
+        cudaGetErrorString(cuda_rc));
+
+    na_sm_mem_handle->info.cuda_offset =
+        (uint64_t) ((uintptr_t) NA_SM_IOV(na_sm_mem_handle)[0].iov_base -
+                    (uintptr_t) base);
+    na_sm_mem_handle->info.mem_type = (uint8_t) mem_type;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE size_t
 na_sm_mem_handle_get_serialize_size(
@@ -4926,9 +7789,24 @@ na_sm_mem_handle_get_serialize_size(
 {
     struct na_sm_mem_handle *na_sm_mem_handle =
         (struct na_sm_mem_handle *) mem_handle;
+    const struct na_sm_mem_desc_info *info = &na_sm_mem_handle->info;
+    size_t ret = na_varint_get_serialize_size((uint64_t) info->iovcnt) +
+                 sizeof(info->flags);
+
+#ifdef NA_SM_HAS_XPMEM
+    /* Zigzag so that -1 (no segment) takes a single byte */
+    ret += na_varint_get_serialize_size(
+        ((uint64_t) info->segid << 1) ^ (uint64_t) (info->segid >> 63));
+#endif
+#ifdef NA_SM_HAS_CUDA
+    ret += sizeof(info->mem_type);
+    if (info->mem_type != NA_MEM_TYPE_HOST)
+        ret += sizeof(info->cuda_ipc) +
+               na_varint_get_serialize_size(info->cuda_offset);
+#endif
 
-    return sizeof(na_sm_mem_handle->info) +
-           na_sm_mem_handle->info.iovcnt * sizeof(struct iovec);
+    return ret +
+           na_iov_get_serialize_size(NA_SM_IOV(na_sm_mem_handle), info->iovcnt);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -4938,18 +7816,38 @@ na_sm_mem_handle_serialize(na_class_t NA_UNUSED *na_class, void *buf,
 {
     struct na_sm_mem_handle *na_sm_mem_handle =
         (struct na_sm_mem_handle *) mem_handle;
+    const struct na_sm_mem_desc_info *info = &na_sm_mem_handle->info;
     struct iovec *iov = NA_SM_IOV(na_sm_mem_handle);
     char *buf_ptr = (char *) buf;
     size_t buf_size_left = buf_size;
     na_return_t ret = NA_SUCCESS;
 
-    /* Descriptor info */
-    NA_ENCODE(done, ret, buf_ptr, buf_size_left, &na_sm_mem_handle->info,
-        struct na_sm_mem_desc_info);
+    /* Descriptor info (total length is recomputed from segments) */
+    ret = na_varint_serialize(
+        &buf_ptr, &buf_size_left, (uint64_t) info->iovcnt);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, done, ret, "Could not encode iovcnt");
 
-    /* IOV */
-    NA_ENCODE_ARRAY(done, ret, buf_ptr, buf_size_left, iov, struct iovec,
-        na_sm_mem_handle->info.iovcnt);
+    NA_ENCODE(done, ret, buf_ptr, buf_size_left, &info->flags, uint8_t);
+
+#ifdef NA_SM_HAS_XPMEM
+    ret = na_varint_serialize(&buf_ptr, &buf_size_left,
+        ((uint64_t) info->segid << 1) ^ (uint64_t) (info->segid >> 63));
+    NA_CHECK_SUBSYS_NA_ERROR(mem, done, ret, "Could not encode segid");
+#endif
+#ifdef NA_SM_HAS_CUDA
+    NA_ENCODE(done, ret, buf_ptr, buf_size_left, &info->mem_type, uint8_t);
+    if (info->mem_type != NA_MEM_TYPE_HOST) {
+        NA_ENCODE(done, ret, buf_ptr, buf_size_left, &info->cuda_ipc,
+            cudaIpcMemHandle_t);
+        ret = na_varint_serialize(
+            &buf_ptr, &buf_size_left, info->cuda_offset);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, done, ret, "Could not encode offset");
+    }
+#endif
+
+    /* IOV (delta-encoded bases, varint lengths) */
+    ret = na_iov_serialize(&buf_ptr, &buf_size_left, iov, info->iovcnt);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, done, ret, "Could not encode segments");
 
 done:
     return ret;
@@ -4964,33 +7862,64 @@ na_sm_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
     const char *buf_ptr = (const char *) buf;
     size_t buf_size_left = buf_size;
     struct iovec *iov = NULL;
+    uint64_t value;
     na_return_t ret = NA_SUCCESS;
 
     na_sm_mem_handle =
         (struct na_sm_mem_handle *) malloc(sizeof(struct na_sm_mem_handle));
     NA_CHECK_SUBSYS_ERROR(mem, na_sm_mem_handle == NULL, error, ret, NA_NOMEM,
         "Could not allocate NA SM memory handle");
+    memset(&na_sm_mem_handle->info, 0, sizeof(na_sm_mem_handle->info));
     na_sm_mem_handle->iov.d = NULL;
-    na_sm_mem_handle->info.iovcnt = 0;
 
     /* Descriptor info */
-    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_sm_mem_handle->info,
-        struct na_sm_mem_desc_info);
+    ret = na_varint_deserialize(&buf_ptr, &buf_size_left, &value);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode iovcnt");
+
+    NA_DECODE(error, ret, buf_ptr, buf_size_left,
+        &na_sm_mem_handle->info.flags, uint8_t);
+
+#ifdef NA_SM_HAS_XPMEM
+    {
+        uint64_t segid;
+
+        ret = na_varint_deserialize(&buf_ptr, &buf_size_left, &segid);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode segid");
+        na_sm_mem_handle->info.segid =
+            (int64_t) ((segid >> 1) ^ ((uint64_t) 0 - (segid & 1)));
+    }
+#endif
+#ifdef NA_SM_HAS_CUDA
+    NA_DECODE(error, ret, buf_ptr, buf_size_left,
+        &na_sm_mem_handle->info.mem_type, uint8_t);
+    if (na_sm_mem_handle->info.mem_type != NA_MEM_TYPE_HOST) {
+        NA_DECODE(error, ret, buf_ptr, buf_size_left,
+            &na_sm_mem_handle->info.cuda_ipc, cudaIpcMemHandle_t);
+        ret = na_varint_deserialize(
+            &buf_ptr, &buf_size_left, &na_sm_mem_handle->info.cuda_offset);
+        NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode offset");
+    }
+#endif
 
     /* IOV */
-    if (na_sm_mem_handle->info.iovcnt > NA_SM_IOV_STATIC_MAX) {
+    if (value > NA_SM_IOV_STATIC_MAX) {
+        NA_CHECK_SUBSYS_ERROR(mem, value > buf_size_left / 2, error, ret,
+            NA_OVERFLOW, "Invalid segment count (%lu)", (unsigned long) value);
+
         /* Allocate IOV */
-        na_sm_mem_handle->iov.d = (struct iovec *) malloc(
-            na_sm_mem_handle->info.iovcnt * sizeof(struct iovec));
+        na_sm_mem_handle->iov.d =
+            (struct iovec *) malloc((size_t) value * sizeof(struct iovec));
         NA_CHECK_SUBSYS_ERROR(mem, na_sm_mem_handle->iov.d == NULL, error, ret,
             NA_NOMEM, "Could not allocate segment array");
 
         iov = na_sm_mem_handle->iov.d;
     } else
         iov = na_sm_mem_handle->iov.s;
+    na_sm_mem_handle->info.iovcnt = (unsigned long) value;
 
-    NA_DECODE_ARRAY(error, ret, buf_ptr, buf_size_left, iov, struct iovec,
-        na_sm_mem_handle->info.iovcnt);
+    ret = na_iov_deserialize(&buf_ptr, &buf_size_left, iov,
+        na_sm_mem_handle->info.iovcnt, &na_sm_mem_handle->info.len);
+    NA_CHECK_SUBSYS_NA_ERROR(mem, error, ret, "Could not decode segments");
 
     *mem_handle_p = (na_mem_handle_t *) na_sm_mem_handle;
 
@@ -5035,6 +7964,19 @@ na_sm_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         (struct na_sm_op_id *) op_id);
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_sm_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t NA_UNUSED remote_id, na_op_id_t *op_id)
+{
+    return na_sm_atomic_rmw(NA_SM_CLASS(na_class), context, callback, arg, op,
+        operand, compare, (struct na_sm_mem_handle *) remote_mem_handle,
+        remote_offset, (struct na_sm_addr *) remote_addr,
+        (struct na_sm_op_id *) op_id);
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE int
 na_sm_poll_get_fd(na_class_t *na_class, na_context_t NA_UNUSED *context)
@@ -5056,19 +7998,8 @@ static NA_INLINE bool
 na_sm_poll_try_wait(na_class_t *na_class, na_context_t NA_UNUSED *context)
 {
     struct na_sm_endpoint *na_sm_endpoint = &NA_SM_CLASS(na_class)->endpoint;
-    struct na_sm_addr *na_sm_addr;
     bool empty = false;
 
-    /* Check whether something is in one of the rx queues */
-    hg_thread_spin_lock(&na_sm_endpoint->poll_addr_list.lock);
-    HG_LIST_FOREACH (na_sm_addr, &na_sm_endpoint->poll_addr_list.list, entry) {
-        if (!na_sm_msg_queue_is_empty(na_sm_addr->rx_queue)) {
-            hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
-            return false;
-        }
-    }
-    hg_thread_spin_unlock(&na_sm_endpoint->poll_addr_list.lock);
-
     /* Check whether something is in the retry queue */
     hg_thread_spin_lock(&na_sm_endpoint->retry_op_queue.lock);
     empty = HG_QUEUE_IS_EMPTY(&na_sm_endpoint->retry_op_queue.queue);
@@ -5076,6 +8007,15 @@ na_sm_poll_try_wait(na_class_t *na_class, na_context_t NA_UNUSED *context)
     if (!empty)
         return false;
 
+    /* Check whether something is in one of the rx queues, caller is about to
+     * block on our fd so peers must notify us from now on (until progress) */
+    if (!na_sm_endpoint->poll_set)
+        return true;
+    if (!na_sm_poll_arm(na_sm_endpoint)) {
+        na_sm_poll_disarm(na_sm_endpoint);
+        return false;
+    }
+
     return true;
 }
 
@@ -5092,27 +8032,34 @@ na_sm_progress(
         hg_time_get_current_ms(&now);
     deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
 
+    /* Back from waiting on our fd (see na_sm_poll_try_wait()) */
+    na_sm_poll_disarm(na_sm_endpoint);
+
     do {
         bool progressed = false;
 
-        if (na_sm_endpoint->poll_set) {
+        /* Busy-poll queues first, peers do not signal unless we block */
+        ret = na_sm_poll(na_sm_endpoint, &progressed);
+        NA_CHECK_SUBSYS_NA_ERROR(poll, error, ret,
+            "Could not make non-blocking progress on context");
+
+        if (!progressed && na_sm_endpoint->poll_set) {
             /* Make blocking progress */
             ret = na_sm_poll_wait(context, na_sm_endpoint,
                 hg_time_to_ms(hg_time_subtract(deadline, now)), &progressed);
             NA_CHECK_SUBSYS_NA_ERROR(poll, error, ret,
                 "Could not make blocking progress on context");
-        } else {
-            /* Make non-blocking progress */
-            ret = na_sm_poll(na_sm_endpoint, &progressed);
-            NA_CHECK_SUBSYS_NA_ERROR(poll, error, ret,
-                "Could not make non-blocking progress on context");
         }
 
         /* Process retries */
-        ret = na_sm_process_retries(&NA_SM_CLASS(na_class)->endpoint);
+        ret = na_sm_process_retries(NA_SM_CLASS(na_class));
         NA_CHECK_SUBSYS_NA_ERROR(
             poll, error, ret, "Could not process retried msgs");
 
+        /* Process staged RMA waiting for copy buffers or queue entries */
+        na_sm_process_rma_acks(na_sm_endpoint);
+        na_sm_process_rma_ops(na_sm_endpoint);
+
         if (progressed)
             return NA_SUCCESS;
 
@@ -5148,6 +8095,7 @@ na_sm_cancel(
 
     switch (na_sm_op_id->completion_data.callback_info.type) {
         case NA_CB_RECV_UNEXPECTED:
+        case NA_CB_MULTI_RECV_UNEXPECTED:
             /* Must remove op_id from unexpected op queue */
             op_queue = &NA_SM_CLASS(na_class)->endpoint.unexpected_op_queue;
             break;
@@ -5162,6 +8110,10 @@ na_sm_cancel(
             break;
         case NA_CB_PUT:
         case NA_CB_GET:
+            /* Staged RMA ops may wait for copy buffers on RMA op queue */
+            op_queue = &NA_SM_CLASS(na_class)->endpoint.rma_op_queue;
+            break;
+        case NA_CB_ATOMIC:
             /* Nothing */
             break;
         default:
@@ -5172,6 +8124,7 @@ na_sm_cancel(
 
     /* Remove op id from queue it is on */
     if (op_queue) {
+        struct na_cb_completion_data *completion_data = NULL;
         bool canceled = false;
 
         hg_thread_spin_lock(&op_queue->lock);
@@ -5185,12 +8138,23 @@ na_sm_cancel(
                     &op_queue->queue, na_sm_op_id, na_sm_op_id, entry);
                 hg_atomic_and32(&na_sm_op_id->status, ~NA_SM_OP_QUEUED);
                 canceled = true;
+
+                /* Multi-recv operations complete through their own entries */
+                if (na_sm_op_id->completion_data.callback_info.type ==
+                    NA_CB_MULTI_RECV_UNEXPECTED)
+                    completion_data = na_sm_multi_recv_reserve(
+                        na_sm_op_id, NULL, 0, 0, 0, NA_CANCELED);
             }
         }
         hg_thread_spin_unlock(&op_queue->lock);
 
         /* Cancel op id */
-        if (canceled) {
+        if (completion_data != NULL) {
+            hg_atomic_or32(&na_sm_op_id->status, NA_SM_OP_COMPLETED);
+            na_cb_completion_add(na_sm_op_id->context, completion_data);
+
+            na_sm_complete_signal(NA_SM_CLASS(na_class));
+        } else if (canceled) {
             na_sm_complete(na_sm_op_id, NA_CANCELED);
 
             na_sm_complete_signal(NA_SM_CLASS(na_class));
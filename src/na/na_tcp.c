@@ -0,0 +1,3196 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#if !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE
+#endif
+#include "na_plugin.h"
+
+#include "na_ip.h"
+
+#include "mercury_event.h"
+#include "mercury_hash_table.h"
+#include "mercury_list.h"
+#include "mercury_poll.h"
+#include "mercury_thread_mutex.h"
+#include "mercury_time.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#    include <linux/errqueue.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Zero-copy sends (Linux >= 4.14) */
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) &&     \
+    defined(SO_EE_ORIGIN_ZEROCOPY)
+#    define NA_TCP_HAS_ZCOPY
+#endif
+
+#ifndef MSG_NOSIGNAL
+#    define MSG_NOSIGNAL 0
+#endif
+
+/* Default msg sizes */
+#define NA_TCP_MSG_SIZE (4096)
+
+/* Max tag */
+#define NA_TCP_MAX_TAG NA_TAG_MAX
+
+/* Max addr string size */
+#define NA_TCP_ADDR_NAME_MAX (64)
+
+/* Wire protocol magic ("NATC") */
+#define NA_TCP_MAGIC (0x4e415443)
+
+/* Connection backlog */
+#define NA_TCP_LISTEN_BACKLOG (1024)
+
+/* Size of per-connection receive buffer, small frames are parsed from that
+ * buffer so that one recv() returns many of them */
+#define NA_TCP_RBUF_SIZE (65536)
+
+/* Remaining body size above which data is received in place */
+#define NA_TCP_RECV_DIRECT_MIN (4096)
+
+/* Max number of recv() calls per connection and per progress iteration */
+#define NA_TCP_RECV_MAX (16)
+
+/* Max number of iovecs gathered from queued frames into one sendmsg() */
+#define NA_TCP_IOV_MAX (64)
+
+/* Max number of iovecs of a frame (header, RMA descriptor, data) */
+#define NA_TCP_FRAME_IOV_MAX (3)
+
+/* Bulk size above which MSG_ZEROCOPY is used */
+#define NA_TCP_ZCOPY_MIN (32768)
+
+/* Max events */
+#define NA_TCP_MAX_EVENTS (64)
+
+/* Op ID status bits */
+#define NA_TCP_OP_COMPLETED (1 << 0)
+#define NA_TCP_OP_CANCELED  (1 << 1)
+#define NA_TCP_OP_QUEUED    (1 << 2)
+
+/* Private data access */
+#define NA_TCP_CLASS(na_class)                                                 \
+    ((struct na_tcp_class *) (na_class->plugin_class))
+
+/* Reset op ID */
+#define NA_TCP_OP_RESET(__op, __context, __cb_type, __cb, __arg, __addr)       \
+    do {                                                                       \
+        __op->context = __context;                                             \
+        __op->completion_data.callback_info.type = __cb_type;                  \
+        __op->completion_data.callback = __cb;                                 \
+        __op->completion_data.callback_info.arg = __arg;                       \
+        __op->addr = __addr;                                                   \
+        if (__addr)                                                            \
+            na_tcp_addr_ref_incr(__addr);                                      \
+        hg_atomic_set32(&__op->status, 0);                                     \
+    } while (0)
+
+#define NA_TCP_OP_RELEASE(__op)                                                \
+    do {                                                                       \
+        if (__op->addr)                                                        \
+            na_tcp_addr_ref_decr(__op->addr);                                  \
+        __op->addr = NULL;                                                     \
+        hg_atomic_set32(&__op->status, NA_TCP_OP_COMPLETED);                   \
+    } while (0)
+
+/* Addr map key */
+#define NA_TCP_ADDR_KEY(sin)                                                   \
+    (((uint64_t) ntohl((sin)->sin_addr.s_addr) << 16) | ntohs((sin)->sin_port))
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Frame types */
+enum na_tcp_frame_type {
+    NA_TCP_HELLO = 1,   /* Connection handshake */
+    NA_TCP_UNEXPECTED,  /* Unexpected msg */
+    NA_TCP_EXPECTED,    /* Expected msg */
+    NA_TCP_GET_REQ,     /* RMA get request */
+    NA_TCP_GET_RESP,    /* RMA get data (or error status) */
+    NA_TCP_PUT,         /* RMA put request and data */
+    NA_TCP_PUT_ACK      /* RMA put completion status */
+};
+
+/* Frame header, all fields are sent in network byte order */
+struct na_tcp_hdr {
+    uint8_t type;        /* Frame type */
+    uint8_t reserved[3]; /* Unused */
+    uint32_t tag;        /* Msg tag or RMA status */
+    uint64_t len;        /* Payload length */
+    uint64_t cookie;     /* RMA operation cookie */
+};
+
+/* RMA descriptor sent along GET_REQ / PUT frames */
+struct na_tcp_rma_req {
+    uint64_t handle_id; /* Remote memory handle ID */
+    uint64_t offset;    /* Offset within remote handle */
+    uint64_t length;    /* Length of transfer */
+};
+
+/* Handshake sent on new connections */
+struct na_tcp_hello {
+    uint32_t magic;    /* Protocol magic */
+    uint32_t ip;       /* Listening IP of sender (0 if not listening) */
+    uint32_t port;     /* Listening port of sender */
+    uint32_t reserved; /* Unused */
+};
+
+union na_tcp_sub {
+    struct na_tcp_rma_req rma_req;
+    struct na_tcp_hello hello;
+};
+
+/* Frame queued for sending */
+struct na_tcp_frame {
+    HG_QUEUE_ENTRY(na_tcp_frame) entry;      /* Entry in send queue */
+    struct na_tcp_hdr hdr;                   /* Encoded header */
+    union na_tcp_sub sub;                    /* Encoded descriptor */
+    struct iovec iov[NA_TCP_FRAME_IOV_MAX];  /* Remaining data to send */
+    struct na_tcp_op_id *op;                 /* Op completed once sent */
+    size_t sent;                             /* Bytes already sent */
+    unsigned int iovcnt;                     /* Number of iovecs */
+    unsigned int iov_idx;                    /* First iovec not sent */
+    bool zcopy;                              /* Last iovec is bulk data */
+    bool internal;                           /* Freed once sent */
+    bool queued;                             /* In send queue */
+};
+
+/* Receive state */
+enum na_tcp_rx_phase {
+    NA_TCP_RX_HDR,     /* Receiving header */
+    NA_TCP_RX_BODY,    /* Receiving payload */
+    NA_TCP_RX_PUT_DATA /* Receiving put data after descriptor */
+};
+
+struct na_tcp_rx {
+    struct na_tcp_hdr hdr;      /* Decoded header */
+    union na_tcp_sub sub;       /* Received descriptor */
+    struct na_tcp_op_id *op;    /* Op receiving payload */
+    char *dest;                 /* Payload destination (NULL to discard) */
+    void *buf;                  /* Buffer of unexpected msg not posted yet */
+    size_t hdr_len;             /* Header bytes received */
+    size_t remaining;           /* Payload bytes left */
+    na_return_t status;         /* Status of payload processing */
+    enum na_tcp_rx_phase phase; /* Current phase */
+};
+
+/* Connection */
+struct na_tcp_conn {
+    HG_LIST_ENTRY(na_tcp_conn) entry;           /* Entry in class lists */
+    HG_QUEUE_HEAD(na_tcp_frame) send_queue;     /* Frames to send */
+    HG_QUEUE_HEAD(na_tcp_op_id) rma_queue;      /* RMAs waiting for reply */
+    struct na_tcp_rx rx;                        /* Receive state */
+    struct na_tcp_addr *addr;                   /* Peer (NULL before hello) */
+    char *rbuf;                                 /* Receive buffer */
+    na_return_t error;                          /* Close reason */
+    int fd;                                     /* Socket */
+    bool connecting;                            /* Connect in progress */
+    bool pollout;                               /* Waiting for POLLOUT */
+    bool zcopy;                                 /* MSG_ZEROCOPY enabled */
+    bool closed;                                /* Closed, pending release */
+};
+
+/* Address */
+struct na_tcp_addr {
+    struct sockaddr_in sin;            /* Listening address of peer */
+    struct na_tcp_class *na_tcp_class; /* Class */
+    struct na_tcp_conn *conn;          /* Connection used for sending */
+    uint64_t key;                      /* Map key (0 if anonymous) */
+    hg_atomic_int32_t ref_count;       /* Ref count */
+    bool self;                         /* Self address */
+    bool in_map;                       /* Inserted in addr map */
+};
+
+/* Memory handle */
+struct na_tcp_mem_handle {
+    uint64_t id;    /* Handle ID (0 for remote handles) */
+    uint64_t base;  /* Base address */
+    uint64_t len;   /* Length */
+    uint8_t flags;  /* Access flags */
+    bool local;     /* Handle was created locally */
+};
+
+/* Unexpected msg received before a recv was posted */
+struct na_tcp_unexpected_info {
+    HG_QUEUE_ENTRY(na_tcp_unexpected_info) entry;
+    struct na_tcp_addr *na_tcp_addr;
+    void *buf;
+    size_t buf_size;
+    na_tag_t tag;
+};
+
+/* Operation ID */
+struct na_tcp_op_id {
+    struct na_cb_completion_data completion_data; /* Completion data */
+    struct na_tcp_frame frame;                    /* Send frame */
+    HG_QUEUE_ENTRY(na_tcp_op_id) entry;           /* Entry in op queues */
+    na_class_t *na_class;                         /* NA class */
+    na_context_t *context;                        /* NA context */
+    struct na_tcp_addr *addr;                     /* Peer address */
+    struct na_tcp_conn *conn;                     /* Conn of pending RMA */
+    void *buf;                                    /* Msg / local RMA buffer */
+    size_t buf_size;                              /* Buffer size */
+    uint64_t cookie;                              /* RMA cookie */
+    na_tag_t tag;                                 /* Msg tag */
+    hg_atomic_int32_t status;                     /* Operation status */
+};
+
+/* Class */
+struct na_tcp_class {
+    HG_LIST_HEAD(na_tcp_conn) conns;         /* Open connections */
+    HG_LIST_HEAD(na_tcp_conn) closed_conns;  /* Connections to release */
+    HG_QUEUE_HEAD(na_tcp_op_id) unexpected_op_queue; /* Posted unexpected */
+    HG_QUEUE_HEAD(na_tcp_op_id) expected_op_queue;   /* Posted expected */
+    HG_QUEUE_HEAD(na_tcp_unexpected_info) unexpected_msg_queue; /* Msgs */
+    hg_thread_mutex_t lock;                  /* Lock for all of the above */
+    hg_hash_table_t *addr_map;               /* Addresses by key */
+    hg_hash_table_t *mem_map;                /* Local memory handles by ID */
+    hg_poll_set_t *poll_set;                 /* Poll set */
+    na_class_t *na_class;                    /* NA class */
+    struct na_tcp_addr *self_addr;           /* Self address */
+    size_t unexpected_size_max;              /* Max unexpected size */
+    size_t expected_size_max;                /* Max expected size */
+    uint64_t mem_id;                         /* Last memory handle ID */
+    hg_atomic_int64_t cookie;                /* Last RMA cookie */
+    hg_atomic_int32_t waiting;               /* Progress is blocked */
+    int listen_fd;                           /* Listening socket */
+    int event_fd;                            /* Wake up event */
+};
+
+/* Tokens identifying listen / event fds in poll set */
+static char na_tcp_listen_token_g;
+static char na_tcp_event_token_g;
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Convert errno to NA return values.
+ */
+static na_return_t
+na_tcp_errno_to_na(int rc);
+
+/**
+ * Convert 64-bit value to / from network byte order.
+ */
+static NA_INLINE uint64_t
+na_tcp_hton64(uint64_t value);
+
+/**
+ * Encode frame header.
+ */
+static NA_INLINE void
+na_tcp_hdr_encode(struct na_tcp_hdr *hdr, enum na_tcp_frame_type type,
+    uint32_t tag, uint64_t len, uint64_t cookie);
+
+/**
+ * Hash / compare 64-bit keys.
+ */
+static NA_INLINE unsigned int
+na_tcp_key_hash(hg_hash_table_key_t key);
+
+static NA_INLINE int
+na_tcp_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2);
+
+/**
+ * Set socket options common to all connections.
+ */
+static na_return_t
+na_tcp_socket_setup(int fd, bool *zcopy_p);
+
+/**
+ * Create address.
+ */
+static struct na_tcp_addr *
+na_tcp_addr_create(struct na_tcp_class *na_tcp_class,
+    const struct sockaddr_in *sin, bool self);
+
+/**
+ * Increment ref count.
+ */
+static NA_INLINE void
+na_tcp_addr_ref_incr(struct na_tcp_addr *na_tcp_addr);
+
+/**
+ * Decrement ref count and free address if 0.
+ */
+static void
+na_tcp_addr_ref_decr(struct na_tcp_addr *na_tcp_addr);
+
+/**
+ * Lookup address in map or insert new one (class lock held).
+ */
+static struct na_tcp_addr *
+na_tcp_addr_map_get(
+    struct na_tcp_class *na_tcp_class, const struct sockaddr_in *sin);
+
+/**
+ * Get or open the connection used to send to an address (class lock held).
+ */
+static na_return_t
+na_tcp_addr_conn(struct na_tcp_class *na_tcp_class,
+    struct na_tcp_addr *na_tcp_addr, struct na_tcp_conn **conn_p);
+
+/**
+ * Create connection on socket and add it to poll set (class lock held).
+ */
+static struct na_tcp_conn *
+na_tcp_conn_create(
+    struct na_tcp_class *na_tcp_class, int fd, bool connecting, bool zcopy);
+
+/**
+ * Close connection and fail its pending operations (class lock held), the
+ * connection is released by na_tcp_conn_release_closed().
+ */
+static void
+na_tcp_conn_close(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn,
+    na_return_t error);
+
+/**
+ * Release closed connections and notify peer errors (class lock not held).
+ */
+static void
+na_tcp_conn_release_closed(struct na_tcp_class *na_tcp_class);
+
+/**
+ * Update events that connection is polled for.
+ */
+static na_return_t
+na_tcp_conn_poll_update(
+    struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn, bool pollout);
+
+/**
+ * Queue frame on connection.
+ */
+static NA_INLINE void
+na_tcp_conn_enqueue(struct na_tcp_conn *conn, struct na_tcp_frame *frame);
+
+/**
+ * Send as much queued data as possible, gathering consecutive frames into
+ * single sendmsg() calls (class lock held).
+ */
+static na_return_t
+na_tcp_conn_send(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn);
+
+/**
+ * Account for sent bytes and complete frames that were fully sent.
+ */
+static void
+na_tcp_conn_sent(struct na_tcp_conn *conn, size_t len);
+
+/**
+ * Receive and process incoming data (class lock held).
+ */
+static na_return_t
+na_tcp_conn_recv(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn);
+
+/**
+ * Process received bytes.
+ */
+static na_return_t
+na_tcp_conn_parse(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn,
+    const char *buf, size_t len);
+
+/**
+ * Process completed header.
+ */
+static na_return_t
+na_tcp_rx_hdr(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn);
+
+/**
+ * Process completed payload(s).
+ */
+static na_return_t
+na_tcp_rx_advance(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn);
+
+/**
+ * Attach connection to peer address once hello is received.
+ */
+static na_return_t
+na_tcp_rx_hello(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn);
+
+/**
+ * Serve RMA get request.
+ */
+static na_return_t
+na_tcp_rx_get_req(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn);
+
+/**
+ * Validate RMA descriptor against local memory handles.
+ */
+static na_return_t
+na_tcp_rma_check(struct na_tcp_class *na_tcp_class,
+    const struct na_tcp_rma_req *rma_req, uint8_t access, char **ptr_p);
+
+/**
+ * Find and dequeue pending RMA operation.
+ */
+static struct na_tcp_op_id *
+na_tcp_rma_find(struct na_tcp_conn *conn, uint64_t cookie);
+
+/**
+ * Send internal reply frame.
+ */
+static na_return_t
+na_tcp_reply(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn,
+    enum na_tcp_frame_type type, na_return_t status, uint64_t cookie,
+    void *data, size_t len);
+
+/**
+ * Drain socket error queue (zero-copy notifications).
+ */
+static na_return_t
+na_tcp_conn_errqueue(struct na_tcp_conn *conn);
+
+/**
+ * Accept incoming connections.
+ */
+static void
+na_tcp_accept(struct na_tcp_class *na_tcp_class);
+
+/**
+ * Process poll event on connection.
+ */
+static void
+na_tcp_conn_event(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn,
+    unsigned int events);
+
+/**
+ * Post send frame of operation.
+ */
+static na_return_t
+na_tcp_post(struct na_tcp_class *na_tcp_class, struct na_tcp_op_id *op_id,
+    bool rma);
+
+/**
+ * Post msg send.
+ */
+static na_return_t
+na_tcp_msg_send(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg, const void *buf,
+    size_t buf_size, na_addr_t *dest_addr, na_tag_t tag, na_op_id_t *op_id);
+
+/**
+ * Setup msg send frame.
+ */
+static na_return_t
+na_tcp_msg_send_setup(struct na_tcp_class *na_tcp_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg, const void *buf,
+    size_t buf_size, struct na_tcp_addr *na_tcp_addr, na_tag_t tag,
+    struct na_tcp_op_id *na_tcp_op_id);
+
+/**
+ * Post RMA operation.
+ */
+static na_return_t
+na_tcp_rma(na_class_t *na_class, na_context_t *context, na_cb_type_t cb_type,
+    na_cb_t callback, void *arg, na_mem_handle_t *local_mem_handle,
+    na_offset_t local_offset, na_mem_handle_t *remote_mem_handle,
+    na_offset_t remote_offset, size_t length, na_addr_t *remote_addr,
+    na_op_id_t *op_id);
+
+/**
+ * Complete operation.
+ */
+static NA_INLINE void
+na_tcp_complete(struct na_tcp_op_id *na_tcp_op_id, na_return_t cb_ret);
+
+/**
+ * Wake up progress blocked on poll set.
+ */
+static NA_INLINE void
+na_tcp_complete_signal(struct na_tcp_class *na_tcp_class);
+
+/**
+ * Release memory.
+ */
+static NA_INLINE void
+na_tcp_release(void *arg);
+
+/* get_protocol_info */
+static na_return_t
+na_tcp_get_protocol_info(const struct na_info *na_info,
+    struct na_protocol_info **na_protocol_info_p);
+
+/* check_protocol */
+static bool
+na_tcp_check_protocol(const char *protocol_name);
+
+/* initialize */
+static na_return_t
+na_tcp_initialize(
+    na_class_t *na_class, const struct na_info *na_info, bool listen);
+
+/* finalize */
+static na_return_t
+na_tcp_finalize(na_class_t *na_class);
+
+/* op_create */
+static na_op_id_t *
+na_tcp_op_create(na_class_t *na_class, unsigned long flags);
+
+/* op_destroy */
+static void
+na_tcp_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
+
+/* op_reset */
+static na_return_t
+na_tcp_op_reset(na_class_t *na_class, na_op_id_t *op_id);
+
+/* addr_lookup */
+static na_return_t
+na_tcp_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p);
+
+/* addr_free */
+static void
+na_tcp_addr_free(na_class_t *na_class, na_addr_t *addr);
+
+/* addr_set_remove */
+static na_return_t
+na_tcp_addr_set_remove(na_class_t *na_class, na_addr_t *addr);
+
+/* addr_self */
+static na_return_t
+na_tcp_addr_self(na_class_t *na_class, na_addr_t **addr_p);
+
+/* addr_dup */
+static na_return_t
+na_tcp_addr_dup(na_class_t *na_class, na_addr_t *addr, na_addr_t **new_addr_p);
+
+/* addr_cmp */
+static bool
+na_tcp_addr_cmp(na_class_t *na_class, na_addr_t *addr1, na_addr_t *addr2);
+
+/* addr_is_self */
+static NA_INLINE bool
+na_tcp_addr_is_self(na_class_t *na_class, na_addr_t *addr);
+
+/* addr_to_string */
+static na_return_t
+na_tcp_addr_to_string(
+    na_class_t *na_class, char *buf, size_t *buf_size, na_addr_t *addr);
+
+/* addr_get_serialize_size */
+static NA_INLINE size_t
+na_tcp_addr_get_serialize_size(na_class_t *na_class, na_addr_t *addr);
+
+/* addr_serialize */
+static na_return_t
+na_tcp_addr_serialize(
+    na_class_t *na_class, void *buf, size_t buf_size, na_addr_t *addr);
+
+/* addr_deserialize */
+static na_return_t
+na_tcp_addr_deserialize(
+    na_class_t *na_class, na_addr_t **addr_p, const void *buf, size_t buf_size);
+
+/* msg_get_max_unexpected_size */
+static NA_INLINE size_t
+na_tcp_msg_get_max_unexpected_size(const na_class_t *na_class);
+
+/* msg_get_max_expected_size */
+static NA_INLINE size_t
+na_tcp_msg_get_max_expected_size(const na_class_t *na_class);
+
+/* msg_get_max_tag */
+static NA_INLINE na_tag_t
+na_tcp_msg_get_max_tag(const na_class_t *na_class);
+
+/* msg_send_unexpected */
+static na_return_t
+na_tcp_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, size_t buf_size,
+    void *plugin_data, na_addr_t *dest_addr, uint8_t dest_id, na_tag_t tag,
+    na_op_id_t *op_id);
+
+/* msg_recv_unexpected */
+static na_return_t
+na_tcp_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
+    na_op_id_t *op_id);
+
+/* msg_send_expected */
+static na_return_t
+na_tcp_msg_send_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, size_t buf_size,
+    void *plugin_data, na_addr_t *dest_addr, uint8_t dest_id, na_tag_t tag,
+    na_op_id_t *op_id);
+
+/* msg_recv_expected */
+static na_return_t
+na_tcp_msg_recv_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
+    na_addr_t *source_addr, uint8_t source_id, na_tag_t tag,
+    na_op_id_t *op_id);
+
+/* msg_send_batch */
+static na_return_t
+na_tcp_msg_send_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+    size_t count, size_t *posted_count_p);
+
+/* mem_handle_create */
+static na_return_t
+na_tcp_mem_handle_create(na_class_t *na_class, void *buf, size_t buf_size,
+    unsigned long flags, na_mem_handle_t **mem_handle_p);
+
+/* mem_handle_free */
+static void
+na_tcp_mem_handle_free(na_class_t *na_class, na_mem_handle_t *mem_handle);
+
+/* mem_handle_get_serialize_size */
+static NA_INLINE size_t
+na_tcp_mem_handle_get_serialize_size(
+    na_class_t *na_class, na_mem_handle_t *mem_handle);
+
+/* mem_handle_serialize */
+static na_return_t
+na_tcp_mem_handle_serialize(na_class_t *na_class, void *buf, size_t buf_size,
+    na_mem_handle_t *mem_handle);
+
+/* mem_handle_deserialize */
+static na_return_t
+na_tcp_mem_handle_deserialize(na_class_t *na_class,
+    na_mem_handle_t **mem_handle_p, const void *buf, size_t buf_size);
+
+/* put */
+static na_return_t
+na_tcp_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t *local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    size_t length, na_addr_t *remote_addr, uint8_t remote_id,
+    na_op_id_t *op_id);
+
+/* get */
+static na_return_t
+na_tcp_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t *local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    size_t length, na_addr_t *remote_addr, uint8_t remote_id,
+    na_op_id_t *op_id);
+
+/* poll_get_fd */
+static int
+na_tcp_poll_get_fd(na_class_t *na_class, na_context_t *context);
+
+/* progress */
+static na_return_t
+na_tcp_progress(
+    na_class_t *na_class, na_context_t *context, unsigned int timeout);
+
+/* cancel */
+static na_return_t
+na_tcp_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t *op_id);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+const struct na_class_ops NA_PLUGIN_OPS(tcp) = {
+    "tcp",                                /* name */
+    na_tcp_get_protocol_info,             /* get_protocol_info */
+    na_tcp_check_protocol,                /* check_protocol */
+    na_tcp_initialize,                    /* initialize */
+    na_tcp_finalize,                      /* finalize */
+    NULL,                                 /* cleanup */
+    NULL,                                 /* has_opt_feature */
+    NULL,                                 /* get_numa_node */
+    NULL,                                 /* context_create */
+    NULL,                                 /* context_destroy */
+    na_tcp_op_create,                     /* op_create */
+    na_tcp_op_destroy,                    /* op_destroy */
+    na_tcp_op_reset,                      /* op_reset */
+    na_tcp_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
+    NULL,                                 /* addr_warm */
+    na_tcp_addr_free,                     /* addr_free */
+    na_tcp_addr_set_remove,               /* addr_set_remove */
+    na_tcp_addr_self,                     /* addr_self */
+    na_tcp_addr_dup,                      /* addr_dup */
+    na_tcp_addr_cmp,                      /* addr_cmp */
+    na_tcp_addr_is_self,                  /* addr_is_self */
+    na_tcp_addr_to_string,                /* addr_to_string */
+    na_tcp_addr_get_serialize_size,       /* addr_get_serialize_size */
+    na_tcp_addr_serialize,                /* addr_serialize */
+    na_tcp_addr_deserialize,              /* addr_deserialize */
+    na_tcp_msg_get_max_unexpected_size,   /* msg_get_max_unexpected_size */
+    na_tcp_msg_get_max_expected_size,     /* msg_get_max_expected_size */
+    NULL,                                 /* msg_get_unexpected_header_size */
+    NULL,                                 /* msg_get_expected_header_size */
+    na_tcp_msg_get_max_tag,               /* msg_get_max_tag */
+    NULL,                                 /* msg_buf_alloc */
+    NULL,                                 /* msg_buf_free */
+    NULL,                                 /* msg_init_unexpected */
+    na_tcp_msg_send_unexpected,           /* msg_send_unexpected */
+    na_tcp_msg_recv_unexpected,           /* msg_recv_unexpected */
+    NULL,                                 /* msg_multi_recv_unexpected */
+    NULL,                                 /* msg_init_expected */
+    na_tcp_msg_send_expected,             /* msg_send_expected */
+    na_tcp_msg_recv_expected,             /* msg_recv_expected */
+    na_tcp_msg_send_batch,                /* msg_send_batch */
+    na_tcp_mem_handle_create,             /* mem_handle_create */
+    NULL,                                 /* mem_handle_create_segments */
+    na_tcp_mem_handle_free,               /* mem_handle_free */
+    NULL,                                 /* mem_handle_get_max_segments */
+    NULL,                                 /* mem_register */
+    NULL,                                 /* mem_deregister */
+    na_tcp_mem_handle_get_serialize_size, /* mem_handle_get_serialize_size */
+    na_tcp_mem_handle_serialize,          /* mem_handle_serialize */
+    na_tcp_mem_handle_deserialize,        /* mem_handle_deserialize */
+    na_tcp_put,                           /* put */
+    na_tcp_get,                           /* get */
+    NULL,                                 /* rma_batch_get_max_segments */
+    NULL,                                 /* rma_batch */
+    NULL,                                 /* atomic */
+    na_tcp_poll_get_fd,                   /* poll_get_fd */
+    NULL,                                 /* poll_try_wait */
+    na_tcp_progress,                      /* progress */
+    na_tcp_cancel                         /* cancel */
+};
+
+/********************/
+/* Plugin callbacks */
+/********************/
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_errno_to_na(int rc)
+{
+    na_return_t ret;
+
+    switch (rc) {
+        case EPERM:
+            ret = NA_PERMISSION;
+            break;
+        case EINTR:
+            ret = NA_INTERRUPT;
+            break;
+        case EAGAIN:
+#if EAGAIN != EWOULDBLOCK
+        case EWOULDBLOCK:
+#endif
+            ret = NA_AGAIN;
+            break;
+        case ENOMEM:
+        case ENOBUFS:
+            ret = NA_NOMEM;
+            break;
+        case EACCES:
+            ret = NA_ACCESS;
+            break;
+        case EFAULT:
+            ret = NA_FAULT;
+            break;
+        case EINVAL:
+            ret = NA_INVALID_ARG;
+            break;
+        case EMSGSIZE:
+            ret = NA_MSGSIZE;
+            break;
+        case EADDRINUSE:
+            ret = NA_ADDRINUSE;
+            break;
+        case EADDRNOTAVAIL:
+            ret = NA_ADDRNOTAVAIL;
+            break;
+        case ECONNREFUSED:
+        case ECONNRESET:
+        case ECONNABORTED:
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case EPIPE:
+            ret = NA_HOSTUNREACH;
+            break;
+        case ETIMEDOUT:
+            ret = NA_TIMEOUT;
+            break;
+        default:
+            ret = NA_PROTOCOL_ERROR;
+            break;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE uint64_t
+na_tcp_hton64(uint64_t value)
+{
+    if (htonl(1) == 1)
+        return value;
+
+    return ((uint64_t) htonl((uint32_t) value) << 32) |
+           htonl((uint32_t) (value >> 32));
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_tcp_hdr_encode(struct na_tcp_hdr *hdr, enum na_tcp_frame_type type,
+    uint32_t tag, uint64_t len, uint64_t cookie)
+{
+    *hdr = (struct na_tcp_hdr){.type = (uint8_t) type,
+        .reserved = {0},
+        .tag = htonl(tag),
+        .len = na_tcp_hton64(len),
+        .cookie = na_tcp_hton64(cookie)};
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE unsigned int
+na_tcp_key_hash(hg_hash_table_key_t key)
+{
+    uint64_t value = *((uint64_t *) key);
+
+    return (unsigned int) (value ^ (value >> 32));
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE int
+na_tcp_key_equal(hg_hash_table_key_t key1, hg_hash_table_key_t key2)
+{
+    return *((uint64_t *) key1) == *((uint64_t *) key2);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_socket_setup(int fd, bool *zcopy_p)
+{
+    int one = 1, flags, rc;
+    na_return_t ret;
+
+    flags = fcntl(fd, F_GETFL, 0);
+    NA_CHECK_SUBSYS_ERROR(cls, flags == -1, error, ret,
+        na_tcp_errno_to_na(errno), "fcntl() failed (%s)", strerror(errno));
+    rc = fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    NA_CHECK_SUBSYS_ERROR(cls, rc == -1, error, ret, na_tcp_errno_to_na(errno),
+        "fcntl() failed (%s)", strerror(errno));
+    (void) fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    /* Small msgs must not wait for more data */
+    rc = setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    NA_CHECK_SUBSYS_WARNING(
+        cls, rc != 0, "Could not set TCP_NODELAY (%s)", strerror(errno));
+
+#ifdef SO_NOSIGPIPE
+    (void) setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    *zcopy_p = false;
+#ifdef NA_TCP_HAS_ZCOPY
+    if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0)
+        *zcopy_p = true;
+#endif
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_tcp_addr *
+na_tcp_addr_create(struct na_tcp_class *na_tcp_class,
+    const struct sockaddr_in *sin, bool self)
+{
+    struct na_tcp_addr *na_tcp_addr;
+
+    na_tcp_addr = (struct na_tcp_addr *) calloc(1, sizeof(*na_tcp_addr));
+    NA_CHECK_SUBSYS_ERROR_NORET(addr, na_tcp_addr == NULL, error,
+        "Could not allocate NA TCP addr");
+
+    na_tcp_addr->na_tcp_class = na_tcp_class;
+    if (sin != NULL) {
+        na_tcp_addr->sin = *sin;
+        na_tcp_addr->key = NA_TCP_ADDR_KEY(sin);
+    }
+    na_tcp_addr->self = self;
+    hg_atomic_init32(&na_tcp_addr->ref_count, 1);
+
+    return na_tcp_addr;
+
+error:
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_tcp_addr_ref_incr(struct na_tcp_addr *na_tcp_addr)
+{
+    hg_atomic_incr32(&na_tcp_addr->ref_count);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_addr_ref_decr(struct na_tcp_addr *na_tcp_addr)
+{
+    struct na_tcp_class *na_tcp_class = na_tcp_addr->na_tcp_class;
+
+    if (hg_atomic_decr32(&na_tcp_addr->ref_count) > 0)
+        return;
+
+    /* Lookups never take a ref on an address whose count dropped to 0 (see
+     * na_tcp_addr_map_get()), connections hold a ref so conn is NULL */
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+    if (na_tcp_addr->in_map)
+        hg_hash_table_remove(
+            na_tcp_class->addr_map, (hg_hash_table_key_t) &na_tcp_addr->key);
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Freeing addr (%p)", (void *) na_tcp_addr);
+    free(na_tcp_addr);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_tcp_addr *
+na_tcp_addr_map_get(
+    struct na_tcp_class *na_tcp_class, const struct sockaddr_in *sin)
+{
+    uint64_t key = NA_TCP_ADDR_KEY(sin);
+    struct na_tcp_addr *na_tcp_addr;
+    int rc;
+
+    na_tcp_addr = (struct na_tcp_addr *) hg_hash_table_lookup(
+        na_tcp_class->addr_map, (hg_hash_table_key_t) &key);
+    if (na_tcp_addr != NULL) {
+        /* Take a ref unless the address is being freed, in which case it is
+         * replaced in the map */
+        int32_t ref_count = hg_atomic_get32(&na_tcp_addr->ref_count);
+        while (ref_count > 0) {
+            if (hg_atomic_cas32(
+                    &na_tcp_addr->ref_count, ref_count, ref_count + 1))
+                return na_tcp_addr;
+            ref_count = hg_atomic_get32(&na_tcp_addr->ref_count);
+        }
+        hg_hash_table_remove(
+            na_tcp_class->addr_map, (hg_hash_table_key_t) &key);
+        na_tcp_addr->in_map = false;
+    }
+
+    na_tcp_addr = na_tcp_addr_create(na_tcp_class, sin, false);
+    if (na_tcp_addr == NULL)
+        return NULL;
+
+    rc = hg_hash_table_insert(na_tcp_class->addr_map,
+        (hg_hash_table_key_t) &na_tcp_addr->key,
+        (hg_hash_table_value_t) na_tcp_addr);
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        addr, rc == 0, error, "hg_hash_table_insert() failed");
+    na_tcp_addr->in_map = true;
+
+    return na_tcp_addr;
+
+error:
+    free(na_tcp_addr);
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_conn(struct na_tcp_class *na_tcp_class,
+    struct na_tcp_addr *na_tcp_addr, struct na_tcp_conn **conn_p)
+{
+    struct na_tcp_conn *conn = NULL;
+    struct na_tcp_frame *frame = NULL;
+    bool zcopy;
+    na_return_t ret;
+    int fd = -1, rc;
+
+    if (na_tcp_addr->conn != NULL) {
+        *conn_p = na_tcp_addr->conn;
+        return NA_SUCCESS;
+    }
+
+    /* Anonymous peers can only be reached through their own connection */
+    NA_CHECK_SUBSYS_ERROR(addr, na_tcp_addr->key == 0, error, ret,
+        NA_HOSTUNREACH, "Connection to anonymous peer was closed");
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    NA_CHECK_SUBSYS_ERROR(addr, fd == -1, error, ret,
+        na_tcp_errno_to_na(errno), "socket() failed (%s)", strerror(errno));
+    ret = na_tcp_socket_setup(fd, &zcopy);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not setup socket");
+
+    rc = connect(fd, (const struct sockaddr *) &na_tcp_addr->sin,
+        sizeof(na_tcp_addr->sin));
+    NA_CHECK_SUBSYS_ERROR(addr, rc != 0 && errno != EINPROGRESS, error, ret,
+        na_tcp_errno_to_na(errno), "connect() failed (%s)", strerror(errno));
+
+    /* Hello is always the first frame */
+    frame = (struct na_tcp_frame *) calloc(1, sizeof(*frame));
+    NA_CHECK_SUBSYS_ERROR(addr, frame == NULL, error, ret, NA_NOMEM,
+        "Could not allocate hello frame");
+    na_tcp_hdr_encode(
+        &frame->hdr, NA_TCP_HELLO, 0, sizeof(struct na_tcp_hello), 0);
+    frame->sub.hello = (struct na_tcp_hello){.magic = htonl(NA_TCP_MAGIC),
+        .ip = na_tcp_class->self_addr->sin.sin_addr.s_addr,
+        .port = htonl(ntohs(na_tcp_class->self_addr->sin.sin_port)),
+        .reserved = 0};
+    frame->iov[0] = (struct iovec){.iov_base = &frame->hdr,
+        .iov_len = sizeof(frame->hdr)};
+    frame->iov[1] = (struct iovec){.iov_base = &frame->sub.hello,
+        .iov_len = sizeof(frame->sub.hello)};
+    frame->iovcnt = 2;
+    frame->internal = true;
+
+    conn = na_tcp_conn_create(na_tcp_class, fd, rc != 0, zcopy);
+    NA_CHECK_SUBSYS_ERROR(addr, conn == NULL, error, ret, NA_NOMEM,
+        "Could not create connection");
+    fd = -1;
+
+    conn->addr = na_tcp_addr;
+    na_tcp_addr_ref_incr(na_tcp_addr);
+    na_tcp_addr->conn = conn;
+    na_tcp_conn_enqueue(conn, frame);
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Opened connection %p (fd=%d) to addr %p",
+        (void *) conn, conn->fd, (void *) na_tcp_addr);
+
+    *conn_p = conn;
+
+    return NA_SUCCESS;
+
+error:
+    free(frame);
+    if (fd != -1)
+        close(fd);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_tcp_conn *
+na_tcp_conn_create(
+    struct na_tcp_class *na_tcp_class, int fd, bool connecting, bool zcopy)
+{
+    struct na_tcp_conn *conn;
+    struct hg_poll_event event;
+    int rc;
+
+    conn = (struct na_tcp_conn *) calloc(1, sizeof(*conn));
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        addr, conn == NULL, error, "Could not allocate connection");
+    conn->rbuf = (char *) malloc(NA_TCP_RBUF_SIZE);
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        addr, conn->rbuf == NULL, error, "Could not allocate receive buffer");
+
+    HG_QUEUE_INIT(&conn->send_queue);
+    HG_QUEUE_INIT(&conn->rma_queue);
+    conn->rx.phase = NA_TCP_RX_HDR;
+    conn->fd = fd;
+    conn->connecting = connecting;
+    conn->pollout = connecting;
+    conn->zcopy = zcopy;
+
+    /* Connection completion is reported as POLLOUT */
+    event.events = HG_POLLIN | (connecting ? HG_POLLOUT : 0);
+    event.data.ptr = conn;
+    rc = hg_poll_add(na_tcp_class->poll_set, fd, &event);
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        addr, rc != HG_UTIL_SUCCESS, error, "Could not add fd to poll set");
+
+    HG_LIST_INSERT_HEAD(&na_tcp_class->conns, conn, entry);
+
+    return conn;
+
+error:
+    if (conn != NULL) {
+        free(conn->rbuf);
+        free(conn);
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_conn_close(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn,
+    na_return_t error)
+{
+    struct na_tcp_frame *frame;
+    struct na_tcp_op_id *na_tcp_op_id;
+
+    if (conn->closed)
+        return;
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Closing connection %p (fd=%d, %s)",
+        (void *) conn, conn->fd, NA_Error_to_string(error));
+
+    (void) hg_poll_remove(na_tcp_class->poll_set, conn->fd);
+    close(conn->fd);
+    conn->fd = -1;
+    conn->closed = true;
+    conn->error = error;
+    HG_LIST_REMOVE(conn, entry);
+    HG_LIST_INSERT_HEAD(&na_tcp_class->closed_conns, conn, entry);
+
+    if (conn->addr != NULL && conn->addr->conn == conn)
+        conn->addr->conn = NULL;
+
+    /* Fail sends that did not go through */
+    while ((frame = HG_QUEUE_FIRST(&conn->send_queue)) != NULL) {
+        HG_QUEUE_POP_HEAD(&conn->send_queue, entry);
+        frame->queued = false;
+        if (frame->op != NULL)
+            na_tcp_complete(frame->op, NA_HOSTUNREACH);
+        else if (frame->internal)
+            free(frame);
+    }
+
+    /* Fail RMAs waiting for a reply */
+    while ((na_tcp_op_id = HG_QUEUE_FIRST(&conn->rma_queue)) != NULL) {
+        HG_QUEUE_POP_HEAD(&conn->rma_queue, entry);
+        hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+        na_tcp_complete(na_tcp_op_id, NA_HOSTUNREACH);
+    }
+
+    /* Recv that was being filled, posted unexpected buffers can be reused */
+    na_tcp_op_id = conn->rx.op;
+    conn->rx.op = NULL;
+    if (na_tcp_op_id != NULL) {
+        if (na_tcp_op_id->completion_data.callback_info.type ==
+            NA_CB_RECV_UNEXPECTED) {
+            HG_QUEUE_PUSH_TAIL(
+                &na_tcp_class->unexpected_op_queue, na_tcp_op_id, entry);
+            hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_QUEUED);
+        } else
+            na_tcp_complete(na_tcp_op_id, NA_HOSTUNREACH);
+    }
+    free(conn->rx.buf);
+    conn->rx.buf = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_conn_release_closed(struct na_tcp_class *na_tcp_class)
+{
+    for (;;) {
+        struct na_tcp_conn *conn;
+
+        hg_thread_mutex_lock(&na_tcp_class->lock);
+        conn = HG_LIST_FIRST(&na_tcp_class->closed_conns);
+        if (conn != NULL)
+            HG_LIST_REMOVE(conn, entry);
+        hg_thread_mutex_unlock(&na_tcp_class->lock);
+        if (conn == NULL)
+            break;
+
+        if (conn->addr != NULL) {
+            /* Let upper layer fail what is still pending to that peer */
+            if (conn->error != NA_SUCCESS)
+                na_cb_addr_error(na_tcp_class->na_class,
+                    (na_addr_t *) conn->addr, conn->error);
+            na_tcp_addr_ref_decr(conn->addr);
+        }
+        free(conn->rbuf);
+        free(conn);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_poll_update(
+    struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn, bool pollout)
+{
+    struct hg_poll_event event = {
+        .events = HG_POLLIN | (pollout ? HG_POLLOUT : 0), .data.ptr = conn};
+    na_return_t ret;
+    int rc;
+
+    if (conn->pollout == pollout)
+        return NA_SUCCESS;
+
+    rc = hg_poll_remove(na_tcp_class->poll_set, conn->fd);
+    NA_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
+        NA_PROTOCOL_ERROR, "Could not remove fd from poll set");
+    rc = hg_poll_add(na_tcp_class->poll_set, conn->fd, &event);
+    NA_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
+        NA_PROTOCOL_ERROR, "Could not add fd to poll set");
+    conn->pollout = pollout;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_tcp_conn_enqueue(struct na_tcp_conn *conn, struct na_tcp_frame *frame)
+{
+    frame->iov_idx = 0;
+    frame->sent = 0;
+    frame->queued = true;
+    HG_QUEUE_PUSH_TAIL(&conn->send_queue, frame, entry);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_send(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn)
+{
+    na_return_t ret;
+
+    if (conn->closed || conn->connecting)
+        return NA_SUCCESS;
+
+    while (!HG_QUEUE_IS_EMPTY(&conn->send_queue)) {
+        struct iovec iov[NA_TCP_IOV_MAX];
+        struct msghdr msg;
+        struct na_tcp_frame *frame;
+        size_t total = 0;
+        int iovcnt = 0, flags = MSG_NOSIGNAL;
+        ssize_t nbytes;
+
+        /* Gather iovecs of queued frames, bulk data that is zero-copied is
+         * sent on its own so that headers are never referenced by the kernel
+         * after they are released */
+        HG_QUEUE_FOREACH (frame, &conn->send_queue, entry) {
+            unsigned int i;
+
+            for (i = frame->iov_idx; i < frame->iovcnt; i++) {
+                bool zcopy = conn->zcopy && frame->zcopy &&
+                             i == frame->iovcnt - 1 &&
+                             frame->iov[i].iov_len >= NA_TCP_ZCOPY_MIN;
+
+                if (zcopy && iovcnt > 0)
+                    goto send;
+                iov[iovcnt++] = frame->iov[i];
+                total += frame->iov[i].iov_len;
+#ifdef NA_TCP_HAS_ZCOPY
+                if (zcopy) {
+                    flags |= MSG_ZEROCOPY;
+                    goto send;
+                }
+#endif
+                if (iovcnt == NA_TCP_IOV_MAX)
+                    goto send;
+            }
+        }
+
+send:
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t) iovcnt;
+        nbytes = sendmsg(conn->fd, &msg, flags);
+        if (nbytes < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+#ifdef NA_TCP_HAS_ZCOPY
+            if (errno == ENOBUFS && (flags & MSG_ZEROCOPY)) {
+                /* Out of optmem for notifications, fall back to copies */
+                NA_LOG_SUBSYS_WARNING(perf, "Disabling MSG_ZEROCOPY on fd %d",
+                    conn->fd);
+                conn->zcopy = false;
+                continue;
+            }
+#endif
+            NA_GOTO_SUBSYS_ERROR(msg, error, ret, na_tcp_errno_to_na(errno),
+                "sendmsg() failed (%s)", strerror(errno));
+        }
+
+        na_tcp_conn_sent(conn, (size_t) nbytes);
+        if ((size_t) nbytes < total)
+            break; /* Socket buffer is full */
+    }
+
+    return na_tcp_conn_poll_update(
+        na_tcp_class, conn, !HG_QUEUE_IS_EMPTY(&conn->send_queue));
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_conn_sent(struct na_tcp_conn *conn, size_t len)
+{
+    while (len > 0) {
+        struct na_tcp_frame *frame = HG_QUEUE_FIRST(&conn->send_queue);
+        struct iovec *iov = &frame->iov[frame->iov_idx];
+        size_t n = (len < iov->iov_len) ? len : iov->iov_len;
+
+        iov->iov_base = (char *) iov->iov_base + n;
+        iov->iov_len -= n;
+        frame->sent += n;
+        len -= n;
+        if (iov->iov_len > 0)
+            break;
+
+        /* Skip empty iovecs */
+        while (++frame->iov_idx < frame->iovcnt &&
+               frame->iov[frame->iov_idx].iov_len == 0)
+            continue;
+        if (frame->iov_idx < frame->iovcnt)
+            continue;
+
+        HG_QUEUE_POP_HEAD(&conn->send_queue, entry);
+        frame->queued = false;
+        if (frame->op != NULL)
+            na_tcp_complete(frame->op, NA_SUCCESS);
+        else if (frame->internal)
+            free(frame);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_recv(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn)
+{
+    unsigned int i;
+    na_return_t ret;
+
+    for (i = 0; i < NA_TCP_RECV_MAX && !conn->closed; i++) {
+        struct na_tcp_rx *rx = &conn->rx;
+        ssize_t nbytes;
+
+        /* Receive large payloads in place */
+        if (rx->phase != NA_TCP_RX_HDR && rx->dest != NULL &&
+            rx->remaining >= NA_TCP_RECV_DIRECT_MIN) {
+            nbytes = recv(conn->fd, rx->dest, rx->remaining, 0);
+            if (nbytes > 0) {
+                rx->dest += nbytes;
+                rx->remaining -= (size_t) nbytes;
+                ret = na_tcp_rx_advance(na_tcp_class, conn);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    msg, error, ret, "Could not process payload");
+                continue;
+            }
+        } else {
+            nbytes = recv(conn->fd, conn->rbuf, NA_TCP_RBUF_SIZE, 0);
+            if (nbytes > 0) {
+                ret = na_tcp_conn_parse(
+                    na_tcp_class, conn, conn->rbuf, (size_t) nbytes);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    msg, error, ret, "Could not process received data");
+                continue;
+            }
+        }
+
+        if (nbytes == 0) {
+            NA_LOG_SUBSYS_DEBUG(
+                addr, "Connection %p closed by peer", (void *) conn);
+            return NA_HOSTUNREACH;
+        }
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        NA_GOTO_SUBSYS_ERROR(msg, error, ret, na_tcp_errno_to_na(errno),
+            "recv() failed (%s)", strerror(errno));
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_parse(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn,
+    const char *buf, size_t len)
+{
+    struct na_tcp_rx *rx = &conn->rx;
+    na_return_t ret;
+
+    while (len > 0 && !conn->closed) {
+        size_t n;
+
+        if (rx->phase == NA_TCP_RX_HDR) {
+            n = sizeof(rx->hdr) - rx->hdr_len;
+            if (n > len)
+                n = len;
+            memcpy((char *) &rx->hdr + rx->hdr_len, buf, n);
+            rx->hdr_len += n;
+            if (rx->hdr_len == sizeof(rx->hdr)) {
+                ret = na_tcp_rx_hdr(na_tcp_class, conn);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    msg, error, ret, "Could not process header");
+            }
+        } else {
+            n = (rx->remaining < len) ? rx->remaining : len;
+            if (rx->dest != NULL) {
+                memcpy(rx->dest, buf, n);
+                rx->dest += n;
+            }
+            rx->remaining -= n;
+            ret = na_tcp_rx_advance(na_tcp_class, conn);
+            NA_CHECK_SUBSYS_NA_ERROR(
+                msg, error, ret, "Could not process payload");
+        }
+        buf += n;
+        len -= n;
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rx_hdr(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn)
+{
+    struct na_tcp_rx *rx = &conn->rx;
+    struct na_tcp_hdr *hdr = &rx->hdr;
+    struct na_tcp_op_id *na_tcp_op_id;
+    na_return_t ret;
+
+    hdr->tag = ntohl(hdr->tag);
+    hdr->len = na_tcp_hton64(hdr->len);
+    hdr->cookie = na_tcp_hton64(hdr->cookie);
+
+    rx->phase = NA_TCP_RX_BODY;
+    rx->remaining = (size_t) hdr->len;
+    rx->dest = NULL;
+    rx->op = NULL;
+    rx->status = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(addr, conn->addr == NULL && hdr->type != NA_TCP_HELLO,
+        error, ret, NA_PROTOCOL_ERROR, "Expected hello on new connection");
+
+    switch (hdr->type) {
+        case NA_TCP_HELLO:
+            NA_CHECK_SUBSYS_ERROR(addr,
+                conn->addr != NULL || hdr->len != sizeof(struct na_tcp_hello),
+                error, ret, NA_PROTOCOL_ERROR, "Invalid hello");
+            rx->dest = (char *) &rx->sub.hello;
+            break;
+        case NA_TCP_UNEXPECTED:
+            NA_CHECK_SUBSYS_ERROR(msg,
+                hdr->len > na_tcp_class->unexpected_size_max, error, ret,
+                NA_PROTOCOL_ERROR, "Unexpected msg size too large (%" PRIu64
+                                   ")",
+                hdr->len);
+            na_tcp_op_id = HG_QUEUE_FIRST(&na_tcp_class->unexpected_op_queue);
+            if (na_tcp_op_id != NULL) {
+                HG_QUEUE_POP_HEAD(&na_tcp_class->unexpected_op_queue, entry);
+                hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+                rx->op = na_tcp_op_id;
+                /* Peer buffers may be larger than locally posted ones */
+                if (hdr->len > na_tcp_op_id->buf_size)
+                    rx->status = NA_OVERFLOW;
+                else
+                    rx->dest = (char *) na_tcp_op_id->buf;
+            } else if (hdr->len > 0) {
+                rx->buf = malloc((size_t) hdr->len);
+                NA_CHECK_SUBSYS_ERROR(msg, rx->buf == NULL, error, ret,
+                    NA_NOMEM, "Could not allocate unexpected buffer");
+                rx->dest = (char *) rx->buf;
+            }
+            break;
+        case NA_TCP_EXPECTED:
+            HG_QUEUE_FOREACH (
+                na_tcp_op_id, &na_tcp_class->expected_op_queue, entry) {
+                if (na_tcp_op_id->addr == conn->addr &&
+                    na_tcp_op_id->tag == hdr->tag)
+                    break;
+            }
+            if (na_tcp_op_id != NULL) {
+                HG_QUEUE_REMOVE(&na_tcp_class->expected_op_queue, na_tcp_op_id,
+                    na_tcp_op_id, entry);
+                hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+                rx->op = na_tcp_op_id;
+                if (hdr->len > na_tcp_op_id->buf_size)
+                    rx->status = NA_OVERFLOW;
+                else
+                    rx->dest = (char *) na_tcp_op_id->buf;
+            } else
+                NA_LOG_SUBSYS_WARNING(msg,
+                    "Dropping expected msg with tag %" PRIu32
+                    " (no matching recv posted)",
+                    hdr->tag);
+            break;
+        case NA_TCP_GET_REQ:
+        case NA_TCP_PUT:
+            NA_CHECK_SUBSYS_ERROR(rma,
+                hdr->len < sizeof(struct na_tcp_rma_req), error, ret,
+                NA_PROTOCOL_ERROR, "Invalid RMA request");
+            rx->remaining = sizeof(struct na_tcp_rma_req);
+            rx->dest = (char *) &rx->sub.rma_req;
+            break;
+        case NA_TCP_GET_RESP:
+            /* Op may have been canceled, data is then discarded */
+            na_tcp_op_id = na_tcp_rma_find(conn, hdr->cookie);
+            if (na_tcp_op_id != NULL) {
+                rx->op = na_tcp_op_id;
+                if (hdr->tag != NA_SUCCESS)
+                    rx->status = (na_return_t) hdr->tag;
+                else if (hdr->len != na_tcp_op_id->buf_size)
+                    rx->status = NA_PROTOCOL_ERROR;
+                else
+                    rx->dest = (char *) na_tcp_op_id->buf;
+            }
+            break;
+        case NA_TCP_PUT_ACK:
+            na_tcp_op_id = na_tcp_rma_find(conn, hdr->cookie);
+            if (na_tcp_op_id != NULL) {
+                rx->op = na_tcp_op_id;
+                rx->status = (na_return_t) hdr->tag;
+            }
+            break;
+        default:
+            NA_GOTO_SUBSYS_ERROR(msg, error, ret, NA_PROTOCOL_ERROR,
+                "Unknown frame type %" PRIu8, hdr->type);
+    }
+
+    return na_tcp_rx_advance(na_tcp_class, conn);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rx_advance(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn)
+{
+    struct na_tcp_rx *rx = &conn->rx;
+    struct na_tcp_op_id *na_tcp_op_id;
+    na_return_t ret;
+
+    while (rx->phase != NA_TCP_RX_HDR && rx->remaining == 0) {
+        na_tcp_op_id = rx->op;
+        rx->op = NULL;
+
+        switch (rx->hdr.type) {
+            case NA_TCP_HELLO:
+                ret = na_tcp_rx_hello(na_tcp_class, conn);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    addr, error, ret, "Could not process hello");
+                break;
+            case NA_TCP_UNEXPECTED:
+                if (na_tcp_op_id != NULL) {
+                    na_tcp_op_id->completion_data.callback_info.info
+                        .recv_unexpected = (struct na_cb_info_recv_unexpected){
+                        .actual_buf_size = (size_t) rx->hdr.len,
+                        .source = (na_addr_t *) conn->addr,
+                        .tag = (na_tag_t) rx->hdr.tag};
+                    na_tcp_addr_ref_incr(conn->addr);
+                    na_tcp_complete(na_tcp_op_id, rx->status);
+                } else {
+                    struct na_tcp_unexpected_info *info =
+                        (struct na_tcp_unexpected_info *) malloc(
+                            sizeof(*info));
+                    NA_CHECK_SUBSYS_ERROR(msg, info == NULL, error, ret,
+                        NA_NOMEM, "Could not allocate unexpected info");
+                    info->na_tcp_addr = conn->addr;
+                    na_tcp_addr_ref_incr(conn->addr);
+                    info->buf = rx->buf;
+                    info->buf_size = (size_t) rx->hdr.len;
+                    info->tag = (na_tag_t) rx->hdr.tag;
+                    rx->buf = NULL;
+                    HG_QUEUE_PUSH_TAIL(
+                        &na_tcp_class->unexpected_msg_queue, info, entry);
+                }
+                break;
+            case NA_TCP_EXPECTED:
+                if (na_tcp_op_id != NULL) {
+                    na_tcp_op_id->completion_data.callback_info.info
+                        .recv_expected = (struct na_cb_info_recv_expected){
+                        .actual_buf_size = (size_t) rx->hdr.len};
+                    na_tcp_complete(na_tcp_op_id, rx->status);
+                }
+                break;
+            case NA_TCP_GET_REQ:
+                ret = na_tcp_rx_get_req(na_tcp_class, conn);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    rma, error, ret, "Could not serve get request");
+                break;
+            case NA_TCP_PUT:
+                if (rx->phase == NA_TCP_RX_BODY) {
+                    uint64_t length;
+
+                    /* Descriptor received, data follows */
+                    length = na_tcp_hton64(rx->sub.rma_req.length);
+                    NA_CHECK_SUBSYS_ERROR(rma,
+                        length != rx->hdr.len - sizeof(struct na_tcp_rma_req),
+                        error, ret, NA_PROTOCOL_ERROR,
+                        "Invalid put length (%" PRIu64 ")", length);
+                    rx->status = na_tcp_rma_check(na_tcp_class,
+                        &rx->sub.rma_req, NA_MEM_WRITE_ONLY, &rx->dest);
+                    rx->phase = NA_TCP_RX_PUT_DATA;
+                    rx->remaining = (size_t) length;
+                    continue;
+                }
+                ret = na_tcp_reply(na_tcp_class, conn, NA_TCP_PUT_ACK,
+                    rx->status, rx->hdr.cookie, NULL, 0);
+                NA_CHECK_SUBSYS_NA_ERROR(
+                    rma, error, ret, "Could not acknowledge put");
+                break;
+            case NA_TCP_GET_RESP:
+            case NA_TCP_PUT_ACK:
+                if (na_tcp_op_id != NULL)
+                    na_tcp_complete(na_tcp_op_id, rx->status);
+                break;
+            default:
+                break;
+        }
+
+        rx->phase = NA_TCP_RX_HDR;
+        rx->hdr_len = 0;
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rx_hello(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn)
+{
+    const struct na_tcp_hello *hello = &conn->rx.sub.hello;
+    struct na_tcp_addr *na_tcp_addr;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(addr, ntohl(hello->magic) != NA_TCP_MAGIC, error,
+        ret, NA_PROTOCOL_ERROR, "Bad protocol magic on connection");
+
+    if (hello->ip != 0 || hello->port != 0) {
+        struct sockaddr_in sin = {.sin_family = AF_INET,
+            .sin_port = htons((uint16_t) ntohl(hello->port)),
+            .sin_addr.s_addr = hello->ip};
+
+        /* Returns a ref that is now owned by the connection */
+        na_tcp_addr = na_tcp_addr_map_get(na_tcp_class, &sin);
+    } else
+        na_tcp_addr = na_tcp_addr_create(na_tcp_class, NULL, false);
+    NA_CHECK_SUBSYS_ERROR(addr, na_tcp_addr == NULL, error, ret, NA_NOMEM,
+        "Could not get address of peer");
+
+    /* If we are already connected to that peer, keep using our connection
+     * for sending and only receive on that one */
+    conn->addr = na_tcp_addr;
+    if (na_tcp_addr->conn == NULL)
+        na_tcp_addr->conn = conn;
+
+    NA_LOG_SUBSYS_DEBUG(addr, "Accepted connection %p from addr %p",
+        (void *) conn, (void *) na_tcp_addr);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rx_get_req(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn)
+{
+    struct na_tcp_rx *rx = &conn->rx;
+    char *ptr = NULL;
+    na_return_t status;
+
+    /* Extra payload is not expected */
+    if (rx->hdr.len != sizeof(struct na_tcp_rma_req))
+        return NA_PROTOCOL_ERROR;
+
+    status = na_tcp_rma_check(
+        na_tcp_class, &rx->sub.rma_req, NA_MEM_READ_ONLY, &ptr);
+
+    /* Data is sent directly from registered memory */
+    return na_tcp_reply(na_tcp_class, conn, NA_TCP_GET_RESP, status,
+        rx->hdr.cookie, ptr,
+        (status == NA_SUCCESS)
+            ? (size_t) na_tcp_hton64(rx->sub.rma_req.length)
+            : 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rma_check(struct na_tcp_class *na_tcp_class,
+    const struct na_tcp_rma_req *rma_req, uint8_t access, char **ptr_p)
+{
+    uint64_t id = na_tcp_hton64(rma_req->handle_id),
+             offset = na_tcp_hton64(rma_req->offset),
+             length = na_tcp_hton64(rma_req->length);
+    struct na_tcp_mem_handle *na_tcp_mem_handle;
+
+    *ptr_p = NULL;
+
+    na_tcp_mem_handle = (struct na_tcp_mem_handle *) hg_hash_table_lookup(
+        na_tcp_class->mem_map, (hg_hash_table_key_t) &id);
+    if (na_tcp_mem_handle == NULL) {
+        NA_LOG_SUBSYS_ERROR(rma, "No memory handle with ID %" PRIu64, id);
+        return NA_INVALID_ARG;
+    }
+    if ((na_tcp_mem_handle->flags & access) == 0) {
+        NA_LOG_SUBSYS_ERROR(rma, "Memory handle %" PRIu64 " access denied", id);
+        return NA_PERMISSION;
+    }
+    if (offset > na_tcp_mem_handle->len ||
+        length > na_tcp_mem_handle->len - offset) {
+        NA_LOG_SUBSYS_ERROR(rma,
+            "RMA out of bounds (offset %" PRIu64 ", length %" PRIu64
+            ", handle length %" PRIu64 ")",
+            offset, length, na_tcp_mem_handle->len);
+        return NA_OVERFLOW;
+    }
+
+    *ptr_p = (char *) na_tcp_mem_handle->base + offset;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_tcp_op_id *
+na_tcp_rma_find(struct na_tcp_conn *conn, uint64_t cookie)
+{
+    struct na_tcp_op_id *na_tcp_op_id;
+
+    HG_QUEUE_FOREACH (na_tcp_op_id, &conn->rma_queue, entry) {
+        if (na_tcp_op_id->cookie == cookie)
+            break;
+    }
+    if (na_tcp_op_id != NULL) {
+        HG_QUEUE_REMOVE(
+            &conn->rma_queue, na_tcp_op_id, na_tcp_op_id, entry);
+        hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+    }
+
+    return na_tcp_op_id;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_reply(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn,
+    enum na_tcp_frame_type type, na_return_t status, uint64_t cookie,
+    void *data, size_t len)
+{
+    struct na_tcp_frame *frame;
+
+    frame = (struct na_tcp_frame *) calloc(1, sizeof(*frame));
+    if (frame == NULL)
+        return NA_NOMEM;
+
+    na_tcp_hdr_encode(&frame->hdr, type, (uint32_t) status, len, cookie);
+    frame->iov[0] = (struct iovec){
+        .iov_base = &frame->hdr, .iov_len = sizeof(frame->hdr)};
+    frame->iov[1] = (struct iovec){.iov_base = data, .iov_len = len};
+    frame->iovcnt = (len > 0) ? 2 : 1;
+    frame->zcopy = (len > 0);
+    frame->internal = true;
+    na_tcp_conn_enqueue(conn, frame);
+
+    return na_tcp_conn_send(na_tcp_class, conn);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_conn_errqueue(struct na_tcp_conn *conn)
+{
+    int error = 0, rc;
+    socklen_t len = sizeof(error);
+
+#ifdef NA_TCP_HAS_ZCOPY
+    /* Zero-copy completions are only consumed, data is owned by operations
+     * that complete once the peer has received it */
+    for (;;) {
+        char control[128];
+        struct msghdr msg;
+        struct cmsghdr *cmsg;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        rc = (int) recvmsg(conn->fd, &msg, MSG_ERRQUEUE);
+        if (rc < 0)
+            break;
+        for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+             cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            const struct sock_extended_err *serr =
+                (const struct sock_extended_err *) CMSG_DATA(cmsg);
+
+            if (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY && serr->ee_errno)
+                return na_tcp_errno_to_na((int) serr->ee_errno);
+        }
+    }
+#endif
+
+    rc = getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &error, &len);
+    if (rc != 0)
+        return na_tcp_errno_to_na(errno);
+
+    return (error != 0) ? na_tcp_errno_to_na(error) : NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_accept(struct na_tcp_class *na_tcp_class)
+{
+    for (;;) {
+        struct na_tcp_conn *conn;
+        bool zcopy;
+        int fd;
+
+        fd = accept(na_tcp_class->listen_fd, NULL, NULL);
+        if (fd == -1) {
+            NA_CHECK_SUBSYS_WARNING(addr,
+                errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR,
+                "accept() failed (%s)", strerror(errno));
+            break;
+        }
+
+        if (na_tcp_socket_setup(fd, &zcopy) != NA_SUCCESS) {
+            close(fd);
+            continue;
+        }
+
+        /* Peer address is known once hello is received */
+        conn = na_tcp_conn_create(na_tcp_class, fd, false, zcopy);
+        if (conn == NULL) {
+            close(fd);
+            continue;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_conn_event(struct na_tcp_class *na_tcp_class, struct na_tcp_conn *conn,
+    unsigned int events)
+{
+    na_return_t ret;
+
+    if (conn->closed)
+        return;
+
+    if (events & HG_POLLERR) {
+        ret = na_tcp_conn_errqueue(conn);
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Error on connection");
+    }
+
+    if (conn->connecting && (events & (HG_POLLOUT | HG_POLLHUP))) {
+        ret = na_tcp_conn_errqueue(conn);
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not connect");
+        conn->connecting = false;
+    }
+
+    if (events & (HG_POLLIN | HG_POLLHUP)) {
+        ret = na_tcp_conn_recv(na_tcp_class, conn);
+        if (ret == NA_HOSTUNREACH)
+            goto error; /* Closed by peer */
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not receive");
+    }
+
+    if (!conn->closed && (events & HG_POLLOUT)) {
+        ret = na_tcp_conn_send(na_tcp_class, conn);
+        NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not send");
+    }
+
+    return;
+
+error:
+    na_tcp_conn_close(na_tcp_class, conn,
+        (ret == NA_PROTOCOL_ERROR) ? NA_PROTOCOL_ERROR : NA_HOSTUNREACH);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_post(
+    struct na_tcp_class *na_tcp_class, struct na_tcp_op_id *op_id, bool rma)
+{
+    struct na_tcp_conn *conn = NULL;
+    na_return_t ret;
+
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+
+    ret = na_tcp_addr_conn(na_tcp_class, op_id->addr, &conn);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        op, unlock, ret, "Could not get connection to peer");
+
+    /* RMA completes on reply, add it first so that reply finds it */
+    if (rma) {
+        op_id->conn = conn;
+        HG_QUEUE_PUSH_TAIL(&conn->rma_queue, op_id, entry);
+        hg_atomic_or32(&op_id->status, NA_TCP_OP_QUEUED);
+    }
+    na_tcp_conn_enqueue(conn, &op_id->frame);
+
+    ret = na_tcp_conn_send(na_tcp_class, conn);
+    if (ret != NA_SUCCESS) {
+        /* Op is failed by close */
+        na_tcp_conn_close(na_tcp_class, conn, NA_HOSTUNREACH);
+        ret = NA_SUCCESS;
+    }
+
+unlock:
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+
+    if (conn != NULL) {
+        na_tcp_complete_signal(na_tcp_class);
+        na_tcp_conn_release_closed(na_tcp_class);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_send_setup(struct na_tcp_class *na_tcp_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg, const void *buf,
+    size_t buf_size, struct na_tcp_addr *na_tcp_addr, na_tag_t tag,
+    struct na_tcp_op_id *na_tcp_op_id)
+{
+    struct na_tcp_frame *frame;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg,
+        buf_size > ((cb_type == NA_CB_SEND_UNEXPECTED)
+                           ? na_tcp_class->unexpected_size_max
+                           : na_tcp_class->expected_size_max),
+        error, ret, NA_OVERFLOW, "Exceeds msg size, %zu", buf_size);
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_tcp_op_id->completion_data.callback_info.type));
+
+    NA_TCP_OP_RESET(
+        na_tcp_op_id, context, cb_type, callback, arg, na_tcp_addr);
+
+    frame = &na_tcp_op_id->frame;
+    na_tcp_hdr_encode(&frame->hdr,
+        (cb_type == NA_CB_SEND_UNEXPECTED) ? NA_TCP_UNEXPECTED
+                                           : NA_TCP_EXPECTED,
+        tag, buf_size, 0);
+    frame->iov[0] = (struct iovec){
+        .iov_base = &frame->hdr, .iov_len = sizeof(frame->hdr)};
+    frame->iov[1] = (struct iovec){
+        .iov_base = (void *) (uintptr_t) buf, .iov_len = buf_size};
+    frame->iovcnt = 2;
+    frame->op = na_tcp_op_id;
+    frame->zcopy = false;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_send(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, na_cb_t callback, void *arg, const void *buf,
+    size_t buf_size, na_addr_t *dest_addr, na_tag_t tag, na_op_id_t *op_id)
+{
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    na_return_t ret;
+
+    ret = na_tcp_msg_send_setup(NA_TCP_CLASS(na_class), context, cb_type,
+        callback, arg, buf, buf_size, (struct na_tcp_addr *) dest_addr, tag,
+        na_tcp_op_id);
+    if (ret != NA_SUCCESS)
+        return ret;
+
+    ret = na_tcp_post(NA_TCP_CLASS(na_class), na_tcp_op_id, false);
+    if (ret != NA_SUCCESS)
+        NA_TCP_OP_RELEASE(na_tcp_op_id);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_rma(na_class_t *na_class, na_context_t *context, na_cb_type_t cb_type,
+    na_cb_t callback, void *arg, na_mem_handle_t *local_mem_handle,
+    na_offset_t local_offset, na_mem_handle_t *remote_mem_handle,
+    na_offset_t remote_offset, size_t length, na_addr_t *remote_addr,
+    na_op_id_t *op_id)
+{
+    struct na_tcp_mem_handle *local = (struct na_tcp_mem_handle *)
+                                 local_mem_handle,
+                             *remote = (struct na_tcp_mem_handle *)
+                                 remote_mem_handle;
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    struct na_tcp_frame *frame;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(rma,
+        local_offset > local->len || length > local->len - local_offset, error,
+        ret, NA_OVERFLOW, "Exceeds local memory handle size");
+    NA_CHECK_SUBSYS_ERROR(rma, remote->local, error, ret, NA_INVALID_ARG,
+        "Remote memory handle was not deserialized");
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_tcp_op_id->completion_data.callback_info.type));
+
+    NA_TCP_OP_RESET(na_tcp_op_id, context, cb_type, callback, arg,
+        (struct na_tcp_addr *) remote_addr);
+    na_tcp_op_id->buf = (char *) local->base + local_offset;
+    na_tcp_op_id->buf_size = length;
+    na_tcp_op_id->cookie =
+        (uint64_t) hg_atomic_incr64(&NA_TCP_CLASS(na_class)->cookie);
+
+    /* Target validates the descriptor against its own memory handles */
+    frame = &na_tcp_op_id->frame;
+    frame->sub.rma_req =
+        (struct na_tcp_rma_req){.handle_id = na_tcp_hton64(remote->id),
+            .offset = na_tcp_hton64(remote_offset),
+            .length = na_tcp_hton64(length)};
+    frame->iov[0] = (struct iovec){
+        .iov_base = &frame->hdr, .iov_len = sizeof(frame->hdr)};
+    frame->iov[1] = (struct iovec){
+        .iov_base = &frame->sub.rma_req, .iov_len = sizeof(frame->sub)};
+    frame->iov[1].iov_len = sizeof(struct na_tcp_rma_req);
+    frame->op = NULL;
+    if (cb_type == NA_CB_PUT) {
+        na_tcp_hdr_encode(&frame->hdr, NA_TCP_PUT, 0,
+            sizeof(struct na_tcp_rma_req) + length, na_tcp_op_id->cookie);
+        frame->iov[2] = (struct iovec){
+            .iov_base = na_tcp_op_id->buf, .iov_len = length};
+        frame->iovcnt = 3;
+        frame->zcopy = true;
+    } else {
+        /* Receiver-driven, data is received in place by the initiator */
+        na_tcp_hdr_encode(&frame->hdr, NA_TCP_GET_REQ, 0,
+            sizeof(struct na_tcp_rma_req), na_tcp_op_id->cookie);
+        frame->iovcnt = 2;
+        frame->zcopy = false;
+    }
+
+    ret = na_tcp_post(NA_TCP_CLASS(na_class), na_tcp_op_id, true);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "Could not post RMA");
+
+    return NA_SUCCESS;
+
+release:
+    NA_TCP_OP_RELEASE(na_tcp_op_id);
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_tcp_complete(struct na_tcp_op_id *na_tcp_op_id, na_return_t cb_ret)
+{
+    /* Mark op id as completed before checking for cancelation */
+    if (hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_COMPLETED) &
+        NA_TCP_OP_CANCELED)
+        cb_ret = NA_CANCELED;
+
+    /* Set callback ret */
+    na_tcp_op_id->completion_data.callback_info.ret = cb_ret;
+
+    /* Add OP to NA completion queue */
+    na_cb_completion_add(na_tcp_op_id->context, &na_tcp_op_id->completion_data);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_tcp_complete_signal(struct na_tcp_class *na_tcp_class)
+{
+    /* Only needed if another thread is blocked on the poll set */
+    if (hg_atomic_get32(&na_tcp_class->waiting) > 0) {
+        int rc = hg_event_set(na_tcp_class->event_fd);
+        NA_CHECK_SUBSYS_ERROR_DONE(
+            op, rc != HG_UTIL_SUCCESS, "Could not signal completion");
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_tcp_release(void *arg)
+{
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) arg;
+
+    NA_CHECK_SUBSYS_WARNING(op,
+        na_tcp_op_id &&
+            (!(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED)),
+        "Releasing resources from an uncompleted operation");
+
+    if (na_tcp_op_id->addr) {
+        na_tcp_addr_ref_decr(na_tcp_op_id->addr);
+        na_tcp_op_id->addr = NULL;
+    }
+    na_tcp_op_id->conn = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_get_protocol_info(
+    const struct na_info *na_info, struct na_protocol_info **na_protocol_info_p)
+{
+    const char *protocol_name =
+        (na_info != NULL) ? na_info->protocol_name : NULL;
+    na_return_t ret;
+
+    if (protocol_name != NULL && strcmp(protocol_name, "tcp")) {
+        *na_protocol_info_p = NULL;
+        return NA_SUCCESS;
+    }
+
+    *na_protocol_info_p = na_protocol_info_alloc("tcp", "tcp", "sockets");
+    NA_CHECK_SUBSYS_ERROR(cls, *na_protocol_info_p == NULL, error, ret,
+        NA_NOMEM, "Could not allocate protocol info entry");
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+na_tcp_check_protocol(const char *protocol_name)
+{
+    return strcmp("tcp", protocol_name) == 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_initialize(
+    na_class_t *na_class, const struct na_info *na_info, bool listening)
+{
+    struct na_init_info na_init_info = NA_INIT_INFO_INITIALIZER;
+    struct na_tcp_class *na_tcp_class = NULL;
+    struct sockaddr_in sin = {.sin_family = AF_INET};
+    struct hg_poll_event event;
+    na_return_t ret;
+    int rc;
+
+    /* Get init info and overwrite defaults */
+    if (na_info->na_init_info)
+        na_init_info = *na_info->na_init_info;
+
+    na_tcp_class = (struct na_tcp_class *) calloc(1, sizeof(*na_tcp_class));
+    NA_CHECK_SUBSYS_ERROR(cls, na_tcp_class == NULL, error, ret, NA_NOMEM,
+        "Could not allocate NA TCP class");
+    na_class->plugin_class = (void *) na_tcp_class;
+    na_tcp_class->na_class = na_class;
+    na_tcp_class->listen_fd = -1;
+    na_tcp_class->event_fd = -1;
+    HG_LIST_INIT(&na_tcp_class->conns);
+    HG_LIST_INIT(&na_tcp_class->closed_conns);
+    HG_QUEUE_INIT(&na_tcp_class->unexpected_op_queue);
+    HG_QUEUE_INIT(&na_tcp_class->expected_op_queue);
+    HG_QUEUE_INIT(&na_tcp_class->unexpected_msg_queue);
+    hg_atomic_init64(&na_tcp_class->cookie, 0);
+    hg_atomic_init32(&na_tcp_class->waiting, 0);
+    na_tcp_class->unexpected_size_max = (na_init_info.max_unexpected_size > 0)
+                                            ? na_init_info.max_unexpected_size
+                                            : NA_TCP_MSG_SIZE;
+    na_tcp_class->expected_size_max = (na_init_info.max_expected_size > 0)
+                                          ? na_init_info.max_expected_size
+                                          : NA_TCP_MSG_SIZE;
+
+    rc = hg_thread_mutex_init(&na_tcp_class->lock);
+    NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+        "hg_thread_mutex_init() failed");
+
+    na_tcp_class->addr_map =
+        hg_hash_table_new(na_tcp_key_hash, na_tcp_key_equal);
+    NA_CHECK_SUBSYS_ERROR(cls, na_tcp_class->addr_map == NULL, error, ret,
+        NA_NOMEM, "Could not allocate address map");
+    na_tcp_class->mem_map =
+        hg_hash_table_new(na_tcp_key_hash, na_tcp_key_equal);
+    NA_CHECK_SUBSYS_ERROR(cls, na_tcp_class->mem_map == NULL, error, ret,
+        NA_NOMEM, "Could not allocate memory handle map");
+
+    na_tcp_class->poll_set = hg_poll_create();
+    NA_CHECK_SUBSYS_ERROR(cls, na_tcp_class->poll_set == NULL, error, ret,
+        NA_NOMEM, "Could not create poll set");
+
+    na_tcp_class->event_fd = hg_event_create();
+    NA_CHECK_SUBSYS_ERROR(cls, na_tcp_class->event_fd == -1, error, ret,
+        NA_NOMEM, "Could not create event");
+    event.events = HG_POLLIN;
+    event.data.ptr = &na_tcp_event_token_g;
+    rc = hg_poll_add(na_tcp_class->poll_set, na_tcp_class->event_fd, &event);
+    NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret,
+        NA_PROTOCOL_ERROR, "Could not add event to poll set");
+
+    if (listening) {
+        char *hostname = NULL, *port_str = NULL;
+        struct sockaddr *sa = NULL;
+        socklen_t salen = 0;
+        uint16_t port = 0;
+        bool zcopy;
+        int one = 1;
+
+        /* Host string is [<ifname or host>][:<port>] */
+        if (na_info->host_name != NULL) {
+            hostname = strdup(na_info->host_name);
+            NA_CHECK_SUBSYS_ERROR(cls, hostname == NULL, error, ret, NA_NOMEM,
+                "strdup() of hostname failed");
+            port_str = strchr(hostname, ':');
+            if (port_str != NULL) {
+                *port_str++ = '\0';
+                port = (uint16_t) (strtoul(port_str, NULL, 10) & 0xffff);
+            }
+        }
+
+        if (hostname != NULL && hostname[0] != '\0' &&
+            strcmp(hostname, "0.0.0.0") != 0)
+            ret = na_ip_check_interface(
+                hostname, port, AF_INET, NULL, &sa, &salen);
+        else {
+            char pref_anyip[NI_MAXHOST];
+            uint32_t subnet = 0, netmask = 0;
+
+            ret = NA_SUCCESS;
+            if (na_init_info.ip_subnet)
+                ret = na_ip_parse_subnet(
+                    na_init_info.ip_subnet, &subnet, &netmask);
+            if (ret == NA_SUCCESS)
+                ret = na_ip_pref_addr(subnet, netmask, pref_anyip);
+            if (ret == NA_SUCCESS)
+                ret = na_ip_check_interface(
+                    pref_anyip, port, AF_INET, NULL, &sa, &salen);
+        }
+        free(hostname);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            cls, error, ret, "Could not resolve listening address");
+        memcpy(&sin, sa, sizeof(sin));
+        free(sa);
+
+        na_tcp_class->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        NA_CHECK_SUBSYS_ERROR(cls, na_tcp_class->listen_fd == -1, error, ret,
+            na_tcp_errno_to_na(errno), "socket() failed (%s)",
+            strerror(errno));
+        (void) setsockopt(na_tcp_class->listen_fd, SOL_SOCKET, SO_REUSEADDR,
+            &one, sizeof(one));
+        ret = na_tcp_socket_setup(na_tcp_class->listen_fd, &zcopy);
+        NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not setup socket");
+
+        rc = bind(na_tcp_class->listen_fd, (struct sockaddr *) &sin,
+            sizeof(sin));
+        NA_CHECK_SUBSYS_ERROR(cls, rc != 0, error, ret,
+            na_tcp_errno_to_na(errno), "bind() failed (%s)", strerror(errno));
+        rc = getsockname(na_tcp_class->listen_fd, (struct sockaddr *) &sin,
+            &(socklen_t){sizeof(sin)});
+        NA_CHECK_SUBSYS_ERROR(cls, rc != 0, error, ret,
+            na_tcp_errno_to_na(errno), "getsockname() failed (%s)",
+            strerror(errno));
+        rc = listen(na_tcp_class->listen_fd, NA_TCP_LISTEN_BACKLOG);
+        NA_CHECK_SUBSYS_ERROR(cls, rc != 0, error, ret,
+            na_tcp_errno_to_na(errno), "listen() failed (%s)",
+            strerror(errno));
+
+        event.events = HG_POLLIN;
+        event.data.ptr = &na_tcp_listen_token_g;
+        rc = hg_poll_add(
+            na_tcp_class->poll_set, na_tcp_class->listen_fd, &event);
+        NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret,
+            NA_PROTOCOL_ERROR, "Could not add listening socket to poll set");
+    }
+
+    /* Self address is anonymous if not listening */
+    na_tcp_class->self_addr =
+        na_tcp_addr_create(na_tcp_class, listening ? &sin : NULL, true);
+    NA_CHECK_SUBSYS_ERROR(cls, na_tcp_class->self_addr == NULL, error, ret,
+        NA_NOMEM, "Could not create self address");
+    if (listening) {
+        /* Loopback connections resolve to self */
+        rc = hg_hash_table_insert(na_tcp_class->addr_map,
+            (hg_hash_table_key_t) &na_tcp_class->self_addr->key,
+            (hg_hash_table_value_t) na_tcp_class->self_addr);
+        NA_CHECK_SUBSYS_ERROR(cls, rc == 0, error, ret, NA_NOMEM,
+            "hg_hash_table_insert() failed");
+        na_tcp_class->self_addr->in_map = true;
+    }
+
+    return NA_SUCCESS;
+
+error:
+    if (na_tcp_class != NULL)
+        (void) na_tcp_finalize(na_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_finalize(na_class_t *na_class)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_unexpected_info *info;
+    struct na_tcp_conn *conn;
+
+    if (na_tcp_class == NULL)
+        return NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_WARNING(cls,
+        !HG_QUEUE_IS_EMPTY(&na_tcp_class->unexpected_op_queue) ||
+            !HG_QUEUE_IS_EMPTY(&na_tcp_class->expected_op_queue),
+        "Operations are still posted");
+
+    /* Close connections without notifying the upper layer */
+    if (na_tcp_class->poll_set != NULL) {
+        hg_thread_mutex_lock(&na_tcp_class->lock);
+        while ((conn = HG_LIST_FIRST(&na_tcp_class->conns)) != NULL)
+            na_tcp_conn_close(na_tcp_class, conn, NA_SUCCESS);
+        hg_thread_mutex_unlock(&na_tcp_class->lock);
+        na_tcp_conn_release_closed(na_tcp_class);
+    }
+
+    while ((info = HG_QUEUE_FIRST(&na_tcp_class->unexpected_msg_queue)) !=
+           NULL) {
+        HG_QUEUE_POP_HEAD(&na_tcp_class->unexpected_msg_queue, entry);
+        na_tcp_addr_ref_decr(info->na_tcp_addr);
+        free(info->buf);
+        free(info);
+    }
+
+    if (na_tcp_class->self_addr != NULL)
+        na_tcp_addr_ref_decr(na_tcp_class->self_addr);
+
+    if (na_tcp_class->addr_map != NULL) {
+        NA_CHECK_SUBSYS_WARNING(cls,
+            hg_hash_table_num_entries(na_tcp_class->addr_map) > 0,
+            "%u address(es) were not freed",
+            hg_hash_table_num_entries(na_tcp_class->addr_map));
+        hg_hash_table_free(na_tcp_class->addr_map);
+    }
+    if (na_tcp_class->mem_map != NULL)
+        hg_hash_table_free(na_tcp_class->mem_map);
+
+    if (na_tcp_class->listen_fd != -1) {
+        (void) hg_poll_remove(na_tcp_class->poll_set, na_tcp_class->listen_fd);
+        close(na_tcp_class->listen_fd);
+    }
+    if (na_tcp_class->event_fd != -1) {
+        (void) hg_poll_remove(na_tcp_class->poll_set, na_tcp_class->event_fd);
+        (void) hg_event_destroy(na_tcp_class->event_fd);
+    }
+    if (na_tcp_class->poll_set != NULL)
+        (void) hg_poll_destroy(na_tcp_class->poll_set);
+
+    (void) hg_thread_mutex_destroy(&na_tcp_class->lock);
+    free(na_tcp_class);
+    na_class->plugin_class = NULL;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_op_id_t *
+na_tcp_op_create(na_class_t *na_class, unsigned long NA_UNUSED flags)
+{
+    struct na_tcp_op_id *na_tcp_op_id;
+
+    na_tcp_op_id = (struct na_tcp_op_id *) calloc(1, sizeof(*na_tcp_op_id));
+    NA_CHECK_SUBSYS_ERROR_NORET(op, na_tcp_op_id == NULL, done,
+        "Could not allocate NA TCP operation ID");
+
+    na_tcp_op_id->na_class = na_class;
+
+    /* Completed by default */
+    hg_atomic_init32(&na_tcp_op_id->status, NA_TCP_OP_COMPLETED);
+
+    /* Set op ID release callbacks */
+    na_tcp_op_id->completion_data.plugin_callback = na_tcp_release;
+    na_tcp_op_id->completion_data.plugin_callback_args = na_tcp_op_id;
+
+done:
+    return (na_op_id_t *) na_tcp_op_id;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+{
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+
+    NA_CHECK_SUBSYS_WARNING(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED),
+        "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_tcp_op_id->completion_data.callback_info.type));
+
+    free(na_tcp_op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_op_reset(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+{
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+
+    if (!(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED))
+        return NA_BUSY;
+
+    /* Addr ref was dropped on release, only clear stale user data */
+    na_tcp_op_id->context = NULL;
+    na_tcp_op_id->completion_data.callback = NULL;
+    na_tcp_op_id->completion_data.callback_info.arg = NULL;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_addr *na_tcp_addr;
+    struct sockaddr_in sin;
+    struct sockaddr *sa = NULL;
+    socklen_t salen = 0;
+    char host[NA_TCP_ADDR_NAME_MAX], *port_str;
+    const char *locator;
+    unsigned long port;
+    na_return_t ret;
+
+    /* Name is [tcp://]<host>:<port> */
+    locator = strstr(name, "://");
+    locator = (locator == NULL) ? name : locator + 3;
+    NA_CHECK_SUBSYS_ERROR(addr, strlen(locator) >= sizeof(host), error, ret,
+        NA_INVALID_ARG, "Address name too long (%s)", name);
+    strcpy(host, locator);
+    port_str = strrchr(host, ':');
+    NA_CHECK_SUBSYS_ERROR(addr, port_str == NULL, error, ret, NA_INVALID_ARG,
+        "No port in address name (%s)", name);
+    *port_str++ = '\0';
+    port = strtoul(port_str, NULL, 10);
+    if (port == 0 && strcmp(host, "0.0.0.0") == 0 &&
+        na_tcp_class->self_addr->key == 0) {
+        /* Anonymous self address (see na_tcp_addr_to_string()) */
+        na_tcp_addr_ref_incr(na_tcp_class->self_addr);
+        *addr_p = (na_addr_t *) na_tcp_class->self_addr;
+
+        return NA_SUCCESS;
+    }
+    NA_CHECK_SUBSYS_ERROR(addr, port == 0 || port > UINT16_MAX, error, ret,
+        NA_INVALID_ARG, "Invalid port in address name (%s)", name);
+
+    ret = na_ip_check_interface(
+        host, (uint16_t) port, AF_INET, NULL, &sa, &salen);
+    NA_CHECK_SUBSYS_NA_ERROR(addr, error, ret, "Could not resolve %s", host);
+    memcpy(&sin, sa, sizeof(sin));
+    free(sa);
+
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+    na_tcp_addr = na_tcp_addr_map_get(na_tcp_class, &sin);
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+    NA_CHECK_SUBSYS_ERROR(addr, na_tcp_addr == NULL, error, ret, NA_NOMEM,
+        "Could not get address for %s", name);
+
+    *addr_p = (na_addr_t *) na_tcp_addr;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_addr_free(na_class_t NA_UNUSED *na_class, na_addr_t *addr)
+{
+    na_tcp_addr_ref_decr((struct na_tcp_addr *) addr);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_set_remove(na_class_t *na_class, na_addr_t *addr)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_addr *na_tcp_addr = (struct na_tcp_addr *) addr;
+    struct na_tcp_conn *conn, *next;
+
+    /* Drop all connections to that peer, a new one is opened on next send */
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+    for (conn = HG_LIST_FIRST(&na_tcp_class->conns); conn != NULL;
+         conn = next) {
+        next = HG_LIST_NEXT(conn, entry);
+        if (conn->addr == na_tcp_addr)
+            na_tcp_conn_close(na_tcp_class, conn, NA_SUCCESS);
+    }
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+
+    na_tcp_conn_release_closed(na_tcp_class);
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_self(na_class_t *na_class, na_addr_t **addr_p)
+{
+    struct na_tcp_addr *na_tcp_addr = NA_TCP_CLASS(na_class)->self_addr;
+
+    na_tcp_addr_ref_incr(na_tcp_addr);
+    *addr_p = (na_addr_t *) na_tcp_addr;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_dup(
+    na_class_t NA_UNUSED *na_class, na_addr_t *addr, na_addr_t **new_addr_p)
+{
+    na_tcp_addr_ref_incr((struct na_tcp_addr *) addr);
+    *new_addr_p = addr;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+na_tcp_addr_cmp(
+    na_class_t NA_UNUSED *na_class, na_addr_t *addr1, na_addr_t *addr2)
+{
+    struct na_tcp_addr *na_tcp_addr1 = (struct na_tcp_addr *) addr1,
+                       *na_tcp_addr2 = (struct na_tcp_addr *) addr2;
+
+    return (na_tcp_addr1 == na_tcp_addr2) ||
+           (na_tcp_addr1->key != 0 && na_tcp_addr1->key == na_tcp_addr2->key);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE bool
+na_tcp_addr_is_self(na_class_t NA_UNUSED *na_class, na_addr_t *addr)
+{
+    return ((struct na_tcp_addr *) addr)->self;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_to_string(na_class_t NA_UNUSED *na_class, char *buf,
+    size_t *buf_size, na_addr_t *addr)
+{
+    struct na_tcp_addr *na_tcp_addr = (struct na_tcp_addr *) addr;
+    char addr_string[NA_TCP_ADDR_NAME_MAX], ip[INET_ADDRSTRLEN];
+    size_t string_len;
+    na_return_t ret;
+    int rc;
+
+    /* Self address of a class that does not listen is tcp://0.0.0.0:0 */
+    NA_CHECK_SUBSYS_ERROR(addr, na_tcp_addr->key == 0 && !na_tcp_addr->self,
+        error, ret, NA_OPNOTSUPPORTED,
+        "Cannot convert anonymous address to string");
+
+    NA_CHECK_SUBSYS_ERROR(addr,
+        inet_ntop(AF_INET, &na_tcp_addr->sin.sin_addr, ip, sizeof(ip)) == NULL,
+        error, ret, NA_PROTOCOL_ERROR, "inet_ntop() failed (%s)",
+        strerror(errno));
+    rc = snprintf(addr_string, sizeof(addr_string), "tcp://%s:%" PRIu16, ip,
+        ntohs(na_tcp_addr->sin.sin_port));
+    NA_CHECK_SUBSYS_ERROR(addr, rc < 0 || rc >= (int) sizeof(addr_string),
+        error, ret, NA_OVERFLOW, "snprintf() failed, rc: %d", rc);
+
+    string_len = strlen(addr_string);
+    if (buf) {
+        NA_CHECK_SUBSYS_ERROR(addr, string_len >= *buf_size, error, ret,
+            NA_OVERFLOW, "Buffer size too small to copy addr");
+        strcpy(buf, addr_string);
+    }
+    *buf_size = string_len + 1;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE size_t
+na_tcp_addr_get_serialize_size(
+    na_class_t NA_UNUSED *na_class, na_addr_t NA_UNUSED *addr)
+{
+    return sizeof(uint64_t);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_serialize(na_class_t NA_UNUSED *na_class, void *buf,
+    size_t buf_size, na_addr_t *addr)
+{
+    struct na_tcp_addr *na_tcp_addr = (struct na_tcp_addr *) addr;
+    char *buf_ptr = (char *) buf;
+    size_t buf_size_left = buf_size;
+    uint64_t key = na_tcp_hton64(na_tcp_addr->key);
+    na_return_t ret;
+
+    /* Self address of a class that does not listen is sent as key 0, it can
+     * only be resolved back by that class (see na_tcp_addr_deserialize()) */
+    NA_CHECK_SUBSYS_ERROR(addr, na_tcp_addr->key == 0 && !na_tcp_addr->self,
+        error, ret, NA_OPNOTSUPPORTED, "Cannot serialize anonymous address");
+
+    NA_ENCODE(error, ret, buf_ptr, buf_size_left, &key, uint64_t);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_addr_deserialize(na_class_t *na_class, na_addr_t **addr_p,
+    const void *buf, size_t buf_size)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_addr *na_tcp_addr;
+    const char *buf_ptr = (const char *) buf;
+    size_t buf_size_left = buf_size;
+    struct sockaddr_in sin = {.sin_family = AF_INET};
+    uint64_t key;
+    na_return_t ret;
+
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &key, uint64_t);
+    key = na_tcp_hton64(key);
+    if (key == 0) {
+        /* Peers that do not listen cannot reach each other, key 0 is
+         * therefore our own anonymous self address */
+        NA_CHECK_SUBSYS_ERROR(addr, na_tcp_class->self_addr->key != 0, error,
+            ret, NA_OPNOTSUPPORTED, "Cannot deserialize anonymous address");
+        na_tcp_addr_ref_incr(na_tcp_class->self_addr);
+        *addr_p = (na_addr_t *) na_tcp_class->self_addr;
+
+        return NA_SUCCESS;
+    }
+    sin.sin_addr.s_addr = htonl((uint32_t) (key >> 16));
+    sin.sin_port = htons((uint16_t) (key & 0xffff));
+
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+    na_tcp_addr = na_tcp_addr_map_get(na_tcp_class, &sin);
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+    NA_CHECK_SUBSYS_ERROR(addr, na_tcp_addr == NULL, error, ret, NA_NOMEM,
+        "Could not get address");
+
+    *addr_p = (na_addr_t *) na_tcp_addr;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE size_t
+na_tcp_msg_get_max_unexpected_size(const na_class_t *na_class)
+{
+    return NA_TCP_CLASS(na_class)->unexpected_size_max;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE size_t
+na_tcp_msg_get_max_expected_size(const na_class_t *na_class)
+{
+    return NA_TCP_CLASS(na_class)->expected_size_max;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_tag_t
+na_tcp_msg_get_max_tag(const na_class_t NA_UNUSED *na_class)
+{
+    return NA_TCP_MAX_TAG;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t *dest_addr,
+    uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    return na_tcp_msg_send(na_class, context, NA_CB_SEND_UNEXPECTED, callback,
+        arg, buf, buf_size, dest_addr, tag, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, size_t buf_size,
+    void NA_UNUSED *plugin_data, na_op_id_t *op_id)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    struct na_tcp_unexpected_info *info;
+    na_return_t ret, cb_ret = NA_SUCCESS;
+
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > na_tcp_class->unexpected_size_max,
+        error, ret, NA_OVERFLOW, "Exceeds unexpected size, %zu", buf_size);
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_tcp_op_id->completion_data.callback_info.type));
+
+    NA_TCP_OP_RESET(
+        na_tcp_op_id, context, NA_CB_RECV_UNEXPECTED, callback, arg, NULL);
+    na_tcp_op_id->completion_data.callback_info.info.recv_unexpected =
+        (struct na_cb_info_recv_unexpected){
+            .actual_buf_size = 0, .source = NULL, .tag = 0};
+    na_tcp_op_id->buf = buf;
+    na_tcp_op_id->buf_size = buf_size;
+
+    /* Look for an unexpected message already received */
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+    info = HG_QUEUE_FIRST(&na_tcp_class->unexpected_msg_queue);
+    if (info != NULL)
+        HG_QUEUE_POP_HEAD(&na_tcp_class->unexpected_msg_queue, entry);
+    else {
+        HG_QUEUE_PUSH_TAIL(
+            &na_tcp_class->unexpected_op_queue, na_tcp_op_id, entry);
+        hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_QUEUED);
+    }
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+
+    if (info != NULL) {
+        /* Addr ref of info is given to the user */
+        na_tcp_op_id->completion_data.callback_info.info.recv_unexpected =
+            (struct na_cb_info_recv_unexpected){
+                .actual_buf_size = info->buf_size,
+                .source = (na_addr_t *) info->na_tcp_addr,
+                .tag = info->tag};
+        if (info->buf_size > buf_size)
+            cb_ret = NA_OVERFLOW;
+        else if (info->buf_size > 0)
+            memcpy(buf, info->buf, info->buf_size);
+        free(info->buf);
+        free(info);
+
+        na_tcp_complete(na_tcp_op_id, cb_ret);
+        na_tcp_complete_signal(na_tcp_class);
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_send_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t *dest_addr,
+    uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    return na_tcp_msg_send(na_class, context, NA_CB_SEND_EXPECTED, callback,
+        arg, buf, buf_size, dest_addr, tag, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_recv_expected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t *source_addr,
+    uint8_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size > na_tcp_class->expected_size_max,
+        error, ret, NA_OVERFLOW, "Exceeds expected size, %zu", buf_size);
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_tcp_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_tcp_op_id->completion_data.callback_info.type));
+
+    NA_TCP_OP_RESET(na_tcp_op_id, context, NA_CB_RECV_EXPECTED, callback, arg,
+        (struct na_tcp_addr *) source_addr);
+    na_tcp_op_id->buf = buf;
+    na_tcp_op_id->buf_size = buf_size;
+    na_tcp_op_id->tag = tag;
+
+    /* Expected messages must always be pre-posted */
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+    HG_QUEUE_PUSH_TAIL(&na_tcp_class->expected_op_queue, na_tcp_op_id, entry);
+    hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_QUEUED);
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_msg_send_batch(na_class_t *na_class, na_context_t *context,
+    na_cb_type_t cb_type, const struct na_msg_send_info *send_infos,
+    size_t count, size_t *posted_count_p)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_conn *conn = NULL;
+    na_return_t ret = NA_SUCCESS;
+    size_t i;
+
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+
+    /* Queue all frames of a connection before sending them, consecutive
+     * entries to the same peer are sent with a single sendmsg() */
+    for (i = 0; i < count; i++) {
+        const struct na_msg_send_info *send_info = &send_infos[i];
+        struct na_tcp_op_id *na_tcp_op_id =
+            (struct na_tcp_op_id *) send_info->op_id;
+        struct na_tcp_conn *next_conn = NULL;
+
+        ret = na_tcp_msg_send_setup(na_tcp_class, context, cb_type,
+            send_info->callback, send_info->arg, send_info->buf,
+            send_info->buf_size, (struct na_tcp_addr *) send_info->dest_addr,
+            send_info->tag, na_tcp_op_id);
+        if (ret != NA_SUCCESS)
+            break;
+
+        ret = na_tcp_addr_conn(na_tcp_class, na_tcp_op_id->addr, &next_conn);
+        if (ret != NA_SUCCESS) {
+            NA_TCP_OP_RELEASE(na_tcp_op_id);
+            break;
+        }
+
+        if (conn != NULL && conn != next_conn &&
+            na_tcp_conn_send(na_tcp_class, conn) != NA_SUCCESS)
+            na_tcp_conn_close(na_tcp_class, conn, NA_HOSTUNREACH);
+        conn = next_conn;
+        na_tcp_conn_enqueue(conn, &na_tcp_op_id->frame);
+    }
+    if (conn != NULL && na_tcp_conn_send(na_tcp_class, conn) != NA_SUCCESS)
+        na_tcp_conn_close(na_tcp_class, conn, NA_HOSTUNREACH);
+
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+
+    if (i > 0) {
+        na_tcp_complete_signal(na_tcp_class);
+        na_tcp_conn_release_closed(na_tcp_class);
+    }
+    if (posted_count_p != NULL)
+        *posted_count_p = i;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_handle_create(na_class_t *na_class, void *buf, size_t buf_size,
+    unsigned long flags, na_mem_handle_t **mem_handle_p)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_mem_handle *na_tcp_mem_handle;
+    na_return_t ret;
+    int rc;
+
+    na_tcp_mem_handle =
+        (struct na_tcp_mem_handle *) calloc(1, sizeof(*na_tcp_mem_handle));
+    NA_CHECK_SUBSYS_ERROR(mem, na_tcp_mem_handle == NULL, error, ret,
+        NA_NOMEM, "Could not allocate NA TCP memory handle");
+    na_tcp_mem_handle->base = (uint64_t) (uintptr_t) buf;
+    na_tcp_mem_handle->len = (uint64_t) buf_size;
+    na_tcp_mem_handle->flags = (uint8_t) (flags & 0xff);
+    na_tcp_mem_handle->local = true;
+
+    /* Remote RMAs may only target memory of registered handles */
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+    na_tcp_mem_handle->id = ++na_tcp_class->mem_id;
+    rc = hg_hash_table_insert(na_tcp_class->mem_map,
+        (hg_hash_table_key_t) &na_tcp_mem_handle->id,
+        (hg_hash_table_value_t) na_tcp_mem_handle);
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+    NA_CHECK_SUBSYS_ERROR(mem, rc == 0, error, ret, NA_NOMEM,
+        "hg_hash_table_insert() failed");
+
+    *mem_handle_p = (na_mem_handle_t *) na_tcp_mem_handle;
+
+    return NA_SUCCESS;
+
+error:
+    free(na_tcp_mem_handle);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_tcp_mem_handle_free(na_class_t *na_class, na_mem_handle_t *mem_handle)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_mem_handle *na_tcp_mem_handle =
+        (struct na_tcp_mem_handle *) mem_handle;
+
+    if (na_tcp_mem_handle->local) {
+        hg_thread_mutex_lock(&na_tcp_class->lock);
+        hg_hash_table_remove(na_tcp_class->mem_map,
+            (hg_hash_table_key_t) &na_tcp_mem_handle->id);
+        hg_thread_mutex_unlock(&na_tcp_class->lock);
+    }
+    free(na_tcp_mem_handle);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE size_t
+na_tcp_mem_handle_get_serialize_size(
+    na_class_t NA_UNUSED *na_class, na_mem_handle_t NA_UNUSED *mem_handle)
+{
+    return 3 * sizeof(uint64_t) + sizeof(uint8_t);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_handle_serialize(na_class_t NA_UNUSED *na_class, void *buf,
+    size_t buf_size, na_mem_handle_t *mem_handle)
+{
+    struct na_tcp_mem_handle *na_tcp_mem_handle =
+        (struct na_tcp_mem_handle *) mem_handle;
+    char *buf_ptr = (char *) buf;
+    size_t buf_size_left = buf_size;
+    uint64_t id = na_tcp_hton64(na_tcp_mem_handle->id),
+             base = na_tcp_hton64(na_tcp_mem_handle->base),
+             len = na_tcp_hton64(na_tcp_mem_handle->len);
+    na_return_t ret = NA_SUCCESS;
+
+    NA_ENCODE(done, ret, buf_ptr, buf_size_left, &id, uint64_t);
+    NA_ENCODE(done, ret, buf_ptr, buf_size_left, &base, uint64_t);
+    NA_ENCODE(done, ret, buf_ptr, buf_size_left, &len, uint64_t);
+    NA_ENCODE(done, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->flags,
+        uint8_t);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
+    na_mem_handle_t **mem_handle_p, const void *buf, size_t buf_size)
+{
+    struct na_tcp_mem_handle *na_tcp_mem_handle;
+    const char *buf_ptr = (const char *) buf;
+    size_t buf_size_left = buf_size;
+    na_return_t ret;
+
+    na_tcp_mem_handle =
+        (struct na_tcp_mem_handle *) calloc(1, sizeof(*na_tcp_mem_handle));
+    NA_CHECK_SUBSYS_ERROR(mem, na_tcp_mem_handle == NULL, error, ret,
+        NA_NOMEM, "Could not allocate NA TCP memory handle");
+
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->id,
+        uint64_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->base,
+        uint64_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->len,
+        uint64_t);
+    NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_tcp_mem_handle->flags,
+        uint8_t);
+    na_tcp_mem_handle->id = na_tcp_hton64(na_tcp_mem_handle->id);
+    na_tcp_mem_handle->base = na_tcp_hton64(na_tcp_mem_handle->base);
+    na_tcp_mem_handle->len = na_tcp_hton64(na_tcp_mem_handle->len);
+    na_tcp_mem_handle->local = false;
+
+    *mem_handle_p = (na_mem_handle_t *) na_tcp_mem_handle;
+
+    return NA_SUCCESS;
+
+error:
+    free(na_tcp_mem_handle);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t *local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    size_t length, na_addr_t *remote_addr, uint8_t NA_UNUSED remote_id,
+    na_op_id_t *op_id)
+{
+    return na_tcp_rma(na_class, context, NA_CB_PUT, callback, arg,
+        local_mem_handle, local_offset, remote_mem_handle, remote_offset,
+        length, remote_addr, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_mem_handle_t *local_mem_handle, na_offset_t local_offset,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    size_t length, na_addr_t *remote_addr, uint8_t NA_UNUSED remote_id,
+    na_op_id_t *op_id)
+{
+    return na_tcp_rma(na_class, context, NA_CB_GET, callback, arg,
+        local_mem_handle, local_offset, remote_mem_handle, remote_offset,
+        length, remote_addr, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+na_tcp_poll_get_fd(na_class_t *na_class, na_context_t NA_UNUSED *context)
+{
+    int fd = hg_poll_get_fd(NA_TCP_CLASS(na_class)->poll_set);
+
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        poll, fd == -1, done, "Could not get poll fd from poll set");
+
+done:
+    return fd;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_progress(
+    na_class_t *na_class, na_context_t NA_UNUSED *context, unsigned int timeout)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    hg_time_t deadline, now = hg_time_from_ms(0);
+    na_return_t ret;
+
+    if (timeout != 0)
+        hg_time_get_current_ms(&now);
+    deadline = hg_time_add(now, hg_time_from_ms(timeout));
+
+    do {
+        struct hg_poll_event events[NA_TCP_MAX_EVENTS];
+        unsigned int nevents = 0, i;
+        int rc;
+
+        hg_atomic_incr32(&na_tcp_class->waiting);
+        rc = hg_poll_wait(na_tcp_class->poll_set,
+            hg_time_to_ms(hg_time_subtract(deadline, now)), NA_TCP_MAX_EVENTS,
+            events, &nevents);
+        hg_atomic_decr32(&na_tcp_class->waiting);
+        NA_CHECK_SUBSYS_ERROR(poll, rc != HG_UTIL_SUCCESS, error, ret,
+            NA_PROTOCOL_ERROR, "hg_poll_wait() failed");
+
+        if (nevents == 1 && (events[0].events & HG_POLLINTR))
+            nevents = 0;
+
+        hg_thread_mutex_lock(&na_tcp_class->lock);
+        for (i = 0; i < nevents; i++) {
+            if (events[i].data.ptr == &na_tcp_listen_token_g)
+                na_tcp_accept(na_tcp_class);
+            else if (events[i].data.ptr == &na_tcp_event_token_g) {
+                bool signaled;
+                (void) hg_event_get(na_tcp_class->event_fd, &signaled);
+            } else
+                na_tcp_conn_event(na_tcp_class,
+                    (struct na_tcp_conn *) events[i].data.ptr,
+                    events[i].events);
+        }
+        hg_thread_mutex_unlock(&na_tcp_class->lock);
+
+        na_tcp_conn_release_closed(na_tcp_class);
+
+        if (nevents > 0)
+            return NA_SUCCESS;
+
+        if (timeout != 0)
+            hg_time_get_current_ms(&now);
+    } while (hg_time_less(now, deadline));
+
+    return NA_TIMEOUT;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_tcp_cancel(
+    na_class_t *na_class, na_context_t NA_UNUSED *context, na_op_id_t *op_id)
+{
+    struct na_tcp_class *na_tcp_class = NA_TCP_CLASS(na_class);
+    struct na_tcp_op_id *na_tcp_op_id = (struct na_tcp_op_id *) op_id;
+    struct na_tcp_frame *frame = &na_tcp_op_id->frame;
+    bool canceled = false;
+    int32_t status;
+
+    /* Exit if op has already completed */
+    status = hg_atomic_get32(&na_tcp_op_id->status);
+    if ((status & NA_TCP_OP_COMPLETED) || (status & NA_TCP_OP_CANCELED))
+        return NA_SUCCESS;
+
+    NA_LOG_SUBSYS_DEBUG(op, "Canceling operation ID %p (%s)",
+        (void *) na_tcp_op_id,
+        na_cb_type_to_string(na_tcp_op_id->completion_data.callback_info.type));
+
+    hg_thread_mutex_lock(&na_tcp_class->lock);
+    if (hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_COMPLETED)
+        goto unlock;
+
+    switch (na_tcp_op_id->completion_data.callback_info.type) {
+        case NA_CB_RECV_UNEXPECTED:
+            if (hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_QUEUED) {
+                HG_QUEUE_REMOVE(&na_tcp_class->unexpected_op_queue,
+                    na_tcp_op_id, na_tcp_op_id, entry);
+                canceled = true;
+            }
+            break;
+        case NA_CB_RECV_EXPECTED:
+            if (hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_QUEUED) {
+                HG_QUEUE_REMOVE(&na_tcp_class->expected_op_queue,
+                    na_tcp_op_id, na_tcp_op_id, entry);
+                canceled = true;
+            }
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+        case NA_CB_SEND_EXPECTED:
+        case NA_CB_PUT:
+        case NA_CB_GET:
+            /* Partially sent frames must go through to keep the stream in
+             * sync, RMA replies of canceled ops are discarded */
+            if (frame->queued && frame->sent > 0)
+                break;
+            if (frame->queued && na_tcp_op_id->addr->conn != NULL) {
+                HG_QUEUE_REMOVE(&na_tcp_op_id->addr->conn->send_queue, frame,
+                    na_tcp_frame, entry);
+                frame->queued = false;
+            }
+            if (hg_atomic_get32(&na_tcp_op_id->status) & NA_TCP_OP_QUEUED)
+                HG_QUEUE_REMOVE(&na_tcp_op_id->conn->rma_queue, na_tcp_op_id,
+                    na_tcp_op_id, entry);
+            canceled = !frame->queued;
+            break;
+        default:
+            break;
+    }
+    if (canceled) {
+        hg_atomic_and32(&na_tcp_op_id->status, ~NA_TCP_OP_QUEUED);
+        hg_atomic_or32(&na_tcp_op_id->status, NA_TCP_OP_CANCELED);
+        na_tcp_complete(na_tcp_op_id, NA_CANCELED);
+    }
+
+unlock:
+    hg_thread_mutex_unlock(&na_tcp_class->lock);
+
+    if (canceled)
+        na_tcp_complete_signal(na_tcp_class);
+
+    return NA_SUCCESS;
+}
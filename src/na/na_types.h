@@ -83,6 +83,38 @@ struct na_init_info {
     /* Request support for tranfers to/from memory devices (e.g., GPU, etc).
      * Default is: false. */
     bool request_mem_device;
+
+    /* Back internal buffers (shared-memory regions, message buffer pools)
+     * with huge pages when available. Plugins silently fall back to regular
+     * pages if huge pages cannot be allocated.
+     * Default is: false. */
+    bool use_huge_pages;
+
+    /* Memory budget that internal buffer pools are charged to. Pools stop
+     * growing once the budget is exhausted. See hg_mem_budget_init().
+     * Default is: NULL (unlimited). */
+    struct hg_mem_budget *mem_budget;
+
+    /* CPUs that the class is used from, in list format (e.g., "0-15,32-47").
+     * Plugins that select the network device from its locality pick a device
+     * local to these CPUs rather than to the CPUs the process is bound to,
+     * so that on multi-NIC nodes, threads on different sockets can each use
+     * a class (and address) on their local NIC.
+     * Default is: NULL (CPUs the process is bound to). */
+    const char *cpu_set;
+};
+
+/* Previous versions of init info to keep compatiblity with older versions */
+struct na_init_info_4_0 {
+    const char *ip_subnet;
+    const char *auth_key;
+    size_t max_unexpected_size;
+    size_t max_expected_size;
+    uint8_t progress_mode;
+    enum na_addr_format addr_format;
+    uint8_t max_contexts;
+    uint8_t thread_mode;
+    bool request_mem_device;
 };
 
 /* Segment */
@@ -99,6 +131,21 @@ struct na_protocol_info {
     char *device_name;             /* Name of associated device */
 };
 
+/* Protocol selection parameters (see NA_Select_protocol()) */
+struct na_select_info {
+    /* File where selections are recorded, a recorded selection is returned
+     * without measuring again (NULL for NA_SELECT_CACHE env variable) */
+    const char *cache_path;
+
+    /* Number of measured loopback round-trips and registrations per
+     * protocol (0 for default) */
+    unsigned int iterations;
+
+    /* Size of the buffer registered to measure registration cost (0 for
+     * default) */
+    size_t reg_size;
+};
+
 /* Return codes:
  * Functions return 0 for success or corresponding return code */
 #define NA_RETURN_VALUES                                                       \
@@ -139,6 +186,7 @@ typedef enum na_return { NA_RETURN_VALUES } na_return_t;
     X(NA_CB_RECV_EXPECTED)         /*!< expected recv callback */              \
     X(NA_CB_PUT)                   /*!< put callback */                        \
     X(NA_CB_GET)                   /*!< get callback */                        \
+    X(NA_CB_ATOMIC)                /*!< atomic callback */                     \
     X(NA_CB_MAX)
 
 #define X(a) a,
@@ -164,12 +212,17 @@ struct na_cb_info_recv_expected {
     size_t actual_buf_size;
 };
 
+struct na_cb_info_atomic {
+    uint64_t result; /*!< value of remote operand before the operation */
+};
+
 /* Callback info struct */
 struct na_cb_info {
     union { /* Union of callback info structures */
         struct na_cb_info_recv_unexpected recv_unexpected;
         struct na_cb_info_multi_recv_unexpected multi_recv_unexpected;
         struct na_cb_info_recv_expected recv_expected;
+        struct na_cb_info_atomic atomic;
     } info;
     void *arg;         /* User data */
     na_cb_type_t type; /* Callback type */
@@ -179,6 +232,90 @@ struct na_cb_info {
 /* Callback type */
 typedef void (*na_cb_t)(const struct na_cb_info *callback_info);
 
+/* Peer error callback (see NA_Addr_set_error_callback()) */
+typedef void (*na_addr_error_cb_t)(
+    na_class_t *na_class, na_addr_t *addr, na_return_t error, void *arg);
+
+/* Message send descriptor (see NA_Msg_send_batch()) */
+struct na_msg_send_info {
+    na_cb_t callback;     /* Completion callback */
+    void *arg;            /* User data */
+    const void *buf;      /* Send buffer */
+    size_t buf_size;      /* Buffer size */
+    void *plugin_data;    /* Plugin data returned by NA_Msg_buf_alloc() */
+    na_addr_t *dest_addr; /* Destination address */
+    na_op_id_t *op_id;    /* Operation ID */
+    na_tag_t tag;         /* Message tag */
+    uint8_t dest_id;      /* Destination context ID */
+};
+
+/* RMA segment descriptor (see NA_Rma_batch()) */
+struct na_rma_segment {
+    na_mem_handle_t *local_mem_handle;  /* Local memory handle */
+    na_offset_t local_offset;           /* Local offset */
+    na_mem_handle_t *remote_mem_handle; /* Remote memory handle */
+    na_offset_t remote_offset;          /* Remote offset */
+    size_t length;                      /* Length of data */
+};
+
+/* Remote atomic operation (see NA_Atomic_fetch_add() and NA_Atomic_cas()) */
+typedef enum na_atomic_op {
+    NA_ATOMIC_FETCH_ADD, /* Add operand, return previous value */
+    NA_ATOMIC_CAS        /* Swap if equal to compare, return previous value */
+} na_atomic_op_t;
+
+/* Context placement (see NA_Context_create_opt()) */
+struct na_context_info {
+    /* CPUs that the context is used from (NULL for the CPUs of numa_node) */
+    const unsigned int *cpus;
+
+    /* Number of CPUs */
+    unsigned int cpu_count;
+
+    /* NUMA node that the context is used from (negative if unspecified) */
+    int numa_node;
+};
+
+/* Progress thread of a context (see NA_Context_progress_start()) */
+struct na_progress_info {
+    /* CPU that the progress thread is pinned to (negative for no pinning) */
+    int cpu_id;
+
+    /* Max number of pending submissions (power of 2, 0 for default) */
+    unsigned int queue_size;
+
+    /* Timeout passed to NA_Progress() when no submission is pending, bounds
+     * the latency of new submissions (ms, 0 busy polls) */
+    unsigned int progress_timeout;
+};
+
+/* Operation descriptor (see NA_Submit()) */
+struct na_submit_info {
+    union {
+        struct {
+            void *buf;         /* Message buffer */
+            size_t buf_size;   /* Buffer size */
+            void *plugin_data; /* Plugin data returned by NA_Msg_buf_alloc() */
+            na_addr_t *addr;   /* Destination or source address */
+            na_tag_t tag;      /* Message tag */
+            uint8_t id;        /* Destination or source context ID */
+        } msg;
+        struct {
+            na_mem_handle_t *local_mem_handle;  /* Local memory handle */
+            na_mem_handle_t *remote_mem_handle; /* Remote memory handle */
+            na_offset_t local_offset;           /* Local offset */
+            na_offset_t remote_offset;          /* Remote offset */
+            size_t data_size;                   /* Amount of data */
+            na_addr_t *remote_addr;             /* Remote address */
+            uint8_t remote_id;                  /* Remote context ID */
+        } rma;
+    } info;            /* Operation parameters */
+    na_cb_t callback;  /* Completion callback */
+    void *arg;         /* User data */
+    na_op_id_t *op_id; /* Operation ID */
+    na_cb_type_t type; /* Operation type (no multi-recv) */
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -190,6 +327,7 @@ typedef void (*na_cb_t)(const struct na_cb_info *callback_info);
 
 /* Optional plugin dependent features that can be queried */
 #define NA_OPT_MULTI_RECV (1 << 0) /* multi-recv */
+#define NA_OPT_ATOMIC     (1 << 1) /* remote atomics */
 
 /* Max timeout */
 #define NA_MAX_IDLE_TIME (3600 * 1000)
@@ -241,6 +379,9 @@ typedef void (*na_cb_t)(const struct na_cb_info *callback_info);
         .addr_format = NA_ADDR_UNSPEC,                                         \
         .max_contexts = 1,                                                     \
         .thread_mode = 0,                                                      \
-        .request_mem_device = false})
+        .request_mem_device = false,                                           \
+        .use_huge_pages = false,                                               \
+        .mem_budget = NULL,                                                    \
+        .cpu_set = NULL})
 
 #endif /* NA_TYPES_H */
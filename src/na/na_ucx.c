@@ -9,7 +9,7 @@
 
 #include "na_ip.h"
 
-#include "mercury_hash_table.h"
+#include "mercury_oa_hash_table.h"
 #include "mercury_mem.h"
 #include "mercury_mem_pool.h"
 #include "mercury_queue.h"
@@ -39,15 +39,37 @@
 
 /* Default features
  * (AM for unexpected messages and TAG for expected messages) */
-#define NA_UCX_FEATURES (UCP_FEATURE_AM | UCP_FEATURE_TAG | UCP_FEATURE_RMA)
+#define NA_UCX_FEATURES                                                        \
+    (UCP_FEATURE_AM | UCP_FEATURE_TAG | UCP_FEATURE_RMA | UCP_FEATURE_AMO64)
 
-/* Default max msg size */
-#define NA_UCX_MSG_SIZE_MAX (4096)
+/* Default max msg size (larger when AMs can be received in place) */
+#ifdef NA_UCX_HAS_AM_RNDV
+#    define NA_UCX_MSG_SIZE_MAX (65536)
+#else
+#    define NA_UCX_MSG_SIZE_MAX (4096)
+#endif
 
 /* Address pool (enabled by default, comment out to disable) */
 #define NA_UCX_HAS_ADDR_POOL
 #define NA_UCX_ADDR_POOL_SIZE (64)
 
+/* Unexpected info pool (enabled by default, comment out to disable) */
+#define NA_UCX_HAS_UNEXPECTED_INFO_POOL
+#define NA_UCX_UNEXPECTED_INFO_POOL_SIZE (64)
+
+/* Number of poll_try_wait() calls that skip arming the worker after progress
+ * last found work */
+#define NA_UCX_ARM_SKIP_MAX (16)
+
+/* Max number of segments per memory handle */
+#define NA_UCX_IOV_MAX (256)
+
+/* Number of local IOV entries kept in op IDs without allocation */
+#define NA_UCX_RMA_IOV_STATIC_MAX (8)
+
+/* Number of unpacked remote keys cached per address */
+#define NA_UCX_RKEY_CACHE_SIZE (8)
+
 /* Memory pool (enabled by default, comment out to disable) */
 #define NA_UCX_HAS_MEM_POOL
 #define NA_UCX_MEM_CHUNK_COUNT (256)
@@ -55,6 +77,9 @@
 
 /* Addr status bits */
 #define NA_UCX_ADDR_RESOLVED (1 << 0)
+#define NA_UCX_ADDR_ACCEPTED (1 << 1)
+#define NA_UCX_ADDR_USED     (1 << 2)
+#define NA_UCX_ADDR_LRU      (1 << 3)
 
 /* Max tag */
 #define NA_UCX_MAX_TAG UINT32_MAX
@@ -63,6 +88,14 @@
 #define NA_UCX_AM_MSG_ID (0)
 #define NA_UCX_TAG_MASK  ((uint64_t) 0x00000000FFFFFFFF)
 
+/* Number of completions that a multi-recv operation may have pending (must
+ * be a power of 2), buffers are returned early once exhausted */
+#define NA_UCX_OP_MULTI_CQ_SIZE (256)
+
+/* Alignment of messages packed into multi-recv buffers */
+#define NA_UCX_MULTI_RECV_ALIGN(x)                                             \
+    (((x) + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1))
+
 /* Op ID status bits */
 #define NA_UCX_OP_COMPLETED (1 << 0)
 #define NA_UCX_OP_CANCELING (1 << 1)
@@ -93,15 +126,19 @@
             .plugin_callback = na_ucx_release,                                 \
             .plugin_callback_args = _op};                                      \
         _op->addr = _addr;                                                     \
-        if (_addr)                                                             \
+        if (_addr) {                                                           \
             na_ucx_addr_ref_incr(_addr);                                       \
+            hg_atomic_incr32(&_op->addr->nops);                                \
+        }                                                                      \
         hg_atomic_set32(&_op->status, 0);                                      \
     } while (0)
 
 #define NA_UCX_OP_RELEASE(_op)                                                 \
     do {                                                                       \
-        if (_op->addr)                                                         \
+        if (_op->addr) {                                                       \
+            hg_atomic_decr32(&_op->addr->nops);                                \
             na_ucx_addr_ref_decr(_op->addr);                                   \
+        }                                                                      \
         hg_atomic_set32(&_op->status, NA_UCX_OP_COMPLETED);                    \
     } while (0)
 
@@ -127,51 +164,83 @@
 /************************************/
 
 /* Address */
+/* Unpacked remote key */
+struct na_ucx_rkey_entry {
+    void *rkey_buf;             /* Packed key (cache key) */
+    size_t rkey_buf_size;       /* Packed key size */
+    ucp_ep_h ep;                /* EP key was unpacked on */
+    ucp_rkey_h rkey;            /* Unpacked key */
+    uint64_t last_use;          /* LRU stamp */
+    hg_atomic_int32_t refcount; /* Ops using that key */
+};
+
+/* Remote key cache */
+struct na_ucx_rkey_cache {
+    struct na_ucx_rkey_entry *entries; /* Allocated on first RMA */
+    uint64_t clock;                    /* Last LRU stamp */
+    hg_thread_spin_t lock;             /* Cache lock */
+};
+
 struct na_ucx_addr {
-    HG_QUEUE_ENTRY(na_ucx_addr) entry; /* Entry in addr pool */
-    struct sockaddr_storage ss_addr;   /* Sock addr */
-    ucs_sock_addr_t addr_key;          /* Address key */
-    struct na_ucx_class *na_ucx_class; /* NA UCX class */
-    ucp_address_t *worker_addr;        /* Worker addr */
-    size_t worker_addr_len;            /* Worker addr len */
-    bool worker_addr_alloc;            /* Worker addr was allocated by us */
-    ucp_ep_h ucp_ep;                   /* Currently only one EP per address */
-    hg_atomic_int32_t refcount;        /* Reference counter */
-    hg_atomic_int32_t status;          /* Connection state */
+    HG_QUEUE_ENTRY(na_ucx_addr) entry;     /* Entry in addr pool */
+    HG_QUEUE_ENTRY(na_ucx_addr) lru_entry; /* Entry in EP LRU queue */
+    struct sockaddr_storage ss_addr;       /* Sock addr */
+    ucs_sock_addr_t addr_key;              /* Address key */
+    struct na_ucx_class *na_ucx_class;     /* NA UCX class */
+    ucp_address_t *worker_addr;            /* Worker addr */
+    size_t worker_addr_len;                /* Worker addr len */
+    bool worker_addr_alloc;                /* Worker addr was allocated by us */
+    ucp_ep_h ucp_ep;                       /* Only one EP per address */
+    hg_atomic_int32_t refcount;            /* Reference counter */
+    hg_atomic_int32_t status;              /* Connection state */
+    hg_atomic_int32_t nops;                /* Ops posted to that address */
+    struct na_ucx_rkey_cache rkey_cache;   /* Unpacked remote keys */
 };
 
 /* Map (used to cache addresses) */
 struct na_ucx_map {
-    hg_thread_rwlock_t lock;
-    hg_hash_table_t *key_map;
-    hg_hash_table_t *ep_map;
+    hg_thread_brlock_t lock;
+    hg_oa_hash_table_t *key_map;
+    hg_oa_hash_table_t *ep_map;
+    HG_QUEUE_HEAD(na_ucx_addr) lru_queue; /* EPs we connected, oldest first */
+    size_t lru_count;                     /* Number of EPs in LRU queue */
 };
 
 /* Memory descriptor */
 NA_PACKED(struct na_ucx_mem_desc {
     uint64_t base;          /* Base address */
     uint64_t len;           /* Size of region */
-    uint64_t rkey_buf_size; /* Cached rkey buf size */
+    uint64_t rkey_buf_size; /* Cached rkey buf size (all segments) */
+    uint32_t iovcnt;        /* Number of segments */
     uint8_t flags;          /* Flag of operation access */
 });
 
+/* Segment descriptor (only serialized if more than one segment) */
+NA_PACKED(struct na_ucx_mem_seg_desc {
+    uint64_t base;          /* Base address */
+    uint64_t len;           /* Size of segment */
+    uint64_t rkey_buf_size; /* Cached rkey buf size */
+});
+
+/* Memory segment */
+struct na_ucx_mem_seg {
+    struct na_ucx_mem_seg_desc desc; /* Segment descriptor */
+    ucp_mem_h mem;                   /* UCP mem handle */
+    void *rkey_buf;                  /* Cached rkey buf */
+};
+
 /* Handle type */
 enum na_ucx_mem_handle_type {
     NA_UCX_MEM_HANDLE_LOCAL,
-    NA_UCX_MEM_HANDLE_REMOTE_PACKED,
-    NA_UCX_MEM_HANDLE_REMOTE_UNPACKED
+    NA_UCX_MEM_HANDLE_REMOTE
 };
 
 /* Memory handle */
 struct na_ucx_mem_handle {
-    struct na_ucx_mem_desc desc;        /* Memory descriptor */
-    hg_thread_mutex_t rkey_unpack_lock; /* Unpack lock */
-    union {
-        ucp_mem_h mem;   /* UCP mem handle */
-        ucp_rkey_h rkey; /* UCP rkey handle */
-    } ucp_mr;
-    void *rkey_buf;         /* Cached rkey buf */
-    hg_atomic_int32_t type; /* Handle type (local / remote) */
+    struct na_ucx_mem_desc desc; /* Memory descriptor */
+    struct na_ucx_mem_seg *segs; /* Segments (seg if contiguous) */
+    struct na_ucx_mem_seg seg;   /* Segment of contiguous handles */
+    hg_atomic_int32_t type;      /* Handle type (local / remote) */
 };
 
 /* Msg info */
@@ -181,28 +250,67 @@ struct na_ucx_msg_info {
         void *ptr;
     } buf;
     size_t buf_size;
+    size_t buf_offset; /* Space consumed (multi-recv) */
     ucp_tag_t tag;
 };
 
 /* UCP RMA op (put/get) */
-typedef na_return_t (*na_ucp_rma_op_t)(ucp_ep_h ep, void *buf, size_t buf_size,
-    uint64_t remote_addr, ucp_rkey_h rkey, void *request);
+typedef na_return_t (*na_ucp_rma_op_t)(ucp_ep_h ep, void *buf, size_t count,
+    ucp_datatype_t datatype, uint64_t remote_addr, ucp_rkey_h rkey,
+    void *request, void *user_data);
+
+/* RMA remote key */
+struct na_ucx_rma_key {
+    ucp_rkey_h rkey;                 /* Unpacked key */
+    struct na_ucx_rkey_entry *entry; /* Cache entry of key */
+    bool tmp;                        /* Key unpacked for that op only */
+};
+
+/* RMA span (local IOV targeting one remote segment) */
+struct na_ucx_rma_span {
+    const struct na_ucx_mem_seg *remote_seg; /* Remote segment */
+    uint64_t remote_addr;                    /* Remote address */
+    struct na_ucx_rma_key key;               /* Remote key of segment */
+    size_t iov_off;                          /* First local IOV entry */
+    size_t iovcnt;                           /* Number of local IOV entries */
+};
 
 /* RMA info */
 struct na_ucx_rma_info {
-    na_ucp_rma_op_t ucp_rma_op;
-    void *buf;
-    size_t buf_size;
-    uint64_t remote_addr;
-    ucp_rkey_h remote_key;
+    na_ucp_rma_op_t ucp_rma_op;    /* Put or get */
+    ucp_dt_iov_t *iov;             /* Local IOV */
+    struct na_ucx_rma_span *spans; /* Spans (one per remote segment) */
+    size_t span_count;             /* Number of spans */
+    ucp_dt_iov_t iov_static[NA_UCX_RMA_IOV_STATIC_MAX]; /* Static IOV */
+    struct na_ucx_rma_span span_static; /* Span of contiguous remotes */
+    hg_atomic_int32_t pending;      /* UCP requests left (+1 while posting) */
+    hg_atomic_int32_t ret;          /* First error returned */
+    hg_atomic_int32_t request_busy; /* Request of op ID in flight */
+};
+
+/* Atomic info */
+struct na_ucx_atomic_info {
+    struct na_ucx_rma_key key; /* Remote key of target segment */
+    uint64_t operand;          /* Value added or swapped in */
+    uint64_t result;           /* Previous value (compare value for CAS) */
+};
+
+/* Completions of multi-event operations */
+struct na_ucx_completion_multi {
+    struct na_cb_completion_data *data; /* Ring of completion data */
+    hg_atomic_int32_t head;             /* Next entry pushed */
+    hg_atomic_int32_t tail;             /* Next entry released */
+    int32_t mask;                       /* Ring mask */
 };
 
 /* Operation ID */
 struct na_ucx_op_id {
     struct na_cb_completion_data completion_data; /* Completion data    */
+    struct na_ucx_completion_multi multi; /* Multi-recv completions   */
     union {
         struct na_ucx_msg_info msg;
         struct na_ucx_rma_info rma;
+        struct na_ucx_atomic_info atomic;
     } info;                             /* Op info                  */
     HG_QUEUE_ENTRY(na_ucx_op_id) entry; /* Entry in queue           */
     na_context_t *context;              /* NA context associated    */
@@ -224,6 +332,7 @@ struct na_ucx_unexpected_info {
     size_t length;
     ucp_tag_t tag;
     bool data_alloc;
+    bool rndv; /* Data is a rendezvous descriptor */
 };
 
 /* Msg queue */
@@ -232,6 +341,12 @@ struct na_ucx_unexpected_msg_queue {
     hg_thread_spin_t lock;
 };
 
+/* Unexpected info pool */
+struct na_ucx_unexpected_info_pool {
+    HG_QUEUE_HEAD(na_ucx_unexpected_info) queue;
+    hg_thread_spin_t lock;
+};
+
 /* Op ID queue */
 struct na_ucx_op_queue {
     HG_QUEUE_HEAD(na_ucx_op_id) queue;
@@ -245,17 +360,36 @@ struct na_ucx_class {
     struct na_ucx_map addr_map;                 /* Address map */
     struct na_ucx_op_queue unexpected_op_queue; /* Unexpected op queue */
     struct na_ucx_addr_pool addr_pool;          /* Addr pool */
+    struct na_ucx_unexpected_info_pool
+        unexpected_info_pool;                   /* Unexpected info pool */
     ucp_context_h ucp_context;                  /* UCP context */
     ucp_worker_h ucp_worker;                    /* Shared UCP worker */
-    ucp_listener_h ucp_listener;   /* Listener handle if listening */
-    struct na_ucx_addr *self_addr; /* Self address */
-    struct hg_mem_pool *mem_pool;  /* Msg buf pool */
-    size_t ucp_request_size;       /* Size of UCP requests */
-    char *protocol_name;           /* Protocol used */
-    size_t unexpected_size_max;    /* Max unexpected size */
-    size_t expected_size_max;      /* Max expected size */
-    hg_atomic_int32_t ncontexts;   /* Number of contexts */
-    bool no_wait;                  /* Wait disabled */
+    ucp_listener_h ucp_listener;       /* Listener handle if listening */
+    struct na_ucx_addr *self_addr;     /* Self address */
+    struct hg_mem_pool *mem_pool;      /* Msg buf pool */
+    hg_atomic_int64_t *arm_count;      /* Worker arm attempts */
+    hg_atomic_int64_t *arm_busy_count; /* Arms that found pending events */
+    hg_atomic_int64_t *arm_skip_count; /* Arms skipped while busy */
+    hg_atomic_int64_t *mem_map_count;  /* Memory segments registered */
+    size_t ucp_request_size;           /* Size of UCP requests */
+    char *protocol_name;               /* Protocol used */
+    size_t unexpected_size_max;        /* Max unexpected size */
+    size_t expected_size_max;          /* Max expected size */
+    struct na_ucx_class *parent;       /* Class of the base worker */
+    na_class_t *na_class;              /* NA class (peer error notify) */
+    size_t ep_max;                     /* Max connected EPs (0 if no limit) */
+    ucs_thread_mode_t thread_mode;     /* Worker thread mode */
+    hg_atomic_int32_t ncontexts;       /* Number of contexts */
+    uint8_t context_max;               /* Max number of contexts */
+    bool multi_worker;                 /* One worker per context */
+    bool rma_iov_unsupported;          /* UCP RMA rejected IOV datatype */
+    bool no_wait;                      /* Wait disabled */
+};
+
+/* UCX context */
+struct na_ucx_context {
+    struct na_ucx_class *worker_class; /* Class owning the context worker */
+    hg_atomic_int32_t arm_skip;        /* Arm attempts left to skip */
 };
 
 /* Datatype used for printing info */
@@ -410,7 +544,7 @@ na_ucp_ep_error_cb(void *arg, ucp_ep_h ep, ucs_status_t status);
  * Close endpoint.
  */
 static void
-na_ucp_ep_close(ucp_ep_h ep);
+na_ucp_ep_close(ucp_ep_h ep, unsigned int mode);
 
 #ifndef NA_UCX_HAS_MEM_POOL
 /**
@@ -469,6 +603,29 @@ static ucs_status_t
 na_ucp_am_recv_cb(void *arg, const void *header, size_t header_length,
     void *data, size_t length, const ucp_am_recv_param_t *param);
 
+/**
+ * Post multi-recv active message buffer, packing messages already received.
+ */
+static void
+na_ucp_am_multi_recv(
+    struct na_ucx_class *na_ucx_class, struct na_ucx_op_id *na_ucx_op_id);
+
+#ifdef NA_UCX_HAS_AM_RNDV
+/**
+ * Receive rendezvous active message data into buf.
+ */
+static na_return_t
+na_ucp_am_recv_data(ucp_worker_h worker, void *data_desc, void *buf,
+    size_t buf_size, size_t length, struct na_ucx_op_id *na_ucx_op_id);
+
+/**
+ * Recv active message data callback.
+ */
+static void
+na_ucp_am_recv_data_cb(
+    void *request, ucs_status_t status, size_t length, void *user_data);
+#endif
+
 /**
  * Send a msg.
  */
@@ -497,18 +654,18 @@ na_ucp_msg_recv_cb(void *request, ucs_status_t status,
     const ucp_tag_recv_info_t *info, void *user_data);
 
 /**
- * RMA put.
+ * RMA put. Request is allocated by UCX if NULL.
  */
 static na_return_t
-na_ucp_put(ucp_ep_h ep, void *buf, size_t buf_size, uint64_t remote_addr,
-    ucp_rkey_h rkey, void *request);
+na_ucp_put(ucp_ep_h ep, void *buf, size_t count, ucp_datatype_t datatype,
+    uint64_t remote_addr, ucp_rkey_h rkey, void *request, void *user_data);
 
 /**
- * RMA get.
+ * RMA get. Request is allocated by UCX if NULL.
  */
 static na_return_t
-na_ucp_get(ucp_ep_h ep, void *buf, size_t buf_size, uint64_t remote_addr,
-    ucp_rkey_h rkey, void *request);
+na_ucp_get(ucp_ep_h ep, void *buf, size_t count, ucp_datatype_t datatype,
+    uint64_t remote_addr, ucp_rkey_h rkey, void *request, void *user_data);
 
 /**
  * RMA callback.
@@ -516,6 +673,19 @@ na_ucp_get(ucp_ep_h ep, void *buf, size_t buf_size, uint64_t remote_addr,
 static void
 na_ucp_rma_cb(void *request, ucs_status_t status, void *user_data);
 
+/**
+ * 64-bit atomic op. Request is allocated by UCX.
+ */
+static na_return_t
+na_ucp_atomic(ucp_ep_h ep, ucp_atomic_op_t op, const uint64_t *operand,
+    uint64_t *result, uint64_t remote_addr, ucp_rkey_h rkey, void *user_data);
+
+/**
+ * Atomic callback.
+ */
+static void
+na_ucp_atomic_cb(void *request, ucs_status_t status, void *user_data);
+
 /*---------------------------------------------------------------------------*/
 /* NA UCX helpers                                                            */
 /*---------------------------------------------------------------------------*/
@@ -540,6 +710,31 @@ na_ucx_parse_hostname_info(const char *hostname_info, const char *subnet_info,
     bool listen, char **net_device_p, struct sockaddr **sockaddr_p,
     socklen_t *addrlen_p);
 
+/**
+ * Create class that owns the worker of context id (multi-worker mode).
+ */
+static na_return_t
+na_ucx_worker_class_create(struct na_ucx_class *na_ucx_class, uint8_t id,
+    struct na_ucx_class **worker_class_p);
+
+/**
+ * Destroy class created by na_ucx_worker_class_create().
+ */
+static void
+na_ucx_worker_class_destroy(struct na_ucx_class *worker_class);
+
+/**
+ * Free addresses remaining in class map and pool.
+ */
+static void
+na_ucx_class_addrs_free(struct na_ucx_class *na_ucx_class);
+
+/**
+ * Shift port of sockaddr by context id.
+ */
+static na_return_t
+na_ucx_sockaddr_port_shift(struct sockaddr_storage *ss_addr, uint8_t id);
+
 /**
  * Hash address key.
  */
@@ -574,6 +769,18 @@ static na_return_t
 na_ucx_addr_map_update(struct na_ucx_class *na_ucx_class,
     struct na_ucx_map *na_ucx_map, struct na_ucx_addr *na_ucx_addr);
 
+/**
+ * Gracefully close least recently used EP that has no ops in flight.
+ */
+static void
+na_ucx_addr_map_evict(struct na_ucx_map *na_ucx_map);
+
+/**
+ * Make sure address has a usable EP (connecting it on first use).
+ */
+static NA_INLINE na_return_t
+na_ucx_addr_resolve(struct na_ucx_addr *na_ucx_addr);
+
 /**
  * Remove addr from map using addr_key.
  */
@@ -638,6 +845,14 @@ static na_return_t
 na_ucx_addr_create(struct na_ucx_class *na_ucx_class, ucs_sock_addr_t *addr_key,
     struct na_ucx_addr **na_ucx_addr_p);
 
+/**
+ * Get address to use to reach remote context id from local context.
+ */
+static na_return_t
+na_ucx_addr_route(struct na_ucx_class *na_ucx_class, na_context_t *context,
+    struct na_ucx_addr *na_ucx_addr, uint8_t id,
+    struct na_ucx_addr **route_addr_p);
+
 /**
  * Increment ref count.
  */
@@ -654,13 +869,14 @@ na_ucx_addr_ref_decr(struct na_ucx_addr *na_ucx_addr);
  * Allocate unexpected info.
  */
 static struct na_ucx_unexpected_info *
-na_ucx_unexpected_info_alloc(void *data, size_t data_alloc_size);
+na_ucx_unexpected_info_alloc(
+    struct na_ucx_class *na_ucx_class, void *data, size_t data_alloc_size);
 
 /**
- * Free unexpected info.
+ * Free unexpected info (or return it to the pool).
  */
 static void
-na_ucx_unexpected_info_free(
+na_ucx_unexpected_info_free(struct na_ucx_class *na_ucx_class,
     struct na_ucx_unexpected_info *na_ucx_unexpected_info);
 
 /**
@@ -671,15 +887,65 @@ na_ucx_rma(struct na_ucx_class *na_ucx_class, na_context_t *context,
     na_cb_type_t cb_type, na_cb_t callback, void *arg,
     struct na_ucx_mem_handle *local_mem_handle, na_offset_t local_offset,
     struct na_ucx_mem_handle *remote_mem_handle, na_offset_t remote_offset,
-    size_t length, struct na_ucx_addr *na_ucx_addr,
+    size_t length, struct na_ucx_addr *na_ucx_addr, uint8_t remote_id,
     struct na_ucx_op_id *na_ucx_op_id);
 
 /**
- * Resolve RMA remote key.
+ * Build local IOV and remote spans of RMA transfer.
+ */
+static na_return_t
+na_ucx_rma_iov_build(const struct na_ucx_mem_handle *local_mem_handle,
+    na_offset_t local_offset, const struct na_ucx_mem_handle *remote_mem_handle,
+    na_offset_t remote_offset, size_t length,
+    struct na_ucx_rma_info *na_ucx_rma_info);
+
+/**
+ * Walk segments of RMA transfer, fill IOV and spans if not NULL.
+ */
+static na_return_t
+na_ucx_rma_iov_walk(const struct na_ucx_mem_handle *local_mem_handle,
+    na_offset_t local_offset, const struct na_ucx_mem_handle *remote_mem_handle,
+    na_offset_t remote_offset, size_t length, ucp_dt_iov_t *iov,
+    struct na_ucx_rma_span *spans, size_t *iovcnt_p, size_t *span_count_p);
+
+/**
+ * Post one UCP RMA request of transfer.
+ */
+static na_return_t
+na_ucx_rma_post(struct na_ucx_op_id *na_ucx_op_id, ucp_ep_h ep, void *buf,
+    size_t count, ucp_datatype_t datatype, uint64_t remote_addr,
+    ucp_rkey_h rkey, size_t *posted_p);
+
+/**
+ * Complete one UCP RMA request of transfer, completes op on last one.
+ */
+static void
+na_ucx_rma_done(struct na_ucx_op_id *na_ucx_op_id, na_return_t ret);
+
+/**
+ * Release remote keys and IOV of transfer.
+ */
+static void
+na_ucx_rma_info_release(struct na_ucx_rma_info *na_ucx_rma_info);
+
+/**
+ * Resolve RMA remote key from the rkey cache of the address.
  */
 static na_return_t
-na_ucx_rma_key_resolve(ucp_ep_h ep, struct na_ucx_mem_handle *na_ucx_mem_handle,
-    ucp_rkey_h *rkey_p);
+na_ucx_rma_key_resolve(struct na_ucx_addr *na_ucx_addr, const void *rkey_buf,
+    size_t rkey_buf_size, struct na_ucx_rma_key *na_ucx_rma_key);
+
+/**
+ * Release RMA remote key resolved by na_ucx_rma_key_resolve().
+ */
+static NA_INLINE void
+na_ucx_rma_key_release(struct na_ucx_rma_key *na_ucx_rma_key);
+
+/**
+ * Invalidate rkeys of previous EP (destroy idle ones, or all if flush).
+ */
+static void
+na_ucx_rkey_cache_invalidate(struct na_ucx_rkey_cache *rkey_cache, bool flush);
 
 /**
  * Complete UCX operation.
@@ -693,6 +959,29 @@ na_ucx_complete(struct na_ucx_op_id *na_ucx_op_id, na_return_t cb_ret);
 static NA_INLINE void
 na_ucx_release(void *arg);
 
+/**
+ * Reserve space and completion data for a message received into a multi-recv
+ * buffer, messages must not exceed the max unexpected size. Called with the
+ * unexpected op queue lock held.
+ */
+static struct na_cb_completion_data *
+na_ucx_multi_recv_reserve(struct na_ucx_op_id *na_ucx_op_id,
+    struct na_ucx_addr *source, na_tag_t tag, size_t buf_size,
+    size_t msg_size_max, bool close);
+
+/**
+ * Complete a message received into a multi-recv buffer.
+ */
+static NA_INLINE void
+na_ucx_complete_multi(struct na_ucx_op_id *na_ucx_op_id,
+    struct na_cb_completion_data *completion_data, na_return_t cb_ret);
+
+/**
+ * Release completion data of multi-recv operation.
+ */
+static NA_INLINE void
+na_ucx_release_multi(void *arg);
+
 /********************/
 /* Plugin callbacks */
 /********************/
@@ -715,6 +1004,19 @@ na_ucx_initialize(
 static na_return_t
 na_ucx_finalize(na_class_t *na_class);
 
+/* has_opt_feature */
+static bool
+na_ucx_has_opt_feature(na_class_t *na_class, unsigned long flags);
+
+/* context_create */
+static na_return_t
+na_ucx_context_create(
+    na_class_t *na_class, void **plugin_context_p, uint8_t id);
+
+/* context_destroy */
+static na_return_t
+na_ucx_context_destroy(na_class_t *na_class, void *plugin_context);
+
 /* op_create */
 static na_op_id_t *
 na_ucx_op_create(na_class_t *na_class, unsigned long flags);
@@ -723,10 +1025,18 @@ na_ucx_op_create(na_class_t *na_class, unsigned long flags);
 static void
 na_ucx_op_destroy(na_class_t *na_class, na_op_id_t *op_id);
 
+/* op_reset */
+static na_return_t
+na_ucx_op_reset(na_class_t *na_class, na_op_id_t *op_id);
+
 /* addr_lookup */
 static na_return_t
 na_ucx_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p);
 
+/* addr_warm */
+static na_return_t
+na_ucx_addr_warm(na_class_t *na_class, na_addr_t *const *addrs, size_t count);
+
 /* addr_free */
 static NA_INLINE void
 na_ucx_addr_free(na_class_t *na_class, na_addr_t *addr);
@@ -800,6 +1110,12 @@ na_ucx_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
     na_op_id_t *op_id);
 
+/* msg_multi_recv_unexpected */
+static na_return_t
+na_ucx_msg_multi_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, size_t buf_size, void *plugin_data,
+    na_op_id_t *op_id);
+
 /* msg_send_expected */
 static na_return_t
 na_ucx_msg_send_expected(na_class_t *na_class, na_context_t *context,
@@ -818,6 +1134,11 @@ static na_return_t
 na_ucx_mem_handle_create(na_class_t *na_class, void *buf, size_t buf_size,
     unsigned long flags, na_mem_handle_t **mem_handle_p);
 
+static na_return_t
+na_ucx_mem_handle_create_segments(na_class_t *na_class,
+    struct na_segment *segments, size_t segment_count, unsigned long flags,
+    na_mem_handle_t **mem_handle_p);
+
 static void
 na_ucx_mem_handle_free(na_class_t *na_class, na_mem_handle_t *mem_handle);
 
@@ -860,6 +1181,13 @@ na_ucx_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     size_t length, na_addr_t *remote_addr, uint8_t remote_id,
     na_op_id_t *op_id);
 
+/* atomic */
+static na_return_t
+na_ucx_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id);
+
 /* poll_get_fd */
 static int
 na_ucx_poll_get_fd(na_class_t *na_class, na_context_t *context);
@@ -888,12 +1216,16 @@ NA_PLUGIN const struct na_class_ops NA_PLUGIN_OPS(ucx) = {
     na_ucx_initialize,                    /* initialize */
     na_ucx_finalize,                      /* finalize */
     NULL,                                 /* cleanup */
-    NULL,                                 /* has_opt_feature */
-    NULL,                                 /* context_create */
-    NULL,                                 /* context_destroy */
+    na_ucx_has_opt_feature,               /* has_opt_feature */
+    NULL,                                 /* get_numa_node */
+    na_ucx_context_create,                /* context_create */
+    na_ucx_context_destroy,               /* context_destroy */
     na_ucx_op_create,                     /* op_create */
     na_ucx_op_destroy,                    /* op_destroy */
+    na_ucx_op_reset,                      /* op_reset */
     na_ucx_addr_lookup,                   /* addr_lookup */
+    NULL,                                 /* addr_lookup_batch */
+    na_ucx_addr_warm,                     /* addr_warm */
     na_ucx_addr_free,                     /* addr_free */
     NULL,                                 /* addr_set_remove */
     na_ucx_addr_self,                     /* addr_self */
@@ -914,12 +1246,13 @@ NA_PLUGIN const struct na_class_ops NA_PLUGIN_OPS(ucx) = {
     NULL,                                 /* msg_init_unexpected */
     na_ucx_msg_send_unexpected,           /* msg_send_unexpected */
     na_ucx_msg_recv_unexpected,           /* msg_recv_unexpected */
-    NULL,                                 /* msg_multi_recv_unexpected */
+    na_ucx_msg_multi_recv_unexpected,     /* msg_multi_recv_unexpected */
     NULL,                                 /* msg_init_expected */
     na_ucx_msg_send_expected,             /* msg_send_expected */
     na_ucx_msg_recv_expected,             /* msg_recv_expected */
+    NULL,                                 /* msg_send_batch */
     na_ucx_mem_handle_create,             /* mem_handle_create */
-    NULL,                                 /* mem_handle_create_segment */
+    na_ucx_mem_handle_create_segments,    /* mem_handle_create_segment */
     na_ucx_mem_handle_free,               /* mem_handle_free */
     na_ucx_mem_handle_get_max_segments,   /* mem_handle_get_max_segments */
     na_ucx_mem_register,                  /* mem_register */
@@ -929,6 +1262,9 @@ NA_PLUGIN const struct na_class_ops NA_PLUGIN_OPS(ucx) = {
     na_ucx_mem_handle_deserialize,        /* mem_handle_deserialize */
     na_ucx_put,                           /* put */
     na_ucx_get,                           /* get */
+    NULL,                                 /* rma_batch_get_max_segments */
+    NULL,                                 /* rma_batch */
+    na_ucx_atomic,                        /* atomic */
     na_ucx_poll_get_fd,                   /* poll_get_fd */
     na_ucx_poll_try_wait,                 /* poll_try_wait */
     na_ucx_progress,                      /* progress */
@@ -1419,7 +1755,12 @@ na_ucp_set_am_handler(
         UCP_AM_HANDLER_PARAM_FIELD_ID | UCP_AM_HANDLER_PARAM_FIELD_CB |
         UCP_AM_HANDLER_PARAM_FIELD_ARG | UCP_AM_HANDLER_PARAM_FIELD_FLAGS;
     param.id = NA_UCX_AM_MSG_ID;
+#ifdef NA_UCX_HAS_AM_RNDV
+    /* Eager data can be kept without a copy if no recv was posted */
+    param.flags = UCP_AM_FLAG_WHOLE_MSG | UCP_AM_FLAG_PERSISTENT_DATA;
+#else
     param.flags = UCP_AM_FLAG_WHOLE_MSG;
+#endif
     param.cb = am_recv_cb;
     param.arg = arg;
 
@@ -1742,30 +2083,41 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static void
-na_ucp_ep_error_cb(
-    void *arg, ucp_ep_h NA_UNUSED ep, ucs_status_t NA_DEBUG_LOG_USED status)
+na_ucp_ep_error_cb(void *arg, ucp_ep_h ep, ucs_status_t status)
 {
     struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) arg;
 
     NA_LOG_SUBSYS_DEBUG(addr, "ep_err_handler() returned (%s) for address (%p)",
         ucs_status_string(status), (void *) na_ucx_addr);
 
+    /* EP was already evicted from that address */
+    if (ep != na_ucx_addr->ucp_ep)
+        return;
+
     /* Mark addr as no longer resolved to force reconnection */
     hg_atomic_and32(&na_ucx_addr->status, ~NA_UCX_ADDR_RESOLVED);
 
+    /* Let upper layer fail what is still pending to that peer */
+    na_cb_addr_error(na_ucx_addr->na_ucx_class->na_class,
+        (na_addr_t *) na_ucx_addr, na_ucs_status_to_na(status));
+
     /* Will schedule removal of address */
     na_ucx_addr_ref_decr(na_ucx_addr);
 }
 
 /*---------------------------------------------------------------------------*/
 static void
-na_ucp_ep_close(ucp_ep_h ep)
+na_ucp_ep_close(ucp_ep_h ep, unsigned int mode)
 {
-    ucs_status_ptr_t status_ptr = ucp_ep_close_nb(ep, UCP_EP_CLOSE_MODE_FORCE);
+    ucs_status_ptr_t status_ptr = ucp_ep_close_nb(ep, mode);
     NA_CHECK_SUBSYS_ERROR_DONE(addr,
         status_ptr != NULL && UCS_PTR_IS_ERR(status_ptr),
         "ucp_ep_close_nb() failed (%s)",
         ucs_status_string(UCS_PTR_STATUS(status_ptr)));
+
+    /* Flushing close completes in the background */
+    if (status_ptr != NULL && !UCS_PTR_IS_ERR(status_ptr))
+        ucp_request_free(status_ptr);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1855,10 +2207,6 @@ na_ucp_am_recv(
     } else {
         NA_LOG_SUBSYS_DEBUG(msg, "Unexpected data was already received");
 
-        /* Copy buffers */
-        memcpy(na_ucx_op_id->info.msg.buf.ptr, na_ucx_unexpected_info->data,
-            na_ucx_unexpected_info->length);
-
         /* Fill unexpected info */
         na_ucx_op_id->completion_data.callback_info.info.recv_unexpected =
             (struct na_cb_info_recv_unexpected){
@@ -1866,18 +2214,139 @@ na_ucp_am_recv(
                 .actual_buf_size = (size_t) na_ucx_unexpected_info->length,
                 .source = (na_addr_t *) na_ucx_unexpected_info->na_ucx_addr};
 
+#ifdef NA_UCX_HAS_AM_RNDV
+        if (na_ucx_unexpected_info->rndv) {
+            na_return_t ret = na_ucp_am_recv_data(na_ucx_class->ucp_worker,
+                na_ucx_unexpected_info->data, na_ucx_op_id->info.msg.buf.ptr,
+                na_ucx_op_id->info.msg.buf_size, na_ucx_unexpected_info->length,
+                na_ucx_op_id);
+
+            /* Descriptor must be released if no data is received */
+            if (ret != NA_SUCCESS) {
+                ucp_am_data_release(
+                    na_ucx_class->ucp_worker, na_ucx_unexpected_info->data);
+                na_ucx_complete(na_ucx_op_id, ret);
+            }
+            na_ucx_unexpected_info_free(na_ucx_class, na_ucx_unexpected_info);
+            return;
+        }
+#endif
+
+        /* Copy buffers */
+        memcpy(na_ucx_op_id->info.msg.buf.ptr, na_ucx_unexpected_info->data,
+            na_ucx_unexpected_info->length);
+
         /* Release AM buffer if returned UCS_INPROGRESS */
         if (!na_ucx_unexpected_info->data_alloc &&
             na_ucx_unexpected_info->length > 0) {
             ucp_am_data_release(
                 na_ucx_class->ucp_worker, na_ucx_unexpected_info->data);
         }
-        na_ucx_unexpected_info_free(na_ucx_unexpected_info);
+        na_ucx_unexpected_info_free(na_ucx_class, na_ucx_unexpected_info);
 
         na_ucx_complete(na_ucx_op_id, NA_SUCCESS);
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+na_ucp_am_multi_recv(
+    struct na_ucx_class *na_ucx_class, struct na_ucx_op_id *na_ucx_op_id)
+{
+    struct na_ucx_unexpected_msg_queue *unexpected_msg_queue =
+        &na_ucx_class->unexpected_msg_queue;
+    struct na_ucx_op_queue *unexpected_op_queue =
+        &na_ucx_class->unexpected_op_queue;
+    struct na_ucx_unexpected_info *rndv_info = NULL;
+    struct na_cb_completion_data *rndv_completion_data = NULL;
+    bool last = false;
+
+    /* Pack unexpected messages already received, then queue the operation
+     * unless its buffer was consumed */
+    hg_thread_spin_lock(&unexpected_op_queue->lock);
+    while (!last) {
+        struct na_ucx_unexpected_info *na_ucx_unexpected_info;
+        struct na_cb_completion_data *completion_data;
+
+        hg_thread_spin_lock(&unexpected_msg_queue->lock);
+        na_ucx_unexpected_info = HG_QUEUE_FIRST(&unexpected_msg_queue->queue);
+        HG_QUEUE_POP_HEAD(&unexpected_msg_queue->queue, entry);
+        hg_thread_spin_unlock(&unexpected_msg_queue->lock);
+        if (na_ucx_unexpected_info == NULL)
+            break;
+
+        /* Peer buffers may be larger than locally posted ones */
+        if (unlikely(na_ucx_unexpected_info->length >
+                     na_ucx_class->unexpected_size_max)) {
+            NA_LOG_SUBSYS_ERROR(msg,
+                "Dropping unexpected msg of %zu bytes that exceeds multi-recv "
+                "max size",
+                na_ucx_unexpected_info->length);
+            if (na_ucx_unexpected_info->rndv ||
+                (!na_ucx_unexpected_info->data_alloc &&
+                    na_ucx_unexpected_info->length > 0))
+                ucp_am_data_release(
+                    na_ucx_class->ucp_worker, na_ucx_unexpected_info->data);
+            na_ucx_addr_ref_decr(na_ucx_unexpected_info->na_ucx_addr);
+            na_ucx_unexpected_info_free(na_ucx_class, na_ucx_unexpected_info);
+            continue;
+        }
+
+        completion_data = na_ucx_multi_recv_reserve(na_ucx_op_id,
+            na_ucx_unexpected_info->na_ucx_addr,
+            (na_tag_t) na_ucx_unexpected_info->tag,
+            na_ucx_unexpected_info->length, na_ucx_class->unexpected_size_max,
+            na_ucx_unexpected_info->rndv);
+        last = completion_data->callback_info.info.multi_recv_unexpected.last;
+
+        /* Rendezvous data is received once the lock is released */
+        if (na_ucx_unexpected_info->rndv) {
+            rndv_info = na_ucx_unexpected_info;
+            rndv_completion_data = completion_data;
+            break;
+        }
+
+        memcpy(completion_data->callback_info.info.multi_recv_unexpected
+                   .actual_buf,
+            na_ucx_unexpected_info->data, na_ucx_unexpected_info->length);
+
+        /* Release AM buffer if returned UCS_INPROGRESS */
+        if (!na_ucx_unexpected_info->data_alloc &&
+            na_ucx_unexpected_info->length > 0) {
+            ucp_am_data_release(
+                na_ucx_class->ucp_worker, na_ucx_unexpected_info->data);
+        }
+        na_ucx_unexpected_info_free(na_ucx_class, na_ucx_unexpected_info);
+
+        na_ucx_complete_multi(na_ucx_op_id, completion_data, NA_SUCCESS);
+    }
+    if (!last) {
+        HG_QUEUE_PUSH_TAIL(&unexpected_op_queue->queue, na_ucx_op_id, entry);
+        hg_atomic_or32(&na_ucx_op_id->status, NA_UCX_OP_QUEUED);
+    }
+    hg_thread_spin_unlock(&unexpected_op_queue->lock);
+
+#ifdef NA_UCX_HAS_AM_RNDV
+    if (rndv_info != NULL) {
+        na_return_t ret = na_ucp_am_recv_data(na_ucx_class->ucp_worker,
+            rndv_info->data,
+            rndv_completion_data->callback_info.info.multi_recv_unexpected
+                .actual_buf,
+            rndv_info->length, rndv_info->length, na_ucx_op_id);
+
+        /* Descriptor must be released if no data is received */
+        if (ret != NA_SUCCESS) {
+            ucp_am_data_release(na_ucx_class->ucp_worker, rndv_info->data);
+            na_ucx_complete_multi(na_ucx_op_id, rndv_completion_data, ret);
+        }
+        na_ucx_unexpected_info_free(na_ucx_class, rndv_info);
+    }
+#else
+    (void) rndv_info;
+    (void) rndv_completion_data;
+#endif
+}
+
 /*---------------------------------------------------------------------------*/
 static ucs_status_t
 na_ucp_am_recv_cb(void *arg, const void *header, size_t header_length,
@@ -1888,6 +2357,13 @@ na_ucp_am_recv_cb(void *arg, const void *header, size_t header_length,
         &na_ucx_class->unexpected_op_queue;
     struct na_ucx_op_id *na_ucx_op_id = NULL;
     struct na_ucx_addr *source_addr = NULL;
+    struct na_cb_completion_data *completion_data = NULL;
+#ifdef NA_UCX_HAS_AM_RNDV
+    bool rndv = param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV;
+#else
+    bool rndv = false;
+#endif
+    bool dropped = false;
     ucp_tag_t tag;
     ucs_status_t ret;
 
@@ -1910,16 +2386,67 @@ na_ucp_am_recv_cb(void *arg, const void *header, size_t header_length,
         UCS_ERR_INVALID_PARAM,
         "No entry found for previously inserted src addr");
 
-    /* Pop op ID from queue */
+    /* Pop op ID from queue, multi-recv operations remain queued until their
+     * buffer is consumed */
     hg_thread_spin_lock(&unexpected_op_queue->lock);
     na_ucx_op_id = HG_QUEUE_FIRST(&unexpected_op_queue->queue);
     if (likely(na_ucx_op_id)) {
-        HG_QUEUE_POP_HEAD(&unexpected_op_queue->queue, entry);
-        hg_atomic_and32(&na_ucx_op_id->status, ~NA_UCX_OP_QUEUED);
+        if (na_ucx_op_id->completion_data.callback_info.type ==
+            NA_CB_MULTI_RECV_UNEXPECTED) {
+            /* Peer buffers may be larger than locally posted ones */
+            if (unlikely(length > na_ucx_class->unexpected_size_max))
+                dropped = true;
+            else
+                completion_data = na_ucx_multi_recv_reserve(na_ucx_op_id,
+                    source_addr, (na_tag_t) tag, length,
+                    na_ucx_class->unexpected_size_max, rndv);
+        }
+        if (!dropped &&
+            (completion_data == NULL ||
+                completion_data->callback_info.info.multi_recv_unexpected
+                    .last)) {
+            HG_QUEUE_POP_HEAD(&unexpected_op_queue->queue, entry);
+            hg_atomic_and32(&na_ucx_op_id->status, ~NA_UCX_OP_QUEUED);
+        }
     }
     hg_thread_spin_unlock(&unexpected_op_queue->lock);
 
-    if (likely(na_ucx_op_id)) {
+    if (unlikely(dropped)) {
+        NA_LOG_SUBSYS_ERROR(msg,
+            "Dropping unexpected msg of %zu bytes that exceeds multi-recv "
+            "max size",
+            length);
+
+        /* UCX releases data (or rendezvous descriptor) on return */
+        return UCS_OK;
+    } else if (completion_data != NULL) {
+        void *actual_buf =
+            completion_data->callback_info.info.multi_recv_unexpected
+                .actual_buf;
+
+        na_ucx_addr_ref_incr(source_addr);
+
+#ifdef NA_UCX_HAS_AM_RNDV
+        /* Large payloads are received in place and close the buffer, the op
+         * ID is used as the request of the transfer */
+        if (rndv) {
+            na_return_t na_ret = na_ucp_am_recv_data(na_ucx_class->ucp_worker,
+                data, actual_buf, length, length, na_ucx_op_id);
+            if (na_ret != NA_SUCCESS)
+                na_ucx_complete_multi(na_ucx_op_id, completion_data, na_ret);
+
+            return UCS_OK;
+        }
+#endif
+
+        /* Copy buffer */
+        memcpy(actual_buf, data, length);
+
+        /* Complete message */
+        na_ucx_complete_multi(na_ucx_op_id, completion_data, NA_SUCCESS);
+
+        return UCS_OK;
+    } else if (likely(na_ucx_op_id)) {
         /* Fill info */
         na_ucx_op_id->completion_data.callback_info.info.recv_unexpected =
             (struct na_cb_info_recv_unexpected){.tag = (na_tag_t) tag,
@@ -1927,6 +2454,20 @@ na_ucp_am_recv_cb(void *arg, const void *header, size_t header_length,
                 .source = (na_addr_t *) source_addr};
         na_ucx_addr_ref_incr(source_addr);
 
+#ifdef NA_UCX_HAS_AM_RNDV
+        /* Large payloads are received in place, UCX drops the descriptor if
+         * the receive could not be posted */
+        if (rndv) {
+            na_return_t na_ret = na_ucp_am_recv_data(na_ucx_class->ucp_worker,
+                data, na_ucx_op_id->info.msg.buf.ptr,
+                na_ucx_op_id->info.msg.buf_size, length, na_ucx_op_id);
+            if (na_ret != NA_SUCCESS)
+                na_ucx_complete(na_ucx_op_id, na_ret);
+
+            return UCS_OK;
+        }
+#endif
+
         /* Copy buffer */
         memcpy(na_ucx_op_id->info.msg.buf.ptr, data, length);
 
@@ -1938,21 +2479,25 @@ na_ucp_am_recv_cb(void *arg, const void *header, size_t header_length,
         struct na_ucx_unexpected_msg_queue *unexpected_msg_queue =
             &na_ucx_class->unexpected_msg_queue;
         struct na_ucx_unexpected_info *na_ucx_unexpected_info = NULL;
-        bool data_alloc = !(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_DATA);
+        bool data_alloc =
+            !rndv && !(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_DATA);
 
         NA_LOG_SUBSYS_WARNING(perf,
-            "No operation was preposted, data will persist (data_alloc=%d)",
-            (int) data_alloc);
+            "No operation was preposted, data will persist (data_alloc=%d, "
+            "rndv=%d)",
+            (int) data_alloc, (int) rndv);
 
         /* If no error and message arrived, keep a copy of the struct in
          * the unexpected message queue (should rarely happen) */
         na_ucx_unexpected_info =
-            na_ucx_unexpected_info_alloc(data, data_alloc ? length : 0);
+            na_ucx_unexpected_info_alloc(
+                na_ucx_class, data, data_alloc ? length : 0);
         NA_CHECK_SUBSYS_ERROR(msg, na_ucx_unexpected_info == NULL, error, ret,
             UCS_ERR_NO_MEMORY, "Could not allocate unexpected info");
 
         na_ucx_unexpected_info->length = length;
         na_ucx_unexpected_info->tag = tag;
+        na_ucx_unexpected_info->rndv = rndv;
         na_ucx_unexpected_info->na_ucx_addr = source_addr;
         na_ucx_addr_ref_incr(source_addr);
 
@@ -1972,35 +2517,41 @@ error:
     return ret;
 }
 
+#ifdef NA_UCX_HAS_AM_RNDV
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucp_msg_send(
-    ucp_ep_h ep, const void *buf, size_t buf_size, ucp_tag_t tag, void *request)
+na_ucp_am_recv_data(ucp_worker_h worker, void *data_desc, void *buf,
+    size_t buf_size, size_t length, struct na_ucx_op_id *na_ucx_op_id)
 {
-    const ucp_request_param_t send_params = {
+    const ucp_request_param_t recv_params = {
         .op_attr_mask = UCP_OP_ATTR_FIELD_REQUEST | UCP_OP_ATTR_FIELD_CALLBACK,
-        .cb = {.send = na_ucp_msg_send_cb},
-        .request = request};
+        .cb = {.recv_am = na_ucp_am_recv_data_cb},
+        .request = na_ucx_op_id};
     ucs_status_ptr_t status_ptr;
     na_return_t ret;
 
-    NA_LOG_SUBSYS_DEBUG(
-        msg, "Posting msg send with buf_size=%zu, tag=%" PRIu64, buf_size, tag);
+    NA_CHECK_SUBSYS_ERROR(msg, length > buf_size, error, ret, NA_MSGSIZE,
+        "Rendezvous data too large for buffer (expected %zu, got %zu)",
+        buf_size, length);
 
-    status_ptr = ucp_tag_send_nbx(ep, buf, buf_size, tag, &send_params);
+    NA_LOG_SUBSYS_DEBUG(msg, "Posting am recv data with length=%zu", length);
+
+    status_ptr =
+        ucp_am_recv_data_nbx(worker, data_desc, buf, length, &recv_params);
     if (status_ptr == NULL) {
         /* Check for immediate completion */
-        NA_LOG_SUBSYS_DEBUG(msg, "ucp_tag_send_nbx() completed immediately");
+        NA_LOG_SUBSYS_DEBUG(
+            msg, "ucp_am_recv_data_nbx() completed immediately");
 
         /* Directly execute callback */
-        na_ucp_msg_send_cb(request, UCS_OK, NULL);
+        na_ucp_am_recv_data_cb(na_ucx_op_id, UCS_OK, length, NULL);
     } else
         NA_CHECK_SUBSYS_ERROR(msg, UCS_PTR_IS_ERR(status_ptr), error, ret,
             na_ucs_status_to_na(UCS_PTR_STATUS(status_ptr)),
-            "ucp_tag_send_nbx() failed (%s)",
+            "ucp_am_recv_data_nbx() failed (%s)",
             ucs_status_string(UCS_PTR_STATUS(status_ptr)));
 
-    NA_LOG_SUBSYS_DEBUG(msg, "ucp_tag_send_nbx() was posted");
+    NA_LOG_SUBSYS_DEBUG(msg, "ucp_am_recv_data_nbx() was posted");
 
     return NA_SUCCESS;
 
@@ -2010,13 +2561,14 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static void
-na_ucp_msg_send_cb(
-    void *request, ucs_status_t status, void NA_UNUSED *user_data)
+na_ucp_am_recv_data_cb(void *request, ucs_status_t status,
+    size_t NA_UNUSED length, void NA_UNUSED *user_data)
 {
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) request;
     na_return_t cb_ret;
 
-    NA_LOG_SUBSYS_DEBUG(
-        msg, "ucp_tag_send_nbx() completed (%s)", ucs_status_string(status));
+    NA_LOG_SUBSYS_DEBUG(msg, "ucp_am_recv_data_nbx() completed (%s)",
+        ucs_status_string(status));
 
     if (status == UCS_OK)
         NA_GOTO_DONE(done, cb_ret, NA_SUCCESS);
@@ -2024,21 +2576,89 @@ na_ucp_msg_send_cb(
         NA_GOTO_DONE(done, cb_ret, NA_CANCELED);
     else
         NA_GOTO_SUBSYS_ERROR(msg, done, cb_ret, na_ucs_status_to_na(status),
-            "ucp_tag_send_nbx() failed (%s)", ucs_status_string(status));
+            "ucp_am_recv_data_nbx() failed (%s)", ucs_status_string(status));
 
 done:
-    na_ucx_complete((struct na_ucx_op_id *) request, cb_ret);
+    /* Rendezvous data always fills the last entry of multi-recv buffers */
+    if (na_ucx_op_id->completion_data.callback_info.type ==
+        NA_CB_MULTI_RECV_UNEXPECTED) {
+        struct na_ucx_completion_multi *multi = &na_ucx_op_id->multi;
+
+        na_ucx_complete_multi(na_ucx_op_id,
+            &multi->data[(hg_atomic_get32(&multi->head) - 1) & multi->mask],
+            cb_ret);
+    } else
+        na_ucx_complete(na_ucx_op_id, cb_ret);
 }
+#endif
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucp_msg_recv(ucp_worker_h worker, void *buf, size_t buf_size, ucp_tag_t tag,
-    void *request)
+na_ucp_msg_send(
+    ucp_ep_h ep, const void *buf, size_t buf_size, ucp_tag_t tag, void *request)
 {
-    ucp_tag_recv_info_t tag_recv_info = {.length = 0, .sender_tag = 0};
-    const ucp_request_param_t recv_params = {
-        .op_attr_mask = UCP_OP_ATTR_FIELD_REQUEST | UCP_OP_ATTR_FIELD_CALLBACK |
-                        UCP_OP_ATTR_FIELD_RECV_INFO,
+    const ucp_request_param_t send_params = {
+        .op_attr_mask = UCP_OP_ATTR_FIELD_REQUEST | UCP_OP_ATTR_FIELD_CALLBACK,
+        .cb = {.send = na_ucp_msg_send_cb},
+        .request = request};
+    ucs_status_ptr_t status_ptr;
+    na_return_t ret;
+
+    NA_LOG_SUBSYS_DEBUG(
+        msg, "Posting msg send with buf_size=%zu, tag=%" PRIu64, buf_size, tag);
+
+    status_ptr = ucp_tag_send_nbx(ep, buf, buf_size, tag, &send_params);
+    if (status_ptr == NULL) {
+        /* Check for immediate completion */
+        NA_LOG_SUBSYS_DEBUG(msg, "ucp_tag_send_nbx() completed immediately");
+
+        /* Directly execute callback */
+        na_ucp_msg_send_cb(request, UCS_OK, NULL);
+    } else
+        NA_CHECK_SUBSYS_ERROR(msg, UCS_PTR_IS_ERR(status_ptr), error, ret,
+            na_ucs_status_to_na(UCS_PTR_STATUS(status_ptr)),
+            "ucp_tag_send_nbx() failed (%s)",
+            ucs_status_string(UCS_PTR_STATUS(status_ptr)));
+
+    NA_LOG_SUBSYS_DEBUG(msg, "ucp_tag_send_nbx() was posted");
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucp_msg_send_cb(
+    void *request, ucs_status_t status, void NA_UNUSED *user_data)
+{
+    na_return_t cb_ret;
+
+    NA_LOG_SUBSYS_DEBUG(
+        msg, "ucp_tag_send_nbx() completed (%s)", ucs_status_string(status));
+
+    if (status == UCS_OK)
+        NA_GOTO_DONE(done, cb_ret, NA_SUCCESS);
+    if (status == UCS_ERR_CANCELED)
+        NA_GOTO_DONE(done, cb_ret, NA_CANCELED);
+    else
+        NA_GOTO_SUBSYS_ERROR(msg, done, cb_ret, na_ucs_status_to_na(status),
+            "ucp_tag_send_nbx() failed (%s)", ucs_status_string(status));
+
+done:
+    na_ucx_complete((struct na_ucx_op_id *) request, cb_ret);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucp_msg_recv(ucp_worker_h worker, void *buf, size_t buf_size, ucp_tag_t tag,
+    void *request)
+{
+    ucp_tag_recv_info_t tag_recv_info = {.length = 0, .sender_tag = 0};
+    const ucp_request_param_t recv_params = {
+        .op_attr_mask = UCP_OP_ATTR_FIELD_REQUEST | UCP_OP_ATTR_FIELD_CALLBACK |
+                        UCP_OP_ATTR_FIELD_RECV_INFO,
         .cb = {.recv = na_ucp_msg_recv_cb},
         .request = request,
         .recv_info.tag_info = &tag_recv_info};
@@ -2115,23 +2735,31 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucp_put(ucp_ep_h ep, void *buf, size_t buf_size, uint64_t remote_addr,
-    ucp_rkey_h rkey, void *request)
+na_ucp_put(ucp_ep_h ep, void *buf, size_t count, ucp_datatype_t datatype,
+    uint64_t remote_addr, ucp_rkey_h rkey, void *request, void *user_data)
 {
-    const ucp_request_param_t rma_params = {
-        .op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_REQUEST,
+    ucp_request_param_t rma_params = {
+        .op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                        UCP_OP_ATTR_FIELD_DATATYPE |
+                        UCP_OP_ATTR_FIELD_USER_DATA,
         .cb = {.send = na_ucp_rma_cb},
-        .request = request};
+        .datatype = datatype,
+        .user_data = user_data};
     ucs_status_ptr_t status_ptr;
     na_return_t ret;
 
-    status_ptr = ucp_put_nbx(ep, buf, buf_size, remote_addr, rkey, &rma_params);
+    if (request != NULL) {
+        rma_params.op_attr_mask |= UCP_OP_ATTR_FIELD_REQUEST;
+        rma_params.request = request;
+    }
+
+    status_ptr = ucp_put_nbx(ep, buf, count, remote_addr, rkey, &rma_params);
     if (status_ptr == NULL) {
         /* Check for immediate completion */
         NA_LOG_SUBSYS_DEBUG(rma, "ucp_put_nbx() completed immediately");
 
         /* Directly execute callback */
-        na_ucp_rma_cb(request, UCS_OK, NULL);
+        na_ucp_rma_cb(request, UCS_OK, user_data);
     } else
         NA_CHECK_SUBSYS_ERROR(rma, UCS_PTR_IS_ERR(status_ptr), error, ret,
             na_ucs_status_to_na(UCS_PTR_STATUS(status_ptr)),
@@ -2148,23 +2776,31 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucp_get(ucp_ep_h ep, void *buf, size_t buf_size, uint64_t remote_addr,
-    ucp_rkey_h rkey, void *request)
+na_ucp_get(ucp_ep_h ep, void *buf, size_t count, ucp_datatype_t datatype,
+    uint64_t remote_addr, ucp_rkey_h rkey, void *request, void *user_data)
 {
-    const ucp_request_param_t rma_params = {
-        .op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_REQUEST,
+    ucp_request_param_t rma_params = {
+        .op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                        UCP_OP_ATTR_FIELD_DATATYPE |
+                        UCP_OP_ATTR_FIELD_USER_DATA,
         .cb = {.send = na_ucp_rma_cb},
-        .request = request};
+        .datatype = datatype,
+        .user_data = user_data};
     ucs_status_ptr_t status_ptr;
     na_return_t ret;
 
-    status_ptr = ucp_get_nbx(ep, buf, buf_size, remote_addr, rkey, &rma_params);
+    if (request != NULL) {
+        rma_params.op_attr_mask |= UCP_OP_ATTR_FIELD_REQUEST;
+        rma_params.request = request;
+    }
+
+    status_ptr = ucp_get_nbx(ep, buf, count, remote_addr, rkey, &rma_params);
     if (status_ptr == NULL) {
         /* Check for immediate completion */
         NA_LOG_SUBSYS_DEBUG(rma, "ucp_get_nbx() completed immediately");
 
         /* Directly execute callback */
-        na_ucp_rma_cb(request, UCS_OK, NULL);
+        na_ucp_rma_cb(request, UCS_OK, user_data);
     } else
         NA_CHECK_SUBSYS_ERROR(rma, UCS_PTR_IS_ERR(status_ptr), error, ret,
             na_ucs_status_to_na(UCS_PTR_STATUS(status_ptr)),
@@ -2181,14 +2817,20 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static void
-na_ucp_rma_cb(void *request, ucs_status_t status, void NA_UNUSED *user_data)
+na_ucp_rma_cb(void *request, ucs_status_t status, void *user_data)
 {
-    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) request;
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) user_data;
     na_return_t cb_ret;
 
     NA_LOG_SUBSYS_DEBUG(
         rma, "ucp_put/get_nbx() completed (%s)", ucs_status_string(status));
 
+    /* Only the first request of a transfer uses the op ID */
+    if (request == (void *) na_ucx_op_id)
+        hg_atomic_set32(&na_ucx_op_id->info.rma.request_busy, 0);
+    else if (request != NULL)
+        ucp_request_free(request);
+
     if (status == UCS_OK)
         NA_GOTO_DONE(done, cb_ret, NA_SUCCESS);
     if (status == UCS_ERR_CANCELED)
@@ -2198,6 +2840,71 @@ na_ucp_rma_cb(void *request, ucs_status_t status, void NA_UNUSED *user_data)
             "na_ucp_rma_cb() failed (%s)", ucs_status_string(status));
 
 done:
+    na_ucx_rma_done(na_ucx_op_id, cb_ret);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucp_atomic(ucp_ep_h ep, ucp_atomic_op_t op, const uint64_t *operand,
+    uint64_t *result, uint64_t remote_addr, ucp_rkey_h rkey, void *user_data)
+{
+    ucp_request_param_t atomic_params = {
+        .op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                        UCP_OP_ATTR_FIELD_DATATYPE |
+                        UCP_OP_ATTR_FIELD_USER_DATA |
+                        UCP_OP_ATTR_FIELD_REPLY_BUFFER,
+        .cb = {.send = na_ucp_atomic_cb},
+        .datatype = ucp_dt_make_contig(sizeof(uint64_t)),
+        .user_data = user_data,
+        .reply_buffer = result};
+    ucs_status_ptr_t status_ptr;
+    na_return_t ret;
+
+    status_ptr = ucp_atomic_op_nbx(
+        ep, op, operand, 1, remote_addr, rkey, &atomic_params);
+    if (status_ptr == NULL) {
+        /* Check for immediate completion */
+        NA_LOG_SUBSYS_DEBUG(rma, "ucp_atomic_op_nbx() completed immediately");
+
+        /* Directly execute callback */
+        na_ucp_atomic_cb(NULL, UCS_OK, user_data);
+    } else
+        NA_CHECK_SUBSYS_ERROR(rma, UCS_PTR_IS_ERR(status_ptr), error, ret,
+            na_ucs_status_to_na(UCS_PTR_STATUS(status_ptr)),
+            "ucp_atomic_op_nbx() failed (%s)",
+            ucs_status_string(UCS_PTR_STATUS(status_ptr)));
+
+    NA_LOG_SUBSYS_DEBUG(rma, "ucp_atomic_op_nbx() was posted");
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucp_atomic_cb(void *request, ucs_status_t status, void *user_data)
+{
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) user_data;
+    struct na_ucx_atomic_info *atomic_info = &na_ucx_op_id->info.atomic;
+    na_return_t cb_ret;
+
+    if (request != NULL)
+        ucp_request_free(request);
+
+    if (status == UCS_OK)
+        NA_GOTO_DONE(done, cb_ret, NA_SUCCESS);
+    if (status == UCS_ERR_CANCELED)
+        NA_GOTO_DONE(done, cb_ret, NA_CANCELED);
+    else
+        NA_GOTO_SUBSYS_ERROR(rma, done, cb_ret, na_ucs_status_to_na(status),
+            "na_ucp_atomic_cb() failed (%s)", ucs_status_string(status));
+
+done:
+    na_ucx_rma_key_release(&atomic_info->key);
+    na_ucx_op_id->completion_data.callback_info.info.atomic.result =
+        atomic_info->result;
     na_ucx_complete(na_ucx_op_id, cb_ret);
 }
 
@@ -2213,9 +2920,9 @@ na_ucx_class_alloc(void)
         "Could not allocate NA private data class");
 
     /* Init table lock */
-    rc = hg_thread_rwlock_init(&na_ucx_class->addr_map.lock);
+    rc = hg_thread_brlock_init(&na_ucx_class->addr_map.lock);
     NA_CHECK_SUBSYS_ERROR_NORET(
-        cls, rc != HG_UTIL_SUCCESS, error, "hg_thread_rwlock_init() failed");
+        cls, rc != HG_UTIL_SUCCESS, error, "hg_thread_brlock_init() failed");
 
     /* Initialize unexpected op queue */
     rc = hg_thread_spin_init(&na_ucx_class->unexpected_op_queue.lock);
@@ -2235,15 +2942,24 @@ na_ucx_class_alloc(void)
         cls, rc != HG_UTIL_SUCCESS, error, "hg_thread_spin_init() failed");
     HG_QUEUE_INIT(&na_ucx_class->addr_pool.queue);
 
+    /* Initialize unexpected info pool */
+    rc = hg_thread_spin_init(&na_ucx_class->unexpected_info_pool.lock);
+    NA_CHECK_SUBSYS_ERROR_NORET(
+        cls, rc != HG_UTIL_SUCCESS, error, "hg_thread_spin_init() failed");
+    HG_QUEUE_INIT(&na_ucx_class->unexpected_info_pool.queue);
+
+    /* Initialize EP LRU queue */
+    HG_QUEUE_INIT(&na_ucx_class->addr_map.lru_queue);
+
     /* Create address map */
     na_ucx_class->addr_map.key_map =
-        hg_hash_table_new(na_ucx_addr_key_hash, na_ucx_addr_key_equal);
+        hg_oa_hash_table_new(na_ucx_addr_key_hash, na_ucx_addr_key_equal);
     NA_CHECK_SUBSYS_ERROR_NORET(cls, na_ucx_class->addr_map.key_map == NULL,
         error, "Could not allocate key map");
 
     /* Create connection map */
     na_ucx_class->addr_map.ep_map =
-        hg_hash_table_new(na_ucx_addr_ep_hash, na_ucx_addr_ep_equal);
+        hg_oa_hash_table_new(na_ucx_addr_ep_hash, na_ucx_addr_ep_equal);
     NA_CHECK_SUBSYS_ERROR_NORET(cls, na_ucx_class->addr_map.ep_map == NULL,
         error, "Could not allocate EP handle map");
 
@@ -2270,23 +2986,174 @@ na_ucx_class_free(struct na_ucx_class *na_ucx_class)
         na_ucp_listener_destroy(na_ucx_class->ucp_listener);
     if (na_ucx_class->ucp_worker)
         na_ucp_worker_destroy(na_ucx_class->ucp_worker);
-    if (na_ucx_class->ucp_context)
+    /* Context is shared with the parent class */
+    if (na_ucx_class->ucp_context && na_ucx_class->parent == NULL)
         na_ucp_context_destroy(na_ucx_class->ucp_context);
 
     if (na_ucx_class->addr_map.key_map)
-        hg_hash_table_free(na_ucx_class->addr_map.key_map);
+        hg_oa_hash_table_free(na_ucx_class->addr_map.key_map);
     if (na_ucx_class->addr_map.ep_map)
-        hg_hash_table_free(na_ucx_class->addr_map.ep_map);
-    (void) hg_thread_rwlock_destroy(&na_ucx_class->addr_map.lock);
+        hg_oa_hash_table_free(na_ucx_class->addr_map.ep_map);
+    (void) hg_thread_brlock_destroy(&na_ucx_class->addr_map.lock);
+
+    /* Free unexpected info pool */
+    while (!HG_QUEUE_IS_EMPTY(&na_ucx_class->unexpected_info_pool.queue)) {
+        struct na_ucx_unexpected_info *na_ucx_unexpected_info =
+            HG_QUEUE_FIRST(&na_ucx_class->unexpected_info_pool.queue);
+        HG_QUEUE_POP_HEAD(&na_ucx_class->unexpected_info_pool.queue, entry);
+        free(na_ucx_unexpected_info);
+    }
 
     (void) hg_thread_spin_destroy(&na_ucx_class->unexpected_op_queue.lock);
     (void) hg_thread_spin_destroy(&na_ucx_class->unexpected_msg_queue.lock);
     (void) hg_thread_spin_destroy(&na_ucx_class->addr_pool.lock);
+    (void) hg_thread_spin_destroy(&na_ucx_class->unexpected_info_pool.lock);
 
     free(na_ucx_class->protocol_name);
     free(na_ucx_class);
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_worker_class_create(struct na_ucx_class *na_ucx_class, uint8_t id,
+    struct na_ucx_class **worker_class_p)
+{
+    struct na_ucx_class *worker_class = NULL;
+    struct sockaddr_storage ss_addr, ucp_listener_ss_addr;
+    ucs_sock_addr_t addr_key = na_ucx_class->self_addr->addr_key;
+    na_return_t ret;
+
+    worker_class = na_ucx_class_alloc();
+    NA_CHECK_SUBSYS_ERROR(ctx, worker_class == NULL, error, ret, NA_NOMEM,
+        "Could not allocate NA UCX worker class");
+
+    /* Share UCP context and settings with parent class */
+    worker_class->parent = na_ucx_class;
+    worker_class->na_class = na_ucx_class->na_class;
+    worker_class->ep_max = na_ucx_class->ep_max;
+    worker_class->ucp_context = na_ucx_class->ucp_context;
+    worker_class->ucp_request_size = na_ucx_class->ucp_request_size;
+    worker_class->unexpected_size_max = na_ucx_class->unexpected_size_max;
+    worker_class->expected_size_max = na_ucx_class->expected_size_max;
+    worker_class->thread_mode = na_ucx_class->thread_mode;
+    worker_class->no_wait = na_ucx_class->no_wait;
+    worker_class->arm_count = na_ucx_class->arm_count;
+    worker_class->arm_busy_count = na_ucx_class->arm_busy_count;
+    worker_class->arm_skip_count = na_ucx_class->arm_skip_count;
+
+    ret = na_ucp_worker_create(worker_class->ucp_context,
+        worker_class->thread_mode, &worker_class->ucp_worker);
+    NA_CHECK_SUBSYS_NA_ERROR(ctx, error, ret, "Could not create UCX worker");
+
+    /* Set AM handler for unexpected messages */
+    ret = na_ucp_set_am_handler(
+        worker_class->ucp_worker, na_ucp_am_recv_cb, (void *) worker_class);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        ctx, error, ret, "Could not set handler for receiving active messages");
+
+    /* Context workers listen on consecutive ports after the class one */
+    if (na_ucx_class->ucp_listener) {
+        memcpy(&ss_addr, addr_key.addr, addr_key.addrlen);
+        ret = na_ucx_sockaddr_port_shift(&ss_addr, id);
+        NA_CHECK_SUBSYS_NA_ERROR(ctx, error, ret,
+            "Could not derive listener address of context %" PRIu8, id);
+
+        ret = na_ucp_listener_create(worker_class->ucp_worker,
+            (const struct sockaddr *) &ss_addr,
+            (ss_addr.ss_family == AF_INET) ? sizeof(struct sockaddr_in)
+                                           : sizeof(struct sockaddr_in6),
+            (void *) worker_class, &worker_class->ucp_listener,
+            &ucp_listener_ss_addr);
+        NA_CHECK_SUBSYS_NA_ERROR(ctx, error, ret,
+            "Could not create UCX listener for context %" PRIu8, id);
+
+        addr_key = (ucs_sock_addr_t){
+            .addr = (const struct sockaddr *) &ucp_listener_ss_addr,
+            .addrlen = sizeof(ucp_listener_ss_addr)};
+    }
+
+    /* Create self address */
+    ret = na_ucx_addr_create(worker_class, &addr_key, &worker_class->self_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(ctx, error, ret, "Could not create self address");
+
+    /* Attach worker address */
+    ret = na_ucp_worker_get_address(worker_class->ucp_worker,
+        &worker_class->self_addr->worker_addr,
+        &worker_class->self_addr->worker_addr_len);
+    NA_CHECK_SUBSYS_NA_ERROR(ctx, error, ret, "Could not get worker address");
+
+    *worker_class_p = worker_class;
+
+    return NA_SUCCESS;
+
+error:
+    if (worker_class)
+        na_ucx_class_free(worker_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_worker_class_destroy(struct na_ucx_class *worker_class)
+{
+    na_ucx_class_addrs_free(worker_class);
+    na_ucx_class_free(worker_class);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_class_addrs_free(struct na_ucx_class *na_ucx_class)
+{
+    hg_oa_hash_table_iter_t addr_table_iter;
+
+    /* Iterate over remaining addresses and free them */
+    hg_oa_hash_table_iterate(na_ucx_class->addr_map.key_map, &addr_table_iter);
+    while (hg_oa_hash_table_iter_has_more(&addr_table_iter)) {
+        struct na_ucx_addr *na_ucx_addr =
+            (struct na_ucx_addr *) hg_oa_hash_table_iter_next(&addr_table_iter);
+        na_ucx_addr_destroy(na_ucx_addr);
+    }
+
+#ifdef NA_UCX_HAS_ADDR_POOL
+    /* Free addresse pool */
+    while (!HG_QUEUE_IS_EMPTY(&na_ucx_class->addr_pool.queue)) {
+        struct na_ucx_addr *na_ucx_addr =
+            HG_QUEUE_FIRST(&na_ucx_class->addr_pool.queue);
+        HG_QUEUE_POP_HEAD(&na_ucx_class->addr_pool.queue, entry);
+        na_ucx_addr_destroy(na_ucx_addr);
+    }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_sockaddr_port_shift(struct sockaddr_storage *ss_addr, uint8_t id)
+{
+    na_return_t ret;
+
+    switch (ss_addr->ss_family) {
+        case AF_INET: {
+            struct sockaddr_in *sin = (struct sockaddr_in *) ss_addr;
+            sin->sin_port = htons((uint16_t) (ntohs(sin->sin_port) + id));
+            break;
+        }
+        case AF_INET6: {
+            struct sockaddr_in6 *sin6 = (struct sockaddr_in6 *) ss_addr;
+            sin6->sin6_port = htons((uint16_t) (ntohs(sin6->sin6_port) + id));
+            break;
+        }
+        default:
+            NA_GOTO_SUBSYS_ERROR(addr, error, ret, NA_PROTONOSUPPORT,
+                "Unsupported address family (%d)", (int) ss_addr->ss_family);
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ucx_parse_hostname_info(const char *hostname_info, const char *subnet_info,
@@ -2405,10 +3272,10 @@ na_ucx_addr_map_lookup(struct na_ucx_map *na_ucx_map, ucs_sock_addr_t *addr_key)
     hg_hash_table_value_t value = NULL;
 
     /* Lookup key */
-    hg_thread_rwlock_rdlock(&na_ucx_map->lock);
-    value = hg_hash_table_lookup(
+    hg_thread_brlock_rdlock(&na_ucx_map->lock);
+    value = hg_oa_hash_table_lookup(
         na_ucx_map->key_map, (hg_hash_table_key_t) addr_key);
-    hg_thread_rwlock_release_rdlock(&na_ucx_map->lock);
+    hg_thread_brlock_release_rdlock(&na_ucx_map->lock);
 
     return (value == HG_HASH_TABLE_NULL) ? NULL : (struct na_ucx_addr *) value;
 }
@@ -2423,10 +3290,10 @@ na_ucx_addr_map_insert(struct na_ucx_class *na_ucx_class,
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    hg_thread_rwlock_wrlock(&na_ucx_map->lock);
+    hg_thread_brlock_wrlock(&na_ucx_map->lock);
 
     /* Look up again to prevent race between lock release/acquire */
-    na_ucx_addr = (struct na_ucx_addr *) hg_hash_table_lookup(
+    na_ucx_addr = (struct na_ucx_addr *) hg_oa_hash_table_lookup(
         na_ucx_map->key_map, (hg_hash_table_key_t) addr_key);
     if (na_ucx_addr) {
         ret = NA_EXIST; /* Entry already exists */
@@ -2438,49 +3305,46 @@ na_ucx_addr_map_insert(struct na_ucx_class *na_ucx_class,
     NA_CHECK_SUBSYS_NA_ERROR(
         addr, error, ret, "Could not allocate NA UCX addr");
 
+    /* EPs of looked up addresses are only created on first use by
+     * na_ucx_addr_map_update() so that lookups never wait on connections */
     if (conn_request) {
         /* Accept connection */
         ret = na_ucp_accept(na_ucx_class->ucp_worker, conn_request,
             na_ucp_ep_error_cb, (void *) na_ucx_addr, &na_ucx_addr->ucp_ep);
         NA_CHECK_SUBSYS_NA_ERROR(
             addr, error, ret, "Could not accept connection request");
-    } else {
-        /* Create new endpoint */
-        ret = na_ucp_connect(na_ucx_class->ucp_worker,
-            na_ucx_class->self_addr->addr_key.addr, na_ucx_addr->addr_key.addr,
-            na_ucx_addr->addr_key.addrlen, na_ucp_ep_error_cb,
-            (void *) na_ucx_addr, &na_ucx_addr->ucp_ep);
-        NA_CHECK_SUBSYS_NA_ERROR(
-            addr, error, ret, "Could not connect UCP endpoint");
-    }
-    NA_LOG_SUBSYS_DEBUG(addr, "UCP ep for addr %p is %p", (void *) na_ucx_addr,
-        (void *) na_ucx_addr->ucp_ep);
+        hg_atomic_or32(&na_ucx_addr->status, NA_UCX_ADDR_ACCEPTED);
 
-    /* Insert new value to secondary map to lookup by EP handle */
-    rc = hg_hash_table_insert(na_ucx_map->ep_map,
-        (hg_hash_table_key_t) na_ucx_addr->ucp_ep,
-        (hg_hash_table_value_t) na_ucx_addr);
-    NA_CHECK_SUBSYS_ERROR(
-        addr, rc == 0, error, ret, NA_NOMEM, "hg_hash_table_insert() failed");
+        NA_LOG_SUBSYS_DEBUG(addr, "UCP ep for addr %p is %p",
+            (void *) na_ucx_addr, (void *) na_ucx_addr->ucp_ep);
+
+        /* Insert new value to secondary map to lookup by EP handle */
+        rc = hg_oa_hash_table_insert(na_ucx_map->ep_map,
+            (hg_hash_table_key_t) na_ucx_addr->ucp_ep,
+            (hg_hash_table_value_t) na_ucx_addr);
+        NA_CHECK_SUBSYS_ERROR(addr, rc == 0, error, ret, NA_NOMEM,
+            "hg_oa_hash_table_insert() failed");
+    }
 
     /* Insert new value to primary map */
-    rc = hg_hash_table_insert(na_ucx_map->key_map,
+    rc = hg_oa_hash_table_insert(na_ucx_map->key_map,
         (hg_hash_table_key_t) &na_ucx_addr->addr_key,
         (hg_hash_table_value_t) na_ucx_addr);
-    NA_CHECK_SUBSYS_ERROR(
-        addr, rc == 0, error, ret, NA_NOMEM, "hg_hash_table_insert() failed");
+    NA_CHECK_SUBSYS_ERROR(addr, rc == 0, error, ret, NA_NOMEM,
+        "hg_oa_hash_table_insert() failed");
 
-    hg_atomic_or32(&na_ucx_addr->status, NA_UCX_ADDR_RESOLVED);
+    if (conn_request)
+        hg_atomic_or32(&na_ucx_addr->status, NA_UCX_ADDR_RESOLVED);
 
 done:
-    hg_thread_rwlock_release_wrlock(&na_ucx_map->lock);
+    hg_thread_brlock_release_wrlock(&na_ucx_map->lock);
 
     *na_ucx_addr_p = na_ucx_addr;
 
     return ret;
 
 error:
-    hg_thread_rwlock_release_wrlock(&na_ucx_map->lock);
+    hg_thread_brlock_release_wrlock(&na_ucx_map->lock);
     if (na_ucx_addr)
         na_ucx_addr_destroy(na_ucx_addr);
 
@@ -2492,27 +3356,38 @@ static na_return_t
 na_ucx_addr_map_update(struct na_ucx_class *na_ucx_class,
     struct na_ucx_map *na_ucx_map, struct na_ucx_addr *na_ucx_addr)
 {
+    bool reconnect = false;
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    hg_thread_rwlock_wrlock(&na_ucx_map->lock);
+    hg_thread_brlock_wrlock(&na_ucx_map->lock);
 
     /* Check again to prevent race between lock release/acquire */
     if (hg_atomic_get32(&na_ucx_addr->status) & NA_UCX_ADDR_RESOLVED)
         goto unlock;
 
-    NA_LOG_SUBSYS_DEBUG(
-        addr, "Attempting to reconnect addr %p", (void *) na_ucx_addr);
+    if (na_ucx_addr->ucp_ep != NULL) {
+        NA_LOG_SUBSYS_DEBUG(
+            addr, "Attempting to reconnect addr %p", (void *) na_ucx_addr);
 
-    /* Remove EP handle from secondary map */
-    rc = hg_hash_table_remove(
-        na_ucx_map->ep_map, (hg_hash_table_key_t) na_ucx_addr->ucp_ep);
-    NA_CHECK_SUBSYS_ERROR(addr, rc != 1, unlock, ret, NA_NOENTRY,
-        "hg_hash_table_remove() failed");
+        /* Remove EP handle from secondary map */
+        rc = hg_oa_hash_table_remove(
+            na_ucx_map->ep_map, (hg_hash_table_key_t) na_ucx_addr->ucp_ep);
+        NA_CHECK_SUBSYS_ERROR(addr, rc != 1, unlock, ret, NA_NOENTRY,
+            "hg_oa_hash_table_remove() failed");
 
-    /* Close previous EP */
-    na_ucp_ep_close(na_ucx_addr->ucp_ep);
-    na_ucx_addr->ucp_ep = NULL;
+        /* Close previous EP */
+        na_ucp_ep_close(na_ucx_addr->ucp_ep, UCP_EP_CLOSE_MODE_FORCE);
+        na_ucx_addr->ucp_ep = NULL;
+        na_ucx_rkey_cache_invalidate(&na_ucx_addr->rkey_cache, false);
+        reconnect = true;
+    } else
+        NA_LOG_SUBSYS_DEBUG(addr, "Connecting addr %p", (void *) na_ucx_addr);
+
+    /* Make room for the new EP */
+    if (na_ucx_class->ep_max > 0 &&
+        na_ucx_map->lru_count >= na_ucx_class->ep_max)
+        na_ucx_addr_map_evict(na_ucx_map);
 
     /* Create new endpoint */
     ret = na_ucp_connect(na_ucx_class->ucp_worker,
@@ -2526,20 +3401,121 @@ na_ucx_addr_map_update(struct na_ucx_class *na_ucx_class,
         (void *) na_ucx_addr->ucp_ep);
 
     /* Insert new value to secondary map to lookup by EP handle */
-    rc = hg_hash_table_insert(na_ucx_map->ep_map,
+    rc = hg_oa_hash_table_insert(na_ucx_map->ep_map,
         (hg_hash_table_key_t) na_ucx_addr->ucp_ep,
         (hg_hash_table_value_t) na_ucx_addr);
-    NA_CHECK_SUBSYS_ERROR(
-        addr, rc == 0, unlock, ret, NA_NOMEM, "hg_hash_table_insert() failed");
+    NA_CHECK_SUBSYS_ERROR(addr, rc == 0, unlock, ret, NA_NOMEM,
+        "hg_oa_hash_table_insert() failed");
+
+    /* Track EPs that we connected (addresses may already be queued if they
+     * got disconnected) */
+    if (!(hg_atomic_get32(&na_ucx_addr->status) &
+            (NA_UCX_ADDR_ACCEPTED | NA_UCX_ADDR_LRU))) {
+        HG_QUEUE_PUSH_TAIL(&na_ucx_map->lru_queue, na_ucx_addr, lru_entry);
+        na_ucx_map->lru_count++;
+        hg_atomic_or32(&na_ucx_addr->status, NA_UCX_ADDR_LRU);
+    }
 
     /* Retake refcount taken away from previous disconnect */
-    na_ucx_addr_ref_incr(na_ucx_addr);
+    if (reconnect)
+        na_ucx_addr_ref_incr(na_ucx_addr);
 
     hg_atomic_or32(&na_ucx_addr->status, NA_UCX_ADDR_RESOLVED);
 
 unlock:
-    hg_thread_rwlock_release_wrlock(&na_ucx_map->lock);
+    hg_thread_brlock_release_wrlock(&na_ucx_map->lock);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_addr_map_evict(struct na_ucx_map *na_ucx_map)
+{
+    size_t n = 2 * na_ucx_map->lru_count; /* Bound to two CLOCK sweeps */
+
+    while (n-- > 0 && !HG_QUEUE_IS_EMPTY(&na_ucx_map->lru_queue)) {
+        struct na_ucx_addr *na_ucx_addr =
+            HG_QUEUE_FIRST(&na_ucx_map->lru_queue);
+        int32_t status;
+        int rc;
+
+        HG_QUEUE_POP_HEAD(&na_ucx_map->lru_queue, lru_entry);
 
+        /* Give addresses used since the last sweep a second chance */
+        status = hg_atomic_and32(&na_ucx_addr->status, ~NA_UCX_ADDR_USED);
+        if ((status & NA_UCX_ADDR_RESOLVED) && (status & NA_UCX_ADDR_USED)) {
+            HG_QUEUE_PUSH_TAIL(&na_ucx_map->lru_queue, na_ucx_addr, lru_entry);
+            continue;
+        }
+
+        /* Disconnected addresses no longer hold an open EP */
+        if (!(status & NA_UCX_ADDR_RESOLVED)) {
+            hg_atomic_and32(&na_ucx_addr->status, ~NA_UCX_ADDR_LRU);
+            na_ucx_map->lru_count--;
+            return;
+        }
+
+        /* Prevent new ops from picking up the EP before checking for ops in
+         * flight, pairs with na_ucx_addr_resolve() */
+        hg_atomic_and32(&na_ucx_addr->status, ~NA_UCX_ADDR_RESOLVED);
+        hg_atomic_fence();
+        if (hg_atomic_get32(&na_ucx_addr->nops) > 0) {
+            hg_atomic_or32(&na_ucx_addr->status, NA_UCX_ADDR_RESOLVED);
+            HG_QUEUE_PUSH_TAIL(&na_ucx_map->lru_queue, na_ucx_addr, lru_entry);
+            continue;
+        }
+
+        NA_LOG_SUBSYS_DEBUG(addr, "Evicting UCP ep %p of addr %p",
+            (void *) na_ucx_addr->ucp_ep, (void *) na_ucx_addr);
+
+        rc = hg_oa_hash_table_remove(
+            na_ucx_map->ep_map, (hg_hash_table_key_t) na_ucx_addr->ucp_ep);
+        NA_CHECK_SUBSYS_WARNING(
+            addr, rc != 1, "hg_oa_hash_table_remove() failed");
+
+        /* Let pending sends drain, address reconnects on next use */
+        na_ucp_ep_close(na_ucx_addr->ucp_ep, UCP_EP_CLOSE_MODE_FLUSH);
+        na_ucx_addr->ucp_ep = NULL;
+        na_ucx_rkey_cache_invalidate(&na_ucx_addr->rkey_cache, false);
+        hg_atomic_and32(&na_ucx_addr->status, ~NA_UCX_ADDR_LRU);
+        na_ucx_map->lru_count--;
+        return;
+    }
+
+    NA_LOG_SUBSYS_DEBUG(addr, "No EP could be evicted (%zu connected)",
+        na_ucx_map->lru_count);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE na_return_t
+na_ucx_addr_resolve(struct na_ucx_addr *na_ucx_addr)
+{
+    int32_t status;
+    na_return_t ret;
+
+    /* Order the op count increment of NA_UCX_OP_RESET() before reading the
+     * status, pairs with na_ucx_addr_map_evict() */
+    hg_atomic_fence();
+    status = hg_atomic_get32(&na_ucx_addr->status);
+
+    /* Check addr to ensure the EP for that addr is still valid */
+    if (!(status & NA_UCX_ADDR_RESOLVED)) {
+        struct na_ucx_class *na_ucx_class = na_ucx_addr->na_ucx_class;
+
+        ret = na_ucx_addr_map_update(
+            na_ucx_class, &na_ucx_class->addr_map, na_ucx_addr);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, error, ret, "Could not update NA UCX address");
+    } else if ((status & NA_UCX_ADDR_LRU) && !(status & NA_UCX_ADDR_USED))
+        hg_atomic_or32(&na_ucx_addr->status, NA_UCX_ADDR_USED);
+
+    NA_CHECK_SUBSYS_ERROR(addr, na_ucx_addr->ucp_ep == NULL, error, ret,
+        NA_ADDRNOTAVAIL, "UCP endpoint is NULL for that address");
+
+    return NA_SUCCESS;
+
+error:
     return ret;
 }
 
@@ -2551,27 +3527,37 @@ na_ucx_addr_map_remove(struct na_ucx_map *na_ucx_map, ucs_sock_addr_t *addr_key)
     na_return_t ret = NA_SUCCESS;
     int rc;
 
-    hg_thread_rwlock_wrlock(&na_ucx_map->lock);
+    hg_thread_brlock_wrlock(&na_ucx_map->lock);
 
-    na_ucx_addr = hg_hash_table_lookup(
+    na_ucx_addr = hg_oa_hash_table_lookup(
         na_ucx_map->key_map, (hg_hash_table_key_t) addr_key);
     if (na_ucx_addr == HG_HASH_TABLE_NULL)
         goto unlock;
 
     /* Remove addr key from primary map */
-    rc = hg_hash_table_remove(
+    rc = hg_oa_hash_table_remove(
         na_ucx_map->key_map, (hg_hash_table_key_t) addr_key);
     NA_CHECK_SUBSYS_ERROR(addr, rc != 1, unlock, ret, NA_NOENTRY,
-        "hg_hash_table_remove() failed");
+        "hg_oa_hash_table_remove() failed");
+
+    /* Remove from LRU queue */
+    if (hg_atomic_get32(&na_ucx_addr->status) & NA_UCX_ADDR_LRU) {
+        HG_QUEUE_REMOVE(
+            &na_ucx_map->lru_queue, na_ucx_addr, na_ucx_addr, lru_entry);
+        na_ucx_map->lru_count--;
+        hg_atomic_and32(&na_ucx_addr->status, ~NA_UCX_ADDR_LRU);
+    }
 
-    /* Remove EP handle from secondary map */
-    rc = hg_hash_table_remove(
+    /* Remove EP handle from secondary map (EP may not be connected yet) */
+    if (na_ucx_addr->ucp_ep == NULL)
+        goto unlock;
+    rc = hg_oa_hash_table_remove(
         na_ucx_map->ep_map, (hg_hash_table_key_t) na_ucx_addr->ucp_ep);
     NA_CHECK_SUBSYS_ERROR(addr, rc != 1, unlock, ret, NA_NOENTRY,
-        "hg_hash_table_remove() failed");
+        "hg_oa_hash_table_remove() failed");
 
 unlock:
-    hg_thread_rwlock_release_wrlock(&na_ucx_map->lock);
+    hg_thread_brlock_release_wrlock(&na_ucx_map->lock);
 
     return ret;
 }
@@ -2603,9 +3589,10 @@ na_ucx_addr_ep_lookup(struct na_ucx_map *na_ucx_map, ucp_ep_h ep)
     hg_hash_table_value_t value = NULL;
 
     /* Lookup key */
-    hg_thread_rwlock_rdlock(&na_ucx_map->lock);
-    value = hg_hash_table_lookup(na_ucx_map->ep_map, (hg_hash_table_key_t) ep);
-    hg_thread_rwlock_release_rdlock(&na_ucx_map->lock);
+    hg_thread_brlock_rdlock(&na_ucx_map->lock);
+    value =
+        hg_oa_hash_table_lookup(na_ucx_map->ep_map, (hg_hash_table_key_t) ep);
+    hg_thread_brlock_release_rdlock(&na_ucx_map->lock);
 
     return (value == HG_HASH_TABLE_NULL) ? NULL : (struct na_ucx_addr *) value;
 }
@@ -2617,8 +3604,10 @@ na_ucx_addr_alloc(struct na_ucx_class *na_ucx_class)
     struct na_ucx_addr *na_ucx_addr;
 
     na_ucx_addr = calloc(1, sizeof(*na_ucx_addr));
-    if (na_ucx_addr)
+    if (na_ucx_addr) {
         na_ucx_addr->na_ucx_class = na_ucx_class;
+        (void) hg_thread_spin_init(&na_ucx_addr->rkey_cache.lock);
+    }
 
     return na_ucx_addr;
 }
@@ -2630,6 +3619,7 @@ na_ucx_addr_destroy(struct na_ucx_addr *na_ucx_addr)
     NA_LOG_SUBSYS_DEBUG(addr, "Destroying address %p", (void *) na_ucx_addr);
 
     na_ucx_addr_release(na_ucx_addr);
+    (void) hg_thread_spin_destroy(&na_ucx_addr->rkey_cache.lock);
     free(na_ucx_addr);
 }
 
@@ -2667,11 +3657,14 @@ na_ucx_addr_release(struct na_ucx_addr *na_ucx_addr)
             &na_ucx_addr->na_ucx_class->addr_map, &na_ucx_addr->addr_key);
     }
 
+    /* No op can be using the keys once the address is released */
+    na_ucx_rkey_cache_invalidate(&na_ucx_addr->rkey_cache, true);
+
     if (na_ucx_addr->ucp_ep != NULL) {
         /* NB. for deserialized addresses that are not "connected" addresses, do
          * not close the EP */
         if (na_ucx_addr->worker_addr == NULL)
-            na_ucp_ep_close(na_ucx_addr->ucp_ep);
+            na_ucp_ep_close(na_ucx_addr->ucp_ep, UCP_EP_CLOSE_MODE_FORCE);
         na_ucx_addr->ucp_ep = NULL;
     }
 
@@ -2693,6 +3686,7 @@ na_ucx_addr_reset(struct na_ucx_addr *na_ucx_addr, ucs_sock_addr_t *addr_key)
     na_ucx_addr->ucp_ep = NULL;
     hg_atomic_init32(&na_ucx_addr->refcount, 1);
     hg_atomic_init32(&na_ucx_addr->status, 0);
+    hg_atomic_init32(&na_ucx_addr->nops, 0);
 
     if (addr_key && addr_key->addr) {
         memcpy(&na_ucx_addr->ss_addr, addr_key->addr, addr_key->addrlen);
@@ -2738,6 +3732,57 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_route(struct na_ucx_class *na_ucx_class, na_context_t *context,
+    struct na_ucx_addr *na_ucx_addr, uint8_t id,
+    struct na_ucx_addr **route_addr_p)
+{
+    struct na_ucx_class *worker_class = NA_UCX_CONTEXT(context)->worker_class;
+    struct na_ucx_addr *route_addr;
+    struct sockaddr_storage ss_addr;
+    ucs_sock_addr_t addr_key;
+    na_return_t ret;
+
+    /* Addresses that were not looked up by name (accepted connections or
+     * deserialized worker addresses) already target a remote worker */
+    if (!na_ucx_class->multi_worker || na_ucx_addr->addr_key.addrlen == 0 ||
+        (hg_atomic_get32(&na_ucx_addr->status) & NA_UCX_ADDR_ACCEPTED) ||
+        (id == 0 && na_ucx_addr->na_ucx_class == worker_class)) {
+        *route_addr_p = na_ucx_addr;
+        return NA_SUCCESS;
+    }
+
+    NA_CHECK_SUBSYS_ERROR(addr, id >= na_ucx_class->context_max, error, ret,
+        NA_INVALID_ARG, "Context id %" PRIu8 " exceeds max_contexts %" PRIu8,
+        id, na_ucx_class->context_max);
+
+    /* Context workers listen on consecutive ports after the class one */
+    memcpy(&ss_addr, na_ucx_addr->addr_key.addr, na_ucx_addr->addr_key.addrlen);
+    ret = na_ucx_sockaddr_port_shift(&ss_addr, id);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, error, ret, "Could not derive address of context %" PRIu8, id);
+    addr_key = (ucs_sock_addr_t){.addr = (const struct sockaddr *) &ss_addr,
+        .addrlen = na_ucx_addr->addr_key.addrlen};
+
+    /* Connect from the worker of the local context */
+    route_addr = na_ucx_addr_map_lookup(&worker_class->addr_map, &addr_key);
+    if (route_addr == NULL) {
+        na_return_t na_ret = na_ucx_addr_map_insert(worker_class,
+            &worker_class->addr_map, &addr_key, NULL, &route_addr);
+        NA_CHECK_SUBSYS_ERROR(addr, na_ret != NA_SUCCESS && na_ret != NA_EXIST,
+            error, ret, na_ret, "Could not insert address of context %" PRIu8,
+            id);
+    }
+
+    *route_addr_p = route_addr;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_ucx_addr_ref_incr(struct na_ucx_addr *na_ucx_addr)
@@ -2776,14 +3821,27 @@ na_ucx_addr_ref_decr(struct na_ucx_addr *na_ucx_addr)
 
 /*---------------------------------------------------------------------------*/
 static struct na_ucx_unexpected_info *
-na_ucx_unexpected_info_alloc(void *data, size_t data_alloc_size)
+na_ucx_unexpected_info_alloc(struct na_ucx_class NA_UNUSED *na_ucx_class,
+    void *data, size_t data_alloc_size)
 {
-    struct na_ucx_unexpected_info *na_ucx_unexpected_info;
+    struct na_ucx_unexpected_info *na_ucx_unexpected_info = NULL;
+
+#ifdef NA_UCX_HAS_UNEXPECTED_INFO_POOL
+    hg_thread_spin_lock(&na_ucx_class->unexpected_info_pool.lock);
+    na_ucx_unexpected_info =
+        HG_QUEUE_FIRST(&na_ucx_class->unexpected_info_pool.queue);
+    if (na_ucx_unexpected_info)
+        HG_QUEUE_POP_HEAD(&na_ucx_class->unexpected_info_pool.queue, entry);
+    hg_thread_spin_unlock(&na_ucx_class->unexpected_info_pool.lock);
+#endif
 
-    na_ucx_unexpected_info = (struct na_ucx_unexpected_info *) calloc(
-        1, sizeof(*na_ucx_unexpected_info));
-    NA_CHECK_SUBSYS_ERROR_NORET(msg, na_ucx_unexpected_info == NULL, error,
-        "Could not allocate unexpected info");
+    /* Fallback to allocation if pool is empty */
+    if (na_ucx_unexpected_info == NULL) {
+        na_ucx_unexpected_info = (struct na_ucx_unexpected_info *) calloc(
+            1, sizeof(*na_ucx_unexpected_info));
+        NA_CHECK_SUBSYS_ERROR_NORET(msg, na_ucx_unexpected_info == NULL, error,
+            "Could not allocate unexpected info");
+    }
 
     if (data_alloc_size > 0) {
         na_ucx_unexpected_info->data = malloc(data_alloc_size);
@@ -2806,23 +3864,37 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static void
-na_ucx_unexpected_info_free(
+na_ucx_unexpected_info_free(struct na_ucx_class NA_UNUSED *na_ucx_class,
     struct na_ucx_unexpected_info *na_ucx_unexpected_info)
 {
     if (na_ucx_unexpected_info->data_alloc)
         free(na_ucx_unexpected_info->data);
+
+#ifdef NA_UCX_HAS_UNEXPECTED_INFO_POOL
+    *na_ucx_unexpected_info = (struct na_ucx_unexpected_info){
+        .na_ucx_addr = NULL, .data = NULL, .length = 0, .tag = 0};
+
+    hg_thread_spin_lock(&na_ucx_class->unexpected_info_pool.lock);
+    HG_QUEUE_PUSH_TAIL(&na_ucx_class->unexpected_info_pool.queue,
+        na_ucx_unexpected_info, entry);
+    hg_thread_spin_unlock(&na_ucx_class->unexpected_info_pool.lock);
+#else
     free(na_ucx_unexpected_info);
+#endif
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucx_rma(struct na_ucx_class NA_UNUSED *na_ucx_class, na_context_t *context,
+na_ucx_rma(struct na_ucx_class *na_ucx_class, na_context_t *context,
     na_cb_type_t cb_type, na_cb_t callback, void *arg,
     struct na_ucx_mem_handle *local_mem_handle, na_offset_t local_offset,
     struct na_ucx_mem_handle *remote_mem_handle, na_offset_t remote_offset,
-    size_t length, struct na_ucx_addr *na_ucx_addr,
+    size_t length, struct na_ucx_addr *na_ucx_addr, uint8_t remote_id,
     struct na_ucx_op_id *na_ucx_op_id)
 {
+    struct na_ucx_rma_info *rma_info;
+    size_t posted = 0, i;
+    bool rma_iov;
     na_return_t ret;
 
     /* Check op_id */
@@ -2832,37 +3904,96 @@ na_ucx_rma(struct na_ucx_class NA_UNUSED *na_ucx_class, na_context_t *context,
         !(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED), error,
         ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
         na_cb_type_to_string(na_ucx_op_id->completion_data.callback_info.type));
+    NA_CHECK_SUBSYS_ERROR(mem,
+        hg_atomic_get32(&remote_mem_handle->type) != NA_UCX_MEM_HANDLE_REMOTE,
+        error, ret, NA_INVALID_ARG, "Invalid memory handle type");
+
+    ret = na_ucx_addr_route(
+        na_ucx_class, context, na_ucx_addr, remote_id, &na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, error, ret, "Could not route NA UCX address");
 
     NA_UCX_OP_RESET(na_ucx_op_id, context, cb_type, callback, arg, na_ucx_addr);
 
-    na_ucx_op_id->info.rma.ucp_rma_op =
-        (cb_type == NA_CB_PUT) ? na_ucp_put : na_ucp_get;
-    na_ucx_op_id->info.rma.buf =
-        (char *) local_mem_handle->desc.base + local_offset;
-    na_ucx_op_id->info.rma.remote_addr =
-        remote_mem_handle->desc.base + remote_offset;
-    na_ucx_op_id->info.rma.buf_size = length;
-    na_ucx_op_id->info.rma.remote_key = NULL;
-
-    /* There is no need to have a fully resolved address to start an RMA.
-     * This is only necessary for two-sided communication. */
-
-    /* TODO UCX requires the remote key to be bound to the origin, do we need a
-     * new API? */
-    ret = na_ucx_rma_key_resolve(na_ucx_addr->ucp_ep, remote_mem_handle,
-        &na_ucx_op_id->info.rma.remote_key);
-    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "Could not resolve remote key");
+    rma_info = &na_ucx_op_id->info.rma;
+    rma_info->ucp_rma_op = (cb_type == NA_CB_PUT) ? na_ucp_put : na_ucp_get;
+    rma_info->iov = rma_info->iov_static;
+    rma_info->spans = &rma_info->span_static;
+    rma_info->span_count = 0;
+    hg_atomic_init32(&rma_info->pending, 1); /* Released once posted */
+    hg_atomic_init32(&rma_info->ret, NA_SUCCESS);
+    hg_atomic_init32(&rma_info->request_busy, 0);
+
+    ret = na_ucx_rma_iov_build(local_mem_handle, local_offset,
+        remote_mem_handle, remote_offset, length, rma_info);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "Could not build RMA IOV");
+
+    /* EPs of looked up addresses are created on first use */
+    ret = na_ucx_addr_resolve(na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        rma, release, ret, "Could not resolve NA UCX address");
 
-    /* Post RMA op */
-    ret = na_ucx_op_id->info.rma.ucp_rma_op(na_ucx_addr->ucp_ep,
-        na_ucx_op_id->info.rma.buf, na_ucx_op_id->info.rma.buf_size,
-        na_ucx_op_id->info.rma.remote_addr, na_ucx_op_id->info.rma.remote_key,
-        na_ucx_op_id);
-    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "Could not post rma operation");
+    /* UCX requires the remote key to be bound to the origin EP */
+    for (i = 0; i < rma_info->span_count; i++) {
+        const struct na_ucx_mem_seg *remote_seg = rma_info->spans[i].remote_seg;
+
+        ret = na_ucx_rma_key_resolve(na_ucx_addr, remote_seg->rkey_buf,
+            (size_t) remote_seg->desc.rkey_buf_size, &rma_info->spans[i].key);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            rma, release, ret, "Could not resolve remote key");
+    }
+
+    /* Post one request per remote segment, local segments are gathered through
+     * an IOV datatype unless UCP rejected it before */
+    rma_iov = !na_ucx_addr->na_ucx_class->rma_iov_unsupported;
+    for (i = 0; i < rma_info->span_count; i++) {
+        struct na_ucx_rma_span *span = &rma_info->spans[i];
+        ucp_dt_iov_t *iov = &rma_info->iov[span->iov_off];
+        uint64_t remote_addr = span->remote_addr;
+        size_t j;
+
+        if (span->iovcnt > 1 && rma_iov) {
+            ret = na_ucx_rma_post(na_ucx_op_id, na_ucx_addr->ucp_ep, iov,
+                span->iovcnt, ucp_dt_make_iov(), remote_addr, span->key.rkey,
+                &posted);
+            if (ret == NA_SUCCESS)
+                continue;
+            if (ret != NA_OPNOTSUPPORTED)
+                break;
+
+            NA_LOG_SUBSYS_WARNING(rma,
+                "IOV datatype not supported by UCP RMA, posting one request "
+                "per segment");
+            na_ucx_addr->na_ucx_class->rma_iov_unsupported = true;
+            rma_iov = false;
+        }
+
+        for (j = 0; j < span->iovcnt; j++) {
+            ret = na_ucx_rma_post(na_ucx_op_id, na_ucx_addr->ucp_ep,
+                iov[j].buffer, iov[j].length, ucp_dt_make_contig(1),
+                remote_addr, span->key.rkey, &posted);
+            if (ret != NA_SUCCESS)
+                break;
+            remote_addr += iov[j].length;
+        }
+        if (ret != NA_SUCCESS)
+            break;
+    }
+    if (ret != NA_SUCCESS) {
+        NA_LOG_SUBSYS_ERROR(rma, "Could not post rma operation (%s)",
+            NA_Error_to_string(ret));
+
+        /* Requests already posted complete the op with that error */
+        if (posted == 0)
+            goto release;
+    }
+
+    /* Release posting reference */
+    na_ucx_rma_done(na_ucx_op_id, ret);
 
     return NA_SUCCESS;
 
 release:
+    na_ucx_rma_info_release(rma_info);
     NA_UCX_OP_RELEASE(na_ucx_op_id);
 
 error:
@@ -2871,49 +4002,335 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucx_rma_key_resolve(ucp_ep_h ep, struct na_ucx_mem_handle *na_ucx_mem_handle,
-    ucp_rkey_h *rkey_p)
+na_ucx_rma_iov_build(const struct na_ucx_mem_handle *local_mem_handle,
+    na_offset_t local_offset, const struct na_ucx_mem_handle *remote_mem_handle,
+    na_offset_t remote_offset, size_t length,
+    struct na_ucx_rma_info *na_ucx_rma_info)
 {
+    size_t iovcnt = 0, span_count = 0;
     na_return_t ret;
 
-    if (hg_atomic_get32(&na_ucx_mem_handle->type) ==
-        NA_UCX_MEM_HANDLE_REMOTE_UNPACKED) {
-        *rkey_p = na_ucx_mem_handle->ucp_mr.rkey;
-        return NA_SUCCESS;
+    /* Contiguous handles only need one IOV entry and one span */
+    if (local_mem_handle->desc.iovcnt > 1 ||
+        remote_mem_handle->desc.iovcnt > 1) {
+        ret = na_ucx_rma_iov_walk(local_mem_handle, local_offset,
+            remote_mem_handle, remote_offset, length, NULL, NULL, &iovcnt,
+            &span_count);
+        NA_CHECK_SUBSYS_NA_ERROR(rma, error, ret, "Could not count RMA IOV");
+
+        if (iovcnt > NA_UCX_RMA_IOV_STATIC_MAX) {
+            na_ucx_rma_info->iov =
+                (ucp_dt_iov_t *) malloc(iovcnt * sizeof(ucp_dt_iov_t));
+            NA_CHECK_SUBSYS_ERROR(rma, na_ucx_rma_info->iov == NULL, error,
+                ret, NA_NOMEM, "Could not allocate RMA IOV");
+        }
+        if (span_count > 1) {
+            na_ucx_rma_info->spans = (struct na_ucx_rma_span *) calloc(
+                span_count, sizeof(struct na_ucx_rma_span));
+            NA_CHECK_SUBSYS_ERROR(rma, na_ucx_rma_info->spans == NULL, error,
+                ret, NA_NOMEM, "Could not allocate RMA spans");
+        }
     }
 
-    hg_thread_mutex_lock(&na_ucx_mem_handle->rkey_unpack_lock);
+    memset(&na_ucx_rma_info->span_static, 0, sizeof(struct na_ucx_rma_span));
+    ret = na_ucx_rma_iov_walk(local_mem_handle, local_offset,
+        remote_mem_handle, remote_offset, length, na_ucx_rma_info->iov,
+        na_ucx_rma_info->spans, &iovcnt, &na_ucx_rma_info->span_count);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, error, ret, "Could not fill RMA IOV");
 
-    switch (hg_atomic_get32(&na_ucx_mem_handle->type)) {
-        case NA_UCX_MEM_HANDLE_REMOTE_PACKED: {
-            ucs_status_t status = ucp_ep_rkey_unpack(ep,
-                na_ucx_mem_handle->rkey_buf, &na_ucx_mem_handle->ucp_mr.rkey);
-            NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, error, ret,
-                na_ucs_status_to_na(status), "ucp_ep_rkey_unpack() failed (%s)",
-                ucs_status_string(status));
-            /* Handle is now unpacked */
-            hg_atomic_set32(
-                &na_ucx_mem_handle->type, NA_UCX_MEM_HANDLE_REMOTE_UNPACKED);
-            break;
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_rma_iov_walk(const struct na_ucx_mem_handle *local_mem_handle,
+    na_offset_t local_offset, const struct na_ucx_mem_handle *remote_mem_handle,
+    na_offset_t remote_offset, size_t length, ucp_dt_iov_t *iov,
+    struct na_ucx_rma_span *spans, size_t *iovcnt_p, size_t *span_count_p)
+{
+    const struct na_ucx_mem_seg *local_segs = local_mem_handle->segs,
+                                *remote_segs = remote_mem_handle->segs;
+    size_t local_iovcnt = (size_t) local_mem_handle->desc.iovcnt,
+           remote_iovcnt = (size_t) remote_mem_handle->desc.iovcnt;
+    size_t local_idx = 0, remote_idx = 0, iovcnt = 0, span_count = 0;
+    uint64_t local_off = (uint64_t) local_offset,
+             remote_off = (uint64_t) remote_offset;
+    na_return_t ret;
+
+    /* Skip segments before offsets */
+    while (local_idx < local_iovcnt &&
+           local_off >= local_segs[local_idx].desc.len)
+        local_off -= local_segs[local_idx++].desc.len;
+    while (remote_idx < remote_iovcnt &&
+           remote_off >= remote_segs[remote_idx].desc.len)
+        remote_off -= remote_segs[remote_idx++].desc.len;
+
+    while (length > 0) {
+        uint64_t len;
+
+        NA_CHECK_SUBSYS_ERROR(rma,
+            local_idx >= local_iovcnt || remote_idx >= remote_iovcnt, error,
+            ret, NA_OVERFLOW, "RMA length exceeds memory handle size");
+
+        len = MIN(local_segs[local_idx].desc.len - local_off,
+            remote_segs[remote_idx].desc.len - remote_off);
+        len = MIN(len, (uint64_t) length);
+
+        /* New span when starting a remote segment */
+        if (span_count == 0 || remote_off == 0) {
+            if (spans != NULL) {
+                spans[span_count].remote_seg = &remote_segs[remote_idx];
+                spans[span_count].remote_addr =
+                    remote_segs[remote_idx].desc.base + remote_off;
+                spans[span_count].iov_off = iovcnt;
+                spans[span_count].iovcnt = 0;
+            }
+            span_count++;
         }
-        case NA_UCX_MEM_HANDLE_REMOTE_UNPACKED:
-            break;
-        case NA_UCX_MEM_HANDLE_LOCAL:
-        default:
-            NA_GOTO_SUBSYS_ERROR(
-                mem, error, ret, NA_INVALID_ARG, "Invalid memory handle type");
+        if (iov != NULL) {
+            iov[iovcnt].buffer =
+                (char *) local_segs[local_idx].desc.base + local_off;
+            iov[iovcnt].length = (size_t) len;
+            spans[span_count - 1].iovcnt++;
+        }
+        iovcnt++;
+
+        local_off += len;
+        if (local_off == local_segs[local_idx].desc.len) {
+            local_idx++;
+            local_off = 0;
+        }
+        remote_off += len;
+        if (remote_off == remote_segs[remote_idx].desc.len) {
+            remote_idx++;
+            remote_off = 0;
+        }
+        length -= (size_t) len;
+    }
+
+    *iovcnt_p = iovcnt;
+    *span_count_p = span_count;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_rma_post(struct na_ucx_op_id *na_ucx_op_id, ucp_ep_h ep, void *buf,
+    size_t count, ucp_datatype_t datatype, uint64_t remote_addr,
+    ucp_rkey_h rkey, size_t *posted_p)
+{
+    na_return_t ret;
+
+    /* UCP requests other than the first are allocated by UCX */
+    hg_atomic_incr32(&na_ucx_op_id->info.rma.pending);
+    if (*posted_p == 0)
+        hg_atomic_set32(&na_ucx_op_id->info.rma.request_busy, 1);
+    ret = na_ucx_op_id->info.rma.ucp_rma_op(ep, buf, count, datatype,
+        remote_addr, rkey, (*posted_p == 0) ? na_ucx_op_id : NULL,
+        na_ucx_op_id);
+    if (ret != NA_SUCCESS) {
+        if (*posted_p == 0)
+            hg_atomic_set32(&na_ucx_op_id->info.rma.request_busy, 0);
+        hg_atomic_decr32(&na_ucx_op_id->info.rma.pending);
+        return ret;
+    }
+    (*posted_p)++;
+
+    return NA_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_rma_done(struct na_ucx_op_id *na_ucx_op_id, na_return_t ret)
+{
+    struct na_ucx_rma_info *rma_info = &na_ucx_op_id->info.rma;
+
+    /* Keep first error */
+    if (ret != NA_SUCCESS)
+        (void) hg_atomic_cas32(&rma_info->ret, NA_SUCCESS, (int32_t) ret);
+
+    if (hg_atomic_decr32(&rma_info->pending) > 0)
+        return;
+
+    na_ucx_rma_info_release(rma_info);
+    na_ucx_complete(
+        na_ucx_op_id, (na_return_t) hg_atomic_get32(&rma_info->ret));
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_rma_info_release(struct na_ucx_rma_info *na_ucx_rma_info)
+{
+    size_t i;
+
+    for (i = 0; i < na_ucx_rma_info->span_count; i++)
+        na_ucx_rma_key_release(&na_ucx_rma_info->spans[i].key);
+    na_ucx_rma_info->span_count = 0;
+
+    if (na_ucx_rma_info->iov != na_ucx_rma_info->iov_static) {
+        free(na_ucx_rma_info->iov);
+        na_ucx_rma_info->iov = na_ucx_rma_info->iov_static;
+    }
+    if (na_ucx_rma_info->spans != &na_ucx_rma_info->span_static) {
+        free(na_ucx_rma_info->spans);
+        na_ucx_rma_info->spans = &na_ucx_rma_info->span_static;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_rma_key_resolve(struct na_ucx_addr *na_ucx_addr, const void *rkey_buf,
+    size_t rkey_buf_size, struct na_ucx_rma_key *na_ucx_rma_key)
+{
+    struct na_ucx_rkey_cache *rkey_cache = &na_ucx_addr->rkey_cache;
+    struct na_ucx_rkey_entry *rkey_entry = NULL;
+    ucs_status_t status;
+    na_return_t ret;
+    size_t i;
+
+    hg_thread_spin_lock(&rkey_cache->lock);
+
+    if (rkey_cache->entries == NULL) {
+        rkey_cache->entries = (struct na_ucx_rkey_entry *) calloc(
+            NA_UCX_RKEY_CACHE_SIZE, sizeof(*rkey_cache->entries));
+        NA_CHECK_SUBSYS_ERROR(mem, rkey_cache->entries == NULL, unlock, ret,
+            NA_NOMEM, "Could not allocate rkey cache");
+    }
+
+    /* Look for the same packed key already unpacked on that EP, while
+     * keeping track of the least recently used idle entry */
+    for (i = 0; i < NA_UCX_RKEY_CACHE_SIZE; i++) {
+        struct na_ucx_rkey_entry *entry = &rkey_cache->entries[i];
+
+        if (entry->ep == na_ucx_addr->ucp_ep &&
+            entry->rkey_buf_size == rkey_buf_size &&
+            memcmp(entry->rkey_buf, rkey_buf, rkey_buf_size) == 0) {
+            hg_atomic_incr32(&entry->refcount);
+            entry->last_use = ++rkey_cache->clock;
+            hg_thread_spin_unlock(&rkey_cache->lock);
+
+            na_ucx_rma_key->rkey = entry->rkey;
+            na_ucx_rma_key->entry = entry;
+
+            return NA_SUCCESS;
+        }
+
+        if (hg_atomic_get32(&entry->refcount) == 0 &&
+            (rkey_entry == NULL || entry->last_use < rkey_entry->last_use))
+            rkey_entry = entry;
+    }
+
+    if (rkey_entry == NULL) {
+        hg_thread_spin_unlock(&rkey_cache->lock);
+
+        /* All cached keys are in use, unpack a key for that op only */
+        status = ucp_ep_rkey_unpack(
+            na_ucx_addr->ucp_ep, rkey_buf, &na_ucx_rma_key->rkey);
+        NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, error, ret,
+            na_ucs_status_to_na(status), "ucp_ep_rkey_unpack() failed (%s)",
+            ucs_status_string(status));
+        na_ucx_rma_key->tmp = true;
+
+        return NA_SUCCESS;
     }
 
-    *rkey_p = na_ucx_mem_handle->ucp_mr.rkey;
-    hg_thread_mutex_unlock(&na_ucx_mem_handle->rkey_unpack_lock);
+    /* Replace least recently used entry */
+    if (rkey_entry->rkey != NULL) {
+        ucp_rkey_destroy(rkey_entry->rkey);
+        rkey_entry->rkey = NULL;
+    }
+    rkey_entry->ep = NULL;
+    rkey_entry->last_use = 0;
+    if (rkey_entry->rkey_buf_size != rkey_buf_size) {
+        free(rkey_entry->rkey_buf);
+        rkey_entry->rkey_buf_size = 0;
+        rkey_entry->rkey_buf = malloc(rkey_buf_size);
+        NA_CHECK_SUBSYS_ERROR(mem, rkey_entry->rkey_buf == NULL, unlock, ret,
+            NA_NOMEM, "Could not allocate rkey buffer");
+    }
+    memcpy(rkey_entry->rkey_buf, rkey_buf, rkey_buf_size);
+
+    status = ucp_ep_rkey_unpack(
+        na_ucx_addr->ucp_ep, rkey_entry->rkey_buf, &rkey_entry->rkey);
+    NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, unlock, ret,
+        na_ucs_status_to_na(status), "ucp_ep_rkey_unpack() failed (%s)",
+        ucs_status_string(status));
+    rkey_entry->rkey_buf_size = rkey_buf_size;
+    rkey_entry->ep = na_ucx_addr->ucp_ep;
+    rkey_entry->last_use = ++rkey_cache->clock;
+    hg_atomic_incr32(&rkey_entry->refcount);
+
+    hg_thread_spin_unlock(&rkey_cache->lock);
+
+    na_ucx_rma_key->rkey = rkey_entry->rkey;
+    na_ucx_rma_key->entry = rkey_entry;
 
     return NA_SUCCESS;
 
+unlock:
+    hg_thread_spin_unlock(&rkey_cache->lock);
 error:
-    hg_thread_mutex_unlock(&na_ucx_mem_handle->rkey_unpack_lock);
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ucx_rma_key_release(struct na_ucx_rma_key *na_ucx_rma_key)
+{
+    if (na_ucx_rma_key->entry != NULL) {
+        hg_atomic_decr32(&na_ucx_rma_key->entry->refcount);
+        na_ucx_rma_key->entry = NULL;
+    } else if (na_ucx_rma_key->tmp) {
+        ucp_rkey_destroy(na_ucx_rma_key->rkey);
+        na_ucx_rma_key->tmp = false;
+    }
+    na_ucx_rma_key->rkey = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_ucx_rkey_cache_invalidate(struct na_ucx_rkey_cache *rkey_cache, bool flush)
+{
+    size_t i;
+
+    hg_thread_spin_lock(&rkey_cache->lock);
+    if (rkey_cache->entries == NULL)
+        goto unlock;
+
+    for (i = 0; i < NA_UCX_RKEY_CACHE_SIZE; i++) {
+        struct na_ucx_rkey_entry *entry = &rkey_cache->entries[i];
+
+        /* Keys still used by ops are destroyed when the entry is reused */
+        entry->ep = NULL;
+        if (entry->rkey != NULL &&
+            (flush || hg_atomic_get32(&entry->refcount) == 0)) {
+            ucp_rkey_destroy(entry->rkey);
+            entry->rkey = NULL;
+            entry->last_use = 0;
+        }
+        if (flush) {
+            free(entry->rkey_buf);
+            entry->rkey_buf = NULL;
+            entry->rkey_buf_size = 0;
+        }
+    }
+
+    if (flush) {
+        free(rkey_cache->entries);
+        rkey_cache->entries = NULL;
+    }
+
+unlock:
+    hg_thread_spin_unlock(&rkey_cache->lock);
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_ucx_complete(struct na_ucx_op_id *na_ucx_op_id, na_return_t cb_ret)
@@ -2940,11 +4357,85 @@ na_ucx_release(void *arg)
         "Releasing resources from an uncompleted operation");
 
     if (na_ucx_op_id && na_ucx_op_id->addr != NULL) {
+        hg_atomic_decr32(&na_ucx_op_id->addr->nops);
         na_ucx_addr_ref_decr(na_ucx_op_id->addr);
         na_ucx_op_id->addr = NULL;
     }
 }
 
+/*---------------------------------------------------------------------------*/
+static struct na_cb_completion_data *
+na_ucx_multi_recv_reserve(struct na_ucx_op_id *na_ucx_op_id,
+    struct na_ucx_addr *source, na_tag_t tag, size_t buf_size,
+    size_t msg_size_max, bool close)
+{
+    struct na_ucx_completion_multi *multi = &na_ucx_op_id->multi;
+    struct na_ucx_msg_info *msg_info = &na_ucx_op_id->info.msg;
+    struct na_cb_completion_data *completion_data;
+    int32_t head = hg_atomic_get32(&multi->head), next;
+    void *buf = (char *) msg_info->buf.ptr + msg_info->buf_offset;
+    bool last;
+
+    /* A multi-recv operation that is still queued always has a free entry,
+     * the buffer is returned as consumed when taking the last one */
+    completion_data = &multi->data[head];
+    next = (head + 1) & multi->mask;
+    hg_atomic_set32(&multi->head, next);
+    msg_info->buf_offset =
+        NA_UCX_MULTI_RECV_ALIGN(msg_info->buf_offset + buf_size);
+    last = close ||
+           ((next + 1) & multi->mask) == hg_atomic_get32(&multi->tail) ||
+           msg_info->buf_offset >= msg_info->buf_size ||
+           msg_info->buf_size - msg_info->buf_offset < msg_size_max;
+
+    *completion_data = (struct na_cb_completion_data){
+        .callback_info =
+            (struct na_cb_info){
+                .info.multi_recv_unexpected =
+                    (struct na_cb_info_multi_recv_unexpected){
+                        .actual_buf_size = buf_size,
+                        .source = (na_addr_t *) source,
+                        .tag = tag,
+                        .actual_buf = buf,
+                        .last = last},
+                .arg = na_ucx_op_id->completion_data.callback_info.arg,
+                .type = NA_CB_MULTI_RECV_UNEXPECTED,
+                .ret = NA_SUCCESS},
+        .callback = na_ucx_op_id->completion_data.callback,
+        .plugin_callback = na_ucx_release_multi,
+        .plugin_callback_args = na_ucx_op_id};
+
+    return completion_data;
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ucx_complete_multi(struct na_ucx_op_id *na_ucx_op_id,
+    struct na_cb_completion_data *completion_data, na_return_t cb_ret)
+{
+    /* Op ID is completed once its buffer has been consumed */
+    if (completion_data->callback_info.info.multi_recv_unexpected.last)
+        hg_atomic_or32(&na_ucx_op_id->status, NA_UCX_OP_COMPLETED);
+
+    /* Set callback ret */
+    completion_data->callback_info.ret = cb_ret;
+
+    /* Add entry to NA completion queue */
+    na_cb_completion_add(na_ucx_op_id->context, completion_data);
+}
+
+/*---------------------------------------------------------------------------*/
+static NA_INLINE void
+na_ucx_release_multi(void *arg)
+{
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) arg;
+    struct na_ucx_completion_multi *multi = &na_ucx_op_id->multi;
+
+    /* Completions are triggered in order */
+    hg_atomic_set32(
+        &multi->tail, (hg_atomic_get32(&multi->tail) + 1) & multi->mask);
+}
+
 /********************/
 /* Plugin callbacks */
 /********************/
@@ -3033,12 +4524,17 @@ na_ucx_initialize(
     struct sockaddr_storage ucp_listener_ss_addr;
     ucs_sock_addr_t addr_key = {.addr = NULL, .addrlen = 0};
     ucp_config_t *config = NULL;
-    bool no_wait = false;
+    bool no_wait = false, huge_pages = false;
+#ifdef NA_UCX_HAS_MEM_POOL
+    struct hg_mem_budget *mem_budget = NULL;
+#endif
     size_t unexpected_size_max = 0, expected_size_max = 0;
     ucs_thread_mode_t context_thread_mode = UCS_THREAD_MODE_SINGLE,
                       worker_thread_mode = UCS_THREAD_MODE_MULTI;
+    uint8_t context_max = 1;
+    const char *env;
     na_return_t ret;
-#ifdef NA_UCX_HAS_ADDR_POOL
+#if defined(NA_UCX_HAS_ADDR_POOL) || defined(NA_UCX_HAS_UNEXPECTED_INFO_POOL)
     unsigned int i;
 #endif
 #ifdef NA_UCX_HAS_LIB_QUERY
@@ -3051,8 +4547,8 @@ na_ucx_initialize(
         if (na_info->na_init_info->progress_mode & NA_NO_BLOCK)
             no_wait = true;
         /* Max contexts */
-        // if (na_info->na_init_info->max_contexts)
-        //     context_max = na_info->na_init_info->max_contexts;
+        if (na_info->na_init_info->max_contexts)
+            context_max = na_info->na_init_info->max_contexts;
         /* Sizes */
         if (na_info->na_init_info->max_unexpected_size)
             unexpected_size_max = na_info->na_init_info->max_unexpected_size;
@@ -3065,6 +4561,12 @@ na_ucx_initialize(
 
         if (na_info->na_init_info->thread_mode & NA_THREAD_MODE_SINGLE_CTX)
             worker_thread_mode = UCS_THREAD_MODE_SINGLE;
+        /* Huge pages */
+        huge_pages = na_info->na_init_info->use_huge_pages;
+#ifdef NA_UCX_HAS_MEM_POOL
+        /* Memory budget */
+        mem_budget = na_info->na_init_info->mem_budget;
+#endif
     }
 
 #ifdef NA_UCX_HAS_LIB_QUERY
@@ -3116,6 +4618,31 @@ na_ucx_initialize(
     /* Set wait mode */
     na_ucx_class->no_wait = no_wait;
 
+#ifndef _WIN32
+    /* Rate of arms that end up in a wait is
+     * (arm_count - arm_busy_count) / (arm_count + arm_skip_count) */
+    HG_LOG_ADD_COUNTER64(
+        na, &na_ucx_class->arm_count, "ucx_arm_count", "Worker arm attempts");
+    HG_LOG_ADD_COUNTER64(na, &na_ucx_class->arm_busy_count,
+        "ucx_arm_busy_count", "Arms that found pending events");
+    HG_LOG_ADD_COUNTER64(na, &na_ucx_class->arm_skip_count,
+        "ucx_arm_skip_count", "Arms skipped while busy");
+    HG_LOG_ADD_COUNTER64(na, &na_ucx_class->mem_map_count,
+        "ucx_mem_map_count", "Memory segments registered");
+#endif
+
+    /* Create one worker per context (disabled by default) */
+    env = getenv("NA_UCX_MULTI_WORKER");
+    na_ucx_class->multi_worker = (env != NULL && env[0] != '0' &&
+                                  env[0] != 'n' && env[0] != 'N' &&
+                                  context_max > 1);
+    na_ucx_class->context_max = context_max;
+    na_ucx_class->thread_mode = worker_thread_mode;
+
+    /* Limit number of EPs that we keep connected (no limit by default) */
+    if ((env = getenv("NA_UCX_MAX_EPS")) != NULL)
+        na_ucx_class->ep_max = (size_t) atol(env);
+
     /* TODO may need to query UCX */
     na_ucx_class->unexpected_size_max =
         unexpected_size_max ? unexpected_size_max : NA_UCX_MSG_SIZE_MAX;
@@ -3171,6 +4698,20 @@ na_ucx_initialize(
     }
 #endif
 
+#ifdef NA_UCX_HAS_UNEXPECTED_INFO_POOL
+    /* Create pool of unexpected infos for messages received before a recv is
+     * posted */
+    for (i = 0; i < NA_UCX_UNEXPECTED_INFO_POOL_SIZE; i++) {
+        struct na_ucx_unexpected_info *na_ucx_unexpected_info =
+            (struct na_ucx_unexpected_info *) calloc(
+                1, sizeof(*na_ucx_unexpected_info));
+        NA_CHECK_SUBSYS_ERROR(cls, na_ucx_unexpected_info == NULL, error, ret,
+            NA_NOMEM, "Could not allocate unexpected info");
+        HG_QUEUE_PUSH_TAIL(&na_ucx_class->unexpected_info_pool.queue,
+            na_ucx_unexpected_info, entry);
+    }
+#endif
+
     /* Create self address */
     ret = na_ucx_addr_create(na_ucx_class, &addr_key, &na_ucx_class->self_addr);
     NA_CHECK_SUBSYS_NA_ERROR(cls, error, ret, "Could not create self address");
@@ -3183,18 +4724,25 @@ na_ucx_initialize(
 
     /* Register initial mempool */
 #ifdef NA_UCX_HAS_MEM_POOL
-    na_ucx_class->mem_pool = hg_mem_pool_create(
+    na_ucx_class->mem_pool = hg_mem_pool_create_opt(
         MAX(na_ucx_class->unexpected_size_max, na_ucx_class->expected_size_max),
-        NA_UCX_MEM_CHUNK_COUNT, NA_UCX_MEM_BLOCK_COUNT, na_ucp_mem_buf_register,
-        0, na_ucp_mem_buf_deregister, (void *) na_ucx_class);
+        NA_UCX_MEM_CHUNK_COUNT, NA_UCX_MEM_BLOCK_COUNT, huge_pages,
+        na_ucp_mem_buf_register, 0, na_ucp_mem_buf_deregister,
+        (void *) na_ucx_class);
     NA_CHECK_SUBSYS_ERROR(cls, na_ucx_class->mem_pool == NULL, error, ret,
         NA_NOMEM,
         "Could not create memory pool with %d blocks of size %d x %zu bytes",
         NA_UCX_MEM_BLOCK_COUNT, NA_UCX_MEM_CHUNK_COUNT,
         MAX(na_ucx_class->unexpected_size_max,
             na_ucx_class->expected_size_max));
+    if (mem_budget != NULL) {
+        int rc = hg_mem_pool_set_budget(na_ucx_class->mem_pool, mem_budget);
+        NA_CHECK_SUBSYS_ERROR(cls, rc != HG_UTIL_SUCCESS, error, ret, NA_NOMEM,
+            "Could not charge memory pool to memory budget");
+    }
 #endif
 
+    na_ucx_class->na_class = na_class;
     na_class->plugin_class = (void *) na_ucx_class;
 
     /* No longer needed */
@@ -3216,7 +4764,6 @@ static na_return_t
 na_ucx_finalize(na_class_t *na_class)
 {
     struct na_ucx_class *na_ucx_class = NA_UCX_CLASS(na_class);
-    hg_hash_table_iter_t addr_table_iter;
     na_return_t ret = NA_SUCCESS;
 
     if (na_ucx_class == NULL)
@@ -3226,26 +4773,85 @@ na_ucx_finalize(na_class_t *na_class)
         done, ret, NA_BUSY, "Contexts were not destroyed (%d remaining)",
         hg_atomic_get32(&na_ucx_class->ncontexts));
 
-    /* Iterate over remaining addresses and free them */
-    hg_hash_table_iterate(na_ucx_class->addr_map.key_map, &addr_table_iter);
-    while (hg_hash_table_iter_has_more(&addr_table_iter)) {
-        struct na_ucx_addr *na_ucx_addr =
-            (struct na_ucx_addr *) hg_hash_table_iter_next(&addr_table_iter);
-        na_ucx_addr_destroy(na_ucx_addr);
-    }
+    na_ucx_class_addrs_free(na_ucx_class);
+    na_ucx_class_free(na_ucx_class);
+    na_class->plugin_class = NULL;
 
-#ifdef NA_UCX_HAS_ADDR_POOL
-    /* Free addresse pool */
-    while (!HG_QUEUE_IS_EMPTY(&na_ucx_class->addr_pool.queue)) {
-        struct na_ucx_addr *na_ucx_addr =
-            HG_QUEUE_FIRST(&na_ucx_class->addr_pool.queue);
-        HG_QUEUE_POP_HEAD(&na_ucx_class->addr_pool.queue, entry);
-        na_ucx_addr_destroy(na_ucx_addr);
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+na_ucx_has_opt_feature(na_class_t NA_UNUSED *na_class, unsigned long flags)
+{
+    return !(flags & ~(NA_OPT_MULTI_RECV | NA_OPT_ATOMIC));
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_context_create(
+    na_class_t *na_class, void **plugin_context_p, uint8_t id)
+{
+    struct na_ucx_class *na_ucx_class = NA_UCX_CLASS(na_class);
+    struct na_ucx_context *na_ucx_context = NULL;
+    na_return_t ret;
+
+    na_ucx_context = (struct na_ucx_context *) malloc(sizeof(*na_ucx_context));
+    NA_CHECK_SUBSYS_ERROR(ctx, na_ucx_context == NULL, error, ret, NA_NOMEM,
+        "Could not allocate NA UCX context");
+
+    if (na_ucx_class->multi_worker && id > 0) {
+        NA_CHECK_SUBSYS_ERROR(fatal, id >= na_ucx_class->context_max, error,
+            ret, NA_OPNOTSUPPORTED,
+            "context id %" PRIu8 ", max_contexts %" PRIu8, id,
+            na_ucx_class->context_max);
+
+        /* Context progresses its own worker */
+        ret = na_ucx_worker_class_create(
+            na_ucx_class, id, &na_ucx_context->worker_class);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            ctx, error, ret, "Could not create context worker");
+    } else
+        na_ucx_context->worker_class = na_ucx_class;
+    hg_atomic_init32(&na_ucx_context->arm_skip, 0);
+
+    hg_atomic_incr32(&na_ucx_class->ncontexts);
+    *plugin_context_p = (void *) na_ucx_context;
+
+    return NA_SUCCESS;
+
+error:
+    free(na_ucx_context);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_context_destroy(na_class_t *na_class, void *plugin_context)
+{
+    struct na_ucx_class *na_ucx_class = NA_UCX_CLASS(na_class);
+    struct na_ucx_context *na_ucx_context =
+        (struct na_ucx_context *) plugin_context;
+    struct na_ucx_class *worker_class = na_ucx_context->worker_class;
+    na_return_t ret = NA_SUCCESS;
+
+    if (worker_class != na_ucx_class) {
+        bool empty;
+
+        /* Check that unexpected op queue is empty */
+        hg_thread_spin_lock(&worker_class->unexpected_op_queue.lock);
+        empty = HG_QUEUE_IS_EMPTY(&worker_class->unexpected_op_queue.queue);
+        hg_thread_spin_unlock(&worker_class->unexpected_op_queue.lock);
+        NA_CHECK_SUBSYS_ERROR(ctx, !empty, done, ret, NA_BUSY,
+            "Unexpected op queue should be empty");
+
+        na_ucx_worker_class_destroy(worker_class);
     }
-#endif
 
-    na_ucx_class_free(na_ucx_class);
-    na_class->plugin_class = NULL;
+    free(na_ucx_context);
+    hg_atomic_decr32(&na_ucx_class->ncontexts);
 
 done:
     return ret;
@@ -3253,7 +4859,7 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_op_id_t *
-na_ucx_op_create(na_class_t *na_class, unsigned long NA_UNUSED flags)
+na_ucx_op_create(na_class_t *na_class, unsigned long flags)
 {
     struct na_ucx_op_id *na_ucx_op_id = NULL;
 
@@ -3266,6 +4872,23 @@ na_ucx_op_create(na_class_t *na_class, unsigned long NA_UNUSED flags)
 
     memset(na_ucx_op_id, 0, sizeof(struct na_ucx_op_id));
 
+    /* Multi-recv operations complete once per message */
+    if (flags & NA_OP_MULTI) {
+        na_ucx_op_id->multi.data = (struct na_cb_completion_data *) calloc(
+            NA_UCX_OP_MULTI_CQ_SIZE, sizeof(struct na_cb_completion_data));
+        if (na_ucx_op_id->multi.data == NULL) {
+            hg_mem_header_free(NA_UCX_CLASS(na_class)->ucp_request_size,
+                alignof(struct na_ucx_op_id), na_ucx_op_id);
+            na_ucx_op_id = NULL;
+            NA_GOTO_SUBSYS_ERROR_NORET(op, out,
+                "Could not allocate %d completion data entries",
+                NA_UCX_OP_MULTI_CQ_SIZE);
+        }
+        na_ucx_op_id->multi.mask = NA_UCX_OP_MULTI_CQ_SIZE - 1;
+        hg_atomic_init32(&na_ucx_op_id->multi.head, 0);
+        hg_atomic_init32(&na_ucx_op_id->multi.tail, 0);
+    }
+
     /* Completed by default */
     hg_atomic_init32(&na_ucx_op_id->status, NA_UCX_OP_COMPLETED);
 
@@ -3284,10 +4907,28 @@ na_ucx_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
         "Attempting to use OP ID that was not completed (%s)",
         na_cb_type_to_string(na_ucx_op_id->completion_data.callback_info.type));
 
+    free(na_ucx_op_id->multi.data);
     hg_mem_header_free(NA_UCX_CLASS(na_class)->ucp_request_size,
         alignof(struct na_ucx_op_id), na_ucx_op_id);
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_op_reset(na_class_t NA_UNUSED *na_class, na_op_id_t *op_id)
+{
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
+
+    if (!(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED))
+        return NA_BUSY;
+
+    /* Addr ref was dropped on release, only clear stale user data */
+    na_ucx_op_id->context = NULL;
+    na_ucx_op_id->completion_data.callback = NULL;
+    na_ucx_op_id->completion_data.callback_info.arg = NULL;
+
+    return NA_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ucx_addr_lookup(na_class_t *na_class, const char *name, na_addr_t **addr_p)
@@ -3359,6 +5000,27 @@ error:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_addr_warm(
+    na_class_t NA_UNUSED *na_class, na_addr_t *const *addrs, size_t count)
+{
+    size_t i;
+    na_return_t ret;
+
+    /* Create EPs now, UCX completes the wire-up in the background */
+    for (i = 0; i < count; i++) {
+        ret = na_ucx_addr_resolve((struct na_ucx_addr *) addrs[i]);
+        NA_CHECK_SUBSYS_NA_ERROR(
+            addr, error, ret, "Could not resolve address %zu", i);
+    }
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static NA_INLINE void
 na_ucx_addr_free(na_class_t NA_UNUSED *na_class, na_addr_t *addr)
@@ -3593,10 +5255,10 @@ na_ucx_msg_buf_free(na_class_t *na_class, void *buf, void *plugin_data)
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucx_msg_send_unexpected(na_class_t NA_UNUSED *na_class,
-    na_context_t *context, na_cb_t callback, void *arg, const void *buf,
-    size_t buf_size, void NA_UNUSED *plugin_data, na_addr_t *dest_addr,
-    uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+na_ucx_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, const void *buf, size_t buf_size,
+    void NA_UNUSED *plugin_data, na_addr_t *dest_addr, uint8_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) dest_addr;
     struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
@@ -3610,21 +5272,19 @@ na_ucx_msg_send_unexpected(na_class_t NA_UNUSED *na_class,
         ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
         na_cb_type_to_string(na_ucx_op_id->completion_data.callback_info.type));
 
-    /* Check addr to ensure the EP for that addr is still valid */
-    if (!(hg_atomic_get32(&na_ucx_addr->status) & NA_UCX_ADDR_RESOLVED)) {
-        struct na_ucx_class *na_ucx_class = NA_UCX_CLASS(na_class);
-
-        ret = na_ucx_addr_map_update(
-            na_ucx_class, &na_ucx_class->addr_map, na_ucx_addr);
-        NA_CHECK_SUBSYS_NA_ERROR(
-            addr, error, ret, "Could not update NA UCX address");
-    }
-    NA_CHECK_SUBSYS_ERROR(msg, na_ucx_addr->ucp_ep == NULL, error, ret,
-        NA_ADDRNOTAVAIL, "UCP endpoint is NULL for that address");
+    /* Pick the address of the remote context worker */
+    ret = na_ucx_addr_route(
+        NA_UCX_CLASS(na_class), context, na_ucx_addr, dest_id, &na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, error, ret, "Could not route NA UCX address");
 
     NA_UCX_OP_RESET(na_ucx_op_id, context, NA_CB_SEND_UNEXPECTED, callback, arg,
         na_ucx_addr);
 
+    ret = na_ucx_addr_resolve(na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, release, ret, "Could not resolve NA UCX address");
+
     /* We assume buf remains valid (safe because we pre-allocate buffers) */
     na_ucx_op_id->info.msg = (struct na_ucx_msg_info){
         .buf.const_ptr = buf, .buf_size = buf_size, .tag = (ucp_tag_t) tag};
@@ -3644,9 +5304,9 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucx_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
-    na_cb_t callback, void *arg, void *buf, size_t buf_size,
-    void NA_UNUSED *plugin_data, na_op_id_t *op_id)
+na_ucx_msg_recv_unexpected(na_class_t NA_UNUSED *na_class,
+    na_context_t *context, na_cb_t callback, void *arg, void *buf,
+    size_t buf_size, void NA_UNUSED *plugin_data, na_op_id_t *op_id)
 {
     struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
     na_return_t ret;
@@ -3666,7 +5326,49 @@ na_ucx_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     na_ucx_op_id->info.msg = (struct na_ucx_msg_info){
         .buf.ptr = buf, .buf_size = buf_size, .tag = (ucp_tag_t) 0};
 
-    na_ucp_am_recv(NA_UCX_CLASS(na_class), na_ucx_op_id);
+    na_ucp_am_recv(NA_UCX_CONTEXT(context)->worker_class, na_ucx_op_id);
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_msg_multi_recv_unexpected(na_class_t *na_class, na_context_t *context,
+    na_cb_t callback, void *arg, void *buf, size_t buf_size,
+    void NA_UNUSED *plugin_data, na_op_id_t *op_id)
+{
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
+    size_t unexpected_size_max = NA_UCX_CLASS(na_class)->unexpected_size_max;
+    na_return_t ret;
+
+    NA_CHECK_SUBSYS_ERROR(msg, buf_size < unexpected_size_max, error, ret,
+        NA_INVALID_ARG,
+        "Multi-recv buffer must hold at least one message of max size (%zu)",
+        unexpected_size_max);
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_ucx_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op, na_ucx_op_id->multi.data == NULL, error, ret,
+        NA_INVALID_ARG, "Operation ID was not created with NA_OP_MULTI");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_ucx_op_id->completion_data.callback_info.type));
+
+    NA_UCX_OP_RESET(na_ucx_op_id, context, NA_CB_MULTI_RECV_UNEXPECTED,
+        callback, arg, NULL);
+
+    /* We assume buf remains valid (safe because we pre-allocate buffers) */
+    na_ucx_op_id->info.msg = (struct na_ucx_msg_info){.buf.ptr = buf,
+        .buf_size = buf_size,
+        .buf_offset = 0,
+        .tag = (ucp_tag_t) 0};
+
+    na_ucp_am_multi_recv(NA_UCX_CONTEXT(context)->worker_class, na_ucx_op_id);
 
     return NA_SUCCESS;
 
@@ -3676,10 +5378,10 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucx_msg_send_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
+na_ucx_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_cb_t callback, void *arg, const void *buf, size_t buf_size,
-    void NA_UNUSED *plugin_data, na_addr_t *dest_addr,
-    uint8_t NA_UNUSED dest_id, na_tag_t tag, na_op_id_t *op_id)
+    void NA_UNUSED *plugin_data, na_addr_t *dest_addr, uint8_t dest_id,
+    na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) dest_addr;
     struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
@@ -3693,21 +5395,19 @@ na_ucx_msg_send_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
         ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
         na_cb_type_to_string(na_ucx_op_id->completion_data.callback_info.type));
 
-    /* Check addr to ensure the EP for that addr is still valid */
-    if (!(hg_atomic_get32(&na_ucx_addr->status) & NA_UCX_ADDR_RESOLVED)) {
-        struct na_ucx_class *na_ucx_class = NA_UCX_CLASS(na_class);
-
-        ret = na_ucx_addr_map_update(
-            na_ucx_class, &na_ucx_class->addr_map, na_ucx_addr);
-        NA_CHECK_SUBSYS_NA_ERROR(
-            addr, error, ret, "Could not update NA UCX address");
-    }
-    NA_CHECK_SUBSYS_ERROR(msg, na_ucx_addr->ucp_ep == NULL, error, ret,
-        NA_ADDRNOTAVAIL, "UCP endpoint is NULL for that address");
+    /* Pick the address of the remote context worker */
+    ret = na_ucx_addr_route(
+        NA_UCX_CLASS(na_class), context, na_ucx_addr, dest_id, &na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, error, ret, "Could not route NA UCX address");
 
     NA_UCX_OP_RESET(
         na_ucx_op_id, context, NA_CB_SEND_EXPECTED, callback, arg, na_ucx_addr);
 
+    ret = na_ucx_addr_resolve(na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        addr, release, ret, "Could not resolve NA UCX address");
+
     /* We assume buf remains valid (safe because we pre-allocate buffers) */
     na_ucx_op_id->info.msg = (struct na_ucx_msg_info){
         .buf.const_ptr = buf, .buf_size = buf_size, .tag = (ucp_tag_t) tag};
@@ -3727,9 +5427,9 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucx_msg_recv_expected(na_class_t *na_class, na_context_t *context,
-    na_cb_t callback, void *arg, void *buf, size_t buf_size,
-    void NA_UNUSED *plugin_data, na_addr_t *source_addr,
+na_ucx_msg_recv_expected(na_class_t NA_UNUSED *na_class,
+    na_context_t *context, na_cb_t callback, void *arg, void *buf,
+    size_t buf_size, void NA_UNUSED *plugin_data, na_addr_t *source_addr,
     uint8_t NA_UNUSED source_id, na_tag_t tag, na_op_id_t *op_id)
 {
     struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) source_addr;
@@ -3751,8 +5451,8 @@ na_ucx_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_ucx_op_id->info.msg = (struct na_ucx_msg_info){
         .buf.ptr = buf, .buf_size = buf_size, .tag = (ucp_tag_t) tag};
 
-    ret = na_ucp_msg_recv(NA_UCX_CLASS(na_class)->ucp_worker, buf, buf_size,
-        (ucp_tag_t) tag, na_ucx_op_id);
+    ret = na_ucp_msg_recv(NA_UCX_CONTEXT(context)->worker_class->ucp_worker,
+        buf, buf_size, (ucp_tag_t) tag, na_ucx_op_id);
     NA_CHECK_SUBSYS_NA_ERROR(
         msg, release, ret, "Could not post expected msg recv");
 
@@ -3782,14 +5482,66 @@ na_ucx_mem_handle_create(na_class_t NA_UNUSED *na_class, void *buf,
     na_ucx_mem_handle->desc.base = (uint64_t) buf;
     na_ucx_mem_handle->desc.flags = flags & 0xff;
     na_ucx_mem_handle->desc.len = (uint64_t) buf_size;
+    na_ucx_mem_handle->desc.iovcnt = 1;
+    na_ucx_mem_handle->seg.desc.base = na_ucx_mem_handle->desc.base;
+    na_ucx_mem_handle->seg.desc.len = na_ucx_mem_handle->desc.len;
+    na_ucx_mem_handle->segs = &na_ucx_mem_handle->seg;
+    hg_atomic_init32(&na_ucx_mem_handle->type, NA_UCX_MEM_HANDLE_LOCAL);
+
+    *mem_handle_p = (na_mem_handle_t *) na_ucx_mem_handle;
+
+    return NA_SUCCESS;
+
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_mem_handle_create_segments(na_class_t NA_UNUSED *na_class,
+    struct na_segment *segments, size_t segment_count, unsigned long flags,
+    na_mem_handle_t **mem_handle_p)
+{
+    struct na_ucx_mem_handle *na_ucx_mem_handle = NULL;
+    na_return_t ret;
+    size_t i;
+
+    NA_CHECK_SUBSYS_WARNING(mem, segment_count == 1, "Segment count is 1");
+
+    NA_CHECK_SUBSYS_ERROR(fatal, segment_count > NA_UCX_IOV_MAX, error, ret,
+        NA_INVALID_ARG, "Segment count exceeds max segment count (%d)",
+        NA_UCX_IOV_MAX);
+
+    /* Allocate memory handle */
+    na_ucx_mem_handle = (struct na_ucx_mem_handle *) calloc(
+        1, sizeof(struct na_ucx_mem_handle));
+    NA_CHECK_SUBSYS_ERROR(mem, na_ucx_mem_handle == NULL, error, ret, NA_NOMEM,
+        "Could not allocate NA UCX memory handle");
+
+    na_ucx_mem_handle->segs = (struct na_ucx_mem_seg *) calloc(
+        segment_count, sizeof(struct na_ucx_mem_seg));
+    NA_CHECK_SUBSYS_ERROR(mem, na_ucx_mem_handle->segs == NULL, error, ret,
+        NA_NOMEM, "Could not allocate segments");
+
+    for (i = 0; i < segment_count; i++) {
+        na_ucx_mem_handle->segs[i].desc.base = (uint64_t) segments[i].base;
+        na_ucx_mem_handle->segs[i].desc.len = (uint64_t) segments[i].len;
+        na_ucx_mem_handle->desc.len += (uint64_t) segments[i].len;
+    }
+    na_ucx_mem_handle->desc.base = na_ucx_mem_handle->segs[0].desc.base;
+    na_ucx_mem_handle->desc.flags = flags & 0xff;
+    na_ucx_mem_handle->desc.iovcnt = (uint32_t) segment_count;
     hg_atomic_init32(&na_ucx_mem_handle->type, NA_UCX_MEM_HANDLE_LOCAL);
-    hg_thread_mutex_init(&na_ucx_mem_handle->rkey_unpack_lock);
 
     *mem_handle_p = (na_mem_handle_t *) na_ucx_mem_handle;
 
     return NA_SUCCESS;
 
 error:
+    if (na_ucx_mem_handle) {
+        free(na_ucx_mem_handle->segs);
+        free(na_ucx_mem_handle);
+    }
     return ret;
 }
 
@@ -3805,18 +5557,17 @@ na_ucx_mem_handle_free(
         case NA_UCX_MEM_HANDLE_LOCAL:
             /* nothing to do here */
             break;
-        case NA_UCX_MEM_HANDLE_REMOTE_UNPACKED:
-            ucp_rkey_destroy(na_ucx_mem_handle->ucp_mr.rkey);
-            NA_FALLTHROUGH;
-        case NA_UCX_MEM_HANDLE_REMOTE_PACKED:
-            free(na_ucx_mem_handle->rkey_buf);
+        case NA_UCX_MEM_HANDLE_REMOTE:
+            /* Packed rkeys of all segments share one buffer */
+            free(na_ucx_mem_handle->segs[0].rkey_buf);
             break;
         default:
             NA_LOG_SUBSYS_ERROR(mem, "Invalid memory handle type");
             break;
     }
 
-    hg_thread_mutex_destroy(&na_ucx_mem_handle->rkey_unpack_lock);
+    if (na_ucx_mem_handle->segs != &na_ucx_mem_handle->seg)
+        free(na_ucx_mem_handle->segs);
     free(na_ucx_mem_handle);
 }
 
@@ -3824,7 +5575,7 @@ na_ucx_mem_handle_free(
 static NA_INLINE size_t
 na_ucx_mem_handle_get_max_segments(const na_class_t NA_UNUSED *na_class)
 {
-    return 1;
+    return NA_UCX_IOV_MAX;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -3834,13 +5585,12 @@ na_ucx_mem_register(na_class_t *na_class, na_mem_handle_t *mem_handle,
 {
     struct na_ucx_mem_handle *na_ucx_mem_handle =
         (struct na_ucx_mem_handle *) mem_handle;
+    ucp_context_h ucp_context = NA_UCX_CLASS(na_class)->ucp_context;
     ucp_mem_map_params_t mem_map_params = {
         .field_mask =
             UCP_MEM_MAP_PARAM_FIELD_ADDRESS | UCP_MEM_MAP_PARAM_FIELD_LENGTH |
-            UCP_MEM_MAP_PARAM_FIELD_PROT | UCP_MEM_MAP_PARAM_FIELD_MEMORY_TYPE,
-        .address = (void *) na_ucx_mem_handle->desc.base,
-        .length = (size_t) na_ucx_mem_handle->desc.len};
-    size_t rkey_buf_size;
+            UCP_MEM_MAP_PARAM_FIELD_PROT | UCP_MEM_MAP_PARAM_FIELD_MEMORY_TYPE};
+    size_t rkey_buf_size, i = 0;
     ucs_status_t status;
     na_return_t ret;
 
@@ -3891,25 +5641,46 @@ na_ucx_mem_register(na_class_t *na_class, na_mem_handle_t *mem_handle,
             break;
     }
 
-    /* Register memory */
-    status = ucp_mem_map(NA_UCX_CLASS(na_class)->ucp_context, &mem_map_params,
-        &na_ucx_mem_handle->ucp_mr.mem);
-    NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, error, ret,
-        na_ucs_status_to_na(status), "ucp_mem_map() failed (%s)",
-        ucs_status_string(status));
+    /* Register each segment and keep a copy of its rkey to share with the
+     * remote */
+    na_ucx_mem_handle->desc.rkey_buf_size = 0;
+    for (i = 0; i < na_ucx_mem_handle->desc.iovcnt; i++) {
+        struct na_ucx_mem_seg *seg = &na_ucx_mem_handle->segs[i];
 
-    /* Keep a copy of the rkey to share with the remote */
-    /* TODO that could have been a good candidate for publish */
-    status = ucp_rkey_pack(NA_UCX_CLASS(na_class)->ucp_context,
-        na_ucx_mem_handle->ucp_mr.mem, &na_ucx_mem_handle->rkey_buf,
-        &rkey_buf_size);
-    NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, error, ret,
-        na_ucs_status_to_na(status), "ucp_rkey_pack() failed (%s)",
-        ucs_status_string(status));
-    na_ucx_mem_handle->desc.rkey_buf_size = (uint64_t) rkey_buf_size;
+        mem_map_params.address = (void *) seg->desc.base;
+        mem_map_params.length = (size_t) seg->desc.len;
+
+        status = ucp_mem_map(ucp_context, &mem_map_params, &seg->mem);
+        NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, unmap, ret,
+            na_ucs_status_to_na(status), "ucp_mem_map() failed (%s)",
+            ucs_status_string(status));
+        hg_atomic_incr64(NA_UCX_CLASS(na_class)->mem_map_count);
+
+        /* TODO that could have been a good candidate for publish */
+        status = ucp_rkey_pack(
+            ucp_context, seg->mem, &seg->rkey_buf, &rkey_buf_size);
+        if (status != UCS_OK) {
+            (void) ucp_mem_unmap(ucp_context, seg->mem);
+            seg->mem = NULL;
+        }
+        NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, unmap, ret,
+            na_ucs_status_to_na(status), "ucp_rkey_pack() failed (%s)",
+            ucs_status_string(status));
+        seg->desc.rkey_buf_size = (uint64_t) rkey_buf_size;
+        na_ucx_mem_handle->desc.rkey_buf_size += (uint64_t) rkey_buf_size;
+    }
 
     return NA_SUCCESS;
 
+unmap:
+    while (i-- > 0) {
+        struct na_ucx_mem_seg *seg = &na_ucx_mem_handle->segs[i];
+
+        ucp_rkey_buffer_release(seg->rkey_buf);
+        seg->rkey_buf = NULL;
+        (void) ucp_mem_unmap(ucp_context, seg->mem);
+        seg->mem = NULL;
+    }
 error:
     return ret;
 }
@@ -3922,23 +5693,27 @@ na_ucx_mem_deregister(na_class_t *na_class, na_mem_handle_t *mem_handle)
         (struct na_ucx_mem_handle *) mem_handle;
     ucs_status_t status;
     na_return_t ret;
+    size_t i;
 
     NA_CHECK_SUBSYS_ERROR(mem,
         hg_atomic_get32(&na_ucx_mem_handle->type) != NA_UCX_MEM_HANDLE_LOCAL,
         error, ret, NA_OPNOTSUPPORTED,
         "cannot unregister memory on remote handle");
 
-    /* Deregister memory */
-    status = ucp_mem_unmap(
-        NA_UCX_CLASS(na_class)->ucp_context, na_ucx_mem_handle->ucp_mr.mem);
-    NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, error, ret,
-        na_ucs_status_to_na(status), "ucp_mem_unmap() failed (%s)",
-        ucs_status_string(status));
-    na_ucx_mem_handle->ucp_mr.mem = NULL;
+    for (i = 0; i < na_ucx_mem_handle->desc.iovcnt; i++) {
+        struct na_ucx_mem_seg *seg = &na_ucx_mem_handle->segs[i];
+
+        /* Deregister memory */
+        status = ucp_mem_unmap(NA_UCX_CLASS(na_class)->ucp_context, seg->mem);
+        NA_CHECK_SUBSYS_ERROR(mem, status != UCS_OK, error, ret,
+            na_ucs_status_to_na(status), "ucp_mem_unmap() failed (%s)",
+            ucs_status_string(status));
+        seg->mem = NULL;
 
-    /* TODO that could have been a good candidate for unpublish */
-    ucp_rkey_buffer_release(na_ucx_mem_handle->rkey_buf);
-    na_ucx_mem_handle->rkey_buf = NULL;
+        /* TODO that could have been a good candidate for unpublish */
+        ucp_rkey_buffer_release(seg->rkey_buf);
+        seg->rkey_buf = NULL;
+    }
 
     return NA_SUCCESS;
 
@@ -3953,9 +5728,15 @@ na_ucx_mem_handle_get_serialize_size(
 {
     struct na_ucx_mem_handle *na_ucx_mem_handle =
         (struct na_ucx_mem_handle *) mem_handle;
+    size_t size = sizeof(na_ucx_mem_handle->desc) +
+                  na_ucx_mem_handle->desc.rkey_buf_size;
 
-    return sizeof(na_ucx_mem_handle->desc) +
-           na_ucx_mem_handle->desc.rkey_buf_size;
+    /* Segment descriptors are only needed if more than one segment */
+    if (na_ucx_mem_handle->desc.iovcnt > 1)
+        size +=
+            na_ucx_mem_handle->desc.iovcnt * sizeof(struct na_ucx_mem_seg_desc);
+
+    return size;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -3968,14 +5749,24 @@ na_ucx_mem_handle_serialize(na_class_t NA_UNUSED *na_class, void *buf,
     char *buf_ptr = (char *) buf;
     size_t buf_size_left = buf_size;
     na_return_t ret;
+    uint32_t i;
 
     /* Descriptor info */
     NA_ENCODE(error, ret, buf_ptr, buf_size_left, &na_ucx_mem_handle->desc,
         struct na_ucx_mem_desc);
 
-    /* Encode rkey */
-    memcpy(buf_ptr, na_ucx_mem_handle->rkey_buf,
-        na_ucx_mem_handle->desc.rkey_buf_size);
+    /* Segment info */
+    if (na_ucx_mem_handle->desc.iovcnt > 1) {
+        for (i = 0; i < na_ucx_mem_handle->desc.iovcnt; i++)
+            NA_ENCODE(error, ret, buf_ptr, buf_size_left,
+                &na_ucx_mem_handle->segs[i].desc, struct na_ucx_mem_seg_desc);
+    }
+
+    /* Encode rkeys */
+    for (i = 0; i < na_ucx_mem_handle->desc.iovcnt; i++)
+        NA_TYPE_ENCODE(error, ret, buf_ptr, buf_size_left,
+            na_ucx_mem_handle->segs[i].rkey_buf,
+            na_ucx_mem_handle->segs[i].desc.rkey_buf_size);
 
     return NA_SUCCESS;
 
@@ -3991,37 +5782,72 @@ na_ucx_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
     struct na_ucx_mem_handle *na_ucx_mem_handle = NULL;
     const char *buf_ptr = (const char *) buf;
     size_t buf_size_left = buf_size;
+    uint64_t rkey_buf_size = 0;
+    char *rkey_buf;
     na_return_t ret;
+    uint32_t i;
 
-    na_ucx_mem_handle =
-        (struct na_ucx_mem_handle *) malloc(sizeof(struct na_ucx_mem_handle));
+    na_ucx_mem_handle = (struct na_ucx_mem_handle *) calloc(
+        1, sizeof(struct na_ucx_mem_handle));
     NA_CHECK_SUBSYS_ERROR(mem, na_ucx_mem_handle == NULL, error, ret, NA_NOMEM,
         "Could not allocate NA UCX memory handle");
-    na_ucx_mem_handle->rkey_buf = NULL;
-    na_ucx_mem_handle->ucp_mr.rkey = NULL;
-    hg_atomic_init32(&na_ucx_mem_handle->type, NA_UCX_MEM_HANDLE_REMOTE_PACKED);
-    hg_thread_mutex_init(&na_ucx_mem_handle->rkey_unpack_lock);
+    na_ucx_mem_handle->segs = &na_ucx_mem_handle->seg;
+    hg_atomic_init32(&na_ucx_mem_handle->type, NA_UCX_MEM_HANDLE_REMOTE);
 
     /* Descriptor info */
     NA_DECODE(error, ret, buf_ptr, buf_size_left, &na_ucx_mem_handle->desc,
         struct na_ucx_mem_desc);
+    NA_CHECK_SUBSYS_ERROR(mem,
+        na_ucx_mem_handle->desc.iovcnt == 0 ||
+            na_ucx_mem_handle->desc.iovcnt > NA_UCX_IOV_MAX,
+        error, ret, NA_PROTOCOL_ERROR, "Invalid segment count (%" PRIu32 ")",
+        na_ucx_mem_handle->desc.iovcnt);
+
+    /* Segment info */
+    if (na_ucx_mem_handle->desc.iovcnt > 1) {
+        na_ucx_mem_handle->segs = (struct na_ucx_mem_seg *) calloc(
+            na_ucx_mem_handle->desc.iovcnt, sizeof(struct na_ucx_mem_seg));
+        NA_CHECK_SUBSYS_ERROR(mem, na_ucx_mem_handle->segs == NULL, error, ret,
+            NA_NOMEM, "Could not allocate segments");
+
+        for (i = 0; i < na_ucx_mem_handle->desc.iovcnt; i++) {
+            NA_DECODE(error, ret, buf_ptr, buf_size_left,
+                &na_ucx_mem_handle->segs[i].desc, struct na_ucx_mem_seg_desc);
+            rkey_buf_size += na_ucx_mem_handle->segs[i].desc.rkey_buf_size;
+        }
+        NA_CHECK_SUBSYS_ERROR(mem,
+            rkey_buf_size != na_ucx_mem_handle->desc.rkey_buf_size, error, ret,
+            NA_PROTOCOL_ERROR, "Invalid rkey buffer size");
+    } else
+        na_ucx_mem_handle->seg.desc = (struct na_ucx_mem_seg_desc){
+            .base = na_ucx_mem_handle->desc.base,
+            .len = na_ucx_mem_handle->desc.len,
+            .rkey_buf_size = na_ucx_mem_handle->desc.rkey_buf_size};
 
-    /* Packed rkey */
-    na_ucx_mem_handle->rkey_buf = malloc(na_ucx_mem_handle->desc.rkey_buf_size);
-    NA_CHECK_SUBSYS_ERROR(mem, na_ucx_mem_handle->rkey_buf == NULL, error, ret,
-        NA_NOMEM, "Could not allocate rkey buffer");
-
+    /* Packed rkeys, kept in one buffer */
     NA_CHECK_SUBSYS_ERROR(mem,
         buf_size_left < na_ucx_mem_handle->desc.rkey_buf_size, error, ret,
         NA_OVERFLOW, "Insufficient size left to copy rkey buffer");
-    memcpy(na_ucx_mem_handle->rkey_buf, buf_ptr,
-        na_ucx_mem_handle->desc.rkey_buf_size);
+    rkey_buf = (char *) malloc(na_ucx_mem_handle->desc.rkey_buf_size);
+    NA_CHECK_SUBSYS_ERROR(mem, rkey_buf == NULL, error, ret, NA_NOMEM,
+        "Could not allocate rkey buffer");
+    memcpy(rkey_buf, buf_ptr, na_ucx_mem_handle->desc.rkey_buf_size);
+
+    for (i = 0; i < na_ucx_mem_handle->desc.iovcnt; i++) {
+        na_ucx_mem_handle->segs[i].rkey_buf = rkey_buf;
+        rkey_buf += na_ucx_mem_handle->segs[i].desc.rkey_buf_size;
+    }
 
     *mem_handle_p = (na_mem_handle_t *) na_ucx_mem_handle;
 
     return NA_SUCCESS;
 
 error:
+    if (na_ucx_mem_handle) {
+        if (na_ucx_mem_handle->segs != &na_ucx_mem_handle->seg)
+            free(na_ucx_mem_handle->segs);
+        free(na_ucx_mem_handle);
+    }
     return ret;
 }
 
@@ -4030,13 +5856,14 @@ static na_return_t
 na_ucx_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t *local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
-    size_t length, na_addr_t *remote_addr, uint8_t NA_UNUSED remote_id,
+    size_t length, na_addr_t *remote_addr, uint8_t remote_id,
     na_op_id_t *op_id)
 {
     return na_ucx_rma(NA_UCX_CLASS(na_class), context, NA_CB_PUT, callback, arg,
         (struct na_ucx_mem_handle *) local_mem_handle, local_offset,
         (struct na_ucx_mem_handle *) remote_mem_handle, remote_offset, length,
-        (struct na_ucx_addr *) remote_addr, (struct na_ucx_op_id *) op_id);
+        (struct na_ucx_addr *) remote_addr, remote_id,
+        (struct na_ucx_op_id *) op_id);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -4044,18 +5871,107 @@ static na_return_t
 na_ucx_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     void *arg, na_mem_handle_t *local_mem_handle, na_offset_t local_offset,
     na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
-    size_t length, na_addr_t *remote_addr, uint8_t NA_UNUSED remote_id,
+    size_t length, na_addr_t *remote_addr, uint8_t remote_id,
     na_op_id_t *op_id)
 {
     return na_ucx_rma(NA_UCX_CLASS(na_class), context, NA_CB_GET, callback, arg,
         (struct na_ucx_mem_handle *) local_mem_handle, local_offset,
         (struct na_ucx_mem_handle *) remote_mem_handle, remote_offset, length,
-        (struct na_ucx_addr *) remote_addr, (struct na_ucx_op_id *) op_id);
+        (struct na_ucx_addr *) remote_addr, remote_id,
+        (struct na_ucx_op_id *) op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_ucx_atomic(na_class_t *na_class, na_context_t *context, na_cb_t callback,
+    void *arg, na_atomic_op_t op, uint64_t operand, uint64_t compare,
+    na_mem_handle_t *remote_mem_handle, na_offset_t remote_offset,
+    na_addr_t *remote_addr, uint8_t remote_id, na_op_id_t *op_id)
+{
+    struct na_ucx_mem_handle *na_ucx_mem_handle =
+        (struct na_ucx_mem_handle *) remote_mem_handle;
+    struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
+    struct na_ucx_addr *na_ucx_addr = (struct na_ucx_addr *) remote_addr;
+    struct na_ucx_atomic_info *atomic_info;
+    const struct na_ucx_mem_seg *remote_seg = NULL;
+    na_offset_t seg_offset = remote_offset;
+    uint32_t i;
+    na_return_t ret;
+
+    /* Check op_id */
+    NA_CHECK_SUBSYS_ERROR(op, na_ucx_op_id == NULL, error, ret, NA_INVALID_ARG,
+        "Invalid operation ID");
+    NA_CHECK_SUBSYS_ERROR(op,
+        !(hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_COMPLETED), error,
+        ret, NA_BUSY, "Attempting to use OP ID that was not completed (%s)",
+        na_cb_type_to_string(na_ucx_op_id->completion_data.callback_info.type));
+    NA_CHECK_SUBSYS_ERROR(mem,
+        hg_atomic_get32(&na_ucx_mem_handle->type) != NA_UCX_MEM_HANDLE_REMOTE,
+        error, ret, NA_INVALID_ARG, "Invalid memory handle type");
+    NA_CHECK_SUBSYS_ERROR(mem,
+        na_ucx_mem_handle->desc.flags != NA_MEM_READWRITE, error, ret,
+        NA_PERMISSION, "Remote memory handle is not read-write");
+
+    /* Operand must be contained within a single remote segment */
+    for (i = 0; i < na_ucx_mem_handle->desc.iovcnt; i++) {
+        const struct na_ucx_mem_seg *seg = &na_ucx_mem_handle->segs[i];
+
+        if (seg_offset < seg->desc.len) {
+            remote_seg = seg;
+            break;
+        }
+        seg_offset -= seg->desc.len;
+    }
+    NA_CHECK_SUBSYS_ERROR(rma,
+        remote_seg == NULL ||
+            seg_offset + sizeof(uint64_t) > remote_seg->desc.len,
+        error, ret, NA_OVERFLOW,
+        "Atomic operand exceeds remote segment (offset=%" PRIu64 ")",
+        remote_offset);
+
+    ret = na_ucx_addr_route(
+        NA_UCX_CLASS(na_class), context, na_ucx_addr, remote_id, &na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, error, ret, "Could not route NA UCX address");
+
+    NA_UCX_OP_RESET(
+        na_ucx_op_id, context, NA_CB_ATOMIC, callback, arg, na_ucx_addr);
+
+    atomic_info = &na_ucx_op_id->info.atomic;
+    atomic_info->key = (struct na_ucx_rma_key){
+        .rkey = NULL, .entry = NULL, .tmp = false};
+    atomic_info->operand = operand;
+    /* UCP CSWAP compares against the reply buffer and returns the old value */
+    atomic_info->result = (op == NA_ATOMIC_CAS) ? compare : 0;
+
+    /* EPs of looked up addresses are created on first use */
+    ret = na_ucx_addr_resolve(na_ucx_addr);
+    NA_CHECK_SUBSYS_NA_ERROR(
+        rma, release, ret, "Could not resolve NA UCX address");
+
+    ret = na_ucx_rma_key_resolve(na_ucx_addr, remote_seg->rkey_buf,
+        (size_t) remote_seg->desc.rkey_buf_size, &atomic_info->key);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "Could not resolve remote key");
+
+    ret = na_ucp_atomic(na_ucx_addr->ucp_ep,
+        (op == NA_ATOMIC_CAS) ? UCP_ATOMIC_OP_CSWAP : UCP_ATOMIC_OP_ADD,
+        &atomic_info->operand, &atomic_info->result,
+        remote_seg->desc.base + seg_offset, atomic_info->key.rkey,
+        na_ucx_op_id);
+    NA_CHECK_SUBSYS_NA_ERROR(rma, release, ret, "Could not post atomic op");
+
+    return NA_SUCCESS;
+
+release:
+    na_ucx_rma_key_release(&atomic_info->key);
+    NA_UCX_OP_RELEASE(na_ucx_op_id);
+
+error:
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static int
-na_ucx_poll_get_fd(na_class_t *na_class, na_context_t NA_UNUSED *context)
+na_ucx_poll_get_fd(na_class_t *na_class, na_context_t *context)
 {
     struct na_ucx_class *na_ucx_class = NA_UCX_CLASS(na_class);
     ucs_status_t status;
@@ -4064,7 +5980,8 @@ na_ucx_poll_get_fd(na_class_t *na_class, na_context_t NA_UNUSED *context)
     if (na_ucx_class->no_wait)
         return -1;
 
-    status = ucp_worker_get_efd(na_ucx_class->ucp_worker, &fd);
+    status = ucp_worker_get_efd(
+        NA_UCX_CONTEXT(context)->worker_class->ucp_worker, &fd);
     NA_CHECK_SUBSYS_ERROR(poll, status != UCS_OK, error, fd, -1,
         "ucp_worker_get_efd() failed (%s)", ucs_status_string(status));
 
@@ -4076,17 +5993,29 @@ error:
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE bool
-na_ucx_poll_try_wait(na_class_t *na_class, na_context_t NA_UNUSED *context)
+na_ucx_poll_try_wait(na_class_t *na_class, na_context_t *context)
 {
     struct na_ucx_class *na_ucx_class = NA_UCX_CLASS(na_class);
+    struct na_ucx_context *na_ucx_context = NA_UCX_CONTEXT(context);
+    struct na_ucx_class *worker_class = na_ucx_context->worker_class;
     ucs_status_t status;
 
     if (na_ucx_class->no_wait)
         return false;
 
-    status = ucp_worker_arm(na_ucx_class->ucp_worker);
+    /* Progress recently found work, more is likely to come so do not pay for
+     * arming the worker and for a wakeup that would follow */
+    if (hg_atomic_get32(&na_ucx_context->arm_skip) > 0) {
+        hg_atomic_decr32(&na_ucx_context->arm_skip);
+        hg_atomic_incr64(worker_class->arm_skip_count);
+        return false;
+    }
+
+    hg_atomic_incr64(worker_class->arm_count);
+    status = ucp_worker_arm(worker_class->ucp_worker);
     if (status == UCS_ERR_BUSY) {
         /* Events have already arrived */
+        hg_atomic_incr64(worker_class->arm_busy_count);
         return false;
     } else if (status != UCS_OK) {
         NA_LOG_SUBSYS_ERROR(
@@ -4099,9 +6028,11 @@ na_ucx_poll_try_wait(na_class_t *na_class, na_context_t NA_UNUSED *context)
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_ucx_progress(na_class_t *na_class, na_context_t NA_UNUSED *context,
+na_ucx_progress(na_class_t NA_UNUSED *na_class, na_context_t *context,
     unsigned int timeout_ms)
 {
+    struct na_ucx_context *na_ucx_context = NA_UCX_CONTEXT(context);
+    ucp_worker_h worker = na_ucx_context->worker_class->ucp_worker;
     hg_time_t deadline, now = hg_time_from_ms(0);
 
     if (timeout_ms != 0)
@@ -4109,8 +6040,11 @@ na_ucx_progress(na_class_t *na_class, na_context_t NA_UNUSED *context,
     deadline = hg_time_add(now, hg_time_from_ms(timeout_ms));
 
     do {
-        if (ucp_worker_progress(NA_UCX_CLASS(na_class)->ucp_worker) != 0)
+        if (ucp_worker_progress(worker) != 0) {
+            /* Skip the next arms while traffic keeps coming */
+            hg_atomic_set32(&na_ucx_context->arm_skip, NA_UCX_ARM_SKIP_MAX);
             return NA_SUCCESS;
+        }
 
         if (timeout_ms != 0)
             hg_time_get_current_ms(&now);
@@ -4122,8 +6056,9 @@ na_ucx_progress(na_class_t *na_class, na_context_t NA_UNUSED *context,
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ucx_cancel(
-    na_class_t *na_class, na_context_t NA_UNUSED *context, na_op_id_t *op_id)
+    na_class_t NA_UNUSED *na_class, na_context_t *context, na_op_id_t *op_id)
 {
+    struct na_ucx_class *worker_class = NA_UCX_CONTEXT(context)->worker_class;
     struct na_ucx_op_id *na_ucx_op_id = (struct na_ucx_op_id *) op_id;
     na_cb_type_t cb_type;
     int32_t status;
@@ -4142,10 +6077,11 @@ na_ucx_cancel(
     hg_atomic_or32(&na_ucx_op_id->status, NA_UCX_OP_CANCELING);
 
     /* Check if op_id is in unexpected op queue */
-    if ((cb_type == NA_CB_RECV_UNEXPECTED) &&
+    if ((cb_type == NA_CB_RECV_UNEXPECTED ||
+            cb_type == NA_CB_MULTI_RECV_UNEXPECTED) &&
         (hg_atomic_get32(&na_ucx_op_id->status) & NA_UCX_OP_QUEUED)) {
-        struct na_ucx_op_queue *op_queue =
-            &NA_UCX_CLASS(na_class)->unexpected_op_queue;
+        struct na_ucx_op_queue *op_queue = &worker_class->unexpected_op_queue;
+        struct na_cb_completion_data *completion_data = NULL;
         bool canceled = false;
 
         /* If dequeued by process_retries() in the meantime, we'll just let it
@@ -4158,16 +6094,26 @@ na_ucx_cancel(
             hg_atomic_and32(&na_ucx_op_id->status, ~NA_UCX_OP_QUEUED);
             hg_atomic_or32(&na_ucx_op_id->status, NA_UCX_OP_CANCELED);
             canceled = true;
+
+            /* Multi-recv operations complete through their own entries */
+            if (cb_type == NA_CB_MULTI_RECV_UNEXPECTED)
+                completion_data = na_ucx_multi_recv_reserve(
+                    na_ucx_op_id, NULL, 0, 0, 0, true);
         }
         hg_thread_spin_unlock(&op_queue->lock);
 
-        if (canceled)
+        if (completion_data != NULL)
+            na_ucx_complete_multi(na_ucx_op_id, completion_data, NA_CANCELED);
+        else if (canceled)
             na_ucx_complete(na_ucx_op_id, NA_CANCELED);
     } else {
-        /* Do best effort to cancel the operation */
+        /* Do best effort to cancel the operation, RMA and atomic requests
+         * allocated by UCX are left to complete */
         hg_atomic_or32(&na_ucx_op_id->status, NA_UCX_OP_CANCELED);
-        ucp_request_cancel(
-            NA_UCX_CLASS(na_class)->ucp_worker, (void *) na_ucx_op_id);
+        if (cb_type != NA_CB_ATOMIC &&
+            ((cb_type != NA_CB_PUT && cb_type != NA_CB_GET) ||
+                hg_atomic_get32(&na_ucx_op_id->info.rma.request_busy)))
+            ucp_request_cancel(worker_class->ucp_worker, (void *) na_ucx_op_id);
     }
 
     return NA_SUCCESS;
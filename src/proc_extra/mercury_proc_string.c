@@ -8,6 +8,7 @@
 #include "mercury_proc_string.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 /****************/
 /* Local Macros */
@@ -21,6 +22,16 @@
 /* Local Prototypes */
 /********************/
 
+#ifndef HG_HAS_XDR
+/**
+ * Point to string of string_len bytes (including terminating NUL) in proc
+ * buffer.
+ */
+static hg_return_t
+hg_proc_string_borrow(
+    hg_proc_t proc, hg_uint64_t string_len, const char **string_p);
+#endif
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -35,6 +46,7 @@ hg_proc_hg_string_object_t(hg_proc_t proc, void *string)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             string_len = (strobj->data) ? strlen(strobj->data) + 1 : 0;
             ret = hg_proc_uint64_t(proc, &string_len);
             if (ret != HG_SUCCESS)
@@ -98,3 +110,190 @@ hg_proc_hg_string_object_t(hg_proc_t proc, void *string)
 done:
     return ret;
 }
+
+#ifndef HG_HAS_XDR
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_proc_string_borrow(
+    hg_proc_t proc, hg_uint64_t string_len, const char **string_p)
+{
+    char *string;
+    hg_return_t ret;
+
+    /* String must have been entirely received */
+    if (string_len > hg_proc_get_size_left(proc)) {
+        ret = HG_OVERFLOW;
+        goto done;
+    }
+
+    string = (char *) hg_proc_save_ptr(proc, string_len);
+    if (string == NULL || string[string_len - 1] != '\0') {
+        ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    ret = hg_proc_restore_ptr(proc, string, string_len);
+    if (ret != HG_SUCCESS)
+        goto done;
+
+    *string_p = string;
+
+done:
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_hg_borrowed_string_t(hg_proc_t proc, void *data)
+{
+#ifdef HG_HAS_XDR
+    return hg_proc_hg_const_string_t(proc, data);
+#else
+    hg_borrowed_string_t *strdata = (hg_borrowed_string_t *) data;
+    hg_uint64_t string_len = 0;
+    hg_uint8_t flags[2] = {0, 0};
+    hg_return_t ret = HG_SUCCESS;
+
+    switch (hg_proc_get_op(proc)) {
+        case HG_ENCODE:
+        case HG_SIZE:
+            ret = hg_proc_hg_const_string_t(proc, data);
+            break;
+        case HG_DECODE:
+            ret = hg_proc_uint64_t(proc, &string_len);
+            if (ret != HG_SUCCESS)
+                goto done;
+            if (string_len == 0) {
+                *strdata = NULL;
+                break;
+            }
+            ret = hg_proc_string_borrow(proc, string_len, strdata);
+            if (ret != HG_SUCCESS)
+                goto done;
+            /* Skip string object flags */
+            ret = hg_proc_hg_uint8_t(proc, &flags[0]);
+            if (ret != HG_SUCCESS)
+                goto done;
+            ret = hg_proc_hg_uint8_t(proc, &flags[1]);
+            if (ret != HG_SUCCESS)
+                goto done;
+            break;
+        case HG_FREE:
+        default:
+            break;
+    }
+
+done:
+    return ret;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_proc_hg_interned_string_t(hg_proc_t proc, void *data)
+{
+    hg_interned_string_t *strdata = (hg_interned_string_t *) data;
+    union {
+        char *p;
+        const char *const_p;
+    } safe_string = {.const_p = *strdata};
+    /* 0 for NULL, (index << 1) | 1 for a reference to an interned string,
+     * string_len << 1 otherwise */
+    hg_uint64_t tag = 0, string_len;
+    hg_uint32_t index;
+    hg_return_t ret = HG_SUCCESS;
+
+    switch (hg_proc_get_op(proc)) {
+        case HG_ENCODE:
+        case HG_SIZE:
+            if (*strdata == NULL) {
+                ret = hg_proc_uint64_t(proc, &tag);
+                break;
+            }
+            string_len = strlen(*strdata) + 1;
+            if (hg_proc_intern_find(proc, *strdata, string_len, &index)) {
+                tag = ((hg_uint64_t) index << 1) | 1;
+                ret = hg_proc_uint64_t(proc, &tag);
+                break;
+            }
+            tag = string_len << 1;
+            ret = hg_proc_uint64_t(proc, &tag);
+            if (ret != HG_SUCCESS)
+                goto done;
+            ret = hg_proc_bytes(proc, safe_string.p, string_len);
+            if (ret != HG_SUCCESS)
+                goto done;
+            ret = hg_proc_intern_add(proc, *strdata, string_len);
+            break;
+        case HG_DECODE:
+            ret = hg_proc_uint64_t(proc, &tag);
+            if (ret != HG_SUCCESS)
+                goto done;
+            if (tag == 0) {
+                *strdata = NULL;
+            } else if (tag & 1) {
+                const char *string;
+
+                if ((tag >> 1) >= HG_PROC_INTERN_MAX) {
+                    ret = HG_PROTOCOL_ERROR;
+                    goto done;
+                }
+                string = (const char *) hg_proc_intern_get(
+                    proc, (hg_uint32_t) (tag >> 1), &string_len);
+                if (string == NULL) {
+                    ret = HG_PROTOCOL_ERROR;
+                    goto done;
+                }
+#ifdef HG_HAS_XDR
+                /* Each occurrence is freed separately */
+                safe_string.p = (char *) malloc(string_len);
+                if (safe_string.p == NULL) {
+                    ret = HG_NOMEM;
+                    goto done;
+                }
+                memcpy(safe_string.p, string, string_len);
+                *strdata = safe_string.p;
+#else
+                *strdata = string;
+#endif
+            } else {
+#ifdef HG_HAS_XDR
+                char *string;
+
+                string_len = tag >> 1;
+                string = (char *) malloc(string_len);
+                if (string == NULL) {
+                    ret = HG_NOMEM;
+                    goto done;
+                }
+                ret = hg_proc_bytes(proc, string, string_len);
+                if (ret == HG_SUCCESS && string[string_len - 1] != '\0')
+                    ret = HG_PROTOCOL_ERROR;
+                if (ret != HG_SUCCESS) {
+                    free(string);
+                    goto done;
+                }
+                *strdata = string;
+#else
+                string_len = tag >> 1;
+                ret = hg_proc_string_borrow(proc, string_len, strdata);
+                if (ret != HG_SUCCESS)
+                    goto done;
+#endif
+                ret = hg_proc_intern_add(proc, *strdata, string_len);
+            }
+            break;
+        case HG_FREE:
+#ifdef HG_HAS_XDR
+            free(safe_string.p);
+            *strdata = NULL;
+#endif
+            break;
+        default:
+            break;
+    }
+
+done:
+    return ret;
+}
@@ -18,6 +18,14 @@
 typedef const char *hg_const_string_t;
 typedef char *hg_string_t;
 
+/* Strings that are decoded in place, i.e., that point directly to the
+ * buffer that they were received in and therefore remain valid only until
+ * the decoded struct is freed (HG_Free_input() / HG_Free_output()) and only
+ * while that buffer is not released (see release_input_early). In XDR
+ * builds, strings are copied. */
+typedef const char *hg_borrowed_string_t;
+typedef const char *hg_interned_string_t;
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -63,6 +71,35 @@ hg_proc_hg_string_t(hg_proc_t proc, void *data);
 HG_PUBLIC hg_return_t
 hg_proc_hg_string_object_t(hg_proc_t proc, void *string);
 
+/**
+ * Processing routine for borrowed strings. The encoded string is the same
+ * as hg_proc_hg_const_string_t() so that either type can be used on each
+ * side, but decoding does not allocate or copy the string.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to data
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_hg_borrowed_string_t(hg_proc_t proc, void *data);
+
+/**
+ * Processing routine for interned strings. Strings that were already
+ * encoded in the same payload are encoded as a reference to their first
+ * occurrence (see hg_proc_intern_add()), which benefits payloads that
+ * repeat path names or keys. Decoded strings are borrowed as with
+ * hg_proc_hg_borrowed_string_t(), repeated occurrences point to the same
+ * string. The encoding differs from other string types.
+ *
+ * \param proc [IN/OUT]         abstract processor object
+ * \param data [IN/OUT]         pointer to data
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_PUBLIC hg_return_t
+hg_proc_hg_interned_string_t(hg_proc_t proc, void *data);
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
@@ -77,6 +114,7 @@ hg_proc_hg_const_string_t(hg_proc_t proc, void *data)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             hg_string_object_init_const_char(&string, *strdata, 0);
             ret = hg_proc_hg_string_object_t(proc, &string);
             if (ret != HG_SUCCESS)
@@ -114,6 +152,7 @@ hg_proc_hg_string_t(hg_proc_t proc, void *data)
 
     switch (hg_proc_get_op(proc)) {
         case HG_ENCODE:
+        case HG_SIZE:
             hg_string_object_init_char(&string, *strdata, 0);
             ret = hg_proc_hg_string_object_t(proc, &string);
             if (ret != HG_SUCCESS)
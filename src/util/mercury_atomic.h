@@ -72,6 +72,23 @@ typedef int64_t hg_atomic_int64_t;
 #    define HG_ATOMIC_VAR_INIT(x) (x)
 #endif
 
+/* For busy loop spinning */
+#ifndef cpu_spinwait
+#    if defined(_WIN32)
+#        define cpu_spinwait YieldProcessor
+#    elif defined(__x86_64__) || defined(__i386__)
+#        include <immintrin.h>
+#        define cpu_spinwait _mm_pause
+#    elif defined(__arm__)
+#        define cpu_spinwait() __asm__ __volatile__("yield")
+#    elif defined(__aarch64__)
+#        define cpu_spinwait() __asm__ __volatile__("isb")
+#    else
+#        warning "Processor yield is not supported on this architecture."
+#        define cpu_spinwait(x)
+#    endif
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -219,6 +236,17 @@ hg_atomic_incr64(hg_atomic_int64_t *ptr);
 static HG_UTIL_INLINE int64_t
 hg_atomic_decr64(hg_atomic_int64_t *ptr);
 
+/**
+ * Add to atomic value (64-bit integer).
+ *
+ * \param ptr [IN/OUT]          pointer to an atomic64 integer
+ * \param value [IN]            value to add
+ *
+ * \return Resulting value
+ */
+static HG_UTIL_INLINE int64_t
+hg_atomic_add64(hg_atomic_int64_t *ptr, int64_t value);
+
 /**
  * OR atomic value (64-bit integer).
  *
@@ -521,6 +549,25 @@ hg_atomic_decr64(hg_atomic_int64_t *ptr)
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE int64_t
+hg_atomic_add64(hg_atomic_int64_t *ptr, int64_t value)
+{
+    int64_t ret;
+
+#if defined(_WIN32)
+    ret = InterlockedExchangeAddNoFence64(&ptr->value, value) + value;
+#elif defined(HG_UTIL_HAS_STDATOMIC_H)
+    ret = atomic_fetch_add_explicit(ptr, value, memory_order_acq_rel) + value;
+#elif defined(__APPLE__)
+    ret = OSAtomicAdd64(value, &ptr->value);
+#else
+    ret = __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL) + value;
+#endif
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE int64_t
 hg_atomic_or64(hg_atomic_int64_t *ptr, int64_t value)
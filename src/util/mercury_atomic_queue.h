@@ -41,23 +41,6 @@
 #include "mercury_atomic.h"
 #include "mercury_mem.h"
 
-/* For busy loop spinning */
-#ifndef cpu_spinwait
-#    if defined(_WIN32)
-#        define cpu_spinwait YieldProcessor
-#    elif defined(__x86_64__) || defined(__i386__)
-#        include <immintrin.h>
-#        define cpu_spinwait _mm_pause
-#    elif defined(__arm__)
-#        define cpu_spinwait() __asm__ __volatile__("yield")
-#    elif defined(__aarch64__)
-#        define cpu_spinwait() __asm__ __volatile__("isb")
-#    else
-#        warning "Processor yield is not supported on this architecture."
-#        define cpu_spinwait(x)
-#    endif
-#endif
-
 /*************************************/
 /* Public Type and Struct Definition */
 /*************************************/
@@ -116,6 +99,36 @@ hg_atomic_queue_free(struct hg_atomic_queue *hg_atomic_queue);
 static HG_UTIL_INLINE int
 hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry);
 
+/**
+ * Push up to count entries to the queue (multi-producer). Slots are
+ * reserved using a single atomic operation and entries are published at
+ * once in FIFO order. Entries that do not fit are not pushed.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [IN]              array of count pointers
+ * \param count [IN]                number of entries to push
+ *
+ * \return Number of entries pushed or 0 if queue is full
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_push_batch(struct hg_atomic_queue *hg_atomic_queue,
+    void **entries, unsigned int count);
+
+/**
+ * Push up to count entries to the queue (single producer). Same as
+ * hg_atomic_queue_push_batch() but does not use any atomic
+ * compare-and-swap, no other producer may access the queue concurrently.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [IN]              array of count pointers
+ * \param count [IN]                number of entries to push
+ *
+ * \return Number of entries pushed or 0 if queue is full
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_push_sp_batch(struct hg_atomic_queue *hg_atomic_queue,
+    void **entries, unsigned int count);
+
 /**
  * Pop an entry from the queue (multi-consumer).
  *
@@ -126,6 +139,21 @@ hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry);
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue);
 
+/**
+ * Pop up to max_count entries from the queue (multi-consumer). Entries are
+ * reserved using a single atomic operation and copied into entries in FIFO
+ * order.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [OUT]             array of at least max_count pointers
+ * \param max_count [IN]            maximum number of entries to pop
+ *
+ * \return Number of entries popped or 0 if queue is empty
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_pop_mc_batch(struct hg_atomic_queue *hg_atomic_queue,
+    void **entries, unsigned int max_count);
+
 /**
  * Pop an entry from the queue (single consumer).
  *
@@ -136,6 +164,21 @@ hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue);
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_sc(struct hg_atomic_queue *hg_atomic_queue);
 
+/**
+ * Pop up to max_count entries from the queue (single consumer). Same as
+ * hg_atomic_queue_pop_mc_batch() but does not use any atomic
+ * compare-and-swap, no other consumer may access the queue concurrently.
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [OUT]             array of at least max_count pointers
+ * \param max_count [IN]            maximum number of entries to pop
+ *
+ * \return Number of entries popped or 0 if queue is empty
+ */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_pop_sc_batch(struct hg_atomic_queue *hg_atomic_queue,
+    void **entries, unsigned int max_count);
+
 /**
  * Determine whether queue is empty.
  *
@@ -195,6 +238,93 @@ hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry)
     return HG_UTIL_SUCCESS;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_push_batch(struct hg_atomic_queue *hg_atomic_queue,
+    void **entries, unsigned int count)
+{
+    int32_t prod_head, prod_next, cons_tail;
+    unsigned int n, i;
+
+    if (count == 0)
+        return 0;
+
+    do {
+        prod_head = hg_atomic_get32(&hg_atomic_queue->prod_head);
+        cons_tail = hg_atomic_get32(&hg_atomic_queue->cons_tail);
+        n = ((unsigned int) cons_tail - (unsigned int) prod_head - 1) &
+            hg_atomic_queue->prod_mask;
+
+        if (n == 0) {
+            hg_atomic_fence();
+            if (prod_head == hg_atomic_get32(&hg_atomic_queue->prod_head) &&
+                cons_tail == hg_atomic_get32(&hg_atomic_queue->cons_tail)) {
+                hg_atomic_queue->drops++;
+                /* Full */
+                return 0;
+            }
+            continue;
+        }
+        if (n > count)
+            n = count;
+        prod_next =
+            (prod_head + (int32_t) n) & (int) hg_atomic_queue->prod_mask;
+    } while (
+        !hg_atomic_cas32(&hg_atomic_queue->prod_head, prod_head, prod_next));
+
+    for (i = 0; i < n; i++)
+        hg_atomic_set64(&hg_atomic_queue->ring[((unsigned int) prod_head + i) &
+                                               hg_atomic_queue->prod_mask],
+            (int64_t) entries[i]);
+
+    /*
+     * If there are other enqueues in progress
+     * that preceded us, we need to wait for them
+     * to complete
+     */
+    while (hg_atomic_get32(&hg_atomic_queue->prod_tail) != prod_head)
+        cpu_spinwait();
+
+    hg_atomic_set32(&hg_atomic_queue->prod_tail, prod_next);
+
+    return n;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_push_sp_batch(struct hg_atomic_queue *hg_atomic_queue,
+    void **entries, unsigned int count)
+{
+    int32_t prod_head, prod_next, cons_tail;
+    unsigned int n, i;
+
+    prod_head = hg_atomic_get32(&hg_atomic_queue->prod_head);
+    cons_tail = hg_atomic_get32(&hg_atomic_queue->cons_tail);
+    n = ((unsigned int) cons_tail - (unsigned int) prod_head - 1) &
+        hg_atomic_queue->prod_mask;
+
+    if (n == 0 || count == 0) {
+        if (count > 0)
+            hg_atomic_queue->drops++;
+        /* Full */
+        return 0;
+    }
+    if (n > count)
+        n = count;
+    prod_next = (prod_head + (int32_t) n) & (int) hg_atomic_queue->prod_mask;
+
+    hg_atomic_set32(&hg_atomic_queue->prod_head, prod_next);
+
+    for (i = 0; i < n; i++)
+        hg_atomic_set64(&hg_atomic_queue->ring[((unsigned int) prod_head + i) &
+                                               hg_atomic_queue->prod_mask],
+            (int64_t) entries[i]);
+
+    hg_atomic_set32(&hg_atomic_queue->prod_tail, prod_next);
+
+    return n;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue)
@@ -226,6 +356,50 @@ hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue)
     return entry;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_pop_mc_batch(struct hg_atomic_queue *hg_atomic_queue,
+    void **entries, unsigned int max_count)
+{
+    int32_t cons_head, cons_next;
+    unsigned int count, i;
+
+    if (max_count == 0)
+        return 0;
+
+    do {
+        cons_head = hg_atomic_get32(&hg_atomic_queue->cons_head);
+        count = ((unsigned int) hg_atomic_get32(&hg_atomic_queue->prod_tail) -
+                    (unsigned int) cons_head) &
+                hg_atomic_queue->cons_mask;
+
+        if (count == 0)
+            return 0;
+        if (count > max_count)
+            count = max_count;
+        cons_next = (cons_head + (int32_t) count) &
+                    (int) hg_atomic_queue->cons_mask;
+    } while (
+        !hg_atomic_cas32(&hg_atomic_queue->cons_head, cons_head, cons_next));
+
+    for (i = 0; i < count; i++)
+        entries[i] = (void *) hg_atomic_get64(
+            &hg_atomic_queue->ring[((unsigned int) cons_head + i) &
+                                   hg_atomic_queue->cons_mask]);
+
+    /*
+     * If there are other dequeues in progress
+     * that preceded us, we need to wait for them
+     * to complete
+     */
+    while (hg_atomic_get32(&hg_atomic_queue->cons_tail) != cons_head)
+        cpu_spinwait();
+
+    hg_atomic_set32(&hg_atomic_queue->cons_tail, cons_next);
+
+    return count;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_sc(struct hg_atomic_queue *hg_atomic_queue)
@@ -251,6 +425,39 @@ hg_atomic_queue_pop_sc(struct hg_atomic_queue *hg_atomic_queue)
     return entry;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_queue_pop_sc_batch(struct hg_atomic_queue *hg_atomic_queue,
+    void **entries, unsigned int max_count)
+{
+    int32_t cons_head, cons_next;
+    unsigned int count, i;
+
+    cons_head = hg_atomic_get32(&hg_atomic_queue->cons_head);
+    count = ((unsigned int) hg_atomic_get32(&hg_atomic_queue->prod_tail) -
+                (unsigned int) cons_head) &
+            hg_atomic_queue->cons_mask;
+
+    if (count == 0 || max_count == 0)
+        /* Empty */
+        return 0;
+    if (count > max_count)
+        count = max_count;
+    cons_next =
+        (cons_head + (int32_t) count) & (int) hg_atomic_queue->cons_mask;
+
+    hg_atomic_set32(&hg_atomic_queue->cons_head, cons_next);
+
+    for (i = 0; i < count; i++)
+        entries[i] = (void *) hg_atomic_get64(
+            &hg_atomic_queue->ring[((unsigned int) cons_head + i) &
+                                   hg_atomic_queue->cons_mask]);
+
+    hg_atomic_set32(&hg_atomic_queue->cons_tail, cons_next);
+
+    return count;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE bool
 hg_atomic_queue_is_empty(struct hg_atomic_queue *hg_atomic_queue)
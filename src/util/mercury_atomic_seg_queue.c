@@ -0,0 +1,436 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Segment layout derived from the FAAArrayQueue of Correia and Ramalhete,
+ * segments are reclaimed using epochs instead of hazard pointers.
+ */
+
+#include "mercury_atomic_seg_queue.h"
+#include "mercury_atomic.h"
+#include "mercury_mem.h"
+#include "mercury_param.h"
+#include "mercury_util_error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Marks a slot that was consumed before its producer could fill it */
+#define HG_ATOMIC_SEG_QUEUE_TAKEN ((int64_t) 1)
+
+/* Number of retired lists, power of 2 so that epoch wrap-around is safe */
+#define HG_ATOMIC_SEG_QUEUE_EPOCHS (4)
+
+/* Pointer conversions */
+#define HG_ATOMIC_SEG_QUEUE_PTR(v) ((struct hg_atomic_seg_queue_seg *) (v))
+#define HG_ATOMIC_SEG_QUEUE_VAL(p) ((int64_t) (intptr_t) (p))
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/**
+ * Queue segment. Slots are reserved by incrementing enq_idx / deq_idx, a
+ * segment is unlinked from the queue once all its slots have been consumed.
+ */
+struct hg_atomic_seg_queue_seg {
+    hg_atomic_int32_t enq_idx;                    /* Next producer slot */
+    hg_atomic_int64_t next;                       /* Next segment       */
+    struct hg_atomic_seg_queue_seg *retired_next; /* Next retired seg   */
+    uint64_t base;                                /* Index of 1st slot  */
+    HG_UTIL_ALIGNED(hg_atomic_int32_t deq_idx, HG_MEM_CACHE_LINE_SIZE);
+    HG_UTIL_ALIGNED(hg_atomic_int64_t slots[], HG_MEM_CACHE_LINE_SIZE);
+};
+
+/**
+ * Queue. Each operation runs within an epoch, active[] counts threads that
+ * have entered an even / odd epoch. Unlinked segments are kept in the
+ * retired list of the epoch they were unlinked in and are freed once no
+ * thread can still be running in that epoch.
+ */
+struct hg_atomic_seg_queue {
+    hg_atomic_int64_t head;                                /* Head segment */
+    hg_atomic_int32_t epoch;                               /* Epoch        */
+    hg_atomic_int32_t active[2];                           /* Active ops   */
+    hg_atomic_int64_t retired[HG_ATOMIC_SEG_QUEUE_EPOCHS]; /* Retired segs */
+    unsigned int seg_count;                                /* Seg capacity */
+    HG_UTIL_ALIGNED(hg_atomic_int64_t tail, HG_MEM_CACHE_LINE_SIZE);
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/* Allocate new segment */
+static struct hg_atomic_seg_queue_seg *
+hg_atomic_seg_queue_seg_alloc(unsigned int seg_count, uint64_t base);
+
+/* Enter current epoch, returns active[] index */
+static HG_UTIL_INLINE unsigned int
+hg_atomic_seg_queue_enter(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/* Leave epoch */
+static HG_UTIL_INLINE void
+hg_atomic_seg_queue_leave(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, unsigned int active_idx);
+
+/* Retire unlinked segment */
+static void
+hg_atomic_seg_queue_retire(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    struct hg_atomic_seg_queue_seg *seg);
+
+/* Free list of retired segments */
+static void
+hg_atomic_seg_queue_free_retired(struct hg_atomic_seg_queue_seg *seg);
+
+/* Pop entry, must be called within an epoch */
+static void *
+hg_atomic_seg_queue_pop_epoch(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/* Check whether segment has any entry left to consume */
+static HG_UTIL_INLINE bool
+hg_atomic_seg_queue_seg_is_empty(
+    struct hg_atomic_seg_queue_seg *seg, unsigned int seg_count);
+
+/*---------------------------------------------------------------------------*/
+static struct hg_atomic_seg_queue_seg *
+hg_atomic_seg_queue_seg_alloc(unsigned int seg_count, uint64_t base)
+{
+    struct hg_atomic_seg_queue_seg *seg;
+
+    seg = hg_mem_aligned_alloc(HG_MEM_CACHE_LINE_SIZE,
+        sizeof(struct hg_atomic_seg_queue_seg) +
+            seg_count * sizeof(hg_atomic_int64_t));
+    HG_UTIL_CHECK_ERROR_NORET(
+        seg == NULL, done, "Could not allocate queue segment");
+
+    memset(seg->slots, 0, seg_count * sizeof(hg_atomic_int64_t));
+    hg_atomic_init32(&seg->enq_idx, 0);
+    hg_atomic_init32(&seg->deq_idx, 0);
+    hg_atomic_init64(&seg->next, 0);
+    seg->retired_next = NULL;
+    seg->base = base;
+
+done:
+    return seg;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_atomic_seg_queue_enter(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    for (;;) {
+        int32_t epoch = hg_atomic_get32(&hg_atomic_seg_queue->epoch);
+        unsigned int active_idx = (unsigned int) epoch & 1;
+
+        hg_atomic_incr32(&hg_atomic_seg_queue->active[active_idx]);
+        /* Epoch may have moved before we were accounted for */
+        if (hg_atomic_get32(&hg_atomic_seg_queue->epoch) == epoch)
+            return active_idx;
+        hg_atomic_decr32(&hg_atomic_seg_queue->active[active_idx]);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_atomic_seg_queue_leave(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, unsigned int active_idx)
+{
+    hg_atomic_decr32(&hg_atomic_seg_queue->active[active_idx]);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_atomic_seg_queue_retire(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    struct hg_atomic_seg_queue_seg *seg)
+{
+    hg_atomic_int64_t *retired;
+    struct hg_atomic_seg_queue_seg *freed;
+    uint32_t epoch;
+    int64_t old;
+
+    /* Read epoch using a RMW so that the unlink is visible to any thread
+     * entering a later epoch */
+    epoch = (uint32_t) hg_atomic_or32(&hg_atomic_seg_queue->epoch, 0);
+    retired = &hg_atomic_seg_queue
+                   ->retired[epoch & (HG_ATOMIC_SEG_QUEUE_EPOCHS - 1)];
+    do {
+        old = hg_atomic_get64(retired);
+        seg->retired_next = HG_ATOMIC_SEG_QUEUE_PTR(old);
+    } while (!hg_atomic_cas64(retired, old, HG_ATOMIC_SEG_QUEUE_VAL(seg)));
+
+    /* Try to move to next epoch, no thread may still run in the previous
+     * epoch (use a RMW to synchronize with threads leaving it) */
+    epoch = (uint32_t) hg_atomic_get32(&hg_atomic_seg_queue->epoch);
+    if (!hg_atomic_cas32(&hg_atomic_seg_queue->active[(epoch - 1) & 1], 0, 0))
+        return;
+    if (!hg_atomic_cas32(&hg_atomic_seg_queue->epoch, (int32_t) epoch,
+            (int32_t) (epoch + 1)))
+        return;
+
+    /* Segments retired in the previous epoch can no longer be accessed */
+    retired = &hg_atomic_seg_queue
+                   ->retired[(epoch - 1) & (HG_ATOMIC_SEG_QUEUE_EPOCHS - 1)];
+    do {
+        old = hg_atomic_get64(retired);
+    } while (old != 0 && !hg_atomic_cas64(retired, old, 0));
+    freed = HG_ATOMIC_SEG_QUEUE_PTR(old);
+    hg_atomic_seg_queue_free_retired(freed);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_atomic_seg_queue_free_retired(struct hg_atomic_seg_queue_seg *seg)
+{
+    while (seg != NULL) {
+        struct hg_atomic_seg_queue_seg *next = seg->retired_next;
+
+        hg_mem_aligned_free(seg);
+        seg = next;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE bool
+hg_atomic_seg_queue_seg_is_empty(
+    struct hg_atomic_seg_queue_seg *seg, unsigned int seg_count)
+{
+    int32_t deq_idx = hg_atomic_get32(&seg->deq_idx);
+
+    return (deq_idx >= hg_atomic_get32(&seg->enq_idx) ||
+               (unsigned int) deq_idx >= seg_count) &&
+           hg_atomic_get64(&seg->next) == 0;
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_atomic_seg_queue *
+hg_atomic_seg_queue_alloc(unsigned int seg_count)
+{
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue = NULL;
+    struct hg_atomic_seg_queue_seg *seg;
+    unsigned int i;
+
+    HG_UTIL_CHECK_ERROR_NORET(
+        seg_count == 0, error, "segment size must be greater than 0");
+
+    hg_atomic_seg_queue = hg_mem_aligned_alloc(
+        HG_MEM_CACHE_LINE_SIZE, sizeof(struct hg_atomic_seg_queue));
+    HG_UTIL_CHECK_ERROR_NORET(
+        hg_atomic_seg_queue == NULL, error, "Could not allocate queue");
+
+    seg = hg_atomic_seg_queue_seg_alloc(seg_count, 0);
+    HG_UTIL_CHECK_ERROR_NORET(seg == NULL, error, "Could not allocate segment");
+
+    hg_atomic_init64(&hg_atomic_seg_queue->head, HG_ATOMIC_SEG_QUEUE_VAL(seg));
+    hg_atomic_init64(&hg_atomic_seg_queue->tail, HG_ATOMIC_SEG_QUEUE_VAL(seg));
+    hg_atomic_init32(&hg_atomic_seg_queue->epoch, 0);
+    hg_atomic_init32(&hg_atomic_seg_queue->active[0], 0);
+    hg_atomic_init32(&hg_atomic_seg_queue->active[1], 0);
+    for (i = 0; i < HG_ATOMIC_SEG_QUEUE_EPOCHS; i++)
+        hg_atomic_init64(&hg_atomic_seg_queue->retired[i], 0);
+    hg_atomic_seg_queue->seg_count = seg_count;
+
+    return hg_atomic_seg_queue;
+
+error:
+    hg_mem_aligned_free(hg_atomic_seg_queue);
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_atomic_seg_queue_free(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    struct hg_atomic_seg_queue_seg *seg;
+    unsigned int i;
+
+    if (hg_atomic_seg_queue == NULL)
+        return;
+
+    seg = HG_ATOMIC_SEG_QUEUE_PTR(hg_atomic_get64(&hg_atomic_seg_queue->head));
+    while (seg != NULL) {
+        struct hg_atomic_seg_queue_seg *next =
+            HG_ATOMIC_SEG_QUEUE_PTR(hg_atomic_get64(&seg->next));
+
+        hg_mem_aligned_free(seg);
+        seg = next;
+    }
+
+    for (i = 0; i < HG_ATOMIC_SEG_QUEUE_EPOCHS; i++)
+        hg_atomic_seg_queue_free_retired(HG_ATOMIC_SEG_QUEUE_PTR(
+            hg_atomic_get64(&hg_atomic_seg_queue->retired[i])));
+
+    hg_mem_aligned_free(hg_atomic_seg_queue);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_atomic_seg_queue_push(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, void *entry)
+{
+    unsigned int seg_count = hg_atomic_seg_queue->seg_count;
+    unsigned int active_idx;
+
+    active_idx = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+
+    for (;;) {
+        int64_t tail = hg_atomic_get64(&hg_atomic_seg_queue->tail);
+        struct hg_atomic_seg_queue_seg *seg = HG_ATOMIC_SEG_QUEUE_PTR(tail);
+        unsigned int idx =
+            (unsigned int) (hg_atomic_incr32(&seg->enq_idx) - 1);
+        struct hg_atomic_seg_queue_seg *new_seg;
+        int64_t next;
+
+        if (idx < seg_count) {
+            /* Slot may have been consumed already, retry in that case */
+            if (hg_atomic_cas64(
+                    &seg->slots[idx], 0, HG_ATOMIC_SEG_QUEUE_VAL(entry)))
+                break;
+            continue;
+        }
+
+        /* Segment is full */
+        if (tail != hg_atomic_get64(&hg_atomic_seg_queue->tail))
+            continue;
+        next = hg_atomic_get64(&seg->next);
+        if (next != 0) {
+            /* Help moving tail forward */
+            hg_atomic_cas64(&hg_atomic_seg_queue->tail, tail, next);
+            continue;
+        }
+
+        /* Append new segment that already contains our entry */
+        new_seg =
+            hg_atomic_seg_queue_seg_alloc(seg_count, seg->base + seg_count);
+        HG_UTIL_CHECK_ERROR_NORET(
+            new_seg == NULL, error, "Could not allocate new segment");
+        hg_atomic_init64(&new_seg->slots[0], HG_ATOMIC_SEG_QUEUE_VAL(entry));
+        hg_atomic_init32(&new_seg->enq_idx, 1);
+        if (hg_atomic_cas64(&seg->next, 0, HG_ATOMIC_SEG_QUEUE_VAL(new_seg))) {
+            hg_atomic_cas64(&hg_atomic_seg_queue->tail, tail,
+                HG_ATOMIC_SEG_QUEUE_VAL(new_seg));
+            break;
+        }
+        /* Never published */
+        hg_mem_aligned_free(new_seg);
+    }
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, active_idx);
+
+    return HG_UTIL_SUCCESS;
+
+error:
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, active_idx);
+
+    return HG_UTIL_FAIL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_atomic_seg_queue_pop_epoch(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    unsigned int seg_count = hg_atomic_seg_queue->seg_count;
+
+    for (;;) {
+        int64_t head = hg_atomic_get64(&hg_atomic_seg_queue->head);
+        struct hg_atomic_seg_queue_seg *seg = HG_ATOMIC_SEG_QUEUE_PTR(head);
+        unsigned int idx;
+        int64_t next;
+
+        if (hg_atomic_seg_queue_seg_is_empty(seg, seg_count))
+            return NULL;
+
+        idx = (unsigned int) (hg_atomic_incr32(&seg->deq_idx) - 1);
+        if (idx < seg_count) {
+            /* Producer has not filled that slot yet, prevent it from doing
+             * so and retry */
+            if (hg_atomic_cas64(&seg->slots[idx], 0, HG_ATOMIC_SEG_QUEUE_TAKEN))
+                continue;
+            return (void *) (intptr_t) hg_atomic_get64(&seg->slots[idx]);
+        }
+
+        /* Segment is drained */
+        next = hg_atomic_get64(&seg->next);
+        if (next == 0)
+            return NULL;
+
+        /* Tail must never point to a retired segment */
+        if (hg_atomic_get64(&hg_atomic_seg_queue->tail) == head)
+            hg_atomic_cas64(&hg_atomic_seg_queue->tail, head, next);
+        if (hg_atomic_cas64(&hg_atomic_seg_queue->head, head, next))
+            hg_atomic_seg_queue_retire(hg_atomic_seg_queue, seg);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+void *
+hg_atomic_seg_queue_pop(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    unsigned int active_idx = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    void *entry = hg_atomic_seg_queue_pop_epoch(hg_atomic_seg_queue);
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, active_idx);
+
+    return entry;
+}
+
+/*---------------------------------------------------------------------------*/
+unsigned int
+hg_atomic_seg_queue_pop_batch(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void **entries, unsigned int max_count)
+{
+    unsigned int active_idx, count;
+
+    active_idx = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    for (count = 0; count < max_count; count++) {
+        entries[count] = hg_atomic_seg_queue_pop_epoch(hg_atomic_seg_queue);
+        if (entries[count] == NULL)
+            break;
+    }
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, active_idx);
+
+    return count;
+}
+
+/*---------------------------------------------------------------------------*/
+bool
+hg_atomic_seg_queue_is_empty(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    unsigned int active_idx = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    bool empty = hg_atomic_seg_queue_seg_is_empty(
+        HG_ATOMIC_SEG_QUEUE_PTR(hg_atomic_get64(&hg_atomic_seg_queue->head)),
+        hg_atomic_seg_queue->seg_count);
+
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, active_idx);
+
+    return empty;
+}
+
+/*---------------------------------------------------------------------------*/
+unsigned int
+hg_atomic_seg_queue_count(struct hg_atomic_seg_queue *hg_atomic_seg_queue)
+{
+    unsigned int seg_count = hg_atomic_seg_queue->seg_count;
+    struct hg_atomic_seg_queue_seg *head, *tail;
+    unsigned int active_idx, enq_idx, deq_idx;
+    int64_t count;
+
+    active_idx = hg_atomic_seg_queue_enter(hg_atomic_seg_queue);
+    head = HG_ATOMIC_SEG_QUEUE_PTR(hg_atomic_get64(&hg_atomic_seg_queue->head));
+    tail = HG_ATOMIC_SEG_QUEUE_PTR(hg_atomic_get64(&hg_atomic_seg_queue->tail));
+    deq_idx = MIN((unsigned int) hg_atomic_get32(&head->deq_idx), seg_count);
+    enq_idx = MIN((unsigned int) hg_atomic_get32(&tail->enq_idx), seg_count);
+    count = (int64_t) (tail->base + enq_idx) - (int64_t) (head->base + deq_idx);
+    hg_atomic_seg_queue_leave(hg_atomic_seg_queue, active_idx);
+
+    return (count > 0) ? (unsigned int) count : 0;
+}
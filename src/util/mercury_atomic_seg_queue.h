@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MERCURY_ATOMIC_SEG_QUEUE_H
+#define MERCURY_ATOMIC_SEG_QUEUE_H
+
+#include "mercury_util_config.h"
+
+#include <stdbool.h>
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/**
+ * Unbounded lock-free multi-producer / multi-consumer queue. The queue is
+ * made of a linked list of fixed-size segments, producers and consumers
+ * reserve slots within the tail and head segments using atomic increments
+ * and a new segment is appended whenever the tail segment is full. Segments
+ * that have been fully consumed are reclaimed using epochs so that no
+ * segment is freed while another thread may still access it.
+ */
+struct hg_atomic_seg_queue;
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocate a new queue made of segments of \seg_count elements each.
+ *
+ * \param seg_count [IN]            number of elements per segment
+ *
+ * \return pointer to allocated queue or NULL on failure
+ */
+HG_UTIL_PUBLIC struct hg_atomic_seg_queue *
+hg_atomic_seg_queue_alloc(unsigned int seg_count);
+
+/**
+ * Free an existing queue. No other thread may access the queue.
+ *
+ * \param hg_atomic_seg_queue [IN]  pointer to queue
+ */
+HG_UTIL_PUBLIC void
+hg_atomic_seg_queue_free(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Push an entry to the queue. \entry must not be NULL.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param entry [IN]                    pointer to object
+ *
+ * \return HG_UTIL_SUCCESS if successful or HG_UTIL_FAIL if a new segment
+ * could not be allocated
+ */
+HG_UTIL_PUBLIC int
+hg_atomic_seg_queue_push(
+    struct hg_atomic_seg_queue *hg_atomic_seg_queue, void *entry);
+
+/**
+ * Pop an entry from the queue.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ *
+ * \return Pointer to popped object or NULL if queue is empty
+ */
+HG_UTIL_PUBLIC void *
+hg_atomic_seg_queue_pop(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Pop up to \max_count entries from the queue in FIFO order.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ * \param entries [OUT]                 array of at least \max_count pointers
+ * \param max_count [IN]                maximum number of entries to pop
+ *
+ * \return Number of entries popped or 0 if queue is empty
+ */
+HG_UTIL_PUBLIC unsigned int
+hg_atomic_seg_queue_pop_batch(struct hg_atomic_seg_queue *hg_atomic_seg_queue,
+    void **entries, unsigned int max_count);
+
+/**
+ * Determine whether queue is empty.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ *
+ * \return true if empty, false if not
+ */
+HG_UTIL_PUBLIC bool
+hg_atomic_seg_queue_is_empty(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+/**
+ * Determine approximate number of elements in queue.
+ *
+ * \param hg_atomic_seg_queue [IN/OUT]  pointer to queue
+ *
+ * \return Number of elements queued
+ */
+HG_UTIL_PUBLIC unsigned int
+hg_atomic_seg_queue_count(struct hg_atomic_seg_queue *hg_atomic_seg_queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_ATOMIC_SEG_QUEUE_H */
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MERCURY_BACKOFF_H
+#define MERCURY_BACKOFF_H
+
+#include "mercury_util_config.h"
+
+#include "mercury_time.h"
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/* Exponential backoff between attempts of a resource that is busy */
+struct hg_backoff {
+    hg_time_t next;  /* Earliest time of next attempt */
+    hg_time_t delay; /* Delay applied after next failed attempt */
+    hg_time_t min;   /* Delay after first failed attempt */
+    hg_time_t max;   /* Delay cap */
+};
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize backoff so that the first attempt is immediately allowed.
+ *
+ * \param backoff [IN/OUT]      pointer to backoff
+ * \param min_us [IN]           delay after first failed attempt (us)
+ * \param max_us [IN]           maximum delay between attempts (us)
+ */
+static HG_UTIL_INLINE void
+hg_backoff_init(
+    struct hg_backoff *backoff, unsigned int min_us, unsigned int max_us);
+
+/**
+ * Check whether an attempt can be made at time now.
+ *
+ * \param backoff [IN]          pointer to backoff
+ * \param now [IN]              current time
+ *
+ * \return true if attempt is due, false otherwise
+ */
+static HG_UTIL_INLINE bool
+hg_backoff_ready(const struct hg_backoff *backoff, hg_time_t now);
+
+/**
+ * Record a failed attempt at time now, next attempt is delayed by twice the
+ * previous delay (bounded by the maximum delay).
+ *
+ * \param backoff [IN/OUT]      pointer to backoff
+ * \param now [IN]              current time
+ */
+static HG_UTIL_INLINE void
+hg_backoff_fail(struct hg_backoff *backoff, hg_time_t now);
+
+/**
+ * Record a successful attempt, next attempt is immediately allowed.
+ *
+ * \param backoff [IN/OUT]      pointer to backoff
+ */
+static HG_UTIL_INLINE void
+hg_backoff_reset(struct hg_backoff *backoff);
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_backoff_init(
+    struct hg_backoff *backoff, unsigned int min_us, unsigned int max_us)
+{
+    backoff->min = hg_time_from_double((double) min_us / 1000000.0);
+    backoff->max = hg_time_from_double((double) max_us / 1000000.0);
+    hg_backoff_reset(backoff);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE bool
+hg_backoff_ready(const struct hg_backoff *backoff, hg_time_t now)
+{
+    return !hg_time_less(now, backoff->next);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_backoff_fail(struct hg_backoff *backoff, hg_time_t now)
+{
+    backoff->next = hg_time_add(now, backoff->delay);
+    backoff->delay = hg_time_add(backoff->delay, backoff->delay);
+    if (hg_time_less(backoff->max, backoff->delay))
+        backoff->delay = backoff->max;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_backoff_reset(struct hg_backoff *backoff)
+{
+    backoff->next = (hg_time_t){0};
+    backoff->delay = backoff->min;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_BACKOFF_H */
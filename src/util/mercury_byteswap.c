@@ -0,0 +1,264 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_byteswap.h"
+#include "mercury_compiler_attributes.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(HG_UTIL_HAS_X86_BSWAP)
+#    include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define HG_BSWAP_NEON
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+#ifdef HG_UTIL_HAS_X86_BSWAP
+#    define HG_BSWAP_TARGET(x) __attribute__((target(x)))
+
+/* pshufb masks reversing bytes of each 32-bit / 64-bit value in a lane */
+#    define HG_BSWAP_32_MASK                                                   \
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+#    define HG_BSWAP_64_MASK                                                   \
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+#endif
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Select byteswap kernels.
+ */
+static void
+hg_bswap_init(void) HG_ATTR_CONSTRUCTOR;
+
+/**
+ * Scalar kernels.
+ */
+static void
+hg_bswap_32_scalar(void *dest, const void *src, size_t count);
+static void
+hg_bswap_64_scalar(void *dest, const void *src, size_t count);
+
+#if defined(HG_UTIL_HAS_X86_BSWAP)
+/**
+ * SSSE3 kernels.
+ */
+static void
+hg_bswap_32_ssse3(void *dest, const void *src, size_t count);
+static void
+hg_bswap_64_ssse3(void *dest, const void *src, size_t count);
+
+/**
+ * AVX2 kernels.
+ */
+static void
+hg_bswap_32_avx2(void *dest, const void *src, size_t count);
+static void
+hg_bswap_64_avx2(void *dest, const void *src, size_t count);
+#elif defined(HG_BSWAP_NEON)
+/**
+ * NEON kernels.
+ */
+static void
+hg_bswap_32_neon(void *dest, const void *src, size_t count);
+static void
+hg_bswap_64_neon(void *dest, const void *src, size_t count);
+#endif
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Selected kernels */
+#if defined(HG_BSWAP_NEON)
+static void (*hg_bswap_32_array_g)(void *, const void *, size_t) =
+    hg_bswap_32_neon;
+static void (*hg_bswap_64_array_g)(void *, const void *, size_t) =
+    hg_bswap_64_neon;
+#else
+static void (*hg_bswap_32_array_g)(void *, const void *, size_t) =
+    hg_bswap_32_scalar;
+static void (*hg_bswap_64_array_g)(void *, const void *, size_t) =
+    hg_bswap_64_scalar;
+#endif
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bswap_init(void)
+{
+#if defined(HG_UTIL_HAS_X86_BSWAP)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        hg_bswap_32_array_g = hg_bswap_32_avx2;
+        hg_bswap_64_array_g = hg_bswap_64_avx2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        hg_bswap_32_array_g = hg_bswap_32_ssse3;
+        hg_bswap_64_array_g = hg_bswap_64_ssse3;
+    }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bswap_32_scalar(void *dest, const void *src, size_t count)
+{
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+    size_t i;
+
+    for (i = 0; i < count; i++, d += sizeof(uint32_t), s += sizeof(uint32_t)) {
+        uint32_t v;
+
+        memcpy(&v, s, sizeof(v));
+        v = bswap_32(v);
+        memcpy(d, &v, sizeof(v));
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bswap_64_scalar(void *dest, const void *src, size_t count)
+{
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+    size_t i;
+
+    for (i = 0; i < count; i++, d += sizeof(uint64_t), s += sizeof(uint64_t)) {
+        uint64_t v;
+
+        memcpy(&v, s, sizeof(v));
+        v = bswap_64(v);
+        memcpy(d, &v, sizeof(v));
+    }
+}
+
+#if defined(HG_UTIL_HAS_X86_BSWAP)
+/*---------------------------------------------------------------------------*/
+static HG_BSWAP_TARGET("ssse3") void
+hg_bswap_32_ssse3(void *dest, const void *src, size_t count)
+{
+    const __m128i mask = _mm_setr_epi8(HG_BSWAP_32_MASK);
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+
+    for (; count >= 8; count -= 8, d += 32, s += 32) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *) s);
+        __m128i v1 = _mm_loadu_si128((const __m128i *) (s + 16));
+        _mm_storeu_si128((__m128i *) d, _mm_shuffle_epi8(v0, mask));
+        _mm_storeu_si128((__m128i *) (d + 16), _mm_shuffle_epi8(v1, mask));
+    }
+    hg_bswap_32_scalar(d, s, count);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_BSWAP_TARGET("ssse3") void
+hg_bswap_64_ssse3(void *dest, const void *src, size_t count)
+{
+    const __m128i mask = _mm_setr_epi8(HG_BSWAP_64_MASK);
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+
+    for (; count >= 4; count -= 4, d += 32, s += 32) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *) s);
+        __m128i v1 = _mm_loadu_si128((const __m128i *) (s + 16));
+        _mm_storeu_si128((__m128i *) d, _mm_shuffle_epi8(v0, mask));
+        _mm_storeu_si128((__m128i *) (d + 16), _mm_shuffle_epi8(v1, mask));
+    }
+    hg_bswap_64_scalar(d, s, count);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_BSWAP_TARGET("avx2") void
+hg_bswap_32_avx2(void *dest, const void *src, size_t count)
+{
+    const __m256i mask =
+        _mm256_setr_epi8(HG_BSWAP_32_MASK, HG_BSWAP_32_MASK);
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+
+    for (; count >= 16; count -= 16, d += 64, s += 64) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *) s);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *) (s + 32));
+        _mm256_storeu_si256((__m256i *) d, _mm256_shuffle_epi8(v0, mask));
+        _mm256_storeu_si256(
+            (__m256i *) (d + 32), _mm256_shuffle_epi8(v1, mask));
+    }
+    hg_bswap_32_scalar(d, s, count);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_BSWAP_TARGET("avx2") void
+hg_bswap_64_avx2(void *dest, const void *src, size_t count)
+{
+    const __m256i mask =
+        _mm256_setr_epi8(HG_BSWAP_64_MASK, HG_BSWAP_64_MASK);
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+
+    for (; count >= 8; count -= 8, d += 64, s += 64) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *) s);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *) (s + 32));
+        _mm256_storeu_si256((__m256i *) d, _mm256_shuffle_epi8(v0, mask));
+        _mm256_storeu_si256(
+            (__m256i *) (d + 32), _mm256_shuffle_epi8(v1, mask));
+    }
+    hg_bswap_64_scalar(d, s, count);
+}
+#elif defined(HG_BSWAP_NEON)
+/*---------------------------------------------------------------------------*/
+static void
+hg_bswap_32_neon(void *dest, const void *src, size_t count)
+{
+    uint8_t *d = (uint8_t *) dest;
+    const uint8_t *s = (const uint8_t *) src;
+
+    for (; count >= 8; count -= 8, d += 32, s += 32) {
+        uint8x16_t v0 = vld1q_u8(s);
+        uint8x16_t v1 = vld1q_u8(s + 16);
+        vst1q_u8(d, vrev32q_u8(v0));
+        vst1q_u8(d + 16, vrev32q_u8(v1));
+    }
+    hg_bswap_32_scalar(d, s, count);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_bswap_64_neon(void *dest, const void *src, size_t count)
+{
+    uint8_t *d = (uint8_t *) dest;
+    const uint8_t *s = (const uint8_t *) src;
+
+    for (; count >= 4; count -= 4, d += 32, s += 32) {
+        uint8x16_t v0 = vld1q_u8(s);
+        uint8x16_t v1 = vld1q_u8(s + 16);
+        vst1q_u8(d, vrev64q_u8(v0));
+        vst1q_u8(d + 16, vrev64q_u8(v1));
+    }
+    hg_bswap_64_scalar(d, s, count);
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+void
+hg_bswap_32_array(void *dest, const void *src, size_t count)
+{
+    hg_bswap_32_array_g(dest, src, count);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_bswap_64_array(void *dest, const void *src, size_t count)
+{
+    hg_bswap_64_array_g(dest, src, count);
+}
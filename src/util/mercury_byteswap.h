@@ -24,4 +24,41 @@
 #    include <byteswap.h>
 #endif
 
+#include <stddef.h>
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Byteswap an array of 32-bit values. Uses SIMD kernels when the CPU
+ * supports them (AVX2 / SSSE3 on x86, NEON on Arm). Arrays do not need to
+ * be aligned and dest may be the same as src (but must not otherwise
+ * overlap).
+ *
+ * \param dest [OUT]            pointer to destination array
+ * \param src [IN]              pointer to source array
+ * \param count [IN]            number of 32-bit values
+ */
+HG_UTIL_PUBLIC void
+hg_bswap_32_array(void *dest, const void *src, size_t count);
+
+/**
+ * Byteswap an array of 64-bit values. Same as hg_bswap_32_array().
+ *
+ * \param dest [OUT]            pointer to destination array
+ * \param src [IN]              pointer to source array
+ * \param count [IN]            number of 64-bit values
+ */
+HG_UTIL_PUBLIC void
+hg_bswap_64_array(void *dest, const void *src, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* MERCURY_BYTESWAP_H */
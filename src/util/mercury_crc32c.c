@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_crc32c.h"
+#include "mercury_compiler_attributes.h"
+
+#include <string.h>
+
+#if defined(HG_UTIL_HAS_X86_CRC32C)
+#    include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32) &&                  \
+    !defined(__AARCH64EB__)
+#    include <arm_acle.h>
+#    define HG_CRC32C_ARM
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Reversed Castagnoli polynomial */
+#define HG_CRC32C_POLY (0x82F63B78)
+
+#ifdef HG_UTIL_HAS_X86_CRC32C
+#    define HG_CRC32C_TARGET(x) __attribute__((target(x)))
+#endif
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Build table and select kernel.
+ */
+static void
+hg_crc32c_init(void) HG_ATTR_CONSTRUCTOR;
+
+/**
+ * Table-driven (slicing-by-8) kernel.
+ */
+static uint32_t
+hg_crc32c_sw(uint32_t crc, const void *buf, size_t size);
+
+/**
+ * Multiply a and b modulo the polynomial (reflected bit order).
+ */
+static uint32_t
+hg_crc32c_multmodp(uint32_t a, uint32_t b);
+
+#if defined(HG_UTIL_HAS_X86_CRC32C)
+/**
+ * SSE4.2 kernel.
+ */
+static uint32_t
+hg_crc32c_sse42(uint32_t crc, const void *buf, size_t size);
+#elif defined(HG_CRC32C_ARM)
+/**
+ * ARMv8 CRC kernel.
+ */
+static uint32_t
+hg_crc32c_arm(uint32_t crc, const void *buf, size_t size);
+#endif
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Lookup tables for slicing-by-8 */
+static uint32_t hg_crc32c_table_g[8][256];
+
+/* x^(2^n) modulo the polynomial, used to combine checksums */
+static uint32_t hg_crc32c_x2n_table_g[32];
+
+/* Selected kernel */
+#if defined(HG_CRC32C_ARM)
+static uint32_t (*hg_crc32c_g)(uint32_t, const void *, size_t) =
+    hg_crc32c_arm;
+#else
+static uint32_t (*hg_crc32c_g)(uint32_t, const void *, size_t) =
+    hg_crc32c_sw;
+#endif
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_crc32c_init(void)
+{
+    uint32_t i, j, crc;
+
+    for (i = 0; i < 256; i++) {
+        crc = i;
+        for (j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ ((crc & 1) ? HG_CRC32C_POLY : 0);
+        hg_crc32c_table_g[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++) {
+        crc = hg_crc32c_table_g[0][i];
+        for (j = 1; j < 8; j++) {
+            crc = hg_crc32c_table_g[0][crc & 0xff] ^ (crc >> 8);
+            hg_crc32c_table_g[j][i] = crc;
+        }
+    }
+
+    /* x^1 is 1 << 30 in reflected bit order */
+    crc = (uint32_t) 1 << 30;
+    hg_crc32c_x2n_table_g[0] = crc;
+    for (i = 1; i < 32; i++)
+        hg_crc32c_x2n_table_g[i] = crc = hg_crc32c_multmodp(crc, crc);
+
+#if defined(HG_UTIL_HAS_X86_CRC32C)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        hg_crc32c_g = hg_crc32c_sse42;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static uint32_t
+hg_crc32c_sw(uint32_t crc, const void *buf, size_t size)
+{
+    const unsigned char *p = (const unsigned char *) buf;
+
+    crc = ~crc;
+    for (; size >= 8; size -= 8, p += 8) {
+        uint32_t lo, hi;
+
+        memcpy(&lo, p, sizeof(lo));
+        memcpy(&hi, p + 4, sizeof(hi));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        lo = __builtin_bswap32(lo);
+        hi = __builtin_bswap32(hi);
+#endif
+        lo ^= crc;
+        crc = hg_crc32c_table_g[7][lo & 0xff] ^
+              hg_crc32c_table_g[6][(lo >> 8) & 0xff] ^
+              hg_crc32c_table_g[5][(lo >> 16) & 0xff] ^
+              hg_crc32c_table_g[4][lo >> 24] ^
+              hg_crc32c_table_g[3][hi & 0xff] ^
+              hg_crc32c_table_g[2][(hi >> 8) & 0xff] ^
+              hg_crc32c_table_g[1][(hi >> 16) & 0xff] ^
+              hg_crc32c_table_g[0][hi >> 24];
+    }
+    for (; size > 0; size--, p++)
+        crc = hg_crc32c_table_g[0][(crc ^ *p) & 0xff] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+/*---------------------------------------------------------------------------*/
+static uint32_t
+hg_crc32c_multmodp(uint32_t a, uint32_t b)
+{
+    uint32_t m = (uint32_t) 1 << 31, p = 0;
+
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ HG_CRC32C_POLY : b >> 1;
+    }
+
+    return p;
+}
+
+#if defined(HG_UTIL_HAS_X86_CRC32C)
+/*---------------------------------------------------------------------------*/
+static HG_CRC32C_TARGET("sse4.2") uint32_t
+hg_crc32c_sse42(uint32_t crc, const void *buf, size_t size)
+{
+    const unsigned char *p = (const unsigned char *) buf;
+
+    crc = ~crc;
+#    ifdef __x86_64__
+    {
+        uint64_t crc64 = crc;
+
+        for (; size >= 8; size -= 8, p += 8) {
+            uint64_t v;
+
+            memcpy(&v, p, sizeof(v));
+            crc64 = _mm_crc32_u64(crc64, v);
+        }
+        crc = (uint32_t) crc64;
+    }
+#    endif
+    for (; size >= 4; size -= 4, p += 4) {
+        uint32_t v;
+
+        memcpy(&v, p, sizeof(v));
+        crc = _mm_crc32_u32(crc, v);
+    }
+    for (; size > 0; size--, p++)
+        crc = _mm_crc32_u8(crc, *p);
+
+    return ~crc;
+}
+#elif defined(HG_CRC32C_ARM)
+/*---------------------------------------------------------------------------*/
+static uint32_t
+hg_crc32c_arm(uint32_t crc, const void *buf, size_t size)
+{
+    const unsigned char *p = (const unsigned char *) buf;
+
+    crc = ~crc;
+    for (; size >= 8; size -= 8, p += 8) {
+        uint64_t v;
+
+        memcpy(&v, p, sizeof(v));
+        crc = __crc32cd(crc, v);
+    }
+    for (; size > 0; size--, p++)
+        crc = __crc32cb(crc, *p);
+
+    return ~crc;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+uint32_t
+hg_crc32c(uint32_t crc, const void *buf, size_t size)
+{
+    return hg_crc32c_g(crc, buf, size);
+}
+
+/*---------------------------------------------------------------------------*/
+uint32_t
+hg_crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t size2)
+{
+    uint32_t p = (uint32_t) 1 << 31; /* x^0 */
+    unsigned int k = 3;              /* Size is in bytes, x^(8 * size2) */
+
+    /* Shift first checksum by size of second block */
+    for (; size2 > 0; size2 >>= 1, k++)
+        if (size2 & 1)
+            p = hg_crc32c_multmodp(hg_crc32c_x2n_table_g[k & 31], p);
+
+    return hg_crc32c_multmodp(p, crc1) ^ crc2;
+}
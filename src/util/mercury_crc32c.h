@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MERCURY_CRC32C_H
+#define MERCURY_CRC32C_H
+
+#include "mercury_util_config.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Compute the CRC32C (Castagnoli) checksum of a buffer. Uses the CRC32
+ * instructions when the CPU supports them (SSE4.2 on x86, ARMv8 CRC
+ * extension on Arm) and a table-driven implementation otherwise. The
+ * checksum of a buffer that is processed in several parts can be obtained by
+ * passing the result of the previous call as \crc, starting from 0.
+ *
+ * \param crc [IN]              checksum of previous data or 0
+ * \param buf [IN]              pointer to data
+ * \param size [IN]             size of data
+ *
+ * \return CRC32C checksum
+ */
+HG_UTIL_PUBLIC uint32_t
+hg_crc32c(uint32_t crc, const void *buf, size_t size);
+
+/**
+ * Combine the CRC32C checksums of two consecutive blocks of data into the
+ * checksum of their concatenation, so that blocks can be processed in any
+ * order.
+ *
+ * \param crc1 [IN]             checksum of first block
+ * \param crc2 [IN]             checksum of second block
+ * \param size2 [IN]            size of second block
+ *
+ * \return CRC32C checksum of both blocks
+ */
+HG_UTIL_PUBLIC uint32_t
+hg_crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t size2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_CRC32C_H */
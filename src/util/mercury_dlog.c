@@ -29,10 +29,130 @@
 /* Local Prototypes */
 /********************/
 
+/* Get calling thread's ring */
+static HG_UTIL_INLINE struct hg_dlog_ring *
+hg_dlog_get_ring(struct hg_dlog *d);
+
+/* Create calling thread's ring */
+static struct hg_dlog_ring *
+hg_dlog_ring_create(struct hg_dlog *d);
+
+/* Prepare rings for a merged dump (dlock held), return #entries */
+static unsigned int
+hg_dlog_merge_start(struct hg_dlog *d);
+
+/* Copy next entry in time order (dlock held), return 0 when done */
+static int
+hg_dlog_merge_next(struct hg_dlog *d, struct hg_dlog_entry *entry);
+
 /*******************/
 /* Local Variables */
 /*******************/
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE struct hg_dlog_ring *
+hg_dlog_get_ring(struct hg_dlog *d)
+{
+    struct hg_dlog_ring *ring = NULL;
+
+    if (hg_atomic_get32(&d->ring_key_init))
+        ring = (struct hg_dlog_ring *) hg_thread_getspecific(d->ring_key);
+
+    return (ring != NULL) ? ring : hg_dlog_ring_create(d);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_dlog_ring *
+hg_dlog_ring_create(struct hg_dlog *d)
+{
+    struct hg_dlog_ring *ring = NULL;
+
+    hg_thread_mutex_lock(&d->dlock);
+    if (!hg_atomic_get32(&d->ring_key_init)) {
+        if (hg_thread_key_create(&d->ring_key) != HG_UTIL_SUCCESS)
+            goto done;
+        hg_atomic_set32(&d->ring_key_init, 1);
+    }
+
+    /* first ring uses the entries given to the dlog, others get their own */
+    if (d->rings == NULL) {
+        ring = malloc(sizeof(*ring));
+        if (!ring)
+            goto done;
+        ring->le = d->le;
+    } else {
+        ring = malloc(sizeof(*ring) + sizeof(*ring->le) * d->lesize);
+        if (!ring)
+            goto done;
+        ring->le = (struct hg_dlog_entry *) (ring + 1);
+    }
+    hg_atomic_init64(&ring->head, 0);
+    hg_atomic_init64(&ring->tail, 0);
+    ring->cur = 0;
+    ring->end = 0;
+
+    if (hg_thread_setspecific(d->ring_key, ring) != HG_UTIL_SUCCESS) {
+        free(ring);
+        ring = NULL;
+        goto done;
+    }
+    ring->next = d->rings;
+    d->rings = ring;
+
+done:
+    hg_thread_mutex_unlock(&d->dlock);
+    return ring;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_dlog_merge_start(struct hg_dlog *d)
+{
+    struct hg_dlog_ring *ring;
+    unsigned int count = 0;
+
+    for (ring = d->rings; ring != NULL; ring = ring->next) {
+        ring->end = hg_atomic_get64(&ring->head);
+        ring->cur = hg_atomic_get64(&ring->tail);
+        if (ring->end - ring->cur > (int64_t) d->lesize)
+            ring->cur = ring->end - (int64_t) d->lesize;
+        count += (unsigned int) (ring->end - ring->cur);
+    }
+
+    return count;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_dlog_merge_next(struct hg_dlog *d, struct hg_dlog_entry *entry)
+{
+    for (;;) {
+        struct hg_dlog_ring *ring, *min_ring = NULL;
+        int64_t idx;
+
+        for (ring = d->rings; ring != NULL; ring = ring->next) {
+            if (ring->cur >= ring->end)
+                continue;
+            if (min_ring == NULL ||
+                hg_time_less(ring->le[ring->cur % d->lesize].time,
+                    min_ring->le[min_ring->cur % d->lesize].time))
+                min_ring = ring;
+        }
+        if (min_ring == NULL)
+            return 0;
+
+        idx = min_ring->cur++;
+        *entry = min_ring->le[idx % d->lesize];
+
+        /* skip entries that the owner overwrote after it wrapped around
+         * (an entry that is being overwritten while copying may be torn,
+         * all its fields still point to static data though) */
+        hg_atomic_fence();
+        if (hg_atomic_get64(&min_ring->head) - idx <= (int64_t) d->lesize)
+            return 1;
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 struct hg_dlog *
 hg_dlog_alloc(char *name, unsigned int lesize, int leloop)
@@ -85,6 +205,16 @@ hg_dlog_free(struct hg_dlog *d)
     }
     HG_LIST_INIT(&d->cnts64);
 
+    while (d->rings) {
+        struct hg_dlog_ring *ring = d->rings;
+        d->rings = ring->next;
+        free(ring);
+    }
+    if (hg_atomic_get32(&d->ring_key_init)) {
+        hg_thread_key_delete(d->ring_key);
+        hg_atomic_set32(&d->ring_key_init, 0);
+    }
+
     if (d->mallocd) {
         free(d->le);
         free(d);
@@ -137,35 +267,66 @@ hg_dlog_mkcount64(struct hg_dlog *d, hg_atomic_int64_t **cptr, const char *name,
     hg_thread_mutex_unlock(&d->dlock);
 }
 
+/*---------------------------------------------------------------------------*/
+int
+hg_dlog_foreach_counter(struct hg_dlog *d,
+    int (*cb)(const char *name, const char *descr, int64_t value, void *arg),
+    void *arg)
+{
+    struct hg_dlog_dcount32 *dc32;
+    struct hg_dlog_dcount64 *dc64;
+    int rc = 0;
+
+    hg_thread_mutex_lock(&d->dlock);
+    HG_LIST_FOREACH (dc32, &d->cnts32, l) {
+        rc = cb(dc32->name, dc32->descr, (int64_t) hg_atomic_get32(&dc32->c),
+            arg);
+        if (rc != 0)
+            goto done;
+    }
+    HG_LIST_FOREACH (dc64, &d->cnts64, l) {
+        rc = cb(dc64->name, dc64->descr, hg_atomic_get64(&dc64->c), arg);
+        if (rc != 0)
+            goto done;
+    }
+
+done:
+    hg_thread_mutex_unlock(&d->dlock);
+
+    return rc;
+}
+
 /*---------------------------------------------------------------------------*/
 unsigned int
 hg_dlog_addlog(struct hg_dlog *d, const char *file, unsigned int line,
     const char *func, const char *msg, const void *data)
 {
-    unsigned int rv = 0;
-    unsigned int idx;
+    struct hg_dlog_ring *ring;
+    struct hg_dlog_entry *le;
+    int64_t head;
 
-    hg_thread_mutex_lock(&d->dlock);
     if (d->lestop)
-        goto done;
-    if (d->leloop == 0 && d->leadds >= d->lesize)
-        goto done;
-    idx = d->lefree;
-    d->lefree = (d->lefree + 1) % d->lesize;
-    if (d->leadds < d->lesize)
-        d->leadds++;
-    d->le[idx] = (struct hg_dlog_entry){.file = file,
+        return 0;
+    ring = hg_dlog_get_ring(d);
+    if (ring == NULL)
+        return 0;
+
+    /* only this thread moves head, tail only moves up to head */
+    head = hg_atomic_get64(&ring->head);
+    if (d->leloop == 0 &&
+        head - hg_atomic_get64(&ring->tail) >= (int64_t) d->lesize)
+        return 0;
+    le = &ring->le[head % d->lesize];
+    *le = (struct hg_dlog_entry){.file = file,
         .line = line,
         .func = func,
         .msg = msg,
         .data = data,
         .time = hg_time_from_ms(0)};
-    hg_time_get_current(&d->le[idx].time);
-    rv = 1;
+    hg_time_get_current(&le->time);
+    hg_atomic_set64(&ring->head, head + 1);
 
-done:
-    hg_thread_mutex_unlock(&d->dlock);
-    return rv;
+    return 1;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -179,9 +340,11 @@ hg_dlog_setlogstop(struct hg_dlog *d, int stop)
 void
 hg_dlog_resetlog(struct hg_dlog *d)
 {
+    struct hg_dlog_ring *ring;
+
     hg_thread_mutex_lock(&d->dlock);
-    d->lefree = 0;
-    d->leadds = 0;
+    for (ring = d->rings; ring != NULL; ring = ring->next)
+        hg_atomic_set64(&ring->tail, hg_atomic_get64(&ring->head));
     hg_thread_mutex_unlock(&d->dlock);
 }
 
@@ -190,7 +353,8 @@ void
 hg_dlog_dump(struct hg_dlog *d, int (*log_func)(FILE *, const char *, ...),
     FILE *stream, int trylock)
 {
-    unsigned int left, idx;
+    struct hg_dlog_entry entry;
+    unsigned int nents;
     struct hg_dlog_dcount32 *dc32;
     struct hg_dlog_dcount64 *dc64;
 
@@ -203,7 +367,8 @@ hg_dlog_dump(struct hg_dlog *d, int (*log_func)(FILE *, const char *, ...),
     } else
         hg_thread_mutex_lock(&d->dlock);
 
-    if (d->leadds > 0) {
+    nents = hg_dlog_merge_start(d);
+    if (nents > 0) {
         log_func(stream,
             "### ----------------------\n"
             "### (%s) debug log summary\n"
@@ -222,17 +387,12 @@ hg_dlog_dump(struct hg_dlog *d, int (*log_func)(FILE *, const char *, ...),
             log_func(stream, "# -\n");
         }
 
-        log_func(stream, "# Number of log entries: %d\n", d->leadds);
+        log_func(stream, "# Number of log entries: %u\n", nents);
 
-        idx = (d->lefree < d->leadds) ? d->lesize + d->lefree - d->leadds
-                                      : d->lefree - d->leadds;
-        left = d->leadds;
-        while (left--) {
+        while (hg_dlog_merge_next(d, &entry))
             log_func(stream, "# [%lf] %s:%d\n## %s()\n",
-                hg_time_to_double(d->le[idx].time), d->le[idx].file,
-                d->le[idx].line, d->le[idx].func);
-            idx = (idx + 1) % d->lesize;
-        }
+                hg_time_to_double(entry.time), entry.file, entry.line,
+                entry.func);
     }
 
     hg_thread_mutex_unlock(&d->dlock);
@@ -284,7 +444,7 @@ hg_dlog_dump_file(struct hg_dlog *d, const char *base, int addpid, int trylock)
     char buf[BUFSIZ];
     int pid;
     FILE *fp = NULL;
-    unsigned int left, idx;
+    struct hg_dlog_entry entry;
     struct hg_dlog_dcount32 *dc32;
     struct hg_dlog_dcount64 *dc64;
 
@@ -326,17 +486,11 @@ hg_dlog_dump_file(struct hg_dlog *d, const char *base, int addpid, int trylock)
     }
     fprintf(fp, "# END COUNTERS\n\n");
 
-    fprintf(fp, "# NLOGS %d FOR %d\n", d->leadds, pid);
+    fprintf(fp, "# NLOGS %u FOR %d\n", hg_dlog_merge_start(d), pid);
 
-    idx = (d->lefree < d->leadds) ? d->lesize + d->lefree - d->leadds
-                                  : d->lefree - d->leadds;
-    left = d->leadds;
-    while (left--) {
-        fprintf(fp, "%lf %d %s %u %s %s %p\n",
-            hg_time_to_double(d->le[idx].time), pid, d->le[idx].file,
-            d->le[idx].line, d->le[idx].func, d->le[idx].msg, d->le[idx].data);
-        idx = (idx + 1) % d->lesize;
-    }
+    while (hg_dlog_merge_next(d, &entry))
+        fprintf(fp, "%lf %d %s %u %s %s %p\n", hg_time_to_double(entry.time),
+            pid, entry.file, entry.line, entry.func, entry.msg, entry.data);
 
     hg_thread_mutex_unlock(&d->dlock);
     fclose(fp);
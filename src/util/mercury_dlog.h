@@ -12,6 +12,7 @@
 
 #include "mercury_atomic.h"
 #include "mercury_list.h"
+#include "mercury_thread.h"
 #include "mercury_thread_mutex.h"
 #include "mercury_time.h"
 
@@ -30,7 +31,9 @@
 
 /*
  * HG_DLOG_INITIALIZER: initializer for a dlog in a global variable.
- * LESIZE is the number of entries in the LE array.  use it like this:
+ * LESIZE is the number of entries in the LE array.  the LE array is
+ * used by the first thread that adds to the log, other threads get a
+ * malloc'd array of the same size.  use it like this:
  *
  * #define FOO_NENTS 128
  * struct hg_dlog_entry foo_le[FOO_NENTS];
@@ -40,7 +43,8 @@
     {                                                                          \
         HG_DLOG_STDMAGIC NAME, HG_THREAD_MUTEX_INITIALIZER,                    \
             HG_LIST_HEAD_INITIALIZER(cnts32),                                  \
-            HG_LIST_HEAD_INITIALIZER(cnts64), LE, LESIZE, LELOOP, 0, 0, 0, 0   \
+            HG_LIST_HEAD_INITIALIZER(cnts64), LE, LESIZE, LELOOP, 0, 0, NULL,  \
+            0, HG_ATOMIC_VAR_INIT(0)                                           \
     }
 
 /*************************************/
@@ -59,6 +63,22 @@ struct hg_dlog_entry {
     hg_time_t time;    /* time added to log */
 };
 
+/*
+ * hg_dlog_ring: per-thread circular buffer of log entries.  only the
+ * owning thread adds entries, so adding does not need a lock.  the
+ * head and tail are running counts of adds (entry index is count %
+ * lesize), which lets a reader detect entries overwritten while it
+ * was reading them.
+ */
+struct hg_dlog_ring {
+    struct hg_dlog_entry *le;  /* array of log entries (lesize) */
+    hg_atomic_int64_t head;    /* #adds done since creation */
+    hg_atomic_int64_t tail;    /* value of head at last reset */
+    int64_t cur;               /* next entry to dump (under dlock) */
+    int64_t end;               /* end of entries to dump (under dlock) */
+    struct hg_dlog_ring *next; /* next ring of the dlog */
+};
+
 /*
  * hg_dlog_dcount32: 32-bit debug counter in the dlog
  */
@@ -91,14 +111,17 @@ struct hg_dlog {
     HG_LIST_HEAD(hg_dlog_dcount64) cnts64; /* counter list */
 
     /* log */
-    struct hg_dlog_entry *le; /* array of log entries */
-    unsigned int lesize;      /* size of le[] array */
+    struct hg_dlog_entry *le; /* array of log entries for first ring */
+    unsigned int lesize;      /* size of le[] array of each ring */
     int leloop;               /* circular buffer? */
-    unsigned int lefree;      /* next free entry in le[] */
-    unsigned int leadds;      /* #adds done if < lesize */
     int lestop;               /* stop taking new logs */
 
     int mallocd; /* allocated with malloc? */
+
+    /* per-thread rings */
+    struct hg_dlog_ring *rings;      /* list of rings (under dlock) */
+    hg_thread_key_t ring_key;        /* key to calling thread's ring */
+    hg_atomic_int32_t ring_key_init; /* ring_key created? */
 };
 
 /*********************/
@@ -178,10 +201,30 @@ HG_UTIL_PUBLIC void
 hg_dlog_mkcount64(struct hg_dlog *d, hg_atomic_int64_t **cptr, const char *name,
     const char *descr);
 
+/**
+ * walk all the counters of a dlog and report their current value.  the
+ * dlock is held during the walk, so cb must not create new counters.
+ * each value is read atomically; 32-bit counters are widened to 64 bits.
+ *
+ * \param d [IN]                dlog to walk
+ * \param cb [IN]               callback, return non-zero to stop the walk
+ * \param arg [IN]              callback argument
+ *
+ * \return value returned by the last call to cb (0 if walk completed)
+ */
+HG_UTIL_PUBLIC int
+hg_dlog_foreach_counter(struct hg_dlog *d,
+    int (*cb)(const char *name, const char *descr, int64_t value, void *arg),
+    void *arg);
+
 /**
  * attempt to add a log record to a dlog.  the id and msg should point
  * to static strings that are valid throughout the life of the program
- * (not something that is is on the stack).
+ * (not something that is is on the stack).  records are added to a
+ * ring owned by the calling thread without taking the dlock (except
+ * on the first add from a thread, which creates its ring).  if the
+ * dlog is not circular, each thread stops logging once its own ring
+ * is full.
  *
  * \param d [IN]                the dlog to add the log record to
  * \param file [IN]             file entry
@@ -218,7 +261,7 @@ hg_dlog_resetlog(struct hg_dlog *d);
 /**
  * dump dlog info to a stream. set trylock if you want to dump even
  * if it is locked (e.g. you are crashing and you don't care about
- * locking).
+ * locking).  entries of all threads are merged in time order.
  *
  * \param d [IN]                dlog to dump
  * \param log_func [IN]         log function to use (default printf)
@@ -59,6 +59,25 @@
 #    define strcasecmp _stricmp
 #endif
 
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Counter walk of a debug log */
+struct hg_log_counter_walk {
+    hg_log_counter_cb_t cb; /* User callback */
+    void *arg;              /* User callback argument */
+    const char *subsys;     /* Subsystem owning the debug log */
+};
+
+/* Counter query */
+struct hg_log_counter_query {
+    const char *subsys; /* Subsystem name (NULL for any) */
+    const char *name;   /* Counter name */
+    int64_t value;      /* Sum of matching counters */
+    bool found;         /* At least one counter matched */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -99,6 +118,16 @@ hg_log_outlet_update_level(struct hg_log_outlet *hg_log_outlet);
 static void
 hg_log_outlet_update_all(void);
 
+/* Forward dlog counter to user callback */
+static int
+hg_log_counter_walk_cb(
+    const char *name, const char *descr, int64_t value, void *arg);
+
+/* Add counter value if it matches */
+static int
+hg_log_get_counter_cb(const char *subsys, const char *name, const char *descr,
+    int64_t value, void *arg);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -286,6 +315,34 @@ hg_log_outlet_update_all(void)
         hg_log_outlet_update_level(hg_log_outlet);
 }
 
+/*---------------------------------------------------------------------------*/
+static int
+hg_log_counter_walk_cb(
+    const char *name, const char *descr, int64_t value, void *arg)
+{
+    struct hg_log_counter_walk *walk = (struct hg_log_counter_walk *) arg;
+
+    return walk->cb(walk->subsys, name, descr, value, walk->arg);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_log_get_counter_cb(const char *subsys, const char *name, const char *descr,
+    int64_t value, void *arg)
+{
+    struct hg_log_counter_query *query = (struct hg_log_counter_query *) arg;
+
+    (void) descr;
+
+    if ((query->subsys == NULL || strcmp(query->subsys, subsys) == 0) &&
+        strcmp(query->name, name) == 0) {
+        query->value += value;
+        query->found = true;
+    }
+
+    return 0;
+}
+
 /*---------------------------------------------------------------------------*/
 void
 hg_log_set_level(enum hg_log_level log_level)
@@ -507,6 +564,43 @@ hg_log_outlet_register(struct hg_log_outlet *hg_log_outlet)
     hg_log_outlet->registered = true;
 }
 
+/*---------------------------------------------------------------------------*/
+void
+hg_log_foreach_counter(hg_log_counter_cb_t cb, void *arg)
+{
+    struct hg_log_outlet *outlet;
+
+    HG_QUEUE_FOREACH (outlet, &hg_log_outlets_g, entry) {
+        struct hg_log_counter_walk walk = {
+            .cb = cb, .arg = arg, .subsys = outlet->name};
+
+        /* Skip debug logs inherited from parent, they are walked once */
+        if (outlet->debug_log == NULL ||
+            (outlet->parent && outlet->parent->debug_log == outlet->debug_log))
+            continue;
+
+        if (hg_dlog_foreach_counter(
+                outlet->debug_log, hg_log_counter_walk_cb, &walk) != 0)
+            break;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_log_get_counter(const char *subsys, const char *name, int64_t *value_p)
+{
+    struct hg_log_counter_query query = {
+        .subsys = subsys, .name = name, .value = 0, .found = false};
+
+    hg_log_foreach_counter(hg_log_get_counter_cb, &query);
+    if (!query.found)
+        return HG_UTIL_FAIL;
+
+    *value_p = query.value;
+
+    return HG_UTIL_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 void
 hg_log_write(struct hg_log_outlet *hg_log_outlet, enum hg_log_level log_level,
@@ -58,6 +58,19 @@
     X(HG_LOG_LEVEL_DEBUG, "debug", "dbg", &stdout)           /*!< debug log */ \
     X(HG_LOG_LEVEL_MAX, "", "", NULL)
 
+/* Levels more verbose than HG_UTIL_LOG_LEVEL_MAX are compiled out */
+#ifndef HG_UTIL_LOG_LEVEL_MAX
+#    define HG_UTIL_LOG_LEVEL_MAX HG_LOG_LEVEL_DEBUG
+#endif
+#define HG_LOG_LEVEL_COMPILED(log_level) ((log_level) <= HG_UTIL_LOG_LEVEL_MAX)
+
+/* Outlets are expected to be off, keep the level check off the fast path */
+#if defined(__GNUC__) || defined(__clang__)
+#    define HG_LOG_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#    define HG_LOG_UNLIKELY(x) (x)
+#endif
+
 /* Root log outlet name */
 #define HG_LOG_OUTLET_ROOT_NAME hg_all
 
@@ -130,9 +143,11 @@
 #    define HG_LOG_WRITE_FUNC(                                                 \
         name, log_level, module, file, line, func, no_return, ...)             \
         do {                                                                   \
+            if (!HG_LOG_LEVEL_COMPILED(log_level))                             \
+                break;                                                         \
             if (!HG_LOG_OUTLET(name).registered)                               \
                 hg_log_outlet_register(&HG_LOG_OUTLET(name));                  \
-            if (HG_LOG_OUTLET(name).level >= log_level)                        \
+            if (HG_LOG_UNLIKELY(HG_LOG_OUTLET(name).level >= log_level))       \
                 hg_log_write(&HG_LOG_OUTLET(name), log_level, module, file,    \
                     line, func, no_return, __VA_ARGS__);                       \
         } while (0)
@@ -140,9 +155,12 @@
 #    define HG_LOG_WRITE_FUNC_DEBUG_EXT(                                       \
         name, header, module, file, line, func, no_return, ...)                \
         do {                                                                   \
+            if (!HG_LOG_LEVEL_COMPILED(HG_LOG_LEVEL_DEBUG))                    \
+                break;                                                         \
             if (!HG_LOG_OUTLET(name).registered)                               \
                 hg_log_outlet_register(&HG_LOG_OUTLET(name));                  \
-            if (HG_LOG_OUTLET(name).level == HG_LOG_LEVEL_DEBUG) {             \
+            if (HG_LOG_UNLIKELY(                                               \
+                    HG_LOG_OUTLET(name).level == HG_LOG_LEVEL_DEBUG)) {        \
                 hg_log_func_t log_func = hg_log_get_func();                    \
                 hg_log_write(&HG_LOG_OUTLET(name), HG_LOG_LEVEL_DEBUG, module, \
                     file, line, func, no_return, header);                      \
@@ -154,12 +172,16 @@
 #    define HG_LOG_WRITE_FUNC(                                                 \
         name, log_level, module, file, line, func, no_return, ...)             \
         do {                                                                   \
+            if (!HG_LOG_LEVEL_COMPILED(log_level))                             \
+                break;                                                         \
             if (log_level == HG_LOG_LEVEL_DEBUG &&                             \
-                HG_LOG_OUTLET(name).level >= HG_LOG_LEVEL_MIN_DEBUG &&         \
+                HG_LOG_LEVEL_COMPILED(HG_LOG_LEVEL_MIN_DEBUG) &&               \
+                HG_LOG_UNLIKELY(                                               \
+                    HG_LOG_OUTLET(name).level >= HG_LOG_LEVEL_MIN_DEBUG) &&    \
                 HG_LOG_OUTLET(name).debug_log)                                 \
                 hg_dlog_addlog(HG_LOG_OUTLET(name).debug_log, file, line,      \
                     func, NULL, NULL);                                         \
-            if (HG_LOG_OUTLET(name).level >= log_level)                        \
+            if (HG_LOG_UNLIKELY(HG_LOG_OUTLET(name).level >= log_level))       \
                 hg_log_write(&HG_LOG_OUTLET(name), log_level, module, file,    \
                     line, func, no_return, __VA_ARGS__);                       \
         } while (0)
@@ -167,7 +189,9 @@
 #    define HG_LOG_WRITE_FUNC_DEBUG_EXT(                                       \
         name, header, module, file, line, func, no_return, ...)                \
         do {                                                                   \
-            if (HG_LOG_OUTLET(name).level == HG_LOG_LEVEL_DEBUG) {             \
+            if (HG_LOG_LEVEL_COMPILED(HG_LOG_LEVEL_DEBUG) &&                   \
+                HG_LOG_UNLIKELY(                                               \
+                    HG_LOG_OUTLET(name).level == HG_LOG_LEVEL_DEBUG)) {        \
                 hg_log_func_t log_func = hg_log_get_func();                    \
                 hg_log_write(&HG_LOG_OUTLET(name), HG_LOG_LEVEL_DEBUG, module, \
                     file, line, func, no_return, header);                      \
@@ -255,6 +279,10 @@ struct hg_log_outlet {
 /* Log function */
 typedef int (*hg_log_func_t)(FILE *stream, const char *format, ...);
 
+/* Counter callback (return non-zero to stop iterating) */
+typedef int (*hg_log_counter_cb_t)(const char *subsys, const char *name,
+    const char *descr, int64_t value, void *arg);
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -385,6 +413,32 @@ hg_log_get_stream_debug(void);
 HG_UTIL_PUBLIC void
 hg_log_outlet_register(struct hg_log_outlet *outlet);
 
+/**
+ * Iterate over the counters of all the debug logs that are attached to
+ * registered outlets. Counters are reported with the name of the subsystem
+ * that owns the debug log and are read atomically, so this can be called at
+ * any time while counters are being updated. The callback must not add new
+ * counters.
+ *
+ * \param cb [IN]               callback
+ * \param arg [IN]              callback argument
+ */
+HG_UTIL_PUBLIC void
+hg_log_foreach_counter(hg_log_counter_cb_t cb, void *arg);
+
+/**
+ * Read the current value of a counter. Counters that are registered once per
+ * class under the same name (e.g., NA plugin counters) are summed together.
+ *
+ * \param subsys [IN]           subsystem name (NULL for any)
+ * \param name [IN]             counter name
+ * \param value_p [OUT]         pointer to returned value
+ *
+ * \return Non-negative on success or negative if no counter was found
+ */
+HG_UTIL_PUBLIC int
+hg_log_get_counter(const char *subsys, const char *name, int64_t *value_p);
+
 /**
  * Write log.
  *
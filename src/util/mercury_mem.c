@@ -16,13 +16,131 @@
 #else
 #    include <errno.h>
 #    include <fcntl.h> /* For O_* constants */
-#    include <string.h>
 #    include <sys/mman.h>
 #    include <sys/stat.h> /* For mode constants */
 #    include <sys/types.h>
 #    include <unistd.h>
 #endif
+#ifdef HG_UTIL_HAS_X86_MEM_COPY
+#    include <immintrin.h>
+#endif
 #include <stdlib.h>
+#include <string.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Default non-temporal copy threshold if L2 cache size cannot be queried */
+#define HG_MEM_COPY_NT_THRESHOLD_DEFAULT (1 << 20)
+
+#ifdef HG_UTIL_HAS_X86_MEM_COPY
+#    define HG_MEM_COPY_TARGET(x) __attribute__((target(x)))
+#endif
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/**
+ * Copy kernel.
+ */
+struct hg_mem_copy_kernel {
+    const char *name;                                       /* Kernel name */
+    bool (*supported)(void);                                /* CPU check   */
+    void (*copy)(void *dest, const void *src, size_t n);    /* SIMD copy   */
+    void (*copy_nt)(void *dest, const void *src, size_t n); /* NT copy     */
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/**
+ * Select default copy kernel and thresholds.
+ */
+static void
+hg_mem_copy_init(void) HG_UTIL_CONSTRUCTOR;
+
+/**
+ * Always supported.
+ */
+static bool
+hg_mem_copy_supported(void);
+
+/**
+ * Plain memcpy().
+ */
+static void
+hg_mem_copy_memcpy(void *dest, const void *src, size_t n);
+
+#ifdef HG_UTIL_HAS_X86_MEM_COPY
+/**
+ * SSE2 non-temporal copy.
+ */
+static void
+hg_mem_copy_sse2_nt(void *dest, const void *src, size_t n);
+
+/**
+ * AVX2 CPU check.
+ */
+static bool
+hg_mem_copy_avx2_supported(void);
+
+/**
+ * AVX2 copy.
+ */
+static void
+hg_mem_copy_avx2(void *dest, const void *src, size_t n);
+
+/**
+ * AVX2 non-temporal copy.
+ */
+static void
+hg_mem_copy_avx2_nt(void *dest, const void *src, size_t n);
+
+/**
+ * AVX-512 CPU check.
+ */
+static bool
+hg_mem_copy_avx512_supported(void);
+
+/**
+ * AVX-512 copy.
+ */
+static void
+hg_mem_copy_avx512(void *dest, const void *src, size_t n);
+
+/**
+ * AVX-512 non-temporal copy.
+ */
+static void
+hg_mem_copy_avx512_nt(void *dest, const void *src, size_t n);
+#endif
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Copy kernels, ordered by preference (plain memcpy() must remain last) */
+static const struct hg_mem_copy_kernel hg_mem_copy_kernels_g[] = {
+#ifdef HG_UTIL_HAS_X86_MEM_COPY
+    {"avx512", hg_mem_copy_avx512_supported, hg_mem_copy_avx512,
+        hg_mem_copy_avx512_nt},
+    {"avx2", hg_mem_copy_avx2_supported, hg_mem_copy_avx2,
+        hg_mem_copy_avx2_nt},
+    {"sse2", hg_mem_copy_supported, hg_mem_copy_memcpy, hg_mem_copy_sse2_nt},
+#endif
+    {"memcpy", hg_mem_copy_supported, hg_mem_copy_memcpy, hg_mem_copy_memcpy}};
+
+#define HG_MEM_COPY_KERNEL_COUNT                                               \
+    (sizeof(hg_mem_copy_kernels_g) / sizeof(hg_mem_copy_kernels_g[0]))
+
+/* Selected copy kernel and thresholds */
+static const struct hg_mem_copy_kernel *hg_mem_copy_kernel_g =
+    &hg_mem_copy_kernels_g[HG_MEM_COPY_KERNEL_COUNT - 1];
+static size_t hg_mem_copy_vec_threshold_g = HG_MEM_PAGE_SIZE;
+static size_t hg_mem_copy_nt_threshold_g = HG_MEM_COPY_NT_THRESHOLD_DEFAULT;
 
 /*---------------------------------------------------------------------------*/
 long
@@ -282,3 +400,287 @@ hg_mem_shm_unmap(const char *name, void *mem_ptr, size_t size)
 done:
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+int
+hg_mem_prefetch(const void *mem_ptr, size_t size)
+{
+    int ret = HG_UTIL_SUCCESS;
+
+#if defined(_WIN32) || !defined(MADV_WILLNEED)
+    (void) mem_ptr;
+    (void) size;
+#else
+    size_t page_size = (size_t) hg_mem_get_page_size();
+    uintptr_t start = (uintptr_t) mem_ptr & ~(page_size - 1);
+    int rc;
+
+    if (size == 0)
+        goto done;
+
+    /* Only starts readahead, pages are not locked or mapped */
+    rc = madvise((void *) start, (size_t) ((uintptr_t) mem_ptr - start) + size,
+        MADV_WILLNEED);
+    HG_UTIL_CHECK_ERROR(rc != 0, done, ret, HG_UTIL_FAIL,
+        "madvise() failed (%s)", strerror(errno));
+#endif
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_mem_copy_init(void)
+{
+    const char *kernel_name = getenv("HG_MEM_COPY_KERNEL");
+    const char *nt_threshold = getenv("HG_MEM_COPY_NT_THRESHOLD");
+    size_t i;
+
+#if !defined(_WIN32) && defined(_SC_LEVEL2_CACHE_SIZE)
+    {
+        long l2_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (l2_size > 0)
+            hg_mem_copy_nt_threshold_g = (size_t) l2_size;
+    }
+#endif
+    if (nt_threshold != NULL)
+        hg_mem_copy_nt_threshold_g = (size_t) strtoull(nt_threshold, NULL, 0);
+
+    /* Fall back to best supported kernel if requested one is not available */
+    if (kernel_name != NULL &&
+        hg_mem_copy_set_kernel(kernel_name) == HG_UTIL_SUCCESS)
+        return;
+
+    for (i = 0; i < HG_MEM_COPY_KERNEL_COUNT; i++) {
+        if (hg_mem_copy_kernels_g[i].supported()) {
+            hg_mem_copy_kernel_g = &hg_mem_copy_kernels_g[i];
+            break;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+hg_mem_copy_supported(void)
+{
+    return true;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_mem_copy_memcpy(void *dest, const void *src, size_t n)
+{
+    memcpy(dest, src, n);
+}
+
+#ifdef HG_UTIL_HAS_X86_MEM_COPY
+/*---------------------------------------------------------------------------*/
+static HG_MEM_COPY_TARGET("sse2") void
+hg_mem_copy_sse2_nt(void *dest, const void *src, size_t n)
+{
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+    size_t head = (16 - ((uintptr_t) d & 15)) & 15;
+
+    /* Align destination for streaming stores */
+    if (head > n)
+        head = n;
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    n -= head;
+
+    for (; n >= 64; n -= 64, d += 64, s += 64) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *) s);
+        __m128i v1 = _mm_loadu_si128((const __m128i *) (s + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i *) (s + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i *) (s + 48));
+        _mm_stream_si128((__m128i *) d, v0);
+        _mm_stream_si128((__m128i *) (d + 16), v1);
+        _mm_stream_si128((__m128i *) (d + 32), v2);
+        _mm_stream_si128((__m128i *) (d + 48), v3);
+    }
+
+    /* Order streaming stores before any subsequent store/unlock */
+    _mm_sfence();
+    memcpy(d, s, n);
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+hg_mem_copy_avx2_supported(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_MEM_COPY_TARGET("avx2") void
+hg_mem_copy_avx2(void *dest, const void *src, size_t n)
+{
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+
+    for (; n >= 128; n -= 128, d += 128, s += 128) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *) s);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *) (s + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i *) (s + 64));
+        __m256i v3 = _mm256_loadu_si256((const __m256i *) (s + 96));
+        _mm256_storeu_si256((__m256i *) d, v0);
+        _mm256_storeu_si256((__m256i *) (d + 32), v1);
+        _mm256_storeu_si256((__m256i *) (d + 64), v2);
+        _mm256_storeu_si256((__m256i *) (d + 96), v3);
+    }
+    memcpy(d, s, n);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_MEM_COPY_TARGET("avx2") void
+hg_mem_copy_avx2_nt(void *dest, const void *src, size_t n)
+{
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+    size_t head = (32 - ((uintptr_t) d & 31)) & 31;
+
+    /* Align destination for streaming stores */
+    if (head > n)
+        head = n;
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    n -= head;
+
+    for (; n >= 128; n -= 128, d += 128, s += 128) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *) s);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *) (s + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i *) (s + 64));
+        __m256i v3 = _mm256_loadu_si256((const __m256i *) (s + 96));
+        _mm256_stream_si256((__m256i *) d, v0);
+        _mm256_stream_si256((__m256i *) (d + 32), v1);
+        _mm256_stream_si256((__m256i *) (d + 64), v2);
+        _mm256_stream_si256((__m256i *) (d + 96), v3);
+    }
+
+    /* Order streaming stores before any subsequent store/unlock */
+    _mm_sfence();
+    memcpy(d, s, n);
+}
+
+/*---------------------------------------------------------------------------*/
+static bool
+hg_mem_copy_avx512_supported(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_MEM_COPY_TARGET("avx512f") void
+hg_mem_copy_avx512(void *dest, const void *src, size_t n)
+{
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+
+    for (; n >= 256; n -= 256, d += 256, s += 256) {
+        __m512i v0 = _mm512_loadu_si512(s);
+        __m512i v1 = _mm512_loadu_si512(s + 64);
+        __m512i v2 = _mm512_loadu_si512(s + 128);
+        __m512i v3 = _mm512_loadu_si512(s + 192);
+        _mm512_storeu_si512(d, v0);
+        _mm512_storeu_si512(d + 64, v1);
+        _mm512_storeu_si512(d + 128, v2);
+        _mm512_storeu_si512(d + 192, v3);
+    }
+    memcpy(d, s, n);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_MEM_COPY_TARGET("avx512f") void
+hg_mem_copy_avx512_nt(void *dest, const void *src, size_t n)
+{
+    char *d = (char *) dest;
+    const char *s = (const char *) src;
+    size_t head = (64 - ((uintptr_t) d & 63)) & 63;
+
+    /* Align destination for streaming stores */
+    if (head > n)
+        head = n;
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    n -= head;
+
+    for (; n >= 256; n -= 256, d += 256, s += 256) {
+        __m512i v0 = _mm512_loadu_si512(s);
+        __m512i v1 = _mm512_loadu_si512(s + 64);
+        __m512i v2 = _mm512_loadu_si512(s + 128);
+        __m512i v3 = _mm512_loadu_si512(s + 192);
+        _mm512_stream_si512((void *) d, v0);
+        _mm512_stream_si512((void *) (d + 64), v1);
+        _mm512_stream_si512((void *) (d + 128), v2);
+        _mm512_stream_si512((void *) (d + 192), v3);
+    }
+
+    /* Order streaming stores before any subsequent store/unlock */
+    _mm_sfence();
+    memcpy(d, s, n);
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+void
+hg_mem_copy(void *dest, const void *src, size_t n)
+{
+    if (n >= hg_mem_copy_nt_threshold_g)
+        hg_mem_copy_kernel_g->copy_nt(dest, src, n);
+    else if (n >= hg_mem_copy_vec_threshold_g)
+        hg_mem_copy_kernel_g->copy(dest, src, n);
+    else
+        memcpy(dest, src, n);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_mem_copy_set_kernel(const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < HG_MEM_COPY_KERNEL_COUNT; i++) {
+        if (strcmp(hg_mem_copy_kernels_g[i].name, name) == 0) {
+            HG_UTIL_CHECK_ERROR_NORET(!hg_mem_copy_kernels_g[i].supported(),
+                error, "Copy kernel %s is not supported by CPU", name);
+            hg_mem_copy_kernel_g = &hg_mem_copy_kernels_g[i];
+            return HG_UTIL_SUCCESS;
+        }
+    }
+    HG_UTIL_LOG_ERROR("Unknown copy kernel %s", name);
+
+error:
+    return HG_UTIL_FAIL;
+}
+
+/*---------------------------------------------------------------------------*/
+const char *
+hg_mem_copy_get_kernel(void)
+{
+    return hg_mem_copy_kernel_g->name;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_mem_copy_set_thresholds(size_t vec_threshold, size_t nt_threshold)
+{
+    hg_mem_copy_vec_threshold_g = vec_threshold;
+    hg_mem_copy_nt_threshold_g = nt_threshold;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_mem_copy_get_thresholds(size_t *vec_threshold_p, size_t *nt_threshold_p)
+{
+    if (vec_threshold_p != NULL)
+        *vec_threshold_p = hg_mem_copy_vec_threshold_g;
+    if (nt_threshold_p != NULL)
+        *nt_threshold_p = hg_mem_copy_nt_threshold_g;
+}
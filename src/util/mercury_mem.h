@@ -21,6 +21,24 @@
 #define HG_MEM_CACHE_LINE_SIZE 64
 #define HG_MEM_PAGE_SIZE       4096
 
+/* Start a new cache line (structs using it must be allocated with
+ * hg_mem_aligned_alloc()) */
+#define HG_MEM_CACHE_ALIGNED(x) HG_UTIL_ALIGNED(x, HG_MEM_CACHE_LINE_SIZE)
+
+/* Contended field that only gets its own cache line when building with
+ * MERCURY_ENABLE_FIELD_PADDING, otherwise it shares the line of its group */
+#ifdef HG_UTIL_HAS_FIELD_PADDING
+#    define HG_MEM_FIELD_ALIGNED(x) HG_MEM_CACHE_ALIGNED(x)
+#else
+#    define HG_MEM_FIELD_ALIGNED(x) x
+#endif
+
+/* Fail compilation if two fields of a struct share a cache line */
+#define HG_MEM_CACHE_LINE_CHECK(type, a, b)                                    \
+    HG_UTIL_STATIC_ASSERT(offsetof(type, a) / HG_MEM_CACHE_LINE_SIZE !=        \
+                              offsetof(type, b) / HG_MEM_CACHE_LINE_SIZE,      \
+        #type ": " #a " and " #b " share a cache line")
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -139,6 +157,75 @@ hg_mem_shm_map(const char *name, size_t size, bool create);
 HG_UTIL_PUBLIC int
 hg_mem_shm_unmap(const char *name, void *mem_ptr, size_t size);
 
+/**
+ * Hint that the pages covering \size bytes at \mem_ptr will be accessed soon
+ * so that file-backed pages are read ahead. The range does not need to be
+ * page-aligned. No-op on platforms without madvise().
+ *
+ * \param mem_ptr [IN]          pointer to memory region
+ * \param size [IN]             size of the region
+ *
+ * \return non-negative on success, or negative in case of failure
+ */
+HG_UTIL_PUBLIC int
+hg_mem_prefetch(const void *mem_ptr, size_t size);
+
+/**
+ * Copy \n bytes from \src to \dest using the selected copy kernel. Copies of
+ * at least the vector threshold go through the kernel's SIMD loop, copies of
+ * at least the non-temporal threshold use streaming stores that bypass the
+ * cache, smaller copies use memcpy(). Buffers must not overlap.
+ *
+ * \param dest [OUT]            destination buffer
+ * \param src [IN]              source buffer
+ * \param n [IN]                number of bytes to copy
+ */
+HG_UTIL_PUBLIC void
+hg_mem_copy(void *dest, const void *src, size_t n);
+
+/**
+ * Select copy kernel used by hg_mem_copy(). Available kernels are "memcpy",
+ * "sse2", "avx2" and "avx512" (x86 only, subject to CPU support). By default
+ * the best kernel supported by the CPU is selected, which can be overridden
+ * with the HG_MEM_COPY_KERNEL environment variable. This call is not
+ * thread-safe and should be made before any copy is issued.
+ *
+ * \param name [IN]             kernel name
+ *
+ * \return non-negative on success, or negative if kernel is not available
+ */
+HG_UTIL_PUBLIC int
+hg_mem_copy_set_kernel(const char *name);
+
+/**
+ * Get name of copy kernel used by hg_mem_copy().
+ *
+ * \return kernel name
+ */
+HG_UTIL_PUBLIC const char *
+hg_mem_copy_get_kernel(void);
+
+/**
+ * Set size thresholds used by hg_mem_copy(). The non-temporal threshold
+ * defaults to the L2 cache size and can be overridden with the
+ * HG_MEM_COPY_NT_THRESHOLD environment variable. This call is not
+ * thread-safe and should be made before any copy is issued.
+ *
+ * \param vec_threshold [IN]    min size for SIMD copies
+ * \param nt_threshold [IN]     min size for non-temporal copies
+ */
+HG_UTIL_PUBLIC void
+hg_mem_copy_set_thresholds(size_t vec_threshold, size_t nt_threshold);
+
+/**
+ * Get size thresholds used by hg_mem_copy().
+ *
+ * \param vec_threshold_p [OUT] min size for SIMD copies
+ * \param nt_threshold_p [OUT]  min size for non-temporal copies
+ */
+HG_UTIL_PUBLIC void
+hg_mem_copy_get_thresholds(size_t *vec_threshold_p, size_t *nt_threshold_p);
+
 #ifdef __cplusplus
 }
 #endif
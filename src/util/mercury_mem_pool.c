@@ -7,16 +7,29 @@
 
 #include "mercury_mem_pool.h"
 
+#include "mercury_atomic.h"
+#include "mercury_list.h"
 #include "mercury_mem.h"
+#include "mercury_param.h"
 #include "mercury_queue.h"
+#include "mercury_thread.h"
 #include "mercury_thread_condition.h"
 #include "mercury_thread_mutex.h"
+#include "mercury_thread_pool.h"
 #include "mercury_thread_spin.h"
+#include "mercury_time.h"
 #include "mercury_util_error.h"
 
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef HG_UTIL_HAS_NUMA
+#    include <errno.h>
+#    include <linux/mempolicy.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
 /****************/
 /* Local Macros */
 /****************/
@@ -53,40 +66,114 @@ struct hg_mem_pool_block {
     HG_QUEUE_HEAD(hg_mem_pool_chunk) chunks; /* Chunk list           */
     HG_QUEUE_ENTRY(hg_mem_pool_block) entry; /* Entry in block list  */
     void *mr_handle;                         /* Pointer to MR handle */
+    size_t huge_size;                        /* Huge page alloc size */
     hg_thread_spin_t chunk_lock;             /* Chunk list lock      */
 };
 
+/**
+ * Per-thread chunk cache. Chunks are taken from / returned to the shared
+ * blocks in batches of half the cache size.
+ */
+struct hg_mem_pool_cache {
+    HG_LIST_ENTRY(hg_mem_pool_cache) entry; /* Entry in cache list */
+    unsigned int count;                     /* Cached chunks       */
+    struct hg_mem_pool_cache_entry {
+        void *mem_ptr;   /* Chunk address */
+        void *mr_handle; /* Chunk MR      */
+    } entries[];
+};
+
 /**
  * Memory pool. A pool is composed of multiple blocks.
  */
 struct hg_mem_pool {
+    HG_LIST_HEAD(hg_mem_pool_cache) caches;        /* Thread caches   */
+    struct hg_mem_pool_stats stats;                /* Pool stats      */
+    struct hg_thread_work grow_work;               /* Async grow work */
+    hg_thread_pool_t *grow_pool;                   /* Async grow      */
+    hg_atomic_int64_t free_count;                  /* Free chunks     */
+    hg_atomic_int32_t growing;                     /* Grow posted     */
     hg_thread_mutex_t extend_mutex;                /* Extend mutex    */
     hg_thread_cond_t extend_cond;                  /* Extend cond     */
     HG_QUEUE_HEAD(hg_mem_pool_block) blocks;       /* Block list      */
     hg_mem_pool_register_func_t register_func;     /* Register func   */
     hg_mem_pool_deregister_func_t deregister_func; /* Deregister func */
+    struct hg_mem_budget *budget;                  /* Memory budget   */
     unsigned long flags;                           /* Optional flags */
     void *arg;                                     /* Func args       */
     size_t chunk_size;                             /* Chunk size      */
     size_t chunk_count;                            /* Chunk count     */
+    size_t grow_watermark;                         /* Grow watermark  */
+    unsigned int cache_max;                        /* Cache size      */
+    hg_thread_key_t cache_key;                     /* Thread cache    */
     int extending;                                 /* Extending pool  */
+    int numa_node;                                 /* NUMA node       */
+    bool huge;                                     /* Use huge pages  */
     hg_thread_spin_t block_lock;                   /* Block list lock */
+    hg_thread_spin_t cache_lock;                   /* Cache list lock */
 };
 
 /********************/
 /* Local Prototypes */
 /********************/
 
+/* Size of a pool block */
+static HG_UTIL_INLINE size_t
+hg_mem_pool_block_size(struct hg_mem_pool *hg_mem_pool);
+
 /* Allocate new pool block */
 static struct hg_mem_pool_block *
-hg_mem_pool_block_alloc(size_t chunk_size, size_t chunk_count,
-    hg_mem_pool_register_func_t register_func, unsigned long flags, void *arg);
+hg_mem_pool_block_alloc(
+    struct hg_mem_pool *hg_mem_pool, double *register_time_p);
+
+/* Add new block to pool */
+static void
+hg_mem_pool_block_add(struct hg_mem_pool *hg_mem_pool,
+    struct hg_mem_pool_block *hg_mem_pool_block, double register_time,
+    bool async);
+
+#ifdef HG_UTIL_HAS_NUMA
+/* Bind memory to NUMA node */
+static void
+hg_mem_pool_numa_bind(void *mem_ptr, size_t size, int numa_node);
+#endif
+
+/* Grow pool in the background if below watermark */
+static HG_UTIL_INLINE void
+hg_mem_pool_check_watermark(struct hg_mem_pool *hg_mem_pool);
+
+/* Background grow callback */
+static HG_THREAD_RETURN_TYPE
+hg_mem_pool_grow(void *arg);
 
 /* Free pool block */
 static void
 hg_mem_pool_block_free(struct hg_mem_pool_block *hg_mem_pool_block,
     hg_mem_pool_deregister_func_t deregister_func, void *arg);
 
+/* Allocate chunk from shared blocks */
+static void *
+hg_mem_pool_alloc_shared(struct hg_mem_pool *hg_mem_pool, void **mr_handle);
+
+/* Release chunk to shared blocks, block_lock must be held */
+static int
+hg_mem_pool_free_shared(
+    struct hg_mem_pool *hg_mem_pool, void *mem_ptr, void *mr_handle);
+
+/* Get calling thread's cache */
+static struct hg_mem_pool_cache *
+hg_mem_pool_cache_get(struct hg_mem_pool *hg_mem_pool);
+
+/* Refill cache from shared blocks */
+static void
+hg_mem_pool_cache_refill(
+    struct hg_mem_pool *hg_mem_pool, struct hg_mem_pool_cache *cache);
+
+/* Release oldest half of cache to shared blocks */
+static void
+hg_mem_pool_cache_flush(
+    struct hg_mem_pool *hg_mem_pool, struct hg_mem_pool_cache *cache);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -98,13 +185,52 @@ hg_mem_pool_create(size_t chunk_size, size_t chunk_count, size_t block_count,
     hg_mem_pool_register_func_t register_func, unsigned long flags,
     hg_mem_pool_deregister_func_t deregister_func, void *arg)
 {
+    return hg_mem_pool_create_opt(chunk_size, chunk_count, block_count, false,
+        register_func, flags, deregister_func, arg);
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_mem_pool *
+hg_mem_pool_create_opt(size_t chunk_size, size_t chunk_count,
+    size_t block_count, bool huge, hg_mem_pool_register_func_t register_func,
+    unsigned long flags, hg_mem_pool_deregister_func_t deregister_func,
+    void *arg)
+{
+    struct hg_mem_pool_attr attr = HG_MEM_POOL_ATTR_INITIALIZER;
+
+    attr.huge = huge;
+
+    return hg_mem_pool_create_attr(chunk_size, chunk_count, block_count, &attr,
+        register_func, flags, deregister_func, arg);
+}
+
+/*---------------------------------------------------------------------------*/
+struct hg_mem_pool *
+hg_mem_pool_create_attr(size_t chunk_size, size_t chunk_count,
+    size_t block_count, const struct hg_mem_pool_attr *attr,
+    hg_mem_pool_register_func_t register_func, unsigned long flags,
+    hg_mem_pool_deregister_func_t deregister_func, void *arg)
+{
+    struct hg_mem_pool_attr default_attr = HG_MEM_POOL_ATTR_INITIALIZER;
     struct hg_mem_pool *hg_mem_pool = NULL;
     size_t i;
 
-    hg_mem_pool = (struct hg_mem_pool *) malloc(sizeof(struct hg_mem_pool));
+    if (attr == NULL)
+        attr = &default_attr;
+
+    hg_mem_pool = (struct hg_mem_pool *) calloc(1, sizeof(struct hg_mem_pool));
     HG_UTIL_CHECK_ERROR_NORET(
         hg_mem_pool == NULL, done, "Could not allocate memory pool");
     HG_QUEUE_INIT(&hg_mem_pool->blocks);
+    HG_LIST_INIT(&hg_mem_pool->caches);
+    hg_mem_pool->cache_max = 0;
+    hg_atomic_init64(&hg_mem_pool->free_count, 0);
+    hg_atomic_init32(&hg_mem_pool->growing, 0);
+    hg_mem_pool->numa_node = attr->numa_node;
+#ifndef HG_UTIL_HAS_NUMA
+    if (attr->numa_node >= 0)
+        HG_UTIL_LOG_WARNING("NUMA binding is not supported, ignoring");
+#endif
     hg_mem_pool->register_func = register_func;
     hg_mem_pool->deregister_func = deregister_func;
     hg_mem_pool->flags = flags;
@@ -114,15 +240,29 @@ hg_mem_pool_create(size_t chunk_size, size_t chunk_count, size_t block_count,
     hg_thread_mutex_init(&hg_mem_pool->extend_mutex);
     hg_thread_cond_init(&hg_mem_pool->extend_cond);
     hg_thread_spin_init(&hg_mem_pool->block_lock);
+    hg_thread_spin_init(&hg_mem_pool->cache_lock);
     hg_mem_pool->extending = 0;
+    hg_mem_pool->huge = attr->huge;
 
     /* Allocate single block */
     for (i = 0; i < block_count; i++) {
-        struct hg_mem_pool_block *hg_mem_pool_block = hg_mem_pool_block_alloc(
-            chunk_size, chunk_count, register_func, flags, arg);
+        double register_time;
+        struct hg_mem_pool_block *hg_mem_pool_block =
+            hg_mem_pool_block_alloc(hg_mem_pool, &register_time);
         HG_UTIL_CHECK_ERROR_NORET(hg_mem_pool_block == NULL, error,
             "Could not allocate block of %zu bytes", chunk_size * chunk_count);
-        HG_QUEUE_PUSH_TAIL(&hg_mem_pool->blocks, hg_mem_pool_block, entry);
+        hg_mem_pool_block_add(
+            hg_mem_pool, hg_mem_pool_block, register_time, false);
+    }
+
+    /* Single background thread used to grow the pool */
+    if (attr->grow_watermark > 0) {
+        int rc = hg_thread_pool_init(1, &hg_mem_pool->grow_pool);
+        HG_UTIL_CHECK_ERROR_NORET(
+            rc != HG_UTIL_SUCCESS, error, "Could not create grow thread");
+        hg_mem_pool->grow_work.func = hg_mem_pool_grow;
+        hg_mem_pool->grow_work.args = hg_mem_pool;
+        hg_mem_pool->grow_watermark = attr->grow_watermark;
     }
 
 done:
@@ -140,45 +280,191 @@ hg_mem_pool_destroy(struct hg_mem_pool *hg_mem_pool)
     if (!hg_mem_pool)
         return;
 
+    /* Wait for background growth to complete */
+    if (hg_mem_pool->grow_pool != NULL)
+        (void) hg_thread_pool_destroy(hg_mem_pool->grow_pool);
+
+    /* Cached chunks belong to the blocks that are released below */
+    if (hg_mem_pool->cache_max > 0) {
+        while (!HG_LIST_IS_EMPTY(&hg_mem_pool->caches)) {
+            struct hg_mem_pool_cache *cache =
+                HG_LIST_FIRST(&hg_mem_pool->caches);
+            HG_LIST_REMOVE(cache, entry);
+            free(cache);
+        }
+        (void) hg_thread_key_delete(hg_mem_pool->cache_key);
+    }
+
     while (!HG_QUEUE_IS_EMPTY(&hg_mem_pool->blocks)) {
         struct hg_mem_pool_block *hg_mem_pool_block =
             HG_QUEUE_FIRST(&hg_mem_pool->blocks);
         HG_QUEUE_POP_HEAD(&hg_mem_pool->blocks, entry);
         hg_mem_pool_block_free(
             hg_mem_pool_block, hg_mem_pool->deregister_func, hg_mem_pool->arg);
+        hg_mem_budget_release(
+            hg_mem_pool->budget, hg_mem_pool_block_size(hg_mem_pool));
     }
     hg_thread_mutex_destroy(&hg_mem_pool->extend_mutex);
     hg_thread_cond_destroy(&hg_mem_pool->extend_cond);
     hg_thread_spin_destroy(&hg_mem_pool->block_lock);
+    hg_thread_spin_destroy(&hg_mem_pool->cache_lock);
     free(hg_mem_pool);
 }
 
+/*---------------------------------------------------------------------------*/
+int
+hg_mem_pool_set_thread_cache(
+    struct hg_mem_pool *hg_mem_pool, unsigned int cache_count)
+{
+    int ret = HG_UTIL_SUCCESS;
+
+    HG_UTIL_CHECK_ERROR(hg_mem_pool->cache_max > 0, done, ret, HG_UTIL_FAIL,
+        "Thread cache is already enabled");
+
+    if (cache_count < 2)
+        goto done;
+
+    ret = hg_thread_key_create(&hg_mem_pool->cache_key);
+    HG_UTIL_CHECK_ERROR_NORET(
+        ret != HG_UTIL_SUCCESS, done, "Could not create thread cache key");
+    hg_mem_pool->cache_max = cache_count;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_mem_budget_init(struct hg_mem_budget *budget, size_t max)
+{
+    hg_atomic_init64(&budget->used, 0);
+    budget->max = max;
+}
+
+/*---------------------------------------------------------------------------*/
+bool
+hg_mem_budget_acquire(struct hg_mem_budget *budget, size_t size)
+{
+    int64_t used;
+
+    if (budget == NULL || budget->max == 0)
+        return true;
+
+    do {
+        used = hg_atomic_get64(&budget->used);
+        if ((size_t) used + size > budget->max)
+            return false;
+    } while (!hg_atomic_cas64(&budget->used, used, used + (int64_t) size));
+
+    return true;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_mem_budget_release(struct hg_mem_budget *budget, size_t size)
+{
+    if (budget == NULL || budget->max == 0)
+        return;
+
+    (void) hg_atomic_add64(&budget->used, -(int64_t) size);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_mem_pool_set_budget(
+    struct hg_mem_pool *hg_mem_pool, struct hg_mem_budget *budget)
+{
+    size_t size;
+    int ret = HG_UTIL_SUCCESS;
+
+    HG_UTIL_CHECK_ERROR(hg_mem_pool->budget != NULL, done, ret, HG_UTIL_FAIL,
+        "Budget is already set");
+
+    hg_thread_spin_lock(&hg_mem_pool->block_lock);
+    size = hg_mem_pool->stats.block_count * hg_mem_pool_block_size(hg_mem_pool);
+    hg_thread_spin_unlock(&hg_mem_pool->block_lock);
+
+    HG_UTIL_CHECK_ERROR(!hg_mem_budget_acquire(budget, size), done, ret,
+        HG_UTIL_FAIL, "Budget is too small for initial blocks (%zu bytes)",
+        size);
+    hg_mem_pool->budget = budget;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE size_t
+hg_mem_pool_block_size(struct hg_mem_pool *hg_mem_pool)
+{
+    /* Size of block struct + number of chunks x (chunk_size + size of entry) */
+    return sizeof(struct hg_mem_pool_block) +
+           hg_mem_pool->chunk_count *
+               (offsetof(struct hg_mem_pool_chunk, chunk) +
+                   hg_mem_pool->chunk_size);
+}
+
 /*---------------------------------------------------------------------------*/
 static struct hg_mem_pool_block *
-hg_mem_pool_block_alloc(size_t chunk_size, size_t chunk_count,
-    hg_mem_pool_register_func_t register_func, unsigned long flags, void *arg)
+hg_mem_pool_block_alloc(
+    struct hg_mem_pool *hg_mem_pool, double *register_time_p)
 {
+    size_t chunk_size = hg_mem_pool->chunk_size;
+    size_t chunk_count = hg_mem_pool->chunk_count;
+    hg_mem_pool_register_func_t register_func = hg_mem_pool->register_func;
     struct hg_mem_pool_block *hg_mem_pool_block = NULL;
     size_t page_size = (size_t) hg_mem_get_page_size();
     void *mem_ptr = NULL, *mr_handle = NULL;
     size_t block_size, i;
     size_t block_header = sizeof(struct hg_mem_pool_block);
     size_t chunk_header = offsetof(struct hg_mem_pool_chunk, chunk);
+    size_t huge_size = 0;
 
     /* Size of block struct + number of chunks x (chunk_size + size of entry) */
     block_size = block_header + chunk_count * (chunk_header + chunk_size);
 
-    /* Allocate backend buffer */
-    mem_ptr = hg_mem_aligned_alloc(page_size, block_size);
-    HG_UTIL_CHECK_ERROR_NORET(
-        mem_ptr == NULL, done, "Could not allocate %zu bytes", block_size);
+    /* Allocate backend buffer, fall back to regular pages if no huge pages
+     * are available */
+    if (hg_mem_pool->huge) {
+        size_t huge_page_size = (size_t) hg_mem_get_hugepage_size();
+
+        if (huge_page_size > 0) {
+            huge_size = (block_size + huge_page_size - 1) / huge_page_size *
+                        huge_page_size;
+            mem_ptr = hg_mem_huge_alloc(huge_size);
+        }
+        if (mem_ptr == NULL)
+            huge_size = 0;
+    }
+    if (mem_ptr == NULL) {
+        mem_ptr = hg_mem_aligned_alloc(page_size, block_size);
+        HG_UTIL_CHECK_ERROR_NORET(
+            mem_ptr == NULL, done, "Could not allocate %zu bytes", block_size);
+    }
+#ifdef HG_UTIL_HAS_NUMA
+    /* Bind before pages are first touched */
+    if (hg_mem_pool->numa_node >= 0)
+        hg_mem_pool_numa_bind(mem_ptr, (huge_size > 0) ? huge_size : block_size,
+            hg_mem_pool->numa_node);
+#endif
     memset(mem_ptr, 0, block_size);
 
     /* Register memory if registration function is provided */
+    *register_time_p = 0;
     if (register_func) {
-        int rc = register_func(mem_ptr, block_size, flags, &mr_handle, arg);
+        hg_time_t t1, t2;
+        int rc;
+
+        hg_time_get_current(&t1);
+        rc = register_func(mem_ptr, block_size, hg_mem_pool->flags, &mr_handle,
+            hg_mem_pool->arg);
+        hg_time_get_current(&t2);
+        *register_time_p = hg_time_to_double(hg_time_subtract(t2, t1));
         if (unlikely(rc != HG_UTIL_SUCCESS)) {
-            hg_mem_aligned_free(mem_ptr);
+            if (huge_size > 0)
+                (void) hg_mem_huge_free(mem_ptr, huge_size);
+            else
+                hg_mem_aligned_free(mem_ptr);
             HG_UTIL_GOTO_ERROR(done, mem_ptr, NULL, "register_func() failed");
         }
     }
@@ -189,6 +475,7 @@ hg_mem_pool_block_alloc(size_t chunk_size, size_t chunk_count,
     HG_QUEUE_INIT(&hg_mem_pool_block->chunks);
     hg_thread_spin_init(&hg_mem_pool_block->chunk_lock);
     hg_mem_pool_block->mr_handle = mr_handle;
+    hg_mem_pool_block->huge_size = huge_size;
 
     /* Assign chunks and insert them to free list */
     for (i = 0; i < chunk_count; i++) {
@@ -204,6 +491,113 @@ done:
     return hg_mem_pool_block;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_mem_pool_block_add(struct hg_mem_pool *hg_mem_pool,
+    struct hg_mem_pool_block *hg_mem_pool_block, double register_time,
+    bool async)
+{
+    struct hg_mem_pool_stats *stats = &hg_mem_pool->stats;
+
+    hg_thread_spin_lock(&hg_mem_pool->block_lock);
+    HG_QUEUE_PUSH_TAIL(&hg_mem_pool->blocks, hg_mem_pool_block, entry);
+    stats->block_count++;
+    if (async)
+        stats->async_grow_count++;
+    stats->register_time += register_time;
+    if (register_time > stats->register_time_max)
+        stats->register_time_max = register_time;
+    hg_thread_spin_unlock(&hg_mem_pool->block_lock);
+
+    hg_atomic_add64(
+        &hg_mem_pool->free_count, (int64_t) hg_mem_pool->chunk_count);
+}
+
+#ifdef HG_UTIL_HAS_NUMA
+/*---------------------------------------------------------------------------*/
+static void
+hg_mem_pool_numa_bind(void *mem_ptr, size_t size, int numa_node)
+{
+    unsigned long nodemask;
+
+    if ((size_t) numa_node >= sizeof(nodemask) * 8) {
+        HG_UTIL_LOG_WARNING("NUMA node %d is out of range", numa_node);
+        return;
+    }
+    nodemask = 1UL << numa_node;
+
+    /* Best effort, fall back to other nodes if memory is exhausted */
+    if (syscall(SYS_mbind, mem_ptr, size, MPOL_PREFERRED, &nodemask,
+            sizeof(nodemask) * 8, 0) != 0)
+        HG_UTIL_LOG_WARNING(
+            "Could not bind block to NUMA node %d (%s)", numa_node,
+            strerror(errno));
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_mem_pool_check_watermark(struct hg_mem_pool *hg_mem_pool)
+{
+    if (hg_mem_pool->grow_watermark == 0 ||
+        hg_atomic_get64(&hg_mem_pool->free_count) >=
+            (int64_t) hg_mem_pool->grow_watermark)
+        return;
+
+    /* Only one growth may be pending at a time */
+    if (!hg_atomic_cas32(&hg_mem_pool->growing, 0, 1))
+        return;
+    if (hg_thread_pool_post(hg_mem_pool->grow_pool, &hg_mem_pool->grow_work) !=
+        HG_UTIL_SUCCESS)
+        hg_atomic_set32(&hg_mem_pool->growing, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_mem_pool_grow(void *arg)
+{
+    struct hg_mem_pool *hg_mem_pool = (struct hg_mem_pool *) arg;
+    struct hg_mem_pool_block *hg_mem_pool_block;
+    double register_time;
+
+    /* Pool may already be extended by an allocating thread */
+    hg_thread_mutex_lock(&hg_mem_pool->extend_mutex);
+    if (hg_mem_pool->extending ||
+        hg_atomic_get64(&hg_mem_pool->free_count) >=
+            (int64_t) hg_mem_pool->grow_watermark) {
+        hg_thread_mutex_unlock(&hg_mem_pool->extend_mutex);
+        goto done;
+    }
+    hg_mem_pool->extending = 1;
+    hg_thread_mutex_unlock(&hg_mem_pool->extend_mutex);
+
+    /* Growing ahead of time is best effort, leave the budget to others */
+    if (hg_mem_budget_acquire(
+            hg_mem_pool->budget, hg_mem_pool_block_size(hg_mem_pool))) {
+        hg_mem_pool_block =
+            hg_mem_pool_block_alloc(hg_mem_pool, &register_time);
+        if (hg_mem_pool_block != NULL)
+            hg_mem_pool_block_add(
+                hg_mem_pool, hg_mem_pool_block, register_time, true);
+        else {
+            hg_mem_budget_release(
+                hg_mem_pool->budget, hg_mem_pool_block_size(hg_mem_pool));
+            HG_UTIL_LOG_ERROR("Could not allocate block of %zu bytes",
+                hg_mem_pool->chunk_size * hg_mem_pool->chunk_count);
+        }
+    }
+
+    hg_thread_mutex_lock(&hg_mem_pool->extend_mutex);
+    hg_mem_pool->extending = 0;
+    hg_thread_cond_broadcast(&hg_mem_pool->extend_cond);
+    hg_thread_mutex_unlock(&hg_mem_pool->extend_mutex);
+
+done:
+    hg_atomic_set32(&hg_mem_pool->growing, 0);
+
+    return (HG_THREAD_RETURN_TYPE) 0;
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_mem_pool_block_free(struct hg_mem_pool_block *hg_mem_pool_block,
@@ -221,7 +615,11 @@ hg_mem_pool_block_free(struct hg_mem_pool_block *hg_mem_pool_block,
 
 done:
     hg_thread_spin_destroy(&hg_mem_pool_block->chunk_lock);
-    hg_mem_aligned_free((void *) hg_mem_pool_block);
+    if (hg_mem_pool_block->huge_size > 0)
+        (void) hg_mem_huge_free(
+            (void *) hg_mem_pool_block, hg_mem_pool_block->huge_size);
+    else
+        hg_mem_aligned_free((void *) hg_mem_pool_block);
     return;
 }
 
@@ -230,8 +628,6 @@ void *
 hg_mem_pool_alloc(
     struct hg_mem_pool *hg_mem_pool, size_t size, void **mr_handle)
 {
-    struct hg_mem_pool_block *hg_mem_pool_block;
-    struct hg_mem_pool_chunk *hg_mem_pool_chunk = NULL;
     void *mem_ptr = NULL;
 
     HG_UTIL_CHECK_ERROR(size > hg_mem_pool->chunk_size, done, mem_ptr, NULL,
@@ -239,6 +635,38 @@ hg_mem_pool_alloc(
     HG_UTIL_CHECK_ERROR(!mr_handle && hg_mem_pool->register_func, done, mem_ptr,
         NULL, "MR handle is NULL");
 
+    if (hg_mem_pool->cache_max > 0) {
+        struct hg_mem_pool_cache *cache = hg_mem_pool_cache_get(hg_mem_pool);
+
+        if (cache != NULL) {
+            if (cache->count == 0)
+                hg_mem_pool_cache_refill(hg_mem_pool, cache);
+            if (cache->count > 0) {
+                cache->count--;
+                mem_ptr = cache->entries[cache->count].mem_ptr;
+                if (mr_handle)
+                    *mr_handle = cache->entries[cache->count].mr_handle;
+                goto done;
+            }
+        }
+    }
+
+    /* Pick chunk from shared blocks, extend pool if needed */
+    mem_ptr = hg_mem_pool_alloc_shared(hg_mem_pool, mr_handle);
+
+done:
+    return mem_ptr;
+}
+
+/*---------------------------------------------------------------------------*/
+static void *
+hg_mem_pool_alloc_shared(struct hg_mem_pool *hg_mem_pool, void **mr_handle)
+{
+    struct hg_mem_pool_block *hg_mem_pool_block;
+    struct hg_mem_pool_chunk *hg_mem_pool_chunk = NULL;
+    double register_time;
+    void *mem_ptr = NULL;
+
     do {
         int found = 0;
 
@@ -266,16 +694,22 @@ hg_mem_pool_alloc(
             hg_mem_pool->extending = 1;
             hg_thread_mutex_unlock(&hg_mem_pool->extend_mutex);
 
-            hg_mem_pool_block = hg_mem_pool_block_alloc(hg_mem_pool->chunk_size,
-                hg_mem_pool->chunk_count, hg_mem_pool->register_func,
-                hg_mem_pool->flags, hg_mem_pool->arg);
-            HG_UTIL_CHECK_ERROR(hg_mem_pool_block == NULL, done, mem_ptr, NULL,
-                "Could not allocate block of %zu bytes",
-                hg_mem_pool->chunk_size * hg_mem_pool->chunk_count);
+            /* Fail fast once the budget is exhausted */
+            if (!hg_mem_budget_acquire(hg_mem_pool->budget,
+                    hg_mem_pool_block_size(hg_mem_pool)))
+                goto unextend;
+            hg_mem_pool_block =
+                hg_mem_pool_block_alloc(hg_mem_pool, &register_time);
+            if (hg_mem_pool_block == NULL) {
+                hg_mem_budget_release(
+                    hg_mem_pool->budget, hg_mem_pool_block_size(hg_mem_pool));
+                HG_UTIL_LOG_ERROR("Could not allocate block of %zu bytes",
+                    hg_mem_pool->chunk_size * hg_mem_pool->chunk_count);
+                goto unextend;
+            }
 
-            hg_thread_spin_lock(&hg_mem_pool->block_lock);
-            HG_QUEUE_PUSH_TAIL(&hg_mem_pool->blocks, hg_mem_pool_block, entry);
-            hg_thread_spin_unlock(&hg_mem_pool->block_lock);
+            hg_mem_pool_block_add(
+                hg_mem_pool, hg_mem_pool_block, register_time, false);
 
             hg_thread_mutex_lock(&hg_mem_pool->extend_mutex);
             hg_mem_pool->extending = 0;
@@ -292,12 +726,22 @@ hg_mem_pool_alloc(
         hg_thread_spin_unlock(&hg_mem_pool_block->chunk_lock);
     } while (!hg_mem_pool_chunk);
 
+    hg_atomic_decr64(&hg_mem_pool->free_count);
+    hg_mem_pool_check_watermark(hg_mem_pool);
+
     mem_ptr = &hg_mem_pool_chunk->chunk;
     if (mr_handle && hg_mem_pool_block)
         *mr_handle = hg_mem_pool_block->mr_handle;
 
-done:
     return mem_ptr;
+
+unextend:
+    hg_thread_mutex_lock(&hg_mem_pool->extend_mutex);
+    hg_mem_pool->extending = 0;
+    hg_thread_cond_broadcast(&hg_mem_pool->extend_cond);
+    hg_thread_mutex_unlock(&hg_mem_pool->extend_mutex);
+
+    return NULL;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -305,14 +749,40 @@ void
 hg_mem_pool_free(
     struct hg_mem_pool *hg_mem_pool, void *mem_ptr, void *mr_handle)
 {
-    struct hg_mem_pool_block *hg_mem_pool_block;
-    int found = 0;
+    int found;
 
     if (!mem_ptr)
         return;
 
+    if (hg_mem_pool->cache_max > 0) {
+        struct hg_mem_pool_cache *cache = hg_mem_pool_cache_get(hg_mem_pool);
+
+        if (cache != NULL) {
+            if (cache->count == hg_mem_pool->cache_max)
+                hg_mem_pool_cache_flush(hg_mem_pool, cache);
+            cache->entries[cache->count].mem_ptr = mem_ptr;
+            cache->entries[cache->count].mr_handle = mr_handle;
+            cache->count++;
+            return;
+        }
+    }
+
     /* Put the node back to the pool */
     hg_thread_spin_lock(&hg_mem_pool->block_lock);
+    found = hg_mem_pool_free_shared(hg_mem_pool, mem_ptr, mr_handle);
+    hg_thread_spin_unlock(&hg_mem_pool->block_lock);
+
+    HG_UTIL_CHECK_WARNING(found != 1, "Memory block was not found");
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_mem_pool_free_shared(
+    struct hg_mem_pool *hg_mem_pool, void *mem_ptr, void *mr_handle)
+{
+    struct hg_mem_pool_block *hg_mem_pool_block;
+    int found = 0;
+
     HG_QUEUE_FOREACH (hg_mem_pool_block, &hg_mem_pool->blocks, entry) {
         /* If MR handle is NULL, it does not really matter which pool we push
          * the node back to.
@@ -324,12 +794,101 @@ hg_mem_pool_free(
             HG_QUEUE_PUSH_TAIL(
                 &hg_mem_pool_block->chunks, hg_mem_pool_chunk, entry);
             hg_thread_spin_unlock(&hg_mem_pool_block->chunk_lock);
+            hg_atomic_incr64(&hg_mem_pool->free_count);
             found = 1;
             break;
         }
     }
+
+    return found;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_mem_pool_cache *
+hg_mem_pool_cache_get(struct hg_mem_pool *hg_mem_pool)
+{
+    struct hg_mem_pool_cache *cache;
+    int rc;
+
+    cache = (struct hg_mem_pool_cache *) hg_thread_getspecific(
+        hg_mem_pool->cache_key);
+    if (likely(cache != NULL))
+        return cache;
+
+    /* First use from this thread, caches are only released with the pool */
+    cache = (struct hg_mem_pool_cache *) malloc(
+        sizeof(struct hg_mem_pool_cache) +
+        hg_mem_pool->cache_max * sizeof(struct hg_mem_pool_cache_entry));
+    HG_UTIL_CHECK_ERROR_NORET(
+        cache == NULL, error, "Could not allocate thread cache");
+    cache->count = 0;
+
+    rc = hg_thread_setspecific(hg_mem_pool->cache_key, cache);
+    HG_UTIL_CHECK_ERROR_NORET(
+        rc != HG_UTIL_SUCCESS, error, "Could not set thread cache");
+
+    hg_thread_spin_lock(&hg_mem_pool->cache_lock);
+    HG_LIST_INSERT_HEAD(&hg_mem_pool->caches, cache, entry);
+    hg_thread_spin_unlock(&hg_mem_pool->cache_lock);
+
+    return cache;
+
+error:
+    free(cache);
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_mem_pool_cache_refill(
+    struct hg_mem_pool *hg_mem_pool, struct hg_mem_pool_cache *cache)
+{
+    struct hg_mem_pool_block *hg_mem_pool_block;
+    unsigned int refill_count = hg_mem_pool->cache_max / 2;
+
+    hg_thread_spin_lock(&hg_mem_pool->block_lock);
+    HG_QUEUE_FOREACH (hg_mem_pool_block, &hg_mem_pool->blocks, entry) {
+        hg_thread_spin_lock(&hg_mem_pool_block->chunk_lock);
+        while (cache->count < refill_count &&
+               !HG_QUEUE_IS_EMPTY(&hg_mem_pool_block->chunks)) {
+            struct hg_mem_pool_chunk *hg_mem_pool_chunk =
+                HG_QUEUE_FIRST(&hg_mem_pool_block->chunks);
+            HG_QUEUE_POP_HEAD(&hg_mem_pool_block->chunks, entry);
+            cache->entries[cache->count].mem_ptr = &hg_mem_pool_chunk->chunk;
+            cache->entries[cache->count].mr_handle =
+                hg_mem_pool_block->mr_handle;
+            cache->count++;
+        }
+        hg_thread_spin_unlock(&hg_mem_pool_block->chunk_lock);
+        if (cache->count == refill_count)
+            break;
+    }
+    hg_thread_spin_unlock(&hg_mem_pool->block_lock);
+
+    hg_atomic_add64(&hg_mem_pool->free_count, -(int64_t) cache->count);
+    hg_mem_pool_check_watermark(hg_mem_pool);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_mem_pool_cache_flush(
+    struct hg_mem_pool *hg_mem_pool, struct hg_mem_pool_cache *cache)
+{
+    unsigned int flush_count = cache->count / 2, i;
+    int found = 1;
+
+    hg_thread_spin_lock(&hg_mem_pool->block_lock);
+    for (i = 0; i < flush_count; i++)
+        found &= hg_mem_pool_free_shared(hg_mem_pool,
+            cache->entries[i].mem_ptr, cache->entries[i].mr_handle);
     hg_thread_spin_unlock(&hg_mem_pool->block_lock);
 
+    /* Keep most recently freed chunks */
+    cache->count -= flush_count;
+    memmove(cache->entries, &cache->entries[flush_count],
+        cache->count * sizeof(struct hg_mem_pool_cache_entry));
+
     HG_UTIL_CHECK_WARNING(found != 1, "Memory block was not found");
 }
 
@@ -348,3 +907,16 @@ hg_mem_pool_chunk_offset(
 
     return (size_t) ((char *) mem_ptr - (char *) hg_mem_pool_block);
 }
+
+/*---------------------------------------------------------------------------*/
+void
+hg_mem_pool_get_stats(
+    struct hg_mem_pool *hg_mem_pool, struct hg_mem_pool_stats *stats)
+{
+    hg_thread_spin_lock(&hg_mem_pool->block_lock);
+    *stats = hg_mem_pool->stats;
+    hg_thread_spin_unlock(&hg_mem_pool->block_lock);
+
+    stats->free_count =
+        (size_t) MAX(hg_atomic_get64(&hg_mem_pool->free_count), 0);
+}
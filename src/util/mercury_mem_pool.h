@@ -10,10 +10,45 @@
 
 #include "mercury_util_config.h"
 
+#include "mercury_atomic.h"
+
+#include <stdbool.h>
+
 /*************************************/
 /* Public Type and Struct Definition */
 /*************************************/
 
+/**
+ * Memory pool attributes.
+ */
+struct hg_mem_pool_attr {
+    int numa_node;         /* NUMA node blocks are bound to (-1 for none) */
+    size_t grow_watermark; /* Grow in background below that many free
+                              chunks (0 to disable) */
+    bool huge;             /* Use huge pages */
+};
+
+/**
+ * Memory pool statistics.
+ */
+struct hg_mem_pool_stats {
+    size_t block_count;       /* Number of blocks                 */
+    size_t free_count;        /* Free chunks (excl. thread cache) */
+    size_t async_grow_count;  /* Blocks added in background       */
+    double register_time;     /* Total registration time (s)      */
+    double register_time_max; /* Max block registration time (s)  */
+};
+
+/**
+ * Memory budget. A budget can be shared by several pools (and by other users
+ * through hg_mem_budget_acquire()) to bound the total amount of memory they
+ * allocate.
+ */
+struct hg_mem_budget {
+    hg_atomic_int64_t used; /* Bytes in use             */
+    size_t max;             /* Max bytes (0: unlimited) */
+};
+
 /**
  * Register memory block.
  *
@@ -42,6 +77,13 @@ typedef int (*hg_mem_pool_deregister_func_t)(void *handle, void *arg);
 /* Public Macros */
 /*****************/
 
+/* Default memory pool attributes */
+#define HG_MEM_POOL_ATTR_INITIALIZER                                           \
+    (struct hg_mem_pool_attr)                                                  \
+    {                                                                          \
+        .numa_node = -1, .grow_watermark = 0, .huge = false                    \
+    }
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -70,6 +112,54 @@ hg_mem_pool_create(size_t chunk_size, size_t chunk_count, size_t block_count,
     hg_mem_pool_register_func_t register_func, unsigned long flags,
     hg_mem_pool_deregister_func_t deregister_func, void *arg);
 
+/**
+ * Same as hg_mem_pool_create() but blocks are backed by huge pages when
+ * \huge is true. Blocks are allocated from regular pages if huge pages cannot
+ * be allocated.
+ *
+ * \param chunk_size [IN]       size of chunks
+ * \param chunk_count [IN]      number of chunks
+ * \param block_count [IN]      number of blocks
+ * \param huge [IN]             use huge pages
+ * \param register_func [IN]    pointer to register function
+ * \param flags [IN]            optional flags passed to register_func
+ * \param deregister_func [IN]  pointer to deregister function
+ * \param arg [IN/OUT]          optional arguments passed to register functions
+ *
+ * \return HG_UTIL_SUCCESS if successful / error code otherwise
+ */
+HG_UTIL_PUBLIC struct hg_mem_pool *
+hg_mem_pool_create_opt(size_t chunk_size, size_t chunk_count,
+    size_t block_count, bool huge, hg_mem_pool_register_func_t register_func,
+    unsigned long flags, hg_mem_pool_deregister_func_t deregister_func,
+    void *arg);
+
+/**
+ * Same as hg_mem_pool_create_opt() but takes a set of attributes \attr.
+ * When attr->numa_node is set, block memory is bound to that NUMA node
+ * before it is touched and registered (best effort). When
+ * attr->grow_watermark is set, a new block is allocated and registered in
+ * the background as soon as the number of free chunks drops below that
+ * watermark, so that registration does not take place on the allocation
+ * path.
+ *
+ * \param chunk_size [IN]       size of chunks
+ * \param chunk_count [IN]      number of chunks
+ * \param block_count [IN]      number of blocks
+ * \param attr [IN]             pointer to pool attributes (NULL for default)
+ * \param register_func [IN]    pointer to register function
+ * \param flags [IN]            optional flags passed to register_func
+ * \param deregister_func [IN]  pointer to deregister function
+ * \param arg [IN/OUT]          optional arguments passed to register functions
+ *
+ * \return HG_UTIL_SUCCESS if successful / error code otherwise
+ */
+HG_UTIL_PUBLIC struct hg_mem_pool *
+hg_mem_pool_create_attr(size_t chunk_size, size_t chunk_count,
+    size_t block_count, const struct hg_mem_pool_attr *attr,
+    hg_mem_pool_register_func_t register_func, unsigned long flags,
+    hg_mem_pool_deregister_func_t deregister_func, void *arg);
+
 /**
  * Destroy a memory pool.
  *
@@ -79,6 +169,66 @@ hg_mem_pool_create(size_t chunk_size, size_t chunk_count, size_t block_count,
 HG_UTIL_PUBLIC void
 hg_mem_pool_destroy(struct hg_mem_pool *hg_mem_pool);
 
+/**
+ * Enable per-thread caches of up to \cache_count chunks in front of the
+ * shared blocks. Threads then allocate and release chunks without locking
+ * and exchange chunks with the shared blocks in batches of \cache_count / 2.
+ * Chunks cached by a thread are only returned to the pool when the cache
+ * overflows or when the pool is destroyed. Must be called before the pool
+ * is used, a \cache_count lower than 2 leaves caching disabled.
+ *
+ * \param hg_mem_pool [IN/OUT]  pointer to memory pool
+ * \param cache_count [IN]      maximum number of chunks cached per thread
+ *
+ * \return HG_UTIL_SUCCESS if successful / error code otherwise
+ */
+HG_UTIL_PUBLIC int
+hg_mem_pool_set_thread_cache(
+    struct hg_mem_pool *hg_mem_pool, unsigned int cache_count);
+
+/**
+ * Initialize a memory budget of \max bytes (0 for unlimited).
+ *
+ * \param budget [OUT]          pointer to budget
+ * \param max [IN]              max number of bytes
+ */
+HG_UTIL_PUBLIC void
+hg_mem_budget_init(struct hg_mem_budget *budget, size_t max);
+
+/**
+ * Take \size bytes out of \budget. A NULL \budget is unlimited.
+ *
+ * \param budget [IN/OUT]       pointer to budget
+ * \param size [IN]             number of bytes
+ *
+ * \return true if \size bytes were taken, false if the budget is exhausted
+ */
+HG_UTIL_PUBLIC bool
+hg_mem_budget_acquire(struct hg_mem_budget *budget, size_t size);
+
+/**
+ * Return \size bytes previously taken to \budget.
+ *
+ * \param budget [IN/OUT]       pointer to budget
+ * \param size [IN]             number of bytes
+ */
+HG_UTIL_PUBLIC void
+hg_mem_budget_release(struct hg_mem_budget *budget, size_t size);
+
+/**
+ * Charge the blocks of \hg_mem_pool to \budget. New blocks are then only
+ * allocated while the budget allows it, allocations fail (and return NULL)
+ * once it is exhausted. Must be called before the pool is used.
+ *
+ * \param hg_mem_pool [IN/OUT]  pointer to memory pool
+ * \param budget [IN/OUT]       pointer to budget
+ *
+ * \return HG_UTIL_SUCCESS if successful / error code otherwise
+ */
+HG_UTIL_PUBLIC int
+hg_mem_pool_set_budget(
+    struct hg_mem_pool *hg_mem_pool, struct hg_mem_budget *budget);
+
 /**
  * Allocate \size bytes and optionally return a memory handle
  * \mr_handle if registration functions were provided.
@@ -119,6 +269,16 @@ HG_UTIL_PUBLIC size_t
 hg_mem_pool_chunk_offset(
     struct hg_mem_pool *hg_mem_pool, void *mem_ptr, void *mr_handle);
 
+/**
+ * Retrieve memory pool statistics.
+ *
+ * \param hg_mem_pool [IN/OUT]  pointer to memory pool
+ * \param stats [OUT]           pointer to statistics
+ */
+HG_UTIL_PUBLIC void
+hg_mem_pool_get_stats(
+    struct hg_mem_pool *hg_mem_pool, struct hg_mem_pool_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
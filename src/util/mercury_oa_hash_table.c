@@ -0,0 +1,470 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_oa_hash_table.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Initial table size (log2) */
+#define HG_OA_HASH_TABLE_MIN_BITS (4)
+
+/* Enlarge table when more than half full, counting entries not yet moved,
+ * higher loads increase probe lengths and mispredictions on lookups */
+#define HG_OA_HASH_TABLE_FULL(hash_table)                                      \
+    (((size_t) (hash_table)->cur.entries + (hash_table)->old.entries + 1) *    \
+            2 >                                                                \
+        (size_t) (hash_table)->cur.mask + 1)
+
+/* Number of old slots visited on each insertion / removal while enlarging */
+#define HG_OA_HASH_TABLE_MIGRATE_STEPS (8)
+
+/* Fibonacci hashing, spreads poor hashes over the upper bits */
+#define HG_OA_HASH_TABLE_GOLDEN (2654435769U)
+
+/************************************/
+/* Local Type and Struct Definition */
+/************************************/
+
+/* Slot, dist is the distance to the home slot plus one or 0 when empty */
+struct hg_oa_hash_table_slot {
+    hg_hash_table_key_t key;
+    hg_hash_table_value_t value;
+    uint32_t hash;
+    uint32_t dist;
+};
+
+/* Array of slots */
+struct hg_oa_hash_table_array {
+    struct hg_oa_hash_table_slot *slots;
+    unsigned int mask;    /* Number of slots - 1 */
+    unsigned int shift;   /* 32 - log2(number of slots) */
+    unsigned int entries; /* Number of used slots */
+};
+
+/* Hash table, entries of old are moved to cur while the table is enlarged */
+struct hg_oa_hash_table {
+    struct hg_oa_hash_table_array cur;
+    struct hg_oa_hash_table_array old;
+    unsigned int migrate_idx; /* Next old slot to move */
+    hg_hash_table_hash_func_t hash_func;
+    hg_hash_table_equal_func_t equal_func;
+    hg_hash_table_key_free_func_t key_free_func;
+    hg_hash_table_value_free_func_t value_free_func;
+};
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+/* Allocate array of 2^bits slots */
+static int
+hg_oa_hash_table_array_alloc(
+    struct hg_oa_hash_table_array *array, unsigned int bits);
+
+/* Find slot holding key */
+static struct hg_oa_hash_table_slot *
+hg_oa_hash_table_array_find(const hg_oa_hash_table_t *hash_table,
+    const struct hg_oa_hash_table_array *array, hg_hash_table_key_t key,
+    uint32_t hash);
+
+/* Place new entry, array must have a free slot */
+static void
+hg_oa_hash_table_array_place(struct hg_oa_hash_table_array *array,
+    hg_hash_table_key_t key, hg_hash_table_value_t value, uint32_t hash);
+
+/* Erase slot, shifting following entries back */
+static void
+hg_oa_hash_table_array_erase(struct hg_oa_hash_table_array *array,
+    struct hg_oa_hash_table_slot *slot);
+
+/* Move up to steps old slots to the current array */
+static void
+hg_oa_hash_table_migrate(hg_oa_hash_table_t *hash_table, unsigned int steps);
+
+/* Start enlarging table */
+static int
+hg_oa_hash_table_enlarge(hg_oa_hash_table_t *hash_table);
+
+/* Get slot from iterator index */
+static struct hg_oa_hash_table_slot *
+hg_oa_hash_table_iter_slot(hg_oa_hash_table_t *hash_table, unsigned int idx);
+
+/* Move iterator to first used slot starting from idx */
+static void
+hg_oa_hash_table_iter_seek(hg_oa_hash_table_iter_t *iter, unsigned int idx);
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_oa_hash_table_array_size(const struct hg_oa_hash_table_array *array)
+{
+    return (array->slots != NULL) ? array->mask + 1 : 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_oa_hash_table_array_home(
+    const struct hg_oa_hash_table_array *array, uint32_t hash)
+{
+    return (unsigned int) ((uint32_t) (hash * HG_OA_HASH_TABLE_GOLDEN) >>
+                           array->shift);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_oa_hash_table_array_alloc(
+    struct hg_oa_hash_table_array *array, unsigned int bits)
+{
+    array->slots = (struct hg_oa_hash_table_slot *) calloc(
+        (size_t) 1 << bits, sizeof(struct hg_oa_hash_table_slot));
+    if (array->slots == NULL)
+        return 0;
+
+    array->mask = (1U << bits) - 1;
+    array->shift = 32 - bits;
+    array->entries = 0;
+
+    return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_oa_hash_table_slot *
+hg_oa_hash_table_array_find(const hg_oa_hash_table_t *hash_table,
+    const struct hg_oa_hash_table_array *array, hg_hash_table_key_t key,
+    uint32_t hash)
+{
+    unsigned int idx;
+    uint32_t dist;
+
+    if (array->slots == NULL || array->entries == 0)
+        return NULL;
+
+    /* Entries are ordered by distance, stop as soon as a closer one is met */
+    idx = hg_oa_hash_table_array_home(array, hash);
+    for (dist = 1;; dist++) {
+        struct hg_oa_hash_table_slot *slot = &array->slots[idx];
+
+        if (slot->dist < dist)
+            return NULL;
+        if (slot->hash == hash && hash_table->equal_func(key, slot->key) != 0)
+            return slot;
+        idx = (idx + 1) & array->mask;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_oa_hash_table_array_place(struct hg_oa_hash_table_array *array,
+    hg_hash_table_key_t key, hg_hash_table_value_t value, uint32_t hash)
+{
+    struct hg_oa_hash_table_slot entry = {
+        .key = key, .value = value, .hash = hash, .dist = 1};
+    unsigned int idx = hg_oa_hash_table_array_home(array, hash);
+
+    /* Take the slot of any entry closer to its home than we are */
+    for (;; idx = (idx + 1) & array->mask, entry.dist++) {
+        struct hg_oa_hash_table_slot *slot = &array->slots[idx];
+
+        if (slot->dist == 0) {
+            *slot = entry;
+            break;
+        }
+        if (slot->dist < entry.dist) {
+            struct hg_oa_hash_table_slot tmp = *slot;
+
+            *slot = entry;
+            entry = tmp;
+        }
+    }
+    array->entries++;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_oa_hash_table_array_erase(struct hg_oa_hash_table_array *array,
+    struct hg_oa_hash_table_slot *slot)
+{
+    unsigned int idx = (unsigned int) (slot - array->slots);
+
+    for (;;) {
+        unsigned int next = (idx + 1) & array->mask;
+
+        if (array->slots[next].dist <= 1) {
+            array->slots[idx].dist = 0;
+            break;
+        }
+        array->slots[idx] = array->slots[next];
+        array->slots[idx].dist--;
+        idx = next;
+    }
+    array->entries--;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_oa_hash_table_migrate(hg_oa_hash_table_t *hash_table, unsigned int steps)
+{
+    struct hg_oa_hash_table_array *old = &hash_table->old;
+
+    if (old->slots == NULL)
+        return;
+
+    /* Erasing pulls displaced entries back into the current slot, entries
+     * therefore never move below migrate_idx and the old array remains
+     * valid for lookups until it is empty */
+    while (steps-- > 0 && old->entries > 0) {
+        struct hg_oa_hash_table_slot *slot =
+            &old->slots[hash_table->migrate_idx];
+
+        if (slot->dist == 0) {
+            hash_table->migrate_idx++;
+            continue;
+        }
+        hg_oa_hash_table_array_place(
+            &hash_table->cur, slot->key, slot->value, slot->hash);
+        hg_oa_hash_table_array_erase(old, slot);
+    }
+
+    if (old->entries == 0) {
+        free(old->slots);
+        old->slots = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_oa_hash_table_enlarge(hg_oa_hash_table_t *hash_table)
+{
+    struct hg_oa_hash_table_array array;
+
+    /* Previous enlargement must be complete */
+    hg_oa_hash_table_migrate(hash_table, (unsigned int) -1);
+
+    if (hash_table->cur.shift == 1 ||
+        !hg_oa_hash_table_array_alloc(&array, 33 - hash_table->cur.shift))
+        return 0;
+
+    hash_table->old = hash_table->cur;
+    hash_table->cur = array;
+    hash_table->migrate_idx = 0;
+
+    return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_oa_hash_table_slot *
+hg_oa_hash_table_iter_slot(hg_oa_hash_table_t *hash_table, unsigned int idx)
+{
+    unsigned int old_size = hg_oa_hash_table_array_size(&hash_table->old);
+
+    return (idx < old_size) ? &hash_table->old.slots[idx]
+                            : &hash_table->cur.slots[idx - old_size];
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_oa_hash_table_iter_seek(hg_oa_hash_table_iter_t *iter, unsigned int idx)
+{
+    hg_oa_hash_table_t *hash_table = iter->hash_table;
+    unsigned int size = hg_oa_hash_table_array_size(&hash_table->old) +
+                        hg_oa_hash_table_array_size(&hash_table->cur);
+
+    while (idx < size && hg_oa_hash_table_iter_slot(hash_table, idx)->dist == 0)
+        idx++;
+    iter->next_slot = idx;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_oa_hash_table_t *
+hg_oa_hash_table_new(
+    hg_hash_table_hash_func_t hash_func, hg_hash_table_equal_func_t equal_func)
+{
+    hg_oa_hash_table_t *hash_table;
+
+    hash_table = (hg_oa_hash_table_t *) calloc(1, sizeof(*hash_table));
+    if (hash_table == NULL)
+        return NULL;
+
+    hash_table->hash_func = hash_func;
+    hash_table->equal_func = equal_func;
+
+    if (!hg_oa_hash_table_array_alloc(
+            &hash_table->cur, HG_OA_HASH_TABLE_MIN_BITS)) {
+        free(hash_table);
+        return NULL;
+    }
+
+    return hash_table;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_oa_hash_table_free(hg_oa_hash_table_t *hash_table)
+{
+    hg_oa_hash_table_iter_t iter;
+
+    if (hash_table->key_free_func != NULL ||
+        hash_table->value_free_func != NULL) {
+        hg_oa_hash_table_iterate(hash_table, &iter);
+        while (hg_oa_hash_table_iter_has_more(&iter)) {
+            struct hg_oa_hash_table_slot *slot =
+                hg_oa_hash_table_iter_slot(hash_table, iter.next_slot);
+
+            if (hash_table->key_free_func != NULL)
+                hash_table->key_free_func(slot->key);
+            if (hash_table->value_free_func != NULL)
+                hash_table->value_free_func(slot->value);
+            hg_oa_hash_table_iter_seek(&iter, iter.next_slot + 1);
+        }
+    }
+
+    free(hash_table->old.slots);
+    free(hash_table->cur.slots);
+    free(hash_table);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_oa_hash_table_register_free_functions(hg_oa_hash_table_t *hash_table,
+    hg_hash_table_key_free_func_t key_free_func,
+    hg_hash_table_value_free_func_t value_free_func)
+{
+    hash_table->key_free_func = key_free_func;
+    hash_table->value_free_func = value_free_func;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_oa_hash_table_insert(hg_oa_hash_table_t *hash_table,
+    hg_hash_table_key_t key, hg_hash_table_value_t value)
+{
+    uint32_t hash = (uint32_t) hash_table->hash_func(key);
+    struct hg_oa_hash_table_slot *slot;
+
+    hg_oa_hash_table_migrate(hash_table, HG_OA_HASH_TABLE_MIGRATE_STEPS);
+
+    slot = hg_oa_hash_table_array_find(hash_table, &hash_table->cur, key, hash);
+    if (slot == NULL)
+        slot = hg_oa_hash_table_array_find(
+            hash_table, &hash_table->old, key, hash);
+    if (slot != NULL) {
+        /* Same key: overwrite entry, freeing the previous value and key */
+        if (hash_table->value_free_func != NULL)
+            hash_table->value_free_func(slot->value);
+        if (hash_table->key_free_func != NULL)
+            hash_table->key_free_func(slot->key);
+        slot->key = key;
+        slot->value = value;
+
+        return 1;
+    }
+
+    /* Keep using the current array if it cannot be enlarged but has room */
+    if (HG_OA_HASH_TABLE_FULL(hash_table) &&
+        !hg_oa_hash_table_enlarge(hash_table) &&
+        hash_table->cur.entries == hash_table->cur.mask)
+        return 0;
+
+    hg_oa_hash_table_array_place(&hash_table->cur, key, value, hash);
+
+    return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_hash_table_value_t
+hg_oa_hash_table_lookup(
+    hg_oa_hash_table_t *hash_table, hg_hash_table_key_t key)
+{
+    uint32_t hash = (uint32_t) hash_table->hash_func(key);
+    struct hg_oa_hash_table_slot *slot;
+
+    slot = hg_oa_hash_table_array_find(hash_table, &hash_table->cur, key, hash);
+    if (slot == NULL)
+        slot = hg_oa_hash_table_array_find(
+            hash_table, &hash_table->old, key, hash);
+
+    return (slot != NULL) ? slot->value : HG_HASH_TABLE_NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_oa_hash_table_remove(
+    hg_oa_hash_table_t *hash_table, hg_hash_table_key_t key)
+{
+    uint32_t hash = (uint32_t) hash_table->hash_func(key);
+    struct hg_oa_hash_table_array *array = &hash_table->cur;
+    struct hg_oa_hash_table_slot *slot;
+    hg_hash_table_key_t slot_key;
+    hg_hash_table_value_t slot_value;
+
+    hg_oa_hash_table_migrate(hash_table, HG_OA_HASH_TABLE_MIGRATE_STEPS);
+
+    slot = hg_oa_hash_table_array_find(hash_table, array, key, hash);
+    if (slot == NULL) {
+        array = &hash_table->old;
+        slot = hg_oa_hash_table_array_find(hash_table, array, key, hash);
+        if (slot == NULL)
+            return 0;
+    }
+
+    slot_key = slot->key;
+    slot_value = slot->value;
+    hg_oa_hash_table_array_erase(array, slot);
+
+    if (hash_table->key_free_func != NULL)
+        hash_table->key_free_func(slot_key);
+    if (hash_table->value_free_func != NULL)
+        hash_table->value_free_func(slot_value);
+
+    return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+unsigned int
+hg_oa_hash_table_num_entries(hg_oa_hash_table_t *hash_table)
+{
+    return hash_table->cur.entries + hash_table->old.entries;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_oa_hash_table_iterate(
+    hg_oa_hash_table_t *hash_table, hg_oa_hash_table_iter_t *iter)
+{
+    iter->hash_table = hash_table;
+    hg_oa_hash_table_iter_seek(iter, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_oa_hash_table_iter_has_more(hg_oa_hash_table_iter_t *iter)
+{
+    hg_oa_hash_table_t *hash_table = iter->hash_table;
+
+    return iter->next_slot < hg_oa_hash_table_array_size(&hash_table->old) +
+                                 hg_oa_hash_table_array_size(&hash_table->cur);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_hash_table_value_t
+hg_oa_hash_table_iter_next(hg_oa_hash_table_iter_t *iter)
+{
+    hg_hash_table_value_t value;
+
+    if (!hg_oa_hash_table_iter_has_more(iter))
+        return HG_HASH_TABLE_NULL;
+
+    value =
+        hg_oa_hash_table_iter_slot(iter->hash_table, iter->next_slot)->value;
+    hg_oa_hash_table_iter_seek(iter, iter->next_slot + 1);
+
+    return value;
+}
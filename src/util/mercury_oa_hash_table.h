@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MERCURY_OA_HASH_TABLE_H
+#define MERCURY_OA_HASH_TABLE_H
+
+#include "mercury_hash_table.h"
+
+/*************************************/
+/* Public Type and Struct Definition */
+/*************************************/
+
+/**
+ * Open-addressing hash table. Keys, values and hashes are stored inline in a
+ * single array of slots using Robin Hood probing, so that entries are not
+ * individually allocated and lookups walk contiguous memory. When the table
+ * is enlarged, entries are moved to the new array a few at a time on each
+ * insertion or removal instead of all at once.
+ *
+ * The interface mirrors \ref hg_hash_table_t and uses the same key, value
+ * and function types, so existing callers can switch by renaming calls.
+ * As with \ref hg_hash_table_t, lookups may run concurrently but insertions
+ * and removals must be serialized by the caller. Entries must not be
+ * inserted or removed while the table is being iterated over.
+ */
+typedef struct hg_oa_hash_table hg_oa_hash_table_t;
+
+/**
+ * Structure used to iterate over a hash table.
+ */
+typedef struct hg_oa_hash_table_iter hg_oa_hash_table_iter_t;
+
+struct hg_oa_hash_table_iter {
+    hg_oa_hash_table_t *hash_table;
+    unsigned int next_slot; /* Next slot, old table slots come first */
+};
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a new hash table.
+ *
+ * \param hash_func [IN]        function used to hash keys
+ * \param equal_func [IN]       function used to compare keys
+ *
+ * \return pointer to new hash table or NULL on failure
+ */
+HG_UTIL_PUBLIC hg_oa_hash_table_t *
+hg_oa_hash_table_new(
+    hg_hash_table_hash_func_t hash_func, hg_hash_table_equal_func_t equal_func);
+
+/**
+ * Destroy a hash table, calling the free functions on remaining entries.
+ *
+ * \param hash_table [IN/OUT]   pointer to hash table
+ */
+HG_UTIL_PUBLIC void
+hg_oa_hash_table_free(hg_oa_hash_table_t *hash_table);
+
+/**
+ * Register functions used to free the key and value when an entry is
+ * removed or overwritten.
+ *
+ * \param hash_table [IN/OUT]   pointer to hash table
+ * \param key_free_func [IN]    function used to free keys
+ * \param value_free_func [IN]  function used to free values
+ */
+HG_UTIL_PUBLIC void
+hg_oa_hash_table_register_free_functions(hg_oa_hash_table_t *hash_table,
+    hg_hash_table_key_free_func_t key_free_func,
+    hg_hash_table_value_free_func_t value_free_func);
+
+/**
+ * Insert a value, overwriting any existing entry using the same key.
+ *
+ * \param hash_table [IN/OUT]   pointer to hash table
+ * \param key [IN]              key
+ * \param value [IN]            value
+ *
+ * \return Non-zero if the value was added or zero if the table could not be
+ * enlarged
+ */
+HG_UTIL_PUBLIC int
+hg_oa_hash_table_insert(hg_oa_hash_table_t *hash_table,
+    hg_hash_table_key_t key, hg_hash_table_value_t value);
+
+/**
+ * Look up a value by key.
+ *
+ * \param hash_table [IN]       pointer to hash table
+ * \param key [IN]              key
+ *
+ * \return Value or HG_HASH_TABLE_NULL if key is not found
+ */
+HG_UTIL_PUBLIC hg_hash_table_value_t
+hg_oa_hash_table_lookup(
+    hg_oa_hash_table_t *hash_table, hg_hash_table_key_t key);
+
+/**
+ * Remove a value by key.
+ *
+ * \param hash_table [IN/OUT]   pointer to hash table
+ * \param key [IN]              key
+ *
+ * \return Non-zero if the key was removed or zero if it was not found
+ */
+HG_UTIL_PUBLIC int
+hg_oa_hash_table_remove(
+    hg_oa_hash_table_t *hash_table, hg_hash_table_key_t key);
+
+/**
+ * Retrieve the number of entries.
+ *
+ * \param hash_table [IN]       pointer to hash table
+ *
+ * \return Number of entries
+ */
+HG_UTIL_PUBLIC unsigned int
+hg_oa_hash_table_num_entries(hg_oa_hash_table_t *hash_table);
+
+/**
+ * Initialize an iterator over all values of a hash table.
+ *
+ * \param hash_table [IN]       pointer to hash table
+ * \param iter [OUT]            pointer to iterator
+ */
+HG_UTIL_PUBLIC void
+hg_oa_hash_table_iterate(
+    hg_oa_hash_table_t *hash_table, hg_oa_hash_table_iter_t *iter);
+
+/**
+ * Determine whether there are more values to iterate over.
+ *
+ * \param iter [IN]             pointer to iterator
+ *
+ * \return Non-zero if there are more values, zero otherwise
+ */
+HG_UTIL_PUBLIC int
+hg_oa_hash_table_iter_has_more(hg_oa_hash_table_iter_t *iter);
+
+/**
+ * Retrieve the next value.
+ *
+ * \param iter [IN/OUT]         pointer to iterator
+ *
+ * \return Next value or HG_HASH_TABLE_NULL if there are no more values
+ */
+HG_UTIL_PUBLIC hg_hash_table_value_t
+hg_oa_hash_table_iter_next(hg_oa_hash_table_iter_t *iter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MERCURY_OA_HASH_TABLE_H */
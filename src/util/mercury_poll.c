@@ -21,6 +21,12 @@
 #    include <unistd.h>
 #    if defined(HG_UTIL_HAS_SYSEPOLL_H)
 #        include <sys/epoll.h>
+#        ifdef HG_UTIL_HAS_IO_URING
+#            include <linux/io_uring.h>
+#            include <poll.h>
+#            include <sys/mman.h>
+#            include <sys/syscall.h>
+#        endif
 #    elif defined(HG_UTIL_HAS_SYSEVENT_H)
 #        include <sys/event.h>
 #        include <sys/time.h>
@@ -36,10 +42,64 @@
 #define HG_POLL_INIT_NEVENTS 32
 #define HG_POLL_MAX_EVENTS   4096
 
+#ifdef HG_UTIL_HAS_IO_URING
+/* Submission ring size, re-arms are submitted in batches of that size */
+#    define HG_POLL_URING_SQ_ENTRIES 256
+/* Completion ring size, one poll per fd is outstanding at most */
+#    define HG_POLL_URING_CQ_ENTRIES (2 * HG_POLL_MAX_EVENTS)
+/* User data of completions that must be ignored (poll removals) */
+#    define HG_POLL_URING_IGNORE UINT64_MAX
+/* End of slot free list */
+#    define HG_POLL_URING_NONE UINT32_MAX
+
+/* Slot index and generation are packed into the user data of each poll */
+#    define HG_POLL_URING_USER_DATA(slot, gen)                                 \
+        (((uint64_t) (gen) << 32) | (uint64_t) (slot))
+#endif
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
 
+#ifdef HG_UTIL_HAS_IO_URING
+/* Registered file descriptor */
+struct hg_poll_uring_entry {
+    hg_poll_data_t data; /* User data */
+    uint32_t gen;        /* Incremented each time the slot is released */
+    uint32_t next_free;  /* Next free slot */
+    int fd;              /* File descriptor (-1 if slot is free) */
+    short int events;    /* POLLIN / POLLOUT */
+    bool armed;          /* Poll request is outstanding */
+    bool oneshot;        /* Only re-armed by hg_poll_rearm() */
+    bool fixed;          /* fd is registered at slot index */
+};
+
+/* io_uring poll backend */
+struct hg_poll_uring {
+    struct hg_poll_uring_entry *entries; /* Slots, indexed by user data */
+    uint64_t *rearm;                     /* Polls to re-arm on next wait */
+    struct io_uring_sqe *sqes;           /* Submission queue entries */
+    struct io_uring_cqe *cqes;           /* Completion queue entries */
+    unsigned int *sq_head;               /* Kernel submission head */
+    unsigned int *sq_tail;               /* Shared submission tail */
+    unsigned int *sq_flags;              /* Submission ring flags */
+    unsigned int *cq_head;               /* Shared completion head */
+    unsigned int *cq_tail;               /* Kernel completion tail */
+    void *ring_ptr;                      /* Mapped rings */
+    size_t ring_size;                    /* Size of mapped rings */
+    unsigned int sq_mask;                /* Submission ring mask */
+    unsigned int sq_entries;             /* Submission ring size */
+    unsigned int sq_local_tail;          /* Tail of unpublished entries */
+    unsigned int cq_mask;                /* Completion ring mask */
+    unsigned int nentries;               /* Number of allocated slots */
+    unsigned int nrearm;                 /* Number of polls to re-arm */
+    uint32_t free_head;                  /* First free slot */
+    int ring_fd;                         /* Ring descriptor */
+    bool fixed_files;                    /* Use registered descriptors */
+    bool external;                       /* Ring fd waited on by caller */
+};
+#endif
+
 struct hg_poll_set {
     hg_thread_mutex_t lock;
 #if defined(_WIN32)
@@ -47,6 +107,9 @@ struct hg_poll_set {
     HANDLE *events; /* placeholder */
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
     struct epoll_event *events;
+#    ifdef HG_UTIL_HAS_IO_URING
+    struct hg_poll_uring *uring; /* NULL if epoll is used */
+#    endif
 #elif defined(HG_UTIL_HAS_SYSEVENT_H)
     struct kevent *events;
 #else
@@ -62,6 +125,79 @@ struct hg_poll_set {
 /* Local Prototypes */
 /********************/
 
+#ifdef HG_UTIL_HAS_IO_URING
+/**
+ * Create io_uring backend, return NULL if not supported by the kernel.
+ */
+static struct hg_poll_uring *
+hg_poll_uring_create(void);
+
+/**
+ * Destroy io_uring backend.
+ */
+static int
+hg_poll_uring_destroy(struct hg_poll_uring *uring);
+
+/**
+ * Register fd at slot index of the file table, -1 to unregister.
+ */
+static int
+hg_poll_uring_register_fd(struct hg_poll_uring *uring, uint32_t slot, int fd);
+
+/**
+ * Get a free submission entry, submitting pending entries if needed.
+ */
+static struct io_uring_sqe *
+hg_poll_uring_get_sqe(struct hg_poll_uring *uring);
+
+/**
+ * Queue a poll request for a slot.
+ */
+static int
+hg_poll_uring_arm(struct hg_poll_uring *uring, uint32_t slot);
+
+/**
+ * Queue poll requests of slots that have completed since last call.
+ */
+static int
+hg_poll_uring_rearm(struct hg_poll_uring *uring);
+
+/**
+ * Submit pending entries and optionally wait for completions.
+ */
+static int
+hg_poll_uring_enter(
+    struct hg_poll_uring *uring, unsigned int timeout, bool wait);
+
+/**
+ * Add file descriptor to io_uring poll set.
+ */
+static int
+hg_poll_uring_add(struct hg_poll_uring *uring, int fd,
+    struct hg_poll_event *event);
+
+/**
+ * Remove file descriptor from io_uring poll set.
+ */
+static int
+hg_poll_uring_remove(struct hg_poll_uring *uring, int fd);
+
+/**
+ * Re-arm one-shot file descriptor of io_uring poll set.
+ */
+static int
+hg_poll_uring_rearm_fd(
+    struct hg_poll_uring *uring, int fd, struct hg_poll_event *event);
+
+/**
+ * Wait on io_uring poll set.
+ */
+static int
+hg_poll_uring_wait(struct hg_poll_uring *uring, hg_thread_mutex_t *lock,
+    unsigned int timeout, unsigned int max_events,
+    struct hg_poll_event *events, unsigned int *actual_events);
+#endif
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -89,9 +225,18 @@ hg_poll_create(void)
 #if defined(_WIN32)
     /* TODO */
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
-    hg_poll_set->fd = epoll_create1(0);
-    HG_UTIL_CHECK_ERROR_NORET(hg_poll_set->fd == -1, error,
-        "epoll_create1() failed (%s)", strerror(errno));
+#    ifdef HG_UTIL_HAS_IO_URING
+    /* Fall back to epoll if io_uring is not available */
+    hg_poll_set->uring = hg_poll_uring_create();
+    if (hg_poll_set->uring != NULL)
+        hg_poll_set->fd = hg_poll_set->uring->ring_fd;
+    else
+#    endif
+    {
+        hg_poll_set->fd = epoll_create1(0);
+        HG_UTIL_CHECK_ERROR_NORET(hg_poll_set->fd == -1, error,
+            "epoll_create1() failed (%s)", strerror(errno));
+    }
 #elif defined(HG_UTIL_HAS_SYSEVENT_H)
     hg_poll_set->fd = kqueue();
     HG_UTIL_CHECK_ERROR_NORET(
@@ -140,8 +285,15 @@ hg_poll_destroy(hg_poll_set_t *poll_set)
 #if defined(_WIN32)
     /* TODO */
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H) || defined(HG_UTIL_HAS_SYSEVENT_H)
-    /* Close poll descriptor */
-    rc = close(poll_set->fd);
+#    ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring != NULL) {
+        rc = hg_poll_uring_destroy(poll_set->uring);
+        HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_UTIL_FAIL,
+            "Could not destroy io_uring poll set");
+    } else
+#    endif
+        /* Close poll descriptor */
+        rc = close(poll_set->fd);
     HG_UTIL_CHECK_ERROR(rc == -1, done, ret, HG_UTIL_FAIL,
         "close() failed (%s)", strerror(errno));
 #else
@@ -170,7 +322,28 @@ hg_poll_get_fd(hg_poll_set_t *poll_set)
     /* TODO */
     return -1;
 #else
+#    ifdef HG_UTIL_HAS_IO_URING
+    /* The ring fd only becomes readable once polls have been submitted, new
+     * polls can no longer be deferred to the next wait */
+    if (poll_set->uring != NULL) {
+        int rc;
+
+        hg_thread_mutex_lock(&poll_set->lock);
+        poll_set->uring->external = true;
+        rc = hg_poll_uring_rearm(poll_set->uring);
+        if (rc == HG_UTIL_SUCCESS)
+            rc = hg_poll_uring_enter(poll_set->uring, 0, false);
+        hg_thread_mutex_unlock(&poll_set->lock);
+        HG_UTIL_CHECK_ERROR_NORET(
+            rc != HG_UTIL_SUCCESS, error, "Could not submit polls");
+    }
+#    endif
     return poll_set->fd;
+
+#    ifdef HG_UTIL_HAS_IO_URING
+error:
+    return -1;
+#    endif
 #endif
 }
 
@@ -188,6 +361,7 @@ hg_poll_add(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event)
     struct kevent ev;
     struct timespec timeout = {0, 0};
     int16_t poll_flags = 0;
+    uint16_t flags = EV_ADD;
     int rc;
 #else
     struct pollfd ev;
@@ -201,11 +375,26 @@ hg_poll_add(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event)
     /* TODO */
     HG_UTIL_GOTO_ERROR(done, ret, HG_UTIL_FAIL, "Not implemented");
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
+#    ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring != NULL) {
+        hg_thread_mutex_lock(&poll_set->lock);
+        ret = hg_poll_uring_add(poll_set->uring, fd, event);
+        if (ret == HG_UTIL_SUCCESS)
+            poll_set->nfds++;
+        hg_thread_mutex_unlock(&poll_set->lock);
+
+        return ret;
+    }
+#    endif
     /* Translate flags */
     if (event->events & HG_POLLIN)
         poll_flags |= EPOLLIN;
     if (event->events & HG_POLLOUT)
         poll_flags |= EPOLLOUT;
+    if (event->events & HG_POLLET)
+        poll_flags |= EPOLLET;
+    if (event->events & HG_POLLONESHOT)
+        poll_flags |= EPOLLONESHOT;
 
     ev.events = poll_flags;
     ev.data.u64 = (uint64_t) event->data.u64;
@@ -219,8 +408,12 @@ hg_poll_add(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event)
         poll_flags |= EVFILT_READ;
     if (event->events & HG_POLLOUT)
         poll_flags |= EVFILT_WRITE;
+    if (event->events & HG_POLLET)
+        flags |= EV_CLEAR;
+    if (event->events & HG_POLLONESHOT)
+        flags |= EV_DISPATCH;
 
-    EV_SET(&ev, (uintptr_t) fd, poll_flags, EV_ADD, 0, 0, event->data.ptr);
+    EV_SET(&ev, (uintptr_t) fd, poll_flags, flags, 0, 0, event->data.ptr);
 
     rc = kevent(poll_set->fd, &ev, 1, NULL, 0, &timeout);
     HG_UTIL_CHECK_ERROR(rc == -1, done, ret, HG_UTIL_FAIL,
@@ -275,6 +468,100 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+int
+hg_poll_rearm(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event)
+{
+#if defined(_WIN32)
+    /* TODO */
+#elif defined(HG_UTIL_HAS_SYSEPOLL_H)
+    struct epoll_event ev;
+    uint32_t poll_flags = 0;
+    int rc;
+#elif defined(HG_UTIL_HAS_SYSEVENT_H)
+    struct kevent ev;
+    struct timespec timeout = {0, 0};
+    int16_t poll_flags = 0;
+    uint16_t flags = EV_ADD | EV_ENABLE;
+    int rc;
+#else
+    int i, found = -1;
+#endif
+    int ret = HG_UTIL_SUCCESS;
+
+    HG_UTIL_LOG_DEBUG("Re-arming fd=%d in poll set (fd=%d)", fd, poll_set->fd);
+
+#if defined(_WIN32)
+    /* TODO */
+    HG_UTIL_GOTO_ERROR(done, ret, HG_UTIL_FAIL, "Not implemented");
+#elif defined(HG_UTIL_HAS_SYSEPOLL_H)
+#    ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring != NULL) {
+        hg_thread_mutex_lock(&poll_set->lock);
+        ret = hg_poll_uring_rearm_fd(poll_set->uring, fd, event);
+        hg_thread_mutex_unlock(&poll_set->lock);
+
+        return ret;
+    }
+#    endif
+    /* Translate flags */
+    if (event->events & HG_POLLIN)
+        poll_flags |= EPOLLIN;
+    if (event->events & HG_POLLOUT)
+        poll_flags |= EPOLLOUT;
+    if (event->events & HG_POLLET)
+        poll_flags |= EPOLLET;
+    if (event->events & HG_POLLONESHOT)
+        poll_flags |= EPOLLONESHOT;
+
+    ev.events = poll_flags;
+    ev.data.u64 = (uint64_t) event->data.u64;
+
+    rc = epoll_ctl(poll_set->fd, EPOLL_CTL_MOD, fd, &ev);
+    HG_UTIL_CHECK_ERROR(rc != 0, done, ret, HG_UTIL_FAIL,
+        "epoll_ctl() failed (%s)", strerror(errno));
+#elif defined(HG_UTIL_HAS_SYSEVENT_H)
+    /* Translate flags */
+    if (event->events & HG_POLLIN)
+        poll_flags |= EVFILT_READ;
+    if (event->events & HG_POLLOUT)
+        poll_flags |= EVFILT_WRITE;
+    if (event->events & HG_POLLET)
+        flags |= EV_CLEAR;
+    if (event->events & HG_POLLONESHOT)
+        flags |= EV_DISPATCH;
+
+    EV_SET(&ev, (uintptr_t) fd, poll_flags, flags, 0, 0, event->data.ptr);
+
+    rc = kevent(poll_set->fd, &ev, 1, NULL, 0, &timeout);
+    HG_UTIL_CHECK_ERROR(rc == -1, done, ret, HG_UTIL_FAIL,
+        "kevent() failed (%s)", strerror(errno));
+#else
+    /* Descriptors are always level-triggered, only update events */
+    hg_thread_mutex_lock(&poll_set->lock);
+    for (i = 0; i < (int) poll_set->nfds; i++) {
+        if (poll_set->events[i].fd == fd) {
+            found = i;
+            break;
+        }
+    }
+    if (found >= 0) {
+        poll_set->events[found].events = 0;
+        if (event->events & HG_POLLIN)
+            poll_set->events[found].events |= POLLIN;
+        if (event->events & HG_POLLOUT)
+            poll_set->events[found].events |= POLLOUT;
+        poll_set->event_data[found] = event->data;
+    }
+    hg_thread_mutex_unlock(&poll_set->lock);
+    HG_UTIL_CHECK_ERROR(
+        found < 0, done, ret, HG_UTIL_FAIL, "Could not find fd in poll_set");
+#endif
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int
 hg_poll_remove(hg_poll_set_t *poll_set, int fd)
@@ -298,6 +585,17 @@ hg_poll_remove(hg_poll_set_t *poll_set, int fd)
     /* TODO */
     HG_UTIL_GOTO_ERROR(done, ret, HG_UTIL_FAIL, "Not implemented");
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
+#    ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring != NULL) {
+        hg_thread_mutex_lock(&poll_set->lock);
+        ret = hg_poll_uring_remove(poll_set->uring, fd);
+        if (ret == HG_UTIL_SUCCESS)
+            poll_set->nfds--;
+        hg_thread_mutex_unlock(&poll_set->lock);
+
+        return ret;
+    }
+#    endif
     rc = epoll_ctl(poll_set->fd, EPOLL_CTL_DEL, fd, NULL);
     HG_UTIL_CHECK_ERROR(rc != 0, done, ret, HG_UTIL_FAIL,
         "epoll_ctl() failed (%s)", strerror(errno));
@@ -355,6 +653,11 @@ hg_poll_wait(hg_poll_set_t *poll_set, unsigned int timeout,
     HG_UTIL_GOTO_ERROR(done, ret, HG_UTIL_FAIL, "Not implemented");
     (void) i;
 #elif defined(HG_UTIL_HAS_SYSEPOLL_H)
+#    ifdef HG_UTIL_HAS_IO_URING
+    if (poll_set->uring != NULL)
+        return hg_poll_uring_wait(poll_set->uring, &poll_set->lock, timeout,
+            max_events, events, actual_events);
+#    endif
     nfds = epoll_wait(
         poll_set->fd, poll_set->events, max_poll_events, (int) timeout);
     HG_UTIL_CHECK_ERROR(nfds == -1 && errno != EINTR, done, ret, HG_UTIL_FAIL,
@@ -523,3 +826,568 @@ unlock:
     return ret;
 #endif
 }
+
+#ifdef HG_UTIL_HAS_IO_URING
+/*---------------------------------------------------------------------------*/
+static struct hg_poll_uring *
+hg_poll_uring_create(void)
+{
+    struct hg_poll_uring *uring = NULL;
+    struct io_uring_params params;
+    size_t sq_size, cq_size;
+    unsigned int i;
+    int rc;
+
+    uring = calloc(1, sizeof(*uring));
+    HG_UTIL_CHECK_ERROR_NORET(
+        uring == NULL, error, "calloc() failed (%s)", strerror(errno));
+    uring->ring_fd = -1;
+    uring->ring_ptr = MAP_FAILED;
+    uring->sqes = MAP_FAILED;
+    uring->free_head = HG_POLL_URING_NONE;
+
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = HG_POLL_URING_CQ_ENTRIES;
+
+    /* io_uring may be missing or disabled (e.g., by seccomp) */
+    uring->ring_fd = (int) syscall(
+        SYS_io_uring_setup, HG_POLL_URING_SQ_ENTRIES, &params);
+    if (uring->ring_fd < 0) {
+        HG_UTIL_LOG_DEBUG("io_uring_setup() failed (%s)", strerror(errno));
+        goto error;
+    }
+
+    /* Timed waits require EXT_ARG, completions must never be dropped */
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0 ||
+        (params.features & IORING_FEAT_NODROP) == 0 ||
+        (params.features & IORING_FEAT_EXT_ARG) == 0) {
+        HG_UTIL_LOG_DEBUG("io_uring features are missing (0x%x)",
+            (unsigned int) params.features);
+        goto error;
+    }
+
+    /* Map both rings at once */
+    sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    uring->ring_size = MAX(sq_size, cq_size);
+    uring->ring_ptr = mmap(NULL, uring->ring_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, uring->ring_fd, IORING_OFF_SQ_RING);
+    HG_UTIL_CHECK_ERROR_NORET(uring->ring_ptr == MAP_FAILED, error,
+        "mmap() failed (%s)", strerror(errno));
+
+    uring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->ring_fd,
+        IORING_OFF_SQES);
+    HG_UTIL_CHECK_ERROR_NORET(uring->sqes == MAP_FAILED, error,
+        "mmap() failed (%s)", strerror(errno));
+
+    uring->sq_head = (unsigned int *) ((char *) uring->ring_ptr +
+                                       params.sq_off.head);
+    uring->sq_tail = (unsigned int *) ((char *) uring->ring_ptr +
+                                       params.sq_off.tail);
+    uring->sq_flags = (unsigned int *) ((char *) uring->ring_ptr +
+                                        params.sq_off.flags);
+    uring->sq_mask = *(unsigned int *) ((char *) uring->ring_ptr +
+                                        params.sq_off.ring_mask);
+    uring->sq_entries = params.sq_entries;
+    uring->sq_local_tail = *uring->sq_tail;
+    uring->cq_head = (unsigned int *) ((char *) uring->ring_ptr +
+                                       params.cq_off.head);
+    uring->cq_tail = (unsigned int *) ((char *) uring->ring_ptr +
+                                       params.cq_off.tail);
+    uring->cq_mask = *(unsigned int *) ((char *) uring->ring_ptr +
+                                        params.cq_off.ring_mask);
+    uring->cqes = (struct io_uring_cqe *) ((char *) uring->ring_ptr +
+                                           params.cq_off.cqes);
+
+    /* Submission entries are always used in ring order */
+    for (i = 0; i < params.sq_entries; i++)
+        ((unsigned int *) ((char *) uring->ring_ptr +
+                           params.sq_off.array))[i] = i;
+
+    /* Register a sparse table of descriptors so that re-arming a poll does
+     * not need to look up the file each time, this is optional */
+    {
+        int *fds = malloc(sizeof(*fds) * HG_POLL_MAX_EVENTS);
+
+        if (fds != NULL) {
+            for (i = 0; i < HG_POLL_MAX_EVENTS; i++)
+                fds[i] = -1;
+            rc = (int) syscall(SYS_io_uring_register, uring->ring_fd,
+                IORING_REGISTER_FILES, fds, HG_POLL_MAX_EVENTS);
+            uring->fixed_files = (rc == 0);
+            free(fds);
+        }
+    }
+
+    HG_UTIL_LOG_DEBUG("Using io_uring poll backend, fd=%d (fixed files: %d)",
+        uring->ring_fd, uring->fixed_files);
+
+    return uring;
+
+error:
+    if (uring) {
+        (void) hg_poll_uring_destroy(uring);
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_destroy(struct hg_poll_uring *uring)
+{
+    int ret = HG_UTIL_SUCCESS;
+
+    if (uring->sqes != MAP_FAILED)
+        (void) munmap(uring->sqes,
+            uring->sq_entries * sizeof(struct io_uring_sqe));
+    if (uring->ring_ptr != MAP_FAILED)
+        (void) munmap(uring->ring_ptr, uring->ring_size);
+    if (uring->ring_fd >= 0 && close(uring->ring_fd) == -1) {
+        HG_UTIL_LOG_ERROR("close() failed (%s)", strerror(errno));
+        ret = HG_UTIL_FAIL;
+    }
+    free(uring->entries);
+    free(uring->rearm);
+    free(uring);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_register_fd(struct hg_poll_uring *uring, uint32_t slot, int fd)
+{
+    struct io_uring_files_update update;
+
+    memset(&update, 0, sizeof(update));
+    update.offset = slot;
+    update.fds = (uint64_t) (uintptr_t) &fd;
+
+    return (int) syscall(SYS_io_uring_register, uring->ring_fd,
+        IORING_REGISTER_FILES_UPDATE, &update, 1);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct io_uring_sqe *
+hg_poll_uring_get_sqe(struct hg_poll_uring *uring)
+{
+    struct io_uring_sqe *sqe;
+
+    if (uring->sq_local_tail -
+            __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE) ==
+        uring->sq_entries) {
+        /* Ring is full, submit what we have */
+        if (hg_poll_uring_enter(uring, 0, false) != HG_UTIL_SUCCESS)
+            return NULL;
+        if (uring->sq_local_tail -
+                __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE) ==
+            uring->sq_entries)
+            return NULL;
+    }
+
+    sqe = &uring->sqes[uring->sq_local_tail & uring->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    uring->sq_local_tail++;
+
+    return sqe;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_arm(struct hg_poll_uring *uring, uint32_t slot)
+{
+    struct hg_poll_uring_entry *entry = &uring->entries[slot];
+    struct io_uring_sqe *sqe;
+    int ret = HG_UTIL_SUCCESS;
+
+    sqe = hg_poll_uring_get_sqe(uring);
+    HG_UTIL_CHECK_ERROR(sqe == NULL, done, ret, HG_UTIL_FAIL,
+        "Could not get submission entry");
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    if (entry->fixed) {
+        sqe->fd = (int) slot;
+        sqe->flags = IOSQE_FIXED_FILE;
+    } else
+        sqe->fd = entry->fd;
+    sqe->poll32_events = (uint32_t) entry->events;
+    sqe->user_data = HG_POLL_URING_USER_DATA(slot, entry->gen);
+    entry->armed = true;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_rearm(struct hg_poll_uring *uring)
+{
+    unsigned int i;
+    int ret = HG_UTIL_SUCCESS;
+
+    for (i = 0; i < uring->nrearm; i++) {
+        uint32_t slot = (uint32_t) uring->rearm[i];
+        uint32_t gen = (uint32_t) (uring->rearm[i] >> 32);
+
+        /* Skip descriptors that have been removed in the meantime */
+        if (uring->entries[slot].gen != gen || uring->entries[slot].armed)
+            continue;
+
+        ret = hg_poll_uring_arm(uring, slot);
+        HG_UTIL_CHECK_ERROR(
+            ret != HG_UTIL_SUCCESS, done, ret, ret, "Could not re-arm poll");
+    }
+    uring->nrearm = 0;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_enter(
+    struct hg_poll_uring *uring, unsigned int timeout, bool wait)
+{
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    unsigned int to_submit, flags = 0;
+    int rc, ret = HG_UTIL_SUCCESS;
+
+    /* Publish entries, the kernel does not submit more than is available */
+    __atomic_store_n(uring->sq_tail, uring->sq_local_tail, __ATOMIC_RELEASE);
+    to_submit = uring->sq_local_tail -
+                __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE);
+
+    if (wait) {
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (long long) (timeout % 1000) * 1000000LL;
+        memset(&arg, 0, sizeof(arg));
+        arg.ts = (uint64_t) (uintptr_t) &ts;
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    } else if (to_submit == 0)
+        goto done;
+
+    rc = (int) syscall(SYS_io_uring_enter, uring->ring_fd, to_submit,
+        wait ? 1 : 0, flags, wait ? &arg : NULL, wait ? sizeof(arg) : 0);
+    /* ETIME is returned on timeout, EBUSY if completions have overflowed */
+    HG_UTIL_CHECK_ERROR(rc < 0 && errno != EINTR && errno != ETIME &&
+                            errno != EBUSY,
+        done, ret, HG_UTIL_FAIL, "io_uring_enter() failed (%s)",
+        strerror(errno));
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_add(
+    struct hg_poll_uring *uring, int fd, struct hg_poll_event *event)
+{
+    struct hg_poll_uring_entry *entry;
+    uint32_t slot;
+    int ret = HG_UTIL_SUCCESS, rc;
+
+    /* Grow slots if none is free */
+    if (uring->free_head == HG_POLL_URING_NONE) {
+        unsigned int nentries =
+            (uring->nentries == 0) ? HG_POLL_INIT_NEVENTS : uring->nentries * 2;
+        struct hg_poll_uring_entry *entries;
+        uint64_t *rearm;
+        unsigned int i;
+
+        HG_UTIL_CHECK_ERROR(nentries > HG_POLL_MAX_EVENTS, done, ret,
+            HG_UTIL_FAIL, "reached max number of events for this poll set (%d)",
+            uring->nentries);
+
+        entries = realloc(uring->entries, sizeof(*entries) * nentries);
+        HG_UTIL_CHECK_ERROR(entries == NULL, done, ret, HG_UTIL_FAIL,
+            "realloc() failed (%s)", strerror(errno));
+        uring->entries = entries;
+
+        rearm = realloc(uring->rearm, sizeof(*rearm) * nentries);
+        HG_UTIL_CHECK_ERROR(rearm == NULL, done, ret, HG_UTIL_FAIL,
+            "realloc() failed (%s)", strerror(errno));
+        uring->rearm = rearm;
+
+        for (i = nentries; i > uring->nentries; i--) {
+            entries[i - 1].gen = 0;
+            entries[i - 1].fd = -1;
+            entries[i - 1].armed = false;
+            entries[i - 1].oneshot = false;
+            entries[i - 1].fixed = false;
+            entries[i - 1].next_free = uring->free_head;
+            uring->free_head = i - 1;
+        }
+        uring->nentries = nentries;
+    }
+
+    slot = uring->free_head;
+    entry = &uring->entries[slot];
+
+    /* Other rings (e.g., nested poll sets) cannot be registered */
+    entry->fixed = false;
+    if (uring->fixed_files) {
+        rc = hg_poll_uring_register_fd(uring, slot, fd);
+        HG_UTIL_CHECK_ERROR(rc < 0 && errno != EBADF, done, ret, HG_UTIL_FAIL,
+            "io_uring_register() failed (%s)", strerror(errno));
+        entry->fixed = (rc >= 0);
+    }
+
+    uring->free_head = entry->next_free;
+    entry->fd = fd;
+    entry->data = event->data;
+    entry->events = 0;
+    if (event->events & HG_POLLIN)
+        entry->events |= POLLIN;
+    if (event->events & HG_POLLOUT)
+        entry->events |= POLLOUT;
+    /* Polls are single-shot, edge-triggered descriptors are re-armed as
+     * level-triggered ones */
+    entry->oneshot = (event->events & HG_POLLONESHOT) != 0;
+
+    /* The poll is submitted with the next wait unless the ring fd is used */
+    ret = hg_poll_uring_arm(uring, slot);
+    HG_UTIL_CHECK_ERROR(
+        ret != HG_UTIL_SUCCESS, error, ret, ret, "Could not arm poll");
+    if (uring->external) {
+        ret = hg_poll_uring_enter(uring, 0, false);
+        HG_UTIL_CHECK_ERROR(
+            ret != HG_UTIL_SUCCESS, error, ret, ret, "Could not submit poll");
+    }
+
+done:
+    return ret;
+
+error:
+    if (entry->fixed)
+        (void) hg_poll_uring_register_fd(uring, slot, -1);
+    entry->gen++;
+    entry->fd = -1;
+    entry->armed = false;
+    entry->fixed = false;
+    entry->next_free = uring->free_head;
+    uring->free_head = slot;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_remove(struct hg_poll_uring *uring, int fd)
+{
+    struct hg_poll_uring_entry *entry = NULL;
+    uint32_t slot;
+    int ret = HG_UTIL_SUCCESS, rc;
+
+    for (slot = 0; slot < uring->nentries; slot++) {
+        if (uring->entries[slot].fd == fd) {
+            entry = &uring->entries[slot];
+            break;
+        }
+    }
+    HG_UTIL_CHECK_ERROR(entry == NULL, done, ret, HG_UTIL_FAIL,
+        "Could not find fd in poll_set");
+
+    /* Cancel outstanding poll right away so that the kernel releases its
+     * reference to the file, its completion is ignored */
+    if (entry->armed) {
+        struct io_uring_sqe *sqe = hg_poll_uring_get_sqe(uring);
+
+        HG_UTIL_CHECK_ERROR(sqe == NULL, done, ret, HG_UTIL_FAIL,
+            "Could not get submission entry");
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->fd = -1;
+        sqe->addr = HG_POLL_URING_USER_DATA(slot, entry->gen);
+        sqe->user_data = HG_POLL_URING_IGNORE;
+
+        ret = hg_poll_uring_enter(uring, 0, false);
+        HG_UTIL_CHECK_ERROR(ret != HG_UTIL_SUCCESS, done, ret, ret,
+            "Could not submit poll removal");
+    }
+
+    if (entry->fixed) {
+        rc = hg_poll_uring_register_fd(uring, slot, -1);
+        HG_UTIL_CHECK_ERROR(rc < 0, done, ret, HG_UTIL_FAIL,
+            "io_uring_register() failed (%s)", strerror(errno));
+    }
+
+    /* Stale completions and re-arms are discarded by generation */
+    entry->gen++;
+    entry->fd = -1;
+    entry->armed = false;
+    entry->fixed = false;
+    entry->next_free = uring->free_head;
+    uring->free_head = slot;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_rearm_fd(
+    struct hg_poll_uring *uring, int fd, struct hg_poll_event *event)
+{
+    struct hg_poll_uring_entry *entry = NULL;
+    uint32_t slot;
+    int ret = HG_UTIL_SUCCESS;
+
+    for (slot = 0; slot < uring->nentries; slot++) {
+        if (uring->entries[slot].fd == fd) {
+            entry = &uring->entries[slot];
+            break;
+        }
+    }
+    HG_UTIL_CHECK_ERROR(entry == NULL, done, ret, HG_UTIL_FAIL,
+        "Could not find fd in poll_set");
+
+    entry->data = event->data;
+    entry->events = 0;
+    if (event->events & HG_POLLIN)
+        entry->events |= POLLIN;
+    if (event->events & HG_POLLOUT)
+        entry->events |= POLLOUT;
+    entry->oneshot = (event->events & HG_POLLONESHOT) != 0;
+
+    /* Poll is still outstanding, new events apply to the next re-arm */
+    if (entry->armed)
+        goto done;
+
+    /* Submitted with the next wait unless the ring fd is used */
+    ret = hg_poll_uring_arm(uring, slot);
+    HG_UTIL_CHECK_ERROR(
+        ret != HG_UTIL_SUCCESS, done, ret, ret, "Could not arm poll");
+    if (uring->external) {
+        ret = hg_poll_uring_enter(uring, 0, false);
+        HG_UTIL_CHECK_ERROR(
+            ret != HG_UTIL_SUCCESS, done, ret, ret, "Could not submit poll");
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_poll_uring_wait(struct hg_poll_uring *uring, hg_thread_mutex_t *lock,
+    unsigned int timeout, unsigned int max_events,
+    struct hg_poll_event *events, unsigned int *actual_events)
+{
+    unsigned int head, tail, nevents = 0;
+    int ret = HG_UTIL_SUCCESS;
+
+    hg_thread_mutex_lock(lock);
+
+    /* Polls that completed on the previous wait are re-armed now that the
+     * caller has consumed the events, this avoids reporting them twice */
+    ret = hg_poll_uring_rearm(uring);
+    HG_UTIL_CHECK_ERROR(
+        ret != HG_UTIL_SUCCESS, unlock, ret, ret, "Could not re-arm polls");
+
+    head = *uring->cq_head;
+    tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+    if (head == tail &&
+        (timeout > 0 || (__atomic_load_n(uring->sq_flags, __ATOMIC_RELAXED) &
+                            IORING_SQ_CQ_OVERFLOW))) {
+        hg_thread_mutex_unlock(lock);
+
+        /* Submit re-arms and wait within a single call */
+        errno = 0;
+        ret = hg_poll_uring_enter(uring, timeout, true);
+        HG_UTIL_CHECK_ERROR(
+            ret != HG_UTIL_SUCCESS, done, ret, ret, "Could not wait on ring");
+
+        /* Handle signal interrupts */
+        if (unlikely(errno == EINTR)) {
+            events[0].events |= HG_POLLINTR;
+            *actual_events = 1;
+
+            /* Reset errno */
+            errno = 0;
+
+            return HG_UTIL_SUCCESS;
+        }
+
+        hg_thread_mutex_lock(lock);
+    } else {
+        ret = hg_poll_uring_enter(uring, 0, false);
+        HG_UTIL_CHECK_ERROR(
+            ret != HG_UTIL_SUCCESS, unlock, ret, ret, "Could not submit polls");
+    }
+
+    /* Drain the whole ring, polls that do not fit are re-armed instead of
+     * being reported later as their readiness may have changed by then */
+    head = *uring->cq_head;
+    tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        struct io_uring_cqe *cqe = &uring->cqes[head & uring->cq_mask];
+        uint32_t slot = (uint32_t) cqe->user_data;
+        uint32_t gen = (uint32_t) (cqe->user_data >> 32);
+        struct hg_poll_uring_entry *entry;
+
+        head++;
+        if (cqe->user_data == HG_POLL_URING_IGNORE ||
+            slot >= uring->nentries || uring->entries[slot].gen != gen)
+            continue;
+        entry = &uring->entries[slot];
+        entry->armed = false;
+        if (nevents == max_events) {
+            uring->rearm[uring->nrearm++] = cqe->user_data;
+            continue;
+        }
+
+        events[nevents].events = 0;
+        events[nevents].data = entry->data;
+        if (cqe->res < 0) {
+            /* Do not re-arm, the descriptor is expected to be removed */
+            events[nevents].events |= HG_POLLERR;
+            nevents++;
+            continue;
+        }
+
+        if (cqe->res & POLLIN)
+            events[nevents].events |= HG_POLLIN;
+        if (cqe->res & POLLOUT)
+            events[nevents].events |= HG_POLLOUT;
+
+        /* Don't change the if/else order */
+        if (cqe->res & POLLERR)
+            events[nevents].events |= HG_POLLERR;
+        else if (cqe->res & POLLHUP)
+            events[nevents].events |= HG_POLLHUP;
+        else if (cqe->res & POLLNVAL)
+            events[nevents].events |= HG_POLLERR;
+
+        if (!entry->oneshot)
+            uring->rearm[uring->nrearm++] = cqe->user_data;
+        nevents++;
+    }
+    __atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+
+    /* When the ring fd is waited on, keep it readable until polls are re-armed
+     * by the next wait, re-arming now would report the same events twice */
+    if (uring->external && uring->nrearm > 0) {
+        struct io_uring_sqe *sqe = hg_poll_uring_get_sqe(uring);
+
+        HG_UTIL_CHECK_ERROR(sqe == NULL, unlock, ret, HG_UTIL_FAIL,
+            "Could not get submission entry");
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = HG_POLL_URING_IGNORE;
+        ret = hg_poll_uring_enter(uring, 0, false);
+        HG_UTIL_CHECK_ERROR(
+            ret != HG_UTIL_SUCCESS, unlock, ret, ret, "Could not submit polls");
+    }
+
+    *actual_events = nevents;
+
+unlock:
+    hg_thread_mutex_unlock(lock);
+
+done:
+    return ret;
+}
+#endif
@@ -41,6 +41,14 @@ struct hg_poll_event {
 #define HG_POLLHUP  (1 << 3) /* Hung up. */
 #define HG_POLLINTR (1 << 4) /* Interrupted. */
 
+/**
+ * Registration modes, passed to hg_poll_add() along with polling events.
+ * Backends that do not support a mode fall back to level-triggered
+ * notifications, which remain correct for callers that drain descriptors.
+ */
+#define HG_POLLET      (1 << 5) /* Edge-triggered. */
+#define HG_POLLONESHOT (1 << 6) /* Disabled after one event. */
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -89,6 +97,20 @@ hg_poll_get_fd(hg_poll_set_t *poll_set);
 HG_UTIL_PUBLIC int
 hg_poll_add(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event);
 
+/**
+ * Re-enable a file descriptor that was added with HG_POLLONESHOT and whose
+ * event has been reported by hg_poll_wait(). Events and registration modes
+ * are replaced with the ones passed.
+ *
+ * \param poll_set [IN]         pointer to poll set
+ * \param fd [IN]               file descriptor
+ * \param event [IN]            pointer to event struct
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_poll_rearm(hg_poll_set_t *poll_set, int fd, struct hg_poll_event *event);
+
 /**
  * Remove file descriptor from poll set.
  *
@@ -9,6 +9,8 @@
 
 #if !defined(_WIN32) && !defined(__APPLE__)
 #    include <sched.h>
+#    include <stdio.h>
+#    include <stdlib.h>
 #endif
 
 /*---------------------------------------------------------------------------*/
@@ -162,3 +164,82 @@ hg_thread_setaffinity(hg_thread_t thread, const hg_cpu_set_t *cpu_mask)
     return HG_UTIL_SUCCESS;
 #endif
 }
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_cpu_mask_init(const unsigned int *cpus, unsigned int cpu_count,
+    int numa_node, hg_cpu_set_t *cpu_mask)
+{
+#if defined(_WIN32)
+    unsigned int i;
+
+    /* NUMA nodes are not resolved */
+    if (cpus == NULL || cpu_count == 0)
+        return HG_UTIL_FAIL;
+
+    *cpu_mask = 0;
+    for (i = 0; i < cpu_count; i++) {
+        if (cpus[i] >= sizeof(hg_cpu_set_t) * 8)
+            return HG_UTIL_FAIL;
+        *cpu_mask |= (hg_cpu_set_t) 1 << cpus[i];
+    }
+    (void) numa_node;
+
+    return HG_UTIL_SUCCESS;
+#elif defined(__APPLE__)
+    (void) cpus;
+    (void) cpu_count;
+    (void) numa_node;
+    (void) cpu_mask;
+    return HG_UTIL_FAIL;
+#else
+    char path[64], cpulist[1024], *ptr;
+    unsigned int i;
+    FILE *file;
+
+    CPU_ZERO(cpu_mask);
+
+    if (cpus != NULL && cpu_count > 0) {
+        for (i = 0; i < cpu_count; i++) {
+            if (cpus[i] >= CPU_SETSIZE)
+                return HG_UTIL_FAIL;
+            CPU_SET(cpus[i], cpu_mask);
+        }
+        return HG_UTIL_SUCCESS;
+    }
+
+    if (numa_node < 0)
+        return HG_UTIL_FAIL;
+
+    /* List is of the form "0-3,8-11" */
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+        numa_node);
+    file = fopen(path, "r");
+    if (file == NULL)
+        return HG_UTIL_FAIL;
+    ptr = fgets(cpulist, (int) sizeof(cpulist), file);
+    fclose(file);
+    if (ptr == NULL)
+        return HG_UTIL_FAIL;
+
+    while (*ptr != '\0' && *ptr != '\n') {
+        unsigned long first, last;
+        char *end;
+
+        first = last = strtoul(ptr, &end, 10);
+        if (end == ptr)
+            return HG_UTIL_FAIL;
+        if (*end == '-') {
+            ptr = end + 1;
+            last = strtoul(ptr, &end, 10);
+            if (end == ptr)
+                return HG_UTIL_FAIL;
+        }
+        for (; first <= last && first < CPU_SETSIZE; first++)
+            CPU_SET((int) first, cpu_mask);
+        ptr = (*end == ',') ? end + 1 : end;
+    }
+
+    return (CPU_COUNT(cpu_mask) > 0) ? HG_UTIL_SUCCESS : HG_UTIL_FAIL;
+#endif
+}
@@ -185,6 +185,21 @@ hg_thread_getaffinity(hg_thread_t thread, hg_cpu_set_t *cpu_mask);
 HG_UTIL_PUBLIC int
 hg_thread_setaffinity(hg_thread_t thread, const hg_cpu_set_t *cpu_mask);
 
+/**
+ * Initialize a cpu mask from a list of CPUs or, if the list is empty, from
+ * the CPUs of a NUMA node.
+ *
+ * \param cpus [IN]             array of CPU indices (may be NULL)
+ * \param cpu_count [IN]        number of CPUs in array
+ * \param numa_node [IN]        NUMA node used if no CPU is given
+ * \param cpu_mask [OUT]        cpu mask
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_cpu_mask_init(const unsigned int *cpus, unsigned int cpu_count,
+    int numa_node, hg_cpu_set_t *cpu_mask);
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE hg_thread_t
 hg_thread_self(void)
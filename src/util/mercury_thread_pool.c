@@ -7,6 +7,9 @@
 
 #include "mercury_thread_pool.h"
 
+#include "mercury_atomic.h"
+#include "mercury_mem.h"
+#include "mercury_thread_spin.h"
 #include "mercury_util_error.h"
 
 #include <stdlib.h>
@@ -15,14 +18,35 @@
 /* Local Macros */
 /****************/
 
+/* Number of times an idle worker looks for work before sleeping */
+#define HG_THREAD_POOL_WS_SPIN (16)
+
+/* Maximum number of works taken at once from another worker */
+#define HG_THREAD_POOL_WS_STEAL_MAX (32)
+
 /************************************/
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Work-stealing worker */
+struct hg_thread_pool_worker {
+    HG_UTIL_ALIGNED(hg_thread_spin_t lock, HG_MEM_CACHE_LINE_SIZE); /* Lock */
+    HG_QUEUE_HEAD(hg_thread_work) queues[HG_THREAD_POOL_PRIO_COUNT];
+    hg_atomic_int32_t queued;                 /* Queued works     */
+    hg_atomic_int32_t sleeping;               /* Waiting on cond  */
+    hg_thread_mutex_t mutex;                  /* Sleep mutex      */
+    hg_thread_cond_t cond;                    /* Sleep cond       */
+    struct hg_thread_pool_private *priv_pool; /* Pool             */
+    unsigned int id;                          /* Worker index     */
+};
+
 struct hg_thread_pool_private {
     struct hg_thread_pool pool;
     unsigned int thread_count;
     hg_thread_t *threads;
+    hg_atomic_int32_t next_worker; /* Next worker posted to */
+    hg_atomic_int32_t searching;   /* Idle workers not sleeping yet */
+    hg_atomic_int32_t ws_shutdown; /* Work-stealing shutdown */
 };
 
 /********************/
@@ -35,6 +59,58 @@ struct hg_thread_pool_private {
 static HG_THREAD_RETURN_TYPE
 hg_thread_pool_worker(void *args);
 
+/**
+ * Work-stealing worker thread
+ */
+static HG_THREAD_RETURN_TYPE
+hg_thread_pool_ws_worker(void *args);
+
+/**
+ * Pop work of priority prio from worker queue. Unless locked is set, a
+ * queue that looks empty is skipped without taking its lock.
+ */
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_ws_pop(struct hg_thread_pool_worker *worker,
+    enum hg_thread_pool_prio prio, bool locked);
+
+/**
+ * Steal work of priority prio from victim, moving up to half of its queued
+ * works to the queue of worker.
+ */
+static struct hg_thread_work *
+hg_thread_pool_ws_steal(struct hg_thread_pool_worker *victim,
+    struct hg_thread_pool_worker *worker, enum hg_thread_pool_prio prio,
+    bool locked);
+
+/**
+ * Get next work, from our own queues first and then from other workers.
+ */
+static struct hg_thread_work *
+hg_thread_pool_ws_get(struct hg_thread_pool_private *priv_pool,
+    struct hg_thread_pool_worker *worker, bool locked);
+
+/**
+ * Queue works on the next worker and wake up as many sleeping workers.
+ */
+static int
+hg_thread_pool_ws_post(struct hg_thread_pool_private *priv_pool,
+    struct hg_thread_work **works, unsigned int count,
+    enum hg_thread_pool_prio prio);
+
+/**
+ * Wake up to count sleeping workers, starting from worker first.
+ */
+static void
+hg_thread_pool_ws_wake(struct hg_thread_pool_private *priv_pool,
+    unsigned int first, unsigned int count);
+
+/**
+ * Pin thread to the index-th CPU of cpu_set.
+ */
+static int
+hg_thread_pool_pin(
+    hg_thread_t thread, const hg_cpu_set_t *cpu_set, unsigned int index);
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -51,7 +127,8 @@ hg_thread_pool_worker(void *args)
         hg_thread_mutex_lock(&pool->mutex);
 
         /* If not shutting down and nothing to do, worker sleeps */
-        while (!pool->shutdown && HG_QUEUE_IS_EMPTY(&pool->queue)) {
+        while (!pool->shutdown && HG_QUEUE_IS_EMPTY(&pool->queue) &&
+               HG_QUEUE_IS_EMPTY(&pool->high_queue)) {
             int rc;
 
             pool->sleeping_worker_count++;
@@ -63,12 +140,18 @@ hg_thread_pool_worker(void *args)
             pool->sleeping_worker_count--;
         }
 
-        if (pool->shutdown && HG_QUEUE_IS_EMPTY(&pool->queue))
+        if (pool->shutdown && HG_QUEUE_IS_EMPTY(&pool->queue) &&
+            HG_QUEUE_IS_EMPTY(&pool->high_queue))
             goto unlock;
 
         /* Grab our task */
-        work = HG_QUEUE_FIRST(&pool->queue);
-        HG_QUEUE_POP_HEAD(&pool->queue, entry);
+        if (!HG_QUEUE_IS_EMPTY(&pool->high_queue)) {
+            work = HG_QUEUE_FIRST(&pool->high_queue);
+            HG_QUEUE_POP_HEAD(&pool->high_queue, entry);
+        } else {
+            work = HG_QUEUE_FIRST(&pool->queue);
+            HG_QUEUE_POP_HEAD(&pool->queue, entry);
+        }
 
         /* Unlock */
         hg_thread_mutex_unlock(&pool->mutex);
@@ -83,9 +166,262 @@ unlock:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_thread_pool_ws_worker(void *args)
+{
+    hg_thread_ret_t ret = 0;
+    struct hg_thread_pool_worker *worker =
+        (struct hg_thread_pool_worker *) args;
+    struct hg_thread_pool_private *priv_pool = worker->priv_pool;
+    struct hg_thread_work *work;
+
+    while (1) {
+        work = hg_thread_pool_ws_get(priv_pool, worker, false);
+        if (work == NULL) {
+            unsigned int i;
+
+            /* Posters do not wake anyone while a worker is searching */
+            hg_atomic_incr32(&priv_pool->searching);
+            for (i = 0; i < HG_THREAD_POOL_WS_SPIN && work == NULL; i++)
+                work = hg_thread_pool_ws_get(priv_pool, worker, false);
+            if (work != NULL) {
+                hg_atomic_decr32(&priv_pool->searching);
+                (*work->func)(work->args);
+                continue;
+            }
+
+            hg_thread_mutex_lock(&worker->mutex);
+            hg_atomic_decr32(&priv_pool->searching);
+
+            /* Posters check searching and sleeping after queueing, so
+             * announce it before looking at the queues one last time */
+            while (1) {
+                hg_atomic_set32(&worker->sleeping, 1);
+                work = hg_thread_pool_ws_get(priv_pool, worker, true);
+                if (work != NULL || hg_atomic_get32(&priv_pool->ws_shutdown))
+                    break;
+                if (hg_thread_cond_wait(&worker->cond, &worker->mutex) !=
+                    HG_UTIL_SUCCESS) {
+                    HG_UTIL_LOG_ERROR(
+                        "Thread cannot wait on condition variable");
+                    break;
+                }
+            }
+            hg_atomic_set32(&worker->sleeping, 0);
+
+            hg_thread_mutex_unlock(&worker->mutex);
+
+            /* Shutting down with nothing left to do */
+            if (work == NULL)
+                break;
+        }
+
+        /* Get to work */
+        (*work->func)(work->args);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE struct hg_thread_work *
+hg_thread_pool_ws_pop(struct hg_thread_pool_worker *worker,
+    enum hg_thread_pool_prio prio, bool locked)
+{
+    struct hg_thread_work *work;
+
+    if (!locked && hg_atomic_get32(&worker->queued) == 0)
+        return NULL;
+
+    hg_thread_spin_lock(&worker->lock);
+    work = HG_QUEUE_FIRST(&worker->queues[prio]);
+    if (work != NULL) {
+        HG_QUEUE_POP_HEAD(&worker->queues[prio], entry);
+        hg_atomic_decr32(&worker->queued);
+    }
+    hg_thread_spin_unlock(&worker->lock);
+
+    return work;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_thread_work *
+hg_thread_pool_ws_steal(struct hg_thread_pool_worker *victim,
+    struct hg_thread_pool_worker *worker, enum hg_thread_pool_prio prio,
+    bool locked)
+{
+    HG_QUEUE_HEAD(hg_thread_work) stolen;
+    struct hg_thread_work *work, *next;
+    int32_t count = 0, max_count;
+
+    if (!locked && hg_atomic_get32(&victim->queued) == 0)
+        return NULL;
+
+    HG_QUEUE_INIT(&stolen);
+
+    hg_thread_spin_lock(&victim->lock);
+    work = HG_QUEUE_FIRST(&victim->queues[prio]);
+    if (work == NULL) {
+        hg_thread_spin_unlock(&victim->lock);
+        return NULL;
+    }
+    HG_QUEUE_POP_HEAD(&victim->queues[prio], entry);
+    max_count = hg_atomic_get32(&victim->queued) / 2;
+    if (max_count > HG_THREAD_POOL_WS_STEAL_MAX)
+        max_count = HG_THREAD_POOL_WS_STEAL_MAX;
+    while (count < max_count &&
+           (next = HG_QUEUE_FIRST(&victim->queues[prio])) != NULL) {
+        HG_QUEUE_POP_HEAD(&victim->queues[prio], entry);
+        HG_QUEUE_PUSH_TAIL(&stolen, next, entry);
+        count++;
+    }
+    hg_atomic_set32(
+        &victim->queued, hg_atomic_get32(&victim->queued) - count - 1);
+    hg_thread_spin_unlock(&victim->lock);
+
+    /* We are awake and will run them, no need to wake anyone up */
+    if (count > 0) {
+        hg_thread_spin_lock(&worker->lock);
+        while ((next = HG_QUEUE_FIRST(&stolen)) != NULL) {
+            HG_QUEUE_POP_HEAD(&stolen, entry);
+            HG_QUEUE_PUSH_TAIL(&worker->queues[prio], next, entry);
+        }
+        hg_atomic_set32(
+            &worker->queued, hg_atomic_get32(&worker->queued) + count);
+        hg_thread_spin_unlock(&worker->lock);
+    }
+
+    return work;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_thread_work *
+hg_thread_pool_ws_get(struct hg_thread_pool_private *priv_pool,
+    struct hg_thread_pool_worker *worker, bool locked)
+{
+    unsigned int n = priv_pool->thread_count;
+    int prio;
+
+    for (prio = HG_THREAD_POOL_PRIO_COUNT - 1; prio >= 0; prio--) {
+        struct hg_thread_work *work;
+        unsigned int i;
+
+        work = hg_thread_pool_ws_pop(
+            worker, (enum hg_thread_pool_prio) prio, locked);
+        if (work != NULL)
+            return work;
+
+        /* Steal starting from the next worker */
+        for (i = 1; i < n; i++) {
+            work = hg_thread_pool_ws_steal(
+                &priv_pool->pool.workers[(worker->id + i) % n], worker,
+                (enum hg_thread_pool_prio) prio, locked);
+            if (work != NULL)
+                return work;
+        }
+    }
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_thread_pool_ws_post(struct hg_thread_pool_private *priv_pool,
+    struct hg_thread_work **works, unsigned int count,
+    enum hg_thread_pool_prio prio)
+{
+    struct hg_thread_pool_worker *worker;
+    unsigned int first, i;
+
+    if (hg_atomic_get32(&priv_pool->ws_shutdown))
+        return HG_UTIL_FAIL;
+
+    first = (unsigned int) hg_atomic_incr32(&priv_pool->next_worker) %
+            priv_pool->thread_count;
+    worker = &priv_pool->pool.workers[first];
+
+    /* queued is only modified with the lock held */
+    hg_thread_spin_lock(&worker->lock);
+    for (i = 0; i < count; i++)
+        HG_QUEUE_PUSH_TAIL(&worker->queues[prio], works[i], entry);
+    hg_atomic_set32(&worker->queued,
+        hg_atomic_get32(&worker->queued) + (int32_t) count);
+    hg_thread_spin_unlock(&worker->lock);
+
+    hg_thread_pool_ws_wake(priv_pool, first, count);
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_thread_pool_ws_wake(struct hg_thread_pool_private *priv_pool,
+    unsigned int first, unsigned int count)
+{
+    unsigned int n = priv_pool->thread_count, i;
+
+    /* A searching worker will find the work without being woken up */
+    if (hg_atomic_get32(&priv_pool->searching) > 0)
+        return;
+
+    /* Sleeping workers other than the first one will steal the work */
+    for (i = 0; i < n && count > 0; i++) {
+        struct hg_thread_pool_worker *worker =
+            &priv_pool->pool.workers[(first + i) % n];
+
+        if (!hg_atomic_get32(&worker->sleeping))
+            continue;
+
+        hg_thread_mutex_lock(&worker->mutex);
+        if (hg_atomic_get32(&worker->sleeping)) {
+            hg_atomic_set32(&worker->sleeping, 0);
+            (void) hg_thread_cond_signal(&worker->cond);
+            count--;
+        }
+        hg_thread_mutex_unlock(&worker->mutex);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_thread_pool_pin(
+    hg_thread_t thread, const hg_cpu_set_t *cpu_set, unsigned int index)
+{
+#if defined(_WIN32) || defined(__APPLE__)
+    (void) index;
+
+    return hg_thread_setaffinity(thread, cpu_set);
+#else
+    hg_cpu_set_t worker_set;
+    int cpu_count = CPU_COUNT(cpu_set), cpu, n;
+
+    if (cpu_count == 0)
+        return HG_UTIL_FAIL;
+
+    n = (int) (index % (unsigned int) cpu_count);
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, cpu_set) && n-- == 0)
+            break;
+
+    CPU_ZERO(&worker_set);
+    CPU_SET(cpu, &worker_set);
+
+    return hg_thread_setaffinity(thread, &worker_set);
+#endif
+}
+
 /*---------------------------------------------------------------------------*/
 int
 hg_thread_pool_init(unsigned int thread_count, hg_thread_pool_t **pool_ptr)
+{
+    return hg_thread_pool_init_opt(thread_count, NULL, pool_ptr);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_pool_init_opt(unsigned int thread_count,
+    const struct hg_thread_pool_opt *opt, hg_thread_pool_t **pool_ptr)
 {
     int ret = HG_UTIL_SUCCESS, rc;
     struct hg_thread_pool_private *priv_pool = NULL;
@@ -103,7 +439,12 @@ hg_thread_pool_init(unsigned int thread_count, hg_thread_pool_t **pool_ptr)
     priv_pool->thread_count = thread_count;
     priv_pool->threads = NULL;
     HG_QUEUE_INIT(&priv_pool->pool.queue);
+    HG_QUEUE_INIT(&priv_pool->pool.high_queue);
+    priv_pool->pool.workers = NULL;
     priv_pool->pool.shutdown = 0;
+    hg_atomic_init32(&priv_pool->next_worker, 0);
+    hg_atomic_init32(&priv_pool->searching, 0);
+    hg_atomic_init32(&priv_pool->ws_shutdown, 0);
 
     rc = hg_thread_mutex_init(&priv_pool->pool.mutex);
     HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_UTIL_FAIL,
@@ -113,6 +454,32 @@ hg_thread_pool_init(unsigned int thread_count, hg_thread_pool_t **pool_ptr)
     HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_UTIL_FAIL,
         "Could not initialize thread condition");
 
+    if (opt != NULL && opt->work_stealing) {
+        HG_UTIL_CHECK_ERROR(thread_count == 0, error, ret, HG_UTIL_FAIL,
+            "Work stealing requires at least one thread");
+
+        priv_pool->pool.workers = (struct hg_thread_pool_worker *)
+            hg_mem_aligned_alloc(HG_MEM_CACHE_LINE_SIZE,
+                thread_count * sizeof(struct hg_thread_pool_worker));
+        HG_UTIL_CHECK_ERROR(priv_pool->pool.workers == NULL, error, ret,
+            HG_UTIL_FAIL, "Could not allocate workers");
+
+        for (i = 0; i < thread_count; i++) {
+            struct hg_thread_pool_worker *worker = &priv_pool->pool.workers[i];
+            int prio;
+
+            hg_thread_spin_init(&worker->lock);
+            for (prio = 0; prio < HG_THREAD_POOL_PRIO_COUNT; prio++)
+                HG_QUEUE_INIT(&worker->queues[prio]);
+            hg_atomic_init32(&worker->queued, 0);
+            hg_atomic_init32(&worker->sleeping, 0);
+            hg_thread_mutex_init(&worker->mutex);
+            hg_thread_cond_init(&worker->cond);
+            worker->priv_pool = priv_pool;
+            worker->id = i;
+        }
+    }
+
     priv_pool->threads =
         (hg_thread_t *) malloc(thread_count * sizeof(hg_thread_t));
     HG_UTIL_CHECK_ERROR(!priv_pool->threads, error, ret, HG_UTIL_FAIL,
@@ -120,10 +487,20 @@ hg_thread_pool_init(unsigned int thread_count, hg_thread_pool_t **pool_ptr)
 
     /* Start worker threads */
     for (i = 0; i < thread_count; i++) {
-        rc = hg_thread_create(
-            &priv_pool->threads[i], hg_thread_pool_worker, (void *) priv_pool);
+        if (priv_pool->pool.workers != NULL)
+            rc = hg_thread_create(&priv_pool->threads[i],
+                hg_thread_pool_ws_worker, &priv_pool->pool.workers[i]);
+        else
+            rc = hg_thread_create(&priv_pool->threads[i],
+                hg_thread_pool_worker, (void *) priv_pool);
         HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, error, ret, HG_UTIL_FAIL,
             "Could not create thread");
+
+        /* Best effort */
+        if (opt != NULL && opt->cpu_set != NULL &&
+            hg_thread_pool_pin(priv_pool->threads[i], opt->cpu_set, i) !=
+                HG_UTIL_SUCCESS)
+            HG_UTIL_LOG_WARNING("Could not pin thread %u", i);
     }
 
     *pool_ptr = (struct hg_thread_pool *) priv_pool;
@@ -160,6 +537,18 @@ hg_thread_pool_destroy(hg_thread_pool_t *pool)
 
         hg_thread_mutex_unlock(&priv_pool->pool.mutex);
 
+        if (priv_pool->pool.workers != NULL) {
+            hg_atomic_set32(&priv_pool->ws_shutdown, 1);
+            for (i = 0; i < priv_pool->thread_count; i++) {
+                struct hg_thread_pool_worker *worker =
+                    &priv_pool->pool.workers[i];
+
+                hg_thread_mutex_lock(&worker->mutex);
+                (void) hg_thread_cond_signal(&worker->cond);
+                hg_thread_mutex_unlock(&worker->mutex);
+            }
+        }
+
         for (i = 0; i < priv_pool->thread_count; i++) {
             rc = hg_thread_join(priv_pool->threads[i]);
             HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_UTIL_FAIL,
@@ -167,6 +556,25 @@ hg_thread_pool_destroy(hg_thread_pool_t *pool)
         }
     }
 
+    if (priv_pool->pool.workers != NULL) {
+        struct hg_thread_work *work;
+
+        /* Run work that was queued while workers were exiting */
+        if (priv_pool->threads)
+            while ((work = hg_thread_pool_ws_get(
+                        priv_pool, &priv_pool->pool.workers[0], true)) != NULL)
+                (*work->func)(work->args);
+
+        for (i = 0; i < priv_pool->thread_count; i++) {
+            struct hg_thread_pool_worker *worker = &priv_pool->pool.workers[i];
+
+            (void) hg_thread_spin_destroy(&worker->lock);
+            (void) hg_thread_mutex_destroy(&worker->mutex);
+            (void) hg_thread_cond_destroy(&worker->cond);
+        }
+        hg_mem_aligned_free(priv_pool->pool.workers);
+    }
+
     rc = hg_thread_mutex_destroy(&priv_pool->pool.mutex);
     HG_UTIL_CHECK_ERROR(rc != HG_UTIL_SUCCESS, done, ret, HG_UTIL_FAIL,
         "Could not destroy mutex");
@@ -186,3 +594,69 @@ error:
 
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_pool_post_prio(hg_thread_pool_t *pool, struct hg_thread_work *work,
+    enum hg_thread_pool_prio prio)
+{
+    return hg_thread_pool_post_batch(pool, &work, 1, prio);
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_pool_post_batch(hg_thread_pool_t *pool, struct hg_thread_work **works,
+    unsigned int count, enum hg_thread_pool_prio prio)
+{
+    int ret = HG_UTIL_SUCCESS;
+    unsigned int i;
+
+    HG_UTIL_CHECK_ERROR(pool == NULL || (works == NULL && count > 0), done,
+        ret, HG_UTIL_FAIL, "NULL pointer");
+    HG_UTIL_CHECK_ERROR(prio < HG_THREAD_POOL_PRIO_NORMAL ||
+                            prio >= HG_THREAD_POOL_PRIO_COUNT,
+        done, ret, HG_UTIL_FAIL, "Invalid priority (%d)", (int) prio);
+    for (i = 0; i < count; i++)
+        HG_UTIL_CHECK_ERROR(works[i] == NULL || works[i]->func == NULL, done,
+            ret, HG_UTIL_FAIL, "Invalid work");
+
+    if (count == 0)
+        goto done;
+
+    if (pool->workers != NULL)
+        return hg_thread_pool_ws_post(
+            (struct hg_thread_pool_private *) pool, works, count, prio);
+
+    hg_thread_mutex_lock(&pool->mutex);
+
+    /* Are we shutting down ? */
+    if (pool->shutdown) {
+        ret = HG_UTIL_FAIL;
+        goto unlock;
+    }
+
+    /* Add tasks to task queue */
+    for (i = 0; i < count; i++) {
+        if (prio == HG_THREAD_POOL_PRIO_HIGH)
+            HG_QUEUE_PUSH_TAIL(&pool->high_queue, works[i], entry);
+        else
+            HG_QUEUE_PUSH_TAIL(&pool->queue, works[i], entry);
+    }
+
+    /* Wake up as many sleeping workers as needed */
+    if (count >= pool->sleeping_worker_count) {
+        if (pool->sleeping_worker_count &&
+            (hg_thread_cond_broadcast(&pool->cond) != HG_UTIL_SUCCESS))
+            ret = HG_UTIL_FAIL;
+    } else {
+        for (i = 0; i < count; i++)
+            if (hg_thread_cond_signal(&pool->cond) != HG_UTIL_SUCCESS)
+                ret = HG_UTIL_FAIL;
+    }
+
+unlock:
+    hg_thread_mutex_unlock(&pool->mutex);
+
+done:
+    return ret;
+}
@@ -21,6 +21,8 @@ typedef struct hg_thread_pool hg_thread_pool_t;
 struct hg_thread_pool {
     unsigned int sleeping_worker_count;
     HG_QUEUE_HEAD(hg_thread_work) queue;
+    HG_QUEUE_HEAD(hg_thread_work) high_queue; /* HG_THREAD_POOL_PRIO_HIGH */
+    struct hg_thread_pool_worker *workers;    /* Work-stealing mode only */
     int shutdown;
     hg_thread_mutex_t mutex;
     hg_thread_cond_t cond;
@@ -32,6 +34,26 @@ struct hg_thread_work {
     HG_QUEUE_ENTRY(hg_thread_work) entry; /* Internal */
 };
 
+/* Work priority, high priority work is always picked first */
+enum hg_thread_pool_prio {
+    HG_THREAD_POOL_PRIO_NORMAL = 0,
+    HG_THREAD_POOL_PRIO_HIGH,
+    HG_THREAD_POOL_PRIO_COUNT /* Internal */
+};
+
+/* Thread pool options */
+struct hg_thread_pool_opt {
+    /* Pin each worker to a single CPU taken in turn from that set, or to
+     * the whole set on platforms that cannot enumerate it (NULL for no
+     * pinning) */
+    const hg_cpu_set_t *cpu_set;
+
+    /* Give each worker its own queue, posted work is spread round-robin
+     * across workers and idle workers steal from busy ones. Only the
+     * targeted worker is woken up (default is a single shared queue) */
+    bool work_stealing;
+};
+
 /*****************/
 /* Public Macros */
 /*****************/
@@ -56,6 +78,20 @@ extern "C" {
 HG_UTIL_PUBLIC int
 hg_thread_pool_init(unsigned int thread_count, hg_thread_pool_t **pool);
 
+/**
+ * Initialize the thread pool with options.
+ *
+ * \param thread_count [IN]     number of threads that will be created at
+ *                              initialization
+ * \param opt [IN]              pointer to options (NULL for defaults)
+ * \param pool [OUT]            pointer to pool object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_pool_init_opt(unsigned int thread_count,
+    const struct hg_thread_pool_opt *opt, hg_thread_pool_t **pool);
+
 /**
  * Destroy the thread pool.
  *
@@ -78,6 +114,34 @@ hg_thread_pool_destroy(hg_thread_pool_t *pool);
 static HG_UTIL_INLINE int
 hg_thread_pool_post(hg_thread_pool_t *pool, struct hg_thread_work *work);
 
+/**
+ * Post work to the pool with priority \prio.
+ *
+ * \param pool [IN/OUT]         pointer to pool object
+ * \param work [IN]             pointer to work struct
+ * \param prio [IN]             work priority
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_pool_post_prio(hg_thread_pool_t *pool, struct hg_thread_work *work,
+    enum hg_thread_pool_prio prio);
+
+/**
+ * Post \count works to the pool at once with priority \prio, taking the
+ * queue lock only once.
+ *
+ * \param pool [IN/OUT]         pointer to pool object
+ * \param works [IN]            array of pointers to work structs
+ * \param count [IN]            number of works
+ * \param prio [IN]             work priority
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_pool_post_batch(hg_thread_pool_t *pool, struct hg_thread_work **works,
+    unsigned int count, enum hg_thread_pool_prio prio);
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE int
 hg_thread_pool_post(hg_thread_pool_t *pool, struct hg_thread_work *work)
@@ -90,6 +154,9 @@ hg_thread_pool_post(hg_thread_pool_t *pool, struct hg_thread_work *work)
     if (!work->func)
         return HG_UTIL_FAIL;
 
+    if (pool->workers != NULL)
+        return hg_thread_pool_post_prio(pool, work, HG_THREAD_POOL_PRIO_NORMAL);
+
     hg_thread_mutex_lock(&pool->mutex);
 
     /* Are we shutting down ? */
@@ -48,3 +48,52 @@ done:
 
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_brlock_init(hg_thread_brlock_t *brlock)
+{
+    unsigned int i;
+    int ret;
+
+    brlock->slots = (struct hg_thread_brlock_slot *) hg_mem_aligned_alloc(
+        HG_MEM_CACHE_LINE_SIZE,
+        HG_THREAD_BRLOCK_SLOTS * sizeof(struct hg_thread_brlock_slot));
+    HG_UTIL_CHECK_ERROR(brlock->slots == NULL, error, ret, HG_UTIL_FAIL,
+        "Could not allocate brlock slots");
+
+    for (i = 0; i < HG_THREAD_BRLOCK_SLOTS; i++) {
+        ret = hg_thread_rwlock_init(&brlock->slots[i].lock);
+        HG_UTIL_CHECK_ERROR(ret != HG_UTIL_SUCCESS, cleanup, ret, HG_UTIL_FAIL,
+            "Could not initialize brlock slot %u", i);
+    }
+
+    return HG_UTIL_SUCCESS;
+
+cleanup:
+    while (i-- > 0)
+        (void) hg_thread_rwlock_destroy(&brlock->slots[i].lock);
+    hg_mem_aligned_free(brlock->slots);
+    brlock->slots = NULL;
+error:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_brlock_destroy(hg_thread_brlock_t *brlock)
+{
+    int ret = HG_UTIL_SUCCESS;
+    unsigned int i;
+
+    if (brlock->slots == NULL)
+        return HG_UTIL_SUCCESS;
+
+    for (i = 0; i < HG_THREAD_BRLOCK_SLOTS; i++)
+        if (hg_thread_rwlock_destroy(&brlock->slots[i].lock) != HG_UTIL_SUCCESS)
+            ret = HG_UTIL_FAIL;
+    hg_mem_aligned_free(brlock->slots);
+    brlock->slots = NULL;
+
+    return ret;
+}
@@ -10,6 +10,7 @@
 
 #include "mercury_util_config.h"
 
+#include "mercury_mem.h"
 #include "mercury_thread_annotation.h"
 
 #ifdef _WIN32
@@ -21,6 +22,21 @@ typedef SRWLOCK hg_thread_rwlock_t;
 typedef pthread_rwlock_t HG_LOCK_CAPABILITY("rwlock") hg_thread_rwlock_t;
 #endif
 
+/* Number of slots of a reader-biased rwlock */
+#define HG_THREAD_BRLOCK_SLOTS (16)
+
+/* Slot of a reader-biased rwlock, each slot is on its own cache line */
+struct hg_thread_brlock_slot {
+    HG_MEM_CACHE_ALIGNED(hg_thread_rwlock_t lock); /* Slot lock */
+};
+
+/* Reader-biased rwlock: readers only take the slot of their thread so that
+ * readers of different threads do not share a cache line, writers take all
+ * slots. Suited to data that is almost never updated. */
+typedef struct hg_thread_brlock {
+    struct hg_thread_brlock_slot *slots; /* Array of slots */
+} HG_LOCK_CAPABILITY("brlock") hg_thread_brlock_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -102,6 +118,63 @@ static HG_UTIL_INLINE void
 hg_thread_rwlock_release_wrlock(hg_thread_rwlock_t *rwlock)
     HG_LOCK_RELEASE(*rwlock);
 
+/**
+ * Initialize the reader-biased rwlock.
+ *
+ * \param brlock [IN/OUT]        pointer to brlock object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_brlock_init(hg_thread_brlock_t *brlock);
+
+/**
+ * Destroy the reader-biased rwlock.
+ *
+ * \param brlock [IN/OUT]        pointer to brlock object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_brlock_destroy(hg_thread_brlock_t *brlock);
+
+/**
+ * Take a read lock for the reader-biased rwlock. Only the slot of the calling
+ * thread is locked.
+ *
+ * \param brlock [IN/OUT]        pointer to brlock object
+ */
+static HG_UTIL_INLINE void
+hg_thread_brlock_rdlock(hg_thread_brlock_t *brlock)
+    HG_LOCK_ACQUIRE_SHARED(*brlock);
+
+/**
+ * Release the read lock of the reader-biased rwlock. Must be called from the
+ * thread that took the read lock.
+ *
+ * \param brlock [IN/OUT]        pointer to brlock object
+ */
+static HG_UTIL_INLINE void
+hg_thread_brlock_release_rdlock(hg_thread_brlock_t *brlock)
+    HG_LOCK_RELEASE_SHARED(*brlock);
+
+/**
+ * Take a write lock for the reader-biased rwlock. All slots are locked.
+ *
+ * \param brlock [IN/OUT]        pointer to brlock object
+ */
+static HG_UTIL_INLINE void
+hg_thread_brlock_wrlock(hg_thread_brlock_t *brlock) HG_LOCK_ACQUIRE(*brlock);
+
+/**
+ * Release the write lock of the reader-biased rwlock.
+ *
+ * \param brlock [IN/OUT]        pointer to brlock object
+ */
+static HG_UTIL_INLINE void
+hg_thread_brlock_release_wrlock(hg_thread_brlock_t *brlock)
+    HG_LOCK_RELEASE(*brlock);
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void
 hg_thread_rwlock_rdlock(
@@ -182,6 +255,62 @@ hg_thread_rwlock_release_wrlock(
 #endif
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE unsigned int
+hg_thread_brlock_slot(void)
+{
+#ifdef _WIN32
+    uint64_t id = (uint64_t) GetCurrentThreadId();
+#else
+    uint64_t id = (uint64_t) (uintptr_t) pthread_self();
+#endif
+
+    /* Fibonacci hashing, thread IDs are not uniformly distributed. A thread
+     * always maps to the same slot so that release does not need it. */
+    return (unsigned int) ((id * 0x9E3779B97F4A7C15ULL) >> 32) %
+           HG_THREAD_BRLOCK_SLOTS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_thread_brlock_rdlock(
+    hg_thread_brlock_t *brlock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
+{
+    hg_thread_rwlock_rdlock(&brlock->slots[hg_thread_brlock_slot()].lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_thread_brlock_release_rdlock(
+    hg_thread_brlock_t *brlock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
+{
+    hg_thread_rwlock_release_rdlock(
+        &brlock->slots[hg_thread_brlock_slot()].lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_thread_brlock_wrlock(
+    hg_thread_brlock_t *brlock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
+{
+    unsigned int i;
+
+    /* Always lock in the same order to prevent writers from deadlocking */
+    for (i = 0; i < HG_THREAD_BRLOCK_SLOTS; i++)
+        hg_thread_rwlock_wrlock(&brlock->slots[i].lock);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_thread_brlock_release_wrlock(
+    hg_thread_brlock_t *brlock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
+{
+    unsigned int i;
+
+    for (i = HG_THREAD_BRLOCK_SLOTS; i > 0; i--)
+        hg_thread_rwlock_release_wrlock(&brlock->slots[i - 1].lock);
+}
+
 #ifdef __cplusplus
 }
 #endif
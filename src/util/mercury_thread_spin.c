@@ -52,3 +52,27 @@ done:
 
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_ticket_init(hg_thread_ticket_t *lock)
+{
+    hg_atomic_init32(&lock->next, 0);
+    hg_atomic_init32(&lock->owner, 0);
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+hg_thread_ticket_destroy(hg_thread_ticket_t *lock)
+{
+    HG_UTIL_CHECK_ERROR_NORET(
+        hg_atomic_get32(&lock->next) != hg_atomic_get32(&lock->owner), error,
+        "Destroying ticket lock that is still held");
+
+    return HG_UTIL_SUCCESS;
+
+error:
+    return HG_UTIL_FAIL;
+}
@@ -10,6 +10,8 @@
 
 #include "mercury_util_config.h"
 
+#include "mercury_atomic.h"
+#include "mercury_thread.h"
 #include "mercury_thread_annotation.h"
 
 #if defined(_WIN32)
@@ -25,6 +27,17 @@ typedef pthread_spinlock_t HG_LOCK_CAPABILITY("spin") hg_thread_spin_t;
 typedef hg_thread_mutex_t HG_LOCK_CAPABILITY("mutex") hg_thread_spin_t;
 #endif
 
+/* Ticket spin lock, waiters acquire the lock in arrival order. It can be
+ * used in place of hg_thread_spin_t where many threads contend for the lock
+ * and fairness matters more than uncontended cost. */
+typedef struct hg_thread_ticket {
+    hg_atomic_int32_t next;  /* Next ticket to hand out */
+    hg_atomic_int32_t owner; /* Ticket of current owner */
+} HG_LOCK_CAPABILITY("ticket") hg_thread_ticket_t;
+
+/* Busy-wait rounds after which a waiter yields its CPU between checks */
+#define HG_THREAD_TICKET_SPIN_MAX (1024)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -76,6 +89,55 @@ hg_thread_spin_try_lock(hg_thread_spin_t *lock)
 static HG_UTIL_INLINE void
 hg_thread_spin_unlock(hg_thread_spin_t *lock) HG_LOCK_RELEASE(*lock);
 
+/**
+ * Initialize the ticket lock.
+ *
+ * \param lock [IN/OUT]         pointer to lock object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_ticket_init(hg_thread_ticket_t *lock);
+
+/**
+ * Destroy the ticket lock.
+ *
+ * \param lock [IN/OUT]         pointer to lock object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+HG_UTIL_PUBLIC int
+hg_thread_ticket_destroy(hg_thread_ticket_t *lock);
+
+/**
+ * Lock the ticket lock. Waiters back off in proportion to the number of
+ * waiters ahead of them and yield once HG_THREAD_TICKET_SPIN_MAX rounds have
+ * elapsed.
+ *
+ * \param lock [IN/OUT]         pointer to lock object
+ */
+static HG_UTIL_INLINE void
+hg_thread_ticket_lock(hg_thread_ticket_t *lock) HG_LOCK_ACQUIRE(*lock);
+
+/**
+ * Try locking the ticket lock, fails if the lock is held or waited on.
+ *
+ * \param lock [IN/OUT]         pointer to lock object
+ *
+ * \return Non-negative on success or negative on failure
+ */
+static HG_UTIL_INLINE int
+hg_thread_ticket_try_lock(hg_thread_ticket_t *lock)
+    HG_LOCK_TRY_ACQUIRE(HG_UTIL_SUCCESS, *lock);
+
+/**
+ * Unlock the ticket lock.
+ *
+ * \param lock [IN/OUT]         pointer to lock object
+ */
+static HG_UTIL_INLINE void
+hg_thread_ticket_unlock(hg_thread_ticket_t *lock) HG_LOCK_RELEASE(*lock);
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void
 hg_thread_spin_lock(hg_thread_spin_t *lock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
@@ -129,6 +191,56 @@ hg_thread_spin_unlock(hg_thread_spin_t *lock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
 #endif
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_thread_ticket_lock(
+    hg_thread_ticket_t *lock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
+{
+    uint32_t ticket = (uint32_t) hg_atomic_incr32(&lock->next) - 1;
+    unsigned int spins = 0;
+
+    for (;;) {
+        uint32_t ahead = ticket - (uint32_t) hg_atomic_get32(&lock->owner);
+        uint32_t i;
+
+        if (ahead == 0)
+            break;
+
+        if (spins >= HG_THREAD_TICKET_SPIN_MAX) {
+            hg_thread_yield();
+            continue;
+        }
+
+        /* Poll less often the further we are from the head of the queue */
+        for (i = 0; i < ahead; i++)
+            cpu_spinwait();
+        spins += ahead;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE int
+hg_thread_ticket_try_lock(
+    hg_thread_ticket_t *lock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
+{
+    uint32_t owner = (uint32_t) hg_atomic_get32(&lock->owner);
+
+    if (!hg_atomic_cas32(&lock->next, (int32_t) owner, (int32_t) (owner + 1)))
+        return HG_UTIL_FAIL;
+
+    return HG_UTIL_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE void
+hg_thread_ticket_unlock(
+    hg_thread_ticket_t *lock) HG_LOCK_NO_THREAD_SAFETY_ANALYSIS
+{
+    /* Only the owner writes owner, release semantics publish the section */
+    hg_atomic_set32(&lock->owner,
+        (int32_t) ((uint32_t) hg_atomic_get32(&lock->owner) + 1));
+}
+
 #ifdef __cplusplus
 }
 #endif
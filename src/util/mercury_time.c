@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2013-2022 UChicago Argonne, LLC and The HDF Group.
+ * Copyright (c) 2022-2023 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mercury_time.h"
+#include "mercury_atomic.h"
+#include "mercury_compiler_attributes.h"
+
+#if defined(HG_TIME_CYCLES_TSC)
+#    include <cpuid.h>
+#endif
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Min period over which the TSC is calibrated (in seconds) */
+#define HG_TIME_CYCLES_CALIBRATION_MIN (0.002)
+
+/********************/
+/* Local Prototypes */
+/********************/
+
+#if defined(HG_TIME_CYCLES_TSC)
+/* Record reference point used for calibration */
+static void
+hg_time_cycles_init(void) HG_ATTR_CONSTRUCTOR;
+#endif
+
+/* Compute counter frequency */
+static uint64_t
+hg_time_cycles_calibrate(void);
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Counter frequency (0 until calibrated) */
+static hg_atomic_int64_t hg_time_cycles_freq_g = HG_ATOMIC_VAR_INIT(0);
+
+#if defined(HG_TIME_CYCLES_TSC)
+/* Calibration reference point */
+static hg_time_t hg_time_cycles_ref_time_g;
+static uint64_t hg_time_cycles_ref_g = 0;
+#endif
+
+/*---------------------------------------------------------------------------*/
+#if defined(HG_TIME_CYCLES_TSC)
+static void
+hg_time_cycles_init(void)
+{
+    /* Calibrating from load time avoids waiting on first conversion */
+    hg_time_get_current(&hg_time_cycles_ref_time_g);
+    hg_time_cycles_ref_g = hg_time_get_cycles();
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static uint64_t
+hg_time_cycles_calibrate(void)
+{
+#if defined(HG_TIME_CYCLES_TSC)
+    hg_time_t ref_time = hg_time_cycles_ref_time_g, now;
+    uint64_t ref = hg_time_cycles_ref_g, cycles;
+    double elapsed;
+
+    /* Constructor did not run, use a local reference */
+    if (ref == 0) {
+        hg_time_get_current(&ref_time);
+        ref = hg_time_get_cycles();
+    }
+
+    do {
+        hg_time_get_current(&now);
+        cycles = hg_time_get_cycles();
+        elapsed = hg_time_diff(now, ref_time);
+    } while (elapsed < HG_TIME_CYCLES_CALIBRATION_MIN);
+
+    return (uint64_t) ((double) (cycles - ref) / elapsed);
+#elif defined(HG_TIME_CYCLES_CNTVCT)
+    uint64_t freq;
+
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(freq));
+
+    return freq;
+#elif defined(_WIN32)
+    LARGE_INTEGER freq;
+
+    QueryPerformanceFrequency(&freq);
+
+    return (uint64_t) freq.QuadPart;
+#elif defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    return 1000000000;
+#else
+    return 1000000;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+uint64_t
+hg_time_cycles_freq(void)
+{
+    int64_t freq = hg_atomic_get64(&hg_time_cycles_freq_g);
+
+    if (freq == 0) {
+        /* Concurrent callers may calibrate at the same time, keep the first
+         * value so that all conversions are consistent */
+        freq = (int64_t) hg_time_cycles_calibrate();
+        if (!hg_atomic_cas64(&hg_time_cycles_freq_g, 0, freq))
+            freq = hg_atomic_get64(&hg_time_cycles_freq_g);
+    }
+
+    return (uint64_t) freq;
+}
+
+/*---------------------------------------------------------------------------*/
+bool
+hg_time_cycles_invariant(void)
+{
+#if defined(HG_TIME_CYCLES_TSC)
+    unsigned int eax, ebx, ecx, edx;
+
+    /* Invariant TSC is reported in CPUID.80000007H:EDX[8] */
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+        return false;
+
+    return (edx & (1U << 8)) != 0;
+#else
+    /* Architected timers and OS clocks are invariant */
+    return true;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+double
+hg_time_cycles_to_double(uint64_t cycles)
+{
+    return (double) cycles / (double) hg_time_cycles_freq();
+}
+
+/*---------------------------------------------------------------------------*/
+uint64_t
+hg_time_cycles_to_ns(uint64_t cycles)
+{
+    uint64_t freq = hg_time_cycles_freq();
+
+    if (freq == 1000000000)
+        return cycles;
+
+    return (uint64_t) ((double) cycles * 1e9 / (double) freq);
+}
@@ -28,6 +28,14 @@
 #    endif
 #endif
 
+/* Cycle counter */
+#if !defined(_WIN32) && (defined(__x86_64__) || defined(__i386__))
+#    include <x86intrin.h>
+#    define HG_TIME_CYCLES_TSC
+#elif !defined(_WIN32) && defined(__aarch64__)
+#    define HG_TIME_CYCLES_CNTVCT
+#endif
+
 /*************************************/
 /* Public Type and Struct Definition */
 /*************************************/
@@ -178,6 +186,58 @@ hg_time_sleep(const hg_time_t rqt);
 static HG_UTIL_INLINE char *
 hg_time_stamp(void);
 
+/**
+ * Read a low-overhead counter that can be used to time short intervals on
+ * hot paths. The TSC is used on x86 and the virtual counter on aarch64,
+ * other platforms fall back to hg_time_get_current(). The read is not
+ * serializing and values are only meaningful when subtracted from each
+ * other, use hg_time_cycles_to_double() to convert the difference.
+ *
+ * \return Counter value
+ */
+static HG_UTIL_INLINE uint64_t
+hg_time_get_cycles(void);
+
+/**
+ * Get the frequency of the counter returned by hg_time_get_cycles(). On x86,
+ * the TSC is calibrated against the monotonic clock on first call, which may
+ * take a couple of milliseconds if called right after the library is loaded.
+ *
+ * \return Number of cycles per second
+ */
+HG_UTIL_PUBLIC uint64_t
+hg_time_cycles_freq(void);
+
+/**
+ * Determine whether the counter ticks at a constant rate across frequency
+ * changes and idle states and is synchronized across CPUs. If not, cycles
+ * can still be compared but conversions may be inaccurate.
+ *
+ * \return true if the counter is invariant, false otherwise
+ */
+HG_UTIL_PUBLIC bool
+hg_time_cycles_invariant(void);
+
+/**
+ * Convert a number of cycles to seconds.
+ *
+ * \param cycles [IN]           number of cycles
+ *
+ * \return Time in seconds
+ */
+HG_UTIL_PUBLIC double
+hg_time_cycles_to_double(uint64_t cycles);
+
+/**
+ * Convert a number of cycles to nanoseconds.
+ *
+ * \param cycles [IN]           number of cycles
+ *
+ * \return Time in nanoseconds
+ */
+HG_UTIL_PUBLIC uint64_t
+hg_time_cycles_to_ns(uint64_t cycles);
+
 /*---------------------------------------------------------------------------*/
 #ifdef _WIN32
 static HG_UTIL_INLINE LARGE_INTEGER
@@ -510,6 +570,36 @@ hg_time_stamp(void)
     return buf;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE uint64_t
+hg_time_get_cycles(void)
+{
+#if defined(HG_TIME_CYCLES_TSC)
+    return (uint64_t) __rdtsc();
+#elif defined(HG_TIME_CYCLES_CNTVCT)
+    uint64_t cycles;
+
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(cycles));
+
+    return cycles;
+#elif defined(_WIN32)
+    LARGE_INTEGER t;
+
+    QueryPerformanceCounter(&t);
+
+    return (uint64_t) t.QuadPart;
+#else
+    hg_time_t tv;
+
+    hg_time_get_current(&tv);
+#    if defined(HG_UTIL_HAS_TIME_H) && defined(HG_UTIL_HAS_CLOCK_GETTIME)
+    return (uint64_t) tv.tv_sec * 1000000000 + (uint64_t) tv.tv_nsec;
+#    else
+    return (uint64_t) tv.tv_sec * 1000000 + (uint64_t) tv.tv_usec;
+#    endif
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif